@@ -0,0 +1,105 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <variant>
+
+#include "multiplayer_backend.h"
+#include "model_a/model_a_backend.h"
+#include "model_b/model_b_backend.h"
+
+namespace Core::Multiplayer::HLE {
+
+/**
+ * Backend Dispatch - Direct calls into the concrete backend on the data path
+ *
+ * LdnServiceBridge owns its backend as a MultiplayerBackend created by
+ * BackendFactory, which costs an indirect call per packet. The concrete type
+ * only changes when the backend is created or switched, so the bridge binds
+ * it here once; the per-packet calls then std::visit to the final ModelA and
+ * ModelB classes and are called directly. Any other backend, such as a test
+ * double, keeps virtual dispatch.
+ *
+ * Non-owning: rebind whenever the owned backend is replaced or released.
+ */
+class BackendDispatch {
+public:
+    BackendDispatch() = default;
+
+    void Bind(MultiplayerBackend* backend) {
+        if (auto* model_a = dynamic_cast<ModelA::ModelABackend*>(backend)) {
+            target_ = model_a;
+        } else if (auto* model_b = dynamic_cast<ModelB::ModelBBackend*>(backend)) {
+            target_ = model_b;
+        } else {
+            target_ = backend;
+        }
+    }
+
+    void Reset() {
+        target_ = static_cast<MultiplayerBackend*>(nullptr);
+    }
+
+    bool IsBound() const {
+        return std::visit([](auto* backend) { return backend != nullptr; }, target_);
+    }
+
+    // True when calls bypass virtual dispatch
+    bool IsDevirtualized() const {
+        return !std::holds_alternative<MultiplayerBackend*>(target_);
+    }
+
+    ErrorCode SendPacket(const PacketBuffer& packet, uint8_t node_id) {
+        return Visit([&](auto& backend) { return backend.SendPacket(packet, node_id); });
+    }
+
+    ErrorCode SendPacket(const PacketBuffer& packet, uint8_t node_id, SendPriority priority) {
+        return Visit([&](auto& backend) { return backend.SendPacket(packet, node_id, priority); });
+    }
+
+    ErrorCode ReceivePacket(PacketBuffer& out_packet, uint8_t& out_node_id) {
+        return Visit([&](auto& backend) { return backend.ReceivePacket(out_packet, out_node_id); });
+    }
+
+    ErrorCode SendPackets(const PacketRef* packets, size_t count, size_t& out_sent) {
+        out_sent = 0;
+        return Visit([&](auto& backend) { return backend.SendPackets(packets, count, out_sent); });
+    }
+
+    ErrorCode ReceivePackets(ReceivedPacket* out_packets, size_t max_packets,
+                             size_t& out_received) {
+        out_received = 0;
+        return Visit([&](auto& backend) {
+            return backend.ReceivePackets(out_packets, max_packets, out_received);
+        });
+    }
+
+    void OnFrameBoundary() {
+        Visit([](auto& backend) {
+            backend.OnFrameBoundary();
+            return ErrorCode::Success;
+        });
+    }
+
+    ErrorCode GetCurrentState(Service::LDN::State& out_state) {
+        return Visit([&](auto& backend) { return backend.GetCurrentState(out_state); });
+    }
+
+private:
+    template <typename Callable>
+    ErrorCode Visit(Callable&& callable) {
+        return std::visit(
+            [&](auto* backend) {
+                return backend ? callable(*backend) : ErrorCode::NotInitialized;
+            },
+            target_);
+    }
+
+    std::variant<MultiplayerBackend*, ModelA::ModelABackend*, ModelB::ModelBBackend*> target_{
+        static_cast<MultiplayerBackend*>(nullptr)};
+};
+
+} // namespace Core::Multiplayer::HLE
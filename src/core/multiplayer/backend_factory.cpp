@@ -3,13 +3,29 @@
 
 #include "backend_factory.h"
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
 
+#include "common/startup_profile.h"
+#include "common/timer_wheel.h"
+#include "common/work_stealing_executor.h"
 #include "model_a/model_a_backend.h"
 #include "model_a/p2p_network_factory.h"
 #include "model_b/model_b_backend.h"
 #include "model_b/mdns_discovery.h"
 
+#ifdef _WIN32
+#include "model_b/platform/windows/windows_capability_detector.h"
+#endif
+
 namespace Core::Multiplayer::HLE {
 
 /**
@@ -20,14 +36,25 @@ class ConcreteBackendFactory : public BackendFactory {
 public:
     ConcreteBackendFactory(std::shared_ptr<ConfigurationManager> config)
         : config_manager_(config) {}
+
+    ~ConcreteBackendFactory() override {
+        {
+            // A probe finishing during teardown must not start a prewarm
+            std::lock_guard<std::mutex> lock(probe_mutex_);
+            prewarm_requested_ = false;
+        }
+        timer_wheel_->Cancel(probe_deadline_timer_);
+    }
     
     std::unique_ptr<MultiplayerBackend> CreateBackend(BackendType type) override {
+        StartupSpan span(StartupPhase::BackendCreation);
         switch (type) {
         case BackendType::ModelA_Internet: {
-            auto p2p_network = ModelA::P2PNetworkFactory::Create(
-                ModelA::P2PNetworkFactory::GetDefaultImplementation(),
-                ModelA::P2PNetworkConfig{}
-            );
+            auto p2p_network = TakePrewarmedNetwork();
+            if (!p2p_network) {
+                p2p_network = ModelA::P2PNetworkFactory::Create(
+                    ModelA::P2PNetworkFactory::GetDefaultImplementation(), MakeP2PConfig());
+            }
             return std::make_unique<ModelA::ModelABackend>(config_manager_, std::move(p2p_network));
         }
         case BackendType::ModelB_AdHoc: {
@@ -35,6 +62,7 @@ public:
             return std::make_unique<ModelB::ModelBBackend>(config_manager_, discovery);
         }
         default:
+            span.Fail();
             return nullptr;
         }
     }
@@ -47,24 +75,226 @@ public:
             return BackendType::ModelA_Internet;
         case ConfigurationManager::MultiplayerMode::AdHoc:
             return BackendType::ModelB_AdHoc;
-        case ConfigurationManager::MultiplayerMode::Auto:
-            if (config_manager_->IsModelBAvailable() && ModelB::ModelBBackend::IsSupported()) {
-                return BackendType::ModelB_AdHoc;
+        case ConfigurationManager::MultiplayerMode::Auto: {
+            StartAvailabilityProbes();
+            std::lock_guard<std::mutex> lock(probe_mutex_);
+            return ChooseAutoBackendLocked();
+        }
+        default:
+            return BackendType::ModelA_Internet;
+        }
+    }
+
+    BackendType WaitForPreferredBackend() override {
+        if (config_manager_->GetPreferredMode() != ConfigurationManager::MultiplayerMode::Auto) {
+            return GetPreferredBackend();
+        }
+        StartAvailabilityProbes();
+        std::unique_lock<std::mutex> lock(probe_mutex_);
+        // The deadline timer settles them at the latest; the bound covers a stalled wheel
+        probes_settled_cv_.wait_for(lock, PROBE_DEADLINE, [this] { return probes_settled_; });
+        return ChooseAutoBackendLocked();
+    }
+
+    bool IsPreferredBackendSettled() override {
+        if (config_manager_->GetPreferredMode() != ConfigurationManager::MultiplayerMode::Auto) {
+            return true;
+        }
+        std::lock_guard<std::mutex> lock(probe_mutex_);
+        return probes_settled_;
+    }
+
+    void SetPreferredBackendListener(std::function<void(BackendType)> listener) override {
+        std::lock_guard<std::mutex> lock(probe_mutex_);
+        preferred_listener_ = std::move(listener);
+    }
+
+    void PrewarmPreferredBackend() override {
+#ifdef _WIN32
+        // The probes take hundreds of milliseconds between WinRT activation
+        // and adapter enumeration; nothing on the backend path waits for them
+        const std::filesystem::path config_path = config_manager_->GetConfigFilePath();
+        ModelB::Windows::WindowsCapabilityDetector::StartBackgroundProbe(
+            config_path.empty() ? std::string{}
+                                : (config_path.parent_path() / "windows_capabilities.json").string());
+#endif
+        {
+            std::lock_guard<std::mutex> lock(probe_mutex_);
+            prewarm_requested_ = true;
+        }
+        // Should the probes settle on Internet later, the listener path
+        // starts it then
+        if (GetPreferredBackend() == BackendType::ModelA_Internet) {
+            StartPrewarm();
+        }
+    }
+
+private:
+    // Capability checks behind Auto, each a synchronous call that may touch
+    // the network, WinRT or the permission system
+    enum Probe : size_t {
+        ModelAAvailable,
+        ModelASupported,
+        ModelBAvailable,
+        ModelBSupported,
+        ProbeCount,
+    };
+
+    // Unsettled probes stay pending a little while before counting as failed
+    static constexpr std::chrono::milliseconds PROBE_DEADLINE{2000};
+
+    void StartAvailabilityProbes() {
+        {
+            std::lock_guard<std::mutex> lock(probe_mutex_);
+            if (probes_started_) {
+                return;
             }
-            if (config_manager_->IsModelAAvailable() && ModelA::ModelABackend::IsSupported()) {
-                return BackendType::ModelA_Internet;
+            probes_started_ = true;
+            announced_ = ChooseAutoBackendLocked();
+        }
+        BeginStartupPhase(StartupPhase::CapabilityDetection);
+        const std::array<std::function<bool()>, ProbeCount> checks{
+            [config = config_manager_] { return config->IsModelAAvailable(); },
+            [] { return ModelA::ModelABackend::IsSupported(); },
+            [config = config_manager_] { return config->IsModelBAvailable(); },
+            [] { return ModelB::ModelBBackend::IsSupported(); },
+        };
+        for (size_t probe = 0; probe < ProbeCount; ++probe) {
+            background_tasks_.Submit([this, probe, check = checks[probe]] {
+                RecordProbe(probe, check());
+            });
+        }
+        probe_deadline_timer_ = timer_wheel_->Schedule(PROBE_DEADLINE, [this] {
+            {
+                std::lock_guard<std::mutex> lock(probe_mutex_);
+                if (probes_settled_) {
+                    return;
+                }
+                for (auto& result : probe_results_) {
+                    result = result.value_or(false);
+                }
+                probes_settled_ = true;
             }
-            if (ModelA::ModelABackend::IsSupported()) {
-                return BackendType::ModelA_Internet;
+            probes_settled_cv_.notify_all();
+            EndStartupPhase(StartupPhase::CapabilityDetection, false);
+            AnnounceIfChanged();
+        });
+    }
+
+    void RecordProbe(size_t probe, bool result) {
+        bool settled;
+        {
+            std::lock_guard<std::mutex> lock(probe_mutex_);
+            if (probes_settled_) {
+                return; // Past the deadline; already counted as failed
             }
+            probe_results_[probe] = result;
+            probes_settled_ = std::all_of(probe_results_.begin(), probe_results_.end(),
+                                          [](const auto& r) { return r.has_value(); });
+            settled = probes_settled_;
+        }
+        if (settled) {
+            probes_settled_cv_.notify_all();
+            EndStartupPhase(StartupPhase::CapabilityDetection);
+        }
+        AnnounceIfChanged();
+    }
+
+    // The serial order of old: ad-hoc when usable, else Internet when
+    // supported. A pending check counts as failed, except that Internet is
+    // assumed supported until shown otherwise.
+    BackendType ChooseAutoBackendLocked() const {
+        const auto passed = [this](Probe probe) { return probe_results_[probe].value_or(false); };
+        if (passed(ModelBAvailable) && passed(ModelBSupported)) {
             return BackendType::ModelB_AdHoc;
-        default:
+        }
+        if (probe_results_[ModelASupported].value_or(true)) {
             return BackendType::ModelA_Internet;
         }
+        return BackendType::ModelB_AdHoc;
+    }
+
+    void AnnounceIfChanged() {
+        std::function<void(BackendType)> listener;
+        BackendType choice;
+        bool prewarm = false;
+        {
+            std::lock_guard<std::mutex> lock(probe_mutex_);
+            choice = ChooseAutoBackendLocked();
+            if (announced_ == choice) {
+                return;
+            }
+            announced_ = choice;
+            listener = preferred_listener_;
+            prewarm = prewarm_requested_ && choice == BackendType::ModelA_Internet;
+        }
+        if (prewarm) {
+            StartPrewarm();
+        }
+        if (listener) {
+            listener(choice);
+        }
+    }
+
+    void StartPrewarm() {
+        std::lock_guard<std::mutex> lock(prewarm_mutex_);
+        if (prewarmed_network_.valid()) {
+            return;
+        }
+        // Host creation loads or generates the key pair and sets up
+        // transports; Start then runs on the executor as well
+        prewarmed_network_ = background_tasks_.Submit([config = MakeP2PConfig()] {
+            auto network = ModelA::P2PNetworkFactory::Create(
+                ModelA::P2PNetworkFactory::GetDefaultImplementation(), config);
+            if (network) {
+                network->Start();
+            }
+            return network;
+        });
+    }
+
+    ModelA::P2PNetworkConfig MakeP2PConfig() const {
+        ModelA::P2PNetworkConfig config;
+        // The host key is kept beside the configuration file
+        const std::filesystem::path config_path = config_manager_->GetConfigFilePath();
+        if (!config_path.empty()) {
+            config.identity_key_path = (config_path.parent_path() / "p2p_identity.json").string();
+        }
+        return config;
+    }
+
+    std::unique_ptr<ModelA::IP2PNetwork> TakePrewarmedNetwork() {
+        std::lock_guard<std::mutex> lock(prewarm_mutex_);
+        if (!prewarmed_network_.valid()) {
+            return nullptr;
+        }
+        return prewarmed_network_.get();
     }
 
-private:
     std::shared_ptr<ConfigurationManager> config_manager_;
+
+    std::mutex prewarm_mutex_;
+    std::future<std::unique_ptr<ModelA::IP2PNetwork>> prewarmed_network_;
+
+    // Probe results, cached for the factory's lifetime
+    std::mutex probe_mutex_;
+    std::array<std::optional<bool>, ProbeCount> probe_results_{};
+    bool probes_started_ = false;
+    bool probes_settled_ = false;
+    std::condition_variable probes_settled_cv_;
+    bool prewarm_requested_ = false;
+    std::optional<BackendType> announced_;
+    std::function<void(BackendType)> preferred_listener_;
+    std::shared_ptr<TimerWheel> timer_wheel_{TimerWheel::GetShared()};
+    TimerWheel::TimerId probe_deadline_timer_{TimerWheel::INVALID_TIMER_ID};
+
+    // Declared last so it is destroyed first, waiting out running probes
+    // and a running prewarm
+    ExecutorTaskGroup background_tasks_{WorkStealingExecutor::GetShared()};
 };
 
+std::unique_ptr<BackendFactory> CreateBackendFactory(std::shared_ptr<ConfigurationManager> config) {
+    return std::make_unique<ConcreteBackendFactory>(std::move(config));
+}
+
 } // namespace Core::Multiplayer::HLE
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 
 #include "multiplayer_backend.h"
@@ -40,7 +41,41 @@ public:
     
     virtual ~BackendFactory() = default;
     virtual std::unique_ptr<MultiplayerBackend> CreateBackend(BackendType type) = 0;
+
+    /**
+     * Never waits on availability checks. In Auto mode the first call starts
+     * them all concurrently and answers from those finished so far; the
+     * answer may change until IsPreferredBackendSettled.
+     */
     virtual BackendType GetPreferredBackend() = 0;
+    virtual bool IsPreferredBackendSettled() { return true; }
+
+    /**
+     * As GetPreferredBackend, but in Auto mode waits for the checks to
+     * settle, at most their deadline, so the answer is final. For callers
+     * that commit to a backend, e.g. LDN initialization.
+     */
+    virtual BackendType WaitForPreferredBackend() { return GetPreferredBackend(); }
+
+    /**
+     * Called, from a pool thread, each time finished checks change the
+     * preferred backend
+     */
+    virtual void SetPreferredBackendListener(std::function<void(BackendType)> listener) {
+        (void)listener;
+    }
+
+    /**
+     * Called at emulator boot. Starts setting up the preferred backend's
+     * network in the background, so a later CreateBackend of that type
+     * finds it ready instead of paying for host startup when a game opens
+     * LDN. On Windows it also starts the cached capability probes.
+     * Factories without such setup ignore it.
+     */
+    virtual void PrewarmPreferredBackend() {}
 };
 
+// Factory function to create the factory the LDN service bridge uses
+std::unique_ptr<BackendFactory> CreateBackendFactory(std::shared_ptr<ConfigurationManager> config);
+
 } // namespace Core::Multiplayer::HLE
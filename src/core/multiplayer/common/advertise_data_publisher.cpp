@@ -0,0 +1,188 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "advertise_data_publisher.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace Core::Multiplayer {
+
+namespace {
+
+// Offset and length of a run on the wire; a shorter gap is cheaper sent as data
+constexpr size_t RUN_HEADER_SIZE = 4;
+
+bool Equal(std::span<const uint8_t> a, std::span<const uint8_t> b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end());
+}
+
+} // namespace
+
+size_t AdvertiseDataPatch::GetPayloadSize() const {
+    size_t total = 0;
+    for (const auto& run : runs) {
+        total += run.bytes.size();
+    }
+    return total;
+}
+
+AdvertiseDataPatch DiffAdvertiseData(std::span<const uint8_t> base,
+                                     std::span<const uint8_t> target) {
+    AdvertiseDataPatch patch;
+    patch.size = static_cast<uint16_t>(target.size());
+
+    const auto differs = [&](size_t i) { return i >= base.size() || base[i] != target[i]; };
+
+    size_t i = 0;
+    while (i < target.size()) {
+        if (!differs(i)) {
+            ++i;
+            continue;
+        }
+        const size_t start = i;
+        size_t end = i + 1;
+        // Extend over short gaps of equal bytes
+        for (size_t next = end; next < target.size() && next - end < RUN_HEADER_SIZE; ++next) {
+            if (differs(next)) {
+                end = next + 1;
+            }
+        }
+        patch.runs.push_back({static_cast<uint16_t>(start),
+                              std::vector<uint8_t>(target.begin() + start, target.begin() + end)});
+        i = end;
+    }
+    return patch;
+}
+
+bool ApplyAdvertiseDataPatch(const AdvertiseDataPatch& patch, std::vector<uint8_t>& data) {
+    for (const auto& run : patch.runs) {
+        if (size_t{run.offset} + run.bytes.size() > patch.size) {
+            return false;
+        }
+    }
+    if (patch.IsFull()) {
+        data.clear();
+    }
+    data.resize(patch.size);
+    for (const auto& run : patch.runs) {
+        std::copy(run.bytes.begin(), run.bytes.end(), data.begin() + run.offset);
+    }
+    return true;
+}
+
+AdvertiseDataPublisher::AdvertiseDataPublisher(PublishCallback publish,
+                                               std::chrono::milliseconds interval,
+                                               std::shared_ptr<TimerWheel> timer_wheel)
+    : publish_(std::move(publish)), interval_(interval),
+      timer_wheel_(timer_wheel ? std::move(timer_wheel) : TimerWheel::GetShared()) {}
+
+AdvertiseDataPublisher::~AdvertiseDataPublisher() {
+    Reset();
+}
+
+bool AdvertiseDataPublisher::Set(std::span<const uint8_t> data, Clock::time_point now) {
+    if (data.size() > MAX_SIZE) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++statistics_.updates;
+    const bool scheduled = publish_timer_ != TimerWheel::INVALID_TIMER_ID;
+    if ((version_ != 0 || scheduled) && Equal(pending_, data)) {
+        ++statistics_.unchanged;
+        return true;
+    }
+    pending_.assign(data.begin(), data.end());
+
+    if (scheduled) {
+        ++statistics_.coalesced;
+        return true;
+    }
+    if (!last_publish_ || now - *last_publish_ >= interval_) {
+        PublishLocked(now);
+        return true;
+    }
+    ++statistics_.coalesced;
+    ScheduleLocked(now);
+    return true;
+}
+
+void AdvertiseDataPublisher::RequestFull() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    full_requested_ = true;
+}
+
+void AdvertiseDataPublisher::Reset() {
+    TimerWheel::TimerId timer;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.clear();
+        published_.clear();
+        version_ = 0;
+        full_requested_ = false;
+        last_publish_.reset();
+        timer = std::exchange(publish_timer_, TimerWheel::INVALID_TIMER_ID);
+    }
+    // Outside the lock: Cancel waits for a running publish, which takes it
+    if (timer != TimerWheel::INVALID_TIMER_ID) {
+        timer_wheel_->Cancel(timer);
+    }
+}
+
+std::optional<uint32_t> AdvertiseDataPublisher::GetPublishedVersion() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (version_ == 0) {
+        return std::nullopt;
+    }
+    return version_;
+}
+
+AdvertiseDataPublisherStatistics AdvertiseDataPublisher::GetStatistics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return statistics_;
+}
+
+void AdvertiseDataPublisher::PublishLocked(Clock::time_point now) {
+    const bool full = version_ == 0 || full_requested_;
+    if (!full && Equal(pending_, published_)) {
+        return; // Changed and changed back within the interval
+    }
+
+    AdvertiseDataPatch patch;
+    if (full) {
+        patch.size = static_cast<uint16_t>(pending_.size());
+        if (!pending_.empty()) {
+            patch.runs.push_back({0, pending_});
+        }
+    } else {
+        patch = DiffAdvertiseData(published_, pending_);
+        patch.base_version = version_;
+    }
+    // 0 is reserved for "no base"
+    version_ = version_ == UINT32_MAX ? 1 : version_ + 1;
+    patch.version = version_;
+
+    published_ = pending_;
+    last_publish_ = now;
+    full_requested_ = false;
+    ++statistics_.publishes;
+    if (full) {
+        ++statistics_.full_publishes;
+    }
+    statistics_.bytes_published += patch.GetPayloadSize();
+    publish_(patch, published_);
+}
+
+void AdvertiseDataPublisher::ScheduleLocked(Clock::time_point now) {
+    const auto remaining =
+        std::chrono::ceil<std::chrono::milliseconds>(*last_publish_ + interval_ - now);
+    publish_timer_ = timer_wheel_->Schedule(
+        std::max(remaining, std::chrono::milliseconds(1)), [this]() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            publish_timer_ = TimerWheel::INVALID_TIMER_ID;
+            PublishLocked(Clock::now());
+        });
+}
+
+} // namespace Core::Multiplayer
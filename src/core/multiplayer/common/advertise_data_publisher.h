@@ -0,0 +1,131 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "timer_wheel.h"
+
+namespace Core::Multiplayer {
+
+/**
+ * Change from one advertise data blob to the next: the bytes that differ,
+ * as runs, and the new size.
+ */
+struct AdvertiseDataPatch {
+    struct Run {
+        uint16_t offset = 0;
+        std::vector<uint8_t> bytes;
+
+        bool operator==(const Run&) const = default;
+    };
+
+    // Version the runs apply on top of; 0 replaces whatever the receiver has
+    uint32_t base_version = 0;
+    uint32_t version = 0;
+    uint16_t size = 0;
+    std::vector<Run> runs;
+
+    bool IsFull() const {
+        return base_version == 0;
+    }
+
+    // Bytes carried in runs
+    size_t GetPayloadSize() const;
+
+    bool operator==(const AdvertiseDataPatch&) const = default;
+};
+
+/**
+ * Runs turning base into target. Runs closer than a run header are merged.
+ * Versions are left 0.
+ */
+AdvertiseDataPatch DiffAdvertiseData(std::span<const uint8_t> base,
+                                     std::span<const uint8_t> target);
+
+/**
+ * Applies a patch in place; a full patch starts from an empty blob
+ * @return False if a run falls outside the new size
+ */
+bool ApplyAdvertiseDataPatch(const AdvertiseDataPatch& patch, std::vector<uint8_t>& data);
+
+struct AdvertiseDataPublisherStatistics {
+    uint64_t updates = 0;     // Set calls
+    uint64_t unchanged = 0;   // Set calls with the pending data
+    uint64_t coalesced = 0;   // Set calls folded into a later publish
+    uint64_t publishes = 0;
+    uint64_t full_publishes = 0;
+    uint64_t bytes_published = 0; // Run bytes handed to the publish callback
+};
+
+/**
+ * Rate-limited, diffing front end for SetAdvertiseData.
+ *
+ * Some games rewrite their advertise data every frame or change one byte a
+ * second. The publisher publishes at most once per interval: a Set within
+ * the interval of the last publish only replaces the pending data, and a
+ * TimerWheel callback publishes whatever is pending when the interval ends.
+ * Each publish carries the runs that differ from the last published blob,
+ * or the whole blob the first time and after RequestFull(). Data that went
+ * back to what was published is not published again.
+ *
+ * The callback runs under the publisher's lock, on the thread calling Set
+ * or on the wheel thread, and must not call back into the publisher.
+ */
+class AdvertiseDataPublisher {
+public:
+    using Clock = std::chrono::steady_clock;
+    using PublishCallback =
+        std::function<void(const AdvertiseDataPatch& patch, std::span<const uint8_t> data)>;
+
+    static constexpr size_t MAX_SIZE = 384; // Service::LDN::AdvertiseDataSizeMax
+    static constexpr std::chrono::milliseconds DEFAULT_INTERVAL{1000};
+
+    explicit AdvertiseDataPublisher(PublishCallback publish,
+                                    std::chrono::milliseconds interval = DEFAULT_INTERVAL,
+                                    std::shared_ptr<TimerWheel> timer_wheel = nullptr);
+    ~AdvertiseDataPublisher();
+
+    AdvertiseDataPublisher(const AdvertiseDataPublisher&) = delete;
+    AdvertiseDataPublisher& operator=(const AdvertiseDataPublisher&) = delete;
+
+    // @return False if data is larger than MAX_SIZE
+    bool Set(std::span<const uint8_t> data, Clock::time_point now = Clock::now());
+
+    // The next publish replaces the blob, for a receiver that lost track
+    void RequestFull();
+
+    // Forgets the published and pending data, e.g. when the network is destroyed
+    void Reset();
+
+    std::optional<uint32_t> GetPublishedVersion() const;
+    AdvertiseDataPublisherStatistics GetStatistics() const;
+
+private:
+    void PublishLocked(Clock::time_point now);
+    void ScheduleLocked(Clock::time_point now);
+
+    const PublishCallback publish_;
+    const std::chrono::milliseconds interval_;
+    std::shared_ptr<TimerWheel> timer_wheel_;
+
+    mutable std::mutex mutex_;
+    std::vector<uint8_t> pending_;
+    std::vector<uint8_t> published_;
+    uint32_t version_ = 0; // 0 until the first publish
+    bool full_requested_ = false;
+    std::optional<Clock::time_point> last_publish_;
+    TimerWheel::TimerId publish_timer_{TimerWheel::INVALID_TIMER_ID}; // guarded by mutex_
+    AdvertiseDataPublisherStatistics statistics_;
+};
+
+} // namespace Core::Multiplayer
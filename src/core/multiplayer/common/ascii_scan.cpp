@@ -0,0 +1,63 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "ascii_scan.h"
+#include "cpu_features.h"
+
+#include <bit>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace Core::Multiplayer {
+
+// 16 bytes at a time with baseline vectors, otherwise 8 at a time in a
+// general purpose register
+const uint8_t* SkipAsciiBaseline(const uint8_t* s, const uint8_t* end) {
+#if defined(__SSE2__) || defined(_M_X64)
+    while (end - s >= 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+        const int high_bits = _mm_movemask_epi8(chunk);
+        if (high_bits != 0) {
+            return s + std::countr_zero(static_cast<unsigned>(high_bits));
+        }
+        s += 16;
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    while (end - s >= 16) {
+        if (vmaxvq_u8(vld1q_u8(s)) >= 0x80) {
+            break; // the scalar loop below finds the exact byte
+        }
+        s += 16;
+    }
+#endif
+    while (end - s >= 8) {
+        uint64_t word;
+        std::memcpy(&word, s, sizeof(word));
+        if ((word & 0x8080808080808080ULL) != 0) {
+            break;
+        }
+        s += 8;
+    }
+    while (s < end && *s < 0x80) {
+        ++s;
+    }
+    return s;
+}
+
+const uint8_t* SkipAscii(const uint8_t* begin, const uint8_t* end) {
+    using Kernel = const uint8_t* (*)(const uint8_t*, const uint8_t*);
+#if defined(SUDACHI_MULTIPLAYER_HAS_AVX2_KERNELS)
+    static const Kernel kernel =
+        SelectKernel<Kernel>({{CpuFeature::Avx2, SkipAsciiAvx2}}, SkipAsciiBaseline);
+#else
+    static const Kernel kernel = SkipAsciiBaseline;
+#endif
+    return kernel(begin, end);
+}
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,24 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstdint>
+
+namespace Core::Multiplayer {
+
+/**
+ * Skips the run of ASCII bytes at begin
+ * @return The first byte with its high bit set, or end
+ */
+const uint8_t* SkipAscii(const uint8_t* begin, const uint8_t* end);
+
+// Variants SkipAscii picks between. The baseline one needs only what every
+// build targets (SSE2 on x86-64, NEON on AArch64); the others must only be
+// called when GetCpuFeatures() has their feature. SkipAsciiAvx2 is declared
+// for every build but only defined where SUDACHI_MULTIPLAYER_HAS_AVX2_KERNELS
+// is, so callers check that first.
+const uint8_t* SkipAsciiBaseline(const uint8_t* begin, const uint8_t* end);
+const uint8_t* SkipAsciiAvx2(const uint8_t* begin, const uint8_t* end);
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,52 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Built with AVX2 enabled. Nothing inline from shared headers is used here,
+// since the linker could keep this file's AVX2 copy for every caller.
+
+#include "ascii_scan.h"
+
+#include <immintrin.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace Core::Multiplayer {
+
+namespace {
+
+unsigned LowestSetBit(unsigned bits) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index = 0;
+    _BitScanForward(&index, bits);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(bits));
+#endif
+}
+
+} // namespace
+
+const uint8_t* SkipAsciiAvx2(const uint8_t* s, const uint8_t* end) {
+    // Two vectors per round, as room messages are mostly long ASCII runs
+    while (end - s >= 64) {
+        const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s));
+        const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + 32));
+        if (_mm256_movemask_epi8(_mm256_or_si256(low, high)) != 0) {
+            break;
+        }
+        s += 64;
+    }
+    while (end - s >= 32) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s));
+        const auto high_bits = static_cast<unsigned>(_mm256_movemask_epi8(chunk));
+        if (high_bits != 0) {
+            return s + LowestSetBit(high_bits);
+        }
+        s += 32;
+    }
+    return SkipAsciiBaseline(s, end);
+}
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "async_task.h"
+
+#include <algorithm>
+
+namespace Core::Multiplayer {
+
+CancellationToken::CallbackId CancellationToken::Register(std::function<void()> callback) const {
+    if (!state_) {
+        return INVALID_CALLBACK_ID;
+    }
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (!state_->cancelled.load(std::memory_order_relaxed)) {
+            const CallbackId id = state_->next_id++;
+            state_->callbacks.emplace_back(id, std::move(callback));
+            return id;
+        }
+    }
+    callback();
+    return INVALID_CALLBACK_ID;
+}
+
+void CancellationToken::Unregister(CallbackId id) const {
+    if (!state_ || id == INVALID_CALLBACK_ID) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    std::erase_if(state_->callbacks, [id](const auto& entry) { return entry.first == id; });
+}
+
+void CancellationSource::Cancel() {
+    std::vector<std::pair<CancellationToken::CallbackId, std::function<void()>>> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (state_->cancelled.exchange(true, std::memory_order_acq_rel)) {
+            return;
+        }
+        callbacks.swap(state_->callbacks);
+    }
+    // Outside the lock: a callback may resume a coroutine that unregisters
+    for (auto& [id, callback] : callbacks) {
+        callback();
+    }
+}
+
+} // namespace Core::Multiplayer
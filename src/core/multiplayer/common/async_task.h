@@ -0,0 +1,448 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "timer_wheel.h"
+#include "work_stealing_executor.h"
+
+namespace Core::Multiplayer {
+
+/**
+ * Cancellation flag shared by a CancellationSource and its tokens.
+ * Callbacks registered on a token run once, on the thread calling Cancel().
+ */
+class CancellationToken {
+public:
+    using CallbackId = uint64_t;
+    static constexpr CallbackId INVALID_CALLBACK_ID = 0;
+
+    // A token that is never cancelled
+    CancellationToken() = default;
+
+    bool IsCancellationRequested() const {
+        return state_ && state_->cancelled.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Runs callback on cancellation, or right away if already cancelled
+     * @return Id for Unregister, or INVALID_CALLBACK_ID if it already ran or
+     *         the token cannot be cancelled
+     */
+    CallbackId Register(std::function<void()> callback) const;
+    void Unregister(CallbackId id) const;
+
+private:
+    friend class CancellationSource;
+
+    struct State {
+        std::atomic<bool> cancelled{false};
+        std::mutex mutex;
+        CallbackId next_id = 1;
+        std::vector<std::pair<CallbackId, std::function<void()>>> callbacks;
+    };
+
+    explicit CancellationToken(std::shared_ptr<State> state) : state_(std::move(state)) {}
+
+    std::shared_ptr<State> state_;
+};
+
+class CancellationSource {
+public:
+    CancellationSource() : state_(std::make_shared<CancellationToken::State>()) {}
+
+    CancellationToken GetToken() const {
+        return CancellationToken(state_);
+    }
+
+    // Sets the flag and runs the registered callbacks; later calls do nothing
+    void Cancel();
+
+    bool IsCancellationRequested() const {
+        return state_->cancelled.load(std::memory_order_acquire);
+    }
+
+private:
+    std::shared_ptr<CancellationToken::State> state_;
+};
+
+template <typename T = void>
+class Task;
+
+namespace Detail {
+
+struct TaskPromiseBase {
+    struct FinalAwaiter {
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            return handle.promise().continuation;
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    std::suspend_always initial_suspend() const noexcept {
+        return {};
+    }
+
+    FinalAwaiter final_suspend() const noexcept {
+        return {};
+    }
+
+    void unhandled_exception() {
+        exception = std::current_exception();
+    }
+
+    void RethrowIfFailed() const {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    std::coroutine_handle<> continuation = std::noop_coroutine();
+    std::exception_ptr exception;
+};
+
+template <typename T>
+struct TaskPromise : TaskPromiseBase {
+    Task<T> get_return_object();
+
+    void return_value(T result) {
+        value.emplace(std::move(result));
+    }
+
+    T TakeResult() {
+        RethrowIfFailed();
+        return std::move(*value);
+    }
+
+    std::optional<T> value;
+};
+
+template <>
+struct TaskPromise<void> : TaskPromiseBase {
+    Task<void> get_return_object();
+
+    void return_void() const noexcept {}
+
+    void TakeResult() const {
+        RethrowIfFailed();
+    }
+};
+
+// Fire-and-forget driver for StartTask; frees itself when done
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() const noexcept {
+            return {};
+        }
+        std::suspend_never initial_suspend() const noexcept {
+            return {};
+        }
+        std::suspend_never final_suspend() const noexcept {
+            return {};
+        }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept {
+            std::terminate();
+        }
+    };
+};
+
+} // namespace Detail
+
+/**
+ * Lazily started coroutine producing a T.
+ *
+ * Nothing runs until the task is awaited or handed to StartTask. Awaiting
+ * one task from another transfers control directly, so a chain of steps
+ * uses no thread while it waits on I/O: each step suspends on an awaitable
+ * below and is resumed on the executor when its result is in.
+ */
+template <typename T>
+class [[nodiscard]] Task {
+public:
+    using promise_type = Detail::TaskPromise<T>;
+
+    Task() = default;
+
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            Destroy();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() {
+        Destroy();
+    }
+
+    auto operator co_await() && noexcept {
+        struct Awaiter {
+            std::coroutine_handle<promise_type> handle;
+
+            bool await_ready() const noexcept {
+                return !handle || handle.done();
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+
+            T await_resume() {
+                return handle.promise().TakeResult();
+            }
+        };
+        return Awaiter{handle_};
+    }
+
+private:
+    friend struct Detail::TaskPromise<T>;
+
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+    void Destroy() {
+        if (handle_) {
+            handle_.destroy();
+            handle_ = nullptr;
+        }
+    }
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+namespace Detail {
+
+template <typename T>
+Task<T> TaskPromise<T>::get_return_object() {
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() {
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+template <typename T, typename OnComplete>
+DetachedTask RunDetached(Task<T> task, OnComplete on_complete) {
+    if constexpr (std::is_void_v<T>) {
+        co_await std::move(task);
+        on_complete();
+    } else {
+        on_complete(co_await std::move(task));
+    }
+}
+
+// Resumes a suspended coroutine on the executor, or inline once it shuts down
+inline void ResumeOnExecutor(WorkStealingExecutor& executor, std::coroutine_handle<> handle) {
+    if (!executor.Post([handle] { handle.resume(); })) {
+        handle.resume();
+    }
+}
+
+/**
+ * State shared by a suspended awaiter and whoever completes it: the
+ * callback, a timer or a cancellation. The first to complete it sets the
+ * result; the rest drop theirs. The coroutine resumes once both the result
+ * is in and await_suspend has returned, so await_suspend may still use the
+ * awaiter after starting the operation.
+ */
+template <typename T>
+struct Completion {
+    std::coroutine_handle<> handle;
+    std::shared_ptr<WorkStealingExecutor> executor;
+    std::atomic<bool> claimed{false};
+    std::atomic<int> outstanding{2}; // The result and the end of await_suspend
+    std::optional<T> result;
+
+    void Complete(std::optional<T> value) {
+        if (claimed.exchange(true, std::memory_order_acq_rel)) {
+            return;
+        }
+        result = std::move(value);
+        if (Release()) {
+            ResumeOnExecutor(*executor, handle);
+        }
+    }
+
+    // @return True for the last of the two, which resumes the coroutine
+    bool Release() {
+        return outstanding.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    }
+};
+
+} // namespace Detail
+
+/**
+ * Runs a task to completion without waiting for it. It starts on the
+ * calling thread and continues wherever its awaitables resume it; then
+ * on_complete gets its result. The task must not throw.
+ */
+template <typename T, typename OnComplete>
+void StartTask(Task<T> task, OnComplete on_complete) {
+    Detail::RunDetached(std::move(task), std::move(on_complete));
+}
+
+template <typename T>
+void StartTask(Task<T> task) {
+    if constexpr (std::is_void_v<T>) {
+        StartTask(std::move(task), [] {});
+    } else {
+        StartTask(std::move(task), [](T) {});
+    }
+}
+
+/**
+ * co_await ResumeOn(executor) continues the coroutine on one of the
+ * executor's workers, e.g. to leave a network thread that completed a step
+ */
+inline auto ResumeOn(std::shared_ptr<WorkStealingExecutor> executor =
+                         WorkStealingExecutor::GetShared()) {
+    struct Awaiter {
+        std::shared_ptr<WorkStealingExecutor> executor;
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> handle) const {
+            Detail::ResumeOnExecutor(*executor, handle);
+        }
+
+        void await_resume() const noexcept {}
+    };
+    return Awaiter{std::move(executor)};
+}
+
+/**
+ * Adapts a callback-style call to co_await. start is called with a
+ * std::function<void(T)> to hand to the call; the coroutine resumes on the
+ * executor with the value it is called with, or with std::nullopt if the
+ * token is cancelled first. A late callback after cancellation is dropped.
+ */
+template <typename T, typename Start>
+auto AwaitCallback(Start start, CancellationToken token = {},
+                   std::shared_ptr<WorkStealingExecutor> executor =
+                       WorkStealingExecutor::GetShared()) {
+    struct Awaiter {
+        Start start;
+        CancellationToken token;
+        std::shared_ptr<Detail::Completion<T>> completion;
+        CancellationToken::CallbackId cancel_id = CancellationToken::INVALID_CALLBACK_ID;
+
+        bool await_ready() const noexcept {
+            return token.IsCancellationRequested();
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle) {
+            completion->handle = handle;
+            cancel_id = token.Register([completion = completion] { completion->Complete(std::nullopt); });
+            start(std::function<void(T)>([completion = completion](T value) {
+                completion->Complete(std::move(value));
+            }));
+            // Completed already: carry on here instead of through the executor
+            return !completion->Release();
+        }
+
+        std::optional<T> await_resume() {
+            token.Unregister(cancel_id);
+            return std::move(completion->result);
+        }
+    };
+    auto completion = std::make_shared<Detail::Completion<T>>();
+    completion->executor = std::move(executor);
+    return Awaiter{std::move(start), std::move(token), std::move(completion)};
+}
+
+/**
+ * Suspends for the duration on the timer wheel and resumes on the executor
+ * @return False if the token was cancelled first
+ */
+inline auto Delay(std::chrono::milliseconds duration, CancellationToken token = {},
+                  std::shared_ptr<WorkStealingExecutor> executor =
+                      WorkStealingExecutor::GetShared(),
+                  std::shared_ptr<TimerWheel> timer_wheel = TimerWheel::GetShared()) {
+    struct Awaiter {
+        std::chrono::milliseconds duration;
+        CancellationToken token;
+        std::shared_ptr<TimerWheel> timer_wheel;
+        std::shared_ptr<Detail::Completion<bool>> completion;
+        CancellationToken::CallbackId cancel_id = CancellationToken::INVALID_CALLBACK_ID;
+        TimerWheel::TimerId timer = TimerWheel::INVALID_TIMER_ID;
+
+        bool await_ready() const noexcept {
+            return token.IsCancellationRequested();
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle) {
+            completion->handle = handle;
+            cancel_id = token.Register([completion = completion] { completion->Complete(false); });
+            // Timer callbacks must not block, so the wheel thread only posts the resume
+            timer = timer_wheel->Schedule(duration, [completion = completion] { completion->Complete(true); });
+            if (timer == TimerWheel::INVALID_TIMER_ID) {
+                completion->Complete(true); // The wheel is shut down
+            }
+            return !completion->Release();
+        }
+
+        bool await_resume() {
+            if (!completion->result) {
+                return false; // Cancelled before suspending
+            }
+            token.Unregister(cancel_id);
+            if (!*completion->result) {
+                timer_wheel->Cancel(timer);
+            }
+            return *completion->result;
+        }
+    };
+    auto completion = std::make_shared<Detail::Completion<bool>>();
+    completion->executor = std::move(executor);
+    return Awaiter{duration, std::move(token), std::move(timer_wheel), std::move(completion)};
+}
+
+/**
+ * Waits for a future without parking a thread on get(): the coroutine
+ * checks it, and while it is not ready sleeps on the timer wheel with a
+ * backoff from 1 ms up to max_poll_interval
+ * @return std::nullopt if the token was cancelled first
+ */
+template <typename T>
+Task<std::optional<T>> AwaitFuture(std::future<T> future, CancellationToken token = {},
+                                   std::chrono::milliseconds max_poll_interval =
+                                       std::chrono::milliseconds(50)) {
+    std::chrono::milliseconds interval(1);
+    while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        if (!co_await Delay(interval, token)) {
+            co_return std::nullopt;
+        }
+        interval = std::min(interval * 2, max_poll_interval);
+    }
+    co_return future.get();
+}
+
+} // namespace Core::Multiplayer
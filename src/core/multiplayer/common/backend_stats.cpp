@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "backend_stats.h"
+
+namespace Core::Multiplayer {
+
+namespace {
+
+constexpr uint64_t RATE_WINDOW_NS = 1'000'000'000;
+
+} // anonymous namespace
+
+void BackendStatsRecorder::TrafficWriter::Add(size_t payload_bytes, size_t wire_bytes,
+                                              uint64_t now_ns) {
+    ++traffic.packets;
+    traffic.payload_bytes += payload_bytes;
+    traffic.wire_bytes += wire_bytes;
+
+    if (window_start_ns == 0) {
+        window_start_ns = now_ns;
+    }
+    const uint64_t elapsed = now_ns > window_start_ns ? now_ns - window_start_ns : 0;
+    if (elapsed >= RATE_WINDOW_NS) {
+        traffic.bytes_per_second = window_bytes * RATE_WINDOW_NS / elapsed;
+        window_start_ns = now_ns;
+        window_bytes = 0;
+    }
+    window_bytes += payload_bytes;
+}
+
+void BackendStatsRecorder::OnSent(uint8_t node_id, size_t payload_bytes, size_t wire_bytes,
+                                  uint64_t now_ns) {
+    const size_t slot = SlotFor(node_id);
+    auto& writer = send_writers_[slot];
+    writer.Add(payload_bytes, wire_bytes, now_ns);
+    sent_[slot].Store(writer.traffic);
+}
+
+void BackendStatsRecorder::OnReceived(uint8_t node_id, size_t wire_bytes, size_t payload_bytes,
+                                      uint64_t now_ns) {
+    const size_t slot = SlotFor(node_id);
+    auto& writer = receive_writers_[slot];
+    writer.Add(payload_bytes, wire_bytes, now_ns);
+    received_[slot].Store(writer.traffic);
+}
+
+void BackendStatsRecorder::OnFecCounts(uint64_t packets_recovered, uint64_t packets_lost) {
+    fec_.Store(FecCounts{packets_recovered, packets_lost});
+}
+
+void BackendStatsRecorder::ReportLink(uint8_t node_id, const NodeLinkSample& sample) {
+    if (node_id >= BackendStats::MAX_NODES) {
+        return;
+    }
+    std::lock_guard lock(link_mutex_);
+    links_[node_id].Store(Link{true, sample});
+}
+
+void BackendStatsRecorder::Fill(BackendStats& out_stats) const {
+    out_stats.node_count = 0;
+    out_stats.payload_bytes_sent = 0;
+    out_stats.wire_bytes_sent = 0;
+    out_stats.payload_bytes_received = 0;
+    out_stats.wire_bytes_received = 0;
+    out_stats.encryption_overhead_bytes = 0;
+    const FecCounts fec = fec_.Load();
+    out_stats.fec_packets_recovered = fec.recovered;
+    out_stats.fec_packets_lost = fec.lost;
+    out_stats.memory = GetMemoryStatistics();
+    out_stats.startup = GetStartupReport();
+
+    for (size_t slot = 0; slot < SLOTS; ++slot) {
+        const Traffic sent = sent_[slot].Load();
+        const Traffic received = received_[slot].Load();
+        out_stats.payload_bytes_sent += sent.payload_bytes;
+        out_stats.wire_bytes_sent += sent.wire_bytes;
+        out_stats.payload_bytes_received += received.payload_bytes;
+        out_stats.wire_bytes_received += received.wire_bytes;
+        if (slot == BackendStats::MAX_NODES) {
+            break;
+        }
+
+        const Link link = links_[slot].Load();
+        if (sent.packets == 0 && received.packets == 0 && !link.reported) {
+            continue;
+        }
+        NodeStats& node = out_stats.nodes[out_stats.node_count++];
+        node = NodeStats{};
+        node.node_id = static_cast<uint8_t>(slot);
+        node.transport = link.sample.transport;
+        node.rtt = link.sample.rtt;
+        node.jitter = link.sample.jitter;
+        node.loss_rate = link.sample.loss_rate;
+        node.one_way_delay = link.sample.one_way_delay;
+        node.clock_offset = link.sample.clock_offset;
+        node.clock_confidence = link.sample.clock_confidence;
+        node.packets_sent = sent.packets;
+        node.packets_received = received.packets;
+        node.payload_bytes_sent = sent.payload_bytes;
+        node.wire_bytes_sent = sent.wire_bytes;
+        node.payload_bytes_received = received.payload_bytes;
+        node.wire_bytes_received = received.wire_bytes;
+        // Charged at the overhead last reported for the link
+        node.encryption_overhead_bytes = sent.packets * link.sample.encryption_overhead;
+        node.send_bytes_per_second = sent.bytes_per_second;
+        node.receive_bytes_per_second = received.bytes_per_second;
+        out_stats.encryption_overhead_bytes += node.encryption_overhead_bytes;
+    }
+}
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,184 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include "memory_accounting.h"
+#include "seqlock.h"
+#include "startup_profile.h"
+
+namespace Core::Multiplayer {
+
+/**
+ * How a node's packets travel
+ */
+enum class LinkTransport : uint8_t {
+    Unknown,
+    Direct, // P2P connection
+    Relay,  // Through a relay server
+    AdHoc,  // Local wireless
+};
+
+/**
+ * What the transport knows about its link to a node, reported to the
+ * backend whenever it changes
+ */
+struct NodeLinkSample {
+    LinkTransport transport = LinkTransport::Unknown;
+    std::chrono::microseconds rtt{0};
+    std::chrono::microseconds jitter{0};
+    float loss_rate = 0.0f; // Fraction of packets lost, 0..1
+    // Bytes the transport's encryption adds to every packet
+    uint32_t encryption_overhead = 0;
+    // From the node's ClockSyncEstimator; zero until its clock is synchronized
+    std::chrono::microseconds one_way_delay{0};
+    std::chrono::microseconds clock_offset{0};
+    float clock_confidence = 0.0f;
+};
+
+/**
+ * Per-node numbers in BackendStats
+ */
+struct NodeStats {
+    uint8_t node_id = 0;
+    LinkTransport transport = LinkTransport::Unknown;
+    std::chrono::microseconds rtt{0};
+    std::chrono::microseconds jitter{0};
+    float loss_rate = 0.0f;
+    std::chrono::microseconds one_way_delay{0};
+    std::chrono::microseconds clock_offset{0}; // The node's clock minus ours
+    float clock_confidence = 0.0f;
+
+    uint64_t packets_sent = 0;
+    uint64_t packets_received = 0;
+    uint64_t payload_bytes_sent = 0; // As handed to the backend
+    uint64_t wire_bytes_sent = 0;    // After delta coding and parity, before encryption
+    uint64_t payload_bytes_received = 0;
+    uint64_t wire_bytes_received = 0;
+    uint64_t encryption_overhead_bytes = 0; // Added by the transport to what was sent
+
+    // Payload throughput over the latest one-second window with traffic
+    uint64_t send_bytes_per_second = 0;
+    uint64_t receive_bytes_per_second = 0;
+};
+
+/**
+ * Snapshot filled by MultiplayerBackend::GetStatistics
+ */
+struct BackendStats {
+    static constexpr size_t MAX_NODES = 8; // Service::LDN::NodeCountMax
+
+    // Nodes that have sent, received or reported a link, in node id order
+    std::array<NodeStats, MAX_NODES> nodes{};
+    size_t node_count = 0;
+
+    size_t receive_queue_depth = 0;
+    size_t receive_queue_capacity = 0;
+
+    // Backend totals, nodes beyond MAX_NODES included
+    uint64_t payload_bytes_sent = 0;
+    uint64_t wire_bytes_sent = 0;
+    uint64_t payload_bytes_received = 0;
+    uint64_t wire_bytes_received = 0;
+    uint64_t encryption_overhead_bytes = 0;
+    uint64_t fec_packets_recovered = 0;
+    uint64_t fec_packets_lost = 0;
+    // Datagrams dropped for a bad CRC32C trailer, on sessions that use one
+    uint64_t integrity_failures = 0;
+
+    // Filled by LdnServiceBridge: service calls made, and those that ran
+    // past its watchdog threshold
+    uint64_t service_calls = 0;
+    uint64_t slow_service_calls = 0;
+
+    // Process-wide heap use per subsystem, shared by every backend
+    MemoryStatistics memory;
+    // Process-wide timings of multiplayer bring-up
+    StartupReport startup;
+};
+
+/**
+ * Per-node traffic counters and link reports behind GetStatistics.
+ *
+ * The send path, the receive path and link reports each publish their own
+ * seqlock per node, so every writer stays single-threaded and Fill() only
+ * copies: polling it every frame takes no lock and never stalls the data
+ * path. Link reports are rare and serialized by a mutex.
+ */
+class BackendStatsRecorder {
+public:
+    // Send thread: a packet of payload_bytes that went out as wire_bytes
+    void OnSent(uint8_t node_id, size_t payload_bytes, size_t wire_bytes, uint64_t now_ns);
+    // Network thread: a packet that arrived as wire_bytes and was queued as payload_bytes
+    void OnReceived(uint8_t node_id, size_t wire_bytes, size_t payload_bytes, uint64_t now_ns);
+    // Network thread: running totals from the FEC decoder
+    void OnFecCounts(uint64_t packets_recovered, uint64_t packets_lost);
+    void ReportLink(uint8_t node_id, const NodeLinkSample& sample);
+
+    // Fills everything but the queue depths, which the owner adds
+    void Fill(BackendStats& out_stats) const;
+
+private:
+    struct Traffic {
+        uint64_t packets = 0;
+        uint64_t payload_bytes = 0;
+        uint64_t wire_bytes = 0;
+        uint64_t bytes_per_second = 0;
+    };
+
+    // Writer-side state for one direction of one node
+    struct TrafficWriter {
+        Traffic traffic;
+        uint64_t window_start_ns = 0;
+        uint64_t window_bytes = 0;
+
+        void Add(size_t payload_bytes, size_t wire_bytes, uint64_t now_ns);
+    };
+
+    struct Link {
+        bool reported = false;
+        NodeLinkSample sample;
+    };
+
+    struct FecCounts {
+        uint64_t recovered = 0;
+        uint64_t lost = 0;
+    };
+
+    static constexpr size_t SLOTS = BackendStats::MAX_NODES + 1; // Last one sums the rest
+
+    static size_t SlotFor(uint8_t node_id) {
+        return node_id < BackendStats::MAX_NODES ? node_id : BackendStats::MAX_NODES;
+    }
+
+    // Owned by the send and network threads respectively
+    std::array<TrafficWriter, SLOTS> send_writers_{};
+    std::array<TrafficWriter, SLOTS> receive_writers_{};
+
+    std::array<SeqLock<Traffic>, SLOTS> sent_{};
+    std::array<SeqLock<Traffic>, SLOTS> received_{};
+    std::array<SeqLock<Link>, BackendStats::MAX_NODES> links_{};
+    SeqLock<FecCounts> fec_;
+    std::mutex link_mutex_;
+};
+
+/**
+ * Stands in for BackendStatsRecorder when instrumentation is compiled out,
+ * see build_policy.h; Fill leaves the snapshot empty
+ */
+class NullBackendStatsRecorder {
+public:
+    void OnSent(uint8_t, size_t, size_t, uint64_t) {}
+    void OnReceived(uint8_t, size_t, size_t, uint64_t) {}
+    void OnFecCounts(uint64_t, uint64_t) {}
+    void ReportLink(uint8_t, const NodeLinkSample&) {}
+    void Fill(BackendStats&) const {}
+};
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,105 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "bandwidth_estimator.h"
+
+#include <algorithm>
+
+namespace Core::Multiplayer {
+
+BandwidthEstimator::BandwidthEstimator(const BandwidthEstimatorConfig& config)
+    : config_(config) {
+    config_.rate_window = std::max(config_.rate_window, std::chrono::milliseconds(1));
+    config_.min_rate = std::max<uint64_t>(config_.min_rate, 1);
+    config_.max_rate = std::max(config_.max_rate, config_.min_rate);
+    window_started_ = Clock::now();
+}
+
+void BandwidthEstimator::OnPacketArrived(size_t bytes, Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto gap =
+        std::chrono::duration_cast<std::chrono::microseconds>(now - last_arrival_);
+    const bool paired = has_arrival_ && bytes >= config_.min_pair_bytes &&
+                        gap.count() > 0 && gap <= config_.max_pair_gap;
+    has_arrival_ = true;
+    last_arrival_ = now;
+    if (!paired) {
+        return;
+    }
+
+    const uint64_t rate = std::min(
+        static_cast<uint64_t>(bytes) * 1'000'000 / static_cast<uint64_t>(gap.count()),
+        config_.max_rate);
+    pair_rates_[pair_next_] = rate;
+    pair_next_ = (pair_next_ + 1) % PAIR_HISTORY;
+    pair_count_ = std::min(pair_count_ + 1, PAIR_HISTORY);
+    ++estimate_.pair_samples;
+
+    // Third quartile: widened pairs fall below it, compressed ones above
+    std::array<uint64_t, PAIR_HISTORY> sorted = pair_rates_;
+    const auto quartile = sorted.begin() + (pair_count_ * 3) / 4;
+    std::nth_element(sorted.begin(), quartile, sorted.begin() + pair_count_);
+    estimate_.bottleneck_bytes_per_second = std::max(*quartile, config_.min_rate);
+    UpdateAvailableLocked();
+}
+
+void BandwidthEstimator::OnBytesSent(uint64_t bytes, Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    RollWindowLocked(now);
+    window_sent_ += bytes;
+}
+
+void BandwidthEstimator::OnBytesAcked(uint64_t bytes, Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    RollWindowLocked(now);
+    window_acked_ += bytes;
+}
+
+BandwidthEstimate BandwidthEstimator::GetEstimate() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return estimate_;
+}
+
+void BandwidthEstimator::Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    estimate_ = {};
+    has_arrival_ = false;
+    pair_rates_.fill(0);
+    pair_next_ = 0;
+    pair_count_ = 0;
+    window_started_ = Clock::now();
+    window_sent_ = 0;
+    window_acked_ = 0;
+}
+
+void BandwidthEstimator::RollWindowLocked(Clock::time_point now) {
+    const auto elapsed = now - window_started_;
+    if (elapsed < config_.rate_window) {
+        return;
+    }
+
+    const auto elapsed_us = std::max<int64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count(), 1);
+    estimate_.send_bytes_per_second = window_sent_ * 1'000'000 / elapsed_us;
+    estimate_.delivery_bytes_per_second = window_acked_ * 1'000'000 / elapsed_us;
+    // Nothing acknowledged at all is a dead path, not a slow one
+    estimate_.queue_building =
+        window_acked_ > 0 &&
+        static_cast<double>(window_sent_) >
+            static_cast<double>(window_acked_) * (1.0 + config_.queue_tolerance);
+    window_started_ = now;
+    window_sent_ = 0;
+    window_acked_ = 0;
+    UpdateAvailableLocked();
+}
+
+void BandwidthEstimator::UpdateAvailableLocked() {
+    if (estimate_.queue_building) {
+        estimate_.available_bytes_per_second = std::clamp(
+            estimate_.delivery_bytes_per_second, config_.min_rate, config_.max_rate);
+    } else {
+        estimate_.available_bytes_per_second = estimate_.bottleneck_bytes_per_second;
+    }
+}
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,98 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace Core::Multiplayer {
+
+struct BandwidthEstimatorConfig {
+    // Arrivals further apart than this were not queued back to back at the
+    // bottleneck, so their spacing says nothing about it
+    std::chrono::microseconds max_pair_gap{10'000};
+    // Smaller packets are left out of pairs; their spacing is mostly
+    // per-packet overhead rather than serialization time
+    size_t min_pair_bytes = 200;
+    // Sent and acknowledged bytes are turned into rates over windows this long
+    std::chrono::milliseconds rate_window{500};
+    // Sends outrunning deliveries by more than this share build a queue
+    double queue_tolerance = 0.25;
+    uint64_t min_rate = 16 * 1024;    // bytes/s, about 128 Kbps
+    uint64_t max_rate = 125'000'000;  // bytes/s, 1 Gbps
+};
+
+struct BandwidthEstimate {
+    // Bottleneck capacity from packet-pair dispersion; 0 until measured
+    uint64_t bottleneck_bytes_per_second = 0;
+    // Over the last complete rate window
+    uint64_t send_bytes_per_second = 0;
+    uint64_t delivery_bytes_per_second = 0;
+    // Sends outran what the path delivered: the difference is queuing
+    bool queue_building = false;
+    // What the path can take: the delivery rate while a queue builds,
+    // otherwise the bottleneck; 0 when neither is known
+    uint64_t available_bytes_per_second = 0;
+    uint64_t pair_samples = 0;
+};
+
+/**
+ * Passive available-bandwidth estimate of one link, from traffic that flows
+ * anyway; nothing is sent to probe it.
+ *
+ * Two packets that left the bottleneck back to back arrive spaced by the
+ * time it took to serialize the second, so size over spacing is its
+ * capacity. Pacing and cross traffic only ever widen the spacing, which is
+ * why the estimate is an upper percentile of recent pairs rather than their
+ * mean. Pairs further apart than max_pair_gap are ignored.
+ *
+ * Capacity says nothing about what other traffic leaves of it, so the rate
+ * at which sent bytes are acknowledged is compared with the rate they are
+ * sent at: while sends outrun acknowledgements a queue is building, and the
+ * delivery rate is all the path has to offer.
+ */
+class BandwidthEstimator {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t PAIR_HISTORY = 16;
+
+    explicit BandwidthEstimator(const BandwidthEstimatorConfig& config = {});
+
+    BandwidthEstimator(const BandwidthEstimator&) = delete;
+    BandwidthEstimator& operator=(const BandwidthEstimator&) = delete;
+
+    // Every packet received over the link, in arrival order
+    void OnPacketArrived(size_t bytes, Clock::time_point now = Clock::now());
+    // Bytes sent that the far end will acknowledge, and those it has
+    void OnBytesSent(uint64_t bytes, Clock::time_point now = Clock::now());
+    void OnBytesAcked(uint64_t bytes, Clock::time_point now = Clock::now());
+
+    BandwidthEstimate GetEstimate() const;
+
+    // Forgets everything, e.g. after moving to another path
+    void Reset();
+
+private:
+    void RollWindowLocked(Clock::time_point now);
+    void UpdateAvailableLocked();
+
+    BandwidthEstimatorConfig config_;
+
+    mutable std::mutex mutex_;
+    BandwidthEstimate estimate_;
+    bool has_arrival_ = false;
+    Clock::time_point last_arrival_;
+    std::array<uint64_t, PAIR_HISTORY> pair_rates_{};
+    size_t pair_next_ = 0;
+    size_t pair_count_ = 0;
+    Clock::time_point window_started_;
+    uint64_t window_sent_ = 0;
+    uint64_t window_acked_ = 0;
+};
+
+} // namespace Core::Multiplayer
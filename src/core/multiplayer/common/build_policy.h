@@ -0,0 +1,88 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+/**
+ * Compile-time feature set of the multiplayer stack.
+ *
+ * A build target picks its policy in src/core/multiplayer/CMakeLists.txt
+ * (SUDACHI_MULTIPLAYER_BUILD_POLICY, Desktop unless building for a phone).
+ * Code tests ActiveBuildPolicy with if constexpr, so features a policy
+ * leaves out are not compiled into the data path at all rather than
+ * branched around per packet. Runtime configuration can narrow a policy
+ * further but never widen it.
+ */
+
+#include <cstdint>
+#include <type_traits>
+
+namespace Core::Multiplayer {
+
+// libp2p transports built into the host
+template <bool Tcp, bool Quic, bool WebSocket>
+struct TransportSet {
+    static constexpr bool tcp = Tcp;
+    static constexpr bool quic = Quic;
+    static constexpr bool websocket = WebSocket;
+};
+
+enum class CipherSelection : uint8_t {
+    CpuProbe,         // Whichever is faster on the CPU, decided at startup
+    ChaCha20Poly1305, // Fast everywhere without needing AES instructions
+    Aes256Gcm,
+};
+
+// How the data-plane AEAD is chosen
+template <CipherSelection Cipher>
+struct EncryptionPolicy {
+    static constexpr CipherSelection cipher = Cipher;
+};
+
+enum class ValidationLevel : uint8_t {
+    Basic, // Size, header and content checks of each packet
+    Full,  // Plus global and per-client rate limits, for hosts facing many clients
+};
+
+template <ValidationLevel Level>
+struct ValidationPolicy {
+    static constexpr ValidationLevel level = Level;
+};
+
+// Per-packet counters and latency histograms
+template <bool Enabled>
+struct InstrumentationPolicy {
+    static constexpr bool enabled = Enabled;
+
+    // Real when instrumentation is built in, otherwise its do-nothing stand-in
+    template <typename Real, typename Null>
+    using Select = std::conditional_t<Enabled, Real, Null>;
+};
+
+template <typename TransportsT, typename EncryptionT, typename ValidationT,
+          typename InstrumentationT>
+struct BuildPolicy {
+    using Transports = TransportsT;
+    using Encryption = EncryptionT;
+    using Validation = ValidationT;
+    using Instrumentation = InstrumentationT;
+};
+
+using DesktopBuildPolicy =
+    BuildPolicy<TransportSet<true, true, true>, EncryptionPolicy<CipherSelection::CpuProbe>,
+                ValidationPolicy<ValidationLevel::Full>, InstrumentationPolicy<true>>;
+
+// QUIC only, since it survives the network switches TCP connections do not;
+// networks that block UDP fall back to the relay
+using MobileBuildPolicy =
+    BuildPolicy<TransportSet<false, true, false>,
+                EncryptionPolicy<CipherSelection::ChaCha20Poly1305>,
+                ValidationPolicy<ValidationLevel::Basic>, InstrumentationPolicy<false>>;
+
+#ifdef SUDACHI_MULTIPLAYER_MOBILE_BUILD
+using ActiveBuildPolicy = MobileBuildPolicy;
+#else
+using ActiveBuildPolicy = DesktopBuildPolicy;
+#endif
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,345 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "bulk_transfer.h"
+
+#include <algorithm>
+
+#include "crc32c.h"
+
+namespace Core::Multiplayer {
+
+namespace {
+
+enum MessageType : uint8_t {
+    TYPE_OFFER = 1,
+    TYPE_ACK = 2,
+    TYPE_CHUNK = 3,
+    TYPE_REWIND = 4,
+    TYPE_CANCEL = 5,
+    TYPE_REFUSE = 6,
+};
+
+void WriteU32(uint8_t* out, uint32_t value) {
+    for (size_t i = 0; i < 4; ++i) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+uint32_t ReadU32(const uint8_t* in) {
+    return static_cast<uint32_t>(in[0]) | (static_cast<uint32_t>(in[1]) << 8) |
+           (static_cast<uint32_t>(in[2]) << 16) | (static_cast<uint32_t>(in[3]) << 24);
+}
+
+} // namespace
+
+BulkTransferChannel::BulkTransferChannel(const BulkTransferConfig& config, SendCallback send,
+                                         CompleteCallback on_complete)
+    : config_(config), send_(std::move(send)), on_complete_(std::move(on_complete)) {}
+
+std::optional<uint32_t> BulkTransferChannel::Send(std::vector<uint8_t> data) {
+    if (data.empty() || data.size() > config_.max_transfer_size ||
+        data.size() > UINT32_MAX) {
+        return std::nullopt;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (outgoing_.size() >= config_.max_transfers) {
+        return std::nullopt;
+    }
+    const uint32_t transfer_id = next_transfer_id_++;
+    Outgoing& transfer = outgoing_[transfer_id];
+    transfer.crc = Crc32c(data);
+    transfer.data = std::make_shared<const std::vector<uint8_t>>(std::move(data));
+    SendOfferLocked(transfer_id, transfer);
+    return transfer_id;
+}
+
+void BulkTransferChannel::Cancel(uint32_t transfer_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (outgoing_.erase(transfer_id) != 0) {
+        SendControlLocked(TYPE_CANCEL, transfer_id);
+    }
+}
+
+bool BulkTransferChannel::SendControlLocked(uint8_t type, uint32_t transfer_id,
+                                            std::optional<uint32_t> first,
+                                            std::optional<uint32_t> second) {
+    uint8_t message[HEADER_SIZE + 8];
+    message[0] = type;
+    WriteU32(message + 1, transfer_id);
+    size_t size = HEADER_SIZE;
+    for (const auto& field : {first, second}) {
+        if (field) {
+            WriteU32(message + size, *field);
+            size += 4;
+        }
+    }
+    return send_(std::span<const uint8_t>(message, size));
+}
+
+bool BulkTransferChannel::SendOfferLocked(uint32_t transfer_id, Outgoing& transfer) {
+    transfer.offered = SendControlLocked(TYPE_OFFER, transfer_id,
+                                         static_cast<uint32_t>(transfer.data->size()),
+                                         transfer.crc);
+    return transfer.offered;
+}
+
+void BulkTransferChannel::PumpLocked(uint32_t transfer_id, Outgoing& transfer) {
+    const std::vector<uint8_t>& data = *transfer.data;
+    const uint64_t window = uint64_t{config_.window_chunks} * config_.chunk_size;
+    while (transfer.next_offset < data.size() &&
+           transfer.next_offset - transfer.acknowledged < window) {
+        const size_t offset = static_cast<size_t>(transfer.next_offset);
+        const size_t length = std::min(config_.chunk_size, data.size() - offset);
+        const std::span<const uint8_t> chunk(data.data() + offset, length);
+
+        message_buffer_.resize(CHUNK_HEADER_SIZE + length);
+        message_buffer_[0] = TYPE_CHUNK;
+        WriteU32(message_buffer_.data() + 1, transfer_id);
+        WriteU32(message_buffer_.data() + HEADER_SIZE, static_cast<uint32_t>(offset));
+        WriteU32(message_buffer_.data() + HEADER_SIZE + 4, Crc32c(chunk));
+        std::copy(chunk.begin(), chunk.end(), message_buffer_.begin() + CHUNK_HEADER_SIZE);
+        if (!send_(message_buffer_)) {
+            // The channel is full; Poll picks up from here
+            return;
+        }
+        if (transfer.next_offset < transfer.sent_offset) {
+            chunks_resent_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            chunks_sent_.fetch_add(1, std::memory_order_relaxed);
+        }
+        transfer.next_offset += length;
+        transfer.sent_offset = std::max(transfer.sent_offset, transfer.next_offset);
+    }
+}
+
+void BulkTransferChannel::AnswerLocked(uint32_t transfer_id, Incoming& transfer) {
+    const uint64_t verified = transfer.data.size();
+    if (transfer.rewind_owed) {
+        if (SendControlLocked(TYPE_REWIND, transfer_id, static_cast<uint32_t>(verified))) {
+            transfer.rewind_owed = false;
+            transfer.acknowledged = verified;
+        }
+        return;
+    }
+    if (transfer.acknowledged == verified) {
+        return;
+    }
+    if (SendControlLocked(TYPE_ACK, transfer_id, static_cast<uint32_t>(verified))) {
+        transfer.acknowledged = verified;
+    }
+}
+
+void BulkTransferChannel::Receive(std::span<const uint8_t> message) {
+    if (message.size() < HEADER_SIZE) {
+        return;
+    }
+    const uint8_t type = message[0];
+    const uint32_t transfer_id = ReadU32(message.data() + 1);
+    const auto field = [&](size_t index) {
+        return ReadU32(message.data() + HEADER_SIZE + 4 * index);
+    };
+    const size_t fields = (message.size() - HEADER_SIZE) / 4;
+
+    std::optional<std::vector<uint8_t>> completed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        switch (type) {
+        case TYPE_OFFER:
+            if (fields >= 2) {
+                HandleOfferLocked(transfer_id, field(0), field(1));
+            }
+            break;
+        case TYPE_ACK:
+        case TYPE_REWIND:
+            if (fields >= 1) {
+                HandleAckLocked(transfer_id, field(0), type == TYPE_REWIND);
+            }
+            break;
+        case TYPE_CHUNK:
+            if (message.size() > CHUNK_HEADER_SIZE) {
+                completed = HandleChunkLocked(transfer_id, field(0), field(1),
+                                              message.subspan(CHUNK_HEADER_SIZE));
+            }
+            break;
+        case TYPE_CANCEL:
+            incoming_.erase(transfer_id);
+            break;
+        case TYPE_REFUSE:
+            if (outgoing_.erase(transfer_id) != 0) {
+                transfers_refused_.fetch_add(1, std::memory_order_relaxed);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    if (completed && on_complete_) {
+        on_complete_(transfer_id, std::move(*completed));
+    }
+}
+
+void BulkTransferChannel::HandleOfferLocked(uint32_t transfer_id, uint32_t total, uint32_t crc) {
+    const auto finished = std::find_if(finished_.begin(), finished_.end(), [&](const Finished& f) {
+        return f.transfer_id == transfer_id;
+    });
+    if (finished != finished_.end()) {
+        finished->acknowledged = SendControlLocked(TYPE_ACK, transfer_id, finished->total);
+        return;
+    }
+
+    auto it = incoming_.find(transfer_id);
+    if (it != incoming_.end() && (it->second.total != total || it->second.crc != crc)) {
+        // The sender's data changed while it was away; its old part is useless
+        incoming_.erase(it);
+        it = incoming_.end();
+    }
+    if (it == incoming_.end()) {
+        if (total == 0 || total > config_.max_transfer_size ||
+            incoming_.size() >= config_.max_transfers) {
+            SendControlLocked(TYPE_REFUSE, transfer_id);
+            return;
+        }
+        it = incoming_.emplace(transfer_id, Incoming{}).first;
+        it->second.total = total;
+        it->second.crc = crc;
+        it->second.data.reserve(total);
+    }
+    // An answer is owed even if nothing changed since the last one
+    it->second.acknowledged.reset();
+    AnswerLocked(transfer_id, it->second);
+}
+
+void BulkTransferChannel::HandleAckLocked(uint32_t transfer_id, uint32_t verified, bool rewind) {
+    const auto it = outgoing_.find(transfer_id);
+    if (it == outgoing_.end() || verified > it->second.data->size()) {
+        return;
+    }
+    Outgoing& transfer = it->second;
+    if (!transfer.accepted || rewind) {
+        // The receiver's offset is where sending picks up
+        if (!transfer.accepted && verified != 0) {
+            resumed_.fetch_add(1, std::memory_order_relaxed);
+        }
+        transfer.accepted = true;
+        transfer.acknowledged = verified;
+        transfer.next_offset = verified;
+    } else if (verified > transfer.acknowledged) {
+        transfer.acknowledged = verified;
+        transfer.next_offset = std::max(transfer.next_offset, transfer.acknowledged);
+    }
+    if (transfer.acknowledged == transfer.data->size()) {
+        transfers_sent_.fetch_add(1, std::memory_order_relaxed);
+        outgoing_.erase(it);
+        return;
+    }
+    PumpLocked(transfer_id, transfer);
+}
+
+std::optional<std::vector<uint8_t>> BulkTransferChannel::HandleChunkLocked(
+    uint32_t transfer_id, uint32_t offset, uint32_t crc, std::span<const uint8_t> data) {
+    const auto it = incoming_.find(transfer_id);
+    if (it == incoming_.end()) {
+        return std::nullopt;
+    }
+    Incoming& transfer = it->second;
+    if (offset != transfer.data.size() || data.size() > transfer.total - offset) {
+        // Sent before a rewind or a resume took effect; dropped
+        return std::nullopt;
+    }
+    chunks_received_.fetch_add(1, std::memory_order_relaxed);
+    if (Crc32c(data) != crc) {
+        checksum_failures_.fetch_add(1, std::memory_order_relaxed);
+        transfer.rewind_owed = true;
+        AnswerLocked(transfer_id, transfer);
+        return std::nullopt;
+    }
+    transfer.data.insert(transfer.data.end(), data.begin(), data.end());
+
+    if (transfer.data.size() < transfer.total) {
+        // Half a window between acknowledgements keeps the sender moving
+        const uint64_t interval = uint64_t{std::max<uint16_t>(config_.window_chunks / 2, 1)} *
+                                  config_.chunk_size;
+        if (!transfer.acknowledged || transfer.data.size() - *transfer.acknowledged >= interval) {
+            AnswerLocked(transfer_id, transfer);
+        }
+        return std::nullopt;
+    }
+
+    if (Crc32c(transfer.data) != transfer.crc) {
+        // Every chunk checked out but the whole does not: start over
+        checksum_failures_.fetch_add(1, std::memory_order_relaxed);
+        transfer.data.clear();
+        transfer.rewind_owed = true;
+        AnswerLocked(transfer_id, transfer);
+        return std::nullopt;
+    }
+    Finished finished{transfer_id, transfer.total, false};
+    finished.acknowledged = SendControlLocked(TYPE_ACK, transfer_id, transfer.total);
+    if (finished_.size() == MAX_FINISHED) {
+        finished_.pop_front();
+    }
+    finished_.push_back(finished);
+    std::vector<uint8_t> completed = std::move(transfer.data);
+    incoming_.erase(it);
+    transfers_received_.fetch_add(1, std::memory_order_relaxed);
+    return completed;
+}
+
+void BulkTransferChannel::Poll() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& [transfer_id, transfer] : outgoing_) {
+        if (!transfer.offered) {
+            SendOfferLocked(transfer_id, transfer);
+        } else if (transfer.accepted) {
+            PumpLocked(transfer_id, transfer);
+        }
+    }
+    for (auto& [transfer_id, transfer] : incoming_) {
+        AnswerLocked(transfer_id, transfer);
+    }
+    for (Finished& finished : finished_) {
+        if (!finished.acknowledged) {
+            finished.acknowledged =
+                SendControlLocked(TYPE_ACK, finished.transfer_id, finished.total);
+        }
+    }
+}
+
+void BulkTransferChannel::OnReconnected() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& [transfer_id, transfer] : outgoing_) {
+        // Whatever was in flight went down with the old connection
+        transfer.accepted = false;
+        SendOfferLocked(transfer_id, transfer);
+    }
+}
+
+std::optional<BulkTransferProgress> BulkTransferChannel::GetProgress(uint32_t transfer_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = outgoing_.find(transfer_id);
+    if (it == outgoing_.end()) {
+        return std::nullopt;
+    }
+    return BulkTransferProgress{it->second.acknowledged, it->second.data->size()};
+}
+
+size_t BulkTransferChannel::GetOutgoingCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return outgoing_.size();
+}
+
+BulkTransferStatistics BulkTransferChannel::GetStatistics() const {
+    BulkTransferStatistics statistics;
+    statistics.chunks_sent = chunks_sent_.load(std::memory_order_relaxed);
+    statistics.chunks_resent = chunks_resent_.load(std::memory_order_relaxed);
+    statistics.chunks_received = chunks_received_.load(std::memory_order_relaxed);
+    statistics.checksum_failures = checksum_failures_.load(std::memory_order_relaxed);
+    statistics.resumed = resumed_.load(std::memory_order_relaxed);
+    statistics.transfers_sent = transfers_sent_.load(std::memory_order_relaxed);
+    statistics.transfers_received = transfers_received_.load(std::memory_order_relaxed);
+    statistics.transfers_refused = transfers_refused_.load(std::memory_order_relaxed);
+    return statistics;
+}
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,182 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace Core::Multiplayer {
+
+struct BulkTransferConfig {
+    // Payload bytes per chunk; each chunk is one channel message
+    size_t chunk_size = 1024;
+    // Chunks sent ahead of the receiver's acknowledgement. Keep it below
+    // ChannelMultiplexer::WINDOW so acknowledgements and offers still fit
+    uint16_t window_chunks = 16;
+    // Offers of larger blobs are refused
+    size_t max_transfer_size = 16 * 1024 * 1024;
+    // Transfers of each direction held at once
+    size_t max_transfers = 4;
+};
+
+struct BulkTransferProgress {
+    uint64_t acknowledged = 0; // Bytes the receiver has verified
+    uint64_t total = 0;
+};
+
+struct BulkTransferStatistics {
+    uint64_t chunks_sent = 0;
+    uint64_t chunks_resent = 0;    // Sent again after a resume or a checksum failure
+    uint64_t chunks_received = 0;
+    uint64_t checksum_failures = 0;
+    uint64_t resumed = 0;          // Transfers continued from a nonzero offset
+    uint64_t transfers_sent = 0;
+    uint64_t transfers_received = 0;
+    uint64_t transfers_refused = 0;
+};
+
+/**
+ * Background transfer of large blobs, such as island data or map and
+ * loadout sync, over a reliable channel of the connection the game
+ * traffic already uses.
+ *
+ * A blob is offered, then sent in chunks that each carry a CRC32C; at most
+ * window_chunks are in flight ahead of the receiver's acknowledgement,
+ * which names how many bytes it has verified. A chunk that fails its
+ * checksum makes the receiver ask for everything from its verified offset
+ * again. The receiver keeps partial blobs across reconnects, so after
+ * OnReconnected re-offers the unfinished transfers, each one continues from
+ * the offset the receiver acknowledges instead of from zero; a CRC32C over
+ * the whole blob catches a sender whose data changed in between.
+ *
+ * Messages go out through the send callback, e.g. ChannelMultiplexer::Send
+ * on a ReliableOrdered channel the config puts in the bulk class, or
+ * IP2PNetwork::SendMessage with SendPriority::Bulk, so the transfer only
+ * uses what realtime traffic leaves over; the owner feeds what arrives on
+ * that channel to Receive. A refused send is retried on the next Poll.
+ *
+ * Wire format, little-endian, type (1) and transfer id (4) first:
+ *   OFFER  total size (4), blob CRC32C (4)
+ *   ACK    verified bytes (4)
+ *   CHUNK  offset (4), chunk CRC32C (4), data
+ *   REWIND verified bytes (4): resend from there
+ *   CANCEL the sender gave up; REFUSE the receiver will not take it
+ *
+ * Thread-safe. The send callback runs under the lock, so the owner must not
+ * feed a message back into the same endpoint from it; the complete
+ * callback runs outside it.
+ */
+class BulkTransferChannel {
+public:
+    using SendCallback = std::function<bool(std::span<const uint8_t> message)>;
+    using CompleteCallback = std::function<void(uint32_t transfer_id, std::vector<uint8_t> data)>;
+
+    static constexpr size_t HEADER_SIZE = 5;
+    static constexpr size_t CHUNK_HEADER_SIZE = HEADER_SIZE + 8;
+
+    BulkTransferChannel(const BulkTransferConfig& config, SendCallback send,
+                        CompleteCallback on_complete);
+
+    BulkTransferChannel(const BulkTransferChannel&) = delete;
+    BulkTransferChannel& operator=(const BulkTransferChannel&) = delete;
+
+    /**
+     * Offers a blob and starts sending it
+     * @return Its transfer id; nothing if it is empty or too large, or
+     *         max_transfers are already being sent
+     */
+    std::optional<uint32_t> Send(std::vector<uint8_t> data);
+    // Stops an outgoing transfer and tells the receiver to drop its part
+    void Cancel(uint32_t transfer_id);
+
+    // Handles a message from the channel
+    void Receive(std::span<const uint8_t> message);
+
+    // Sends what the windows allow, e.g. once a frame or from a timer
+    void Poll();
+
+    /**
+     * After the connection was re-established: offers every unfinished
+     * outgoing transfer again and waits for the receiver's offset
+     */
+    void OnReconnected();
+
+    // Nothing once the transfer finished, was cancelled or never existed
+    std::optional<BulkTransferProgress> GetProgress(uint32_t transfer_id) const;
+    size_t GetOutgoingCount() const;
+    BulkTransferStatistics GetStatistics() const;
+
+private:
+    struct Outgoing {
+        std::shared_ptr<const std::vector<uint8_t>> data;
+        uint32_t crc = 0;
+        uint64_t acknowledged = 0;
+        uint64_t next_offset = 0;
+        // Highest offset sent so far, to tell resent chunks from new ones
+        uint64_t sent_offset = 0;
+        bool offered = false;  // The offer went out
+        bool accepted = false; // The receiver answered it
+    };
+
+    struct Incoming {
+        std::vector<uint8_t> data; // The verified prefix
+        uint32_t total = 0;
+        uint32_t crc = 0;
+        // Verified bytes last acknowledged; nothing until the offer is answered
+        std::optional<uint64_t> acknowledged;
+        bool rewind_owed = false;
+    };
+
+    bool SendControlLocked(uint8_t type, uint32_t transfer_id,
+                           std::optional<uint32_t> first = std::nullopt,
+                           std::optional<uint32_t> second = std::nullopt);
+    bool SendOfferLocked(uint32_t transfer_id, Outgoing& transfer);
+    void PumpLocked(uint32_t transfer_id, Outgoing& transfer);
+    // Acknowledges, or asks for a resend, if the sender is owed either
+    void AnswerLocked(uint32_t transfer_id, Incoming& transfer);
+    void HandleOfferLocked(uint32_t transfer_id, uint32_t total, uint32_t crc);
+    void HandleAckLocked(uint32_t transfer_id, uint32_t verified, bool rewind);
+    std::optional<std::vector<uint8_t>> HandleChunkLocked(uint32_t transfer_id, uint32_t offset,
+                                                          uint32_t crc,
+                                                          std::span<const uint8_t> data);
+
+    const BulkTransferConfig config_;
+    const SendCallback send_;
+    const CompleteCallback on_complete_;
+
+    mutable std::mutex mutex_;
+    std::map<uint32_t, Outgoing> outgoing_;
+    std::map<uint32_t, Incoming> incoming_;
+    // Recently finished incoming transfers, to acknowledge a re-offer whose
+    // final acknowledgement was lost to a reconnect
+    struct Finished {
+        uint32_t transfer_id = 0;
+        uint32_t total = 0;
+        bool acknowledged = false;
+    };
+    static constexpr size_t MAX_FINISHED = 16;
+    std::deque<Finished> finished_;
+    uint32_t next_transfer_id_ = 1;
+    std::vector<uint8_t> message_buffer_;
+
+    std::atomic<uint64_t> chunks_sent_{0};
+    std::atomic<uint64_t> chunks_resent_{0};
+    std::atomic<uint64_t> chunks_received_{0};
+    std::atomic<uint64_t> checksum_failures_{0};
+    std::atomic<uint64_t> resumed_{0};
+    std::atomic<uint64_t> transfers_sent_{0};
+    std::atomic<uint64_t> transfers_received_{0};
+    std::atomic<uint64_t> transfers_refused_{0};
+};
+
+} // namespace Core::Multiplayer
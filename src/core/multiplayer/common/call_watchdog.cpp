@@ -0,0 +1,83 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "call_watchdog.h"
+
+#include <algorithm>
+
+#include "packet_trace.h"
+
+#if __has_include(<execinfo.h>)
+#include <execinfo.h>
+#define MULTIPLAYER_HAS_BACKTRACE 1
+#endif
+
+namespace Core::Multiplayer {
+
+void CallWatchdog::SetThreshold(std::chrono::nanoseconds threshold) {
+    threshold_ns_.store(static_cast<uint64_t>(std::max<int64_t>(threshold.count(), 0)),
+                        std::memory_order_relaxed);
+}
+
+std::chrono::nanoseconds CallWatchdog::GetThreshold() const {
+    return std::chrono::nanoseconds(threshold_ns_.load(std::memory_order_relaxed));
+}
+
+void CallWatchdog::RecordSlowCall(const char* call, uint64_t start_ns, uint64_t elapsed_ns) {
+    SlowCallRecord record;
+    record.call = call;
+    record.duration = std::chrono::nanoseconds(elapsed_ns);
+    record.started_at_ns = start_ns;
+    record.trace_id = MULTIPLAYER_TRACE_ID();
+#ifdef MULTIPLAYER_HAS_BACKTRACE
+    // Taken before the lock so a slow unwind does not hold up readers
+    std::array<void*, SlowCallRecord::MAX_STACK_DEPTH + 2> frames{};
+    const int depth = ::backtrace(frames.data(), static_cast<int>(frames.size()));
+    // Skip this function
+    constexpr int SKIPPED_FRAMES = 1;
+    for (int i = SKIPPED_FRAMES; i < depth; ++i) {
+        record.stack[record.stack_depth++] = frames[static_cast<size_t>(i)];
+    }
+#endif
+
+    slow_calls_.fetch_add(1, std::memory_order_relaxed);
+    std::lock_guard lock(records_mutex_);
+    records_[next_record_] = record;
+    next_record_ = (next_record_ + 1) % RECORD_CAPACITY;
+    record_count_ = std::min(record_count_ + 1, RECORD_CAPACITY);
+    if (record.duration > worst_.duration) {
+        worst_ = record;
+    }
+}
+
+std::vector<SlowCallRecord> CallWatchdog::GetSlowCalls() const {
+    std::lock_guard lock(records_mutex_);
+    std::vector<SlowCallRecord> records;
+    records.reserve(record_count_);
+    const size_t first = (next_record_ + RECORD_CAPACITY - record_count_) % RECORD_CAPACITY;
+    for (size_t i = 0; i < record_count_; ++i) {
+        records.push_back(records_[(first + i) % RECORD_CAPACITY]);
+    }
+    return records;
+}
+
+CallWatchdogStatistics CallWatchdog::GetStatistics() const {
+    CallWatchdogStatistics stats;
+    stats.calls = calls_.load(std::memory_order_relaxed);
+    stats.slow_calls = slow_calls_.load(std::memory_order_relaxed);
+    std::lock_guard lock(records_mutex_);
+    stats.worst_duration = worst_.duration;
+    stats.worst_call = worst_.call;
+    return stats;
+}
+
+void CallWatchdog::Reset() {
+    calls_.store(0, std::memory_order_relaxed);
+    slow_calls_.store(0, std::memory_order_relaxed);
+    std::lock_guard lock(records_mutex_);
+    next_record_ = 0;
+    record_count_ = 0;
+    worst_ = SlowCallRecord{};
+}
+
+} // namespace Core::Multiplayer
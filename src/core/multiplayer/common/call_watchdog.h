@@ -0,0 +1,116 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace Core::Multiplayer {
+
+/**
+ * A call that ran past the watchdog's threshold
+ */
+struct SlowCallRecord {
+    static constexpr size_t MAX_STACK_DEPTH = 16;
+
+    const char* call = nullptr; // Entry point name, a string literal
+    std::chrono::nanoseconds duration{0};
+    uint64_t started_at_ns = 0; // Steady clock
+    uint32_t trace_id = 0;      // Packet trace id when tracing is built in, else 0
+    // Return addresses of the caller chain where the platform can walk it;
+    // symbolize offline, e.g. with addr2line
+    std::array<void*, MAX_STACK_DEPTH> stack{};
+    size_t stack_depth = 0;
+};
+
+/**
+ * Call watchdog statistics
+ */
+struct CallWatchdogStatistics {
+    uint64_t calls = 0;
+    uint64_t slow_calls = 0;
+    std::chrono::nanoseconds worst_duration{0};
+    const char* worst_call = nullptr;
+};
+
+/**
+ * Times calls into a thread the emulator cannot afford to stall, such as the
+ * HLE thread running LDN service calls, and keeps the latest ones that took
+ * longer than a threshold.
+ *
+ * A watched call costs two clock reads and a relaxed counter add. Only a
+ * slow call takes the lock and captures the caller's stack, so the records
+ * point at which service path hitched the frame.
+ */
+class CallWatchdog {
+public:
+    static constexpr size_t RECORD_CAPACITY = 64;
+    // A few hundred microseconds is already a visible share of a 16.67ms frame
+    static constexpr std::chrono::microseconds DEFAULT_THRESHOLD{500};
+
+    class [[nodiscard]] Scope {
+    public:
+        Scope(CallWatchdog& watchdog, const char* call)
+            : watchdog_(watchdog), call_(call), start_ns_(Now()) {}
+        ~Scope() {
+            watchdog_.Finish(call_, start_ns_);
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        CallWatchdog& watchdog_;
+        const char* const call_;
+        const uint64_t start_ns_;
+    };
+
+    // Times the caller's scope as the named call
+    Scope Watch(const char* call) {
+        return Scope(*this, call);
+    }
+
+    void SetThreshold(std::chrono::nanoseconds threshold);
+    std::chrono::nanoseconds GetThreshold() const;
+
+    // Slow calls still in the ring, oldest first
+    std::vector<SlowCallRecord> GetSlowCalls() const;
+    CallWatchdogStatistics GetStatistics() const;
+    void Reset();
+
+    static uint64_t Now() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now().time_since_epoch())
+                                         .count());
+    }
+
+private:
+    void Finish(const char* call, uint64_t start_ns) {
+        const uint64_t elapsed = Now() - start_ns;
+        calls_.fetch_add(1, std::memory_order_relaxed);
+        if (elapsed >= threshold_ns_.load(std::memory_order_relaxed)) {
+            RecordSlowCall(call, start_ns, elapsed);
+        }
+    }
+
+    void RecordSlowCall(const char* call, uint64_t start_ns, uint64_t elapsed_ns);
+
+    std::atomic<uint64_t> threshold_ns_{
+        static_cast<uint64_t>(std::chrono::nanoseconds(DEFAULT_THRESHOLD).count())};
+    std::atomic<uint64_t> calls_{0};
+    std::atomic<uint64_t> slow_calls_{0};
+
+    mutable std::mutex records_mutex_;
+    std::array<SlowCallRecord, RECORD_CAPACITY> records_{};
+    size_t next_record_ = 0;
+    size_t record_count_ = 0;
+    SlowCallRecord worst_;
+};
+
+} // namespace Core::Multiplayer
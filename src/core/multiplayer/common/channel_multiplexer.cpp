@@ -0,0 +1,382 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "channel_multiplexer.h"
+
+#include <algorithm>
+
+namespace Core::Multiplayer {
+
+namespace {
+
+constexpr uint8_t CHANNEL_MASK = 0x0F;
+// Retransmission timeouts stop doubling after this many attempts
+constexpr uint32_t MAX_BACKOFF_SHIFT = 6;
+
+void WriteU16(uint8_t* out, uint16_t value) {
+    out[0] = static_cast<uint8_t>(value);
+    out[1] = static_cast<uint8_t>(value >> 8);
+}
+
+uint16_t ReadU16(const uint8_t* in) {
+    return static_cast<uint16_t>(in[0] | (in[1] << 8));
+}
+
+// Serial-number distance from b to a; negative if a is older
+int16_t Distance(uint16_t a, uint16_t b) {
+    return static_cast<int16_t>(static_cast<uint16_t>(a - b));
+}
+
+} // namespace
+
+ChannelMultiplexer::ChannelMultiplexer(const ChannelConfig& config, SendCallback send,
+                                       DeliverCallback deliver,
+                                       std::shared_ptr<TimerWheel> timer_wheel)
+    : config_(config), send_(std::move(send)), deliver_(std::move(deliver)),
+      timer_wheel_(timer_wheel ? std::move(timer_wheel) : TimerWheel::GetShared()) {
+    const size_t count = std::min(config_.channels.size(), MAX_CHANNELS);
+    send_channels_.resize(count);
+    receive_channels_.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        send_channels_[i].mode = config_.channels[i];
+        receive_channels_[i].mode = config_.channels[i];
+    }
+    if (config_.poll_interval.count() > 0) {
+        poll_timer_ = timer_wheel_->ScheduleRepeating(config_.poll_interval, [this]() { Poll(); });
+    }
+}
+
+ChannelMultiplexer::~ChannelMultiplexer() {
+    if (poll_timer_ != TimerWheel::INVALID_TIMER_ID) {
+        timer_wheel_->Cancel(poll_timer_);
+    }
+}
+
+bool ChannelMultiplexer::Send(uint8_t channel, std::span<const uint8_t> payload) {
+    std::lock_guard<std::mutex> lock(send_mutex_);
+    if (channel >= send_channels_.size()) {
+        return false;
+    }
+    SendChannel& state = send_channels_[channel];
+    if (state.mode == ChannelMode::Unreliable) {
+        return WriteFrameLocked(channel, false, 0, payload);
+    }
+
+    const uint16_t sequence = state.next_sequence;
+    if (state.mode == ChannelMode::UnreliableSequenced) {
+        ++state.next_sequence;
+        return WriteFrameLocked(channel, true, sequence, payload);
+    }
+
+    Unacked& unacked = state.unacked[sequence % WINDOW];
+    if (failed_.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    if (unacked.active) {
+        window_full_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    ++state.next_sequence;
+    unacked.active = true;
+    unacked.sequence = sequence;
+    unacked.sends = 1;
+    unacked.last_sent = Clock::now();
+    unacked.payload.assign(payload.begin(), payload.end());
+    reliable_bytes_sent_.fetch_add(payload.size(), std::memory_order_relaxed);
+    WriteFrameLocked(channel, true, sequence, payload);
+    return true;
+}
+
+bool ChannelMultiplexer::WriteFrameLocked(uint8_t flags, bool has_sequence, uint16_t sequence,
+                                          std::span<const uint8_t> payload) {
+    frame_buffer_.resize(MAX_HEADER_SIZE + payload.size());
+    uint8_t* out = frame_buffer_.data();
+    size_t size = 1;
+    if (has_sequence) {
+        WriteU16(out + size, sequence);
+        size += SEQUENCE_SIZE;
+    }
+
+    const bool can_carry_ack = (flags & FLAG_ACK_ONLY) != 0 ||
+                               FramePriority(config_, std::span(&flags, 1)) != SendPriority::Bulk;
+    if (can_carry_ack) {
+        std::lock_guard<std::mutex> lock(ack_mutex_);
+        for (size_t i = 0; i < MAX_CHANNELS; ++i) {
+            const size_t channel = (next_ack_channel_ + i) % MAX_CHANNELS;
+            PendingAck& ack = pending_acks_[channel];
+            if (!ack.pending) {
+                continue;
+            }
+            flags |= FLAG_ACK;
+            out[size] = static_cast<uint8_t>(channel);
+            WriteU16(out + size + 1, ack.ack);
+            for (size_t byte = 0; byte < 4; ++byte) {
+                out[size + 3 + byte] = static_cast<uint8_t>(ack.bits >> (8 * byte));
+            }
+            size += ACK_SIZE;
+            ack.pending = false;
+            next_ack_channel_ = channel + 1;
+            break;
+        }
+    }
+    if ((flags & FLAG_ACK_ONLY) != 0) {
+        if ((flags & FLAG_ACK) == 0) {
+            return false;
+        }
+        acks_sent_.fetch_add(1, std::memory_order_relaxed);
+    } else if ((flags & FLAG_ACK) != 0) {
+        acks_piggybacked_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    out[0] = flags;
+    std::copy(payload.begin(), payload.end(), out + size);
+    size += payload.size();
+    if ((flags & FLAG_ACK_ONLY) == 0) {
+        sent_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return send_(std::span<const uint8_t>(out, size));
+}
+
+SendPriority ChannelMultiplexer::FramePriority(const ChannelConfig& config,
+                                              std::span<const uint8_t> frame) {
+    if (frame.empty() || (frame[0] & FLAG_ACK_ONLY) != 0) {
+        return SendPriority::Control;
+    }
+    const size_t channel = frame[0] & CHANNEL_MASK;
+    return channel < config.priorities.size() ? config.priorities[channel]
+                                              : SendPriority::Realtime;
+}
+
+void ChannelMultiplexer::Receive(std::span<const uint8_t> frame) {
+    if (frame.empty()) {
+        malformed_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    const uint8_t flags = frame[0];
+    const uint8_t channel = flags & CHANNEL_MASK;
+    const bool ack_only = (flags & FLAG_ACK_ONLY) != 0;
+    if (!ack_only && channel >= receive_channels_.size()) {
+        malformed_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    const bool has_sequence =
+        !ack_only && receive_channels_[channel].mode != ChannelMode::Unreliable;
+    const size_t header_size = 1 + (has_sequence ? SEQUENCE_SIZE : 0) +
+                               ((flags & FLAG_ACK) != 0 ? ACK_SIZE : 0);
+    if (frame.size() < header_size || (ack_only && (flags & FLAG_ACK) == 0)) {
+        malformed_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    size_t offset = 1;
+    uint16_t sequence = 0;
+    if (has_sequence) {
+        sequence = ReadU16(frame.data() + offset);
+        offset += SEQUENCE_SIZE;
+    }
+    if ((flags & FLAG_ACK) != 0) {
+        uint32_t bits = 0;
+        for (size_t byte = 0; byte < 4; ++byte) {
+            bits |= static_cast<uint32_t>(frame[offset + 3 + byte]) << (8 * byte);
+        }
+        HandleAck(frame[offset], ReadU16(frame.data() + offset + 1), bits, Clock::now());
+        offset += ACK_SIZE;
+    }
+    if (ack_only) {
+        return;
+    }
+
+    const auto payload = frame.subspan(offset);
+    std::lock_guard<std::mutex> lock(receive_mutex_);
+    ReceiveChannel& state = receive_channels_[channel];
+    switch (state.mode) {
+    case ChannelMode::Unreliable:
+        break;
+    case ChannelMode::UnreliableSequenced:
+        if (state.started && Distance(sequence, state.next_sequence) < 0) {
+            stale_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        state.started = true;
+        state.next_sequence = static_cast<uint16_t>(sequence + 1);
+        break;
+    case ChannelMode::ReliableOrdered:
+        ReceiveReliable(channel, sequence, payload);
+        return;
+    }
+    delivered_.fetch_add(1, std::memory_order_relaxed);
+    deliver_(channel, payload);
+}
+
+void ChannelMultiplexer::ReceiveReliable(uint8_t channel, uint16_t sequence,
+                                         std::span<const uint8_t> payload) {
+    ReceiveChannel& state = receive_channels_[channel];
+    if (!state.started) {
+        // Both ends start their sequences at zero
+        state.started = true;
+        state.newest = static_cast<uint16_t>(state.next_sequence - 1);
+    }
+
+    const int16_t ahead = Distance(sequence, state.next_sequence);
+    bool accepted = false;
+    if (ahead < 0) {
+        // Delivered already; its ack must have been lost
+        duplicates_.fetch_add(1, std::memory_order_relaxed);
+    } else if (ahead < WINDOW) {
+        Held& held = state.held[sequence % WINDOW];
+        if (held.occupied) {
+            duplicates_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            held.occupied = true;
+            held.sequence = sequence;
+            held.payload.assign(payload.begin(), payload.end());
+            accepted = true;
+            if (Distance(sequence, state.newest) > 0) {
+                state.newest = sequence;
+            }
+        }
+    } else {
+        // Beyond any window the sender can have open
+        malformed_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(ack_mutex_);
+        PendingAck& ack = pending_acks_[channel];
+        if (!ack.pending) {
+            ack.pending = true;
+            ack.due = Clock::now() + config_.ack_delay;
+        }
+        ack.ack = state.newest;
+        ack.bits = AckBitsLocked(state);
+    }
+    if (!accepted) {
+        return;
+    }
+
+    for (;;) {
+        Held& held = state.held[state.next_sequence % WINDOW];
+        if (!held.occupied || held.sequence != state.next_sequence) {
+            break;
+        }
+        held.occupied = false;
+        ++state.next_sequence;
+        delivered_.fetch_add(1, std::memory_order_relaxed);
+        deliver_(channel, held.payload);
+    }
+}
+
+uint32_t ChannelMultiplexer::AckBitsLocked(const ReceiveChannel& channel) const {
+    uint32_t bits = 0;
+    for (uint16_t n = 0; n < WINDOW; ++n) {
+        const uint16_t sequence = static_cast<uint16_t>(channel.newest - 1 - n);
+        const Held& held = channel.held[sequence % WINDOW];
+        const bool received = Distance(sequence, channel.next_sequence) < 0 ||
+                              (held.occupied && held.sequence == sequence);
+        if (received) {
+            bits |= uint32_t{1} << n;
+        }
+    }
+    return bits;
+}
+
+void ChannelMultiplexer::HandleAck(uint8_t channel, uint16_t ack, uint32_t bits,
+                                   Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(send_mutex_);
+    if (channel >= send_channels_.size() ||
+        send_channels_[channel].mode != ChannelMode::ReliableOrdered) {
+        malformed_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    for (auto& unacked : send_channels_[channel].unacked) {
+        if (!unacked.active) {
+            continue;
+        }
+        const int16_t behind = Distance(ack, unacked.sequence);
+        const bool acked = behind == 0 || (behind > 0 && behind <= WINDOW &&
+                                           ((bits >> (behind - 1)) & 1) != 0);
+        if (!acked) {
+            continue;
+        }
+        // Karn's rule: a retransmitted message's ack may answer any copy
+        if (unacked.sends == 1) {
+            rtt_estimator_.AddSample(
+                std::chrono::duration_cast<std::chrono::microseconds>(now - unacked.last_sent));
+        }
+        unacked.active = false;
+        reliable_bytes_acked_.fetch_add(unacked.payload.size(), std::memory_order_relaxed);
+    }
+}
+
+bool ChannelMultiplexer::HasOverdueAck(Clock::time_point now) const {
+    std::lock_guard<std::mutex> lock(ack_mutex_);
+    return std::any_of(pending_acks_.begin(), pending_acks_.end(), [now](const PendingAck& ack) {
+        return ack.pending && ack.due <= now;
+    });
+}
+
+void ChannelMultiplexer::Poll(Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(send_mutex_);
+    const auto timeout = rtt_estimator_.GetRetransmissionTimeout();
+    for (size_t channel = 0; channel < send_channels_.size(); ++channel) {
+        auto& state = send_channels_[channel];
+        if (state.mode != ChannelMode::ReliableOrdered) {
+            continue;
+        }
+        // Oldest first, so the receiver can release the ordered stream soonest
+        for (uint16_t i = 0; i < WINDOW; ++i) {
+            const uint16_t sequence = static_cast<uint16_t>(state.next_sequence - WINDOW + i);
+            Unacked& unacked = state.unacked[sequence % WINDOW];
+            if (!unacked.active || unacked.sequence != sequence) {
+                continue;
+            }
+            const auto backoff = timeout * (1u << std::min(unacked.sends - 1, MAX_BACKOFF_SHIFT));
+            if (now - unacked.last_sent < std::min(backoff, RttEstimator::MAX_RTO)) {
+                continue;
+            }
+            if (unacked.sends > config_.max_retransmits) {
+                failed_.store(true, std::memory_order_release);
+                continue;
+            }
+            ++unacked.sends;
+            unacked.last_sent = now;
+            retransmits_.fetch_add(1, std::memory_order_relaxed);
+            WriteFrameLocked(static_cast<uint8_t>(channel), true, sequence, unacked.payload);
+        }
+    }
+
+    // Anything owed that found no packet to ride on within ack_delay
+    for (size_t i = 0; i < MAX_CHANNELS && HasOverdueAck(now); ++i) {
+        WriteFrameLocked(FLAG_ACK_ONLY, false, 0, {});
+    }
+}
+
+size_t ChannelMultiplexer::GetUnackedCount() const {
+    std::lock_guard<std::mutex> lock(send_mutex_);
+    size_t count = 0;
+    for (const auto& state : send_channels_) {
+        for (const auto& unacked : state.unacked) {
+            count += unacked.active ? 1 : 0;
+        }
+    }
+    return count;
+}
+
+ChannelStatistics ChannelMultiplexer::GetStatistics() const {
+    ChannelStatistics statistics;
+    statistics.sent = sent_.load(std::memory_order_relaxed);
+    statistics.delivered = delivered_.load(std::memory_order_relaxed);
+    statistics.retransmits = retransmits_.load(std::memory_order_relaxed);
+    statistics.acks_piggybacked = acks_piggybacked_.load(std::memory_order_relaxed);
+    statistics.acks_sent = acks_sent_.load(std::memory_order_relaxed);
+    statistics.duplicates = duplicates_.load(std::memory_order_relaxed);
+    statistics.stale = stale_.load(std::memory_order_relaxed);
+    statistics.window_full = window_full_.load(std::memory_order_relaxed);
+    statistics.malformed = malformed_.load(std::memory_order_relaxed);
+    statistics.reliable_bytes_sent = reliable_bytes_sent_.load(std::memory_order_relaxed);
+    statistics.reliable_bytes_acked = reliable_bytes_acked_.load(std::memory_order_relaxed);
+    return statistics;
+}
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,221 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+#include "priority_send_queue.h"
+#include "rtt_estimator.h"
+#include "timer_wheel.h"
+
+namespace Core::Multiplayer {
+
+/**
+ * Delivery guarantees of a channel
+ */
+enum class ChannelMode : uint8_t {
+    Unreliable,          // May be lost, duplicated or reordered; game state
+    UnreliableSequenced, // May be lost; anything older than the newest is dropped
+    ReliableOrdered,     // Retransmitted until acknowledged, delivered in order once
+};
+
+struct ChannelConfig {
+    // Channel ids index this list; at most ChannelMultiplexer::MAX_CHANNELS
+    std::vector<ChannelMode> channels{ChannelMode::ReliableOrdered, ChannelMode::Unreliable,
+                                      ChannelMode::UnreliableSequenced};
+    // Longest an acknowledgement waits for an outgoing packet to ride on
+    std::chrono::milliseconds ack_delay{20};
+    // Retransmissions before a reliable message, and the connection, count as lost
+    uint32_t max_retransmits = 10;
+    // How often the wheel drives Poll; zero leaves it to the owner
+    std::chrono::milliseconds poll_interval{10};
+    // Send class per channel id, for the send callback to pass on (see
+    // FramePriority); channels past its end are realtime
+    std::vector<SendPriority> priorities;
+};
+
+struct ChannelStatistics {
+    uint64_t sent = 0;
+    uint64_t delivered = 0;
+    uint64_t retransmits = 0;
+    uint64_t acks_piggybacked = 0;
+    uint64_t acks_sent = 0;   // Standalone, for want of a packet to ride on
+    uint64_t duplicates = 0;
+    uint64_t stale = 0;       // Sequenced packets older than the newest delivered
+    uint64_t window_full = 0; // Reliable sends refused with WINDOW messages in flight
+    uint64_t malformed = 0;
+    // Reliable payload bytes, first sends only, and those acknowledged; the
+    // rate of the second is what the path delivers, for BandwidthEstimator
+    uint64_t reliable_bytes_sent = 0;
+    uint64_t reliable_bytes_acked = 0;
+};
+
+/**
+ * Unreliable, unreliable-sequenced and reliable-ordered channels over one
+ * datagram connection, in the style of ENet and the classic game networking
+ * ack scheme.
+ *
+ * Reliable messages carry a per-channel sequence number and stay in a send
+ * window until acknowledged. The receiver acknowledges with the newest
+ * sequence it has seen plus a bitfield of the WINDOW before it, riding on
+ * whatever packet it sends next, on any channel; only if none goes out
+ * within ack_delay is a standalone acknowledgement sent. Each ack repeats
+ * the whole window, so a lost one costs nothing once the next arrives.
+ * Unacknowledged messages are resent after the RttEstimator's timeout,
+ * doubling per attempt; after max_retransmits the endpoint is failed, since
+ * the ordered stream behind the message can no longer be delivered.
+ *
+ * Wire format, little-endian:
+ *   flags (1): channel id in bits 0-3, FLAG_ACK, FLAG_ACK_ONLY
+ *   sequence (2), for sequenced and reliable channels
+ *   ack channel (1), ack (2), ack bits (4), with FLAG_ACK
+ *   payload, unless FLAG_ACK_ONLY
+ *
+ * Acknowledgements never ride on a bulk channel's frames, which may wait
+ * behind other traffic; they go out standalone instead.
+ *
+ * Both ends must configure the same channels. Thread-safe; the send
+ * callback runs under the send lock, so frames leave in order, and the
+ * deliver callback under the receive lock, in order per channel. Neither
+ * may feed a frame back into the same endpoint synchronously.
+ */
+class ChannelMultiplexer {
+public:
+    using Clock = std::chrono::steady_clock;
+    using SendCallback = std::function<bool(std::span<const uint8_t> frame)>;
+    using DeliverCallback = std::function<void(uint8_t channel, std::span<const uint8_t> payload)>;
+
+    static constexpr size_t MAX_CHANNELS = 16;
+    // Reliable messages in flight per channel; one per ack bit
+    static constexpr uint16_t WINDOW = 32;
+    static constexpr uint8_t FLAG_ACK = 0x10;
+    static constexpr uint8_t FLAG_ACK_ONLY = 0x20;
+    static constexpr size_t SEQUENCE_SIZE = 2;
+    static constexpr size_t ACK_SIZE = 7;
+    static constexpr size_t MAX_HEADER_SIZE = 1 + SEQUENCE_SIZE + ACK_SIZE;
+
+    ChannelMultiplexer(const ChannelConfig& config, SendCallback send, DeliverCallback deliver,
+                       std::shared_ptr<TimerWheel> timer_wheel = nullptr);
+    ~ChannelMultiplexer();
+
+    ChannelMultiplexer(const ChannelMultiplexer&) = delete;
+    ChannelMultiplexer& operator=(const ChannelMultiplexer&) = delete;
+
+    /**
+     * Frames and sends a message. A reliable one is kept for retransmission
+     * even if this first send fails.
+     * @return False for an unknown channel, a full reliable window or a
+     *         failed endpoint, or if an unreliable send failed
+     */
+    bool Send(uint8_t channel, std::span<const uint8_t> payload);
+
+    // Handles a frame from the connection
+    void Receive(std::span<const uint8_t> frame);
+
+    /**
+     * Send class of a frame under config, for a transport with send classes:
+     * acknowledgement-only frames are control, others take their channel's
+     */
+    static SendPriority FramePriority(const ChannelConfig& config,
+                                      std::span<const uint8_t> frame);
+
+    // Resends overdue reliable messages and sends overdue acknowledgements
+    void Poll(Clock::time_point now = Clock::now());
+
+    // Reliable messages sent and not yet acknowledged, over all channels
+    size_t GetUnackedCount() const;
+    // Set once a reliable message ran out of retransmissions
+    bool IsFailed() const { return failed_.load(std::memory_order_acquire); }
+    ChannelStatistics GetStatistics() const;
+    const RttEstimator& GetRttEstimator() const { return rtt_estimator_; }
+
+private:
+    struct Unacked {
+        bool active = false;
+        uint16_t sequence = 0;
+        uint32_t sends = 0;
+        Clock::time_point last_sent;
+        std::vector<uint8_t> payload;
+    };
+
+    struct SendChannel {
+        ChannelMode mode = ChannelMode::Unreliable;
+        uint16_t next_sequence = 0;
+        std::array<Unacked, WINDOW> unacked{};
+    };
+
+    struct Held {
+        bool occupied = false;
+        uint16_t sequence = 0;
+        std::vector<uint8_t> payload;
+    };
+
+    struct ReceiveChannel {
+        ChannelMode mode = ChannelMode::Unreliable;
+        bool started = false;
+        uint16_t next_sequence = 0; // Reliable: next to deliver; sequenced: oldest still new
+        uint16_t newest = 0;        // Reliable: newest seen, the ack
+        std::array<Held, WINDOW> held{};
+    };
+
+    // Acknowledgement owed per reliable receive channel
+    struct PendingAck {
+        bool pending = false;
+        uint16_t ack = 0;
+        uint32_t bits = 0;
+        Clock::time_point due;
+    };
+
+    // Frames and sends, with an owed acknowledgement riding along if there is one
+    bool WriteFrameLocked(uint8_t flags, bool has_sequence, uint16_t sequence,
+                          std::span<const uint8_t> payload);
+    bool HasOverdueAck(Clock::time_point now) const;
+    void ReceiveReliable(uint8_t channel, uint16_t sequence, std::span<const uint8_t> payload);
+    void HandleAck(uint8_t channel, uint16_t ack, uint32_t bits, Clock::time_point now);
+    uint32_t AckBitsLocked(const ReceiveChannel& channel) const;
+
+    const ChannelConfig config_;
+    const SendCallback send_;
+    const DeliverCallback deliver_;
+    std::shared_ptr<TimerWheel> timer_wheel_;
+    TimerWheel::TimerId poll_timer_{TimerWheel::INVALID_TIMER_ID};
+
+    // Lock order: receive_mutex_ (a deliver callback may send), send_mutex_, ack_mutex_
+    mutable std::mutex send_mutex_;
+    std::vector<SendChannel> send_channels_;
+    std::vector<uint8_t> frame_buffer_;
+
+    std::mutex receive_mutex_;
+    std::vector<ReceiveChannel> receive_channels_;
+
+    mutable std::mutex ack_mutex_;
+    std::array<PendingAck, MAX_CHANNELS> pending_acks_{};
+    size_t next_ack_channel_ = 0;
+
+    RttEstimator rtt_estimator_;
+    std::atomic<bool> failed_{false};
+
+    std::atomic<uint64_t> sent_{0};
+    std::atomic<uint64_t> delivered_{0};
+    std::atomic<uint64_t> retransmits_{0};
+    std::atomic<uint64_t> acks_piggybacked_{0};
+    std::atomic<uint64_t> acks_sent_{0};
+    std::atomic<uint64_t> duplicates_{0};
+    std::atomic<uint64_t> stale_{0};
+    std::atomic<uint64_t> window_full_{0};
+    std::atomic<uint64_t> malformed_{0};
+    std::atomic<uint64_t> reliable_bytes_sent_{0};
+    std::atomic<uint64_t> reliable_bytes_acked_{0};
+};
+
+} // namespace Core::Multiplayer
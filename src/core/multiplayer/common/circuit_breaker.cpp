@@ -2,341 +2,338 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "circuit_breaker.h"
+#include "multiplayer_log.h"
+#include <algorithm>
 #include <chrono>
-#include <thread>
 #include <sstream>
-#include <spdlog/spdlog.h>
 
 namespace Core::Multiplayer {
 
-// Implementation class using PIMPL pattern
-class CircuitBreaker::Impl {
-public:
-    explicit Impl(const CircuitBreakerConfig& config)
-        : config_(config), state_(CircuitBreakerState::Closed), 
-          consecutive_failures_(0), listener_(nullptr) {
-        
-        last_state_change_ = std::chrono::steady_clock::now();
-        
-        // Initialize metrics
-        metrics_.total_requests = 0;
-        metrics_.successful_requests = 0;
-        metrics_.failed_requests = 0;
-        metrics_.rejected_requests = 0;
-        metrics_.consecutive_failures = 0;
-        metrics_.success_rate = 0.0;
-        metrics_.failure_rate = 0.0;
-        metrics_.average_response_time_ms = 0.0;
-        metrics_.min_response_time_ms = 0.0;
-        metrics_.max_response_time_ms = 0.0;
-        metrics_.last_state_change = last_state_change_;
-        metrics_.time_in_current_state = std::chrono::milliseconds(0);
+namespace {
+std::string StateToString(CircuitBreakerState state) {
+    switch (state) {
+        case CircuitBreakerState::Closed: return "Closed";
+        case CircuitBreakerState::Open: return "Open";
+        case CircuitBreakerState::HalfOpen: return "HalfOpen";
+        default: return "Unknown";
     }
+}
 
-    ~Impl() = default;
-
-    ErrorCode ExecuteInternal(std::function<ErrorCode()> operation) {
-        auto start_time = std::chrono::steady_clock::now();
-
-        std::unique_lock<std::mutex> lock(mutex_);
-
-        // Check if circuit is open
-        if (state_ == CircuitBreakerState::Open) {
-            // Check if enough time has passed to transition to half-open
-            auto time_since_open = std::chrono::duration_cast<std::chrono::milliseconds>(
-                start_time - last_state_change_);
-
-            if (time_since_open.count() >= config_.timeout_duration_ms) {
-                TransitionToHalfOpen();
-            } else {
-                metrics_.rejected_requests++;
-                return ErrorCode::ServiceUnavailable;
-            }
-        }
-
-        // If half-open, only allow limited concurrent calls
-        if (state_ == CircuitBreakerState::HalfOpen) {
-            if (half_open_calls_ >= config_.max_concurrent_half_open_calls) {
-                metrics_.rejected_requests++;
-                return ErrorCode::ServiceUnavailable;
-            }
-            half_open_calls_++;
-        }
-
-        metrics_.total_requests++;
-
-        // Release the lock while executing the user operation
-        lock.unlock();
-
-        ErrorCode result;
-        try {
-            result = operation();
-        } catch (...) {
-            result = ErrorCode::InternalError;
-        }
-
-        auto end_time = std::chrono::steady_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
-
-        // Reacquire lock to update metrics and state
-        lock.lock();
-
-        // Update response time metrics
-        UpdateResponseTimeMetrics(duration.count());
-
-        // Handle result
-        if (result == ErrorCode::Success) {
-            OnSuccess();
-        } else {
-            OnFailure(result);
-        }
+// Lower or raise an atomic bound; only contended when a new extreme shows up
+template <typename Compare>
+void UpdateBound(std::atomic<uint64_t>& bound, uint64_t value, Compare better) {
+    uint64_t current = bound.load(std::memory_order_relaxed);
+    while (better(value, current) &&
+           !bound.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+} // namespace
+
+CircuitBreaker::CircuitBreaker(const CircuitBreakerConfig& config,
+                               std::shared_ptr<const ClockSource> clock)
+    : clock_(std::move(clock)), config_(config), failure_threshold_(config.failure_threshold),
+      last_state_change_(Now()),
+      window_size_(std::max<size_t>(config.sliding_window_size, 1)) {
+    window_ = std::make_unique<std::atomic<uint8_t>[]>(window_size_);
+    for (size_t i = 0; i < window_size_; ++i) {
+        window_[i].store(Empty, std::memory_order_relaxed);
+    }
+}
 
-        if (state_ == CircuitBreakerState::HalfOpen) {
-            half_open_calls_--;
-        }
+CircuitBreaker::~CircuitBreaker() = default;
 
-        return result;
+CircuitBreaker::Admission CircuitBreaker::AdmitSlow() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto state = state_.load(std::memory_order_relaxed);
+    if (state == CircuitBreakerState::Closed) {
+        // Closed again since the fast path looked
+        return Admission::Closed;
     }
 
-    CircuitBreakerState GetState() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return state_;
+    if (state == CircuitBreakerState::Open) {
+        // Check if enough time has passed to transition to half-open
+        auto time_since_open = std::chrono::duration_cast<std::chrono::milliseconds>(
+            Now() - last_state_change_);
+        if (time_since_open.count() < config_.timeout_duration_ms) {
+            counters_.Add(RejectedRequests);
+            return Admission::Rejected;
+        }
+        TransitionLocked(CircuitBreakerState::HalfOpen);
     }
 
-    void ForceOpen() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        TransitionTo(CircuitBreakerState::Open);
+    // Half-open only allows limited concurrent calls
+    if (half_open_calls_ >= config_.max_concurrent_half_open_calls) {
+        counters_.Add(RejectedRequests);
+        return Admission::Rejected;
     }
+    half_open_calls_++;
+    return Admission::Trial;
+}
 
-    void ForceHalfOpen() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        TransitionToHalfOpen();
+void CircuitBreaker::RecordOutcome(Admission admission, ErrorCode result,
+                                   std::optional<std::chrono::steady_clock::duration> elapsed) {
+    const bool success = result == ErrorCode::Success;
+    counters_.Add(success ? SuccessfulRequests : FailedRequests);
+
+    if (elapsed) {
+        const auto elapsed_us = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(*elapsed).count());
+        counters_.Add(TimedRequests);
+        counters_.Add(ResponseTimeUs, elapsed_us);
+        UpdateBound(min_response_time_us_, elapsed_us, std::less<>{});
+        UpdateBound(max_response_time_us_, elapsed_us, std::greater<>{});
     }
 
-    void Reset() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        consecutive_failures_ = 0;
-        metrics_.consecutive_failures = 0;
-        TransitionTo(CircuitBreakerState::Closed);
-    }
+    const uint64_t slot = window_cursor_.fetch_add(1, std::memory_order_relaxed) % window_size_;
+    window_[slot].store(success ? SlotSuccess : SlotFailure, std::memory_order_relaxed);
 
-    CircuitBreakerMetrics GetMetrics() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        
-        CircuitBreakerMetrics current_metrics = metrics_;
-        
-        // Update time in current state
-        auto now = std::chrono::steady_clock::now();
-        current_metrics.time_in_current_state = 
-            std::chrono::duration_cast<std::chrono::milliseconds>(now - last_state_change_);
-        
-        // Calculate rates
-        if (current_metrics.total_requests > 0) {
-            current_metrics.success_rate = 
-                static_cast<double>(current_metrics.successful_requests) / current_metrics.total_requests;
-            current_metrics.failure_rate = 
-                static_cast<double>(current_metrics.failed_requests) / current_metrics.total_requests;
+    if (admission == Admission::Trial) {
+        OnTrialOutcome(success);
+    } else if (success) {
+        // Skip the store when already zero so a healthy endpoint's cache
+        // line stays shared between threads
+        if (consecutive_failures_.load(std::memory_order_relaxed) != 0) {
+            consecutive_failures_.store(0, std::memory_order_relaxed);
         }
-        
-        return current_metrics;
+    } else {
+        OnClosedFailure();
     }
+}
 
-    std::string ExportMetricsAsJSON() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        
-        std::ostringstream json;
-        json << "{\n";
-        json << "  \"state\": \"" << StateToString(state_) << "\",\n";
-        json << "  \"total_requests\": " << metrics_.total_requests << ",\n";
-        json << "  \"successful_requests\": " << metrics_.successful_requests << ",\n";
-        json << "  \"failed_requests\": " << metrics_.failed_requests << ",\n";
-        json << "  \"rejected_requests\": " << metrics_.rejected_requests << ",\n";
-        json << "  \"consecutive_failures\": " << metrics_.consecutive_failures << ",\n";
-        json << "  \"success_rate\": " << metrics_.success_rate << ",\n";
-        json << "  \"failure_rate\": " << metrics_.failure_rate << ",\n";
-        json << "  \"average_response_time_ms\": " << metrics_.average_response_time_ms << ",\n";
-        json << "  \"min_response_time_ms\": " << metrics_.min_response_time_ms << ",\n";
-        json << "  \"max_response_time_ms\": " << metrics_.max_response_time_ms << "\n";
-        json << "}";
-        
-        return json.str();
+void CircuitBreaker::OnClosedFailure() {
+    const size_t failures = consecutive_failures_.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (failures < failure_threshold_.load(std::memory_order_relaxed)) {
+        return;
     }
 
-    void SetListener(MockCircuitBreakerListener* listener) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        listener_ = listener;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (listener_) {
+        MULTIPLAYER_LOG_WARN("Circuit breaker: Failure recorded, {} in a row", failures);
     }
-
-    void UpdateConfig(const CircuitBreakerConfig& config) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        config_ = config;
+    // Only a call admitted while Closed may open a still-closed circuit;
+    // a concurrent trial or Force* call has already decided otherwise
+    if (state_.load(std::memory_order_relaxed) == CircuitBreakerState::Closed) {
+        TransitionLocked(CircuitBreakerState::Open);
     }
+}
 
-    CircuitBreakerConfig GetConfig() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return config_;
+void CircuitBreaker::OnTrialOutcome(bool success) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (half_open_calls_ > 0) {
+        half_open_calls_--;
+    }
+    if (state_.load(std::memory_order_relaxed) != CircuitBreakerState::HalfOpen) {
+        return;
     }
 
-private:
-    // These functions expect mutex_ to be locked by the caller
-    void OnSuccess() {
-        metrics_.successful_requests++;
-        consecutive_failures_ = 0;
-        metrics_.consecutive_failures = 0;
-        
-        if (listener_) {
-            if (spdlog::should_log(spdlog::level::info)) {
-                spdlog::info("Circuit breaker: Success recorded");
-            }
-        }
-        
-        // If in half-open state and we've had enough successes, close the circuit
-        if (state_ == CircuitBreakerState::HalfOpen && 
-            metrics_.successful_requests >= config_.success_threshold_for_close) {
-            TransitionTo(CircuitBreakerState::Closed);
-        }
+    if (!success) {
+        // A failed trial reopens the circuit straight away
+        consecutive_failures_.fetch_add(1, std::memory_order_relaxed);
+        TransitionLocked(CircuitBreakerState::Open);
+        return;
     }
 
-    void OnFailure(ErrorCode error) {
-        metrics_.failed_requests++;
-        consecutive_failures_++;
-        metrics_.consecutive_failures = consecutive_failures_;
-        
-        if (listener_) {
-            if (spdlog::should_log(spdlog::level::warn)) {
-                spdlog::warn("Circuit breaker: Failure recorded, error {}", static_cast<int>(error));
-            }
-        }
-        
-        // Check if we should open the circuit
-        if ((state_ == CircuitBreakerState::Closed || state_ == CircuitBreakerState::HalfOpen) &&
-            consecutive_failures_ >= config_.failure_threshold) {
-            TransitionTo(CircuitBreakerState::Open);
-        }
+    // Enough successful trials close the circuit
+    half_open_successes_++;
+    if (half_open_successes_ >= config_.success_threshold_for_close) {
+        TransitionLocked(CircuitBreakerState::Closed);
     }
+}
 
-    void TransitionTo(CircuitBreakerState new_state) {
-        CircuitBreakerState old_state = state_;
-        state_ = new_state;
-        last_state_change_ = std::chrono::steady_clock::now();
-        metrics_.last_state_change = last_state_change_;
-        
-        if (new_state == CircuitBreakerState::Open) {
-            if (listener_) {
-                if (spdlog::should_log(spdlog::level::warn)) {
-                    spdlog::warn("Circuit breaker: Circuit opened after {} failures", consecutive_failures_);
-                }
-            }
-        } else if (new_state == CircuitBreakerState::Closed) {
-            if (listener_) {
-                if (spdlog::should_log(spdlog::level::info)) {
-                    spdlog::info("Circuit breaker: Circuit closed");
-                }
-            }
-        } else if (new_state == CircuitBreakerState::HalfOpen) {
-            half_open_calls_ = 0;
-            if (listener_) {
-                if (spdlog::should_log(spdlog::level::info)) {
-                    spdlog::info("Circuit breaker: Half-open test started");
-                }
-            }
-        }
+// Expects mutex_ to be locked by the caller
+void CircuitBreaker::TransitionLocked(CircuitBreakerState new_state) {
+    CircuitBreakerState old_state = state_.load(std::memory_order_relaxed);
+    last_state_change_ = Now();
 
+    if (new_state == CircuitBreakerState::Open) {
         if (listener_) {
-            if (spdlog::should_log(spdlog::level::info)) {
-                spdlog::info("Circuit breaker: State changed from {} to {}",
-                             StateToString(old_state), StateToString(new_state));
-            }
-        }
-
-        if (spdlog::should_log(spdlog::level::info)) {
-            spdlog::info("Circuit breaker state changed from {} to {}",
-                         StateToString(old_state), StateToString(new_state));
+            MULTIPLAYER_LOG_WARN("Circuit breaker: Circuit opened after {} failures",
+                                 consecutive_failures_.load(std::memory_order_relaxed));
         }
-    }
-
-    void TransitionToHalfOpen() {
-        TransitionTo(CircuitBreakerState::HalfOpen);
-    }
-
-    void UpdateResponseTimeMetrics(double response_time_ms) {
-        if (metrics_.total_requests == 1) {
-            metrics_.min_response_time_ms = response_time_ms;
-            metrics_.max_response_time_ms = response_time_ms;
-            metrics_.average_response_time_ms = response_time_ms;
-        } else {
-            metrics_.min_response_time_ms = std::min(metrics_.min_response_time_ms, response_time_ms);
-            metrics_.max_response_time_ms = std::max(metrics_.max_response_time_ms, response_time_ms);
-            
-            // Update running average
-            double total_time = metrics_.average_response_time_ms * (metrics_.total_requests - 1);
-            metrics_.average_response_time_ms = (total_time + response_time_ms) / metrics_.total_requests;
+    } else if (new_state == CircuitBreakerState::Closed) {
+        consecutive_failures_.store(0, std::memory_order_relaxed);
+        if (listener_) {
+            MULTIPLAYER_LOG_INFO("Circuit breaker: Circuit closed");
         }
-    }
-
-    std::string StateToString(CircuitBreakerState state) const {
-        switch (state) {
-            case CircuitBreakerState::Closed: return "Closed";
-            case CircuitBreakerState::Open: return "Open";
-            case CircuitBreakerState::HalfOpen: return "HalfOpen";
-            default: return "Unknown";
+    } else if (new_state == CircuitBreakerState::HalfOpen) {
+        half_open_calls_ = 0;
+        half_open_successes_ = 0;
+        if (listener_) {
+            MULTIPLAYER_LOG_INFO("Circuit breaker: Half-open test started");
         }
     }
 
-    mutable std::mutex mutex_;
-    CircuitBreakerConfig config_;
-    CircuitBreakerState state_;
-    size_t consecutive_failures_;
-    std::chrono::steady_clock::time_point last_state_change_;
-    CircuitBreakerMetrics metrics_;
-    MockCircuitBreakerListener* listener_;
-    size_t half_open_calls_ = 0;
-};
-
-// CircuitBreaker implementation
-CircuitBreaker::CircuitBreaker(const CircuitBreakerConfig& config)
-    : impl_(std::make_unique<Impl>(config)) {}
+    // Published last, so a call admitted by the new state sees the reset
+    // counters above
+    state_.store(new_state, std::memory_order_release);
 
-CircuitBreaker::~CircuitBreaker() = default;
-
-ErrorCode CircuitBreaker::ExecuteInternal(std::function<ErrorCode()> operation) {
-    return impl_->ExecuteInternal(operation);
+    MULTIPLAYER_LOG_INFO("Circuit breaker state changed from {} to {}",
+                         StateToString(old_state), StateToString(new_state));
 }
 
 CircuitBreakerState CircuitBreaker::GetState() const {
-    return impl_->GetState();
+    return state_.load(std::memory_order_acquire);
 }
 
 void CircuitBreaker::ForceOpen() {
-    impl_->ForceOpen();
+    std::lock_guard<std::mutex> lock(mutex_);
+    TransitionLocked(CircuitBreakerState::Open);
 }
 
 void CircuitBreaker::ForceHalfOpen() {
-    impl_->ForceHalfOpen();
+    std::lock_guard<std::mutex> lock(mutex_);
+    TransitionLocked(CircuitBreakerState::HalfOpen);
 }
 
 void CircuitBreaker::Reset() {
-    impl_->Reset();
+    std::lock_guard<std::mutex> lock(mutex_);
+    consecutive_failures_.store(0, std::memory_order_relaxed);
+    TransitionLocked(CircuitBreakerState::Closed);
 }
 
 CircuitBreakerMetrics CircuitBreaker::GetMetrics() const {
-    return impl_->GetMetrics();
+    CircuitBreakerMetrics metrics;
+    metrics.successful_requests = counters_.Load(SuccessfulRequests);
+    metrics.failed_requests = counters_.Load(FailedRequests);
+    metrics.total_requests = metrics.successful_requests + metrics.failed_requests;
+    metrics.rejected_requests = counters_.Load(RejectedRequests);
+    metrics.consecutive_failures = consecutive_failures_.load(std::memory_order_relaxed);
+
+    // Calculate rates
+    if (metrics.total_requests > 0) {
+        metrics.success_rate =
+            static_cast<double>(metrics.successful_requests) / metrics.total_requests;
+        metrics.failure_rate =
+            static_cast<double>(metrics.failed_requests) / metrics.total_requests;
+    }
+    const uint64_t timed_requests = counters_.Load(TimedRequests);
+    if (timed_requests > 0) {
+        metrics.average_response_time_ms =
+            counters_.Load(ResponseTimeUs) / 1000.0 / timed_requests;
+        metrics.min_response_time_ms =
+            min_response_time_us_.load(std::memory_order_relaxed) / 1000.0;
+        metrics.max_response_time_ms =
+            max_response_time_us_.load(std::memory_order_relaxed) / 1000.0;
+    }
+
+    for (size_t i = 0; i < window_size_; ++i) {
+        const uint8_t slot = window_[i].load(std::memory_order_relaxed);
+        metrics.window_requests += slot != Empty;
+        metrics.window_failures += slot == SlotFailure;
+    }
+    if (metrics.window_requests > 0) {
+        metrics.window_failure_rate =
+            static_cast<double>(metrics.window_failures) / metrics.window_requests;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    metrics.last_state_change = last_state_change_;
+    metrics.time_in_current_state = std::chrono::duration_cast<std::chrono::milliseconds>(
+        Now() - last_state_change_);
+    return metrics;
 }
 
 std::string CircuitBreaker::ExportMetricsAsJSON() const {
-    return impl_->ExportMetricsAsJSON();
+    const CircuitBreakerMetrics metrics = GetMetrics();
+
+    std::ostringstream json;
+    json << "{\n";
+    json << "  \"state\": \"" << StateToString(GetState()) << "\",\n";
+    json << "  \"total_requests\": " << metrics.total_requests << ",\n";
+    json << "  \"successful_requests\": " << metrics.successful_requests << ",\n";
+    json << "  \"failed_requests\": " << metrics.failed_requests << ",\n";
+    json << "  \"rejected_requests\": " << metrics.rejected_requests << ",\n";
+    json << "  \"consecutive_failures\": " << metrics.consecutive_failures << ",\n";
+    json << "  \"success_rate\": " << metrics.success_rate << ",\n";
+    json << "  \"failure_rate\": " << metrics.failure_rate << ",\n";
+    json << "  \"window_failure_rate\": " << metrics.window_failure_rate << ",\n";
+    json << "  \"average_response_time_ms\": " << metrics.average_response_time_ms << ",\n";
+    json << "  \"min_response_time_ms\": " << metrics.min_response_time_ms << ",\n";
+    json << "  \"max_response_time_ms\": " << metrics.max_response_time_ms << "\n";
+    json << "}";
+
+    return json.str();
 }
 
 void CircuitBreaker::SetListener(MockCircuitBreakerListener* listener) {
-    impl_->SetListener(listener);
+    std::lock_guard<std::mutex> lock(mutex_);
+    listener_ = listener;
 }
 
 void CircuitBreaker::UpdateConfig(const CircuitBreakerConfig& config) {
-    impl_->UpdateConfig(config);
+    std::lock_guard<std::mutex> lock(mutex_);
+    config_ = config;
+    // The window's size stays as constructed
+    config_.sliding_window_size = window_size_;
+    failure_threshold_.store(config.failure_threshold, std::memory_order_relaxed);
 }
 
 CircuitBreakerConfig CircuitBreaker::GetConfig() const {
-    return impl_->GetConfig();
+    std::lock_guard<std::mutex> lock(mutex_);
+    return config_;
+}
+
+// CircuitBreakerRegistry implementation
+CircuitBreakerRegistry::CircuitBreakerRegistry(std::shared_ptr<const ClockSource> clock)
+    : clock_(std::move(clock)) {}
+
+CircuitBreakerRegistry::~CircuitBreakerRegistry() {
+    for (auto& segment : segments_) {
+        delete segment.load(std::memory_order_relaxed);
+    }
+}
+
+void CircuitBreakerRegistry::SetScopeConfig(CircuitBreakerScope scope,
+                                            const CircuitBreakerConfig& config) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    scope_configs_[static_cast<size_t>(scope)] = config;
+}
+
+std::optional<CircuitBreakerRegistry::Key> CircuitBreakerRegistry::Intern(
+    CircuitBreakerScope scope, std::string_view endpoint) {
+    std::string name(scope == CircuitBreakerScope::Relay ? "relay:" : "room:");
+    name.append(endpoint);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = keys_.find(name);
+    if (it != keys_.end()) {
+        return it->second;
+    }
+    if (names_.size() >= MAX_BREAKERS) {
+        return std::nullopt;
+    }
+
+    const Key key = static_cast<Key>(names_.size());
+    auto& slot = segments_[key / SEGMENT_SIZE];
+    Segment* segment = slot.load(std::memory_order_relaxed);
+    if (!segment) {
+        segment = new Segment();
+        slot.store(segment, std::memory_order_release);
+    }
+    segment->breakers[key % SEGMENT_SIZE] =
+        std::make_unique<CircuitBreaker>(scope_configs_[static_cast<size_t>(scope)], clock_);
+
+    keys_.emplace(name, key);
+    names_.push_back(std::move(name));
+    return key;
+}
+
+std::string CircuitBreakerRegistry::GetName(Key key) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return key < names_.size() ? names_[key] : std::string{};
+}
+
+size_t CircuitBreakerRegistry::Size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return names_.size();
+}
+
+void CircuitBreakerRegistry::ForEach(
+    const std::function<void(const std::string&, const CircuitBreaker&)>& visitor) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (Key key = 0; key < names_.size(); ++key) {
+        visitor(names_[key], Get(key));
+    }
 }
 
 } // namespace Core::Multiplayer
@@ -4,14 +4,20 @@
 #pragma once
 
 #include <memory>
+#include <array>
 #include <chrono>
 #include <functional>
 #include <mutex>
 #include <atomic>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
 
+#include "clock_source.h"
 #include "error_handling.h"
+#include "sharded_counters.h"
 
 namespace Core::Multiplayer {
 
@@ -25,7 +31,7 @@ struct CircuitBreakerConfig {
     size_t failure_threshold = 5;
     uint32_t timeout_duration_ms = 60000;
     size_t success_threshold_for_close = 3;
-    size_t sliding_window_size = 10;
+    size_t sliding_window_size = 10; // Fixed when the breaker is constructed
     size_t minimum_throughput = 10;
     bool enable_automatic_half_open = true;
     size_t max_concurrent_half_open_calls = 1;
@@ -52,11 +58,16 @@ struct CircuitBreakerMetrics {
     double success_rate = 0.0;
     double failure_rate = 0.0;
     
-    // Response time metrics
+    // Response time metrics, from a sample of the calls
     double average_response_time_ms = 0.0;
     double min_response_time_ms = 0.0;
     double max_response_time_ms = 0.0;
     
+    // Outcomes of the last sliding_window_size calls
+    size_t window_requests = 0;
+    size_t window_failures = 0;
+    double window_failure_rate = 0.0;
+    
     // State timing
     std::chrono::steady_clock::time_point last_state_change;
     std::chrono::milliseconds time_in_current_state{0};
@@ -77,6 +88,13 @@ struct CircuitBreakerMetrics {
  * - Comprehensive metrics and monitoring
  * - Thread-safe operations
  * 
+ * While Closed, admitting a call is a single atomic load and recording its
+ * outcome takes no lock: counters are striped per thread and the sliding
+ * window is a ring of outcome slots claimed by an atomic cursor. The mutex
+ * is only taken to change state and to admit calls while Open or Half-Open.
+ * Reading the clock costs more than the rest of the bookkeeping, so only
+ * one in RESPONSE_TIME_SAMPLE_INTERVAL Closed calls per thread is timed.
+ * 
  * Usage:
  *   CircuitBreakerConfig config;
  *   config.failure_threshold = 5;
@@ -91,9 +109,16 @@ struct CircuitBreakerMetrics {
  */
 class CircuitBreaker {
 public:
-    explicit CircuitBreaker(const CircuitBreakerConfig& config);
+    static constexpr uint32_t RESPONSE_TIME_SAMPLE_INTERVAL = 16;
+
+    // The open timeout and state times are read from clock; GetSteady() when null
+    explicit CircuitBreaker(const CircuitBreakerConfig& config,
+                            std::shared_ptr<const ClockSource> clock = nullptr);
     ~CircuitBreaker();
 
+    CircuitBreaker(const CircuitBreaker&) = delete;
+    CircuitBreaker& operator=(const CircuitBreaker&) = delete;
+
     // Core circuit breaker operations
     template<typename F>
     ErrorCode Execute(F&& operation);
@@ -114,17 +139,164 @@ public:
     CircuitBreakerConfig GetConfig() const;
 
 private:
-    class Impl;
-    std::unique_ptr<Impl> impl_;
-    
-    // Internal helper for template implementation
-    ErrorCode ExecuteInternal(std::function<ErrorCode()> operation);
+    // How a call was let through, which decides what its outcome may change
+    enum class Admission {
+        Rejected,
+        Closed,
+        Trial, // One of the limited Half-Open calls
+    };
+
+    enum Counter : size_t {
+        SuccessfulRequests,
+        FailedRequests,
+        RejectedRequests,
+        TimedRequests,
+        ResponseTimeUs,
+        CounterCount,
+    };
+
+    enum WindowSlot : uint8_t {
+        Empty,
+        SlotSuccess,
+        SlotFailure,
+    };
+
+    Admission Admit() {
+        if (state_.load(std::memory_order_acquire) == CircuitBreakerState::Closed) {
+            return Admission::Closed;
+        }
+        return AdmitSlow();
+    }
+
+    static bool SampleResponseTime() {
+        thread_local uint32_t calls = 0;
+        return calls++ % RESPONSE_TIME_SAMPLE_INTERVAL == 0;
+    }
+
+    ClockSource::TimePoint Now() const {
+        return clock_ ? clock_->Now() : std::chrono::steady_clock::now();
+    }
+
+    Admission AdmitSlow();
+    void RecordOutcome(Admission admission, ErrorCode result,
+                       std::optional<std::chrono::steady_clock::duration> elapsed);
+    void OnClosedFailure();
+    void OnTrialOutcome(bool success);
+    void TransitionLocked(CircuitBreakerState new_state);
+
+    const std::shared_ptr<const ClockSource> clock_;
+    mutable std::mutex mutex_;
+    CircuitBreakerConfig config_;
+    std::atomic<CircuitBreakerState> state_{CircuitBreakerState::Closed};
+    std::atomic<size_t> failure_threshold_;
+    std::atomic<size_t> consecutive_failures_{0};
+    std::chrono::steady_clock::time_point last_state_change_;
+    MockCircuitBreakerListener* listener_ = nullptr;
+    size_t half_open_calls_ = 0;
+    size_t half_open_successes_ = 0;
+
+    ShardedCounters<CounterCount> counters_;
+    std::atomic<uint64_t> min_response_time_us_{UINT64_MAX};
+    std::atomic<uint64_t> max_response_time_us_{0};
+
+    // Sliding window ring; slot = cursor % size
+    std::unique_ptr<std::atomic<uint8_t>[]> window_;
+    size_t window_size_;
+    std::atomic<uint64_t> window_cursor_{0};
 };
 
 // Template implementation
 template<typename F>
 ErrorCode CircuitBreaker::Execute(F&& operation) {
-    return ExecuteInternal(std::forward<F>(operation));
+    const Admission admission = Admit();
+    if (admission == Admission::Rejected) {
+        return ErrorCode::ServiceUnavailable;
+    }
+
+    const bool timed = admission == Admission::Trial || SampleResponseTime();
+    const auto start_time = timed ? std::chrono::steady_clock::now()
+                                  : std::chrono::steady_clock::time_point{};
+    ErrorCode result;
+    try {
+        result = std::forward<F>(operation)();
+    } catch (...) {
+        result = ErrorCode::InternalError;
+    }
+    RecordOutcome(admission, result,
+                  timed ? std::optional{std::chrono::steady_clock::now() - start_time}
+                        : std::nullopt);
+    return result;
 }
 
+/**
+ * Endpoint kinds the registry keeps breakers for
+ */
+enum class CircuitBreakerScope {
+    Relay,
+    RoomServer,
+};
+
+/**
+ * Hands out one CircuitBreaker per endpoint.
+ *
+ * Endpoints are interned once, when a connection is set up, into a dense
+ * key; Get(key) is then a lock-free array lookup suitable for wrapping
+ * every send. Breakers live as long as the registry and are never moved.
+ */
+class CircuitBreakerRegistry {
+public:
+    using Key = uint32_t;
+
+    static constexpr size_t SEGMENT_SIZE = 64;
+    static constexpr size_t MAX_SEGMENTS = 256;
+    static constexpr size_t MAX_BREAKERS = SEGMENT_SIZE * MAX_SEGMENTS;
+
+    // Breakers are created with clock, see CircuitBreaker
+    explicit CircuitBreakerRegistry(std::shared_ptr<const ClockSource> clock = nullptr);
+    ~CircuitBreakerRegistry();
+
+    CircuitBreakerRegistry(const CircuitBreakerRegistry&) = delete;
+    CircuitBreakerRegistry& operator=(const CircuitBreakerRegistry&) = delete;
+
+    /**
+     * Config for breakers created for a scope from now on
+     */
+    void SetScopeConfig(CircuitBreakerScope scope, const CircuitBreakerConfig& config);
+
+    /**
+     * Key for an endpoint's breaker, creating the breaker on first use
+     * @param endpoint Relay or room server address, e.g. "relay.example:443"
+     * @return The key; std::nullopt once MAX_BREAKERS endpoints exist
+     */
+    std::optional<Key> Intern(CircuitBreakerScope scope, std::string_view endpoint);
+
+    /**
+     * The breaker for a key returned by Intern. Lock-free.
+     */
+    CircuitBreaker& Get(Key key) const {
+        const Segment* segment = segments_[key / SEGMENT_SIZE].load(std::memory_order_acquire);
+        return *segment->breakers[key % SEGMENT_SIZE];
+    }
+
+    std::string GetName(Key key) const;
+    size_t Size() const;
+
+    /**
+     * Visit every breaker with its interned name, e.g. to export metrics
+     */
+    void ForEach(const std::function<void(const std::string&, const CircuitBreaker&)>& visitor) const;
+
+private:
+    struct Segment {
+        std::array<std::unique_ptr<CircuitBreaker>, SEGMENT_SIZE> breakers;
+    };
+
+    const std::shared_ptr<const ClockSource> clock_;
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Key> keys_;
+    std::vector<std::string> names_;
+    std::array<CircuitBreakerConfig, 2> scope_configs_;
+    std::array<std::atomic<Segment*>, MAX_SEGMENTS> segments_{};
+};
+
 } // namespace Core::Multiplayer
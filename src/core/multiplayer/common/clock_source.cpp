@@ -0,0 +1,61 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "clock_source.h"
+
+namespace Core::Multiplayer {
+
+namespace {
+
+class SteadyClockSource final : public ClockSource {
+public:
+    TimePoint Now() const override {
+        return std::chrono::steady_clock::now();
+    }
+
+    WallTimePoint WallNow() const override {
+        return std::chrono::system_clock::now();
+    }
+};
+
+} // namespace
+
+std::shared_ptr<const ClockSource> ClockSource::GetSteady() {
+    static const std::shared_ptr<const ClockSource> steady =
+        std::make_shared<SteadyClockSource>();
+    return steady;
+}
+
+VirtualClock::VirtualClock(WallTimePoint wall_start) : wall_start_(wall_start) {}
+
+ClockSource::TimePoint VirtualClock::Now() const {
+    return TimePoint{} + START_OFFSET +
+           std::chrono::nanoseconds(elapsed_ns_.load(std::memory_order_acquire));
+}
+
+ClockSource::WallTimePoint VirtualClock::WallNow() const {
+    return wall_start_ + std::chrono::duration_cast<WallTimePoint::duration>(GetElapsed());
+}
+
+void VirtualClock::Advance(std::chrono::nanoseconds duration) {
+    if (duration.count() > 0) {
+        elapsed_ns_.fetch_add(duration.count(), std::memory_order_acq_rel);
+    }
+}
+
+void VirtualClock::AdvanceTo(TimePoint point) {
+    const int64_t target =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(point - TimePoint{} - START_OFFSET)
+            .count();
+    int64_t current = elapsed_ns_.load(std::memory_order_relaxed);
+    while (current < target &&
+           !elapsed_ns_.compare_exchange_weak(current, target, std::memory_order_acq_rel,
+                                              std::memory_order_relaxed)) {
+    }
+}
+
+std::chrono::nanoseconds VirtualClock::GetElapsed() const {
+    return std::chrono::nanoseconds(elapsed_ns_.load(std::memory_order_acquire));
+}
+
+} // namespace Core::Multiplayer
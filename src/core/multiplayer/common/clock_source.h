@@ -0,0 +1,72 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+namespace Core::Multiplayer {
+
+/**
+ * Where a component reads the time, so tests and the network simulator can
+ * substitute a VirtualClock for the real one.
+ *
+ * Components take a std::shared_ptr<const ClockSource> and fall back to
+ * GetSteady() when given none; code on a per-packet path should keep a
+ * direct clock read for that case instead of paying the virtual call.
+ */
+class ClockSource {
+public:
+    using TimePoint = std::chrono::steady_clock::time_point;
+    using WallTimePoint = std::chrono::system_clock::time_point;
+
+    virtual ~ClockSource() = default;
+
+    virtual TimePoint Now() const = 0;
+
+    // Calendar time, for timestamps that leave the process
+    virtual WallTimePoint WallNow() const = 0;
+
+    // Whether time only moves when someone advances it
+    virtual bool IsVirtual() const { return false; }
+
+    // steady_clock and system_clock
+    static std::shared_ptr<const ClockSource> GetSteady();
+};
+
+/**
+ * Clock that stands still until advanced. Reads are safe from any thread;
+ * whoever drives the simulation advances it.
+ *
+ * It starts an hour past the steady_clock epoch, so Now() minus a timeout
+ * never reaches a default-constructed time_point, which callers use to
+ * mean "never". Wall time starts at the given calendar time.
+ */
+class VirtualClock final : public ClockSource {
+public:
+    static constexpr std::chrono::hours START_OFFSET{1};
+
+    explicit VirtualClock(WallTimePoint wall_start = std::chrono::sys_days{
+                              std::chrono::year{2025} / std::chrono::January / 1});
+
+    TimePoint Now() const override;
+    WallTimePoint WallNow() const override;
+    bool IsVirtual() const override { return true; }
+
+    // Moves time forward; a negative duration is ignored
+    void Advance(std::chrono::nanoseconds duration);
+
+    // Moves time forward to point; earlier points are ignored
+    void AdvanceTo(TimePoint point);
+
+    // Time advanced since construction
+    std::chrono::nanoseconds GetElapsed() const;
+
+private:
+    const WallTimePoint wall_start_;
+    std::atomic<int64_t> elapsed_ns_{0};
+};
+
+} // namespace Core::Multiplayer
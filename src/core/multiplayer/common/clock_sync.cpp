@@ -0,0 +1,182 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "clock_sync.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Core::Multiplayer {
+
+namespace {
+
+// NTP's PHI: how fast an estimate's error grows once drift is corrected for
+constexpr double DISPERSION_PPM = 15.0;
+// Fraction of a new one-way delay sample taken into the smoothed value
+constexpr int64_t DELAY_GAIN_SHIFT = 3;
+
+int64_t Difference(uint64_t later, uint64_t earlier) {
+    return static_cast<int64_t>(later) - static_cast<int64_t>(earlier);
+}
+
+int64_t Smooth(int64_t smoothed, int64_t sample, bool first) {
+    return first ? sample : smoothed + ((sample - smoothed) >> DELAY_GAIN_SHIFT);
+}
+
+} // namespace
+
+std::chrono::microseconds ClockSyncSnapshot::OffsetAt(uint64_t local_us) const {
+    const double elapsed_s = static_cast<double>(Difference(local_us, reference_us)) / 1e6;
+    return offset + std::chrono::microseconds(std::llround(drift_ppm * elapsed_s));
+}
+
+bool ClockSyncEstimator::AddSample(const ClockSyncSample& sample) {
+    std::lock_guard lock(mutex_);
+    const int64_t round_trip = Difference(sample.local_receive_us, sample.local_send_us);
+    const int64_t turnaround = Difference(sample.remote_send_us, sample.remote_receive_us);
+    if (sample.local_send_us == 0 || sample.remote_receive_us == 0 || round_trip < 0 ||
+        turnaround < 0 || turnaround > round_trip) {
+        ++snapshot_.rejected_count;
+        return false;
+    }
+
+    Entry entry;
+    entry.delay_us = static_cast<uint64_t>(round_trip - turnaround);
+    entry.offset_us = (Difference(sample.remote_receive_us, sample.local_send_us) +
+                       Difference(sample.remote_send_us, sample.local_receive_us)) /
+                      2;
+    entry.local_us = sample.local_send_us + static_cast<uint64_t>(round_trip / 2);
+
+    bool restart = snapshot_.sample_count == 0;
+    if (window_size_ != 0) {
+        uint64_t min_delay = UINT64_MAX;
+        for (size_t i = 0; i < window_size_; ++i) {
+            min_delay = std::min(min_delay, window_[i].delay_us);
+        }
+        const uint64_t threshold =
+            2 * min_delay + static_cast<uint64_t>(OUTLIER_SLACK.count());
+        if (entry.delay_us > threshold) {
+            if (++consecutive_rejections_ < WINDOW / 2) {
+                ++snapshot_.rejected_count;
+                return false;
+            }
+            // Slow for this long: the path itself changed, start over on it
+            window_size_ = 0;
+            next_ = 0;
+            restart = true;
+        }
+    }
+    consecutive_rejections_ = 0;
+
+    window_[next_] = entry;
+    next_ = (next_ + 1) % WINDOW;
+    window_size_ = std::min(window_size_ + 1, WINDOW);
+    ++snapshot_.sample_count;
+    RecomputeLocked();
+
+    // Each direction's share of this exchange, against the filtered offset
+    const int64_t outbound = Difference(sample.remote_receive_us, sample.local_send_us) -
+                             snapshot_.OffsetAt(sample.local_send_us).count();
+    const int64_t inbound = Difference(sample.local_receive_us, sample.remote_send_us) +
+                            snapshot_.OffsetAt(sample.local_receive_us).count();
+    snapshot_.outbound_delay = std::chrono::microseconds(
+        Smooth(snapshot_.outbound_delay.count(), std::max<int64_t>(outbound, 0), restart));
+    snapshot_.inbound_delay = std::chrono::microseconds(
+        Smooth(snapshot_.inbound_delay.count(), std::max<int64_t>(inbound, 0), restart));
+    return true;
+}
+
+void ClockSyncEstimator::RecomputeLocked() {
+    const Entry* best = &window_[0];
+    uint64_t oldest_us = UINT64_MAX;
+    uint64_t newest_us = 0;
+    for (size_t i = 0; i < window_size_; ++i) {
+        const Entry& entry = window_[i];
+        if (entry.delay_us < best->delay_us) {
+            best = &entry;
+        }
+        oldest_us = std::min(oldest_us, entry.local_us);
+        newest_us = std::max(newest_us, entry.local_us);
+    }
+
+    double drift_ppm = 0.0;
+    if (window_size_ >= 3 && newest_us - oldest_us >= static_cast<uint64_t>(
+                                 std::chrono::microseconds(MIN_DRIFT_SPAN).count())) {
+        // Least squares over seconds since the oldest sample
+        double mean_t = 0.0;
+        double mean_offset = 0.0;
+        for (size_t i = 0; i < window_size_; ++i) {
+            mean_t += static_cast<double>(window_[i].local_us - oldest_us) / 1e6;
+            mean_offset += static_cast<double>(window_[i].offset_us);
+        }
+        mean_t /= static_cast<double>(window_size_);
+        mean_offset /= static_cast<double>(window_size_);
+        double covariance = 0.0;
+        double variance = 0.0;
+        for (size_t i = 0; i < window_size_; ++i) {
+            const double t = static_cast<double>(window_[i].local_us - oldest_us) / 1e6 - mean_t;
+            covariance += t * (static_cast<double>(window_[i].offset_us) - mean_offset);
+            variance += t * t;
+        }
+        if (variance > 0.0) {
+            drift_ppm = std::clamp(covariance / variance, -MAX_DRIFT_PPM, MAX_DRIFT_PPM);
+        }
+    }
+
+    // Spread of the window around the drift line through the best sample
+    double squared_residuals = 0.0;
+    for (size_t i = 0; i < window_size_; ++i) {
+        const double predicted =
+            static_cast<double>(best->offset_us) +
+            drift_ppm * static_cast<double>(Difference(window_[i].local_us, best->local_us)) / 1e6;
+        const double residual = static_cast<double>(window_[i].offset_us) - predicted;
+        squared_residuals += residual * residual;
+    }
+    const double spread_us = std::sqrt(squared_residuals / static_cast<double>(window_size_));
+    const double age_s = static_cast<double>(newest_us - best->local_us) / 1e6;
+
+    snapshot_.reference_us = newest_us;
+    snapshot_.drift_ppm = drift_ppm;
+    snapshot_.offset = std::chrono::microseconds(
+        best->offset_us + std::llround(drift_ppm * age_s));
+    snapshot_.error_bound = std::chrono::microseconds(std::llround(
+        static_cast<double>(best->delay_us) / 2.0 + spread_us + DISPERSION_PPM * age_s));
+
+    const double fill = static_cast<double>(window_size_) / static_cast<double>(WINDOW);
+    const double tightness = 1000.0 / (1000.0 + static_cast<double>(snapshot_.error_bound.count()));
+    snapshot_.confidence = static_cast<float>(fill * tightness);
+}
+
+ClockSyncSnapshot ClockSyncEstimator::GetSnapshot() const {
+    std::lock_guard lock(mutex_);
+    return snapshot_;
+}
+
+std::optional<uint64_t> ClockSyncEstimator::ToLocalTime(uint64_t remote_us) const {
+    const ClockSyncSnapshot snapshot = GetSnapshot();
+    if (!snapshot.IsSynchronized()) {
+        return std::nullopt;
+    }
+    // The offset moves by microseconds per second, so one refinement is exact enough
+    const uint64_t guess = remote_us - static_cast<uint64_t>(snapshot.offset.count());
+    return remote_us - static_cast<uint64_t>(snapshot.OffsetAt(guess).count());
+}
+
+std::optional<std::chrono::microseconds> ClockSyncEstimator::GetOneWayDelay(
+    uint64_t remote_send_us, uint64_t local_receive_us) const {
+    const auto sent = ToLocalTime(remote_send_us);
+    if (!sent) {
+        return std::nullopt;
+    }
+    return std::chrono::microseconds(std::max<int64_t>(Difference(local_receive_us, *sent), 0));
+}
+
+void ClockSyncEstimator::Reset() {
+    std::lock_guard lock(mutex_);
+    window_size_ = 0;
+    next_ = 0;
+    consecutive_rejections_ = 0;
+    snapshot_ = ClockSyncSnapshot{};
+}
+
+} // namespace Core::Multiplayer
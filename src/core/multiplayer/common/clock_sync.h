@@ -0,0 +1,124 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+
+namespace Core::Multiplayer {
+
+/**
+ * One request/response exchange with a peer, in microseconds: the request
+ * left at local_send_us and arrived at remote_receive_us; the response left
+ * at remote_send_us and arrived at local_receive_us. A peer that answers at
+ * once reports the same time for both remote readings.
+ */
+struct ClockSyncSample {
+    uint64_t local_send_us = 0;
+    uint64_t remote_receive_us = 0;
+    uint64_t remote_send_us = 0;
+    uint64_t local_receive_us = 0;
+};
+
+/**
+ * Consistent view of a ClockSyncEstimator
+ */
+struct ClockSyncSnapshot {
+    // Remote clock minus local clock at reference_us on the local clock
+    std::chrono::microseconds offset{0};
+    uint64_t reference_us = 0;
+    // How fast the offset grows, in microseconds per second of local time
+    double drift_ppm = 0.0;
+    // The true offset at reference_us lies within offset +- error_bound
+    std::chrono::microseconds error_bound{0};
+    // Smoothed one-way delays; their sum is the round-trip time
+    std::chrono::microseconds outbound_delay{0};
+    std::chrono::microseconds inbound_delay{0};
+    // 0 with no samples, approaching 1 as the window fills with tight samples
+    float confidence = 0.0f;
+    uint64_t sample_count = 0;
+    uint64_t rejected_count = 0;
+
+    bool IsSynchronized() const { return sample_count != 0; }
+
+    // The offset at a local time, with drift applied
+    std::chrono::microseconds OffsetAt(uint64_t local_us) const;
+};
+
+/**
+ * Clock offset and drift estimator for one peer, in the style of NTP's
+ * clock filter.
+ *
+ * Each sample yields an offset ((t1 - t0) + (t2 - t3)) / 2 and a delay
+ * (t3 - t0) - (t2 - t1). Queueing inflates the delay and skews the offset
+ * by up to half the excess, so the estimate follows the lowest-delay sample
+ * of the last WINDOW, and samples whose delay is far above that minimum are
+ * rejected outright; after WINDOW / 2 rejections in a row the path is
+ * taken to have changed and samples are accepted again. Drift is the least
+ * squares slope of the window's offsets over local time, once they span
+ * MIN_DRIFT_SPAN, clamped to MAX_DRIFT_PPM.
+ *
+ * The error bound is half the best sample's delay plus the spread of the
+ * window around the drift line, and grows by 15 ppm of the best sample's
+ * age, as NTP's dispersion does. One-way delays are only as good as the assumption
+ * that the best sample's path was symmetric, the same limit every
+ * two-way method has.
+ *
+ * Samples arrive at keepalive rate, so a mutex guards everything.
+ */
+class ClockSyncEstimator {
+public:
+    static constexpr size_t WINDOW = 8;
+    static constexpr std::chrono::seconds MIN_DRIFT_SPAN{2};
+    static constexpr double MAX_DRIFT_PPM = 500.0;
+    // Samples up to this much slower than the window's best are never outliers
+    static constexpr std::chrono::microseconds OUTLIER_SLACK{2000};
+
+    ClockSyncEstimator() = default;
+
+    ClockSyncEstimator(const ClockSyncEstimator&) = delete;
+    ClockSyncEstimator& operator=(const ClockSyncEstimator&) = delete;
+
+    /**
+     * Adds an exchange
+     * @return False if it was rejected as malformed or an outlier
+     */
+    bool AddSample(const ClockSyncSample& sample);
+
+    ClockSyncSnapshot GetSnapshot() const;
+
+    // A remote clock reading as local time; nothing until synchronized
+    std::optional<uint64_t> ToLocalTime(uint64_t remote_us) const;
+
+    /**
+     * One-way delay of a message stamped remote_send_us by the peer and
+     * received at local_receive_us; nothing until synchronized
+     */
+    std::optional<std::chrono::microseconds> GetOneWayDelay(uint64_t remote_send_us,
+                                                           uint64_t local_receive_us) const;
+
+    void Reset();
+
+private:
+    struct Entry {
+        int64_t offset_us = 0;
+        uint64_t delay_us = 0;
+        uint64_t local_us = 0; // Midpoint of the exchange
+    };
+
+    void RecomputeLocked();
+
+    mutable std::mutex mutex_;
+    std::array<Entry, WINDOW> window_{};
+    size_t window_size_ = 0;
+    size_t next_ = 0;
+    size_t consecutive_rejections_ = 0;
+    ClockSyncSnapshot snapshot_;
+};
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,104 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "congestion_controller.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace Core::Multiplayer {
+
+namespace {
+constexpr int64_t NO_SAMPLE = std::numeric_limits<int64_t>::max();
+} // namespace
+
+DelayBasedController::DelayBasedController(const CongestionControlConfig& config)
+    : config_(config) {
+    config_.target_delay = std::max(config_.target_delay, std::chrono::microseconds(1));
+    config_.min_rate = std::max<uint64_t>(config_.min_rate, 1);
+    config_.max_rate = std::max(config_.max_rate, config_.min_rate);
+    config_.max_decrease = std::clamp(config_.max_decrease, 0.0, 1.0);
+    rate_.store(std::clamp(config_.initial_rate, config_.min_rate, config_.max_rate),
+                std::memory_order_relaxed);
+    base_history_us_.fill(NO_SAMPLE);
+    slot_started_ = Clock::now();
+}
+
+std::optional<RateHint> DelayBasedController::OnRttSample(std::chrono::microseconds rtt,
+                                                          Clock::time_point now) {
+    if (rtt.count() < 0) {
+        return std::nullopt;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Each slot covers a tenth of the window; rolling over drops the oldest
+    const auto slot_length = std::chrono::duration_cast<Clock::duration>(
+        config_.base_delay_window / static_cast<int>(BASE_HISTORY_SLOTS));
+    while (now - slot_started_ >= slot_length) {
+        base_slot_ = (base_slot_ + 1) % BASE_HISTORY_SLOTS;
+        base_history_us_[base_slot_] = NO_SAMPLE;
+        slot_started_ += slot_length;
+        if (now - slot_started_ >= config_.base_delay_window) {
+            // Idle for a whole window; nothing older is worth keeping
+            base_history_us_.fill(NO_SAMPLE);
+            slot_started_ = now;
+        }
+    }
+    auto& slot_min = base_history_us_[base_slot_];
+    slot_min = std::min<int64_t>(slot_min, rtt.count());
+
+    queuing_delay_ = rtt - BaseDelayLocked();
+    ++sample_count_;
+
+    // Positive below the target, negative above, clamped to [-1, 1]
+    const double off_target =
+        std::clamp(static_cast<double>((config_.target_delay - queuing_delay_).count()) /
+                       static_cast<double>(config_.target_delay.count()),
+                   -1.0, 1.0);
+    const double rate = static_cast<double>(rate_.load(std::memory_order_relaxed));
+    const double updated =
+        off_target >= 0.0 ? rate + static_cast<double>(config_.additive_increase) * off_target
+                          : rate * (1.0 + config_.max_decrease * off_target);
+    rate_.store(std::clamp(static_cast<uint64_t>(updated), config_.min_rate, config_.max_rate),
+                std::memory_order_release);
+
+    const bool congested = off_target < 0.0;
+    if (congested == congested_.load(std::memory_order_relaxed)) {
+        return std::nullopt;
+    }
+    congested_.store(congested, std::memory_order_release);
+    if (congested) {
+        ++reduce_count_;
+    }
+    return RateHint{rate_.load(std::memory_order_relaxed), congested, queuing_delay_};
+}
+
+CongestionStatistics DelayBasedController::GetStatistics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CongestionStatistics stats;
+    stats.bytes_per_second = rate_.load(std::memory_order_relaxed);
+    stats.base_delay = BaseDelayLocked();
+    stats.queuing_delay = queuing_delay_;
+    stats.congested = congested_.load(std::memory_order_relaxed);
+    stats.sample_count = sample_count_;
+    stats.reduce_count = reduce_count_;
+    return stats;
+}
+
+void DelayBasedController::Reset(Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    base_history_us_.fill(NO_SAMPLE);
+    base_slot_ = 0;
+    slot_started_ = now;
+    queuing_delay_ = std::chrono::microseconds(0);
+    rate_.store(std::clamp(config_.initial_rate, config_.min_rate, config_.max_rate),
+                std::memory_order_release);
+    congested_.store(false, std::memory_order_release);
+}
+
+std::chrono::microseconds DelayBasedController::BaseDelayLocked() const {
+    const int64_t base = *std::min_element(base_history_us_.begin(), base_history_us_.end());
+    return std::chrono::microseconds(base == NO_SAMPLE ? 0 : base);
+}
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,116 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+
+namespace Core::Multiplayer {
+
+/**
+ * Limits and gains of a DelayBasedController
+ */
+struct CongestionControlConfig {
+    // Queuing delay steered toward. LEDBAT's 100ms is far too much for games.
+    std::chrono::microseconds target_delay{25'000};
+    uint64_t initial_rate = 1024 * 1024; // bytes/s
+    uint64_t min_rate = 32 * 1024;
+    uint64_t max_rate = 10 * 1024 * 1024;
+    // Added per sample with no queuing delay at all, less as delay nears the target
+    uint64_t additive_increase = 64 * 1024;
+    // Share of the rate cut per sample at twice the target delay or more
+    double max_decrease = 0.5;
+    // How long a base delay measurement is remembered, so a route change
+    // to a slower path is eventually accepted as the new base
+    std::chrono::seconds base_delay_window{120};
+};
+
+/**
+ * Advice to whoever generates traffic, raised when congestion starts or ends
+ */
+struct RateHint {
+    // Rate the controller is now pacing to
+    uint64_t bytes_per_second = 0;
+    // True while queuing delay is over the target: send less, e.g. drop bulk
+    // transfers or lower the update rate
+    bool reduce = false;
+    std::chrono::microseconds queuing_delay{0};
+};
+
+struct CongestionStatistics {
+    uint64_t bytes_per_second = 0;
+    std::chrono::microseconds base_delay{0};
+    std::chrono::microseconds queuing_delay{0};
+    bool congested = false;
+    uint64_t sample_count = 0;
+    // Times congestion began
+    uint64_t reduce_count = 0;
+};
+
+/**
+ * Delay-based send rate control in the style of LEDBAT (RFC 6817).
+ *
+ * Each RTT sample is compared with the base delay, the lowest RTT seen
+ * within base_delay_window; the excess is queuing delay building up at the
+ * bottleneck. Below the target the rate grows additively, in proportion to
+ * how far below it is; above it the rate is cut multiplicatively, in
+ * proportion to how far above, so the sender backs off as soon as queues
+ * start to form instead of once packets are lost. The caller paces sends to
+ * GetRate, typically by feeding it to a token bucket.
+ *
+ * Samples are taken under a lock; GetRate is a single atomic load.
+ */
+class DelayBasedController {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit DelayBasedController(const CongestionControlConfig& config = {});
+
+    DelayBasedController(const DelayBasedController&) = delete;
+    DelayBasedController& operator=(const DelayBasedController&) = delete;
+
+    /**
+     * Updates the rate from one round-trip measurement
+     * @return A hint when the sample started or ended congestion
+     */
+    std::optional<RateHint> OnRttSample(std::chrono::microseconds rtt,
+                                        Clock::time_point now = Clock::now());
+
+    uint64_t GetRate() const {
+        return rate_.load(std::memory_order_acquire);
+    }
+
+    bool IsCongested() const {
+        return congested_.load(std::memory_order_acquire);
+    }
+
+    CongestionStatistics GetStatistics() const;
+
+    // Forgets the base delay and starts over, e.g. after moving to another path
+    void Reset(Clock::time_point now = Clock::now());
+
+private:
+    // Minimum per slot, as in LEDBAT's base delay history
+    static constexpr size_t BASE_HISTORY_SLOTS = 10;
+
+    std::chrono::microseconds BaseDelayLocked() const;
+
+    CongestionControlConfig config_;
+    std::atomic<uint64_t> rate_;
+    std::atomic<bool> congested_{false};
+
+    mutable std::mutex mutex_;
+    std::array<int64_t, BASE_HISTORY_SLOTS> base_history_us_{};
+    size_t base_slot_ = 0;
+    Clock::time_point slot_started_;
+    std::chrono::microseconds queuing_delay_{0};
+    uint64_t sample_count_ = 0;
+    uint64_t reduce_count_ = 0;
+};
+
+} // namespace Core::Multiplayer
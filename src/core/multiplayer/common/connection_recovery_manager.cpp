@@ -2,22 +2,28 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "connection_recovery_manager.h"
-#include <thread>
+#include "multiplayer_log.h"
+#include "timer_wheel.h"
+#include "work_stealing_executor.h"
 #include <random>
 #include <algorithm>
-#include <spdlog/spdlog.h>
+#include <utility>
 
 namespace Core::Multiplayer {
 
 // Implementation class using PIMPL pattern
 class ConnectionRecoveryManager::Impl {
 public:
-    Impl(const RecoveryConfig& config, MockNetworkConnection* connection)
+    Impl(const RecoveryConfig& config, MockNetworkConnection* connection,
+         std::shared_ptr<TimerWheel> timer_wheel)
         : config_(config), connection_(connection), state_(RecoveryState::Idle),
           current_attempt_(0), listener_(nullptr),
-          rng_(std::random_device{}()) {
+          rng_(config.jitter_seed != 0 ? static_cast<std::mt19937::result_type>(config.jitter_seed)
+                                       : std::random_device{}()),
+          timer_wheel_(timer_wheel ? std::move(timer_wheel) : TimerWheel::GetShared()),
+          attempt_tasks_(WorkStealingExecutor::GetShared()) {
         
-        start_time_ = std::chrono::steady_clock::now();
+        start_time_ = timer_wheel_->GetClock()->Now();
         
         // Initialize default strategies for different error types
         InitializeDefaultStrategies();
@@ -30,58 +36,60 @@ public:
     ErrorCode StartRecovery(const ErrorInfo& error) {
         std::lock_guard<std::mutex> lock(mutex_);
         
-        if (state_ == RecoveryState::InProgress) {
-            return ErrorCode::InvalidState;
-        }
-        
         // Check if error is retryable
         if (!CanRetryError(error)) {
             return ErrorCode::NotSupported;
         }
         
+        // Coalesce with the recovery already under way for this connection
+        if (state_ == RecoveryState::InProgress) {
+            current_error_ = error;
+            coalesced_requests_++;
+            return ErrorCode::Success;
+        }
+        
         current_error_ = error;
         state_ = RecoveryState::InProgress;
         current_attempt_ = 0;
-        start_time_ = std::chrono::steady_clock::now();
+        coalesced_requests_ = 0;
+        generation_++;
+        start_time_ = timer_wheel_->GetClock()->Now();
         
-        // Start recovery process in background thread
-        recovery_thread_ = std::thread(&Impl::PerformRecovery, this);
+        ScheduleNextAttemptLocked();
 
-        if (spdlog::should_log(spdlog::level::info)) {
-            spdlog::info("Started recovery for error: {}", static_cast<int>(error.error_code));
-        }
+        MULTIPLAYER_LOG_INFO("Started recovery for error: {}", static_cast<int>(error.error_code));
         return ErrorCode::Success;
     }
 
     ErrorCode StopRecovery() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        
-        if (state_ != RecoveryState::InProgress) {
-            return ErrorCode::InvalidState;
-        }
-        
-        state_ = RecoveryState::Aborted;
-        
-        if (recovery_thread_.joinable()) {
-            recovery_thread_.join();
+        TimerWheel::TimerId pending_timer;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            
+            if (state_ != RecoveryState::InProgress) {
+                return ErrorCode::InvalidState;
+            }
+            
+            pending_timer = AbortLocked();
         }
+        // Outside mutex_: Cancel waits for a firing timer callback
+        timer_wheel_->Cancel(pending_timer);
 
-        if (spdlog::should_log(spdlog::level::info)) {
-            spdlog::info("Recovery stopped");
-        }
+        MULTIPLAYER_LOG_INFO("Recovery stopped");
         return ErrorCode::Success;
     }
 
     void Shutdown() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        
-        if (state_ == RecoveryState::InProgress) {
-            state_ = RecoveryState::Aborted;
-        }
-        
-        if (recovery_thread_.joinable()) {
-            recovery_thread_.join();
+        TimerWheel::TimerId pending_timer = TimerWheel::INVALID_TIMER_ID;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            
+            if (state_ == RecoveryState::InProgress) {
+                pending_timer = AbortLocked();
+            }
         }
+        timer_wheel_->Cancel(pending_timer);
+        attempt_tasks_.Wait();
     }
 
     RecoveryState GetState() const {
@@ -97,8 +105,9 @@ public:
         status.current_attempt = current_attempt_;
         status.max_attempts = config_.max_retries;
         status.start_time = start_time_;
+        status.coalesced_requests = coalesced_requests_;
         
-        auto now = std::chrono::steady_clock::now();
+        auto now = timer_wheel_->GetClock()->Now();
         status.elapsed_time = std::chrono::duration_cast<std::chrono::milliseconds>(now - start_time_);
         
         if (current_error_.has_value()) {
@@ -166,44 +175,69 @@ private:
         // For minimal implementation, we'll use built-in logic
     }
 
-    void PerformRecovery() {
-        while (true) {
-            {
-                std::lock_guard<std::mutex> lock(mutex_);
-                if (state_ == RecoveryState::Aborted) {
-                    return;
-                }
-                
-                current_attempt_++;
-                
-                // Check if exceeded max attempts
-                if (current_attempt_ > config_.max_retries) {
-                    state_ = RecoveryState::Failed;
-                    NotifyRecoveryFailed();
-                    return;
-                }
-                
-                NotifyRecoveryAttempt();
-            }
-            
-            // Calculate delay with exponential backoff and jitter
-            uint32_t delay_ms = CalculateDelay();
-            std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms));
-            
-            // Attempt to recover connection
-            bool success = AttemptConnection();
-            
-            {
-                std::lock_guard<std::mutex> lock(mutex_);
-                if (success) {
-                    state_ = RecoveryState::Succeeded;
-                    NotifyRecoverySuccess();
-                    return;
-                }
-                
-                // Continue retry loop if not successful
+    // Counts the next attempt and arms its timer, or fails the recovery once
+    // the retries are used up
+    void ScheduleNextAttemptLocked() {
+        current_attempt_++;
+        
+        // Check if exceeded max attempts
+        if (current_attempt_ > config_.max_retries) {
+            state_ = RecoveryState::Failed;
+            NotifyRecoveryFailed();
+            return;
+        }
+        
+        NotifyRecoveryAttempt();
+        
+        // Calculate delay with exponential backoff and jitter
+        const uint32_t delay_ms = CalculateDelay();
+        const uint64_t generation = generation_;
+        // The wheel thread only hands the attempt to the executor; the
+        // connection attempt itself may block. A manual wheel's driver is
+        // simulating time, so the attempt runs right there, in order.
+        if (timer_wheel_->IsManual()) {
+            timer_id_ = timer_wheel_->Schedule(std::chrono::milliseconds(delay_ms),
+                                               [this, generation]() { RunAttempt(generation); });
+            return;
+        }
+        timer_id_ = timer_wheel_->Schedule(std::chrono::milliseconds(delay_ms), [this, generation]() {
+            attempt_tasks_.Submit([this, generation]() { RunAttempt(generation); });
+        });
+    }
+
+    void RunAttempt(uint64_t generation) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (state_ != RecoveryState::InProgress || generation != generation_) {
+                return;
             }
+            timer_id_ = TimerWheel::INVALID_TIMER_ID;
         }
+        
+        // Attempt to recover connection
+        bool success = AttemptConnection();
+        
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Stopped, or stopped and restarted, while connecting
+        if (state_ != RecoveryState::InProgress || generation != generation_) {
+            return;
+        }
+        if (success) {
+            state_ = RecoveryState::Succeeded;
+            NotifyRecoverySuccess();
+            return;
+        }
+        
+        ScheduleNextAttemptLocked();
+    }
+
+    // Bumping the generation turns any attempt already handed to the
+    // executor into a no-op. Returns the pending timer for the caller to
+    // cancel once it has released mutex_
+    TimerWheel::TimerId AbortLocked() {
+        state_ = RecoveryState::Aborted;
+        generation_++;
+        return std::exchange(timer_id_, TimerWheel::INVALID_TIMER_ID);
     }
 
     uint32_t CalculateDelay() {
@@ -235,19 +269,16 @@ private:
         // For minimal implementation, simulate connection attempts
         // In real implementation, this would call connection_->Connect()
         // For now, simulate 50% success rate for recovery attempts
-        static int attempt_count = 0;
-        attempt_count++;
-        return (attempt_count % 2) == 0;
+        static std::atomic<int> attempt_count{0};
+        return (++attempt_count % 2) == 0;
     }
 
     void NotifyRecoveryAttempt() {
         // For minimal implementation, just log the attempt
         // In real implementation, this would call listener_->OnRecoveryAttempt()
         if (listener_ && current_error_.has_value()) {
-            if (spdlog::should_log(spdlog::level::debug)) {
-                spdlog::debug("Recovery attempt {} for error {}", current_attempt_,
-                              static_cast<int>(current_error_.value().error_code));
-            }
+            MULTIPLAYER_LOG_DEBUG("Recovery attempt {} for error {}", current_attempt_,
+                                  static_cast<int>(current_error_.value().error_code));
         }
     }
 
@@ -255,10 +286,8 @@ private:
         // For minimal implementation, just log the success
         // In real implementation, this would call listener_->OnRecoverySucceeded()
         if (listener_ && current_error_.has_value()) {
-            if (spdlog::should_log(spdlog::level::info)) {
-                spdlog::info("Recovery succeeded for error {}",
-                             static_cast<int>(current_error_.value().error_code));
-            }
+            MULTIPLAYER_LOG_INFO("Recovery succeeded for error {}",
+                                 static_cast<int>(current_error_.value().error_code));
         }
     }
 
@@ -266,11 +295,9 @@ private:
         // For minimal implementation, just log the failure
         // In real implementation, this would call listener_->OnRecoveryFailed()
         if (listener_ && current_error_.has_value()) {
-            if (spdlog::should_log(spdlog::level::err)) {
-                spdlog::error("Recovery failed for error {} after {} attempts",
-                              static_cast<int>(current_error_.value().error_code),
-                              current_attempt_);
-            }
+            MULTIPLAYER_LOG_ERROR("Recovery failed for error {} after {} attempts",
+                                  static_cast<int>(current_error_.value().error_code),
+                                  current_attempt_);
         }
     }
 
@@ -282,15 +309,22 @@ private:
     std::chrono::steady_clock::time_point start_time_;
     std::optional<ErrorInfo> current_error_;
     MockRecoveryListener* listener_;
-    std::thread recovery_thread_;
     std::unordered_map<ErrorCode, MockRecoveryStrategy*> custom_strategies_;
     std::mt19937 rng_;
+    size_t coalesced_requests_ = 0;
+    
+    std::shared_ptr<TimerWheel> timer_wheel_;
+    TimerWheel::TimerId timer_id_ = TimerWheel::INVALID_TIMER_ID;
+    // Identifies the current recovery; attempts from an earlier one drop out
+    uint64_t generation_ = 0;
+    ExecutorTaskGroup attempt_tasks_;
 };
 
 // ConnectionRecoveryManager implementation
 ConnectionRecoveryManager::ConnectionRecoveryManager(const RecoveryConfig& config, 
-                                                   MockNetworkConnection* connection)
-    : impl_(std::make_unique<Impl>(config, connection)) {}
+                                                   MockNetworkConnection* connection,
+                                                   std::shared_ptr<TimerWheel> timer_wheel)
+    : impl_(std::make_unique<Impl>(config, connection, std::move(timer_wheel))) {}
 
 ConnectionRecoveryManager::~ConnectionRecoveryManager() = default;
 
@@ -16,6 +16,7 @@
 namespace Core::Multiplayer {
 
 // Forward declarations
+class TimerWheel;
 class MockNetworkConnection;
 class MockRecoveryListener;
 class MockRecoveryStrategy;
@@ -31,6 +32,7 @@ struct RecoveryConfig {
     bool jitter_enabled = true;
     uint32_t jitter_range_percent = 25;
     uint32_t connection_timeout_ms = 10000;
+    uint64_t jitter_seed = 0; // Zero seeds from std::random_device
 };
 
 /**
@@ -65,6 +67,8 @@ struct RecoveryStatus {
     std::chrono::milliseconds elapsed_time;
     std::optional<ErrorInfo> last_error;
     RecoveryStrategy current_strategy;
+    // StartRecovery calls folded into this recovery while it was running
+    size_t coalesced_requests = 0;
 };
 
 /**
@@ -80,6 +84,12 @@ struct RecoveryStatus {
  * - Error categorization and filtering
  * - Thread-safe operations
  * - Integration with circuit breaker patterns
+ * - Attempts wait on the shared timer wheel and run on the shared executor,
+ *   so a recovery holds no thread while backing off
+ * - A StartRecovery while a recovery is running joins it rather than
+ *   starting a second one for the same connection
+ * - Given a manual TimerWheel, attempts run inline from RunDue() and time
+ *   is read from the wheel's clock, so recoveries replay deterministically
  * 
  * Usage:
  *   RecoveryConfig config;
@@ -95,7 +105,8 @@ struct RecoveryStatus {
 class ConnectionRecoveryManager {
 public:
     explicit ConnectionRecoveryManager(const RecoveryConfig& config, 
-                                     MockNetworkConnection* connection);
+                                     MockNetworkConnection* connection,
+                                     std::shared_ptr<TimerWheel> timer_wheel = nullptr);
     ~ConnectionRecoveryManager();
 
     // Core recovery operations
@@ -0,0 +1,156 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "connection_status_publisher.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace Core::Multiplayer {
+
+namespace {
+
+struct TierLimits {
+    ConnectionQuality quality;
+    std::chrono::milliseconds max_ping;
+    float max_loss;
+};
+
+// Best first
+constexpr TierLimits TIERS[] = {
+    {ConnectionQuality::Excellent, std::chrono::milliseconds(50), 0.01f},
+    {ConnectionQuality::Good, std::chrono::milliseconds(100), 0.03f},
+    {ConnectionQuality::Fair, std::chrono::milliseconds(200), 0.10f},
+};
+
+} // namespace
+
+ConnectionQuality ClassifyConnectionQuality(std::chrono::milliseconds ping, float loss_rate) {
+    for (const auto& tier : TIERS) {
+        if (ping < tier.max_ping && loss_rate < tier.max_loss) {
+            return tier.quality;
+        }
+    }
+    return ConnectionQuality::Poor;
+}
+
+ConnectionStatusPublisher::ConnectionStatusPublisher(StatsSource source, PublishCallback publish,
+                                                     ConnectionStatusConfig config,
+                                                     std::shared_ptr<TimerWheel> timer_wheel)
+    : source_(std::move(source)), publish_(std::move(publish)), config_(config),
+      timer_wheel_(timer_wheel ? std::move(timer_wheel) : TimerWheel::GetShared()) {}
+
+ConnectionStatusPublisher::~ConnectionStatusPublisher() {
+    Stop();
+}
+
+void ConnectionStatusPublisher::Start() {
+    if (config_.sample_interval.count() <= 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (sample_timer_ != TimerWheel::INVALID_TIMER_ID) {
+        return;
+    }
+    sample_timer_ =
+        timer_wheel_->ScheduleRepeating(config_.sample_interval, [this]() { Sample(); });
+}
+
+void ConnectionStatusPublisher::Stop() {
+    TimerWheel::TimerId timer;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        timer = std::exchange(sample_timer_, TimerWheel::INVALID_TIMER_ID);
+    }
+    // Outside the lock: Cancel waits for a running sample, which takes it
+    if (timer != TimerWheel::INVALID_TIMER_ID) {
+        timer_wheel_->Cancel(timer);
+    }
+}
+
+void ConnectionStatusPublisher::Sample(Clock::time_point now) {
+    // Filled outside the lock; the source may be slow and never needs it
+    BackendStats stats;
+    const bool sampled = source_(stats);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++statistics_.samples;
+    if (!sampled) {
+        ++statistics_.failed_samples;
+        return;
+    }
+    const auto current = published_ ? published_->quality : ConnectionQuality::Unknown;
+    const ConnectionStatus status = Summarize(stats, current, config_);
+    if (!IsSignificantLocked(status)) {
+        ++statistics_.insignificant;
+        return;
+    }
+    if (last_publish_ && now - *last_publish_ < config_.min_publish_interval) {
+        ++statistics_.deferred;
+        return;
+    }
+    published_ = status;
+    last_publish_ = now;
+    ++statistics_.publishes;
+    publish_(status);
+}
+
+void ConnectionStatusPublisher::Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    published_.reset();
+    last_publish_.reset();
+}
+
+std::optional<ConnectionStatus> ConnectionStatusPublisher::GetPublished() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return published_;
+}
+
+ConnectionStatusPublisherStatistics ConnectionStatusPublisher::GetStatistics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return statistics_;
+}
+
+ConnectionStatus ConnectionStatusPublisher::Summarize(const BackendStats& stats,
+                                                      ConnectionQuality current,
+                                                      const ConnectionStatusConfig& config) {
+    ConnectionStatus status;
+    status.peer_count = stats.node_count;
+    bool reported = false;
+    for (size_t i = 0; i < stats.node_count; ++i) {
+        const NodeStats& node = stats.nodes[i];
+        if (node.transport == LinkTransport::Unknown) {
+            continue;
+        }
+        reported = true;
+        status.ping = std::max(
+            status.ping, std::chrono::duration_cast<std::chrono::milliseconds>(node.rtt));
+        status.loss_rate = std::max(status.loss_rate, node.loss_rate);
+    }
+    if (!reported) {
+        return status;
+    }
+
+    status.quality = ClassifyConnectionQuality(status.ping, status.loss_rate);
+    if (current != ConnectionQuality::Unknown && status.quality > current) {
+        // Moving up only counts once it clears the margin too
+        const auto strict = ClassifyConnectionQuality(status.ping + config.tier_ping_margin,
+                                                      status.loss_rate + config.tier_loss_margin);
+        status.quality = std::max(current, strict);
+    }
+    return status;
+}
+
+bool ConnectionStatusPublisher::IsSignificantLocked(const ConnectionStatus& status) const {
+    if (!published_) {
+        return true;
+    }
+    if (status.quality != published_->quality || status.peer_count != published_->peer_count) {
+        return true;
+    }
+    const auto delta = status.ping > published_->ping ? status.ping - published_->ping
+                                                      : published_->ping - status.ping;
+    return delta >= config_.ping_hysteresis;
+}
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,129 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+#include "backend_stats.h"
+#include "timer_wheel.h"
+
+namespace Core::Multiplayer {
+
+/**
+ * Quality tier shown by the connection overlay, worst first
+ */
+enum class ConnectionQuality : uint8_t {
+    Unknown, // No link reported yet
+    Poor,
+    Fair,
+    Good,
+    Excellent,
+};
+
+/**
+ * What the overlay shows, summarized from BackendStats
+ */
+struct ConnectionStatus {
+    // Worst link, since the slowest peer is the one that stalls the game
+    std::chrono::milliseconds ping{0};
+    float loss_rate = 0.0f;
+    ConnectionQuality quality = ConnectionQuality::Unknown;
+    size_t peer_count = 0;
+
+    bool operator==(const ConnectionStatus&) const = default;
+};
+
+struct ConnectionStatusConfig {
+    // How often the stats are read; 0 leaves it to Sample() calls
+    std::chrono::milliseconds sample_interval{250};
+    // No two publishes closer than this
+    std::chrono::milliseconds min_publish_interval{500};
+    // Ping moves smaller than this are not worth a repaint
+    std::chrono::milliseconds ping_hysteresis{10};
+    // A link must beat a better tier's limits by this much to move up to it
+    std::chrono::milliseconds tier_ping_margin{10};
+    float tier_loss_margin = 0.005f;
+};
+
+struct ConnectionStatusPublisherStatistics {
+    uint64_t samples = 0;
+    uint64_t failed_samples = 0;  // Stats source returned false
+    uint64_t insignificant = 0;   // Samples within hysteresis of the published status
+    uint64_t deferred = 0;        // Significant samples held back by the publish rate cap
+    uint64_t publishes = 0;
+};
+
+// Tier for a link from its ping and loss alone
+ConnectionQuality ClassifyConnectionQuality(std::chrono::milliseconds ping, float loss_rate);
+
+/**
+ * Bridge from the backend's statistics to the connection overlay.
+ *
+ * Reading stats on every RTT sample and repainting for each would add a
+ * paint per packet on top of emulation frames. The publisher instead reads
+ * the stats on a TimerWheel interval and publishes only changes a player
+ * would notice: a quality tier or peer count change, or a ping move past
+ * the hysteresis. Moving up a tier takes a margin past its limits, so a
+ * link sitting on a boundary does not flicker. Publishes are at least
+ * min_publish_interval apart; a change arriving sooner goes out with the
+ * first sample after the interval, carrying the latest numbers.
+ *
+ * The callback runs on the wheel thread, or the thread calling Sample, with
+ * the publisher's lock held. It must not call back into the publisher and
+ * should only hand the status over to the UI thread, e.g. through a queued
+ * signal.
+ */
+class ConnectionStatusPublisher {
+public:
+    using Clock = std::chrono::steady_clock;
+    using StatsSource = std::function<bool(BackendStats& out_stats)>;
+    using PublishCallback = std::function<void(const ConnectionStatus& status)>;
+
+    ConnectionStatusPublisher(StatsSource source, PublishCallback publish,
+                              ConnectionStatusConfig config = {},
+                              std::shared_ptr<TimerWheel> timer_wheel = nullptr);
+    ~ConnectionStatusPublisher();
+
+    ConnectionStatusPublisher(const ConnectionStatusPublisher&) = delete;
+    ConnectionStatusPublisher& operator=(const ConnectionStatusPublisher&) = delete;
+
+    // Start sampling on the wheel; does nothing with a zero sample interval
+    void Start();
+    void Stop();
+
+    // Read the stats once and publish if warranted
+    void Sample(Clock::time_point now = Clock::now());
+
+    // Forget the published status, so the next sample publishes
+    void Reset();
+
+    std::optional<ConnectionStatus> GetPublished() const;
+    ConnectionStatusPublisherStatistics GetStatistics() const;
+
+    // The status stats describe, with the tier held against current
+    static ConnectionStatus Summarize(const BackendStats& stats, ConnectionQuality current,
+                                      const ConnectionStatusConfig& config);
+
+private:
+    bool IsSignificantLocked(const ConnectionStatus& status) const;
+
+    const StatsSource source_;
+    const PublishCallback publish_;
+    const ConnectionStatusConfig config_;
+    std::shared_ptr<TimerWheel> timer_wheel_;
+
+    mutable std::mutex mutex_;
+    std::optional<ConnectionStatus> published_;
+    std::optional<Clock::time_point> last_publish_;
+    TimerWheel::TimerId sample_timer_{TimerWheel::INVALID_TIMER_ID}; // guarded by mutex_
+    ConnectionStatusPublisherStatistics statistics_;
+};
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,163 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "cpu_features.h"
+
+#include <array>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define CPU_FEATURES_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define CPU_FEATURES_ARM 1
+#if defined(__linux__)
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+#endif
+
+namespace Core::Multiplayer {
+
+namespace {
+
+#if defined(CPU_FEATURES_X86)
+struct CpuidRegisters {
+    uint32_t eax = 0, ebx = 0, ecx = 0, edx = 0;
+};
+
+CpuidRegisters Cpuid(uint32_t leaf, uint32_t subleaf = 0) {
+    CpuidRegisters registers;
+#if defined(_MSC_VER)
+    std::array<int, 4> info{};
+    __cpuidex(info.data(), static_cast<int>(leaf), static_cast<int>(subleaf));
+    registers = {static_cast<uint32_t>(info[0]), static_cast<uint32_t>(info[1]),
+                 static_cast<uint32_t>(info[2]), static_cast<uint32_t>(info[3])};
+#else
+    __cpuid_count(leaf, subleaf, registers.eax, registers.ebx, registers.ecx, registers.edx);
+#endif
+    return registers;
+}
+
+// Which register sets the OS saves on a context switch
+uint64_t ReadXcr0() {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32_t eax = 0, edx = 0;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+
+uint32_t DetectBits() {
+    const uint32_t max_leaf = Cpuid(0).eax;
+    if (max_leaf < 1) {
+        return 0;
+    }
+    const CpuidRegisters leaf1 = Cpuid(1);
+    uint32_t bits = 0;
+    const auto set = [&bits](bool present, CpuFeature feature) {
+        if (present) {
+            bits |= static_cast<uint32_t>(feature);
+        }
+    };
+    set((leaf1.edx & (1u << 26)) != 0, CpuFeature::Sse2);
+    set((leaf1.ecx & (1u << 9)) != 0, CpuFeature::Ssse3);
+    set((leaf1.ecx & (1u << 19)) != 0, CpuFeature::Sse41);
+    set((leaf1.ecx & (1u << 20)) != 0, CpuFeature::Sse42);
+    set((leaf1.ecx & (1u << 1)) != 0, CpuFeature::Pclmul);
+    set((leaf1.ecx & (1u << 25)) != 0, CpuFeature::Aes);
+
+    if (max_leaf >= 7) {
+        const CpuidRegisters leaf7 = Cpuid(7, 0);
+        // AVX state is only usable once the OS has enabled XMM and YMM saving
+        const bool os_saves_ymm = (leaf1.ecx & (1u << 27)) != 0 && (ReadXcr0() & 0x6) == 0x6;
+        set(os_saves_ymm && (leaf7.ebx & (1u << 5)) != 0, CpuFeature::Avx2);
+        set((leaf7.ebx & (1u << 8)) != 0, CpuFeature::Bmi2);
+    }
+    return bits;
+}
+#elif defined(CPU_FEATURES_ARM)
+uint32_t DetectBits() {
+    // Advanced SIMD is part of the AArch64 baseline
+    uint32_t bits = static_cast<uint32_t>(CpuFeature::Neon);
+#if defined(__APPLE__)
+    // Every Apple AArch64 core has the CRC and crypto extensions
+    bits |= static_cast<uint32_t>(CpuFeature::ArmCrc32 | CpuFeature::ArmAes | CpuFeature::ArmPmull);
+#elif defined(__linux__)
+    const unsigned long hwcap = getauxval(AT_HWCAP);
+    if ((hwcap & HWCAP_CRC32) != 0) {
+        bits |= static_cast<uint32_t>(CpuFeature::ArmCrc32);
+    }
+    if ((hwcap & HWCAP_AES) != 0) {
+        bits |= static_cast<uint32_t>(CpuFeature::ArmAes);
+    }
+    if ((hwcap & HWCAP_PMULL) != 0) {
+        bits |= static_cast<uint32_t>(CpuFeature::ArmPmull);
+    }
+#elif defined(_WIN32)
+    if (IsProcessorFeaturePresent(PF_ARM_V8_CRC32_INSTRUCTIONS_AVAILABLE)) {
+        bits |= static_cast<uint32_t>(CpuFeature::ArmCrc32);
+    }
+    if (IsProcessorFeaturePresent(PF_ARM_V8_CRYPTO_INSTRUCTIONS_AVAILABLE)) {
+        bits |= static_cast<uint32_t>(CpuFeature::ArmAes | CpuFeature::ArmPmull);
+    }
+#endif
+    return bits;
+}
+#else
+uint32_t DetectBits() {
+    return 0;
+}
+#endif
+
+constexpr std::array<std::pair<CpuFeature, const char*>, 12> FEATURE_NAMES = {{
+    {CpuFeature::Sse2, "sse2"},
+    {CpuFeature::Ssse3, "ssse3"},
+    {CpuFeature::Sse41, "sse4.1"},
+    {CpuFeature::Sse42, "sse4.2"},
+    {CpuFeature::Pclmul, "pclmul"},
+    {CpuFeature::Aes, "aes"},
+    {CpuFeature::Avx2, "avx2"},
+    {CpuFeature::Bmi2, "bmi2"},
+    {CpuFeature::Neon, "neon"},
+    {CpuFeature::ArmCrc32, "crc32"},
+    {CpuFeature::ArmAes, "aes"},
+    {CpuFeature::ArmPmull, "pmull"},
+}};
+
+} // namespace
+
+CpuFeatures CpuFeatures::Detect() {
+    CpuFeatures features;
+    features.bits_ = DetectBits();
+    return features;
+}
+
+std::string CpuFeatures::ToString() const {
+    std::string names;
+    for (const auto& [feature, name] : FEATURE_NAMES) {
+        if (!Has(feature)) {
+            continue;
+        }
+        if (!names.empty()) {
+            names += ' ';
+        }
+        names += name;
+    }
+    return names;
+}
+
+const CpuFeatures& GetCpuFeatures() {
+    static const CpuFeatures features = CpuFeatures::Detect();
+    return features;
+}
+
+} // namespace Core::Multiplayer
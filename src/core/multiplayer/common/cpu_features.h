@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+
+namespace Core::Multiplayer {
+
+// Instruction set extensions a kernel can be specialised for
+enum class CpuFeature : uint32_t {
+    None = 0,
+    // x86
+    Sse2 = 1u << 0,
+    Ssse3 = 1u << 1,
+    Sse41 = 1u << 2,
+    Sse42 = 1u << 3,
+    Pclmul = 1u << 4,
+    Aes = 1u << 5,
+    Avx2 = 1u << 6, // Only reported when the OS saves the YMM registers
+    Bmi2 = 1u << 7,
+    // AArch64
+    Neon = 1u << 16,
+    ArmCrc32 = 1u << 17,
+    ArmAes = 1u << 18,
+    ArmPmull = 1u << 19,
+};
+
+constexpr CpuFeature operator|(CpuFeature a, CpuFeature b) {
+    return static_cast<CpuFeature>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b));
+}
+
+/**
+ * Set of instruction set extensions, as detected on this CPU or as
+ * required by a kernel
+ */
+class CpuFeatures {
+public:
+    constexpr CpuFeatures() = default;
+    constexpr CpuFeatures(CpuFeature features) : bits_(static_cast<uint32_t>(features)) {}
+
+    // Queries CPUID, or the kernel's HWCAP on ARM; GetCpuFeatures caches this
+    static CpuFeatures Detect();
+
+    // Whether every feature in features is present
+    constexpr bool Has(CpuFeature features) const {
+        const auto wanted = static_cast<uint32_t>(features);
+        return (bits_ & wanted) == wanted;
+    }
+
+    constexpr bool Has(CpuFeatures features) const {
+        return (bits_ & features.bits_) == features.bits_;
+    }
+
+    constexpr CpuFeatures Without(CpuFeature features) const {
+        CpuFeatures result;
+        result.bits_ = bits_ & ~static_cast<uint32_t>(features);
+        return result;
+    }
+
+    constexpr uint32_t GetBits() const {
+        return bits_;
+    }
+
+    // Space separated feature names, e.g. "sse2 sse4.2 avx2", for logs
+    std::string ToString() const;
+
+    constexpr bool operator==(const CpuFeatures&) const = default;
+
+private:
+    uint32_t bits_ = 0;
+};
+
+// Features of the CPU the process runs on, detected on first use
+const CpuFeatures& GetCpuFeatures();
+
+/**
+ * One implementation of a kernel and the features it needs
+ */
+template <typename Function>
+struct KernelVariant {
+    CpuFeatures required;
+    Function function;
+};
+
+/**
+ * Function-pointer multiversioning: picks the first variant the CPU can
+ * run, or fallback when none fits. List variants best first and resolve
+ * once into a function-local static, so a call costs one indirect branch:
+ *
+ *   static const Kernel kernel = SelectKernel<Kernel>(
+ *       {{CpuFeature::Avx2, ScanAvx2}, {CpuFeature::Sse42, ScanSse42}}, ScanScalar);
+ *
+ * Variants needing an extension the baseline build lacks belong in their
+ * own translation unit, added with sudachi_multiplayer_isa_sources() in
+ * CMake, which also defines SUDACHI_MULTIPLAYER_HAS_<ISA>_KERNELS so the
+ * caller knows the variant was built.
+ */
+template <typename Function>
+Function SelectKernel(std::initializer_list<KernelVariant<Function>> variants, Function fallback,
+                      const CpuFeatures& features = GetCpuFeatures()) {
+    for (const auto& variant : variants) {
+        if (variant.function != nullptr && features.Has(variant.required)) {
+            return variant.function;
+        }
+    }
+    return fallback;
+}
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,196 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "crc32.h"
+#include "cpu_features.h"
+
+#include <array>
+#include <bit>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define CRC32_X86 1
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#include <arm_acle.h>
+#define CRC32_ARM 1
+#endif
+
+namespace Core::Multiplayer {
+
+namespace {
+
+constexpr uint32_t POLYNOMIAL = 0xEDB88320; // Reflected 0x04C11DB7
+
+// Slicing-by-8: table[k][b] is the CRC of byte b followed by k zero bytes
+constexpr std::array<std::array<uint32_t, 256>, 8> MakeTables() {
+    std::array<std::array<uint32_t, 256>, 8> tables{};
+    for (uint32_t byte = 0; byte < 256; ++byte) {
+        uint32_t crc = byte;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ ((crc & 1) != 0 ? POLYNOMIAL : 0);
+        }
+        tables[0][byte] = crc;
+    }
+    for (size_t k = 1; k < tables.size(); ++k) {
+        for (uint32_t byte = 0; byte < 256; ++byte) {
+            const uint32_t previous = tables[k - 1][byte];
+            tables[k][byte] = (previous >> 8) ^ tables[0][previous & 0xFF];
+        }
+    }
+    return tables;
+}
+
+constexpr auto TABLES = MakeTables();
+
+uint32_t LoadLittle32(const uint8_t* data) {
+    uint32_t word;
+    std::memcpy(&word, data, sizeof(word));
+    if constexpr (std::endian::native == std::endian::big) {
+        word = __builtin_bswap32(word);
+    }
+    return word;
+}
+
+uint32_t Software(const uint8_t* data, size_t size, uint32_t crc) {
+    while (size >= 8) {
+        const uint32_t low = LoadLittle32(data) ^ crc;
+        const uint32_t high = LoadLittle32(data + 4);
+        crc = TABLES[7][low & 0xFF] ^ TABLES[6][(low >> 8) & 0xFF] ^
+              TABLES[5][(low >> 16) & 0xFF] ^ TABLES[4][low >> 24] ^
+              TABLES[3][high & 0xFF] ^ TABLES[2][(high >> 8) & 0xFF] ^
+              TABLES[1][(high >> 16) & 0xFF] ^ TABLES[0][high >> 24];
+        data += 8;
+        size -= 8;
+    }
+    while (size-- != 0) {
+        crc = (crc >> 8) ^ TABLES[0][(crc ^ *data++) & 0xFF];
+    }
+    return crc;
+}
+
+#if defined(CRC32_X86)
+/*
+ * Folding with PCLMULQDQ, after "Fast CRC Computation for Generic
+ * Polynomials Using PCLMULQDQ Instruction" (Gopal et al., Intel, 2009).
+ * Four 128-bit lanes fold 64 bytes per round, are folded into one, and the
+ * remaining 64 bits are Barrett-reduced to the CRC. The constants are the
+ * paper's bit-reflected x^n mod P values for CRC-32.
+ */
+constexpr size_t FOLD_MIN_SIZE = 64;
+
+__attribute__((target("pclmul,sse4.1"))) __m128i Load(const uint8_t* at) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(at));
+}
+
+// Folds lane forward over 128 bits and adds next
+__attribute__((target("pclmul,sse4.1"))) __m128i Fold(__m128i lane, __m128i next,
+                                                       __m128i k) {
+    const __m128i low = _mm_clmulepi64_si128(lane, k, 0x00);
+    const __m128i high = _mm_clmulepi64_si128(lane, k, 0x11);
+    return _mm_xor_si128(_mm_xor_si128(high, low), next);
+}
+
+__attribute__((target("pclmul,sse4.1"))) uint32_t Folded(const uint8_t* data, size_t size,
+                                                         uint32_t crc) {
+    alignas(16) static constexpr uint64_t k1k2[2]{0x0154442BD4, 0x01C6E41596};
+    alignas(16) static constexpr uint64_t k3k4[2]{0x01751997D0, 0x00CCAA009E};
+    alignas(16) static constexpr uint64_t k5k0[2]{0x0163CD6124, 0x0000000000};
+    alignas(16) static constexpr uint64_t poly[2]{0x01DB710641, 0x01F7011641};
+
+    __m128i x1 = _mm_xor_si128(Load(data), _mm_cvtsi32_si128(static_cast<int>(crc)));
+    __m128i x2 = Load(data + 16);
+    __m128i x3 = Load(data + 32);
+    __m128i x4 = Load(data + 48);
+    data += 64;
+    size -= 64;
+
+    __m128i k = _mm_load_si128(reinterpret_cast<const __m128i*>(k1k2));
+    while (size >= 64) {
+        x1 = Fold(x1, Load(data), k);
+        x2 = Fold(x2, Load(data + 16), k);
+        x3 = Fold(x3, Load(data + 32), k);
+        x4 = Fold(x4, Load(data + 48), k);
+        data += 64;
+        size -= 64;
+    }
+
+    k = _mm_load_si128(reinterpret_cast<const __m128i*>(k3k4));
+    x1 = Fold(x1, x2, k);
+    x1 = Fold(x1, x3, k);
+    x1 = Fold(x1, x4, k);
+    while (size >= 16) {
+        x1 = Fold(x1, Load(data), k);
+        data += 16;
+        size -= 16;
+    }
+
+    // 128 bits to 64
+    const __m128i mask = _mm_setr_epi32(~0, 0, ~0, 0);
+    x2 = _mm_clmulepi64_si128(x1, k, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+    k = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(k5k0));
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask), k, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduction to 32 bits
+    k = _mm_load_si128(reinterpret_cast<const __m128i*>(poly));
+    x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask), k, 0x10);
+    x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, mask), k, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+    crc = static_cast<uint32_t>(_mm_extract_epi32(x1, 1));
+
+    // Under 16 bytes left
+    return Software(data, size, crc);
+}
+
+uint32_t Hardware(const uint8_t* data, size_t size, uint32_t crc) {
+    if (size < FOLD_MIN_SIZE) {
+        return Software(data, size, crc);
+    }
+    return Folded(data, size, crc);
+}
+
+#elif defined(CRC32_ARM)
+__attribute__((target("+crc"))) uint32_t Hardware(const uint8_t* data, size_t size,
+                                                  uint32_t crc) {
+    while (size >= 8) {
+        uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        crc = __crc32d(crc, word);
+        data += 8;
+        size -= 8;
+    }
+    while (size-- != 0) {
+        crc = __crc32b(crc, *data++);
+    }
+    return crc;
+}
+#endif
+
+using Kernel = uint32_t (*)(const uint8_t*, size_t, uint32_t);
+
+Kernel GetKernel() {
+#if defined(CRC32_X86)
+    static const Kernel kernel =
+        SelectKernel<Kernel>({{CpuFeature::Pclmul | CpuFeature::Sse41, Hardware}}, Software);
+#elif defined(CRC32_ARM)
+    static const Kernel kernel = SelectKernel<Kernel>({{CpuFeature::ArmCrc32, Hardware}}, Software);
+#else
+    static const Kernel kernel = Software;
+#endif
+    return kernel;
+}
+
+} // namespace
+
+uint32_t Crc32(std::span<const uint8_t> data, uint32_t crc) {
+    return ~GetKernel()(data.data(), data.size(), ~crc);
+}
+
+bool IsCrc32Accelerated() {
+    return GetKernel() != Software;
+}
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,25 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+namespace Core::Multiplayer {
+
+/**
+ * CRC-32 (IEEE 802.3), the checksum of zlib, PNG and Ethernet.
+ *
+ * Folds 64 bytes at a time with carry-less multiplication (PCLMULQDQ) on
+ * x86 and runs on the ARMv8 CRC32 instructions on ARM, falling back to
+ * slicing-by-8 tables elsewhere. Chain calls by passing the previous result
+ * as crc. For a checksum that only this project reads, Crc32c is cheaper
+ * on x86.
+ */
+uint32_t Crc32(std::span<const uint8_t> data, uint32_t crc = 0);
+
+// Whether Crc32 runs on CLMUL or CRC instructions
+bool IsCrc32Accelerated();
+
+} // namespace Core::Multiplayer
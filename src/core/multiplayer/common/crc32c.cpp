@@ -0,0 +1,131 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "crc32c.h"
+#include "cpu_features.h"
+
+#include <array>
+#include <bit>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#define CRC32C_X86 1
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#include <arm_acle.h>
+#define CRC32C_ARM 1
+#endif
+
+namespace Core::Multiplayer {
+
+namespace {
+
+constexpr uint32_t POLYNOMIAL = 0x82F63B78; // Reflected 0x1EDC6F41
+
+// Slicing-by-4: table[k][b] is the CRC of byte b followed by k zero bytes
+constexpr std::array<std::array<uint32_t, 256>, 4> MakeTables() {
+    std::array<std::array<uint32_t, 256>, 4> tables{};
+    for (uint32_t byte = 0; byte < 256; ++byte) {
+        uint32_t crc = byte;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ ((crc & 1) != 0 ? POLYNOMIAL : 0);
+        }
+        tables[0][byte] = crc;
+    }
+    for (size_t k = 1; k < tables.size(); ++k) {
+        for (uint32_t byte = 0; byte < 256; ++byte) {
+            const uint32_t previous = tables[k - 1][byte];
+            tables[k][byte] = (previous >> 8) ^ tables[0][previous & 0xFF];
+        }
+    }
+    return tables;
+}
+
+constexpr auto TABLES = MakeTables();
+
+uint32_t Software(const uint8_t* data, size_t size, uint32_t crc) {
+    while (size >= 4) {
+        uint32_t word;
+        std::memcpy(&word, data, sizeof(word));
+        if constexpr (std::endian::native == std::endian::big) {
+            word = __builtin_bswap32(word);
+        }
+        crc ^= word;
+        crc = TABLES[3][crc & 0xFF] ^ TABLES[2][(crc >> 8) & 0xFF] ^
+              TABLES[1][(crc >> 16) & 0xFF] ^ TABLES[0][crc >> 24];
+        data += 4;
+        size -= 4;
+    }
+    while (size-- != 0) {
+        crc = (crc >> 8) ^ TABLES[0][(crc ^ *data++) & 0xFF];
+    }
+    return crc;
+}
+
+#if defined(CRC32C_X86)
+__attribute__((target("sse4.2"))) uint32_t Hardware(const uint8_t* data, size_t size,
+                                                    uint32_t crc) {
+#if defined(__x86_64__)
+    uint64_t crc64 = crc;
+    while (size >= 8) {
+        uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+        data += 8;
+        size -= 8;
+    }
+    crc = static_cast<uint32_t>(crc64);
+#endif
+    while (size >= 4) {
+        uint32_t word;
+        std::memcpy(&word, data, sizeof(word));
+        crc = _mm_crc32_u32(crc, word);
+        data += 4;
+        size -= 4;
+    }
+    while (size-- != 0) {
+        crc = _mm_crc32_u8(crc, *data++);
+    }
+    return crc;
+}
+#elif defined(CRC32C_ARM)
+__attribute__((target("+crc"))) uint32_t Hardware(const uint8_t* data, size_t size,
+                                                  uint32_t crc) {
+    while (size >= 8) {
+        uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        crc = __crc32cd(crc, word);
+        data += 8;
+        size -= 8;
+    }
+    while (size-- != 0) {
+        crc = __crc32cb(crc, *data++);
+    }
+    return crc;
+}
+#endif
+
+using Kernel = uint32_t (*)(const uint8_t*, size_t, uint32_t);
+
+Kernel GetKernel() {
+#if defined(CRC32C_X86)
+    static const Kernel kernel = SelectKernel<Kernel>({{CpuFeature::Sse42, Hardware}}, Software);
+#elif defined(CRC32C_ARM)
+    static const Kernel kernel = SelectKernel<Kernel>({{CpuFeature::ArmCrc32, Hardware}}, Software);
+#else
+    static const Kernel kernel = Software;
+#endif
+    return kernel;
+}
+
+} // namespace
+
+uint32_t Crc32c(std::span<const uint8_t> data, uint32_t crc) {
+    return ~GetKernel()(data.data(), data.size(), ~crc);
+}
+
+bool IsCrc32cAccelerated() {
+    return GetKernel() != Software;
+}
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,24 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+namespace Core::Multiplayer {
+
+/**
+ * CRC-32C (Castagnoli), as used by iSCSI and SCTP.
+ *
+ * Runs on the SSE4.2 crc32 instruction or the ARMv8 CRC32C instructions
+ * where the CPU has them, which checks a full datagram in well under a
+ * microsecond, and on a table otherwise. Chain calls by passing the
+ * previous result as crc.
+ */
+uint32_t Crc32c(std::span<const uint8_t> data, uint32_t crc = 0);
+
+// Whether Crc32c runs on CRC instructions
+bool IsCrc32cAccelerated();
+
+} // namespace Core::Multiplayer
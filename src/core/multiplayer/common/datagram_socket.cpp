@@ -0,0 +1,719 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "datagram_socket.h"
+#include "registered_io.h"
+
+#include <algorithm>
+#include <cstring>
+#include <optional>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <linux/errqueue.h>
+#include <linux/net_tstamp.h>
+#endif
+
+namespace Core::Multiplayer {
+
+static_assert(DatagramEndpoint::STORAGE_SIZE >= sizeof(sockaddr_in6),
+              "DatagramEndpoint must hold an IPv6 address");
+
+namespace {
+
+#ifdef _WIN32
+using NativeSocket = SOCKET;
+using AddressLength = int;
+
+bool EnsureWinsock() {
+    static const bool started = [] {
+        WSADATA data;
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }();
+    return started;
+}
+
+void CloseNative(NativeSocket socket) {
+    closesocket(socket);
+}
+
+bool SetNonBlocking(NativeSocket socket) {
+    u_long enable = 1;
+    return ioctlsocket(socket, FIONBIO, &enable) == 0;
+}
+#else
+using NativeSocket = int;
+using AddressLength = socklen_t;
+
+bool EnsureWinsock() {
+    return true;
+}
+
+void CloseNative(NativeSocket socket) {
+    ::close(socket);
+}
+
+bool SetNonBlocking(NativeSocket socket) {
+    const int flags = ::fcntl(socket, F_GETFL, 0);
+    return flags >= 0 && ::fcntl(socket, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+#endif
+
+NativeSocket ToNative(intptr_t handle) {
+    return static_cast<NativeSocket>(handle);
+}
+
+sockaddr* AddressOf(DatagramEndpoint& endpoint) {
+    return reinterpret_cast<sockaddr*>(endpoint.storage.data());
+}
+
+#ifdef __linux__
+// Control data of one datagram: its timestamps and, on the error queue, the
+// extended error that carries a transmit timestamp's id
+struct alignas(cmsghdr) TimestampControl {
+    uint8_t bytes[CMSG_SPACE(sizeof(scm_timestamping)) +
+                  CMSG_SPACE(sizeof(sock_extended_err) + sizeof(sockaddr_in6))];
+};
+
+int64_t ToNanoseconds(const timespec& time) {
+    return static_cast<int64_t>(time.tv_sec) * 1'000'000'000 + time.tv_nsec;
+}
+
+// Merges what the message carries, so separate software and hardware
+// reports of one datagram add up
+void ReadTimestamps(msghdr& message, DatagramTimestamps& out) {
+    for (cmsghdr* header = CMSG_FIRSTHDR(&message); header != nullptr;
+         header = CMSG_NXTHDR(&message, header)) {
+        if (header->cmsg_level != SOL_SOCKET || header->cmsg_type != SO_TIMESTAMPING) {
+            continue;
+        }
+        scm_timestamping timestamps;
+        std::memcpy(&timestamps, CMSG_DATA(header), sizeof(timestamps));
+        // ts[1] is unused; ts[2] is the NIC's raw clock
+        if (const int64_t software = ToNanoseconds(timestamps.ts[0]); software != 0) {
+            out.software_ns = software;
+        }
+        if (const int64_t hardware = ToNanoseconds(timestamps.ts[2]); hardware != 0) {
+            out.hardware_ns = hardware;
+        }
+    }
+}
+#endif
+
+const sockaddr* AddressOf(const DatagramEndpoint& endpoint) {
+    return reinterpret_cast<const sockaddr*>(endpoint.storage.data());
+}
+
+} // anonymous namespace
+
+bool DatagramEndpoint::FromString(const std::string& host, uint16_t port, DatagramEndpoint& out) {
+    out = DatagramEndpoint{};
+    sockaddr_in ipv4{};
+    if (inet_pton(AF_INET, host.c_str(), &ipv4.sin_addr) == 1) {
+        ipv4.sin_family = AF_INET;
+        ipv4.sin_port = htons(port);
+        std::memcpy(out.storage.data(), &ipv4, sizeof(ipv4));
+        out.length = sizeof(ipv4);
+        return true;
+    }
+    sockaddr_in6 ipv6{};
+    if (inet_pton(AF_INET6, host.c_str(), &ipv6.sin6_addr) == 1) {
+        ipv6.sin6_family = AF_INET6;
+        ipv6.sin6_port = htons(port);
+        std::memcpy(out.storage.data(), &ipv6, sizeof(ipv6));
+        out.length = sizeof(ipv6);
+        return true;
+    }
+    return false;
+}
+
+uint16_t DatagramEndpoint::Port() const {
+    if (length == sizeof(sockaddr_in)) {
+        return ntohs(reinterpret_cast<const sockaddr_in*>(storage.data())->sin_port);
+    }
+    if (length == sizeof(sockaddr_in6)) {
+        return ntohs(reinterpret_cast<const sockaddr_in6*>(storage.data())->sin6_port);
+    }
+    return 0;
+}
+
+bool DatagramEndpoint::IsIPv6() const {
+    return length == sizeof(sockaddr_in6);
+}
+
+void DatagramEndpoint::SetPort(uint16_t port) {
+    if (length == sizeof(sockaddr_in)) {
+        reinterpret_cast<sockaddr_in*>(storage.data())->sin_port = htons(port);
+    } else if (length == sizeof(sockaddr_in6)) {
+        reinterpret_cast<sockaddr_in6*>(storage.data())->sin6_port = htons(port);
+    }
+}
+
+std::string DatagramEndpoint::ToString() const {
+    char address[INET6_ADDRSTRLEN] = {};
+    if (length == sizeof(sockaddr_in)) {
+        const auto* ipv4 = reinterpret_cast<const sockaddr_in*>(storage.data());
+        inet_ntop(AF_INET, &ipv4->sin_addr, address, sizeof(address));
+        return std::string(address) + ':' + std::to_string(Port());
+    }
+    if (length == sizeof(sockaddr_in6)) {
+        const auto* ipv6 = reinterpret_cast<const sockaddr_in6*>(storage.data());
+        inet_ntop(AF_INET6, &ipv6->sin6_addr, address, sizeof(address));
+        return '[' + std::string(address) + "]:" + std::to_string(Port());
+    }
+    return {};
+}
+
+bool DatagramEndpoint::operator==(const DatagramEndpoint& other) const {
+    if (length != other.length) {
+        return false;
+    }
+    if (length == sizeof(sockaddr_in)) {
+        const auto* a = reinterpret_cast<const sockaddr_in*>(storage.data());
+        const auto* b = reinterpret_cast<const sockaddr_in*>(other.storage.data());
+        return a->sin_addr.s_addr == b->sin_addr.s_addr && a->sin_port == b->sin_port;
+    }
+    if (length == sizeof(sockaddr_in6)) {
+        const auto* a = reinterpret_cast<const sockaddr_in6*>(storage.data());
+        const auto* b = reinterpret_cast<const sockaddr_in6*>(other.storage.data());
+        return std::memcmp(&a->sin6_addr, &b->sin6_addr, sizeof(a->sin6_addr)) == 0 &&
+               a->sin6_port == b->sin6_port && a->sin6_scope_id == b->sin6_scope_id;
+    }
+    return length == 0;
+}
+
+DatagramSocket::DatagramSocket() = default;
+
+DatagramSocket::~DatagramSocket() {
+    Close();
+}
+
+ErrorCode DatagramSocket::Open(const std::string& bind_address, uint16_t port,
+                               const DatagramSocketOptions& options) {
+    if (IsOpen()) {
+        return ErrorCode::InvalidState;
+    }
+    if (!EnsureWinsock()) {
+        return ErrorCode::PlatformAPIError;
+    }
+    if (options.registered_io && !RegisteredIoQueue::IsSupported()) {
+        return ErrorCode::PlatformFeatureUnavailable;
+    }
+    DatagramEndpoint local;
+    if (!DatagramEndpoint::FromString(bind_address, port, local)) {
+        return ErrorCode::InvalidParameter;
+    }
+
+    const int family = AddressOf(local)->sa_family;
+    const NativeSocket socket =
+        options.registered_io ? ToNative(RegisteredIoQueue::CreateSocket(family))
+                              : ::socket(family, SOCK_DGRAM, IPPROTO_UDP);
+#ifdef _WIN32
+    if (socket == INVALID_SOCKET) {
+#else
+    if (socket < 0) {
+#endif
+        return ErrorCode::NetworkError;
+    }
+    handle_ = static_cast<intptr_t>(socket);
+
+    const int enable = 1;
+    const auto* enable_value = reinterpret_cast<const char*>(&enable);
+    if (options.reuse_address) {
+        setsockopt(socket, SOL_SOCKET, SO_REUSEADDR, enable_value, sizeof(enable));
+    }
+    if (options.reuse_port) {
+#ifdef SO_REUSEPORT
+        if (setsockopt(socket, SOL_SOCKET, SO_REUSEPORT, enable_value, sizeof(enable)) != 0) {
+            Close();
+            return ErrorCode::PlatformFeatureUnavailable;
+        }
+#else
+        Close();
+        return ErrorCode::PlatformFeatureUnavailable;
+#endif
+    }
+    // Best effort; the kernel may clamp either size
+    if (options.receive_buffer_size != 0) {
+        const int size = static_cast<int>(options.receive_buffer_size);
+        setsockopt(socket, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char*>(&size),
+                   sizeof(size));
+    }
+    if (options.send_buffer_size != 0) {
+        const int size = static_cast<int>(options.send_buffer_size);
+        setsockopt(socket, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<const char*>(&size),
+                   sizeof(size));
+    }
+
+    if (!SetNonBlocking(socket)) {
+        Close();
+        return ErrorCode::PlatformAPIError;
+    }
+    if (::bind(socket, AddressOf(local), static_cast<AddressLength>(local.length)) != 0) {
+        Close();
+        return ErrorCode::ConnectionRefused;
+    }
+    if (options.registered_io) {
+        // Receives can only be posted once the socket is bound
+        rio_ = RegisteredIoQueue::Create(handle_);
+        if (!rio_) {
+            Close();
+            return ErrorCode::PlatformFeatureUnavailable;
+        }
+    }
+    return ErrorCode::Success;
+}
+
+ErrorCode DatagramSocket::Adopt(intptr_t handle) {
+    if (IsOpen()) {
+        return ErrorCode::InvalidState;
+    }
+    if (handle == INVALID_HANDLE || !EnsureWinsock()) {
+        return ErrorCode::InvalidParameter;
+    }
+    const NativeSocket socket = ToNative(handle);
+    int type = 0;
+    AddressLength length = sizeof(type);
+    if (::getsockopt(socket, SOL_SOCKET, SO_TYPE, reinterpret_cast<char*>(&type), &length) != 0 ||
+        type != SOCK_DGRAM) {
+        return ErrorCode::InvalidParameter;
+    }
+    if (!SetNonBlocking(socket)) {
+        return ErrorCode::PlatformAPIError;
+    }
+    handle_ = handle;
+    return ErrorCode::Success;
+}
+
+ErrorCode DatagramSocket::Connect(const DatagramEndpoint& peer) {
+    if (!IsOpen()) {
+        return ErrorCode::NotInitialized;
+    }
+    if (::connect(ToNative(handle_), AddressOf(peer), static_cast<AddressLength>(peer.length)) !=
+        0) {
+        return ErrorCode::ConnectionFailed;
+    }
+    return ErrorCode::Success;
+}
+
+ErrorCode DatagramSocket::JoinMulticastGroup(const std::string& group_address,
+                                             const std::string& interface_address) {
+    if (!IsOpen()) {
+        return ErrorCode::NotInitialized;
+    }
+    ip_mreq request{};
+    if (inet_pton(AF_INET, group_address.c_str(), &request.imr_multiaddr) != 1 ||
+        !IN_MULTICAST(ntohl(request.imr_multiaddr.s_addr))) {
+        return ErrorCode::InvalidParameter;
+    }
+    request.imr_interface.s_addr = htonl(INADDR_ANY);
+    if (!interface_address.empty() &&
+        inet_pton(AF_INET, interface_address.c_str(), &request.imr_interface) != 1) {
+        return ErrorCode::InvalidParameter;
+    }
+
+    const NativeSocket socket = ToNative(handle_);
+    if (setsockopt(socket, IPPROTO_IP, IP_ADD_MEMBERSHIP, reinterpret_cast<const char*>(&request),
+                   sizeof(request)) != 0) {
+        return ErrorCode::PlatformFeatureUnavailable;
+    }
+    // Best effort; without them the system picks the interface and the
+    // caller filters its own datagrams
+    setsockopt(socket, IPPROTO_IP, IP_MULTICAST_IF,
+               reinterpret_cast<const char*>(&request.imr_interface),
+               sizeof(request.imr_interface));
+#ifdef _WIN32
+    const DWORD loop = 0;
+#else
+    const unsigned char loop = 0;
+#endif
+    setsockopt(socket, IPPROTO_IP, IP_MULTICAST_LOOP, reinterpret_cast<const char*>(&loop),
+               sizeof(loop));
+    return ErrorCode::Success;
+}
+
+ErrorCode DatagramSocket::EnableBroadcast() {
+    if (!IsOpen()) {
+        return ErrorCode::NotInitialized;
+    }
+    const int enable = 1;
+    if (setsockopt(ToNative(handle_), SOL_SOCKET, SO_BROADCAST,
+                   reinterpret_cast<const char*>(&enable), sizeof(enable)) != 0) {
+        return ErrorCode::PlatformAPIError;
+    }
+    return ErrorCode::Success;
+}
+
+void DatagramSocket::Close() {
+    if (IsOpen()) {
+        CloseNative(ToNative(handle_));
+        handle_ = INVALID_HANDLE;
+    }
+    // After the socket, which takes its request queue with it
+    rio_.reset();
+}
+
+SocketTuningResult DatagramSocket::Tune(const SocketTuningProfile& profile) {
+    if (!IsOpen()) {
+        return SocketTuningResult{false, false, false, false};
+    }
+    return ApplySocketTuning(handle_, profile);
+}
+
+DatagramEndpoint DatagramSocket::GetLocalEndpoint() const {
+    DatagramEndpoint local;
+    if (!IsOpen()) {
+        return local;
+    }
+    AddressLength length = static_cast<AddressLength>(local.storage.size());
+    if (::getsockname(ToNative(handle_), AddressOf(local), &length) == 0) {
+        local.length = static_cast<uint32_t>(length);
+    }
+    return local;
+}
+
+bool DatagramSocket::WaitReadable(std::chrono::milliseconds timeout) const {
+    if (!IsOpen()) {
+        return false;
+    }
+    if (rio_) {
+        return rio_->WaitReadable(timeout);
+    }
+#ifdef _WIN32
+    WSAPOLLFD descriptor{ToNative(handle_), POLLRDNORM, 0};
+    return WSAPoll(&descriptor, 1, static_cast<INT>(timeout.count())) > 0;
+#else
+    pollfd descriptor{ToNative(handle_), POLLIN, 0};
+    return ::poll(&descriptor, 1, static_cast<int>(timeout.count())) > 0;
+#endif
+}
+
+size_t DatagramSocket::ReceiveBatch(DatagramReceiveSlot* slots, size_t count) {
+    if (!IsOpen() || count == 0) {
+        return 0;
+    }
+    count = std::min(count, MAX_BATCH_SIZE);
+    if (rio_) {
+        const size_t filled = rio_->Receive(slots, count);
+        receive_calls_.fetch_add(1, std::memory_order_relaxed);
+        datagrams_received_.fetch_add(filled, std::memory_order_relaxed);
+        return filled;
+    }
+
+#ifdef __linux__
+    std::array<mmsghdr, MAX_BATCH_SIZE> messages{};
+    std::array<iovec, MAX_BATCH_SIZE> iovecs{};
+    // Left unset without timestamping, so the common path carries no control data
+    std::array<TimestampControl, MAX_BATCH_SIZE> controls;
+    const bool timestamped = timestamping_ != TimestampingMode::Off;
+    for (size_t i = 0; i < count; ++i) {
+        iovecs[i] = {slots[i].buffer, slots[i].capacity};
+        messages[i].msg_hdr.msg_iov = &iovecs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+        messages[i].msg_hdr.msg_name = slots[i].from.storage.data();
+        messages[i].msg_hdr.msg_namelen = static_cast<socklen_t>(slots[i].from.storage.size());
+        if (timestamped) {
+            messages[i].msg_hdr.msg_control = controls[i].bytes;
+            messages[i].msg_hdr.msg_controllen = sizeof(controls[i].bytes);
+        }
+    }
+    int received;
+    do {
+        received = ::recvmmsg(ToNative(handle_), messages.data(), static_cast<unsigned int>(count),
+                              MSG_DONTWAIT, nullptr);
+    } while (received < 0 && errno == EINTR);
+    receive_calls_.fetch_add(1, std::memory_order_relaxed);
+    if (received <= 0) {
+        return 0;
+    }
+    for (int i = 0; i < received; ++i) {
+        slots[i].size = messages[i].msg_len;
+        slots[i].truncated = (messages[i].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+        slots[i].from.length = messages[i].msg_hdr.msg_namelen;
+        slots[i].timestamps = {};
+        if (timestamped) {
+            ReadTimestamps(messages[i].msg_hdr, slots[i].timestamps);
+        }
+    }
+    const size_t filled = static_cast<size_t>(received);
+#else
+    size_t filled = 0;
+    for (; filled < count; ++filled) {
+        DatagramReceiveSlot& slot = slots[filled];
+        AddressLength length = static_cast<AddressLength>(slot.from.storage.size());
+#ifdef _WIN32
+        const int result =
+            ::recvfrom(ToNative(handle_), reinterpret_cast<char*>(slot.buffer),
+                       static_cast<int>(slot.capacity), 0, AddressOf(slot.from), &length);
+        receive_calls_.fetch_add(1, std::memory_order_relaxed);
+        // Windows fills the buffer and reports the rest as lost
+        slot.truncated = result < 0 && WSAGetLastError() == WSAEMSGSIZE;
+        if (result < 0 && !slot.truncated) {
+            break;
+        }
+        slot.size = slot.truncated ? slot.capacity : static_cast<size_t>(result);
+#else
+        iovec iov{slot.buffer, slot.capacity};
+        msghdr message{};
+        message.msg_name = slot.from.storage.data();
+        message.msg_namelen = length;
+        message.msg_iov = &iov;
+        message.msg_iovlen = 1;
+        const ssize_t result = ::recvmsg(ToNative(handle_), &message, 0);
+        receive_calls_.fetch_add(1, std::memory_order_relaxed);
+        if (result < 0) {
+            break;
+        }
+        length = message.msg_namelen;
+        slot.size = static_cast<size_t>(result);
+        slot.truncated = (message.msg_flags & MSG_TRUNC) != 0;
+#endif
+        slot.from.length = static_cast<uint32_t>(length);
+    }
+#endif
+
+    datagrams_received_.fetch_add(filled, std::memory_order_relaxed);
+    return filled;
+}
+
+size_t DatagramSocket::ReceiveBatch(PacketPool& pool, ReceivedDatagram* out, size_t max_count) {
+    max_count = std::min(max_count, MAX_BATCH_SIZE);
+    std::array<DatagramReceiveSlot, MAX_BATCH_SIZE> slots{};
+    size_t acquired = 0;
+    for (; acquired < max_count; ++acquired) {
+        out[acquired].packet = pool.Acquire();
+        if (!out[acquired].packet) {
+            break;
+        }
+        slots[acquired].buffer = out[acquired].packet.data();
+        slots[acquired].capacity = PacketBuffer::capacity();
+    }
+
+    const size_t filled = ReceiveBatch(slots.data(), acquired);
+    size_t kept = 0;
+    for (size_t i = 0; i < filled; ++i) {
+        if (slots[i].truncated) {
+            truncated_dropped_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        if (kept != i) {
+            out[kept].packet = std::move(out[i].packet);
+        }
+        out[kept].packet.Resize(slots[i].size);
+        out[kept].from = slots[i].from;
+        ++kept;
+    }
+    // Returns the buffers nothing arrived for
+    for (size_t i = kept; i < acquired; ++i) {
+        out[i].packet.Reset();
+    }
+    return kept;
+}
+
+size_t DatagramSocket::SendBatch(const OutgoingDatagram* datagrams, size_t count) {
+    if (!IsOpen()) {
+        return 0;
+    }
+    if (rio_) {
+        size_t posted = 0;
+        uint64_t errors = 0;
+        const size_t taken = rio_->Send(datagrams, count, posted, errors);
+        send_calls_.fetch_add(1, std::memory_order_relaxed);
+        datagrams_sent_.fetch_add(posted, std::memory_order_relaxed);
+        send_errors_.fetch_add(errors, std::memory_order_relaxed);
+        return taken;
+    }
+
+    size_t sent = 0;
+#ifdef __linux__
+    std::array<mmsghdr, MAX_BATCH_SIZE> messages{};
+    std::array<std::array<iovec, 2>, MAX_BATCH_SIZE> iovecs{};
+    while (sent < count) {
+        const size_t batch = std::min(count - sent, MAX_BATCH_SIZE);
+        for (size_t i = 0; i < batch; ++i) {
+            const OutgoingDatagram& datagram = datagrams[sent + i];
+            iovecs[i][0] = {const_cast<uint8_t*>(datagram.data), datagram.size};
+            iovecs[i][1] = {const_cast<uint8_t*>(datagram.tail), datagram.tail_size};
+            messages[i].msg_hdr = {};
+            messages[i].msg_hdr.msg_iov = iovecs[i].data();
+            messages[i].msg_hdr.msg_iovlen = datagram.tail_size != 0 ? 2 : 1;
+            if (datagram.to != nullptr) {
+                messages[i].msg_hdr.msg_name = const_cast<uint8_t*>(datagram.to->storage.data());
+                messages[i].msg_hdr.msg_namelen = datagram.to->length;
+            }
+        }
+        const int result = ::sendmmsg(ToNative(handle_), messages.data(),
+                                      static_cast<unsigned int>(batch), MSG_DONTWAIT);
+        send_calls_.fetch_add(1, std::memory_order_relaxed);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) {
+                break;
+            }
+            // This datagram was refused (bad address, too large); go on without it
+            send_errors_.fetch_add(1, std::memory_order_relaxed);
+            ++sent;
+            continue;
+        }
+        datagrams_sent_.fetch_add(static_cast<uint64_t>(result), std::memory_order_relaxed);
+        sent += static_cast<size_t>(result);
+        if (static_cast<size_t>(result) < batch) {
+            // The next datagram would have blocked or failed; find out which
+            continue;
+        }
+    }
+#else
+    for (; sent < count; ++sent) {
+        const OutgoingDatagram& datagram = datagrams[sent];
+#ifdef _WIN32
+        std::array<WSABUF, 2> buffers{};
+        buffers[0] = {static_cast<ULONG>(datagram.size),
+                      reinterpret_cast<CHAR*>(const_cast<uint8_t*>(datagram.data))};
+        buffers[1] = {static_cast<ULONG>(datagram.tail_size),
+                      reinterpret_cast<CHAR*>(const_cast<uint8_t*>(datagram.tail))};
+        DWORD bytes = 0;
+        const int result = WSASendTo(
+            ToNative(handle_), buffers.data(), datagram.tail_size != 0 ? 2 : 1, &bytes, 0,
+            datagram.to != nullptr ? AddressOf(*datagram.to) : nullptr,
+            datagram.to != nullptr ? static_cast<int>(datagram.to->length) : 0, nullptr, nullptr);
+        send_calls_.fetch_add(1, std::memory_order_relaxed);
+        if (result != 0) {
+            if (WSAGetLastError() == WSAEWOULDBLOCK) {
+                break;
+            }
+            send_errors_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+#else
+        std::array<iovec, 2> iov{};
+        iov[0] = {const_cast<uint8_t*>(datagram.data), datagram.size};
+        iov[1] = {const_cast<uint8_t*>(datagram.tail), datagram.tail_size};
+        msghdr message{};
+        message.msg_iov = iov.data();
+        message.msg_iovlen = datagram.tail_size != 0 ? 2 : 1;
+        if (datagram.to != nullptr) {
+            message.msg_name = const_cast<uint8_t*>(datagram.to->storage.data());
+            message.msg_namelen = datagram.to->length;
+        }
+        const ssize_t result = ::sendmsg(ToNative(handle_), &message, 0);
+        send_calls_.fetch_add(1, std::memory_order_relaxed);
+        if (result < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) {
+                break;
+            }
+            send_errors_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+#endif
+        datagrams_sent_.fetch_add(1, std::memory_order_relaxed);
+    }
+#endif
+    return sent;
+}
+
+ErrorCode DatagramSocket::EnableTimestamping(TimestampingMode mode) {
+    if (!IsOpen()) {
+        return ErrorCode::NotInitialized;
+    }
+#ifdef __linux__
+    unsigned int flags = 0;
+    if (mode != TimestampingMode::Off) {
+        flags = SOF_TIMESTAMPING_SOFTWARE | SOF_TIMESTAMPING_TX_SOFTWARE |
+                SOF_TIMESTAMPING_RX_SOFTWARE |
+                // Number transmit reports, and leave the payload off the error queue
+                SOF_TIMESTAMPING_OPT_ID | SOF_TIMESTAMPING_OPT_TSONLY;
+    }
+    if (mode == TimestampingMode::Hardware) {
+        flags |= SOF_TIMESTAMPING_RAW_HARDWARE | SOF_TIMESTAMPING_TX_HARDWARE |
+                 SOF_TIMESTAMPING_RX_HARDWARE;
+    }
+    if (setsockopt(ToNative(handle_), SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) != 0) {
+        return ErrorCode::PlatformFeatureUnavailable;
+    }
+    timestamping_ = mode;
+    return ErrorCode::Success;
+#else
+    return mode == TimestampingMode::Off ? ErrorCode::Success
+                                         : ErrorCode::PlatformFeatureUnavailable;
+#endif
+}
+
+size_t DatagramSocket::ReadTransmitTimestamps(TransmitTimestamp* out, size_t max_count) {
+    if (!IsOpen() || timestamping_ == TimestampingMode::Off) {
+        return 0;
+    }
+#ifdef __linux__
+    size_t read = 0;
+    while (read < max_count) {
+        TimestampControl control;
+        msghdr message{};
+        message.msg_control = control.bytes;
+        message.msg_controllen = sizeof(control.bytes);
+        if (::recvmsg(ToNative(handle_), &message, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+            break;
+        }
+
+        std::optional<uint32_t> id;
+        for (cmsghdr* header = CMSG_FIRSTHDR(&message); header != nullptr;
+             header = CMSG_NXTHDR(&message, header)) {
+            const bool extended_error =
+                (header->cmsg_level == IPPROTO_IP && header->cmsg_type == IP_RECVERR) ||
+                (header->cmsg_level == IPPROTO_IPV6 && header->cmsg_type == IPV6_RECVERR);
+            if (!extended_error) {
+                continue;
+            }
+            sock_extended_err error;
+            std::memcpy(&error, CMSG_DATA(header), sizeof(error));
+            if (error.ee_errno == ENOMSG && error.ee_origin == SO_EE_ORIGIN_TIMESTAMPING) {
+                id = error.ee_data;
+            }
+        }
+        if (!id) {
+            continue; // An ICMP error rather than a timestamp
+        }
+
+        // Software and hardware reports of one datagram arrive separately
+        auto* entry = std::find_if(out, out + read, [&id](const TransmitTimestamp& timestamp) {
+            return timestamp.id == *id;
+        });
+        if (entry == out + read) {
+            *entry = TransmitTimestamp{*id, {}};
+            ++read;
+        }
+        ReadTimestamps(message, entry->timestamps);
+    }
+    return read;
+#else
+    (void)out;
+    (void)max_count;
+    return 0;
+#endif
+}
+
+DatagramSocketStatistics DatagramSocket::GetStatistics() const {
+    DatagramSocketStatistics statistics;
+    statistics.receive_calls = receive_calls_.load(std::memory_order_relaxed);
+    statistics.send_calls = send_calls_.load(std::memory_order_relaxed);
+    statistics.datagrams_received = datagrams_received_.load(std::memory_order_relaxed);
+    statistics.datagrams_sent = datagrams_sent_.load(std::memory_order_relaxed);
+    statistics.truncated_dropped = truncated_dropped_.load(std::memory_order_relaxed);
+    statistics.send_errors = send_errors_.load(std::memory_order_relaxed);
+    return statistics;
+}
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,253 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "error_codes.h"
+#include "packet_buffer.h"
+#include "socket_tuning.h"
+
+namespace Core::Multiplayer {
+
+class RegisteredIoQueue;
+
+/**
+ * IPv4 or IPv6 UDP address, stored as a native socket address so batches of
+ * them can be handed to the kernel without conversion
+ */
+struct DatagramEndpoint {
+    static constexpr size_t STORAGE_SIZE = 28; // sizeof(sockaddr_in6)
+
+    alignas(8) std::array<uint8_t, STORAGE_SIZE> storage{};
+    uint32_t length = 0; // 0 for an unset endpoint
+
+    /**
+     * Resolves a numeric address; host names are not looked up
+     * @return False if host is not an IPv4 or IPv6 address
+     */
+    static bool FromString(const std::string& host, uint16_t port, DatagramEndpoint& out);
+
+    bool IsValid() const { return length != 0; }
+    bool IsIPv6() const;
+    uint16_t Port() const;
+    void SetPort(uint16_t port);
+    std::string ToString() const;
+
+    bool operator==(const DatagramEndpoint& other) const;
+    bool operator!=(const DatagramEndpoint& other) const { return !(*this == other); }
+};
+
+/**
+ * Which kernel timestamps a socket reports (Linux SO_TIMESTAMPING)
+ */
+enum class TimestampingMode : uint8_t {
+    Off,
+    Software, // Taken by the kernel as a datagram crosses the driver
+    Hardware, // Software, plus the NIC's where it supports them
+};
+
+/**
+ * Kernel timestamps of one datagram in CLOCK_REALTIME nanoseconds, the
+ * clock std::chrono::system_clock reads on Linux; zero when not taken
+ */
+struct DatagramTimestamps {
+    int64_t software_ns = 0;
+    int64_t hardware_ns = 0;
+};
+
+/**
+ * When a sent datagram left, read back from the socket's error queue
+ */
+struct TransmitTimestamp {
+    uint32_t id = 0; // Datagrams sent before this one since timestamping was enabled
+    DatagramTimestamps timestamps;
+};
+
+/**
+ * Describes one datagram to receive into caller-owned memory
+ */
+struct DatagramReceiveSlot {
+    uint8_t* buffer = nullptr;
+    size_t capacity = 0;
+    size_t size = 0;        // Filled in: bytes received
+    bool truncated = false; // Filled in: the datagram was larger than capacity
+    DatagramEndpoint from;  // Filled in: sender
+    DatagramTimestamps timestamps; // Filled in while timestamping is enabled
+};
+
+/**
+ * One datagram to send, optionally gathered from a header and a body so a
+ * framed packet needs no copy. A null destination sends to the connected peer.
+ */
+struct OutgoingDatagram {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    const uint8_t* tail = nullptr;
+    size_t tail_size = 0;
+    const DatagramEndpoint* to = nullptr;
+};
+
+/**
+ * Datagram received into a pooled buffer
+ */
+struct ReceivedDatagram {
+    PacketBuffer packet;
+    DatagramEndpoint from;
+};
+
+struct DatagramSocketOptions {
+    bool reuse_address = false;
+    bool reuse_port = false; // SO_REUSEPORT; Open fails where it is unsupported
+    size_t receive_buffer_size = 0; // 0 keeps the system default
+    size_t send_buffer_size = 0;
+    // Windows Registered I/O (see registered_io.h); Open fails with
+    // PlatformFeatureUnavailable where it is missing
+    bool registered_io = false;
+};
+
+struct DatagramSocketStatistics {
+    uint64_t receive_calls = 0;
+    uint64_t send_calls = 0;
+    uint64_t datagrams_received = 0;
+    uint64_t datagrams_sent = 0;
+    uint64_t truncated_dropped = 0;
+    uint64_t send_errors = 0;
+};
+
+/**
+ * Non-blocking UDP socket that moves datagrams in batches.
+ *
+ * On Linux a batch costs one recvmmsg or sendmmsg system call however many
+ * datagrams it holds; at a 60Hz tick with several peers that removes most
+ * of the per-packet syscall overhead. Elsewhere the same interface loops
+ * over recvfrom and sendmsg/WSASendTo, so callers need no platform code.
+ *
+ * Receives can land straight in PacketPool buffers, so a datagram goes from
+ * the kernel into the buffer the data path hands on without another copy.
+ *
+ * Not thread-safe; one thread receives and one sends, or a single thread
+ * does both.
+ */
+class DatagramSocket {
+public:
+    static constexpr size_t MAX_BATCH_SIZE = 64;
+    static constexpr intptr_t INVALID_HANDLE = -1;
+
+    DatagramSocket();
+    ~DatagramSocket();
+
+    DatagramSocket(const DatagramSocket&) = delete;
+    DatagramSocket& operator=(const DatagramSocket&) = delete;
+
+    /**
+     * Creates the socket and binds it; port 0 binds an ephemeral port
+     * @param bind_address Numeric local address, e.g. "0.0.0.0" or "::"
+     */
+    ErrorCode Open(const std::string& bind_address, uint16_t port,
+                   const DatagramSocketOptions& options = DatagramSocketOptions{});
+
+    /**
+     * Takes ownership of a datagram socket created and bound elsewhere, such
+     * as one Android's Java side hands over, and makes it non-blocking
+     * @return InvalidParameter if handle is not a datagram socket, which is
+     *         then left open and still the caller's
+     */
+    ErrorCode Adopt(intptr_t handle);
+
+    /**
+     * Fixes the peer for sends without a destination and filters receives
+     * to it
+     */
+    ErrorCode Connect(const DatagramEndpoint& peer);
+
+    /**
+     * Joins an IPv4 multicast group and sends group datagrams out of the same
+     * interface, without looping them back to this host
+     * @param interface_address Numeric local IPv4 address of the interface;
+     *                          empty lets the system choose
+     */
+    ErrorCode JoinMulticastGroup(const std::string& group_address,
+                                 const std::string& interface_address = {});
+    // Allows sends to broadcast addresses such as 255.255.255.255
+    ErrorCode EnableBroadcast();
+
+    // Applies buffer sizes, DSCP marking and busy poll to the open socket
+    SocketTuningResult Tune(const SocketTuningProfile& profile);
+
+    /**
+     * Has the kernel timestamp datagrams where they cross the driver, so a
+     * latency measurement can tell stack time from network time. Receive
+     * timestamps fill DatagramReceiveSlot::timestamps; transmit ones queue up
+     * for ReadTransmitTimestamps, and should be drained since they also wake
+     * poll. Hardware timestamps only arrive once the interface has been set
+     * up for them (SIOCSHWTSTAMP, e.g. with hwstamp_ctl).
+     * @return PlatformFeatureUnavailable where SO_TIMESTAMPING is missing
+     */
+    ErrorCode EnableTimestamping(TimestampingMode mode);
+    TimestampingMode GetTimestampingMode() const { return timestamping_; }
+
+    /**
+     * Reads queued transmit timestamps without waiting
+     * @return Number written to out
+     */
+    size_t ReadTransmitTimestamps(TransmitTimestamp* out, size_t max_count);
+
+    void Close();
+    bool IsOpen() const { return handle_ != INVALID_HANDLE; }
+
+    // Native descriptor for registering with poll, epoll or kqueue. A
+    // registered I/O socket is only readable through WaitReadable.
+    intptr_t GetNativeHandle() const { return handle_; }
+    bool IsRegisteredIo() const { return rio_ != nullptr; }
+    DatagramEndpoint GetLocalEndpoint() const;
+
+    /**
+     * Waits until a datagram can be received
+     * @return False on timeout or error
+     */
+    bool WaitReadable(std::chrono::milliseconds timeout) const;
+
+    /**
+     * Receives up to count datagrams that are already queued, without waiting
+     * @return Number of slots filled, including truncated datagrams
+     */
+    size_t ReceiveBatch(DatagramReceiveSlot* slots, size_t count);
+
+    /**
+     * Receives up to max_count queued datagrams into buffers from pool,
+     * dropping truncated ones
+     * @return Number of datagrams written to out
+     */
+    size_t ReceiveBatch(PacketPool& pool, ReceivedDatagram* out, size_t max_count);
+
+    /**
+     * Sends datagrams in order, stopping early if the socket buffer fills
+     * @return Number of datagrams handed to the kernel; a datagram the kernel
+     *         rejects outright is skipped and counted as a send error
+     */
+    size_t SendBatch(const OutgoingDatagram* datagrams, size_t count);
+
+    DatagramSocketStatistics GetStatistics() const;
+
+private:
+    intptr_t handle_ = INVALID_HANDLE;
+    std::unique_ptr<RegisteredIoQueue> rio_;
+    TimestampingMode timestamping_ = TimestampingMode::Off;
+
+    std::atomic<uint64_t> receive_calls_{0};
+    std::atomic<uint64_t> send_calls_{0};
+    std::atomic<uint64_t> datagrams_received_{0};
+    std::atomic<uint64_t> datagrams_sent_{0};
+    std::atomic<uint64_t> truncated_dropped_{0};
+    std::atomic<uint64_t> send_errors_{0};
+};
+
+} // namespace Core::Multiplayer
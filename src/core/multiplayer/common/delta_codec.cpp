@@ -0,0 +1,279 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "delta_codec.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Core::Multiplayer {
+
+namespace {
+void WriteU16(uint8_t* out, size_t value) {
+    out[0] = static_cast<uint8_t>(value & 0xFF);
+    out[1] = static_cast<uint8_t>((value >> 8) & 0xFF);
+}
+
+uint16_t ReadU16(const uint8_t* data) {
+    return static_cast<uint16_t>(data[0] | (data[1] << 8));
+}
+
+// Whether frame id a was sent after b, allowing for wraparound
+bool IsNewer(uint16_t a, uint16_t b) {
+    return static_cast<int16_t>(a - b) > 0;
+}
+} // namespace
+
+DeltaEncoder::DeltaEncoder(const DeltaCodecConfig& config) : config_(config) {}
+
+size_t DeltaEncoder::Encode(const uint8_t* data, size_t size, uint8_t* out) {
+    if (size > PACKET_BUFFER_SIZE) {
+        return 0;
+    }
+
+    size_t written = 0;
+    const bool keyframe_due =
+        !reference_.valid || packets_since_keyframe_ + 1 >= config_.keyframe_interval;
+    if (!keyframe_due) {
+        written = WriteDelta(data, size, out);
+    }
+    if (written != 0) {
+        ++packets_since_keyframe_;
+        ++statistics_.deltas_sent;
+    } else {
+        written = WriteKeyframe(data, size, out);
+    }
+
+    auto& sent = history_[history_next_];
+    history_next_ = (history_next_ + 1) % HISTORY_SIZE;
+    sent.valid = true;
+    sent.frame_id = next_frame_id_++;
+    sent.size = size;
+    std::memcpy(sent.bytes.data(), data, size);
+
+    statistics_.bytes_before_encoding += size;
+    statistics_.bytes_after_encoding += written;
+    return written;
+}
+
+size_t DeltaEncoder::WriteKeyframe(const uint8_t* data, size_t size, uint8_t* out) {
+    out[0] = KIND_KEYFRAME;
+    WriteU16(out + 1, next_frame_id_);
+    std::memcpy(out + KEYFRAME_HEADER_SIZE, data, size);
+
+    // Assumed delivered; if it is not, the next keyframe heals the stream
+    reference_.valid = true;
+    reference_.frame_id = next_frame_id_;
+    reference_.size = size;
+    std::memcpy(reference_.bytes.data(), data, size);
+    packets_since_keyframe_ = 0;
+    ++statistics_.keyframes_sent;
+    return KEYFRAME_HEADER_SIZE + size;
+}
+
+size_t DeltaEncoder::WriteDelta(const uint8_t* data, size_t size, uint8_t* out) const {
+    const auto reference_at = [this](size_t i) -> uint8_t {
+        return i < reference_.size ? reference_.bytes[i] : 0;
+    };
+    const size_t keyframe_size = KEYFRAME_HEADER_SIZE + size;
+
+    out[0] = KIND_DELTA;
+    WriteU16(out + 1, next_frame_id_);
+    WriteU16(out + 3, reference_.frame_id);
+    WriteU16(out + 5, size);
+    size_t written = DELTA_HEADER_SIZE;
+
+    size_t i = 0;
+    while (i < size) {
+        if (data[i] == reference_at(i)) {
+            ++i;
+            continue;
+        }
+        // Gaps shorter than a run header are cheaper to resend than to skip
+        const size_t start = i;
+        size_t end = i + 1;
+        for (size_t j = end; j < size && j - end < RUN_HEADER_SIZE; ++j) {
+            if (data[j] != reference_at(j)) {
+                end = j + 1;
+            }
+        }
+
+        const size_t length = end - start;
+        if (written + RUN_HEADER_SIZE + length >= keyframe_size) {
+            return 0;
+        }
+        WriteU16(out + written, start);
+        WriteU16(out + written + 2, length);
+        std::memcpy(out + written + RUN_HEADER_SIZE, data + start, length);
+        written += RUN_HEADER_SIZE + length;
+        i = end;
+    }
+    return written < keyframe_size ? written : 0;
+}
+
+void DeltaEncoder::Acknowledge(uint16_t frame_id) {
+    if (reference_.valid && !IsNewer(frame_id, reference_.frame_id)) {
+        return;
+    }
+    const auto it = std::find_if(history_.begin(), history_.end(), [frame_id](const auto& sent) {
+        return sent.valid && sent.frame_id == frame_id;
+    });
+    if (it != history_.end()) {
+        reference_ = *it;
+    }
+}
+
+void DeltaEncoder::Reset() {
+    reference_.valid = false;
+    for (auto& sent : history_) {
+        sent.valid = false;
+    }
+    packets_since_keyframe_ = 0;
+}
+
+bool DeltaDecoder::Decode(const uint8_t* data, size_t size, uint8_t* out, size_t& out_size,
+                          uint16_t& out_frame_id) {
+    if (size < DeltaEncoder::KEYFRAME_HEADER_SIZE) {
+        ++statistics_.malformed_packets;
+        return false;
+    }
+    const uint16_t frame_id = ReadU16(data + 1);
+
+    if (data[0] == DeltaEncoder::KIND_KEYFRAME) {
+        const size_t length = size - DeltaEncoder::KEYFRAME_HEADER_SIZE;
+        if (length > PACKET_BUFFER_SIZE) {
+            ++statistics_.malformed_packets;
+            return false;
+        }
+        std::memcpy(out, data + DeltaEncoder::KEYFRAME_HEADER_SIZE, length);
+        out_size = length;
+        reference_.valid = true;
+        reference_.frame_id = frame_id;
+        reference_.size = length;
+        std::memcpy(reference_.bytes.data(), out, length);
+    } else if (data[0] == DeltaEncoder::KIND_DELTA && size >= DeltaEncoder::DELTA_HEADER_SIZE) {
+        const size_t length = ReadU16(data + 5);
+        if (length > PACKET_BUFFER_SIZE) {
+            ++statistics_.malformed_packets;
+            return false;
+        }
+        const ReceivedFrame* reference = FindFrame(ReadU16(data + 3));
+        if (reference == nullptr) {
+            ++statistics_.missing_references;
+            return false;
+        }
+
+        const size_t copied = std::min(length, reference->size);
+        std::memcpy(out, reference->bytes.data(), copied);
+        std::memset(out + copied, 0, length - copied);
+
+        size_t offset = DeltaEncoder::DELTA_HEADER_SIZE;
+        while (offset < size) {
+            if (size - offset < DeltaEncoder::RUN_HEADER_SIZE) {
+                ++statistics_.malformed_packets;
+                return false;
+            }
+            const size_t start = ReadU16(data + offset);
+            const size_t run = ReadU16(data + offset + 2);
+            offset += DeltaEncoder::RUN_HEADER_SIZE;
+            if (start + run > length || size - offset < run) {
+                ++statistics_.malformed_packets;
+                return false;
+            }
+            std::memcpy(out + start, data + offset, run);
+            offset += run;
+        }
+        out_size = length;
+        // The encoder moved to an acknowledged packet; keep it before the history wraps
+        if (reference != &reference_) {
+            reference_ = *reference;
+        }
+    } else {
+        ++statistics_.malformed_packets;
+        return false;
+    }
+
+    Remember(frame_id, out, out_size);
+    out_frame_id = frame_id;
+    ++statistics_.packets_decoded;
+    return true;
+}
+
+void DeltaDecoder::Reset() {
+    reference_.valid = false;
+    for (auto& frame : history_) {
+        frame.valid = false;
+    }
+}
+
+const DeltaDecoder::ReceivedFrame* DeltaDecoder::FindFrame(uint16_t frame_id) const {
+    if (reference_.valid && reference_.frame_id == frame_id) {
+        return &reference_;
+    }
+    const auto it = std::find_if(history_.begin(), history_.end(), [frame_id](const auto& frame) {
+        return frame.valid && frame.frame_id == frame_id;
+    });
+    return it != history_.end() ? &*it : nullptr;
+}
+
+void DeltaDecoder::Remember(uint16_t frame_id, const uint8_t* data, size_t size) {
+    auto& frame = history_[history_next_];
+    history_next_ = (history_next_ + 1) % HISTORY_SIZE;
+    frame.valid = true;
+    frame.frame_id = frame_id;
+    frame.size = size;
+    std::memcpy(frame.bytes.data(), data, size);
+}
+
+DeltaCodec::DeltaCodec(const DeltaCodecConfig& config) : config_(config) {}
+
+size_t DeltaCodec::Encode(const DeltaStreamKey& key, const uint8_t* data, size_t size,
+                          uint8_t* out) {
+    return encoders_.try_emplace(key, config_).first->second.Encode(data, size, out);
+}
+
+bool DeltaCodec::Decode(const DeltaStreamKey& key, const uint8_t* data, size_t size,
+                        uint8_t* out, size_t& out_size, uint16_t& out_frame_id) {
+    return decoders_[key].Decode(data, size, out, out_size, out_frame_id);
+}
+
+void DeltaCodec::Acknowledge(const DeltaStreamKey& key, uint16_t frame_id) {
+    const auto it = encoders_.find(key);
+    if (it != encoders_.end()) {
+        it->second.Acknowledge(frame_id);
+    }
+}
+
+void DeltaCodec::ResetNode(uint8_t node_id) {
+    for (auto it = encoders_.begin(); it != encoders_.end();) {
+        it = it->first.node_id == node_id ? encoders_.erase(it) : std::next(it);
+    }
+    for (auto it = decoders_.begin(); it != decoders_.end();) {
+        it = it->first.node_id == node_id ? decoders_.erase(it) : std::next(it);
+    }
+}
+
+void DeltaCodec::Clear() {
+    encoders_.clear();
+    decoders_.clear();
+}
+
+DeltaCodecStatistics DeltaCodec::GetStatistics() const {
+    DeltaCodecStatistics total;
+    for (const auto& [key, encoder] : encoders_) {
+        const auto& statistics = encoder.GetStatistics();
+        total.keyframes_sent += statistics.keyframes_sent;
+        total.deltas_sent += statistics.deltas_sent;
+        total.bytes_before_encoding += statistics.bytes_before_encoding;
+        total.bytes_after_encoding += statistics.bytes_after_encoding;
+    }
+    for (const auto& [key, decoder] : decoders_) {
+        const auto& statistics = decoder.GetStatistics();
+        total.packets_decoded += statistics.packets_decoded;
+        total.missing_references += statistics.missing_references;
+        total.malformed_packets += statistics.malformed_packets;
+    }
+    return total;
+}
+
+} // namespace Core::Multiplayer
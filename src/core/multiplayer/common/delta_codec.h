@@ -0,0 +1,199 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+#include "packet_buffer.h"
+
+namespace Core::Multiplayer {
+
+/**
+ * Delta codec configuration
+ */
+struct DeltaCodecConfig {
+    // Every Nth packet of a stream is sent whole so a lost reference heals
+    uint32_t keyframe_interval = 30;
+};
+
+/**
+ * Delta codec statistics, summed over all streams
+ */
+struct DeltaCodecStatistics {
+    uint64_t keyframes_sent = 0;
+    uint64_t deltas_sent = 0;
+    uint64_t bytes_before_encoding = 0;
+    uint64_t bytes_after_encoding = 0;
+    uint64_t packets_decoded = 0;
+    uint64_t missing_references = 0; // Deltas against a packet that never arrived
+    uint64_t malformed_packets = 0;
+};
+
+/**
+ * Encodes one stream of packets as the byte ranges that changed since a
+ * reference packet the receiver holds.
+ *
+ * The reference is the latest keyframe, or a later packet once the receiver
+ * acknowledges it. Deltas never reference each other, so losing one costs
+ * only that packet; losing a keyframe costs the deltas sent against it until
+ * an acknowledgement or the next keyframe.
+ *
+ * Wire format, little-endian:
+ *   keyframe: kind (1), frame id (2), packet bytes
+ *   delta:    kind (1), frame id (2), reference id (2), packet size (2),
+ *             then runs of offset (2), length (2), new bytes
+ * Bytes past the end of the reference compare as zero.
+ */
+class DeltaEncoder {
+public:
+    static constexpr uint8_t KIND_KEYFRAME = 0x01;
+    static constexpr uint8_t KIND_DELTA = 0x02;
+    static constexpr size_t KEYFRAME_HEADER_SIZE = 3;
+    static constexpr size_t DELTA_HEADER_SIZE = 7;
+    static constexpr size_t RUN_HEADER_SIZE = 4;
+    static constexpr size_t MAX_ENCODED_SIZE = KEYFRAME_HEADER_SIZE + PACKET_BUFFER_SIZE;
+    static constexpr size_t HISTORY_SIZE = 4;
+
+    explicit DeltaEncoder(const DeltaCodecConfig& config = DeltaCodecConfig{});
+
+    /**
+     * Encodes a packet of at most PACKET_BUFFER_SIZE bytes; out must hold
+     * MAX_ENCODED_SIZE bytes
+     * @return Bytes written, or 0 if the packet is too large
+     */
+    size_t Encode(const uint8_t* data, size_t size, uint8_t* out);
+
+    /**
+     * The receiver holds frame_id, so later deltas may use it as their
+     * reference. Unknown or older ids are ignored.
+     */
+    void Acknowledge(uint16_t frame_id);
+
+    // Sends a keyframe next
+    void Reset();
+
+    const DeltaCodecStatistics& GetStatistics() const { return statistics_; }
+
+private:
+    struct SentPacket {
+        bool valid = false;
+        uint16_t frame_id = 0;
+        size_t size = 0;
+        std::array<uint8_t, PACKET_BUFFER_SIZE> bytes{};
+    };
+
+    size_t WriteKeyframe(const uint8_t* data, size_t size, uint8_t* out);
+    // Returns 0 if the delta would not be smaller than a keyframe
+    size_t WriteDelta(const uint8_t* data, size_t size, uint8_t* out) const;
+
+    DeltaCodecConfig config_;
+    uint16_t next_frame_id_ = 0;
+    uint32_t packets_since_keyframe_ = 0;
+    // Recently sent packets, for acknowledgements to promote
+    std::array<SentPacket, HISTORY_SIZE> history_{};
+    size_t history_next_ = 0;
+    SentPacket reference_;
+    DeltaCodecStatistics statistics_;
+};
+
+/**
+ * Rebuilds packets produced by a DeltaEncoder
+ */
+class DeltaDecoder {
+public:
+    static constexpr size_t HISTORY_SIZE = 8;
+
+    /**
+     * Decodes one encoded packet into out, which holds PACKET_BUFFER_SIZE bytes
+     * @param out_frame_id Receives the frame id, for acknowledgements
+     * @return False if it is malformed or its reference is missing
+     */
+    bool Decode(const uint8_t* data, size_t size, uint8_t* out, size_t& out_size,
+                uint16_t& out_frame_id);
+
+    void Reset();
+
+    const DeltaCodecStatistics& GetStatistics() const { return statistics_; }
+
+private:
+    struct ReceivedFrame {
+        bool valid = false;
+        uint16_t frame_id = 0;
+        size_t size = 0;
+        std::array<uint8_t, PACKET_BUFFER_SIZE> bytes{};
+    };
+
+    const ReceivedFrame* FindFrame(uint16_t frame_id) const;
+    void Remember(uint16_t frame_id, const uint8_t* data, size_t size);
+
+    // Recently decoded packets, any of which an acknowledgement may promote
+    std::array<ReceivedFrame, HISTORY_SIZE> history_{};
+    size_t history_next_ = 0;
+    // The latest keyframe or promoted packet, kept for as long as deltas use it
+    ReceivedFrame reference_;
+    DeltaCodecStatistics statistics_;
+};
+
+/**
+ * Stream a packet belongs to: the LDN node it is sent to or came from, and
+ * the protocol it carries. LDN game data is protocol 0.
+ */
+struct DeltaStreamKey {
+    uint8_t node_id = 0;
+    uint8_t protocol = 0;
+
+    bool operator==(const DeltaStreamKey& other) const {
+        return node_id == other.node_id && protocol == other.protocol;
+    }
+};
+
+struct DeltaStreamKeyHash {
+    size_t operator()(const DeltaStreamKey& key) const {
+        return std::hash<uint16_t>{}(static_cast<uint16_t>(key.node_id << 8 | key.protocol));
+    }
+};
+
+/**
+ * Opt-in delta coding between a backend and its transports, with one
+ * encoder and one decoder per stream created on first use.
+ *
+ * Not thread-safe, but the encoding and decoding sides share no state, so
+ * the send path and the network thread may each use their side.
+ */
+class DeltaCodec {
+public:
+    static constexpr size_t MAX_ENCODED_SIZE = DeltaEncoder::MAX_ENCODED_SIZE;
+
+    explicit DeltaCodec(const DeltaCodecConfig& config = DeltaCodecConfig{});
+
+    // See DeltaEncoder::Encode
+    size_t Encode(const DeltaStreamKey& key, const uint8_t* data, size_t size, uint8_t* out);
+    // See DeltaDecoder::Decode
+    bool Decode(const DeltaStreamKey& key, const uint8_t* data, size_t size, uint8_t* out,
+                size_t& out_size, uint16_t& out_frame_id);
+    bool Decode(const DeltaStreamKey& key, const uint8_t* data, size_t size, uint8_t* out,
+                size_t& out_size) {
+        uint16_t frame_id = 0;
+        return Decode(key, data, size, out, out_size, frame_id);
+    }
+    void Acknowledge(const DeltaStreamKey& key, uint16_t frame_id);
+
+    // Forgets a node's streams in both directions, e.g. when it leaves
+    void ResetNode(uint8_t node_id);
+    void Clear();
+
+    const DeltaCodecConfig& GetConfig() const { return config_; }
+    DeltaCodecStatistics GetStatistics() const;
+
+private:
+    DeltaCodecConfig config_;
+    std::unordered_map<DeltaStreamKey, DeltaEncoder, DeltaStreamKeyHash> encoders_;
+    std::unordered_map<DeltaStreamKey, DeltaDecoder, DeltaStreamKeyHash> decoders_;
+};
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,34 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "discovery_filter.h"
+
+#include <charconv>
+
+namespace Core::Multiplayer {
+
+std::optional<uint64_t> ParseTitleId(std::string_view text) {
+    if (text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+        text.remove_prefix(2);
+    }
+    if (text.empty()) {
+        return std::nullopt;
+    }
+    uint64_t title_id = 0;
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), title_id, 16);
+    if (error != std::errc{} || end != text.data() + text.size()) {
+        return std::nullopt;
+    }
+    return title_id;
+}
+
+std::string FormatTitleId(uint64_t title_id) {
+    static constexpr char DIGITS[] = "0123456789abcdef";
+    std::string text(16, '0');
+    for (size_t i = 16; i-- > 0; title_id >>= 4) {
+        text[i] = DIGITS[title_id & 0xF];
+    }
+    return text;
+}
+
+} // namespace Core::Multiplayer
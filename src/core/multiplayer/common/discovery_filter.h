@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace Core::Multiplayer {
+
+/**
+ * Backend-neutral form of an LDN ScanFilter, handed to a backend before it
+ * scans so it can drop sessions at the source: Model B in the mDNS query
+ * and before parsing an announcement, Model A in the room server query.
+ * Unset fields match everything.
+ */
+struct DiscoveryFilter {
+    // The title's id, announced as game_id by both backends
+    std::optional<uint64_t> local_communication_id;
+    std::optional<uint16_t> scene_id;
+    // LDN SSID, the network name
+    std::optional<std::string> network_name;
+    std::optional<std::array<uint8_t, 6>> host_mac;
+
+    bool IsEmpty() const {
+        return !local_communication_id && !scene_id && !network_name && !host_mac;
+    }
+
+    bool MatchesTitle(uint64_t game_id) const {
+        return !local_communication_id || *local_communication_id == game_id;
+    }
+
+    bool operator==(const DiscoveryFilter&) const = default;
+};
+
+/**
+ * Title id as announced in TXT records: hex digits, optionally 0x-prefixed,
+ * in either case
+ * @return Nothing if text is not a 64-bit hex number
+ */
+std::optional<uint64_t> ParseTitleId(std::string_view text);
+
+// Sixteen lower-case hex digits
+std::string FormatTitleId(uint64_t title_id);
+
+} // namespace Core::Multiplayer
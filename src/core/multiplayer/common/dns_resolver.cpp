@@ -0,0 +1,344 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "dns_resolver.h"
+#include "thread_policy.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <netdb.h>
+#include <sys/socket.h>
+#endif
+
+namespace Core::Multiplayer {
+
+namespace {
+
+constexpr uint8_t FamilyBit(DnsResolver::Family family) {
+    return family == DnsResolver::Family::IPv6 ? 0b10 : 0b01;
+}
+
+DnsResolver::Addresses WithPort(DnsResolver::Addresses addresses, uint16_t port) {
+    for (auto& address : addresses) {
+        address.SetPort(port);
+    }
+    return addresses;
+}
+
+} // namespace
+
+DnsResolver::DnsResolver(const DnsResolverConfig& config, LookupFunction lookup,
+                         std::shared_ptr<TimerWheel> timer_wheel)
+    : config_(config), lookup_(lookup ? std::move(lookup) : LookupFunction(DefaultLookup)),
+      timer_wheel_(timer_wheel ? std::move(timer_wheel) : TimerWheel::GetShared()) {
+    const size_t worker_count = std::max<size_t>(config_.worker_count, 1);
+    workers_.reserve(worker_count);
+    for (size_t i = 0; i < worker_count; ++i) {
+        workers_.push_back(SpawnThread(ThreadRole::Background, "mp-dns", [this]() { WorkerLoop(); }));
+    }
+}
+
+DnsResolver::~DnsResolver() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_requested_ = true;
+        queue_.clear();
+    }
+    queue_cv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+
+    std::vector<TimerWheel::TimerId> timers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& [host, entry] : entries_) {
+            timers.push_back(std::exchange(entry.resolution_timer, TimerWheel::INVALID_TIMER_ID));
+        }
+    }
+    for (const auto id : timers) {
+        timer_wheel_->Cancel(id);
+    }
+}
+
+std::shared_ptr<DnsResolver> DnsResolver::GetShared() {
+    static std::shared_ptr<DnsResolver> shared = std::make_shared<DnsResolver>();
+    return shared;
+}
+
+void DnsResolver::ResolveAsync(const std::string& host, uint16_t port, Callback callback) {
+    DatagramEndpoint numeric;
+    if (DatagramEndpoint::FromString(host, port, numeric)) {
+        if (callback) {
+            callback(Addresses{numeric});
+        }
+        return;
+    }
+    Request(host, port, std::move(callback));
+}
+
+DnsResolver::Addresses DnsResolver::Resolve(const std::string& host, uint16_t port,
+                                            std::chrono::milliseconds timeout) {
+    struct Result {
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool done = false;
+        Addresses addresses;
+    };
+    // Shared, so a late answer after the timeout has somewhere to go
+    auto result = std::make_shared<Result>();
+    ResolveAsync(host, port, [result](const Addresses& addresses) {
+        {
+            std::lock_guard<std::mutex> lock(result->mutex);
+            result->addresses = addresses;
+            result->done = true;
+        }
+        result->cv.notify_all();
+    });
+
+    std::unique_lock<std::mutex> lock(result->mutex);
+    result->cv.wait_for(lock, timeout, [&result]() { return result->done; });
+    return std::move(result->addresses);
+}
+
+void DnsResolver::Prefetch(const std::string& host) {
+    DatagramEndpoint numeric;
+    if (host.empty() || DatagramEndpoint::FromString(host, 0, numeric)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++statistics_.prefetches;
+    }
+    Request(host, 0, nullptr);
+}
+
+void DnsResolver::Prefetch(std::span<const std::string> hosts) {
+    for (const auto& host : hosts) {
+        Prefetch(host);
+    }
+}
+
+void DnsResolver::Invalidate(const std::string& host) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = entries_.find(host);
+    if (it != entries_.end()) {
+        it->second.answered = false;
+        it->second.addresses.clear();
+    }
+}
+
+size_t DnsResolver::GetCachedCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<size_t>(std::count_if(entries_.begin(), entries_.end(), [](const auto& pair) {
+        return pair.second.answered;
+    }));
+}
+
+DnsResolverStatistics DnsResolver::GetStatistics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return statistics_;
+}
+
+void DnsResolver::Request(const std::string& host, uint16_t port, Callback callback) {
+    Addresses answer;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Entry& entry = GetEntryLocked(host);
+        const bool fresh = entry.answered && timer_wheel_->GetClock()->Now() < entry.expires_at;
+        if (fresh) {
+            ++statistics_.cache_hits;
+            answer = entry.addresses;
+        } else if (entry.answered && config_.serve_stale && !entry.addresses.empty()) {
+            ++statistics_.stale_hits;
+            answer = entry.addresses;
+            if (entry.pending == 0) {
+                StartLookupLocked(host, entry);
+            }
+        } else if (entry.pending != 0 && !entry.lookup_ipv6.empty()) {
+            // Joins a lookup whose IPv6 answer has already gone out
+            ++statistics_.coalesced;
+            answer = entry.lookup_ipv6;
+        } else {
+            if (entry.pending == 0) {
+                StartLookupLocked(host, entry);
+            } else {
+                ++statistics_.coalesced;
+            }
+            if (callback) {
+                entry.waiters.push_back({port, std::move(callback)});
+            }
+            return;
+        }
+    }
+    if (callback) {
+        callback(WithPort(std::move(answer), port));
+    }
+}
+
+DnsResolver::Entry& DnsResolver::GetEntryLocked(const std::string& host) {
+    const auto it = entries_.find(host);
+    if (it != entries_.end()) {
+        return it->second;
+    }
+
+    if (entries_.size() >= std::max<size_t>(config_.max_entries, 1)) {
+        // Evict the idle entry closest to expiry; entries with lookups in flight stay
+        auto victim = entries_.end();
+        for (auto candidate = entries_.begin(); candidate != entries_.end(); ++candidate) {
+            if (candidate->second.pending == 0 &&
+                (victim == entries_.end() ||
+                 candidate->second.expires_at < victim->second.expires_at)) {
+                victim = candidate;
+            }
+        }
+        if (victim != entries_.end()) {
+            entries_.erase(victim);
+        }
+    }
+    return entries_[host];
+}
+
+void DnsResolver::StartLookupLocked(const std::string& host, Entry& entry) {
+    if (stop_requested_) {
+        return;
+    }
+    entry.pending = FamilyBit(Family::IPv4) | FamilyBit(Family::IPv6);
+    entry.lookup_ipv6.clear();
+    entry.lookup_ipv4.clear();
+    // AAAA is queued first so a single free worker starts it first
+    queue_.emplace_back(host, Family::IPv6);
+    queue_.emplace_back(host, Family::IPv4);
+    statistics_.queries += 2;
+    queue_cv_.notify_all();
+}
+
+DnsResolver::Delivery DnsResolver::OnLookupDone(const std::string& host, Family family,
+                                                Addresses addresses) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = entries_.find(host);
+    if (it == entries_.end()) {
+        return {};
+    }
+    Entry& entry = it->second;
+    entry.pending &= static_cast<uint8_t>(~FamilyBit(family));
+    (family == Family::IPv6 ? entry.lookup_ipv6 : entry.lookup_ipv4) = std::move(addresses);
+
+    if (entry.pending == 0) {
+        entry.addresses = Interleave(entry.lookup_ipv6, entry.lookup_ipv4);
+        entry.answered = true;
+        if (entry.addresses.empty()) {
+            ++statistics_.failures;
+        }
+        entry.expires_at = timer_wheel_->GetClock()->Now() +
+                           (entry.addresses.empty() ? config_.negative_ttl : config_.positive_ttl);
+        return {std::move(entry.waiters), entry.addresses,
+                std::exchange(entry.resolution_timer, TimerWheel::INVALID_TIMER_ID)};
+    }
+
+    if (entry.waiters.empty()) {
+        return {};
+    }
+    if (family == Family::IPv6 && !entry.lookup_ipv6.empty()) {
+        // IPv6 is preferred, so waiters need not hold out for A
+        return {std::move(entry.waiters), entry.lookup_ipv6};
+    }
+    if (family == Family::IPv4 && !entry.lookup_ipv4.empty() &&
+        entry.resolution_timer == TimerWheel::INVALID_TIMER_ID) {
+        entry.resolution_timer = timer_wheel_->Schedule(
+            config_.resolution_delay, [this, host]() { OnResolutionDelay(host); });
+    }
+    return {};
+}
+
+void DnsResolver::OnResolutionDelay(const std::string& host) {
+    Delivery delivery;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = entries_.find(host);
+        if (it == entries_.end() ||
+            it->second.resolution_timer == TimerWheel::INVALID_TIMER_ID) {
+            return;
+        }
+        Entry& entry = it->second;
+        entry.resolution_timer = TimerWheel::INVALID_TIMER_ID;
+        // AAAA is still outstanding; go ahead with IPv4
+        delivery.waiters = std::move(entry.waiters);
+        delivery.addresses = entry.lookup_ipv4;
+    }
+    Deliver(delivery);
+}
+
+void DnsResolver::Deliver(Delivery& delivery) {
+    if (delivery.stale_timer != TimerWheel::INVALID_TIMER_ID) {
+        timer_wheel_->Cancel(delivery.stale_timer);
+    }
+    for (auto& waiter : delivery.waiters) {
+        waiter.callback(WithPort(delivery.addresses, waiter.port));
+    }
+}
+
+DnsResolver::Addresses DnsResolver::Interleave(const Addresses& ipv6, const Addresses& ipv4) {
+    Addresses ordered;
+    ordered.reserve(ipv6.size() + ipv4.size());
+    for (size_t i = 0; i < std::max(ipv6.size(), ipv4.size()); ++i) {
+        if (i < ipv6.size()) {
+            ordered.push_back(ipv6[i]);
+        }
+        if (i < ipv4.size()) {
+            ordered.push_back(ipv4[i]);
+        }
+    }
+    return ordered;
+}
+
+DnsResolver::Addresses DnsResolver::DefaultLookup(const std::string& host, Family family) {
+    Addresses addresses;
+    addrinfo hints{};
+    hints.ai_family = family == Family::IPv6 ? AF_INET6 : AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    // Skips AAAA queries on hosts without IPv6 configured, and A without IPv4
+    hints.ai_flags = AI_ADDRCONFIG;
+    addrinfo* results = nullptr;
+    if (::getaddrinfo(host.c_str(), nullptr, &hints, &results) != 0) {
+        return addresses;
+    }
+    for (const addrinfo* entry = results; entry != nullptr; entry = entry->ai_next) {
+        if (entry->ai_addrlen == 0 || entry->ai_addrlen > DatagramEndpoint::STORAGE_SIZE) {
+            continue;
+        }
+        DatagramEndpoint endpoint;
+        std::memcpy(endpoint.storage.data(), entry->ai_addr, entry->ai_addrlen);
+        endpoint.length = static_cast<uint32_t>(entry->ai_addrlen);
+        if (std::find(addresses.begin(), addresses.end(), endpoint) == addresses.end()) {
+            addresses.push_back(endpoint);
+        }
+    }
+    ::freeaddrinfo(results);
+    return addresses;
+}
+
+void DnsResolver::WorkerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        queue_cv_.wait(lock, [this]() { return stop_requested_ || !queue_.empty(); });
+        if (stop_requested_) {
+            return;
+        }
+        auto [host, family] = std::move(queue_.front());
+        queue_.pop_front();
+
+        lock.unlock();
+        Delivery delivery = OnLookupDone(host, family, lookup_(host, family));
+        Deliver(delivery);
+        lock.lock();
+    }
+}
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,174 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "datagram_socket.h"
+#include "timer_wheel.h"
+
+namespace Core::Multiplayer {
+
+struct DnsResolverConfig {
+    // getaddrinfo reports no record TTL, so answers are kept this long
+    std::chrono::seconds positive_ttl{300};
+    // A host with no addresses is not looked up again for this long
+    std::chrono::seconds negative_ttl{10};
+    // Hand out an expired answer at once while it is refreshed in the background
+    bool serve_stale = true;
+    // RFC 8305 resolution delay: how long an IPv4 answer waits for AAAA
+    std::chrono::milliseconds resolution_delay{50};
+    // Lookups running at once; A and AAAA for a host take one each
+    size_t worker_count = 4;
+    size_t max_entries = 256;
+};
+
+struct DnsResolverStatistics {
+    uint64_t cache_hits = 0;
+    uint64_t stale_hits = 0;
+    uint64_t coalesced = 0; // Joined a lookup already in flight
+    uint64_t queries = 0;   // One per address family looked up
+    uint64_t failures = 0;  // Lookups that found no address at all
+    uint64_t prefetches = 0;
+};
+
+/**
+ * Host name resolver that keeps connection setup off blocking lookups.
+ *
+ * A and AAAA queries run in parallel on the resolver's own threads, and
+ * concurrent requests for one host share them. Answers are ordered for
+ * Happy Eyeballs (RFC 8305): IPv6 first, alternating with IPv4, so a
+ * connector walking the list in order tries both families early. Waiters
+ * get the IPv6 answer as soon as it is in; an IPv4 answer waits up to
+ * resolution_delay for it.
+ *
+ * Answers are cached for positive_ttl and failures for negative_ttl. With
+ * serve_stale, an expired answer is returned immediately and refreshed in
+ * the background, so a failover or reconnect does not wait on DNS. Prefetch
+ * configured hosts at startup to start every session from a warm cache.
+ * Numeric addresses are never looked up.
+ *
+ * Thread-safe. Callbacks run without the lock held on the thread that
+ * completed the lookup, a timer thread, or the caller's thread for cached
+ * answers. Destruction waits for lookups already in getaddrinfo.
+ */
+class DnsResolver {
+public:
+    using Addresses = std::vector<DatagramEndpoint>;
+    using Callback = std::function<void(const Addresses& addresses)>;
+
+    enum class Family : uint8_t {
+        IPv4,
+        IPv6,
+    };
+
+    // Blocking query for one family; returned addresses need no port
+    using LookupFunction = std::function<Addresses(const std::string& host, Family family)>;
+
+    static constexpr std::chrono::milliseconds DEFAULT_TIMEOUT{5000};
+
+    // Without a lookup function, getaddrinfo is used
+    explicit DnsResolver(const DnsResolverConfig& config = DnsResolverConfig{},
+                         LookupFunction lookup = nullptr,
+                         std::shared_ptr<TimerWheel> timer_wheel = nullptr);
+    ~DnsResolver();
+
+    DnsResolver(const DnsResolver&) = delete;
+    DnsResolver& operator=(const DnsResolver&) = delete;
+
+    // Process-wide resolver, so every component shares one cache
+    static std::shared_ptr<DnsResolver> GetShared();
+
+    /**
+     * Resolves host and calls back with its addresses on port, in connection
+     * order; empty if the host has none
+     */
+    void ResolveAsync(const std::string& host, uint16_t port, Callback callback);
+
+    /**
+     * Blocking form of ResolveAsync, for connect paths that are already off
+     * the game thread
+     * @return Empty if the host has no addresses or timeout passed first
+     */
+    Addresses Resolve(const std::string& host, uint16_t port,
+                      std::chrono::milliseconds timeout = DEFAULT_TIMEOUT);
+
+    // Starts a lookup unless a fresh answer is cached or one is in flight
+    void Prefetch(const std::string& host);
+    void Prefetch(std::span<const std::string> hosts);
+
+    // Forgets the answer, e.g. after a network change; the next request waits
+    // for a new lookup
+    void Invalidate(const std::string& host);
+
+    size_t GetCachedCount() const;
+    DnsResolverStatistics GetStatistics() const;
+
+private:
+    struct Waiter {
+        uint16_t port;
+        Callback callback;
+    };
+
+    struct Entry {
+        // Last complete answer, already in connection order
+        Addresses addresses;
+        bool answered = false;
+        ClockSource::TimePoint expires_at{};
+
+        // Lookup in flight: one bit per family still outstanding
+        uint8_t pending = 0;
+        Addresses lookup_ipv6;
+        Addresses lookup_ipv4;
+        std::vector<Waiter> waiters;
+        TimerWheel::TimerId resolution_timer = TimerWheel::INVALID_TIMER_ID;
+    };
+
+    struct Delivery {
+        std::vector<Waiter> waiters;
+        Addresses addresses;
+        // Cancelled outside the lock, since the timer callback takes it
+        TimerWheel::TimerId stale_timer = TimerWheel::INVALID_TIMER_ID;
+    };
+
+    static Addresses DefaultLookup(const std::string& host, Family family);
+    static Addresses Interleave(const Addresses& ipv6, const Addresses& ipv4);
+
+    // Request without the numeric shortcut; callback may be empty
+    void Request(const std::string& host, uint16_t port, Callback callback);
+    Entry& GetEntryLocked(const std::string& host);
+    void StartLookupLocked(const std::string& host, Entry& entry);
+    Delivery OnLookupDone(const std::string& host, Family family, Addresses addresses);
+    void OnResolutionDelay(const std::string& host);
+    void Deliver(Delivery& delivery);
+    void WorkerLoop();
+
+    const DnsResolverConfig config_;
+    const LookupFunction lookup_;
+    const std::shared_ptr<TimerWheel> timer_wheel_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable queue_cv_;
+    std::unordered_map<std::string, Entry> entries_;
+    std::deque<std::pair<std::string, Family>> queue_;
+    bool stop_requested_ = false;
+    std::vector<std::thread> workers_;
+
+    DnsResolverStatistics statistics_;
+};
+
+} // namespace Core::Multiplayer
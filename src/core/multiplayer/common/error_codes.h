@@ -44,6 +44,7 @@ enum class ErrorCode {
     SSLError,
     Timeout,
     NotSupported,
+    NotImplemented,
     PermissionDenied,
     
     // State errors
@@ -70,7 +71,7 @@ enum class ErrorCode {
     
     // Configuration errors
     ConfigurationInvalid,
-    ConfigurationMissing
+    ConfigurationMissing // Keep last: HLE::ErrorCodeMapper sizes its tables from it
 };
 
 } // namespace Core::Multiplayer
@@ -2,15 +2,14 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "error_handling.h"
+#include "multiplayer_log.h"
 #include <algorithm>
-#include <thread>
-#include <iostream>
-#include <deque>
+#include <iterator>
 
 namespace Core::Multiplayer {
 
 // Error code to category mapping
-static ErrorCategory GetErrorCategory(ErrorCode code) {
+ErrorCategory GetErrorCategory(ErrorCode code) {
     // Network errors (1000-1999)
     if (code >= ErrorCode::NetworkTimeout && code <= ErrorCode::SSLError) {
         return ErrorCategory::NetworkConnectivity;
@@ -87,41 +86,84 @@ static std::string GetDefaultErrorMessage(ErrorCode code) {
     }
 }
 
+// Message templates for ErrorFormat, indexed by its value; {N} is argument N
+static constexpr const char* ERROR_FORMAT_TEMPLATES[] = {
+    nullptr,
+    "Rate limit exceeded ({0} per second allowed)",
+    "Operation would block with {0} bytes pending",
+    "Queue full ({0} of {1} entries)",
+    "Message of {0} bytes exceeds the {1} byte limit",
+    "Timed out after {0} ms",
+    "Peer limit of {0} reached",
+};
+
+std::string FormatErrorMessage(const ErrorRecord& record) {
+    const auto index = static_cast<size_t>(record.format);
+    if (index == 0 || index >= std::size(ERROR_FORMAT_TEMPLATES)) {
+        return GetDefaultErrorMessage(record.code);
+    }
+    
+    std::string message;
+    for (const char* c = ERROR_FORMAT_TEMPLATES[index]; *c != '\0'; ++c) {
+        const size_t arg = static_cast<size_t>(c[1] - '0');
+        if (c[0] == '{' && arg < record.arg_count && c[2] == '}') {
+            message += std::to_string(record.args[arg]);
+            c += 2;
+        } else {
+            message += *c;
+        }
+    }
+    return message;
+}
+
+ErrorInfo ToErrorInfo(const ErrorRecord& record) {
+    ErrorInfo error;
+    error.category = record.category;
+    error.error_code = record.code;
+    error.message = FormatErrorMessage(record);
+    error.timestamp = record.timestamp;
+    error.component = record.component;
+    return error;
+}
+
 // Implementation class
 class ErrorHandler::Impl {
 public:
     Impl() : max_history_size_(100), auto_recovery_enabled_(true) {
+        history_.resize(max_history_size_);
         InitializeDefaultNotificationLevels();
     }
 
     void ReportError(const ErrorInfo& error) {
         std::lock_guard<std::mutex> lock(mutex_);
         
-        // Log the error
-        std::cerr << "[" << error.component << "] Error " 
-                  << static_cast<int>(error.error_code) << ": " << error.message << std::endl;
-        
-        // Add to history and trim oldest entries when exceeding limit
-        error_history_.push_back(error);
-        if (error_history_.size() > max_history_size_) {
-            error_history_.pop_front();
-        }
+        MULTIPLAYER_LOG_ERROR("[{}] Error {}: {}", error.component, error.error_code,
+                              error.message);
         
         // Update statistics
         error_stats_[error.error_code]++;
         
-        // Trigger callbacks
-        if (on_error_) {
-            on_error_(error);
-        }
+        DispatchLocked(error);
+    }
+
+    void ReportError(const ErrorRecord& record) {
+        std::lock_guard<std::mutex> lock(mutex_);
         
-        // Show notification
-        ShowNotification(error);
+        error_stats_[record.code]++;
         
-        // Attempt auto-recovery if enabled
-        if (auto_recovery_enabled_) {
-            AttemptRecovery(error);
+        // Nobody needs the text now; keep the record and format it only if
+        // the history is read
+        if (!NeedsErrorInfoLocked(record.category)) {
+            if (HistoryEntry* entry = NextHistorySlotLocked()) {
+                entry->info.reset();
+                entry->record = record;
+            }
+            return;
         }
+        
+        ErrorInfo error = ToErrorInfo(record);
+        ApplyStoredContextLocked(error);
+        DispatchLocked(error);
     }
 
     void ShowNotification(const ErrorInfo& error) {
@@ -187,9 +229,14 @@ public:
 
     std::vector<ErrorInfo> GetRecentErrors(size_t count) const {
         std::lock_guard<std::mutex> lock(mutex_);
-        size_t to_copy = std::min(count, error_history_.size());
-        auto start = error_history_.end() - static_cast<std::deque<ErrorInfo>::difference_type>(to_copy);
-        return std::vector<ErrorInfo>(start, error_history_.end());
+        size_t to_copy = std::min(count, history_size_);
+        std::vector<ErrorInfo> errors;
+        errors.reserve(to_copy);
+        for (size_t i = history_size_ - to_copy; i < history_size_; ++i) {
+            const HistoryEntry& entry = HistoryAtLocked(i);
+            errors.push_back(entry.info ? *entry.info : ToErrorInfo(entry.record));
+        }
+        return errors;
     }
 
     std::unordered_map<ErrorCode, size_t> GetErrorStatistics() const {
@@ -199,12 +246,29 @@ public:
 
     void ClearErrorHistory() {
         std::lock_guard<std::mutex> lock(mutex_);
-        error_history_.clear();
+        for (auto& entry : history_) {
+            entry.info.reset();
+        }
+        history_next_ = 0;
+        history_size_ = 0;
         error_stats_.clear();
     }
 
+    void SetMaxErrorHistorySize(size_t size) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Keep the most recent entries that still fit
+        const size_t kept = std::min(size, history_size_);
+        std::vector<HistoryEntry> history(size);
+        for (size_t i = 0; i < kept; ++i) {
+            history[i] = std::move(HistoryAtLocked(history_size_ - kept + i));
+        }
+        history_ = std::move(history);
+        history_size_ = kept;
+        history_next_ = size == 0 ? 0 : kept % size;
+        max_history_size_ = size;
+    }
+
     // Setters
-    void SetMaxErrorHistorySize(size_t size) { max_history_size_ = size; }
     void SetAutoRecoveryEnabled(bool enabled) { auto_recovery_enabled_ = enabled; }
     void SetNotificationLevel(ErrorCode code, NotificationLevel level) {
         notification_levels_[code] = level;
@@ -234,7 +298,18 @@ public:
     
     void ApplyStoredContext(ErrorInfo& error) {
         std::lock_guard<std::mutex> lock(mutex_);
-        
+        ApplyStoredContextLocked(error);
+    }
+
+private:
+    // A history slot holds either a full ErrorInfo or, for errors reported
+    // as an ErrorRecord nobody listened to, just the record
+    struct HistoryEntry {
+        ErrorRecord record;
+        std::optional<ErrorInfo> info;
+    };
+
+    void ApplyStoredContextLocked(ErrorInfo& error) {
         // Apply stored context
         auto context_it = error_contexts_.find(error.error_code);
         if (context_it != error_contexts_.end()) {
@@ -258,7 +333,51 @@ public:
         }
     }
 
-private:
+    bool NeedsErrorInfoLocked(ErrorCategory category) const {
+        return on_error_ || notification_callback_ ||
+               (auto_recovery_enabled_ && recovery_strategies_.count(category) != 0);
+    }
+
+    // Record the error in the history, then run the callbacks, notification
+    // and auto-recovery
+    void DispatchLocked(const ErrorInfo& error) {
+        if (HistoryEntry* entry = NextHistorySlotLocked()) {
+            entry->info = error;
+        }
+        
+        // Trigger callbacks
+        if (on_error_) {
+            on_error_(error);
+        }
+        
+        // Show notification
+        ShowNotification(error);
+        
+        // Attempt auto-recovery if enabled
+        if (auto_recovery_enabled_) {
+            AttemptRecovery(error);
+        }
+    }
+
+    // The history is a ring preallocated to max_history_size_ entries; the
+    // slot returned overwrites the oldest entry once it is full
+    HistoryEntry* NextHistorySlotLocked() {
+        if (history_.empty()) {
+            return nullptr;
+        }
+        HistoryEntry& entry = history_[history_next_];
+        history_next_ = (history_next_ + 1) % history_.size();
+        history_size_ = std::min(history_size_ + 1, history_.size());
+        return &entry;
+    }
+
+    // index 0 is the oldest entry
+    HistoryEntry& HistoryAtLocked(size_t index) {
+        return history_[(history_next_ + history_.size() - history_size_ + index) % history_.size()];
+    }
+    const HistoryEntry& HistoryAtLocked(size_t index) const {
+        return history_[(history_next_ + history_.size() - history_size_ + index) % history_.size()];
+    }
     void InitializeDefaultNotificationLevels() {
         // Network errors - usually warnings
         notification_levels_[ErrorCode::NetworkTimeout] = NotificationLevel::Warning;
@@ -310,7 +429,9 @@ private:
     }
 
     mutable std::mutex mutex_;
-    std::deque<ErrorInfo> error_history_;
+    std::vector<HistoryEntry> history_;
+    size_t history_next_ = 0;
+    size_t history_size_ = 0;
     std::unordered_map<ErrorCode, size_t> error_stats_;
     std::unordered_map<ErrorCategory, std::vector<std::unique_ptr<IErrorRecoveryStrategy>>> recovery_strategies_;
     std::unordered_map<ErrorCode, NotificationLevel> notification_levels_;
@@ -352,6 +473,10 @@ void ErrorHandler::ReportError(const ErrorInfo& error) {
     impl_->ReportError(error);
 }
 
+void ErrorHandler::ReportError(const ErrorRecord& record) {
+    impl_->ReportError(record);
+}
+
 void ErrorHandler::SetErrorContext(ErrorCode code, const std::string& key, 
                                   const std::string& value) {
     impl_->SetErrorContext(code, key, value);
@@ -424,8 +549,28 @@ void ErrorHandler::SetOnRecoveryFailure(ErrorCallback callback) {
 }
 
 // NetworkRetryStrategy implementation
-NetworkRetryStrategy::NetworkRetryStrategy(uint32_t max_retries, uint32_t initial_delay_ms)
-    : max_retries_(max_retries), initial_delay_ms_(initial_delay_ms) {}
+NetworkRetryStrategy::NetworkRetryStrategy(uint32_t max_retries, uint32_t initial_delay_ms,
+                                           std::shared_ptr<TimerWheel> timer_wheel,
+                                           std::shared_ptr<WorkStealingExecutor> executor)
+    : max_retries_(max_retries), initial_delay_ms_(initial_delay_ms),
+      timer_wheel_(timer_wheel ? std::move(timer_wheel) : TimerWheel::GetShared()),
+      retry_tasks_(executor ? std::move(executor) : WorkStealingExecutor::GetShared()) {}
+
+NetworkRetryStrategy::~NetworkRetryStrategy() {
+    std::vector<TimerWheel::TimerId> timers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        shutting_down_ = true;
+        for (const auto& [endpoint, retry] : pending_retries_) {
+            timers.push_back(retry.timer_id);
+        }
+    }
+    // Cancel waits for a firing timer, whose retry then shows up in the group
+    for (const auto timer_id : timers) {
+        timer_wheel_->Cancel(timer_id);
+    }
+    retry_tasks_.Wait();
+}
 
 bool NetworkRetryStrategy::CanRecover(const ErrorInfo& error) const {
     if (error.category != ErrorCategory::NetworkConnectivity) {
@@ -441,34 +586,72 @@ bool NetworkRetryStrategy::CanRecover(const ErrorInfo& error) const {
 
 void NetworkRetryStrategy::AttemptRecovery(const ErrorInfo& error, 
                                           std::function<void(bool)> callback) {
-    std::thread([this, error, callback]() {
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            retry_counts_[error.error_code]++;
-        }
-        
-        // Calculate exponential backoff
-        uint32_t retry_count = retry_counts_[error.error_code];
-        uint32_t delay_ms = initial_delay_ms_ * (1 << (retry_count - 1));
-        
-        // Honor retry_after_seconds if specified
-        if (error.retry_after_seconds.has_value()) {
-            delay_ms = error.retry_after_seconds.value() * 1000;
-        }
-        
-        std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms));
-        
-        // In a real implementation, this would retry the network operation
-        // For now, we'll simulate a 50% success rate
-        bool success = (std::rand() % 2) == 0;
-        
-        if (success) {
-            std::lock_guard<std::mutex> lock(mutex_);
-            retry_counts_.erase(error.error_code);
+    const std::string endpoint = GetEndpointKey(error);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (shutting_down_) {
+        return;
+    }
+    
+    // Coalesce with a retry already waiting for this endpoint
+    auto pending = pending_retries_.find(endpoint);
+    if (pending != pending_retries_.end()) {
+        pending->second.callbacks.push_back(std::move(callback));
+        return;
+    }
+    
+    // Calculate exponential backoff
+    uint32_t retry_count = ++retry_counts_[error.error_code];
+    uint32_t delay_ms = initial_delay_ms_ * (1u << std::min<uint32_t>(retry_count - 1, 16));
+    
+    // Honor retry_after_seconds if specified
+    if (error.retry_after_seconds.has_value()) {
+        delay_ms = error.retry_after_seconds.value() * 1000;
+    }
+    
+    PendingRetry& retry = pending_retries_[endpoint];
+    retry.error_code = error.error_code;
+    retry.callbacks.push_back(std::move(callback));
+    // The wheel thread only hands the retry to the executor, so it never
+    // blocks on the retry itself or the callbacks
+    retry.timer_id = timer_wheel_->Schedule(std::chrono::milliseconds(delay_ms), [this, endpoint]() {
+        retry_tasks_.Submit([this, endpoint]() { RunRetry(endpoint); });
+    });
+}
+
+size_t NetworkRetryStrategy::GetPendingRetryCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_retries_.size();
+}
+
+std::string NetworkRetryStrategy::GetEndpointKey(const ErrorInfo& error) {
+    auto it = error.context.find("endpoint");
+    return it != error.context.end() ? it->second : error.component;
+}
+
+void NetworkRetryStrategy::RunRetry(const std::string& endpoint) {
+    PendingRetry retry;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = pending_retries_.find(endpoint);
+        if (it == pending_retries_.end()) {
+            return;
         }
-        
+        retry = std::move(it->second);
+        pending_retries_.erase(it);
+    }
+    
+    // In a real implementation, this would retry the network operation
+    // For now, we'll simulate a 50% success rate
+    bool success = (std::rand() % 2) == 0;
+    
+    if (success) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        retry_counts_.erase(retry.error_code);
+    }
+    
+    for (auto& callback : retry.callbacks) {
         callback(success);
-    }).detach();
+    }
 }
 
 // PermissionRequestStrategy implementation
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <optional>
@@ -12,6 +14,8 @@
 #include <mutex>
 #include <queue>
 #include "error_codes.h"
+#include "timer_wheel.h"
+#include "work_stealing_executor.h"
 
 namespace Core::Multiplayer {
 
@@ -45,6 +49,72 @@ struct ErrorInfo {
     std::unordered_map<std::string, std::string> context; // Additional context
 };
 
+/**
+ * Message templates for ErrorRecord. Each names a fixed message whose
+ * numeric arguments are filled in only when the text is needed.
+ */
+enum class ErrorFormat : uint16_t {
+    Default,         // The error code's default message
+    RateLimited,     // {0}: allowed rate per second
+    WouldBlock,      // {0}: bytes still pending
+    QueueFull,       // {0}: queued entries, {1}: capacity
+    MessageTooLarge, // {0}: message size, {1}: limit
+    TimedOut,        // {0}: milliseconds waited
+    PeerLimit,       // {0}: peer limit
+};
+
+/**
+ * Compact error record for frequent, expected errors such as rate-limit
+ * drops or would-block results. It is trivially copyable and building or
+ * reporting one does not allocate; the message text is formatted only when
+ * a listener or the UI needs an ErrorInfo.
+ */
+struct ErrorRecord {
+    static constexpr size_t MAX_ARGS = 4;
+
+    ErrorCode code = ErrorCode::Success;
+    ErrorCategory category = ErrorCategory::Unknown;
+    ErrorFormat format = ErrorFormat::Default;
+    uint8_t arg_count = 0;
+    std::array<int64_t, MAX_ARGS> args{};
+    const char* component = "Unknown"; // Must have static storage duration
+    std::chrono::steady_clock::time_point timestamp;
+};
+
+/**
+ * Category an error code falls into
+ */
+ErrorCategory GetErrorCategory(ErrorCode code);
+
+/**
+ * Build an ErrorRecord stamped with the current time
+ * @param component Static string naming the reporting component
+ */
+template <typename... Args>
+ErrorRecord MakeErrorRecord(ErrorCode code, ErrorFormat format, const char* component,
+                            Args... args) {
+    static_assert(sizeof...(Args) <= ErrorRecord::MAX_ARGS, "Too many error arguments");
+    ErrorRecord record;
+    record.code = code;
+    record.category = GetErrorCategory(code);
+    record.format = format;
+    record.arg_count = static_cast<uint8_t>(sizeof...(Args));
+    record.args = {static_cast<int64_t>(args)...};
+    record.component = component;
+    record.timestamp = std::chrono::steady_clock::now();
+    return record;
+}
+
+/**
+ * Format a record's message text
+ */
+std::string FormatErrorMessage(const ErrorRecord& record);
+
+/**
+ * Expand a record into a full ErrorInfo, formatting its message
+ */
+ErrorInfo ToErrorInfo(const ErrorRecord& record);
+
 /**
  * User notification levels for UI integration
  */
@@ -95,6 +165,10 @@ public:
     void ReportError(ErrorCode code, const std::string& message, 
                     const std::string& component = "Unknown");
     void ReportError(const ErrorInfo& error);
+    // Fast path for expected errors: only counts and records the error
+    // unless an error or notification callback, or an auto-recovery
+    // strategy for its category, needs it as an ErrorInfo. Not logged.
+    void ReportError(const ErrorRecord& record);
     
     // Error enrichment
     void SetErrorContext(ErrorCode code, const std::string& key, 
@@ -134,22 +208,54 @@ private:
 
 /**
  * Common error recovery strategies
+ *
+ * Retries wait on a timer wheel instead of a sleeping thread and run on an
+ * executor, so an outage that fails many operations at once does not spawn
+ * a thread per retry. A retry requested while one for the same endpoint
+ * (the error's "endpoint" context entry, or else its component) is already
+ * waiting joins it: every caller gets that retry's result.
  */
 class NetworkRetryStrategy : public IErrorRecoveryStrategy {
 public:
+    /**
+     * @param timer_wheel Wheel the retry delays wait on; the shared wheel
+     *                    is used when null
+     * @param executor Pool the retries and callbacks run on; the shared
+     *                 pool is used when null
+     */
     NetworkRetryStrategy(uint32_t max_retries = 3, 
-                        uint32_t initial_delay_ms = 1000);
+                        uint32_t initial_delay_ms = 1000,
+                        std::shared_ptr<TimerWheel> timer_wheel = nullptr,
+                        std::shared_ptr<WorkStealingExecutor> executor = nullptr);
+    ~NetworkRetryStrategy() override;
     
     bool CanRecover(const ErrorInfo& error) const override;
     void AttemptRecovery(const ErrorInfo& error, 
                         std::function<void(bool)> callback) override;
     std::string GetName() const override { return "Network Retry"; }
     
+    // Retries currently waiting for their timer
+    size_t GetPendingRetryCount() const;
+    
 private:
+    struct PendingRetry {
+        TimerWheel::TimerId timer_id = TimerWheel::INVALID_TIMER_ID;
+        ErrorCode error_code = ErrorCode::Success;
+        std::vector<std::function<void(bool)>> callbacks;
+    };
+    
+    static std::string GetEndpointKey(const ErrorInfo& error);
+    void RunRetry(const std::string& endpoint);
+    
     uint32_t max_retries_;
     uint32_t initial_delay_ms_;
     std::unordered_map<ErrorCode, uint32_t> retry_counts_;
+    std::unordered_map<std::string, PendingRetry> pending_retries_;
+    bool shutting_down_ = false;
     mutable std::mutex mutex_;
+    
+    std::shared_ptr<TimerWheel> timer_wheel_;
+    ExecutorTaskGroup retry_tasks_;
 };
 
 /**
@@ -0,0 +1,321 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "mpmc_ring.h"
+
+namespace Core::Multiplayer {
+
+template <typename Signature, size_t Capacity = 48>
+class InlineFunction;
+
+/**
+ * Move-only callable that keeps its target inside the object when it fits in
+ * Capacity bytes and moves without throwing, and on the heap otherwise. A
+ * lambda capturing a few pointers, or a std::function, never allocates.
+ */
+template <typename R, typename... Args, size_t Capacity>
+class InlineFunction<R(Args...), Capacity> {
+public:
+    InlineFunction() = default;
+    InlineFunction(std::nullptr_t) {}
+
+    template <typename F,
+              typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, InlineFunction> &&
+                                          std::is_invocable_r_v<R, std::decay_t<F>&, Args...>>>
+    InlineFunction(F&& f) {
+        using Target = std::decay_t<F>;
+        if constexpr (std::is_pointer_v<Target> || std::is_member_pointer_v<Target>) {
+            if (!f) {
+                return;
+            }
+        } else if constexpr (std::is_constructible_v<bool, const Target&>) {
+            // Empty std::function and the like stay empty
+            if (!static_cast<bool>(f)) {
+                return;
+            }
+        }
+        if constexpr (FitsInline<Target>()) {
+            ::new (static_cast<void*>(storage_)) Target(std::forward<F>(f));
+        } else {
+            ::new (static_cast<void*>(storage_)) Target*(new Target(std::forward<F>(f)));
+        }
+        ops_ = &OPS<Target>;
+    }
+
+    InlineFunction(InlineFunction&& other) noexcept {
+        MoveFrom(other);
+    }
+
+    InlineFunction& operator=(InlineFunction&& other) noexcept {
+        if (this != &other) {
+            Reset();
+            MoveFrom(other);
+        }
+        return *this;
+    }
+
+    InlineFunction(const InlineFunction&) = delete;
+    InlineFunction& operator=(const InlineFunction&) = delete;
+
+    ~InlineFunction() {
+        Reset();
+    }
+
+    explicit operator bool() const {
+        return ops_ != nullptr;
+    }
+
+    bool IsInline() const {
+        return ops_ != nullptr && ops_->is_inline;
+    }
+
+    R operator()(Args... args) const {
+        return ops_->invoke(const_cast<unsigned char*>(storage_), std::forward<Args>(args)...);
+    }
+
+    void Reset() {
+        if (ops_) {
+            ops_->destroy(storage_);
+            ops_ = nullptr;
+        }
+    }
+
+private:
+    struct Ops {
+        R (*invoke)(void* storage, Args&&... args);
+        void (*move)(void* destination, void* source) noexcept;
+        void (*destroy)(void* storage) noexcept;
+        bool is_inline;
+    };
+
+    template <typename Target>
+    static constexpr bool FitsInline() {
+        return sizeof(Target) <= Capacity && alignof(Target) <= alignof(std::max_align_t) &&
+               std::is_nothrow_move_constructible_v<Target>;
+    }
+
+    template <typename Target>
+    static Target& Get(void* storage) {
+        if constexpr (FitsInline<Target>()) {
+            return *std::launder(static_cast<Target*>(storage));
+        } else {
+            return **std::launder(static_cast<Target**>(storage));
+        }
+    }
+
+    template <typename Target>
+    static constexpr Ops OPS{
+        [](void* storage, Args&&... args) -> R {
+            return Get<Target>(storage)(std::forward<Args>(args)...);
+        },
+        [](void* destination, void* source) noexcept {
+            if constexpr (FitsInline<Target>()) {
+                ::new (destination) Target(std::move(Get<Target>(source)));
+                Get<Target>(source).~Target();
+            } else {
+                ::new (destination) Target*(*static_cast<Target**>(source));
+            }
+        },
+        [](void* storage) noexcept {
+            if constexpr (FitsInline<Target>()) {
+                Get<Target>(storage).~Target();
+            } else {
+                delete *static_cast<Target**>(storage);
+            }
+        },
+        FitsInline<Target>(),
+    };
+
+    void MoveFrom(InlineFunction& other) noexcept {
+        if (other.ops_) {
+            other.ops_->move(storage_, other.storage_);
+            ops_ = std::exchange(other.ops_, nullptr);
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char storage_[Capacity];
+    const Ops* ops_ = nullptr;
+};
+
+/**
+ * Events deferred by EventChannels, run later by whichever thread owns the
+ * queue. Network threads post to it instead of running UI or game code
+ * inline; the owner calls Dispatch from its own loop, e.g. once per frame.
+ *
+ * Posting is lock-free. A full queue drops the event and says so.
+ */
+class EventQueue {
+public:
+    // Large enough for an event's arguments and the subscriber list
+    using Task = InlineFunction<void(), 128>;
+
+    explicit EventQueue(size_t capacity = 1024) : queue_(capacity) {}
+
+    EventQueue(const EventQueue&) = delete;
+    EventQueue& operator=(const EventQueue&) = delete;
+
+    // @return False if the queue was full; the event is dropped
+    bool Post(Task task) {
+        return queue_.TryPush(std::move(task));
+    }
+
+    /**
+     * Runs queued events on the calling thread, oldest first
+     * @return Number of events run
+     */
+    size_t Dispatch(size_t max_events = std::numeric_limits<size_t>::max()) {
+        size_t dispatched = 0;
+        Task task;
+        while (dispatched < max_events && queue_.TryPop(task)) {
+            task();
+            task.Reset();
+            ++dispatched;
+        }
+        return dispatched;
+    }
+
+    size_t GetPendingCount() const {
+        return queue_.Size();
+    }
+
+    MpmcRingStatistics GetStatistics() const {
+        return queue_.GetStatistics();
+    }
+
+private:
+    MpmcRing<Task> queue_;
+};
+
+/**
+ * One typed event with any number of subscribers, replacing a std::function
+ * member behind a callback mutex.
+ *
+ * The subscriber list is an immutable snapshot swapped whole on every
+ * change, so Publish takes no lock and never waits on a subscriber being
+ * added; only Subscribe and Unsubscribe serialize with each other. A handler
+ * removed while an event is being published elsewhere may still see that
+ * one event.
+ *
+ * With a deferred queue set, Publish copies the arguments into the queue
+ * instead of calling handlers, and they run when the queue is dispatched.
+ */
+template <typename... Args>
+class EventChannel {
+public:
+    using Handler = InlineFunction<void(const Args&...)>;
+    using SubscriptionId = uint64_t;
+
+    static constexpr SubscriptionId INVALID_SUBSCRIPTION_ID = 0;
+
+    EventChannel() = default;
+
+    EventChannel(const EventChannel&) = delete;
+    EventChannel& operator=(const EventChannel&) = delete;
+
+    /**
+     * @return Id for Unsubscribe, or INVALID_SUBSCRIPTION_ID for an empty handler
+     */
+    SubscriptionId Subscribe(Handler handler) {
+        if (!handler) {
+            return INVALID_SUBSCRIPTION_ID;
+        }
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        auto subscribers =
+            std::make_shared<SubscriberList>(*subscribers_.load(std::memory_order_acquire));
+        const SubscriptionId id = next_id_++;
+        subscribers->push_back({id, std::make_shared<const Handler>(std::move(handler))});
+        subscribers_.store(std::move(subscribers), std::memory_order_release);
+        return id;
+    }
+
+    bool Unsubscribe(SubscriptionId id) {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        auto subscribers =
+            std::make_shared<SubscriberList>(*subscribers_.load(std::memory_order_acquire));
+        const auto it = std::find_if(subscribers->begin(), subscribers->end(),
+                                     [id](const Subscriber& subscriber) { return subscriber.id == id; });
+        if (it == subscribers->end()) {
+            return false;
+        }
+        subscribers->erase(it);
+        subscribers_.store(std::move(subscribers), std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Replaces every subscriber with this handler, or with none when it is
+     * empty; for single-callback setters
+     */
+    void Reset(Handler handler) {
+        auto subscribers = std::make_shared<SubscriberList>();
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        if (handler) {
+            subscribers->push_back({next_id_++, std::make_shared<const Handler>(std::move(handler))});
+        }
+        subscribers_.store(std::move(subscribers), std::memory_order_release);
+    }
+
+    void SetDeferredQueue(std::shared_ptr<EventQueue> queue) {
+        deferred_.store(std::move(queue), std::memory_order_release);
+    }
+
+    bool HasSubscribers() const {
+        return !subscribers_.load(std::memory_order_acquire)->empty();
+    }
+
+    /**
+     * Calls every handler, or queues the event for them
+     * @return False if the deferred queue was full and the event was dropped
+     */
+    bool Publish(const Args&... args) const {
+        auto subscribers = subscribers_.load(std::memory_order_acquire);
+        if (subscribers->empty()) {
+            return true;
+        }
+        if (auto queue = deferred_.load(std::memory_order_acquire)) {
+            return queue->Post([subscribers = std::move(subscribers),
+                                event = std::make_tuple(args...)] {
+                std::apply([&](const auto&... values) { Invoke(*subscribers, values...); }, event);
+            });
+        }
+        Invoke(*subscribers, args...);
+        return true;
+    }
+
+private:
+    struct Subscriber {
+        SubscriptionId id;
+        // Shared between snapshots, so changing the list never copies handlers
+        std::shared_ptr<const Handler> handler;
+    };
+    using SubscriberList = std::vector<Subscriber>;
+
+    static void Invoke(const SubscriberList& subscribers, const Args&... args) {
+        for (const auto& subscriber : subscribers) {
+            (*subscriber.handler)(args...);
+        }
+    }
+
+    std::atomic<std::shared_ptr<const SubscriberList>> subscribers_{
+        std::make_shared<const SubscriberList>()};
+    std::atomic<std::shared_ptr<EventQueue>> deferred_;
+    std::mutex write_mutex_;
+    SubscriptionId next_id_ = 1;
+};
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,239 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "fec_codec.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Core::Multiplayer {
+
+namespace {
+void WriteHeader(uint8_t* out, uint8_t kind, uint16_t group_id, uint8_t index,
+                 uint8_t group_size) {
+    out[0] = kind;
+    out[1] = static_cast<uint8_t>(group_id & 0xFF);
+    out[2] = static_cast<uint8_t>((group_id >> 8) & 0xFF);
+    out[3] = index;
+    out[4] = group_size;
+}
+
+uint16_t ReadU16(const uint8_t* data) {
+    return static_cast<uint16_t>(data[0] | (data[1] << 8));
+}
+
+void XorInto(uint8_t* parity, const uint8_t* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        parity[i] ^= data[i];
+    }
+}
+
+// Whether group a was started after group b, allowing for wraparound
+bool IsNewer(uint16_t a, uint16_t b) {
+    return static_cast<int16_t>(a - b) > 0;
+}
+} // namespace
+
+FecEncoder::FecEncoder(const FecConfig& config)
+    : group_size_(std::clamp<uint8_t>(config.group_size, 1, MAX_GROUP_SIZE)),
+      next_group_size_(group_size_) {}
+
+void FecEncoder::SetGroupSize(uint8_t group_size) {
+    next_group_size_ = std::clamp<uint8_t>(group_size, 1, MAX_GROUP_SIZE);
+}
+
+size_t FecEncoder::Encode(const uint8_t* data, size_t size, uint8_t* out) {
+    if (size > MAX_PAYLOAD_SIZE) {
+        return 0;
+    }
+    if (index_ == 0) {
+        group_size_ = next_group_size_;
+        std::memset(parity_.data(), 0, parity_size_);
+        length_parity_ = 0;
+        parity_size_ = 0;
+    }
+
+    WriteHeader(out, KIND_DATA, group_id_, index_, group_size_);
+    std::memcpy(out + HEADER_SIZE, data, size);
+    XorInto(parity_.data(), data, size);
+    length_parity_ ^= static_cast<uint16_t>(size);
+    parity_size_ = std::max(parity_size_, size);
+    ++statistics_.data_packets_sent;
+
+    if (++index_ == group_size_) {
+        parity_ready_ = true;
+        parity_group_id_ = group_id_++;
+        index_ = 0;
+    }
+    return HEADER_SIZE + size;
+}
+
+size_t FecEncoder::TakeParity(uint8_t* out) {
+    if (!parity_ready_) {
+        return 0;
+    }
+    parity_ready_ = false;
+
+    WriteHeader(out, KIND_PARITY, parity_group_id_, group_size_, group_size_);
+    out[HEADER_SIZE] = static_cast<uint8_t>(length_parity_ & 0xFF);
+    out[HEADER_SIZE + 1] = static_cast<uint8_t>((length_parity_ >> 8) & 0xFF);
+    std::memcpy(out + HEADER_SIZE + PARITY_LENGTH_SIZE, parity_.data(), parity_size_);
+    ++statistics_.parity_packets_sent;
+    return HEADER_SIZE + PARITY_LENGTH_SIZE + parity_size_;
+}
+
+size_t FecDecoder::Decode(const uint8_t* data, size_t size, std::array<FecPacketView, 2>& out) {
+    if (size < FecEncoder::HEADER_SIZE) {
+        return 0;
+    }
+    const uint8_t kind = data[0];
+    const uint16_t group_id = ReadU16(data + 1);
+    const uint8_t index = data[3];
+    const uint8_t group_size = data[4];
+    const uint8_t* body = data + FecEncoder::HEADER_SIZE;
+    const size_t body_size = size - FecEncoder::HEADER_SIZE;
+    if (group_size == 0 || group_size > FecEncoder::MAX_GROUP_SIZE ||
+        body_size > FecEncoder::PARITY_LENGTH_SIZE + FecEncoder::MAX_PAYLOAD_SIZE) {
+        return 0;
+    }
+
+    if (kind == FecEncoder::KIND_DATA) {
+        if (index >= group_size || body_size > FecEncoder::MAX_PAYLOAD_SIZE) {
+            return 0;
+        }
+        Group* group = FindGroup(group_id, group_size);
+        if (group != nullptr) {
+            const uint32_t bit = uint32_t{1} << index;
+            if ((group->received & bit) != 0) {
+                return 0; // Duplicate
+            }
+            group->received |= bit;
+            ++group->received_count;
+        }
+        ++statistics_.packets_received;
+        out[0] = {body, body_size};
+        if (group == nullptr || group->settled) {
+            // Too old to track, or the parity already rebuilt a packet
+            return 1;
+        }
+
+        XorInto(group->parity.data(), body, body_size);
+        group->length_parity ^= static_cast<uint16_t>(body_size);
+        group->parity_size = std::max(group->parity_size, body_size);
+        if (group->received_count == group->group_size) {
+            group->settled = true;
+            return 1;
+        }
+        return TryRecover(*group, out[1]) ? 2 : 1;
+    }
+
+    if (kind == FecEncoder::KIND_PARITY && body_size >= FecEncoder::PARITY_LENGTH_SIZE) {
+        Group* group = FindGroup(group_id, group_size);
+        if (group == nullptr || group->has_parity || group->settled) {
+            return 0;
+        }
+        group->has_parity = true;
+        const size_t parity_size = body_size - FecEncoder::PARITY_LENGTH_SIZE;
+        XorInto(group->parity.data(), body + FecEncoder::PARITY_LENGTH_SIZE, parity_size);
+        group->length_parity ^= ReadU16(body);
+        group->parity_size = std::max(group->parity_size, parity_size);
+        return TryRecover(*group, out[0]) ? 1 : 0;
+    }
+    return 0;
+}
+
+FecDecoder::Group* FecDecoder::FindGroup(uint16_t group_id, uint8_t group_size) {
+    if (has_newest_ && !IsNewer(group_id, newest_group_) &&
+        static_cast<uint16_t>(newest_group_ - group_id) >= GROUP_WINDOW) {
+        return nullptr;
+    }
+
+    Group& group = groups_[group_id % GROUP_WINDOW];
+    if (!group.active || group.group_id != group_id) {
+        Retire(group);
+        std::memset(group.parity.data(), 0, group.parity_size);
+        group.active = true;
+        group.settled = false;
+        group.has_parity = false;
+        group.group_id = group_id;
+        group.group_size = group_size;
+        group.received = 0;
+        group.received_count = 0;
+        group.length_parity = 0;
+        group.parity_size = 0;
+    }
+    if (!has_newest_ || IsNewer(group_id, newest_group_)) {
+        has_newest_ = true;
+        newest_group_ = group_id;
+    }
+    return &group;
+}
+
+void FecDecoder::Retire(Group& group) {
+    if (group.active && !group.settled) {
+        statistics_.packets_lost += group.group_size - group.received_count;
+    }
+    group.active = false;
+}
+
+bool FecDecoder::TryRecover(Group& group, FecPacketView& out) {
+    if (!group.has_parity || group.received_count + 1 != group.group_size ||
+        group.length_parity > group.parity_size) {
+        return false;
+    }
+    group.settled = true;
+    // The original may still turn up late; it is then a duplicate
+    group.received = static_cast<uint32_t>((uint64_t{1} << group.group_size) - 1);
+    ++statistics_.packets_recovered;
+    out = {group.parity.data(), group.length_parity};
+    return true;
+}
+
+FecCodec::FecCodec(const FecConfig& config) : config_(config) {}
+
+size_t FecCodec::Encode(uint8_t node_id, const uint8_t* data, size_t size, uint8_t* out) {
+    return encoders_.try_emplace(node_id, config_).first->second.Encode(data, size, out);
+}
+
+void FecCodec::SetGroupSize(uint8_t group_size) {
+    config_.group_size = group_size;
+    for (auto& [node_id, encoder] : encoders_) {
+        encoder.SetGroupSize(group_size);
+    }
+}
+
+size_t FecCodec::TakeParity(uint8_t node_id, uint8_t* out) {
+    const auto it = encoders_.find(node_id);
+    return it != encoders_.end() ? it->second.TakeParity(out) : 0;
+}
+
+size_t FecCodec::Decode(uint8_t node_id, const uint8_t* data, size_t size,
+                        std::array<FecPacketView, 2>& out) {
+    return decoders_[node_id].Decode(data, size, out);
+}
+
+void FecCodec::ResetNode(uint8_t node_id) {
+    encoders_.erase(node_id);
+    decoders_.erase(node_id);
+}
+
+FecStatistics FecCodec::GetStatistics() const {
+    FecStatistics total = GetDecodeStatistics();
+    for (const auto& [node_id, encoder] : encoders_) {
+        total.data_packets_sent += encoder.GetStatistics().data_packets_sent;
+        total.parity_packets_sent += encoder.GetStatistics().parity_packets_sent;
+    }
+    return total;
+}
+
+FecStatistics FecCodec::GetDecodeStatistics() const {
+    FecStatistics total;
+    for (const auto& [node_id, decoder] : decoders_) {
+        total.packets_received += decoder.GetStatistics().packets_received;
+        total.packets_recovered += decoder.GetStatistics().packets_recovered;
+        total.packets_lost += decoder.GetStatistics().packets_lost;
+    }
+    return total;
+}
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,180 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+namespace Core::Multiplayer {
+
+/**
+ * Forward error correction configuration
+ */
+struct FecConfig {
+    // Data packets per parity packet; one loss per group is recoverable
+    uint8_t group_size = 4;
+};
+
+/**
+ * Forward error correction statistics, summed over all streams
+ */
+struct FecStatistics {
+    uint64_t data_packets_sent = 0;
+    uint64_t parity_packets_sent = 0;
+    uint64_t packets_received = 0;
+    uint64_t packets_recovered = 0;
+    uint64_t packets_lost = 0; // Missing from a group, with too few others to rebuild them
+};
+
+/**
+ * A packet handed back by FecDecoder; refers to the input or the decoder
+ */
+struct FecPacketView {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+};
+
+/**
+ * XOR parity over groups of consecutive packets of one stream.
+ *
+ * After every group_size data packets the encoder emits a parity packet
+ * holding the XOR of their lengths and of their bytes, zero-padded to the
+ * longest. The decoder rebuilds any single packet of a group from the
+ * others and the parity. Retransmitting at 60Hz always arrives too late,
+ * while a parity packet costs one extra send per group and no round trip.
+ *
+ * Wire format, little-endian:
+ *   header: kind (1), group id (2), index in group (1), group size (1)
+ *   data:   header, packet bytes
+ *   parity: header, XOR of the lengths (2), XOR of the bytes
+ */
+class FecEncoder {
+public:
+    static constexpr uint8_t KIND_DATA = 0x01;
+    static constexpr uint8_t KIND_PARITY = 0x02;
+    static constexpr size_t HEADER_SIZE = 5;
+    static constexpr size_t PARITY_LENGTH_SIZE = 2;
+    // Largest UDP payload in a 1500-byte MTU; leaves room for the codecs below
+    static constexpr size_t MAX_PAYLOAD_SIZE = 1472;
+    static constexpr size_t MAX_FRAMED_SIZE = HEADER_SIZE + PARITY_LENGTH_SIZE + MAX_PAYLOAD_SIZE;
+    static constexpr uint8_t MAX_GROUP_SIZE = 32;
+
+    explicit FecEncoder(const FecConfig& config = FecConfig{});
+
+    /**
+     * Frames a data packet; out must hold MAX_FRAMED_SIZE bytes
+     * @return Bytes written, or 0 if the packet is too large
+     */
+    size_t Encode(const uint8_t* data, size_t size, uint8_t* out);
+
+    /**
+     * Writes the parity packet for the group the last Encode completed
+     * @return Bytes written, or 0 if the group is not complete yet
+     */
+    size_t TakeParity(uint8_t* out);
+
+    // Takes effect from the next group; the one under way keeps its size
+    void SetGroupSize(uint8_t group_size);
+
+    const FecStatistics& GetStatistics() const { return statistics_; }
+
+private:
+    uint8_t group_size_;
+    uint8_t next_group_size_;
+    uint16_t group_id_ = 0;
+    uint8_t index_ = 0;
+    bool parity_ready_ = false;
+    uint16_t parity_group_id_ = 0;
+    uint16_t length_parity_ = 0;
+    size_t parity_size_ = 0;
+    std::array<uint8_t, MAX_PAYLOAD_SIZE> parity_{};
+    FecStatistics statistics_;
+};
+
+/**
+ * Rebuilds lost packets from FecEncoder parity. Data packets are handed
+ * back as soon as they arrive, and a recovered packet as soon as the rest
+ * of its group and the parity have, so recovery adds no delay to packets
+ * that were not lost.
+ */
+class FecDecoder {
+public:
+    // Groups tracked at once; older ones are settled as recovered or lost
+    static constexpr size_t GROUP_WINDOW = 4;
+
+    /**
+     * Decodes one framed packet
+     * @param out Receives the arrived data packet and any recovered one;
+     *            they stay valid until the next call
+     * @return Number of packets written to out
+     */
+    size_t Decode(const uint8_t* data, size_t size, std::array<FecPacketView, 2>& out);
+
+    const FecStatistics& GetStatistics() const { return statistics_; }
+
+private:
+    struct Group {
+        bool active = false;
+        bool settled = false;  // Complete, or its loss already repaired
+        bool has_parity = false;
+        uint16_t group_id = 0;
+        uint8_t group_size = 0;
+        uint32_t received = 0; // Bitmap of data packets seen
+        uint8_t received_count = 0;
+        uint16_t length_parity = 0;
+        size_t parity_size = 0;
+        std::array<uint8_t, FecEncoder::MAX_PAYLOAD_SIZE> parity{};
+    };
+
+    Group* FindGroup(uint16_t group_id, uint8_t group_size);
+    void Retire(Group& group);
+    // Rebuilds the one missing packet once the parity and all others are in
+    bool TryRecover(Group& group, FecPacketView& out);
+
+    std::array<Group, GROUP_WINDOW> groups_{};
+    bool has_newest_ = false;
+    uint16_t newest_group_ = 0;
+    FecStatistics statistics_;
+};
+
+/**
+ * Opt-in forward error correction between a backend and its transports,
+ * with one encoder and one decoder per LDN node created on first use.
+ *
+ * Not thread-safe, but the encoding and decoding sides share no state, so
+ * the send path and the network thread may each use their side.
+ */
+class FecCodec {
+public:
+    static constexpr size_t MAX_FRAMED_SIZE = FecEncoder::MAX_FRAMED_SIZE;
+
+    explicit FecCodec(const FecConfig& config = FecConfig{});
+
+    // See FecEncoder
+    size_t Encode(uint8_t node_id, const uint8_t* data, size_t size, uint8_t* out);
+    size_t TakeParity(uint8_t node_id, uint8_t* out);
+    // See FecDecoder
+    size_t Decode(uint8_t node_id, const uint8_t* data, size_t size,
+                  std::array<FecPacketView, 2>& out);
+
+    // Forgets a node's streams in both directions, e.g. when it leaves
+    void ResetNode(uint8_t node_id);
+
+    // Regroups every encoder from its next group on; encoding side only
+    void SetGroupSize(uint8_t group_size);
+
+    const FecConfig& GetConfig() const { return config_; }
+    FecStatistics GetStatistics() const;
+    // The receive counts alone, safe on the decoding side's thread
+    FecStatistics GetDecodeStatistics() const;
+
+private:
+    FecConfig config_;
+    std::unordered_map<uint8_t, FecEncoder> encoders_;
+    std::unordered_map<uint8_t, FecDecoder> decoders_;
+};
+
+} // namespace Core::Multiplayer
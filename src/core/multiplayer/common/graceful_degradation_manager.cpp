@@ -2,8 +2,9 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "graceful_degradation_manager.h"
-#include <thread>
+#include "multiplayer_log.h"
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <atomic>
 
@@ -16,7 +17,9 @@ public:
         : config_(config), current_mode_(MultiplayerMode::Offline), 
           original_mode_(MultiplayerMode::Offline), state_(DegradationState::Normal),
           fallback_attempts_(0), is_degraded_(false), internet_backend_(nullptr),
-          adhoc_backend_(nullptr), listener_(nullptr), shutdown_requested_(false) {
+          adhoc_backend_(nullptr), listener_(nullptr),
+          switch_cost_ms_(config.initial_switch_cost_ms),
+          standby_tasks_(WorkStealingExecutor::GetShared()) {
         
         degradation_start_time_ = std::chrono::steady_clock::now();
         
@@ -75,25 +78,19 @@ public:
             }
         }
         
-        // Start health monitoring if enabled
-        if (config_.enable_auto_recovery) {
-            StartHealthMonitoring();
-        }
-        
         std::cout << "Graceful degradation manager initialized with mode: " 
                   << ModeToString(current_mode_) << std::endl;
         return ErrorCode::Success;
     }
 
     void Shutdown() {
+        // Health is driven by traffic reports; there is no monitor to stop,
+        // only a standby to let go of
         {
             std::lock_guard<std::mutex> lock(mutex_);
-            shutdown_requested_ = true;
-        }
-        
-        if (health_monitor_thread_.joinable()) {
-            health_monitor_thread_.join();
+            ReleaseStandbyLocked();
         }
+        standby_tasks_.Wait();
     }
 
     MultiplayerMode GetCurrentMode() const {
@@ -116,6 +113,10 @@ public:
         status.fallback_attempts = fallback_attempts_;
         status.is_degraded = is_degraded_;
         status.degradation_start_time = degradation_start_time_;
+        status.standby_mode = standby_mode_;
+        status.standby_ready = standby_ready_;
+        status.switch_cost = std::chrono::milliseconds(std::llround(switch_cost_ms_));
+        status.held_switches = held_switches_;
         
         auto now = std::chrono::steady_clock::now();
         status.time_in_degraded_state = 
@@ -203,14 +204,8 @@ public:
             return;
         }
         
-        // Attempt fallback to another mode
-        auto fallback_modes = GetSupportedFallbackModes(current_mode_);
-        for (auto fallback_mode : fallback_modes) {
-            if (IsBackendAvailableLocked(fallback_mode)) {
-                AttemptFallback(fallback_mode, error);
-                break;
-            }
-        }
+        // A timeout may be a blip worth riding out; the rest mean the path is gone
+        FallBackLocked(error, error.error_code == ErrorCode::NetworkTimeout);
     }
 
     ErrorCode AttemptRecovery(MultiplayerMode target_mode) {
@@ -221,7 +216,9 @@ public:
         }
         
         MultiplayerMode old_mode = current_mode_;
+        const bool warm = TakeStandbyLocked(target_mode);
         current_mode_ = target_mode;
+        NoteSwitchLocked(target_mode);
         
         // Check if we're recovering to the original mode
         if (target_mode == original_mode_) {
@@ -239,7 +236,7 @@ public:
         }
         
         std::cout << "Successfully recovered to " << ModeToString(target_mode) 
-                  << " mode" << std::endl;
+                  << " mode" << (warm ? " (warm standby)" : "") << std::endl;
         return ErrorCode::Success;
     }
 
@@ -288,6 +285,114 @@ public:
         return (it != health_metrics_.end()) ? it->second : HealthMetrics{};
     }
 
+    void ReportPacketLoss(MultiplayerMode mode, uint64_t recovered, uint64_t lost) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& metrics = health_metrics_[mode];
+        metrics.packets_recovered += recovered;
+        metrics.packets_lost += lost;
+    }
+
+    void ReportTrafficSample(MultiplayerMode mode, const TrafficSample& sample) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& metrics = health_metrics_[mode];
+        const double alpha = config_.health_ewma_alpha;
+        const bool first = metrics.traffic_samples == 0;
+        metrics.traffic_samples++;
+        metrics.last_sample_time = std::chrono::steady_clock::now();
+        
+        // The first traffic on a switch's target is what the switch cost
+        if (pending_switch_ && pending_switch_->mode == mode && sample.packets_received > 0) {
+            const double took_ms = std::chrono::duration<double, std::milli>(
+                                       metrics.last_sample_time - pending_switch_->started)
+                                       .count();
+            switch_cost_ms_ += config_.switch_cost_ewma_alpha * (took_ms - switch_cost_ms_);
+            pending_switch_.reset();
+        }
+        
+        if (sample.rtt) {
+            const double rtt_ms = sample.rtt->count() / 1000.0;
+            if (first || metrics.rtt_ewma_ms == 0.0) {
+                metrics.rtt_ewma_ms = rtt_ms;
+                metrics.rtt_deviation_ms = rtt_ms / 2.0;
+            } else {
+                // Judge the sample against the baseline before it moves it.
+                // Anomalies still pull the average, so a lasting shift
+                // becomes the new normal, but not the deviation, which
+                // would otherwise widen to excuse the next spike.
+                const double deviation = std::abs(rtt_ms - metrics.rtt_ewma_ms);
+                if (rtt_ms > metrics.rtt_ewma_ms &&
+                    deviation > config_.rtt_anomaly_deviations * metrics.rtt_deviation_ms) {
+                    metrics.rtt_anomalies++;
+                    rtt_anomaly_streaks_[mode]++;
+                } else {
+                    rtt_anomaly_streaks_[mode] = 0;
+                    metrics.rtt_deviation_ms += alpha * (deviation - metrics.rtt_deviation_ms);
+                }
+                metrics.rtt_ewma_ms += alpha * (rtt_ms - metrics.rtt_ewma_ms);
+            }
+        }
+        
+        const uint64_t expected = sample.packets_received + sample.packets_missing;
+        if (expected > 0) {
+            const double loss = static_cast<double>(sample.packets_missing) / expected;
+            metrics.loss_ewma = first ? loss : metrics.loss_ewma + alpha * (loss - metrics.loss_ewma);
+        }
+        
+        if (sample.send_queue_depth) {
+            const double depth = static_cast<double>(*sample.send_queue_depth);
+            metrics.send_queue_depth_ewma =
+                first ? depth
+                      : metrics.send_queue_depth_ewma + alpha * (depth - metrics.send_queue_depth_ewma);
+        }
+        
+        const BackendHealthStatus old_status = metrics.status;
+        metrics.status = JudgeHealth(mode, metrics);
+        const bool changed = metrics.status != old_status;
+        if (changed) {
+            MULTIPLAYER_LOG_INFO("{} backend health: {} -> {}", ModeToString(mode),
+                                 StatusToString(old_status), StatusToString(metrics.status));
+        }
+        
+        if (mode != current_mode_) {
+            return;
+        }
+        
+        // Ready the fallback while the current mode is only trending bad,
+        // and let it go again if the trend reverses
+        if (changed && metrics.status == BackendHealthStatus::Degraded) {
+            BeginStandbyLocked();
+        } else if (changed && metrics.status == BackendHealthStatus::Healthy) {
+            ReleaseStandbyLocked();
+        }
+        if (metrics.status != BackendHealthStatus::Unhealthy) {
+            switch_held_ = false;
+        }
+        
+        // Fail over on the sample that shows it instead of waiting for an
+        // error; a switch the cost model held back is weighed again on
+        // every sample while the mode stays unhealthy
+        if (metrics.status == BackendHealthStatus::Unhealthy && (changed || switch_held_) &&
+            config_.enable_auto_fallback && fallback_attempts_ < config_.max_fallback_attempts) {
+            ErrorInfo error;
+            error.category = ErrorCategory::NetworkConnectivity;
+            error.error_code = ErrorCode::ServiceUnavailable;
+            error.message = ModeToString(mode) + " backend traffic is unhealthy";
+            error.component = "GracefulDegradation";
+            error.timestamp = metrics.last_sample_time;
+            FallBackLocked(error, true);
+        }
+    }
+
+    void SetStandbyHandlers(StandbyHandlers handlers) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        standby_handlers_ = std::move(handlers);
+    }
+
+    void SetStandbyResourceProvider(std::function<StandbyResources()> provider) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        resource_provider_ = std::move(provider);
+    }
+
     bool IsServiceAvailable() const {
         std::lock_guard<std::mutex> lock(mutex_);
         return IsBackendAvailableLocked(current_mode_);
@@ -317,29 +422,222 @@ private:
             metrics.failed_health_checks = 0;
             metrics.average_response_time_ms = 0.0;
             metrics.last_check_time = std::chrono::steady_clock::now();
+            metrics.packets_recovered = 0;
+            metrics.packets_lost = 0;
             health_metrics_[mode] = metrics;
         }
     }
 
-    void StartHealthMonitoring() {
-        health_monitor_thread_ = std::thread([this]() {
-            while (true) {
-                {
-                    std::lock_guard<std::mutex> lock(mutex_);
-                    if (shutdown_requested_) {
-                        break;
-                    }
+    BackendHealthStatus JudgeHealth(MultiplayerMode mode, const HealthMetrics& metrics) const {
+        if (metrics.traffic_samples < config_.health_min_samples) {
+            return BackendHealthStatus::Unknown;
+        }
+        
+        auto streak = rtt_anomaly_streaks_.find(mode);
+        const bool anomalous = streak != rtt_anomaly_streaks_.end() &&
+                               streak->second >= config_.rtt_anomaly_trigger_count;
+        if (anomalous || metrics.rtt_ewma_ms >= config_.unhealthy_rtt_ms ||
+            metrics.loss_ewma >= config_.unhealthy_loss_ratio ||
+            metrics.send_queue_depth_ewma >= config_.unhealthy_send_queue_depth) {
+            return BackendHealthStatus::Unhealthy;
+        }
+        if (metrics.rtt_ewma_ms >= config_.degraded_rtt_ms ||
+            metrics.loss_ewma >= config_.degraded_loss_ratio ||
+            metrics.send_queue_depth_ewma >= config_.degraded_send_queue_depth) {
+            return BackendHealthStatus::Degraded;
+        }
+        return BackendHealthStatus::Healthy;
+    }
+
+    // Cuts over to the warm standby if it is ready, else falls back to the
+    // first available mode whose traffic is not known to be unhealthy.
+    // With weigh_cost the switch must also pass the cost model.
+    void FallBackLocked(const ErrorInfo& error, bool weigh_cost) {
+        std::optional<MultiplayerMode> target;
+        if (standby_mode_ && standby_ready_) {
+            // Already prepared, so known to be available
+            target = standby_mode_;
+        } else {
+            for (auto fallback_mode : GetSupportedFallbackModes(current_mode_)) {
+                auto health = health_metrics_.find(fallback_mode);
+                if (health != health_metrics_.end() &&
+                    health->second.status == BackendHealthStatus::Unhealthy) {
+                    continue;
+                }
+                if (IsBackendAvailableLocked(fallback_mode)) {
+                    target = fallback_mode;
+                    break;
                 }
-                
-                // Check health of all backends
-                CheckBackendHealth(MultiplayerMode::Internet);
-                CheckBackendHealth(MultiplayerMode::Adhoc);
-                
-                // Sleep for the configured interval
-                std::this_thread::sleep_for(
-                    std::chrono::milliseconds(config_.health_check_interval_ms));
             }
-        });
+        }
+        if (!target) {
+            return;
+        }
+        if (weigh_cost && ShouldHoldSwitchLocked(*target)) {
+            if (!switch_held_) {
+                held_switches_++;
+                MULTIPLAYER_LOG_INFO("Holding switch from {} to {}: not worth its cost yet",
+                                     ModeToString(current_mode_), ModeToString(*target));
+            }
+            switch_held_ = true;
+            return;
+        }
+        AttemptFallback(*target, error);
+    }
+
+    // Expected share of traffic a mode delivers, from its averages; empty
+    // until the mode has enough samples to be judged
+    std::optional<double> ExpectedQualityLocked(MultiplayerMode mode) const {
+        auto it = health_metrics_.find(mode);
+        if (it == health_metrics_.end() || it->second.status == BackendHealthStatus::Unknown) {
+            return std::nullopt;
+        }
+        const double scale = config_.quality_rtt_scale_ms;
+        const double delivered = 1.0 - std::clamp(it->second.loss_ewma, 0.0, 1.0);
+        return delivered * scale / (scale + it->second.rtt_ewma_ms);
+    }
+
+    // Offline is the last resort; only the dwell time holds it back
+    bool ShouldHoldSwitchLocked(MultiplayerMode target) const {
+        if (!config_.enable_switch_cost_model) {
+            return false;
+        }
+        if (last_switch_time_ && std::chrono::steady_clock::now() - *last_switch_time_ <
+                                     std::chrono::milliseconds(config_.min_dwell_ms)) {
+            return true;
+        }
+        if (target == MultiplayerMode::Offline) {
+            return false;
+        }
+        const auto current_quality = ExpectedQualityLocked(current_mode_);
+        const auto target_quality = ExpectedQualityLocked(target);
+        if (!current_quality || !target_quality) {
+            return false;
+        }
+        // Nothing is delivered while the switch is under way
+        const double horizon_ms = config_.switch_horizon_ms;
+        const double switched = *target_quality * std::max(horizon_ms - switch_cost_ms_, 0.0);
+        const double stayed = *current_quality * horizon_ms;
+        return switched <= stayed * (1.0 + config_.switch_hysteresis_ratio);
+    }
+
+    void NoteSwitchLocked(MultiplayerMode target) {
+        const auto now = std::chrono::steady_clock::now();
+        last_switch_time_ = now;
+        switch_held_ = false;
+        if (target == MultiplayerMode::Offline) {
+            pending_switch_.reset();
+        } else {
+            pending_switch_ = PendingSwitch{target, now};
+        }
+    }
+
+    bool IsStandbyAllowedLocked() const {
+        if (!config_.enable_warm_standby || !standby_handlers_.prepare) {
+            return false;
+        }
+        if (!resource_provider_) {
+            return true;
+        }
+        const StandbyResources resources = resource_provider_();
+        if (resources.free_memory_mb < config_.standby_min_free_memory_mb) {
+            return false;
+        }
+        if (resources.on_battery && (!config_.allow_standby_on_battery ||
+                                     resources.battery_percent < config_.standby_min_battery_percent)) {
+            return false;
+        }
+        return true;
+    }
+
+    // Prepares the first backed fallback mode whose traffic is not known to
+    // be unhealthy; Offline needs no warming
+    void BeginStandbyLocked() {
+        if (standby_mode_ || !IsStandbyAllowedLocked()) {
+            return;
+        }
+        for (auto mode : GetSupportedFallbackModes(current_mode_)) {
+            if (!GetBackendForMode(mode)) {
+                continue;
+            }
+            auto health = health_metrics_.find(mode);
+            if (health != health_metrics_.end() &&
+                health->second.status == BackendHealthStatus::Unhealthy) {
+                continue;
+            }
+            
+            standby_mode_ = mode;
+            standby_ready_ = false;
+            const uint64_t generation = ++standby_generation_;
+            if (state_ == DegradationState::Normal) {
+                state_ = DegradationState::WarmStandby;
+            }
+            MULTIPLAYER_LOG_INFO("Preparing {} as warm standby", ModeToString(mode));
+            
+            standby_tasks_.Submit([this, mode, generation, handlers = standby_handlers_]() {
+                const ErrorCode result = handlers.prepare(mode);
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (generation != standby_generation_) {
+                    // Released or cut over while preparing; a cutover keeps
+                    // the backend, a release is finished here
+                    if (result == ErrorCode::Success && current_mode_ != mode &&
+                        handlers.release) {
+                        standby_tasks_.Submit([handlers, mode]() { handlers.release(mode); });
+                    }
+                    return;
+                }
+                if (result == ErrorCode::Success) {
+                    standby_ready_ = true;
+                } else {
+                    standby_mode_.reset();
+                    RestoreStateAfterStandbyLocked();
+                }
+            });
+            return;
+        }
+    }
+
+    // Drops the standby and shuts its backend down, unless it is still
+    // preparing, in which case the prepare task does that when it finishes
+    void ReleaseStandbyLocked() {
+        if (!standby_mode_) {
+            return;
+        }
+        const MultiplayerMode mode = *standby_mode_;
+        const bool ready = standby_ready_;
+        standby_mode_.reset();
+        standby_ready_ = false;
+        ++standby_generation_;
+        RestoreStateAfterStandbyLocked();
+        
+        if (ready && standby_handlers_.release) {
+            standby_tasks_.Submit([release = standby_handlers_.release, mode]() { release(mode); });
+        }
+        MULTIPLAYER_LOG_INFO("Released {} warm standby", ModeToString(mode));
+    }
+
+    // Called when switching to target_mode; returns true if it was the
+    // ready standby. Any other standby is released.
+    bool TakeStandbyLocked(MultiplayerMode target_mode) {
+        if (!standby_mode_) {
+            return false;
+        }
+        if (*standby_mode_ != target_mode) {
+            ReleaseStandbyLocked();
+            return false;
+        }
+        const bool ready = standby_ready_;
+        standby_mode_.reset();
+        standby_ready_ = false;
+        ++standby_generation_;
+        RestoreStateAfterStandbyLocked();
+        return ready;
+    }
+
+    void RestoreStateAfterStandbyLocked() {
+        if (state_ == DegradationState::WarmStandby) {
+            state_ = DegradationState::Normal;
+        }
     }
 
     MockMultiplayerBackend* GetBackendForMode(MultiplayerMode mode) const {
@@ -370,11 +668,13 @@ private:
 
     void AttemptFallback(MultiplayerMode target_mode, const ErrorInfo& error) {
         MultiplayerMode old_mode = current_mode_;
+        const bool warm = TakeStandbyLocked(target_mode);
         current_mode_ = target_mode;
         state_ = DegradationState::Degraded;
         is_degraded_ = true;
         fallback_attempts_++;
         degradation_start_time_ = std::chrono::steady_clock::now();
+        NoteSwitchLocked(target_mode);
         
         if (listener_) {
             // For minimal implementation, just log the switch
@@ -384,8 +684,8 @@ private:
         }
         
         std::cout << "Fell back from " << ModeToString(old_mode) << " to " 
-                  << ModeToString(target_mode) << " due to error: " 
-                  << static_cast<int>(error.error_code) << std::endl;
+                  << ModeToString(target_mode) << (warm ? " (warm standby)" : "")
+                  << " due to error: " << static_cast<int>(error.error_code) << std::endl;
     }
 
     void UpdateResponseTimeMetrics(MultiplayerMode mode, double response_time_ms) {
@@ -400,6 +700,15 @@ private:
         }
     }
 
+    std::string StatusToString(BackendHealthStatus status) const {
+        switch (status) {
+            case BackendHealthStatus::Healthy: return "Healthy";
+            case BackendHealthStatus::Degraded: return "Degraded";
+            case BackendHealthStatus::Unhealthy: return "Unhealthy";
+            default: return "Unknown";
+        }
+    }
+
     std::string ModeToString(MultiplayerMode mode) const {
         switch (mode) {
             case MultiplayerMode::Internet: return "Internet";
@@ -423,8 +732,28 @@ private:
     MockModeSwitchListener* listener_;
     
     std::unordered_map<MultiplayerMode, HealthMetrics> health_metrics_;
-    std::thread health_monitor_thread_;
-    bool shutdown_requested_;
+    // Consecutive anomalous RTT samples per mode
+    std::unordered_map<MultiplayerMode, size_t> rtt_anomaly_streaks_;
+    
+    // Switch cost model; a switch is pending until its target carries traffic
+    struct PendingSwitch {
+        MultiplayerMode mode;
+        std::chrono::steady_clock::time_point started;
+    };
+    double switch_cost_ms_;
+    std::optional<std::chrono::steady_clock::time_point> last_switch_time_;
+    std::optional<PendingSwitch> pending_switch_;
+    bool switch_held_ = false;
+    size_t held_switches_ = 0;
+    
+    // Warm standby; the generation tells a finishing prepare task whether
+    // its standby is still wanted
+    StandbyHandlers standby_handlers_;
+    std::function<StandbyResources()> resource_provider_;
+    std::optional<MultiplayerMode> standby_mode_;
+    bool standby_ready_ = false;
+    uint64_t standby_generation_ = 0;
+    ExecutorTaskGroup standby_tasks_;
 };
 
 // GracefulDegradationManager implementation
@@ -485,6 +814,25 @@ HealthMetrics GracefulDegradationManager::GetHealthMetrics(MultiplayerMode mode)
     return impl_->GetHealthMetrics(mode);
 }
 
+void GracefulDegradationManager::ReportPacketLoss(MultiplayerMode mode, uint64_t recovered,
+                                                  uint64_t lost) {
+    impl_->ReportPacketLoss(mode, recovered, lost);
+}
+
+void GracefulDegradationManager::SetStandbyHandlers(StandbyHandlers handlers) {
+    impl_->SetStandbyHandlers(std::move(handlers));
+}
+
+void GracefulDegradationManager::SetStandbyResourceProvider(
+    std::function<StandbyResources()> provider) {
+    impl_->SetStandbyResourceProvider(std::move(provider));
+}
+
+void GracefulDegradationManager::ReportTrafficSample(MultiplayerMode mode,
+                                                     const TrafficSample& sample) {
+    impl_->ReportTrafficSample(mode, sample);
+}
+
 bool GracefulDegradationManager::IsServiceAvailable() const {
     return impl_->IsServiceAvailable();
 }
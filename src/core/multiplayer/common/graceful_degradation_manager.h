@@ -5,13 +5,16 @@
 
 #include <memory>
 #include <chrono>
+#include <cstdint>
 #include <functional>
 #include <mutex>
 #include <atomic>
+#include <optional>
 #include <vector>
 #include <string>
 
 #include "error_handling.h"
+#include "work_stealing_executor.h"
 
 namespace Core::Multiplayer {
 
@@ -45,7 +48,8 @@ enum class DegradationState {
     Normal,     // All backends operating normally
     Degraded,   // Operating on fallback backend
     Failed,     // All backends failed, offline mode
-    Recovering  // Attempting to recover to primary backend
+    Recovering, // Attempting to recover to primary backend
+    WarmStandby // Primary trending unhealthy; fallback backend being readied
 };
 
 /**
@@ -57,7 +61,67 @@ struct DegradationConfig {
     uint32_t fallback_timeout_ms = 10000;
     uint32_t recovery_check_interval_ms = 30000;
     size_t max_fallback_attempts = 2;
-    uint32_t health_check_interval_ms = 10000;
+    
+    // Passive health: each traffic sample moves an exponentially weighted
+    // moving average by this fraction of its distance from the sample
+    double health_ewma_alpha = 0.2;
+    // Samples a mode needs before its health is judged
+    size_t health_min_samples = 4;
+    // Thresholds on the averages; crossing an unhealthy one on the current
+    // mode falls back at once
+    double degraded_rtt_ms = 150.0;
+    double unhealthy_rtt_ms = 400.0;
+    double degraded_loss_ratio = 0.05;
+    double unhealthy_loss_ratio = 0.2;
+    double degraded_send_queue_depth = 64.0;
+    double unhealthy_send_queue_depth = 256.0;
+    // An RTT sample more than this many smoothed deviations above the
+    // average is an anomaly; this many in a row make the mode unhealthy
+    double rtt_anomaly_deviations = 4.0;
+    size_t rtt_anomaly_trigger_count = 3;
+    
+    // Warm standby: once the current mode's traffic turns Degraded, bring
+    // up its fallback backend in the background so failing over is only a
+    // cutover. Skipped when the device is short of memory or battery.
+    bool enable_warm_standby = true;
+    size_t standby_min_free_memory_mb = 256;
+    uint8_t standby_min_battery_percent = 30;
+    bool allow_standby_on_battery = true;
+    
+    // Switch cost model: a switch that traffic or a timeout asks for goes
+    // ahead only if the target's expected quality, over the horizon less
+    // the time a switch costs, beats staying put by the hysteresis ratio.
+    // The cost starts at the initial value and then tracks how long past
+    // switches took to carry traffic. Hard failures bypass the model.
+    bool enable_switch_cost_model = true;
+    uint32_t switch_horizon_ms = 60000;
+    uint32_t initial_switch_cost_ms = 3000;
+    double switch_cost_ewma_alpha = 0.3;
+    // No cost-weighed switch within this long of the previous one
+    uint32_t min_dwell_ms = 15000;
+    double switch_hysteresis_ratio = 0.2;
+    // Round trip at which a lossless mode's quality is halved
+    double quality_rtt_scale_ms = 100.0;
+};
+
+/**
+ * Device resources that decide whether a warm standby may run
+ */
+struct StandbyResources {
+    size_t free_memory_mb = SIZE_MAX;
+    bool on_battery = false;
+    uint8_t battery_percent = 100;
+};
+
+/**
+ * Hooks that ready and tear down a standby backend. Both run on the shared
+ * executor, never on the caller's thread or under the manager's lock.
+ */
+struct StandbyHandlers {
+    // Initialize the mode's backend and start discovery
+    std::function<ErrorCode(MultiplayerMode mode)> prepare;
+    // Shut down a standby that is no longer needed
+    std::function<void(MultiplayerMode mode)> release;
 };
 
 /**
@@ -71,6 +135,12 @@ struct DegradationStatus {
     bool is_degraded;
     std::chrono::steady_clock::time_point degradation_start_time;
     std::chrono::milliseconds time_in_degraded_state{0};
+    // Fallback backend kept warm, and whether it has finished preparing
+    std::optional<MultiplayerMode> standby_mode;
+    bool standby_ready = false;
+    // Current switch cost estimate, and switches the cost model held back
+    std::chrono::milliseconds switch_cost{0};
+    size_t held_switches = 0;
 };
 
 /**
@@ -82,6 +152,34 @@ struct HealthMetrics {
     size_t failed_health_checks;
     double average_response_time_ms;
     std::chrono::steady_clock::time_point last_check_time;
+    // Packets forward error correction rebuilt, and ones it could not
+    uint64_t packets_recovered;
+    uint64_t packets_lost;
+    
+    // Derived passively from ReportTrafficSample
+    BackendHealthStatus status = BackendHealthStatus::Unknown;
+    uint64_t traffic_samples = 0;
+    double rtt_ewma_ms = 0.0;
+    double rtt_deviation_ms = 0.0;
+    double loss_ewma = 0.0;
+    double send_queue_depth_ewma = 0.0;
+    uint64_t rtt_anomalies = 0;
+    std::chrono::steady_clock::time_point last_sample_time;
+};
+
+/**
+ * One observation from a backend's data path, taken from counters the
+ * transport already keeps. Fields that were not observed are left empty.
+ */
+struct TrafficSample {
+    // Latest round trip, e.g. RttEstimator::GetLatestRtt()
+    std::optional<std::chrono::microseconds> rtt;
+    // Packets the receive sequence window accepted and found missing since
+    // the previous sample
+    uint64_t packets_received = 0;
+    uint64_t packets_missing = 0;
+    // Current send queue depth
+    std::optional<size_t> send_queue_depth;
 };
 
 /**
@@ -93,7 +191,7 @@ struct HealthMetrics {
  * 
  * Key Features:
  * - Automatic fallback between multiplayer modes
- * - Health monitoring of backend services
+ * - Passive health monitoring from the backends' own traffic
  * - Automatic recovery when primary backends recover
  * - Service continuity during transitions
  * - User notification and progress feedback
@@ -114,6 +212,25 @@ struct HealthMetrics {
  *   // Error handling triggers automatic fallback
  *   auto error = CreateNetworkError(ErrorCode::NetworkTimeout, "Connection failed");
  *   manager->HandleError(error);
+ *   
+ *   // So does traffic that turns bad, as soon as a sample shows it
+ *   manager->ReportTrafficSample(MultiplayerMode::Internet, sample);
+ * 
+ * Health is not probed. The data path reports what it already measures
+ * (round trips, sequence-window loss, send queue depth); each report
+ * updates moving averages and is judged against the thresholds right away,
+ * so a backend going bad is acted on by the report that shows it.
+ * 
+ * A Degraded report on the current mode starts a warm standby: the
+ * fallback backend is prepared in the background, and the fallback that
+ * follows if traffic keeps getting worse cuts over to it. A Healthy report
+ * releases the standby again.
+ * 
+ * Switching is not free, so a switch asked for by traffic or a timeout is
+ * weighed first: each mode's expected quality comes from its averages, and
+ * the switch must pay back its measured cost within the configured horizon,
+ * clear a hysteresis band and respect a minimum dwell time. Modes without
+ * enough samples to judge, and hard failures, switch as before.
  */
 class GracefulDegradationManager {
 public:
@@ -142,6 +259,12 @@ public:
     // Health monitoring
     void CheckBackendHealth(MultiplayerMode mode);
     HealthMetrics GetHealthMetrics(MultiplayerMode mode) const;
+    void ReportPacketLoss(MultiplayerMode mode, uint64_t recovered, uint64_t lost);
+    void ReportTrafficSample(MultiplayerMode mode, const TrafficSample& sample);
+
+    // Warm standby
+    void SetStandbyHandlers(StandbyHandlers handlers);
+    void SetStandbyResourceProvider(std::function<StandbyResources()> provider);
 
     // Service availability
     bool IsServiceAvailable() const;
@@ -0,0 +1,225 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "ip_address_key.h"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+
+namespace Core::Multiplayer {
+
+namespace {
+std::optional<uint32_t> ParseIPv4(std::string_view text) {
+    uint8_t octets[4];
+    size_t pos = 0;
+    for (int i = 0; i < 4; ++i) {
+        if (i > 0) {
+            if (pos >= text.size() || text[pos] != '.') {
+                return std::nullopt;
+            }
+            ++pos;
+        }
+        size_t digits = 0;
+        unsigned value = 0;
+        while (pos < text.size() && digits < 3 && text[pos] >= '0' && text[pos] <= '9') {
+            value = value * 10 + static_cast<unsigned>(text[pos] - '0');
+            ++pos;
+            ++digits;
+        }
+        if (digits == 0 || value > 255) {
+            return std::nullopt;
+        }
+        octets[i] = static_cast<uint8_t>(value);
+    }
+    if (pos != text.size()) {
+        return std::nullopt;
+    }
+    uint32_t address;
+    std::memcpy(&address, octets, 4);
+    return address;
+}
+
+int HexValue(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+std::optional<IpAddressKey> ParseIPv6(std::string_view text) {
+    // Groups before and after "::", expanded with zeros in between
+    std::array<uint16_t, 8> head{};
+    std::array<uint16_t, 8> tail{};
+    size_t head_count = 0;
+    size_t tail_count = 0;
+    bool compressed = false;
+    bool embedded_ipv4 = false;
+
+    size_t pos = 0;
+    if (text.starts_with("::")) {
+        compressed = true;
+        pos = 2;
+    }
+    while (pos < text.size()) {
+        auto& groups = compressed ? tail : head;
+        auto& count = compressed ? tail_count : head_count;
+        if (head_count + tail_count >= 8) {
+            return std::nullopt;
+        }
+
+        const size_t end = std::min(text.find(':', pos), text.size());
+        const std::string_view group = text.substr(pos, end - pos);
+        if (end == text.size() && group.find('.') != std::string_view::npos) {
+            // Trailing dotted quad, as in ::ffff:192.0.2.1
+            const auto ipv4 = ParseIPv4(group);
+            if (!ipv4 || head_count + tail_count > 6) {
+                return std::nullopt;
+            }
+            uint8_t octets[4];
+            std::memcpy(octets, &*ipv4, 4);
+            groups[count++] = static_cast<uint16_t>(octets[0] << 8 | octets[1]);
+            groups[count++] = static_cast<uint16_t>(octets[2] << 8 | octets[3]);
+            embedded_ipv4 = true;
+            pos = end;
+            break;
+        }
+        if (group.empty() || group.size() > 4) {
+            return std::nullopt;
+        }
+        uint16_t value = 0;
+        for (const char c : group) {
+            const int digit = HexValue(c);
+            if (digit < 0) {
+                return std::nullopt;
+            }
+            value = static_cast<uint16_t>(value << 4 | digit);
+        }
+        groups[count++] = value;
+
+        pos = end;
+        if (pos == text.size()) {
+            break;
+        }
+        if (text.substr(pos, 2) == "::") {
+            if (compressed) {
+                return std::nullopt;
+            }
+            compressed = true;
+            pos += 2;
+        } else {
+            ++pos;
+            if (pos == text.size()) {
+                return std::nullopt; // trailing single colon
+            }
+        }
+    }
+    if (pos != text.size() && !embedded_ipv4) {
+        return std::nullopt;
+    }
+
+    const size_t total = head_count + tail_count;
+    if (compressed ? total > 7 : total != 8) {
+        return std::nullopt;
+    }
+    std::array<uint16_t, 8> groups{};
+    std::copy(head.begin(), head.begin() + head_count, groups.begin());
+    std::copy(tail.begin(), tail.begin() + tail_count, groups.end() - tail_count);
+
+    IpAddressKey key;
+    for (size_t i = 0; i < 8; ++i) {
+        key.bytes[i * 2] = static_cast<uint8_t>(groups[i] >> 8);
+        key.bytes[i * 2 + 1] = static_cast<uint8_t>(groups[i]);
+    }
+    return key;
+}
+} // namespace
+
+std::optional<IpAddressKey> IpAddressKey::Parse(std::string_view text) {
+    if (text.find(':') == std::string_view::npos) {
+        const auto ipv4 = ParseIPv4(text);
+        if (!ipv4) {
+            return std::nullopt;
+        }
+        return FromIPv4(*ipv4);
+    }
+    return ParseIPv6(text);
+}
+
+std::optional<std::pair<IpAddressKey, uint8_t>> IpAddressKey::ParsePrefix(std::string_view text) {
+    const size_t slash = text.find('/');
+    const auto key = Parse(text.substr(0, slash));
+    if (!key) {
+        return std::nullopt;
+    }
+    if (slash == std::string_view::npos) {
+        return std::make_pair(*key, BITS);
+    }
+
+    const std::string_view length_text = text.substr(slash + 1);
+    unsigned length = 0;
+    const auto [end, error] =
+        std::from_chars(length_text.data(), length_text.data() + length_text.size(), length);
+    const bool ipv4 = text.substr(0, slash).find(':') == std::string_view::npos;
+    if (error != std::errc{} || end != length_text.data() + length_text.size() ||
+        length > (ipv4 ? 32u : 128u)) {
+        return std::nullopt;
+    }
+    const uint8_t bits = static_cast<uint8_t>(ipv4 ? length + IPV4_MAPPED_PREFIX : length);
+    return std::make_pair(key->Masked(bits), bits);
+}
+
+IpAddressKey IpAddressKey::Masked(uint8_t length) const {
+    IpAddressKey masked;
+    const size_t whole = length / 8;
+    std::memcpy(masked.bytes.data(), bytes.data(), whole);
+    if (length % 8 != 0) {
+        masked.bytes[whole] = static_cast<uint8_t>(bytes[whole] & (0xFF00 >> (length % 8)));
+    }
+    return masked;
+}
+
+uint8_t IpAddressKey::CommonPrefixLength(const IpAddressKey& other) const {
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        const uint8_t diff = bytes[i] ^ other.bytes[i];
+        if (diff != 0) {
+            return static_cast<uint8_t>(i * 8 + std::countl_zero(diff));
+        }
+    }
+    return BITS;
+}
+
+std::string IpAddressKey::ToString() const {
+    if (IsIPv4()) {
+        return std::to_string(bytes[12]) + '.' + std::to_string(bytes[13]) + '.' +
+               std::to_string(bytes[14]) + '.' + std::to_string(bytes[15]);
+    }
+    // Full form without "::" compression, which is unambiguous for logs
+    static constexpr char HEX[] = "0123456789abcdef";
+    std::string text;
+    text.reserve(39);
+    for (size_t i = 0; i < 8; ++i) {
+        if (i > 0) {
+            text += ':';
+        }
+        const uint16_t group = static_cast<uint16_t>(bytes[i * 2] << 8 | bytes[i * 2 + 1]);
+        bool leading = true;
+        for (int shift = 12; shift >= 0; shift -= 4) {
+            const int digit = (group >> shift) & 0xF;
+            if (digit == 0 && leading && shift > 0) {
+                continue;
+            }
+            leading = false;
+            text += HEX[digit];
+        }
+    }
+    return text;
+}
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,83 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace Core::Multiplayer {
+
+/**
+ * An IPv4 or IPv6 address as 16 bytes in network order, for use as a table
+ * key. IPv4 addresses are stored IPv4-mapped (::ffff:a.b.c.d), so the two
+ * families share one key space and IPv4 prefixes are IPv6 prefixes 96 bits
+ * longer.
+ */
+struct IpAddressKey {
+    static constexpr uint8_t BITS = 128;
+    // Prefix length of ::ffff:0:0/96, which holds every IPv4 address
+    static constexpr uint8_t IPV4_MAPPED_PREFIX = 96;
+
+    std::array<uint8_t, 16> bytes{};
+
+    /**
+     * Parses a dotted quad or an RFC 4291 IPv6 address
+     * @return The key, or nothing if the text is not an address. Octets may
+     *         have leading zeros ("010"), as the former regex allowed.
+     */
+    static std::optional<IpAddressKey> Parse(std::string_view text);
+
+    /**
+     * Parses "address/length"; a bare address is a full-length prefix. IPv4
+     * lengths count from the start of the IPv4 address.
+     * @return The key and its prefix length in key bits (0-128)
+     */
+    static std::optional<std::pair<IpAddressKey, uint8_t>> ParsePrefix(std::string_view text);
+
+    // From four bytes in network order, as in sockaddr_in::sin_addr
+    static IpAddressKey FromIPv4(uint32_t network_order_address) {
+        IpAddressKey key;
+        key.bytes[10] = 0xFF;
+        key.bytes[11] = 0xFF;
+        std::memcpy(key.bytes.data() + 12, &network_order_address, 4);
+        return key;
+    }
+
+    bool IsIPv4() const {
+        static constexpr std::array<uint8_t, 12> MAPPED{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xFF, 0xFF};
+        return std::memcmp(bytes.data(), MAPPED.data(), MAPPED.size()) == 0;
+    }
+
+    // Bit i from the most significant end of the first byte
+    bool Bit(uint8_t i) const {
+        return (bytes[i / 8] >> (7 - i % 8)) & 1;
+    }
+
+    // The first `length` bits, the rest cleared
+    IpAddressKey Masked(uint8_t length) const;
+
+    // Number of leading bits shared with another key
+    uint8_t CommonPrefixLength(const IpAddressKey& other) const;
+
+    uint64_t Hash() const {
+        uint64_t high;
+        uint64_t low;
+        std::memcpy(&high, bytes.data(), 8);
+        std::memcpy(&low, bytes.data() + 8, 8);
+        // Mixed so the table's low bits depend on every address byte
+        uint64_t h = (high ^ (low * 0x9E3779B97F4A7C15ULL)) * 0xBF58476D1CE4E5B9ULL;
+        return h ^ (h >> 31);
+    }
+
+    std::string ToString() const;
+
+    bool operator==(const IpAddressKey& other) const = default;
+};
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,142 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "ip_address_key.h"
+
+namespace Core::Multiplayer {
+
+/**
+ * Flat open-addressing hash map from IpAddressKey to Value.
+ *
+ * Slots live in one array probed linearly, so a lookup is usually a single
+ * cache line and never allocates. Erase shifts later entries of the probe
+ * run back instead of leaving tombstones, which keeps lookups short however
+ * much churn the table sees. The table doubles when it is half full.
+ *
+ * Not thread-safe; the owner locks around it.
+ */
+template <typename Value>
+class IpAddressMap {
+public:
+    explicit IpAddressMap(size_t initial_capacity = 64) {
+        size_t capacity = 16;
+        while (capacity < initial_capacity) {
+            capacity <<= 1;
+        }
+        slots_.resize(capacity);
+    }
+
+    Value* Find(const IpAddressKey& key) {
+        const size_t index = Probe(key);
+        return slots_[index].used ? &slots_[index].value : nullptr;
+    }
+
+    const Value* Find(const IpAddressKey& key) const {
+        const size_t index = Probe(key);
+        return slots_[index].used ? &slots_[index].value : nullptr;
+    }
+
+    // The value for key, default-constructed if it was not present
+    Value& FindOrInsert(const IpAddressKey& key) {
+        if ((size_ + 1) * 2 > slots_.size()) {
+            Grow();
+        }
+        Slot& slot = slots_[Probe(key)];
+        if (!slot.used) {
+            slot.used = true;
+            slot.key = key;
+            slot.value = Value{};
+            ++size_;
+        }
+        return slot.value;
+    }
+
+    bool Erase(const IpAddressKey& key) {
+        const size_t index = Probe(key);
+        if (!slots_[index].used) {
+            return false;
+        }
+        EraseAt(index);
+        return true;
+    }
+
+    // Erases every entry for which predicate(key, value) is true
+    template <typename Predicate>
+    size_t EraseIf(Predicate&& predicate) {
+        size_t erased = 0;
+        for (size_t i = 0; i < slots_.size();) {
+            if (slots_[i].used && predicate(slots_[i].key, slots_[i].value)) {
+                // Shifting may move an unvisited entry into slot i, so look again
+                EraseAt(i);
+                ++erased;
+            } else {
+                ++i;
+            }
+        }
+        return erased;
+    }
+
+    size_t Size() const {
+        return size_;
+    }
+
+private:
+    struct Slot {
+        IpAddressKey key;
+        Value value{};
+        bool used = false;
+    };
+
+    size_t Mask() const {
+        return slots_.size() - 1;
+    }
+
+    // Slot holding key, or the empty slot where it would go
+    size_t Probe(const IpAddressKey& key) const {
+        size_t index = key.Hash() & Mask();
+        while (slots_[index].used && !(slots_[index].key == key)) {
+            index = (index + 1) & Mask();
+        }
+        return index;
+    }
+
+    void EraseAt(size_t hole) {
+        slots_[hole].used = false;
+        --size_;
+        // Pull back entries whose home slot is at or before the hole
+        for (size_t index = (hole + 1) & Mask(); slots_[index].used;
+             index = (index + 1) & Mask()) {
+            const size_t home = slots_[index].key.Hash() & Mask();
+            if (((index - home) & Mask()) >= ((index - hole) & Mask())) {
+                slots_[hole] = std::move(slots_[index]);
+                slots_[index].used = false;
+                hole = index;
+            }
+        }
+    }
+
+    void Grow() {
+        std::vector<Slot> old(slots_.size() * 2);
+        old.swap(slots_);
+        size_ = 0;
+        for (auto& slot : old) {
+            if (slot.used) {
+                Slot& target = slots_[Probe(slot.key)];
+                target = std::move(slot);
+                ++size_;
+            }
+        }
+    }
+
+    std::vector<Slot> slots_;
+    size_t size_ = 0;
+};
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,172 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ip_address_key.h"
+
+namespace Core::Multiplayer {
+
+/**
+ * Path-compressed binary radix trie mapping address prefixes (CIDR blocks)
+ * to values, e.g. bans.
+ *
+ * Each node holds the full prefix it stands for, so runs of single-child
+ * nodes are collapsed and a lookup visits at most one node per stored prefix
+ * on the path, not one per bit. Nodes live in one vector and link by index.
+ *
+ * Entries are removed in bulk with EraseIf, which rebuilds the trie; that
+ * suits sets that change rarely compared with how often they are queried.
+ *
+ * Not thread-safe; the owner locks around it.
+ */
+template <typename Value>
+class IpPrefixTrie {
+public:
+    IpPrefixTrie() {
+        Clear();
+    }
+
+    // Adds or replaces the value of key/length; bits past length are ignored
+    void Insert(const IpAddressKey& key, uint8_t length, Value value) {
+        const IpAddressKey prefix = key.Masked(length);
+        uint32_t index = 0;
+        while (true) {
+            if (nodes_[index].length == length) {
+                if (!nodes_[index].has_value) {
+                    ++size_;
+                }
+                nodes_[index].has_value = true;
+                nodes_[index].value = std::move(value);
+                return;
+            }
+
+            const bool bit = prefix.Bit(nodes_[index].length);
+            const uint32_t child = nodes_[index].children[bit];
+            if (child == NONE) {
+                nodes_[index].children[bit] = NewNode(prefix, length, std::move(value));
+                return;
+            }
+
+            const Node& next = nodes_[child];
+            const uint8_t common = std::min<uint8_t>(
+                {prefix.CommonPrefixLength(next.prefix), length, next.length});
+            if (common == next.length) {
+                index = child;
+                continue;
+            }
+
+            // The new prefix diverges inside the edge: split it
+            const bool next_bit = next.prefix.Bit(common);
+            uint32_t split;
+            if (common == length) {
+                split = NewNode(prefix, length, std::move(value));
+            } else {
+                split = NewNode(prefix.Masked(common), common);
+                nodes_[split].children[!next_bit] = NewNode(prefix, length, std::move(value));
+            }
+            nodes_[split].children[next_bit] = child;
+            nodes_[index].children[bit] = split;
+            return;
+        }
+    }
+
+    /**
+     * Visits the values of every stored prefix containing key, shortest first
+     * @return True as soon as predicate(value) returns true
+     */
+    template <typename Predicate>
+    bool AnyMatch(const IpAddressKey& key, Predicate&& predicate) const {
+        uint32_t index = 0;
+        while (true) {
+            const Node& node = nodes_[index];
+            if (node.length > 0 && key.CommonPrefixLength(node.prefix) < node.length) {
+                return false;
+            }
+            if (node.has_value && predicate(node.value)) {
+                return true;
+            }
+            if (node.length == IpAddressKey::BITS) {
+                return false;
+            }
+            index = node.children[key.Bit(node.length)];
+            if (index == NONE) {
+                return false;
+            }
+        }
+    }
+
+    // Removes every entry for which predicate(prefix, length, value) is true
+    template <typename Predicate>
+    size_t EraseIf(Predicate&& predicate) {
+        std::vector<uint32_t> kept;
+        for (uint32_t i = 0; i < nodes_.size(); ++i) {
+            const Node& node = nodes_[i];
+            if (node.has_value && !predicate(node.prefix, node.length, node.value)) {
+                kept.push_back(i);
+            }
+        }
+        const size_t erased = size_ - kept.size();
+        if (erased == 0) {
+            return 0;
+        }
+        std::vector<Node> old;
+        old.swap(nodes_);
+        Clear();
+        for (const uint32_t i : kept) {
+            Insert(old[i].prefix, old[i].length, std::move(old[i].value));
+        }
+        return erased;
+    }
+
+    void Clear() {
+        nodes_.clear();
+        nodes_.push_back(Node{});
+        size_ = 0;
+    }
+
+    size_t Size() const {
+        return size_;
+    }
+
+    bool Empty() const {
+        return size_ == 0;
+    }
+
+private:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    struct Node {
+        IpAddressKey prefix;
+        uint8_t length = 0;
+        bool has_value = false;
+        uint32_t children[2] = {NONE, NONE};
+        Value value{};
+    };
+
+    uint32_t NewNode(const IpAddressKey& prefix, uint8_t length) {
+        Node node;
+        node.prefix = prefix;
+        node.length = length;
+        nodes_.push_back(std::move(node));
+        return static_cast<uint32_t>(nodes_.size() - 1);
+    }
+
+    uint32_t NewNode(const IpAddressKey& prefix, uint8_t length, Value value) {
+        const uint32_t index = NewNode(prefix, length);
+        nodes_[index].has_value = true;
+        nodes_[index].value = std::move(value);
+        ++size_;
+        return index;
+    }
+
+    std::vector<Node> nodes_;
+    size_t size_ = 0;
+};
+
+} // namespace Core::Multiplayer
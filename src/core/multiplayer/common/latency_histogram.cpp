@@ -0,0 +1,87 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "latency_histogram.h"
+
+#include <utility>
+
+namespace Core::Multiplayer {
+
+LatencyHistogramSnapshot LatencyHistogram::Snapshot() const {
+    std::array<uint64_t, BUCKET_COUNT> merged{};
+    uint64_t sum = 0;
+    uint64_t min = std::numeric_limits<uint64_t>::max();
+    uint64_t max = 0;
+    for (const auto& stripe : stripes_) {
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            merged[i] += stripe.buckets[i].load(std::memory_order_relaxed);
+        }
+        sum += stripe.sum.load(std::memory_order_relaxed);
+        min = std::min(min, stripe.min.load(std::memory_order_relaxed));
+        max = std::max(max, stripe.max.load(std::memory_order_relaxed));
+    }
+
+    LatencyHistogramSnapshot snapshot;
+    for (const uint64_t count : merged) {
+        snapshot.count += count;
+    }
+    if (snapshot.count == 0) {
+        return snapshot;
+    }
+    snapshot.min_ns = std::min(min, max);
+    snapshot.max_ns = max;
+    snapshot.mean_ns = sum / snapshot.count;
+
+    // Walk the buckets once, filling each percentile as its rank is reached
+    const std::array<std::pair<double, uint64_t*>, 4> percentiles{{
+        {0.50, &snapshot.p50_ns},
+        {0.90, &snapshot.p90_ns},
+        {0.99, &snapshot.p99_ns},
+        {0.999, &snapshot.p999_ns},
+    }};
+    size_t next = 0;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT && next < percentiles.size(); ++i) {
+        seen += merged[i];
+        while (next < percentiles.size()) {
+            const auto rank = static_cast<uint64_t>(percentiles[next].first *
+                                                    static_cast<double>(snapshot.count - 1)) +
+                              1;
+            if (seen < rank) {
+                break;
+            }
+            // Keep sparse results inside the range actually recorded. A sample
+            // still being recorded may have bumped a bucket but not min yet.
+            *percentiles[next].second = std::min(std::max(LowerBound(i), min), max);
+            ++next;
+        }
+    }
+    return snapshot;
+}
+
+LatencyHistogramTotals LatencyHistogram::Collect(std::span<const uint64_t> upper_bounds_ns,
+                                                 std::span<uint64_t> cumulative) const {
+    std::array<uint64_t, BUCKET_COUNT> merged{};
+    LatencyHistogramTotals totals;
+    for (const auto& stripe : stripes_) {
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            merged[i] += stripe.buckets[i].load(std::memory_order_relaxed);
+        }
+        totals.sum_ns += stripe.sum.load(std::memory_order_relaxed);
+    }
+
+    size_t bound = 0;
+    const size_t bound_count = std::min(upper_bounds_ns.size(), cumulative.size());
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        while (bound < bound_count && LowerBound(i) > upper_bounds_ns[bound]) {
+            cumulative[bound++] = totals.count;
+        }
+        totals.count += merged[i];
+    }
+    while (bound < bound_count) {
+        cumulative[bound++] = totals.count;
+    }
+    return totals;
+}
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,207 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+#include "monotonic_clock.h"
+
+namespace Core::Multiplayer {
+
+/**
+ * Percentiles of a LatencyHistogram at the time it was read, in nanoseconds.
+ * Percentiles are the lower bound of the bucket holding them, so they read at
+ * most about 3% low.
+ */
+struct LatencyHistogramSnapshot {
+    uint64_t count = 0;
+    uint64_t min_ns = 0;
+    uint64_t mean_ns = 0;
+    uint64_t p50_ns = 0;
+    uint64_t p90_ns = 0;
+    uint64_t p99_ns = 0;
+    uint64_t p999_ns = 0;
+    uint64_t max_ns = 0;
+};
+
+/**
+ * Totals of a LatencyHistogram::Collect
+ */
+struct LatencyHistogramTotals {
+    uint64_t count = 0;
+    uint64_t sum_ns = 0;
+};
+
+/**
+ * A lock-free HDR latency histogram in nanoseconds.
+ *
+ * Values below 64 ns get a bucket each; above that every power of two is
+ * split into 32 buckets up to about 68 seconds, beyond which values are
+ * clamped into the last bucket. Like ShardedCounters, each thread records
+ * into its own cache-line aligned stripe and Snapshot() merges the stripes
+ * with relaxed loads, so recording on the data path never blocks and a
+ * snapshot may miss samples still in flight.
+ */
+class LatencyHistogram {
+public:
+    static constexpr size_t STRIPE_COUNT = 8;
+    static constexpr size_t LINEAR_BUCKETS = 64;
+    static constexpr size_t SUB_BUCKETS = 32;
+    static constexpr int MAX_EXPONENT = 36;
+    static constexpr size_t BUCKET_COUNT =
+        LINEAR_BUCKETS + static_cast<size_t>(MAX_EXPONENT - 6) * SUB_BUCKETS;
+
+    void Record(uint64_t ns) {
+        auto& stripe = stripes_[ThisThreadStripe()];
+        stripe.buckets[BucketFor(ns)].fetch_add(1, std::memory_order_relaxed);
+        stripe.sum.fetch_add(ns, std::memory_order_relaxed);
+        uint64_t max = stripe.max.load(std::memory_order_relaxed);
+        while (ns > max && !stripe.max.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {
+        }
+        uint64_t min = stripe.min.load(std::memory_order_relaxed);
+        while (ns < min && !stripe.min.compare_exchange_weak(min, ns, std::memory_order_relaxed)) {
+        }
+    }
+
+    void Record(std::chrono::nanoseconds latency) {
+        Record(static_cast<uint64_t>(std::max<int64_t>(latency.count(), 0)));
+    }
+
+    LatencyHistogramSnapshot Snapshot() const;
+
+    /**
+     * Cumulative counts for exporting as a fixed-bucket histogram, e.g. to
+     * Prometheus: cumulative[i] counts the samples whose bucket starts at or
+     * below upper_bounds_ns[i], so it is exact to within a bucket width.
+     * @param upper_bounds_ns Ascending; cumulative has as many entries
+     */
+    LatencyHistogramTotals Collect(std::span<const uint64_t> upper_bounds_ns,
+                                   std::span<uint64_t> cumulative) const;
+
+    static constexpr size_t BucketFor(uint64_t ns) {
+        if (ns < LINEAR_BUCKETS) {
+            return static_cast<size_t>(ns);
+        }
+        const int exponent = std::min(63 - std::countl_zero(ns), MAX_EXPONENT - 1);
+        const uint64_t clamped = std::min<uint64_t>(ns, (uint64_t{1} << (exponent + 1)) - 1);
+        const size_t sub = static_cast<size_t>(clamped >> (exponent - 5)) & (SUB_BUCKETS - 1);
+        return LINEAR_BUCKETS + static_cast<size_t>(exponent - 6) * SUB_BUCKETS + sub;
+    }
+
+    static constexpr uint64_t LowerBound(size_t bucket) {
+        if (bucket < LINEAR_BUCKETS) {
+            return bucket;
+        }
+        const size_t group = (bucket - LINEAR_BUCKETS) / SUB_BUCKETS;
+        const size_t sub = (bucket - LINEAR_BUCKETS) % SUB_BUCKETS;
+        return static_cast<uint64_t>(SUB_BUCKETS + sub) << (group + 1);
+    }
+
+private:
+    struct alignas(64) Stripe {
+        std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets{};
+        std::atomic<uint64_t> sum{0};
+        std::atomic<uint64_t> min{std::numeric_limits<uint64_t>::max()};
+        std::atomic<uint64_t> max{0};
+    };
+
+    static size_t ThisThreadStripe() {
+        static std::atomic<size_t> next_stripe{0};
+        thread_local const size_t stripe =
+            next_stripe.fetch_add(1, std::memory_order_relaxed) % STRIPE_COUNT;
+        return stripe;
+    }
+
+    std::array<Stripe, STRIPE_COUNT> stripes_{};
+};
+
+/**
+ * The hops of the backend data path that carry a latency histogram.
+ */
+enum class DataPathHop : size_t {
+    BridgeEntry,    // LdnServiceBridge send call, from entry to return
+    BackendEnqueue, // Backend send, from entry to handing the frame to the transport
+    TransportWrite, // Transport send call for one frame
+    TransportRead,  // Inbound frame from the transport to the receive queue
+    ReceiveDequeue, // Time a received packet waited in the receive queue
+    Count
+};
+
+constexpr size_t DATA_PATH_HOP_COUNT = static_cast<size_t>(DataPathHop::Count);
+
+/**
+ * Per-hop latency snapshots returned by MultiplayerBackend::GetStatistics.
+ */
+struct DataPathStatistics {
+    std::array<LatencyHistogramSnapshot, DATA_PATH_HOP_COUNT> hops{};
+
+    const LatencyHistogramSnapshot& operator[](DataPathHop hop) const {
+        return hops[static_cast<size_t>(hop)];
+    }
+};
+
+/**
+ * One LatencyHistogram per data path hop, owned by a backend.
+ */
+class DataPathLatency {
+public:
+    static uint64_t Now() {
+        return MonotonicClock::Now();
+    }
+
+    void Record(DataPathHop hop, uint64_t ns) {
+        histograms_[static_cast<size_t>(hop)].Record(ns);
+    }
+
+    // Records the time elapsed since start, a value returned by Now()
+    void RecordSince(DataPathHop hop, uint64_t start) {
+        const uint64_t now = Now();
+        Record(hop, now > start ? now - start : 0);
+    }
+
+    DataPathStatistics Snapshot() const {
+        DataPathStatistics statistics;
+        for (size_t i = 0; i < DATA_PATH_HOP_COUNT; ++i) {
+            statistics.hops[i] = histograms_[i].Snapshot();
+        }
+        return statistics;
+    }
+
+private:
+    std::array<LatencyHistogram, DATA_PATH_HOP_COUNT> histograms_{};
+};
+
+/**
+ * Stands in for DataPathLatency when instrumentation is compiled out, see
+ * build_policy.h. Now() does not read the clock, so timing a hop costs nothing.
+ */
+class NullDataPathLatency {
+public:
+    static uint64_t Now() {
+        return 0;
+    }
+    void Record(DataPathHop, uint64_t) {}
+    void RecordSince(DataPathHop, uint64_t) {}
+    DataPathStatistics Snapshot() const {
+        return {};
+    }
+};
+
+// For MultiplayerBackend::GetDataPathLatency; null for the stand-in
+inline DataPathLatency* GetRecordableLatency(DataPathLatency& latency) {
+    return &latency;
+}
+inline DataPathLatency* GetRecordableLatency(NullDataPathLatency&) {
+    return nullptr;
+}
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,115 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "liveness_tracker.h"
+
+#include <algorithm>
+
+namespace Core::Multiplayer {
+
+LivenessTracker::LivenessTracker(const LivenessConfig& config)
+    : config_(config), last_sent_ms_(ToMilliseconds(Clock::now())),
+      last_received_ms_(last_sent_ms_.load()) {
+    config_.min_interval = std::max(config_.min_interval, std::chrono::milliseconds(1));
+    config_.max_interval = std::max(config_.max_interval, config_.min_interval);
+    const auto initial =
+        std::clamp(config_.initial_interval, config_.min_interval, config_.max_interval);
+    interval_ms_.store(initial.count(), std::memory_order_relaxed);
+    ceiling_ms_.store(config_.max_interval.count(), std::memory_order_relaxed);
+}
+
+void LivenessTracker::OnSent(Clock::time_point now) {
+    last_sent_ms_.store(ToMilliseconds(now), std::memory_order_relaxed);
+}
+
+void LivenessTracker::OnReceived(Clock::time_point now) {
+    last_received_ms_.store(ToMilliseconds(now), std::memory_order_relaxed);
+
+    const int64_t idle_ms = probe_idle_ms_.exchange(0, std::memory_order_acq_rel);
+    if (idle_ms == 0) {
+        return;
+    }
+    probe_sent_ms_.store(0, std::memory_order_relaxed);
+
+    // The binding outlived idle_ms, so a step past it is worth trying
+    const int64_t ceiling = ceiling_ms_.load(std::memory_order_relaxed);
+    const int64_t target = std::min(idle_ms + config_.probe_step.count(), ceiling);
+    int64_t interval = interval_ms_.load(std::memory_order_relaxed);
+    while (interval < target &&
+           !interval_ms_.compare_exchange_weak(interval, target, std::memory_order_relaxed)) {
+    }
+}
+
+std::chrono::milliseconds LivenessTracker::TimeUntilKeepalive(Clock::time_point now) const {
+    const int64_t due = last_sent_ms_.load(std::memory_order_relaxed) +
+                        interval_ms_.load(std::memory_order_relaxed);
+    return std::chrono::milliseconds(std::max<int64_t>(due - ToMilliseconds(now), 0));
+}
+
+void LivenessTracker::OnKeepaliveSent(Clock::time_point now) {
+    const int64_t now_ms = ToMilliseconds(now);
+    const int64_t last_activity = std::max(last_sent_ms_.load(std::memory_order_relaxed),
+                                           last_received_ms_.load(std::memory_order_relaxed));
+    last_sent_ms_.store(now_ms, std::memory_order_relaxed);
+    keepalives_sent_.fetch_add(1, std::memory_order_relaxed);
+
+    // A probe still outstanding keeps the longer idle period it measures
+    if (probe_idle_ms_.load(std::memory_order_acquire) == 0) {
+        probe_sent_ms_.store(now_ms, std::memory_order_relaxed);
+        probe_idle_ms_.store(std::max<int64_t>(now_ms - last_activity, 1),
+                             std::memory_order_release);
+    }
+}
+
+bool LivenessTracker::HasOutstandingProbe() const {
+    return probe_idle_ms_.load(std::memory_order_acquire) != 0;
+}
+
+std::chrono::milliseconds LivenessTracker::GetProbeAge(Clock::time_point now) const {
+    const int64_t sent_ms = probe_sent_ms_.load(std::memory_order_relaxed);
+    if (!HasOutstandingProbe() || sent_ms == 0) {
+        return std::chrono::milliseconds::zero();
+    }
+    return std::chrono::milliseconds(std::max<int64_t>(ToMilliseconds(now) - sent_ms, 0));
+}
+
+void LivenessTracker::OnBindingLost() {
+    const int64_t idle_ms = probe_idle_ms_.exchange(0, std::memory_order_acq_rel);
+    if (idle_ms == 0) {
+        return;
+    }
+    probe_sent_ms_.store(0, std::memory_order_relaxed);
+
+    const int64_t limit = std::max<int64_t>(static_cast<int64_t>(idle_ms * config_.safety_margin),
+                                            config_.min_interval.count());
+    int64_t ceiling = ceiling_ms_.load(std::memory_order_relaxed);
+    while (limit < ceiling &&
+           !ceiling_ms_.compare_exchange_weak(ceiling, limit, std::memory_order_relaxed)) {
+    }
+    int64_t interval = interval_ms_.load(std::memory_order_relaxed);
+    while (limit < interval &&
+           !interval_ms_.compare_exchange_weak(interval, limit, std::memory_order_relaxed)) {
+    }
+}
+
+std::chrono::milliseconds LivenessTracker::GetKeepaliveInterval() const {
+    return std::chrono::milliseconds(interval_ms_.load(std::memory_order_relaxed));
+}
+
+std::chrono::milliseconds LivenessTracker::GetIntervalCeiling() const {
+    return std::chrono::milliseconds(ceiling_ms_.load(std::memory_order_relaxed));
+}
+
+void LivenessTracker::Reset(Clock::time_point now) {
+    const int64_t now_ms = ToMilliseconds(now);
+    last_sent_ms_.store(now_ms, std::memory_order_relaxed);
+    last_received_ms_.store(now_ms, std::memory_order_relaxed);
+    probe_idle_ms_.store(0, std::memory_order_release);
+    probe_sent_ms_.store(0, std::memory_order_relaxed);
+}
+
+int64_t LivenessTracker::ToMilliseconds(Clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
+}
+
+} // namespace Core::Multiplayer
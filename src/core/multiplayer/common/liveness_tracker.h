@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace Core::Multiplayer {
+
+/**
+ * Limits for the idle keepalive interval of a LivenessTracker
+ */
+struct LivenessConfig {
+    std::chrono::milliseconds initial_interval{15000};
+    std::chrono::milliseconds min_interval{5000};
+    std::chrono::milliseconds max_interval{60000};
+    // An answered probe lets the interval grow to its idle period plus this
+    std::chrono::milliseconds probe_step{5000};
+    // Fraction of an idle period that killed the binding kept as the new limit
+    double safety_margin = 0.8;
+};
+
+/**
+ * Traffic-driven liveness for a connection.
+ *
+ * Every frame sent refreshes both the peer's view of us and any NAT binding
+ * on the path, so a keepalive is only due once nothing at all has been sent
+ * for a whole interval; while application traffic flows none are sent.
+ *
+ * The interval adapts to the binding timeout of the path. Each keepalive is
+ * a probe of the idle period before it: when anything comes back the
+ * binding survived that long, and the interval may grow to that period plus
+ * probe_step, up to max_interval. When the probe goes unanswered or the
+ * connection drops instead, the binding timed out within that period, so
+ * the interval and its ceiling drop to safety_margin of it and never grow
+ * past it again.
+ *
+ * Recording traffic is a relaxed atomic store; only probe outcomes do more.
+ */
+class LivenessTracker {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit LivenessTracker(const LivenessConfig& config = {});
+
+    LivenessTracker(const LivenessTracker&) = delete;
+    LivenessTracker& operator=(const LivenessTracker&) = delete;
+
+    void OnSent(Clock::time_point now = Clock::now());
+    // Also confirms an outstanding probe
+    void OnReceived(Clock::time_point now = Clock::now());
+
+    /**
+     * Time left until a keepalive is due
+     * @return Zero once nothing has been sent for a whole interval
+     */
+    std::chrono::milliseconds TimeUntilKeepalive(Clock::time_point now = Clock::now()) const;
+
+    // Records a keepalive as the outstanding probe
+    void OnKeepaliveSent(Clock::time_point now = Clock::now());
+
+    bool HasOutstandingProbe() const;
+    // Time since the outstanding probe was sent; zero without one
+    std::chrono::milliseconds GetProbeAge(Clock::time_point now = Clock::now()) const;
+
+    /**
+     * The outstanding probe went unanswered or the connection dropped. Only
+     * lowers the interval when a probe was outstanding; losses while traffic
+     * was flowing say nothing about the binding timeout.
+     */
+    void OnBindingLost();
+
+    std::chrono::milliseconds GetKeepaliveInterval() const;
+    // Largest interval the path has not been shown to break at
+    std::chrono::milliseconds GetIntervalCeiling() const;
+    uint64_t GetKeepaliveCount() const { return keepalives_sent_.load(std::memory_order_relaxed); }
+
+    // Starts a new connection; the learned interval is kept
+    void Reset(Clock::time_point now = Clock::now());
+
+private:
+    static int64_t ToMilliseconds(Clock::time_point time);
+
+    LivenessConfig config_;
+    std::atomic<int64_t> last_sent_ms_;
+    std::atomic<int64_t> last_received_ms_;
+    std::atomic<int64_t> interval_ms_;
+    std::atomic<int64_t> ceiling_ms_;
+    // Idle period the outstanding probe followed, and when it was sent; 0 without one
+    std::atomic<int64_t> probe_idle_ms_{0};
+    std::atomic<int64_t> probe_sent_ms_{0};
+    std::atomic<uint64_t> keepalives_sent_{0};
+};
+
+} // namespace Core::Multiplayer
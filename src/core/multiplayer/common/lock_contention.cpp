@@ -0,0 +1,75 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "lock_contention.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace Core::Multiplayer {
+
+namespace {
+
+constexpr size_t SITE_COUNT = static_cast<size_t>(LockSite::Count);
+
+// One line per site, so waiters on different sites do not share counters
+struct alignas(64) SiteCounters {
+    std::atomic<uint64_t> contended{0};
+    std::atomic<uint64_t> wait_ns{0};
+};
+
+std::array<SiteCounters, SITE_COUNT>& Counters() {
+    static std::array<SiteCounters, SITE_COUNT> counters;
+    return counters;
+}
+
+} // namespace
+
+const char* GetLockSiteName(LockSite site) {
+    switch (site) {
+    case LockSite::RoomClientConnection:
+        return "room_client_connection";
+    case LockSite::RoomClientCallbacks:
+        return "room_client_callbacks";
+    case LockSite::RateLimiterShard:
+        return "rate_limiter_shard";
+    case LockSite::P2PState:
+        return "p2p_state";
+    case LockSite::P2PPeerWrite:
+        return "p2p_peer_write";
+    case LockSite::P2PPeerSendQueue:
+        return "p2p_peer_send_queue";
+    case LockSite::LdnServiceControl:
+        return "ldn_service_control";
+    case LockSite::LdnServiceData:
+        return "ldn_service_data";
+    case LockSite::Count:
+        break;
+    }
+    return "unknown";
+}
+
+void RecordLockWait(LockSite site, std::chrono::nanoseconds wait) {
+    auto& counters = Counters()[static_cast<size_t>(site)];
+    counters.contended.fetch_add(1, std::memory_order_relaxed);
+    counters.wait_ns.fetch_add(static_cast<uint64_t>(std::max<int64_t>(wait.count(), 0)),
+                               std::memory_order_relaxed);
+}
+
+LockContentionStatistics GetLockContentionStatistics() {
+    LockContentionStatistics statistics;
+    for (size_t i = 0; i < SITE_COUNT; ++i) {
+        statistics.sites[i].contended = Counters()[i].contended.load(std::memory_order_relaxed);
+        statistics.sites[i].wait_ns = Counters()[i].wait_ns.load(std::memory_order_relaxed);
+    }
+    return statistics;
+}
+
+void ResetLockContentionStatistics() {
+    for (auto& counters : Counters()) {
+        counters.contended.store(0, std::memory_order_relaxed);
+        counters.wait_ns.store(0, std::memory_order_relaxed);
+    }
+}
+
+} // namespace Core::Multiplayer
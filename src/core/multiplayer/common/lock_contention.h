@@ -0,0 +1,114 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace Core::Multiplayer {
+
+/**
+ * Locks on hot paths whose contention is accounted separately
+ */
+enum class LockSite : uint8_t {
+    RoomClientConnection, // RoomClient connection handle
+    RoomClientCallbacks,  // RoomClient callback registration
+    RateLimiterShard,     // ClientRateManager shards
+    P2PState,             // Libp2pP2PNetwork peer table writers
+    P2PPeerWrite,         // Libp2pP2PNetwork per-peer stream writes
+    P2PPeerSendQueue,     // Libp2pP2PNetwork per-peer send queues
+    LdnServiceControl,    // LdnServiceBridge control operations
+    LdnServiceData,       // LdnServiceBridge packet send and receive
+    Count,
+};
+
+const char* GetLockSiteName(LockSite site);
+
+/**
+ * Contention on one lock site, summed over every mutex of that site
+ */
+struct LockSiteStats {
+    // Acquisitions that found the lock held and had to wait
+    uint64_t contended = 0;
+    uint64_t wait_ns = 0;
+};
+
+struct LockContentionStatistics {
+    std::array<LockSiteStats, static_cast<size_t>(LockSite::Count)> sites{};
+
+    LockSiteStats& operator[](LockSite site) {
+        return sites[static_cast<size_t>(site)];
+    }
+    const LockSiteStats& operator[](LockSite site) const {
+        return sites[static_cast<size_t>(site)];
+    }
+};
+
+void RecordLockWait(LockSite site, std::chrono::nanoseconds wait);
+LockContentionStatistics GetLockContentionStatistics();
+void ResetLockContentionStatistics();
+
+/**
+ * Drop-in mutex that accounts the time callers wait for it to its site.
+ *
+ * Every acquisition tries the lock first, so an uncontended one costs the
+ * same as the plain mutex. Only an acquisition that has to block reads the
+ * clock and adds to the site's counters. Shared locking is available when
+ * the wrapped mutex has it.
+ */
+template <LockSite Site, typename Mutex = std::mutex>
+class ProfiledMutex {
+public:
+    ProfiledMutex() = default;
+    ProfiledMutex(const ProfiledMutex&) = delete;
+    ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+    void lock() {
+        if (mutex_.try_lock()) {
+            return;
+        }
+        const auto start = std::chrono::steady_clock::now();
+        mutex_.lock();
+        RecordLockWait(Site, std::chrono::steady_clock::now() - start);
+    }
+
+    bool try_lock() {
+        return mutex_.try_lock();
+    }
+
+    void unlock() {
+        mutex_.unlock();
+    }
+
+    void lock_shared()
+        requires requires(Mutex& mutex) { mutex.lock_shared(); }
+    {
+        if (mutex_.try_lock_shared()) {
+            return;
+        }
+        const auto start = std::chrono::steady_clock::now();
+        mutex_.lock_shared();
+        RecordLockWait(Site, std::chrono::steady_clock::now() - start);
+    }
+
+    bool try_lock_shared()
+        requires requires(Mutex& mutex) { mutex.try_lock_shared(); }
+    {
+        return mutex_.try_lock_shared();
+    }
+
+    void unlock_shared()
+        requires requires(Mutex& mutex) { mutex.unlock_shared(); }
+    {
+        mutex_.unlock_shared();
+    }
+
+private:
+    Mutex mutex_;
+};
+
+} // namespace Core::Multiplayer
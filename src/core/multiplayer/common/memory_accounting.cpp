@@ -0,0 +1,98 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "memory_accounting.h"
+
+namespace Core::Multiplayer {
+
+namespace {
+
+constexpr size_t SUBSYSTEM_COUNT = static_cast<size_t>(MemorySubsystem::Count);
+
+std::array<TrackedMemoryResource, SUBSYSTEM_COUNT>& Resources() {
+    // Never destroyed, so tables in other statics can release into it at exit
+    static auto* const resources = new std::array<TrackedMemoryResource, SUBSYSTEM_COUNT>();
+    return *resources;
+}
+
+} // namespace
+
+const char* GetMemorySubsystemName(MemorySubsystem subsystem) {
+    switch (subsystem) {
+    case MemorySubsystem::RoomClient:
+        return "room_client";
+    case MemorySubsystem::P2P:
+        return "p2p";
+    case MemorySubsystem::Relay:
+        return "relay";
+    case MemorySubsystem::Mdns:
+        return "mdns";
+    case MemorySubsystem::SecurityTables:
+        return "security_tables";
+    case MemorySubsystem::PacketPool:
+        return "packet_pool";
+    case MemorySubsystem::Count:
+        break;
+    }
+    return "unknown";
+}
+
+uint64_t MemoryStatistics::TotalLiveBytes() const {
+    uint64_t total = 0;
+    for (const auto& subsystem : subsystems) {
+        total += subsystem.live_bytes;
+    }
+    return total;
+}
+
+SubsystemMemoryStats TrackedMemoryResource::GetStatistics() const {
+    SubsystemMemoryStats stats;
+    stats.live_bytes = live_bytes_.load(std::memory_order_relaxed);
+    stats.high_water_bytes = high_water_bytes_.load(std::memory_order_relaxed);
+    stats.live_allocations = live_allocations_.load(std::memory_order_relaxed);
+    stats.total_allocations = total_allocations_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void TrackedMemoryResource::ResetHighWater() {
+    high_water_bytes_.store(live_bytes_.load(std::memory_order_relaxed),
+                            std::memory_order_relaxed);
+}
+
+void* TrackedMemoryResource::do_allocate(size_t bytes, size_t alignment) {
+    void* const pointer = upstream_->allocate(bytes, alignment);
+    const uint64_t live = live_bytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    uint64_t high_water = high_water_bytes_.load(std::memory_order_relaxed);
+    while (live > high_water &&
+           !high_water_bytes_.compare_exchange_weak(high_water, live, std::memory_order_relaxed)) {
+    }
+    live_allocations_.fetch_add(1, std::memory_order_relaxed);
+    total_allocations_.fetch_add(1, std::memory_order_relaxed);
+    return pointer;
+}
+
+void TrackedMemoryResource::do_deallocate(void* pointer, size_t bytes, size_t alignment) {
+    upstream_->deallocate(pointer, bytes, alignment);
+    live_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+    live_allocations_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+TrackedMemoryResource* GetMemoryResource(MemorySubsystem subsystem) {
+    return &Resources()[static_cast<size_t>(subsystem)];
+}
+
+MemoryStatistics GetMemoryStatistics() {
+    MemoryStatistics stats;
+    for (size_t i = 0; i < SUBSYSTEM_COUNT; ++i) {
+        stats.subsystems[i] = Resources()[i].GetStatistics();
+    }
+    return stats;
+}
+
+void ResetMemoryHighWater() {
+    for (auto& resource : Resources()) {
+        resource.ResetHighWater();
+    }
+}
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+namespace Core::Multiplayer {
+
+/**
+ * Parts of the multiplayer stack whose heap use is accounted separately
+ */
+enum class MemorySubsystem : uint8_t {
+    RoomClient,     // Room list index
+    P2P,            // Peer address book
+    Relay,          // Relay sessions
+    Mdns,           // Discovered service cache
+    SecurityTables, // Per-client rate limits
+    PacketPool,     // Packet buffer slabs
+    Count,
+};
+
+const char* GetMemorySubsystemName(MemorySubsystem subsystem);
+
+/**
+ * Heap use of one subsystem
+ */
+struct SubsystemMemoryStats {
+    uint64_t live_bytes = 0;
+    uint64_t high_water_bytes = 0; // Since start or the last ResetMemoryHighWater()
+    uint64_t live_allocations = 0;
+    uint64_t total_allocations = 0;
+};
+
+/**
+ * Heap use of every subsystem, filled by GetMemoryStatistics
+ */
+struct MemoryStatistics {
+    std::array<SubsystemMemoryStats, static_cast<size_t>(MemorySubsystem::Count)> subsystems{};
+
+    SubsystemMemoryStats& operator[](MemorySubsystem subsystem) {
+        return subsystems[static_cast<size_t>(subsystem)];
+    }
+    const SubsystemMemoryStats& operator[](MemorySubsystem subsystem) const {
+        return subsystems[static_cast<size_t>(subsystem)];
+    }
+
+    uint64_t TotalLiveBytes() const;
+};
+
+/**
+ * Memory resource that counts what passes through it to an upstream
+ * resource.
+ *
+ * Containers a subsystem owns take its resource, so the bytes a room, peer
+ * or discovered service really costs are measured instead of estimated. The
+ * counters are relaxed atomics; the tables using them allocate per entry,
+ * not per packet.
+ */
+class TrackedMemoryResource final : public std::pmr::memory_resource {
+public:
+    explicit TrackedMemoryResource(
+        std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream_(upstream) {}
+
+    TrackedMemoryResource(const TrackedMemoryResource&) = delete;
+    TrackedMemoryResource& operator=(const TrackedMemoryResource&) = delete;
+
+    SubsystemMemoryStats GetStatistics() const;
+    // Lowers the high-water mark to the current live bytes
+    void ResetHighWater();
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    std::pmr::memory_resource* const upstream_;
+    std::atomic<uint64_t> live_bytes_{0};
+    std::atomic<uint64_t> high_water_bytes_{0};
+    std::atomic<uint64_t> live_allocations_{0};
+    std::atomic<uint64_t> total_allocations_{0};
+};
+
+// The process-wide resource a subsystem allocates its tables from
+TrackedMemoryResource* GetMemoryResource(MemorySubsystem subsystem);
+
+MemoryStatistics GetMemoryStatistics();
+void ResetMemoryHighWater();
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,306 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "metrics_exporter.h"
+
+#include <array>
+#include <cerrno>
+#include <utility>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace Core::Multiplayer {
+
+namespace {
+
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0; // SO_NOSIGPIPE is set per socket instead
+#endif
+
+constexpr std::string_view METRICS_PATH = "/metrics";
+constexpr std::string_view METRICS_CONTENT_TYPE =
+    "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n";
+
+bool SetNonBlocking(int fd) {
+    const int flags = ::fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+} // namespace
+
+MetricsExporter::MetricsExporter(const MetricsExporterConfig& config)
+    : config_(config), connections_(config.max_connections) {}
+
+MetricsExporter::~MetricsExporter() {
+    Stop();
+}
+
+void MetricsExporter::AddCollector(Collector collector) {
+    collectors_.push_back(std::move(collector));
+}
+
+void MetricsExporter::Render(std::string& output) const {
+    MetricsWriter writer(output);
+    for (const Collector& collector : collectors_) {
+        collector(writer);
+    }
+}
+
+ErrorCode MetricsExporter::Start() {
+    if (running_) {
+        return ErrorCode::InvalidState;
+    }
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(config_.port);
+    if (::inet_pton(AF_INET, config_.bind_address.c_str(), &address.sin_addr) != 1) {
+        return ErrorCode::ConfigurationInvalid;
+    }
+
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) {
+        return ErrorCode::NetworkError;
+    }
+    const int enable = 1;
+    ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    if (::bind(listen_fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listen_fd_, SOMAXCONN) != 0 || !SetNonBlocking(listen_fd_)) {
+        Stop();
+        return ErrorCode::ConnectionRefused;
+    }
+
+    int wake[2];
+    if (::pipe(wake) != 0) {
+        Stop();
+        return ErrorCode::ResourceExhausted;
+    }
+    wake_read_fd_ = wake[0];
+    wake_write_fd_ = wake[1];
+    SetNonBlocking(wake_read_fd_);
+
+    sockaddr_in bound{};
+    socklen_t length = sizeof(bound);
+    ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&bound), &length);
+    port_ = ntohs(bound.sin_port);
+
+    stop_requested_.store(false, std::memory_order_release);
+    thread_ = std::thread([this] { Run(); });
+    running_ = true;
+    return ErrorCode::Success;
+}
+
+void MetricsExporter::Stop() {
+    stop_requested_.store(true, std::memory_order_release);
+    if (wake_write_fd_ >= 0) {
+        const uint8_t wake = 1;
+        [[maybe_unused]] const ssize_t written = ::write(wake_write_fd_, &wake, sizeof(wake));
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    for (int* fd : {&listen_fd_, &wake_read_fd_, &wake_write_fd_}) {
+        if (*fd >= 0) {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
+    running_ = false;
+    port_ = 0;
+}
+
+void MetricsExporter::Run() {
+    std::vector<pollfd> descriptors;
+    std::vector<size_t> polled;
+
+    while (!stop_requested_.load(std::memory_order_acquire)) {
+        descriptors.clear();
+        polled.clear();
+        descriptors.push_back({listen_fd_, POLLIN, 0});
+        descriptors.push_back({wake_read_fd_, POLLIN, 0});
+        for (size_t i = 0; i < connections_.size(); ++i) {
+            const Connection& connection = connections_[i];
+            if (connection.fd < 0) {
+                continue;
+            }
+            const short events = connection.response.empty() ? POLLIN : POLLOUT;
+            descriptors.push_back({connection.fd, events, 0});
+            polled.push_back(i);
+        }
+
+        const int ready = ::poll(descriptors.data(), descriptors.size(),
+                                 static_cast<int>(SWEEP_INTERVAL.count()));
+        if (ready < 0 && errno != EINTR) {
+            break;
+        }
+        const Clock::time_point now = Clock::now();
+        if (descriptors[1].revents != 0) {
+            uint8_t drain[64];
+            while (::read(wake_read_fd_, drain, sizeof(drain)) > 0) {
+            }
+        }
+
+        for (size_t i = 0; i < polled.size(); ++i) {
+            const short revents = descriptors[i + 2].revents;
+            if (revents == 0) {
+                continue;
+            }
+            Connection& connection = connections_[polled[i]];
+            bool keep = (revents & (POLLERR | POLLNVAL)) == 0;
+            if (keep && connection.response.empty() && (revents & (POLLIN | POLLHUP)) != 0) {
+                keep = ReadFrom(connection);
+            }
+            if (keep && !connection.response.empty()) {
+                keep = Flush(connection);
+            }
+            if (!keep) {
+                Close(connection);
+            }
+        }
+        // Scrapers that connect and never finish a request
+        for (Connection& connection : connections_) {
+            if (connection.fd >= 0 && now >= connection.deadline) {
+                Close(connection);
+            }
+        }
+        if ((descriptors[0].revents & POLLIN) != 0) {
+            AcceptPending(now);
+        }
+    }
+    for (Connection& connection : connections_) {
+        if (connection.fd >= 0) {
+            Close(connection);
+        }
+    }
+}
+
+void MetricsExporter::AcceptPending(Clock::time_point now) {
+    while (true) {
+        const int fd = ::accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0) {
+            return;
+        }
+        Connection* free_slot = nullptr;
+        for (Connection& connection : connections_) {
+            if (connection.fd < 0) {
+                free_slot = &connection;
+                break;
+            }
+        }
+        if (free_slot == nullptr || !SetNonBlocking(fd)) {
+            ::close(fd);
+            continue;
+        }
+#ifdef SO_NOSIGPIPE
+        const int enable = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &enable, sizeof(enable));
+#endif
+        free_slot->fd = fd;
+        free_slot->deadline = now + config_.request_timeout;
+    }
+}
+
+bool MetricsExporter::ReadFrom(Connection& connection) {
+    std::array<char, 2048> buffer;
+    bool peer_closed = false;
+    while (true) {
+        const ssize_t received = ::recv(connection.fd, buffer.data(), buffer.size(), 0);
+        if (received == 0) {
+            // A scraper may shut down its side once the request is sent
+            peer_closed = true;
+            break;
+        }
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            return false;
+        }
+        connection.request.append(buffer.data(), static_cast<size_t>(received));
+        if (connection.request.size() > MAX_REQUEST_SIZE) {
+            Reply(connection, "431 Request Header Fields Too Large", {}, {});
+            return true;
+        }
+    }
+    if (connection.request.find("\r\n\r\n") != std::string::npos) {
+        Respond(connection);
+        return true;
+    }
+    return !peer_closed;
+}
+
+void MetricsExporter::Respond(Connection& connection) {
+    const std::string_view request(connection.request);
+    const std::string_view line = request.substr(0, request.find("\r\n"));
+    const size_t method_end = line.find(' ');
+    const size_t target_end = line.find(' ', method_end + 1);
+    if (method_end == std::string_view::npos || target_end == std::string_view::npos) {
+        Reply(connection, "400 Bad Request", {}, {});
+        return;
+    }
+    if (line.substr(0, method_end) != "GET") {
+        Reply(connection, "405 Method Not Allowed", "Allow: GET\r\n", {});
+        return;
+    }
+    const std::string_view target = line.substr(method_end + 1, target_end - method_end - 1);
+    if (target.substr(0, target.find('?')) != METRICS_PATH) {
+        Reply(connection, "404 Not Found", {}, {});
+        return;
+    }
+
+    body_.clear();
+    Render(body_);
+    scrapes_.fetch_add(1, std::memory_order_relaxed);
+    Reply(connection, "200 OK", METRICS_CONTENT_TYPE, body_);
+}
+
+void MetricsExporter::Reply(Connection& connection, std::string_view status,
+                            std::string_view extra_headers, std::string_view body) {
+    std::string& response = connection.response;
+    response.clear();
+    response += "HTTP/1.1 ";
+    response += status;
+    response += "\r\nConnection: close\r\nContent-Length: ";
+    response += std::to_string(body.size());
+    response += "\r\n";
+    response += extra_headers;
+    response += "\r\n";
+    response += body;
+    connection.response_offset = 0;
+}
+
+bool MetricsExporter::Flush(Connection& connection) {
+    while (connection.response_offset < connection.response.size()) {
+        const ssize_t sent =
+            ::send(connection.fd, connection.response.data() + connection.response_offset,
+                   connection.response.size() - connection.response_offset, SEND_FLAGS);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        connection.response_offset += static_cast<size_t>(sent);
+    }
+    return false;
+}
+
+void MetricsExporter::Close(Connection& connection) {
+    ::close(connection.fd);
+    connection.fd = -1;
+    // Cleared, not released, so the next scrape reuses the capacity
+    connection.request.clear();
+    connection.response.clear();
+    connection.response_offset = 0;
+}
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,116 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "error_codes.h"
+#include "metrics_writer.h"
+
+namespace Core::Multiplayer {
+
+struct MetricsExporterConfig {
+    // Loopback by default: the endpoint has no authentication
+    std::string bind_address = "127.0.0.1";
+    uint16_t port = 9464; // 0 binds an ephemeral port
+    size_t max_connections = 8;
+    std::chrono::milliseconds request_timeout{5000};
+};
+
+/**
+ * Embedded HTTP endpoint serving GET /metrics to Prometheus, for the relay
+ * and room servers.
+ *
+ * Each scrape runs the collectors on the exporter's own thread. They are
+ * expected to read the services' sharded counters, atomics and
+ * LatencyHistograms, which are read with relaxed loads, so a scrape never
+ * stops or waits for the data path. Rates such as packets per second are
+ * left to the scraper, from the counters.
+ *
+ * One poll() loop serves a handful of connections; request and response
+ * buffers are kept per connection slot and reused, so steady scraping does
+ * not allocate. Every response closes its connection.
+ *
+ * Usage:
+ *   MetricsExporter exporter(MetricsExporterConfig{});
+ *   exporter.AddCollector([&server](MetricsWriter& writer) { server.WriteMetrics(writer); });
+ *   exporter.Start();
+ */
+class MetricsExporter {
+public:
+    using Collector = std::function<void(MetricsWriter&)>;
+
+    static constexpr size_t MAX_REQUEST_SIZE = 8 * 1024;
+    static constexpr std::chrono::milliseconds SWEEP_INTERVAL{1000};
+
+    explicit MetricsExporter(const MetricsExporterConfig& config);
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    // Collectors run in the order added; add them before Start
+    void AddCollector(Collector collector);
+
+    // Binds and listens, then starts the loop
+    ErrorCode Start();
+    void Stop();
+    bool IsRunning() const { return running_; }
+
+    // Bound port, which differs from the configured one when that is 0
+    uint16_t GetPort() const { return port_; }
+    uint64_t GetScrapeCount() const { return scrapes_.load(std::memory_order_relaxed); }
+
+    // Runs every collector into output, as a scrape does
+    void Render(std::string& output) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Connection {
+        int fd = -1;
+        std::string request;
+        std::string response;
+        size_t response_offset = 0;
+        Clock::time_point deadline;
+    };
+
+    void Run();
+    void AcceptPending(Clock::time_point now);
+    // @return False to close the connection
+    bool ReadFrom(Connection& connection);
+    void Respond(Connection& connection);
+    void Reply(Connection& connection, std::string_view status, std::string_view extra_headers,
+               std::string_view body);
+    // @return False once the response is written or the peer is gone
+    bool Flush(Connection& connection);
+    void Close(Connection& connection);
+
+    const MetricsExporterConfig config_;
+    std::vector<Collector> collectors_;
+    bool running_ = false;
+    uint16_t port_ = 0;
+
+    int listen_fd_ = -1;
+    int wake_read_fd_ = -1;
+    int wake_write_fd_ = -1;
+    std::atomic<bool> stop_requested_{false};
+    std::thread thread_;
+
+    // Loop state; only the loop thread touches it
+    std::vector<Connection> connections_;
+    std::string body_;
+
+    std::atomic<uint64_t> scrapes_{0};
+};
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,145 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "metrics_writer.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+#include "latency_histogram.h"
+
+namespace Core::Multiplayer {
+
+void MetricsWriter::Counter(std::string_view name, std::string_view help, uint64_t value,
+                            Labels labels) {
+    BeginFamily(name, help, "counter");
+    BeginSample(name, {}, labels);
+    AppendNumber(value);
+    output_ += '\n';
+}
+
+void MetricsWriter::Gauge(std::string_view name, std::string_view help, double value,
+                          Labels labels) {
+    BeginFamily(name, help, "gauge");
+    BeginSample(name, {}, labels);
+    AppendNumber(value);
+    output_ += '\n';
+}
+
+void MetricsWriter::Histogram(std::string_view name, std::string_view help,
+                              const LatencyHistogram& histogram, Labels labels,
+                              std::span<const uint64_t> bounds_ns) {
+    bounds_ns = bounds_ns.first(std::min(bounds_ns.size(), MAX_LATENCY_BOUNDS));
+    std::array<uint64_t, MAX_LATENCY_BOUNDS> cumulative{};
+    const LatencyHistogramTotals totals =
+        histogram.Collect(bounds_ns, std::span(cumulative).first(bounds_ns.size()));
+
+    BeginFamily(name, help, "histogram");
+    std::array<char, 32> bound_text{};
+    for (size_t i = 0; i < bounds_ns.size(); ++i) {
+        // Fixed notation, as "0.0001" rather than "1e-04" is what scrapers show
+        const double seconds = static_cast<double>(bounds_ns[i]) / 1e9;
+        const auto result = std::to_chars(bound_text.data(), bound_text.data() + bound_text.size(),
+                                          seconds, std::chars_format::fixed);
+        const size_t length = static_cast<size_t>(result.ptr - bound_text.data());
+        const MetricLabel le{"le", std::string_view(bound_text.data(), length)};
+        BeginSample(name, "_bucket", labels, &le);
+        // A sample still being recorded may be in a bucket but not the total yet
+        AppendNumber(std::min(cumulative[i], totals.count));
+        output_ += '\n';
+    }
+    const MetricLabel infinity{"le", "+Inf"};
+    BeginSample(name, "_bucket", labels, &infinity);
+    AppendNumber(totals.count);
+    output_ += '\n';
+    BeginSample(name, "_sum", labels);
+    AppendNumber(static_cast<double>(totals.sum_ns) / 1e9);
+    output_ += '\n';
+    BeginSample(name, "_count", labels);
+    AppendNumber(totals.count);
+    output_ += '\n';
+}
+
+void MetricsWriter::BeginFamily(std::string_view name, std::string_view help,
+                                std::string_view type) {
+    if (name == family_) {
+        return;
+    }
+    family_ = name;
+    output_ += "# HELP ";
+    output_ += name;
+    output_ += ' ';
+    output_ += help;
+    output_ += "\n# TYPE ";
+    output_ += name;
+    output_ += ' ';
+    output_ += type;
+    output_ += '\n';
+}
+
+void MetricsWriter::BeginSample(std::string_view name, std::string_view suffix, Labels labels,
+                                const MetricLabel* extra) {
+    output_ += name;
+    output_ += suffix;
+    if (labels.size() != 0 || extra != nullptr) {
+        char separator = '{';
+        const auto append = [&](const MetricLabel& label) {
+            output_ += separator;
+            output_ += label.name;
+            output_ += "=\"";
+            AppendLabelValue(label.value);
+            output_ += '"';
+            separator = ',';
+        };
+        for (const MetricLabel& label : labels) {
+            append(label);
+        }
+        if (extra != nullptr) {
+            append(*extra);
+        }
+        output_ += '}';
+    }
+    output_ += ' ';
+}
+
+void MetricsWriter::AppendLabelValue(std::string_view value) {
+    for (const char c : value) {
+        switch (c) {
+        case '\\':
+            output_ += "\\\\";
+            break;
+        case '"':
+            output_ += "\\\"";
+            break;
+        case '\n':
+            output_ += "\\n";
+            break;
+        default:
+            output_ += c;
+            break;
+        }
+    }
+}
+
+void MetricsWriter::AppendNumber(uint64_t value) {
+    std::array<char, 24> text{};
+    const auto result = std::to_chars(text.data(), text.data() + text.size(), value);
+    output_.append(text.data(), result.ptr);
+}
+
+void MetricsWriter::AppendNumber(double value) {
+    if (std::isnan(value)) {
+        output_ += "NaN";
+        return;
+    }
+    if (std::isinf(value)) {
+        output_ += value > 0 ? "+Inf" : "-Inf";
+        return;
+    }
+    std::array<char, 32> text{};
+    const auto result = std::to_chars(text.data(), text.data() + text.size(), value);
+    output_.append(text.data(), result.ptr);
+}
+
+} // namespace Core::Multiplayer
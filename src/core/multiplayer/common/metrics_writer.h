@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace Core::Multiplayer {
+
+class LatencyHistogram;
+
+struct MetricLabel {
+    std::string_view name;
+    std::string_view value;
+};
+
+/**
+ * Appends metrics in the Prometheus text exposition format (version 0.0.4)
+ * to a string, for MetricsExporter collectors.
+ *
+ * Samples of one family go in consecutive calls with the same name; HELP
+ * and TYPE are written before the first of them. Names should be string
+ * literals, as the last one is kept to spot the next family. Numbers are
+ * formatted with to_chars straight into the output, so a scrape into a
+ * string reused from the last one allocates nothing once it has grown.
+ *
+ * Counter names end in _total. Histograms are read from a LatencyHistogram
+ * and exported in seconds with the usual _bucket, _sum and _count samples.
+ */
+class MetricsWriter {
+public:
+    using Labels = std::initializer_list<MetricLabel>;
+
+    // 50 us to 1 s, the range relay and room server latencies fall in
+    static constexpr std::array<uint64_t, 14> DEFAULT_LATENCY_BOUNDS_NS = {
+        50'000,     100'000,     250'000,     500'000,     1'000'000,
+        2'500'000,  5'000'000,   10'000'000,  25'000'000,  50'000'000,
+        100'000'000, 250'000'000, 500'000'000, 1'000'000'000,
+    };
+    static constexpr size_t MAX_LATENCY_BOUNDS = 32;
+
+    explicit MetricsWriter(std::string& output) : output_(output) {}
+
+    void Counter(std::string_view name, std::string_view help, uint64_t value,
+                 Labels labels = {});
+    void Gauge(std::string_view name, std::string_view help, double value, Labels labels = {});
+
+    /**
+     * @param bounds_ns Ascending bucket bounds in nanoseconds, at most
+     *                  MAX_LATENCY_BOUNDS; +Inf is added
+     */
+    void Histogram(std::string_view name, std::string_view help,
+                   const LatencyHistogram& histogram, Labels labels = {},
+                   std::span<const uint64_t> bounds_ns = DEFAULT_LATENCY_BOUNDS_NS);
+
+private:
+    void BeginFamily(std::string_view name, std::string_view help, std::string_view type);
+    // Name and suffix, then the labels and an optional extra one
+    void BeginSample(std::string_view name, std::string_view suffix, Labels labels,
+                     const MetricLabel* extra = nullptr);
+    void AppendLabelValue(std::string_view value);
+    void AppendNumber(uint64_t value);
+    void AppendNumber(double value);
+
+    std::string& output_;
+    std::string_view family_;
+};
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,154 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "monotonic_clock.h"
+
+#include <chrono>
+#include <limits>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <cpuid.h>
+#include <x86intrin.h>
+#define MONOTONIC_CLOCK_TSC
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#define MONOTONIC_CLOCK_ARM
+#endif
+
+#if defined(MONOTONIC_CLOCK_TSC) || defined(MONOTONIC_CLOCK_ARM)
+#define MONOTONIC_CLOCK_COUNTER
+#endif
+
+namespace Core::Multiplayer {
+
+#if defined(MONOTONIC_CLOCK_COUNTER)
+namespace {
+
+// Counter ticks scale to nanoseconds as ticks * mult >> MULT_SHIFT
+constexpr unsigned MULT_SHIFT = 32;
+
+struct Calibration {
+    MonotonicClock::Source source = MonotonicClock::Source::SteadyClock;
+    uint64_t base_ticks = 0;
+    uint64_t base_ns = 0;
+    uint64_t mult = 0;
+};
+
+uint64_t ReadCounter() {
+#if defined(MONOTONIC_CLOCK_TSC)
+    return __rdtsc();
+#else
+    uint64_t ticks;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#endif
+}
+
+// Reads the counter and steady_clock as close together as possible, keeping
+// the tightest of a few tries so a preemption does not skew the pair
+void SamplePair(uint64_t& out_ticks, uint64_t& out_ns) {
+    uint64_t best_window = std::numeric_limits<uint64_t>::max();
+    for (int attempt = 0; attempt < 5; ++attempt) {
+        const uint64_t before = ReadCounter();
+        const uint64_t ns = MonotonicClock::SteadyNow();
+        const uint64_t after = ReadCounter();
+        if (after - before < best_window) {
+            best_window = after - before;
+            out_ticks = before + (after - before) / 2;
+            out_ns = ns;
+        }
+    }
+}
+
+#if defined(MONOTONIC_CLOCK_TSC)
+// Only an invariant TSC ticks at a constant rate through frequency and
+// power state changes
+bool HasInvariantTsc() {
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007) {
+        return false;
+    }
+    __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+    return (edx & (1u << 8)) != 0;
+}
+#endif
+
+Calibration Calibrate() {
+    Calibration calibration;
+#if defined(MONOTONIC_CLOCK_TSC)
+    if (!HasInvariantTsc()) {
+        return calibration;
+    }
+    // The TSC frequency is not architecturally visible, so measure it over
+    // a span long enough that steady_clock's read jitter is a few ppm of it
+    constexpr uint64_t CALIBRATION_NS = 2'000'000;
+    uint64_t start_ticks = 0, start_ns = 0;
+    SamplePair(start_ticks, start_ns);
+    uint64_t end_ticks = 0, end_ns = 0;
+    do {
+        SamplePair(end_ticks, end_ns);
+    } while (end_ns - start_ns < CALIBRATION_NS);
+    if (end_ticks <= start_ticks) {
+        return calibration;
+    }
+    calibration.mult = ((end_ns - start_ns) << MULT_SHIFT) / (end_ticks - start_ticks);
+    calibration.base_ticks = end_ticks;
+    calibration.base_ns = end_ns;
+    calibration.source = MonotonicClock::Source::Tsc;
+#elif defined(MONOTONIC_CLOCK_ARM)
+    constexpr uint64_t NANOSECONDS_PER_SECOND = 1'000'000'000;
+    uint64_t frequency;
+    asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+    if (frequency == 0) {
+        return calibration;
+    }
+    calibration.mult = (NANOSECONDS_PER_SECOND << MULT_SHIFT) / frequency;
+    SamplePair(calibration.base_ticks, calibration.base_ns);
+    calibration.source = MonotonicClock::Source::ArmCounter;
+#endif
+    if (calibration.mult == 0) {
+        calibration.source = MonotonicClock::Source::SteadyClock;
+    }
+    return calibration;
+}
+
+// Calibrated on first use, which costs a couple of milliseconds once on x86
+const Calibration& GetCalibration() {
+    static const Calibration calibration = Calibrate();
+    return calibration;
+}
+
+} // namespace
+#endif
+
+uint64_t MonotonicClock::Now() {
+#if defined(MONOTONIC_CLOCK_COUNTER)
+    const Calibration& calibration = GetCalibration();
+    if (calibration.source != Source::SteadyClock) {
+        // Another core's counter may read a few ticks behind the base
+        const auto elapsed = static_cast<int64_t>(ReadCounter() - calibration.base_ticks);
+        if (elapsed <= 0) {
+            return calibration.base_ns;
+        }
+        const auto scaled =
+            (static_cast<unsigned __int128>(elapsed) * calibration.mult) >> MULT_SHIFT;
+        return calibration.base_ns + static_cast<uint64_t>(scaled);
+    }
+#endif
+    return SteadyNow();
+}
+
+uint64_t MonotonicClock::SteadyNow() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+}
+
+MonotonicClock::Source MonotonicClock::GetSource() {
+#if defined(MONOTONIC_CLOCK_COUNTER)
+    return GetCalibration().source;
+#else
+    return Source::SteadyClock;
+#endif
+}
+
+} // namespace Core::Multiplayer
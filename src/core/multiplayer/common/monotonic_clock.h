@@ -0,0 +1,39 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstdint>
+
+namespace Core::Multiplayer {
+
+/**
+ * Per-packet timestamp source.
+ *
+ * steady_clock::now() is a vDSO call costing tens of nanoseconds, more on
+ * some Android kernels, which adds up when every packet is timed several
+ * times. Where the CPU has a constant-rate counter readable from user space
+ * (an invariant TSC on x86, CNTVCT_EL0 on AArch64) Now() reads it directly
+ * and scales it to nanoseconds; elsewhere it falls back to steady_clock.
+ *
+ * Readings are nanoseconds on the steady_clock epoch, taken when the clock
+ * was calibrated on first use. The counter may drift from steady_clock by a
+ * few ppm afterwards, so only subtract Now() readings from each other.
+ */
+class MonotonicClock {
+public:
+    enum class Source : uint8_t {
+        SteadyClock,
+        Tsc,         // x86 time stamp counter, calibrated against steady_clock
+        ArmCounter,  // AArch64 virtual counter, at the frequency CNTFRQ_EL0 reports
+    };
+
+    static uint64_t Now();
+
+    // steady_clock in the same unit, what Now() falls back to
+    static uint64_t SteadyNow();
+
+    static Source GetSource();
+};
+
+} // namespace Core::Multiplayer
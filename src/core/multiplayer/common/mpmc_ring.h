@@ -0,0 +1,166 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace Core::Multiplayer {
+
+/**
+ * MPMC ring statistics
+ */
+struct MpmcRingStatistics {
+    size_t capacity = 0;
+    size_t size = 0;
+    size_t high_watermark = 0;
+    uint64_t pushed_count = 0;
+    uint64_t dropped_count = 0;
+};
+
+/**
+ * Bounded lock-free multi-producer/multi-consumer ring.
+ *
+ * Each slot carries a sequence number that tells producers and consumers
+ * whether it is free or filled for their lap, so both sides claim a position
+ * with a single CAS and never block each other. Elements are moved in and
+ * out; a failed TryPush leaves the value with the caller untouched, so it
+ * can be retried later.
+ *
+ * Capacity is rounded up to the next power of two, and is at least two so a
+ * filled slot's sequence can never look free to the next producer.
+ */
+template <typename T>
+class MpmcRing {
+public:
+    explicit MpmcRing(size_t capacity)
+        : capacity_(RoundUpToPowerOfTwo(capacity)), mask_(capacity_ - 1),
+          slots_(std::make_unique<Slot[]>(capacity_)) {
+        for (size_t i = 0; i < capacity_; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcRing(const MpmcRing&) = delete;
+    MpmcRing& operator=(const MpmcRing&) = delete;
+
+    /**
+     * Producer side: enqueue an element
+     * @return False if the ring was full; the value is not moved from
+     */
+    bool TryPush(T&& value) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &slots_[tail & mask_];
+            const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            const auto lap = static_cast<std::ptrdiff_t>(sequence - tail);
+            if (lap == 0) {
+                if (tail_.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (lap < 0) {
+                dropped_count_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                tail = tail_.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->value = std::move(value);
+        slot->sequence.store(tail + 1, std::memory_order_release);
+
+        pushed_count_.fetch_add(1, std::memory_order_relaxed);
+        const size_t depth = tail + 1 - head_.load(std::memory_order_relaxed);
+        size_t watermark = high_watermark_.load(std::memory_order_relaxed);
+        while (depth > watermark && depth <= capacity_ &&
+               !high_watermark_.compare_exchange_weak(watermark, depth,
+                                                      std::memory_order_relaxed)) {
+        }
+        return true;
+    }
+
+    /**
+     * Consumer side: dequeue the oldest element
+     * @return False if the ring was empty
+     */
+    bool TryPop(T& out) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &slots_[head & mask_];
+            const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            const auto lap = static_cast<std::ptrdiff_t>(sequence - (head + 1));
+            if (lap == 0) {
+                if (head_.compare_exchange_weak(head, head + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (lap < 0) {
+                return false;
+            } else {
+                head = head_.load(std::memory_order_relaxed);
+            }
+        }
+
+        out = std::move(slot->value);
+        // Drop any resources still held by the moved-from slot
+        slot->value = T{};
+        slot->sequence.store(head + capacity_, std::memory_order_release);
+        return true;
+    }
+
+    size_t Size() const {
+        const size_t head = head_.load(std::memory_order_acquire);
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    bool Empty() const { return Size() == 0; }
+    size_t Capacity() const { return capacity_; }
+
+    size_t HighWatermark() const { return high_watermark_.load(std::memory_order_relaxed); }
+    uint64_t DroppedCount() const { return dropped_count_.load(std::memory_order_relaxed); }
+
+    MpmcRingStatistics GetStatistics() const {
+        MpmcRingStatistics stats;
+        stats.capacity = capacity_;
+        stats.size = Size();
+        stats.high_watermark = HighWatermark();
+        stats.pushed_count = pushed_count_.load(std::memory_order_relaxed);
+        stats.dropped_count = DroppedCount();
+        return stats;
+    }
+
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    static size_t RoundUpToPowerOfTwo(size_t value) {
+        size_t result = 2;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head_{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail_{0};
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> high_watermark_{0};
+    std::atomic<uint64_t> pushed_count_{0};
+    std::atomic<uint64_t> dropped_count_{0};
+};
+
+} // namespace Core::Multiplayer
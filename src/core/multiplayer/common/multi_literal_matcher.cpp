@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "multi_literal_matcher.h"
+
+#include <deque>
+
+namespace Core::Multiplayer {
+
+MultiLiteralMatcher::MultiLiteralMatcher(const std::vector<std::string_view>& literals) {
+    // Trie over case-folded bytes; a missing edge is 0, which is the root
+    transitions_.assign(256, 0);
+    accepting_.assign(1, 0);
+    for (const auto literal : literals) {
+        if (literal.empty()) {
+            matches_empty_ = true;
+            continue;
+        }
+        State state = 0;
+        for (const char ch : literal) {
+            const uint8_t c = FoldCase(static_cast<uint8_t>(ch));
+            State next = transitions_[static_cast<size_t>(state) * 256 + c];
+            if (next == 0) {
+                next = static_cast<State>(accepting_.size());
+                transitions_[static_cast<size_t>(state) * 256 + c] = next;
+                transitions_.resize(transitions_.size() + 256, 0);
+                accepting_.push_back(0);
+            }
+            state = next;
+        }
+        accepting_[state] = 1;
+    }
+
+    // Breadth-first, fill each missing edge from the failure state's row,
+    // which is already complete because it is shallower
+    std::vector<State> failure(accepting_.size(), 0);
+    std::deque<State> queue;
+    for (size_t c = 0; c < 256; ++c) {
+        const State child = transitions_[c];
+        if (child != 0) {
+            queue.push_back(child);
+        }
+    }
+    while (!queue.empty()) {
+        const State state = queue.front();
+        queue.pop_front();
+        accepting_[state] |= accepting_[failure[state]];
+        for (size_t c = 0; c < 256; ++c) {
+            State& edge = transitions_[static_cast<size_t>(state) * 256 + c];
+            const State fallback = transitions_[static_cast<size_t>(failure[state]) * 256 + c];
+            if (edge != 0) {
+                failure[edge] = fallback;
+                queue.push_back(edge);
+            } else {
+                edge = fallback;
+            }
+        }
+    }
+
+    // Uppercase input takes the same edges as lowercase
+    for (size_t state = 0; state < accepting_.size(); ++state) {
+        State* row = transitions_.data() + state * 256;
+        for (size_t c = 'A'; c <= 'Z'; ++c) {
+            row[c] = row[FoldCase(static_cast<uint8_t>(c))];
+        }
+    }
+    for (size_t c = 0; c < 256; ++c) {
+        starts_[c] = transitions_[c] != 0;
+    }
+}
+
+size_t MultiLiteralMatcher::Find(std::string_view text) const {
+    if (matches_empty_) {
+        return 0;
+    }
+    const auto* data = reinterpret_cast<const uint8_t*>(text.data());
+    const size_t size = text.size();
+    State state = 0;
+    size_t i = 0;
+    while (i < size) {
+        if (state == 0) {
+            while (i < size && !starts_[data[i]]) {
+                ++i;
+            }
+            if (i == size) {
+                break;
+            }
+        }
+        state = Row(state)[data[i++]];
+        if (accepting_[state]) {
+            return i;
+        }
+    }
+    return std::string_view::npos;
+}
+
+} // namespace Core::Multiplayer
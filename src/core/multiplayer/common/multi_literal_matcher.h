@@ -0,0 +1,64 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace Core::Multiplayer {
+
+/**
+ * Finds any of a fixed set of literals in a byte string, ignoring ASCII case.
+ *
+ * The literals are compiled once into an Aho-Corasick automaton and then
+ * flattened into a dense DFA with one row of 256 transitions per state, so a
+ * search is a single table load per input byte with no backtracking. Case
+ * folding is built into the table: 'A' and 'a' lead to the same state, and
+ * the input is never copied or lowercased. Bytes outside ASCII only match
+ * themselves, as with std::regex::icase in the "C" locale.
+ *
+ * While the automaton is in its start state, bytes that cannot begin any
+ * literal are skipped without touching the transition table.
+ */
+class MultiLiteralMatcher {
+public:
+    explicit MultiLiteralMatcher(const std::vector<std::string_view>& literals);
+
+    /// True if any literal occurs in the text
+    bool Contains(std::string_view text) const {
+        return Find(text) != std::string_view::npos;
+    }
+
+    /**
+     * @return Offset one past the end of the earliest ending match, or
+     *         std::string_view::npos if none of the literals occur
+     */
+    size_t Find(std::string_view text) const;
+
+    size_t GetStateCount() const {
+        return accepting_.size();
+    }
+
+private:
+    using State = uint32_t;
+
+    static constexpr uint8_t FoldCase(uint8_t c) {
+        return (c >= 'A' && c <= 'Z') ? static_cast<uint8_t>(c + ('a' - 'A')) : c;
+    }
+
+    const State* Row(State state) const {
+        return transitions_.data() + static_cast<size_t>(state) * 256;
+    }
+
+    std::vector<State> transitions_;
+    std::vector<uint8_t> accepting_;
+    // Bytes that leave the start state
+    std::array<bool, 256> starts_{};
+    bool matches_empty_ = false;
+};
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,88 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "multipath_codec.h"
+
+#include <cstring>
+
+namespace Core::Multiplayer {
+
+size_t MultipathCodec::Encode(uint8_t node_id, bool redundant, const uint8_t* data, size_t size,
+                              uint8_t* out) {
+    if (size > FecCodec::MAX_FRAMED_SIZE) {
+        return 0;
+    }
+    if (!redundant) {
+        out[0] = KIND_SINGLE;
+        std::memcpy(out + 1, data, size);
+        return size + 1;
+    }
+
+    const uint16_t sequence = send_sequences_[node_id]++;
+    out[0] = KIND_REDUNDANT;
+    out[1] = static_cast<uint8_t>(sequence);
+    out[2] = static_cast<uint8_t>(sequence >> 8);
+    std::memcpy(out + REDUNDANT_HEADER_SIZE, data, size);
+    return size + REDUNDANT_HEADER_SIZE;
+}
+
+void MultipathCodec::OnSent(size_t path, bool redundant) {
+    if (path < MAX_PATHS) {
+        counters_[path].sent.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (!redundant) {
+        single_sent_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool MultipathCodec::Decode(uint8_t node_id, size_t path, const uint8_t* data, size_t size,
+                            size_t& out_offset) {
+    if (size == 0 || path >= MAX_PATHS) {
+        return false;
+    }
+    if (data[0] == KIND_SINGLE) {
+        out_offset = 1;
+        return true;
+    }
+    if (data[0] != KIND_REDUNDANT || size < REDUNDANT_HEADER_SIZE) {
+        return false;
+    }
+
+    const uint16_t sequence = static_cast<uint16_t>(data[1] | (data[2] << 8));
+    auto& window = receive_windows_[node_id];
+    // Unwrapped from one wrap in, so sequences before the first stay positive
+    const uint64_t unwrapped = window.IsStarted()
+                                   ? UnwrapSequence(sequence, window.GetHighest())
+                                   : 0x10000 + uint64_t{sequence};
+    const auto result = window.CheckAndMark(unwrapped);
+    if (result == ReplayWindow<RECEIVE_WINDOW>::Result::TooOld) {
+        stale_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    if (result == ReplayWindow<RECEIVE_WINDOW>::Result::Duplicate) {
+        counters_[path].second.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    counters_[path].first.fetch_add(1, std::memory_order_relaxed);
+    out_offset = REDUNDANT_HEADER_SIZE;
+    return true;
+}
+
+void MultipathCodec::ResetNode(uint8_t node_id) {
+    send_sequences_[node_id] = 0;
+    receive_windows_[node_id].Reset();
+}
+
+MultipathStatistics MultipathCodec::GetStatistics() const {
+    MultipathStatistics statistics;
+    for (size_t path = 0; path < MAX_PATHS; ++path) {
+        statistics.paths[path].sent = counters_[path].sent.load(std::memory_order_relaxed);
+        statistics.paths[path].first = counters_[path].first.load(std::memory_order_relaxed);
+        statistics.paths[path].second = counters_[path].second.load(std::memory_order_relaxed);
+    }
+    statistics.single_sent = single_sent_.load(std::memory_order_relaxed);
+    statistics.stale = stale_.load(std::memory_order_relaxed);
+    return statistics;
+}
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,113 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "fec_codec.h"
+#include "replay_window.h"
+
+namespace Core::Multiplayer {
+
+/**
+ * Per-path receive counts of redundant sending
+ */
+struct MultipathPathStatistics {
+    uint64_t sent = 0;
+    uint64_t first = 0;  // Copies that arrived before the other path's
+    uint64_t second = 0; // Copies dropped as duplicates
+};
+
+struct MultipathStatistics {
+    static constexpr size_t MAX_PATHS = 2;
+
+    std::array<MultipathPathStatistics, MAX_PATHS> paths{};
+    uint64_t single_sent = 0; // Packets sent over the primary path only
+    uint64_t stale = 0;       // Too far behind the newest to tell whether seen; dropped
+
+    // Share of redundant packets whose first copy came over the path, 0..1
+    double GetWinRate(size_t path) const {
+        uint64_t total = 0;
+        for (const auto& statistics : paths) {
+            total += statistics.first;
+        }
+        return total == 0 ? 0.0 : static_cast<double>(paths[path].first) / total;
+    }
+};
+
+/**
+ * Framing for sending latency-critical packets over two paths at once,
+ * e.g. the direct P2P connection and the relay, or two relays.
+ *
+ * Redundant packets carry a per-node sequence number; the receiver keeps
+ * whichever copy arrives first, from either path, and drops the other, so
+ * a spike on one path costs nothing while the other is on time. Other
+ * packets go over the primary path with a one byte header.
+ *
+ * Wire format, little-endian:
+ *   single:    kind (1), packet bytes
+ *   redundant: kind (1), sequence (2), packet bytes
+ *
+ * Not thread-safe, but the encoding and decoding sides share no state, so
+ * the send path and the receive side may each use their own. Both paths
+ * decode into the same windows, so deliveries from their transport threads
+ * must be serialized, as ModelABackend::DeliverPacket does; the statistics
+ * may be read from any thread.
+ */
+class MultipathCodec {
+public:
+    static constexpr size_t MAX_PATHS = MultipathStatistics::MAX_PATHS;
+    static constexpr uint8_t KIND_SINGLE = 0x00;
+    static constexpr uint8_t KIND_REDUNDANT = 0x01;
+    static constexpr size_t REDUNDANT_HEADER_SIZE = 3;
+    static constexpr size_t MAX_FRAMED_SIZE = REDUNDANT_HEADER_SIZE + FecCodec::MAX_FRAMED_SIZE;
+    // Sequences this far behind a node's newest are dropped
+    static constexpr uint16_t RECEIVE_WINDOW = 64;
+
+    /**
+     * Frames a packet; out must hold MAX_FRAMED_SIZE bytes. A redundant one
+     * is to be sent over every path, see OnSent.
+     * @return Bytes written, or 0 if the packet is too large
+     */
+    size_t Encode(uint8_t node_id, bool redundant, const uint8_t* data, size_t size,
+                  uint8_t* out);
+
+    // Counts a framed packet handed to the path
+    void OnSent(size_t path, bool redundant);
+
+    /**
+     * Unframes a packet that arrived over the path
+     * @param out_offset Receives where the packet bytes start in data
+     * @return False for a duplicate, stale or malformed frame
+     */
+    bool Decode(uint8_t node_id, size_t path, const uint8_t* data, size_t size,
+                size_t& out_offset);
+
+    // Forgets a node's sequences in both directions, e.g. when it leaves
+    void ResetNode(uint8_t node_id);
+
+    MultipathStatistics GetStatistics() const;
+
+private:
+    struct PathCounters {
+        std::atomic<uint64_t> sent{0};
+        std::atomic<uint64_t> first{0};
+        std::atomic<uint64_t> second{0};
+    };
+
+    // Send side
+    std::array<uint16_t, 256> send_sequences_{};
+    // Receive side
+    // Sequences unwrapped to 64 bits
+    std::array<ReplayWindow<RECEIVE_WINDOW>, 256> receive_windows_{};
+
+    std::array<PathCounters, MAX_PATHS> counters_{};
+    std::atomic<uint64_t> single_sent_{0};
+    std::atomic<uint64_t> stale_{0};
+};
+
+} // namespace Core::Multiplayer
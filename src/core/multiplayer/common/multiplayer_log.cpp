@@ -0,0 +1,235 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "multiplayer_log.h"
+#include "thread_policy.h"
+
+#include <charconv>
+
+#include <spdlog/spdlog.h>
+
+namespace Core::Multiplayer {
+
+namespace {
+
+void AppendArgument(std::string& out, const LogRecord& record, const LogArgument& arg) {
+    std::array<char, 32> buffer{};
+    std::to_chars_result result{buffer.data(), std::errc{}};
+    switch (arg.type) {
+    case LogArgument::Type::Signed:
+        result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), arg.signed_value);
+        break;
+    case LogArgument::Type::Unsigned:
+        result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), arg.unsigned_value);
+        break;
+    case LogArgument::Type::Double:
+        result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), arg.double_value);
+        break;
+    case LogArgument::Type::Bool:
+        out += arg.unsigned_value != 0 ? "true" : "false";
+        return;
+    case LogArgument::Type::String:
+        out.append(record.text.data() + arg.text_offset, arg.text_length);
+        return;
+    }
+    out.append(buffer.data(), result.ptr);
+}
+
+spdlog::level::level_enum ToSpdlogLevel(LogLevel level) {
+    switch (level) {
+    case LogLevel::Trace:
+        return spdlog::level::trace;
+    case LogLevel::Debug:
+        return spdlog::level::debug;
+    case LogLevel::Info:
+        return spdlog::level::info;
+    case LogLevel::Warn:
+        return spdlog::level::warn;
+    case LogLevel::Error:
+        return spdlog::level::err;
+    case LogLevel::Critical:
+        return spdlog::level::critical;
+    }
+    return spdlog::level::info;
+}
+
+} // namespace
+
+std::string FormatLogRecord(const LogRecord& record) {
+    std::string message;
+    size_t next_arg = 0;
+    for (const char* c = record.format; c && *c != '\0'; ++c) {
+        if ((c[0] == '{' && c[1] == '{') || (c[0] == '}' && c[1] == '}')) {
+            message += *c++;
+            continue;
+        }
+        if (c[0] != '{') {
+            message += *c;
+            continue;
+        }
+        const char* close = c;
+        while (*close != '\0' && *close != '}') {
+            ++close;
+        }
+        if (*close == '\0' || next_arg >= record.arg_count) {
+            // Unterminated, or more placeholders than arguments; keep it as written
+            message += *c;
+            continue;
+        }
+        AppendArgument(message, record, record.args[next_arg++]);
+        c = close;
+    }
+    if (record.suppressed != 0) {
+        message += " (";
+        message += std::to_string(record.suppressed);
+        message += " similar suppressed)";
+    }
+    return message;
+}
+
+struct AsyncLogger::ThreadRing {
+    explicit ThreadRing(uint32_t index_) : ring(RING_CAPACITY), index(index_) {}
+
+    SpscRing<LogRecord> ring;
+    const uint32_t index;
+    std::atomic<bool> retired{false}; // The thread exited; dropped once drained
+};
+
+AsyncLogger& AsyncLogger::Instance() {
+    static AsyncLogger instance;
+    return instance;
+}
+
+AsyncLogger::AsyncLogger() {
+    thread_ = SpawnThread(ThreadRole::Background, "mp-log", [this] { Run(); });
+}
+
+AsyncLogger::~AsyncLogger() {
+    {
+        std::lock_guard lock(mutex_);
+        stop_requested_ = true;
+    }
+    wake_cv_.notify_one();
+    thread_.join();
+}
+
+void AsyncLogger::SetSink(Sink sink) {
+    std::lock_guard lock(mutex_);
+    sink_ = sink ? std::make_shared<const Sink>(std::move(sink)) : nullptr;
+}
+
+void AsyncLogger::Flush() {
+    std::unique_lock lock(mutex_);
+    const uint64_t target = ++flush_requested_;
+    wake_cv_.notify_one();
+    flushed_cv_.wait(lock, [&] { return flush_completed_ >= target; });
+}
+
+AsyncLoggerStatistics AsyncLogger::GetStatistics() const {
+    AsyncLoggerStatistics statistics;
+    statistics.written = written_.load(std::memory_order_relaxed);
+    statistics.dropped = dropped_.load(std::memory_order_relaxed);
+    std::lock_guard lock(mutex_);
+    statistics.threads = rings_.size();
+    return statistics;
+}
+
+void AsyncLogger::Submit(const LogRecord& record) {
+    ThreadRing& ring = CurrentRing();
+    if (!ring.ring.TryPush(record)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+AsyncLogger::ThreadRing& AsyncLogger::CurrentRing() {
+    // Marks the ring retired when its thread exits; the logger thread
+    // drains what is left and lets it go
+    struct Owner {
+        std::shared_ptr<ThreadRing> ring;
+        ~Owner() {
+            if (ring) {
+                ring->retired.store(true, std::memory_order_release);
+            }
+        }
+    };
+    thread_local Owner owner;
+    if (!owner.ring) {
+        std::lock_guard lock(mutex_);
+        owner.ring = std::make_shared<ThreadRing>(next_thread_index_++);
+        rings_.push_back(owner.ring);
+    }
+    return *owner.ring;
+}
+
+void AsyncLogger::Run() {
+    std::unique_lock lock(mutex_);
+    while (true) {
+        wake_cv_.wait_for(lock, DRAIN_INTERVAL, [this] {
+            return stop_requested_ || flush_requested_ != flush_completed_;
+        });
+        const uint64_t flush_target = flush_requested_;
+        const bool stopping = stop_requested_;
+        const auto sink = sink_;
+        drain_rings_ = rings_;
+        lock.unlock();
+
+        Drain(sink.get());
+
+        lock.lock();
+        // A retired ring gets no more records, so one found empty is done
+        std::erase_if(rings_, [](const auto& ring) {
+            return ring->retired.load(std::memory_order_acquire) && ring->ring.Empty();
+        });
+        drain_rings_.clear();
+        flush_completed_ = flush_target;
+        flushed_cv_.notify_all();
+        if (stopping) {
+            return;
+        }
+    }
+}
+
+void AsyncLogger::Drain(const Sink* sink) {
+    batch_.clear();
+    LogRecord record;
+    for (const auto& ring : drain_rings_) {
+        while (ring->ring.TryPop(record)) {
+            record.thread_index = ring->index;
+            batch_.push_back(record);
+        }
+    }
+    // Each ring is in order already; this interleaves the threads
+    std::stable_sort(batch_.begin(), batch_.end(), [](const LogRecord& a, const LogRecord& b) {
+        return a.timestamp < b.timestamp;
+    });
+
+    for (const LogRecord& entry : batch_) {
+        const std::string message = FormatLogRecord(entry);
+        if (sink) {
+            (*sink)(entry, message);
+        } else {
+            spdlog::default_logger_raw()->log(entry.timestamp, spdlog::source_loc{},
+                                              ToSpdlogLevel(entry.level), message);
+        }
+    }
+    written_.fetch_add(batch_.size(), std::memory_order_relaxed);
+}
+
+bool LogRateLimiter::Allow(uint64_t& suppressed, std::chrono::steady_clock::time_point now) {
+    constexpr int64_t WINDOW_NS = 1'000'000'000;
+    const int64_t now_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+    int64_t start = window_start_ns_.load(std::memory_order_relaxed);
+    if (now_ns - start >= WINDOW_NS &&
+        window_start_ns_.compare_exchange_strong(start, now_ns, std::memory_order_relaxed)) {
+        window_count_.store(0, std::memory_order_relaxed);
+    }
+    if (window_count_.fetch_add(1, std::memory_order_relaxed) >= per_second_) {
+        suppressed_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
+    return true;
+}
+
+} // namespace Core::Multiplayer
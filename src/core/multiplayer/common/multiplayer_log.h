@@ -0,0 +1,304 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "spsc_ring.h"
+
+/**
+ * Structured asynchronous logging for the multiplayer subsystem.
+ *
+ *   MULTIPLAYER_LOG_WARN("Security violation from {} ({}): {}", id, ip, reason);
+ *   MULTIPLAYER_LOG_RATE_LIMITED(Warn, 10, "Dropped packet from {}", ip);
+ *
+ * A call site below SUDACHI_MULTIPLAYER_LOG_LEVEL expands to nothing, so its
+ * arguments are not even evaluated. The rest copy the format literal's
+ * address and their arguments, in binary, into a fixed-size record on the
+ * calling thread's own ring; no lock, allocation or formatting happens there,
+ * and a full ring drops the record rather than wait. A background thread
+ * merges the rings in time order, formats, and hands the text to the sink,
+ * spdlog by default.
+ *
+ * Arguments may be integers, enums, floating point, bools and strings; a
+ * record holds MAX_LOG_ARGS of them and the strings share LOG_TEXT_CAPACITY
+ * bytes, past which they are truncated. Each {} in the format takes the
+ * next argument; anything inside the braces is ignored, and {{ and }} are
+ * literal braces.
+ */
+
+// 0 trace, 1 debug, 2 info, 3 warn, 4 error, 5 critical, 6 off
+#ifndef SUDACHI_MULTIPLAYER_LOG_LEVEL
+#ifdef NDEBUG
+#define SUDACHI_MULTIPLAYER_LOG_LEVEL 2
+#else
+#define SUDACHI_MULTIPLAYER_LOG_LEVEL 1
+#endif
+#endif
+
+namespace Core::Multiplayer {
+
+enum class LogLevel : uint8_t {
+    Trace,
+    Debug,
+    Info,
+    Warn,
+    Error,
+    Critical,
+};
+
+constexpr size_t MAX_LOG_ARGS = 6;
+constexpr size_t LOG_TEXT_CAPACITY = 96;
+
+struct LogArgument {
+    enum class Type : uint8_t { Signed, Unsigned, Double, Bool, String };
+
+    Type type = Type::Signed;
+    uint8_t text_offset = 0; // String: its bytes in LogRecord::text
+    uint8_t text_length = 0;
+    union {
+        int64_t signed_value;
+        uint64_t unsigned_value;
+        double double_value;
+    };
+};
+
+/**
+ * One log call, as it sits in the ring
+ */
+struct LogRecord {
+    std::chrono::system_clock::time_point timestamp;
+    const char* format = nullptr; // A string literal, so never copied
+    uint64_t suppressed = 0;      // Calls a rate limiter dropped since the last one that went
+    uint32_t thread_index = 0;
+    LogLevel level = LogLevel::Info;
+    uint8_t arg_count = 0;
+    uint8_t text_used = 0;
+    std::array<LogArgument, MAX_LOG_ARGS> args;
+    std::array<char, LOG_TEXT_CAPACITY> text;
+
+    void Add(std::string_view value) {
+        const size_t length = std::min(value.size(), LOG_TEXT_CAPACITY - text_used);
+        LogArgument& arg = args[arg_count++];
+        arg.type = LogArgument::Type::String;
+        arg.text_offset = text_used;
+        arg.text_length = static_cast<uint8_t>(length);
+        std::memcpy(text.data() + text_used, value.data(), length);
+        text_used = static_cast<uint8_t>(text_used + length);
+    }
+
+    template <typename T>
+    void Add(const T& value) {
+        using U = std::decay_t<T>;
+        LogArgument& arg = args[arg_count++];
+        if constexpr (std::is_same_v<U, bool>) {
+            arg.type = LogArgument::Type::Bool;
+            arg.unsigned_value = value ? 1 : 0;
+        } else if constexpr (std::is_enum_v<U>) {
+            arg.type = LogArgument::Type::Signed;
+            arg.signed_value = static_cast<int64_t>(value);
+        } else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+            arg.type = LogArgument::Type::Signed;
+            arg.signed_value = value;
+        } else if constexpr (std::is_integral_v<U>) {
+            arg.type = LogArgument::Type::Unsigned;
+            arg.unsigned_value = value;
+        } else if constexpr (std::is_floating_point_v<U>) {
+            arg.type = LogArgument::Type::Double;
+            arg.double_value = value;
+        } else {
+            static_assert(std::is_convertible_v<const T&, std::string_view>,
+                          "Log arguments are numbers, enums, bools or strings");
+            --arg_count;
+            Add(std::string_view(value));
+        }
+    }
+};
+
+// Formats a record's message, without timestamp or level
+std::string FormatLogRecord(const LogRecord& record);
+
+struct AsyncLoggerStatistics {
+    uint64_t written = 0;
+    uint64_t dropped = 0; // Ring full
+    size_t threads = 0;   // Rings currently registered
+};
+
+/**
+ * The process-wide background logger behind the MULTIPLAYER_LOG macros
+ */
+class AsyncLogger {
+public:
+    // Called on the logger thread with the formatted message
+    using Sink = std::function<void(const LogRecord& record, std::string_view message)>;
+
+    static constexpr size_t RING_CAPACITY = 256;
+    static constexpr std::chrono::milliseconds DRAIN_INTERVAL{10};
+
+    static AsyncLogger& Instance();
+
+    ~AsyncLogger();
+
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    template <typename... Args>
+    void Log(LogLevel level, uint64_t suppressed, const char* format, const Args&... args) {
+        static_assert(sizeof...(Args) <= MAX_LOG_ARGS, "Too many log arguments");
+        LogRecord record;
+        record.timestamp = std::chrono::system_clock::now();
+        record.format = format;
+        record.suppressed = suppressed;
+        record.level = level;
+        (record.Add(args), ...);
+        Submit(record);
+    }
+
+    // Replaces the sink; nullptr restores spdlog
+    void SetSink(Sink sink);
+
+    /**
+     * Blocks until everything logged before the call has reached the sink.
+     * Not from the sink itself.
+     */
+    void Flush();
+
+    AsyncLoggerStatistics GetStatistics() const;
+
+private:
+    struct ThreadRing;
+
+    AsyncLogger();
+
+    void Submit(const LogRecord& record);
+    ThreadRing& CurrentRing();
+    void Run();
+    void Drain(const Sink* sink);
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_cv_;
+    std::condition_variable flushed_cv_;
+    std::vector<std::shared_ptr<ThreadRing>> rings_;
+    uint32_t next_thread_index_ = 0;
+    uint64_t flush_requested_ = 0;
+    uint64_t flush_completed_ = 0;
+    bool stop_requested_ = false;
+
+    std::shared_ptr<const Sink> sink_;
+
+    // Logger thread only
+    std::vector<std::shared_ptr<ThreadRing>> drain_rings_;
+    std::vector<LogRecord> batch_;
+
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::thread thread_;
+};
+
+/**
+ * Lets through at most a fixed number of calls per second from one call
+ * site, and counts the rest so the next one through can report them
+ */
+class LogRateLimiter {
+public:
+    explicit LogRateLimiter(uint32_t per_second) : per_second_(per_second) {}
+
+    /**
+     * @param suppressed Set, when allowed, to the calls dropped since the
+     *        last one allowed
+     */
+    bool Allow(uint64_t& suppressed,
+               std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+private:
+    const uint32_t per_second_;
+    std::atomic<int64_t> window_start_ns_{0};
+    std::atomic<uint32_t> window_count_{0};
+    std::atomic<uint64_t> suppressed_{0};
+};
+
+} // namespace Core::Multiplayer
+
+#define MULTIPLAYER_LOG_IMPL(level, format, ...)                                                   \
+    ::Core::Multiplayer::AsyncLogger::Instance().Log(                                              \
+        ::Core::Multiplayer::LogLevel::level, 0, "" format __VA_OPT__(, ) __VA_ARGS__)
+
+#define MULTIPLAYER_LOG_RATE_LIMITED_IMPL(level, per_second, format, ...)                          \
+    do {                                                                                           \
+        static ::Core::Multiplayer::LogRateLimiter multiplayer_log_limiter(per_second);            \
+        uint64_t multiplayer_log_suppressed = 0;                                                   \
+        if (multiplayer_log_limiter.Allow(multiplayer_log_suppressed)) {                           \
+            ::Core::Multiplayer::AsyncLogger::Instance().Log(                                      \
+                ::Core::Multiplayer::LogLevel::level, multiplayer_log_suppressed, "" format       \
+                __VA_OPT__(, ) __VA_ARGS__);                                                       \
+        }                                                                                          \
+    } while (0)
+
+#define MULTIPLAYER_LOG_DISABLED(...) static_cast<void>(0)
+
+#if SUDACHI_MULTIPLAYER_LOG_LEVEL <= 0
+#define MULTIPLAYER_LOG_TRACE(...) MULTIPLAYER_LOG_IMPL(Trace, __VA_ARGS__)
+#define MULTIPLAYER_LOG_RATE_LIMITED_Trace MULTIPLAYER_LOG_RATE_LIMITED_IMPL
+#else
+#define MULTIPLAYER_LOG_TRACE MULTIPLAYER_LOG_DISABLED
+#define MULTIPLAYER_LOG_RATE_LIMITED_Trace MULTIPLAYER_LOG_DISABLED
+#endif
+#if SUDACHI_MULTIPLAYER_LOG_LEVEL <= 1
+#define MULTIPLAYER_LOG_DEBUG(...) MULTIPLAYER_LOG_IMPL(Debug, __VA_ARGS__)
+#define MULTIPLAYER_LOG_RATE_LIMITED_Debug MULTIPLAYER_LOG_RATE_LIMITED_IMPL
+#else
+#define MULTIPLAYER_LOG_DEBUG MULTIPLAYER_LOG_DISABLED
+#define MULTIPLAYER_LOG_RATE_LIMITED_Debug MULTIPLAYER_LOG_DISABLED
+#endif
+#if SUDACHI_MULTIPLAYER_LOG_LEVEL <= 2
+#define MULTIPLAYER_LOG_INFO(...) MULTIPLAYER_LOG_IMPL(Info, __VA_ARGS__)
+#define MULTIPLAYER_LOG_RATE_LIMITED_Info MULTIPLAYER_LOG_RATE_LIMITED_IMPL
+#else
+#define MULTIPLAYER_LOG_INFO MULTIPLAYER_LOG_DISABLED
+#define MULTIPLAYER_LOG_RATE_LIMITED_Info MULTIPLAYER_LOG_DISABLED
+#endif
+#if SUDACHI_MULTIPLAYER_LOG_LEVEL <= 3
+#define MULTIPLAYER_LOG_WARN(...) MULTIPLAYER_LOG_IMPL(Warn, __VA_ARGS__)
+#define MULTIPLAYER_LOG_RATE_LIMITED_Warn MULTIPLAYER_LOG_RATE_LIMITED_IMPL
+#else
+#define MULTIPLAYER_LOG_WARN MULTIPLAYER_LOG_DISABLED
+#define MULTIPLAYER_LOG_RATE_LIMITED_Warn MULTIPLAYER_LOG_DISABLED
+#endif
+#if SUDACHI_MULTIPLAYER_LOG_LEVEL <= 4
+#define MULTIPLAYER_LOG_ERROR(...) MULTIPLAYER_LOG_IMPL(Error, __VA_ARGS__)
+#define MULTIPLAYER_LOG_RATE_LIMITED_Error MULTIPLAYER_LOG_RATE_LIMITED_IMPL
+#else
+#define MULTIPLAYER_LOG_ERROR MULTIPLAYER_LOG_DISABLED
+#define MULTIPLAYER_LOG_RATE_LIMITED_Error MULTIPLAYER_LOG_DISABLED
+#endif
+#if SUDACHI_MULTIPLAYER_LOG_LEVEL <= 5
+#define MULTIPLAYER_LOG_CRITICAL(...) MULTIPLAYER_LOG_IMPL(Critical, __VA_ARGS__)
+#define MULTIPLAYER_LOG_RATE_LIMITED_Critical MULTIPLAYER_LOG_RATE_LIMITED_IMPL
+#else
+#define MULTIPLAYER_LOG_CRITICAL MULTIPLAYER_LOG_DISABLED
+#define MULTIPLAYER_LOG_RATE_LIMITED_Critical MULTIPLAYER_LOG_DISABLED
+#endif
+
+/**
+ * At most per_second calls per second from this call site, e.g. for every
+ * packet of a flood; the next one through reports how many were dropped.
+ * Level is one of Trace, Debug, Info, Warn, Error, Critical.
+ */
+#define MULTIPLAYER_LOG_RATE_LIMITED(level, per_second, ...)                                       \
+    MULTIPLAYER_LOG_RATE_LIMITED_##level(level, per_second, __VA_ARGS__)
@@ -2,15 +2,84 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "network_security.h"
+#include "ascii_scan.h"
+#include "ip_address_key.h"
+#include "monotonic_clock.h"
+#include "multi_literal_matcher.h"
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
 #include <nlohmann/json.hpp>
-#include <regex>
 #include <sstream>
+#include <utility>
 
 using json = nlohmann::json;
 
 namespace Core::Multiplayer::Security {
 
+namespace {
+
+// Byte classes for the name validators, built at compile time rather than
+// compiling a std::regex on every call
+using ByteClass = std::array<bool, 256>;
+
+template <typename Predicate>
+constexpr ByteClass MakeByteClass(Predicate predicate) {
+    ByteClass table{};
+    for (size_t c = 0; c < table.size(); ++c) {
+        table[c] = predicate(static_cast<unsigned char>(c));
+    }
+    return table;
+}
+
+constexpr bool IsAsciiAlnum(unsigned char c) {
+    return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+}
+
+// [a-zA-Z0-9_-], the first segment of a protocol name
+constexpr ByteClass PROTOCOL_ROOT_CHARS =
+    MakeByteClass([](unsigned char c) { return IsAsciiAlnum(c) || c == '_' || c == '-'; });
+// [a-zA-Z0-9_.-], the later segments, which may carry a version
+constexpr ByteClass PROTOCOL_SEGMENT_CHARS = MakeByteClass(
+    [](unsigned char c) { return IsAsciiAlnum(c) || c == '_' || c == '.' || c == '-'; });
+// [1-9A-HJ-NP-Za-km-z]: no 0, I, O or l
+constexpr ByteClass BASE58_CHARS = MakeByteClass([](unsigned char c) {
+    return IsAsciiAlnum(c) && c != '0' && c != 'I' && c != 'O' && c != 'l';
+});
+
+// Matches ^/[a-zA-Z0-9_-]+(/[a-zA-Z0-9_.-]+)*$
+constexpr bool IsProtocolName(std::string_view protocol) {
+    const ByteClass* segment_chars = &PROTOCOL_ROOT_CHARS;
+    size_t i = 0;
+    while (i < protocol.size()) {
+        if (protocol[i] != '/') {
+            return false;
+        }
+        const size_t segment_start = ++i;
+        while (i < protocol.size() && (*segment_chars)[static_cast<unsigned char>(protocol[i])]) {
+            ++i;
+        }
+        if (i == segment_start) {
+            return false;
+        }
+        segment_chars = &PROTOCOL_SEGMENT_CHARS;
+    }
+    return i != 0;
+}
+
+constexpr bool IsBase58(std::string_view text) {
+    return std::all_of(text.begin(), text.end(),
+                       [](char c) { return BASE58_CHARS[static_cast<unsigned char>(c)]; });
+}
+
+static_assert(IsProtocolName("/sudachi/ldn/1.0.0"));
+static_assert(!IsProtocolName("/sudachi.ldn") && !IsProtocolName("/sudachi//ldn") &&
+              !IsProtocolName("/sudachi/") && !IsProtocolName("sudachi"));
+static_assert(IsBase58("12D3KooW") && !IsBase58("12D3Koo0") && !IsBase58("Il"));
+
+} // namespace
+
 // NetworkInputValidator implementation
 ValidationResult NetworkInputValidator::ValidatePacket(const std::vector<uint8_t>& data) {
     // Size validation
@@ -51,7 +120,7 @@ ValidationResult NetworkInputValidator::ValidatePacket(const std::vector<uint8_t
     return ValidationResult::Success();
 }
 
-ValidationResult NetworkInputValidator::ValidateJsonMessage(const std::string& json_str) {
+ValidationResult NetworkInputValidator::ValidateJsonText(std::string_view json_str) {
     // Size validation
     if (json_str.size() > MAX_JSON_SIZE) {
         return ValidationResult::Failure(
@@ -76,6 +145,15 @@ ValidationResult NetworkInputValidator::ValidateJsonMessage(const std::string& j
         );
     }
     
+    return ValidationResult::Success();
+}
+
+ValidationResult NetworkInputValidator::ValidateJsonMessage(const std::string& json_str) {
+    auto res = ValidateJsonText(json_str);
+    if (!res.is_valid) {
+        return res;
+    }
+
     // JSON structure validation
     return ValidateJsonStructure(json_str);
 }
@@ -96,8 +174,7 @@ ValidationResult NetworkInputValidator::ValidateProtocolName(const std::string&
     }
     
     // Protocol name should match pattern: /sudachi/protocol/version
-    std::regex protocol_pattern(R"(^/[a-zA-Z0-9_-]+(/[a-zA-Z0-9_.-]+)*$)");
-    if (!std::regex_match(protocol, protocol_pattern)) {
+    if (!IsProtocolName(protocol)) {
         return ValidationResult::Failure(
             "Invalid protocol name format: " + protocol,
             ErrorCode::InvalidParameter
@@ -123,8 +200,7 @@ ValidationResult NetworkInputValidator::ValidatePeerId(const std::string& peer_i
     }
     
     // Base58 validation (simplified - should only contain valid Base58 characters)
-    std::regex base58_pattern(R"(^[1-9A-HJ-NP-Za-km-z]+$)");
-    if (!std::regex_match(peer_id, base58_pattern)) {
+    if (!IsBase58(peer_id)) {
         return ValidationResult::Failure(
             "Invalid peer ID format (not Base58): " + peer_id,
             ErrorCode::InvalidParameter
@@ -177,16 +253,19 @@ ValidationResult NetworkInputValidator::ValidatePacketContent(const std::vector<
     return ValidationResult::Success();
 }
 
-bool NetworkInputValidator::IsValidUtf8(const std::string& str) {
+bool NetworkInputValidator::IsValidUtf8(std::string_view str) {
     // UTF-8 validation based on Markus Kuhn's well-tested algorithm
     // http://www.cl.cam.ac.uk/~mgk25/ucs/utf8_check.c
+    // Messages are mostly ASCII, so runs of it are skipped a vector at a time
+    // (see ascii_scan.h) and only multi-byte sequences go through the
+    // byte-wise checks.
     const unsigned char* s = reinterpret_cast<const unsigned char*>(str.data());
     const unsigned char* end = s + str.size();
 
     while (s < end) {
         if (*s < 0x80) {
             // 0xxxxxxx
-            ++s;
+            s = SkipAscii(s, end);
         } else if ((s[0] & 0xE0) == 0xC0) {
             // 110xxxxx 10xxxxxx
             if (s + 1 >= end || (s[1] & 0xC0) != 0x80 || (s[0] & 0xFE) == 0xC0)
@@ -216,69 +295,200 @@ bool NetworkInputValidator::IsValidUtf8(const std::string& str) {
     return true;
 }
 
-bool NetworkInputValidator::ContainsSuspiciousPatterns(const std::string& str) {
-    // Compile all patterns into a single case-insensitive regular expression to
-    // avoid allocating a lowercased copy of the input and to efficiently
-    // perform multi-pattern matching.
-    static const std::regex suspicious_regex(
-        R"(<script|javascript:|eval\(|exec\(|\.\./|..\\|cmd\.exe|/bin/|drop table|select \* from|union select|'; --)",
-        std::regex::icase);
+bool NetworkInputValidator::ContainsSuspiciousPatterns(std::string_view str) {
+    // Compiled once into a case-folding automaton, so the message is scanned
+    // in a single pass without being copied or lowercased. Matches exactly
+    // what the former case-insensitive std::regex alternation did.
+    static const MultiLiteralMatcher suspicious_literals({
+        "<script", "javascript:", "eval(", "exec(", "../", "cmd.exe", "/bin/",
+        "drop table", "select * from", "union select", "'; --"});
+    if (suspicious_literals.Contains(str)) {
+        return true;
+    }
 
-    return std::regex_search(str, suspicious_regex);
+    // The regex also had "..\\", where the dots are wildcards: a backslash
+    // after any two characters other than line terminators
+    const auto is_line_break = [](char c) { return c == '\n' || c == '\r'; };
+    for (size_t pos = str.find('\\', 2); pos != std::string_view::npos;
+         pos = str.find('\\', pos + 1)) {
+        if (!is_line_break(str[pos - 1]) && !is_line_break(str[pos - 2])) {
+            return true;
+        }
+    }
+    return false;
 }
 
 namespace {
-ValidationResult CheckJsonNode(const json& node, size_t depth) {
-    if (depth > MAX_JSON_DEPTH) {
-        return ValidationResult::Failure(
-            "JSON depth exceeds maximum allowed: " + std::to_string(depth) +
-                " > " + std::to_string(MAX_JSON_DEPTH),
-            ErrorCode::InvalidMessage);
+ValidationResult DepthFailure(size_t depth) {
+    return ValidationResult::Failure(
+        "JSON depth exceeds maximum allowed: " + std::to_string(depth) +
+            " > " + std::to_string(MAX_JSON_DEPTH),
+        ErrorCode::InvalidMessage);
+}
+
+ValidationResult ArraySizeFailure(size_t size) {
+    return ValidationResult::Failure(
+        "JSON array too large: " + std::to_string(size) +
+            " > " + std::to_string(MAX_JSON_ARRAY_SIZE),
+        ErrorCode::InvalidMessage);
+}
+
+ValidationResult ObjectSizeFailure(size_t size) {
+    return ValidationResult::Failure(
+        "JSON object too large: " + std::to_string(size) +
+            " > " + std::to_string(MAX_JSON_OBJECT_SIZE),
+        ErrorCode::InvalidMessage);
+}
+
+// Checks the depth and size limits as the parser reports each token, without
+// building a document. Stops the parse at the first violation.
+class JsonLimitsSax : public json::json_sax_t {
+public:
+    bool null() override {
+        return OnValue();
+    }
+    bool boolean(bool) override {
+        return OnValue();
+    }
+    bool number_integer(number_integer_t) override {
+        return OnValue();
+    }
+    bool number_unsigned(number_unsigned_t) override {
+        return OnValue();
+    }
+    bool number_float(number_float_t, const string_t&) override {
+        return OnValue();
+    }
+    bool string(string_t&) override {
+        return OnValue();
+    }
+    bool binary(binary_t&) override {
+        return OnValue();
+    }
+    bool start_object(std::size_t) override {
+        return OnValue() && Open(false);
+    }
+    bool key(string_t&) override {
+        return true;
+    }
+    bool end_object() override {
+        return Close();
+    }
+    bool start_array(std::size_t) override {
+        return OnValue() && Open(true);
+    }
+    bool end_array() override {
+        return Close();
+    }
+    bool parse_error(std::size_t, const std::string&, const json::exception& e) override {
+        result_ = ValidationResult::Failure("Invalid JSON format: " + std::string(e.what()),
+                                            ErrorCode::InvalidMessage);
+        return false;
     }
 
-    if (node.is_array()) {
-        if (node.size() > MAX_JSON_ARRAY_SIZE) {
-            return ValidationResult::Failure(
-                "JSON array too large: " + std::to_string(node.size()) +
-                    " > " + std::to_string(MAX_JSON_ARRAY_SIZE),
-                ErrorCode::InvalidMessage);
+    const ValidationResult& GetResult() const {
+        return result_;
+    }
+
+private:
+    struct Container {
+        bool is_array;
+        size_t size;
+    };
+
+    bool OnValue() {
+        // The root is at depth 1, as in the document the parser would build
+        const size_t depth = containers_.size() + 1;
+        if (depth > MAX_JSON_DEPTH) {
+            result_ = DepthFailure(depth);
+            return false;
         }
-        for (const auto& item : node) {
-            auto res = CheckJsonNode(item, depth + 1);
-            if (!res.is_valid) {
-                return res;
-            }
+        if (containers_.empty()) {
+            return true;
         }
-    } else if (node.is_object()) {
-        if (node.size() > MAX_JSON_OBJECT_SIZE) {
-            return ValidationResult::Failure(
-                "JSON object too large: " + std::to_string(node.size()) +
-                    " > " + std::to_string(MAX_JSON_OBJECT_SIZE),
-                ErrorCode::InvalidMessage);
+        auto& parent = containers_.back();
+        ++parent.size;
+        if (parent.is_array && parent.size > MAX_JSON_ARRAY_SIZE) {
+            result_ = ArraySizeFailure(parent.size);
+            return false;
         }
-        for (const auto& item : node.items()) {
-            auto res = CheckJsonNode(item.value(), depth + 1);
-            if (!res.is_valid) {
-                return res;
-            }
+        if (!parent.is_array && parent.size > MAX_JSON_OBJECT_SIZE) {
+            result_ = ObjectSizeFailure(parent.size);
+            return false;
         }
+        return true;
     }
 
-    return ValidationResult::Success();
-}
+    bool Open(bool is_array) {
+        containers_.push_back({is_array, 0});
+        return true;
+    }
+
+    bool Close() {
+        containers_.pop_back();
+        return true;
+    }
+
+    // Open containers, innermost last; never more than MAX_JSON_DEPTH
+    std::vector<Container> containers_;
+    ValidationResult result_ = ValidationResult::Success();
+};
 } // namespace
 
-ValidationResult NetworkInputValidator::ValidateJsonStructure(const std::string& json_str) {
+ValidationResult NetworkInputValidator::ValidateJsonStructure(std::string_view json_str) {
+    JsonLimitsSax sax;
     try {
-        auto parsed = json::parse(json_str);
+        json::sax_parse(json_str, &sax);
+    } catch (const std::exception& e) {
+        return ValidationResult::Failure(
+            "JSON validation error: " + std::string(e.what()),
+            ErrorCode::InvalidMessage
+        );
+    }
+    return sax.GetResult();
+}
 
-        auto res = CheckJsonNode(parsed, 1);
-        if (!res.is_valid) {
-            return res;
-        }
+ValidationResult NetworkInputValidator::ParseJsonMessage(std::string_view json_str,
+                                                         json& document) {
+    auto res = ValidateJsonText(json_str);
+    if (!res.is_valid) {
+        return res;
+    }
 
-        return ValidationResult::Success();
+    // Limits are enforced while the document is built, so there is no second
+    // walk over it. The callback's depth counts the containers enclosing the
+    // element, one less than the depth of the element itself.
+    ValidationResult limits = ValidationResult::Success();
+    const auto check_limits = [&limits](int depth, json::parse_event_t event, json& parsed) {
+        if (!limits.is_valid) {
+            return false;
+        }
+        switch (event) {
+        case json::parse_event_t::object_start:
+        case json::parse_event_t::array_start:
+        case json::parse_event_t::value:
+            if (static_cast<size_t>(depth) + 1 > MAX_JSON_DEPTH) {
+                limits = DepthFailure(static_cast<size_t>(depth) + 1);
+            }
+            break;
+        case json::parse_event_t::array_end:
+            if (parsed.size() > MAX_JSON_ARRAY_SIZE) {
+                limits = ArraySizeFailure(parsed.size());
+            }
+            break;
+        case json::parse_event_t::object_end:
+            if (parsed.size() > MAX_JSON_OBJECT_SIZE) {
+                limits = ObjectSizeFailure(parsed.size());
+            }
+            break;
+        case json::parse_event_t::key:
+            break;
+        }
+        return limits.is_valid;
+    };
 
+    try {
+        document = json::parse(json_str, check_limits);
     } catch (const json::parse_error& e) {
         return ValidationResult::Failure(
             "Invalid JSON format: " + std::string(e.what()),
@@ -290,278 +500,466 @@ ValidationResult NetworkInputValidator::ValidateJsonStructure(const std::string&
             ErrorCode::InvalidMessage
         );
     }
+    if (!limits.is_valid) {
+        document = nullptr;
+    }
+    return limits;
 }
 
 // TokenBucketRateLimit implementation
-TokenBucketRateLimit::TokenBucketRateLimit(double capacity, double refill_rate)
-    : capacity_(capacity), refill_rate_(refill_rate), tokens_(capacity) {
-    last_refill_ = std::chrono::steady_clock::now();
+namespace {
+
+// Finest token resolution; coarser for very large buckets so the scaled
+// capacity still fits in 32 bits
+constexpr double MAX_TOKEN_SCALE = 1024.0;
+
+double TokenScaleFor(double capacity) {
+    const double max_scale = static_cast<double>(UINT32_MAX) / std::max(capacity, 1.0);
+    return std::clamp(std::floor(max_scale), 1.0, MAX_TOKEN_SCALE);
 }
 
+} // anonymous namespace
+
+TokenBucketRateLimit::TokenBucketRateLimit(double capacity, double refill_rate)
+    : epoch_ns_(MonotonicClock::Now()), scale_(TokenScaleFor(capacity)),
+      scaled_capacity_(static_cast<uint64_t>(
+          std::min(std::max(capacity, 0.0) * scale_, static_cast<double>(UINT32_MAX)))),
+      scaled_refill_per_ms_(std::max(refill_rate, 0.0) * scale_ / 1000.0),
+      state_(Pack(scaled_capacity_, 0)) {}
+
 bool TokenBucketRateLimit::TryConsume(double tokens) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    Refill();
-    
-    if (tokens_ >= tokens) {
-        tokens_ -= tokens;
-        return true;
+    const auto needed = static_cast<uint64_t>(std::ceil(std::max(tokens, 0.0) * scale_));
+    const uint32_t now_ms = NowMs();
+
+    uint64_t current = state_.load(std::memory_order_relaxed);
+    while (true) {
+        const uint64_t refilled = RefilledState(current, now_ms);
+        const uint64_t available = refilled >> 32;
+        if (available < needed) {
+            return false;
+        }
+
+        const uint64_t desired = Pack(available - needed, static_cast<uint32_t>(refilled));
+        if (state_.compare_exchange_weak(current, desired, std::memory_order_relaxed)) {
+            return true;
+        }
     }
-    
-    return false;
 }
 
 double TokenBucketRateLimit::GetTokens() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return tokens_;
+    const uint64_t refilled = RefilledState(state_.load(std::memory_order_relaxed), NowMs());
+    return static_cast<double>(refilled >> 32) / scale_;
 }
 
 void TokenBucketRateLimit::Reset() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    tokens_ = capacity_;
-    last_refill_ = std::chrono::steady_clock::now();
+    state_.store(Pack(scaled_capacity_, NowMs()), std::memory_order_relaxed);
 }
 
-void TokenBucketRateLimit::Refill() {
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration<double>(now - last_refill_).count();
-    
-    double tokens_to_add = elapsed * refill_rate_;
-    tokens_ = std::min(capacity_, tokens_ + tokens_to_add);
-    
-    last_refill_ = now;
+uint32_t TokenBucketRateLimit::NowMs() const {
+    const uint64_t elapsed_ns = MonotonicClock::Now() - epoch_ns_;
+    return static_cast<uint32_t>(elapsed_ns / 1'000'000); // Wraps every ~49 days
+}
+
+uint64_t TokenBucketRateLimit::RefilledState(uint64_t state, uint32_t now_ms) const {
+    const uint64_t tokens = state >> 32;
+    const auto last_ms = static_cast<uint32_t>(state);
+    if (tokens >= scaled_capacity_) {
+        return Pack(scaled_capacity_, now_ms);
+    }
+
+    // Wrap-safe difference; a racing consumer may already have stored a
+    // timestamp newer than ours, which counts as no time elapsed
+    const auto elapsed_ms = static_cast<int32_t>(now_ms - last_ms);
+    if (elapsed_ms <= 0) {
+        return state;
+    }
+    const auto added = static_cast<uint64_t>(elapsed_ms * scaled_refill_per_ms_);
+    if (added == 0) {
+        // Keep the old timestamp so sub-unit refills accumulate across calls
+        return state;
+    }
+    return Pack(std::min(scaled_capacity_, tokens + added), now_ms);
 }
 
 // ClientRateManager implementation
-ClientRateManager::ClientRateManager(const RateLimitConfig& config) : config_(config) {}
+ClientRateManager::ClientLimits::ClientLimits(const RateLimitConfig& config, int64_t now_ms)
+    : packet_limiter(config.burst_capacity, config.packets_per_second),
+      byte_limiter(config.byte_burst_capacity, config.bytes_per_second),
+      last_activity_ms(now_ms) {}
+
+ClientRateManager::ClientRateManager(const RateLimitConfig& config,
+                                     std::shared_ptr<TimerWheel> timer_wheel)
+    : config_(config),
+      timer_wheel_(timer_wheel ? std::move(timer_wheel) : TimerWheel::GetShared()) {
+    eviction_timer_ =
+        timer_wheel_->ScheduleRepeating(EVICTION_INTERVAL, [this]() { SweepNextShard(); });
+}
+
+ClientRateManager::~ClientRateManager() {
+    // Waits for an in-flight sweep, so the shards outlive it
+    timer_wheel_->Cancel(eviction_timer_);
+}
+
+template <typename Operation>
+bool ClientRateManager::WithClientLimits(const std::string& client_id, Operation&& operation) {
+    Shard& shard = GetShard(client_id);
+    {
+        std::shared_lock lock(shard.mutex);
+        auto it = shard.clients.find(client_id);
+        if (it != shard.clients.end()) {
+            return operation(it->second);
+        }
+    }
+
+    // First packet from this client: take the shard exclusively to insert
+    std::unique_lock lock(shard.mutex);
+    const auto [it, inserted] = shard.clients.try_emplace(client_id, config_, NowMs());
+    if (inserted) {
+        client_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return operation(it->second);
+}
 
 bool ClientRateManager::CheckPacketRateLimit(const std::string& client_id) {
-    std::lock_guard<std::mutex> lock(clients_mutex_);
-    
-    auto* limits = GetOrCreateClientLimits(client_id);
-    limits->total_packets++;
-    limits->last_activity = std::chrono::steady_clock::now();
-    
-    return limits->packet_limiter->TryConsume(1.0);
+    Count(Counter::PacketsChecked);
+    const bool allowed = WithClientLimits(client_id, [](ClientLimits& limits) {
+        limits.total_packets.fetch_add(1, std::memory_order_relaxed);
+        limits.last_activity_ms.store(NowMs(), std::memory_order_relaxed);
+        return limits.packet_limiter.TryConsume(1.0);
+    });
+    if (!allowed) {
+        Count(Counter::PacketsLimited);
+    }
+    return allowed;
 }
 
 bool ClientRateManager::CheckByteRateLimit(const std::string& client_id, size_t bytes) {
-    std::lock_guard<std::mutex> lock(clients_mutex_);
-    
-    auto* limits = GetOrCreateClientLimits(client_id);
-    limits->total_bytes += bytes;
-    limits->last_activity = std::chrono::steady_clock::now();
-    
-    return limits->byte_limiter->TryConsume(static_cast<double>(bytes));
+    Count(Counter::BytesChecked, bytes);
+    const bool allowed = WithClientLimits(client_id, [bytes](ClientLimits& limits) {
+        limits.total_bytes.fetch_add(bytes, std::memory_order_relaxed);
+        limits.last_activity_ms.store(NowMs(), std::memory_order_relaxed);
+        return limits.byte_limiter.TryConsume(static_cast<double>(bytes));
+    });
+    if (!allowed) {
+        Count(Counter::BytesLimited, bytes);
+    }
+    return allowed;
 }
 
 void ClientRateManager::RemoveClient(const std::string& client_id) {
-    std::lock_guard<std::mutex> lock(clients_mutex_);
-    client_limits_.erase(client_id);
+    Shard& shard = GetShard(client_id);
+    std::unique_lock lock(shard.mutex);
+    if (shard.clients.erase(client_id) != 0) {
+        client_count_.fetch_sub(1, std::memory_order_relaxed);
+    }
 }
 
 std::string ClientRateManager::GetClientStats(const std::string& client_id) const {
-    std::lock_guard<std::mutex> lock(clients_mutex_);
-    
-    auto it = client_limits_.find(client_id);
-    if (it == client_limits_.end()) {
+    const auto stats = GetClientStatistics(client_id);
+    if (!stats) {
         return "Client not found";
     }
-    
+    return FormatClientRateStatistics(client_id, *stats);
+}
+
+std::optional<ClientRateStatistics> ClientRateManager::GetClientStatistics(
+    const std::string& client_id) const {
+    const Shard& shard = GetShard(client_id);
+    std::shared_lock lock(shard.mutex);
+
+    auto it = shard.clients.find(client_id);
+    if (it == shard.clients.end()) {
+        return std::nullopt;
+    }
+
     const auto& limits = it->second;
-    std::ostringstream oss;
-    oss << "Client " << client_id << ": "
-        << "Packets=" << limits->total_packets << ", "
-        << "Bytes=" << limits->total_bytes << ", "
-        << "PacketTokens=" << limits->packet_limiter->GetTokens() << ", "
-        << "ByteTokens=" << limits->byte_limiter->GetTokens();
-    
-    return oss.str();
+    ClientRateStatistics stats;
+    stats.total_packets = limits.total_packets.load(std::memory_order_relaxed);
+    stats.total_bytes = limits.total_bytes.load(std::memory_order_relaxed);
+    stats.packet_tokens = limits.packet_limiter.GetTokens();
+    stats.byte_tokens = limits.byte_limiter.GetTokens();
+    return stats;
 }
 
-ClientRateManager::ClientLimits* ClientRateManager::GetOrCreateClientLimits(const std::string& client_id) {
-    auto it = client_limits_.find(client_id);
-    if (it == client_limits_.end()) {
-        auto limits = std::make_unique<ClientLimits>();
-        limits->packet_limiter = std::make_unique<TokenBucketRateLimit>(
-            config_.burst_capacity, config_.packets_per_second);
-        limits->byte_limiter = std::make_unique<TokenBucketRateLimit>(
-            config_.byte_burst_capacity, config_.bytes_per_second);
-        limits->last_activity = std::chrono::steady_clock::now();
-        limits->total_packets = 0;
-        limits->total_bytes = 0;
-        
-        auto* ptr = limits.get();
-        client_limits_[client_id] = std::move(limits);
-        return ptr;
+RateLimitStatistics ClientRateManager::GetStatistics() const {
+    RateLimitStatistics stats;
+    stats.tracked_clients = client_count_.load(std::memory_order_relaxed);
+    stats.packets_checked = counters_.Load(static_cast<size_t>(Counter::PacketsChecked));
+    stats.packets_limited = counters_.Load(static_cast<size_t>(Counter::PacketsLimited));
+    stats.bytes_checked = counters_.Load(static_cast<size_t>(Counter::BytesChecked));
+    stats.bytes_limited = counters_.Load(static_cast<size_t>(Counter::BytesLimited));
+    stats.clients_evicted = counters_.Load(static_cast<size_t>(Counter::ClientsEvicted));
+    return stats;
+}
+
+size_t ClientRateManager::GetClientCount() const {
+    return client_count_.load(std::memory_order_relaxed);
+}
+
+size_t ClientRateManager::EvictIdleClients() {
+    const int64_t now_ms = NowMs();
+    size_t evicted = 0;
+    for (auto& shard : shards_) {
+        evicted += EvictIdleClientsInShard(shard, now_ms);
     }
-    
-    return it->second.get();
+    return evicted;
 }
 
-void ClientRateManager::CleanupInactiveClients() {
-    auto now = std::chrono::steady_clock::now();
-    auto timeout = std::chrono::minutes(30); // Remove clients inactive for 30 minutes
-    
-    for (auto it = client_limits_.begin(); it != client_limits_.end();) {
-        if (now - it->second->last_activity > timeout) {
-            it = client_limits_.erase(it);
+ClientRateManager::Shard& ClientRateManager::GetShard(const std::string& client_id) {
+    return const_cast<Shard&>(std::as_const(*this).GetShard(client_id));
+}
+
+const ClientRateManager::Shard& ClientRateManager::GetShard(const std::string& client_id) const {
+    // Fibonacci mixing so the shard choice does not reuse the low bits the
+    // per-shard unordered_map buckets on
+    const uint64_t hash = std::hash<std::string>{}(client_id);
+    const uint64_t mixed = hash * 0x9E3779B97F4A7C15ULL;
+    return shards_[(mixed >> 32) % SHARD_COUNT];
+}
+
+size_t ClientRateManager::EvictIdleClientsInShard(Shard& shard, int64_t now_ms) {
+    const int64_t timeout_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(config_.idle_client_timeout).count();
+
+    std::unique_lock lock(shard.mutex);
+    size_t evicted = 0;
+    for (auto it = shard.clients.begin(); it != shard.clients.end();) {
+        if (now_ms - it->second.last_activity_ms.load(std::memory_order_relaxed) > timeout_ms) {
+            it = shard.clients.erase(it);
+            ++evicted;
         } else {
             ++it;
         }
     }
+    if (evicted != 0) {
+        client_count_.fetch_sub(evicted, std::memory_order_relaxed);
+        Count(Counter::ClientsEvicted, evicted);
+    }
+    return evicted;
+}
+
+void ClientRateManager::SweepNextShard() {
+    // One shard per tick keeps each timer callback short
+    const size_t index = next_sweep_shard_.fetch_add(1, std::memory_order_relaxed) % SHARD_COUNT;
+    EvictIdleClientsInShard(shards_[index], NowMs());
+}
+
+int64_t ClientRateManager::NowMs() {
+    return static_cast<int64_t>(MonotonicClock::Now() / 1'000'000);
 }
 
 // DDoSProtection implementation
-DDoSProtection::DDoSProtection(const DDoSProtectionConfig& config) : config_(config) {
+DDoSProtection::DDoSProtection(const DDoSProtectionConfig& config,
+                               std::shared_ptr<TimerWheel> timer_wheel)
+    : config_(config),
+      timer_wheel_(timer_wheel ? std::move(timer_wheel) : TimerWheel::GetShared()) {
     global_packet_limiter_ = std::make_unique<TokenBucketRateLimit>(
         static_cast<double>(config_.max_packets_per_second * 2), // 2x burst capacity
         static_cast<double>(config_.max_packets_per_second)
     );
+    cleanup_timer_ = timer_wheel_->ScheduleRepeating(CLEANUP_INTERVAL, [this]() { Cleanup(); });
+}
+
+DDoSProtection::~DDoSProtection() {
+    // Waits for an in-flight sweep, so the tables outlive it
+    timer_wheel_->Cancel(cleanup_timer_);
 }
 
 bool DDoSProtection::AllowNewConnection(const std::string& ip_address) {
-    std::lock_guard<std::mutex> lock(protection_mutex_);
-    
     // Validate IP address format
-    if (!IsValidIPAddress(ip_address)) {
+    const auto address = IpAddressKey::Parse(ip_address);
+    if (!address) {
         return false;
     }
+    return AllowNewConnection(*address);
+}
+
+bool DDoSProtection::AllowNewConnection(const IpAddressKey& address) {
+    std::lock_guard<std::mutex> lock(protection_mutex_);
     
     // Check if IP is blacklisted
-    if (IsBlacklisted(ip_address)) {
+    if (IsBlacklistedLocked(address, std::chrono::steady_clock::now())) {
+        Count(Counter::BlacklistRejections);
         return false;
     }
     
     // Check global connection limit
     if (active_connections_.load() >= config_.max_total_connections) {
+        Count(Counter::ConnectionLimitRejections);
         return false;
     }
     
-    // Check per-IP connection limit
-    auto& ip_info = ip_connections_[ip_address];
-    if (ip_info.connection_count >= config_.max_connections_per_ip) {
+    // Check per-IP connection limit; an address is only stored once it connects
+    const IPInfo* ip_info = ip_connections_.Find(address);
+    if (ip_info && ip_info->connection_count >= config_.max_connections_per_ip) {
         // Blacklist IP for too many connections
-        BlacklistIP(ip_address, "Too many connections from IP");
+        BlacklistLocked(address, IpAddressKey::BITS, "Too many connections from IP");
+        Count(Counter::PerAddressRejections);
         return false;
     }
     
+    Count(Counter::ConnectionsAllowed);
     return true;
 }
 
 void DDoSProtection::RegisterConnection(const std::string& ip_address, const std::string& connection_id) {
+    // Connections are counted per address; the id is not needed to remove one
+    (void)connection_id;
+    if (const auto address = IpAddressKey::Parse(ip_address)) {
+        RegisterConnection(*address);
+    }
+}
+
+void DDoSProtection::RegisterConnection(const IpAddressKey& address) {
     std::lock_guard<std::mutex> lock(protection_mutex_);
     
     active_connections_.fetch_add(1);
     
-    auto& ip_info = ip_connections_[ip_address];
+    const auto now = std::chrono::steady_clock::now();
+    auto& ip_info = ip_connections_.FindOrInsert(address);
     if (ip_info.connection_count == 0) {
-        ip_info.first_connection = std::chrono::steady_clock::now();
+        ip_info.first_connection = now;
     }
     
     ip_info.connection_count++;
-    ip_info.connection_ids.push_back(connection_id);
-    ip_info.last_activity = std::chrono::steady_clock::now();
+    ip_info.last_activity = now;
+    PublishSizesLocked();
 }
 
 void DDoSProtection::RemoveConnection(const std::string& ip_address, const std::string& connection_id) {
+    (void)connection_id;
+    if (const auto address = IpAddressKey::Parse(ip_address)) {
+        RemoveConnection(*address);
+    }
+}
+
+void DDoSProtection::RemoveConnection(const IpAddressKey& address) {
     std::lock_guard<std::mutex> lock(protection_mutex_);
     
     active_connections_.fetch_sub(1);
     
-    auto it = ip_connections_.find(ip_address);
-    if (it != ip_connections_.end()) {
-        auto& ip_info = it->second;
-        
-        // Remove connection ID
-        auto conn_it = std::find(ip_info.connection_ids.begin(), ip_info.connection_ids.end(), connection_id);
-        if (conn_it != ip_info.connection_ids.end()) {
-            ip_info.connection_ids.erase(conn_it);
-        }
-        
-        if (ip_info.connection_count > 0) {
-            ip_info.connection_count--;
+    auto* ip_info = ip_connections_.Find(address);
+    if (ip_info) {
+        if (ip_info->connection_count > 0) {
+            ip_info->connection_count--;
         }
         
         // Remove IP info if no connections remain
-        if (ip_info.connection_count == 0) {
-            ip_connections_.erase(it);
+        if (ip_info->connection_count == 0) {
+            ip_connections_.Erase(address);
         } else {
-            ip_info.last_activity = std::chrono::steady_clock::now();
+            ip_info->last_activity = std::chrono::steady_clock::now();
         }
     }
+    PublishSizesLocked();
 }
 
 bool DDoSProtection::CheckGlobalPacketRate() {
-    return global_packet_limiter_->TryConsume(1.0);
+    if (!global_packet_limiter_->TryConsume(1.0)) {
+        Count(Counter::GlobalRateLimited);
+        return false;
+    }
+    return true;
 }
 
 void DDoSProtection::BlacklistIP(const std::string& ip_address, const std::string& reason) {
+    const auto prefix = IpAddressKey::ParsePrefix(ip_address);
+    if (!prefix) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(protection_mutex_);
+    BlacklistLocked(prefix->first, prefix->second, reason);
+}
+
+void DDoSProtection::BlacklistPrefix(const IpAddressKey& address, uint8_t prefix_length,
+                                     const std::string& reason) {
+    std::lock_guard<std::mutex> lock(protection_mutex_);
+    BlacklistLocked(address, std::min(prefix_length, IpAddressKey::BITS), reason);
+}
+
+void DDoSProtection::BlacklistLocked(const IpAddressKey& address, uint8_t prefix_length,
+                                     const std::string& reason) {
     BlacklistEntry entry;
     entry.blacklist_time = std::chrono::steady_clock::now();
     entry.reason = reason;
     
-    blacklisted_ips_[ip_address] = entry;
+    blacklist_.Insert(address, prefix_length, std::move(entry));
+    PublishSizesLocked();
+}
+
+void DDoSProtection::PublishSizesLocked() {
+    unique_addresses_.store(ip_connections_.Size(), std::memory_order_relaxed);
+    blacklist_entries_.store(blacklist_.Size(), std::memory_order_relaxed);
 }
 
 bool DDoSProtection::IsBlacklisted(const std::string& ip_address) const {
-    auto it = blacklisted_ips_.find(ip_address);
-    if (it == blacklisted_ips_.end()) {
+    const auto address = IpAddressKey::Parse(ip_address);
+    return address && IsBlacklisted(*address);
+}
+
+bool DDoSProtection::IsBlacklisted(const IpAddressKey& address) const {
+    std::lock_guard<std::mutex> lock(protection_mutex_);
+    return IsBlacklistedLocked(address, std::chrono::steady_clock::now());
+}
+
+bool DDoSProtection::IsBlacklistedLocked(const IpAddressKey& address,
+                                         std::chrono::steady_clock::time_point now) const {
+    if (blacklist_.Empty()) {
         return false;
     }
-    
-    // Check if blacklist has expired
-    auto now = std::chrono::steady_clock::now();
-    if (now - it->second.blacklist_time > config_.blacklist_duration) {
-        return false; // Expired
-    }
-    
-    return true;
+    // Expired bans still in the trie until the next sweep are ignored
+    return blacklist_.AnyMatch(address, [&](const BlacklistEntry& entry) {
+        return now - entry.blacklist_time <= config_.blacklist_duration;
+    });
 }
 
 std::string DDoSProtection::GetProtectionStats() const {
+    return FormatProtectionStatistics(GetProtectionStatistics());
+}
+
+ProtectionStatistics DDoSProtection::GetProtectionStatistics() const {
+    ProtectionStatistics stats;
+    stats.active_connections = active_connections_.load(std::memory_order_relaxed);
+    stats.max_connections = config_.max_total_connections;
+    stats.unique_addresses = unique_addresses_.load(std::memory_order_relaxed);
+    stats.blacklist_entries = blacklist_entries_.load(std::memory_order_relaxed);
+    stats.global_packet_tokens = global_packet_limiter_->GetTokens();
+    stats.connections_allowed = counters_.Load(static_cast<size_t>(Counter::ConnectionsAllowed));
+    stats.blacklist_rejections = counters_.Load(static_cast<size_t>(Counter::BlacklistRejections));
+    stats.connection_limit_rejections =
+        counters_.Load(static_cast<size_t>(Counter::ConnectionLimitRejections));
+    stats.per_address_rejections =
+        counters_.Load(static_cast<size_t>(Counter::PerAddressRejections));
+    stats.global_rate_limited = counters_.Load(static_cast<size_t>(Counter::GlobalRateLimited));
+    return stats;
+}
+
+void DDoSProtection::Cleanup() {
     std::lock_guard<std::mutex> lock(protection_mutex_);
-    
-    std::ostringstream oss;
-    oss << "DDoS Protection Stats:\n"
-        << "  Active connections: " << active_connections_.load() << "/" << config_.max_total_connections << "\n"
-        << "  Unique IPs: " << ip_connections_.size() << "\n"
-        << "  Blacklisted IPs: " << blacklisted_ips_.size() << "\n"
-        << "  Global packet tokens: " << global_packet_limiter_->GetTokens();
-    
-    return oss.str();
+    CleanupExpiredBlacklist();
+    CleanupInactiveConnections();
+    PublishSizesLocked();
 }
 
 void DDoSProtection::CleanupExpiredBlacklist() {
     auto now = std::chrono::steady_clock::now();
     
-    for (auto it = blacklisted_ips_.begin(); it != blacklisted_ips_.end();) {
-        if (now - it->second.blacklist_time > config_.blacklist_duration) {
-            it = blacklisted_ips_.erase(it);
-        } else {
-            ++it;
-        }
-    }
+    blacklist_.EraseIf([&](const IpAddressKey&, uint8_t, const BlacklistEntry& entry) {
+        return now - entry.blacklist_time > config_.blacklist_duration;
+    });
 }
 
 void DDoSProtection::CleanupInactiveConnections() {
     auto now = std::chrono::steady_clock::now();
     
-    for (auto it = ip_connections_.begin(); it != ip_connections_.end();) {
-        if (now - it->second.last_activity > config_.connection_timeout) {
-            // Adjust active connection count
-            active_connections_.fetch_sub(it->second.connection_count);
-            it = ip_connections_.erase(it);
-        } else {
-            ++it;
+    ip_connections_.EraseIf([&](const IpAddressKey&, const IPInfo& info) {
+        if (now - info.last_activity <= config_.connection_timeout) {
+            return false;
         }
-    }
-}
-
-bool DDoSProtection::IsValidIPAddress(const std::string& ip_address) const {
-    // Simple IPv4 validation (can be enhanced for IPv6)
-    std::regex ipv4_pattern(R"(^((25[0-5]|2[0-4][0-9]|[01]?[0-9][0-9]?)\.){3}(25[0-5]|2[0-4][0-9]|[01]?[0-9][0-9]?)$)");
-    return std::regex_match(ip_address, ipv4_pattern);
+        // Adjust active connection count
+        active_connections_.fetch_sub(info.connection_count);
+        return true;
+    });
 }
 
 // NetworkSecurityManager implementation
@@ -579,7 +977,52 @@ ValidationResult NetworkSecurityManager::ValidateIncomingPacket(
     const std::vector<uint8_t>& data,
     const std::string& protocol) {
     
+    return Record(CheckIncomingPacket(client_id, client_ip, data, protocol),
+                  Counter::PacketsAccepted, Counter::PacketsRejected);
+}
+
+ValidationResult NetworkSecurityManager::ValidateIncomingJsonMessage(
+    const std::string& client_id,
+    const std::string& client_ip,
+    const std::string& json_message) {
+    
+    return Record(CheckIncomingJsonMessage(client_id, client_ip, json_message),
+                  Counter::JsonMessagesAccepted, Counter::JsonMessagesRejected);
+}
+
+ValidationResult NetworkSecurityManager::ValidateIncomingJsonMessage(
+    const std::string& client_id,
+    const std::string& client_ip,
+    const std::string& json_message,
+    json& document) {
+    
+    return Record(CheckIncomingJsonMessage(client_id, client_ip, json_message, document),
+                  Counter::JsonMessagesAccepted, Counter::JsonMessagesRejected);
+}
+
+ValidationResult NetworkSecurityManager::CheckIncomingPacket(
+    const std::string& client_id,
+    const std::string& client_ip,
+    const std::vector<uint8_t>& data,
+    const std::string& protocol) {
+    
     // Global rate limiting check
+    auto rate_result = CheckGlobalPacketRate();
+    if (!rate_result.is_valid) {
+        return rate_result;
+    }
+    
+    // Input validation
+    auto input_result = CheckPacketInput(data, protocol);
+    if (!input_result.is_valid) {
+        return input_result;
+    }
+    
+    // Rate limiting check
+    return CheckPacketRate(client_id, data.size());
+}
+
+ValidationResult NetworkSecurityManager::CheckGlobalPacketRate() {
     if (!ddos_protection_->CheckGlobalPacketRate()) {
         return ValidationResult::Failure(
             "Global packet rate limit exceeded",
@@ -587,23 +1030,24 @@ ValidationResult NetworkSecurityManager::ValidateIncomingPacket(
         );
     }
     
-    // Input validation
-    auto validation_result = NetworkInputValidator::ValidatePacket(data);
-    if (!validation_result.is_valid) {
-        return validation_result;
-    }
-    
-    auto protocol_result = NetworkInputValidator::ValidateProtocolName(protocol);
-    if (!protocol_result.is_valid) {
-        return protocol_result;
+    return ValidationResult::Success();
+}
+
+ValidationResult NetworkSecurityManager::CheckPacketSource(const IpAddressKey& address) {
+    if (ddos_protection_->IsBlacklisted(address)) {
+        return ValidationResult::Failure(
+            "Packet from blacklisted address",
+            ErrorCode::ConnectionRefused
+        );
     }
     
-    auto content_result = NetworkInputValidator::ValidatePacketContent(data, protocol);
-    if (!content_result.is_valid) {
-        return content_result;
-    }
+    return ValidationResult::Success();
+}
+
+ValidationResult NetworkSecurityManager::CheckPacketRate(
+    const std::string& client_id,
+    size_t packet_size) {
     
-    // Rate limiting check
     if (!rate_manager_->CheckPacketRateLimit(client_id)) {
         return ValidationResult::Failure(
             "Client packet rate limit exceeded",
@@ -611,7 +1055,7 @@ ValidationResult NetworkSecurityManager::ValidateIncomingPacket(
         );
     }
     
-    if (!rate_manager_->CheckByteRateLimit(client_id, data.size())) {
+    if (!rate_manager_->CheckByteRateLimit(client_id, packet_size)) {
         return ValidationResult::Failure(
             "Client byte rate limit exceeded",
             ErrorCode::NetworkTimeout
@@ -621,7 +1065,28 @@ ValidationResult NetworkSecurityManager::ValidateIncomingPacket(
     return ValidationResult::Success();
 }
 
-ValidationResult NetworkSecurityManager::ValidateIncomingJsonMessage(
+ValidationResult NetworkSecurityManager::CheckPacketInput(
+    const std::vector<uint8_t>& data,
+    const std::string& protocol) {
+    
+    auto validation_result = NetworkInputValidator::ValidatePacket(data);
+    if (!validation_result.is_valid) {
+        return validation_result;
+    }
+    
+    auto protocol_result = NetworkInputValidator::ValidateProtocolName(protocol);
+    if (!protocol_result.is_valid) {
+        return protocol_result;
+    }
+    
+    return NetworkInputValidator::ValidatePacketContent(data, protocol);
+}
+
+void NetworkSecurityManager::RecordPacketResult(bool accepted) {
+    counters_.Add(static_cast<size_t>(accepted ? Counter::PacketsAccepted : Counter::PacketsRejected));
+}
+
+ValidationResult NetworkSecurityManager::CheckIncomingJsonMessage(
     const std::string& client_id,
     const std::string& client_ip,
     const std::string& json_message) {
@@ -640,6 +1105,35 @@ ValidationResult NetworkSecurityManager::ValidateIncomingJsonMessage(
         return validation_result;
     }
     
+    return CheckClientMessageRate(client_id, json_message.size());
+}
+
+ValidationResult NetworkSecurityManager::CheckIncomingJsonMessage(
+    const std::string& client_id,
+    const std::string& client_ip,
+    const std::string& json_message,
+    json& document) {
+    
+    if (!ddos_protection_->CheckGlobalPacketRate()) {
+        return ValidationResult::Failure(
+            "Global packet rate limit exceeded",
+            ErrorCode::NetworkTimeout
+        );
+    }
+    
+    // Input validation and parsing in the same pass
+    auto validation_result = NetworkInputValidator::ParseJsonMessage(json_message, document);
+    if (!validation_result.is_valid) {
+        return validation_result;
+    }
+    
+    return CheckClientMessageRate(client_id, json_message.size());
+}
+
+ValidationResult NetworkSecurityManager::CheckClientMessageRate(
+    const std::string& client_id,
+    size_t message_size) {
+    
     // Rate limiting check
     if (!rate_manager_->CheckPacketRateLimit(client_id)) {
         return ValidationResult::Failure(
@@ -648,7 +1142,7 @@ ValidationResult NetworkSecurityManager::ValidateIncomingJsonMessage(
         );
     }
     
-    if (!rate_manager_->CheckByteRateLimit(client_id, json_message.size())) {
+    if (!rate_manager_->CheckByteRateLimit(client_id, message_size)) {
         return ValidationResult::Failure(
             "Client byte rate limit exceeded",
             ErrorCode::NetworkTimeout
@@ -684,12 +1178,67 @@ void NetworkSecurityManager::RemoveClient(
 }
 
 std::string NetworkSecurityManager::GetSecurityStats() const {
+    return FormatSecurityStatistics(GetSecurityStatistics());
+}
+
+SecurityStatistics NetworkSecurityManager::GetSecurityStatistics() const {
+    SecurityStatistics stats;
+    stats.protection = ddos_protection_->GetProtectionStatistics();
+    stats.rate_limits = rate_manager_->GetStatistics();
+    stats.packets_accepted = counters_.Load(static_cast<size_t>(Counter::PacketsAccepted));
+    stats.packets_rejected = counters_.Load(static_cast<size_t>(Counter::PacketsRejected));
+    stats.json_messages_accepted =
+        counters_.Load(static_cast<size_t>(Counter::JsonMessagesAccepted));
+    stats.json_messages_rejected =
+        counters_.Load(static_cast<size_t>(Counter::JsonMessagesRejected));
+    return stats;
+}
+
+ValidationResult NetworkSecurityManager::Record(ValidationResult result, Counter accepted,
+                                                Counter rejected) {
+    counters_.Add(static_cast<size_t>(result.is_valid ? accepted : rejected));
+    return result;
+}
+
+std::string FormatClientRateStatistics(const std::string& client_id,
+                                       const ClientRateStatistics& stats) {
+    std::ostringstream oss;
+    oss << "Client " << client_id << ": "
+        << "Packets=" << stats.total_packets << ", "
+        << "Bytes=" << stats.total_bytes << ", "
+        << "PacketTokens=" << stats.packet_tokens << ", "
+        << "ByteTokens=" << stats.byte_tokens;
+    return oss.str();
+}
+
+std::string FormatProtectionStatistics(const ProtectionStatistics& stats) {
+    std::ostringstream oss;
+    oss << "DDoS Protection Stats:\n"
+        << "  Active connections: " << stats.active_connections << "/" << stats.max_connections << "\n"
+        << "  Unique IPs: " << stats.unique_addresses << "\n"
+        << "  Blacklisted IPs: " << stats.blacklist_entries << "\n"
+        << "  Global packet tokens: " << stats.global_packet_tokens << "\n"
+        << "  Connections allowed: " << stats.connections_allowed << "\n"
+        << "  Rejected (blacklisted/full/per-IP): " << stats.blacklist_rejections << "/"
+        << stats.connection_limit_rejections << "/" << stats.per_address_rejections << "\n"
+        << "  Global rate limited packets: " << stats.global_rate_limited;
+    return oss.str();
+}
+
+std::string FormatSecurityStatistics(const SecurityStatistics& stats) {
+    const auto& rates = stats.rate_limits;
     std::ostringstream oss;
     oss << "=== Network Security Statistics ===\n";
-    oss << ddos_protection_->GetProtectionStats() << "\n";
-    oss << "Rate limiting active for various clients\n";
+    oss << FormatProtectionStatistics(stats.protection) << "\n";
+    oss << "Rate limiting: " << rates.tracked_clients << " clients, "
+        << rates.packets_limited << "/" << rates.packets_checked << " packets and "
+        << rates.bytes_limited << "/" << rates.bytes_checked << " bytes limited, "
+        << rates.clients_evicted << " idle clients evicted\n";
+    oss << "Packets accepted/rejected: " << stats.packets_accepted << "/"
+        << stats.packets_rejected << "\n";
+    oss << "JSON messages accepted/rejected: " << stats.json_messages_accepted << "/"
+        << stats.json_messages_rejected << "\n";
     oss << "=====================================";
-    
     return oss.str();
 }
 
@@ -4,13 +4,24 @@
 #pragma once
 
 #include "error_codes.h"
+#include "ip_address_map.h"
+#include "ip_prefix_trie.h"
+#include "lock_contention.h"
+#include "memory_accounting.h"
+#include "sharded_counters.h"
+#include "timer_wheel.h"
+#include <nlohmann/json_fwd.hpp>
+#include <array>
 #include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <memory>
+#include <memory_resource>
 #include <mutex>
-#include <atomic>
-#include <regex>
+#include <optional>
+#include <shared_mutex>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -45,6 +56,7 @@ struct RateLimitConfig {
     double burst_capacity = 120.0;        // Allow bursts up to 120 packets
     double bytes_per_second = 1048576.0;  // 1MB per second per client
     double byte_burst_capacity = 2097152.0; // 2MB burst capacity
+    std::chrono::seconds idle_client_timeout{1800}; // Evict clients idle for 30 minutes
 };
 
 /**
@@ -78,6 +90,64 @@ struct ValidationResult {
     }
 };
 
+/**
+ * Rate limiting counters, summed over all clients
+ */
+struct RateLimitStatistics {
+    size_t tracked_clients = 0;
+    uint64_t packets_checked = 0;
+    uint64_t packets_limited = 0;
+    uint64_t bytes_checked = 0;
+    uint64_t bytes_limited = 0;  // Bytes in messages rejected by the byte limit
+    uint64_t clients_evicted = 0;
+};
+
+/**
+ * Rate limiting state of a single client
+ */
+struct ClientRateStatistics {
+    uint64_t total_packets = 0;
+    uint64_t total_bytes = 0;
+    double packet_tokens = 0.0;
+    double byte_tokens = 0.0;
+};
+
+/**
+ * DDoS protection counters and table sizes
+ */
+struct ProtectionStatistics {
+    size_t active_connections = 0;
+    size_t max_connections = 0;
+    size_t unique_addresses = 0;
+    size_t blacklist_entries = 0;
+    double global_packet_tokens = 0.0;
+    uint64_t connections_allowed = 0;
+    uint64_t blacklist_rejections = 0;
+    uint64_t connection_limit_rejections = 0;  // Global connection limit reached
+    uint64_t per_address_rejections = 0;       // Address over its limit, now banned
+    uint64_t global_rate_limited = 0;          // Packets over the global packet rate
+};
+
+/**
+ * Everything NetworkSecurityManager counts
+ */
+struct SecurityStatistics {
+    ProtectionStatistics protection;
+    RateLimitStatistics rate_limits;
+    uint64_t packets_accepted = 0;
+    uint64_t packets_rejected = 0;
+    uint64_t json_messages_accepted = 0;
+    uint64_t json_messages_rejected = 0;
+};
+
+/**
+ * Human-readable forms of the statistics, for logs and debugging
+ */
+std::string FormatClientRateStatistics(const std::string& client_id,
+                                       const ClientRateStatistics& stats);
+std::string FormatProtectionStatistics(const ProtectionStatistics& stats);
+std::string FormatSecurityStatistics(const SecurityStatistics& stats);
+
 /**
  * Validates network inputs to prevent injection and buffer overflow attacks
  */
@@ -96,6 +166,14 @@ public:
      * @return Validation result
      */
     static ValidationResult ValidateJsonMessage(const std::string& json_str);
+
+    /**
+     * Validate a JSON message and parse it in the same pass
+     * @param json_str The JSON text to validate
+     * @param document Receives the parsed message; null when validation fails
+     * @return Validation result, the same as ValidateJsonMessage would give
+     */
+    static ValidationResult ParseJsonMessage(std::string_view json_str, nlohmann::json& document);
     
     /**
      * Validate a protocol name
@@ -126,15 +204,34 @@ public:
      */
     static ValidationResult ValidatePacketContent(const std::vector<uint8_t>& data, const std::string& protocol);
 
+    /**
+     * Check for script, path traversal and SQL injection fragments
+     * @param str The text to scan, matched ignoring ASCII case
+     * @return True if any suspicious fragment occurs
+     */
+    static bool ContainsSuspiciousPatterns(std::string_view str);
+
+    /**
+     * Check that text is well-formed UTF-8, without copying it
+     * @param str The text to check
+     * @return False for overlong forms, surrogates, code points above
+     *         U+10FFFF, U+FFFE/U+FFFF and truncated sequences
+     */
+    static bool IsValidUtf8(std::string_view str);
+
 private:
-    static bool IsValidUtf8(const std::string& str);
-    static bool ContainsSuspiciousPatterns(const std::string& str);
-    static ValidationResult ValidateJsonStructure(const std::string& json_str);
+    // Size, encoding and content checks that need no parsing
+    static ValidationResult ValidateJsonText(std::string_view json_str);
+    static ValidationResult ValidateJsonStructure(std::string_view json_str);
 };
 
 /**
  * Token bucket rate limiting implementation
- * Thread-safe rate limiter using token bucket algorithm
+ * Lock-free rate limiter using the token bucket algorithm.
+ *
+ * The token count (fixed point) and the time of the last refill (milliseconds)
+ * are packed into one 64-bit word and updated with a single compare-exchange,
+ * so concurrent consumers never block each other.
  */
 class TokenBucketRateLimit {
 public:
@@ -164,21 +261,45 @@ public:
     void Reset();
 
 private:
-    void Refill();
-    
-    mutable std::mutex mutex_;
-    std::chrono::steady_clock::time_point last_refill_;
-    double tokens_;
-    const double capacity_;
-    const double refill_rate_;
+    static uint64_t Pack(uint64_t scaled_tokens, uint32_t timestamp_ms) {
+        return (scaled_tokens << 32) | timestamp_ms;
+    }
+
+    uint32_t NowMs() const;
+    uint64_t RefilledState(uint64_t state, uint32_t now_ms) const;
+
+    const uint64_t epoch_ns_; // MonotonicClock
+    const double scale_;
+    const uint64_t scaled_capacity_;
+    const double scaled_refill_per_ms_;
+    std::atomic<uint64_t> state_; // [scaled tokens:32][last refill ms:32]
 };
 
 /**
  * Manages rate limiting for multiple clients
+ *
+ * Clients are spread over SHARD_COUNT lock-striped shards by a hash of the
+ * client id. The per-packet checks only take their shard's lock in shared
+ * mode and update lock-free token buckets, so checks for different clients,
+ * and for the same client, proceed in parallel. Idle clients are evicted one
+ * shard at a time from a timer rather than on the packet path.
  */
 class ClientRateManager {
 public:
-    explicit ClientRateManager(const RateLimitConfig& config);
+    static constexpr size_t SHARD_COUNT = 64;
+    static constexpr std::chrono::milliseconds EVICTION_INTERVAL{1000};
+
+    /**
+     * @param config Rate limits applied to every client
+     * @param timer_wheel Wheel that drives idle-client eviction; the shared
+     *                    wheel is used when null
+     */
+    explicit ClientRateManager(const RateLimitConfig& config,
+                               std::shared_ptr<TimerWheel> timer_wheel = nullptr);
+    ~ClientRateManager();
+
+    ClientRateManager(const ClientRateManager&) = delete;
+    ClientRateManager& operator=(const ClientRateManager&) = delete;
     
     /**
      * Check if a client is within rate limits for packet count
@@ -208,37 +329,112 @@ public:
      */
     std::string GetClientStats(const std::string& client_id) const;
 
+    /**
+     * Get rate limiting state for a client. Takes the client's shard in
+     * shared mode only, like the packet checks.
+     * @param client_id The client identifier
+     * @return The client's state, or nothing if the client is not tracked
+     */
+    std::optional<ClientRateStatistics> GetClientStatistics(const std::string& client_id) const;
+
+    /**
+     * Get counters summed over all clients; takes no locks
+     */
+    RateLimitStatistics GetStatistics() const;
+
+    /**
+     * Get the number of tracked clients
+     */
+    size_t GetClientCount() const;
+
+    /**
+     * Evict every client idle for longer than the configured timeout now,
+     * instead of waiting for the background sweep
+     * @return Number of clients evicted
+     */
+    size_t EvictIdleClients();
+
 private:
     struct ClientLimits {
-        std::unique_ptr<TokenBucketRateLimit> packet_limiter;
-        std::unique_ptr<TokenBucketRateLimit> byte_limiter;
-        std::chrono::steady_clock::time_point last_activity;
-        size_t total_packets;
-        size_t total_bytes;
+        ClientLimits(const RateLimitConfig& config, int64_t now_ms);
+
+        TokenBucketRateLimit packet_limiter;
+        TokenBucketRateLimit byte_limiter;
+        std::atomic<int64_t> last_activity_ms;
+        std::atomic<size_t> total_packets{0};
+        std::atomic<size_t> total_bytes{0};
     };
-    
-    mutable std::mutex clients_mutex_;
-    std::unordered_map<std::string, std::unique_ptr<ClientLimits>> client_limits_;
+
+    struct alignas(64) Shard {
+        mutable ProfiledMutex<LockSite::RateLimiterShard, std::shared_mutex> mutex;
+        std::pmr::unordered_map<std::string, ClientLimits> clients{
+            GetMemoryResource(MemorySubsystem::SecurityTables)};
+    };
+
+    enum class Counter : size_t {
+        PacketsChecked,
+        PacketsLimited,
+        BytesChecked,
+        BytesLimited,
+        ClientsEvicted,
+        Count,
+    };
+
+    void Count(Counter counter, uint64_t amount = 1) {
+        counters_.Add(static_cast<size_t>(counter), amount);
+    }
+
+    Shard& GetShard(const std::string& client_id);
+    const Shard& GetShard(const std::string& client_id) const;
+
+    /**
+     * Run an operation on a client's limits, creating them on first use. The
+     * operation runs under the shard's shared lock so the entry cannot be
+     * evicted underneath it.
+     */
+    template <typename Operation>
+    bool WithClientLimits(const std::string& client_id, Operation&& operation);
+
+    size_t EvictIdleClientsInShard(Shard& shard, int64_t now_ms);
+    void SweepNextShard();
+    static int64_t NowMs();
+
     RateLimitConfig config_;
-    
-    ClientLimits* GetOrCreateClientLimits(const std::string& client_id);
-    void CleanupInactiveClients();
+    std::array<Shard, SHARD_COUNT> shards_;
+    std::atomic<size_t> next_sweep_shard_{0};
+    std::atomic<size_t> client_count_{0};
+    ShardedCounters<static_cast<size_t>(Counter::Count)> counters_;
+
+    std::shared_ptr<TimerWheel> timer_wheel_;
+    TimerWheel::TimerId eviction_timer_ = TimerWheel::INVALID_TIMER_ID;
 };
 
 /**
  * DDoS protection implementation
  * Protects against connection flooding and resource exhaustion
+ *
+ * Addresses are parsed once into 16-byte keys. Connection counts live in a
+ * flat hash table and bans in a prefix trie, so admitting a connection costs
+ * a few probes whatever the load; addresses that are only checked are never
+ * stored, so a storm of spoofed sources does not grow the tables. Expired
+ * bans and idle addresses are swept on a timer instead of on the accept path.
  */
 class DDoSProtection {
 public:
-    explicit DDoSProtection(const DDoSProtectionConfig& config);
+    explicit DDoSProtection(const DDoSProtectionConfig& config,
+                            std::shared_ptr<TimerWheel> timer_wheel = nullptr);
+    ~DDoSProtection();
+
+    DDoSProtection(const DDoSProtection&) = delete;
+    DDoSProtection& operator=(const DDoSProtection&) = delete;
     
     /**
      * Check if a new connection from an IP should be allowed
-     * @param ip_address The IP address of the connecting client
+     * @param ip_address The IPv4 or IPv6 address of the connecting client
      * @return True if connection should be allowed, false if blocked
      */
     bool AllowNewConnection(const std::string& ip_address);
+    bool AllowNewConnection(const IpAddressKey& address);
     
     /**
      * Register a successful connection
@@ -246,6 +442,7 @@ public:
      * @param connection_id Unique connection identifier
      */
     void RegisterConnection(const std::string& ip_address, const std::string& connection_id);
+    void RegisterConnection(const IpAddressKey& address);
     
     /**
      * Remove a connection (cleanup on disconnect)
@@ -253,6 +450,7 @@ public:
      * @param connection_id The connection identifier
      */
     void RemoveConnection(const std::string& ip_address, const std::string& connection_id);
+    void RemoveConnection(const IpAddressKey& address);
     
     /**
      * Check if the global packet rate limit is exceeded
@@ -261,18 +459,27 @@ public:
     bool CheckGlobalPacketRate();
     
     /**
-     * Add an IP address to the blacklist
-     * @param ip_address The IP address to blacklist
+     * Add an IP address or CIDR block to the blacklist
+     * @param ip_address The address ("192.0.2.7") or block ("192.0.2.0/24", "2001:db8::/32")
      * @param reason The reason for blacklisting
      */
     void BlacklistIP(const std::string& ip_address, const std::string& reason);
     
     /**
-     * Check if an IP address is blacklisted
+     * Add every address sharing the first prefix_length bits with address to the blacklist
+     * @param address Any address in the block
+     * @param prefix_length Length in IpAddressKey bits, so IPv4 /24 is 96 + 24
+     * @param reason The reason for blacklisting
+     */
+    void BlacklistPrefix(const IpAddressKey& address, uint8_t prefix_length, const std::string& reason);
+    
+    /**
+     * Check if an IP address is blacklisted, directly or by a CIDR block
      * @param ip_address The IP address to check
      * @return True if blacklisted, false otherwise
      */
     bool IsBlacklisted(const std::string& ip_address) const;
+    bool IsBlacklisted(const IpAddressKey& address) const;
     
     /**
      * Get DDoS protection statistics
@@ -280,10 +487,18 @@ public:
      */
     std::string GetProtectionStats() const;
 
+    /**
+     * Get DDoS protection counters; takes no locks, so polling it never
+     * delays connection admission
+     */
+    ProtectionStatistics GetProtectionStatistics() const;
+
 private:
+    // How often expired bans and idle addresses are swept
+    static constexpr std::chrono::milliseconds CLEANUP_INTERVAL{10000};
+
     struct IPInfo {
-        size_t connection_count;
-        std::vector<std::string> connection_ids;
+        size_t connection_count = 0;
         std::chrono::steady_clock::time_point first_connection;
         std::chrono::steady_clock::time_point last_activity;
     };
@@ -293,18 +508,42 @@ private:
         std::string reason;
     };
     
+    enum class Counter : size_t {
+        ConnectionsAllowed,
+        BlacklistRejections,
+        ConnectionLimitRejections,
+        PerAddressRejections,
+        GlobalRateLimited,
+        Count,
+    };
+
+    void Count(Counter counter) {
+        counters_.Add(static_cast<size_t>(counter));
+    }
+
     mutable std::mutex protection_mutex_;
     DDoSProtectionConfig config_;
     std::atomic<size_t> active_connections_{0};
-    std::unordered_map<std::string, IPInfo> ip_connections_;
-    std::unordered_map<std::string, BlacklistEntry> blacklisted_ips_;
+    // Table sizes, republished after every change so readers need no lock
+    std::atomic<size_t> unique_addresses_{0};
+    std::atomic<size_t> blacklist_entries_{0};
+    ShardedCounters<static_cast<size_t>(Counter::Count)> counters_;
+    IpAddressMap<IPInfo> ip_connections_;
+    IpPrefixTrie<BlacklistEntry> blacklist_;
     
     // Global rate limiting
     std::unique_ptr<TokenBucketRateLimit> global_packet_limiter_;
-    
+
+    std::shared_ptr<TimerWheel> timer_wheel_;
+    TimerWheel::TimerId cleanup_timer_ = TimerWheel::INVALID_TIMER_ID;
+    
+    bool IsBlacklistedLocked(const IpAddressKey& address,
+                             std::chrono::steady_clock::time_point now) const;
+    void BlacklistLocked(const IpAddressKey& address, uint8_t prefix_length, const std::string& reason);
+    void PublishSizesLocked();
+    void Cleanup();
     void CleanupExpiredBlacklist();
     void CleanupInactiveConnections();
-    bool IsValidIPAddress(const std::string& ip_address) const;
 };
 
 /**
@@ -345,6 +584,62 @@ public:
         const std::string& client_ip,
         const std::string& json_message
     );
+
+    /**
+     * Validate, check rate limits for and parse an incoming JSON message in one pass
+     * @param client_id The client identifier
+     * @param client_ip The client IP address
+     * @param json_message The JSON message
+     * @param document Receives the parsed message when it is accepted
+     * @return Validation result
+     */
+    ValidationResult ValidateIncomingJsonMessage(
+        const std::string& client_id,
+        const std::string& client_ip,
+        const std::string& json_message,
+        nlohmann::json& document
+    );
+    
+    /**
+     * The checks of ValidateIncomingPacket as separate steps, for callers
+     * that run them as pipeline stages over batches of packets. Such callers
+     * report each packet's final outcome with RecordPacketResult.
+     */
+
+    /**
+     * Check the global packet rate for one packet
+     * @return Validation result
+     */
+    ValidationResult CheckGlobalPacketRate();
+
+    /**
+     * Check that packets from an address are not blacklisted
+     * @param address The sender's address
+     * @return Validation result
+     */
+    ValidationResult CheckPacketSource(const IpAddressKey& address);
+
+    /**
+     * Check a client's packet and byte rate limits for one packet
+     * @param client_id The client identifier
+     * @param packet_size Size of the packet in bytes
+     * @return Validation result
+     */
+    ValidationResult CheckPacketRate(const std::string& client_id, size_t packet_size);
+
+    /**
+     * Check a packet's size, header, protocol name and content
+     * @param data The packet data
+     * @param protocol The protocol name
+     * @return Validation result
+     */
+    static ValidationResult CheckPacketInput(const std::vector<uint8_t>& data,
+                                             const std::string& protocol);
+
+    /**
+     * Count a packet checked in stages as accepted or rejected
+     */
+    void RecordPacketResult(bool accepted);
     
     /**
      * Check if a new connection should be allowed
@@ -375,7 +670,37 @@ public:
      */
     std::string GetSecurityStats() const;
 
+    /**
+     * Get comprehensive security counters; takes no locks, so it can be
+     * polled while packets are being validated
+     */
+    SecurityStatistics GetSecurityStatistics() const;
+
 private:
+    enum class Counter : size_t {
+        PacketsAccepted,
+        PacketsRejected,
+        JsonMessagesAccepted,
+        JsonMessagesRejected,
+        Count,
+    };
+
+    ValidationResult CheckIncomingPacket(const std::string& client_id,
+                                         const std::string& client_ip,
+                                         const std::vector<uint8_t>& data,
+                                         const std::string& protocol);
+    ValidationResult CheckIncomingJsonMessage(const std::string& client_id,
+                                              const std::string& client_ip,
+                                              const std::string& json_message);
+    ValidationResult CheckIncomingJsonMessage(const std::string& client_id,
+                                              const std::string& client_ip,
+                                              const std::string& json_message,
+                                              nlohmann::json& document);
+    ValidationResult CheckClientMessageRate(const std::string& client_id, size_t message_size);
+    ValidationResult Record(ValidationResult result, Counter accepted, Counter rejected);
+
+    ShardedCounters<static_cast<size_t>(Counter::Count)> counters_;
+
     std::unique_ptr<ClientRateManager> rate_manager_;
     std::unique_ptr<DDoSProtection> ddos_protection_;
 };
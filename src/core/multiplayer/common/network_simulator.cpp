@@ -0,0 +1,152 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "network_simulator.h"
+
+#include <algorithm>
+
+namespace Core::Multiplayer {
+
+namespace {
+
+struct LaterEvent {
+    template <typename T>
+    bool operator()(const T& a, const T& b) const {
+        return a.at != b.at ? a.at > b.at : a.sequence > b.sequence;
+    }
+};
+
+} // namespace
+
+NetworkSimulator::NetworkSimulator(uint64_t seed, std::chrono::milliseconds tick_interval)
+    : clock_(std::make_shared<VirtualClock>()),
+      timer_wheel_(std::make_shared<TimerWheel>(clock_, tick_interval)), random_(seed) {}
+
+NetworkSimulator::~NetworkSimulator() {
+    // Timer callbacks may capture state owned by the scenario
+    timer_wheel_->Shutdown();
+}
+
+NetworkSimulator::NodeId NetworkSimulator::AddNode(Receiver receiver) {
+    receivers_.push_back(std::move(receiver));
+    return static_cast<NodeId>(receivers_.size() - 1);
+}
+
+void NetworkSimulator::SetReceiver(NodeId node, Receiver receiver) {
+    if (node < receivers_.size()) {
+        receivers_[node] = std::move(receiver);
+    }
+}
+
+void NetworkSimulator::SetDefaultLink(const SimulatedLink& link) {
+    default_link_ = link;
+}
+
+void NetworkSimulator::SetLink(NodeId from, NodeId to, const SimulatedLink& link) {
+    GetLink(from, to) = link;
+}
+
+void NetworkSimulator::SetLinkUp(NodeId a, NodeId b, bool up) {
+    GetLink(a, b).up = up;
+    GetLink(b, a).up = up;
+}
+
+bool NetworkSimulator::Send(NodeId from, NodeId to, std::vector<uint8_t> payload) {
+    if (from >= receivers_.size() || to >= receivers_.size()) {
+        return false;
+    }
+    ++statistics_.datagrams_sent;
+    const uint64_t key = LinkKey(from, to);
+    const auto it = links_.find(key);
+    const SimulatedLink& link = it != links_.end() ? it->second : default_link_;
+    if (!link.up) {
+        ++statistics_.dropped_link_down;
+        return true;
+    }
+    if (link.loss > 0.0 && std::uniform_real_distribution<double>(0.0, 1.0)(random_) < link.loss) {
+        ++statistics_.dropped_loss;
+        return true;
+    }
+
+    const auto now = clock_->Now();
+    auto departure = now;
+    if (link.bytes_per_second != 0) {
+        // Datagrams queue behind each other on a rate-limited link
+        const auto transmit = std::chrono::nanoseconds(
+            static_cast<int64_t>(payload.size()) * 1'000'000'000 /
+            static_cast<int64_t>(link.bytes_per_second));
+        auto& busy_until = busy_until_[key];
+        busy_until = std::max(busy_until, now) + transmit;
+        departure = busy_until;
+    }
+    auto arrival = departure + link.latency;
+    if (link.jitter.count() > 0) {
+        arrival += std::chrono::microseconds(
+            std::uniform_int_distribution<int64_t>(0, link.jitter.count())(random_));
+    }
+
+    Push(arrival, [this, from, to, payload = std::move(payload)]() {
+        ++statistics_.datagrams_delivered;
+        statistics_.bytes_delivered += payload.size();
+        if (receivers_[to]) {
+            receivers_[to](from, payload);
+        }
+    });
+    return true;
+}
+
+void NetworkSimulator::Schedule(std::chrono::nanoseconds delay, Event event) {
+    Push(clock_->Now() + std::max(delay, std::chrono::nanoseconds::zero()), std::move(event));
+}
+
+void NetworkSimulator::RunFor(std::chrono::nanoseconds duration) {
+    RunUntil(clock_->Now() + duration);
+}
+
+void NetworkSimulator::RunUntil(ClockSource::TimePoint deadline) {
+    while (Step(deadline)) {
+    }
+    clock_->AdvanceTo(deadline);
+    statistics_.timers_run += timer_wheel_->RunDue();
+}
+
+bool NetworkSimulator::RunUntilIdle(std::chrono::nanoseconds max_duration) {
+    const auto deadline = clock_->Now() + max_duration;
+    while (Step(deadline)) {
+    }
+    return events_.empty() && timer_wheel_->GetTimerCount() == 0;
+}
+
+SimulatedLink& NetworkSimulator::GetLink(NodeId from, NodeId to) {
+    return links_.try_emplace(LinkKey(from, to), default_link_).first->second;
+}
+
+void NetworkSimulator::Push(ClockSource::TimePoint at, Event event) {
+    events_.push_back({at, next_sequence_++, std::move(event)});
+    std::push_heap(events_.begin(), events_.end(), LaterEvent{});
+}
+
+bool NetworkSimulator::Step(ClockSource::TimePoint deadline) {
+    const auto tick = timer_wheel_->GetNextTickTime();
+    const bool event_due = !events_.empty() && events_.front().at <= deadline;
+    const bool tick_due = tick && *tick <= deadline;
+    if (!event_due && !tick_due) {
+        return false;
+    }
+
+    // At the same instant, deliveries and events go before timers
+    if (event_due && (!tick_due || events_.front().at <= *tick)) {
+        std::pop_heap(events_.begin(), events_.end(), LaterEvent{});
+        PendingEvent next = std::move(events_.back());
+        events_.pop_back();
+        clock_->AdvanceTo(next.at);
+        ++statistics_.events_run;
+        next.event();
+        return true;
+    }
+    clock_->AdvanceTo(*tick);
+    statistics_.timers_run += timer_wheel_->RunDue();
+    return true;
+}
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,43 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "node_event_queue.h"
+
+namespace Core::Multiplayer {
+
+void NodeEventQueue::Post(uint8_t node_id, State state) {
+    latest_[node_id].store(state, std::memory_order_release);
+    // Set after the state, so a drain that sees the bit sees the state
+    pending_[node_id / 64].fetch_or(uint64_t{1} << (node_id % 64), std::memory_order_release);
+    posted_.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool NodeEventQueue::HasPending() const {
+    for (const auto& word : pending_) {
+        if (word.load(std::memory_order_relaxed) != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool NodeEventQueue::IsConnected(uint8_t node_id) const {
+    return (connected_[node_id / 64] & (uint64_t{1} << (node_id % 64))) != 0;
+}
+
+void NodeEventQueue::Reset() {
+    for (auto& word : pending_) {
+        word.store(0, std::memory_order_relaxed);
+    }
+    for (auto& state : latest_) {
+        state.store(State::None, std::memory_order_relaxed);
+    }
+    connected_.fill(0);
+}
+
+NodeEventQueueStatistics NodeEventQueue::GetStatistics() const {
+    return NodeEventQueueStatistics{posted_.load(std::memory_order_relaxed),
+                                    delivered_.load(std::memory_order_relaxed)};
+}
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,102 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace Core::Multiplayer {
+
+struct NodeEventQueueStatistics {
+    uint64_t posted = 0;    // Joins and leaves posted
+    uint64_t delivered = 0; // Changes handed to Drain's function; the rest were folded
+};
+
+/**
+ * Node joins and leaves from network threads, handed to the HLE thread.
+ *
+ * Backends report membership from whichever thread learns of it, while the
+ * LDN layer reads it under its own locks. Posting only stores the node's
+ * latest state and sets its bit in a pending bitset, so a network thread
+ * never blocks and the queue cannot overflow. Drain folds everything posted
+ * since the last drain into one change per node against what it delivered
+ * before: a node that left and joined again in between, or joined and
+ * left, is not reported at all.
+ *
+ * Any thread may Post; Drain and Reset belong to one consumer thread.
+ */
+class NodeEventQueue {
+public:
+    static constexpr size_t CAPACITY = 256;
+
+    void PostJoined(uint8_t node_id) {
+        Post(node_id, State::Joined);
+    }
+
+    void PostLeft(uint8_t node_id) {
+        Post(node_id, State::Left);
+    }
+
+    /**
+     * Calls function(node_id, connected) for every node whose state changed
+     * since the last drain, in id order
+     * @return Number of changes delivered
+     */
+    template <typename Function>
+    size_t Drain(Function&& function) {
+        size_t delivered = 0;
+        for (size_t word = 0; word < WORDS; ++word) {
+            uint64_t bits = pending_[word].exchange(0, std::memory_order_acquire);
+            while (bits != 0) {
+                const auto bit = static_cast<size_t>(std::countr_zero(bits));
+                bits &= bits - 1;
+                const size_t node = word * 64 + bit;
+                const State state = latest_[node].exchange(State::None, std::memory_order_acquire);
+                if (state == State::None) {
+                    continue; // Taken by the previous drain
+                }
+                const bool connected = state == State::Joined;
+                const uint64_t mask = uint64_t{1} << bit;
+                if (((connected_[word] & mask) != 0) == connected) {
+                    continue;
+                }
+                connected_[word] ^= mask;
+                function(static_cast<uint8_t>(node), connected);
+                ++delivered;
+            }
+        }
+        delivered_.fetch_add(delivered, std::memory_order_relaxed);
+        return delivered;
+    }
+
+    bool HasPending() const;
+
+    // Whether the consumer was last told the node is connected
+    bool IsConnected(uint8_t node_id) const;
+
+    // Forgets pending and delivered state, e.g. when the session ends
+    void Reset();
+
+    NodeEventQueueStatistics GetStatistics() const;
+
+private:
+    enum class State : uint8_t { None, Joined, Left };
+
+    static constexpr size_t WORDS = CAPACITY / 64;
+
+    void Post(uint8_t node_id, State state);
+
+    std::array<std::atomic<State>, CAPACITY> latest_{};
+    std::array<std::atomic<uint64_t>, WORDS> pending_{};
+    // Consumer only
+    std::array<uint64_t, WORDS> connected_{};
+
+    std::atomic<uint64_t> posted_{0};
+    std::atomic<uint64_t> delivered_{0};
+};
+
+} // namespace Core::Multiplayer
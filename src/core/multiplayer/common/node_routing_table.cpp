@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "node_routing_table.h"
+
+namespace Core::Multiplayer {
+
+namespace {
+
+constexpr uint64_t Bit(uint8_t node_id) {
+    return uint64_t{1} << (node_id % 64);
+}
+
+} // namespace
+
+bool NodeRoutingTable::Join(uint8_t node_id, const NodeRoute& route) {
+    if (node_id == BROADCAST_NODE_ID) {
+        return false;
+    }
+    Entry& entry = entries_[node_id];
+    entry.route.Store(route);
+    entry.packets_sent.store(0, std::memory_order_relaxed);
+    entry.send_failures.store(0, std::memory_order_relaxed);
+    // Published after the route, so a sender that sees the bit sees the route
+    active_[node_id / 64].fetch_or(Bit(node_id), std::memory_order_release);
+    return true;
+}
+
+void NodeRoutingTable::Leave(uint8_t node_id) {
+    active_[node_id / 64].fetch_and(~Bit(node_id), std::memory_order_acq_rel);
+    entries_[node_id].route.Store(NodeRoute{});
+}
+
+void NodeRoutingTable::Clear() {
+    for (size_t word = 0; word < ACTIVE_WORDS; ++word) {
+        uint64_t bits = active_[word].exchange(0, std::memory_order_acq_rel);
+        while (bits != 0) {
+            const auto bit = static_cast<size_t>(std::countr_zero(bits));
+            bits &= bits - 1;
+            entries_[word * 64 + bit].route.Store(NodeRoute{});
+        }
+    }
+}
+
+std::optional<NodeRoute> NodeRoutingTable::Lookup(uint8_t node_id) const {
+    if (!IsActive(node_id)) {
+        return std::nullopt;
+    }
+    return entries_[node_id].route.Load();
+}
+
+bool NodeRoutingTable::IsActive(uint8_t node_id) const {
+    return (active_[node_id / 64].load(std::memory_order_acquire) & Bit(node_id)) != 0;
+}
+
+size_t NodeRoutingTable::GetActiveCount() const {
+    size_t count = 0;
+    for (const auto& word : active_) {
+        count += static_cast<size_t>(std::popcount(word.load(std::memory_order_relaxed)));
+    }
+    return count;
+}
+
+void NodeRoutingTable::RecordSent(uint8_t node_id) {
+    entries_[node_id].packets_sent.fetch_add(1, std::memory_order_relaxed);
+}
+
+void NodeRoutingTable::RecordSendFailure(uint8_t node_id) {
+    entries_[node_id].send_failures.fetch_add(1, std::memory_order_relaxed);
+}
+
+NodeRouteCounters NodeRoutingTable::GetCounters(uint8_t node_id) const {
+    const Entry& entry = entries_[node_id];
+    return NodeRouteCounters{entry.packets_sent.load(std::memory_order_relaxed),
+                             entry.send_failures.load(std::memory_order_relaxed)};
+}
+
+} // namespace Core::Multiplayer
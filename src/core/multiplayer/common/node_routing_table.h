@@ -0,0 +1,93 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "seqlock.h"
+
+namespace Core::Multiplayer {
+
+/**
+ * Where a transport sends a node's packets, as the transport registered it:
+ * an index into its own connection table and the stream or socket it
+ * resolved to. Both are opaque to the backend.
+ */
+struct NodeRoute {
+    uint64_t transport_handle = 0;
+    void* connection = nullptr;
+};
+
+/**
+ * Per-node send counters kept beside the route; bytes are in BackendStats
+ */
+struct NodeRouteCounters {
+    uint64_t packets_sent = 0;
+    uint64_t send_failures = 0;
+};
+
+/**
+ * node_id to route, indexed directly by the LDN node id.
+ *
+ * Transports key peers by peer id or device address; the table lets the send
+ * path resolve a node with an array index instead of a string-keyed lookup.
+ * Every node id has its own cache line, so the send path reading one node
+ * never shares a line with the counters of another, and broadcast walks a
+ * bitset of the nodes that joined.
+ *
+ * Join and Leave come from one thread at a time, whichever reports
+ * membership; lookups and counters are lock-free from any thread.
+ */
+class NodeRoutingTable {
+public:
+    static constexpr size_t CAPACITY = 256;
+    // Not a node; SendPacket's "every node"
+    static constexpr uint8_t BROADCAST_NODE_ID = 0xFF;
+
+    // Counters start over; false for the broadcast id
+    bool Join(uint8_t node_id, const NodeRoute& route);
+    void Leave(uint8_t node_id);
+    void Clear();
+
+    std::optional<NodeRoute> Lookup(uint8_t node_id) const;
+    bool IsActive(uint8_t node_id) const;
+    size_t GetActiveCount() const;
+
+    void RecordSent(uint8_t node_id);
+    void RecordSendFailure(uint8_t node_id);
+    NodeRouteCounters GetCounters(uint8_t node_id) const;
+
+    // Calls function(node_id, route) for every node that joined, in id order
+    template <typename Function>
+    void ForEachActive(Function&& function) const {
+        for (size_t word = 0; word < ACTIVE_WORDS; ++word) {
+            uint64_t bits = active_[word].load(std::memory_order_acquire);
+            while (bits != 0) {
+                const auto bit = static_cast<size_t>(std::countr_zero(bits));
+                bits &= bits - 1;
+                const auto node_id = static_cast<uint8_t>(word * 64 + bit);
+                function(node_id, entries_[node_id].route.Load());
+            }
+        }
+    }
+
+private:
+    struct alignas(64) Entry {
+        SeqLock<NodeRoute> route;
+        std::atomic<uint64_t> packets_sent{0};
+        std::atomic<uint64_t> send_failures{0};
+    };
+
+    static constexpr size_t ACTIVE_WORDS = CAPACITY / 64;
+
+    std::array<Entry, CAPACITY> entries_{};
+    std::array<std::atomic<uint64_t>, ACTIVE_WORDS> active_{};
+};
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,181 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "packet_buffer.h"
+#include <cstring>
+#include "memory_accounting.h"
+
+namespace Core::Multiplayer {
+
+// PacketBuffer implementation
+PacketBuffer::PacketBuffer(const PacketBuffer& other) noexcept : slot_(other.slot_) {
+    if (slot_) {
+        slot_->ref_count.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+PacketBuffer::PacketBuffer(PacketBuffer&& other) noexcept : slot_(other.slot_) {
+    other.slot_ = nullptr;
+}
+
+PacketBuffer& PacketBuffer::operator=(const PacketBuffer& other) noexcept {
+    if (this != &other) {
+        if (other.slot_) {
+            other.slot_->ref_count.fetch_add(1, std::memory_order_relaxed);
+        }
+        Reset();
+        slot_ = other.slot_;
+    }
+    return *this;
+}
+
+PacketBuffer& PacketBuffer::operator=(PacketBuffer&& other) noexcept {
+    if (this != &other) {
+        Reset();
+        slot_ = other.slot_;
+        other.slot_ = nullptr;
+    }
+    return *this;
+}
+
+PacketBuffer::~PacketBuffer() {
+    Reset();
+}
+
+bool PacketBuffer::Resize(size_t size) {
+    if (!slot_ || size > slot_->Capacity()) {
+        return false;
+    }
+    slot_->length = size;
+    return true;
+}
+
+bool PacketBuffer::Assign(const uint8_t* bytes, size_t size) {
+    if (!slot_ || size > slot_->Capacity()) {
+        return false;
+    }
+    if (size > 0) {
+        std::memcpy(slot_->Data(), bytes, size);
+    }
+    slot_->length = size;
+    return true;
+}
+
+uint32_t PacketBuffer::UseCount() const {
+    return slot_ ? slot_->ref_count.load(std::memory_order_relaxed) : 0;
+}
+
+void PacketBuffer::Reset() {
+    if (!slot_) {
+        return;
+    }
+
+    PacketBufferSlot* slot = slot_;
+    slot_ = nullptr;
+
+    // Last handle returns the slot to its pool
+    if (slot->ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        slot->owner->Release(slot);
+    }
+}
+
+// PacketPool implementation
+PacketPool::PacketPool(size_t capacity)
+    : capacity_(capacity), slots_(capacity, GetMemoryResource(MemorySubsystem::PacketPool)),
+      free_list_(GetMemoryResource(MemorySubsystem::PacketPool)) {
+    free_list_.reserve(capacity_);
+    for (size_t i = capacity_; i > 0; --i) {
+        slots_[i - 1].owner = this;
+        free_list_.push_back(&slots_[i - 1]);
+    }
+}
+
+PacketPool::~PacketPool() = default;
+
+PacketBuffer PacketPool::Acquire() {
+    PacketBufferSlot* slot = nullptr;
+    size_t in_use = 0;
+    {
+        std::lock_guard<std::mutex> lock(free_mutex_);
+        if (free_list_.empty()) {
+            exhausted_count_.fetch_add(1, std::memory_order_relaxed);
+            return PacketBuffer();
+        }
+        slot = free_list_.back();
+        free_list_.pop_back();
+        in_use = capacity_ - free_list_.size();
+    }
+
+    total_acquired_.fetch_add(1, std::memory_order_relaxed);
+    size_t previous = high_watermark_.load(std::memory_order_relaxed);
+    while (in_use > previous &&
+           !high_watermark_.compare_exchange_weak(previous, in_use, std::memory_order_relaxed)) {
+    }
+
+    slot->length = 0;
+    slot->ref_count.store(1, std::memory_order_relaxed);
+    return PacketBuffer(slot);
+}
+
+PacketBuffer PacketPool::Acquire(const uint8_t* bytes, size_t size) {
+    if (size > PACKET_BUFFER_SIZE) {
+        return AcquireOversize(bytes, size);
+    }
+
+    PacketBuffer buffer = Acquire();
+    if (buffer) {
+        buffer.Assign(bytes, size);
+    }
+    return buffer;
+}
+
+PacketBuffer PacketPool::AcquireOversize(const uint8_t* bytes, size_t size) {
+    if (size > MAX_OVERSIZE_PACKET_SIZE) {
+        return PacketBuffer();
+    }
+
+    // Allocated from the same resource as the slab, so it is accounted for
+    std::pmr::polymorphic_allocator<> allocator = slots_.get_allocator();
+    PacketBufferSlot* slot = allocator.new_object<PacketBufferSlot>();
+    slot->owner = this;
+    slot->overflow = static_cast<uint8_t*>(allocator.allocate_bytes(size));
+    slot->overflow_capacity = size;
+    std::memcpy(slot->overflow, bytes, size);
+    slot->length = size;
+    slot->ref_count.store(1, std::memory_order_relaxed);
+
+    total_acquired_.fetch_add(1, std::memory_order_relaxed);
+    oversize_acquired_.fetch_add(1, std::memory_order_relaxed);
+    return PacketBuffer(slot);
+}
+
+size_t PacketPool::Available() const {
+    std::lock_guard<std::mutex> lock(free_mutex_);
+    return free_list_.size();
+}
+
+PacketPoolStatistics PacketPool::GetStatistics() const {
+    PacketPoolStatistics stats;
+    stats.capacity = capacity_;
+    stats.in_use = capacity_ - Available();
+    stats.high_watermark = high_watermark_.load(std::memory_order_relaxed);
+    stats.total_acquired = total_acquired_.load(std::memory_order_relaxed);
+    stats.exhausted_count = exhausted_count_.load(std::memory_order_relaxed);
+    stats.oversize_acquired = oversize_acquired_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void PacketPool::Release(PacketBufferSlot* slot) {
+    if (slot->overflow) {
+        std::pmr::polymorphic_allocator<> allocator = slots_.get_allocator();
+        allocator.deallocate_bytes(slot->overflow, slot->overflow_capacity);
+        allocator.delete_object(slot);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(free_mutex_);
+    // Capacity was reserved up front, so this never reallocates
+    free_list_.push_back(slot);
+}
+
+} // namespace Core::Multiplayer
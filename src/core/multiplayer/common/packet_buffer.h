@@ -0,0 +1,188 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+namespace Core::Multiplayer {
+
+/**
+ * Size of a single pooled packet buffer. Matches the MTU budget used by the
+ * LDN data path so a buffer always holds one complete frame.
+ */
+constexpr size_t PACKET_BUFFER_SIZE = 1400;
+
+/**
+ * Largest frame a pool will copy into an oversize buffer. Covers a relay
+ * message reassembled from the maximum of 64 fragments.
+ */
+constexpr size_t MAX_OVERSIZE_PACKET_SIZE = 64 * PACKET_BUFFER_SIZE;
+
+/**
+ * Default number of buffers in a pool (8 players at 60Hz with headroom)
+ */
+constexpr size_t DEFAULT_PACKET_POOL_CAPACITY = 256;
+
+class PacketPool;
+
+/**
+ * Storage slot inside a PacketPool slab, or allocated past it for an
+ * oversize frame
+ */
+struct PacketBufferSlot {
+    std::array<uint8_t, PACKET_BUFFER_SIZE> bytes;
+    std::atomic<uint32_t> ref_count{0};
+    size_t length = 0;
+    PacketPool* owner = nullptr;
+    // Heap storage used instead of bytes by an oversize slot
+    uint8_t* overflow = nullptr;
+    size_t overflow_capacity = 0;
+
+    uint8_t* Data() { return overflow ? overflow : bytes.data(); }
+    size_t Capacity() const { return overflow ? overflow_capacity : PACKET_BUFFER_SIZE; }
+};
+
+/**
+ * Ref-counted handle to an MTU-sized buffer owned by a PacketPool.
+ *
+ * Copying a handle shares the underlying buffer; the slot is returned to the
+ * pool when the last handle is released. A default-constructed handle, or one
+ * returned by an exhausted pool, is empty (IsValid() == false).
+ *
+ * The owning pool must outlive every handle it has produced.
+ */
+class PacketBuffer {
+public:
+    PacketBuffer() = default;
+    PacketBuffer(const PacketBuffer& other) noexcept;
+    PacketBuffer(PacketBuffer&& other) noexcept;
+    PacketBuffer& operator=(const PacketBuffer& other) noexcept;
+    PacketBuffer& operator=(PacketBuffer&& other) noexcept;
+    ~PacketBuffer();
+
+    bool IsValid() const { return slot_ != nullptr; }
+    explicit operator bool() const { return IsValid(); }
+
+    uint8_t* data() { return slot_ ? slot_->Data() : nullptr; }
+    const uint8_t* data() const { return slot_ ? slot_->Data() : nullptr; }
+    size_t size() const { return slot_ ? slot_->length : 0; }
+    bool empty() const { return size() == 0; }
+    // Capacity of a pooled buffer; an oversize buffer holds exactly its frame
+    static constexpr size_t capacity() { return PACKET_BUFFER_SIZE; }
+
+    /**
+     * Set the number of valid bytes in the buffer
+     * @return False if the handle is empty or size exceeds the buffer's storage
+     */
+    bool Resize(size_t size);
+
+    /**
+     * Copy bytes into the buffer, replacing its contents
+     * @return False if the handle is empty or size exceeds the buffer's storage
+     */
+    bool Assign(const uint8_t* bytes, size_t size);
+
+    /**
+     * Number of handles currently sharing this buffer
+     */
+    uint32_t UseCount() const;
+
+    /**
+     * Release this handle, returning the buffer to the pool if it was the last
+     */
+    void Reset();
+
+private:
+    friend class PacketPool;
+    explicit PacketBuffer(PacketBufferSlot* slot) noexcept : slot_(slot) {}
+
+    PacketBufferSlot* slot_ = nullptr;
+};
+
+/**
+ * Inbound packet tagged with the LDN node it arrived from
+ */
+struct ReceivedPacket {
+    PacketBuffer packet;
+    uint8_t node_id = 0;
+    // Packet trace id from packet_trace.h; 0 if untraced
+    uint32_t trace_id = 0;
+    // Steady clock nanoseconds when the backend queued it; 0 if untracked
+    uint64_t queued_at = 0;
+};
+
+/**
+ * Packet pool statistics
+ */
+struct PacketPoolStatistics {
+    size_t capacity = 0;
+    size_t in_use = 0;
+    size_t high_watermark = 0;
+    uint64_t total_acquired = 0;
+    uint64_t exhausted_count = 0;
+    // Frames over PACKET_BUFFER_SIZE copied into heap buffers
+    uint64_t oversize_acquired = 0;
+};
+
+/**
+ * Fixed-size slab arena of PacketBuffer slots.
+ *
+ * All storage is allocated once at construction; Acquire and release only
+ * move slot pointers on a preallocated free list, so the steady-state packet
+ * path never touches the heap. The rare frame over PACKET_BUFFER_SIZE, such
+ * as a reassembled relay message, gets a heap buffer sized to it that is
+ * freed on release instead. Thread-safe.
+ */
+class PacketPool {
+public:
+    explicit PacketPool(size_t capacity = DEFAULT_PACKET_POOL_CAPACITY);
+    ~PacketPool();
+
+    PacketPool(const PacketPool&) = delete;
+    PacketPool& operator=(const PacketPool&) = delete;
+
+    /**
+     * Take a buffer from the pool
+     * @return Buffer with size() == 0, or an empty handle if the pool is exhausted
+     */
+    PacketBuffer Acquire();
+
+    /**
+     * Take a buffer and fill it with a copy of the given bytes
+     * Sizes over PACKET_BUFFER_SIZE get an oversize heap buffer.
+     * @return Filled buffer, or an empty handle if exhausted or size exceeds
+     *         MAX_OVERSIZE_PACKET_SIZE
+     */
+    PacketBuffer Acquire(const uint8_t* bytes, size_t size);
+
+    size_t Capacity() const { return capacity_; }
+    size_t Available() const;
+    PacketPoolStatistics GetStatistics() const;
+
+private:
+    friend class PacketBuffer;
+    PacketBuffer AcquireOversize(const uint8_t* bytes, size_t size);
+    void Release(PacketBufferSlot* slot);
+
+    const size_t capacity_;
+    // Allocated from the PacketPool memory resource
+    std::pmr::vector<PacketBufferSlot> slots_;
+
+    mutable std::mutex free_mutex_;
+    std::pmr::vector<PacketBufferSlot*> free_list_;
+
+    std::atomic<size_t> high_watermark_{0};
+    std::atomic<uint64_t> total_acquired_{0};
+    std::atomic<uint64_t> exhausted_count_{0};
+    std::atomic<uint64_t> oversize_acquired_{0};
+};
+
+} // namespace Core::Multiplayer
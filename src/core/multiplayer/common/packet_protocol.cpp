@@ -0,0 +1,187 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "packet_protocol.h"
+#include "crc32.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Core::Multiplayer {
+
+namespace {
+
+bool ValidateHeader(const LdnPacketHeader& header, std::span<const uint8_t> payload) {
+    return header.magic == LDN_PACKET_MAGIC && header.version == LDN_PACKET_VERSION &&
+           ValidatePacketType(header.packet_type) && header.payload_size <= MAX_PACKET_SIZE &&
+           header.payload_size == payload.size() && header.crc32 == Crc32(payload);
+}
+
+} // namespace
+
+uint32_t CalculateCRC32(const uint8_t* data, size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+    return Crc32(std::span(data, size));
+}
+
+bool ValidatePacketType(uint16_t packet_type) {
+    return packet_type >= static_cast<uint16_t>(PacketType::Handshake) &&
+           packet_type <= static_cast<uint16_t>(PacketType::Error);
+}
+
+bool ValidatePacket(const LdnPacket& packet) {
+    return ValidateHeader(packet.header, packet.payload);
+}
+
+bool ValidatePacket(const LdnPacketView& packet) {
+    return ValidateHeader(packet.header, packet.payload);
+}
+
+void SerializeHeader(const LdnPacketHeader& header,
+                     std::span<uint8_t, LDN_PACKET_HEADER_SIZE> out) {
+    LdnPacketHeaderLayout::Encode(header, out);
+}
+
+std::optional<size_t> SerializePacket(const LdnPacketHeader& header,
+                                      std::span<const uint8_t> payload, std::span<uint8_t> out) {
+    const size_t size = LDN_PACKET_HEADER_SIZE + payload.size();
+    if (payload.size() > MAX_PACKET_SIZE || out.size() < size) {
+        return std::nullopt;
+    }
+    LdnPacketHeader complete = header;
+    complete.payload_size = static_cast<uint32_t>(payload.size());
+    complete.crc32 = Crc32(payload);
+    SerializeHeader(complete, out.first<LDN_PACKET_HEADER_SIZE>());
+    if (!payload.empty()) {
+        std::memcpy(out.data() + LDN_PACKET_HEADER_SIZE, payload.data(), payload.size());
+    }
+    return size;
+}
+
+bool SerializePacket(const LdnPacket& packet, std::vector<uint8_t>& serialized) {
+    if (packet.payload.size() > MAX_PACKET_SIZE) {
+        return false;
+    }
+    serialized.resize(LDN_PACKET_HEADER_SIZE + packet.payload.size());
+    return SerializePacket(packet.header, packet.payload, serialized).has_value();
+}
+
+bool DeserializePacket(std::span<const uint8_t> data, LdnPacketView& out) {
+    if (data.size() < LDN_PACKET_HEADER_SIZE) {
+        return false;
+    }
+    LdnPacketHeader header;
+    LdnPacketHeaderLayout::Decode(data.first<LDN_PACKET_HEADER_SIZE>(), header);
+    const auto payload = data.subspan(LDN_PACKET_HEADER_SIZE);
+    if (!ValidateHeader(header, payload)) {
+        return false;
+    }
+    out.header = header;
+    out.payload = payload;
+    return true;
+}
+
+bool DeserializePacket(std::span<const uint8_t> data, LdnPacket& out) {
+    LdnPacketView view;
+    if (!DeserializePacket(data, view)) {
+        return false;
+    }
+    out.header = view.header;
+    out.payload.assign(view.payload.begin(), view.payload.end());
+    return true;
+}
+
+bool FragmentData(std::span<const uint8_t> data, uint32_t session_id, uint8_t source_node_id,
+                  uint8_t dest_node_id, std::vector<LdnPacketView>& fragments,
+                  uint32_t first_sequence) {
+    const size_t count = (data.size() + MAX_PACKET_SIZE - 1) / MAX_PACKET_SIZE;
+    if (count == 0 || count > UINT16_MAX) {
+        return false;
+    }
+    fragments.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        const size_t offset = i * MAX_PACKET_SIZE;
+        const auto payload = data.subspan(offset, std::min(MAX_PACKET_SIZE, data.size() - offset));
+        LdnPacketHeader& header = fragments[i].header;
+        header = LdnPacketHeader{};
+        header.source_node_id = source_node_id;
+        header.session_id = session_id;
+        header.packet_type = static_cast<uint16_t>(PacketType::Fragment);
+        header.dest_node_id = dest_node_id;
+        header.sequence_number = first_sequence + static_cast<uint32_t>(i);
+        header.fragment_id = static_cast<uint16_t>(i);
+        header.total_fragments = static_cast<uint16_t>(count);
+        header.payload_size = static_cast<uint32_t>(payload.size());
+        header.crc32 = Crc32(payload);
+        fragments[i].payload = payload;
+    }
+    return true;
+}
+
+std::optional<size_t> ReassembleFragments(std::span<const LdnPacketView> fragments,
+                                          std::span<uint8_t> out) {
+    if (fragments.empty() || fragments.size() != fragments[0].header.total_fragments) {
+        return std::nullopt;
+    }
+    // Every fragment but the last is full, so each one's place follows from its id
+    const size_t count = fragments.size();
+    size_t size = 0;
+    std::vector<bool> seen(count);
+    for (const auto& fragment : fragments) {
+        const auto& header = fragment.header;
+        const bool last = header.fragment_id == count - 1;
+        if (header.total_fragments != count || header.fragment_id >= count ||
+            seen[header.fragment_id] || fragment.payload.size() > MAX_PACKET_SIZE ||
+            (!last && fragment.payload.size() != MAX_PACKET_SIZE)) {
+            return std::nullopt;
+        }
+        seen[header.fragment_id] = true;
+        size += fragment.payload.size();
+    }
+    if (size > out.size()) {
+        return std::nullopt;
+    }
+    for (const auto& fragment : fragments) {
+        if (!fragment.payload.empty()) {
+            std::memcpy(out.data() + size_t{fragment.header.fragment_id} * MAX_PACKET_SIZE,
+                        fragment.payload.data(), fragment.payload.size());
+        }
+    }
+    return size;
+}
+
+bool ReassembleFragments(std::span<const LdnPacketView> fragments,
+                         std::vector<uint8_t>& reassembled) {
+    size_t size = 0;
+    for (const auto& fragment : fragments) {
+        size += fragment.payload.size();
+    }
+    reassembled.resize(size);
+    if (!ReassembleFragments(fragments, std::span<uint8_t>(reassembled))) {
+        reassembled.clear();
+        return false;
+    }
+    return true;
+}
+
+LdnPacket CreateErrorPacket(uint32_t session_id, uint8_t source_node_id, uint8_t dest_node_id,
+                            ErrorCode error, std::string_view message) {
+    LdnPacket packet;
+    packet.header.source_node_id = source_node_id;
+    packet.header.session_id = session_id;
+    packet.header.packet_type = static_cast<uint16_t>(PacketType::Error);
+    packet.header.dest_node_id = dest_node_id;
+
+    message = message.substr(0, MAX_PACKET_SIZE - sizeof(uint32_t));
+    packet.payload.resize(sizeof(uint32_t) + message.size());
+    Wire::StoreLittle(std::span(packet.payload).first<sizeof(uint32_t)>(),
+                      static_cast<uint32_t>(error));
+    std::memcpy(packet.payload.data() + sizeof(uint32_t), message.data(), message.size());
+    packet.header.payload_size = static_cast<uint32_t>(packet.payload.size());
+    packet.header.crc32 = Crc32(packet.payload);
+    return packet;
+}
+
+} // namespace Core::Multiplayer
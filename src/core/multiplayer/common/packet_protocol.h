@@ -0,0 +1,169 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "error_codes.h"
+#include "packet_buffer.h"
+#include "wire_format.h"
+
+namespace Core::Multiplayer {
+
+constexpr uint16_t LDN_PACKET_MAGIC = 0x4C44; // "LD"
+constexpr uint8_t LDN_PACKET_VERSION = 1;
+
+enum class PacketType : uint16_t {
+    Handshake = 1,
+    HandshakeAck,
+    Data,
+    Ack,
+    Heartbeat,
+    Disconnect,
+    Fragment,
+    Error,
+};
+
+/**
+ * Header of an LDN protocol packet. The struct is the wire layout: every
+ * field goes out little endian at its own offset, with no padding.
+ */
+struct LdnPacketHeader {
+    uint16_t magic = LDN_PACKET_MAGIC;
+    uint8_t version = LDN_PACKET_VERSION;
+    uint8_t source_node_id = 0;
+    uint32_t session_id = 0;
+    uint16_t packet_type = static_cast<uint16_t>(PacketType::Data);
+    uint8_t dest_node_id = 0;
+    uint8_t reserved = 0;
+    uint32_t sequence_number = 0;
+    uint64_t timestamp = 0;
+    uint16_t fragment_id = 0;
+    uint16_t total_fragments = 0;
+    uint32_t payload_size = 0;
+    uint32_t crc32 = 0; // CRC-32 of the payload
+    uint32_t reserved2 = 0;
+};
+
+constexpr size_t LDN_PACKET_HEADER_SIZE = sizeof(LdnPacketHeader);
+static_assert(LDN_PACKET_HEADER_SIZE == 40, "LdnPacketHeader must match the wire layout");
+
+#define LDN_HEADER_FIELD(name) Wire::Field<&LdnPacketHeader::name, offsetof(LdnPacketHeader, name)>
+using LdnPacketHeaderLayout =
+    Wire::Layout<LDN_PACKET_HEADER_SIZE, LDN_HEADER_FIELD(magic), LDN_HEADER_FIELD(version),
+                 LDN_HEADER_FIELD(source_node_id), LDN_HEADER_FIELD(session_id),
+                 LDN_HEADER_FIELD(packet_type), LDN_HEADER_FIELD(dest_node_id),
+                 LDN_HEADER_FIELD(reserved), LDN_HEADER_FIELD(sequence_number),
+                 LDN_HEADER_FIELD(timestamp), LDN_HEADER_FIELD(fragment_id),
+                 LDN_HEADER_FIELD(total_fragments), LDN_HEADER_FIELD(payload_size),
+                 LDN_HEADER_FIELD(crc32), LDN_HEADER_FIELD(reserved2)>;
+#undef LDN_HEADER_FIELD
+
+// Largest payload; header and payload together fit one PacketBuffer
+constexpr size_t MAX_PACKET_SIZE = PACKET_BUFFER_SIZE - LDN_PACKET_HEADER_SIZE;
+
+struct LdnPacket {
+    LdnPacketHeader header;
+    std::vector<uint8_t> payload;
+};
+
+/**
+ * A packet whose payload lives elsewhere: in the received datagram, or in
+ * the buffer FragmentData split. Valid as long as that storage is.
+ */
+struct LdnPacketView {
+    LdnPacketHeader header;
+    std::span<const uint8_t> payload;
+};
+
+// CRC-32 (IEEE), see Crc32
+uint32_t CalculateCRC32(const uint8_t* data, size_t size);
+
+bool ValidatePacketType(uint16_t packet_type);
+
+/**
+ * Magic, version, type, payload size against both the limit and the
+ * payload, and the payload's CRC
+ */
+bool ValidatePacket(const LdnPacket& packet);
+bool ValidatePacket(const LdnPacketView& packet);
+
+/**
+ * Writes the header alone, as it stands, for sending ahead of a payload
+ * that stays where it is (e.g. as an OutgoingDatagram tail)
+ */
+void SerializeHeader(const LdnPacketHeader& header,
+                     std::span<uint8_t, LDN_PACKET_HEADER_SIZE> out);
+
+/**
+ * Writes header and payload into out, filling in payload_size and the
+ * payload's CRC as it goes
+ * @return Bytes written, or nullopt if the payload is too large or out too
+ *         small
+ */
+std::optional<size_t> SerializePacket(const LdnPacketHeader& header,
+                                      std::span<const uint8_t> payload, std::span<uint8_t> out);
+
+// As above, reusing serialized's capacity
+bool SerializePacket(const LdnPacket& packet, std::vector<uint8_t>& serialized);
+
+/**
+ * Parses a received packet without copying its payload; out.payload points
+ * into data. Fails on anything ValidatePacket rejects.
+ */
+bool DeserializePacket(std::span<const uint8_t> data, LdnPacketView& out);
+bool DeserializePacket(std::span<const uint8_t> data, LdnPacket& out);
+
+/**
+ * Splits data into Fragment packets of up to MAX_PACKET_SIZE, numbered from
+ * first_sequence. Each fragment's payload is a view into data and its CRC
+ * is filled in, so the fragments can go out without copying.
+ * @return False if data is empty or needs more than 65535 fragments
+ */
+bool FragmentData(std::span<const uint8_t> data, uint32_t session_id, uint8_t source_node_id,
+                  uint8_t dest_node_id, std::vector<LdnPacketView>& fragments,
+                  uint32_t first_sequence = 0);
+
+/**
+ * Joins the fragments of one message, in any order, into out
+ * @return Bytes written, or nullopt if fragments are missing, repeated,
+ *         inconsistent or do not fit
+ */
+std::optional<size_t> ReassembleFragments(std::span<const LdnPacketView> fragments,
+                                          std::span<uint8_t> out);
+bool ReassembleFragments(std::span<const LdnPacketView> fragments,
+                         std::vector<uint8_t>& reassembled);
+
+/**
+ * Error packet whose payload is the code, as 32 bits little endian,
+ * followed by the message, cut to fit
+ */
+LdnPacket CreateErrorPacket(uint32_t session_id, uint8_t source_node_id, uint8_t dest_node_id,
+                            ErrorCode error, std::string_view message);
+
+/**
+ * Per-session sequence numbers, wrapping at 2^32. Thread-safe.
+ */
+class PacketSequencer {
+public:
+    uint32_t GetNextSequence() {
+        return sequence_.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    // The next GetNextSequence() returns sequence + 1
+    void SetSequence(uint32_t sequence) {
+        sequence_.store(sequence, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint32_t> sequence_{0};
+};
+
+} // namespace Core::Multiplayer
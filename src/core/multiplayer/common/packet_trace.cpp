@@ -0,0 +1,151 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "packet_trace.h"
+
+#ifdef SUDACHI_MULTIPLAYER_TRACING
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdio>
+
+#include "monotonic_clock.h"
+
+namespace Core::Multiplayer::Trace {
+
+namespace {
+
+/**
+ * Ring slot written by one recorder at a time. Fields are relaxed atomics
+ * so a reader racing a writer sees a torn event, never undefined behavior;
+ * the sequence tells it to drop the event.
+ */
+struct alignas(64) Slot {
+    std::atomic<uint64_t> sequence{0}; // Index + 1 once written, 0 while writing
+    std::atomic<const char*> name{nullptr};
+    std::atomic<uint32_t> trace_id{0};
+    std::atomic<uint32_t> thread_id{0};
+    std::atomic<uint64_t> begin_ns{0};
+    std::atomic<uint64_t> end_ns{0};
+};
+
+std::atomic<uint32_t> sample_interval{DEFAULT_SAMPLE_INTERVAL};
+std::atomic<uint32_t> next_trace_id{0};
+std::atomic<uint32_t> next_thread_id{0};
+std::atomic<uint64_t> next_slot{0};
+// Slots below this index were cleared
+std::atomic<uint64_t> first_slot{0};
+std::array<Slot, EVENT_CAPACITY> slots;
+
+thread_local uint32_t sample_countdown = 0;
+
+uint32_t ThisThreadId() {
+    thread_local const uint32_t id = next_thread_id.fetch_add(1, std::memory_order_relaxed) + 1;
+    return id;
+}
+
+} // namespace
+
+void SetSampleInterval(uint32_t interval) {
+    sample_interval.store(interval, std::memory_order_relaxed);
+}
+
+uint32_t GetSampleInterval() {
+    return sample_interval.load(std::memory_order_relaxed);
+}
+
+uint32_t BeginPacket() {
+    const uint32_t interval = sample_interval.load(std::memory_order_relaxed);
+    if (interval == 0) {
+        return 0;
+    }
+    // Counted per thread so untraced packets never touch shared state
+    if (sample_countdown > 1 && sample_countdown <= interval) {
+        --sample_countdown;
+        return 0;
+    }
+    sample_countdown = interval;
+    uint32_t id = next_trace_id.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (id == 0) {
+        // Wrapped; 0 means untraced
+        id = next_trace_id.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+    return id;
+}
+
+uint64_t NowNs() {
+    return MonotonicClock::Now();
+}
+
+void RecordSpan(const char* name, uint32_t trace_id, uint64_t begin_ns, uint64_t end_ns) {
+    const uint64_t index = next_slot.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = slots[index % EVENT_CAPACITY];
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.trace_id.store(trace_id, std::memory_order_relaxed);
+    slot.thread_id.store(ThisThreadId(), std::memory_order_relaxed);
+    slot.begin_ns.store(begin_ns, std::memory_order_relaxed);
+    slot.end_ns.store(std::max(end_ns, begin_ns), std::memory_order_relaxed);
+    slot.sequence.store(index + 1, std::memory_order_release);
+}
+
+std::vector<TraceEvent> CollectEvents() {
+    const uint64_t end = next_slot.load(std::memory_order_acquire);
+    const uint64_t begin = std::max(end > EVENT_CAPACITY ? end - EVENT_CAPACITY : 0,
+                                    first_slot.load(std::memory_order_acquire));
+
+    std::vector<TraceEvent> events;
+    events.reserve(static_cast<size_t>(end > begin ? end - begin : 0));
+    for (uint64_t index = begin; index < end; ++index) {
+        const Slot& slot = slots[index % EVENT_CAPACITY];
+        if (slot.sequence.load(std::memory_order_acquire) != index + 1) {
+            continue; // Still being written, or already overwritten
+        }
+        TraceEvent event;
+        event.name = slot.name.load(std::memory_order_relaxed);
+        event.trace_id = slot.trace_id.load(std::memory_order_relaxed);
+        event.thread_id = slot.thread_id.load(std::memory_order_relaxed);
+        event.begin_ns = slot.begin_ns.load(std::memory_order_relaxed);
+        event.end_ns = slot.end_ns.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == index + 1 && event.name) {
+            events.push_back(event);
+        }
+    }
+    return events;
+}
+
+std::string ExportChromeTrace() {
+    auto events = CollectEvents();
+    std::sort(events.begin(), events.end(),
+              [](const TraceEvent& a, const TraceEvent& b) { return a.begin_ns < b.begin_ns; });
+
+    std::string json = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    char line[256];
+    for (size_t i = 0; i < events.size(); ++i) {
+        const auto& event = events[i];
+        // Zone names are literals in this codebase and need no escaping
+        const int length = std::snprintf(
+            line, sizeof(line),
+            "%s{\"name\":\"%s\",\"cat\":\"multiplayer\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+            "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"trace_id\":%u}}",
+            i == 0 ? "" : ",", event.name, event.thread_id,
+            static_cast<double>(event.begin_ns) / 1000.0,
+            static_cast<double>(event.end_ns - event.begin_ns) / 1000.0, event.trace_id);
+        if (length > 0) {
+            json.append(line, std::min(static_cast<size_t>(length), sizeof(line) - 1));
+        }
+    }
+    json += "]}";
+    return json;
+}
+
+void ClearEvents() {
+    first_slot.store(next_slot.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+} // namespace Core::Multiplayer::Trace
+
+#endif // SUDACHI_MULTIPLAYER_TRACING
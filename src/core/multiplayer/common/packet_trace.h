@@ -0,0 +1,179 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+/**
+ * Per-packet tracing across LDN -> backend -> transport.
+ *
+ * Built only with SUDACHI_MULTIPLAYER_TRACING (the CMake option of the same
+ * name); otherwise every macro below expands to nothing and
+ * MULTIPLAYER_TRACE_ID() to 0, so the data path carries no trace code.
+ *
+ * A packet is tagged with a trace id where it enters the multiplayer stack:
+ * the LdnServiceBridge or backend send call going out, the transport's
+ * receive handler coming in. The id lives in a thread local for the rest of
+ * that synchronous call chain, and ReceivedPacket::trace_id carries it across
+ * the receive queue. Zones opened while a traced packet is current are
+ * recorded into a fixed ring that ExportChromeTrace() writes as JSON for the
+ * Perfetto UI or chrome://tracing, and, when built against Tracy
+ * (SUDACHI_MULTIPLAYER_TRACY), also emitted as Tracy zones.
+ *
+ * Only one packet in GetSampleInterval() gets an id; the rest cost a thread
+ * local read and a countdown per hop, which keeps a sampled capture cheap
+ * enough to leave on in release builds.
+ */
+
+#include <cstdint>
+
+#ifdef SUDACHI_MULTIPLAYER_TRACING
+
+#include <string>
+#include <vector>
+
+#ifdef SUDACHI_MULTIPLAYER_TRACY
+#include <tracy/Tracy.hpp>
+#endif
+
+namespace Core::Multiplayer::Trace {
+
+// One in this many packets is traced unless changed with SetSampleInterval
+constexpr uint32_t DEFAULT_SAMPLE_INTERVAL = 1024;
+// Events kept before the oldest are overwritten
+constexpr size_t EVENT_CAPACITY = size_t{1} << 14;
+
+struct TraceEvent {
+    const char* name = nullptr; // Zone names are string literals
+    uint32_t trace_id = 0;
+    uint32_t thread_id = 0;
+    uint64_t begin_ns = 0; // MonotonicClock, like DataPathLatency::Now()
+    uint64_t end_ns = 0;
+};
+
+namespace Detail {
+inline thread_local uint32_t current_trace_id = 0;
+} // namespace Detail
+
+/**
+ * Sets how many packets pass per traced one: 1 traces every packet, 0
+ * stops tagging new packets.
+ */
+void SetSampleInterval(uint32_t interval);
+uint32_t GetSampleInterval();
+
+// Trace id of the packet this thread is handling; 0 when untraced
+inline uint32_t CurrentId() {
+    return Detail::current_trace_id;
+}
+
+// A new trace id if this packet is sampled, otherwise 0
+uint32_t BeginPacket();
+
+uint64_t NowNs();
+void RecordSpan(const char* name, uint32_t trace_id, uint64_t begin_ns, uint64_t end_ns);
+
+// Recorded events still in the ring, oldest first
+std::vector<TraceEvent> CollectEvents();
+// The recorded events as Chrome trace event JSON
+std::string ExportChromeTrace();
+void ClearEvents();
+
+/**
+ * Makes a packet's trace id current on this thread for the scope. Reuses the
+ * current id when there is one, so a packet keeps the id its outermost entry
+ * point gave it.
+ */
+class PacketScope {
+public:
+    PacketScope() : previous_(Detail::current_trace_id) {
+        if (previous_ == 0) {
+            Detail::current_trace_id = BeginPacket();
+        }
+    }
+    explicit PacketScope(uint32_t trace_id) : previous_(Detail::current_trace_id) {
+        Detail::current_trace_id = trace_id;
+    }
+    ~PacketScope() {
+        Detail::current_trace_id = previous_;
+    }
+
+    PacketScope(const PacketScope&) = delete;
+    PacketScope& operator=(const PacketScope&) = delete;
+
+private:
+    const uint32_t previous_;
+};
+
+/**
+ * Records the scope as a span of the current packet's trace, if it has one.
+ */
+class Zone {
+public:
+    explicit Zone(const char* name)
+        : name_(name), trace_id_(CurrentId()), begin_ns_(trace_id_ != 0 ? NowNs() : 0) {}
+    ~Zone() {
+        if (trace_id_ != 0) {
+            RecordSpan(name_, trace_id_, begin_ns_, NowNs());
+        }
+    }
+
+    Zone(const Zone&) = delete;
+    Zone& operator=(const Zone&) = delete;
+
+private:
+    const char* const name_;
+    const uint32_t trace_id_;
+    const uint64_t begin_ns_;
+};
+
+} // namespace Core::Multiplayer::Trace
+
+#define MULTIPLAYER_TRACE_CONCAT_INNER(a, b) a##b
+#define MULTIPLAYER_TRACE_CONCAT(a, b) MULTIPLAYER_TRACE_CONCAT_INNER(a, b)
+
+#ifdef SUDACHI_MULTIPLAYER_TRACY
+#define MULTIPLAYER_TRACE_TRACY_ZONE(name)                                                         \
+    ZoneNamedN(MULTIPLAYER_TRACE_CONCAT(multiplayer_tracy_zone_, __LINE__), name,                  \
+               ::Core::Multiplayer::Trace::CurrentId() != 0);                                      \
+    MULTIPLAYER_TRACE_CONCAT(multiplayer_tracy_zone_, __LINE__)                                    \
+        .Value(::Core::Multiplayer::Trace::CurrentId())
+#else
+#define MULTIPLAYER_TRACE_TRACY_ZONE(name) static_cast<void>(0)
+#endif
+
+// Tags the packet being handled with a trace id, unless it already has one
+#define MULTIPLAYER_TRACE_PACKET()                                                                 \
+    const ::Core::Multiplayer::Trace::PacketScope MULTIPLAYER_TRACE_CONCAT(                        \
+        multiplayer_trace_packet_, __LINE__) {}
+// Makes a trace id carried with a packet current again, e.g. after a queue
+#define MULTIPLAYER_TRACE_RESUME(trace_id)                                                         \
+    const ::Core::Multiplayer::Trace::PacketScope MULTIPLAYER_TRACE_CONCAT(                        \
+        multiplayer_trace_packet_, __LINE__) {                                                     \
+        trace_id                                                                                   \
+    }
+// Records the enclosing scope under the given string literal
+#define MULTIPLAYER_TRACE_ZONE(name)                                                               \
+    const ::Core::Multiplayer::Trace::Zone MULTIPLAYER_TRACE_CONCAT(multiplayer_trace_zone_,       \
+                                                                    __LINE__) {                    \
+        name                                                                                       \
+    };                                                                                             \
+    MULTIPLAYER_TRACE_TRACY_ZONE(name)
+// Records a span that began earlier, such as the time a packet sat in a queue
+#define MULTIPLAYER_TRACE_SPAN(name, trace_id, begin_ns)                                           \
+    do {                                                                                           \
+        if ((trace_id) != 0) {                                                                     \
+            ::Core::Multiplayer::Trace::RecordSpan(name, trace_id, begin_ns,                       \
+                                                   ::Core::Multiplayer::Trace::NowNs());           \
+        }                                                                                          \
+    } while (false)
+#define MULTIPLAYER_TRACE_ID() ::Core::Multiplayer::Trace::CurrentId()
+
+#else
+
+#define MULTIPLAYER_TRACE_PACKET() static_cast<void>(0)
+#define MULTIPLAYER_TRACE_RESUME(trace_id) static_cast<void>(0)
+#define MULTIPLAYER_TRACE_ZONE(name) static_cast<void>(0)
+#define MULTIPLAYER_TRACE_SPAN(name, trace_id, begin_ns) static_cast<void>(0)
+#define MULTIPLAYER_TRACE_ID() uint32_t{0}
+
+#endif
@@ -0,0 +1,376 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "persistent_cache_store.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+
+#include "crc32c.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Core::Multiplayer {
+
+using namespace PersistentCacheFormat;
+
+struct PersistentCacheStore::Record {
+    uint64_t sequence;  // 0 for a copy never written
+    uint32_t checksum;  // CRC-32C of the record with this field left out
+    uint16_t kind;
+    uint16_t schema;
+    uint8_t key_size;
+    uint8_t flags;
+    uint16_t value_size;
+    uint8_t key[KEY_CAPACITY];
+    uint8_t value[VALUE_CAPACITY];
+};
+
+namespace {
+
+constexpr uint8_t FLAG_ERASED = 0x01;
+constexpr size_t COPIES_PER_SLOT = 2;
+
+constexpr uint8_t SLOT_UNVERIFIED = 0;
+constexpr uint8_t SLOT_EMPTY = 3;
+
+struct FileHeader {
+    uint32_t magic = MAGIC;
+    uint16_t version = VERSION;
+    uint16_t record_size = RECORD_SIZE;
+    uint64_t slot_count = 0;
+    uint32_t key_capacity = KEY_CAPACITY;
+    uint32_t value_capacity = VALUE_CAPACITY;
+    uint8_t reserved[40] = {};
+};
+static_assert(sizeof(FileHeader) == HEADER_SIZE);
+
+size_t FileSize(size_t slot_count) {
+    return HEADER_SIZE + slot_count * COPIES_PER_SLOT * RECORD_SIZE;
+}
+
+uint32_t RecordChecksum(const uint8_t* record) {
+    const uint32_t crc = Crc32c(std::span(record, sizeof(uint64_t)));
+    constexpr size_t body = sizeof(uint64_t) + sizeof(uint32_t);
+    return Crc32c(std::span(record + body, RECORD_SIZE - body), crc);
+}
+
+} // namespace
+
+PersistentCacheStore::~PersistentCacheStore() {
+    Close();
+}
+
+ErrorCode PersistentCacheStore::Open(const std::string& path, size_t slot_count) {
+    std::lock_guard lock(mutex_);
+    if (mapping_) {
+        return ErrorCode::InvalidState;
+    }
+    if (slot_count == 0) {
+        return ErrorCode::InvalidParameter;
+    }
+    slot_count = std::bit_ceil(slot_count);
+
+#ifdef _WIN32
+    const HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ,
+                                    nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return ErrorCode::PermissionDenied;
+    }
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size)) {
+        CloseHandle(file);
+        return ErrorCode::PermissionDenied;
+    }
+    file_ = file;
+    const auto map = [this](size_t size) {
+        const auto wide = static_cast<uint64_t>(size);
+        const HANDLE file_mapping =
+            CreateFileMappingA(static_cast<HANDLE>(file_), nullptr, PAGE_READWRITE,
+                               static_cast<DWORD>(wide >> 32), static_cast<DWORD>(wide), nullptr);
+        void* view = file_mapping ? MapViewOfFile(file_mapping, FILE_MAP_WRITE, 0, 0, size)
+                                  : nullptr;
+        if (!view) {
+            if (file_mapping) {
+                CloseHandle(file_mapping);
+            }
+            return false;
+        }
+        file_mapping_ = file_mapping;
+        mapping_ = static_cast<uint8_t*>(view);
+        size_ = size;
+        return true;
+    };
+    const auto truncate = [this] {
+        LARGE_INTEGER start{};
+        return SetFilePointerEx(static_cast<HANDLE>(file_), start, nullptr, FILE_BEGIN) &&
+               SetEndOfFile(static_cast<HANDLE>(file_));
+    };
+    const auto close_file = [this] {
+        CloseHandle(static_cast<HANDLE>(file_));
+        file_ = nullptr;
+    };
+    const size_t existing_size = static_cast<size_t>(file_size.QuadPart);
+#else
+    const int file = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (file < 0) {
+        return ErrorCode::PermissionDenied;
+    }
+    struct stat file_stat{};
+    if (::fstat(file, &file_stat) != 0) {
+        ::close(file);
+        return ErrorCode::PermissionDenied;
+    }
+    file_ = file;
+    const auto map = [this](size_t size) {
+        if (::ftruncate(file_, static_cast<off_t>(size)) != 0) {
+            return false;
+        }
+        void* view = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file_, 0);
+        if (view == MAP_FAILED) {
+            return false;
+        }
+        mapping_ = static_cast<uint8_t*>(view);
+        size_ = size;
+        return true;
+    };
+    const auto truncate = [this] { return ::ftruncate(file_, 0) == 0; };
+    const auto close_file = [this] {
+        ::close(file_);
+        file_ = -1;
+    };
+    const size_t existing_size = static_cast<size_t>(file_stat.st_size);
+#endif
+
+    // Only the header is read here; records are checked as they are looked up
+    if (existing_size >= HEADER_SIZE && map(existing_size)) {
+        FileHeader header;
+        std::memcpy(&header, mapping_, sizeof(header));
+        const FileHeader expected;
+        if (header.magic == expected.magic && header.version == expected.version &&
+            header.record_size == expected.record_size &&
+            header.key_capacity == expected.key_capacity &&
+            header.value_capacity == expected.value_capacity && header.slot_count != 0 &&
+            std::has_single_bit(header.slot_count) &&
+            existing_size == FileSize(static_cast<size_t>(header.slot_count))) {
+            slot_count_ = static_cast<size_t>(header.slot_count);
+            current_copy_ = std::make_unique<uint8_t[]>(slot_count_);
+            return ErrorCode::Success;
+        }
+        Unmap();
+    }
+
+    // Missing, older or damaged: start over. Truncating first zeroes every
+    // slot, and the header goes in last, so a crash here leaves a file that
+    // is started over again on the next open.
+    if (!truncate() || !map(FileSize(slot_count))) {
+        Unmap();
+        close_file();
+        return ErrorCode::ResourceExhausted;
+    }
+    FileHeader header;
+    header.slot_count = slot_count;
+    std::memcpy(mapping_, &header, sizeof(header));
+    slot_count_ = slot_count;
+    current_copy_ = std::make_unique<uint8_t[]>(slot_count_);
+    return ErrorCode::Success;
+}
+
+void PersistentCacheStore::Close() {
+    std::lock_guard lock(mutex_);
+    if (!mapping_) {
+        return;
+    }
+    Unmap();
+#ifdef _WIN32
+    CloseHandle(static_cast<HANDLE>(file_));
+    file_ = nullptr;
+#else
+    ::close(file_);
+    file_ = -1;
+#endif
+}
+
+bool PersistentCacheStore::IsOpen() const {
+    std::lock_guard lock(mutex_);
+    return mapping_ != nullptr;
+}
+
+std::optional<std::span<const uint8_t>> PersistentCacheStore::Find(CacheKind kind,
+                                                                   uint16_t schema,
+                                                                   std::string_view key) const {
+    std::lock_guard lock(mutex_);
+    const auto slot = FindSlotLocked(kind, key, false);
+    if (!slot) {
+        return std::nullopt;
+    }
+    const Record* record = CurrentRecordLocked(*slot);
+    if (!record || (record->flags & FLAG_ERASED) != 0 || record->schema != schema) {
+        return std::nullopt;
+    }
+    return std::span<const uint8_t>(record->value, record->value_size);
+}
+
+ErrorCode PersistentCacheStore::Store(CacheKind kind, uint16_t schema, std::string_view key,
+                                      std::span<const uint8_t> value) {
+    if (key.size() > KEY_CAPACITY || value.size() > VALUE_CAPACITY) {
+        return ErrorCode::InvalidParameter;
+    }
+    std::lock_guard lock(mutex_);
+    if (!mapping_) {
+        return ErrorCode::NotInitialized;
+    }
+    const auto slot = FindSlotLocked(kind, key, true);
+    if (!slot) {
+        return ErrorCode::ResourceExhausted;
+    }
+    return WriteLocked(*slot, kind, schema, key, value, false);
+}
+
+bool PersistentCacheStore::Erase(CacheKind kind, std::string_view key) {
+    std::lock_guard lock(mutex_);
+    const auto slot = FindSlotLocked(kind, key, false);
+    if (!slot) {
+        return false;
+    }
+    const Record* record = CurrentRecordLocked(*slot);
+    if (!record || (record->flags & FLAG_ERASED) != 0) {
+        return false;
+    }
+    // The key stays in the slot so probes for keys placed after it still reach them
+    return WriteLocked(*slot, kind, record->schema, key, {}, true) == ErrorCode::Success;
+}
+
+ErrorCode PersistentCacheStore::Flush() {
+    std::lock_guard lock(mutex_);
+    if (!mapping_) {
+        return ErrorCode::NotInitialized;
+    }
+#ifdef _WIN32
+    const bool flushed = FlushViewOfFile(mapping_, size_) &&
+                         FlushFileBuffers(static_cast<HANDLE>(file_));
+#else
+    const bool flushed = ::msync(mapping_, size_, MS_SYNC) == 0;
+#endif
+    return flushed ? ErrorCode::Success : ErrorCode::InternalError;
+}
+
+size_t PersistentCacheStore::GetSlotCount() const {
+    std::lock_guard lock(mutex_);
+    return slot_count_;
+}
+
+size_t PersistentCacheStore::GetRecordCount() const {
+    std::lock_guard lock(mutex_);
+    size_t count = 0;
+    for (size_t slot = 0; slot < slot_count_; ++slot) {
+        const Record* record = CurrentRecordLocked(slot);
+        if (record && (record->flags & FLAG_ERASED) == 0) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+std::optional<size_t> PersistentCacheStore::FindSlotLocked(CacheKind kind, std::string_view key,
+                                                           bool for_store) const {
+    if (!mapping_ || key.size() > KEY_CAPACITY) {
+        return std::nullopt;
+    }
+    const auto kind_value = static_cast<uint16_t>(kind);
+    uint32_t hash = Crc32c(std::span(reinterpret_cast<const uint8_t*>(&kind_value),
+                                     sizeof(kind_value)));
+    hash = Crc32c(std::span(reinterpret_cast<const uint8_t*>(key.data()), key.size()), hash);
+
+    // Linear probing; slots are never freed, so an empty one ends the chain
+    const size_t mask = slot_count_ - 1;
+    for (size_t probe = 0; probe < slot_count_; ++probe) {
+        const size_t slot = (hash + probe) & mask;
+        const Record* record = CurrentRecordLocked(slot);
+        if (!record) {
+            return for_store ? std::optional<size_t>(slot) : std::nullopt;
+        }
+        if (record->kind == kind_value && record->key_size == key.size() &&
+            std::memcmp(record->key, key.data(), key.size()) == 0) {
+            return slot;
+        }
+    }
+    return std::nullopt;
+}
+
+const PersistentCacheStore::Record* PersistentCacheStore::CurrentRecordLocked(
+    size_t slot) const {
+    uint8_t& current = current_copy_[slot];
+    if (current == SLOT_UNVERIFIED) {
+        current = SLOT_EMPTY;
+        uint64_t newest = 0;
+        for (size_t copy = 0; copy < COPIES_PER_SLOT; ++copy) {
+            const Record* record = GetCopy(slot, copy);
+            if (record->sequence > newest && record->key_size <= KEY_CAPACITY &&
+                record->value_size <= VALUE_CAPACITY &&
+                record->checksum == RecordChecksum(reinterpret_cast<const uint8_t*>(record))) {
+                newest = record->sequence;
+                current = static_cast<uint8_t>(copy + 1);
+            }
+        }
+    }
+    return current == SLOT_EMPTY ? nullptr : GetCopy(slot, current - 1);
+}
+
+PersistentCacheStore::Record* PersistentCacheStore::GetCopy(size_t slot, size_t copy) const {
+    static_assert(sizeof(Record) == RECORD_SIZE);
+    static_assert(offsetof(Record, value) == 64,
+                  "Values are read in place and must stay 8-byte aligned");
+    return reinterpret_cast<Record*>(mapping_ + HEADER_SIZE +
+                                     (slot * COPIES_PER_SLOT + copy) * RECORD_SIZE);
+}
+
+ErrorCode PersistentCacheStore::WriteLocked(size_t slot, CacheKind kind, uint16_t schema,
+                                            std::string_view key,
+                                            std::span<const uint8_t> value, bool erased) {
+    const Record* current = CurrentRecordLocked(slot);
+    // The copy that is not current; a torn write to it leaves the current one readable
+    const size_t target = current ? (current_copy_[slot] == 1 ? 1 : 0) : 0;
+    Record record{};
+    record.sequence = current ? current->sequence + 1 : 1;
+    record.kind = static_cast<uint16_t>(kind);
+    record.schema = schema;
+    record.key_size = static_cast<uint8_t>(key.size());
+    record.flags = erased ? FLAG_ERASED : 0;
+    record.value_size = static_cast<uint16_t>(value.size());
+    std::memcpy(record.key, key.data(), key.size());
+    if (!value.empty()) {
+        std::memcpy(record.value, value.data(), value.size());
+    }
+    record.checksum = RecordChecksum(reinterpret_cast<const uint8_t*>(&record));
+    std::memcpy(GetCopy(slot, target), &record, sizeof(record));
+    current_copy_[slot] = static_cast<uint8_t>(target + 1);
+    return ErrorCode::Success;
+}
+
+void PersistentCacheStore::Unmap() {
+    if (!mapping_) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(mapping_);
+    CloseHandle(static_cast<HANDLE>(file_mapping_));
+    file_mapping_ = nullptr;
+#else
+    ::munmap(mapping_, size_);
+#endif
+    mapping_ = nullptr;
+    size_ = 0;
+    slot_count_ = 0;
+    current_copy_.reset();
+}
+
+} // namespace Core::Multiplayer
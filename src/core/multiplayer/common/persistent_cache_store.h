@@ -0,0 +1,172 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "error_codes.h"
+
+namespace Core::Multiplayer {
+
+/**
+ * Which cache a record belongs to. Each keeps its own keys and record
+ * schema version; new caches take the next value, never a reused one.
+ */
+enum class CacheKind : uint16_t {
+    NatType = 1,
+    RelayRtt = 2,
+    AddressBook = 3,
+    Capabilities = 4,
+    TrafficProfile = 5,
+};
+
+/**
+ * Cache file layout, little-endian as written by the host:
+ *
+ *   header  64 bytes: magic, version, record size, slot count
+ *   slots   slot_count slots of two RECORD_SIZE copies each
+ *
+ * A record holds a sequence number, a CRC-32C over the record, the cache
+ * kind and its schema version, the key and the value, at fixed offsets.
+ */
+namespace PersistentCacheFormat {
+constexpr uint32_t MAGIC = 0x564B444C; // "LDKV"
+constexpr uint16_t VERSION = 1;
+constexpr size_t HEADER_SIZE = 64;
+constexpr size_t RECORD_SIZE = 256;
+constexpr size_t KEY_CAPACITY = 44;
+constexpr size_t VALUE_CAPACITY = 192;
+} // namespace PersistentCacheFormat
+
+/**
+ * Small key/value store in one memory-mapped file, shared by the caches
+ * that outlive a session (NAT type, relay RTTs, address book, detected
+ * capabilities, title traffic profiles) so none of them needs a file
+ * format or a parse at startup of its own.
+ *
+ * Open maps the file and checks only its header. Records are fixed-size
+ * and found by hashing kind and key into an open-addressed slot table, so
+ * a lookup returns a pointer into the mapping; each slot's checksum is
+ * verified the first time it is read, not when the file is opened.
+ *
+ * Every slot has two copies of its record. Store writes the older copy
+ * with a higher sequence number and leaves the current one untouched, so
+ * a process that dies mid-write leaves a copy that fails its checksum and
+ * the previous value is read instead. Writes reach the file through the
+ * shared mapping; Flush forces them to disk.
+ *
+ * Thread-safe within one process; two processes must not open the same
+ * file at once.
+ */
+class PersistentCacheStore {
+public:
+    static constexpr size_t DEFAULT_SLOT_COUNT = 1024; // 512 KiB
+
+    PersistentCacheStore() = default;
+    ~PersistentCacheStore();
+
+    PersistentCacheStore(const PersistentCacheStore&) = delete;
+    PersistentCacheStore& operator=(const PersistentCacheStore&) = delete;
+
+    /**
+     * Maps the cache file at path, creating it if missing. A file with
+     * another version or layout is started over empty.
+     * @param slot_count Records the table holds, for a new file; rounded up
+     *                   to a power of two. An existing file keeps its own.
+     */
+    [[nodiscard]] ErrorCode Open(const std::string& path,
+                                 size_t slot_count = DEFAULT_SLOT_COUNT);
+    // Unmaps the file; a no-op if not open
+    void Close();
+    bool IsOpen() const;
+
+    /**
+     * The value stored for a key, pointing into the mapping. It stays valid
+     * until the key is stored again or the file is closed.
+     * @return Nothing if the key is missing, or was stored with another schema
+     */
+    std::optional<std::span<const uint8_t>> Find(CacheKind kind, uint16_t schema,
+                                                 std::string_view key) const;
+
+    // The value read in place as a T; null under the same conditions as
+    // Find, or if the stored value is not sizeof(T) bytes
+    template <typename T>
+    const T* Find(CacheKind kind, uint16_t schema, std::string_view key) const {
+        static_assert(std::is_trivially_copyable_v<T> && alignof(T) <= 8 &&
+                      sizeof(T) <= PersistentCacheFormat::VALUE_CAPACITY);
+        const auto value = Find(kind, schema, key);
+        if (!value || value->size() != sizeof(T)) {
+            return nullptr;
+        }
+        return reinterpret_cast<const T*>(value->data());
+    }
+
+    /**
+     * Replaces the value for a key
+     * @return InvalidParameter if the key or value is too long,
+     *         ResourceExhausted if every slot holds another key
+     */
+    ErrorCode Store(CacheKind kind, uint16_t schema, std::string_view key,
+                    std::span<const uint8_t> value);
+
+    // Stores a trivially copyable value as its bytes
+    template <typename T>
+        requires(!std::is_convertible_v<const T&, std::span<const uint8_t>>)
+    ErrorCode Store(CacheKind kind, uint16_t schema, std::string_view key, const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        return Store(kind, schema, key,
+                     std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(&value),
+                                              sizeof(T)));
+    }
+
+    /**
+     * Removes a key; its slot stays reserved for it
+     * @return False if it was not stored
+     */
+    bool Erase(CacheKind kind, std::string_view key);
+
+    // Writes the mapping back to the file and waits for it
+    ErrorCode Flush();
+
+    size_t GetSlotCount() const;
+    // Keys currently stored; counts every slot, so it reads the whole file
+    size_t GetRecordCount() const;
+
+private:
+    struct Record;
+
+    // Index of the slot that holds or would hold the key
+    std::optional<size_t> FindSlotLocked(CacheKind kind, std::string_view key,
+                                         bool for_store) const;
+    // The valid copy with the highest sequence number, verified once per slot
+    const Record* CurrentRecordLocked(size_t slot) const;
+    Record* GetCopy(size_t slot, size_t copy) const;
+    ErrorCode WriteLocked(size_t slot, CacheKind kind, uint16_t schema, std::string_view key,
+                          std::span<const uint8_t> value, bool erased);
+    void Unmap();
+
+    mutable std::mutex mutex_;
+    uint8_t* mapping_ = nullptr;
+    size_t size_ = 0;
+    size_t slot_count_ = 0;
+    // Per slot: 0 not yet verified, 1 or 2 the current copy plus one, 3 empty
+    std::unique_ptr<uint8_t[]> current_copy_;
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* file_mapping_ = nullptr;
+#else
+    int file_ = -1;
+#endif
+};
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,290 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <utility>
+
+namespace Core::Multiplayer {
+
+/**
+ * Send class of an outgoing message, highest first
+ */
+enum class SendPriority : uint8_t {
+    // Session control: handshakes, acks, disconnects
+    Control,
+    // Per-frame game traffic such as input and LDN packets
+    Realtime,
+    // Large transfers like advertise data or save sync, which may wait
+    Bulk,
+};
+
+constexpr size_t SEND_PRIORITY_COUNT = 3;
+
+/**
+ * Where a title's state packets carry the slot that says what they update,
+ * such as an LDN packet type or a game-defined object id: length bytes at
+ * offset, read little-endian. Two queued packets with the same slot hold
+ * the same state, so the newer one replaces the older (see
+ * PrioritySendQueue::PushLatest) instead of queueing behind it. Slots are
+ * at most 7 bytes, leaving the top byte of a key for the destination node.
+ */
+struct LatestValueKey {
+    static constexpr uint8_t MAX_LENGTH = 7;
+
+    uint16_t offset = 0;
+    uint8_t length = 0; // 0 turns latest-value-wins off
+
+    bool IsEnabled() const {
+        return length != 0 && length <= MAX_LENGTH;
+    }
+
+    // The slot of a payload; nothing if off or the payload is too short to have one
+    std::optional<uint64_t> Extract(std::span<const uint8_t> payload) const {
+        if (!IsEnabled() || payload.size() < static_cast<size_t>(offset) + length) {
+            return std::nullopt;
+        }
+        uint64_t slot = 0;
+        for (uint8_t i = 0; i < length; ++i) {
+            slot |= static_cast<uint64_t>(payload[offset + i]) << (8 * i);
+        }
+        return slot;
+    }
+
+    bool operator==(const LatestValueKey&) const = default;
+};
+
+enum class PushResult : uint8_t {
+    Queued,
+    Replaced, // An older message with the same key was overwritten in place
+    Full,
+};
+
+/**
+ * Messages waiting for a link, taken out by send class.
+ *
+ * Control goes before realtime and realtime before bulk, strictly, so a
+ * long bulk backlog never delays an input packet by more than the one
+ * message already being written. Within control and realtime, destinations
+ * with something waiting take turns one message at a time. Bulk is shared
+ * by deficit round-robin: each turn a destination may send up to a quantum
+ * of bytes, so one large transfer cannot starve another destination's.
+ *
+ * Not thread-safe; the owner serializes access, usually under the lock
+ * that already serializes writes to the link.
+ */
+template <typename T>
+class PrioritySendQueue {
+public:
+    /**
+     * @param max_messages Messages held across every class and destination
+     * @param bulk_quantum Bulk bytes a destination may send per turn
+     */
+    explicit PrioritySendQueue(size_t max_messages = 256, size_t bulk_quantum = 1500)
+        : max_messages_(max_messages), bulk_quantum_(bulk_quantum) {}
+
+    /**
+     * Enqueues a message of size bytes for a destination
+     * @return False if the queue is full; the message is not moved from
+     */
+    bool Push(uint64_t destination, SendPriority priority, T&& message, size_t size) {
+        if (size_ >= max_messages_) {
+            return false;
+        }
+        const size_t index = static_cast<size_t>(priority);
+        auto& lane = destinations_[destination].lanes[index];
+        if (lane.empty()) {
+            active_[index].push_back(destination);
+        }
+        lane.push_back({std::move(message), size, std::nullopt});
+        ++counts_[index];
+        ++size_;
+        return true;
+    }
+
+    /**
+     * Latest-value-wins push: a message still queued for the destination
+     * in the same class with the same key is overwritten in place, keeping
+     * its turn, so a stalled link drains one message per key instead of a
+     * backlog of superseded ones. Otherwise the message is queued as Push
+     * would.
+     */
+    PushResult PushLatest(uint64_t destination, SendPriority priority, uint64_t key, T&& message,
+                          size_t size) {
+        const size_t index = static_cast<size_t>(priority);
+        if (const auto it = destinations_.find(destination); it != destinations_.end()) {
+            for (auto& entry : it->second.lanes[index]) {
+                if (entry.key == key) {
+                    entry.message = std::move(message);
+                    entry.size = size;
+                    return PushResult::Replaced;
+                }
+            }
+        }
+        if (!Push(destination, priority, std::move(message), size)) {
+            return PushResult::Full;
+        }
+        destinations_[destination].lanes[index].back().key = key;
+        return PushResult::Queued;
+    }
+
+    /**
+     * The message Pop would take next, left in the queue
+     * @return Null when empty
+     */
+    T* Front() {
+        const auto next = Settle();
+        if (!next) {
+            return nullptr;
+        }
+        return &destinations_[next->second].lanes[next->first].front().message;
+    }
+
+    /**
+     * Takes the next message in priority order
+     * @return False when empty
+     */
+    bool Pop(T& out) {
+        const auto next = Settle();
+        if (!next) {
+            return false;
+        }
+        const auto [index, destination] = *next;
+        auto& state = destinations_[destination];
+        auto& lane = state.lanes[index];
+        out = std::move(lane.front().message);
+        const size_t size = lane.front().size;
+        lane.pop_front();
+        --counts_[index];
+        --size_;
+
+        auto& active = active_[index];
+        if (index == static_cast<size_t>(SendPriority::Bulk)) {
+            // The destination keeps its turn while its deficit lasts
+            state.deficit -= size;
+            if (lane.empty()) {
+                state.deficit = 0;
+                state.has_turn = false;
+                active.pop_front();
+            }
+        } else {
+            active.pop_front();
+            if (!lane.empty()) {
+                active.push_back(destination);
+            }
+        }
+        if (state.IsIdle()) {
+            destinations_.erase(destination);
+        }
+        return true;
+    }
+
+    // Drops everything held for a destination, e.g. when it disconnects
+    void Remove(uint64_t destination) {
+        const auto it = destinations_.find(destination);
+        if (it == destinations_.end()) {
+            return;
+        }
+        for (size_t index = 0; index < SEND_PRIORITY_COUNT; ++index) {
+            const size_t dropped = it->second.lanes[index].size();
+            if (dropped != 0) {
+                counts_[index] -= dropped;
+                size_ -= dropped;
+                std::erase(active_[index], destination);
+            }
+        }
+        destinations_.erase(it);
+    }
+
+    void Clear() {
+        destinations_.clear();
+        for (auto& active : active_) {
+            active.clear();
+        }
+        counts_.fill(0);
+        size_ = 0;
+    }
+
+    size_t Size() const {
+        return size_;
+    }
+
+    size_t Size(SendPriority priority) const {
+        return counts_[static_cast<size_t>(priority)];
+    }
+
+    bool Empty() const {
+        return size_ == 0;
+    }
+
+private:
+    struct Entry {
+        T message;
+        size_t size;
+        std::optional<uint64_t> key; // Set by PushLatest
+    };
+    struct Destination {
+        std::array<std::deque<Entry>, SEND_PRIORITY_COUNT> lanes;
+        // Bulk bytes this destination may still send on its current turn
+        size_t deficit = 0;
+        bool has_turn = false;
+
+        bool IsIdle() const {
+            for (const auto& lane : lanes) {
+                if (!lane.empty()) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    /**
+     * Finds the class and destination to serve next. For bulk this hands
+     * out quanta until the destination in front can afford its message, so
+     * calling it again without a Pop in between changes nothing.
+     */
+    std::optional<std::pair<size_t, uint64_t>> Settle() {
+        for (size_t index = 0; index < SEND_PRIORITY_COUNT; ++index) {
+            auto& active = active_[index];
+            if (active.empty()) {
+                continue;
+            }
+            if (index != static_cast<size_t>(SendPriority::Bulk)) {
+                return std::make_pair(index, active.front());
+            }
+            while (true) {
+                auto& state = destinations_[active.front()];
+                if (!state.has_turn) {
+                    state.deficit += bulk_quantum_;
+                    state.has_turn = true;
+                }
+                if (state.deficit >= state.lanes[index].front().size) {
+                    return std::make_pair(index, active.front());
+                }
+                // Turn over; a message larger than a quantum waits a few rounds
+                state.has_turn = false;
+                active.push_back(active.front());
+                active.pop_front();
+            }
+        }
+        return std::nullopt;
+    }
+
+    const size_t max_messages_;
+    const size_t bulk_quantum_;
+    std::unordered_map<uint64_t, Destination> destinations_;
+    // Destinations with messages waiting in each class, in serving order
+    std::array<std::deque<uint64_t>, SEND_PRIORITY_COUNT> active_;
+    std::array<size_t, SEND_PRIORITY_COUNT> counts_{};
+    size_t size_ = 0;
+};
+
+} // namespace Core::Multiplayer
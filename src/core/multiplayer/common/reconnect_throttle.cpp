@@ -0,0 +1,39 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "reconnect_throttle.h"
+
+#include <algorithm>
+#include <random>
+
+namespace Core::Multiplayer {
+
+ReconnectThrottle::ReconnectThrottle(const ReconnectThrottleConfig& config)
+    : attempts_per_second_(std::max(config.attempts_per_second, 0.001)),
+      bucket_(std::max(config.burst, 1.0), attempts_per_second_) {}
+
+std::shared_ptr<ReconnectThrottle> ReconnectThrottle::GetShared() {
+    static std::shared_ptr<ReconnectThrottle> shared = std::make_shared<ReconnectThrottle>();
+    return shared;
+}
+
+std::chrono::milliseconds ReconnectThrottle::TryAcquire() {
+    if (bucket_.TryConsume()) {
+        return std::chrono::milliseconds::zero();
+    }
+    deferred_.fetch_add(1, std::memory_order_relaxed);
+
+    // Until the next token, plus up to one more interval of jitter
+    const double interval_ms = 1000.0 / attempts_per_second_;
+    const double missing = std::clamp(1.0 - bucket_.GetTokens(), 0.0, 1.0);
+    thread_local std::mt19937 generator{std::random_device{}()};
+    std::uniform_real_distribution<double> jitter(0.0, interval_ms);
+    const double wait_ms = missing * interval_ms + jitter(generator);
+    return std::chrono::milliseconds(std::max<int64_t>(1, static_cast<int64_t>(wait_ms)));
+}
+
+uint64_t ReconnectThrottle::GetDeferredCount() const {
+    return deferred_.load(std::memory_order_relaxed);
+}
+
+} // namespace Core::Multiplayer
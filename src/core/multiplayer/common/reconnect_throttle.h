@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include "network_security.h"
+
+namespace Core::Multiplayer {
+
+struct ReconnectThrottleConfig {
+    double burst = 4.0;               // Attempts that may start back to back
+    double attempts_per_second = 1.0; // Sustained rate once the burst is spent
+};
+
+/**
+ * Token bucket shared by every client that reconnects to a server, so a
+ * process that loses several connections at once (room server restart,
+ * network change) spreads its attempts out instead of firing them all on
+ * top of each other's backoff.
+ *
+ * A caller refused a token is told how long to wait, spread over one
+ * refill interval so the refused callers do not come back together.
+ */
+class ReconnectThrottle {
+public:
+    explicit ReconnectThrottle(const ReconnectThrottleConfig& config = {});
+
+    /**
+     * Process-wide throttle used by RoomClient and RelayClient
+     */
+    static std::shared_ptr<ReconnectThrottle> GetShared();
+
+    /**
+     * Takes a token for one connection attempt
+     * @return Zero if the attempt may start now, otherwise when to ask again
+     */
+    std::chrono::milliseconds TryAcquire();
+
+    // Attempts told to wait so far
+    uint64_t GetDeferredCount() const;
+
+private:
+    const double attempts_per_second_;
+    Security::TokenBucketRateLimit bucket_;
+    std::atomic<uint64_t> deferred_{0};
+};
+
+} // namespace Core::Multiplayer
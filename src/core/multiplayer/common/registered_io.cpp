@@ -0,0 +1,349 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "registered_io.h"
+
+#include "datagram_socket.h"
+
+#ifdef _WIN32
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <mswsock.h>
+#endif
+
+namespace Core::Multiplayer {
+
+#ifdef _WIN32
+
+namespace {
+
+// Each slot starts with the peer address, in the SOCKADDR_INET form RIO uses
+constexpr size_t ADDRESS_SIZE = sizeof(SOCKADDR_INET);
+constexpr size_t DATA_OFFSET = 32;
+static_assert(ADDRESS_SIZE <= DATA_OFFSET, "Slot address area too small");
+constexpr size_t DATA_SIZE = RegisteredIoQueue::SLOT_SIZE - DATA_OFFSET;
+// Receive slots come first, then send slots
+constexpr size_t SLOT_COUNT = RegisteredIoQueue::RECEIVE_DEPTH + RegisteredIoQueue::SEND_DEPTH;
+
+bool LoadFunctions(SOCKET socket, RIO_EXTENSION_FUNCTION_TABLE& out) {
+    GUID id = WSAID_MULTIPLE_RIO;
+    DWORD bytes = 0;
+    out = {};
+    out.cbSize = sizeof(out);
+    return WSAIoctl(socket, SIO_GET_MULTIPLE_EXTENSION_FUNCTION_POINTER, &id, sizeof(id), &out,
+                    sizeof(out), &bytes, nullptr, nullptr) == 0;
+}
+
+PVOID ToContext(uint32_t slot) {
+    return reinterpret_cast<PVOID>(static_cast<uintptr_t>(slot));
+}
+
+void StoreAddress(const SOCKADDR_INET& address, DatagramEndpoint& out) {
+    const size_t length =
+        address.si_family == AF_INET6 ? sizeof(sockaddr_in6) : sizeof(sockaddr_in);
+    std::memcpy(out.storage.data(), &address, length);
+    out.length = static_cast<uint32_t>(length);
+}
+
+} // namespace
+
+struct RegisteredIoQueue::Impl {
+    RIO_EXTENSION_FUNCTION_TABLE rio{};
+    uint8_t* slab = nullptr;
+    RIO_BUFFERID buffer_id = RIO_INVALID_BUFFERID;
+    HANDLE receive_event = nullptr;
+    RIO_CQ receive_queue = RIO_INVALID_CQ;
+    RIO_CQ send_queue = RIO_INVALID_CQ;
+    RIO_RQ request_queue = RIO_INVALID_RQ;
+
+    // A request queue takes no concurrent posts, so the receive and send
+    // threads take turns posting; completions need no lock
+    std::mutex post_mutex;
+
+    // Receive thread only: completions read but not handed out yet
+    std::array<RIORESULT, DatagramSocket::MAX_BATCH_SIZE> completions{};
+    size_t completion_count = 0;
+    size_t completion_offset = 0;
+
+    // Send thread only
+    std::vector<uint32_t> free_send_slots;
+
+    ~Impl() {
+        if (send_queue != RIO_INVALID_CQ) {
+            rio.RIOCloseCompletionQueue(send_queue);
+        }
+        if (receive_queue != RIO_INVALID_CQ) {
+            rio.RIOCloseCompletionQueue(receive_queue);
+        }
+        if (buffer_id != RIO_INVALID_BUFFERID) {
+            rio.RIODeregisterBuffer(buffer_id);
+        }
+        if (slab) {
+            VirtualFree(slab, 0, MEM_RELEASE);
+        }
+        if (receive_event) {
+            CloseHandle(receive_event);
+        }
+    }
+
+    uint8_t* SlotData(uint32_t slot) const {
+        return slab + slot * SLOT_SIZE + DATA_OFFSET;
+    }
+
+    SOCKADDR_INET* SlotAddress(uint32_t slot) const {
+        return reinterpret_cast<SOCKADDR_INET*>(slab + slot * SLOT_SIZE);
+    }
+
+    RIO_BUF DataBuffer(uint32_t slot, size_t length) const {
+        return RIO_BUF{buffer_id, static_cast<ULONG>(slot * SLOT_SIZE + DATA_OFFSET),
+                       static_cast<ULONG>(length)};
+    }
+
+    RIO_BUF AddressBuffer(uint32_t slot) const {
+        return RIO_BUF{buffer_id, static_cast<ULONG>(slot * SLOT_SIZE),
+                       static_cast<ULONG>(ADDRESS_SIZE)};
+    }
+
+    bool PostReceive(uint32_t slot, DWORD flags) {
+        RIO_BUF data = DataBuffer(slot, DATA_SIZE);
+        RIO_BUF address = AddressBuffer(slot);
+        return rio.RIOReceiveEx(request_queue, &data, 1, nullptr, &address, nullptr, nullptr,
+                                flags, ToContext(slot)) != FALSE;
+    }
+
+    // Completions ready to hand out, reading more once the last batch is used up
+    size_t PendingReceives() {
+        if (completion_offset == completion_count) {
+            const ULONG dequeued = rio.RIODequeueCompletion(
+                receive_queue, completions.data(), static_cast<ULONG>(completions.size()));
+            completion_offset = 0;
+            completion_count = dequeued == RIO_CORRUPT_CQ ? 0 : dequeued;
+        }
+        return completion_count - completion_offset;
+    }
+
+    // Returns the slots of finished sends; a send that failed in flight is an error
+    void ReclaimSends(uint64_t& errors) {
+        std::array<RIORESULT, DatagramSocket::MAX_BATCH_SIZE> results;
+        while (true) {
+            const ULONG dequeued = rio.RIODequeueCompletion(send_queue, results.data(),
+                                                            static_cast<ULONG>(results.size()));
+            if (dequeued == 0 || dequeued == RIO_CORRUPT_CQ) {
+                return;
+            }
+            for (ULONG i = 0; i < dequeued; ++i) {
+                if (results[i].Status != 0) {
+                    ++errors;
+                }
+                free_send_slots.push_back(static_cast<uint32_t>(results[i].RequestContext));
+            }
+        }
+    }
+};
+
+bool RegisteredIoQueue::IsSupported() {
+    static const bool supported = [] {
+        WSADATA data;
+        if (WSAStartup(MAKEWORD(2, 2), &data) != 0) {
+            return false;
+        }
+        const intptr_t handle = CreateSocket(AF_INET);
+        if (handle == DatagramSocket::INVALID_HANDLE) {
+            return false;
+        }
+        RIO_EXTENSION_FUNCTION_TABLE table;
+        const bool loaded = LoadFunctions(static_cast<SOCKET>(handle), table);
+        closesocket(static_cast<SOCKET>(handle));
+        return loaded;
+    }();
+    return supported;
+}
+
+intptr_t RegisteredIoQueue::CreateSocket(int family) {
+    const SOCKET socket =
+        WSASocketW(family, SOCK_DGRAM, IPPROTO_UDP, nullptr, 0, WSA_FLAG_REGISTERED_IO);
+    return socket == INVALID_SOCKET ? DatagramSocket::INVALID_HANDLE
+                                    : static_cast<intptr_t>(socket);
+}
+
+std::unique_ptr<RegisteredIoQueue> RegisteredIoQueue::Create(intptr_t socket) {
+    auto impl = std::make_unique<Impl>();
+    const SOCKET native = static_cast<SOCKET>(socket);
+    if (!LoadFunctions(native, impl->rio)) {
+        return nullptr;
+    }
+
+    const DWORD slab_size = static_cast<DWORD>(SLOT_COUNT * SLOT_SIZE);
+    impl->slab = static_cast<uint8_t*>(
+        VirtualAlloc(nullptr, slab_size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE));
+    if (!impl->slab) {
+        return nullptr;
+    }
+    impl->buffer_id = impl->rio.RIORegisterBuffer(reinterpret_cast<PCHAR>(impl->slab), slab_size);
+    if (impl->buffer_id == RIO_INVALID_BUFFERID) {
+        return nullptr;
+    }
+
+    impl->receive_event = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    if (!impl->receive_event) {
+        return nullptr;
+    }
+    RIO_NOTIFICATION_COMPLETION notification{};
+    notification.Type = RIO_EVENT_COMPLETION;
+    notification.Event.EventHandle = impl->receive_event;
+    notification.Event.NotifyReset = TRUE;
+    impl->receive_queue =
+        impl->rio.RIOCreateCompletionQueue(static_cast<DWORD>(RECEIVE_DEPTH), &notification);
+    // Sends are only ever polled
+    impl->send_queue = impl->rio.RIOCreateCompletionQueue(static_cast<DWORD>(SEND_DEPTH), nullptr);
+    if (impl->receive_queue == RIO_INVALID_CQ || impl->send_queue == RIO_INVALID_CQ) {
+        return nullptr;
+    }
+
+    // Last, as nothing can detach a request queue from its socket again
+    impl->request_queue = impl->rio.RIOCreateRequestQueue(
+        native, static_cast<ULONG>(RECEIVE_DEPTH), 1, static_cast<ULONG>(SEND_DEPTH), 1,
+        impl->receive_queue, impl->send_queue, nullptr);
+    if (impl->request_queue == RIO_INVALID_RQ) {
+        return nullptr;
+    }
+
+    // Within the depth the queue was created with, posting cannot fail
+    for (uint32_t slot = 0; slot < RECEIVE_DEPTH; ++slot) {
+        impl->PostReceive(slot, RIO_MSG_DEFER);
+    }
+    impl->rio.RIOReceive(impl->request_queue, nullptr, 0, RIO_MSG_COMMIT_ONLY, nullptr);
+
+    impl->free_send_slots.reserve(SEND_DEPTH);
+    for (size_t slot = SLOT_COUNT; slot > RECEIVE_DEPTH; --slot) {
+        impl->free_send_slots.push_back(static_cast<uint32_t>(slot - 1));
+    }
+    return std::unique_ptr<RegisteredIoQueue>(new RegisteredIoQueue(std::move(impl)));
+}
+
+bool RegisteredIoQueue::WaitReadable(std::chrono::milliseconds timeout) {
+    Impl& impl = *impl_;
+    if (impl.PendingReceives() != 0) {
+        return true;
+    }
+    // Fires at once if a completion slipped in since the dequeue; a
+    // notification already armed by an earlier wait is just as good
+    impl.rio.RIONotify(impl.receive_queue);
+    WaitForSingleObject(impl.receive_event, static_cast<DWORD>(timeout.count()));
+    return impl.PendingReceives() != 0;
+}
+
+size_t RegisteredIoQueue::Receive(DatagramReceiveSlot* slots, size_t count) {
+    Impl& impl = *impl_;
+    if (impl.PendingReceives() == 0) {
+        return 0;
+    }
+
+    size_t filled = 0;
+    std::lock_guard lock(impl.post_mutex);
+    while (filled < count && impl.completion_offset < impl.completion_count) {
+        const RIORESULT& result = impl.completions[impl.completion_offset++];
+        const auto slot_index = static_cast<uint32_t>(result.RequestContext);
+        // Other failures, such as a port unreachable report, carry no datagram
+        if (result.Status == 0 || result.Status == WSAEMSGSIZE) {
+            DatagramReceiveSlot& slot = slots[filled++];
+            const size_t size = std::min<size_t>(result.BytesTransferred, slot.capacity);
+            std::memcpy(slot.buffer, impl.SlotData(slot_index), size);
+            slot.size = size;
+            slot.truncated = result.Status == WSAEMSGSIZE || result.BytesTransferred > slot.capacity;
+            slot.timestamps = {};
+            StoreAddress(*impl.SlotAddress(slot_index), slot.from);
+        }
+        impl.PostReceive(slot_index, RIO_MSG_DEFER);
+    }
+    impl.rio.RIOReceive(impl.request_queue, nullptr, 0, RIO_MSG_COMMIT_ONLY, nullptr);
+    return filled;
+}
+
+size_t RegisteredIoQueue::Send(const OutgoingDatagram* datagrams, size_t count, size_t& posted,
+                               uint64_t& errors) {
+    Impl& impl = *impl_;
+    impl.ReclaimSends(errors);
+
+    posted = 0;
+    size_t taken = 0;
+    std::lock_guard lock(impl.post_mutex);
+    for (; taken < count; ++taken) {
+        const OutgoingDatagram& datagram = datagrams[taken];
+        const size_t size = datagram.size + datagram.tail_size;
+        if (size > DATA_SIZE) {
+            ++errors;
+            continue;
+        }
+        if (impl.free_send_slots.empty()) {
+            break;
+        }
+        const uint32_t slot = impl.free_send_slots.back();
+        uint8_t* data = impl.SlotData(slot);
+        std::memcpy(data, datagram.data, datagram.size);
+        if (datagram.tail_size != 0) {
+            std::memcpy(data + datagram.size, datagram.tail, datagram.tail_size);
+        }
+        RIO_BUF buffer = impl.DataBuffer(slot, size);
+        RIO_BUF address{};
+        if (datagram.to != nullptr) {
+            std::memcpy(impl.SlotAddress(slot), datagram.to->storage.data(), datagram.to->length);
+            address = impl.AddressBuffer(slot);
+        }
+        if (!impl.rio.RIOSendEx(impl.request_queue, &buffer, 1, nullptr,
+                                datagram.to != nullptr ? &address : nullptr, nullptr, nullptr,
+                                RIO_MSG_DEFER, ToContext(slot))) {
+            ++errors;
+            continue;
+        }
+        impl.free_send_slots.pop_back();
+        ++posted;
+    }
+    if (posted != 0) {
+        impl.rio.RIOSend(impl.request_queue, nullptr, 0, RIO_MSG_COMMIT_ONLY, nullptr);
+    }
+    return taken;
+}
+
+#else
+
+struct RegisteredIoQueue::Impl {};
+
+bool RegisteredIoQueue::IsSupported() {
+    return false;
+}
+
+intptr_t RegisteredIoQueue::CreateSocket(int) {
+    return DatagramSocket::INVALID_HANDLE;
+}
+
+std::unique_ptr<RegisteredIoQueue> RegisteredIoQueue::Create(intptr_t) {
+    return nullptr;
+}
+
+bool RegisteredIoQueue::WaitReadable(std::chrono::milliseconds) {
+    return false;
+}
+
+size_t RegisteredIoQueue::Receive(DatagramReceiveSlot*, size_t) {
+    return 0;
+}
+
+size_t RegisteredIoQueue::Send(const OutgoingDatagram*, size_t, size_t& posted, uint64_t&) {
+    posted = 0;
+    return 0;
+}
+
+#endif
+
+RegisteredIoQueue::RegisteredIoQueue(std::unique_ptr<Impl> impl) : impl_(std::move(impl)) {}
+
+RegisteredIoQueue::~RegisteredIoQueue() = default;
+
+} // namespace Core::Multiplayer
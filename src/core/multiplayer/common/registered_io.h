@@ -0,0 +1,84 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace Core::Multiplayer {
+
+struct DatagramReceiveSlot;
+struct OutgoingDatagram;
+
+/**
+ * Windows Registered I/O (RIO) queues for one datagram socket.
+ *
+ * Every receive and send buffer is a slot of one slab registered with the
+ * kernel once, so no buffer is locked or mapped per operation. Receives
+ * stay posted; a batch is read from a completion queue in user mode and
+ * the emptied slots are posted back with a single commit, which brings the
+ * per-datagram cost of DatagramSocket::ReceiveBatch on Windows down to
+ * what recvmmsg costs on Linux. Sends are copied into free slots and
+ * committed together in the same way.
+ *
+ * Slots are larger than PacketBuffer so a full MTU-budget payload plus a
+ * data plane's header and trailer still fits. Receives copy out of the
+ * slot into the caller's buffer; that copy is what keeps the slab pinned
+ * while PacketBuffers move on to other threads.
+ *
+ * Elsewhere IsSupported() is false and Create() returns null.
+ * Same threading as DatagramSocket: one receiving and one sending thread.
+ */
+class RegisteredIoQueue {
+public:
+    static constexpr size_t SLOT_SIZE = 2048;
+    static constexpr size_t RECEIVE_DEPTH = 256;
+    static constexpr size_t SEND_DEPTH = 256;
+
+    // Whether the RIO extension functions can be loaded (Windows 8 and later)
+    static bool IsSupported();
+
+    /**
+     * Creates an unbound UDP socket that RIO queues can be built on
+     * @return DatagramSocket::INVALID_HANDLE on failure
+     */
+    static intptr_t CreateSocket(int family);
+
+    /**
+     * Builds the queues for a bound socket from CreateSocket and posts every
+     * receive slot
+     * @return Null if RIO is unavailable or a queue cannot be created
+     */
+    static std::unique_ptr<RegisteredIoQueue> Create(intptr_t socket);
+
+    // Must be destroyed after the socket is closed
+    ~RegisteredIoQueue();
+
+    RegisteredIoQueue(const RegisteredIoQueue&) = delete;
+    RegisteredIoQueue& operator=(const RegisteredIoQueue&) = delete;
+
+    // Polls the receive completion queue, sleeping on its event when it is empty
+    bool WaitReadable(std::chrono::milliseconds timeout);
+    size_t Receive(DatagramReceiveSlot* slots, size_t count);
+    /**
+     * Also reclaims the slots of finished sends, adding ones that failed in
+     * flight to errors
+     * @param posted Filled in: datagrams handed to the kernel
+     * @return Number of datagrams taken, stopping when every send slot is in
+     *         flight; ones that cannot be posted are skipped and added to errors
+     */
+    size_t Send(const OutgoingDatagram* datagrams, size_t count, size_t& posted,
+                uint64_t& errors);
+
+private:
+    struct Impl;
+
+    explicit RegisteredIoQueue(std::unique_ptr<Impl> impl);
+
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace Core::Multiplayer
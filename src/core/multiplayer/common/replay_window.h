@@ -0,0 +1,126 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace Core::Multiplayer {
+
+/**
+ * Serial number arithmetic (RFC 1982): the 64-bit value nearest to reference
+ * whose low bits are sequence, for counters that wrap on the wire
+ */
+template <std::unsigned_integral T>
+constexpr uint64_t UnwrapSequence(T sequence, uint64_t reference) {
+    using Signed = std::make_signed_t<T>;
+    const auto delta = static_cast<Signed>(static_cast<T>(sequence - static_cast<T>(reference)));
+    return reference + static_cast<uint64_t>(static_cast<int64_t>(delta));
+}
+
+/**
+ * Sliding window over the last Bits sequence numbers of one sender, for
+ * replay protection and duplicate suppression.
+ *
+ * The bitmap is a ring of words indexed by sequence, as in RFC 6479, so
+ * moving the window forward clears the words it passes instead of shifting
+ * the whole bitmap; Check and Mark are O(1) in the window size. One spare
+ * word keeps the full Bits behind the newest sequence covered while the
+ * newest word fills. Not thread-safe; keep one per peer and session.
+ */
+template <size_t Bits>
+class ReplayWindow {
+    static_assert(Bits >= 64 && Bits % 64 == 0, "Bits must be a multiple of 64");
+
+public:
+    static constexpr uint64_t SIZE = Bits;
+
+    enum class Result : uint8_t {
+        New,       // Newer than anything seen, or inside the window and unseen
+        Duplicate, // Inside the window and already marked
+        TooOld,    // Fallen out of the window; cannot tell
+    };
+
+    Result Check(uint64_t sequence) const {
+        if (!started_ || sequence > highest_) {
+            return Result::New;
+        }
+        if (highest_ - sequence >= SIZE) {
+            return Result::TooOld;
+        }
+        return (words_[WordOf(sequence)] & BitOf(sequence)) != 0 ? Result::Duplicate
+                                                                 : Result::New;
+    }
+
+    /**
+     * Records a sequence, moving the window forward if it is the newest.
+     * Separate from Check so a caller can authenticate a packet first, and
+     * forgeries cannot move the window.
+     */
+    void Mark(uint64_t sequence) {
+        if (!started_ || sequence > highest_) {
+            Advance(sequence);
+        } else if (highest_ - sequence >= SIZE) {
+            return;
+        }
+        words_[WordOf(sequence)] |= BitOf(sequence);
+    }
+
+    Result CheckAndMark(uint64_t sequence) {
+        const Result result = Check(sequence);
+        if (result == Result::New) {
+            Mark(sequence);
+        }
+        return result;
+    }
+
+    bool IsStarted() const {
+        return started_;
+    }
+
+    // Newest sequence marked; zero before the first
+    uint64_t GetHighest() const {
+        return highest_;
+    }
+
+    void Reset() {
+        words_.fill(0);
+        highest_ = 0;
+        started_ = false;
+    }
+
+private:
+    static constexpr size_t WORD_COUNT = Bits / 64 + 1;
+
+    static constexpr size_t WordOf(uint64_t sequence) {
+        return static_cast<size_t>((sequence >> 6) % WORD_COUNT);
+    }
+
+    static constexpr uint64_t BitOf(uint64_t sequence) {
+        return uint64_t{1} << (sequence & 63);
+    }
+
+    void Advance(uint64_t sequence) {
+        const uint64_t from = highest_ >> 6;
+        const uint64_t to = sequence >> 6;
+        if (!started_ || to - from >= WORD_COUNT) {
+            words_.fill(0);
+        } else {
+            for (uint64_t word = from + 1; word <= to; ++word) {
+                words_[static_cast<size_t>(word % WORD_COUNT)] = 0;
+            }
+        }
+        highest_ = sequence;
+        started_ = true;
+    }
+
+    std::array<uint64_t, WORD_COUNT> words_{};
+    uint64_t highest_ = 0;
+    bool started_ = false;
+};
+
+} // namespace Core::Multiplayer
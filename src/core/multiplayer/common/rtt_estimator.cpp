@@ -0,0 +1,88 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "rtt_estimator.h"
+
+#include <algorithm>
+
+namespace Core::Multiplayer {
+
+void RttEstimator::AddSample(std::chrono::microseconds rtt) {
+    if (rtt.count() < 0) {
+        return;
+    }
+    const uint64_t sample = std::min<uint64_t>(static_cast<uint64_t>(rtt.count()), MAX_SAMPLE_US);
+
+    uint64_t state = state_.load(std::memory_order_relaxed);
+    uint64_t updated;
+    do {
+        if ((state & VALID_BIT) == 0) {
+            updated = Pack(sample, sample / 2);
+            continue;
+        }
+        const uint64_t srtt = SmoothedOf(state);
+        const uint64_t rttvar = VariationOf(state);
+        const uint64_t deviation = srtt > sample ? srtt - sample : sample - srtt;
+        // Rounded to nearest so small samples do not decay to zero
+        updated = Pack((7 * srtt + sample + 4) / 8, (3 * rttvar + deviation + 2) / 4);
+    } while (!state_.compare_exchange_weak(state, updated, std::memory_order_acq_rel,
+                                           std::memory_order_relaxed));
+
+    latest_us_.store(sample, std::memory_order_relaxed);
+    uint64_t min = min_us_.load(std::memory_order_relaxed);
+    while (sample < min &&
+           !min_us_.compare_exchange_weak(min, sample, std::memory_order_relaxed)) {
+    }
+    sample_count_.fetch_add(1, std::memory_order_release);
+}
+
+std::chrono::microseconds RttEstimator::GetSmoothedRtt() const {
+    return std::chrono::microseconds(SmoothedOf(state_.load(std::memory_order_acquire)));
+}
+
+std::chrono::microseconds RttEstimator::GetRttVariation() const {
+    return std::chrono::microseconds(VariationOf(state_.load(std::memory_order_acquire)));
+}
+
+std::chrono::microseconds RttEstimator::GetLatestRtt() const {
+    return std::chrono::microseconds(latest_us_.load(std::memory_order_relaxed));
+}
+
+std::chrono::microseconds RttEstimator::GetMinRtt() const {
+    const uint64_t min = min_us_.load(std::memory_order_relaxed);
+    return std::chrono::microseconds(min == UINT64_MAX ? 0 : min);
+}
+
+std::chrono::microseconds RttEstimator::GetRetransmissionTimeout() const {
+    return TimeoutOf(state_.load(std::memory_order_acquire));
+}
+
+RttSnapshot RttEstimator::GetSnapshot() const {
+    const uint64_t state = state_.load(std::memory_order_acquire);
+    RttSnapshot snapshot;
+    snapshot.smoothed_rtt = std::chrono::microseconds(SmoothedOf(state));
+    snapshot.rtt_variation = std::chrono::microseconds(VariationOf(state));
+    snapshot.latest_rtt = GetLatestRtt();
+    snapshot.min_rtt = GetMinRtt();
+    snapshot.retransmission_timeout = TimeoutOf(state);
+    snapshot.sample_count = GetSampleCount();
+    return snapshot;
+}
+
+void RttEstimator::Reset() {
+    state_.store(0, std::memory_order_release);
+    latest_us_.store(0, std::memory_order_relaxed);
+    min_us_.store(UINT64_MAX, std::memory_order_relaxed);
+    sample_count_.store(0, std::memory_order_release);
+}
+
+std::chrono::microseconds RttEstimator::TimeoutOf(uint64_t state) {
+    if ((state & VALID_BIT) == 0) {
+        return INITIAL_RTO;
+    }
+    const auto srtt = std::chrono::microseconds(SmoothedOf(state));
+    const auto rttvar = std::chrono::microseconds(VariationOf(state));
+    return std::clamp(srtt + std::max(CLOCK_GRANULARITY, 4 * rttvar), MIN_RTO, MAX_RTO);
+}
+
+} // namespace Core::Multiplayer
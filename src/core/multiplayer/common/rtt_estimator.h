@@ -0,0 +1,83 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace Core::Multiplayer {
+
+/**
+ * Consistent view of an RttEstimator
+ */
+struct RttSnapshot {
+    std::chrono::microseconds smoothed_rtt{0};
+    std::chrono::microseconds rtt_variation{0};
+    std::chrono::microseconds latest_rtt{0};
+    std::chrono::microseconds min_rtt{0};
+    std::chrono::microseconds retransmission_timeout{0};
+    uint64_t sample_count = 0;
+};
+
+/**
+ * Round-trip time estimator in the style of RFC 6298.
+ *
+ * The first sample R sets SRTT = R and RTTVAR = R/2; later samples update
+ * RTTVAR = 3/4 RTTVAR + 1/4 |SRTT - R| and then SRTT = 7/8 SRTT + 1/8 R.
+ * RTTVAR doubles as the jitter signal. The timeout is SRTT + max(G, 4 RTTVAR)
+ * with a 1ms clock granularity, clamped to [MIN_RTO, MAX_RTO]; the floor is
+ * far below RFC 6298's one second because game traffic cannot wait that long.
+ *
+ * SRTT and RTTVAR are packed into one atomic word and updated with a CAS, so
+ * samples may be added from any thread and every read is lock-free and never
+ * sees one value updated without the other.
+ */
+class RttEstimator {
+public:
+    static constexpr std::chrono::microseconds CLOCK_GRANULARITY{1000};
+    static constexpr std::chrono::microseconds MIN_RTO{200'000};
+    static constexpr std::chrono::microseconds MAX_RTO{60'000'000};
+    // Timeout before the first sample (RFC 6298 section 2.1)
+    static constexpr std::chrono::microseconds INITIAL_RTO{1'000'000};
+
+    RttEstimator() = default;
+
+    RttEstimator(const RttEstimator&) = delete;
+    RttEstimator& operator=(const RttEstimator&) = delete;
+
+    // Negative samples (clock steps, corrupt echoes) are ignored
+    void AddSample(std::chrono::microseconds rtt);
+
+    bool HasSamples() const { return GetSampleCount() != 0; }
+    uint64_t GetSampleCount() const { return sample_count_.load(std::memory_order_acquire); }
+
+    std::chrono::microseconds GetSmoothedRtt() const;
+    std::chrono::microseconds GetRttVariation() const;
+    std::chrono::microseconds GetLatestRtt() const;
+    std::chrono::microseconds GetMinRtt() const;
+    std::chrono::microseconds GetRetransmissionTimeout() const;
+    RttSnapshot GetSnapshot() const;
+
+    void Reset();
+
+private:
+    static constexpr uint64_t VALID_BIT = uint64_t{1} << 63;
+    static constexpr uint64_t MAX_SAMPLE_US = (uint64_t{1} << 31) - 1;
+
+    static uint64_t Pack(uint64_t srtt_us, uint64_t rttvar_us) {
+        return VALID_BIT | (srtt_us << 31) | rttvar_us;
+    }
+    static uint64_t SmoothedOf(uint64_t state) { return (state & ~VALID_BIT) >> 31; }
+    static uint64_t VariationOf(uint64_t state) { return state & MAX_SAMPLE_US; }
+    static std::chrono::microseconds TimeoutOf(uint64_t state);
+
+    // Valid bit, then 32 bits of SRTT and 31 bits of RTTVAR in microseconds
+    std::atomic<uint64_t> state_{0};
+    std::atomic<uint64_t> latest_us_{0};
+    std::atomic<uint64_t> min_us_{UINT64_MAX};
+    std::atomic<uint64_t> sample_count_{0};
+};
+
+} // namespace Core::Multiplayer
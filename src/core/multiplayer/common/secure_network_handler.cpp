@@ -2,21 +2,35 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "secure_network_handler.h"
-#include <spdlog/spdlog.h>
+#include "multiplayer_log.h"
+#include <nlohmann/json.hpp>
 
 namespace Core::Multiplayer {
 
-SecureNetworkHandler::SecureNetworkHandler() {
-    auto rate_config = CreateDefaultRateConfig();
-    auto ddos_config = CreateDefaultDDoSConfig();
-    security_manager_ = std::make_unique<Security::NetworkSecurityManager>(rate_config, ddos_config);
-}
+SecureNetworkHandler::SecureNetworkHandler()
+    : SecureNetworkHandler(CreateDefaultRateConfig(), CreateDefaultDDoSConfig()) {}
 
 SecureNetworkHandler::SecureNetworkHandler(
     const Security::RateLimitConfig& rate_config,
-    const Security::DDoSProtectionConfig& ddos_config) {
-    
-    security_manager_ = std::make_unique<Security::NetworkSecurityManager>(rate_config, ddos_config);
+    const Security::DDoSProtectionConfig& ddos_config)
+    : rate_config_(rate_config), ddos_config_(ddos_config) {}
+
+SecureNetworkHandler::~SecureNetworkHandler() {
+    // The pipeline's threads use the security manager and handlers
+    StopPacketPipeline();
+}
+
+Security::NetworkSecurityManager& SecureNetworkHandler::SecurityManager() {
+    std::call_once(security_manager_once_, [this] {
+        security_manager_ =
+            std::make_unique<Security::NetworkSecurityManager>(rate_config_, ddos_config_);
+        built_security_manager_.store(security_manager_.get(), std::memory_order_release);
+    });
+    return *security_manager_;
+}
+
+bool SecureNetworkHandler::IsSecurityManagerBuilt() const {
+    return built_security_manager_.load(std::memory_order_acquire) != nullptr;
 }
 
 bool SecureNetworkHandler::HandleIncomingPacket(
@@ -25,8 +39,8 @@ bool SecureNetworkHandler::HandleIncomingPacket(
     const std::vector<uint8_t>& data,
     const std::string& protocol) {
     
-    // Validate packet through security manager
-    auto validation_result = security_manager_->ValidateIncomingPacket(client_id, client_ip, data, protocol);
+    // Validate packet through security manager, as far as the build policy asks
+    auto validation_result = CheckIncomingPacket(client_id, data, protocol);
     
     if (!validation_result.is_valid) {
         LogSecurityViolation(client_id, client_ip, validation_result.error_message);
@@ -41,23 +55,80 @@ bool SecureNetworkHandler::HandleIncomingPacket(
     return true;
 }
 
+Security::ValidationResult SecureNetworkHandler::CheckIncomingPacket(
+    const std::string& client_id,
+    const std::vector<uint8_t>& data,
+    const std::string& protocol) {
+    
+    using Policy = ActiveBuildPolicy;
+    auto result = Security::ValidationResult::Success();
+    if constexpr (Policy::Validation::level == ValidationLevel::Full) {
+        result = SecurityManager().CheckGlobalPacketRate();
+    }
+    if (result.is_valid) {
+        result = Security::NetworkSecurityManager::CheckPacketInput(data, protocol);
+    }
+    if constexpr (Policy::Validation::level == ValidationLevel::Full) {
+        if (result.is_valid) {
+            result = SecurityManager().CheckPacketRate(client_id, data.size());
+        }
+    }
+    if constexpr (Policy::Instrumentation::enabled) {
+        SecurityManager().RecordPacketResult(result.is_valid);
+    }
+    return result;
+}
+
+void SecureNetworkHandler::StartPacketPipeline(const SecurePacketPipelineConfig& config) {
+    StopPacketPipeline();
+    packet_pipeline_ = std::make_unique<SecurePacketPipeline>(
+        SecurityManager(), packet_handler_,
+        [this](const InboundPacket& packet, const Security::ValidationResult& result) {
+            LogSecurityViolation(packet.client_id, packet.client_ip, result.error_message);
+        },
+        config);
+    packet_pipeline_->Start();
+}
+
+void SecureNetworkHandler::StopPacketPipeline() {
+    if (packet_pipeline_) {
+        packet_pipeline_->Stop();
+    }
+}
+
+bool SecureNetworkHandler::SubmitIncomingPackets(InboundPacketBatch&& batch) {
+    return packet_pipeline_ && packet_pipeline_->Submit(std::move(batch));
+}
+
+SecurePacketPipelineStatistics SecureNetworkHandler::GetPipelineStatistics() const {
+    return packet_pipeline_ ? packet_pipeline_->GetStatistics() : SecurePacketPipelineStatistics{};
+}
+
 bool SecureNetworkHandler::HandleIncomingJsonMessage(
     const std::string& client_id,
     const std::string& client_ip,
     const std::string& json_message) {
     
-    // Validate JSON message through security manager
-    auto validation_result = security_manager_->ValidateIncomingJsonMessage(client_id, client_ip, json_message);
+    // Validate JSON message through security manager, parsing it at the
+    // same time when a handler wants the document
+    nlohmann::json document;
+    auto& security_manager = SecurityManager();
+    auto validation_result = parsed_json_handler_
+        ? security_manager.ValidateIncomingJsonMessage(client_id, client_ip, json_message, document)
+        : security_manager.ValidateIncomingJsonMessage(client_id, client_ip, json_message);
     
     if (!validation_result.is_valid) {
         LogSecurityViolation(client_id, client_ip, validation_result.error_message);
         return false;
     }
     
-    // Forward to JSON handler if valid
+    // Forward to JSON handlers if valid
     if (json_handler_) {
         json_handler_(client_id, json_message);
     }
+    if (parsed_json_handler_) {
+        parsed_json_handler_(client_id, document);
+    }
     
     return true;
 }
@@ -68,7 +139,7 @@ bool SecureNetworkHandler::HandleNewConnection(
     const std::string& connection_id) {
     
     // Validate connection through security manager
-    auto validation_result = security_manager_->ValidateNewConnection(client_ip, connection_id);
+    auto validation_result = SecurityManager().ValidateNewConnection(client_ip, connection_id);
     
     if (!validation_result.is_valid) {
         LogSecurityViolation(client_id, client_ip, validation_result.error_message);
@@ -80,7 +151,7 @@ bool SecureNetworkHandler::HandleNewConnection(
         connection_handler_(client_id, client_ip);
     }
     
-    spdlog::info("Accepted connection from client {} (IP: {})", client_id, client_ip);
+    MULTIPLAYER_LOG_INFO("Accepted connection from client {} (IP: {})", client_id, client_ip);
     return true;
 }
 
@@ -89,10 +160,12 @@ void SecureNetworkHandler::HandleClientDisconnection(
     const std::string& client_ip,
     const std::string& connection_id) {
     
-    // Cleanup security state
-    security_manager_->RemoveClient(client_id, client_ip, connection_id);
+    // Cleanup security state; there is none if nothing built the manager
+    if (IsSecurityManagerBuilt()) {
+        security_manager_->RemoveClient(client_id, client_ip, connection_id);
+    }
     
-    spdlog::info("Client {} disconnected (IP: {})", client_id, client_ip);
+    MULTIPLAYER_LOG_INFO("Client {} disconnected (IP: {})", client_id, client_ip);
 }
 
 void SecureNetworkHandler::SetPacketHandler(PacketHandler handler) {
@@ -103,12 +176,22 @@ void SecureNetworkHandler::SetJsonMessageHandler(JsonMessageHandler handler) {
     json_handler_ = handler;
 }
 
+void SecureNetworkHandler::SetParsedJsonMessageHandler(ParsedJsonMessageHandler handler) {
+    parsed_json_handler_ = handler;
+}
+
 void SecureNetworkHandler::SetConnectionHandler(ConnectionHandler handler) {
     connection_handler_ = handler;
 }
 
 std::string SecureNetworkHandler::GetSecurityStats() const {
-    return security_manager_->GetSecurityStats();
+    return Security::FormatSecurityStatistics(GetSecurityStatistics());
+}
+
+Security::SecurityStatistics SecureNetworkHandler::GetSecurityStatistics() const {
+    const auto* security_manager = built_security_manager_.load(std::memory_order_acquire);
+    return security_manager ? security_manager->GetSecurityStatistics()
+                            : Security::SecurityStatistics{};
 }
 
 Security::RateLimitConfig SecureNetworkHandler::CreateDefaultRateConfig() {
@@ -135,7 +218,9 @@ void SecureNetworkHandler::LogSecurityViolation(
     const std::string& client_ip, 
     const std::string& reason) {
     
-    spdlog::warn("Security violation from client {} (IP: {}): {}", client_id, client_ip, reason);
+    // A flood of bad packets must not turn into a flood of log lines
+    MULTIPLAYER_LOG_RATE_LIMITED(Warn, 10, "Security violation from client {} (IP: {}): {}",
+                                 client_id, client_ip, reason);
 }
 
 } // namespace Core::Multiplayer
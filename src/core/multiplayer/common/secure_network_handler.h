@@ -3,9 +3,13 @@
 
 #pragma once
 
+#include "build_policy.h"
 #include "network_security.h"
+#include "secure_packet_pipeline.h"
+#include <atomic>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -14,11 +18,16 @@ namespace Core::Multiplayer {
 /**
  * Secure network handler that integrates security validation with network operations
  * This class demonstrates how to use the network security framework in multiplayer components
+ *
+ * The security manager, with its rate limiters and DDoS protection, is built
+ * on the first inbound connection, message or checked packet, so a pure
+ * client that never accepts peers does not pay for the server-side state.
  */
 class SecureNetworkHandler {
 public:
     using PacketHandler = std::function<void(const std::string& client_id, const std::vector<uint8_t>& data)>;
     using JsonMessageHandler = std::function<void(const std::string& client_id, const std::string& message)>;
+    using ParsedJsonMessageHandler = std::function<void(const std::string& client_id, const nlohmann::json& message)>;
     using ConnectionHandler = std::function<void(const std::string& client_id, const std::string& client_ip)>;
     
     /**
@@ -36,8 +45,12 @@ public:
         const Security::DDoSProtectionConfig& ddos_config
     );
     
+    ~SecureNetworkHandler();
+    
     /**
-     * Handle an incoming packet with security validation
+     * Handle an incoming packet with security validation. Rate limits are
+     * checked, and the outcome counted, only when the build policy's
+     * validation level and instrumentation include them.
      * @param client_id The client identifier
      * @param client_ip The client IP address
      * @param data The packet data
@@ -51,6 +64,32 @@ public:
         const std::string& protocol
     );
     
+    /**
+     * Run packet checks and dispatch on a staged pipeline instead of on the
+     * receiving thread. The packet handler set at this point is used for
+     * pipelined packets, and is called on the pipeline's dispatch thread.
+     * @param config Queue sizes, stage pinning and idle behaviour
+     */
+    void StartPacketPipeline(const SecurePacketPipelineConfig& config = {});
+    
+    /**
+     * Finish the packets already submitted and stop the pipeline
+     */
+    void StopPacketPipeline();
+    
+    /**
+     * Queue a batch of received packets on the pipeline
+     * Must always be called from the same thread.
+     * @param batch The packets; left untouched if refused
+     * @return False if the pipeline is not running or is full
+     */
+    bool SubmitIncomingPackets(InboundPacketBatch&& batch);
+    
+    /**
+     * Get pipeline statistics; all zero if the pipeline was never started
+     */
+    SecurePacketPipelineStatistics GetPipelineStatistics() const;
+    
     /**
      * Handle an incoming JSON message with security validation
      * @param client_id The client identifier
@@ -101,6 +140,14 @@ public:
      */
     void SetJsonMessageHandler(JsonMessageHandler handler);
     
+    /**
+     * Set parsed JSON message handler callback
+     * The message is parsed while it is validated, so the handler does not
+     * need to parse it again
+     * @param handler Function to call with each valid JSON message's document
+     */
+    void SetParsedJsonMessageHandler(ParsedJsonMessageHandler handler);
+    
     /**
      * Set connection handler callback
      * @param handler Function to call for accepted connections
@@ -112,6 +159,17 @@ public:
      * @return Security statistics string
      */
     std::string GetSecurityStats() const;
+
+    /**
+     * Get security counters without blocking packet processing
+     * @return Security statistics; all zero before the first inbound traffic
+     */
+    Security::SecurityStatistics GetSecurityStatistics() const;
+
+    /**
+     * Whether inbound traffic has built the security manager yet
+     */
+    bool IsSecurityManagerBuilt() const;
     
     /**
      * Create default rate limiting configuration
@@ -126,11 +184,23 @@ public:
     static Security::DDoSProtectionConfig CreateDefaultDDoSConfig();
 
 private:
+    const Security::RateLimitConfig rate_config_;
+    const Security::DDoSProtectionConfig ddos_config_;
+    std::once_flag security_manager_once_;
     std::unique_ptr<Security::NetworkSecurityManager> security_manager_;
+    // Set once security_manager_ is built, for the const getters
+    std::atomic<const Security::NetworkSecurityManager*> built_security_manager_{nullptr};
     PacketHandler packet_handler_;
     JsonMessageHandler json_handler_;
+    ParsedJsonMessageHandler parsed_json_handler_;
     ConnectionHandler connection_handler_;
+    std::unique_ptr<SecurePacketPipeline> packet_pipeline_;
     
+    // Builds the security manager on first use
+    Security::NetworkSecurityManager& SecurityManager();
+    Security::ValidationResult CheckIncomingPacket(const std::string& client_id,
+                                                   const std::vector<uint8_t>& data,
+                                                   const std::string& protocol);
     void LogSecurityViolation(const std::string& client_id, const std::string& client_ip, const std::string& reason);
 };
 
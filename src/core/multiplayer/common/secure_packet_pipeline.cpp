@@ -0,0 +1,226 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "secure_packet_pipeline.h"
+#include "ip_address_key.h"
+#include "thread_policy.h"
+#include <optional>
+#include <utility>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace Core::Multiplayer {
+
+namespace {
+void PinCurrentThread(int cpu) {
+#ifdef __linux__
+    const unsigned cores = std::thread::hardware_concurrency();
+    if (cpu < 0 || cores == 0) {
+        return;
+    }
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(static_cast<unsigned>(cpu) % cores, &cpus);
+    // Best effort; an unpinned stage still works
+    pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+#else
+    (void)cpu;
+#endif
+}
+} // namespace
+
+SecurePacketPipeline::SecurePacketPipeline(Security::NetworkSecurityManager& security_manager,
+                                           PacketHandler packet_handler,
+                                           RejectHandler reject_handler,
+                                           const SecurePacketPipelineConfig& config)
+    : security_manager_(security_manager), packet_handler_(std::move(packet_handler)),
+      reject_handler_(std::move(reject_handler)), config_(config) {
+    for (auto& stage : stages_) {
+        stage = std::make_unique<Stage>(config_.queue_capacity);
+    }
+}
+
+SecurePacketPipeline::~SecurePacketPipeline() {
+    Stop();
+}
+
+void SecurePacketPipeline::Start() {
+    if (running_.exchange(true, std::memory_order_acq_rel)) {
+        return;
+    }
+    for (size_t i = 0; i < PIPELINE_STAGE_COUNT; ++i) {
+        stages_[i]->input_closed.store(false, std::memory_order_release);
+        stages_[i]->thread = SpawnThread(ThreadRole::Worker, "mp-pipeline-" + std::to_string(i),
+                                          [this, i] { RunStage(i); });
+    }
+}
+
+void SecurePacketPipeline::Stop() {
+    if (!running_.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+    // Close the stages front to back, so each drains what the one before
+    // it passed on before exiting
+    for (auto& stage : stages_) {
+        stage->input_closed.store(true, std::memory_order_release);
+        stage->thread.join();
+    }
+}
+
+bool SecurePacketPipeline::Submit(InboundPacketBatch&& batch) {
+    if (!IsRunning()) {
+        return false;
+    }
+    if (!stages_[0]->input.TryPush(std::move(batch))) {
+        batches_refused_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+SecurePacketPipelineStatistics SecurePacketPipeline::GetStatistics() const {
+    SecurePacketPipelineStatistics statistics;
+    for (size_t i = 0; i < PIPELINE_STAGE_COUNT; ++i) {
+        const Stage& stage = *stages_[i];
+        auto& out = statistics.stages[i];
+        out.batches = stage.counters.batches.load(std::memory_order_relaxed);
+        out.packets = stage.counters.packets.load(std::memory_order_relaxed);
+        out.packets_rejected = stage.counters.packets_rejected.load(std::memory_order_relaxed);
+        out.input_queue = stage.input.GetStatistics();
+    }
+    statistics.batches_refused = batches_refused_.load(std::memory_order_relaxed);
+    return statistics;
+}
+
+void SecurePacketPipeline::RunStage(size_t index) {
+    PinCurrentThread(config_.stage_cpus[index]);
+    Stage& stage = *stages_[index];
+    InboundPacketBatch batch;
+    while (true) {
+        if (stage.input.TryPop(batch)) {
+            ProcessBatch(index, batch);
+            continue;
+        }
+        if (stage.input_closed.load(std::memory_order_acquire)) {
+            // The close is published after the last push, so one more pop
+            // catches a batch that raced with it
+            if (!stage.input.TryPop(batch)) {
+                break;
+            }
+            ProcessBatch(index, batch);
+            continue;
+        }
+        std::this_thread::sleep_for(config_.idle_sleep);
+    }
+}
+
+template <typename Check>
+void SecurePacketPipeline::FilterBatch(size_t index, InboundPacketBatch& batch, Check&& check) {
+    size_t kept = 0;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        const Security::ValidationResult result = check(batch[i]);
+        if (!result.is_valid) {
+            security_manager_.RecordPacketResult(false);
+            if (reject_handler_) {
+                reject_handler_(batch[i], result);
+            }
+            continue;
+        }
+        if (kept != i) {
+            batch[kept] = std::move(batch[i]);
+        }
+        ++kept;
+    }
+    const size_t rejected = batch.size() - kept;
+    if (rejected != 0) {
+        stages_[index]->counters.packets_rejected.fetch_add(rejected, std::memory_order_relaxed);
+        batch.resize(kept);
+    }
+}
+
+void SecurePacketPipeline::ProcessBatch(size_t index, InboundPacketBatch& batch) {
+    StageCounters& counters = stages_[index]->counters;
+    counters.batches.fetch_add(1, std::memory_order_relaxed);
+    counters.packets.fetch_add(batch.size(), std::memory_order_relaxed);
+
+    switch (static_cast<PipelineStage>(index)) {
+    case PipelineStage::Admission: {
+        // Packets from one sender tend to arrive together; the blacklist is
+        // looked up once per run of packets from the same address
+        std::optional<std::string> run_ip;
+        Security::ValidationResult source_result = Security::ValidationResult::Success();
+        FilterBatch(index, batch, [&](const InboundPacket& packet) {
+            if (!run_ip || packet.client_ip != *run_ip) {
+                run_ip = packet.client_ip;
+                const auto address = IpAddressKey::Parse(packet.client_ip);
+                source_result = address ? security_manager_.CheckPacketSource(*address)
+                                        : Security::ValidationResult::Success();
+            }
+            if (!source_result.is_valid) {
+                return source_result;
+            }
+            return security_manager_.CheckGlobalPacketRate();
+        });
+        break;
+    }
+    case PipelineStage::RateLimit:
+        FilterBatch(index, batch, [this](const InboundPacket& packet) {
+            return security_manager_.CheckPacketRate(packet.client_id, packet.data.size());
+        });
+        break;
+    case PipelineStage::Validation: {
+        // Likewise a batch usually carries one protocol, so its name is
+        // validated once per run rather than per packet
+        std::optional<std::string> run_protocol;
+        Security::ValidationResult protocol_result = Security::ValidationResult::Success();
+        FilterBatch(index, batch, [&](const InboundPacket& packet) {
+            if (!run_protocol || packet.protocol != *run_protocol) {
+                run_protocol = packet.protocol;
+                protocol_result =
+                    Security::NetworkInputValidator::ValidateProtocolName(packet.protocol);
+            }
+            auto packet_result = Security::NetworkInputValidator::ValidatePacket(packet.data);
+            if (!packet_result.is_valid) {
+                return packet_result;
+            }
+            if (!protocol_result.is_valid) {
+                return protocol_result;
+            }
+            return Security::NetworkInputValidator::ValidatePacketContent(packet.data,
+                                                                          packet.protocol);
+        });
+        break;
+    }
+    case PipelineStage::Dispatch:
+        for (const auto& packet : batch) {
+            security_manager_.RecordPacketResult(true);
+            if (packet_handler_) {
+                packet_handler_(packet.client_id, packet.data);
+            }
+        }
+        batch.clear();
+        return;
+    case PipelineStage::Count:
+        return;
+    }
+
+    if (!batch.empty()) {
+        Forward(index, std::move(batch));
+    }
+    batch.clear();
+}
+
+void SecurePacketPipeline::Forward(size_t index, InboundPacketBatch&& batch) {
+    auto& next = stages_[index + 1]->input;
+    // Wait for room instead of dropping: the next stage always keeps
+    // draining, even while stopping
+    while (next.Size() >= next.Capacity()) {
+        std::this_thread::sleep_for(config_.idle_sleep);
+    }
+    next.TryPush(std::move(batch));
+}
+
+} // namespace Core::Multiplayer
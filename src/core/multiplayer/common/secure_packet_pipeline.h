@@ -0,0 +1,168 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "network_security.h"
+#include "spsc_ring.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Core::Multiplayer {
+
+/**
+ * A packet waiting for security checks
+ */
+struct InboundPacket {
+    std::string client_id;
+    std::string client_ip;
+    std::vector<uint8_t> data;
+    std::string protocol;
+};
+
+using InboundPacketBatch = std::vector<InboundPacket>;
+
+/**
+ * Pipeline stages, in the order packets pass through them
+ */
+enum class PipelineStage : size_t {
+    Admission,  // Global packet rate and blacklist
+    RateLimit,  // Per-client packet and byte rates
+    Validation, // Size, header, protocol and content
+    Dispatch,   // Hand accepted packets to the packet handler
+    Count,
+};
+
+constexpr size_t PIPELINE_STAGE_COUNT = static_cast<size_t>(PipelineStage::Count);
+
+/**
+ * Secure packet pipeline configuration
+ */
+struct SecurePacketPipelineConfig {
+    // Batches each stage's input queue holds
+    size_t queue_capacity = 256;
+    // CPU to pin each stage's thread to, or -1 to leave it unpinned
+    std::array<int, PIPELINE_STAGE_COUNT> stage_cpus{-1, -1, -1, -1};
+    // How long an idle stage sleeps between polls of its queue
+    std::chrono::microseconds idle_sleep{50};
+};
+
+/**
+ * Per-stage counters
+ */
+struct PipelineStageStatistics {
+    uint64_t batches = 0;
+    uint64_t packets = 0;
+    uint64_t packets_rejected = 0;
+    SpscRingStatistics input_queue;
+};
+
+/**
+ * Secure packet pipeline statistics
+ */
+struct SecurePacketPipelineStatistics {
+    std::array<PipelineStageStatistics, PIPELINE_STAGE_COUNT> stages;
+    // Batches refused by Submit because the first queue was full
+    uint64_t batches_refused = 0;
+};
+
+/**
+ * Runs the NetworkSecurityManager packet checks as a pipeline of stages,
+ * each on its own thread and each working on whole batches.
+ *
+ * Stages are connected by SPSC rings of batches. Each stage drops the
+ * packets it rejects, compacting the batch in place, and passes the rest
+ * on, so a batch's cheap checks all run before any of its expensive ones
+ * and each check's code and tables stay warm for the whole batch. A full
+ * downstream queue holds its stage back rather than dropping packets; only
+ * Submit refuses work, so overload shows up at the receiving thread.
+ *
+ * Submit must always be called from the same thread, and not while Stop
+ * runs. The packet handler runs on the dispatch stage's thread and the
+ * reject handler on the thread of the stage that rejected the packet.
+ */
+class SecurePacketPipeline {
+public:
+    using PacketHandler = std::function<void(const std::string& client_id, const std::vector<uint8_t>& data)>;
+    using RejectHandler = std::function<void(const InboundPacket& packet, const Security::ValidationResult& result)>;
+
+    /**
+     * @param security_manager Checks to run; must outlive the pipeline
+     * @param packet_handler Called for each accepted packet, in order
+     * @param reject_handler Called for each rejected packet; may be null
+     * @param config Queue sizes, pinning and idle behaviour
+     */
+    SecurePacketPipeline(Security::NetworkSecurityManager& security_manager,
+                         PacketHandler packet_handler, RejectHandler reject_handler = nullptr,
+                         const SecurePacketPipelineConfig& config = {});
+    ~SecurePacketPipeline();
+
+    SecurePacketPipeline(const SecurePacketPipeline&) = delete;
+    SecurePacketPipeline& operator=(const SecurePacketPipeline&) = delete;
+
+    /**
+     * Start the stage threads
+     */
+    void Start();
+
+    /**
+     * Finish every batch already submitted, then stop the stage threads
+     */
+    void Stop();
+
+    /**
+     * Queue a batch of received packets
+     * @param batch The packets; left untouched if refused
+     * @return False if the pipeline is not running or its first queue is full
+     */
+    bool Submit(InboundPacketBatch&& batch);
+
+    bool IsRunning() const {
+        return running_.load(std::memory_order_acquire);
+    }
+
+    SecurePacketPipelineStatistics GetStatistics() const;
+
+private:
+    struct alignas(64) StageCounters {
+        std::atomic<uint64_t> batches{0};
+        std::atomic<uint64_t> packets{0};
+        std::atomic<uint64_t> packets_rejected{0};
+    };
+
+    struct Stage {
+        explicit Stage(size_t capacity) : input(capacity) {}
+
+        SpscRing<InboundPacketBatch> input;
+        // Set once nothing more will be pushed to input
+        std::atomic<bool> input_closed{false};
+        StageCounters counters;
+        std::thread thread;
+    };
+
+    void RunStage(size_t index);
+    void ProcessBatch(size_t index, InboundPacketBatch& batch);
+    void Forward(size_t index, InboundPacketBatch&& batch);
+
+    template <typename Check>
+    void FilterBatch(size_t index, InboundPacketBatch& batch, Check&& check);
+
+    Security::NetworkSecurityManager& security_manager_;
+    PacketHandler packet_handler_;
+    RejectHandler reject_handler_;
+    SecurePacketPipelineConfig config_;
+
+    std::array<std::unique_ptr<Stage>, PIPELINE_STAGE_COUNT> stages_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> batches_refused_{0};
+};
+
+} // namespace Core::Multiplayer
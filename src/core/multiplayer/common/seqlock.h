@@ -0,0 +1,73 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace Core::Multiplayer {
+
+/**
+ * A value published by one writer and copied out by any number of readers.
+ *
+ * Store() bumps the sequence to odd, writes the value and bumps it back to
+ * even; Load() copies the value and retries while the sequence was odd or
+ * moved, so readers never block the writer and a writer never waits for
+ * readers. The value is kept as relaxed atomic words, which makes a torn
+ * copy that is about to be retried a benign race rather than undefined
+ * behavior.
+ *
+ * Only one thread may Store() at a time.
+ */
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock copies values bytewise");
+
+public:
+    SeqLock() {
+        Store(T{});
+    }
+
+    void Store(const T& value) {
+        std::array<uint64_t, WORDS> words{};
+        std::memcpy(words.data(), &value, sizeof(T));
+
+        const uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; ++i) {
+            words_[i].store(words[i], std::memory_order_relaxed);
+        }
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    T Load() const {
+        std::array<uint64_t, WORDS> words{};
+        uint64_t before = 0;
+        uint64_t after = 0;
+        do {
+            before = sequence_.load(std::memory_order_acquire);
+            for (size_t i = 0; i < WORDS; ++i) {
+                words[i] = words_[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence_.load(std::memory_order_relaxed);
+        } while ((before & 1) != 0 || before != after);
+
+        T value;
+        std::memcpy(static_cast<void*>(&value), words.data(), sizeof(T));
+        return value;
+    }
+
+private:
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint64_t> sequence_{0};
+    std::array<std::atomic<uint64_t>, WORDS> words_{};
+};
+
+} // namespace Core::Multiplayer
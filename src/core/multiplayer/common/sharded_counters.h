@@ -0,0 +1,55 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Core::Multiplayer {
+
+/**
+ * A fixed set of monotonic counters striped across cache lines.
+ *
+ * Each thread adds to its own stripe, picked once per thread, so threads
+ * counting at the same time rarely touch the same cache line. Reading sums
+ * the stripes with relaxed loads and never blocks or slows the writers; the
+ * total may miss adds still in flight on other threads.
+ *
+ * COUNTERS is normally the size of an enum indexing the set.
+ */
+template <size_t COUNTERS>
+class ShardedCounters {
+public:
+    static constexpr size_t STRIPE_COUNT = 16;
+
+    void Add(size_t counter, uint64_t amount = 1) {
+        stripes_[ThisThreadStripe()].values[counter].fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    uint64_t Load(size_t counter) const {
+        uint64_t total = 0;
+        for (const auto& stripe : stripes_) {
+            total += stripe.values[counter].load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+private:
+    struct alignas(64) Stripe {
+        std::array<std::atomic<uint64_t>, COUNTERS> values{};
+    };
+
+    static size_t ThisThreadStripe() {
+        static std::atomic<size_t> next_stripe{0};
+        thread_local const size_t stripe =
+            next_stripe.fetch_add(1, std::memory_order_relaxed) % STRIPE_COUNT;
+        return stripe;
+    }
+
+    std::array<Stripe, STRIPE_COUNT> stripes_{};
+};
+
+} // namespace Core::Multiplayer
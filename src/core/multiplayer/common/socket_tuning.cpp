@@ -0,0 +1,151 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "socket_tuning.h"
+
+#include <algorithm>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <netinet/in.h>
+#include <netinet/ip.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#endif
+
+namespace Core::Multiplayer {
+
+namespace {
+
+#ifdef _WIN32
+using NativeSocket = SOCKET;
+using AddressLength = int;
+#else
+using NativeSocket = int;
+using AddressLength = socklen_t;
+#endif
+
+bool SetInt(NativeSocket socket, int level, int name, int value) {
+    return setsockopt(socket, level, name, reinterpret_cast<const char*>(&value),
+                      sizeof(value)) == 0;
+}
+
+bool SetTrafficClass(NativeSocket socket, TrafficClass traffic_class) {
+#ifdef _WIN32
+    // Winsock drops IP_TOS unless qWAVE marks the flow
+    (void)socket;
+    return traffic_class == TrafficClass::BestEffort;
+#else
+    sockaddr_storage local{};
+    AddressLength length = sizeof(local);
+    if (getsockname(socket, reinterpret_cast<sockaddr*>(&local), &length) != 0) {
+        return false;
+    }
+    const int tos = DscpFor(traffic_class) << 2;
+    const bool marked = local.ss_family == AF_INET6
+                            ? SetInt(socket, IPPROTO_IPV6, IPV6_TCLASS, tos)
+                            : SetInt(socket, IPPROTO_IP, IP_TOS, tos);
+#ifdef SO_PRIORITY
+    // Also the local qdisc band; 6 is the highest an unprivileged socket gets
+    if (marked && traffic_class == TrafficClass::Interactive) {
+        SetInt(socket, SOL_SOCKET, SO_PRIORITY, 6);
+    }
+#endif
+    return marked;
+#endif
+}
+
+} // anonymous namespace
+
+uint8_t DscpFor(TrafficClass traffic_class) {
+    switch (traffic_class) {
+    case TrafficClass::Video:
+        return 34;
+    case TrafficClass::Interactive:
+        return 46;
+    case TrafficClass::BestEffort:
+        break;
+    }
+    return 0;
+}
+
+SocketTuningProfile SocketTuningProfile::Realtime() {
+    SocketTuningProfile profile;
+    profile.send_buffer_size = 64 * 1024;
+    profile.receive_buffer_size = 256 * 1024;
+    profile.traffic_class = TrafficClass::Interactive;
+    profile.no_delay = true;
+    profile.adapt_send_buffer = true;
+    return profile;
+}
+
+SocketTuningProfile SocketTuningProfile::Throughput() {
+    SocketTuningProfile profile;
+    profile.send_buffer_size = 4 * 1024 * 1024;
+    profile.receive_buffer_size = 4 * 1024 * 1024;
+    return profile;
+}
+
+SocketTuningResult ApplySocketTuning(intptr_t native_handle, const SocketTuningProfile& profile) {
+    const auto socket = static_cast<NativeSocket>(native_handle);
+    SocketTuningResult result;
+    // The kernel may clamp either size to its maximum without failing
+    if (profile.receive_buffer_size != 0) {
+        result.buffers &= SetInt(socket, SOL_SOCKET, SO_RCVBUF,
+                                 static_cast<int>(profile.receive_buffer_size));
+    }
+    if (profile.send_buffer_size != 0) {
+        result.buffers &= SetSocketSendBufferSize(native_handle, profile.send_buffer_size);
+    }
+    if (profile.traffic_class != TrafficClass::BestEffort) {
+        result.traffic_class = SetTrafficClass(socket, profile.traffic_class);
+    }
+    if (profile.no_delay) {
+        int type = 0;
+        AddressLength length = sizeof(type);
+        if (getsockopt(socket, SOL_SOCKET, SO_TYPE, reinterpret_cast<char*>(&type), &length) ==
+                0 &&
+            type == SOCK_STREAM) {
+            result.no_delay = SetInt(socket, IPPROTO_TCP, TCP_NODELAY, 1);
+        }
+    }
+    if (profile.busy_poll_us != 0) {
+#ifdef SO_BUSY_POLL
+        result.busy_poll = SetInt(socket, SOL_SOCKET, SO_BUSY_POLL,
+                                  static_cast<int>(profile.busy_poll_us));
+#else
+        result.busy_poll = false;
+#endif
+    }
+    return result;
+}
+
+bool SetSocketSendBufferSize(intptr_t native_handle, size_t size) {
+    return SetInt(static_cast<NativeSocket>(native_handle), SOL_SOCKET, SO_SNDBUF,
+                  static_cast<int>(size));
+}
+
+AdaptiveSendBuffer::AdaptiveSendBuffer(size_t full_size, SendBufferAdaptationConfig config)
+    : config_(config), full_size_(full_size), size_(full_size) {}
+
+std::optional<size_t> AdaptiveSendBuffer::OnQueuingDelay(std::chrono::microseconds queuing_delay) {
+    if (full_size_ == 0) {
+        return std::nullopt;
+    }
+    const size_t floor = std::min(config_.min_size, full_size_);
+    size_t size = size_;
+    if (queuing_delay > config_.shrink_above) {
+        size = std::max(size_ / 2, floor);
+    } else if (queuing_delay < config_.grow_below) {
+        size = std::min(size_ * 2, full_size_);
+    }
+    if (size == size_) {
+        return std::nullopt;
+    }
+    size_ = size;
+    return size;
+}
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,109 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace Core::Multiplayer {
+
+/**
+ * DSCP marking for a socket's packets. Wi-Fi drivers and access points map
+ * DSCP to a WMM access category (RFC 8325), and a higher category wins the
+ * medium more often on a busy home network.
+ */
+enum class TrafficClass : uint8_t {
+    BestEffort,  // DSCP 0, WMM best effort
+    Video,       // AF41, WMM video
+    Interactive, // EF, WMM voice; game state and input
+};
+
+// DSCP code point for a traffic class, before shifting into the TOS byte
+uint8_t DscpFor(TrafficClass traffic_class);
+
+/**
+ * Socket options a transport applies to each socket it creates. Zero sizes
+ * keep the system default.
+ */
+struct SocketTuningProfile {
+    size_t send_buffer_size = 0;
+    size_t receive_buffer_size = 0;
+    TrafficClass traffic_class = TrafficClass::BestEffort;
+    // TCP_NODELAY on stream sockets; ignored for datagram sockets
+    bool no_delay = false;
+    // SO_BUSY_POLL on Linux: spin this long in receive calls instead of
+    // sleeping on the interrupt. Costs CPU and battery, so off by default
+    uint32_t busy_poll_us = 0;
+    // Let AdaptiveSendBuffer shrink the send buffer while queues build
+    bool adapt_send_buffer = false;
+
+    // Small send buffer, EF marking, no Nagle; for game traffic
+    static SocketTuningProfile Realtime();
+    // Large buffers, best effort; for bulk transfers and servers
+    static SocketTuningProfile Throughput();
+};
+
+// Which options the kernel accepted; each one is best effort
+struct SocketTuningResult {
+    bool buffers = true;
+    bool traffic_class = true;
+    bool no_delay = true;
+    bool busy_poll = true;
+};
+
+/**
+ * Applies a profile to an open socket. IP_TOS or IPV6_TCLASS is picked from
+ * the socket's address family. Unsupported or refused options are skipped;
+ * Windows ignores DSCP from unprivileged sockets, and raising busy poll over
+ * the net.core.busy_read default needs CAP_NET_ADMIN.
+ */
+SocketTuningResult ApplySocketTuning(intptr_t native_handle, const SocketTuningProfile& profile);
+
+// Changes SO_SNDBUF of an open socket; false if the kernel refused
+bool SetSocketSendBufferSize(intptr_t native_handle, size_t size);
+
+struct SendBufferAdaptationConfig {
+    // Queuing delay above which each sample halves the buffer
+    std::chrono::microseconds shrink_above{std::chrono::milliseconds{25}};
+    // Queuing delay below which each sample doubles it back
+    std::chrono::microseconds grow_below{std::chrono::milliseconds{5}};
+    size_t min_size = 8 * 1024;
+};
+
+/**
+ * Sizes a send buffer from the queuing delay a congestion controller
+ * measures.
+ *
+ * A large SO_SNDBUF lets datagrams pile up in the qdisc and Wi-Fi driver
+ * when the link slows down, so each game packet waits behind stale ones. A
+ * buffer that shrinks while delay is high makes the socket push back with
+ * EAGAIN instead, and the sender drops or coalesces at its own layer. Once
+ * the delay falls the buffer grows back to its configured size.
+ *
+ * Not thread-safe.
+ */
+class AdaptiveSendBuffer {
+public:
+    explicit AdaptiveSendBuffer(size_t full_size, SendBufferAdaptationConfig config = {});
+
+    /**
+     * Feeds one queuing delay sample
+     * @return The new size to apply when it changed
+     */
+    std::optional<size_t> OnQueuingDelay(std::chrono::microseconds queuing_delay);
+
+    // 0 when adapting is off because the size is the system default
+    size_t GetSize() const {
+        return size_;
+    }
+
+private:
+    SendBufferAdaptationConfig config_;
+    size_t full_size_;
+    size_t size_;
+};
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,152 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace Core::Multiplayer {
+
+/**
+ * SPSC ring statistics
+ */
+struct SpscRingStatistics {
+    size_t capacity = 0;
+    size_t size = 0;
+    size_t high_watermark = 0;
+    uint64_t pushed_count = 0;
+    uint64_t dropped_count = 0;
+};
+
+/**
+ * Bounded lock-free single-producer/single-consumer ring.
+ *
+ * Exactly one thread may call TryPush and exactly one (other) thread may call
+ * TryPop. Neither side takes a lock or allocates after construction, which
+ * keeps network threads from stalling the emulation thread and vice versa.
+ * When the ring is full, TryPush drops the element and counts the drop.
+ *
+ * Capacity is rounded up to the next power of two.
+ */
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity)
+        : capacity_(RoundUpToPowerOfTwo(capacity)), mask_(capacity_ - 1),
+          slots_(std::make_unique<T[]>(capacity_)) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /**
+     * Producer side: enqueue an element
+     * @return False if the ring was full and the element was dropped
+     */
+    bool TryPush(T&& value) {
+        return Emplace(std::move(value));
+    }
+
+    bool TryPush(const T& value) {
+        return Emplace(value);
+    }
+
+    /**
+     * Consumer side: dequeue the oldest element
+     * @return False if the ring was empty
+     */
+    bool TryPop(T& out) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_) {
+                return false;
+            }
+        }
+
+        out = std::move(slots_[head & mask_]);
+        // Drop any resources still held by the moved-from slot
+        slots_[head & mask_] = T{};
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t Size() const {
+        // Read head first so a concurrent pop can never make tail appear behind it
+        const size_t head = head_.load(std::memory_order_acquire);
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    bool Empty() const { return Size() == 0; }
+    size_t Capacity() const { return capacity_; }
+
+    size_t HighWatermark() const { return high_watermark_.load(std::memory_order_relaxed); }
+    uint64_t DroppedCount() const { return dropped_count_.load(std::memory_order_relaxed); }
+
+    SpscRingStatistics GetStatistics() const {
+        SpscRingStatistics stats;
+        stats.capacity = capacity_;
+        stats.size = Size();
+        stats.high_watermark = HighWatermark();
+        stats.pushed_count = pushed_count_.load(std::memory_order_relaxed);
+        stats.dropped_count = DroppedCount();
+        return stats;
+    }
+
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    static size_t RoundUpToPowerOfTwo(size_t value) {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    template <typename U>
+    bool Emplace(U&& value) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ >= capacity_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ >= capacity_) {
+                dropped_count_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+
+        slots_[tail & mask_] = std::forward<U>(value);
+        tail_.store(tail + 1, std::memory_order_release);
+
+        // Statistics are only written by the producer
+        pushed_count_.store(pushed_count_.load(std::memory_order_relaxed) + 1,
+                            std::memory_order_relaxed);
+        const size_t depth = tail + 1 - head_.load(std::memory_order_relaxed);
+        if (depth > high_watermark_.load(std::memory_order_relaxed)) {
+            high_watermark_.store(depth, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<T[]> slots_;
+
+    // Consumer-owned index plus its cached view of the producer index
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head_{0};
+    size_t cached_tail_ = 0;
+
+    // Producer-owned index plus its cached view of the consumer index
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail_{0};
+    size_t cached_head_ = 0;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> high_watermark_{0};
+    std::atomic<uint64_t> pushed_count_{0};
+    std::atomic<uint64_t> dropped_count_{0};
+};
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,222 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "startup_profile.h"
+
+#include <algorithm>
+#include <atomic>
+#include <optional>
+
+#include "multiplayer_log.h"
+
+namespace Core::Multiplayer {
+
+namespace {
+
+constexpr size_t PHASE_COUNT = static_cast<size_t>(StartupPhase::Count);
+
+// Steady clock nanoseconds; zero means not yet
+struct PhaseClock {
+    std::atomic<uint64_t> begin_ns{0};
+    std::atomic<uint64_t> end_ns{0};
+    std::atomic<bool> failed{false};
+};
+
+struct Profile {
+    std::array<PhaseClock, PHASE_COUNT> phases;
+    std::atomic<int> open_phases{0};
+};
+
+Profile& GetProfile() {
+    // Never destroyed, so phases ending during exit still have somewhere to go
+    static auto* const profile = new Profile();
+    return *profile;
+}
+
+uint64_t NowNs() {
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::max<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now).count(), 1);
+}
+
+std::chrono::microseconds Micros(uint64_t ns) {
+    return std::chrono::microseconds(ns / 1000);
+}
+
+uint64_t Millis(std::chrono::microseconds duration) {
+    return static_cast<uint64_t>(duration.count()) / 1000;
+}
+
+void LogReport(const StartupReport& report) {
+    MULTIPLAYER_LOG_INFO("Multiplayer startup took {} ms, {} ms of it on the critical path",
+                         Millis(report.total), Millis(report.critical_path));
+    for (size_t i = 0; i < PHASE_COUNT; ++i) {
+        const StartupPhaseTiming& timing = report.phases[i];
+        if (timing.critical) {
+            MULTIPLAYER_LOG_INFO("  critical phase {}: {} ms from +{} ms",
+                                 GetStartupPhaseName(static_cast<StartupPhase>(i)),
+                                 Millis(timing.duration), Millis(timing.start));
+        }
+    }
+}
+
+} // namespace
+
+const char* GetStartupPhaseName(StartupPhase phase) {
+    switch (phase) {
+    case StartupPhase::CapabilityDetection:
+        return "capability_detection";
+    case StartupPhase::BackendCreation:
+        return "backend_creation";
+    case StartupPhase::BackendInitialize:
+        return "backend_initialize";
+    case StartupPhase::HostInit:
+        return "host_init";
+    case StartupPhase::HostStart:
+        return "host_start";
+    case StartupPhase::NatDetection:
+        return "nat_detection";
+    case StartupPhase::RoomConnect:
+        return "room_connect";
+    case StartupPhase::RoomRegister:
+        return "room_register";
+    case StartupPhase::MdnsFirstResult:
+        return "mdns_first_result";
+    case StartupPhase::WifiDirectNegotiation:
+        return "wifi_direct_negotiation";
+    case StartupPhase::Count:
+        break;
+    }
+    return "unknown";
+}
+
+void BeginStartupPhase(StartupPhase phase) {
+    Profile& profile = GetProfile();
+    uint64_t expected = 0;
+    if (profile.phases[static_cast<size_t>(phase)].begin_ns.compare_exchange_strong(
+            expected, NowNs())) {
+        profile.open_phases.fetch_add(1);
+    }
+}
+
+void EndStartupPhase(StartupPhase phase, bool succeeded) {
+    Profile& profile = GetProfile();
+    PhaseClock& clock = profile.phases[static_cast<size_t>(phase)];
+    const uint64_t begin_ns = clock.begin_ns.load();
+    if (begin_ns == 0) {
+        return;
+    }
+    uint64_t expected = 0;
+    const uint64_t end_ns = NowNs();
+    if (!clock.end_ns.compare_exchange_strong(expected, end_ns)) {
+        return;
+    }
+    clock.failed = !succeeded;
+
+    MULTIPLAYER_LOG_DEBUG("Startup phase {} {} after {} ms", GetStartupPhaseName(phase),
+                          succeeded ? "finished" : "failed",
+                          Millis(Micros(end_ns - begin_ns)));
+    if (profile.open_phases.fetch_sub(1) == 1) {
+        LogReport(GetStartupReport());
+    }
+}
+
+StartupReport GetStartupReport() {
+    const Profile& profile = GetProfile();
+    std::array<uint64_t, PHASE_COUNT> begins{};
+    std::array<uint64_t, PHASE_COUNT> ends{};
+    uint64_t earliest = 0;
+    uint64_t latest = 0;
+    for (size_t i = 0; i < PHASE_COUNT; ++i) {
+        begins[i] = profile.phases[i].begin_ns.load();
+        ends[i] = begins[i] != 0 ? profile.phases[i].end_ns.load() : 0;
+        if (begins[i] != 0 && (earliest == 0 || begins[i] < earliest)) {
+            earliest = begins[i];
+        }
+        latest = std::max(latest, ends[i]);
+    }
+
+    StartupReport report;
+    if (earliest == 0) {
+        return report;
+    }
+    const uint64_t now_ns = NowNs();
+    for (size_t i = 0; i < PHASE_COUNT; ++i) {
+        if (begins[i] == 0) {
+            continue;
+        }
+        StartupPhaseTiming& timing = report.phases[i];
+        timing.started = true;
+        timing.finished = ends[i] != 0;
+        timing.failed = timing.finished && profile.phases[i].failed.load();
+        timing.start = Micros(begins[i] - earliest);
+        // Unfinished phases report how long they have run so far
+        timing.duration = Micros((timing.finished ? ends[i] : std::max(now_ns, begins[i])) -
+                                 begins[i]);
+    }
+    if (latest == 0) {
+        return report;
+    }
+    report.total = Micros(latest - earliest);
+
+    // Walk back from the last phase to finish through what it waited on
+    const auto latest_ending_before = [&](uint64_t limit) {
+        std::optional<size_t> found;
+        for (size_t i = 0; i < PHASE_COUNT; ++i) {
+            if (ends[i] != 0 && ends[i] <= limit && !report.phases[i].critical &&
+                (!found || ends[i] > ends[*found])) {
+                found = i;
+            }
+        }
+        return found;
+    };
+    for (auto phase = latest_ending_before(latest); phase;
+         phase = latest_ending_before(begins[*phase])) {
+        report.phases[*phase].critical = true;
+        report.critical_path += report.phases[*phase].duration;
+    }
+    return report;
+}
+
+void ResetStartupProfile() {
+    Profile& profile = GetProfile();
+    for (PhaseClock& clock : profile.phases) {
+        clock.begin_ns = 0;
+        clock.end_ns = 0;
+        clock.failed = false;
+    }
+    profile.open_phases = 0;
+}
+
+std::string StartupReport::Format() const {
+    std::array<size_t, PHASE_COUNT> order{};
+    size_t started = 0;
+    for (size_t i = 0; i < PHASE_COUNT; ++i) {
+        if (phases[i].started) {
+            order[started++] = i;
+        }
+    }
+    std::stable_sort(order.begin(), order.begin() + started,
+                     [this](size_t a, size_t b) { return phases[a].start < phases[b].start; });
+
+    std::string text = "total " + std::to_string(Millis(total)) + "ms, critical " +
+                       std::to_string(Millis(critical_path)) + "ms:";
+    for (size_t i = 0; i < started; ++i) {
+        const StartupPhaseTiming& timing = phases[order[i]];
+        text += ' ';
+        text += GetStartupPhaseName(static_cast<StartupPhase>(order[i]));
+        text += ' ';
+        text += std::to_string(Millis(timing.duration));
+        text += "ms";
+        if (!timing.finished) {
+            text += "...";
+        } else if (timing.failed) {
+            text += '!';
+        } else if (timing.critical) {
+            text += '*';
+        }
+    }
+    return text;
+}
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,120 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Core::Multiplayer {
+
+/**
+ * Steps of bringing multiplayer up, timed by the startup profile
+ */
+enum class StartupPhase : uint8_t {
+    CapabilityDetection,   // BackendFactory availability probes, until settled
+    BackendCreation,       // BackendFactory::CreateBackend
+    BackendInitialize,     // MultiplayerBackend::Initialize
+    HostInit,              // libp2p identity, transports and host construction
+    HostStart,             // libp2p host start
+    NatDetection,          // AutoNAT, until its first verdict
+    RoomConnect,           // Room server WebSocket, until connected
+    RoomRegister,          // Register request, until its response
+    MdnsFirstResult,       // mDNS discovery, until the first service is found
+    WifiDirectNegotiation, // Wi-Fi Direct connect or group setup, until formed
+    Count,
+};
+
+const char* GetStartupPhaseName(StartupPhase phase);
+
+/**
+ * Timing of one phase's first run
+ */
+struct StartupPhaseTiming {
+    bool started = false;
+    bool finished = false;
+    bool failed = false;
+    // Finished phases that the last one to finish waited on, see StartupReport
+    bool critical = false;
+    // From the earliest phase start
+    std::chrono::microseconds start{0};
+    std::chrono::microseconds duration{0};
+};
+
+/**
+ * Startup timings, filled by GetStartupReport.
+ *
+ * Phases overlap, so their durations do not add up to the startup time. The
+ * critical path is the chain that ends with the last phase to finish, each
+ * link being the latest-finishing phase that ended before the next began;
+ * shortening any other phase would not have brought multiplayer up sooner.
+ */
+struct StartupReport {
+    std::array<StartupPhaseTiming, static_cast<size_t>(StartupPhase::Count)> phases{};
+    // Earliest start to latest finish
+    std::chrono::microseconds total{0};
+    // Sum of the critical phases; total less this is time spent between them
+    std::chrono::microseconds critical_path{0};
+
+    StartupPhaseTiming& operator[](StartupPhase phase) {
+        return phases[static_cast<size_t>(phase)];
+    }
+    const StartupPhaseTiming& operator[](StartupPhase phase) const {
+        return phases[static_cast<size_t>(phase)];
+    }
+
+    /**
+     * One line in start order, for logs and bug reports:
+     * "total 912ms, critical 880ms: host_init 310ms* room_connect 570ms* mdns_first_result 45ms"
+     * Critical phases are starred, failed ones marked "!", unfinished ones "...".
+     */
+    std::string Format() const;
+};
+
+/**
+ * Process-wide phase timings for the first bring-up of each phase.
+ *
+ * Only a phase's first run is kept until ResetStartupProfile, so reconnects
+ * and backend switches do not overwrite what startup cost; an End without a
+ * matching Begin, or a second End, does nothing. Begin and End take no lock
+ * and are safe from any thread, so a phase may end on a callback thread.
+ *
+ * Each finished phase is logged at debug level, and whenever the last open
+ * phase finishes the report is logged at info level. Backends also carry it
+ * in BackendStats::startup.
+ */
+void BeginStartupPhase(StartupPhase phase);
+void EndStartupPhase(StartupPhase phase, bool succeeded = true);
+
+StartupReport GetStartupReport();
+void ResetStartupProfile();
+
+/**
+ * Times a phase that starts and ends in one scope; it counts as failed if
+ * Fail() was called before the scope ends
+ */
+class StartupSpan {
+public:
+    explicit StartupSpan(StartupPhase phase) : phase_(phase) {
+        BeginStartupPhase(phase);
+    }
+    ~StartupSpan() {
+        EndStartupPhase(phase_, !failed_);
+    }
+
+    StartupSpan(const StartupSpan&) = delete;
+    StartupSpan& operator=(const StartupSpan&) = delete;
+
+    void Fail() {
+        failed_ = true;
+    }
+
+private:
+    const StartupPhase phase_;
+    bool failed_ = false;
+};
+
+} // namespace Core::Multiplayer
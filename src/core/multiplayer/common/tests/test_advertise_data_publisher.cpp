@@ -0,0 +1,197 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "core/multiplayer/common/advertise_data_publisher.h"
+
+using namespace Core::Multiplayer;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct Published {
+    std::mutex mutex;
+    std::vector<AdvertiseDataPatch> patches;
+    std::vector<uint8_t> data;
+
+    AdvertiseDataPublisher::PublishCallback Callback() {
+        return [this](const AdvertiseDataPatch& patch, std::span<const uint8_t> published) {
+            std::lock_guard<std::mutex> lock(mutex);
+            patches.push_back(patch);
+            data.assign(published.begin(), published.end());
+        };
+    }
+
+    size_t Count() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return patches.size();
+    }
+};
+
+bool WaitFor(const std::function<bool()>& condition) {
+    const auto deadline = std::chrono::steady_clock::now() + 2s;
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+} // namespace
+
+TEST(AdvertiseDataPatchTest, DiffCarriesOnlyChangedRuns) {
+    std::vector<uint8_t> base(64, 0);
+    std::vector<uint8_t> target = base;
+    target[3] = 1;
+    target[40] = 2;
+    target[41] = 3;
+
+    auto patch = DiffAdvertiseData(base, target);
+    patch.base_version = 1;
+    ASSERT_EQ(patch.runs.size(), 2u);
+    EXPECT_EQ(patch.runs[0].offset, 3u);
+    EXPECT_EQ(patch.runs[0].bytes, std::vector<uint8_t>{1});
+    EXPECT_EQ(patch.runs[1].offset, 40u);
+    EXPECT_EQ(patch.GetPayloadSize(), 3u);
+
+    std::vector<uint8_t> applied = base;
+    ASSERT_TRUE(ApplyAdvertiseDataPatch(patch, applied));
+    EXPECT_EQ(applied, target);
+}
+
+TEST(AdvertiseDataPatchTest, CloseRunsAreMerged) {
+    std::vector<uint8_t> base(16, 0);
+    std::vector<uint8_t> target = base;
+    target[2] = 1;
+    target[5] = 1;
+
+    const auto patch = DiffAdvertiseData(base, target);
+    ASSERT_EQ(patch.runs.size(), 1u);
+    EXPECT_EQ(patch.runs[0].offset, 2u);
+    EXPECT_EQ(patch.runs[0].bytes.size(), 4u);
+}
+
+TEST(AdvertiseDataPatchTest, GrowingAndShrinkingChangeTheSize) {
+    const std::vector<uint8_t> base{1, 2, 3};
+    const std::vector<uint8_t> longer{1, 2, 3, 4, 5};
+    const std::vector<uint8_t> shorter{1};
+
+    const auto apply = [](std::span<const uint8_t> from, std::span<const uint8_t> to,
+                          std::vector<uint8_t>& data) {
+        auto patch = DiffAdvertiseData(from, to);
+        patch.base_version = 1;
+        return ApplyAdvertiseDataPatch(patch, data);
+    };
+
+    std::vector<uint8_t> applied = base;
+    ASSERT_TRUE(apply(base, longer, applied));
+    EXPECT_EQ(applied, longer);
+    ASSERT_TRUE(apply(longer, shorter, applied));
+    EXPECT_EQ(applied, shorter);
+}
+
+TEST(AdvertiseDataPatchTest, OutOfBoundsRunIsRejected) {
+    AdvertiseDataPatch patch;
+    patch.size = 4;
+    patch.runs.push_back({3, {1, 2}});
+    std::vector<uint8_t> data{9, 9, 9, 9};
+    EXPECT_FALSE(ApplyAdvertiseDataPatch(patch, data));
+    EXPECT_EQ(data, (std::vector<uint8_t>{9, 9, 9, 9}));
+}
+
+TEST(AdvertiseDataPublisherTest, FirstSetPublishesFullBlob) {
+    Published published;
+    AdvertiseDataPublisher publisher(published.Callback(), 1000ms,
+                                     std::make_shared<TimerWheel>(1ms));
+    const std::vector<uint8_t> data{1, 2, 3};
+    ASSERT_TRUE(publisher.Set(data));
+
+    ASSERT_EQ(published.Count(), 1u);
+    EXPECT_TRUE(published.patches[0].IsFull());
+    EXPECT_EQ(published.patches[0].version, 1u);
+    EXPECT_EQ(published.data, data);
+    EXPECT_EQ(publisher.GetPublishedVersion(), 1u);
+}
+
+TEST(AdvertiseDataPublisherTest, SetsWithinTheIntervalAreCoalesced) {
+    Published published;
+    AdvertiseDataPublisher publisher(published.Callback(), 20ms,
+                                     std::make_shared<TimerWheel>(1ms));
+    std::vector<uint8_t> data(32, 0);
+    publisher.Set(data);
+    for (uint8_t i = 1; i <= 10; ++i) {
+        data[0] = i;
+        publisher.Set(data);
+    }
+    EXPECT_EQ(published.Count(), 1u);
+
+    ASSERT_TRUE(WaitFor([&] { return published.Count() == 2; }));
+    std::this_thread::sleep_for(40ms);
+    EXPECT_EQ(published.Count(), 2u);
+
+    const auto& patch = published.patches[1];
+    EXPECT_EQ(patch.base_version, 1u);
+    EXPECT_EQ(patch.version, 2u);
+    EXPECT_EQ(patch.GetPayloadSize(), 1u);
+    EXPECT_EQ(published.data, data);
+    EXPECT_EQ(publisher.GetStatistics().coalesced, 10u);
+}
+
+TEST(AdvertiseDataPublisherTest, UnchangedDataIsNotPublished) {
+    Published published;
+    AdvertiseDataPublisher publisher(published.Callback(), 1ms,
+                                     std::make_shared<TimerWheel>(1ms));
+    const std::vector<uint8_t> data{4, 5, 6};
+    const auto start = AdvertiseDataPublisher::Clock::now();
+    publisher.Set(data, start);
+    publisher.Set(data, start + 1s);
+
+    EXPECT_EQ(published.Count(), 1u);
+    EXPECT_EQ(publisher.GetStatistics().unchanged, 1u);
+}
+
+TEST(AdvertiseDataPublisherTest, RequestFullResendsTheWholeBlob) {
+    Published published;
+    AdvertiseDataPublisher publisher(published.Callback(), 1ms,
+                                     std::make_shared<TimerWheel>(1ms));
+    const auto start = AdvertiseDataPublisher::Clock::now();
+    publisher.Set(std::vector<uint8_t>{1, 2, 3}, start);
+    publisher.RequestFull();
+    publisher.Set(std::vector<uint8_t>{1, 2, 4}, start + 1s);
+
+    ASSERT_EQ(published.Count(), 2u);
+    EXPECT_TRUE(published.patches[1].IsFull());
+    EXPECT_EQ(published.patches[1].GetPayloadSize(), 3u);
+}
+
+TEST(AdvertiseDataPublisherTest, OversizedDataIsRejected) {
+    Published published;
+    AdvertiseDataPublisher publisher(published.Callback());
+    const std::vector<uint8_t> data(AdvertiseDataPublisher::MAX_SIZE + 1, 0);
+    EXPECT_FALSE(publisher.Set(data));
+    EXPECT_EQ(published.Count(), 0u);
+}
+
+TEST(AdvertiseDataPublisherTest, ResetCancelsThePendingPublish) {
+    Published published;
+    AdvertiseDataPublisher publisher(published.Callback(), 20ms,
+                                     std::make_shared<TimerWheel>(1ms));
+    publisher.Set(std::vector<uint8_t>{1});
+    publisher.Set(std::vector<uint8_t>{2});
+    publisher.Reset();
+
+    std::this_thread::sleep_for(50ms);
+    EXPECT_EQ(published.Count(), 1u);
+    EXPECT_FALSE(publisher.GetPublishedVersion().has_value());
+}
@@ -0,0 +1,136 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <optional>
+#include <thread>
+
+#include "core/multiplayer/common/async_task.h"
+
+using namespace Core::Multiplayer;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Starts the task and blocks the test thread, not an executor worker, for its result
+template <typename T>
+T RunToCompletion(Task<T> task) {
+    std::promise<T> result;
+    auto future = result.get_future();
+    StartTask(std::move(task), [&result](T value) { result.set_value(std::move(value)); });
+    EXPECT_EQ(future.wait_for(5s), std::future_status::ready);
+    return future.get();
+}
+
+Task<int> Add(int a, int b) {
+    co_return a + b;
+}
+
+Task<int> AddTwice(int value) {
+    const int once = co_await Add(value, 1);
+    co_return co_await Add(once, 1);
+}
+
+} // namespace
+
+TEST(AsyncTaskTest, TasksChainThroughCoAwait) {
+    EXPECT_EQ(RunToCompletion(AddTwice(40)), 42);
+}
+
+TEST(AsyncTaskTest, TaskIsLazyUntilStarted) {
+    bool ran = false;
+    // Coroutine lambdas are kept alive; the frame refers to their captures
+    auto body = [&ran]() -> Task<int> {
+        ran = true;
+        co_return 1;
+    };
+    auto task = body();
+    EXPECT_FALSE(ran);
+    EXPECT_EQ(RunToCompletion(std::move(task)), 1);
+    EXPECT_TRUE(ran);
+}
+
+TEST(AsyncTaskTest, AwaitCallbackResumesOnTheExecutor) {
+    std::function<void(int)> pending;
+    auto task = [&pending]() -> Task<std::optional<int>> {
+        co_return co_await AwaitCallback<int>(
+            [&pending](std::function<void(int)> complete) { pending = std::move(complete); });
+    };
+
+    std::promise<std::optional<int>> result;
+    auto future = result.get_future();
+    StartTask(task(), [&result](std::optional<int> value) { result.set_value(value); });
+    ASSERT_TRUE(pending);
+    EXPECT_EQ(future.wait_for(20ms), std::future_status::timeout);
+
+    std::thread network_thread([&pending] { pending(7); });
+    network_thread.join();
+    EXPECT_EQ(future.get(), 7);
+}
+
+TEST(AsyncTaskTest, AwaitCallbackCompletedInlineContinues) {
+    auto task = []() -> Task<std::optional<int>> {
+        co_return co_await AwaitCallback<int>([](std::function<void(int)> complete) { complete(3); });
+    };
+    EXPECT_EQ(RunToCompletion(task()), 3);
+}
+
+TEST(AsyncTaskTest, CancellationResumesWithNullopt) {
+    CancellationSource source;
+    std::function<void(int)> pending;
+    auto task = [&]() -> Task<std::optional<int>> {
+        co_return co_await AwaitCallback<int>(
+            [&pending](std::function<void(int)> complete) { pending = std::move(complete); },
+            source.GetToken());
+    };
+
+    std::promise<std::optional<int>> result;
+    auto future = result.get_future();
+    StartTask(task(), [&result](std::optional<int> value) { result.set_value(value); });
+    source.Cancel();
+    EXPECT_EQ(future.get(), std::nullopt);
+
+    pending(9); // Late result is dropped
+}
+
+TEST(AsyncTaskTest, DelayWaitsOnTheTimerWheel) {
+    auto task = []() -> Task<bool> { co_return co_await Delay(20ms); };
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(RunToCompletion(task()));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, 20ms);
+}
+
+TEST(AsyncTaskTest, CancelledDelayReturnsEarly) {
+    CancellationSource source;
+    auto task = [token = source.GetToken()]() -> Task<bool> { co_return co_await Delay(10s, token); };
+
+    std::promise<bool> result;
+    auto future = result.get_future();
+    StartTask(task(), [&result](bool elapsed) { result.set_value(elapsed); });
+    source.Cancel();
+    ASSERT_EQ(future.wait_for(2s), std::future_status::ready);
+    EXPECT_FALSE(future.get());
+}
+
+TEST(AsyncTaskTest, AwaitFuturePollsWithoutBlocking) {
+    std::promise<int> promise;
+    std::thread producer([&promise] {
+        std::this_thread::sleep_for(30ms);
+        promise.set_value(5);
+    });
+    EXPECT_EQ(RunToCompletion(AwaitFuture(promise.get_future())), 5);
+    producer.join();
+}
+
+TEST(AsyncTaskTest, RegisterOnCancelledTokenRunsRightAway) {
+    CancellationSource source;
+    source.Cancel();
+    bool ran = false;
+    EXPECT_EQ(source.GetToken().Register([&ran] { ran = true; }),
+              CancellationToken::INVALID_CALLBACK_ID);
+    EXPECT_TRUE(ran);
+    EXPECT_FALSE(CancellationToken{}.IsCancellationRequested());
+}
@@ -0,0 +1,168 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core/multiplayer/common/backend_stats.h"
+#include "core/multiplayer/common/seqlock.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+
+using namespace Core::Multiplayer;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr uint64_t SECOND_NS = 1'000'000'000;
+
+struct Pair {
+    uint64_t value = 0;
+    uint64_t copy = 0;
+};
+
+} // namespace
+
+TEST(SeqLockTest, LoadsWhatWasStored) {
+    SeqLock<Pair> lock;
+    EXPECT_EQ(lock.Load().value, 0u);
+    lock.Store(Pair{7, 7});
+    EXPECT_EQ(lock.Load().value, 7u);
+    EXPECT_EQ(lock.Load().copy, 7u);
+}
+
+TEST(SeqLockTest, ReadersNeverSeeATornValue) {
+    SeqLock<Pair> lock;
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        for (uint64_t i = 1; i <= 200'000; ++i) {
+            lock.Store(Pair{i, i});
+        }
+        done = true;
+    });
+
+    uint64_t last = 0;
+    while (!done) {
+        const Pair pair = lock.Load();
+        ASSERT_EQ(pair.value, pair.copy);
+        ASSERT_GE(pair.value, last);
+        last = pair.value;
+    }
+    writer.join();
+    EXPECT_EQ(lock.Load().value, 200'000u);
+}
+
+TEST(BackendStatsTest, EmptyRecorderHasNoNodes) {
+    BackendStatsRecorder recorder;
+    BackendStats stats;
+    recorder.Fill(stats);
+    EXPECT_EQ(stats.node_count, 0u);
+    EXPECT_EQ(stats.payload_bytes_sent, 0u);
+}
+
+TEST(BackendStatsTest, CountsTrafficPerNode) {
+    BackendStatsRecorder recorder;
+    recorder.OnSent(1, 100, 60, SECOND_NS);
+    recorder.OnSent(1, 100, 70, SECOND_NS);
+    recorder.OnReceived(3, 80, 120, SECOND_NS);
+
+    BackendStats stats;
+    recorder.Fill(stats);
+    ASSERT_EQ(stats.node_count, 2u);
+    EXPECT_EQ(stats.nodes[0].node_id, 1);
+    EXPECT_EQ(stats.nodes[0].packets_sent, 2u);
+    EXPECT_EQ(stats.nodes[0].payload_bytes_sent, 200u);
+    EXPECT_EQ(stats.nodes[0].wire_bytes_sent, 130u);
+    EXPECT_EQ(stats.nodes[1].node_id, 3);
+    EXPECT_EQ(stats.nodes[1].packets_received, 1u);
+    EXPECT_EQ(stats.nodes[1].wire_bytes_received, 80u);
+    EXPECT_EQ(stats.nodes[1].payload_bytes_received, 120u);
+    EXPECT_EQ(stats.payload_bytes_sent, 200u);
+    EXPECT_EQ(stats.wire_bytes_received, 80u);
+}
+
+TEST(BackendStatsTest, NodesBeyondTheLimitOnlyCountInTotals) {
+    BackendStatsRecorder recorder;
+    recorder.OnSent(200, 50, 50, SECOND_NS);
+    BackendStats stats;
+    recorder.Fill(stats);
+    EXPECT_EQ(stats.node_count, 0u);
+    EXPECT_EQ(stats.payload_bytes_sent, 50u);
+}
+
+TEST(BackendStatsTest, ThroughputCoversTheLastWindow) {
+    BackendStatsRecorder recorder;
+    for (uint64_t i = 0; i < 10; ++i) {
+        recorder.OnSent(0, 1000, 1000, SECOND_NS + i * SECOND_NS / 10);
+    }
+    BackendStats stats;
+    recorder.Fill(stats);
+    EXPECT_EQ(stats.nodes[0].send_bytes_per_second, 0u);
+
+    // The packet closing the window is counted in the next one
+    recorder.OnSent(0, 1000, 1000, 2 * SECOND_NS);
+    recorder.Fill(stats);
+    EXPECT_EQ(stats.nodes[0].send_bytes_per_second, 10'000u);
+}
+
+TEST(BackendStatsTest, LinkReportsFillRttAndOverhead) {
+    BackendStatsRecorder recorder;
+    NodeLinkSample sample;
+    sample.transport = LinkTransport::Relay;
+    sample.rtt = 42ms;
+    sample.jitter = 3ms;
+    sample.loss_rate = 0.02f;
+    sample.encryption_overhead = 28;
+    sample.one_way_delay = 19ms;
+    sample.clock_offset = -4ms;
+    sample.clock_confidence = 0.75f;
+    recorder.ReportLink(2, sample);
+    recorder.OnSent(2, 100, 100, SECOND_NS);
+    recorder.OnSent(2, 100, 100, SECOND_NS);
+    recorder.OnFecCounts(5, 1);
+
+    BackendStats stats;
+    recorder.Fill(stats);
+    ASSERT_EQ(stats.node_count, 1u);
+    const NodeStats& node = stats.nodes[0];
+    EXPECT_EQ(node.transport, LinkTransport::Relay);
+    EXPECT_EQ(node.rtt, 42ms);
+    EXPECT_EQ(node.jitter, 3ms);
+    EXPECT_FLOAT_EQ(node.loss_rate, 0.02f);
+    EXPECT_EQ(node.one_way_delay, 19ms);
+    EXPECT_EQ(node.clock_offset, -4ms);
+    EXPECT_FLOAT_EQ(node.clock_confidence, 0.75f);
+    EXPECT_EQ(node.encryption_overhead_bytes, 56u);
+    EXPECT_EQ(stats.encryption_overhead_bytes, 56u);
+    EXPECT_EQ(stats.fec_packets_recovered, 5u);
+    EXPECT_EQ(stats.fec_packets_lost, 1u);
+}
+
+TEST(BackendStatsTest, FillWhileSendAndReceiveThreadsRecord) {
+    BackendStatsRecorder recorder;
+    std::atomic<bool> done{false};
+    constexpr uint64_t PACKETS = 100'000;
+    std::thread sender([&] {
+        for (uint64_t i = 0; i < PACKETS; ++i) {
+            recorder.OnSent(0, 10, 10, SECOND_NS + i);
+        }
+    });
+    std::thread receiver([&] {
+        for (uint64_t i = 0; i < PACKETS; ++i) {
+            recorder.OnReceived(0, 10, 10, SECOND_NS + i);
+        }
+    });
+
+    BackendStats stats;
+    while (!done) {
+        recorder.Fill(stats);
+        if (stats.node_count == 1) {
+            // Each direction is copied whole, never half-updated
+            ASSERT_EQ(stats.nodes[0].payload_bytes_sent, stats.nodes[0].packets_sent * 10);
+            ASSERT_EQ(stats.nodes[0].payload_bytes_received,
+                      stats.nodes[0].packets_received * 10);
+            done = stats.nodes[0].packets_sent == PACKETS &&
+                   stats.nodes[0].packets_received == PACKETS;
+        }
+    }
+    sender.join();
+    receiver.join();
+}
@@ -0,0 +1,76 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <chrono>
+
+#include "core/multiplayer/common/bandwidth_estimator.h"
+
+using namespace Core::Multiplayer;
+using namespace std::chrono_literals;
+
+TEST(BandwidthEstimatorTest, PacketPairsGiveTheBottleneck) {
+    BandwidthEstimator estimator;
+    auto now = BandwidthEstimator::Clock::now();
+    // 1000-byte packets 1 ms apart: 1 MB/s, a few widened by cross traffic
+    for (int i = 0; i < 32; ++i) {
+        now += i % 4 == 0 ? 3ms : 1ms;
+        estimator.OnPacketArrived(1000, now);
+    }
+
+    const auto estimate = estimator.GetEstimate();
+    EXPECT_EQ(estimate.bottleneck_bytes_per_second, 1'000'000u);
+    EXPECT_EQ(estimate.available_bytes_per_second, 1'000'000u);
+    EXPECT_FALSE(estimate.queue_building);
+}
+
+TEST(BandwidthEstimatorTest, IgnoresSmallAndSpreadOutPackets) {
+    BandwidthEstimator estimator;
+    auto now = BandwidthEstimator::Clock::now();
+    for (int i = 0; i < 8; ++i) {
+        now += 1ms;
+        estimator.OnPacketArrived(64, now);
+    }
+    for (int i = 0; i < 8; ++i) {
+        now += 50ms;
+        estimator.OnPacketArrived(1000, now);
+    }
+
+    EXPECT_EQ(estimator.GetEstimate().pair_samples, 0u);
+    EXPECT_EQ(estimator.GetEstimate().available_bytes_per_second, 0u);
+}
+
+TEST(BandwidthEstimatorTest, SendsOutrunningAcksLimitToTheDeliveryRate) {
+    BandwidthEstimatorConfig config;
+    config.rate_window = 100ms;
+    BandwidthEstimator estimator(config);
+    auto now = BandwidthEstimator::Clock::now();
+    for (int i = 0; i < 8; ++i) {
+        now += 1ms;
+        estimator.OnPacketArrived(1000, now);
+    }
+
+    // 200 KB/s sent, 100 KB/s acknowledged
+    for (int i = 0; i < 2; ++i) {
+        now += 100ms;
+        estimator.OnBytesSent(20'000, now);
+        estimator.OnBytesAcked(10'000, now);
+    }
+    auto estimate = estimator.GetEstimate();
+    EXPECT_TRUE(estimate.queue_building);
+    EXPECT_EQ(estimate.delivery_bytes_per_second, 100'000u);
+    EXPECT_EQ(estimate.available_bytes_per_second, 100'000u);
+
+    // Acks catch up: back to the bottleneck
+    for (int i = 0; i < 2; ++i) {
+        now += 100ms;
+        estimator.OnBytesSent(10'000, now);
+        estimator.OnBytesAcked(10'000, now);
+    }
+    estimate = estimator.GetEstimate();
+    EXPECT_FALSE(estimate.queue_building);
+    EXPECT_EQ(estimate.available_bytes_per_second, 1'000'000u);
+
+    estimator.Reset();
+    EXPECT_EQ(estimator.GetEstimate().available_bytes_per_second, 0u);
+}
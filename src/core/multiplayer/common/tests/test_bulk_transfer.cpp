@@ -0,0 +1,223 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "core/multiplayer/common/bulk_transfer.h"
+
+using namespace Core::Multiplayer;
+
+namespace {
+
+using Message = std::vector<uint8_t>;
+
+constexpr uint8_t TYPE_CHUNK = 3;
+
+// One end of a link whose messages the test carries by hand
+struct Endpoint {
+    explicit Endpoint(const BulkTransferConfig& config)
+        : channel(
+              config,
+              [this](std::span<const uint8_t> message) {
+                  if (!accepting) {
+                      return false;
+                  }
+                  sent.emplace_back(message.begin(), message.end());
+                  return true;
+              },
+              [this](uint32_t, std::vector<uint8_t> data) { completed.push_back(std::move(data)); }) {}
+
+    std::vector<Message> TakeSent() { return std::exchange(sent, {}); }
+
+    bool accepting = true;
+    std::vector<Message> sent;
+    std::vector<std::vector<uint8_t>> completed;
+    BulkTransferChannel channel;
+};
+
+BulkTransferConfig SmallChunks() {
+    BulkTransferConfig config;
+    config.chunk_size = 100;
+    config.window_chunks = 4;
+    return config;
+}
+
+std::vector<uint8_t> Blob(size_t size) {
+    std::vector<uint8_t> blob(size);
+    for (size_t i = 0; i < size; ++i) {
+        blob[i] = static_cast<uint8_t>(i * 31 + 7);
+    }
+    return blob;
+}
+
+size_t CountChunks(const std::vector<Message>& messages) {
+    size_t count = 0;
+    for (const auto& message : messages) {
+        count += message[0] == TYPE_CHUNK ? 1 : 0;
+    }
+    return count;
+}
+
+// Carries messages both ways until the link is quiet; filter may drop or alter them
+void Exchange(Endpoint& a, Endpoint& b,
+              const std::function<bool(Message&)>& filter = [](Message&) { return true; }) {
+    for (int round = 0; round < 1000; ++round) {
+        auto to_b = a.TakeSent();
+        auto to_a = b.TakeSent();
+        if (to_b.empty() && to_a.empty()) {
+            return;
+        }
+        for (auto& message : to_b) {
+            if (filter(message)) {
+                b.channel.Receive(message);
+            }
+        }
+        for (auto& message : to_a) {
+            a.channel.Receive(message);
+        }
+    }
+    FAIL() << "Link never went quiet";
+}
+
+} // namespace
+
+TEST(BulkTransferTest, SendsABlobInChunksWithinTheWindow) {
+    Endpoint a(SmallChunks());
+    Endpoint b(SmallChunks());
+    const auto blob = Blob(1050);
+    const auto id = a.channel.Send(blob);
+    ASSERT_TRUE(id.has_value());
+
+    // Nothing but the offer until the receiver answers it
+    ASSERT_EQ(a.sent.size(), 1u);
+    EXPECT_EQ(CountChunks(a.sent), 0u);
+    ASSERT_TRUE(a.channel.GetProgress(*id).has_value());
+    EXPECT_EQ(a.channel.GetProgress(*id)->total, 1050u);
+
+    // Then one window of chunks, and more only as the receiver acknowledges
+    b.channel.Receive(a.TakeSent()[0]);
+    a.channel.Receive(b.TakeSent()[0]);
+    EXPECT_EQ(CountChunks(a.sent), 4u);
+    a.channel.Poll();
+    EXPECT_EQ(CountChunks(a.sent), 4u);
+
+    Exchange(a, b);
+    ASSERT_EQ(b.completed.size(), 1u);
+    EXPECT_EQ(b.completed[0], blob);
+    EXPECT_FALSE(a.channel.GetProgress(*id).has_value());
+    EXPECT_EQ(a.channel.GetOutgoingCount(), 0u);
+
+    const auto sender = a.channel.GetStatistics();
+    EXPECT_EQ(sender.chunks_sent, 11u);
+    EXPECT_EQ(sender.chunks_resent, 0u);
+    EXPECT_EQ(sender.transfers_sent, 1u);
+    EXPECT_EQ(b.channel.GetStatistics().transfers_received, 1u);
+}
+
+TEST(BulkTransferTest, CorruptChunkIsSentAgain) {
+    Endpoint a(SmallChunks());
+    Endpoint b(SmallChunks());
+    const auto blob = Blob(600);
+    ASSERT_TRUE(a.channel.Send(blob).has_value());
+
+    bool corrupted = false;
+    Exchange(a, b, [&](Message& message) {
+        if (!corrupted && message[0] == TYPE_CHUNK && message[5] == 200) {
+            message.back() ^= 0x40;
+            corrupted = true;
+        }
+        return true;
+    });
+    ASSERT_TRUE(corrupted);
+    ASSERT_EQ(b.completed.size(), 1u);
+    EXPECT_EQ(b.completed[0], blob);
+    EXPECT_EQ(b.channel.GetStatistics().checksum_failures, 1u);
+    // Everything from the bad chunk on goes again
+    EXPECT_EQ(a.channel.GetStatistics().chunks_sent, 6u);
+    EXPECT_EQ(a.channel.GetStatistics().chunks_resent, 4u);
+}
+
+TEST(BulkTransferTest, ResumesFromTheVerifiedOffsetAfterReconnect) {
+    Endpoint a(SmallChunks());
+    Endpoint b(SmallChunks());
+    const auto blob = Blob(2000);
+    const auto id = a.channel.Send(blob);
+    ASSERT_TRUE(id.has_value());
+
+    // The connection drops once the receiver holds 600 bytes
+    size_t delivered = 0;
+    Exchange(a, b, [&](Message& message) {
+        if (message[0] != TYPE_CHUNK) {
+            return true;
+        }
+        return ++delivered <= 6;
+    });
+    EXPECT_TRUE(b.completed.empty());
+    const uint64_t acknowledged = a.channel.GetProgress(*id)->acknowledged;
+    EXPECT_GT(acknowledged, 0u);
+    EXPECT_LE(acknowledged, 600u);
+
+    a.channel.OnReconnected();
+    Exchange(a, b);
+    ASSERT_EQ(b.completed.size(), 1u);
+    EXPECT_EQ(b.completed[0], blob);
+
+    const auto sender = a.channel.GetStatistics();
+    EXPECT_EQ(sender.resumed, 1u);
+    // Only what was lost in flight is sent twice, not the verified 600 bytes
+    EXPECT_EQ(sender.chunks_sent, 20u);
+    EXPECT_LE(sender.chunks_resent, 4u);
+}
+
+TEST(BulkTransferTest, RefusedSendsAreRetriedOnPoll) {
+    Endpoint a(SmallChunks());
+    Endpoint b(SmallChunks());
+    a.accepting = false;
+    const auto blob = Blob(300);
+    ASSERT_TRUE(a.channel.Send(blob).has_value());
+    EXPECT_TRUE(a.sent.empty());
+
+    a.accepting = true;
+    a.channel.Poll();
+    Exchange(a, b);
+    ASSERT_EQ(b.completed.size(), 1u);
+    EXPECT_EQ(b.completed[0], blob);
+}
+
+TEST(BulkTransferTest, OversizedOffersAreRefusedAndCancelDropsBothEnds) {
+    BulkTransferConfig small = SmallChunks();
+    small.max_transfer_size = 500;
+    Endpoint a(SmallChunks());
+    Endpoint b(small);
+    EXPECT_FALSE(a.channel.Send({}).has_value());
+
+    const auto refused = a.channel.Send(Blob(501));
+    ASSERT_TRUE(refused.has_value());
+    Exchange(a, b);
+    EXPECT_FALSE(a.channel.GetProgress(*refused).has_value());
+    EXPECT_EQ(a.channel.GetStatistics().transfers_refused, 1u);
+
+    const auto cancelled = a.channel.Send(Blob(400));
+    ASSERT_TRUE(cancelled.has_value());
+    // The sender gives up with the second half still on its way
+    Exchange(a, b, [&](Message& message) {
+        if (message[0] == TYPE_CHUNK && message[5] == 44) {
+            a.channel.Cancel(*cancelled);
+            return false;
+        }
+        return true;
+    });
+    EXPECT_EQ(a.channel.GetOutgoingCount(), 0u);
+    EXPECT_TRUE(b.completed.empty());
+
+    // Later transfers are unaffected
+    const auto again = a.channel.Send(Blob(300));
+    ASSERT_TRUE(again.has_value());
+    Exchange(a, b);
+    ASSERT_EQ(b.completed.size(), 1u);
+    EXPECT_EQ(b.completed[0], Blob(300));
+}
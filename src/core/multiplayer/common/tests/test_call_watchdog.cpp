@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core/multiplayer/common/call_watchdog.h"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <thread>
+
+using namespace Core::Multiplayer;
+using namespace std::chrono_literals;
+
+namespace {
+
+void FastCall(CallWatchdog& watchdog) {
+    const auto watch = watchdog.Watch("Test::Fast");
+}
+
+void SlowCall(CallWatchdog& watchdog, const char* name = "Test::Slow") {
+    const auto watch = watchdog.Watch(name);
+    std::this_thread::sleep_for(2ms);
+}
+
+} // namespace
+
+TEST(CallWatchdogTest, CountsCallsUnderThresholdWithoutRecording) {
+    CallWatchdog watchdog;
+    for (int i = 0; i < 100; ++i) {
+        FastCall(watchdog);
+    }
+    const auto stats = watchdog.GetStatistics();
+    EXPECT_EQ(stats.calls, 100u);
+    EXPECT_EQ(stats.slow_calls, 0u);
+    EXPECT_TRUE(watchdog.GetSlowCalls().empty());
+}
+
+TEST(CallWatchdogTest, RecordsCallsOverThreshold) {
+    CallWatchdog watchdog;
+    watchdog.SetThreshold(1ms);
+    FastCall(watchdog);
+    SlowCall(watchdog);
+
+    const auto records = watchdog.GetSlowCalls();
+    ASSERT_EQ(records.size(), 1u);
+    EXPECT_STREQ(records[0].call, "Test::Slow");
+    EXPECT_GE(records[0].duration, 2ms);
+    EXPECT_NE(records[0].started_at_ns, 0u);
+#if __has_include(<execinfo.h>)
+    EXPECT_GT(records[0].stack_depth, 0u);
+#endif
+
+    const auto stats = watchdog.GetStatistics();
+    EXPECT_EQ(stats.calls, 2u);
+    EXPECT_EQ(stats.slow_calls, 1u);
+    EXPECT_STREQ(stats.worst_call, "Test::Slow");
+}
+
+TEST(CallWatchdogTest, ThresholdIsConfigurable) {
+    CallWatchdog watchdog;
+    EXPECT_EQ(watchdog.GetThreshold(), CallWatchdog::DEFAULT_THRESHOLD);
+    watchdog.SetThreshold(1s);
+    SlowCall(watchdog);
+    EXPECT_EQ(watchdog.GetStatistics().slow_calls, 0u);
+
+    watchdog.SetThreshold(0ns);
+    FastCall(watchdog);
+    EXPECT_EQ(watchdog.GetStatistics().slow_calls, 1u);
+}
+
+TEST(CallWatchdogTest, RingKeepsTheLatestRecords) {
+    CallWatchdog watchdog;
+    watchdog.SetThreshold(0ns);
+    const char* first = "Test::First";
+    const char* later = "Test::Later";
+    {
+        const auto watch = watchdog.Watch(first);
+    }
+    for (size_t i = 0; i < CallWatchdog::RECORD_CAPACITY; ++i) {
+        const auto watch = watchdog.Watch(later);
+    }
+
+    const auto records = watchdog.GetSlowCalls();
+    ASSERT_EQ(records.size(), CallWatchdog::RECORD_CAPACITY);
+    for (const auto& record : records) {
+        EXPECT_EQ(record.call, later);
+    }
+    for (size_t i = 1; i < records.size(); ++i) {
+        EXPECT_LE(records[i - 1].started_at_ns, records[i].started_at_ns);
+    }
+    EXPECT_EQ(watchdog.GetStatistics().slow_calls, CallWatchdog::RECORD_CAPACITY + 1);
+}
+
+TEST(CallWatchdogTest, ResetClearsEverything) {
+    CallWatchdog watchdog;
+    watchdog.SetThreshold(1ms);
+    SlowCall(watchdog);
+    watchdog.Reset();
+
+    const auto stats = watchdog.GetStatistics();
+    EXPECT_EQ(stats.calls, 0u);
+    EXPECT_EQ(stats.slow_calls, 0u);
+    EXPECT_EQ(stats.worst_call, nullptr);
+    EXPECT_TRUE(watchdog.GetSlowCalls().empty());
+}
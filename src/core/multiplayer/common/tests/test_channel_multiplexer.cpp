@@ -0,0 +1,231 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "core/multiplayer/common/channel_multiplexer.h"
+
+using namespace Core::Multiplayer;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr uint8_t RELIABLE = 0;
+constexpr uint8_t UNRELIABLE = 1;
+constexpr uint8_t SEQUENCED = 2;
+
+using Frame = std::vector<uint8_t>;
+
+struct Delivered {
+    uint8_t channel;
+    std::vector<uint8_t> payload;
+
+    bool operator==(const Delivered&) const = default;
+};
+
+// One end of a connection whose frames the test carries by hand
+struct Endpoint {
+    explicit Endpoint(const ChannelConfig& config)
+        : multiplexer(
+              config,
+              [this](std::span<const uint8_t> frame) {
+                  sent.emplace_back(frame.begin(), frame.end());
+                  return true;
+              },
+              [this](uint8_t channel, std::span<const uint8_t> payload) {
+                  delivered.push_back({channel, {payload.begin(), payload.end()}});
+              }) {}
+
+    std::vector<Frame> TakeSent() { return std::exchange(sent, {}); }
+
+    std::vector<Frame> sent;
+    std::vector<Delivered> delivered;
+    ChannelMultiplexer multiplexer;
+};
+
+ChannelConfig ManualConfig() {
+    ChannelConfig config;
+    config.poll_interval = 0ms;
+    return config;
+}
+
+bool Send(Endpoint& endpoint, uint8_t channel, uint8_t value) {
+    const std::vector<uint8_t> payload{value};
+    return endpoint.multiplexer.Send(channel, payload);
+}
+
+} // namespace
+
+TEST(ChannelMultiplexerTest, ReliableMessagesSurviveLossAndReordering) {
+    Endpoint a(ManualConfig());
+    Endpoint b(ManualConfig());
+    for (uint8_t i = 0; i < 5; ++i) {
+        ASSERT_TRUE(Send(a, RELIABLE, i));
+    }
+    auto frames = a.TakeSent();
+    ASSERT_EQ(frames.size(), 5u);
+
+    // Message 1 is lost, the rest arrive backwards
+    for (const size_t index : {4u, 3u, 2u, 0u}) {
+        b.multiplexer.Receive(frames[index]);
+    }
+    ASSERT_EQ(b.delivered.size(), 1u);
+    EXPECT_EQ(b.delivered[0], (Delivered{RELIABLE, {0}}));
+
+    // Nothing to ride on, so the ack goes out alone once it is due
+    const auto start = ChannelMultiplexer::Clock::now();
+    b.multiplexer.Poll(start + 1s);
+    auto acks = b.TakeSent();
+    ASSERT_EQ(acks.size(), 1u);
+    a.multiplexer.Receive(acks[0]);
+    EXPECT_EQ(a.multiplexer.GetUnackedCount(), 1u);
+
+    a.multiplexer.Poll(start + 2s);
+    frames = a.TakeSent();
+    ASSERT_EQ(frames.size(), 1u);
+    b.multiplexer.Receive(frames[0]);
+    ASSERT_EQ(b.delivered.size(), 5u);
+    for (uint8_t i = 0; i < 5; ++i) {
+        EXPECT_EQ(b.delivered[i].payload, std::vector<uint8_t>{i});
+    }
+
+    b.multiplexer.Poll(start + 3s);
+    for (const auto& ack : b.TakeSent()) {
+        a.multiplexer.Receive(ack);
+    }
+    EXPECT_EQ(a.multiplexer.GetUnackedCount(), 0u);
+    EXPECT_EQ(a.multiplexer.GetStatistics().retransmits, 1u);
+    EXPECT_EQ(b.multiplexer.GetStatistics().acks_sent, 2u);
+}
+
+TEST(ChannelMultiplexerTest, AcksRideOnOutgoingPackets) {
+    Endpoint a(ManualConfig());
+    Endpoint b(ManualConfig());
+    ASSERT_TRUE(Send(a, RELIABLE, 1));
+    b.multiplexer.Receive(a.TakeSent()[0]);
+
+    // Any channel carries it
+    ASSERT_TRUE(Send(b, UNRELIABLE, 2));
+    const auto frames = b.TakeSent();
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_EQ(frames[0].size(), 1 + ChannelMultiplexer::ACK_SIZE + 1);
+    a.multiplexer.Receive(frames[0]);
+
+    EXPECT_EQ(a.multiplexer.GetUnackedCount(), 0u);
+    EXPECT_EQ(a.delivered, (std::vector<Delivered>{{UNRELIABLE, {2}}}));
+    EXPECT_TRUE(a.multiplexer.GetRttEstimator().HasSamples());
+    EXPECT_EQ(b.multiplexer.GetStatistics().acks_piggybacked, 1u);
+
+    // Owed nothing now, so nothing goes out alone
+    b.multiplexer.Poll(ChannelMultiplexer::Clock::now() + 1s);
+    EXPECT_TRUE(b.TakeSent().empty());
+}
+
+TEST(ChannelMultiplexerTest, AcksNeverRideOnBulkFrames) {
+    ChannelConfig config = ManualConfig();
+    config.priorities = {SendPriority::Bulk};
+    Endpoint a(config);
+    Endpoint b(config);
+    ASSERT_TRUE(Send(a, UNRELIABLE, 1));
+    ASSERT_TRUE(Send(a, RELIABLE, 1));
+    const auto data = a.TakeSent();
+    EXPECT_EQ(ChannelMultiplexer::FramePriority(config, data[0]), SendPriority::Realtime);
+    EXPECT_EQ(ChannelMultiplexer::FramePriority(config, data[1]), SendPriority::Bulk);
+    b.multiplexer.Receive(data[1]);
+
+    // The bulk frame goes out bare; the ack follows alone, as control
+    ASSERT_TRUE(Send(b, RELIABLE, 2));
+    auto frames = b.TakeSent();
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_EQ(frames[0].size(), 1 + ChannelMultiplexer::SEQUENCE_SIZE + 1);
+    b.multiplexer.Poll(ChannelMultiplexer::Clock::now() + 100ms);
+    frames = b.TakeSent();
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_EQ(ChannelMultiplexer::FramePriority(config, frames[0]), SendPriority::Control);
+    EXPECT_EQ(b.multiplexer.GetStatistics().acks_piggybacked, 0u);
+    EXPECT_EQ(b.multiplexer.GetStatistics().acks_sent, 1u);
+}
+
+TEST(ChannelMultiplexerTest, DuplicateReliableMessageIsAckedAgain) {
+    Endpoint a(ManualConfig());
+    Endpoint b(ManualConfig());
+    ASSERT_TRUE(Send(a, RELIABLE, 1));
+    const auto frame = a.TakeSent()[0];
+    b.multiplexer.Receive(frame);
+    b.multiplexer.Poll(ChannelMultiplexer::Clock::now() + 1s);
+    b.TakeSent(); // The ack is lost
+
+    b.multiplexer.Receive(frame);
+    EXPECT_EQ(b.delivered.size(), 1u);
+    EXPECT_EQ(b.multiplexer.GetStatistics().duplicates, 1u);
+    b.multiplexer.Poll(ChannelMultiplexer::Clock::now() + 1s);
+    const auto acks = b.TakeSent();
+    ASSERT_EQ(acks.size(), 1u);
+    a.multiplexer.Receive(acks[0]);
+    EXPECT_EQ(a.multiplexer.GetUnackedCount(), 0u);
+}
+
+TEST(ChannelMultiplexerTest, SequencedChannelDropsOlderPackets) {
+    Endpoint a(ManualConfig());
+    Endpoint b(ManualConfig());
+    for (uint8_t i = 0; i < 3; ++i) {
+        ASSERT_TRUE(Send(a, SEQUENCED, i));
+    }
+    const auto frames = a.TakeSent();
+    for (const size_t index : {0u, 2u, 1u, 2u}) {
+        b.multiplexer.Receive(frames[index]);
+    }
+    EXPECT_EQ(b.delivered, (std::vector<Delivered>{{SEQUENCED, {0}}, {SEQUENCED, {2}}}));
+    EXPECT_EQ(b.multiplexer.GetStatistics().stale, 2u);
+}
+
+TEST(ChannelMultiplexerTest, UnreliableChannelPassesEverythingThrough) {
+    Endpoint a(ManualConfig());
+    Endpoint b(ManualConfig());
+    ASSERT_TRUE(Send(a, UNRELIABLE, 1));
+    ASSERT_TRUE(Send(a, UNRELIABLE, 2));
+    const auto frames = a.TakeSent();
+    EXPECT_EQ(frames[0].size(), 2u);
+    for (const size_t index : {1u, 0u, 0u}) {
+        b.multiplexer.Receive(frames[index]);
+    }
+    EXPECT_EQ(b.delivered.size(), 3u);
+    EXPECT_EQ(a.multiplexer.GetUnackedCount(), 0u);
+}
+
+TEST(ChannelMultiplexerTest, FullWindowRefusesAndExhaustedRetransmitsFail) {
+    ChannelConfig config = ManualConfig();
+    config.max_retransmits = 1;
+    Endpoint a(config);
+    for (uint16_t i = 0; i < ChannelMultiplexer::WINDOW; ++i) {
+        ASSERT_TRUE(Send(a, RELIABLE, static_cast<uint8_t>(i)));
+    }
+    EXPECT_FALSE(Send(a, RELIABLE, 0));
+    EXPECT_EQ(a.multiplexer.GetStatistics().window_full, 1u);
+    a.TakeSent();
+
+    const auto start = ChannelMultiplexer::Clock::now();
+    a.multiplexer.Poll(start + 10s);
+    EXPECT_EQ(a.TakeSent().size(), ChannelMultiplexer::WINDOW);
+    EXPECT_FALSE(a.multiplexer.IsFailed());
+    a.multiplexer.Poll(start + 100s);
+    EXPECT_TRUE(a.TakeSent().empty());
+    EXPECT_TRUE(a.multiplexer.IsFailed());
+    // Unreliable channels still work
+    EXPECT_TRUE(Send(a, UNRELIABLE, 0));
+}
+
+TEST(ChannelMultiplexerTest, MalformedFramesAreDropped) {
+    Endpoint b(ManualConfig());
+    b.multiplexer.Receive(Frame{});
+    b.multiplexer.Receive(Frame{0x0F, 1});                           // Unknown channel
+    b.multiplexer.Receive(Frame{RELIABLE, 1});                       // Short sequence
+    b.multiplexer.Receive(Frame{ChannelMultiplexer::FLAG_ACK_ONLY}); // Ack-only without ack
+    EXPECT_TRUE(b.delivered.empty());
+    EXPECT_EQ(b.multiplexer.GetStatistics().malformed, 4u);
+}
@@ -0,0 +1,151 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core/multiplayer/common/circuit_breaker.h"
+#include <gtest/gtest.h>
+
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Core::Multiplayer;
+
+TEST(CircuitBreakerWindowTest, WindowHoldsTheLastCalls) {
+    CircuitBreakerConfig config;
+    config.failure_threshold = 100;
+    config.sliding_window_size = 4;
+    CircuitBreaker breaker(config);
+
+    for (int i = 0; i < 6; ++i) {
+        breaker.Execute([] { return ErrorCode::NetworkTimeout; });
+    }
+    breaker.Execute([] { return ErrorCode::Success; });
+
+    const auto metrics = breaker.GetMetrics();
+    EXPECT_EQ(metrics.total_requests, 7u);
+    EXPECT_EQ(metrics.failed_requests, 6u);
+    EXPECT_EQ(metrics.consecutive_failures, 0u);
+    EXPECT_EQ(metrics.window_requests, 4u);
+    EXPECT_EQ(metrics.window_failures, 3u);
+    EXPECT_DOUBLE_EQ(metrics.window_failure_rate, 0.75);
+}
+
+TEST(CircuitBreakerWindowTest, ExceptionsCountAsFailures) {
+    CircuitBreakerConfig config;
+    config.failure_threshold = 1;
+    CircuitBreaker breaker(config);
+
+    EXPECT_EQ(breaker.Execute([]() -> ErrorCode { throw std::runtime_error("boom"); }),
+              ErrorCode::InternalError);
+    EXPECT_EQ(breaker.GetState(), CircuitBreakerState::Open);
+    EXPECT_EQ(breaker.Execute([] { return ErrorCode::Success; }), ErrorCode::ServiceUnavailable);
+    EXPECT_EQ(breaker.GetMetrics().rejected_requests, 1u);
+}
+
+TEST(CircuitBreakerWindowTest, ConcurrentCallsAreAllCounted) {
+    CircuitBreakerConfig config;
+    config.failure_threshold = 1000000;
+    CircuitBreaker breaker(config);
+    constexpr int THREADS = 8;
+    constexpr int CALLS = 20000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&breaker, t] {
+            for (int i = 0; i < CALLS; ++i) {
+                breaker.Execute([&] {
+                    return (i + t) % 4 == 0 ? ErrorCode::NetworkTimeout : ErrorCode::Success;
+                });
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const auto metrics = breaker.GetMetrics();
+    EXPECT_EQ(metrics.total_requests, static_cast<size_t>(THREADS) * CALLS);
+    EXPECT_EQ(metrics.failed_requests, static_cast<size_t>(THREADS) * CALLS / 4);
+    EXPECT_EQ(breaker.GetState(), CircuitBreakerState::Closed);
+}
+
+TEST(CircuitBreakerWindowTest, HalfOpenAdmitsLimitedTrials) {
+    CircuitBreakerConfig config;
+    config.max_concurrent_half_open_calls = 1;
+    config.success_threshold_for_close = 1;
+    CircuitBreaker breaker(config);
+    breaker.ForceHalfOpen();
+
+    // A second call while the trial is still running is turned away
+    ErrorCode nested = ErrorCode::Success;
+    breaker.Execute([&] {
+        nested = breaker.Execute([] { return ErrorCode::Success; });
+        return ErrorCode::Success;
+    });
+    EXPECT_EQ(nested, ErrorCode::ServiceUnavailable);
+    EXPECT_EQ(breaker.GetState(), CircuitBreakerState::Closed);
+}
+
+TEST(CircuitBreakerRegistryTest, InternsEndpointsPerScope) {
+    CircuitBreakerRegistry registry;
+    CircuitBreakerConfig relay_config;
+    relay_config.failure_threshold = 1;
+    registry.SetScopeConfig(CircuitBreakerScope::Relay, relay_config);
+
+    const auto relay = registry.Intern(CircuitBreakerScope::Relay, "relay.example:443");
+    const auto room = registry.Intern(CircuitBreakerScope::RoomServer, "relay.example:443");
+    ASSERT_TRUE(relay && room);
+    EXPECT_NE(*relay, *room);
+    EXPECT_EQ(registry.Intern(CircuitBreakerScope::Relay, "relay.example:443"), relay);
+    EXPECT_EQ(registry.GetName(*relay), "relay:relay.example:443");
+    EXPECT_EQ(registry.GetName(*room), "room:relay.example:443");
+    EXPECT_EQ(registry.Size(), 2u);
+
+    // Each endpoint trips on its own, with its scope's config
+    registry.Get(*relay).Execute([] { return ErrorCode::ConnectionRefused; });
+    registry.Get(*room).Execute([] { return ErrorCode::ConnectionRefused; });
+    EXPECT_EQ(registry.Get(*relay).GetState(), CircuitBreakerState::Open);
+    EXPECT_EQ(registry.Get(*room).GetState(), CircuitBreakerState::Closed);
+
+    std::set<std::string> names;
+    registry.ForEach([&](const std::string& name, const CircuitBreaker&) { names.insert(name); });
+    EXPECT_EQ(names.size(), 2u);
+}
+
+TEST(CircuitBreakerRegistryTest, BreakersStayPutAsTheRegistryGrows) {
+    CircuitBreakerRegistry registry;
+    const auto first = registry.Intern(CircuitBreakerScope::Relay, "relay0");
+    ASSERT_TRUE(first);
+    CircuitBreaker* breaker = &registry.Get(*first);
+
+    for (size_t i = 1; i < CircuitBreakerRegistry::SEGMENT_SIZE * 3; ++i) {
+        const auto key = registry.Intern(CircuitBreakerScope::Relay, "relay" + std::to_string(i));
+        ASSERT_TRUE(key);
+        EXPECT_EQ(*key, i);
+    }
+    EXPECT_EQ(&registry.Get(*first), breaker);
+}
+
+// Components/CircuitBreaker/WrappedSend in the component benchmarks times this
+TEST(CircuitBreakerRegistryTest, WrappedSendsRunAndAreCounted) {
+    constexpr int SENDS = 1000;
+    CircuitBreakerRegistry registry;
+    const auto key = registry.Intern(CircuitBreakerScope::Relay, "relay.example:443");
+    ASSERT_TRUE(key);
+
+    int sent = 0;
+    const auto send = [&sent] {
+        ++sent;
+        return ErrorCode::Success;
+    };
+    for (int i = 0; i < SENDS; ++i) {
+        EXPECT_EQ(registry.Get(*key).Execute(send), ErrorCode::Success);
+    }
+
+    EXPECT_EQ(sent, SENDS);
+    const auto metrics = registry.Get(*key).GetMetrics();
+    EXPECT_EQ(metrics.total_requests, static_cast<size_t>(SENDS));
+    EXPECT_EQ(metrics.failed_requests, 0u);
+    EXPECT_EQ(registry.Get(*key).GetState(), CircuitBreakerState::Closed);
+}
@@ -0,0 +1,160 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core/multiplayer/common/clock_sync.h"
+#include <gtest/gtest.h>
+#include <cstdlib>
+
+using namespace Core::Multiplayer;
+using namespace std::chrono_literals;
+
+namespace {
+
+// A peer whose clock reads offset_us ahead of ours and gains drift_ppm
+struct SimulatedPeer {
+    int64_t offset_us = 0;
+    double drift_ppm = 0.0;
+
+    uint64_t RemoteTime(uint64_t local_us) const {
+        return static_cast<uint64_t>(static_cast<int64_t>(local_us) + offset_us +
+                                     static_cast<int64_t>(drift_ppm * local_us / 1e6));
+    }
+
+    ClockSyncSample Exchange(uint64_t local_send_us, uint64_t outbound_us, uint64_t inbound_us,
+                             uint64_t turnaround_us = 0) const {
+        const uint64_t arrival = local_send_us + outbound_us;
+        return {local_send_us, RemoteTime(arrival), RemoteTime(arrival + turnaround_us),
+                arrival + turnaround_us + inbound_us};
+    }
+};
+
+constexpr uint64_t START_US = 1'000'000'000;
+
+} // namespace
+
+TEST(ClockSyncTest, NothingBeforeTheFirstSample) {
+    ClockSyncEstimator estimator;
+    const ClockSyncSnapshot snapshot = estimator.GetSnapshot();
+    EXPECT_FALSE(snapshot.IsSynchronized());
+    EXPECT_EQ(snapshot.confidence, 0.0f);
+    EXPECT_FALSE(estimator.ToLocalTime(START_US).has_value());
+    EXPECT_FALSE(estimator.GetOneWayDelay(START_US, START_US).has_value());
+}
+
+TEST(ClockSyncTest, SymmetricPathGivesTheExactOffset) {
+    const SimulatedPeer peer{-250'000, 0.0};
+    ClockSyncEstimator estimator;
+    ASSERT_TRUE(estimator.AddSample(peer.Exchange(START_US, 10'000, 10'000, 300)));
+
+    const ClockSyncSnapshot snapshot = estimator.GetSnapshot();
+    EXPECT_TRUE(snapshot.IsSynchronized());
+    EXPECT_EQ(snapshot.offset, -250'000us);
+    EXPECT_EQ(snapshot.error_bound, 10'000us);
+    EXPECT_EQ(snapshot.outbound_delay, 10'000us);
+    EXPECT_EQ(snapshot.inbound_delay, 10'000us);
+    EXPECT_GT(snapshot.confidence, 0.0f);
+
+    // A frame the peer stamped now arrives 10ms later on our clock
+    const uint64_t sent = START_US + 1'000'000;
+    EXPECT_EQ(estimator.ToLocalTime(peer.RemoteTime(sent)), sent);
+    EXPECT_EQ(estimator.GetOneWayDelay(peer.RemoteTime(sent), sent + 10'000), 10'000us);
+}
+
+TEST(ClockSyncTest, FollowsTheLowestDelaySample) {
+    const SimulatedPeer peer{40'000, 0.0};
+    ClockSyncEstimator estimator;
+    // Queueing on the way out skews a sample's offset by half the excess
+    ASSERT_TRUE(estimator.AddSample(peer.Exchange(START_US, 3'000, 1'000)));
+    ASSERT_TRUE(estimator.AddSample(peer.Exchange(START_US + 100'000, 1'000, 1'000)));
+    ASSERT_TRUE(estimator.AddSample(peer.Exchange(START_US + 200'000, 1'000, 2'500)));
+
+    const ClockSyncSnapshot snapshot = estimator.GetSnapshot();
+    EXPECT_EQ(snapshot.offset, 40'000us);
+    EXPECT_EQ(snapshot.sample_count, 3u);
+    EXPECT_EQ(snapshot.rejected_count, 0u);
+}
+
+TEST(ClockSyncTest, DelaySpikesAreRejected) {
+    const SimulatedPeer peer{5'000, 0.0};
+    ClockSyncEstimator estimator;
+    for (uint64_t i = 0; i < 4; ++i) {
+        ASSERT_TRUE(estimator.AddSample(peer.Exchange(START_US + i * 250'000, 2'000, 2'000)));
+    }
+    const ClockSyncSnapshot before = estimator.GetSnapshot();
+
+    // Bufferbloat on one direction only, which would move the offset by 40ms
+    EXPECT_FALSE(estimator.AddSample(peer.Exchange(START_US + 1'000'000, 82'000, 2'000)));
+    const ClockSyncSnapshot after = estimator.GetSnapshot();
+    EXPECT_EQ(after.offset, before.offset);
+    EXPECT_EQ(after.outbound_delay, before.outbound_delay);
+    EXPECT_EQ(after.rejected_count, 1u);
+    EXPECT_EQ(after.sample_count, 4u);
+
+    // Malformed exchanges never count
+    EXPECT_FALSE(estimator.AddSample({START_US, START_US, START_US, START_US - 1}));
+    EXPECT_FALSE(estimator.AddSample({START_US, START_US + 10, START_US, START_US + 5}));
+    EXPECT_EQ(estimator.GetSnapshot().rejected_count, 3u);
+}
+
+TEST(ClockSyncTest, ALastingPathChangeIsAdoptedAfterHalfAWindow) {
+    const SimulatedPeer peer{0, 0.0};
+    ClockSyncEstimator estimator;
+    for (uint64_t i = 0; i < 4; ++i) {
+        ASSERT_TRUE(estimator.AddSample(peer.Exchange(START_US + i * 250'000, 2'000, 2'000)));
+    }
+
+    // The peer moved from a direct path to a relay far away
+    uint64_t now = START_US + 1'000'000;
+    size_t rejected = 0;
+    while (!estimator.AddSample(peer.Exchange(now, 60'000, 40'000))) {
+        ++rejected;
+        now += 250'000;
+    }
+    EXPECT_EQ(rejected, ClockSyncEstimator::WINDOW / 2 - 1);
+
+    const ClockSyncSnapshot snapshot = estimator.GetSnapshot();
+    // Asymmetry is invisible to two-way timing: the offset is off by half of it
+    EXPECT_EQ(snapshot.offset, 10'000us);
+    EXPECT_GE(snapshot.error_bound, 50'000us);
+    EXPECT_EQ(snapshot.outbound_delay + snapshot.inbound_delay, 100'000us);
+}
+
+TEST(ClockSyncTest, DriftIsEstimatedAndApplied) {
+    const SimulatedPeer peer{1'000'000, 80.0};
+    ClockSyncEstimator estimator;
+    uint64_t now = START_US;
+    for (size_t i = 0; i < ClockSyncEstimator::WINDOW; ++i) {
+        // Jitter that is not a spike, so the filter keeps every sample
+        const uint64_t jitter = (i * 7) % 3 * 300;
+        ASSERT_TRUE(estimator.AddSample(peer.Exchange(now, 5'000 + jitter, 5'000)));
+        now += 1'000'000;
+    }
+
+    const ClockSyncSnapshot snapshot = estimator.GetSnapshot();
+    EXPECT_NEAR(snapshot.drift_ppm, 80.0, 60.0);
+    EXPECT_EQ(snapshot.sample_count, ClockSyncEstimator::WINDOW);
+
+    // A minute on, the drift correction keeps the prediction close
+    const uint64_t later = now + 60'000'000;
+    const int64_t truth = static_cast<int64_t>(peer.RemoteTime(later) - later);
+    EXPECT_LT(std::llabs(snapshot.OffsetAt(later).count() - truth), 5'000);
+}
+
+TEST(ClockSyncTest, ConfidenceGrowsWithTightSamples) {
+    const SimulatedPeer peer{0, 0.0};
+    ClockSyncEstimator loose;
+    ClockSyncEstimator tight;
+    for (uint64_t i = 0; i < ClockSyncEstimator::WINDOW; ++i) {
+        loose.AddSample(peer.Exchange(START_US + i * 100'000, 30'000, 30'000));
+        tight.AddSample(peer.Exchange(START_US + i * 100'000, 300, 300));
+    }
+    EXPECT_LT(loose.GetSnapshot().confidence, tight.GetSnapshot().confidence);
+    EXPECT_GT(tight.GetSnapshot().confidence, 0.5f);
+
+    ClockSyncEstimator single;
+    single.AddSample(peer.Exchange(START_US, 300, 300));
+    EXPECT_LT(single.GetSnapshot().confidence, tight.GetSnapshot().confidence);
+
+    tight.Reset();
+    EXPECT_FALSE(tight.GetSnapshot().IsSynchronized());
+}
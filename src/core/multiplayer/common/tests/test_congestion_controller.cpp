@@ -0,0 +1,95 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core/multiplayer/common/congestion_controller.h"
+#include <gtest/gtest.h>
+
+using namespace Core::Multiplayer;
+using namespace std::chrono_literals;
+
+namespace {
+CongestionControlConfig TestConfig() {
+    CongestionControlConfig config;
+    config.target_delay = 20ms;
+    config.initial_rate = 100'000;
+    config.min_rate = 10'000;
+    config.max_rate = 1'000'000;
+    config.additive_increase = 10'000;
+    config.max_decrease = 0.5;
+    config.base_delay_window = 10s;
+    return config;
+}
+} // namespace
+
+TEST(DelayBasedControllerTest, GrowsWhileQueuesAreEmpty) {
+    DelayBasedController controller(TestConfig());
+    const auto start = DelayBasedController::Clock::now();
+
+    EXPECT_FALSE(controller.OnRttSample(50ms, start).has_value());
+    EXPECT_EQ(controller.GetRate(), 110'000u);
+    // Half the target: half the increase
+    controller.OnRttSample(60ms, start + 10ms);
+    EXPECT_EQ(controller.GetRate(), 115'000u);
+
+    const auto stats = controller.GetStatistics();
+    EXPECT_EQ(stats.base_delay, 50ms);
+    EXPECT_EQ(stats.queuing_delay, 10ms);
+    EXPECT_FALSE(stats.congested);
+    EXPECT_EQ(stats.sample_count, 2u);
+}
+
+TEST(DelayBasedControllerTest, BacksOffAndHintsWhenDelayBuilds) {
+    DelayBasedController controller(TestConfig());
+    const auto start = DelayBasedController::Clock::now();
+    controller.OnRttSample(50ms, start);
+    const uint64_t rate = controller.GetRate();
+
+    // Twice the target: the full cut, and a hint to reduce
+    const auto hint = controller.OnRttSample(90ms, start + 10ms);
+    ASSERT_TRUE(hint.has_value());
+    EXPECT_TRUE(hint->reduce);
+    EXPECT_EQ(hint->queuing_delay, 40ms);
+    EXPECT_EQ(controller.GetRate(), rate / 2);
+    EXPECT_TRUE(controller.IsCongested());
+
+    // Still congested: no new hint, but the rate keeps falling
+    EXPECT_FALSE(controller.OnRttSample(80ms, start + 20ms).has_value());
+    EXPECT_LT(controller.GetRate(), rate / 2);
+
+    const auto cleared = controller.OnRttSample(55ms, start + 30ms);
+    ASSERT_TRUE(cleared.has_value());
+    EXPECT_FALSE(cleared->reduce);
+    EXPECT_EQ(controller.GetStatistics().reduce_count, 1u);
+}
+
+TEST(DelayBasedControllerTest, RateStaysWithinLimits) {
+    DelayBasedController controller(TestConfig());
+    auto now = DelayBasedController::Clock::now();
+    controller.OnRttSample(10ms, now);
+    for (int i = 0; i < 50; ++i) {
+        now += 10ms;
+        controller.OnRttSample(500ms, now);
+    }
+    EXPECT_EQ(controller.GetRate(), 10'000u);
+
+    for (int i = 0; i < 500; ++i) {
+        now += 10ms;
+        controller.OnRttSample(10ms, now);
+    }
+    EXPECT_EQ(controller.GetRate(), 1'000'000u);
+}
+
+TEST(DelayBasedControllerTest, BaseDelayFollowsARouteChange) {
+    DelayBasedController controller(TestConfig());
+    const auto start = DelayBasedController::Clock::now();
+    controller.OnRttSample(20ms, start);
+
+    // A slower path looks like queuing at first...
+    controller.OnRttSample(80ms, start + 1s);
+    EXPECT_EQ(controller.GetStatistics().queuing_delay, 60ms);
+
+    // ...until the old minimum has left the window
+    controller.OnRttSample(80ms, start + 11s);
+    EXPECT_EQ(controller.GetStatistics().base_delay, 80ms);
+    EXPECT_EQ(controller.GetStatistics().queuing_delay, 0ms);
+}
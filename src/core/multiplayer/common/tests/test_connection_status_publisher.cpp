@@ -0,0 +1,155 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "core/multiplayer/common/connection_status_publisher.h"
+
+using namespace Core::Multiplayer;
+using namespace std::chrono_literals;
+
+namespace {
+
+ConnectionStatusConfig ManualConfig() {
+    ConnectionStatusConfig config;
+    config.sample_interval = 0ms;
+    return config;
+}
+
+// Feeds the publisher one link whose numbers the test sets
+struct Harness {
+    explicit Harness(const ConnectionStatusConfig& config = ManualConfig())
+        : publisher(
+              [this](BackendStats& out_stats) {
+                  if (!available) {
+                      return false;
+                  }
+                  out_stats.node_count = 1;
+                  out_stats.nodes[0].transport = LinkTransport::Direct;
+                  out_stats.nodes[0].rtt = rtt;
+                  out_stats.nodes[0].loss_rate = loss;
+                  return true;
+              },
+              [this](const ConnectionStatus& status) { published.push_back(status); },
+              config) {}
+
+    void SampleAt(std::chrono::microseconds link_rtt,
+                  ConnectionStatusPublisher::Clock::duration at) {
+        rtt = link_rtt;
+        publisher.Sample(start + at);
+    }
+
+    bool available = true;
+    std::chrono::microseconds rtt{0};
+    float loss = 0.0f;
+    std::vector<ConnectionStatus> published;
+    const ConnectionStatusPublisher::Clock::time_point start =
+        ConnectionStatusPublisher::Clock::now();
+    ConnectionStatusPublisher publisher;
+};
+
+} // namespace
+
+TEST(ConnectionStatusPublisherTest, ClassifiesByPingAndLoss) {
+    EXPECT_EQ(ClassifyConnectionQuality(20ms, 0.0f), ConnectionQuality::Excellent);
+    EXPECT_EQ(ClassifyConnectionQuality(20ms, 0.05f), ConnectionQuality::Fair);
+    EXPECT_EQ(ClassifyConnectionQuality(150ms, 0.0f), ConnectionQuality::Fair);
+    EXPECT_EQ(ClassifyConnectionQuality(400ms, 0.0f), ConnectionQuality::Poor);
+}
+
+TEST(ConnectionStatusPublisherTest, SmallPingMovesAreNotPublished) {
+    Harness harness;
+    harness.SampleAt(30ms, 0s);
+    for (int i = 0; i < 100; ++i) {
+        harness.SampleAt(30ms + std::chrono::milliseconds(i % 5), 1s + i * 1s);
+    }
+    ASSERT_EQ(harness.published.size(), 1u);
+    EXPECT_EQ(harness.published[0].ping, 30ms);
+    EXPECT_EQ(harness.published[0].quality, ConnectionQuality::Excellent);
+    EXPECT_EQ(harness.published[0].peer_count, 1u);
+    EXPECT_EQ(harness.publisher.GetStatistics().insignificant, 100u);
+
+    harness.SampleAt(42ms, 200s);
+    ASSERT_EQ(harness.published.size(), 2u);
+    EXPECT_EQ(harness.published[1].ping, 42ms);
+}
+
+TEST(ConnectionStatusPublisherTest, TierOnlyImprovesPastTheMargin) {
+    Harness harness;
+    harness.SampleAt(55ms, 0s);
+    EXPECT_EQ(harness.published.back().quality, ConnectionQuality::Good);
+
+    // Just under the Excellent limit is not enough
+    harness.SampleAt(45ms, 1s);
+    EXPECT_EQ(harness.publisher.GetPublished()->quality, ConnectionQuality::Good);
+
+    harness.SampleAt(35ms, 2s);
+    EXPECT_EQ(harness.publisher.GetPublished()->quality, ConnectionQuality::Excellent);
+
+    // Falling back crosses at the limit itself
+    harness.SampleAt(50ms, 3s);
+    EXPECT_EQ(harness.publisher.GetPublished()->quality, ConnectionQuality::Good);
+}
+
+TEST(ConnectionStatusPublisherTest, PublishRateIsCapped) {
+    Harness harness;
+    harness.SampleAt(30ms, 0ms);
+    harness.SampleAt(80ms, 100ms);
+    harness.SampleAt(90ms, 200ms);
+    EXPECT_EQ(harness.published.size(), 1u);
+    EXPECT_EQ(harness.publisher.GetStatistics().deferred, 2u);
+
+    // The first sample past the interval carries the latest numbers
+    harness.SampleAt(95ms, 500ms);
+    ASSERT_EQ(harness.published.size(), 2u);
+    EXPECT_EQ(harness.published[1].ping, 95ms);
+}
+
+TEST(ConnectionStatusPublisherTest, FailedSamplesAndUnreportedLinksPublishNothingNew) {
+    Harness harness;
+    harness.available = false;
+    harness.SampleAt(30ms, 0s);
+    EXPECT_TRUE(harness.published.empty());
+    EXPECT_EQ(harness.publisher.GetStatistics().failed_samples, 1u);
+
+    BackendStats stats;
+    stats.node_count = 2;
+    const auto status =
+        ConnectionStatusPublisher::Summarize(stats, ConnectionQuality::Unknown, ManualConfig());
+    EXPECT_EQ(status.quality, ConnectionQuality::Unknown);
+    EXPECT_EQ(status.peer_count, 2u);
+}
+
+TEST(ConnectionStatusPublisherTest, SamplesOnTheWheel) {
+    auto wheel = std::make_shared<TimerWheel>(1ms);
+    ConnectionStatusConfig config;
+    config.sample_interval = 5ms;
+    std::mutex mutex;
+    std::condition_variable published;
+    int count = 0;
+    ConnectionStatusPublisher publisher(
+        [](BackendStats& out_stats) {
+            out_stats.node_count = 1;
+            out_stats.nodes[0].transport = LinkTransport::Relay;
+            out_stats.nodes[0].rtt = 120ms;
+            return true;
+        },
+        [&](const ConnectionStatus&) {
+            std::lock_guard lock(mutex);
+            ++count;
+            published.notify_all();
+        },
+        config, wheel);
+    publisher.Start();
+
+    std::unique_lock lock(mutex);
+    EXPECT_TRUE(published.wait_for(lock, 5s, [&] { return count > 0; }));
+    lock.unlock();
+    publisher.Stop();
+    EXPECT_EQ(publisher.GetPublished()->quality, ConnectionQuality::Fair);
+}
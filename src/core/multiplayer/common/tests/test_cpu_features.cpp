@@ -0,0 +1,98 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "core/multiplayer/common/ascii_scan.h"
+#include "core/multiplayer/common/cpu_features.h"
+
+using namespace Core::Multiplayer;
+
+namespace {
+
+using Kernel = int (*)();
+
+int Scalar() {
+    return 0;
+}
+int Sse42() {
+    return 1;
+}
+int Avx2() {
+    return 2;
+}
+
+} // namespace
+
+TEST(CpuFeaturesTest, SelectsTheFirstVariantTheCpuRuns) {
+    const auto select = [](CpuFeatures features) {
+        return SelectKernel<Kernel>({{CpuFeature::Avx2 | CpuFeature::Bmi2, Avx2},
+                                     {CpuFeature::Sse42, Sse42}},
+                                    Scalar, features)();
+    };
+    EXPECT_EQ(select(CpuFeature::Sse2 | CpuFeature::Sse42 | CpuFeature::Avx2 | CpuFeature::Bmi2), 2);
+    // AVX2 alone is not enough for a variant that also needs BMI2
+    EXPECT_EQ(select(CpuFeature::Sse42 | CpuFeature::Avx2), 1);
+    EXPECT_EQ(select(CpuFeature::Neon), 0);
+    EXPECT_EQ(select(CpuFeatures{}), 0);
+}
+
+TEST(CpuFeaturesTest, SetOperations) {
+    const CpuFeatures features = CpuFeature::Sse2 | CpuFeature::Aes | CpuFeature::Pclmul;
+    EXPECT_TRUE(features.Has(CpuFeature::Aes | CpuFeature::Pclmul));
+    EXPECT_FALSE(features.Has(CpuFeature::Aes | CpuFeature::Avx2));
+    EXPECT_TRUE(features.Has(CpuFeature::None));
+    EXPECT_FALSE(features.Without(CpuFeature::Aes).Has(CpuFeature::Aes));
+    EXPECT_EQ(features.ToString(), "sse2 pclmul aes");
+    EXPECT_EQ(CpuFeatures{}.ToString(), "");
+}
+
+TEST(CpuFeaturesTest, DetectionCoversTheCompileTimeBaseline) {
+    const CpuFeatures& features = GetCpuFeatures();
+    EXPECT_EQ(features, CpuFeatures::Detect());
+    EXPECT_EQ(&features, &GetCpuFeatures());
+#if defined(__SSE2__) || defined(_M_X64)
+    EXPECT_TRUE(features.Has(CpuFeature::Sse2));
+#endif
+#if defined(__SSE4_2__)
+    EXPECT_TRUE(features.Has(CpuFeature::Sse42));
+#endif
+#if defined(__AVX2__)
+    EXPECT_TRUE(features.Has(CpuFeature::Avx2));
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+    EXPECT_TRUE(features.Has(CpuFeature::Neon));
+#endif
+}
+
+TEST(AsciiScanTest, VariantsAgreeWithTheBaseline) {
+    // A non-ASCII byte at every position, or none, seen from a few alignments
+    std::mt19937 random(7);
+    std::vector<uint8_t> data(300, 'a');
+    const uint8_t* end = data.data() + data.size();
+    for (size_t position = 0; position <= data.size(); ++position) {
+        if (position < data.size()) {
+            data[position] = static_cast<uint8_t>(0x80 | (random() & 0x7F));
+        }
+        for (const size_t start : {size_t{0}, size_t{1}, size_t{31}}) {
+            if (start > position) {
+                continue;
+            }
+            const uint8_t* begin = data.data() + start;
+            const uint8_t* expected = data.data() + position;
+            EXPECT_EQ(SkipAsciiBaseline(begin, end), expected) << position;
+            EXPECT_EQ(SkipAscii(begin, end), expected) << position;
+#if defined(SUDACHI_MULTIPLAYER_HAS_AVX2_KERNELS)
+            if (GetCpuFeatures().Has(CpuFeature::Avx2)) {
+                EXPECT_EQ(SkipAsciiAvx2(begin, end), expected) << position;
+            }
+#endif
+        }
+        if (position < data.size()) {
+            data[position] = 'a';
+        }
+    }
+}
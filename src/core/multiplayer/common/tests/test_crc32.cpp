@@ -0,0 +1,62 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "core/multiplayer/common/crc32.h"
+
+using namespace Core::Multiplayer;
+
+namespace {
+
+std::span<const uint8_t> Bytes(std::string_view text) {
+    return {reinterpret_cast<const uint8_t*>(text.data()), text.size()};
+}
+
+// Bit at a time, straight from the definition
+uint32_t Reference(std::span<const uint8_t> data) {
+    uint32_t crc = ~0u;
+    for (const uint8_t byte : data) {
+        crc ^= byte;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ ((crc & 1) != 0 ? 0xEDB88320u : 0);
+        }
+    }
+    return ~crc;
+}
+
+} // namespace
+
+TEST(Crc32Test, MatchesTheCheckValues) {
+    EXPECT_EQ(Crc32(Bytes("")), 0u);
+    EXPECT_EQ(Crc32(Bytes("123456789")), 0xCBF43926u);
+    EXPECT_EQ(Crc32(Bytes("Hello")), 0xF7D18982u);
+    EXPECT_EQ(Crc32(Bytes("The quick brown fox jumps over the lazy dog")), 0x414FA339u);
+}
+
+TEST(Crc32Test, MatchesTheReferenceAcrossTheFoldingThresholds) {
+    std::mt19937 rng(11);
+    std::vector<uint8_t> data(2100);
+    for (auto& byte : data) {
+        byte = static_cast<uint8_t>(rng());
+    }
+    // Below, at and past one 64-byte block, with every tail length
+    for (size_t offset = 0; offset < 4; ++offset) {
+        for (size_t size = 0; size <= 300; ++size) {
+            const std::span<const uint8_t> slice(data.data() + offset, size);
+            ASSERT_EQ(Crc32(slice), Reference(slice)) << offset << "+" << size;
+        }
+    }
+    EXPECT_EQ(Crc32(std::span(data).subspan(3)), Reference(std::span(data).subspan(3)));
+}
+
+TEST(Crc32Test, ChainsAcrossCalls) {
+    std::vector<uint8_t> data(1000, 0x5A);
+    data[500] = 1;
+    const std::span<const uint8_t> whole(data);
+    EXPECT_EQ(Crc32(whole.subspan(130), Crc32(whole.first(130))), Crc32(whole));
+}
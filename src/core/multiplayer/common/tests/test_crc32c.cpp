@@ -0,0 +1,62 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "core/multiplayer/common/crc32c.h"
+
+using namespace Core::Multiplayer;
+
+namespace {
+
+std::span<const uint8_t> Bytes(std::string_view text) {
+    return {reinterpret_cast<const uint8_t*>(text.data()), text.size()};
+}
+
+// Bit at a time, straight from the definition
+uint32_t Reference(std::span<const uint8_t> data) {
+    uint32_t crc = ~0u;
+    for (const uint8_t byte : data) {
+        crc ^= byte;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ ((crc & 1) != 0 ? 0x82F63B78u : 0);
+        }
+    }
+    return ~crc;
+}
+
+} // namespace
+
+TEST(Crc32cTest, MatchesTheCheckValues) {
+    EXPECT_EQ(Crc32c(Bytes("")), 0u);
+    EXPECT_EQ(Crc32c(Bytes("123456789")), 0xE3069283u);
+
+    // RFC 3720 B.4: 32 bytes of zeros, and of ones
+    const std::vector<uint8_t> zeros(32, 0x00);
+    const std::vector<uint8_t> ones(32, 0xFF);
+    EXPECT_EQ(Crc32c(zeros), 0x8A9136AAu);
+    EXPECT_EQ(Crc32c(ones), 0x62A8AB43u);
+}
+
+TEST(Crc32cTest, MatchesTheReferenceAtEveryLengthAndAlignment) {
+    std::mt19937 rng(7);
+    std::vector<uint8_t> data(600);
+    for (auto& byte : data) {
+        byte = static_cast<uint8_t>(rng());
+    }
+    for (size_t offset = 0; offset < 8; ++offset) {
+        for (size_t size = 0; size + offset <= data.size(); size += 1 + size / 16) {
+            const std::span<const uint8_t> slice(data.data() + offset, size);
+            ASSERT_EQ(Crc32c(slice), Reference(slice)) << offset << "+" << size;
+        }
+    }
+}
+
+TEST(Crc32cTest, ChainsAcrossCalls) {
+    const auto whole = Bytes("header and payload in two pieces");
+    EXPECT_EQ(Crc32c(whole.subspan(11), Crc32c(whole.first(11))), Crc32c(whole));
+}
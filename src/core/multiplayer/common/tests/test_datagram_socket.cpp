@@ -0,0 +1,338 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core/multiplayer/common/datagram_socket.h"
+#include "core/multiplayer/common/registered_io.h"
+#include <gtest/gtest.h>
+#include <array>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using namespace Core::Multiplayer;
+
+namespace {
+
+class DatagramSocketTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_EQ(receiver.Open("127.0.0.1", 0), ErrorCode::Success);
+        ASSERT_EQ(sender.Open("127.0.0.1", 0), ErrorCode::Success);
+        destination = receiver.GetLocalEndpoint();
+        ASSERT_TRUE(destination.IsValid());
+        ASSERT_NE(destination.Port(), 0);
+    }
+
+    // Sends count datagrams of the given size, byte i of datagram n being n + i
+    void SendNumbered(size_t count, size_t size) {
+        payloads.assign(count, std::vector<uint8_t>(size));
+        std::vector<OutgoingDatagram> datagrams(count);
+        for (size_t n = 0; n < count; ++n) {
+            for (size_t i = 0; i < size; ++i) {
+                payloads[n][i] = static_cast<uint8_t>(n + i);
+            }
+            datagrams[n].data = payloads[n].data();
+            datagrams[n].size = size;
+            datagrams[n].to = &destination;
+        }
+        ASSERT_EQ(sender.SendBatch(datagrams.data(), count), count);
+    }
+
+    DatagramSocket receiver;
+    DatagramSocket sender;
+    DatagramEndpoint destination;
+    std::vector<std::vector<uint8_t>> payloads;
+};
+
+} // namespace
+
+TEST_F(DatagramSocketTest, ReceivesABatchInOneCall) {
+    SendNumbered(16, 64);
+    ASSERT_TRUE(receiver.WaitReadable(std::chrono::milliseconds(1000)));
+
+    std::array<std::array<uint8_t, 128>, 16> buffers{};
+    std::array<DatagramReceiveSlot, 16> slots{};
+    for (size_t i = 0; i < slots.size(); ++i) {
+        slots[i].buffer = buffers[i].data();
+        slots[i].capacity = buffers[i].size();
+    }
+
+    size_t received = 0;
+    while (received < slots.size() && receiver.WaitReadable(std::chrono::milliseconds(1000))) {
+        received += receiver.ReceiveBatch(slots.data() + received, slots.size() - received);
+    }
+    ASSERT_EQ(received, slots.size());
+
+    const DatagramEndpoint source = sender.GetLocalEndpoint();
+    for (size_t n = 0; n < received; ++n) {
+        EXPECT_EQ(slots[n].size, 64u);
+        EXPECT_FALSE(slots[n].truncated);
+        EXPECT_EQ(slots[n].from, source);
+        EXPECT_TRUE(std::equal(payloads[n].begin(), payloads[n].end(), buffers[n].begin()));
+    }
+
+    const auto statistics = receiver.GetStatistics();
+    EXPECT_EQ(statistics.datagrams_received, 16u);
+#ifdef __linux__
+    // Loopback delivers synchronously, so one recvmmsg collects everything
+    EXPECT_EQ(statistics.receive_calls, 1u);
+    EXPECT_EQ(sender.GetStatistics().send_calls, 1u);
+#endif
+}
+
+TEST_F(DatagramSocketTest, ReceivesIntoPacketPool) {
+    PacketPool pool(8);
+    SendNumbered(4, 100);
+    ASSERT_TRUE(receiver.WaitReadable(std::chrono::milliseconds(1000)));
+
+    std::array<ReceivedDatagram, 8> out{};
+    const size_t received = receiver.ReceiveBatch(pool, out.data(), out.size());
+    ASSERT_EQ(received, 4u);
+    for (size_t n = 0; n < received; ++n) {
+        ASSERT_EQ(out[n].packet.size(), 100u);
+        EXPECT_TRUE(std::equal(payloads[n].begin(), payloads[n].end(), out[n].packet.data()));
+    }
+    // Buffers nothing arrived for went back to the pool
+    EXPECT_FALSE(out[4].packet.IsValid());
+    EXPECT_EQ(pool.Available(), 4u);
+}
+
+TEST_F(DatagramSocketTest, DropsTruncatedDatagramsFromPool) {
+    PacketPool pool(4);
+    SendNumbered(1, PACKET_BUFFER_SIZE + 100);
+    SendNumbered(1, 10);
+    ASSERT_TRUE(receiver.WaitReadable(std::chrono::milliseconds(1000)));
+
+    std::array<ReceivedDatagram, 4> out{};
+    size_t received = 0;
+    for (int attempt = 0; attempt < 10 && received == 0; ++attempt) {
+        received = receiver.ReceiveBatch(pool, out.data(), out.size());
+        receiver.WaitReadable(std::chrono::milliseconds(100));
+    }
+    ASSERT_EQ(received, 1u);
+    EXPECT_EQ(out[0].packet.size(), 10u);
+    EXPECT_EQ(receiver.GetStatistics().truncated_dropped, 1u);
+}
+
+TEST_F(DatagramSocketTest, GathersHeaderAndTail) {
+    const std::array<uint8_t, 4> header{1, 2, 3, 4};
+    const std::array<uint8_t, 3> tail{5, 6, 7};
+    OutgoingDatagram datagram;
+    datagram.data = header.data();
+    datagram.size = header.size();
+    datagram.tail = tail.data();
+    datagram.tail_size = tail.size();
+    datagram.to = &destination;
+    ASSERT_EQ(sender.SendBatch(&datagram, 1), 1u);
+    ASSERT_TRUE(receiver.WaitReadable(std::chrono::milliseconds(1000)));
+
+    std::array<uint8_t, 16> buffer{};
+    DatagramReceiveSlot slot;
+    slot.buffer = buffer.data();
+    slot.capacity = buffer.size();
+    ASSERT_EQ(receiver.ReceiveBatch(&slot, 1), 1u);
+    ASSERT_EQ(slot.size, 7u);
+    EXPECT_EQ(buffer[3], 4);
+    EXPECT_EQ(buffer[4], 5);
+    EXPECT_EQ(buffer[6], 7);
+}
+
+TEST_F(DatagramSocketTest, ConnectedSocketSendsWithoutAddress) {
+    ASSERT_EQ(sender.Connect(destination), ErrorCode::Success);
+    const std::array<uint8_t, 2> payload{9, 8};
+    OutgoingDatagram datagram;
+    datagram.data = payload.data();
+    datagram.size = payload.size();
+    ASSERT_EQ(sender.SendBatch(&datagram, 1), 1u);
+    ASSERT_TRUE(receiver.WaitReadable(std::chrono::milliseconds(1000)));
+
+    std::array<uint8_t, 16> buffer{};
+    DatagramReceiveSlot slot;
+    slot.buffer = buffer.data();
+    slot.capacity = buffer.size();
+    ASSERT_EQ(receiver.ReceiveBatch(&slot, 1), 1u);
+    EXPECT_EQ(slot.size, 2u);
+}
+
+TEST_F(DatagramSocketTest, EmptySocketReturnsNothing) {
+    std::array<uint8_t, 16> buffer{};
+    DatagramReceiveSlot slot;
+    slot.buffer = buffer.data();
+    slot.capacity = buffer.size();
+    EXPECT_EQ(receiver.ReceiveBatch(&slot, 1), 0u);
+    EXPECT_FALSE(receiver.WaitReadable(std::chrono::milliseconds(0)));
+}
+
+#ifdef __linux__
+TEST_F(DatagramSocketTest, KernelTimestampsBracketTheTransit) {
+    if (sender.EnableTimestamping(TimestampingMode::Software) != ErrorCode::Success ||
+        receiver.EnableTimestamping(TimestampingMode::Software) != ErrorCode::Success) {
+        GTEST_SKIP() << "SO_TIMESTAMPING is unavailable";
+    }
+    const auto now_ns = [] {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    };
+
+    const int64_t before_send = now_ns();
+    SendNumbered(2, 32);
+    ASSERT_TRUE(receiver.WaitReadable(std::chrono::milliseconds(1000)));
+    std::array<std::array<uint8_t, 64>, 2> buffers{};
+    std::array<DatagramReceiveSlot, 2> slots{};
+    for (size_t i = 0; i < slots.size(); ++i) {
+        slots[i].buffer = buffers[i].data();
+        slots[i].capacity = buffers[i].size();
+    }
+    ASSERT_EQ(receiver.ReceiveBatch(slots.data(), slots.size()), 2u);
+    const int64_t after_receive = now_ns();
+
+    std::array<TransmitTimestamp, 4> sent{};
+    size_t reported = 0;
+    for (int attempt = 0; attempt < 100 && reported < 2; ++attempt) {
+        reported += sender.ReadTransmitTimestamps(sent.data() + reported, sent.size() - reported);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(reported, 2u);
+
+    // Send, transmit, receive and the receive call happen in that order
+    for (size_t n = 0; n < 2; ++n) {
+        EXPECT_EQ(sent[n].id, n);
+        EXPECT_GE(sent[n].timestamps.software_ns, before_send);
+        EXPECT_LE(sent[n].timestamps.software_ns, slots[n].timestamps.software_ns);
+        EXPECT_LE(slots[n].timestamps.software_ns, after_receive);
+        EXPECT_EQ(slots[n].timestamps.hardware_ns, 0);
+    }
+}
+#endif
+
+TEST(DatagramEndpointTest, ParsesNumericAddresses) {
+    DatagramEndpoint ipv4;
+    ASSERT_TRUE(DatagramEndpoint::FromString("192.168.1.20", 11452, ipv4));
+    EXPECT_EQ(ipv4.Port(), 11452);
+    EXPECT_EQ(ipv4.ToString(), "192.168.1.20:11452");
+
+    DatagramEndpoint ipv6;
+    ASSERT_TRUE(DatagramEndpoint::FromString("::1", 8443, ipv6));
+    EXPECT_EQ(ipv6.ToString(), "[::1]:8443");
+    EXPECT_NE(ipv4, ipv6);
+
+    DatagramEndpoint same;
+    ASSERT_TRUE(DatagramEndpoint::FromString("192.168.1.20", 11452, same));
+    EXPECT_EQ(ipv4, same);
+
+    DatagramEndpoint invalid;
+    EXPECT_FALSE(DatagramEndpoint::FromString("relay.example.com", 80, invalid));
+    EXPECT_FALSE(invalid.IsValid());
+}
+
+TEST(DatagramSocketLifecycleTest, RejectsUnparsableBindAddress) {
+    DatagramSocket socket;
+    EXPECT_EQ(socket.Open("not-an-address", 0), ErrorCode::InvalidParameter);
+    EXPECT_FALSE(socket.IsOpen());
+    EXPECT_EQ(socket.Open("127.0.0.1", 0), ErrorCode::Success);
+    EXPECT_EQ(socket.Open("127.0.0.1", 0), ErrorCode::InvalidState);
+    socket.Close();
+    EXPECT_FALSE(socket.IsOpen());
+}
+
+TEST(DatagramSocketLifecycleTest, MulticastGroupMustBeMulticast) {
+    DatagramSocket socket;
+    EXPECT_EQ(socket.JoinMulticastGroup("239.255.77.12"), ErrorCode::NotInitialized);
+    ASSERT_EQ(socket.Open("0.0.0.0", 0), ErrorCode::Success);
+    EXPECT_EQ(socket.JoinMulticastGroup("192.168.1.10"), ErrorCode::InvalidParameter);
+    EXPECT_EQ(socket.JoinMulticastGroup("239.255.77.12", "not-an-address"),
+              ErrorCode::InvalidParameter);
+    EXPECT_EQ(socket.EnableBroadcast(), ErrorCode::Success);
+}
+
+TEST(DatagramSocketLifecycleTest, RegisteredIoMovesDatagrams) {
+    DatagramSocketOptions options;
+    options.registered_io = true;
+    DatagramSocket socket;
+    const ErrorCode result = socket.Open("127.0.0.1", 0, options);
+    if (!RegisteredIoQueue::IsSupported()) {
+        EXPECT_EQ(result, ErrorCode::PlatformFeatureUnavailable);
+        EXPECT_FALSE(socket.IsOpen());
+        return;
+    }
+    ASSERT_EQ(result, ErrorCode::Success);
+    EXPECT_TRUE(socket.IsRegisteredIo());
+
+    // Through the registered queues both ways
+    const DatagramEndpoint destination = socket.GetLocalEndpoint();
+    std::array<uint8_t, 3> header{1, 2, 3};
+    std::array<uint8_t, 2> tail{4, 5};
+    std::array<OutgoingDatagram, 8> datagrams{};
+    for (OutgoingDatagram& datagram : datagrams) {
+        datagram = {header.data(), header.size(), tail.data(), tail.size(), &destination};
+    }
+    ASSERT_EQ(socket.SendBatch(datagrams.data(), datagrams.size()), datagrams.size());
+
+    std::array<std::array<uint8_t, 16>, 8> buffers{};
+    std::array<DatagramReceiveSlot, 8> slots{};
+    for (size_t i = 0; i < slots.size(); ++i) {
+        slots[i].buffer = buffers[i].data();
+        slots[i].capacity = buffers[i].size();
+    }
+    size_t received = 0;
+    while (received < slots.size() && socket.WaitReadable(std::chrono::milliseconds(1000))) {
+        received += socket.ReceiveBatch(slots.data() + received, slots.size() - received);
+    }
+    ASSERT_EQ(received, slots.size());
+    for (size_t i = 0; i < slots.size(); ++i) {
+        EXPECT_EQ(slots[i].size, 5u);
+        EXPECT_EQ(buffers[i][4], 5);
+        EXPECT_EQ(slots[i].from, destination);
+    }
+    EXPECT_EQ(socket.GetStatistics().datagrams_sent, datagrams.size());
+}
+
+#ifndef _WIN32
+TEST(DatagramSocketLifecycleTest, AdoptsDescriptorBoundElsewhere) {
+    const int stream = ::socket(AF_INET, SOCK_STREAM, 0);
+    DatagramSocket adopted;
+    EXPECT_EQ(adopted.Adopt(stream), ErrorCode::InvalidParameter);
+    EXPECT_FALSE(adopted.IsOpen());
+    ::close(stream);
+
+    const int fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT_EQ(::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)), 0);
+    ASSERT_EQ(adopted.Adopt(fd), ErrorCode::Success);
+    EXPECT_EQ(adopted.GetNativeHandle(), fd);
+    EXPECT_EQ(adopted.Adopt(fd), ErrorCode::InvalidState);
+
+    DatagramSocket sender;
+    ASSERT_EQ(sender.Open("127.0.0.1", 0), ErrorCode::Success);
+    const DatagramEndpoint destination = adopted.GetLocalEndpoint();
+    const std::array<uint8_t, 3> payload{1, 2, 3};
+    OutgoingDatagram datagram;
+    datagram.data = payload.data();
+    datagram.size = payload.size();
+    datagram.to = &destination;
+    ASSERT_EQ(sender.SendBatch(&datagram, 1), 1u);
+    ASSERT_TRUE(adopted.WaitReadable(std::chrono::milliseconds(1000)));
+
+    std::array<uint8_t, 16> buffer{};
+    DatagramReceiveSlot slot;
+    slot.buffer = buffer.data();
+    slot.capacity = buffer.size();
+    ASSERT_EQ(adopted.ReceiveBatch(&slot, 1), 1u);
+    EXPECT_EQ(slot.size, 3u);
+
+    // Closing releases the adopted descriptor like an opened one
+    adopted.Close();
+    EXPECT_EQ(::fcntl(fd, F_GETFD), -1);
+}
+#endif
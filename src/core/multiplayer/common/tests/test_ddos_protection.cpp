@@ -0,0 +1,161 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core/multiplayer/common/ip_address_map.h"
+#include "core/multiplayer/common/ip_prefix_trie.h"
+#include "core/multiplayer/common/network_security.h"
+#include <gtest/gtest.h>
+
+#include <random>
+
+using namespace Core::Multiplayer;
+using namespace Core::Multiplayer::Security;
+
+TEST(IpAddressKeyTest, ParsesIPv4AsMapped) {
+    const auto key = IpAddressKey::Parse("192.168.0.1");
+    ASSERT_TRUE(key.has_value());
+    EXPECT_TRUE(key->IsIPv4());
+    EXPECT_EQ(key->ToString(), "192.168.0.1");
+    EXPECT_EQ(*key, *IpAddressKey::Parse("::ffff:192.168.0.1"));
+    EXPECT_EQ(*key, *IpAddressKey::Parse("192.168.000.001"));
+
+    for (const char* bad : {"", "1.2.3", "1.2.3.4.", "256.1.1.1", "1.2.3.4x", "1..2.3", "1234.1.1.1",
+                            " 1.2.3.4"}) {
+        EXPECT_FALSE(IpAddressKey::Parse(bad).has_value()) << bad;
+    }
+}
+
+TEST(IpAddressKeyTest, ParsesIPv6) {
+    const auto key = IpAddressKey::Parse("2001:db8::1");
+    ASSERT_TRUE(key.has_value());
+    EXPECT_FALSE(key->IsIPv4());
+    EXPECT_EQ(key->ToString(), "2001:db8:0:0:0:0:0:1");
+    EXPECT_EQ(*IpAddressKey::Parse("::"), IpAddressKey{});
+    EXPECT_TRUE(IpAddressKey::Parse("1:2:3:4:5:6:7:8").has_value());
+    EXPECT_TRUE(IpAddressKey::Parse("fe80::").has_value());
+
+    for (const char* bad : {":", ":::", "1::2::3", "1:2:3:4:5:6:7:8:9", "1:2:3:4:5:6:7", "12345::",
+                            "1:", "g::1", "::1.2.3"}) {
+        EXPECT_FALSE(IpAddressKey::Parse(bad).has_value()) << bad;
+    }
+}
+
+TEST(IpAddressKeyTest, ParsesPrefixes) {
+    const auto v4 = IpAddressKey::ParsePrefix("10.1.2.3/8");
+    ASSERT_TRUE(v4.has_value());
+    EXPECT_EQ(v4->second, 96 + 8);
+    EXPECT_EQ(v4->first.ToString(), "10.0.0.0");
+
+    const auto v6 = IpAddressKey::ParsePrefix("2001:db8::/32");
+    ASSERT_TRUE(v6.has_value());
+    EXPECT_EQ(v6->second, 32);
+    EXPECT_EQ(IpAddressKey::ParsePrefix("1.2.3.4")->second, 128);
+    EXPECT_FALSE(IpAddressKey::ParsePrefix("1.2.3.4/33").has_value());
+    EXPECT_FALSE(IpAddressKey::ParsePrefix("::/129").has_value());
+    EXPECT_FALSE(IpAddressKey::ParsePrefix("1.2.3.4/").has_value());
+}
+
+TEST(IpAddressMapTest, SurvivesChurn) {
+    IpAddressMap<int> map(16);
+    std::mt19937 rng(7);
+    std::vector<IpAddressKey> keys;
+    for (uint32_t i = 0; i < 2000; ++i) {
+        keys.push_back(IpAddressKey::FromIPv4(rng()));
+        map.FindOrInsert(keys.back()) = static_cast<int>(i);
+    }
+    EXPECT_EQ(map.Size(), keys.size());
+    for (size_t i = 0; i < keys.size(); i += 2) {
+        EXPECT_TRUE(map.Erase(keys[i]));
+    }
+    EXPECT_EQ(map.Size(), keys.size() / 2);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        const int* value = map.Find(keys[i]);
+        if (i % 2 == 0) {
+            EXPECT_EQ(value, nullptr);
+        } else {
+            ASSERT_NE(value, nullptr);
+            EXPECT_EQ(*value, static_cast<int>(i));
+        }
+    }
+    EXPECT_EQ(map.EraseIf([](const IpAddressKey&, int value) { return value % 4 == 1; }), 500u);
+    EXPECT_EQ(map.Size(), 500u);
+}
+
+TEST(IpPrefixTrieTest, MatchesEveryEnclosingPrefix) {
+    IpPrefixTrie<int> trie;
+    const auto insert = [&](const char* text, int value) {
+        const auto prefix = IpAddressKey::ParsePrefix(text);
+        trie.Insert(prefix->first, prefix->second, value);
+    };
+    insert("10.0.0.0/8", 1);
+    insert("10.1.0.0/16", 2);
+    insert("10.1.2.3", 3);
+    insert("2001:db8::/32", 4);
+    EXPECT_EQ(trie.Size(), 4u);
+
+    const auto matches = [&](const char* text) {
+        std::vector<int> found;
+        trie.AnyMatch(*IpAddressKey::Parse(text), [&](int value) {
+            found.push_back(value);
+            return false;
+        });
+        return found;
+    };
+    EXPECT_EQ(matches("10.1.2.3"), (std::vector<int>{1, 2, 3}));
+    EXPECT_EQ(matches("10.1.9.9"), (std::vector<int>{1, 2}));
+    EXPECT_EQ(matches("10.200.0.1"), (std::vector<int>{1}));
+    EXPECT_EQ(matches("11.0.0.1"), (std::vector<int>{}));
+    EXPECT_EQ(matches("2001:db8:ffff::1"), (std::vector<int>{4}));
+    EXPECT_EQ(matches("2001:db9::1"), (std::vector<int>{}));
+
+    EXPECT_EQ(trie.EraseIf([](const IpAddressKey&, uint8_t, int value) { return value == 2; }), 1u);
+    EXPECT_EQ(matches("10.1.2.3"), (std::vector<int>{1, 3}));
+}
+
+TEST(DDoSProtectionTest, BansCidrBlocks) {
+    DDoSProtectionConfig config;
+    DDoSProtection protection(config);
+    protection.BlacklistIP("198.51.100.0/24", "abuse");
+    protection.BlacklistIP("2001:db8::/48", "abuse");
+
+    EXPECT_FALSE(protection.AllowNewConnection("198.51.100.77"));
+    EXPECT_TRUE(protection.AllowNewConnection("198.51.101.1"));
+    EXPECT_FALSE(protection.AllowNewConnection("2001:db8:0:1::5"));
+    EXPECT_TRUE(protection.AllowNewConnection("2001:db8:1::5"));
+    EXPECT_TRUE(protection.IsBlacklisted("198.51.100.1"));
+    EXPECT_FALSE(protection.AllowNewConnection("not an address"));
+}
+
+TEST(DDoSProtectionTest, BansAnAddressOverItsConnectionLimit) {
+    DDoSProtectionConfig config;
+    config.max_connections_per_ip = 2;
+    DDoSProtection protection(config);
+    const auto address = IpAddressKey::FromIPv4(0x0100007F);
+
+    for (int i = 0; i < 2; ++i) {
+        ASSERT_TRUE(protection.AllowNewConnection(address));
+        protection.RegisterConnection(address);
+    }
+    EXPECT_FALSE(protection.AllowNewConnection(address));
+    EXPECT_TRUE(protection.IsBlacklisted("127.0.0.1"));
+
+    // String and key forms refer to the same address
+    protection.RemoveConnection("127.0.0.1", "connection");
+    EXPECT_FALSE(protection.AllowNewConnection("127.0.0.1"));
+}
+
+// Components/DDoSProtection/SpoofedAdmission in the component benchmarks
+// times these checks
+TEST(DDoSProtectionTest, CheckedAddressesAreNotStored) {
+    DDoSProtectionConfig config;
+    DDoSProtection protection(config);
+    protection.BlacklistIP("203.0.113.0/24", "abuse");
+
+    std::mt19937 rng(99);
+    constexpr int ATTEMPTS = 20000;
+    for (int i = 0; i < ATTEMPTS; ++i) {
+        protection.AllowNewConnection(IpAddressKey::FromIPv4(rng()));
+    }
+
+    EXPECT_NE(protection.GetProtectionStats().find("Unique IPs: 0"), std::string::npos);
+}
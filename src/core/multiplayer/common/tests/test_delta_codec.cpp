@@ -0,0 +1,168 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core/multiplayer/common/delta_codec.h"
+#include <gtest/gtest.h>
+#include <array>
+#include <vector>
+
+using namespace Core::Multiplayer;
+
+namespace {
+
+std::vector<uint8_t> StatePacket(uint8_t frame) {
+    // A game state packet where only a counter and one position change
+    std::vector<uint8_t> packet(200, 0x42);
+    packet[10] = frame;
+    packet[120] = static_cast<uint8_t>(frame * 3);
+    return packet;
+}
+
+class DeltaCodecTest : public ::testing::Test {
+protected:
+    std::vector<uint8_t> Encode(const std::vector<uint8_t>& packet) {
+        const size_t size = encoder.Encode(packet.data(), packet.size(), wire.data());
+        return std::vector<uint8_t>(wire.begin(), wire.begin() + size);
+    }
+
+    bool Decode(const std::vector<uint8_t>& encoded, std::vector<uint8_t>& out) {
+        std::array<uint8_t, PACKET_BUFFER_SIZE> buffer{};
+        size_t size = 0;
+        uint16_t frame_id = 0;
+        if (!decoder.Decode(encoded.data(), encoded.size(), buffer.data(), size, frame_id)) {
+            return false;
+        }
+        out.assign(buffer.begin(), buffer.begin() + size);
+        last_frame_id = frame_id;
+        return true;
+    }
+
+    DeltaEncoder encoder{DeltaCodecConfig{8}};
+    DeltaDecoder decoder;
+    std::array<uint8_t, DeltaEncoder::MAX_ENCODED_SIZE> wire{};
+    uint16_t last_frame_id = 0;
+};
+
+} // anonymous namespace
+
+TEST_F(DeltaCodecTest, SendsOnlyChangedRanges) {
+    const auto first = Encode(StatePacket(0));
+    EXPECT_EQ(first[0], DeltaEncoder::KIND_KEYFRAME);
+    EXPECT_EQ(first.size(), DeltaEncoder::KEYFRAME_HEADER_SIZE + 200);
+
+    const auto second = Encode(StatePacket(1));
+    EXPECT_EQ(second[0], DeltaEncoder::KIND_DELTA);
+    // Two one-byte runs
+    EXPECT_EQ(second.size(), DeltaEncoder::DELTA_HEADER_SIZE + 2 * (DeltaEncoder::RUN_HEADER_SIZE + 1));
+
+    std::vector<uint8_t> decoded;
+    ASSERT_TRUE(Decode(first, decoded));
+    EXPECT_EQ(decoded, StatePacket(0));
+    ASSERT_TRUE(Decode(second, decoded));
+    EXPECT_EQ(decoded, StatePacket(1));
+    EXPECT_EQ(last_frame_id, 1u);
+}
+
+TEST_F(DeltaCodecTest, HandlesSizeChanges) {
+    std::vector<uint8_t> decoded;
+    ASSERT_TRUE(Decode(Encode(StatePacket(0)), decoded));
+
+    auto longer = StatePacket(0);
+    longer.resize(260, 0x42);
+    ASSERT_TRUE(Decode(Encode(longer), decoded));
+    EXPECT_EQ(decoded, longer);
+
+    const auto reference = StatePacket(0);
+    const std::vector<uint8_t> shorter(reference.begin(), reference.begin() + 50);
+    const auto encoded = Encode(shorter);
+    EXPECT_EQ(encoded[0], DeltaEncoder::KIND_DELTA);
+    ASSERT_TRUE(Decode(encoded, decoded));
+    EXPECT_EQ(decoded, shorter);
+}
+
+TEST_F(DeltaCodecTest, LostDeltasCostOnlyThemselves) {
+    std::vector<uint8_t> decoded;
+    ASSERT_TRUE(Decode(Encode(StatePacket(0)), decoded));
+    Encode(StatePacket(1)); // Lost
+    Encode(StatePacket(2)); // Lost
+    ASSERT_TRUE(Decode(Encode(StatePacket(3)), decoded));
+    EXPECT_EQ(decoded, StatePacket(3));
+}
+
+TEST_F(DeltaCodecTest, KeyframesRecoverFromLostKeyframe) {
+    Encode(StatePacket(0)); // Keyframe lost
+    std::vector<uint8_t> decoded;
+    for (uint8_t frame = 1; frame < 8; ++frame) {
+        EXPECT_FALSE(Decode(Encode(StatePacket(frame)), decoded));
+    }
+    EXPECT_EQ(decoder.GetStatistics().missing_references, 7u);
+
+    // The eighth packet is the next keyframe
+    const auto keyframe = Encode(StatePacket(8));
+    EXPECT_EQ(keyframe[0], DeltaEncoder::KIND_KEYFRAME);
+    ASSERT_TRUE(Decode(keyframe, decoded));
+    ASSERT_TRUE(Decode(Encode(StatePacket(9)), decoded));
+    EXPECT_EQ(decoded, StatePacket(9));
+    EXPECT_EQ(encoder.GetStatistics().keyframes_sent, 2u);
+}
+
+TEST_F(DeltaCodecTest, AcknowledgedPacketBecomesReference) {
+    std::vector<uint8_t> decoded;
+    ASSERT_TRUE(Decode(Encode(StatePacket(0)), decoded));
+
+    // The packet drifts far from the keyframe, then holds still
+    auto moved = StatePacket(1);
+    std::fill(moved.begin() + 20, moved.begin() + 100, 0x11);
+    ASSERT_TRUE(Decode(Encode(moved), decoded));
+    const size_t against_keyframe = Encode(moved).size();
+
+    encoder.Acknowledge(last_frame_id);
+    const auto against_acknowledged = Encode(moved);
+    EXPECT_LT(against_acknowledged.size(), against_keyframe);
+    // Older acknowledgements do not move the reference back
+    encoder.Acknowledge(0);
+    EXPECT_EQ(Encode(moved).size(), against_acknowledged.size());
+
+    // Both deltas decode, well after the acknowledged packet left the history
+    for (size_t i = 0; i < DeltaDecoder::HISTORY_SIZE; ++i) {
+        ASSERT_TRUE(Decode(against_acknowledged, decoded));
+    }
+    EXPECT_EQ(decoded, moved);
+}
+
+TEST_F(DeltaCodecTest, RejectsMalformedPackets) {
+    std::vector<uint8_t> decoded;
+    ASSERT_TRUE(Decode(Encode(StatePacket(0)), decoded));
+    auto delta = Encode(StatePacket(1));
+
+    // A run past the end of the packet
+    delta[DeltaEncoder::DELTA_HEADER_SIZE] = 0xFF;
+    EXPECT_FALSE(Decode(delta, decoded));
+    EXPECT_FALSE(Decode({DeltaEncoder::KIND_DELTA, 0}, decoded));
+    EXPECT_FALSE(Decode({0x7F, 0, 0, 1}, decoded));
+    EXPECT_EQ(decoder.GetStatistics().malformed_packets, 3u);
+}
+
+TEST(DeltaCodecStreamsTest, KeepsStreamsApart) {
+    DeltaCodec sender;
+    DeltaCodec receiver;
+    std::array<uint8_t, DeltaCodec::MAX_ENCODED_SIZE> wire{};
+    std::array<uint8_t, PACKET_BUFFER_SIZE> out{};
+    size_t size = 0;
+
+    const auto to_one = StatePacket(1);
+    const auto to_two = StatePacket(2);
+    size_t encoded = sender.Encode({1}, to_one.data(), to_one.size(), wire.data());
+    ASSERT_TRUE(receiver.Decode({1}, wire.data(), encoded, out.data(), size));
+    encoded = sender.Encode({2}, to_two.data(), to_two.size(), wire.data());
+    // Each node's first packet is its own keyframe
+    EXPECT_EQ(wire[0], DeltaEncoder::KIND_KEYFRAME);
+    ASSERT_TRUE(receiver.Decode({2}, wire.data(), encoded, out.data(), size));
+    EXPECT_EQ(std::vector<uint8_t>(out.begin(), out.begin() + size), to_two);
+
+    sender.ResetNode(1);
+    encoded = sender.Encode({1}, to_one.data(), to_one.size(), wire.data());
+    EXPECT_EQ(wire[0], DeltaEncoder::KIND_KEYFRAME);
+    EXPECT_EQ(sender.GetStatistics().keyframes_sent, 2u);
+    EXPECT_EQ(receiver.GetStatistics().packets_decoded, 2u);
+}
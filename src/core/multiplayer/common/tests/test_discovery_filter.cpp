@@ -0,0 +1,50 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include "core/multiplayer/common/discovery_filter.h"
+
+using namespace Core::Multiplayer;
+
+TEST(DiscoveryFilterTest, EmptyFilterMatchesEveryTitle) {
+    DiscoveryFilter filter;
+    EXPECT_TRUE(filter.IsEmpty());
+    EXPECT_TRUE(filter.MatchesTitle(0x01006A800016E000));
+}
+
+TEST(DiscoveryFilterTest, TitleFilterMatchesOnlyThatTitle) {
+    DiscoveryFilter filter;
+    filter.local_communication_id = 0x01006A800016E000;
+    EXPECT_FALSE(filter.IsEmpty());
+    EXPECT_TRUE(filter.MatchesTitle(0x01006A800016E000));
+    EXPECT_FALSE(filter.MatchesTitle(0x0100000000001000));
+}
+
+TEST(DiscoveryFilterTest, FieldsOtherThanTitleDoNotAffectTitleMatch) {
+    DiscoveryFilter filter;
+    filter.scene_id = 3;
+    filter.network_name = "room";
+    EXPECT_FALSE(filter.IsEmpty());
+    EXPECT_TRUE(filter.MatchesTitle(0x0100000000001000));
+}
+
+TEST(DiscoveryFilterTest, ParsesTitleIdsWithAndWithoutPrefix) {
+    EXPECT_EQ(ParseTitleId("01006a800016e000"), 0x01006A800016E000u);
+    EXPECT_EQ(ParseTitleId("0x01006A800016E000"), 0x01006A800016E000u);
+    EXPECT_EQ(ParseTitleId("1"), 1u);
+}
+
+TEST(DiscoveryFilterTest, RejectsMalformedTitleIds) {
+    EXPECT_FALSE(ParseTitleId("").has_value());
+    EXPECT_FALSE(ParseTitleId("0x").has_value());
+    EXPECT_FALSE(ParseTitleId("smash").has_value());
+    EXPECT_FALSE(ParseTitleId("01006a800016e000 ").has_value());
+    EXPECT_FALSE(ParseTitleId("101006a800016e000").has_value());
+}
+
+TEST(DiscoveryFilterTest, FormatRoundTrips) {
+    EXPECT_EQ(FormatTitleId(0x01006A800016E000), "01006a800016e000");
+    EXPECT_EQ(FormatTitleId(1), "0000000000000001");
+    EXPECT_EQ(ParseTitleId(FormatTitleId(0xFEDCBA9876543210)), 0xFEDCBA9876543210u);
+}
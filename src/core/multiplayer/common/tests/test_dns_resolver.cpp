@@ -0,0 +1,197 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/multiplayer/common/clock_source.h"
+#include "core/multiplayer/common/dns_resolver.h"
+
+using namespace Core::Multiplayer;
+using namespace std::chrono_literals;
+
+namespace {
+
+DatagramEndpoint Address(const std::string& text, uint16_t port = 0) {
+    DatagramEndpoint endpoint;
+    EXPECT_TRUE(DatagramEndpoint::FromString(text, port, endpoint));
+    return endpoint;
+}
+
+// Answers from a fixed table; IPv6 queries can be held until released
+struct FakeDns {
+    DnsResolver::Addresses Lookup(const std::string& host, DnsResolver::Family family) {
+        ++queries;
+        if (family == DnsResolver::Family::IPv6) {
+            hold_ipv6.wait();
+            return host == "dual.example" ? ipv6 : DnsResolver::Addresses{};
+        }
+        return host == "dual.example" || host == "v4.example" ? ipv4 : DnsResolver::Addresses{};
+    }
+
+    DnsResolver::Addresses ipv6{Address("2001:db8::1"), Address("2001:db8::2")};
+    DnsResolver::Addresses ipv4{Address("192.0.2.1")};
+    std::promise<void> release_ipv6;
+    std::shared_future<void> hold_ipv6 = release_ipv6.get_future().share();
+    std::atomic<int> queries{0};
+};
+
+struct ResolverFixture {
+    explicit ResolverFixture(bool hold_ipv6 = false) {
+        if (!hold_ipv6) {
+            dns.release_ipv6.set_value();
+        }
+        resolver = std::make_unique<DnsResolver>(
+            config,
+            [this](const std::string& host, DnsResolver::Family family) {
+                return dns.Lookup(host, family);
+            },
+            wheel);
+    }
+
+    // Waits until both families are in the cache
+    void Warm(const std::string& host) {
+        const size_t cached = resolver->GetCachedCount();
+        resolver->Prefetch(host);
+        while (resolver->GetCachedCount() == cached) {
+            std::this_thread::sleep_for(1ms);
+        }
+    }
+
+    ~ResolverFixture() {
+        if (dns.hold_ipv6.wait_for(0s) != std::future_status::ready) {
+            dns.release_ipv6.set_value();
+        }
+        resolver.reset();
+        wheel->Shutdown();
+    }
+
+    FakeDns dns;
+    DnsResolverConfig config;
+    std::shared_ptr<VirtualClock> clock = std::make_shared<VirtualClock>();
+    std::shared_ptr<TimerWheel> wheel = std::make_shared<TimerWheel>(clock);
+    std::unique_ptr<DnsResolver> resolver;
+};
+
+} // namespace
+
+TEST(DnsResolverTest, NumericHostsAreNotLookedUp) {
+    ResolverFixture fixture;
+    DnsResolver::Addresses answer;
+    fixture.resolver->ResolveAsync("::1", 9000, [&answer](const auto& a) { answer = a; });
+    ASSERT_EQ(answer.size(), 1u);
+    EXPECT_EQ(answer[0], Address("::1", 9000));
+    EXPECT_EQ(fixture.dns.queries.load(), 0);
+}
+
+TEST(DnsResolverTest, AnswersAlternateFamiliesStartingWithIPv6) {
+    ResolverFixture fixture;
+    fixture.Warm("dual.example");
+    const auto answer = fixture.resolver->Resolve("dual.example", 8443);
+    const DnsResolver::Addresses expected{Address("2001:db8::1", 8443), Address("192.0.2.1", 8443),
+                                          Address("2001:db8::2", 8443)};
+    EXPECT_EQ(answer, expected);
+    EXPECT_EQ(fixture.resolver->GetStatistics().queries, 2u);
+}
+
+TEST(DnsResolverTest, ConcurrentRequestsShareOneLookup) {
+    ResolverFixture fixture(true);
+    std::atomic<int> answered{0};
+    for (int i = 0; i < 3; ++i) {
+        fixture.resolver->ResolveAsync("v4.example", 80, [&answered](const auto& addresses) {
+            EXPECT_EQ(addresses.size(), 1u);
+            ++answered;
+        });
+    }
+    fixture.dns.release_ipv6.set_value();
+    while (answered.load() < 3) {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    const auto stats = fixture.resolver->GetStatistics();
+    EXPECT_EQ(stats.queries, 2u);
+    EXPECT_EQ(stats.coalesced, 2u);
+}
+
+TEST(DnsResolverTest, ExpiredAnswersAreServedWhileRefreshing) {
+    ResolverFixture fixture;
+    fixture.Warm("dual.example");
+    fixture.clock->Advance(fixture.config.positive_ttl - 1s);
+    EXPECT_EQ(fixture.resolver->Resolve("dual.example", 1).size(), 3u);
+    EXPECT_EQ(fixture.resolver->GetStatistics().cache_hits, 1u);
+
+    // Past the TTL the old answer comes back at once and a refresh starts
+    fixture.dns.ipv6.clear();
+    fixture.clock->Advance(2s);
+    EXPECT_EQ(fixture.resolver->Resolve("dual.example", 1).size(), 3u);
+    EXPECT_EQ(fixture.resolver->GetStatistics().stale_hits, 1u);
+    while (fixture.dns.queries.load() < 4 ||
+           fixture.resolver->Resolve("dual.example", 1).size() != 1) {
+        std::this_thread::sleep_for(1ms);
+    }
+}
+
+TEST(DnsResolverTest, FailuresAreCachedForTheNegativeTtl) {
+    ResolverFixture fixture;
+    EXPECT_TRUE(fixture.resolver->Resolve("missing.example", 1).empty());
+    EXPECT_TRUE(fixture.resolver->Resolve("missing.example", 1).empty());
+    EXPECT_EQ(fixture.dns.queries.load(), 2);
+    EXPECT_EQ(fixture.resolver->GetStatistics().failures, 1u);
+
+    fixture.clock->Advance(fixture.config.negative_ttl);
+    EXPECT_TRUE(fixture.resolver->Resolve("missing.example", 1).empty());
+    EXPECT_EQ(fixture.dns.queries.load(), 4);
+}
+
+TEST(DnsResolverTest, SlowAaaaHoldsIPv4OnlyForTheResolutionDelay) {
+    ResolverFixture fixture(true);
+    std::atomic<bool> answered{false};
+    DnsResolver::Addresses answer;
+    fixture.resolver->ResolveAsync("dual.example", 1, [&](const auto& addresses) {
+        answer = addresses;
+        answered = true;
+    });
+
+    // The A answer arms the resolution delay instead of answering
+    while (fixture.wheel->GetTimerCount() == 0) {
+        std::this_thread::sleep_for(1ms);
+    }
+    EXPECT_FALSE(answered.load());
+    fixture.clock->Advance(fixture.config.resolution_delay);
+    fixture.wheel->RunDue();
+    ASSERT_TRUE(answered.load());
+    EXPECT_EQ(answer, DnsResolver::Addresses{Address("192.0.2.1", 1)});
+
+    // Once AAAA arrives the cached answer has both families
+    fixture.dns.release_ipv6.set_value();
+    while (fixture.resolver->GetCachedCount() == 0) {
+        std::this_thread::sleep_for(1ms);
+    }
+    EXPECT_EQ(fixture.resolver->Resolve("dual.example", 1).size(), 3u);
+}
+
+TEST(DnsResolverTest, PrefetchWarmsTheCache) {
+    ResolverFixture fixture;
+    const std::vector<std::string> hosts{"dual.example", "v4.example", "10.0.0.1"};
+    fixture.resolver->Prefetch(hosts);
+    while (fixture.resolver->GetCachedCount() < 2) {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    EXPECT_EQ(fixture.resolver->Resolve("v4.example", 1).size(), 1u);
+    const auto stats = fixture.resolver->GetStatistics();
+    EXPECT_EQ(stats.prefetches, 2u);
+    EXPECT_EQ(stats.queries, 4u);
+    EXPECT_EQ(stats.cache_hits, 1u);
+
+    // A network change forgets the answer
+    fixture.resolver->Invalidate("v4.example");
+    EXPECT_EQ(fixture.resolver->Resolve("v4.example", 1).size(), 1u);
+    EXPECT_EQ(fixture.resolver->GetStatistics().queries, 6u);
+}
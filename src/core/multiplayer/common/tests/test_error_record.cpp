@@ -0,0 +1,130 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core/multiplayer/common/error_handling.h"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+
+using namespace Core::Multiplayer;
+
+namespace {
+std::atomic<size_t> g_allocations{0};
+
+// Out of line, so the compiler does not pair the malloc with sized deletes
+[[gnu::noinline]] void* CountedAllocate(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+} // namespace
+
+void* operator new(size_t size) {
+    return CountedAllocate(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+static_assert(std::is_trivially_copyable_v<ErrorRecord>);
+
+TEST(ErrorRecordTest, FormatsMessagesOnDemand) {
+    auto record = MakeErrorRecord(ErrorCode::MessageTooLarge, ErrorFormat::MessageTooLarge,
+                                  "Relay", 70000, 65536);
+    EXPECT_EQ(record.arg_count, 2u);
+    EXPECT_EQ(FormatErrorMessage(record), "Message of 70000 bytes exceeds the 65536 byte limit");
+
+    record = MakeErrorRecord(ErrorCode::ConnectionLost, ErrorFormat::Default, "P2P");
+    EXPECT_EQ(FormatErrorMessage(record), "Lost connection to the server");
+
+    const ErrorInfo info = ToErrorInfo(
+        MakeErrorRecord(ErrorCode::NetworkTimeout, ErrorFormat::TimedOut, "P2P", 1500));
+    EXPECT_EQ(info.category, ErrorCategory::NetworkConnectivity);
+    EXPECT_EQ(info.message, "Timed out after 1500 ms");
+    EXPECT_EQ(info.component, "P2P");
+}
+
+TEST(ErrorRecordTest, MissingArgumentsStayAsPlaceholders) {
+    const auto record =
+        MakeErrorRecord(ErrorCode::MessageQueueFull, ErrorFormat::QueueFull, "Relay", 10);
+    EXPECT_EQ(FormatErrorMessage(record), "Queue full (10 of {1} entries)");
+}
+
+TEST(ErrorRecordTest, ReportingWithoutListenersDoesNotAllocate) {
+    ErrorHandler handler;
+    // Count each code once so the statistics map has its nodes
+    handler.ReportError(MakeErrorRecord(ErrorCode::ResourceExhausted, ErrorFormat::RateLimited,
+                                        "Security", 100));
+
+    const size_t before = g_allocations.load();
+    for (int i = 0; i < 1000; ++i) {
+        handler.ReportError(MakeErrorRecord(ErrorCode::ResourceExhausted,
+                                            ErrorFormat::RateLimited, "Security", 100));
+    }
+    EXPECT_EQ(g_allocations.load(), before);
+
+    EXPECT_EQ(handler.GetErrorStatistics()[ErrorCode::ResourceExhausted], 1001u);
+    const auto recent = handler.GetRecentErrors(1);
+    ASSERT_EQ(recent.size(), 1u);
+    EXPECT_EQ(recent[0].message, "Rate limit exceeded (100 per second allowed)");
+    EXPECT_EQ(recent[0].component, "Security");
+}
+
+TEST(ErrorRecordTest, ListenersReceiveFormattedErrors) {
+    ErrorHandler handler;
+    handler.SetErrorContext(ErrorCode::MaxPeersExceeded, "room", "lobby");
+    std::vector<ErrorInfo> seen;
+    handler.SetOnError([&](const ErrorInfo& error) { seen.push_back(error); });
+
+    handler.ReportError(
+        MakeErrorRecord(ErrorCode::MaxPeersExceeded, ErrorFormat::PeerLimit, "Room", 8));
+    ASSERT_EQ(seen.size(), 1u);
+    EXPECT_EQ(seen[0].message, "Peer limit of 8 reached");
+    EXPECT_EQ(seen[0].context.at("room"), "lobby");
+}
+
+TEST(ErrorRecordTest, HistoryKeepsTheMostRecentEntries) {
+    ErrorHandler handler;
+    handler.SetMaxErrorHistorySize(3);
+    for (int i = 1; i <= 5; ++i) {
+        handler.ReportError(
+            MakeErrorRecord(ErrorCode::Timeout, ErrorFormat::TimedOut, "Test", i));
+    }
+    handler.ReportError(ErrorCode::ConnectionLost, "dropped", "Test");
+
+    auto recent = handler.GetRecentErrors(10);
+    ASSERT_EQ(recent.size(), 3u);
+    EXPECT_EQ(recent[0].message, "Timed out after 4 ms");
+    EXPECT_EQ(recent[1].message, "Timed out after 5 ms");
+    EXPECT_EQ(recent[2].message, "dropped");
+
+    handler.SetMaxErrorHistorySize(2);
+    recent = handler.GetRecentErrors(10);
+    ASSERT_EQ(recent.size(), 2u);
+    EXPECT_EQ(recent[0].message, "Timed out after 5 ms");
+
+    handler.ClearErrorHistory();
+    EXPECT_TRUE(handler.GetRecentErrors(10).empty());
+}
+
+// Components/ErrorHandler/* in the component benchmarks times both ways
+// of building this error
+TEST(ErrorRecordTest, RecordCarriesWhatTheErrorInfoWould) {
+    const ErrorInfo built = CreateNetworkError(ErrorCode::ResourceExhausted, "Rate limited");
+    const ErrorInfo from_record = ToErrorInfo(
+        MakeErrorRecord(ErrorCode::ResourceExhausted, ErrorFormat::RateLimited, "Security", 100));
+
+    EXPECT_EQ(from_record.error_code, built.error_code);
+    EXPECT_EQ(from_record.message, "Rate limit exceeded (100 per second allowed)");
+    EXPECT_EQ(from_record.component, "Security");
+}
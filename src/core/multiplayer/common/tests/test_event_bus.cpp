@@ -0,0 +1,106 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core/multiplayer/common/event_bus.h"
+#include <gtest/gtest.h>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Core::Multiplayer;
+
+TEST(InlineFunctionTest, SmallTargetsStayInline) {
+    int calls = 0;
+    InlineFunction<int(int)> add([&calls](int value) {
+        ++calls;
+        return value + 1;
+    });
+    EXPECT_TRUE(add.IsInline());
+    EXPECT_EQ(add(41), 42);
+
+    InlineFunction<int(int)> moved(std::move(add));
+    EXPECT_FALSE(static_cast<bool>(add));
+    EXPECT_EQ(moved(1), 2);
+    EXPECT_EQ(calls, 2);
+
+    std::array<char, 256> large{};
+    large[0] = 'x';
+    InlineFunction<char()> heap([large] { return large[0]; });
+    EXPECT_FALSE(heap.IsInline());
+    EXPECT_EQ(heap(), 'x');
+}
+
+TEST(InlineFunctionTest, EmptyStdFunctionStaysEmpty) {
+    std::function<void()> empty;
+    InlineFunction<void()> wrapped(empty);
+    EXPECT_FALSE(static_cast<bool>(wrapped));
+}
+
+TEST(EventChannelTest, PublishesToEverySubscriber) {
+    EventChannel<std::string, int> channel;
+    std::vector<std::string> seen;
+    const auto first = channel.Subscribe(
+        [&seen](const std::string& name, int value) { seen.push_back(name + std::to_string(value)); });
+    channel.Subscribe([&seen](const std::string& name, int) { seen.push_back(name); });
+    EXPECT_TRUE(channel.HasSubscribers());
+
+    channel.Publish("peer", 1);
+    EXPECT_EQ(seen, (std::vector<std::string>{"peer1", "peer"}));
+
+    EXPECT_TRUE(channel.Unsubscribe(first));
+    EXPECT_FALSE(channel.Unsubscribe(first));
+    seen.clear();
+    channel.Publish("peer", 2);
+    EXPECT_EQ(seen, (std::vector<std::string>{"peer"}));
+
+    channel.Reset(nullptr);
+    EXPECT_FALSE(channel.HasSubscribers());
+}
+
+TEST(EventChannelTest, DeferredQueueRunsOnDispatch) {
+    auto queue = std::make_shared<EventQueue>(4);
+    EventChannel<std::vector<uint8_t>> channel;
+    channel.SetDeferredQueue(queue);
+
+    size_t received = 0;
+    channel.Reset([&received](const std::vector<uint8_t>& data) { received += data.size(); });
+
+    std::vector<uint8_t> data(3);
+    EXPECT_TRUE(channel.Publish(data));
+    // The queue holds its own copy
+    data.clear();
+    EXPECT_EQ(received, 0u);
+    EXPECT_EQ(queue->GetPendingCount(), 1u);
+
+    EXPECT_EQ(queue->Dispatch(), 1u);
+    EXPECT_EQ(received, 3u);
+}
+
+TEST(EventChannelTest, PublishWhileSubscribing) {
+    EventChannel<int> channel;
+    std::atomic<int> total{0};
+    channel.Subscribe([&total](int value) { total += value; });
+
+    std::atomic<bool> done{false};
+    std::thread subscriber([&] {
+        std::vector<EventChannel<int>::SubscriptionId> ids;
+        for (int i = 0; i < 200; ++i) {
+            ids.push_back(channel.Subscribe([](int) {}));
+        }
+        for (const auto id : ids) {
+            channel.Unsubscribe(id);
+        }
+        done = true;
+    });
+
+    int published = 0;
+    while (!done || published < 1000) {
+        channel.Publish(1);
+        ++published;
+    }
+    subscriber.join();
+    EXPECT_EQ(total.load(), published);
+}
@@ -0,0 +1,221 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core/multiplayer/common/fec_codec.h"
+#include <gtest/gtest.h>
+#include <array>
+#include <vector>
+
+using namespace Core::Multiplayer;
+
+namespace {
+
+using Packet = std::vector<uint8_t>;
+
+Packet GamePacket(uint8_t seed, size_t size) {
+    Packet packet(size);
+    for (size_t i = 0; i < size; ++i) {
+        packet[i] = static_cast<uint8_t>(seed * 31 + i);
+    }
+    return packet;
+}
+
+class FecCodecTest : public ::testing::Test {
+protected:
+    // Frames the packets of one group, then its parity
+    std::vector<Packet> EncodeGroup(const std::vector<Packet>& packets) {
+        std::vector<Packet> wire;
+        for (const auto& packet : packets) {
+            const size_t size = encoder.Encode(packet.data(), packet.size(), buffer.data());
+            wire.emplace_back(buffer.begin(), buffer.begin() + size);
+        }
+        const size_t parity = encoder.TakeParity(buffer.data());
+        wire.emplace_back(buffer.begin(), buffer.begin() + parity);
+        return wire;
+    }
+
+    std::vector<Packet> Decode(const Packet& framed) {
+        std::array<FecPacketView, 2> out{};
+        const size_t count = decoder.Decode(framed.data(), framed.size(), out);
+        std::vector<Packet> packets;
+        for (size_t i = 0; i < count; ++i) {
+            packets.emplace_back(out[i].data, out[i].data + out[i].size);
+        }
+        return packets;
+    }
+
+    std::vector<Packet> Group(uint8_t first_seed) {
+        return {GamePacket(first_seed, 120), GamePacket(first_seed + 1, 64),
+                GamePacket(first_seed + 2, 200), GamePacket(first_seed + 3, 90)};
+    }
+
+    FecEncoder encoder{FecConfig{4}};
+    FecDecoder decoder;
+    std::array<uint8_t, FecEncoder::MAX_FRAMED_SIZE> buffer{};
+};
+
+} // anonymous namespace
+
+TEST_F(FecCodecTest, EmitsParityAfterEachGroup) {
+    const auto packets = Group(0);
+    for (size_t i = 0; i < packets.size(); ++i) {
+        const size_t size = encoder.Encode(packets[i].data(), packets[i].size(), buffer.data());
+        EXPECT_EQ(size, FecEncoder::HEADER_SIZE + packets[i].size());
+        EXPECT_EQ(buffer[0], FecEncoder::KIND_DATA);
+        const size_t parity = encoder.TakeParity(buffer.data());
+        if (i + 1 < packets.size()) {
+            EXPECT_EQ(parity, 0u);
+        } else {
+            // Padded to the longest packet of the group
+            EXPECT_EQ(parity, FecEncoder::HEADER_SIZE + FecEncoder::PARITY_LENGTH_SIZE + 200);
+            EXPECT_EQ(buffer[0], FecEncoder::KIND_PARITY);
+        }
+    }
+    EXPECT_EQ(encoder.GetStatistics().data_packets_sent, 4u);
+    EXPECT_EQ(encoder.GetStatistics().parity_packets_sent, 1u);
+}
+
+TEST_F(FecCodecTest, RegroupsFromTheNextGroup) {
+    encoder.Encode(GamePacket(0, 100).data(), 100, buffer.data());
+    encoder.SetGroupSize(2);
+    // The group under way keeps its four packets
+    for (uint8_t seed = 1; seed < 4; ++seed) {
+        EXPECT_EQ(encoder.TakeParity(buffer.data()), 0u);
+        encoder.Encode(GamePacket(seed, 100).data(), 100, buffer.data());
+    }
+    EXPECT_NE(encoder.TakeParity(buffer.data()), 0u);
+
+    const auto wire = EncodeGroup({GamePacket(4, 80), GamePacket(5, 60)});
+    ASSERT_EQ(wire.size(), 3u);
+    EXPECT_EQ(wire[2][0], FecEncoder::KIND_PARITY);
+    // The smaller group still recovers a loss
+    EXPECT_EQ(Decode(wire[0]).size(), 1u);
+    const auto recovered = Decode(wire[2]);
+    ASSERT_EQ(recovered.size(), 1u);
+    EXPECT_EQ(recovered[0], GamePacket(5, 60));
+}
+
+TEST_F(FecCodecTest, RecoversAnySingleLoss) {
+    for (size_t lost = 0; lost < 4; ++lost) {
+        const auto packets = Group(static_cast<uint8_t>(lost * 4));
+        const auto wire = EncodeGroup(packets);
+
+        std::vector<Packet> received;
+        for (size_t i = 0; i < wire.size(); ++i) {
+            if (i == lost) {
+                continue;
+            }
+            for (auto& packet : Decode(wire[i])) {
+                received.push_back(std::move(packet));
+            }
+        }
+        ASSERT_EQ(received.size(), 4u) << "lost index " << lost;
+        EXPECT_EQ(received.back(), packets[lost]) << "lost index " << lost;
+    }
+    EXPECT_EQ(decoder.GetStatistics().packets_received, 12u);
+    EXPECT_EQ(decoder.GetStatistics().packets_recovered, 4u);
+}
+
+TEST_F(FecCodecTest, RecoversWhenParityArrivesFirst) {
+    const auto packets = Group(0);
+    const auto wire = EncodeGroup(packets);
+
+    EXPECT_TRUE(Decode(wire[4]).empty());
+    EXPECT_EQ(Decode(wire[0]).size(), 1u);
+    EXPECT_EQ(Decode(wire[2]).size(), 1u);
+    const auto last = Decode(wire[3]);
+    ASSERT_EQ(last.size(), 2u);
+    EXPECT_EQ(last[0], packets[3]);
+    EXPECT_EQ(last[1], packets[1]);
+
+    // The missing packet turning up late is not delivered twice
+    EXPECT_TRUE(Decode(wire[1]).empty());
+}
+
+TEST_F(FecCodecTest, SuppressesDuplicates) {
+    const auto wire = EncodeGroup(Group(0));
+    EXPECT_EQ(Decode(wire[0]).size(), 1u);
+    EXPECT_TRUE(Decode(wire[0]).empty());
+    EXPECT_EQ(decoder.GetStatistics().packets_received, 1u);
+}
+
+TEST_F(FecCodecTest, CountsUnrecoverableLosses) {
+    // Two losses in the first group, and the parity lost in the second
+    const auto first = EncodeGroup(Group(0));
+    Decode(first[0]);
+    Decode(first[3]);
+    Decode(first[4]);
+    const auto second = EncodeGroup(Group(4));
+    for (size_t i = 0; i < 4; ++i) {
+        EXPECT_EQ(Decode(second[i]).size(), 1u);
+    }
+
+    // Groups are settled once they fall out of the window
+    for (uint8_t seed = 8; seed < 8 + 4 * FecDecoder::GROUP_WINDOW; seed += 4) {
+        const auto wire = EncodeGroup(Group(seed));
+        for (const auto& framed : wire) {
+            Decode(framed);
+        }
+    }
+    EXPECT_EQ(decoder.GetStatistics().packets_recovered, 0u);
+    EXPECT_EQ(decoder.GetStatistics().packets_lost, 2u);
+}
+
+TEST_F(FecCodecTest, DeliversPacketsOfRetiredGroups) {
+    const auto late = EncodeGroup(Group(0));
+    for (uint8_t seed = 4; seed < 4 + 4 * FecDecoder::GROUP_WINDOW; seed += 4) {
+        for (const auto& framed : EncodeGroup(Group(seed))) {
+            Decode(framed);
+        }
+    }
+    // Too old to recover, but a late packet is still better than none
+    const auto packets = Decode(late[1]);
+    ASSERT_EQ(packets.size(), 1u);
+    EXPECT_EQ(packets[0], GamePacket(1, 64));
+    EXPECT_TRUE(Decode(late[4]).empty());
+}
+
+TEST_F(FecCodecTest, RejectsMalformedPackets) {
+    auto wire = EncodeGroup(Group(0));
+    EXPECT_TRUE(Decode(Packet(FecEncoder::HEADER_SIZE - 1, 0x01)).empty());
+
+    Packet bad_index = wire[0];
+    bad_index[3] = 4;
+    EXPECT_TRUE(Decode(bad_index).empty());
+
+    Packet bad_size = wire[0];
+    bad_size[4] = FecEncoder::MAX_GROUP_SIZE + 1;
+    EXPECT_TRUE(Decode(bad_size).empty());
+
+    EXPECT_EQ(decoder.GetStatistics().packets_received, 0u);
+}
+
+TEST_F(FecCodecTest, KeepsStreamsPerNode) {
+    FecCodec codec{FecConfig{2}};
+    std::array<uint8_t, FecCodec::MAX_FRAMED_SIZE> framed{};
+    const Packet a = GamePacket(1, 50);
+    const Packet b = GamePacket(2, 70);
+
+    // Node 1 completes a group after two packets; node 2 has sent only one
+    std::vector<Packet> to_node_1;
+    for (const auto* packet : {&a, &b}) {
+        const size_t size = codec.Encode(1, packet->data(), packet->size(), framed.data());
+        to_node_1.emplace_back(framed.begin(), framed.begin() + size);
+    }
+    codec.Encode(2, a.data(), a.size(), framed.data());
+    EXPECT_EQ(codec.TakeParity(2, framed.data()), 0u);
+    const size_t parity = codec.TakeParity(1, framed.data());
+    ASSERT_NE(parity, 0u);
+    to_node_1.emplace_back(framed.begin(), framed.begin() + parity);
+
+    FecCodec receiver{FecConfig{2}};
+    std::array<FecPacketView, 2> out{};
+    EXPECT_EQ(receiver.Decode(1, to_node_1[1].data(), to_node_1[1].size(), out), 1u);
+    ASSERT_EQ(receiver.Decode(1, to_node_1[2].data(), to_node_1[2].size(), out), 1u);
+    EXPECT_EQ(Packet(out[0].data, out[0].data + out[0].size), a);
+
+    receiver.ResetNode(1);
+    EXPECT_EQ(receiver.GetStatistics().packets_recovered, 0u);
+    EXPECT_EQ(codec.GetStatistics().data_packets_sent, 3u);
+    EXPECT_EQ(codec.GetStatistics().parity_packets_sent, 1u);
+}
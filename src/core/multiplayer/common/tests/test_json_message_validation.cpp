@@ -0,0 +1,117 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core/multiplayer/common/network_security.h"
+#include "core/multiplayer/common/secure_network_handler.h"
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <string>
+
+using namespace Core::Multiplayer;
+using namespace Core::Multiplayer::Security;
+using json = nlohmann::json;
+
+namespace {
+std::string Nested(size_t depth) {
+    // depth - 1 arrays around a scalar
+    return std::string(depth - 1, '[') + "0" + std::string(depth - 1, ']');
+}
+
+std::string ArrayOf(size_t count) {
+    std::string str = "[";
+    for (size_t i = 0; i < count; ++i) {
+        str += i == 0 ? "1" : ",1";
+    }
+    return str + "]";
+}
+
+std::string ObjectOf(size_t count) {
+    std::string str = "{";
+    for (size_t i = 0; i < count; ++i) {
+        str += (i == 0 ? "\"k" : ",\"k") + std::to_string(i) + "\":1";
+    }
+    return str + "}";
+}
+
+void ExpectSameVerdict(const std::string& str, bool valid) {
+    EXPECT_EQ(NetworkInputValidator::ValidateJsonMessage(str).is_valid, valid) << str;
+    json document;
+    EXPECT_EQ(NetworkInputValidator::ParseJsonMessage(str, document).is_valid, valid) << str;
+    if (valid) {
+        EXPECT_EQ(document, json::parse(str));
+    } else {
+        EXPECT_TRUE(document.is_null());
+    }
+}
+} // namespace
+
+TEST(JsonMessageValidationTest, EnforcesDepthWhileParsing) {
+    ExpectSameVerdict(Nested(MAX_JSON_DEPTH), true);
+    ExpectSameVerdict(Nested(MAX_JSON_DEPTH + 1), false);
+    ExpectSameVerdict("{\"a\":" + Nested(MAX_JSON_DEPTH - 1) + "}", true);
+    ExpectSameVerdict("{\"a\":" + Nested(MAX_JSON_DEPTH) + "}", false);
+}
+
+TEST(JsonMessageValidationTest, EnforcesContainerSizes) {
+    ExpectSameVerdict(ArrayOf(MAX_JSON_ARRAY_SIZE), true);
+    ExpectSameVerdict(ArrayOf(MAX_JSON_ARRAY_SIZE + 1), false);
+    ExpectSameVerdict(ObjectOf(MAX_JSON_OBJECT_SIZE), true);
+    ExpectSameVerdict(ObjectOf(MAX_JSON_OBJECT_SIZE + 1), false);
+    ExpectSameVerdict("{\"list\":" + ArrayOf(MAX_JSON_ARRAY_SIZE + 1) + "}", false);
+}
+
+TEST(JsonMessageValidationTest, RejectsMalformedAndSuspiciousText) {
+    ExpectSameVerdict("{\"type\":\"chat\",\"text\":\"hi\"}", true);
+    ExpectSameVerdict("{\"type\":\"chat\",", false);
+    ExpectSameVerdict("{} {}", false);
+    ExpectSameVerdict("{\"text\":\"<script>\"}", false);
+    ExpectSameVerdict("{\"text\":\"\xC0\xAF\"}", false);
+}
+
+TEST(JsonMessageValidationTest, HandlerReceivesTheParsedDocument) {
+    SecureNetworkHandler handler;
+    json received;
+    int raw_calls = 0;
+    handler.SetJsonMessageHandler([&](const std::string&, const std::string&) { ++raw_calls; });
+    handler.SetParsedJsonMessageHandler(
+        [&](const std::string&, const json& message) { received = message; });
+
+    EXPECT_TRUE(handler.HandleIncomingJsonMessage("client", "10.0.0.1",
+                                                  "{\"type\":\"join\",\"room\":7}"));
+    EXPECT_EQ(raw_calls, 1);
+    EXPECT_EQ(received["type"], "join");
+    EXPECT_EQ(received["room"], 7);
+
+    EXPECT_FALSE(handler.HandleIncomingJsonMessage("client", "10.0.0.1", Nested(20)));
+    EXPECT_EQ(raw_calls, 1);
+}
+
+TEST(JsonMessageValidationTest, HandlerBuildsSecurityOnFirstInboundTraffic) {
+    SecureNetworkHandler handler;
+    EXPECT_FALSE(handler.IsSecurityManagerBuilt());
+    EXPECT_EQ(handler.GetSecurityStatistics().json_messages_accepted, 0u);
+    handler.HandleClientDisconnection("client", "10.0.0.1", "c1");
+    EXPECT_FALSE(handler.IsSecurityManagerBuilt());
+
+    EXPECT_TRUE(handler.HandleIncomingJsonMessage("client", "10.0.0.1", "{\"type\":\"ping\"}"));
+    EXPECT_TRUE(handler.IsSecurityManagerBuilt());
+    EXPECT_EQ(handler.GetSecurityStatistics().json_messages_accepted, 1u);
+}
+
+TEST(JsonMessageValidationTest, ValidatesProtocolNamesAndPeerIds) {
+    EXPECT_TRUE(NetworkInputValidator::ValidateProtocolName("/sudachi/ldn/1.0.0").is_valid);
+    EXPECT_TRUE(NetworkInputValidator::ValidateProtocolName("/ipfs-id").is_valid);
+    EXPECT_FALSE(NetworkInputValidator::ValidateProtocolName("/v1.0").is_valid);
+    EXPECT_FALSE(NetworkInputValidator::ValidateProtocolName("/sudachi//ldn").is_valid);
+    EXPECT_FALSE(NetworkInputValidator::ValidateProtocolName("/sudachi/ldn/").is_valid);
+    EXPECT_FALSE(NetworkInputValidator::ValidateProtocolName("sudachi/ldn").is_valid);
+    EXPECT_FALSE(NetworkInputValidator::ValidateProtocolName("/sudachi/l dn").is_valid);
+
+    EXPECT_TRUE(
+        NetworkInputValidator::ValidatePeerId("12D3KooWGzxzKZYveHXtpG6AsrUJBcWxHBFS2HsEoGTxrMLvKXtf")
+            .is_valid);
+    EXPECT_FALSE(NetworkInputValidator::ValidatePeerId("12D3KooW0").is_valid);
+    EXPECT_FALSE(NetworkInputValidator::ValidatePeerId("QmIl").is_valid);
+    EXPECT_FALSE(NetworkInputValidator::ValidatePeerId(std::string("Qm\0x", 4)).is_valid);
+}
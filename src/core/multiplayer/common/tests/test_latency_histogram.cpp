@@ -0,0 +1,124 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core/multiplayer/common/latency_histogram.h"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace Core::Multiplayer;
+
+TEST(LatencyHistogramTest, EmptySnapshotIsZero) {
+    LatencyHistogram histogram;
+    const auto snapshot = histogram.Snapshot();
+    EXPECT_EQ(snapshot.count, 0u);
+    EXPECT_EQ(snapshot.min_ns, 0u);
+    EXPECT_EQ(snapshot.max_ns, 0u);
+    EXPECT_EQ(snapshot.p99_ns, 0u);
+}
+
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+    LatencyHistogram histogram;
+    for (uint64_t ns = 1; ns <= 50; ++ns) {
+        histogram.Record(ns);
+    }
+    const auto snapshot = histogram.Snapshot();
+    EXPECT_EQ(snapshot.count, 50u);
+    EXPECT_EQ(snapshot.min_ns, 1u);
+    EXPECT_EQ(snapshot.max_ns, 50u);
+    EXPECT_EQ(snapshot.mean_ns, 25u);
+    EXPECT_EQ(snapshot.p50_ns, 25u);
+    EXPECT_EQ(snapshot.p90_ns, 45u);
+    EXPECT_EQ(snapshot.p99_ns, 49u);
+}
+
+TEST(LatencyHistogramTest, LargeValuesAreWithinBucketPrecision) {
+    for (const uint64_t ns : {100ull, 1'000ull, 123'456ull, 9'876'543'210ull}) {
+        LatencyHistogram histogram;
+        for (int i = 0; i < 100; ++i) {
+            histogram.Record(ns);
+        }
+        const auto snapshot = histogram.Snapshot();
+        EXPECT_EQ(snapshot.p50_ns, ns);
+        EXPECT_EQ(snapshot.max_ns, ns);
+
+        const uint64_t lower = LatencyHistogram::LowerBound(LatencyHistogram::BucketFor(ns));
+        EXPECT_LE(lower, ns);
+        EXPECT_GE(static_cast<double>(lower), static_cast<double>(ns) * 0.96);
+    }
+}
+
+TEST(LatencyHistogramTest, BucketsAreMonotonic) {
+    size_t previous = 0;
+    for (uint64_t ns = 0; ns < (uint64_t{1} << 20); ns += 7) {
+        const size_t bucket = LatencyHistogram::BucketFor(ns);
+        EXPECT_GE(bucket, previous);
+        EXPECT_LE(LatencyHistogram::LowerBound(bucket), ns);
+        previous = bucket;
+    }
+}
+
+TEST(LatencyHistogramTest, HugeValuesClampToLastBucket) {
+    EXPECT_EQ(LatencyHistogram::BucketFor(~uint64_t{0}), LatencyHistogram::BUCKET_COUNT - 1);
+    EXPECT_EQ(LatencyHistogram::BucketFor(uint64_t{1} << 40), LatencyHistogram::BUCKET_COUNT - 1);
+}
+
+TEST(LatencyHistogramTest, TailPercentilesSeparateOutliers) {
+    LatencyHistogram histogram;
+    for (int i = 0; i < 9'980; ++i) {
+        histogram.Record(uint64_t{1'000});
+    }
+    for (int i = 0; i < 20; ++i) {
+        histogram.Record(uint64_t{1'000'000});
+    }
+    const auto snapshot = histogram.Snapshot();
+    EXPECT_EQ(snapshot.p99_ns, 1'000u);
+    EXPECT_GT(snapshot.p999_ns, 900'000u);
+    EXPECT_EQ(snapshot.max_ns, 1'000'000u);
+}
+
+TEST(LatencyHistogramTest, MergesRecordsFromManyThreads) {
+    LatencyHistogram histogram;
+    constexpr int THREADS = 12;
+    constexpr int RECORDS = 10'000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&histogram, t] {
+            for (int i = 0; i < RECORDS; ++i) {
+                histogram.Record(static_cast<uint64_t>(t + 1) * 1'000);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    const auto snapshot = histogram.Snapshot();
+    EXPECT_EQ(snapshot.count, static_cast<uint64_t>(THREADS * RECORDS));
+    EXPECT_EQ(snapshot.min_ns, 1'000u);
+    EXPECT_EQ(snapshot.max_ns, 12'000u);
+}
+
+TEST(DataPathLatencyTest, RecordsEachHopSeparately) {
+    DataPathLatency latency;
+    latency.Record(DataPathHop::TransportWrite, 5'000);
+    latency.Record(DataPathHop::TransportWrite, 7'000);
+    latency.RecordSince(DataPathHop::ReceiveDequeue, DataPathLatency::Now());
+
+    const auto statistics = latency.Snapshot();
+    EXPECT_EQ(statistics[DataPathHop::TransportWrite].count, 2u);
+    EXPECT_EQ(statistics[DataPathHop::TransportWrite].max_ns, 7'000u);
+    EXPECT_EQ(statistics[DataPathHop::ReceiveDequeue].count, 1u);
+    EXPECT_EQ(statistics[DataPathHop::BridgeEntry].count, 0u);
+}
+
+TEST(DataPathLatencyTest, StandInRecordsNothing) {
+    NullDataPathLatency latency;
+    latency.Record(DataPathHop::TransportWrite, 5'000);
+    latency.RecordSince(DataPathHop::ReceiveDequeue, NullDataPathLatency::Now());
+
+    EXPECT_EQ(latency.Snapshot()[DataPathHop::TransportWrite].count, 0u);
+    EXPECT_EQ(GetRecordableLatency(latency), nullptr);
+
+    DataPathLatency recorded;
+    EXPECT_EQ(GetRecordableLatency(recorded), &recorded);
+}
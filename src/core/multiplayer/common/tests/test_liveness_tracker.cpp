@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core/multiplayer/common/liveness_tracker.h"
+#include <gtest/gtest.h>
+
+using namespace Core::Multiplayer;
+using namespace std::chrono_literals;
+
+namespace {
+
+LivenessConfig TestConfig() {
+    LivenessConfig config;
+    config.initial_interval = 10s;
+    config.min_interval = 2s;
+    config.max_interval = 30s;
+    config.probe_step = 5s;
+    config.safety_margin = 0.5;
+    return config;
+}
+
+} // namespace
+
+TEST(LivenessTrackerTest, TrafficDefersKeepalive) {
+    const auto start = LivenessTracker::Clock::now();
+    LivenessTracker tracker(TestConfig());
+    tracker.Reset(start);
+
+    EXPECT_EQ(tracker.TimeUntilKeepalive(start + 4s), 6s);
+    tracker.OnSent(start + 8s);
+    EXPECT_EQ(tracker.TimeUntilKeepalive(start + 12s), 6s);
+    EXPECT_EQ(tracker.TimeUntilKeepalive(start + 19s), 0s);
+
+    // Receiving alone does not refresh the peer's view of us
+    tracker.OnReceived(start + 17s);
+    EXPECT_EQ(tracker.TimeUntilKeepalive(start + 18s), 0s);
+}
+
+TEST(LivenessTrackerTest, AnsweredProbeGrowsIntervalUpToMaximum) {
+    const auto start = LivenessTracker::Clock::now();
+    LivenessTracker tracker(TestConfig());
+    tracker.Reset(start);
+
+    auto now = start;
+    for (int i = 0; i < 6; ++i) {
+        now += tracker.GetKeepaliveInterval();
+        tracker.OnKeepaliveSent(now);
+        EXPECT_TRUE(tracker.HasOutstandingProbe());
+        now += 50ms;
+        tracker.OnReceived(now);
+        EXPECT_FALSE(tracker.HasOutstandingProbe());
+    }
+    EXPECT_EQ(tracker.GetKeepaliveInterval(), 30s);
+    EXPECT_EQ(tracker.GetKeepaliveCount(), 6u);
+}
+
+TEST(LivenessTrackerTest, ShortIdleProbeDoesNotGrowInterval) {
+    const auto start = LivenessTracker::Clock::now();
+    LivenessTracker tracker(TestConfig());
+    tracker.Reset(start);
+
+    // Inbound traffic a second before the keepalive: only 1s of idle is proven
+    tracker.OnReceived(start + 9s);
+    tracker.OnKeepaliveSent(start + 10s);
+    tracker.OnReceived(start + 10s + 50ms);
+    EXPECT_EQ(tracker.GetKeepaliveInterval(), 10s);
+}
+
+TEST(LivenessTrackerTest, LostProbeLowersIntervalAndCeiling) {
+    const auto start = LivenessTracker::Clock::now();
+    LivenessTracker tracker(TestConfig());
+    tracker.Reset(start);
+
+    tracker.OnKeepaliveSent(start + 10s);
+    EXPECT_EQ(tracker.GetProbeAge(start + 11s), 1s);
+    tracker.OnBindingLost();
+
+    EXPECT_FALSE(tracker.HasOutstandingProbe());
+    EXPECT_EQ(tracker.GetKeepaliveInterval(), 5s);
+    EXPECT_EQ(tracker.GetIntervalCeiling(), 5s);
+
+    // Later answers cannot push it back past what broke
+    tracker.OnKeepaliveSent(start + 15s);
+    tracker.OnReceived(start + 15s + 50ms);
+    EXPECT_EQ(tracker.GetKeepaliveInterval(), 5s);
+}
+
+TEST(LivenessTrackerTest, LossWithoutProbeKeepsInterval) {
+    LivenessTracker tracker(TestConfig());
+    tracker.OnBindingLost();
+    EXPECT_EQ(tracker.GetKeepaliveInterval(), 10s);
+    EXPECT_EQ(tracker.GetIntervalCeiling(), 30s);
+}
+
+TEST(LivenessTrackerTest, IntervalNeverDropsBelowMinimum) {
+    const auto start = LivenessTracker::Clock::now();
+    LivenessTracker tracker(TestConfig());
+    tracker.Reset(start);
+
+    tracker.OnKeepaliveSent(start + 3s);
+    tracker.OnBindingLost();
+    EXPECT_EQ(tracker.GetKeepaliveInterval(), 2s);
+}
@@ -0,0 +1,87 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core/multiplayer/common/lock_contention.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <shared_mutex>
+#include <thread>
+
+using namespace Core::Multiplayer;
+using namespace std::chrono_literals;
+
+namespace {
+
+class LockContentionTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ResetLockContentionStatistics();
+    }
+};
+
+TEST_F(LockContentionTest, UncontendedLockRecordsNothing) {
+    ProfiledMutex<LockSite::RoomClientConnection> mutex;
+    for (int i = 0; i < 100; ++i) {
+        std::lock_guard lock(mutex);
+    }
+    const auto stats = GetLockContentionStatistics()[LockSite::RoomClientConnection];
+    EXPECT_EQ(stats.contended, 0u);
+    EXPECT_EQ(stats.wait_ns, 0u);
+}
+
+TEST_F(LockContentionTest, BlockedLockRecordsItsWait) {
+    ProfiledMutex<LockSite::P2PPeerWrite> mutex;
+    std::atomic<bool> held{false};
+    std::thread holder([&] {
+        std::lock_guard lock(mutex);
+        held = true;
+        std::this_thread::sleep_for(20ms);
+    });
+    while (!held) {
+        std::this_thread::yield();
+    }
+    {
+        std::lock_guard lock(mutex);
+    }
+    holder.join();
+
+    const auto statistics = GetLockContentionStatistics();
+    EXPECT_EQ(statistics[LockSite::P2PPeerWrite].contended, 1u);
+    EXPECT_GE(statistics[LockSite::P2PPeerWrite].wait_ns, 5'000'000u);
+    // Other sites are untouched
+    EXPECT_EQ(statistics[LockSite::P2PState].contended, 0u);
+}
+
+TEST_F(LockContentionTest, SharedLocksOnlyWaitForWriters) {
+    ProfiledMutex<LockSite::RateLimiterShard, std::shared_mutex> mutex;
+    {
+        std::shared_lock first(mutex);
+        std::shared_lock second(mutex);
+        EXPECT_FALSE(mutex.try_lock());
+    }
+    EXPECT_EQ(GetLockContentionStatistics()[LockSite::RateLimiterShard].contended, 0u);
+
+    std::atomic<bool> held{false};
+    std::thread writer([&] {
+        std::unique_lock lock(mutex);
+        held = true;
+        std::this_thread::sleep_for(10ms);
+    });
+    while (!held) {
+        std::this_thread::yield();
+    }
+    {
+        std::shared_lock lock(mutex);
+    }
+    writer.join();
+    EXPECT_EQ(GetLockContentionStatistics()[LockSite::RateLimiterShard].contended, 1u);
+}
+
+TEST_F(LockContentionTest, EverySiteHasAName) {
+    for (size_t i = 0; i < static_cast<size_t>(LockSite::Count); ++i) {
+        EXPECT_STRNE(GetLockSiteName(static_cast<LockSite>(i)), "unknown");
+    }
+}
+
+} // namespace
@@ -0,0 +1,83 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core/multiplayer/common/memory_accounting.h"
+#include "core/multiplayer/common/backend_stats.h"
+#include "core/multiplayer/common/network_security.h"
+#include "core/multiplayer/common/packet_buffer.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace Core::Multiplayer;
+
+TEST(MemoryAccountingTest, TracksLiveBytesAndHighWater) {
+    TrackedMemoryResource resource;
+    {
+        std::pmr::vector<uint8_t> first(1000, 0, &resource);
+        EXPECT_EQ(resource.GetStatistics().live_bytes, 1000u);
+        {
+            std::pmr::vector<uint8_t> second(500, 0, &resource);
+            EXPECT_EQ(resource.GetStatistics().live_bytes, 1500u);
+            EXPECT_EQ(resource.GetStatistics().live_allocations, 2u);
+        }
+        EXPECT_EQ(resource.GetStatistics().live_bytes, 1000u);
+    }
+    const auto stats = resource.GetStatistics();
+    EXPECT_EQ(stats.live_bytes, 0u);
+    EXPECT_EQ(stats.high_water_bytes, 1500u);
+    EXPECT_EQ(stats.live_allocations, 0u);
+    EXPECT_EQ(stats.total_allocations, 2u);
+
+    resource.ResetHighWater();
+    EXPECT_EQ(resource.GetStatistics().high_water_bytes, 0u);
+}
+
+TEST(MemoryAccountingTest, ResourcesAreDistinctPerSubsystem) {
+    EXPECT_EQ(GetMemoryResource(MemorySubsystem::Relay), GetMemoryResource(MemorySubsystem::Relay));
+    EXPECT_NE(GetMemoryResource(MemorySubsystem::Relay), GetMemoryResource(MemorySubsystem::Mdns));
+    EXPECT_FALSE(GetMemoryResource(MemorySubsystem::Relay)
+                     ->is_equal(*GetMemoryResource(MemorySubsystem::Mdns)));
+    EXPECT_STREQ(GetMemorySubsystemName(MemorySubsystem::SecurityTables), "security_tables");
+}
+
+TEST(MemoryAccountingTest, PacketPoolChargesItsSlab) {
+    const uint64_t before = GetMemoryStatistics()[MemorySubsystem::PacketPool].live_bytes;
+    {
+        PacketPool pool(16);
+        const uint64_t charged =
+            GetMemoryStatistics()[MemorySubsystem::PacketPool].live_bytes - before;
+        EXPECT_GE(charged, 16 * sizeof(PacketBufferSlot));
+
+        // Acquiring buffers reuses the slab
+        auto buffer = pool.Acquire();
+        EXPECT_EQ(GetMemoryStatistics()[MemorySubsystem::PacketPool].live_bytes - before, charged);
+    }
+    EXPECT_EQ(GetMemoryStatistics()[MemorySubsystem::PacketPool].live_bytes, before);
+}
+
+TEST(MemoryAccountingTest, RateLimitTablesChargePerClient) {
+    const uint64_t before = GetMemoryStatistics()[MemorySubsystem::SecurityTables].live_bytes;
+    Security::RateLimitConfig config;
+    Security::ClientRateManager manager(config);
+    for (int i = 0; i < 100; ++i) {
+        manager.CheckPacketRateLimit("client-" + std::to_string(i));
+    }
+    const uint64_t with_clients =
+        GetMemoryStatistics()[MemorySubsystem::SecurityTables].live_bytes;
+    EXPECT_GT(with_clients, before);
+
+    for (int i = 0; i < 100; ++i) {
+        manager.RemoveClient("client-" + std::to_string(i));
+    }
+    EXPECT_LT(GetMemoryStatistics()[MemorySubsystem::SecurityTables].live_bytes, with_clients);
+}
+
+TEST(MemoryAccountingTest, BackendStatsCarryMemoryStatistics) {
+    PacketPool pool(4);
+    BackendStatsRecorder recorder;
+    BackendStats stats;
+    recorder.Fill(stats);
+    EXPECT_GE(stats.memory[MemorySubsystem::PacketPool].live_bytes, 4 * sizeof(PacketBufferSlot));
+    EXPECT_GE(stats.memory.TotalLiveBytes(), stats.memory[MemorySubsystem::PacketPool].live_bytes);
+}
@@ -0,0 +1,125 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "core/multiplayer/common/latency_histogram.h"
+#include "core/multiplayer/common/metrics_exporter.h"
+#include "core/multiplayer/common/metrics_writer.h"
+
+using namespace Core::Multiplayer;
+
+namespace {
+
+// Sends request to the exporter and reads until it closes the connection
+std::string Fetch(uint16_t port, const std::string& request) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return {};
+    }
+    ::send(fd, request.data(), request.size(), 0);
+    std::string response;
+    std::array<char, 1024> buffer;
+    ssize_t received;
+    while ((received = ::recv(fd, buffer.data(), buffer.size(), 0)) > 0) {
+        response.append(buffer.data(), static_cast<size_t>(received));
+    }
+    ::close(fd);
+    return response;
+}
+
+} // namespace
+
+TEST(MetricsWriterTest, WritesFamiliesOnce) {
+    std::string output;
+    MetricsWriter writer(output);
+    writer.Counter("relay_dropped_total", "Dropped datagrams", 3, {{"reason", "malformed"}});
+    writer.Counter("relay_dropped_total", "Dropped datagrams", 4, {{"reason", "rate_limited"}});
+    writer.Gauge("relay_sessions", "Active sessions", 2);
+    writer.Gauge("room_info", "Label escaping", 1, {{"name", "a\"b\\c\nd"}});
+
+    EXPECT_EQ(output, "# HELP relay_dropped_total Dropped datagrams\n"
+                      "# TYPE relay_dropped_total counter\n"
+                      "relay_dropped_total{reason=\"malformed\"} 3\n"
+                      "relay_dropped_total{reason=\"rate_limited\"} 4\n"
+                      "# HELP relay_sessions Active sessions\n"
+                      "# TYPE relay_sessions gauge\n"
+                      "relay_sessions 2\n"
+                      "# HELP room_info Label escaping\n"
+                      "# TYPE room_info gauge\n"
+                      "room_info{name=\"a\\\"b\\\\c\\nd\"} 1\n");
+}
+
+TEST(MetricsWriterTest, ExportsHistogramsInSeconds) {
+    LatencyHistogram histogram;
+    histogram.Record(40'000);    // Under the first bound
+    histogram.Record(2'000'000); // 2 ms
+    histogram.Record(2'000'000);
+    histogram.Record(5'000'000'000); // Past every bound
+
+    std::string output;
+    MetricsWriter writer(output);
+    constexpr std::array<uint64_t, 3> bounds{100'000, 2'500'000, 1'000'000'000};
+    writer.Histogram("relay_batch_seconds", "Batch time", histogram, {{"reactor", "0"}}, bounds);
+
+    EXPECT_EQ(output, "# HELP relay_batch_seconds Batch time\n"
+                      "# TYPE relay_batch_seconds histogram\n"
+                      "relay_batch_seconds_bucket{reactor=\"0\",le=\"0.0001\"} 1\n"
+                      "relay_batch_seconds_bucket{reactor=\"0\",le=\"0.0025\"} 3\n"
+                      "relay_batch_seconds_bucket{reactor=\"0\",le=\"1\"} 3\n"
+                      "relay_batch_seconds_bucket{reactor=\"0\",le=\"+Inf\"} 4\n"
+                      "relay_batch_seconds_sum{reactor=\"0\"} 5.00404\n"
+                      "relay_batch_seconds_count{reactor=\"0\"} 4\n");
+}
+
+TEST(MetricsExporterTest, ServesMetricsOverHttp) {
+    MetricsExporterConfig config;
+    config.port = 0;
+    MetricsExporter exporter(config);
+    std::atomic<uint64_t> packets{0};
+    exporter.AddCollector([&packets](MetricsWriter& writer) {
+        writer.Counter("test_packets_total", "Packets", packets.load());
+    });
+    ASSERT_EQ(exporter.Start(), ErrorCode::Success);
+    ASSERT_NE(exporter.GetPort(), 0);
+
+    packets = 7;
+    const std::string response =
+        Fetch(exporter.GetPort(), "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    EXPECT_EQ(response.rfind("HTTP/1.1 200 OK\r\n", 0), 0u) << response;
+    EXPECT_NE(response.find("Content-Type: text/plain; version=0.0.4"), std::string::npos);
+    EXPECT_NE(response.find("\r\n\r\n# HELP test_packets_total Packets\n"), std::string::npos);
+    EXPECT_NE(response.find("\ntest_packets_total 7\n"), std::string::npos);
+
+    // A query string is ignored; the collectors run again for every scrape
+    packets = 8;
+    EXPECT_NE(Fetch(exporter.GetPort(), "GET /metrics?x=1 HTTP/1.1\r\n\r\n")
+                  .find("\ntest_packets_total 8\n"),
+              std::string::npos);
+    EXPECT_EQ(exporter.GetScrapeCount(), 2u);
+
+    EXPECT_EQ(Fetch(exporter.GetPort(), "GET / HTTP/1.1\r\n\r\n").rfind("HTTP/1.1 404", 0), 0u);
+    EXPECT_EQ(Fetch(exporter.GetPort(), "POST /metrics HTTP/1.1\r\n\r\n").rfind("HTTP/1.1 405", 0),
+              0u);
+    EXPECT_EQ(Fetch(exporter.GetPort(), std::string(MetricsExporter::MAX_REQUEST_SIZE + 1, 'x'))
+                  .rfind("HTTP/1.1 431", 0),
+              0u);
+    EXPECT_EQ(exporter.GetScrapeCount(), 2u);
+
+    exporter.Stop();
+    EXPECT_FALSE(exporter.IsRunning());
+}
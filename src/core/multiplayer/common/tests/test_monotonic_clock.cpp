@@ -0,0 +1,50 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core/multiplayer/common/monotonic_clock.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+
+using namespace Core::Multiplayer;
+
+TEST(MonotonicClockTest, NeverGoesBackwards) {
+    uint64_t previous = MonotonicClock::Now();
+    for (int i = 0; i < 100000; ++i) {
+        const uint64_t now = MonotonicClock::Now();
+        ASSERT_GE(now, previous);
+        previous = now;
+    }
+}
+
+TEST(MonotonicClockTest, StartsOnTheSteadyClockEpoch) {
+    const uint64_t steady = MonotonicClock::SteadyNow();
+    const uint64_t now = MonotonicClock::Now();
+    const uint64_t difference = now > steady ? now - steady : steady - now;
+    EXPECT_LT(difference, 50'000'000u);
+}
+
+TEST(MonotonicClockTest, TracksSteadyClockRate) {
+    const uint64_t steady_start = MonotonicClock::SteadyNow();
+    const uint64_t start = MonotonicClock::Now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    const uint64_t elapsed = MonotonicClock::Now() - start;
+    const uint64_t steady_elapsed = MonotonicClock::SteadyNow() - steady_start;
+
+    // Within 1% plus the time between the paired reads
+    const uint64_t tolerance = steady_elapsed / 100 + 1'000'000;
+    EXPECT_LE(elapsed, steady_elapsed + tolerance);
+    EXPECT_GE(elapsed + tolerance, steady_elapsed);
+}
+
+TEST(MonotonicClockTest, ReportsCounterOnSupportedHosts) {
+    const auto source = MonotonicClock::GetSource();
+#if defined(__aarch64__)
+    EXPECT_EQ(source, MonotonicClock::Source::ArmCounter);
+#elif !defined(__x86_64__)
+    EXPECT_EQ(source, MonotonicClock::Source::SteadyClock);
+#else
+    // Depends on whether the CPU, or the hypervisor, reports an invariant TSC
+    EXPECT_NE(source, MonotonicClock::Source::ArmCounter);
+#endif
+}
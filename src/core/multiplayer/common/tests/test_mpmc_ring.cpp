@@ -0,0 +1,93 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core/multiplayer/common/mpmc_ring.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Core::Multiplayer;
+
+TEST(MpmcRingTest, PopsInFifoOrder) {
+    MpmcRing<int> ring(3);
+    EXPECT_EQ(ring.Capacity(), 4u);
+
+    for (int i = 1; i <= 4; ++i) {
+        int value = i;
+        EXPECT_TRUE(ring.TryPush(std::move(value)));
+    }
+
+    int value = 0;
+    for (int i = 1; i <= 4; ++i) {
+        ASSERT_TRUE(ring.TryPop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(ring.TryPop(value));
+}
+
+TEST(MpmcRingTest, FullRingLeavesValueWithCaller) {
+    MpmcRing<std::string> ring(1);
+    EXPECT_EQ(ring.Capacity(), 2u);
+    std::string first = "first";
+    std::string filler = "filler";
+    std::string second = "second";
+    EXPECT_TRUE(ring.TryPush(std::move(first)));
+    EXPECT_TRUE(ring.TryPush(std::move(filler)));
+    EXPECT_FALSE(ring.TryPush(std::move(second)));
+    EXPECT_EQ(second, "second");
+
+    auto stats = ring.GetStatistics();
+    EXPECT_EQ(stats.size, 2u);
+    EXPECT_EQ(stats.high_watermark, 2u);
+    EXPECT_EQ(stats.pushed_count, 2u);
+    EXPECT_EQ(stats.dropped_count, 1u);
+
+    // Slots are reused on the next lap
+    std::string out;
+    ASSERT_TRUE(ring.TryPop(out));
+    EXPECT_EQ(out, "first");
+    EXPECT_TRUE(ring.TryPush(std::move(second)));
+}
+
+TEST(MpmcRingTest, ConcurrentProducersAndConsumersSeeEveryElementOnce) {
+    constexpr int kProducers = 4;
+    constexpr int kConsumers = 3;
+    constexpr int kPerProducer = 20000;
+    MpmcRing<int> ring(64);
+
+    std::vector<std::atomic<int>> seen(kProducers * kPerProducer);
+    std::atomic<int> consumed{0};
+    std::vector<std::thread> threads;
+
+    for (int c = 0; c < kConsumers; ++c) {
+        threads.emplace_back([&]() {
+            int value;
+            while (consumed.load() < kProducers * kPerProducer) {
+                if (ring.TryPop(value)) {
+                    seen[value].fetch_add(1);
+                    consumed.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (int p = 0; p < kProducers; ++p) {
+        threads.emplace_back([&ring, p]() {
+            for (int i = 0; i < kPerProducer; ++i) {
+                int value = p * kPerProducer + i;
+                while (!ring.TryPush(std::move(value))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (const auto& count : seen) {
+        EXPECT_EQ(count.load(), 1);
+    }
+    EXPECT_TRUE(ring.Empty());
+}
@@ -0,0 +1,114 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core/multiplayer/common/multi_literal_matcher.h"
+#include "core/multiplayer/common/network_security.h"
+#include <gtest/gtest.h>
+
+#include <random>
+#include <regex>
+#include <string>
+
+using namespace Core::Multiplayer;
+using Core::Multiplayer::Security::NetworkInputValidator;
+
+namespace {
+// The expression ContainsSuspiciousPatterns used before the matcher
+const std::regex& ReferenceRegex() {
+    static const std::regex regex(
+        R"(<script|javascript:|eval\(|exec\(|\.\./|..\\|cmd\.exe|/bin/|drop table|select \* from|union select|'; --)",
+        std::regex::icase);
+    return regex;
+}
+
+bool ReferenceContains(const std::string& str) {
+    return std::regex_search(str, ReferenceRegex());
+}
+} // namespace
+
+TEST(MultiLiteralMatcherTest, FindsOverlappingLiterals) {
+    MultiLiteralMatcher matcher({"he", "she", "hers", "his"});
+    EXPECT_EQ(matcher.Find("ushers"), 4u); // "she" ends first
+    EXPECT_EQ(matcher.Find("ahis"), 4u);
+    EXPECT_TRUE(matcher.Contains("xxhersxx"));
+    EXPECT_FALSE(matcher.Contains("hs sh hi"));
+    EXPECT_FALSE(matcher.Contains(""));
+}
+
+TEST(MultiLiteralMatcherTest, FoldsAsciiCaseOnly) {
+    MultiLiteralMatcher matcher({"Select * FROM"});
+    EXPECT_TRUE(matcher.Contains("sElEcT * from users"));
+    EXPECT_FALSE(matcher.Contains("select * fro"));
+
+    MultiLiteralMatcher high({"\xC3\xA9t\xC3\xA9"});
+    EXPECT_TRUE(high.Contains("l'\xC3\xA9T\xC3\xA9"));
+    // Not folded: 0xC3 0x89 is uppercase E-acute
+    EXPECT_FALSE(high.Contains("\xC3\x89t\xC3\x89"));
+}
+
+TEST(MultiLiteralMatcherTest, FailureLinksRecoverPartialMatches) {
+    MultiLiteralMatcher matcher({"aab", "ab"});
+    EXPECT_EQ(matcher.Find("aaab"), 4u);
+    EXPECT_EQ(matcher.Find("xab"), 3u);
+    EXPECT_FALSE(matcher.Contains("aaaa"));
+}
+
+TEST(SuspiciousPatternsTest, MatchesTheRegex) {
+    const std::vector<std::string> cases = {
+        "{\"msg\":\"hello\"}",
+        "<SCRIPT>alert(1)</script>",
+        "JavaScript:void(0)",
+        "eval (x)",
+        "EVAL(x)",
+        "..\\..\\windows",
+        "ab\\",
+        "a\\",
+        "\\\\\\",
+        "a\n\\",
+        "\na\\",
+        "ab\r\\",
+        "path/../etc",
+        "Cmd.Exe /c",
+        "cmdxexe",
+        "/usr/bin/sh",
+        "DROP TABLE users",
+        "select * from t",
+        "select *from t",
+        "UNION   select",
+        "x'; -- comment",
+        "x' ; --",
+    };
+    for (const auto& str : cases) {
+        EXPECT_EQ(NetworkInputValidator::ContainsSuspiciousPatterns(str), ReferenceContains(str))
+            << str;
+    }
+}
+
+TEST(SuspiciousPatternsTest, MatchesTheRegexOnRandomInput) {
+    // A small alphabet built from the patterns makes matches and near misses common
+    const std::string alphabet = "<>scriptSCRIPTjavJAV:evlEVL()x./\\\\\n\r mdbinDROPtableSEUNO*f'; -";
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+    std::uniform_int_distribution<size_t> length(0, 24);
+    for (int i = 0; i < 20000; ++i) {
+        std::string str(length(rng), ' ');
+        for (auto& c : str) {
+            c = alphabet[pick(rng)];
+        }
+        ASSERT_EQ(NetworkInputValidator::ContainsSuspiciousPatterns(str), ReferenceContains(str))
+            << str;
+    }
+}
+
+// Components/NetworkInputValidator/SuspiciousPatterns in the component
+// benchmarks times a message like this one against the regex
+TEST(SuspiciousPatternsTest, LongChatMessageIsClean) {
+    std::string message = "{\"type\":\"chat\",\"room\":\"Lobby 3\",\"from\":\"player_42\",\"text\":\"";
+    for (int i = 0; i < 16; ++i) {
+        message += "anyone up for a match on the new map? ";
+    }
+    message += "\"}";
+
+    EXPECT_FALSE(NetworkInputValidator::ContainsSuspiciousPatterns(message));
+    EXPECT_FALSE(ReferenceContains(message));
+}
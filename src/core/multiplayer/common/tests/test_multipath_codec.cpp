@@ -0,0 +1,126 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "core/multiplayer/common/multipath_codec.h"
+
+using namespace Core::Multiplayer;
+
+namespace {
+
+constexpr uint8_t NODE = 3;
+
+struct Framed {
+    std::vector<uint8_t> bytes;
+};
+
+Framed Encode(MultipathCodec& codec, bool redundant, std::vector<uint8_t> packet) {
+    std::array<uint8_t, MultipathCodec::MAX_FRAMED_SIZE> out{};
+    const size_t size = codec.Encode(NODE, redundant, packet.data(), packet.size(), out.data());
+    return Framed{std::vector<uint8_t>(out.begin(), out.begin() + size)};
+}
+
+// The packet bytes, or nothing if the codec dropped the frame
+std::optional<std::vector<uint8_t>> Decode(MultipathCodec& codec, size_t path,
+                                           const Framed& framed) {
+    size_t offset = 0;
+    if (!codec.Decode(NODE, path, framed.bytes.data(), framed.bytes.size(), offset)) {
+        return std::nullopt;
+    }
+    return std::vector<uint8_t>(framed.bytes.begin() + offset, framed.bytes.end());
+}
+
+} // namespace
+
+TEST(MultipathCodecTest, FirstCopyWinsAndSecondIsDropped) {
+    MultipathCodec sender;
+    MultipathCodec receiver;
+    const auto framed = Encode(sender, true, {1, 2, 3});
+    EXPECT_EQ(framed.bytes.size(), 3u + MultipathCodec::REDUNDANT_HEADER_SIZE);
+
+    EXPECT_EQ(Decode(receiver, 1, framed), (std::vector<uint8_t>{1, 2, 3}));
+    EXPECT_EQ(Decode(receiver, 0, framed), std::nullopt);
+
+    const auto statistics = receiver.GetStatistics();
+    EXPECT_EQ(statistics.paths[1].first, 1u);
+    EXPECT_EQ(statistics.paths[0].second, 1u);
+    EXPECT_DOUBLE_EQ(statistics.GetWinRate(1), 1.0);
+    EXPECT_DOUBLE_EQ(statistics.GetWinRate(0), 0.0);
+}
+
+TEST(MultipathCodecTest, WinRatesFollowWhichPathIsAhead) {
+    MultipathCodec sender;
+    MultipathCodec receiver;
+    for (uint8_t i = 0; i < 4; ++i) {
+        const auto framed = Encode(sender, true, {i});
+        // Path 0 wins three of four
+        const size_t winner = i == 2 ? 1 : 0;
+        EXPECT_TRUE(Decode(receiver, winner, framed));
+        EXPECT_FALSE(Decode(receiver, 1 - winner, framed));
+    }
+    const auto statistics = receiver.GetStatistics();
+    EXPECT_DOUBLE_EQ(statistics.GetWinRate(0), 0.75);
+    EXPECT_DOUBLE_EQ(statistics.GetWinRate(1), 0.25);
+}
+
+TEST(MultipathCodecTest, LateCopiesOutOfOrderAreStillDeduplicated) {
+    MultipathCodec sender;
+    MultipathCodec receiver;
+    std::vector<Framed> frames;
+    for (uint8_t i = 0; i < 5; ++i) {
+        frames.push_back(Encode(sender, true, {i}));
+    }
+
+    // Path 0 delivers 0, 2, 4; path 1 delivers all of them late and reordered
+    std::vector<uint8_t> delivered;
+    for (const size_t index : {0u, 2u, 4u}) {
+        delivered.push_back((*Decode(receiver, 0, frames[index]))[0]);
+    }
+    for (const size_t index : {3u, 1u, 0u, 4u, 2u}) {
+        if (const auto packet = Decode(receiver, 1, frames[index])) {
+            delivered.push_back((*packet)[0]);
+        }
+    }
+    EXPECT_EQ(delivered, (std::vector<uint8_t>{0, 2, 4, 3, 1}));
+    EXPECT_EQ(receiver.GetStatistics().paths[1].second, 3u);
+}
+
+TEST(MultipathCodecTest, SequencesBeyondTheWindowAreStale) {
+    MultipathCodec sender;
+    MultipathCodec receiver;
+    const auto old_frame = Encode(sender, true, {0});
+    for (size_t i = 0; i < MultipathCodec::RECEIVE_WINDOW; ++i) {
+        Encode(sender, true, {1});
+    }
+    EXPECT_TRUE(Decode(receiver, 0, Encode(sender, true, {2})));
+    EXPECT_FALSE(Decode(receiver, 1, old_frame));
+    EXPECT_EQ(receiver.GetStatistics().stale, 1u);
+}
+
+TEST(MultipathCodecTest, SinglePacketsPassThrough) {
+    MultipathCodec sender;
+    MultipathCodec receiver;
+    const auto framed = Encode(sender, false, {7, 8});
+    EXPECT_EQ(framed.bytes.size(), 3u);
+    EXPECT_EQ(Decode(receiver, 0, framed), (std::vector<uint8_t>{7, 8}));
+    EXPECT_EQ(Decode(receiver, 0, framed), (std::vector<uint8_t>{7, 8}));
+
+    const std::vector<uint8_t> unknown{0x7F, 1};
+    size_t offset = 0;
+    EXPECT_FALSE(receiver.Decode(NODE, 0, unknown.data(), unknown.size(), offset));
+    EXPECT_FALSE(receiver.Decode(NODE, 2, framed.bytes.data(), framed.bytes.size(), offset));
+}
+
+TEST(MultipathCodecTest, ResetNodeStartsSequencesOver) {
+    MultipathCodec sender;
+    MultipathCodec receiver;
+    const auto framed = Encode(sender, true, {1});
+    EXPECT_TRUE(Decode(receiver, 0, framed));
+    receiver.ResetNode(NODE);
+    EXPECT_TRUE(Decode(receiver, 1, framed));
+}
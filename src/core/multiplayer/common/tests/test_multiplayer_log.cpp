@@ -0,0 +1,134 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Info and below compiled out, as in a build configured for warnings
+#define SUDACHI_MULTIPLAYER_LOG_LEVEL 3
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "core/multiplayer/common/multiplayer_log.h"
+
+using namespace Core::Multiplayer;
+using namespace std::chrono_literals;
+
+namespace {
+
+enum class Color { Red = 2 };
+
+template <typename... Args>
+std::string Format(const char* format, const Args&... args) {
+    LogRecord record;
+    record.format = format;
+    (record.Add(args), ...);
+    return FormatLogRecord(record);
+}
+
+// Collects what reaches the sink, and puts spdlog back afterwards
+class MultiplayerLogTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        AsyncLogger::Instance().SetSink([this](const LogRecord& record, std::string_view message) {
+            std::lock_guard lock(mutex_);
+            levels_.push_back(record.level);
+            messages_.emplace_back(message);
+        });
+    }
+    void TearDown() override {
+        AsyncLogger::Instance().SetSink(nullptr);
+    }
+
+    std::vector<std::string> TakeMessages() {
+        AsyncLogger::Instance().Flush();
+        std::lock_guard lock(mutex_);
+        levels_.clear();
+        return std::exchange(messages_, {});
+    }
+
+    std::mutex mutex_;
+    std::vector<LogLevel> levels_;
+    std::vector<std::string> messages_;
+};
+
+} // namespace
+
+TEST(LogRecordTest, FormatsEveryArgumentType) {
+    EXPECT_EQ(Format("{} {} {} {} {} {}", -3, 7u, 1.5, true, Color::Red, "peer"),
+              "-3 7 1.5 true 2 peer");
+    EXPECT_EQ(Format("{{literal}} {:>8}", std::string("spec ignored")), "{literal} spec ignored");
+    // Placeholders without an argument are kept as written
+    EXPECT_EQ(Format("{} and {}", 1), "1 and {}");
+
+    const std::string long_text(LOG_TEXT_CAPACITY + 10, 'x');
+    EXPECT_EQ(Format("{}", long_text).size(), LOG_TEXT_CAPACITY);
+
+    LogRecord record;
+    record.format = "dropped";
+    record.suppressed = 4;
+    EXPECT_EQ(FormatLogRecord(record), "dropped (4 similar suppressed)");
+}
+
+TEST(LogRecordTest, RateLimiterCountsWhatItDrops) {
+    LogRateLimiter limiter(2);
+    const auto start = std::chrono::steady_clock::now();
+    uint64_t suppressed = 99;
+    EXPECT_TRUE(limiter.Allow(suppressed, start));
+    EXPECT_EQ(suppressed, 0u);
+    EXPECT_TRUE(limiter.Allow(suppressed, start + 1ms));
+    EXPECT_FALSE(limiter.Allow(suppressed, start + 2ms));
+    EXPECT_FALSE(limiter.Allow(suppressed, start + 3ms));
+
+    EXPECT_TRUE(limiter.Allow(suppressed, start + 1s));
+    EXPECT_EQ(suppressed, 2u);
+}
+
+TEST_F(MultiplayerLogTest, DisabledLevelsAreNotEvaluated) {
+    int evaluated = 0;
+    const auto argument = [&] { return ++evaluated; };
+    MULTIPLAYER_LOG_DEBUG("debug {}", argument());
+    MULTIPLAYER_LOG_INFO("info {}", argument());
+    MULTIPLAYER_LOG_RATE_LIMITED(Info, 10, "limited {}", argument());
+    MULTIPLAYER_LOG_WARN("warn {}", argument());
+    EXPECT_EQ(evaluated, 1);
+    EXPECT_EQ(TakeMessages(), std::vector<std::string>{"warn 1"});
+}
+
+TEST_F(MultiplayerLogTest, ThreadsKeepTheirOwnOrder) {
+    constexpr int THREADS = 4;
+    constexpr int MESSAGES = 50;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < MESSAGES; ++i) {
+                MULTIPLAYER_LOG_ERROR("{} {}", t, i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const auto messages = TakeMessages();
+    ASSERT_EQ(messages.size(), static_cast<size_t>(THREADS * MESSAGES));
+    std::vector<int> next(THREADS, 0);
+    for (const auto& message : messages) {
+        const int t = message[0] - '0';
+        EXPECT_EQ(message, std::to_string(t) + " " + std::to_string(next[t]++));
+    }
+    EXPECT_EQ(AsyncLogger::Instance().GetStatistics().dropped, 0u);
+}
+
+TEST_F(MultiplayerLogTest, RateLimitedCallSiteReportsTheFlood) {
+    for (int i = 0; i < 25; ++i) {
+        MULTIPLAYER_LOG_RATE_LIMITED(Warn, 10, "bad packet {}", i);
+    }
+    const auto messages = TakeMessages();
+    ASSERT_EQ(messages.size(), 10u);
+    EXPECT_EQ(messages.back(), "bad packet 9");
+}
@@ -0,0 +1,174 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <tuple>
+#include <vector>
+
+#include "core/multiplayer/common/circuit_breaker.h"
+#include "core/multiplayer/common/connection_recovery_manager.h"
+#include "core/multiplayer/common/network_simulator.h"
+
+using namespace Core::Multiplayer;
+using namespace std::chrono_literals;
+
+namespace {
+
+using Delivery = std::tuple<int64_t, NetworkSimulator::NodeId, NetworkSimulator::NodeId>;
+
+// Every node gossips to a random peer on a repeating timer over a lossy,
+// jittery network; returns when each datagram arrived, from whom, to whom
+std::vector<Delivery> RunGossip(uint64_t seed, size_t node_count, std::chrono::seconds duration) {
+    NetworkSimulator simulator(seed);
+    simulator.SetDefaultLink({.latency = 20ms, .jitter = 15ms, .loss = 0.05});
+    const auto start = simulator.Now();
+
+    std::vector<Delivery> deliveries;
+    for (size_t i = 0; i < node_count; ++i) {
+        const auto node = simulator.AddNode();
+        simulator.SetReceiver(node, [&, node](NetworkSimulator::NodeId from,
+                                              std::span<const uint8_t>) {
+            deliveries.emplace_back((simulator.Now() - start).count(), from, node);
+        });
+        simulator.GetTimerWheel()->ScheduleRepeating(1s, [&, node]() {
+            const auto peer = static_cast<NetworkSimulator::NodeId>(
+                std::uniform_int_distribution<size_t>(0, node_count - 1)(simulator.GetRandom()));
+            simulator.Send(node, peer, std::vector<uint8_t>(32));
+        });
+    }
+    simulator.RunFor(duration);
+    return deliveries;
+}
+
+} // namespace
+
+TEST(NetworkSimulatorTest, DeliversAfterSerializationAndLatency) {
+    NetworkSimulator simulator(1);
+    const auto a = simulator.AddNode();
+    std::vector<std::chrono::nanoseconds> arrivals;
+    const auto start = simulator.Now();
+    const auto b = simulator.AddNode(
+        [&](NetworkSimulator::NodeId, std::span<const uint8_t> payload) {
+            EXPECT_EQ(payload.size(), 100u);
+            arrivals.push_back(simulator.Now() - start);
+        });
+    simulator.SetLink(a, b, {.latency = 20ms, .bytes_per_second = 1000});
+
+    ASSERT_TRUE(simulator.Send(a, b, std::vector<uint8_t>(100)));
+    ASSERT_TRUE(simulator.Send(a, b, std::vector<uint8_t>(100)));
+    EXPECT_FALSE(simulator.Send(a, 7, {}));
+
+    // The second datagram waits for the first to leave
+    EXPECT_TRUE(simulator.RunUntilIdle(1s));
+    ASSERT_EQ(arrivals.size(), 2u);
+    EXPECT_EQ(arrivals[0], 120ms);
+    EXPECT_EQ(arrivals[1], 220ms);
+    EXPECT_EQ(simulator.GetStatistics().bytes_delivered, 200u);
+
+    // The reverse direction keeps the default, instant link
+    simulator.Send(b, a, {1});
+    EXPECT_TRUE(simulator.RunUntilIdle(1s));
+    EXPECT_EQ(simulator.GetStatistics().datagrams_delivered, 3u);
+}
+
+TEST(NetworkSimulatorTest, PartitionsDropAndHeal) {
+    NetworkSimulator simulator(1);
+    size_t received = 0;
+    const auto a = simulator.AddNode();
+    const auto b = simulator.AddNode(
+        [&received](NetworkSimulator::NodeId, std::span<const uint8_t>) { ++received; });
+
+    simulator.SetLinkUp(a, b, false);
+    simulator.Send(a, b, {1});
+    simulator.RunFor(1s);
+    EXPECT_EQ(received, 0u);
+    EXPECT_EQ(simulator.GetStatistics().dropped_link_down, 1u);
+
+    simulator.SetLinkUp(a, b, true);
+    simulator.Send(a, b, {1});
+    simulator.RunFor(1s);
+    EXPECT_EQ(received, 1u);
+}
+
+TEST(NetworkSimulatorTest, EventsAndTimersInterleaveInSimulatedTime) {
+    NetworkSimulator simulator(1);
+    const auto start = simulator.Now();
+    std::vector<std::pair<char, std::chrono::milliseconds>> log;
+    const auto record = [&](char what) {
+        log.emplace_back(what,
+                         std::chrono::duration_cast<std::chrono::milliseconds>(simulator.Now() - start));
+    };
+
+    simulator.GetTimerWheel()->Schedule(30ms, [&] { record('t'); });
+    simulator.Schedule(10ms, [&] {
+        record('a');
+        simulator.Schedule(40ms, [&] { record('c'); });
+    });
+    simulator.Schedule(30ms, [&] { record('b'); });
+    simulator.RunFor(100ms);
+
+    const std::vector<std::pair<char, std::chrono::milliseconds>> expected{
+        {'a', 10ms}, {'b', 30ms}, {'t', 30ms}, {'c', 50ms}};
+    EXPECT_EQ(log, expected);
+    EXPECT_EQ(simulator.Now() - start, 100ms);
+}
+
+TEST(NetworkSimulatorTest, SameSeedReplaysExactly) {
+    const auto first = RunGossip(7, 50, 60s);
+    const auto second = RunGossip(7, 50, 60s);
+    ASSERT_FALSE(first.empty());
+    EXPECT_EQ(first, second);
+    EXPECT_NE(first, RunGossip(8, 50, 60s));
+}
+
+TEST(NetworkSimulatorTest, HourOfTrafficBetweenHundredsOfNodes) {
+    const auto deliveries = RunGossip(42, 200, 3600s);
+    // 720000 datagrams less about 5% lost; the last second's may be in flight
+    EXPECT_GT(deliveries.size(), 670'000u);
+    EXPECT_LT(deliveries.size(), 700'000u);
+    EXPECT_LE(std::get<0>(deliveries.back()), std::chrono::nanoseconds(3600s).count());
+}
+
+TEST(NetworkSimulatorTest, CircuitBreakerTimesOutInSimulatedTime) {
+    NetworkSimulator simulator(1);
+    CircuitBreakerConfig config;
+    config.failure_threshold = 2;
+    config.timeout_duration_ms = 60000;
+    config.success_threshold_for_close = 1;
+    CircuitBreaker breaker(config, simulator.GetClock());
+
+    breaker.Execute([] { return ErrorCode::NetworkError; });
+    breaker.Execute([] { return ErrorCode::NetworkError; });
+    ASSERT_EQ(breaker.GetState(), CircuitBreakerState::Open);
+
+    simulator.RunFor(59s);
+    EXPECT_EQ(breaker.Execute([] { return ErrorCode::Success; }), ErrorCode::ServiceUnavailable);
+    simulator.RunFor(1s);
+    EXPECT_EQ(breaker.Execute([] { return ErrorCode::Success; }), ErrorCode::Success);
+    EXPECT_EQ(breaker.GetState(), CircuitBreakerState::Closed);
+}
+
+TEST(NetworkSimulatorTest, RecoveryBacksOffOnTheSimulatedWheel) {
+    NetworkSimulator simulator(1);
+    RecoveryConfig config;
+    config.max_retries = 5;
+    config.initial_delay_ms = 1000;
+    config.max_delay_ms = 60000;
+    config.backoff_multiplier = 2.0;
+    config.jitter_enabled = false;
+
+    // Without a connection every attempt fails: 1 + 2 + 4 + 8 + 16 seconds
+    ConnectionRecoveryManager manager(config, nullptr, simulator.GetTimerWheel());
+    ErrorInfo error;
+    error.error_code = ErrorCode::ConnectionLost;
+    ASSERT_EQ(manager.StartRecovery(error), ErrorCode::Success);
+
+    simulator.RunFor(30s);
+    EXPECT_EQ(manager.GetState(), RecoveryState::InProgress);
+    EXPECT_EQ(manager.GetRecoveryStatus().current_attempt, 5u);
+    simulator.RunFor(1s);
+    EXPECT_EQ(manager.GetState(), RecoveryState::Failed);
+    EXPECT_EQ(manager.GetRecoveryStatus().elapsed_time, 31s);
+}
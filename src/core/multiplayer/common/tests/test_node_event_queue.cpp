@@ -0,0 +1,111 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "core/multiplayer/common/node_event_queue.h"
+
+using namespace Core::Multiplayer;
+
+namespace {
+
+std::vector<std::pair<uint8_t, bool>> DrainAll(NodeEventQueue& queue) {
+    std::vector<std::pair<uint8_t, bool>> changes;
+    queue.Drain([&](uint8_t node_id, bool connected) { changes.emplace_back(node_id, connected); });
+    return changes;
+}
+
+} // namespace
+
+TEST(NodeEventQueueTest, DeliversChangesInNodeOrder) {
+    NodeEventQueue queue;
+    queue.PostJoined(7);
+    queue.PostJoined(2);
+    EXPECT_TRUE(queue.HasPending());
+
+    const auto changes = DrainAll(queue);
+    ASSERT_EQ(changes.size(), 2u);
+    EXPECT_EQ(changes[0], std::make_pair(uint8_t{2}, true));
+    EXPECT_EQ(changes[1], std::make_pair(uint8_t{7}, true));
+    EXPECT_FALSE(queue.HasPending());
+    EXPECT_TRUE(queue.IsConnected(7));
+}
+
+TEST(NodeEventQueueTest, FlapsBetweenDrainsAreFolded) {
+    NodeEventQueue queue;
+    queue.PostJoined(1);
+    queue.PostLeft(1);
+    EXPECT_TRUE(DrainAll(queue).empty());
+
+    queue.PostJoined(3);
+    DrainAll(queue);
+    queue.PostLeft(3);
+    queue.PostJoined(3);
+    EXPECT_TRUE(DrainAll(queue).empty());
+    EXPECT_TRUE(queue.IsConnected(3));
+
+    const auto statistics = queue.GetStatistics();
+    EXPECT_EQ(statistics.posted, 5u);
+    EXPECT_EQ(statistics.delivered, 1u);
+}
+
+TEST(NodeEventQueueTest, LeaveAfterJoinIsDelivered) {
+    NodeEventQueue queue;
+    queue.PostJoined(4);
+    DrainAll(queue);
+    queue.PostLeft(4);
+
+    const auto changes = DrainAll(queue);
+    ASSERT_EQ(changes.size(), 1u);
+    EXPECT_EQ(changes[0], std::make_pair(uint8_t{4}, false));
+}
+
+TEST(NodeEventQueueTest, ResetForgetsConnectedNodes) {
+    NodeEventQueue queue;
+    queue.PostJoined(5);
+    DrainAll(queue);
+    queue.PostLeft(6);
+    queue.Reset();
+
+    EXPECT_FALSE(queue.IsConnected(5));
+    EXPECT_FALSE(queue.HasPending());
+    queue.PostJoined(5);
+    EXPECT_EQ(DrainAll(queue).size(), 1u);
+}
+
+TEST(NodeEventQueueTest, ConcurrentPostsEndInTheLatestState) {
+    NodeEventQueue queue;
+    std::atomic<bool> posting{true};
+    std::thread drainer([&] {
+        while (posting.load()) {
+            DrainAll(queue);
+        }
+    });
+
+    std::vector<std::thread> posters;
+    for (int thread = 0; thread < 4; ++thread) {
+        posters.emplace_back([&queue, thread] {
+            for (int i = 0; i < 1000; ++i) {
+                const auto node_id = static_cast<uint8_t>(thread * 16 + i % 16);
+                queue.PostJoined(node_id);
+                queue.PostLeft(node_id);
+            }
+            queue.PostJoined(static_cast<uint8_t>(thread * 16));
+        });
+    }
+    for (auto& poster : posters) {
+        poster.join();
+    }
+    posting.store(false);
+    drainer.join();
+    DrainAll(queue);
+
+    for (uint8_t node_id = 0; node_id < 64; ++node_id) {
+        EXPECT_EQ(queue.IsConnected(node_id), node_id % 16 == 0) << int{node_id};
+    }
+}
@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+
+#include "core/multiplayer/common/node_routing_table.h"
+
+using namespace Core::Multiplayer;
+
+TEST(NodeRoutingTableTest, JoinedNodesResolveToTheirRoute) {
+    NodeRoutingTable table;
+    int connection = 0;
+    ASSERT_TRUE(table.Join(3, NodeRoute{42, &connection}));
+
+    const auto route = table.Lookup(3);
+    ASSERT_TRUE(route.has_value());
+    EXPECT_EQ(route->transport_handle, 42u);
+    EXPECT_EQ(route->connection, &connection);
+    EXPECT_FALSE(table.Lookup(4).has_value());
+    EXPECT_EQ(table.GetActiveCount(), 1u);
+}
+
+TEST(NodeRoutingTableTest, LeaveRemovesTheRoute) {
+    NodeRoutingTable table;
+    table.Join(1, NodeRoute{1, nullptr});
+    table.Leave(1);
+    EXPECT_FALSE(table.IsActive(1));
+    EXPECT_FALSE(table.Lookup(1).has_value());
+    EXPECT_EQ(table.GetActiveCount(), 0u);
+}
+
+TEST(NodeRoutingTableTest, BroadcastIdCannotJoin) {
+    NodeRoutingTable table;
+    EXPECT_FALSE(table.Join(NodeRoutingTable::BROADCAST_NODE_ID, NodeRoute{}));
+    EXPECT_EQ(table.GetActiveCount(), 0u);
+}
+
+TEST(NodeRoutingTableTest, ForEachActiveVisitsJoinedNodesInOrder) {
+    NodeRoutingTable table;
+    for (const uint8_t node_id : {200, 7, 0, 64, 63}) {
+        table.Join(node_id, NodeRoute{node_id, nullptr});
+    }
+    table.Leave(64);
+
+    std::vector<uint8_t> visited;
+    table.ForEachActive([&visited](uint8_t node_id, const NodeRoute& route) {
+        EXPECT_EQ(route.transport_handle, node_id);
+        visited.push_back(node_id);
+    });
+    EXPECT_EQ(visited, (std::vector<uint8_t>{0, 7, 63, 200}));
+}
+
+TEST(NodeRoutingTableTest, CountersStartOverOnJoin) {
+    NodeRoutingTable table;
+    table.Join(2, NodeRoute{});
+    table.RecordSent(2);
+    table.RecordSent(2);
+    table.RecordSendFailure(2);
+    EXPECT_EQ(table.GetCounters(2).packets_sent, 2u);
+    EXPECT_EQ(table.GetCounters(2).send_failures, 1u);
+
+    table.Leave(2);
+    table.Join(2, NodeRoute{});
+    EXPECT_EQ(table.GetCounters(2).packets_sent, 0u);
+    EXPECT_EQ(table.GetCounters(2).send_failures, 0u);
+}
+
+TEST(NodeRoutingTableTest, ClearDropsEveryNode) {
+    NodeRoutingTable table;
+    table.Join(0, NodeRoute{});
+    table.Join(130, NodeRoute{});
+    table.Clear();
+    EXPECT_EQ(table.GetActiveCount(), 0u);
+    EXPECT_FALSE(table.Lookup(130).has_value());
+}
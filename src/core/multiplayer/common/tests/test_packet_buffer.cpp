@@ -0,0 +1,131 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core/multiplayer/common/packet_buffer.h"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace Core::Multiplayer;
+
+TEST(PacketPoolTest, AcquireAndReleaseReturnsSlotToPool) {
+    PacketPool pool(4);
+    EXPECT_EQ(pool.Available(), 4u);
+
+    {
+        PacketBuffer buffer = pool.Acquire();
+        ASSERT_TRUE(buffer.IsValid());
+        EXPECT_EQ(buffer.size(), 0u);
+        EXPECT_EQ(buffer.capacity(), PACKET_BUFFER_SIZE);
+        EXPECT_EQ(pool.Available(), 3u);
+    }
+
+    EXPECT_EQ(pool.Available(), 4u);
+}
+
+TEST(PacketPoolTest, CopiesShareBufferUntilLastRelease) {
+    PacketPool pool(2);
+    const uint8_t bytes[] = {0x01, 0x02, 0x03};
+
+    PacketBuffer first = pool.Acquire(bytes, sizeof(bytes));
+    ASSERT_TRUE(first.IsValid());
+    PacketBuffer second = first;
+
+    EXPECT_EQ(first.UseCount(), 2u);
+    EXPECT_EQ(second.data(), first.data());
+    EXPECT_EQ(second.size(), sizeof(bytes));
+    EXPECT_EQ(pool.Available(), 1u);
+
+    first.Reset();
+    EXPECT_EQ(second.UseCount(), 1u);
+    EXPECT_EQ(pool.Available(), 1u);
+
+    second.Reset();
+    EXPECT_EQ(pool.Available(), 2u);
+}
+
+TEST(PacketPoolTest, MoveTransfersOwnership) {
+    PacketPool pool(1);
+    PacketBuffer source = pool.Acquire();
+    PacketBuffer target = std::move(source);
+
+    EXPECT_FALSE(source.IsValid());
+    EXPECT_TRUE(target.IsValid());
+    EXPECT_EQ(target.UseCount(), 1u);
+}
+
+TEST(PacketPoolTest, ExhaustedPoolReturnsEmptyHandle) {
+    PacketPool pool(1);
+    PacketBuffer held = pool.Acquire();
+    PacketBuffer missing = pool.Acquire();
+
+    EXPECT_FALSE(missing.IsValid());
+    EXPECT_EQ(missing.data(), nullptr);
+
+    auto stats = pool.GetStatistics();
+    EXPECT_EQ(stats.capacity, 1u);
+    EXPECT_EQ(stats.in_use, 1u);
+    EXPECT_EQ(stats.high_watermark, 1u);
+    EXPECT_EQ(stats.exhausted_count, 1u);
+}
+
+TEST(PacketPoolTest, RejectsOversizedPayload) {
+    PacketPool pool(1);
+    std::vector<uint8_t> oversized(MAX_OVERSIZE_PACKET_SIZE + 1, 0xAA);
+
+    EXPECT_FALSE(pool.Acquire(oversized.data(), oversized.size()).IsValid());
+    EXPECT_EQ(pool.Available(), 1u);
+
+    PacketBuffer buffer = pool.Acquire();
+    EXPECT_FALSE(buffer.Resize(PACKET_BUFFER_SIZE + 1));
+    EXPECT_TRUE(buffer.Resize(PACKET_BUFFER_SIZE));
+    EXPECT_EQ(buffer.size(), PACKET_BUFFER_SIZE);
+}
+
+TEST(PacketPoolTest, OversizedPayloadGetsItsOwnBuffer) {
+    PacketPool pool(1);
+    std::vector<uint8_t> oversized(PACKET_BUFFER_SIZE * 3 + 7);
+    for (size_t i = 0; i < oversized.size(); ++i) {
+        oversized[i] = static_cast<uint8_t>(i * 31);
+    }
+
+    {
+        PacketBuffer buffer = pool.Acquire(oversized.data(), oversized.size());
+        ASSERT_TRUE(buffer.IsValid());
+        EXPECT_EQ(std::vector<uint8_t>(buffer.data(), buffer.data() + buffer.size()), oversized);
+        // The slab is left to the MTU-sized traffic
+        EXPECT_EQ(pool.Available(), 1u);
+
+        PacketBuffer copy = buffer;
+        EXPECT_EQ(copy.UseCount(), 2u);
+        EXPECT_FALSE(buffer.Resize(oversized.size() + 1));
+        EXPECT_TRUE(buffer.Resize(10));
+        EXPECT_EQ(copy.size(), 10u);
+    }
+
+    const PacketPoolStatistics stats = pool.GetStatistics();
+    EXPECT_EQ(stats.oversize_acquired, 1u);
+    EXPECT_EQ(stats.in_use, 0u);
+    EXPECT_EQ(pool.Available(), 1u);
+}
+
+TEST(PacketPoolTest, ConcurrentAcquireReleaseKeepsPoolConsistent) {
+    PacketPool pool(64);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&pool]() {
+            for (int i = 0; i < 10000; ++i) {
+                PacketBuffer buffer = pool.Acquire();
+                if (buffer) {
+                    PacketBuffer shared = buffer;
+                    shared.Resize(1);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(pool.Available(), 64u);
+}
@@ -0,0 +1,191 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/multiplayer/common/packet_protocol.h"
+
+using namespace Core::Multiplayer;
+
+namespace {
+
+std::vector<uint8_t> RandomBytes(size_t size) {
+    std::mt19937 rng(42);
+    std::vector<uint8_t> data(size);
+    for (auto& byte : data) {
+        byte = static_cast<uint8_t>(rng());
+    }
+    return data;
+}
+
+LdnPacketHeader DataHeader() {
+    LdnPacketHeader header;
+    header.session_id = 0x12345678;
+    header.source_node_id = 1;
+    header.dest_node_id = 2;
+    header.sequence_number = 100;
+    header.timestamp = 0x0102030405060708;
+    return header;
+}
+
+} // namespace
+
+TEST(PacketProtocolTest, SerializesIntoTheCallersBuffer) {
+    const auto payload = RandomBytes(1024);
+    std::array<uint8_t, PACKET_BUFFER_SIZE> buffer{};
+
+    const auto written = SerializePacket(DataHeader(), payload, buffer);
+    ASSERT_TRUE(written.has_value());
+    EXPECT_EQ(*written, LDN_PACKET_HEADER_SIZE + payload.size());
+
+    // Little endian at the struct's offsets
+    EXPECT_EQ(buffer[0], 0x44);
+    EXPECT_EQ(buffer[1], 0x4C);
+    const size_t session = offsetof(LdnPacketHeader, session_id);
+    EXPECT_EQ(buffer[session], 0x78);
+    EXPECT_EQ(buffer[session + 3], 0x12);
+    EXPECT_EQ(buffer[offsetof(LdnPacketHeader, timestamp)], 0x08);
+    EXPECT_TRUE(std::equal(payload.begin(), payload.end(),
+                           buffer.begin() + LDN_PACKET_HEADER_SIZE));
+}
+
+TEST(PacketProtocolTest, RejectsPayloadsThatDoNotFit) {
+    const auto payload = RandomBytes(100);
+    std::vector<uint8_t> small(LDN_PACKET_HEADER_SIZE + payload.size() - 1);
+    EXPECT_FALSE(SerializePacket(DataHeader(), payload, small).has_value());
+
+    const auto oversized = RandomBytes(MAX_PACKET_SIZE + 1);
+    std::vector<uint8_t> large(LDN_PACKET_HEADER_SIZE + oversized.size());
+    EXPECT_FALSE(SerializePacket(DataHeader(), oversized, large).has_value());
+}
+
+TEST(PacketProtocolTest, DeserializedViewPointsIntoTheDatagram) {
+    const auto payload = RandomBytes(300);
+    std::vector<uint8_t> datagram(LDN_PACKET_HEADER_SIZE + payload.size());
+    ASSERT_TRUE(SerializePacket(DataHeader(), payload, datagram).has_value());
+
+    LdnPacketView view;
+    ASSERT_TRUE(DeserializePacket(datagram, view));
+    EXPECT_EQ(view.payload.data(), datagram.data() + LDN_PACKET_HEADER_SIZE);
+    EXPECT_EQ(view.payload.size(), payload.size());
+    EXPECT_EQ(view.header.session_id, 0x12345678u);
+    EXPECT_EQ(view.header.sequence_number, 100u);
+    EXPECT_EQ(view.header.timestamp, 0x0102030405060708u);
+    EXPECT_EQ(view.header.payload_size, payload.size());
+    EXPECT_TRUE(ValidatePacket(view));
+
+    LdnPacket copy;
+    ASSERT_TRUE(DeserializePacket(datagram, copy));
+    EXPECT_EQ(copy.payload, payload);
+}
+
+TEST(PacketProtocolTest, DeserializeRejectsDamage) {
+    const auto payload = RandomBytes(64);
+    std::vector<uint8_t> datagram(LDN_PACKET_HEADER_SIZE + payload.size());
+    ASSERT_TRUE(SerializePacket(DataHeader(), payload, datagram).has_value());
+    LdnPacketView view;
+
+    auto corrupted = datagram;
+    corrupted.back() ^= 0x01;
+    EXPECT_FALSE(DeserializePacket(corrupted, view));
+
+    auto truncated = datagram;
+    truncated.pop_back();
+    EXPECT_FALSE(DeserializePacket(truncated, view));
+
+    auto bad_magic = datagram;
+    bad_magic[0] = 0;
+    EXPECT_FALSE(DeserializePacket(bad_magic, view));
+
+    EXPECT_FALSE(DeserializePacket(std::span(datagram).first(LDN_PACKET_HEADER_SIZE - 1), view));
+}
+
+TEST(PacketProtocolTest, FragmentsAreViewsIntoTheSource) {
+    const auto data = RandomBytes(MAX_PACKET_SIZE * 3 + 1024);
+    std::vector<LdnPacketView> fragments;
+    ASSERT_TRUE(FragmentData(data, 0x12345678, 1, 2, fragments, 10));
+    ASSERT_EQ(fragments.size(), 4u);
+
+    for (size_t i = 0; i < fragments.size(); ++i) {
+        const auto& fragment = fragments[i];
+        EXPECT_EQ(fragment.payload.data(), data.data() + i * MAX_PACKET_SIZE);
+        EXPECT_EQ(fragment.header.fragment_id, i);
+        EXPECT_EQ(fragment.header.total_fragments, 4);
+        EXPECT_EQ(fragment.header.sequence_number, 10 + i);
+        EXPECT_EQ(fragment.header.packet_type, static_cast<uint16_t>(PacketType::Fragment));
+        EXPECT_TRUE(ValidatePacket(fragment));
+    }
+    EXPECT_EQ(fragments.back().payload.size(), 1024u);
+
+    std::vector<LdnPacketView> empty;
+    EXPECT_FALSE(FragmentData({}, 0, 1, 2, empty));
+}
+
+TEST(PacketProtocolTest, ReassemblesOutOfOrder) {
+    const auto data = RandomBytes(MAX_PACKET_SIZE * 2 + 7);
+    std::vector<LdnPacketView> fragments;
+    ASSERT_TRUE(FragmentData(data, 1, 1, 2, fragments));
+    std::reverse(fragments.begin(), fragments.end());
+
+    std::vector<uint8_t> out(data.size());
+    const auto written = ReassembleFragments(fragments, std::span<uint8_t>(out));
+    ASSERT_TRUE(written.has_value());
+    EXPECT_EQ(*written, data.size());
+    EXPECT_EQ(out, data);
+
+    std::vector<uint8_t> reassembled;
+    ASSERT_TRUE(ReassembleFragments(fragments, reassembled));
+    EXPECT_EQ(reassembled, data);
+
+    std::vector<uint8_t> small(data.size() - 1);
+    EXPECT_FALSE(ReassembleFragments(fragments, std::span<uint8_t>(small)).has_value());
+}
+
+TEST(PacketProtocolTest, ReassemblyRejectsMissingAndRepeatedFragments) {
+    const auto data = RandomBytes(MAX_PACKET_SIZE * 3);
+    std::vector<LdnPacketView> fragments;
+    ASSERT_TRUE(FragmentData(data, 1, 1, 2, fragments));
+    std::vector<uint8_t> reassembled;
+
+    auto missing = fragments;
+    missing.pop_back();
+    EXPECT_FALSE(ReassembleFragments(missing, reassembled));
+
+    auto repeated = fragments;
+    repeated[2] = repeated[1];
+    EXPECT_FALSE(ReassembleFragments(repeated, reassembled));
+    EXPECT_TRUE(reassembled.empty());
+}
+
+TEST(PacketProtocolTest, ErrorPacketCarriesTheCodeAndMessage) {
+    const auto packet = CreateErrorPacket(7, 1, 2, ErrorCode::InvalidMessage, "bad frame");
+    EXPECT_EQ(packet.header.packet_type, static_cast<uint16_t>(PacketType::Error));
+    EXPECT_TRUE(ValidatePacket(packet));
+
+    ASSERT_EQ(packet.payload.size(), sizeof(uint32_t) + 9);
+    const uint32_t code = packet.payload[0] | (packet.payload[1] << 8) |
+                          (packet.payload[2] << 16) | (uint32_t{packet.payload[3]} << 24);
+    EXPECT_EQ(code, static_cast<uint32_t>(ErrorCode::InvalidMessage));
+    EXPECT_EQ(std::string(packet.payload.begin() + 4, packet.payload.end()), "bad frame");
+
+    const std::string long_message(MAX_PACKET_SIZE * 2, 'x');
+    const auto truncated = CreateErrorPacket(7, 1, 2, ErrorCode::InvalidMessage, long_message);
+    EXPECT_EQ(truncated.payload.size(), MAX_PACKET_SIZE);
+    EXPECT_TRUE(ValidatePacket(truncated));
+}
+
+TEST(PacketProtocolTest, SequencerWraps) {
+    PacketSequencer sequencer;
+    EXPECT_EQ(sequencer.GetNextSequence(), 1u);
+    EXPECT_EQ(sequencer.GetNextSequence(), 2u);
+
+    sequencer.SetSequence(0xFFFFFFFE);
+    EXPECT_EQ(sequencer.GetNextSequence(), 0xFFFFFFFFu);
+    EXPECT_EQ(sequencer.GetNextSequence(), 0u);
+}
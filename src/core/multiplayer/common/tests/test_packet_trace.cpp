@@ -0,0 +1,118 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core/multiplayer/common/packet_trace.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include <thread>
+
+using namespace Core::Multiplayer;
+
+namespace {
+
+class PacketTraceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Trace::SetSampleInterval(1);
+        Trace::ClearEvents();
+    }
+
+    void TearDown() override {
+        Trace::SetSampleInterval(Trace::DEFAULT_SAMPLE_INTERVAL);
+    }
+};
+
+void SendHop() {
+    MULTIPLAYER_TRACE_PACKET();
+    MULTIPLAYER_TRACE_ZONE("Test::Send");
+    {
+        MULTIPLAYER_TRACE_ZONE("Test::Transport");
+    }
+}
+
+} // namespace
+
+TEST_F(PacketTraceTest, ZonesShareTheOutermostTraceId) {
+    {
+        MULTIPLAYER_TRACE_PACKET();
+        MULTIPLAYER_TRACE_ZONE("Test::Bridge");
+        SendHop();
+    }
+    EXPECT_EQ(MULTIPLAYER_TRACE_ID(), 0u);
+
+    const auto events = Trace::CollectEvents();
+    ASSERT_EQ(events.size(), 3u);
+    for (const auto& event : events) {
+        EXPECT_NE(event.trace_id, 0u);
+        EXPECT_EQ(event.trace_id, events[0].trace_id);
+        EXPECT_LE(event.begin_ns, event.end_ns);
+    }
+}
+
+TEST_F(PacketTraceTest, ZonesOutsideATracedPacketAreNotRecorded) {
+    {
+        MULTIPLAYER_TRACE_ZONE("Test::Untraced");
+    }
+    EXPECT_TRUE(Trace::CollectEvents().empty());
+}
+
+TEST_F(PacketTraceTest, SamplesOneInIntervalPerThread) {
+    Trace::SetSampleInterval(4);
+    std::thread([] {
+        for (int i = 0; i < 16; ++i) {
+            SendHop();
+        }
+    }).join();
+
+    // Two zones per traced packet
+    EXPECT_EQ(Trace::CollectEvents().size(), 8u);
+}
+
+TEST_F(PacketTraceTest, ZeroIntervalStopsTagging) {
+    Trace::SetSampleInterval(0);
+    SendHop();
+    EXPECT_TRUE(Trace::CollectEvents().empty());
+}
+
+TEST_F(PacketTraceTest, ResumedIdSpansAQueue) {
+    uint32_t carried = 0;
+    const uint64_t queued_at = Trace::NowNs();
+    {
+        MULTIPLAYER_TRACE_PACKET();
+        carried = MULTIPLAYER_TRACE_ID();
+    }
+    ASSERT_NE(carried, 0u);
+
+    std::thread([carried, queued_at] {
+        MULTIPLAYER_TRACE_SPAN("Test::Queue", carried, queued_at);
+        MULTIPLAYER_TRACE_RESUME(carried);
+        MULTIPLAYER_TRACE_ZONE("Test::Consumer");
+    }).join();
+
+    const auto events = Trace::CollectEvents();
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0].trace_id, carried);
+    EXPECT_EQ(events[0].begin_ns, queued_at);
+    EXPECT_EQ(events[1].trace_id, carried);
+}
+
+TEST_F(PacketTraceTest, RingKeepsTheNewestEvents) {
+    for (size_t i = 0; i < Trace::EVENT_CAPACITY + 10; ++i) {
+        Trace::RecordSpan("Test::Flood", static_cast<uint32_t>(i + 1), i, i + 1);
+    }
+    const auto events = Trace::CollectEvents();
+    ASSERT_EQ(events.size(), Trace::EVENT_CAPACITY);
+    EXPECT_EQ(events.front().trace_id, 11u);
+    EXPECT_EQ(events.back().trace_id, Trace::EVENT_CAPACITY + 10);
+}
+
+TEST_F(PacketTraceTest, ExportsChromeTraceJson) {
+    SendHop();
+    const std::string json = Trace::ExportChromeTrace();
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0u);
+    EXPECT_NE(json.find("\"name\":\"Test::Send\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"Test::Transport\""), std::string::npos);
+    EXPECT_EQ(std::count(json.begin(), json.end(), '{'), 5);
+    EXPECT_EQ(json.substr(json.size() - 2), "]}");
+}
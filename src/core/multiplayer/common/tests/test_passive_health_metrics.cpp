@@ -0,0 +1,126 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <chrono>
+
+#include "core/multiplayer/common/graceful_degradation_manager.h"
+#include "mocks/mock_multiplayer_backend.h"
+
+using namespace Core::Multiplayer;
+using namespace std::chrono_literals;
+
+namespace {
+TrafficSample Sample(std::chrono::microseconds rtt, uint64_t received = 100,
+                     uint64_t missing = 0, size_t queue_depth = 0) {
+    TrafficSample sample;
+    sample.rtt = rtt;
+    sample.packets_received = received;
+    sample.packets_missing = missing;
+    sample.send_queue_depth = queue_depth;
+    return sample;
+}
+
+class PassiveHealthTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        manager.SetInternetBackend(&internet_backend);
+        manager.SetAdhocBackend(&adhoc_backend);
+    }
+
+    void Warm(MultiplayerMode mode, size_t samples = 4) {
+        for (size_t i = 0; i < samples; ++i) {
+            manager.ReportTrafficSample(mode, Sample(20ms));
+        }
+    }
+
+    DegradationConfig config;
+    GracefulDegradationManager manager{config};
+    ::testing::NiceMock<MockMultiplayerBackend> internet_backend;
+    ::testing::NiceMock<MockMultiplayerBackend> adhoc_backend;
+};
+} // namespace
+
+TEST_F(PassiveHealthTest, AveragesTrafficIntoHealthMetrics) {
+    manager.ReportTrafficSample(MultiplayerMode::Internet, Sample(40ms, 90, 10, 8));
+    auto metrics = manager.GetHealthMetrics(MultiplayerMode::Internet);
+    EXPECT_EQ(metrics.status, BackendHealthStatus::Unknown);
+    EXPECT_DOUBLE_EQ(metrics.rtt_ewma_ms, 40.0);
+    EXPECT_DOUBLE_EQ(metrics.loss_ewma, 0.1);
+    EXPECT_DOUBLE_EQ(metrics.send_queue_depth_ewma, 8.0);
+
+    manager.ReportTrafficSample(MultiplayerMode::Internet, Sample(50ms, 100, 0, 8));
+    metrics = manager.GetHealthMetrics(MultiplayerMode::Internet);
+    EXPECT_DOUBLE_EQ(metrics.rtt_ewma_ms, 42.0);
+    EXPECT_DOUBLE_EQ(metrics.loss_ewma, 0.08);
+    EXPECT_EQ(metrics.traffic_samples, 2u);
+
+    Warm(MultiplayerMode::Internet, 2);
+    EXPECT_EQ(manager.GetHealthMetrics(MultiplayerMode::Internet).status,
+              BackendHealthStatus::Degraded); // loss still above 5%
+    Warm(MultiplayerMode::Internet, 4);
+    EXPECT_EQ(manager.GetHealthMetrics(MultiplayerMode::Internet).status,
+              BackendHealthStatus::Healthy);
+}
+
+TEST_F(PassiveHealthTest, FailsOverOnTheSampleThatCrossesTheThreshold) {
+    ASSERT_EQ(manager.Initialize(MultiplayerMode::Internet), ErrorCode::Success);
+    ASSERT_EQ(manager.GetCurrentMode(), MultiplayerMode::Internet);
+    Warm(MultiplayerMode::Internet);
+
+    // Half the packets go missing; the switch happens on the report that
+    // tips the loss average over, not on a later poll
+    for (int i = 0; i < 10; ++i) {
+        manager.ReportTrafficSample(MultiplayerMode::Internet, Sample(20ms, 50, 50));
+        const auto status = manager.GetHealthMetrics(MultiplayerMode::Internet).status;
+        if (status == BackendHealthStatus::Unhealthy) {
+            EXPECT_NE(manager.GetCurrentMode(), MultiplayerMode::Internet);
+            EXPECT_EQ(manager.GetState(), DegradationState::Degraded);
+            return;
+        }
+        EXPECT_EQ(manager.GetCurrentMode(), MultiplayerMode::Internet);
+    }
+    FAIL() << "Loss never made the backend unhealthy";
+}
+
+TEST_F(PassiveHealthTest, RttAnomaliesMarkTheBackendUnhealthy) {
+    Warm(MultiplayerMode::Internet, 10);
+    // Well under the 400ms average threshold, but far outside the baseline
+    for (int i = 0; i < 3; ++i) {
+        manager.ReportTrafficSample(MultiplayerMode::Internet, Sample(200ms));
+    }
+    const auto metrics = manager.GetHealthMetrics(MultiplayerMode::Internet);
+    EXPECT_LT(metrics.rtt_ewma_ms, 400.0);
+    EXPECT_EQ(metrics.rtt_anomalies, 3u);
+    EXPECT_EQ(metrics.status, BackendHealthStatus::Unhealthy);
+
+    // A normal sample ends the streak
+    manager.ReportTrafficSample(MultiplayerMode::Internet, Sample(20ms));
+    EXPECT_NE(manager.GetHealthMetrics(MultiplayerMode::Internet).status,
+              BackendHealthStatus::Unhealthy);
+}
+
+TEST_F(PassiveHealthTest, FallbackSkipsModesWithUnhealthyTraffic) {
+    ASSERT_EQ(manager.Initialize(MultiplayerMode::Internet), ErrorCode::Success);
+    for (int i = 0; i < 6; ++i) {
+        manager.ReportTrafficSample(MultiplayerMode::Adhoc, Sample(20ms, 0, 0, 1000));
+    }
+    ASSERT_EQ(manager.GetHealthMetrics(MultiplayerMode::Adhoc).status,
+              BackendHealthStatus::Unhealthy);
+
+    for (int i = 0; i < 6; ++i) {
+        manager.ReportTrafficSample(MultiplayerMode::Internet, Sample(500ms));
+    }
+    EXPECT_EQ(manager.GetCurrentMode(), MultiplayerMode::Offline);
+}
+
+TEST_F(PassiveHealthTest, TooFewSamplesChangeNothing) {
+    ASSERT_EQ(manager.Initialize(MultiplayerMode::Internet), ErrorCode::Success);
+    for (int i = 0; i < 3; ++i) {
+        manager.ReportTrafficSample(MultiplayerMode::Internet, Sample(900ms, 0, 100));
+    }
+    EXPECT_EQ(manager.GetHealthMetrics(MultiplayerMode::Internet).status,
+              BackendHealthStatus::Unknown);
+    EXPECT_EQ(manager.GetCurrentMode(), MultiplayerMode::Internet);
+}
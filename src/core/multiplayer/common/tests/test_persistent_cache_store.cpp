@@ -0,0 +1,147 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "core/multiplayer/common/persistent_cache_store.h"
+
+using namespace Core::Multiplayer;
+
+namespace {
+
+struct RelayRtt {
+    uint32_t rtt_us;
+    uint16_t port;
+    uint16_t samples;
+};
+
+class PersistentCacheStoreTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = (std::filesystem::temp_directory_path() /
+                 ("persistent_cache_test_" +
+                  std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()) +
+                  ".ldnkv"))
+                    .string();
+        std::filesystem::remove(path_);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(path_);
+    }
+
+    // Flips one byte of the file, as a write cut short would leave it
+    void CorruptByte(size_t offset) {
+        std::fstream file(path_, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekg(static_cast<std::streamoff>(offset));
+        const char byte = static_cast<char>(file.get() ^ 0xFF);
+        file.seekp(static_cast<std::streamoff>(offset));
+        file.put(byte);
+    }
+
+    std::string path_;
+};
+
+} // namespace
+
+TEST_F(PersistentCacheStoreTest, ValuesSurviveReopening) {
+    {
+        PersistentCacheStore store;
+        ASSERT_EQ(store.Open(path_, 16), ErrorCode::Success);
+        EXPECT_EQ(store.Store(CacheKind::RelayRtt, 1, "relay-eu", RelayRtt{1500, 443, 8}),
+                  ErrorCode::Success);
+        const std::vector<uint8_t> nat{2};
+        EXPECT_EQ(store.Store(CacheKind::NatType, 1, "relay-eu", nat), ErrorCode::Success);
+    }
+
+    PersistentCacheStore store;
+    ASSERT_EQ(store.Open(path_, 64), ErrorCode::Success);
+    // The file keeps the slot count it was created with
+    EXPECT_EQ(store.GetSlotCount(), 16u);
+    const auto* rtt = store.Find<RelayRtt>(CacheKind::RelayRtt, 1, "relay-eu");
+    ASSERT_NE(rtt, nullptr);
+    EXPECT_EQ(rtt->rtt_us, 1500u);
+    EXPECT_EQ(rtt->port, 443);
+    // Kinds keep separate keys, and another schema reads as missing
+    const auto nat = store.Find(CacheKind::NatType, 1, "relay-eu");
+    ASSERT_TRUE(nat.has_value());
+    EXPECT_EQ(std::vector<uint8_t>(nat->begin(), nat->end()), std::vector<uint8_t>{2});
+    EXPECT_EQ(store.Find<RelayRtt>(CacheKind::RelayRtt, 2, "relay-eu"), nullptr);
+    EXPECT_FALSE(store.Find(CacheKind::AddressBook, 1, "relay-eu").has_value());
+    EXPECT_EQ(store.GetRecordCount(), 2u);
+}
+
+TEST_F(PersistentCacheStoreTest, TornWriteLeavesThePreviousValue) {
+    {
+        PersistentCacheStore store;
+        ASSERT_EQ(store.Open(path_, 1), ErrorCode::Success);
+        ASSERT_EQ(store.Store(CacheKind::RelayRtt, 1, "relay", RelayRtt{100, 1, 1}),
+                  ErrorCode::Success);
+        ASSERT_EQ(store.Store(CacheKind::RelayRtt, 1, "relay", RelayRtt{200, 1, 2}),
+                  ErrorCode::Success);
+    }
+    // The second value went to the slot's second copy; damage its value
+    CorruptByte(PersistentCacheFormat::HEADER_SIZE + PersistentCacheFormat::RECORD_SIZE + 64);
+
+    PersistentCacheStore store;
+    ASSERT_EQ(store.Open(path_), ErrorCode::Success);
+    const auto* rtt = store.Find<RelayRtt>(CacheKind::RelayRtt, 1, "relay");
+    ASSERT_NE(rtt, nullptr);
+    EXPECT_EQ(rtt->rtt_us, 100u);
+
+    // The next write replaces the damaged copy
+    ASSERT_EQ(store.Store(CacheKind::RelayRtt, 1, "relay", RelayRtt{300, 1, 3}),
+              ErrorCode::Success);
+    EXPECT_EQ(store.Find<RelayRtt>(CacheKind::RelayRtt, 1, "relay")->rtt_us, 300u);
+}
+
+TEST_F(PersistentCacheStoreTest, StartsOverOnAnotherVersion) {
+    {
+        PersistentCacheStore store;
+        ASSERT_EQ(store.Open(path_, 4), ErrorCode::Success);
+        ASSERT_EQ(store.Store(CacheKind::Capabilities, 1, "gpu", uint32_t{7}),
+                  ErrorCode::Success);
+    }
+    CorruptByte(4); // Version
+
+    PersistentCacheStore store;
+    ASSERT_EQ(store.Open(path_, 8), ErrorCode::Success);
+    EXPECT_EQ(store.GetSlotCount(), 8u);
+    EXPECT_EQ(store.GetRecordCount(), 0u);
+    EXPECT_EQ(store.Find<uint32_t>(CacheKind::Capabilities, 1, "gpu"), nullptr);
+}
+
+TEST_F(PersistentCacheStoreTest, ErasedKeysKeepLaterProbesReachable) {
+    PersistentCacheStore store;
+    ASSERT_EQ(store.Open(path_, 2), ErrorCode::Success);
+    ASSERT_EQ(store.Store(CacheKind::AddressBook, 1, "a", uint32_t{1}), ErrorCode::Success);
+    ASSERT_EQ(store.Store(CacheKind::AddressBook, 1, "b", uint32_t{2}), ErrorCode::Success);
+    EXPECT_EQ(store.Store(CacheKind::AddressBook, 1, "c", uint32_t{3}),
+              ErrorCode::ResourceExhausted);
+
+    EXPECT_TRUE(store.Erase(CacheKind::AddressBook, "a"));
+    EXPECT_FALSE(store.Erase(CacheKind::AddressBook, "a"));
+    EXPECT_EQ(store.Find<uint32_t>(CacheKind::AddressBook, 1, "a"), nullptr);
+    ASSERT_NE(store.Find<uint32_t>(CacheKind::AddressBook, 1, "b"), nullptr);
+    EXPECT_EQ(*store.Find<uint32_t>(CacheKind::AddressBook, 1, "b"), 2u);
+    EXPECT_EQ(store.GetRecordCount(), 1u);
+
+    ASSERT_EQ(store.Store(CacheKind::AddressBook, 1, "a", uint32_t{4}), ErrorCode::Success);
+    EXPECT_EQ(*store.Find<uint32_t>(CacheKind::AddressBook, 1, "a"), 4u);
+    EXPECT_EQ(store.Flush(), ErrorCode::Success);
+}
+
+TEST_F(PersistentCacheStoreTest, RejectsOversizedEntries) {
+    PersistentCacheStore store;
+    EXPECT_EQ(store.Store(CacheKind::NatType, 1, "k", uint8_t{1}), ErrorCode::NotInitialized);
+    ASSERT_EQ(store.Open(path_, 4), ErrorCode::Success);
+    const std::string long_key(PersistentCacheFormat::KEY_CAPACITY + 1, 'k');
+    EXPECT_EQ(store.Store(CacheKind::NatType, 1, long_key, uint8_t{1}),
+              ErrorCode::InvalidParameter);
+    const std::vector<uint8_t> long_value(PersistentCacheFormat::VALUE_CAPACITY + 1);
+    EXPECT_EQ(store.Store(CacheKind::NatType, 1, "k", long_value), ErrorCode::InvalidParameter);
+}
@@ -0,0 +1,117 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core/multiplayer/common/priority_send_queue.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace Core::Multiplayer;
+
+namespace {
+std::vector<std::string> DrainAll(PrioritySendQueue<std::string>& queue) {
+    std::vector<std::string> order;
+    std::string message;
+    while (queue.Pop(message)) {
+        order.push_back(message);
+    }
+    return order;
+}
+} // namespace
+
+TEST(PrioritySendQueueTest, HigherClassesGoFirst) {
+    PrioritySendQueue<std::string> queue;
+    EXPECT_TRUE(queue.Push(1, SendPriority::Bulk, "bulk", 1000));
+    EXPECT_TRUE(queue.Push(1, SendPriority::Realtime, "input", 32));
+    EXPECT_TRUE(queue.Push(2, SendPriority::Control, "ack", 8));
+    EXPECT_EQ(queue.Size(), 3u);
+    EXPECT_EQ(queue.Size(SendPriority::Bulk), 1u);
+
+    ASSERT_NE(queue.Front(), nullptr);
+    EXPECT_EQ(*queue.Front(), "ack");
+    EXPECT_EQ(DrainAll(queue), (std::vector<std::string>{"ack", "input", "bulk"}));
+    EXPECT_TRUE(queue.Empty());
+    EXPECT_EQ(queue.Front(), nullptr);
+}
+
+TEST(PrioritySendQueueTest, RealtimeTakesTurnsAcrossDestinations) {
+    PrioritySendQueue<std::string> queue;
+    queue.Push(1, SendPriority::Realtime, "a1", 10);
+    queue.Push(1, SendPriority::Realtime, "a2", 10);
+    queue.Push(2, SendPriority::Realtime, "b1", 10);
+
+    EXPECT_EQ(DrainAll(queue), (std::vector<std::string>{"a1", "b1", "a2"}));
+}
+
+TEST(PrioritySendQueueTest, BulkIsSharedByDeficit) {
+    // Destination 1 sends small messages, 2 large ones; each turn is worth 1000 bytes
+    PrioritySendQueue<std::string> queue(16, 1000);
+    for (int i = 0; i < 4; ++i) {
+        queue.Push(1, SendPriority::Bulk, "small" + std::to_string(i), 500);
+    }
+    queue.Push(2, SendPriority::Bulk, "large0", 1500);
+    queue.Push(2, SendPriority::Bulk, "large1", 1500);
+
+    EXPECT_EQ(DrainAll(queue),
+              (std::vector<std::string>{"small0", "small1", "small2", "small3", "large0",
+                                        "large1"}));
+
+    // A large message waits for enough turns while the other side keeps its share
+    queue.Push(2, SendPriority::Bulk, "large", 2500);
+    for (int i = 0; i < 3; ++i) {
+        queue.Push(1, SendPriority::Bulk, "small" + std::to_string(i), 1000);
+    }
+    EXPECT_EQ(DrainAll(queue),
+              (std::vector<std::string>{"small0", "small1", "large", "small2"}));
+}
+
+TEST(PrioritySendQueueTest, FullQueueAndRemove) {
+    PrioritySendQueue<std::string> queue(2);
+    std::string third = "third";
+    EXPECT_TRUE(queue.Push(1, SendPriority::Bulk, "first", 1));
+    EXPECT_TRUE(queue.Push(2, SendPriority::Realtime, "second", 1));
+    EXPECT_FALSE(queue.Push(2, SendPriority::Control, std::move(third), 1));
+    EXPECT_EQ(third, "third");
+
+    queue.Remove(1);
+    EXPECT_EQ(queue.Size(), 1u);
+    EXPECT_EQ(queue.Size(SendPriority::Bulk), 0u);
+    EXPECT_EQ(DrainAll(queue), (std::vector<std::string>{"second"}));
+}
+
+TEST(PrioritySendQueueTest, LatestValueReplacesInPlace) {
+    PrioritySendQueue<std::string> queue;
+    EXPECT_EQ(queue.PushLatest(1, SendPriority::Realtime, 7, "pos1", 16), PushResult::Queued);
+    queue.Push(1, SendPriority::Realtime, "input", 8);
+    EXPECT_EQ(queue.PushLatest(1, SendPriority::Realtime, 9, "hp1", 16), PushResult::Queued);
+    EXPECT_EQ(queue.PushLatest(1, SendPriority::Realtime, 7, "pos2", 16), PushResult::Replaced);
+    // Another destination, or another class, is another slot
+    EXPECT_EQ(queue.PushLatest(2, SendPriority::Realtime, 7, "b-pos", 16), PushResult::Queued);
+    EXPECT_EQ(queue.PushLatest(1, SendPriority::Bulk, 7, "bulk-pos", 16), PushResult::Queued);
+    EXPECT_EQ(queue.Size(), 5u);
+
+    // The newest position goes out where the first one was queued
+    EXPECT_EQ(DrainAll(queue),
+              (std::vector<std::string>{"pos2", "b-pos", "input", "hp1", "bulk-pos"}));
+
+    // Once sent, the slot queues afresh
+    EXPECT_EQ(queue.PushLatest(1, SendPriority::Realtime, 7, "pos3", 16), PushResult::Queued);
+}
+
+TEST(PrioritySendQueueTest, LatestValueStillReplacesWhenFull) {
+    PrioritySendQueue<std::string> queue(2);
+    queue.PushLatest(1, SendPriority::Realtime, 1, "a1", 10);
+    queue.PushLatest(1, SendPriority::Realtime, 2, "b1", 10);
+    EXPECT_EQ(queue.PushLatest(1, SendPriority::Realtime, 3, "c1", 10), PushResult::Full);
+    EXPECT_EQ(queue.PushLatest(1, SendPriority::Realtime, 1, "a2", 10), PushResult::Replaced);
+    EXPECT_EQ(DrainAll(queue), (std::vector<std::string>{"a2", "b1"}));
+}
+
+TEST(PrioritySendQueueTest, LatestValueKeyReadsTheSlot) {
+    const std::vector<uint8_t> packet{0x10, 0x20, 0x34, 0x12, 0x99};
+    EXPECT_FALSE(LatestValueKey{}.Extract(packet).has_value());
+    EXPECT_EQ(LatestValueKey({0, 1}).Extract(packet), 0x10u);
+    EXPECT_EQ(LatestValueKey({2, 2}).Extract(packet), 0x1234u);
+    EXPECT_FALSE(LatestValueKey({4, 2}).Extract(packet).has_value());
+    EXPECT_FALSE(LatestValueKey({0, 8}).IsEnabled());
+}
@@ -0,0 +1,134 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core/multiplayer/common/network_security.h"
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Core::Multiplayer;
+using namespace Core::Multiplayer::Security;
+using namespace std::chrono_literals;
+
+TEST(TokenBucketRateLimitTest, ConsumesUpToCapacity) {
+    TokenBucketRateLimit bucket(10.0, 0.0);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_TRUE(bucket.TryConsume());
+    }
+    EXPECT_FALSE(bucket.TryConsume());
+    EXPECT_DOUBLE_EQ(bucket.GetTokens(), 0.0);
+
+    bucket.Reset();
+    EXPECT_DOUBLE_EQ(bucket.GetTokens(), 10.0);
+}
+
+TEST(TokenBucketRateLimitTest, RefillsOverTime) {
+    TokenBucketRateLimit bucket(5.0, 1000.0);
+    EXPECT_TRUE(bucket.TryConsume(5.0));
+    EXPECT_FALSE(bucket.TryConsume(5.0));
+
+    std::this_thread::sleep_for(20ms);
+    EXPECT_TRUE(bucket.TryConsume(5.0));
+}
+
+TEST(TokenBucketRateLimitTest, LargeByteBucketKeepsCapacity) {
+    TokenBucketRateLimit bucket(2097152.0, 0.0);
+    EXPECT_TRUE(bucket.TryConsume(2097152.0));
+    EXPECT_FALSE(bucket.TryConsume(1.0));
+}
+
+TEST(TokenBucketRateLimitTest, ConcurrentConsumersNeverOverspend) {
+    constexpr int THREAD_COUNT = 8;
+    TokenBucketRateLimit bucket(1000.0, 0.0);
+    std::atomic<int> granted{0};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREAD_COUNT; ++t) {
+        threads.emplace_back([&bucket, &granted]() {
+            for (int i = 0; i < 500; ++i) {
+                if (bucket.TryConsume()) {
+                    ++granted;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(granted.load(), 1000);
+}
+
+TEST(ClientRateManagerTest, LimitsEachClientIndependently) {
+    RateLimitConfig config;
+    config.burst_capacity = 3.0;
+    config.packets_per_second = 0.0;
+    ClientRateManager manager(config, std::make_shared<TimerWheel>());
+
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_TRUE(manager.CheckPacketRateLimit("alice"));
+    }
+    EXPECT_FALSE(manager.CheckPacketRateLimit("alice"));
+    EXPECT_TRUE(manager.CheckPacketRateLimit("bob"));
+    EXPECT_EQ(manager.GetClientCount(), 2u);
+
+    manager.RemoveClient("alice");
+    EXPECT_EQ(manager.GetClientCount(), 1u);
+    EXPECT_EQ(manager.GetClientStats("alice"), "Client not found");
+    EXPECT_TRUE(manager.CheckPacketRateLimit("alice"));
+}
+
+TEST(ClientRateManagerTest, TracksByteTotals) {
+    ClientRateManager manager(RateLimitConfig{}, std::make_shared<TimerWheel>());
+    EXPECT_TRUE(manager.CheckByteRateLimit("carol", 1000));
+    EXPECT_TRUE(manager.CheckByteRateLimit("carol", 500));
+
+    const std::string stats = manager.GetClientStats("carol");
+    EXPECT_NE(stats.find("Bytes=1500"), std::string::npos);
+}
+
+TEST(ClientRateManagerTest, EvictsIdleClients) {
+    RateLimitConfig config;
+    config.idle_client_timeout = std::chrono::seconds(0);
+    ClientRateManager manager(config, std::make_shared<TimerWheel>());
+
+    for (int i = 0; i < 100; ++i) {
+        manager.CheckPacketRateLimit("client-" + std::to_string(i));
+    }
+    EXPECT_EQ(manager.GetClientCount(), 100u);
+
+    std::this_thread::sleep_for(5ms);
+    EXPECT_EQ(manager.EvictIdleClients(), 100u);
+    EXPECT_EQ(manager.GetClientCount(), 0u);
+}
+
+TEST(ClientRateManagerTest, ConcurrentClientsAcrossShards) {
+    constexpr int THREAD_COUNT = 8;
+    constexpr int CLIENTS_PER_THREAD = 200;
+    RateLimitConfig config;
+    config.burst_capacity = 1.0;
+    config.packets_per_second = 0.0;
+    ClientRateManager manager(config, std::make_shared<TimerWheel>());
+    std::atomic<int> granted{0};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREAD_COUNT; ++t) {
+        threads.emplace_back([&manager, &granted]() {
+            // Every thread hits the same clients, so each grants exactly once
+            for (int i = 0; i < CLIENTS_PER_THREAD; ++i) {
+                if (manager.CheckPacketRateLimit("peer-" + std::to_string(i))) {
+                    ++granted;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(granted.load(), CLIENTS_PER_THREAD);
+    EXPECT_EQ(manager.GetClientCount(), static_cast<size_t>(CLIENTS_PER_THREAD));
+}
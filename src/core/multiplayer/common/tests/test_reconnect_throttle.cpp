@@ -0,0 +1,40 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+
+#include "core/multiplayer/common/reconnect_throttle.h"
+
+using namespace Core::Multiplayer;
+using namespace std::chrono_literals;
+
+TEST(ReconnectThrottleTest, BurstIsAdmittedThenSpreadOut) {
+    ReconnectThrottle throttle(ReconnectThrottleConfig{3.0, 10.0});
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(throttle.TryAcquire(), 0ms);
+    }
+
+    // Refused callers wait for the next token plus up to one more interval
+    for (int i = 0; i < 20; ++i) {
+        const auto wait = throttle.TryAcquire();
+        EXPECT_GT(wait, 0ms);
+        EXPECT_LE(wait, 200ms);
+    }
+    EXPECT_EQ(throttle.GetDeferredCount(), 20u);
+}
+
+TEST(ReconnectThrottleTest, TokensComeBackAtTheConfiguredRate) {
+    ReconnectThrottle throttle(ReconnectThrottleConfig{1.0, 20.0});
+    EXPECT_EQ(throttle.TryAcquire(), 0ms);
+    EXPECT_GT(throttle.TryAcquire(), 0ms);
+
+    std::this_thread::sleep_for(80ms);
+    EXPECT_EQ(throttle.TryAcquire(), 0ms);
+}
+
+TEST(ReconnectThrottleTest, SharedInstanceIsProcessWide) {
+    EXPECT_NE(ReconnectThrottle::GetShared(), nullptr);
+    EXPECT_EQ(ReconnectThrottle::GetShared(), ReconnectThrottle::GetShared());
+}
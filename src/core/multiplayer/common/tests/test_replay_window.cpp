@@ -0,0 +1,106 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <random>
+#include <set>
+
+#include "core/multiplayer/common/replay_window.h"
+
+using namespace Core::Multiplayer;
+
+namespace {
+
+using Window64 = ReplayWindow<64>;
+using Result = Window64::Result;
+
+// The obvious implementation, over the full history
+template <size_t Bits>
+typename ReplayWindow<Bits>::Result Reference(const std::set<uint64_t>& seen,
+                                              uint64_t sequence) {
+    using R = typename ReplayWindow<Bits>::Result;
+    if (seen.empty() || sequence > *seen.rbegin()) {
+        return R::New;
+    }
+    if (*seen.rbegin() - sequence >= Bits) {
+        return R::TooOld;
+    }
+    return seen.contains(sequence) ? R::Duplicate : R::New;
+}
+
+template <size_t Bits>
+void CompareWithReference(uint32_t seed) {
+    std::mt19937 rng(seed);
+    ReplayWindow<Bits> window;
+    std::set<uint64_t> seen;
+    uint64_t head = 1 << 20;
+    for (int i = 0; i < 20000; ++i) {
+        // Mostly forward, with reordering, duplicates and the odd long jump
+        const uint32_t roll = rng() % 100;
+        uint64_t sequence;
+        if (roll < 60) {
+            sequence = head += 1 + rng() % 3;
+        } else if (roll < 97) {
+            sequence = head - rng() % (Bits + Bits / 2);
+        } else {
+            sequence = head += rng() % (Bits * 3);
+        }
+        const auto expected = Reference<Bits>(seen, sequence);
+        ASSERT_EQ(window.CheckAndMark(sequence), expected) << "sequence " << sequence;
+        if (expected == ReplayWindow<Bits>::Result::New) {
+            seen.insert(sequence);
+        }
+    }
+}
+
+} // namespace
+
+TEST(ReplayWindowTest, AcceptsEachSequenceOnce) {
+    Window64 window;
+    EXPECT_FALSE(window.IsStarted());
+    EXPECT_EQ(window.CheckAndMark(10), Result::New);
+    EXPECT_EQ(window.CheckAndMark(10), Result::Duplicate);
+    EXPECT_EQ(window.CheckAndMark(8), Result::New);
+    EXPECT_EQ(window.CheckAndMark(12), Result::New);
+    EXPECT_EQ(window.CheckAndMark(8), Result::Duplicate);
+    EXPECT_EQ(window.CheckAndMark(11), Result::New);
+    EXPECT_EQ(window.GetHighest(), 12u);
+}
+
+TEST(ReplayWindowTest, CoversExactlyItsSize) {
+    Window64 window;
+    window.Mark(1000);
+    EXPECT_EQ(window.Check(1000 - 63), Result::New);
+    EXPECT_EQ(window.Check(1000 - 64), Result::TooOld);
+
+    // A jump past the whole window forgets everything before it
+    window.Mark(1000 - 63);
+    window.Mark(2000);
+    EXPECT_EQ(window.Check(1000), Result::TooOld);
+    EXPECT_EQ(window.Check(1999), Result::New);
+}
+
+TEST(ReplayWindowTest, CheckDoesNotMark) {
+    Window64 window;
+    window.Mark(5);
+    EXPECT_EQ(window.Check(9), Result::New);
+    EXPECT_EQ(window.Check(9), Result::New);
+    EXPECT_EQ(window.GetHighest(), 5u);
+
+    window.Reset();
+    EXPECT_FALSE(window.IsStarted());
+    EXPECT_EQ(window.Check(5), Result::New);
+}
+
+TEST(ReplayWindowTest, MatchesReferenceAtEverySize) {
+    CompareWithReference<64>(1);
+    CompareWithReference<128>(2);
+    CompareWithReference<1024>(3);
+}
+
+TEST(ReplayWindowTest, UnwrapsNarrowCounters) {
+    EXPECT_EQ(UnwrapSequence<uint16_t>(2, 0x1FFFE), 0x20002u);
+    EXPECT_EQ(UnwrapSequence<uint16_t>(0xFFFE, 0x20002), 0x1FFFEu);
+    EXPECT_EQ(UnwrapSequence<uint32_t>(5, uint64_t{1} << 32), (uint64_t{1} << 32) + 5);
+}
@@ -0,0 +1,87 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core/multiplayer/common/rtt_estimator.h"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace Core::Multiplayer;
+using namespace std::chrono_literals;
+
+TEST(RttEstimatorTest, StartsWithInitialTimeout) {
+    RttEstimator estimator;
+    EXPECT_FALSE(estimator.HasSamples());
+    EXPECT_EQ(estimator.GetSmoothedRtt(), 0us);
+    EXPECT_EQ(estimator.GetMinRtt(), 0us);
+    EXPECT_EQ(estimator.GetRetransmissionTimeout(), RttEstimator::INITIAL_RTO);
+}
+
+TEST(RttEstimatorTest, FirstSampleSeedsSmoothedRttAndVariation) {
+    RttEstimator estimator;
+    estimator.AddSample(40ms);
+
+    EXPECT_EQ(estimator.GetSmoothedRtt(), 40ms);
+    EXPECT_EQ(estimator.GetRttVariation(), 20ms);
+    // 40ms + 4 * 20ms
+    EXPECT_EQ(estimator.GetRetransmissionTimeout(), 200ms);
+}
+
+TEST(RttEstimatorTest, FollowsRfc6298Update) {
+    RttEstimator estimator;
+    estimator.AddSample(40ms);
+    estimator.AddSample(80ms);
+
+    // RTTVAR = 3/4 * 20 + 1/4 * |40 - 80| = 25, SRTT = 7/8 * 40 + 1/8 * 80 = 45
+    EXPECT_EQ(estimator.GetRttVariation(), 25ms);
+    EXPECT_EQ(estimator.GetSmoothedRtt(), 45ms);
+    EXPECT_EQ(estimator.GetLatestRtt(), 80ms);
+    EXPECT_EQ(estimator.GetMinRtt(), 40ms);
+    EXPECT_EQ(estimator.GetSampleCount(), 2u);
+}
+
+TEST(RttEstimatorTest, SteadySamplesConvergeAndVariationDecays) {
+    RttEstimator estimator;
+    estimator.AddSample(100ms);
+    for (int i = 0; i < 100; ++i) {
+        estimator.AddSample(20ms);
+    }
+
+    const auto snapshot = estimator.GetSnapshot();
+    EXPECT_LT(snapshot.smoothed_rtt, 21ms);
+    EXPECT_LT(snapshot.rtt_variation, 1ms);
+    EXPECT_EQ(snapshot.min_rtt, 20ms);
+    EXPECT_EQ(snapshot.retransmission_timeout, RttEstimator::MIN_RTO);
+    EXPECT_EQ(snapshot.sample_count, 101u);
+}
+
+TEST(RttEstimatorTest, IgnoresNegativeSamplesAndResets) {
+    RttEstimator estimator;
+    estimator.AddSample(-5ms);
+    EXPECT_FALSE(estimator.HasSamples());
+
+    estimator.AddSample(10ms);
+    estimator.Reset();
+    EXPECT_FALSE(estimator.HasSamples());
+    EXPECT_EQ(estimator.GetSmoothedRtt(), 0us);
+    EXPECT_EQ(estimator.GetRetransmissionTimeout(), RttEstimator::INITIAL_RTO);
+}
+
+TEST(RttEstimatorTest, ConcurrentSamplesStayConsistent) {
+    RttEstimator estimator;
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; ++t) {
+        writers.emplace_back([&estimator]() {
+            for (int i = 0; i < 1000; ++i) {
+                estimator.AddSample(30ms);
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    EXPECT_EQ(estimator.GetSampleCount(), 4000u);
+    EXPECT_EQ(estimator.GetSmoothedRtt(), 30ms);
+    EXPECT_EQ(estimator.GetMinRtt(), 30ms);
+}
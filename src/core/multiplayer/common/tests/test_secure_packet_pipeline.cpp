@@ -0,0 +1,232 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core/multiplayer/common/secure_packet_pipeline.h"
+#include <gtest/gtest.h>
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace Core::Multiplayer;
+using namespace Core::Multiplayer::Security;
+
+namespace {
+constexpr const char* LDN_PROTOCOL = "/sudachi/ldn/1.0.0";
+
+// "LD" magic and version 1, then the sequence number in the first payload byte
+InboundPacket MakePacket(const std::string& client_id, const std::string& client_ip,
+                         uint8_t sequence, size_t size = 32) {
+    InboundPacket packet;
+    packet.client_id = client_id;
+    packet.client_ip = client_ip;
+    packet.data.assign(size, 0x42);
+    packet.data[0] = 0x44;
+    packet.data[1] = 0x4C;
+    packet.data[2] = 0x01;
+    packet.data[3] = 0x00;
+    packet.data[4] = sequence;
+    packet.protocol = LDN_PROTOCOL;
+    return packet;
+}
+
+struct Received {
+    std::mutex mutex;
+    std::vector<std::pair<std::string, uint8_t>> packets;
+    std::vector<std::string> rejections;
+};
+
+RateLimitConfig GenerousRates() {
+    RateLimitConfig config;
+    config.packets_per_second = 1e6;
+    config.burst_capacity = 1e6;
+    config.bytes_per_second = 1e9;
+    config.byte_burst_capacity = 1e9;
+    return config;
+}
+
+DDoSProtectionConfig GenerousGlobalRate() {
+    DDoSProtectionConfig config;
+    config.max_packets_per_second = 1000000;
+    return config;
+}
+} // namespace
+
+TEST(SecurePacketPipelineTest, DispatchesAcceptedPacketsInOrder) {
+    NetworkSecurityManager manager(GenerousRates(), GenerousGlobalRate());
+    Received received;
+    SecurePacketPipeline pipeline(
+        manager,
+        [&](const std::string& client_id, const std::vector<uint8_t>& data) {
+            std::lock_guard<std::mutex> lock(received.mutex);
+            received.packets.emplace_back(client_id, data[4]);
+        });
+    pipeline.Start();
+
+    for (uint8_t batch_index = 0; batch_index < 10; ++batch_index) {
+        InboundPacketBatch batch;
+        for (uint8_t i = 0; i < 10; ++i) {
+            batch.push_back(MakePacket("alice", "192.0.2.1", batch_index * 10 + i));
+        }
+        ASSERT_TRUE(pipeline.Submit(std::move(batch)));
+    }
+    pipeline.Stop();
+
+    ASSERT_EQ(received.packets.size(), 100u);
+    for (size_t i = 0; i < received.packets.size(); ++i) {
+        EXPECT_EQ(received.packets[i].second, i);
+    }
+    const auto stats = pipeline.GetStatistics();
+    for (const auto& stage : stats.stages) {
+        EXPECT_EQ(stage.packets, 100u);
+        EXPECT_EQ(stage.packets_rejected, 0u);
+    }
+    EXPECT_EQ(manager.GetSecurityStatistics().packets_accepted, 100u);
+}
+
+TEST(SecurePacketPipelineTest, EachStageDropsWhatItRejects) {
+    RateLimitConfig rates = GenerousRates();
+    rates.packets_per_second = 0.001;
+    rates.burst_capacity = 2.0;
+    NetworkSecurityManager manager(rates, GenerousGlobalRate());
+
+    Received received;
+    SecurePacketPipeline pipeline(
+        manager,
+        [&](const std::string& client_id, const std::vector<uint8_t>& data) {
+            std::lock_guard<std::mutex> lock(received.mutex);
+            received.packets.emplace_back(client_id, data[4]);
+        },
+        [&](const InboundPacket& packet, const ValidationResult& result) {
+            std::lock_guard<std::mutex> lock(received.mutex);
+            received.rejections.push_back(packet.client_id + ": " + result.error_message);
+        });
+    pipeline.Start();
+
+    InboundPacketBatch batch;
+    batch.push_back(MakePacket("alice", "192.0.2.1", 1));
+    batch.push_back(MakePacket("alice", "192.0.2.1", 2));
+    batch.push_back(MakePacket("alice", "192.0.2.1", 3)); // over alice's burst
+    batch.push_back(MakePacket("bob", "192.0.2.2", 4, 8)); // too short
+    batch.push_back(MakePacket("carol", "192.0.2.3", 5));
+    InboundPacket bad_magic = MakePacket("dave", "192.0.2.4", 6);
+    bad_magic.data[0] = 0;
+    batch.push_back(std::move(bad_magic));
+    ASSERT_TRUE(pipeline.Submit(std::move(batch)));
+    pipeline.Stop();
+
+    std::vector<uint8_t> sequences;
+    for (const auto& packet : received.packets) {
+        sequences.push_back(packet.second);
+    }
+    EXPECT_EQ(sequences, (std::vector<uint8_t>{1, 2, 5}));
+    EXPECT_EQ(received.rejections.size(), 3u);
+
+    const auto stats = pipeline.GetStatistics();
+    const auto& rate_stage = stats.stages[static_cast<size_t>(PipelineStage::RateLimit)];
+    const auto& validation_stage = stats.stages[static_cast<size_t>(PipelineStage::Validation)];
+    EXPECT_EQ(rate_stage.packets_rejected, 1u);
+    EXPECT_EQ(validation_stage.packets_rejected, 2u);
+    EXPECT_EQ(manager.GetSecurityStatistics().packets_rejected, 3u);
+}
+
+TEST(SecurePacketPipelineTest, RejectsBlacklistedSources) {
+    DDoSProtectionConfig ddos = GenerousGlobalRate();
+    ddos.max_connections_per_ip = 1;
+    NetworkSecurityManager manager(GenerousRates(), ddos);
+    // The second connection from the address gets it banned
+    ASSERT_TRUE(manager.ValidateNewConnection("203.0.113.9", "first").is_valid);
+    ASSERT_FALSE(manager.ValidateNewConnection("203.0.113.9", "second").is_valid);
+
+    size_t dispatched = 0;
+    SecurePacketPipeline pipeline(
+        manager, [&](const std::string&, const std::vector<uint8_t>&) { ++dispatched; });
+    pipeline.Start();
+    InboundPacketBatch batch;
+    batch.push_back(MakePacket("mallory", "203.0.113.9", 1));
+    batch.push_back(MakePacket("mallory", "203.0.113.9", 2));
+    batch.push_back(MakePacket("alice", "192.0.2.1", 3));
+    ASSERT_TRUE(pipeline.Submit(std::move(batch)));
+    pipeline.Stop();
+
+    EXPECT_EQ(dispatched, 1u);
+    EXPECT_EQ(pipeline.GetStatistics().stages[0].packets_rejected, 2u);
+}
+
+TEST(SecurePacketPipelineTest, RefusesWorkWhenStoppedOrFull) {
+    NetworkSecurityManager manager(GenerousRates(), GenerousGlobalRate());
+    SecurePacketPipelineConfig config;
+    config.queue_capacity = 2;
+    SecurePacketPipeline pipeline(manager, nullptr, nullptr, config);
+
+    InboundPacketBatch batch{MakePacket("alice", "192.0.2.1", 1)};
+    EXPECT_FALSE(pipeline.Submit(std::move(batch)));
+    EXPECT_EQ(batch.size(), 1u);
+
+    pipeline.Start();
+    pipeline.Stop();
+    EXPECT_FALSE(pipeline.IsRunning());
+    EXPECT_FALSE(pipeline.Submit(std::move(batch)));
+}
+
+TEST(SecurePacketPipelineTest, PinnedStagesStillRun) {
+    NetworkSecurityManager manager(GenerousRates(), GenerousGlobalRate());
+    SecurePacketPipelineConfig config;
+    config.stage_cpus = {0, 1, 2, 3};
+    size_t dispatched = 0;
+    SecurePacketPipeline pipeline(
+        manager, [&](const std::string&, const std::vector<uint8_t>&) { ++dispatched; }, nullptr,
+        config);
+    pipeline.Start();
+    ASSERT_TRUE(pipeline.Submit(InboundPacketBatch{MakePacket("alice", "192.0.2.1", 1)}));
+    pipeline.Stop();
+    EXPECT_EQ(dispatched, 1u);
+}
+
+// Components/SecurePacketPipeline/* in the component benchmarks times this
+// traffic through the pipeline and inline
+TEST(SecurePacketPipelineTest, AgreesWithInlineChecksAcrossClients) {
+    constexpr size_t BATCH = 64;
+    constexpr size_t BATCHES = 50;
+    constexpr size_t CLIENTS = 16;
+
+    std::vector<InboundPacketBatch> batches;
+    for (size_t b = 0; b < BATCHES; ++b) {
+        InboundPacketBatch batch;
+        for (size_t i = 0; i < BATCH; ++i) {
+            const size_t client = (b + i / 8) % CLIENTS;
+            batch.push_back(MakePacket("client" + std::to_string(client),
+                                       "192.0.2." + std::to_string(client + 1),
+                                       static_cast<uint8_t>(i), 256));
+        }
+        batches.push_back(std::move(batch));
+    }
+
+    NetworkSecurityManager inline_manager(GenerousRates(), GenerousGlobalRate());
+    size_t inline_accepted = 0;
+    for (const auto& batch : batches) {
+        for (const auto& packet : batch) {
+            inline_accepted += inline_manager
+                                   .ValidateIncomingPacket(packet.client_id, packet.client_ip,
+                                                           packet.data, packet.protocol)
+                                   .is_valid;
+        }
+    }
+
+    NetworkSecurityManager manager(GenerousRates(), GenerousGlobalRate());
+    SecurePacketPipelineConfig config;
+    config.queue_capacity = BATCHES;
+    size_t dispatched = 0;
+    SecurePacketPipeline pipeline(
+        manager, [&](const std::string&, const std::vector<uint8_t>&) { ++dispatched; }, nullptr,
+        config);
+    pipeline.Start();
+    for (auto& batch : batches) {
+        ASSERT_TRUE(pipeline.Submit(std::move(batch)));
+    }
+    pipeline.Stop();
+
+    EXPECT_EQ(inline_accepted, BATCH * BATCHES);
+    EXPECT_EQ(dispatched, BATCH * BATCHES);
+    EXPECT_EQ(manager.GetSecurityStatistics().rate_limits.tracked_clients, CLIENTS);
+}
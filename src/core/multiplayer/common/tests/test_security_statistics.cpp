@@ -0,0 +1,159 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core/multiplayer/common/network_security.h"
+#include "core/multiplayer/common/sharded_counters.h"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace Core::Multiplayer;
+using namespace Core::Multiplayer::Security;
+
+namespace {
+constexpr const char* LDN_PROTOCOL = "/sudachi/ldn/1.0.0";
+
+// "LD" magic and version 1, then a payload
+std::vector<uint8_t> MakePacket(size_t size) {
+    std::vector<uint8_t> packet(size, 0x42);
+    packet[0] = 0x44;
+    packet[1] = 0x4C;
+    packet[2] = 0x01;
+    packet[3] = 0x00;
+    return packet;
+}
+} // namespace
+
+TEST(ShardedCountersTest, SumsAddsFromManyThreads) {
+    ShardedCounters<2> counters;
+    constexpr int THREADS = 8;
+    constexpr int ADDS = 100000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&counters]() {
+            for (int i = 0; i < ADDS; ++i) {
+                counters.Add(0);
+                counters.Add(1, 3);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(counters.Load(0), static_cast<uint64_t>(THREADS) * ADDS);
+    EXPECT_EQ(counters.Load(1), static_cast<uint64_t>(THREADS) * ADDS * 3);
+}
+
+TEST(SecurityStatisticsTest, CountsConnectionDecisions) {
+    DDoSProtectionConfig config;
+    config.max_connections_per_ip = 1;
+    DDoSProtection protection(config);
+    protection.BlacklistIP("198.51.100.0/24", "abuse");
+
+    EXPECT_TRUE(protection.AllowNewConnection("192.0.2.1"));
+    protection.RegisterConnection("192.0.2.1", "a");
+    EXPECT_FALSE(protection.AllowNewConnection("192.0.2.1"));
+    EXPECT_FALSE(protection.AllowNewConnection("198.51.100.9"));
+
+    auto stats = protection.GetProtectionStatistics();
+    EXPECT_EQ(stats.connections_allowed, 1u);
+    EXPECT_EQ(stats.per_address_rejections, 1u);
+    EXPECT_EQ(stats.blacklist_rejections, 1u);
+    EXPECT_EQ(stats.active_connections, 1u);
+    EXPECT_EQ(stats.unique_addresses, 1u);
+    // The /24 and the ban on 192.0.2.1 for exceeding its limit
+    EXPECT_EQ(stats.blacklist_entries, 2u);
+
+    protection.RemoveConnection("192.0.2.1", "a");
+    stats = protection.GetProtectionStatistics();
+    EXPECT_EQ(stats.active_connections, 0u);
+    EXPECT_EQ(stats.unique_addresses, 0u);
+}
+
+TEST(SecurityStatisticsTest, CountsRateLimitedClients) {
+    RateLimitConfig config;
+    config.burst_capacity = 2.0;
+    config.packets_per_second = 0.001;
+    ClientRateManager manager(config);
+
+    EXPECT_TRUE(manager.CheckPacketRateLimit("alice"));
+    EXPECT_TRUE(manager.CheckPacketRateLimit("alice"));
+    EXPECT_FALSE(manager.CheckPacketRateLimit("alice"));
+    EXPECT_TRUE(manager.CheckByteRateLimit("bob", 100));
+
+    const auto stats = manager.GetStatistics();
+    EXPECT_EQ(stats.tracked_clients, 2u);
+    EXPECT_EQ(stats.packets_checked, 3u);
+    EXPECT_EQ(stats.packets_limited, 1u);
+    EXPECT_EQ(stats.bytes_checked, 100u);
+    EXPECT_EQ(stats.bytes_limited, 0u);
+
+    const auto alice = manager.GetClientStatistics("alice");
+    ASSERT_TRUE(alice.has_value());
+    EXPECT_EQ(alice->total_packets, 3u);
+    EXPECT_FALSE(manager.GetClientStatistics("carol").has_value());
+}
+
+TEST(SecurityStatisticsTest, ManagerCountsAcceptedAndRejected) {
+    NetworkSecurityManager manager(RateLimitConfig{}, DDoSProtectionConfig{});
+    const auto good = MakePacket(64);
+    const auto too_small = MakePacket(4);
+
+    EXPECT_TRUE(manager.ValidateIncomingPacket("alice", "192.0.2.1", good, LDN_PROTOCOL).is_valid);
+    EXPECT_FALSE(
+        manager.ValidateIncomingPacket("alice", "192.0.2.1", too_small, LDN_PROTOCOL).is_valid);
+    EXPECT_TRUE(
+        manager.ValidateIncomingJsonMessage("alice", "192.0.2.1", R"({"type":"ping"})").is_valid);
+    EXPECT_FALSE(manager.ValidateIncomingJsonMessage("alice", "192.0.2.1", "{").is_valid);
+
+    const auto stats = manager.GetSecurityStatistics();
+    EXPECT_EQ(stats.packets_accepted, 1u);
+    EXPECT_EQ(stats.packets_rejected, 1u);
+    EXPECT_EQ(stats.json_messages_accepted, 1u);
+    EXPECT_EQ(stats.json_messages_rejected, 1u);
+    EXPECT_EQ(stats.rate_limits.tracked_clients, 1u);
+
+    const std::string text = manager.GetSecurityStats();
+    EXPECT_NE(text.find("Packets accepted/rejected: 1/1"), std::string::npos);
+    EXPECT_NE(text.find("Active connections: 0/"), std::string::npos);
+}
+
+// Components/NetworkSecurityManager/PollStatistics in the component
+// benchmarks times the polls
+TEST(SecurityStatisticsTest, PollsUnderLoadNeverGoBackwards) {
+    NetworkSecurityManager manager(RateLimitConfig{}, DDoSProtectionConfig{});
+    const auto packet = MakePacket(64);
+    constexpr int WORKERS = 4;
+    constexpr int PACKETS = 2000;
+    std::atomic<int> finished{0};
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < WORKERS; ++t) {
+        workers.emplace_back([&, t]() {
+            const std::string client = "client" + std::to_string(t);
+            for (int i = 0; i < PACKETS; ++i) {
+                manager.ValidateIncomingPacket(client, "192.0.2.1", packet, LDN_PROTOCOL);
+            }
+            ++finished;
+        });
+    }
+
+    uint64_t observed = 0;
+    while (finished.load() != WORKERS) {
+        const auto stats = manager.GetSecurityStatistics();
+        const uint64_t decided = stats.packets_accepted + stats.packets_rejected;
+        EXPECT_GE(decided, observed);
+        observed = decided;
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    const auto final_stats = manager.GetSecurityStatistics();
+    EXPECT_EQ(final_stats.packets_accepted + final_stats.packets_rejected,
+              static_cast<uint64_t>(WORKERS) * PACKETS);
+}
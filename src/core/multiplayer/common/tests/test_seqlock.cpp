@@ -0,0 +1,68 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "core/multiplayer/common/seqlock.h"
+
+using namespace Core::Multiplayer;
+
+namespace {
+
+// About the size of an LDN NetworkInfo, with an odd tail
+struct LargeValue {
+    std::array<uint32_t, 290> words;
+    uint8_t tail;
+};
+
+LargeValue Filled(uint32_t value) {
+    LargeValue large{};
+    large.words.fill(value);
+    large.tail = static_cast<uint8_t>(value);
+    return large;
+}
+
+} // namespace
+
+TEST(SeqLockTest, LoadReturnsTheLastStore) {
+    SeqLock<LargeValue> lock;
+    EXPECT_EQ(lock.Load().words[0], 0u);
+
+    lock.Store(Filled(7));
+    const LargeValue loaded = lock.Load();
+    EXPECT_EQ(loaded.words.back(), 7u);
+    EXPECT_EQ(loaded.tail, 7);
+}
+
+TEST(SeqLockTest, ReadersNeverSeeATornValue) {
+    SeqLock<LargeValue> lock;
+    std::atomic<bool> done{false};
+    std::atomic<bool> torn{false};
+
+    std::thread reader([&] {
+        while (!done.load(std::memory_order_acquire)) {
+            const LargeValue value = lock.Load();
+            for (const uint32_t word : value.words) {
+                if (word != value.words[0]) {
+                    torn = true;
+                }
+            }
+            if (value.tail != static_cast<uint8_t>(value.words[0])) {
+                torn = true;
+            }
+        }
+    });
+
+    for (uint32_t i = 1; i <= 20000; ++i) {
+        lock.Store(Filled(i));
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+
+    EXPECT_FALSE(torn);
+    EXPECT_EQ(lock.Load().words[0], 20000u);
+}
@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core/multiplayer/common/datagram_socket.h"
+#include "core/multiplayer/common/socket_tuning.h"
+#include <gtest/gtest.h>
+#include <chrono>
+
+#ifndef _WIN32
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using namespace Core::Multiplayer;
+using namespace std::chrono_literals;
+
+namespace {
+
+#ifndef _WIN32
+int GetInt(int socket, int level, int name) {
+    int value = -1;
+    socklen_t length = sizeof(value);
+    getsockopt(socket, level, name, &value, &length);
+    return value;
+}
+
+TEST(SocketTuningTest, MarksIpv4DatagramSocket) {
+    DatagramSocket socket;
+    ASSERT_EQ(socket.Open("127.0.0.1", 0), ErrorCode::Success);
+
+    SocketTuningProfile profile = SocketTuningProfile::Realtime();
+    const SocketTuningResult result = socket.Tune(profile);
+    EXPECT_TRUE(result.buffers);
+    EXPECT_TRUE(result.traffic_class);
+
+    const int handle = static_cast<int>(socket.GetNativeHandle());
+    EXPECT_EQ(GetInt(handle, IPPROTO_IP, IP_TOS), 46 << 2);
+    // Linux reports double the requested size to account for bookkeeping
+    EXPECT_GE(GetInt(handle, SOL_SOCKET, SO_SNDBUF),
+              static_cast<int>(profile.send_buffer_size));
+}
+
+TEST(SocketTuningTest, MarksIpv6DatagramSocket) {
+    DatagramSocket socket;
+    if (socket.Open("::1", 0) != ErrorCode::Success) {
+        GTEST_SKIP() << "No IPv6 loopback";
+    }
+    SocketTuningProfile profile;
+    profile.traffic_class = TrafficClass::Video;
+    EXPECT_TRUE(socket.Tune(profile).traffic_class);
+    EXPECT_EQ(GetInt(static_cast<int>(socket.GetNativeHandle()), IPPROTO_IPV6, IPV6_TCLASS),
+              34 << 2);
+}
+
+TEST(SocketTuningTest, NoDelayOnlyTouchesStreamSockets) {
+    const int stream = ::socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(stream, 0);
+    SocketTuningProfile profile;
+    profile.no_delay = true;
+    EXPECT_TRUE(ApplySocketTuning(stream, profile).no_delay);
+    EXPECT_NE(GetInt(stream, IPPROTO_TCP, TCP_NODELAY), 0);
+    ::close(stream);
+
+    DatagramSocket datagram;
+    ASSERT_EQ(datagram.Open("127.0.0.1", 0), ErrorCode::Success);
+    EXPECT_TRUE(datagram.Tune(profile).no_delay);
+}
+#endif
+
+TEST(SocketTuningTest, TuningClosedSocketFails) {
+    DatagramSocket socket;
+    const SocketTuningResult result = socket.Tune(SocketTuningProfile::Realtime());
+    EXPECT_FALSE(result.buffers);
+    EXPECT_FALSE(result.traffic_class);
+}
+
+TEST(AdaptiveSendBufferTest, ShrinksUnderDelayAndGrowsBack) {
+    SendBufferAdaptationConfig config;
+    config.min_size = 16 * 1024;
+    AdaptiveSendBuffer buffer(64 * 1024, config);
+
+    EXPECT_EQ(buffer.OnQueuingDelay(50ms), std::optional<size_t>{32 * 1024});
+    EXPECT_EQ(buffer.OnQueuingDelay(50ms), std::optional<size_t>{16 * 1024});
+    // Floored at the minimum
+    EXPECT_EQ(buffer.OnQueuingDelay(50ms), std::nullopt);
+    // Between the thresholds the size holds
+    EXPECT_EQ(buffer.OnQueuingDelay(10ms), std::nullopt);
+    EXPECT_EQ(buffer.GetSize(), 16u * 1024);
+
+    EXPECT_EQ(buffer.OnQueuingDelay(1ms), std::optional<size_t>{32 * 1024});
+    EXPECT_EQ(buffer.OnQueuingDelay(1ms), std::optional<size_t>{64 * 1024});
+    EXPECT_EQ(buffer.OnQueuingDelay(1ms), std::nullopt);
+}
+
+TEST(AdaptiveSendBufferTest, SystemDefaultSizeIsLeftAlone) {
+    AdaptiveSendBuffer buffer(0);
+    EXPECT_EQ(buffer.OnQueuingDelay(100ms), std::nullopt);
+    EXPECT_EQ(buffer.GetSize(), 0u);
+}
+
+} // namespace
@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core/multiplayer/common/packet_buffer.h"
+#include "core/multiplayer/common/spsc_ring.h"
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace Core::Multiplayer;
+
+TEST(SpscRingTest, CapacityRoundsUpToPowerOfTwo) {
+    SpscRing<int> ring(5);
+    EXPECT_EQ(ring.Capacity(), 8u);
+    EXPECT_TRUE(ring.Empty());
+}
+
+TEST(SpscRingTest, PopsInFifoOrder) {
+    SpscRing<int> ring(4);
+    EXPECT_TRUE(ring.TryPush(1));
+    EXPECT_TRUE(ring.TryPush(2));
+    EXPECT_TRUE(ring.TryPush(3));
+
+    int value = 0;
+    ASSERT_TRUE(ring.TryPop(value));
+    EXPECT_EQ(value, 1);
+    ASSERT_TRUE(ring.TryPop(value));
+    EXPECT_EQ(value, 2);
+    ASSERT_TRUE(ring.TryPop(value));
+    EXPECT_EQ(value, 3);
+    EXPECT_FALSE(ring.TryPop(value));
+}
+
+TEST(SpscRingTest, FullRingDropsAndCounts) {
+    SpscRing<int> ring(2);
+    EXPECT_TRUE(ring.TryPush(1));
+    EXPECT_TRUE(ring.TryPush(2));
+    EXPECT_FALSE(ring.TryPush(3));
+    EXPECT_FALSE(ring.TryPush(4));
+
+    auto stats = ring.GetStatistics();
+    EXPECT_EQ(stats.size, 2u);
+    EXPECT_EQ(stats.high_watermark, 2u);
+    EXPECT_EQ(stats.pushed_count, 2u);
+    EXPECT_EQ(stats.dropped_count, 2u);
+}
+
+TEST(SpscRingTest, PoppedSlotReleasesPooledBuffer) {
+    PacketPool pool(2);
+    SpscRing<ReceivedPacket> ring(2);
+
+    const uint8_t bytes[] = {0xAB, 0xCD};
+    ReceivedPacket packet;
+    packet.packet = pool.Acquire(bytes, sizeof(bytes));
+    packet.node_id = 3;
+    ASSERT_TRUE(ring.TryPush(std::move(packet)));
+    EXPECT_EQ(pool.Available(), 1u);
+
+    ReceivedPacket received;
+    ASSERT_TRUE(ring.TryPop(received));
+    EXPECT_EQ(received.node_id, 3);
+    ASSERT_EQ(received.packet.size(), sizeof(bytes));
+    EXPECT_EQ(received.packet.data()[0], 0xAB);
+
+    received.packet.Reset();
+    EXPECT_EQ(pool.Available(), 2u);
+}
+
+TEST(SpscRingTest, ConcurrentProducerConsumerPreservesOrder) {
+    constexpr int COUNT = 100000;
+    SpscRing<int> ring(64);
+
+    std::thread producer([&ring]() {
+        for (int i = 0; i < COUNT; ++i) {
+            while (!ring.TryPush(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int expected = 0;
+    int value = 0;
+    while (expected < COUNT) {
+        if (ring.TryPop(value)) {
+            ASSERT_EQ(value, expected);
+            ++expected;
+        }
+    }
+    producer.join();
+
+    EXPECT_TRUE(ring.Empty());
+    EXPECT_LE(ring.HighWatermark(), ring.Capacity());
+}
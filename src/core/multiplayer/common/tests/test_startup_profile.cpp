@@ -0,0 +1,101 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core/multiplayer/common/backend_stats.h"
+#include "core/multiplayer/common/startup_profile.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+
+using namespace Core::Multiplayer;
+using namespace std::chrono_literals;
+
+TEST(StartupProfileTest, EmptyUntilAPhaseStarts) {
+    ResetStartupProfile();
+    const StartupReport report = GetStartupReport();
+    for (const auto& timing : report.phases) {
+        EXPECT_FALSE(timing.started);
+    }
+    EXPECT_EQ(report.total, 0us);
+    EXPECT_EQ(report.Format(), "total 0ms, critical 0ms:");
+}
+
+TEST(StartupProfileTest, CriticalPathFollowsWhatTheLastPhaseWaitedOn) {
+    ResetStartupProfile();
+    BeginStartupPhase(StartupPhase::HostInit);
+    std::this_thread::sleep_for(20ms);
+    EndStartupPhase(StartupPhase::HostInit);
+
+    // Discovery runs beside the room connection and finishes first
+    BeginStartupPhase(StartupPhase::RoomConnect);
+    BeginStartupPhase(StartupPhase::MdnsFirstResult);
+    std::this_thread::sleep_for(5ms);
+    EndStartupPhase(StartupPhase::MdnsFirstResult);
+    std::this_thread::sleep_for(30ms);
+    EndStartupPhase(StartupPhase::RoomConnect);
+
+    const StartupReport report = GetStartupReport();
+    EXPECT_TRUE(report[StartupPhase::HostInit].critical);
+    EXPECT_TRUE(report[StartupPhase::RoomConnect].critical);
+    EXPECT_FALSE(report[StartupPhase::MdnsFirstResult].critical);
+    EXPECT_FALSE(report[StartupPhase::NatDetection].started);
+
+    EXPECT_GE(report[StartupPhase::HostInit].duration, 20ms);
+    EXPECT_GE(report[StartupPhase::RoomConnect].duration, 35ms);
+    EXPECT_GE(report[StartupPhase::RoomConnect].start, 20ms);
+    EXPECT_GE(report.total, 55ms);
+    EXPECT_EQ(report.critical_path, report[StartupPhase::HostInit].duration +
+                                        report[StartupPhase::RoomConnect].duration);
+    EXPECT_LE(report.critical_path, report.total);
+
+    const std::string text = report.Format();
+    EXPECT_LT(text.find("host_init"), text.find("room_connect"));
+    EXPECT_NE(text.find("mdns_first_result"), std::string::npos);
+    EXPECT_EQ(text.find("mdns_first_result " +
+                        std::to_string(report[StartupPhase::MdnsFirstResult].duration.count() /
+                                       1000) +
+                        "ms*"),
+              std::string::npos);
+}
+
+TEST(StartupProfileTest, KeepsOnlyTheFirstRun) {
+    ResetStartupProfile();
+    // An end without a beginning is ignored
+    EndStartupPhase(StartupPhase::NatDetection);
+    EXPECT_FALSE(GetStartupReport()[StartupPhase::NatDetection].started);
+
+    {
+        StartupSpan span(StartupPhase::BackendCreation);
+        span.Fail();
+    }
+    const auto first = GetStartupReport()[StartupPhase::BackendCreation];
+    ASSERT_TRUE(first.finished);
+    EXPECT_TRUE(first.failed);
+
+    // A later retry does not replace what startup cost
+    {
+        StartupSpan span(StartupPhase::BackendCreation);
+        std::this_thread::sleep_for(5ms);
+    }
+    const auto after = GetStartupReport()[StartupPhase::BackendCreation];
+    EXPECT_TRUE(after.failed);
+    EXPECT_EQ(after.duration, first.duration);
+    EXPECT_NE(GetStartupReport().Format().find("backend_creation"), std::string::npos);
+}
+
+TEST(StartupProfileTest, UnfinishedPhasesShowTimeSoFar) {
+    ResetStartupProfile();
+    BeginStartupPhase(StartupPhase::WifiDirectNegotiation);
+    std::this_thread::sleep_for(5ms);
+
+    BackendStatsRecorder recorder;
+    BackendStats stats;
+    recorder.Fill(stats);
+    const auto& timing = stats.startup[StartupPhase::WifiDirectNegotiation];
+    EXPECT_TRUE(timing.started);
+    EXPECT_FALSE(timing.finished);
+    EXPECT_GE(timing.duration, 5ms);
+    EXPECT_NE(stats.startup.Format().find("wifi_direct_negotiation"), std::string::npos);
+    EXPECT_NE(stats.startup.Format().find("..."), std::string::npos);
+    ResetStartupProfile();
+}
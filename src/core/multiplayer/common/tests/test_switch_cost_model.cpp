@@ -0,0 +1,114 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <chrono>
+#include <thread>
+
+#include "core/multiplayer/common/graceful_degradation_manager.h"
+#include "mocks/mock_multiplayer_backend.h"
+
+using namespace Core::Multiplayer;
+using namespace std::chrono_literals;
+
+namespace {
+TrafficSample Sample(std::chrono::microseconds rtt, uint64_t received, uint64_t missing) {
+    TrafficSample sample;
+    sample.rtt = rtt;
+    sample.packets_received = received;
+    sample.packets_missing = missing;
+    return sample;
+}
+
+class SwitchCostModelTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        manager.SetInternetBackend(&internet_backend);
+        manager.SetAdhocBackend(&adhoc_backend);
+    }
+
+    // Backend availability is simulated; retry until the switch lands
+    void StartOnInternet() {
+        for (int i = 0; i < 20 && manager.GetCurrentMode() != MultiplayerMode::Internet; ++i) {
+            manager.Initialize(MultiplayerMode::Internet);
+        }
+        ASSERT_EQ(manager.GetCurrentMode(), MultiplayerMode::Internet);
+    }
+
+    void MoveToAdhoc() {
+        for (int i = 0; i < 20 && manager.GetCurrentMode() != MultiplayerMode::Adhoc; ++i) {
+            manager.AttemptRecovery(MultiplayerMode::Adhoc);
+        }
+        ASSERT_EQ(manager.GetCurrentMode(), MultiplayerMode::Adhoc);
+    }
+
+    void Report(MultiplayerMode mode, TrafficSample sample, int count) {
+        for (int i = 0; i < count; ++i) {
+            manager.ReportTrafficSample(mode, sample);
+        }
+    }
+
+    DegradationConfig config;
+    GracefulDegradationManager manager{config};
+    ::testing::NiceMock<MockMultiplayerBackend> internet_backend;
+    ::testing::NiceMock<MockMultiplayerBackend> adhoc_backend;
+};
+} // namespace
+
+TEST_F(SwitchCostModelTest, HoldsASwitchUntilItPaysBack) {
+    // A ready standby is the target without a simulated availability check
+    manager.SetStandbyHandlers({[](MultiplayerMode) { return ErrorCode::Success; },
+                                [](MultiplayerMode) {}});
+    StartOnInternet();
+    Report(MultiplayerMode::Adhoc, Sample(80ms, 100, 0), 8);
+    Report(MultiplayerMode::Internet, Sample(20ms, 90, 10), 8);
+    for (int i = 0; i < 200 && !manager.GetDegradationStatus().standby_ready; ++i) {
+        std::this_thread::sleep_for(5ms);
+    }
+    ASSERT_TRUE(manager.GetDegradationStatus().standby_ready);
+
+    // Lossy enough to be unhealthy, but its short round trips still beat
+    // the slower Adhoc path
+    Report(MultiplayerMode::Internet, Sample(20ms, 75, 25), 10);
+    ASSERT_EQ(manager.GetHealthMetrics(MultiplayerMode::Internet).status,
+              BackendHealthStatus::Unhealthy);
+    EXPECT_EQ(manager.GetCurrentMode(), MultiplayerMode::Internet);
+    EXPECT_EQ(manager.GetDegradationStatus().held_switches, 1u);
+
+    // Once most packets are lost the held switch goes ahead
+    for (int i = 0; i < 20 && manager.GetCurrentMode() == MultiplayerMode::Internet; ++i) {
+        manager.ReportTrafficSample(MultiplayerMode::Internet, Sample(20ms, 20, 80));
+    }
+    EXPECT_EQ(manager.GetCurrentMode(), MultiplayerMode::Adhoc);
+    EXPECT_EQ(manager.GetDegradationStatus().held_switches, 1u);
+    manager.Shutdown();
+}
+
+TEST_F(SwitchCostModelTest, DwellTimeHoldsTimeoutsButNotLostConnections) {
+    StartOnInternet();
+    MoveToAdhoc();
+
+    manager.HandleError(CreateNetworkError(ErrorCode::NetworkTimeout, "timeout"));
+    EXPECT_EQ(manager.GetCurrentMode(), MultiplayerMode::Adhoc);
+    EXPECT_EQ(manager.GetDegradationStatus().held_switches, 1u);
+
+    manager.HandleError(CreateNetworkError(ErrorCode::ConnectionLost, "lost"));
+    EXPECT_NE(manager.GetCurrentMode(), MultiplayerMode::Adhoc);
+}
+
+TEST_F(SwitchCostModelTest, SwitchCostFollowsMeasuredSwitches) {
+    EXPECT_EQ(manager.GetDegradationStatus().switch_cost, 3000ms);
+    StartOnInternet();
+    MoveToAdhoc();
+
+    // Traffic arrives at once, so the estimate moves 30% of the way to zero
+    manager.ReportTrafficSample(MultiplayerMode::Adhoc, Sample(20ms, 100, 0));
+    const auto cost = manager.GetDegradationStatus().switch_cost;
+    EXPECT_GT(cost, 2000ms);
+    EXPECT_LE(cost, 2100ms);
+
+    // Later traffic on the same mode is not another switch
+    manager.ReportTrafficSample(MultiplayerMode::Adhoc, Sample(20ms, 100, 0));
+    EXPECT_EQ(manager.GetDegradationStatus().switch_cost, cost);
+}
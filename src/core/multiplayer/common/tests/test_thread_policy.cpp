@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "core/multiplayer/common/thread_policy.h"
+
+using namespace Core::Multiplayer;
+
+namespace {
+
+// Restores the process-wide policy the test replaced
+class ThreadPolicyTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        saved_ = GetThreadPolicy();
+    }
+    void TearDown() override {
+        SetThreadPolicy(saved_);
+    }
+
+    ThreadPolicy saved_;
+};
+
+} // namespace
+
+TEST_F(ThreadPolicyTest, DesktopLeavesPlacementToTheScheduler) {
+    const auto policy = ThreadPolicy::ForProfile(ThreadProfile::Desktop, {1, 1, 1, 1});
+    for (const auto& role : policy.roles) {
+        EXPECT_TRUE(role.cpus.empty());
+    }
+    EXPECT_EQ(policy.For(ThreadRole::NetworkIo).priority, ThreadPriority::Elevated);
+    EXPECT_EQ(policy.For(ThreadRole::Background).priority, ThreadPriority::Low);
+}
+
+TEST_F(ThreadPolicyTest, AndroidKeepsToTheLittleCores) {
+    // Four little, three mid and one prime core, as on a Snapdragon 8 Gen 2
+    const std::vector<uint32_t> capacities{325, 325, 325, 325, 820, 820, 820, 1024};
+    const auto policy = ThreadPolicy::ForProfile(ThreadProfile::AndroidBigLittle, capacities);
+    for (const auto& role : policy.roles) {
+        EXPECT_EQ(role.cpus, (std::vector<uint32_t>{0, 1, 2, 3, 4, 5, 6}));
+    }
+
+    // Without a slower core there is nothing to prefer
+    const auto uniform = ThreadPolicy::ForProfile(ThreadProfile::AndroidBigLittle, {1, 1});
+    EXPECT_TRUE(uniform.For(ThreadRole::NetworkIo).cpus.empty());
+    EXPECT_TRUE(ThreadPolicy::ForProfile(ThreadProfile::AndroidBigLittle, {})
+                    .For(ThreadRole::Worker)
+                    .cpus.empty());
+}
+
+TEST_F(ThreadPolicyTest, SteamDeckTakesTheLastCore) {
+    const auto policy =
+        ThreadPolicy::ForProfile(ThreadProfile::SteamDeck, std::vector<uint32_t>(8, 1));
+    EXPECT_EQ(policy.For(ThreadRole::NetworkIo).cpus, (std::vector<uint32_t>{6, 7}));
+    EXPECT_EQ(policy.For(ThreadRole::NetworkIo).priority, ThreadPriority::Realtime);
+    EXPECT_EQ(policy.For(ThreadRole::Timer).cpus, (std::vector<uint32_t>{6, 7}));
+    EXPECT_EQ(policy.For(ThreadRole::Worker).cpus, (std::vector<uint32_t>{4, 5, 6, 7}));
+}
+
+TEST_F(ThreadPolicyTest, SpawnedThreadIsNamedAndPlaced) {
+    ThreadPolicy policy;
+    policy.For(ThreadRole::Worker).cpus = {0};
+    SetThreadPolicy(policy);
+
+    bool ran = false;
+    std::string name;
+    bool pinned = false;
+    auto thread = SpawnThread(ThreadRole::Worker, "mp-test-thread-name", [&] {
+        ran = true;
+#ifdef __linux__
+        char buffer[32] = {};
+        pthread_getname_np(pthread_self(), buffer, sizeof(buffer));
+        name = buffer;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        pthread_getaffinity_np(pthread_self(), sizeof(set), &set);
+        pinned = CPU_COUNT(&set) == 1 && CPU_ISSET(0, &set);
+#endif
+    });
+    thread.join();
+
+    EXPECT_TRUE(ran);
+#ifdef __linux__
+    EXPECT_EQ(name, "mp-test-thread-");
+    EXPECT_TRUE(pinned);
+#endif
+}
+
+TEST_F(ThreadPolicyTest, ApplyReportsWhatItGot) {
+    ThreadPolicy policy;
+    policy.For(ThreadRole::Background).priority = ThreadPriority::Low;
+    SetThreadPolicy(policy);
+
+    ThreadPolicyResult result;
+    auto thread = SpawnThread(ThreadRole::Background, "", [&] {
+        result = ApplyThreadPolicy(ThreadRole::Background, "mp-bg");
+    });
+    thread.join();
+    EXPECT_TRUE(result.affinity);
+    // Lowering priority needs no privilege
+    EXPECT_TRUE(result.priority);
+    EXPECT_TRUE(result.name);
+}
@@ -0,0 +1,158 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core/multiplayer/common/connection_recovery_manager.h"
+#include "core/multiplayer/common/error_handling.h"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace Core::Multiplayer;
+
+namespace {
+ErrorInfo MakeNetworkError(const std::string& component, const std::string& endpoint = {}) {
+    ErrorInfo error;
+    error.category = ErrorCategory::NetworkConnectivity;
+    error.error_code = ErrorCode::ConnectionTimeout;
+    error.message = "Connection timed out";
+    error.component = component;
+    if (!endpoint.empty()) {
+        error.context["endpoint"] = endpoint;
+    }
+    return error;
+}
+
+RecoveryConfig FastConfig(uint32_t delay_ms) {
+    RecoveryConfig config;
+    config.max_retries = 3;
+    config.initial_delay_ms = delay_ms;
+    config.backoff_multiplier = 1.0;
+    config.jitter_enabled = false;
+    return config;
+}
+
+template <typename Predicate>
+bool WaitFor(Predicate&& predicate, std::chrono::milliseconds timeout = std::chrono::seconds(5)) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+struct CallbackLog {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<bool> results;
+
+    std::function<void(bool)> Callback() {
+        return [this](bool success) {
+            std::lock_guard<std::mutex> lock(mutex);
+            results.push_back(success);
+            cv.notify_all();
+        };
+    }
+
+    bool WaitForCount(size_t count) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return cv.wait_for(lock, std::chrono::seconds(5), [&] { return results.size() >= count; });
+    }
+};
+} // namespace
+
+TEST(TimerScheduledRecoveryTest, RecoveryRunsItsAttemptsOnTimers) {
+    // Without a connection every attempt fails
+    ConnectionRecoveryManager manager(FastConfig(1), nullptr);
+    ASSERT_EQ(manager.StartRecovery(MakeNetworkError("p2p")), ErrorCode::Success);
+
+    ASSERT_TRUE(WaitFor([&] { return manager.GetState() == RecoveryState::Failed; }));
+    EXPECT_EQ(manager.GetRecoveryStatus().current_attempt, 4u);
+}
+
+TEST(TimerScheduledRecoveryTest, RepeatedStartsCoalesceIntoOneRecovery) {
+    ConnectionRecoveryManager manager(FastConfig(60000), nullptr);
+    ASSERT_EQ(manager.StartRecovery(MakeNetworkError("p2p")), ErrorCode::Success);
+    EXPECT_EQ(manager.StartRecovery(MakeNetworkError("p2p")), ErrorCode::Success);
+    EXPECT_EQ(manager.StartRecovery(MakeNetworkError("p2p")), ErrorCode::Success);
+
+    const auto status = manager.GetRecoveryStatus();
+    EXPECT_EQ(status.state, RecoveryState::InProgress);
+    EXPECT_EQ(status.current_attempt, 1u);
+    EXPECT_EQ(status.coalesced_requests, 2u);
+}
+
+TEST(TimerScheduledRecoveryTest, StopCancelsTheWaitingAttempt) {
+    ConnectionRecoveryManager manager(FastConfig(60000), nullptr);
+    ASSERT_EQ(manager.StartRecovery(MakeNetworkError("p2p")), ErrorCode::Success);
+
+    // Returns at once rather than after the 60 second backoff
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(manager.StopRecovery(), ErrorCode::Success);
+    manager.Shutdown();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+    EXPECT_EQ(manager.GetState(), RecoveryState::Aborted);
+    EXPECT_EQ(manager.StopRecovery(), ErrorCode::InvalidState);
+
+    // A new recovery starts afresh
+    ASSERT_EQ(manager.StartRecovery(MakeNetworkError("p2p")), ErrorCode::Success);
+    EXPECT_EQ(manager.GetRecoveryStatus().coalesced_requests, 0u);
+}
+
+TEST(TimerScheduledRecoveryTest, ManyRecoveriesDoNotNeedThreadsEach) {
+    constexpr size_t MANAGERS = 200;
+    std::vector<std::unique_ptr<ConnectionRecoveryManager>> managers;
+    for (size_t i = 0; i < MANAGERS; ++i) {
+        managers.push_back(std::make_unique<ConnectionRecoveryManager>(FastConfig(1), nullptr));
+        ASSERT_EQ(managers.back()->StartRecovery(MakeNetworkError("p2p")), ErrorCode::Success);
+    }
+    for (const auto& manager : managers) {
+        EXPECT_TRUE(WaitFor([&] { return manager->GetState() == RecoveryState::Failed; }));
+    }
+}
+
+TEST(TimerScheduledRecoveryTest, RetriesForOneEndpointShareATimer) {
+    NetworkRetryStrategy strategy(3, 20);
+    CallbackLog log;
+
+    strategy.AttemptRecovery(MakeNetworkError("room_client", "relay.example:443"), log.Callback());
+    strategy.AttemptRecovery(MakeNetworkError("p2p", "relay.example:443"), log.Callback());
+    strategy.AttemptRecovery(MakeNetworkError("p2p", "peer.example:7000"), log.Callback());
+    EXPECT_EQ(strategy.GetPendingRetryCount(), 2u);
+
+    ASSERT_TRUE(log.WaitForCount(3));
+    EXPECT_TRUE(WaitFor([&] { return strategy.GetPendingRetryCount() == 0; }));
+}
+
+TEST(TimerScheduledRecoveryTest, RetriesFallBackToTheComponentAsEndpoint) {
+    NetworkRetryStrategy strategy(3, 20);
+    CallbackLog log;
+
+    strategy.AttemptRecovery(MakeNetworkError("room_client"), log.Callback());
+    strategy.AttemptRecovery(MakeNetworkError("room_client"), log.Callback());
+    EXPECT_EQ(strategy.GetPendingRetryCount(), 1u);
+
+    // Both callers see the one retry's result
+    ASSERT_TRUE(log.WaitForCount(2));
+    std::lock_guard<std::mutex> lock(log.mutex);
+    EXPECT_EQ(log.results[0], log.results[1]);
+}
+
+TEST(TimerScheduledRecoveryTest, DestroyingTheStrategyCancelsWaitingRetries) {
+    std::atomic<int> calls{0};
+    const auto start = std::chrono::steady_clock::now();
+    {
+        NetworkRetryStrategy strategy(3, 60000);
+        strategy.AttemptRecovery(MakeNetworkError("room_client"), [&](bool) { ++calls; });
+        EXPECT_EQ(strategy.GetPendingRetryCount(), 1u);
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+    EXPECT_EQ(calls.load(), 0);
+}
@@ -0,0 +1,186 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core/multiplayer/common/timer_wheel.h"
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace Core::Multiplayer;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Polls until the predicate holds or the deadline passes
+template <typename Predicate>
+bool WaitFor(Predicate predicate, std::chrono::milliseconds timeout = 2000ms) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+} // namespace
+
+TEST(TimerWheelTest, OneShotTimerFiresOnce) {
+    TimerWheel wheel(1ms);
+    std::atomic<int> fired{0};
+
+    const auto id = wheel.Schedule(5ms, [&fired]() { ++fired; });
+    ASSERT_NE(id, TimerWheel::INVALID_TIMER_ID);
+    EXPECT_TRUE(wheel.IsScheduled(id));
+
+    ASSERT_TRUE(WaitFor([&fired]() { return fired.load() == 1; }));
+    std::this_thread::sleep_for(20ms);
+    EXPECT_EQ(fired.load(), 1);
+    EXPECT_FALSE(wheel.IsScheduled(id));
+    EXPECT_EQ(wheel.GetTimerCount(), 0u);
+}
+
+TEST(TimerWheelTest, CascadedTimerDoesNotFireEarly) {
+    TimerWheel wheel(1ms);
+    std::atomic<bool> fired{false};
+
+    // 150 ticks lands in the second level and has to cascade down
+    const auto start = std::chrono::steady_clock::now();
+    std::atomic<int64_t> elapsed_ms{0};
+    wheel.Schedule(150ms, [&]() {
+        elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+        fired = true;
+    });
+
+    ASSERT_TRUE(WaitFor([&fired]() { return fired.load(); }));
+    EXPECT_GE(elapsed_ms.load(), 150);
+}
+
+TEST(TimerWheelTest, TimersFireInDeadlineOrder) {
+    TimerWheel wheel(1ms);
+    std::mutex order_mutex;
+    std::vector<int> order;
+    auto record = [&](int value) {
+        return [&, value]() {
+            std::lock_guard<std::mutex> lock(order_mutex);
+            order.push_back(value);
+        };
+    };
+
+    wheel.Schedule(90ms, record(3));
+    wheel.Schedule(10ms, record(1));
+    wheel.Schedule(40ms, record(2));
+
+    ASSERT_TRUE(WaitFor([&]() {
+        std::lock_guard<std::mutex> lock(order_mutex);
+        return order.size() == 3;
+    }));
+    EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+}
+
+TEST(TimerWheelTest, CancelledTimerNeverFires) {
+    TimerWheel wheel(1ms);
+    std::atomic<bool> fired{false};
+
+    const auto id = wheel.Schedule(20ms, [&fired]() { fired = true; });
+    EXPECT_TRUE(wheel.Cancel(id));
+    EXPECT_FALSE(wheel.Cancel(id));
+
+    std::this_thread::sleep_for(50ms);
+    EXPECT_FALSE(fired.load());
+}
+
+TEST(TimerWheelTest, RepeatingTimerRunsUntilCancelled) {
+    TimerWheel wheel(1ms);
+    std::atomic<int> fired{0};
+
+    const auto id = wheel.ScheduleRepeating(5ms, [&fired]() { ++fired; });
+    ASSERT_TRUE(WaitFor([&fired]() { return fired.load() >= 3; }));
+    EXPECT_TRUE(wheel.Cancel(id));
+
+    const int after_cancel = fired.load();
+    std::this_thread::sleep_for(30ms);
+    EXPECT_EQ(fired.load(), after_cancel);
+}
+
+TEST(TimerWheelTest, CallbackMayCancelItself) {
+    TimerWheel wheel(1ms);
+    std::atomic<int> fired{0};
+    TimerWheel::TimerId id = TimerWheel::INVALID_TIMER_ID;
+    std::mutex id_mutex;
+
+    {
+        std::lock_guard<std::mutex> lock(id_mutex);
+        id = wheel.ScheduleRepeating(2ms, [&]() {
+            ++fired;
+            std::lock_guard<std::mutex> inner(id_mutex);
+            wheel.Cancel(id);
+        });
+    }
+
+    ASSERT_TRUE(WaitFor([&fired]() { return fired.load() == 1; }));
+    std::this_thread::sleep_for(20ms);
+    EXPECT_EQ(fired.load(), 1);
+}
+
+TEST(TimerWheelTest, CancelWaitsForRunningCallback) {
+    TimerWheel wheel(1ms);
+    std::atomic<bool> started{false};
+    std::atomic<bool> finished{false};
+
+    const auto id = wheel.Schedule(1ms, [&]() {
+        started = true;
+        std::this_thread::sleep_for(30ms);
+        finished = true;
+    });
+
+    ASSERT_TRUE(WaitFor([&started]() { return started.load(); }));
+    wheel.Cancel(id);
+    EXPECT_TRUE(finished.load());
+}
+
+TEST(TimerWheelTest, ShutdownIsImmediateAndRejectsNewTimers) {
+    TimerWheel wheel(10ms);
+    std::atomic<bool> fired{false};
+    wheel.Schedule(std::chrono::hours(1), [&fired]() { fired = true; });
+
+    const auto start = std::chrono::steady_clock::now();
+    wheel.Shutdown();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 500ms);
+
+    EXPECT_EQ(wheel.GetTimerCount(), 0u);
+    EXPECT_EQ(wheel.Schedule(1ms, []() {}), TimerWheel::INVALID_TIMER_ID);
+    EXPECT_FALSE(fired.load());
+}
+
+TEST(TimerWheelTest, ManualWheelFiresOnlyWhenDriven) {
+    const auto clock = std::make_shared<VirtualClock>();
+    TimerWheel wheel(clock, 10ms);
+    ASSERT_TRUE(wheel.IsManual());
+
+    std::vector<int> order;
+    wheel.Schedule(50ms, [&order]() { order.push_back(2); });
+    wheel.Schedule(20ms, [&order]() { order.push_back(1); });
+    const auto repeating = wheel.ScheduleRepeating(30ms, [&order]() { order.push_back(3); });
+    EXPECT_EQ(wheel.GetNextTickTime(), clock->Now() + 10ms);
+
+    std::this_thread::sleep_for(30ms);
+    EXPECT_EQ(wheel.RunDue(), 0u);
+
+    clock->Advance(60ms);
+    EXPECT_EQ(wheel.RunDue(), 4u);
+    EXPECT_EQ(order, (std::vector<int>{1, 3, 2, 3}));
+
+    // Cancelling from a callback on the driving thread does not wait on itself
+    wheel.Schedule(10ms, [&wheel, repeating]() { wheel.Cancel(repeating); });
+    clock->Advance(10ms);
+    wheel.RunDue();
+    clock->Advance(1h);
+    EXPECT_EQ(wheel.RunDue(), 0u);
+    EXPECT_FALSE(wheel.GetNextTickTime());
+}
@@ -0,0 +1,111 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "core/multiplayer/common/traffic_capture.h"
+
+using namespace Core::Multiplayer;
+
+namespace {
+
+class TrafficCaptureTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = (std::filesystem::temp_directory_path() /
+                 ("traffic_capture_test_" +
+                  std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()) +
+                  ".ldncap"))
+                    .string();
+        std::filesystem::remove(path_);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(path_);
+    }
+
+    std::string path_;
+    const std::vector<uint8_t> packet_a{1, 2, 3, 4};
+    const std::vector<uint8_t> packet_b{9, 8, 7, 6, 5, 4, 3, 2};
+};
+
+} // namespace
+
+TEST_F(TrafficCaptureTest, RecordsReadBackInOrder) {
+    TrafficCaptureWriter writer;
+    ASSERT_EQ(writer.Open(path_, 4096), ErrorCode::Success);
+    EXPECT_TRUE(writer.Record(TrafficDirection::Sent, 0xFF, packet_a.data(), packet_a.size(), 1000));
+    EXPECT_TRUE(writer.Record(TrafficDirection::Received, 2, packet_b.data(), packet_b.size(), 17000));
+    ASSERT_EQ(writer.Close(), ErrorCode::Success);
+    // Trimmed to what was recorded
+    EXPECT_EQ(std::filesystem::file_size(path_),
+              TrafficCaptureFormat::HEADER_SIZE + 2 * TrafficCaptureFormat::RECORD_HEADER_SIZE +
+                  packet_a.size() + packet_b.size());
+
+    TrafficCaptureReader reader;
+    ASSERT_EQ(reader.Open(path_), ErrorCode::Success);
+    EXPECT_TRUE(reader.HasPayloads());
+    const auto& records = reader.GetRecords();
+    ASSERT_EQ(records.size(), 2u);
+
+    EXPECT_EQ(records[0].timestamp_ns, 0u);
+    EXPECT_EQ(records[0].direction, TrafficDirection::Sent);
+    EXPECT_EQ(records[0].node_id, 0xFF);
+    EXPECT_EQ(std::vector<uint8_t>(records[0].payload.begin(), records[0].payload.end()), packet_a);
+
+    EXPECT_EQ(records[1].timestamp_ns, 16000u);
+    EXPECT_EQ(records[1].direction, TrafficDirection::Received);
+    EXPECT_EQ(records[1].node_id, 2);
+    EXPECT_EQ(records[1].size, packet_b.size());
+    EXPECT_EQ(std::vector<uint8_t>(records[1].payload.begin(), records[1].payload.end()), packet_b);
+    EXPECT_EQ(reader.GetDuration(), 16000u);
+}
+
+TEST_F(TrafficCaptureTest, ShapeOnlyCaptureKeepsSizesWithoutPayloads) {
+    TrafficCaptureWriter writer;
+    ASSERT_EQ(writer.Open(path_, 4096, false), ErrorCode::Success);
+    EXPECT_TRUE(writer.Record(TrafficDirection::Sent, 1, packet_b.data(), packet_b.size(), 5));
+    ASSERT_EQ(writer.Close(), ErrorCode::Success);
+
+    TrafficCaptureReader reader;
+    ASSERT_EQ(reader.Open(path_), ErrorCode::Success);
+    EXPECT_FALSE(reader.HasPayloads());
+    ASSERT_EQ(reader.GetRecords().size(), 1u);
+    EXPECT_EQ(reader.GetRecords()[0].size, packet_b.size());
+    EXPECT_TRUE(reader.GetRecords()[0].payload.empty());
+}
+
+TEST_F(TrafficCaptureTest, FullCaptureDropsInsteadOfGrowing) {
+    TrafficCaptureWriter writer;
+    const size_t capacity = TrafficCaptureFormat::HEADER_SIZE +
+                            TrafficCaptureFormat::RECORD_HEADER_SIZE + packet_a.size();
+    ASSERT_EQ(writer.Open(path_, capacity), ErrorCode::Success);
+    EXPECT_TRUE(writer.Record(TrafficDirection::Sent, 1, packet_a.data(), packet_a.size(), 0));
+    EXPECT_FALSE(writer.Record(TrafficDirection::Sent, 1, packet_a.data(), packet_a.size(), 1));
+    EXPECT_EQ(writer.GetRecordCount(), 1u);
+    EXPECT_EQ(writer.GetDroppedCount(), 1u);
+    ASSERT_EQ(writer.Close(), ErrorCode::Success);
+
+    TrafficCaptureReader reader;
+    ASSERT_EQ(reader.Open(path_), ErrorCode::Success);
+    EXPECT_EQ(reader.GetRecords().size(), 1u);
+}
+
+TEST_F(TrafficCaptureTest, RejectsUnfinishedAndForeignFiles) {
+    {
+        std::ofstream file(path_, std::ios::binary);
+        file << "definitely not a capture file, but long enough for a header";
+    }
+    TrafficCaptureReader reader;
+    EXPECT_EQ(reader.Open(path_), ErrorCode::InvalidMessage);
+
+    // Never closed, so the header was never written
+    TrafficCaptureWriter writer;
+    ASSERT_EQ(writer.Open(path_, 4096), ErrorCode::Success);
+    EXPECT_TRUE(writer.Record(TrafficDirection::Sent, 1, packet_a.data(), packet_a.size(), 0));
+    EXPECT_EQ(reader.Open(path_), ErrorCode::InvalidMessage);
+}
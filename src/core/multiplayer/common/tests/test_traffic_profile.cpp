@@ -0,0 +1,162 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "core/multiplayer/common/traffic_profile.h"
+
+using namespace Core::Multiplayer;
+
+namespace {
+
+constexpr uint64_t SMASH = 0x01006A800016E000;
+constexpr uint64_t ANIMAL_CROSSING = 0x01006F8002326000;
+constexpr uint64_t UNKNOWN_TITLE = 0x0100000000001000;
+constexpr uint64_t NS_PER_MS = 1'000'000;
+
+// count packets of size bytes, spread evenly at per_second
+void Feed(TrafficProfileLearner& learner, size_t count, size_t size, uint32_t per_second) {
+    const uint64_t interval = 1'000'000'000 / per_second;
+    for (size_t i = 0; i < count; ++i) {
+        learner.Observe(size, 1'000 * NS_PER_MS + i * interval);
+    }
+}
+
+class TrafficProfileTableTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = (std::filesystem::temp_directory_path() / "traffic_profile_test.json").string();
+        std::filesystem::remove(path_);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(path_);
+    }
+
+    std::string path_;
+};
+
+} // namespace
+
+TEST_F(TrafficProfileTableTest, BuiltInProfilesAndDefault) {
+    TrafficProfileTable table;
+    EXPECT_EQ(table.Lookup(SMASH), TrafficProfileTable::LowLatency());
+    EXPECT_EQ(table.Lookup(ANIMAL_CROSSING), TrafficProfileTable::Bulk());
+    EXPECT_FALSE(table.HasProfile(UNKNOWN_TITLE));
+    EXPECT_EQ(table.Lookup(UNKNOWN_TITLE), TrafficProfile{});
+}
+
+TEST_F(TrafficProfileTableTest, SetOverridesBuiltInUntilReset) {
+    TrafficProfileTable table;
+    TrafficProfile custom;
+    custom.coalescing_threshold = 300;
+    table.Set(SMASH, custom);
+    EXPECT_EQ(table.Lookup(SMASH), custom);
+
+    table.Reset(SMASH);
+    EXPECT_EQ(table.Lookup(SMASH), TrafficProfileTable::LowLatency());
+}
+
+TEST_F(TrafficProfileTableTest, SaveAndLoadRoundTrip) {
+    TrafficProfile custom;
+    custom.coalescing_threshold = 700;
+    custom.jitter_target = std::chrono::microseconds(6000);
+    custom.fec_group_size = 6;
+    custom.compression_threshold = 128;
+    custom.priority = SendPriority::Bulk;
+    custom.latest_value_key = {4, 2};
+    {
+        TrafficProfileTable table;
+        table.Set(UNKNOWN_TITLE, custom);
+        ASSERT_TRUE(table.Save(path_));
+    }
+
+    TrafficProfileTable loaded;
+    ASSERT_TRUE(loaded.Load(path_));
+    EXPECT_EQ(loaded.Lookup(UNKNOWN_TITLE), custom);
+    EXPECT_EQ(loaded.Lookup(SMASH), TrafficProfileTable::LowLatency());
+}
+
+TEST_F(TrafficProfileTableTest, MissingFileLoadsEmptyAndCorruptFileFails) {
+    TrafficProfileTable table;
+    EXPECT_TRUE(table.Load(path_));
+
+    std::ofstream(path_) << "{ not json";
+    EXPECT_FALSE(table.Load(path_));
+}
+
+TEST(TrafficProfileLearnerTest, NeedsEnoughPacketsBeforeDeriving) {
+    TrafficProfileLearner learner;
+    Feed(learner, TrafficProfileLearner::MIN_PACKETS - 1, 100, 60);
+    EXPECT_FALSE(learner.Derive({}).has_value());
+    Feed(learner, 1, 100, 60);
+    EXPECT_TRUE(learner.Derive({}).has_value());
+}
+
+TEST(TrafficProfileLearnerTest, HighRateSmallPacketsGetLowLatency) {
+    TrafficProfileLearner learner;
+    Feed(learner, 1200, 96, 60);
+
+    const TrafficShape shape = learner.GetShape();
+    EXPECT_GE(shape.packets_per_second, 55u);
+    EXPECT_LE(shape.packets_per_second, 60u);
+    EXPECT_LT(shape.median_size, 256u);
+
+    const auto profile = learner.Derive(TrafficProfileTable::Action());
+    ASSERT_TRUE(profile.has_value());
+    EXPECT_EQ(profile->coalescing_threshold, 0u);
+    EXPECT_EQ(profile->jitter_target, std::chrono::microseconds(2000));
+    EXPECT_EQ(profile->compression_threshold, 0u);
+    EXPECT_EQ(profile->priority, SendPriority::Realtime);
+}
+
+TEST(TrafficProfileLearnerTest, SlowLargePacketsGetBulk) {
+    TrafficProfileLearner learner;
+    Feed(learner, 800, 900, 5);
+
+    const auto profile = learner.Derive({});
+    ASSERT_TRUE(profile.has_value());
+    EXPECT_EQ(profile->coalescing_threshold, 1200u);
+    EXPECT_EQ(profile->jitter_target, std::chrono::microseconds(10000));
+    EXPECT_EQ(profile->compression_threshold, 256u);
+    EXPECT_EQ(profile->priority, SendPriority::Bulk);
+}
+
+TEST(TrafficProfileLearnerTest, DeriveKeepsFecFromBase) {
+    TrafficProfileLearner learner;
+    Feed(learner, 800, 900, 5);
+    const auto profile = learner.Derive(TrafficProfileTable::LowLatency());
+    ASSERT_TRUE(profile.has_value());
+    EXPECT_EQ(profile->fec_group_size, TrafficProfileTable::LowLatency().fec_group_size);
+}
+
+TEST(TrafficProfileLearnerTest, ResetForgetsObservations) {
+    TrafficProfileLearner learner;
+    Feed(learner, 1000, 100, 30);
+    learner.Reset();
+    EXPECT_EQ(learner.GetShape().packets, 0u);
+    EXPECT_FALSE(learner.Derive({}).has_value());
+}
+
+TEST(AdaptToBandwidthTest, RetunesWithoutTogglingFeatures) {
+    TrafficProfile profile;
+    profile.compression_threshold = 256;
+    profile.fec_group_size = 4;
+
+    EXPECT_EQ(AdaptToBandwidth(profile, 0), profile);
+    EXPECT_EQ(AdaptToBandwidth(profile, LOW_BANDWIDTH + 1), profile);
+
+    const auto slow = AdaptToBandwidth(profile, LOW_BANDWIDTH / 2);
+    EXPECT_EQ(slow.compression_threshold, 64u);
+    EXPECT_EQ(slow.fec_group_size, 8);
+
+    const auto fast = AdaptToBandwidth(profile, HIGH_BANDWIDTH * 2);
+    EXPECT_EQ(fast.compression_threshold, 1024u);
+    EXPECT_EQ(fast.fec_group_size, 2);
+
+    // What is off stays off
+    EXPECT_EQ(AdaptToBandwidth(TrafficProfile{}, LOW_BANDWIDTH / 2), TrafficProfile{});
+}
@@ -4,6 +4,9 @@
 #include "core/multiplayer/common/network_security.h"
 #include <gtest/gtest.h>
 
+#include <string_view>
+#include <vector>
+
 using namespace Core::Multiplayer::Security;
 
 TEST(NetworkInputValidatorUtf8Test, RejectsOverlongEncoding) {
@@ -30,3 +33,49 @@ TEST(NetworkInputValidatorUtf8Test, AcceptsValidUtf8) {
     EXPECT_TRUE(result.is_valid);
 }
 
+
+TEST(NetworkInputValidatorUtf8Test, ValidatesStringViewsWithoutCopying) {
+    const std::string buffer = "xx{\"name\":\"caf\xC3\xA9\"}\xFFyy";
+    EXPECT_TRUE(NetworkInputValidator::IsValidUtf8(std::string_view(buffer).substr(2, 16)));
+    EXPECT_FALSE(NetworkInputValidator::IsValidUtf8(buffer));
+    EXPECT_TRUE(NetworkInputValidator::IsValidUtf8(std::string_view{}));
+}
+
+TEST(NetworkInputValidatorUtf8Test, FindsErrorsAtEveryOffsetOfALongAsciiRun) {
+    // Errors at each position, past and around the 8, 16, 32 and 64 byte blocks
+    // that are skipped at once
+    const std::vector<std::string> bad = {"\xFF", "\xC0\xAF", "\xED\xA0\x80", "\xEF\xBF\xBE",
+                                          "\xF4\x90\x80\x80", "\xE2\x82"};
+    const std::vector<std::string> good = {"\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x98\x81"};
+    for (size_t offset = 0; offset < 70; ++offset) {
+        for (const auto& sequence : bad) {
+            std::string str(offset, 'a');
+            str += sequence;
+            EXPECT_FALSE(NetworkInputValidator::IsValidUtf8(str)) << offset;
+            str.append(40, 'b');
+            EXPECT_FALSE(NetworkInputValidator::IsValidUtf8(str)) << offset;
+        }
+        for (const auto& sequence : good) {
+            std::string str(offset, 'a');
+            str += sequence;
+            str.append(offset % 23, 'b');
+            str += sequence;
+            EXPECT_TRUE(NetworkInputValidator::IsValidUtf8(str)) << offset;
+        }
+    }
+}
+
+// Components/NetworkInputValidator/Utf8 in the component benchmarks times
+// a message like this one
+TEST(NetworkInputValidatorUtf8Test, AcceptsAChatMessageEndingInMultibyteText) {
+    std::string message = "{\"type\":\"chat\",\"room\":\"Lobby 3\",\"from\":\"player_42\",\"text\":\"";
+    for (int i = 0; i < 16; ++i) {
+        message += "anyone up for a match on the new map? ";
+    }
+    message += "caf\xC3\xA9 \xF0\x9F\x98\x81\"}";
+
+    EXPECT_TRUE(NetworkInputValidator::IsValidUtf8(message));
+    // Cut inside the emoji
+    const std::string_view cut = std::string_view(message).substr(0, message.size() - 3);
+    EXPECT_FALSE(NetworkInputValidator::IsValidUtf8(cut));
+}
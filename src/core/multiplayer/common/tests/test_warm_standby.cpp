@@ -0,0 +1,170 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "core/multiplayer/common/graceful_degradation_manager.h"
+#include "mocks/mock_multiplayer_backend.h"
+
+using namespace Core::Multiplayer;
+using namespace std::chrono_literals;
+
+namespace {
+TrafficSample Sample(uint64_t received, uint64_t missing) {
+    TrafficSample sample;
+    sample.rtt = 20ms;
+    sample.packets_received = received;
+    sample.packets_missing = missing;
+    return sample;
+}
+
+class WarmStandbyTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        manager.SetInternetBackend(&internet_backend);
+        manager.SetAdhocBackend(&adhoc_backend);
+        manager.SetStandbyHandlers({
+            [this](MultiplayerMode mode) {
+                prepared_mode = mode;
+                prepared++;
+                return ErrorCode::Success;
+            },
+            [this](MultiplayerMode) { released++; },
+        });
+    }
+
+    // Initialization simulates backend availability; retry until the
+    // primary comes up
+    void StartOnInternet() {
+        for (int i = 0; i < 20 && manager.GetCurrentMode() != MultiplayerMode::Internet; ++i) {
+            manager.Initialize(MultiplayerMode::Internet);
+        }
+        ASSERT_EQ(manager.GetCurrentMode(), MultiplayerMode::Internet);
+        Report(100, 0, 4);
+        ASSERT_EQ(manager.GetHealthMetrics(MultiplayerMode::Internet).status,
+                  BackendHealthStatus::Healthy);
+    }
+
+    void Report(uint64_t received, uint64_t missing, int count) {
+        for (int i = 0; i < count; ++i) {
+            manager.ReportTrafficSample(MultiplayerMode::Internet, Sample(received, missing));
+        }
+    }
+
+    // About 10% loss: past the degraded threshold, short of unhealthy
+    void TrendTowardDegraded() {
+        Report(90, 10, 8);
+        ASSERT_EQ(manager.GetHealthMetrics(MultiplayerMode::Internet).status,
+                  BackendHealthStatus::Degraded);
+    }
+
+    bool WaitForStandbyReady() {
+        for (int i = 0; i < 200; ++i) {
+            if (manager.GetDegradationStatus().standby_ready) {
+                return true;
+            }
+            std::this_thread::sleep_for(5ms);
+        }
+        return false;
+    }
+
+    DegradationConfig config;
+    GracefulDegradationManager manager{config};
+    ::testing::NiceMock<MockMultiplayerBackend> internet_backend;
+    ::testing::NiceMock<MockMultiplayerBackend> adhoc_backend;
+    std::atomic<int> prepared{0};
+    std::atomic<int> released{0};
+    std::atomic<MultiplayerMode> prepared_mode{MultiplayerMode::Offline};
+};
+} // namespace
+
+TEST_F(WarmStandbyTest, PreparesFallbackWhileThePrimaryDegrades) {
+    StartOnInternet();
+    TrendTowardDegraded();
+
+    auto status = manager.GetDegradationStatus();
+    EXPECT_EQ(status.state, DegradationState::WarmStandby);
+    ASSERT_TRUE(status.standby_mode.has_value());
+    EXPECT_EQ(*status.standby_mode, MultiplayerMode::Adhoc);
+
+    ASSERT_TRUE(WaitForStandbyReady());
+    EXPECT_EQ(prepared.load(), 1);
+    EXPECT_EQ(prepared_mode.load(), MultiplayerMode::Adhoc);
+    EXPECT_EQ(manager.GetCurrentMode(), MultiplayerMode::Internet);
+}
+
+TEST_F(WarmStandbyTest, UnhealthyPrimaryCutsOverToTheReadyStandby) {
+    StartOnInternet();
+    TrendTowardDegraded();
+    ASSERT_TRUE(WaitForStandbyReady());
+
+    Report(50, 50, 10);
+    EXPECT_EQ(manager.GetCurrentMode(), MultiplayerMode::Adhoc);
+    EXPECT_EQ(manager.GetState(), DegradationState::Degraded);
+
+    const auto status = manager.GetDegradationStatus();
+    EXPECT_FALSE(status.standby_mode.has_value());
+    EXPECT_FALSE(status.standby_ready);
+    manager.Shutdown();
+    // The standby became the active backend rather than being torn down
+    EXPECT_EQ(released.load(), 0);
+    EXPECT_EQ(prepared.load(), 1);
+}
+
+TEST_F(WarmStandbyTest, RecoveringPrimaryReleasesTheStandby) {
+    StartOnInternet();
+    TrendTowardDegraded();
+    ASSERT_TRUE(WaitForStandbyReady());
+
+    Report(100, 0, 20);
+    ASSERT_EQ(manager.GetHealthMetrics(MultiplayerMode::Internet).status,
+              BackendHealthStatus::Healthy);
+    const auto status = manager.GetDegradationStatus();
+    EXPECT_EQ(status.state, DegradationState::Normal);
+    EXPECT_FALSE(status.standby_mode.has_value());
+
+    manager.Shutdown();
+    EXPECT_EQ(released.load(), 1);
+    EXPECT_EQ(manager.GetCurrentMode(), MultiplayerMode::Internet);
+}
+
+TEST_F(WarmStandbyTest, ResourceCapsBlockStandby) {
+    StartOnInternet();
+
+    StandbyResources resources;
+    resources.free_memory_mb = 64;
+    manager.SetStandbyResourceProvider([&resources] { return resources; });
+    TrendTowardDegraded();
+    EXPECT_FALSE(manager.GetDegradationStatus().standby_mode.has_value());
+    EXPECT_EQ(manager.GetState(), DegradationState::Normal);
+
+    // Plenty of memory, but a nearly flat battery
+    Report(100, 0, 20);
+    resources.free_memory_mb = 4096;
+    resources.on_battery = true;
+    resources.battery_percent = 10;
+    TrendTowardDegraded();
+    EXPECT_FALSE(manager.GetDegradationStatus().standby_mode.has_value());
+
+    Report(100, 0, 20);
+    resources.battery_percent = 80;
+    TrendTowardDegraded();
+    EXPECT_TRUE(manager.GetDegradationStatus().standby_mode.has_value());
+    manager.Shutdown();
+    EXPECT_EQ(prepared.load(), 1);
+}
+
+TEST_F(WarmStandbyTest, DisabledStandbyNeverPrepares) {
+    DegradationConfig disabled;
+    disabled.enable_warm_standby = false;
+    manager.UpdateConfig(disabled);
+    StartOnInternet();
+    TrendTowardDegraded();
+    EXPECT_FALSE(manager.GetDegradationStatus().standby_mode.has_value());
+    manager.Shutdown();
+    EXPECT_EQ(prepared.load(), 0);
+}
@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "core/multiplayer/common/wire_format.h"
+
+using namespace Core::Multiplayer;
+
+namespace {
+
+enum class Kind : uint16_t { First = 1, Second = 0x0102 };
+
+struct Sample {
+    uint32_t token = 0;
+    Kind kind = Kind::First;
+    uint8_t flags = 0;
+    int8_t delta = 0;
+    uint64_t timestamp = 0;
+};
+
+// Wire order differs from declaration order
+using SampleLayout = Wire::Layout<16, Wire::Field<&Sample::kind, 0>, Wire::Field<&Sample::token, 2>,
+                                  Wire::Field<&Sample::flags, 6>, Wire::Field<&Sample::delta, 7>,
+                                  Wire::Field<&Sample::timestamp, 8>>;
+
+constexpr std::array<uint8_t, 16> Encoded(const Sample& sample) {
+    std::array<uint8_t, 16> out{};
+    SampleLayout::Encode(sample, out);
+    return out;
+}
+
+constexpr Sample RoundTrip(const Sample& sample) {
+    const auto bytes = Encoded(sample);
+    Sample decoded;
+    SampleLayout::Decode(bytes, decoded);
+    return decoded;
+}
+
+constexpr Sample MakeSample() {
+    Sample sample;
+    sample.token = 0x11223344;
+    sample.kind = Kind::Second;
+    sample.flags = 0x80;
+    sample.delta = -2;
+    sample.timestamp = 0x0102030405060708;
+    return sample;
+}
+
+} // namespace
+
+static_assert(Wire::ByteSwap<uint32_t>(0x11223344) == 0x44332211);
+static_assert(Wire::ByteSwap<uint16_t>(0x0102) == 0x0201);
+static_assert(Encoded(MakeSample())[0] == 0x02 && Encoded(MakeSample())[2] == 0x44);
+static_assert(RoundTrip(MakeSample()).timestamp == 0x0102030405060708);
+static_assert(RoundTrip(MakeSample()).delta == -2);
+
+TEST(WireFormatTest, EncodesLittleEndianAtTheLayoutOffsets) {
+    const auto bytes = Encoded(MakeSample());
+    const std::array<uint8_t, 16> expected{0x02, 0x01, 0x44, 0x33, 0x22, 0x11, 0x80, 0xFE,
+                                           0x08, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01};
+    EXPECT_EQ(bytes, expected);
+}
+
+TEST(WireFormatTest, RuntimeAndCompileTimeCodecsAgree) {
+    const Sample sample = MakeSample();
+    std::vector<uint8_t> buffer(20, 0xAA);
+    ASSERT_TRUE(SampleLayout::TryEncode(sample, buffer));
+    constexpr auto expected = Encoded(MakeSample());
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), buffer.begin()));
+    EXPECT_EQ(buffer[16], 0xAA);
+
+    Sample decoded;
+    ASSERT_TRUE(SampleLayout::TryDecode(buffer, decoded));
+    EXPECT_EQ(decoded.token, sample.token);
+    EXPECT_EQ(decoded.kind, sample.kind);
+    EXPECT_EQ(decoded.flags, sample.flags);
+    EXPECT_EQ(decoded.delta, sample.delta);
+    EXPECT_EQ(decoded.timestamp, sample.timestamp);
+}
+
+TEST(WireFormatTest, ShortBuffersAreRejected) {
+    std::vector<uint8_t> buffer(15);
+    Sample sample;
+    EXPECT_FALSE(SampleLayout::TryEncode(sample, buffer));
+    EXPECT_FALSE(SampleLayout::TryDecode(buffer, sample));
+}
@@ -0,0 +1,145 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "core/multiplayer/common/work_stealing_executor.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+
+using namespace Core::Multiplayer;
+using namespace std::chrono_literals;
+
+TEST(SmallTaskTest, SmallCallableIsStoredInline) {
+    int calls = 0;
+    SmallTask task([&calls]() { ++calls; });
+
+    ASSERT_TRUE(task);
+    EXPECT_TRUE(task.IsInline());
+    task();
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(SmallTaskTest, LargeCallableFallsBackToHeap) {
+    std::array<uint64_t, 16> payload{};
+    payload[15] = 7;
+    uint64_t result = 0;
+    SmallTask task([payload, &result]() { result = payload[15]; });
+
+    EXPECT_FALSE(task.IsInline());
+    task();
+    EXPECT_EQ(result, 7u);
+}
+
+TEST(SmallTaskTest, MoveTransfersOwnership) {
+    auto counter = std::make_shared<int>(0);
+    SmallTask original([counter]() { ++*counter; });
+    SmallTask moved(std::move(original));
+
+    EXPECT_FALSE(original);
+    moved();
+    EXPECT_EQ(*counter, 1);
+
+    moved = SmallTask();
+    EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(WorkStealingExecutorTest, SubmitReturnsResult) {
+    WorkStealingExecutor executor(2);
+    auto future = executor.Submit([]() { return 42; });
+    EXPECT_EQ(future.get(), 42);
+}
+
+TEST(WorkStealingExecutorTest, RunsEveryPostedTask) {
+    constexpr int TASK_COUNT = 10000;
+    std::atomic<int> completed{0};
+    {
+        WorkStealingExecutor executor(4);
+        for (int i = 0; i < TASK_COUNT; ++i) {
+            ASSERT_TRUE(executor.Post([&completed]() { ++completed; }));
+        }
+    }
+    EXPECT_EQ(completed.load(), TASK_COUNT);
+}
+
+TEST(WorkStealingExecutorTest, NestedTasksAreSpreadAcrossWorkers) {
+    constexpr int FAN_OUT = 64;
+    WorkStealingExecutor executor(4);
+    std::atomic<int> leaves{0};
+
+    auto root = executor.Submit([&executor, &leaves]() {
+        // Spawned from a worker, so they land on its local deque
+        for (int i = 0; i < FAN_OUT; ++i) {
+            executor.Post([&leaves]() {
+                std::this_thread::sleep_for(100us);
+                ++leaves;
+            });
+        }
+    });
+    root.get();
+
+    const auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (leaves.load() < FAN_OUT && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(1ms);
+    }
+    EXPECT_EQ(leaves.load(), FAN_OUT);
+
+    const auto stats = executor.GetStatistics();
+    EXPECT_EQ(stats.worker_count, 4u);
+    EXPECT_EQ(stats.worker_queue_depths.size(), 4u);
+    EXPECT_GE(stats.executed_tasks, static_cast<uint64_t>(FAN_OUT + 1));
+}
+
+TEST(WorkStealingExecutorTest, TryRunPendingTaskHelpsFromOutside) {
+    WorkStealingExecutor executor(1);
+    std::atomic<bool> release{false};
+    std::atomic<bool> ran{false};
+
+    // Occupy the only worker so the next task stays queued
+    executor.Post([&release]() {
+        while (!release.load()) {
+            std::this_thread::yield();
+        }
+    });
+    std::this_thread::sleep_for(10ms);
+    executor.Post([&ran]() { ran = true; });
+
+    EXPECT_TRUE(executor.TryRunPendingTask());
+    EXPECT_TRUE(ran.load());
+    release = true;
+}
+
+TEST(ExecutorTaskGroupTest, WaitBlocksUntilGroupTasksFinish) {
+    auto executor = std::make_shared<WorkStealingExecutor>(2);
+    std::atomic<int> completed{0};
+
+    ExecutorTaskGroup group(executor);
+    for (int i = 0; i < 32; ++i) {
+        group.Submit([&completed]() {
+            std::this_thread::sleep_for(1ms);
+            ++completed;
+        });
+    }
+    group.Wait();
+
+    EXPECT_EQ(completed.load(), 32);
+    EXPECT_EQ(group.GetOutstandingCount(), 0u);
+}
+
+TEST(ExecutorTaskGroupTest, DestructorWaitsForOutstandingTasks) {
+    auto executor = std::make_shared<WorkStealingExecutor>(2);
+    auto state = std::make_unique<std::atomic<int>>(0);
+    {
+        ExecutorTaskGroup group(executor);
+        for (int i = 0; i < 8; ++i) {
+            group.Submit([raw = state.get()]() {
+                std::this_thread::sleep_for(2ms);
+                ++*raw;
+            });
+        }
+    }
+    // Group is gone, so every task must have finished touching state
+    EXPECT_EQ(state->load(), 8);
+}
@@ -0,0 +1,247 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "thread_policy.h"
+
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <optional>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <pthread.h>
+#include <pthread/qos.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Core::Multiplayer {
+
+namespace {
+
+#if !defined(_WIN32) && !defined(__APPLE__)
+constexpr int ELEVATED_NICE = -5;
+constexpr int LOW_NICE = 10;
+// pthread_setname_np refuses longer names
+constexpr size_t MAX_THREAD_NAME = 15;
+#endif
+
+std::mutex policy_mutex;
+std::optional<ThreadPolicy> current_policy;
+
+std::vector<uint32_t> Range(size_t first, size_t last) {
+    std::vector<uint32_t> cpus;
+    for (size_t cpu = first; cpu < last; ++cpu) {
+        cpus.push_back(static_cast<uint32_t>(cpu));
+    }
+    return cpus;
+}
+
+std::optional<uint32_t> ReadNumber(const std::string& path) {
+    std::ifstream file(path);
+    uint32_t value = 0;
+    if (!(file >> value)) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+bool ApplyAffinity(const std::vector<uint32_t>& cpus) {
+    if (cpus.empty()) {
+        return true;
+    }
+#ifdef _WIN32
+    DWORD_PTR mask = 0;
+    for (const uint32_t cpu : cpus) {
+        if (cpu < sizeof(mask) * 8) {
+            mask |= DWORD_PTR{1} << cpu;
+        }
+    }
+    return mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#elif defined(__APPLE__)
+    // macOS only takes affinity hints between threads, not cores
+    return false;
+#else
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (const uint32_t cpu : cpus) {
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    return CPU_COUNT(&set) != 0 && pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#endif
+}
+
+bool ApplyPriority(ThreadPriority priority) {
+    if (priority == ThreadPriority::Normal) {
+        return true;
+    }
+#ifdef _WIN32
+    int level = THREAD_PRIORITY_BELOW_NORMAL;
+    if (priority == ThreadPriority::Realtime) {
+        level = THREAD_PRIORITY_TIME_CRITICAL;
+    } else if (priority == ThreadPriority::Elevated) {
+        level = THREAD_PRIORITY_ABOVE_NORMAL;
+    }
+    return SetThreadPriority(GetCurrentThread(), level) != 0;
+#elif defined(__APPLE__)
+    const qos_class_t qos =
+        priority == ThreadPriority::Low ? QOS_CLASS_UTILITY : QOS_CLASS_USER_INTERACTIVE;
+    return pthread_set_qos_class_self_np(qos, 0) == 0;
+#else
+    if (priority == ThreadPriority::Realtime) {
+        sched_param param{};
+        param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+        if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0) {
+            return true;
+        }
+        // Usually refused without CAP_SYS_NICE or an RLIMIT_RTPRIO grant
+    }
+    // Linux applies a nice value to the thread id alone
+    const int nice = priority == ThreadPriority::Low ? LOW_NICE : ELEVATED_NICE;
+    const auto tid = static_cast<id_t>(syscall(SYS_gettid));
+    return setpriority(PRIO_PROCESS, tid, nice) == 0;
+#endif
+}
+
+bool ApplyName(std::string_view name) {
+    if (name.empty()) {
+        return false;
+    }
+#ifdef _WIN32
+    // Names are ASCII, so widening each character is enough
+    const std::wstring wide(name.begin(), name.end());
+    return SUCCEEDED(SetThreadDescription(GetCurrentThread(), wide.c_str()));
+#elif defined(__APPLE__)
+    return pthread_setname_np(std::string(name).c_str()) == 0;
+#else
+    const std::string truncated(name.substr(0, MAX_THREAD_NAME));
+    return pthread_setname_np(pthread_self(), truncated.c_str()) == 0;
+#endif
+}
+
+} // namespace
+
+ThreadPolicy ThreadPolicy::ForProfile(ThreadProfile profile,
+                                      const std::vector<uint32_t>& core_capacities) {
+    ThreadPolicy policy;
+    policy.For(ThreadRole::NetworkIo).priority = ThreadPriority::Elevated;
+    policy.For(ThreadRole::Timer).priority = ThreadPriority::Elevated;
+    policy.For(ThreadRole::Worker).priority = ThreadPriority::Normal;
+    policy.For(ThreadRole::Background).priority = ThreadPriority::Low;
+
+    switch (profile) {
+    case ThreadProfile::Desktop:
+        break;
+    case ThreadProfile::AndroidBigLittle: {
+        // Everything goes to the little cores; the emulator needs every big
+        // one, and a receive loop mostly sleeps
+        const uint32_t fastest =
+            core_capacities.empty()
+                ? 0
+                : *std::max_element(core_capacities.begin(), core_capacities.end());
+        std::vector<uint32_t> little;
+        for (size_t cpu = 0; cpu < core_capacities.size(); ++cpu) {
+            if (core_capacities[cpu] < fastest) {
+                little.push_back(static_cast<uint32_t>(cpu));
+            }
+        }
+        for (auto& role : policy.roles) {
+            role.cpus = little;
+        }
+        break;
+    }
+    case ThreadProfile::SteamDeck: {
+        // Four cores with two threads each; the emulator's CPU and GPU
+        // threads fill the first ones, so networking takes the last core
+        // and workers may spill onto the one before it
+        const size_t count = core_capacities.size();
+        if (count < 4) {
+            break;
+        }
+        policy.For(ThreadRole::NetworkIo).priority = ThreadPriority::Realtime;
+        policy.For(ThreadRole::NetworkIo).cpus = Range(count - 2, count);
+        policy.For(ThreadRole::Timer).cpus = Range(count - 2, count);
+        policy.For(ThreadRole::Worker).cpus = Range(count / 2, count);
+        policy.For(ThreadRole::Background).cpus = Range(count - 2, count);
+        break;
+    }
+    }
+    return policy;
+}
+
+ThreadPolicy ThreadPolicy::ForProfile(ThreadProfile profile) {
+    auto capacities = ReadCoreCapacities();
+    if (capacities.empty()) {
+        capacities.assign(std::max(1u, std::thread::hardware_concurrency()), 1);
+    }
+    return ForProfile(profile, capacities);
+}
+
+ThreadProfile DetectThreadProfile() {
+#if defined(__ANDROID__)
+    return ThreadProfile::AndroidBigLittle;
+#elif defined(__linux__)
+    std::ifstream vendor("/sys/devices/virtual/dmi/id/board_vendor");
+    std::string name;
+    if (std::getline(vendor, name) && name == "Valve") {
+        return ThreadProfile::SteamDeck;
+    }
+    return ThreadProfile::Desktop;
+#else
+    return ThreadProfile::Desktop;
+#endif
+}
+
+std::vector<uint32_t> ReadCoreCapacities() {
+    std::vector<uint32_t> capacities;
+#ifdef __linux__
+    const unsigned count = std::thread::hardware_concurrency();
+    for (unsigned cpu = 0; cpu < count; ++cpu) {
+        const std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+        // The scheduler's own capacity figure where the kernel exports it,
+        // otherwise the top clock, which tells big from little just as well
+        auto capacity = ReadNumber(base + "/cpu_capacity");
+        if (!capacity) {
+            capacity = ReadNumber(base + "/cpufreq/cpuinfo_max_freq");
+        }
+        if (!capacity) {
+            return {};
+        }
+        capacities.push_back(*capacity);
+    }
+#endif
+    return capacities;
+}
+
+void SetThreadPolicy(ThreadPolicy policy) {
+    std::lock_guard lock(policy_mutex);
+    current_policy = std::move(policy);
+}
+
+ThreadPolicy GetThreadPolicy() {
+    std::lock_guard lock(policy_mutex);
+    if (!current_policy) {
+        current_policy = ThreadPolicy::ForProfile(DetectThreadProfile());
+    }
+    return *current_policy;
+}
+
+ThreadPolicyResult ApplyThreadPolicy(ThreadRole role, std::string_view name) {
+    const ThreadPolicy policy = GetThreadPolicy();
+    const ThreadRolePolicy& role_policy = policy.For(role);
+    ThreadPolicyResult result;
+    result.affinity = ApplyAffinity(role_policy.cpus);
+    result.priority = ApplyPriority(role_policy.priority);
+    result.name = ApplyName(name);
+    return result;
+}
+
+} // namespace Core::Multiplayer
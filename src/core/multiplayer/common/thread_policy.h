@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Core::Multiplayer {
+
+/**
+ * What a multiplayer thread does, which decides where it runs and how
+ * urgently
+ */
+enum class ThreadRole : uint8_t {
+    NetworkIo,  // Socket receive loops; latency goes straight into game input
+    Timer,      // The timer wheel; short callbacks that must fire on time
+    Worker,     // Executor and pipeline workers; compression, crypto, parsing
+    Background, // Anything that may wait
+};
+
+constexpr size_t THREAD_ROLE_COUNT = 4;
+
+enum class ThreadPriority : uint8_t {
+    Low,
+    Normal,
+    Elevated, // Above normal; a negative nice on Linux, which may need CAP_SYS_NICE
+    Realtime, // SCHED_FIFO where permitted, otherwise Elevated
+};
+
+/**
+ * Platforms with a tuned policy
+ */
+enum class ThreadProfile : uint8_t {
+    Desktop,          // Any core; the OS balances us against the emulator
+    AndroidBigLittle, // Little cores, leaving the big ones to the emulator
+    SteamDeck,        // The last of the four Zen 2 cores and its SMT sibling
+};
+
+struct ThreadRolePolicy {
+    std::vector<uint32_t> cpus; // Logical CPUs to run on; empty for any
+    ThreadPriority priority = ThreadPriority::Normal;
+};
+
+struct ThreadPolicy {
+    std::array<ThreadRolePolicy, THREAD_ROLE_COUNT> roles{};
+
+    const ThreadRolePolicy& For(ThreadRole role) const {
+        return roles[static_cast<size_t>(role)];
+    }
+    ThreadRolePolicy& For(ThreadRole role) {
+        return roles[static_cast<size_t>(role)];
+    }
+
+    /**
+     * The tuned policy for a platform
+     * @param core_capacities Relative speed of each logical CPU, as from
+     *        ReadCoreCapacities; the slower ones are the little cores.
+     *        Empty or uniform means no core is preferred over another.
+     */
+    static ThreadPolicy ForProfile(ThreadProfile profile,
+                                   const std::vector<uint32_t>& core_capacities);
+    static ThreadPolicy ForProfile(ThreadProfile profile);
+};
+
+// Which profile the running platform matches
+ThreadProfile DetectThreadProfile();
+
+// Relative speed of each logical CPU from sysfs; empty where unavailable
+std::vector<uint32_t> ReadCoreCapacities();
+
+/**
+ * Replace the process-wide policy. Only threads started afterwards follow
+ * it, so set it before the multiplayer components start. Until then the
+ * policy is the one for the detected profile.
+ */
+void SetThreadPolicy(ThreadPolicy policy);
+ThreadPolicy GetThreadPolicy();
+
+// What a best-effort ApplyThreadPolicy actually got
+struct ThreadPolicyResult {
+    bool affinity = false;
+    bool priority = false;
+    bool name = false;
+};
+
+/**
+ * Apply the current policy for a role, and an OS-visible name for
+ * profilers, to the calling thread. Linux keeps the first 15 characters of
+ * the name.
+ */
+ThreadPolicyResult ApplyThreadPolicy(ThreadRole role, std::string_view name);
+
+/**
+ * Start a thread that applies the policy for its role and takes its name
+ * before running f. Every multiplayer thread should start here.
+ */
+template <typename F>
+std::thread SpawnThread(ThreadRole role, std::string name, F&& f) {
+    return std::thread([role, name = std::move(name), f = std::forward<F>(f)]() mutable {
+        ApplyThreadPolicy(role, name);
+        f();
+    });
+}
+
+} // namespace Core::Multiplayer
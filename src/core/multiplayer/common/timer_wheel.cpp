@@ -0,0 +1,279 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "timer_wheel.h"
+#include "thread_policy.h"
+
+#include <algorithm>
+
+namespace Core::Multiplayer {
+
+TimerWheel::TimerWheel(std::chrono::milliseconds tick_interval)
+    : TimerWheel(ClockSource::GetSteady(), tick_interval) {}
+
+TimerWheel::TimerWheel(std::shared_ptr<const ClockSource> clock,
+                       std::chrono::milliseconds tick_interval)
+    : tick_interval_(std::max(tick_interval, std::chrono::milliseconds(1))),
+      clock_(clock ? std::move(clock) : ClockSource::GetSteady()), start_time_(clock_->Now()) {
+    if (!IsManual()) {
+        worker_thread_ = SpawnThread(ThreadRole::Timer, "mp-timer", [this]() { WorkerLoop(); });
+    }
+}
+
+TimerWheel::~TimerWheel() {
+    Shutdown();
+}
+
+std::shared_ptr<TimerWheel> TimerWheel::GetShared() {
+    static std::shared_ptr<TimerWheel> shared = std::make_shared<TimerWheel>();
+    return shared;
+}
+
+TimerWheel::TimerId TimerWheel::Schedule(std::chrono::milliseconds delay, Callback callback) {
+    return AddTimer(delay, 0, std::move(callback));
+}
+
+TimerWheel::TimerId TimerWheel::ScheduleRepeating(std::chrono::milliseconds interval,
+                                                  Callback callback) {
+    return AddTimer(interval, ToTicks(interval), std::move(callback));
+}
+
+bool TimerWheel::Cancel(TimerId id) {
+    if (id == INVALID_TIMER_ID) {
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    const bool removed = timers_.erase(id) > 0;
+
+    // Slot entries for the id are left behind and skipped when reached. If the
+    // callback is running right now, wait so the caller can tear down safely.
+    if (running_id_ == id && std::this_thread::get_id() != running_thread_) {
+        callback_cv_.wait(lock, [this, id]() { return running_id_ != id; });
+    }
+    return removed;
+}
+
+bool TimerWheel::IsScheduled(TimerId id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return timers_.count(id) > 0;
+}
+
+size_t TimerWheel::GetTimerCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return timers_.size();
+}
+
+size_t TimerWheel::RunDue() {
+    if (!IsManual()) {
+        return 0;
+    }
+    std::vector<TimerId> expired;
+    std::unique_lock<std::mutex> lock(mutex_);
+    const uint64_t target_tick = ElapsedTicks();
+    size_t ran = 0;
+    while (!stop_requested_ && !timers_.empty() && current_tick_ < target_tick) {
+        ran += RunExpiredLocked(lock, target_tick, expired);
+    }
+    if (timers_.empty()) {
+        current_tick_ = std::max(current_tick_, target_tick);
+    }
+    return ran;
+}
+
+std::optional<ClockSource::TimePoint> TimerWheel::GetNextTickTime() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (timers_.empty()) {
+        return std::nullopt;
+    }
+    return start_time_ + tick_interval_ * (current_tick_ + 1);
+}
+
+void TimerWheel::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_requested_ = true;
+        timers_.clear();
+        for (auto& level : wheel_) {
+            for (auto& slot : level) {
+                slot.clear();
+            }
+        }
+    }
+    wake_cv_.notify_all();
+
+    if (worker_thread_.joinable()) {
+        if (worker_thread_.get_id() == std::this_thread::get_id()) {
+            worker_thread_.detach(); // Shut down from inside a callback
+        } else {
+            worker_thread_.join();
+        }
+    }
+}
+
+TimerWheel::TimerId TimerWheel::AddTimer(std::chrono::milliseconds delay,
+                                         uint64_t interval_ticks, Callback callback) {
+    if (!callback) {
+        return INVALID_TIMER_ID;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stop_requested_) {
+        return INVALID_TIMER_ID;
+    }
+
+    const uint64_t now_tick = std::max(current_tick_, ElapsedTicks());
+    if (timers_.empty()) {
+        // The wheel was idle; only stale entries remain, so jump straight to now
+        for (auto& level : wheel_) {
+            for (auto& slot : level) {
+                slot.clear();
+            }
+        }
+        current_tick_ = now_tick;
+    }
+
+    // Round the deadline up to a tick boundary so timers never fire early
+    const auto due = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        clock_->Now() - start_time_ +
+        std::max(delay, std::chrono::milliseconds::zero()));
+    const auto tick_ns = std::chrono::nanoseconds(tick_interval_).count();
+    const auto due_tick = static_cast<uint64_t>((due.count() + tick_ns - 1) / tick_ns);
+    const uint64_t expiry_tick = std::max(due_tick, current_tick_ + 1);
+
+    const TimerId id = next_id_++;
+    timers_.emplace(id, Timer{expiry_tick, interval_ticks, std::move(callback)});
+    InsertLocked(id, expiry_tick);
+
+    wake_cv_.notify_one();
+    return id;
+}
+
+uint64_t TimerWheel::ToTicks(std::chrono::milliseconds duration) const {
+    if (duration <= std::chrono::milliseconds::zero()) {
+        return 1;
+    }
+    const auto ticks = (duration.count() + tick_interval_.count() - 1) / tick_interval_.count();
+    return static_cast<uint64_t>(ticks);
+}
+
+uint64_t TimerWheel::ElapsedTicks() const {
+    const auto elapsed = clock_->Now() - start_time_;
+    return static_cast<uint64_t>(elapsed / tick_interval_);
+}
+
+void TimerWheel::InsertLocked(TimerId id, uint64_t expiry_tick) {
+    const uint64_t delta = expiry_tick > current_tick_ ? expiry_tick - current_tick_ : 0;
+
+    for (size_t level = 0; level < LEVEL_COUNT; ++level) {
+        const size_t shift = SLOT_BITS * level;
+        if (delta < (uint64_t{1} << (shift + SLOT_BITS))) {
+            wheel_[level][(expiry_tick >> shift) & SLOT_MASK].push_back(id);
+            return;
+        }
+    }
+
+    // Beyond the wheel span: park in the outermost level and re-cascade later
+    const size_t shift = SLOT_BITS * (LEVEL_COUNT - 1);
+    const uint64_t parked_tick = current_tick_ + WHEEL_SPAN - 1;
+    wheel_[LEVEL_COUNT - 1][(parked_tick >> shift) & SLOT_MASK].push_back(id);
+}
+
+void TimerWheel::AdvanceLocked(std::vector<TimerId>& expired) {
+    ++current_tick_;
+
+    // Entering a new block of an outer level redistributes its slot inwards
+    for (size_t level = 1; level < LEVEL_COUNT; ++level) {
+        const size_t shift = SLOT_BITS * level;
+        if ((current_tick_ & ((uint64_t{1} << shift) - 1)) != 0) {
+            break;
+        }
+
+        Slot cascading;
+        cascading.swap(wheel_[level][(current_tick_ >> shift) & SLOT_MASK]);
+        for (const TimerId id : cascading) {
+            const auto it = timers_.find(id);
+            if (it != timers_.end()) {
+                InsertLocked(id, it->second.expiry_tick);
+            }
+        }
+    }
+
+    Slot& slot = wheel_[0][current_tick_ & SLOT_MASK];
+    for (const TimerId id : slot) {
+        const auto it = timers_.find(id);
+        if (it == timers_.end()) {
+            continue; // Cancelled
+        }
+        if (it->second.expiry_tick <= current_tick_) {
+            expired.push_back(id);
+        } else {
+            InsertLocked(id, it->second.expiry_tick);
+        }
+    }
+    slot.clear();
+}
+
+size_t TimerWheel::RunExpiredLocked(std::unique_lock<std::mutex>& lock, uint64_t target_tick,
+                                    std::vector<TimerId>& expired) {
+    expired.clear();
+    while (current_tick_ < target_tick && expired.empty()) {
+        AdvanceLocked(expired);
+    }
+
+    size_t ran = 0;
+    for (const TimerId id : expired) {
+        const auto it = timers_.find(id);
+        if (it == timers_.end()) {
+            continue; // Cancelled by an earlier callback in this batch
+        }
+
+        Callback callback = std::move(it->second.callback);
+        const uint64_t interval_ticks = it->second.interval_ticks;
+        if (interval_ticks == 0) {
+            timers_.erase(it);
+        }
+
+        running_id_ = id;
+        running_thread_ = std::this_thread::get_id();
+        lock.unlock();
+        callback();
+        lock.lock();
+        running_id_ = INVALID_TIMER_ID;
+        running_thread_ = {};
+        callback_cv_.notify_all();
+        ++ran;
+
+        if (interval_ticks != 0) {
+            const auto repeat = timers_.find(id);
+            if (repeat != timers_.end()) {
+                repeat->second.callback = std::move(callback);
+                repeat->second.expiry_tick = current_tick_ + interval_ticks;
+                InsertLocked(id, repeat->second.expiry_tick);
+            }
+        }
+    }
+    return ran;
+}
+
+void TimerWheel::WorkerLoop() {
+    std::vector<TimerId> expired;
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (!stop_requested_) {
+        if (timers_.empty()) {
+            wake_cv_.wait(lock, [this]() { return stop_requested_ || !timers_.empty(); });
+            continue;
+        }
+
+        const uint64_t target_tick = ElapsedTicks();
+        if (current_tick_ >= target_tick) {
+            wake_cv_.wait_until(lock, start_time_ + tick_interval_ * (current_tick_ + 1));
+            continue;
+        }
+
+        RunExpiredLocked(lock, target_tick, expired);
+    }
+}
+
+} // namespace Core::Multiplayer
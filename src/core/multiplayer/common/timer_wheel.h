@@ -0,0 +1,155 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "clock_source.h"
+
+namespace Core::Multiplayer {
+
+/**
+ * Hierarchical timer wheel serviced by a single thread.
+ *
+ * Four levels of 64 slots each cover roughly 16.7 million ticks (about 46
+ * hours at the default 10ms tick); longer delays are parked in the outermost
+ * level and re-cascaded. Scheduling and cancellation are O(1), so thousands of
+ * clients can share one wheel instead of each parking its own sleeping
+ * threads.
+ *
+ * Callbacks run on the wheel thread and must not block. Cancel() never lets a
+ * pending callback start, and if the callback is already running on the wheel
+ * thread it waits for it to return, so an owner can cancel its timers and then
+ * safely destroy the state they capture.
+ *
+ * A wheel built on a VirtualClock has no thread of its own: whoever drives
+ * the clock calls RunDue() after advancing it, and the callbacks run on that
+ * thread, in deadline order. Components handed such a wheel read the time
+ * from GetClock(), so a whole client runs on simulated time.
+ */
+class TimerWheel {
+public:
+    using TimerId = uint64_t;
+    using Callback = std::function<void()>;
+
+    static constexpr TimerId INVALID_TIMER_ID = 0;
+    static constexpr std::chrono::milliseconds DEFAULT_TICK_INTERVAL{10};
+
+    explicit TimerWheel(std::chrono::milliseconds tick_interval = DEFAULT_TICK_INTERVAL);
+    TimerWheel(std::shared_ptr<const ClockSource> clock,
+               std::chrono::milliseconds tick_interval = DEFAULT_TICK_INTERVAL);
+    ~TimerWheel();
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    /**
+     * Process-wide wheel shared by all multiplayer components
+     */
+    static std::shared_ptr<TimerWheel> GetShared();
+
+    /**
+     * Run a callback once after the given delay (rounded up to whole ticks)
+     * @return Timer id, or INVALID_TIMER_ID if the wheel has been shut down
+     */
+    TimerId Schedule(std::chrono::milliseconds delay, Callback callback);
+
+    /**
+     * Run a callback every interval until cancelled
+     * @return Timer id, or INVALID_TIMER_ID if the wheel has been shut down
+     */
+    TimerId ScheduleRepeating(std::chrono::milliseconds interval, Callback callback);
+
+    /**
+     * Cancel a timer. Blocks while its callback is running on the wheel thread,
+     * unless called from that callback.
+     * @return True if the timer was still pending
+     */
+    bool Cancel(TimerId id);
+
+    bool IsScheduled(TimerId id) const;
+    size_t GetTimerCount() const;
+    std::chrono::milliseconds GetTickInterval() const { return tick_interval_; }
+
+    // The clock deadlines are measured on
+    const std::shared_ptr<const ClockSource>& GetClock() const { return clock_; }
+
+    // Whether the wheel is driven by RunDue() instead of its own thread
+    bool IsManual() const { return clock_->IsVirtual(); }
+
+    /**
+     * Runs, on the calling thread, every callback due by the clock's current
+     * time. Only for manual wheels.
+     * @return Number of callbacks run
+     */
+    size_t RunDue();
+
+    /**
+     * When the next tick is, for a driver advancing the clock step by step
+     * @return Nothing while no timer is pending
+     */
+    std::optional<ClockSource::TimePoint> GetNextTickTime() const;
+
+    /**
+     * Drop every pending timer and stop the wheel thread
+     */
+    void Shutdown();
+
+private:
+    static constexpr size_t LEVEL_COUNT = 4;
+    static constexpr size_t SLOT_BITS = 6;
+    static constexpr size_t SLOTS_PER_LEVEL = size_t{1} << SLOT_BITS;
+    static constexpr uint64_t SLOT_MASK = SLOTS_PER_LEVEL - 1;
+    static constexpr uint64_t WHEEL_SPAN = uint64_t{1} << (SLOT_BITS * LEVEL_COUNT);
+
+    struct Timer {
+        uint64_t expiry_tick = 0;
+        uint64_t interval_ticks = 0; // Zero for one-shot timers
+        Callback callback;
+    };
+
+    using Slot = std::vector<TimerId>;
+
+    TimerId AddTimer(std::chrono::milliseconds delay, uint64_t interval_ticks,
+                     Callback callback);
+    uint64_t ToTicks(std::chrono::milliseconds duration) const;
+    uint64_t ElapsedTicks() const;
+    void InsertLocked(TimerId id, uint64_t expiry_tick);
+    void AdvanceLocked(std::vector<TimerId>& expired);
+    // Advances towards target_tick until timers expire, then runs them
+    size_t RunExpiredLocked(std::unique_lock<std::mutex>& lock, uint64_t target_tick,
+                            std::vector<TimerId>& expired);
+    void WorkerLoop();
+
+    const std::chrono::milliseconds tick_interval_;
+    const std::shared_ptr<const ClockSource> clock_;
+    const ClockSource::TimePoint start_time_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_cv_;
+    std::condition_variable callback_cv_;
+
+    std::array<std::array<Slot, SLOTS_PER_LEVEL>, LEVEL_COUNT> wheel_;
+    std::unordered_map<TimerId, Timer> timers_;
+    uint64_t current_tick_ = 0;
+    TimerId next_id_ = 1;
+    TimerId running_id_ = INVALID_TIMER_ID;
+    std::thread::id running_thread_;
+    bool stop_requested_ = false;
+
+    std::thread worker_thread_;
+};
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,299 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "traffic_capture.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Core::Multiplayer {
+
+namespace {
+
+using namespace TrafficCaptureFormat;
+
+struct FileHeader {
+    uint32_t magic = MAGIC;
+    uint16_t version = VERSION;
+    uint16_t flags = 0;
+    uint64_t record_count = 0;
+    uint64_t record_bytes = 0;
+    uint64_t reserved = 0;
+};
+static_assert(sizeof(FileHeader) == HEADER_SIZE);
+
+struct RecordHeader {
+    uint64_t timestamp_ns = 0;
+    uint16_t size = 0;
+    uint16_t stored_size = 0; // Payload bytes that follow; 0 without payloads
+    uint8_t node_id = 0;
+    uint8_t direction = 0;
+    uint16_t reserved = 0;
+};
+static_assert(sizeof(RecordHeader) == RECORD_HEADER_SIZE);
+
+} // namespace
+
+TrafficCaptureWriter::~TrafficCaptureWriter() {
+    Close();
+}
+
+ErrorCode TrafficCaptureWriter::Open(const std::string& path, size_t capacity_bytes,
+                                     bool capture_payloads) {
+    if (IsOpen()) {
+        return ErrorCode::InvalidState;
+    }
+    if (capacity_bytes < HEADER_SIZE + RECORD_HEADER_SIZE) {
+        return ErrorCode::InvalidParameter;
+    }
+
+#ifdef _WIN32
+    const HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ,
+                                    nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return ErrorCode::PermissionDenied;
+    }
+    const auto size = static_cast<uint64_t>(capacity_bytes);
+    const HANDLE file_mapping =
+        CreateFileMappingA(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(size >> 32),
+                           static_cast<DWORD>(size), nullptr);
+    void* view = file_mapping ? MapViewOfFile(file_mapping, FILE_MAP_WRITE, 0, 0, capacity_bytes)
+                              : nullptr;
+    if (!view) {
+        if (file_mapping) {
+            CloseHandle(file_mapping);
+        }
+        CloseHandle(file);
+        return ErrorCode::ResourceExhausted;
+    }
+    file_ = file;
+    file_mapping_ = file_mapping;
+#else
+    const int file = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (file < 0) {
+        return ErrorCode::PermissionDenied;
+    }
+    if (::ftruncate(file, static_cast<off_t>(capacity_bytes)) != 0) {
+        ::close(file);
+        return ErrorCode::ResourceExhausted;
+    }
+    void* view = ::mmap(nullptr, capacity_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    if (view == MAP_FAILED) {
+        ::close(file);
+        return ErrorCode::ResourceExhausted;
+    }
+    file_ = file;
+#endif
+
+    mapping_ = static_cast<uint8_t*>(view);
+    capacity_ = capacity_bytes;
+    offset_ = HEADER_SIZE;
+    record_count_ = 0;
+    dropped_count_ = 0;
+    start_ns_ = 0;
+    capture_payloads_ = capture_payloads;
+    return ErrorCode::Success;
+}
+
+bool TrafficCaptureWriter::Record(TrafficDirection direction, uint8_t node_id,
+                                  const uint8_t* data, size_t size, uint64_t now_ns) {
+    if (!IsOpen()) {
+        return false;
+    }
+    if (size > std::numeric_limits<uint16_t>::max()) {
+        ++dropped_count_;
+        return false;
+    }
+    const size_t stored = capture_payloads_ ? size : 0;
+    if (capacity_ - offset_ < RECORD_HEADER_SIZE + stored) {
+        ++dropped_count_;
+        return false;
+    }
+    if (record_count_ == 0) {
+        start_ns_ = now_ns;
+    }
+
+    RecordHeader header;
+    header.timestamp_ns = now_ns > start_ns_ ? now_ns - start_ns_ : 0;
+    header.size = static_cast<uint16_t>(size);
+    header.stored_size = static_cast<uint16_t>(stored);
+    header.node_id = node_id;
+    header.direction = static_cast<uint8_t>(direction);
+    std::memcpy(mapping_ + offset_, &header, sizeof(header));
+    if (stored != 0) {
+        std::memcpy(mapping_ + offset_ + RECORD_HEADER_SIZE, data, stored);
+    }
+    offset_ += RECORD_HEADER_SIZE + stored;
+    ++record_count_;
+    return true;
+}
+
+ErrorCode TrafficCaptureWriter::Close() {
+    if (!IsOpen()) {
+        return ErrorCode::Success;
+    }
+    FileHeader header;
+    header.flags = capture_payloads_ ? FLAG_PAYLOADS : 0;
+    header.record_count = record_count_;
+    header.record_bytes = offset_ - HEADER_SIZE;
+    std::memcpy(mapping_, &header, sizeof(header));
+
+    const size_t used = offset_;
+    Unmap();
+
+    // Trim the unused tail of the mapping
+    bool trimmed = false;
+#ifdef _WIN32
+    LARGE_INTEGER end;
+    end.QuadPart = static_cast<LONGLONG>(used);
+    trimmed = SetFilePointerEx(static_cast<HANDLE>(file_), end, nullptr, FILE_BEGIN) &&
+              SetEndOfFile(static_cast<HANDLE>(file_));
+    CloseHandle(static_cast<HANDLE>(file_));
+    file_ = nullptr;
+#else
+    trimmed = ::ftruncate(file_, static_cast<off_t>(used)) == 0;
+    ::close(file_);
+    file_ = -1;
+#endif
+    return trimmed ? ErrorCode::Success : ErrorCode::InternalError;
+}
+
+void TrafficCaptureWriter::Unmap() {
+#ifdef _WIN32
+    UnmapViewOfFile(mapping_);
+    CloseHandle(static_cast<HANDLE>(file_mapping_));
+    file_mapping_ = nullptr;
+#else
+    ::munmap(mapping_, capacity_);
+#endif
+    mapping_ = nullptr;
+    capacity_ = 0;
+}
+
+TrafficCaptureReader::~TrafficCaptureReader() {
+    Close();
+}
+
+ErrorCode TrafficCaptureReader::Open(const std::string& path) {
+    Close();
+
+#ifdef _WIN32
+    const HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return ErrorCode::InvalidParameter;
+    }
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) ||
+        static_cast<uint64_t>(file_size.QuadPart) < HEADER_SIZE) {
+        CloseHandle(file);
+        return ErrorCode::InvalidMessage;
+    }
+    const HANDLE file_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* view = file_mapping ? MapViewOfFile(file_mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        if (file_mapping) {
+            CloseHandle(file_mapping);
+        }
+        CloseHandle(file);
+        return ErrorCode::ResourceExhausted;
+    }
+    file_ = file;
+    file_mapping_ = file_mapping;
+    size_ = static_cast<size_t>(file_size.QuadPart);
+#else
+    const int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        return ErrorCode::InvalidParameter;
+    }
+    struct stat file_stat{};
+    if (::fstat(file, &file_stat) != 0 || static_cast<size_t>(file_stat.st_size) < HEADER_SIZE) {
+        ::close(file);
+        return ErrorCode::InvalidMessage;
+    }
+    const size_t size = static_cast<size_t>(file_stat.st_size);
+    void* view = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+    if (view == MAP_FAILED) {
+        ::close(file);
+        return ErrorCode::ResourceExhausted;
+    }
+    file_ = file;
+    size_ = size;
+#endif
+    mapping_ = static_cast<const uint8_t*>(view);
+
+    FileHeader header;
+    std::memcpy(&header, mapping_, sizeof(header));
+    if (header.magic != MAGIC || header.version != VERSION ||
+        header.record_bytes > size_ - HEADER_SIZE) {
+        Close();
+        return ErrorCode::InvalidMessage;
+    }
+    has_payloads_ = (header.flags & FLAG_PAYLOADS) != 0;
+
+    const size_t end = HEADER_SIZE + static_cast<size_t>(header.record_bytes);
+    size_t offset = HEADER_SIZE;
+    records_.reserve(static_cast<size_t>(
+        std::min<uint64_t>(header.record_count, header.record_bytes / RECORD_HEADER_SIZE)));
+    while (offset < end) {
+        if (end - offset < RECORD_HEADER_SIZE) {
+            Close();
+            return ErrorCode::InvalidMessage;
+        }
+        RecordHeader record_header;
+        std::memcpy(&record_header, mapping_ + offset, sizeof(record_header));
+        offset += RECORD_HEADER_SIZE;
+        if (end - offset < record_header.stored_size ||
+            record_header.direction > static_cast<uint8_t>(TrafficDirection::Received)) {
+            Close();
+            return ErrorCode::InvalidMessage;
+        }
+
+        TrafficRecord record;
+        record.timestamp_ns = record_header.timestamp_ns;
+        record.size = record_header.size;
+        record.node_id = record_header.node_id;
+        record.direction = static_cast<TrafficDirection>(record_header.direction);
+        record.payload = {mapping_ + offset, record_header.stored_size};
+        records_.push_back(record);
+        offset += record_header.stored_size;
+    }
+    if (records_.size() != header.record_count) {
+        Close();
+        return ErrorCode::InvalidMessage;
+    }
+    return ErrorCode::Success;
+}
+
+void TrafficCaptureReader::Close() {
+    records_.clear();
+    has_payloads_ = false;
+    if (!mapping_) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(mapping_);
+    CloseHandle(static_cast<HANDLE>(file_mapping_));
+    CloseHandle(static_cast<HANDLE>(file_));
+    file_mapping_ = nullptr;
+    file_ = nullptr;
+#else
+    ::munmap(const_cast<uint8_t*>(mapping_), size_);
+    ::close(file_);
+    file_ = -1;
+#endif
+    mapping_ = nullptr;
+    size_ = 0;
+}
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,162 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "error_codes.h"
+
+namespace Core::Multiplayer {
+
+/**
+ * Which way a captured packet went, seen from the local console
+ */
+enum class TrafficDirection : uint8_t {
+    Sent = 0,
+    Received = 1,
+};
+
+/**
+ * One captured packet as read back from a capture. payload points into the
+ * reader's mapping and is empty if payloads were not captured.
+ */
+struct TrafficRecord {
+    uint64_t timestamp_ns = 0; // Since the capture started
+    uint16_t size = 0;         // Size of the packet as sent or received
+    uint8_t node_id = 0;
+    TrafficDirection direction = TrafficDirection::Sent;
+    std::span<const uint8_t> payload;
+};
+
+/**
+ * Capture file layout, little-endian as written by the capturing host:
+ *
+ *   header   32 bytes: magic, version, flags, record count, record bytes
+ *   records  16-byte record header, then the payload if FLAG_PAYLOADS
+ *
+ * Record headers hold the timestamp in nanoseconds since the capture
+ * started, the packet size, node id and direction.
+ */
+namespace TrafficCaptureFormat {
+constexpr uint32_t MAGIC = 0x5043444C; // "LDCP"
+constexpr uint16_t VERSION = 1;
+constexpr uint16_t FLAG_PAYLOADS = 0x0001;
+constexpr size_t HEADER_SIZE = 32;
+constexpr size_t RECORD_HEADER_SIZE = 16;
+} // namespace TrafficCaptureFormat
+
+/**
+ * Records LDN packets into a memory-mapped capture file.
+ *
+ * The file is sized to the capacity up front and mapped, so recording a
+ * packet is a bounds check and a copy into the mapping: no system call and
+ * no allocation on the data path. Packets that no longer fit are counted
+ * as dropped. Close() writes the header and trims the file to what was
+ * recorded; a capture that was never closed has no valid header.
+ *
+ * Not thread-safe; LdnServiceBridge records from the HLE thread.
+ */
+class TrafficCaptureWriter {
+public:
+    TrafficCaptureWriter() = default;
+    ~TrafficCaptureWriter();
+
+    TrafficCaptureWriter(const TrafficCaptureWriter&) = delete;
+    TrafficCaptureWriter& operator=(const TrafficCaptureWriter&) = delete;
+
+    /**
+     * Creates or truncates the file at path and maps capacity_bytes of it
+     * @param capture_payloads False keeps only timestamps, sizes and node ids
+     */
+    [[nodiscard]] ErrorCode Open(const std::string& path, size_t capacity_bytes,
+                                 bool capture_payloads = true);
+    // Finishes the file; a no-op if not open
+    ErrorCode Close();
+    bool IsOpen() const {
+        return mapping_ != nullptr;
+    }
+
+    /**
+     * @param now_ns MonotonicClock nanoseconds, as from DataPathLatency::Now();
+     *        the first record sets the capture's start
+     * @return False if the capture is full or closed
+     */
+    bool Record(TrafficDirection direction, uint8_t node_id, const uint8_t* data, size_t size,
+                uint64_t now_ns);
+
+    uint64_t GetRecordCount() const {
+        return record_count_;
+    }
+    uint64_t GetDroppedCount() const {
+        return dropped_count_;
+    }
+    size_t GetBytesUsed() const {
+        return offset_;
+    }
+
+private:
+    void Unmap();
+
+    uint8_t* mapping_ = nullptr;
+    size_t capacity_ = 0;
+    size_t offset_ = 0;
+    uint64_t record_count_ = 0;
+    uint64_t dropped_count_ = 0;
+    uint64_t start_ns_ = 0;
+    bool capture_payloads_ = true;
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* file_mapping_ = nullptr;
+#else
+    int file_ = -1;
+#endif
+};
+
+/**
+ * Maps a capture file read-only and indexes its records
+ */
+class TrafficCaptureReader {
+public:
+    TrafficCaptureReader() = default;
+    ~TrafficCaptureReader();
+
+    TrafficCaptureReader(const TrafficCaptureReader&) = delete;
+    TrafficCaptureReader& operator=(const TrafficCaptureReader&) = delete;
+
+    /**
+     * @return InvalidMessage if the file is not a finished capture or a
+     *         record runs past its end
+     */
+    [[nodiscard]] ErrorCode Open(const std::string& path);
+    void Close();
+
+    bool HasPayloads() const {
+        return has_payloads_;
+    }
+    // Records in capture order; payloads stay valid until Close()
+    const std::vector<TrafficRecord>& GetRecords() const {
+        return records_;
+    }
+    uint64_t GetDuration() const {
+        return records_.empty() ? 0 : records_.back().timestamp_ns;
+    }
+
+private:
+    const uint8_t* mapping_ = nullptr;
+    size_t size_ = 0;
+    bool has_payloads_ = false;
+    std::vector<TrafficRecord> records_;
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* file_mapping_ = nullptr;
+#else
+    int file_ = -1;
+#endif
+};
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,283 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "traffic_profile.h"
+#include "fec_codec.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+
+#include <nlohmann/json.hpp>
+
+namespace Core::Multiplayer {
+
+namespace {
+using json = nlohmann::json;
+
+constexpr int TABLE_FORMAT_VERSION = 1;
+constexpr uint64_t NS_PER_SECOND = 1'000'000'000;
+
+constexpr uint64_t SUPER_SMASH_BROS_ULTIMATE = 0x01006A800016E000;
+constexpr uint64_t SPLATOON_2 = 0x01003BC0000A0000;
+constexpr uint64_t SPLATOON_3 = 0x0100C2500FC20000;
+constexpr uint64_t MARIO_KART_8_DELUXE = 0x0100152000022000;
+constexpr uint64_t ANIMAL_CROSSING_NEW_HORIZONS = 0x01006F8002326000;
+
+// Smallest value whose bucket holds the given fraction of the samples
+template <size_t N>
+size_t Percentile(const std::array<uint64_t, N>& histogram, uint64_t total, double fraction) {
+    const auto wanted = static_cast<uint64_t>(static_cast<double>(total) * fraction);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < N; ++i) {
+        seen += histogram[i];
+        if (seen > wanted) {
+            return i;
+        }
+    }
+    return N - 1;
+}
+} // namespace
+
+TrafficProfile AdaptToBandwidth(const TrafficProfile& profile,
+                                uint64_t available_bytes_per_second) {
+    constexpr size_t MIN_COMPRESSION_THRESHOLD = 64;
+    constexpr uint8_t MIN_FEC_GROUP_SIZE = 2;
+
+    TrafficProfile adapted = profile;
+    if (available_bytes_per_second == 0) {
+        return adapted; // Not measured yet
+    }
+    if (available_bytes_per_second < LOW_BANDWIDTH) {
+        if (adapted.compression_threshold != 0) {
+            adapted.compression_threshold =
+                std::max(adapted.compression_threshold / 4, MIN_COMPRESSION_THRESHOLD);
+        }
+        if (adapted.fec_group_size != 0) {
+            adapted.fec_group_size = static_cast<uint8_t>(
+                std::min<int>(adapted.fec_group_size * 2, FecEncoder::MAX_GROUP_SIZE));
+        }
+    } else if (available_bytes_per_second > HIGH_BANDWIDTH) {
+        if (adapted.compression_threshold != 0) {
+            adapted.compression_threshold =
+                std::min(adapted.compression_threshold * 4, PACKET_BUFFER_SIZE);
+        }
+        if (adapted.fec_group_size != 0) {
+            adapted.fec_group_size = std::max<uint8_t>(
+                static_cast<uint8_t>(adapted.fec_group_size / 2), MIN_FEC_GROUP_SIZE);
+        }
+    }
+    return adapted;
+}
+
+TrafficProfile TrafficProfileTable::LowLatency() {
+    TrafficProfile profile;
+    profile.jitter_target = std::chrono::microseconds(2000);
+    profile.fec_group_size = 4;
+    return profile;
+}
+
+TrafficProfile TrafficProfileTable::Action() {
+    TrafficProfile profile;
+    profile.coalescing_threshold = 512;
+    profile.jitter_target = std::chrono::microseconds(4000);
+    profile.fec_group_size = 8;
+    return profile;
+}
+
+TrafficProfile TrafficProfileTable::Bulk() {
+    TrafficProfile profile;
+    profile.coalescing_threshold = 1200;
+    profile.jitter_target = std::chrono::microseconds(10000);
+    profile.compression_threshold = 256;
+    profile.priority = SendPriority::Bulk;
+    return profile;
+}
+
+TrafficProfileTable::TrafficProfileTable() {
+    built_in_[SUPER_SMASH_BROS_ULTIMATE] = LowLatency();
+    built_in_[SPLATOON_2] = Action();
+    built_in_[SPLATOON_3] = Action();
+    built_in_[MARIO_KART_8_DELUXE] = Action();
+    built_in_[ANIMAL_CROSSING_NEW_HORIZONS] = Bulk();
+}
+
+TrafficProfile TrafficProfileTable::Lookup(uint64_t local_communication_id) const {
+    if (const auto it = overrides_.find(local_communication_id); it != overrides_.end()) {
+        return it->second;
+    }
+    if (const auto it = built_in_.find(local_communication_id); it != built_in_.end()) {
+        return it->second;
+    }
+    return {};
+}
+
+bool TrafficProfileTable::HasProfile(uint64_t local_communication_id) const {
+    return overrides_.contains(local_communication_id) ||
+           built_in_.contains(local_communication_id);
+}
+
+void TrafficProfileTable::Set(uint64_t local_communication_id, const TrafficProfile& profile) {
+    overrides_[local_communication_id] = profile;
+}
+
+void TrafficProfileTable::Reset(uint64_t local_communication_id) {
+    overrides_.erase(local_communication_id);
+}
+
+bool TrafficProfileTable::Load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        return true;
+    }
+
+    decltype(overrides_) overrides;
+    try {
+        const json document = json::parse(file);
+        if (document.value("version", 0) != TABLE_FORMAT_VERSION) {
+            return false;
+        }
+        for (const auto& entry : document.at("profiles")) {
+            TrafficProfile profile;
+            profile.coalescing_threshold = entry.value("coalescing_threshold", size_t{0});
+            profile.jitter_target =
+                std::chrono::microseconds(entry.value("jitter_target_us", int64_t{5000}));
+            profile.fec_group_size = entry.value("fec_group_size", uint8_t{0});
+            profile.compression_threshold = entry.value("compression_threshold", size_t{0});
+            const auto priority = entry.value("priority", 1);
+            if (priority < 0 || priority > static_cast<int>(SendPriority::Bulk)) {
+                return false;
+            }
+            profile.priority = static_cast<SendPriority>(priority);
+            const auto key_length = entry.value("latest_value_length", 0);
+            if (key_length < 0 || key_length > LatestValueKey::MAX_LENGTH) {
+                return false;
+            }
+            profile.latest_value_key.offset = entry.value("latest_value_offset", uint16_t{0});
+            profile.latest_value_key.length = static_cast<uint8_t>(key_length);
+            const auto id = std::stoull(entry.at("local_communication_id").get<std::string>(),
+                                        nullptr, 16);
+            overrides[id] = profile;
+        }
+    } catch (const json::exception&) {
+        return false;
+    } catch (const std::logic_error&) {
+        return false;
+    }
+
+    overrides_ = std::move(overrides);
+    return true;
+}
+
+bool TrafficProfileTable::Save(const std::string& path) const {
+    json profiles = json::array();
+    for (const auto& [id, profile] : overrides_) {
+        char id_hex[17];
+        std::snprintf(id_hex, sizeof(id_hex), "%016llx", static_cast<unsigned long long>(id));
+        profiles.push_back({{"local_communication_id", id_hex},
+                            {"coalescing_threshold", profile.coalescing_threshold},
+                            {"jitter_target_us", profile.jitter_target.count()},
+                            {"fec_group_size", profile.fec_group_size},
+                            {"compression_threshold", profile.compression_threshold},
+                            {"priority", static_cast<int>(profile.priority)},
+                            {"latest_value_offset", profile.latest_value_key.offset},
+                            {"latest_value_length", profile.latest_value_key.length}});
+    }
+    const json document{{"version", TABLE_FORMAT_VERSION}, {"profiles", std::move(profiles)}};
+
+    const std::string temp_path = path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+        file << document.dump();
+        if (!file.flush()) {
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temp_path, path, error);
+    return !error;
+}
+
+void TrafficProfileLearner::Observe(size_t size, uint64_t now_ns) {
+    if (packets_ == 0 || now_ns - window_start_ns_ >= NS_PER_SECOND) {
+        CloseWindow();
+        window_start_ns_ = now_ns;
+    }
+    ++window_packets_;
+    ++size_histogram_[std::min(size / SIZE_BUCKET_BYTES, SIZE_BUCKETS - 1)];
+    ++packets_;
+}
+
+void TrafficProfileLearner::CloseWindow() {
+    if (window_packets_ == 0) {
+        return;
+    }
+    ++rate_histogram_[std::min<size_t>(window_packets_ / RATE_BUCKET_PACKETS, RATE_BUCKETS - 1)];
+    window_packets_ = 0;
+}
+
+void TrafficProfileLearner::Reset() {
+    size_histogram_ = {};
+    rate_histogram_ = {};
+    packets_ = 0;
+    window_start_ns_ = 0;
+    window_packets_ = 0;
+}
+
+TrafficShape TrafficProfileLearner::GetShape() const {
+    TrafficShape shape;
+    shape.packets = packets_;
+    if (packets_ == 0) {
+        return shape;
+    }
+    // Largest size in the bucket, so a shape never understates packet sizes
+    shape.median_size = (Percentile(size_histogram_, packets_, 0.5) + 1) * SIZE_BUCKET_BYTES - 1;
+    shape.p90_size = (Percentile(size_histogram_, packets_, 0.9) + 1) * SIZE_BUCKET_BYTES - 1;
+
+    // The open window counts too, unless it has barely started
+    auto rates = rate_histogram_;
+    uint64_t windows = 0;
+    for (const auto count : rates) {
+        windows += count;
+    }
+    if (windows == 0 || window_packets_ >= RATE_BUCKET_PACKETS) {
+        ++rates[std::min<size_t>(window_packets_ / RATE_BUCKET_PACKETS, RATE_BUCKETS - 1)];
+        ++windows;
+    }
+    shape.packets_per_second =
+        static_cast<uint32_t>(Percentile(rates, windows, 0.5) * RATE_BUCKET_PACKETS);
+    return shape;
+}
+
+std::optional<TrafficProfile> TrafficProfileLearner::Derive(const TrafficProfile& base) const {
+    if (packets_ < MIN_PACKETS) {
+        return std::nullopt;
+    }
+    const TrafficShape shape = GetShape();
+
+    TrafficProfile profile = base;
+    if (shape.packets_per_second >= 50) {
+        // Frame-rate traffic: holding packets back costs more than headers
+        profile.coalescing_threshold = 0;
+        profile.jitter_target = std::chrono::microseconds(2000);
+    } else if (shape.packets_per_second >= 15) {
+        profile.coalescing_threshold = std::clamp<size_t>(shape.p90_size * 4, 256, 1200);
+        profile.jitter_target = std::chrono::microseconds(4000);
+    } else {
+        profile.coalescing_threshold = 1200;
+        profile.jitter_target = std::chrono::microseconds(10000);
+    }
+    profile.compression_threshold = shape.median_size >= 256 ? 256 : 0;
+    profile.priority = shape.median_size >= 512 && shape.packets_per_second < 20
+                           ? SendPriority::Bulk
+                           : SendPriority::Realtime;
+    return profile;
+}
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,146 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "packet_buffer.h"
+#include "priority_send_queue.h"
+
+namespace Core::Multiplayer {
+
+/**
+ * Data path tuning for one title's traffic
+ */
+struct TrafficProfile {
+    // Bytes held per destination before coalesced packets go out early; 0
+    // sends every packet on its own
+    size_t coalescing_threshold = 0;
+    // Starting playout delay of the receive jitter buffer
+    std::chrono::microseconds jitter_target{5000};
+    // Data packets per parity packet; 0 turns FEC off. Every node of a
+    // session must agree on whether it is on
+    uint8_t fec_group_size = 0;
+    // Payloads of at least this many bytes are compressed; 0 turns it off
+    size_t compression_threshold = 0;
+    // Send class of packets the game sends without one
+    SendPriority priority = SendPriority::Realtime;
+    // Where state packets carry their slot; when set, a queued packet is
+    // replaced by a newer one for the same slot instead of sent stale
+    LatestValueKey latest_value_key;
+
+    bool operator==(const TrafficProfile&) const = default;
+};
+
+// Available bandwidth, bytes/s, below which bytes cost more than CPU time
+// (about 512 Kbps) and above which the reverse holds (about 16 Mbps)
+constexpr uint64_t LOW_BANDWIDTH = 64 * 1024;
+constexpr uint64_t HIGH_BANDWIDTH = 2 * 1024 * 1024;
+
+/**
+ * Retunes a profile for a link's available bandwidth, as BandwidthEstimator
+ * measures it. On a slow link smaller payloads are compressed and parity is
+ * spread over twice the packets; on a fast one only large payloads are
+ * compressed and parity comes twice as often. Compression and FEC are never
+ * turned on or off, only retuned: each parity packet carries its group
+ * size, so the nodes of a session need not agree on it.
+ */
+TrafficProfile AdaptToBandwidth(const TrafficProfile& profile,
+                                uint64_t available_bytes_per_second);
+
+/**
+ * Profiles keyed by local_communication_id, the id a title puts in its
+ * CreateNetworkConfig; for most titles it is the title id.
+ *
+ * Built-in entries cover titles whose traffic is known; set entries, such
+ * as learned ones, override them and are what Load and Save persist.
+ * Titles without an entry get the default profile, which leaves every
+ * optimization off.
+ */
+class TrafficProfileTable {
+public:
+    // Fighting games: every frame counts, so nothing is held back
+    static TrafficProfile LowLatency();
+    // Shooters and racers: small packets at a high rate
+    static TrafficProfile Action();
+    // Life sims and the like: larger, infrequent, loss-tolerant transfers
+    static TrafficProfile Bulk();
+
+    TrafficProfileTable();
+
+    TrafficProfile Lookup(uint64_t local_communication_id) const;
+    bool HasProfile(uint64_t local_communication_id) const;
+    void Set(uint64_t local_communication_id, const TrafficProfile& profile);
+    // Drops the set entry, going back to the built-in one if there is one
+    void Reset(uint64_t local_communication_id);
+
+    /**
+     * Replaces the set entries with those in the JSON file at path
+     * @return False if the file exists but could not be parsed
+     */
+    bool Load(const std::string& path);
+    // Writes the set entries through a temporary file
+    bool Save(const std::string& path) const;
+
+private:
+    std::unordered_map<uint64_t, TrafficProfile> built_in_;
+    std::unordered_map<uint64_t, TrafficProfile> overrides_;
+};
+
+/**
+ * What TrafficProfileLearner measured
+ */
+struct TrafficShape {
+    uint64_t packets = 0;
+    size_t median_size = 0;
+    size_t p90_size = 0;
+    // Median over the one-second windows that carried traffic
+    uint32_t packets_per_second = 0;
+};
+
+/**
+ * Learning mode: derives a profile from the sizes and rate of the packets
+ * a title sends.
+ *
+ * Sizes go into 64-byte buckets and the number of packets in each second
+ * into a rate histogram, so observing is a few increments and memory stays
+ * fixed however long the session runs. Derive() only retunes what each
+ * node may choose for itself; FEC changes the wire format, so it is kept
+ * from the profile the session started with.
+ */
+class TrafficProfileLearner {
+public:
+    // Packets observed before Derive() trusts the histograms
+    static constexpr uint64_t MIN_PACKETS = 600;
+
+    // A packet of size bytes sent at now_ns, steady clock nanoseconds
+    void Observe(size_t size, uint64_t now_ns);
+    void Reset();
+
+    TrafficShape GetShape() const;
+    // Nothing until MIN_PACKETS have been observed
+    std::optional<TrafficProfile> Derive(const TrafficProfile& base) const;
+
+private:
+    static constexpr size_t SIZE_BUCKET_BYTES = 64;
+    static constexpr size_t SIZE_BUCKETS = PACKET_BUFFER_SIZE / SIZE_BUCKET_BYTES + 1;
+    static constexpr uint32_t RATE_BUCKET_PACKETS = 5;
+    static constexpr size_t RATE_BUCKETS = 64; // The last one holds 315 per second and up
+
+    void CloseWindow();
+
+    std::array<uint64_t, SIZE_BUCKETS> size_histogram_{};
+    std::array<uint64_t, RATE_BUCKETS> rate_histogram_{};
+    uint64_t packets_ = 0;
+    uint64_t window_start_ns_ = 0;
+    uint32_t window_packets_ = 0;
+};
+
+} // namespace Core::Multiplayer
@@ -0,0 +1,192 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+/**
+ * Little-endian wire layouts for fixed-size protocol headers.
+ *
+ * A header is described once, as a struct and the list of its fields with
+ * their wire offsets:
+ *
+ *     using Layout = Wire::Layout<12, Wire::Field<&Header::token, 0>,
+ *                                     Wire::Field<&Header::size, 4>, ...>;
+ *
+ * Layout checks at compile time that the fields tile the header exactly,
+ * with no gaps or overlaps, and Encode and Decode then move each field with
+ * one load or store, byte swapped only on big-endian hosts. Both are
+ * constexpr, so layouts can be tested with static_assert.
+ */
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+namespace Core::Multiplayer::Wire {
+
+// Compilers turn this into a single bswap or rev instruction
+template <std::unsigned_integral T>
+constexpr T ByteSwap(T value) {
+    T result = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        result = static_cast<T>((result << 8) | ((value >> (i * 8)) & 0xFF));
+    }
+    return result;
+}
+
+template <typename T>
+concept WireValue = std::integral<T> || std::is_enum_v<T>;
+
+namespace Detail {
+
+template <typename T>
+struct WireBits {
+    using Type = std::make_unsigned_t<T>;
+};
+template <typename T>
+    requires std::is_enum_v<T>
+struct WireBits<T> {
+    using Type = std::make_unsigned_t<std::underlying_type_t<T>>;
+};
+template <>
+struct WireBits<bool> {
+    using Type = uint8_t;
+};
+
+template <typename T>
+using Bits = typename WireBits<T>::Type;
+
+template <typename U>
+constexpr U ToLittle(U value) {
+    if constexpr (std::endian::native == std::endian::big) {
+        return ByteSwap(value);
+    } else {
+        return value;
+    }
+}
+
+// Every byte of the header belongs to exactly one field
+template <size_t Size, typename... Fields>
+consteval bool TilesExactly() {
+    std::array<uint8_t, Size> owners{};
+    bool fits = true;
+    const auto claim = [&](size_t offset, size_t length) {
+        if (offset + length > Size) {
+            fits = false;
+            return;
+        }
+        for (size_t i = offset; i < offset + length; ++i) {
+            ++owners[i];
+        }
+    };
+    (claim(Fields::offset, Fields::size), ...);
+    for (const uint8_t owner_count : owners) {
+        fits = fits && owner_count == 1;
+    }
+    return fits;
+}
+
+} // namespace Detail
+
+// Writes value little endian at the start of out
+template <WireValue T>
+constexpr void StoreLittle(std::span<uint8_t, sizeof(T)> out, T value) {
+    using U = Detail::Bits<T>;
+    const U bits = static_cast<U>(value);
+    if (std::is_constant_evaluated()) {
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            out[i] = static_cast<uint8_t>(bits >> (i * 8));
+        }
+    } else {
+        const U little = Detail::ToLittle(bits);
+        std::memcpy(out.data(), &little, sizeof(U));
+    }
+}
+
+// Reads a little-endian T from the start of in
+template <WireValue T>
+constexpr T LoadLittle(std::span<const uint8_t, sizeof(T)> in) {
+    using U = Detail::Bits<T>;
+    U bits = 0;
+    if (std::is_constant_evaluated()) {
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            bits = static_cast<U>(bits | (static_cast<U>(in[i]) << (i * 8)));
+        }
+    } else {
+        std::memcpy(&bits, in.data(), sizeof(U));
+        bits = Detail::ToLittle(bits);
+    }
+    return static_cast<T>(bits);
+}
+
+/**
+ * One field of a layout: a data member and its offset on the wire
+ */
+template <auto Member, size_t Offset>
+struct Field;
+
+template <typename S, WireValue T, T S::*Member, size_t Offset>
+struct Field<Member, Offset> {
+    using Struct = S;
+    using Type = T;
+    static constexpr size_t offset = Offset;
+    static constexpr size_t size = sizeof(T);
+
+    template <size_t N>
+    static constexpr void Encode(const S& from, std::span<uint8_t, N> out) {
+        StoreLittle<T>(out.template subspan<Offset, sizeof(T)>(), from.*Member);
+    }
+
+    template <size_t N>
+    static constexpr void Decode(std::span<const uint8_t, N> in, S& to) {
+        to.*Member = LoadLittle<T>(in.template subspan<Offset, sizeof(T)>());
+    }
+};
+
+template <size_t Size, typename First, typename... Rest>
+class Layout {
+public:
+    using Struct = typename First::Struct;
+    static constexpr size_t size = Size;
+
+    static constexpr void Encode(const Struct& from, std::span<uint8_t, Size> out) {
+        First::Encode(from, out);
+        (Rest::Encode(from, out), ...);
+    }
+
+    static constexpr void Decode(std::span<const uint8_t, Size> in, Struct& to) {
+        First::Decode(in, to);
+        (Rest::Decode(in, to), ...);
+    }
+
+    // False if out is shorter than the header
+    static constexpr bool TryEncode(const Struct& from, std::span<uint8_t> out) {
+        if (out.size() < Size) {
+            return false;
+        }
+        Encode(from, out.template first<Size>());
+        return true;
+    }
+
+    // False if in is shorter than the header; anything past it is ignored
+    static constexpr bool TryDecode(std::span<const uint8_t> in, Struct& to) {
+        if (in.size() < Size) {
+            return false;
+        }
+        Decode(in.template first<Size>(), to);
+        return true;
+    }
+
+private:
+    static_assert((std::is_same_v<Struct, typename Rest::Struct> && ...),
+                  "Every field of a layout must belong to the same struct");
+    static_assert(Detail::TilesExactly<Size, First, Rest...>(),
+                  "Layout fields must cover the header without gaps or overlaps");
+};
+
+} // namespace Core::Multiplayer::Wire
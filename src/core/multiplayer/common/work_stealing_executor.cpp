@@ -0,0 +1,341 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "work_stealing_executor.h"
+#include "thread_policy.h"
+
+#include <chrono>
+#include <string>
+
+namespace Core::Multiplayer {
+
+namespace {
+
+// Identifies the executor and worker slot owning the current thread, so
+// submissions from inside a task can use the worker's own deque
+thread_local WorkStealingExecutor* current_executor = nullptr;
+thread_local size_t current_worker_index = 0;
+
+constexpr size_t INITIAL_DEQUE_CAPACITY = 256;
+
+} // anonymous namespace
+
+/**
+ * Chase-Lev work-stealing deque (Le, Pop, Cohen, Zappa Nardelli, PPoPP 2013).
+ *
+ * Only the owning worker calls Push and Pop; any thread may call Steal. The
+ * ring grows when full; retired rings are kept until destruction because a
+ * concurrent thief may still be reading from them.
+ */
+class WorkStealingExecutor::WorkDeque {
+public:
+    WorkDeque() {
+        rings_.push_back(std::make_unique<Ring>(INITIAL_DEQUE_CAPACITY));
+        ring_.store(rings_.back().get(), std::memory_order_relaxed);
+    }
+
+    void Push(SmallTask* task) {
+        const int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        const int64_t top = top_.load(std::memory_order_acquire);
+        Ring* ring = ring_.load(std::memory_order_relaxed);
+        if (bottom - top > ring->capacity - 1) {
+            ring = Grow(ring, top, bottom);
+        }
+        ring->Store(bottom, task);
+        bottom_.store(bottom + 1, std::memory_order_release);
+    }
+
+    bool Pop(SmallTask*& task) {
+        const int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        Ring* ring = ring_.load(std::memory_order_relaxed);
+        // Sequentially consistent store/load pair instead of a standalone fence,
+        // which ThreadSanitizer cannot model
+        bottom_.store(bottom, std::memory_order_seq_cst);
+        int64_t top = top_.load(std::memory_order_seq_cst);
+
+        if (top > bottom) {
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return false; // Empty
+        }
+
+        task = ring->Load(bottom);
+        if (top == bottom) {
+            // Last element: race any thief for it
+            const bool won = top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                                          std::memory_order_relaxed);
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    bool Steal(SmallTask*& task) {
+        int64_t top = top_.load(std::memory_order_seq_cst);
+        const int64_t bottom = bottom_.load(std::memory_order_seq_cst);
+        if (top >= bottom) {
+            return false;
+        }
+
+        Ring* ring = ring_.load(std::memory_order_acquire);
+        SmallTask* candidate = ring->Load(top);
+        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed)) {
+            return false; // Lost the race to another thief or the owner
+        }
+        task = candidate;
+        return true;
+    }
+
+    size_t Size() const {
+        const int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        const int64_t top = top_.load(std::memory_order_relaxed);
+        return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+    }
+
+private:
+    struct Ring {
+        explicit Ring(int64_t ring_capacity)
+            : capacity(ring_capacity), mask(ring_capacity - 1),
+              slots(std::make_unique<std::atomic<SmallTask*>[]>(static_cast<size_t>(ring_capacity))) {}
+
+        SmallTask* Load(int64_t index) const {
+            return slots[static_cast<size_t>(index & mask)].load(std::memory_order_relaxed);
+        }
+
+        void Store(int64_t index, SmallTask* task) {
+            slots[static_cast<size_t>(index & mask)].store(task, std::memory_order_relaxed);
+        }
+
+        const int64_t capacity;
+        const int64_t mask;
+        std::unique_ptr<std::atomic<SmallTask*>[]> slots;
+    };
+
+    Ring* Grow(Ring* old_ring, int64_t top, int64_t bottom) {
+        auto grown = std::make_unique<Ring>(old_ring->capacity * 2);
+        for (int64_t i = top; i < bottom; ++i) {
+            grown->Store(i, old_ring->Load(i));
+        }
+        Ring* ring = grown.get();
+        rings_.push_back(std::move(grown));
+        ring_.store(ring, std::memory_order_release);
+        return ring;
+    }
+
+    alignas(64) std::atomic<int64_t> top_{0};
+    alignas(64) std::atomic<int64_t> bottom_{0};
+    std::atomic<Ring*> ring_{nullptr};
+    std::vector<std::unique_ptr<Ring>> rings_; // Owner only
+};
+
+struct WorkStealingExecutor::Worker {
+    WorkDeque deque;
+    std::thread thread;
+    uint32_t steal_seed = 0;
+};
+
+WorkStealingExecutor::WorkStealingExecutor(size_t thread_count) {
+    if (thread_count == 0) {
+        thread_count = 1;
+    }
+
+    workers_.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        auto worker = std::make_unique<Worker>();
+        worker->steal_seed = static_cast<uint32_t>(i * 2654435761u + 1);
+        workers_.push_back(std::move(worker));
+    }
+
+    // Start threads only once every deque exists, since workers steal from all
+    for (size_t i = 0; i < thread_count; ++i) {
+        workers_[i]->thread = SpawnThread(ThreadRole::Worker, "mp-worker-" + std::to_string(i),
+                                           [this, i]() { WorkerLoop(i); });
+    }
+}
+
+WorkStealingExecutor::~WorkStealingExecutor() {
+    stop_requested_.store(true);
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+    }
+    sleep_cv_.notify_all();
+
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+
+    // Tasks posted after the workers drained (e.g. from another thread racing
+    // shutdown) are run here so no future is left without a value
+    SmallTask* task = nullptr;
+    while (TryTakeInjected(task)) {
+        RunTask(task);
+    }
+}
+
+std::shared_ptr<WorkStealingExecutor> WorkStealingExecutor::GetShared() {
+    static std::shared_ptr<WorkStealingExecutor> shared = std::make_shared<WorkStealingExecutor>();
+    return shared;
+}
+
+bool WorkStealingExecutor::Post(SmallTask task) {
+    if (!task || stop_requested_.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    auto* node = new SmallTask(std::move(task));
+    pending_tasks_.fetch_add(1, std::memory_order_seq_cst);
+
+    if (current_executor == this) {
+        workers_[current_worker_index]->deque.Push(node);
+    } else {
+        std::lock_guard<std::mutex> lock(injection_mutex_);
+        injection_queue_.push_back(node);
+    }
+
+    // Pairs with the sleeping_workers_ increment in WorkerLoop: either we see
+    // the sleeper here or it sees our pending task before it waits
+    if (sleeping_workers_.load(std::memory_order_seq_cst) > 0) {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+        }
+        sleep_cv_.notify_one();
+    }
+    return true;
+}
+
+bool WorkStealingExecutor::TryRunPendingTask() {
+    SmallTask* task = nullptr;
+    const bool found = current_executor == this
+                           ? TryTakeTask(current_worker_index, task)
+                           : TryTakeInjected(task) || TryStealTask(workers_.size(), task);
+    if (!found) {
+        return false;
+    }
+    RunTask(task);
+    return true;
+}
+
+ExecutorStatistics WorkStealingExecutor::GetStatistics() const {
+    ExecutorStatistics stats;
+    stats.worker_count = workers_.size();
+    stats.queued_tasks = pending_tasks_.load(std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(injection_mutex_);
+        stats.injection_queue_depth = injection_queue_.size();
+    }
+    stats.worker_queue_depths.reserve(workers_.size());
+    for (const auto& worker : workers_) {
+        stats.worker_queue_depths.push_back(worker->deque.Size());
+    }
+    stats.executed_tasks = executed_tasks_.load(std::memory_order_relaxed);
+    stats.stolen_tasks = stolen_tasks_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool WorkStealingExecutor::TryTakeTask(size_t worker_index, SmallTask*& task) {
+    return workers_[worker_index]->deque.Pop(task) || TryTakeInjected(task) ||
+           TryStealTask(worker_index, task);
+}
+
+bool WorkStealingExecutor::TryStealTask(size_t thief_index, SmallTask*& task) {
+    const size_t count = workers_.size();
+
+    // Start at a pseudo-random victim so thieves spread out
+    size_t start = 0;
+    if (thief_index < count) {
+        uint32_t& seed = workers_[thief_index]->steal_seed;
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        start = seed % count;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        const size_t victim = (start + i) % count;
+        if (victim == thief_index) {
+            continue;
+        }
+        if (workers_[victim]->deque.Steal(task)) {
+            stolen_tasks_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorkStealingExecutor::TryTakeInjected(SmallTask*& task) {
+    std::lock_guard<std::mutex> lock(injection_mutex_);
+    if (injection_queue_.empty()) {
+        return false;
+    }
+    task = injection_queue_.front();
+    injection_queue_.pop_front();
+    return true;
+}
+
+void WorkStealingExecutor::RunTask(SmallTask* task) {
+    pending_tasks_.fetch_sub(1, std::memory_order_relaxed);
+    (*task)();
+    delete task;
+    executed_tasks_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void WorkStealingExecutor::WorkerLoop(size_t worker_index) {
+    current_executor = this;
+    current_worker_index = worker_index;
+
+    while (true) {
+        SmallTask* task = nullptr;
+        if (TryTakeTask(worker_index, task)) {
+            RunTask(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        sleeping_workers_.fetch_add(1, std::memory_order_seq_cst);
+        sleep_cv_.wait(lock, [this]() {
+            return pending_tasks_.load(std::memory_order_seq_cst) > 0 ||
+                   stop_requested_.load();
+        });
+        sleeping_workers_.fetch_sub(1, std::memory_order_relaxed);
+
+        if (stop_requested_.load() && pending_tasks_.load(std::memory_order_seq_cst) == 0) {
+            break;
+        }
+    }
+
+    current_executor = nullptr;
+}
+
+ExecutorTaskGroup::ExecutorTaskGroup(std::shared_ptr<WorkStealingExecutor> executor)
+    : executor_(std::move(executor)) {}
+
+ExecutorTaskGroup::~ExecutorTaskGroup() {
+    Wait();
+}
+
+void ExecutorTaskGroup::Wait() {
+    while (outstanding_.load(std::memory_order_acquire) > 0) {
+        if (executor_->TryRunPendingTask()) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cv_.wait_for(lock, std::chrono::milliseconds(1), [this]() {
+            return outstanding_.load(std::memory_order_acquire) == 0;
+        });
+    }
+
+    // Ensure the last TaskFinished has released the mutex before we return
+    std::lock_guard<std::mutex> lock(mutex_);
+}
+
+void ExecutorTaskGroup::TaskFinished() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (outstanding_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        done_cv_.notify_all();
+    }
+}
+
+} // namespace Core::Multiplayer
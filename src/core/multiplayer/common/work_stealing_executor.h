@@ -0,0 +1,259 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Core::Multiplayer {
+
+/**
+ * Move-only type-erased void() callable with inline storage.
+ *
+ * Callables up to INLINE_SIZE bytes that are nothrow-movable are stored in
+ * place; larger ones fall back to a single heap allocation. Unlike
+ * std::function it accepts move-only callables such as std::packaged_task.
+ */
+class SmallTask {
+public:
+    static constexpr size_t INLINE_SIZE = 48;
+
+    SmallTask() = default;
+
+    template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, SmallTask>>>
+    SmallTask(F&& f) { // NOLINT(google-explicit-constructor)
+        using Callable = std::decay_t<F>;
+        if constexpr (sizeof(Callable) <= INLINE_SIZE &&
+                      alignof(Callable) <= alignof(std::max_align_t) &&
+                      std::is_nothrow_move_constructible_v<Callable>) {
+            new (&storage_) Callable(std::forward<F>(f));
+            vtable_ = &InlineVTable<Callable>;
+        } else {
+            *reinterpret_cast<Callable**>(&storage_) = new Callable(std::forward<F>(f));
+            vtable_ = &HeapVTable<Callable>;
+        }
+    }
+
+    SmallTask(SmallTask&& other) noexcept {
+        MoveFrom(other);
+    }
+
+    SmallTask& operator=(SmallTask&& other) noexcept {
+        if (this != &other) {
+            Reset();
+            MoveFrom(other);
+        }
+        return *this;
+    }
+
+    SmallTask(const SmallTask&) = delete;
+    SmallTask& operator=(const SmallTask&) = delete;
+
+    ~SmallTask() {
+        Reset();
+    }
+
+    explicit operator bool() const { return vtable_ != nullptr; }
+
+    void operator()() {
+        vtable_->invoke(&storage_);
+    }
+
+    /**
+     * Whether the callable lives in the inline buffer
+     */
+    bool IsInline() const { return vtable_ != nullptr && vtable_->is_inline; }
+
+private:
+    struct VTable {
+        void (*invoke)(void* storage);
+        void (*move)(void* destination, void* source);
+        void (*destroy)(void* storage);
+        bool is_inline;
+    };
+
+    template <typename Callable>
+    static inline const VTable InlineVTable{
+        [](void* storage) { (*static_cast<Callable*>(storage))(); },
+        [](void* destination, void* source) {
+            new (destination) Callable(std::move(*static_cast<Callable*>(source)));
+            static_cast<Callable*>(source)->~Callable();
+        },
+        [](void* storage) { static_cast<Callable*>(storage)->~Callable(); },
+        true,
+    };
+
+    template <typename Callable>
+    static inline const VTable HeapVTable{
+        [](void* storage) { (**static_cast<Callable**>(storage))(); },
+        [](void* destination, void* source) {
+            *static_cast<Callable**>(destination) = *static_cast<Callable**>(source);
+        },
+        [](void* storage) { delete *static_cast<Callable**>(storage); },
+        false,
+    };
+
+    void MoveFrom(SmallTask& other) noexcept {
+        if (other.vtable_) {
+            other.vtable_->move(&storage_, &other.storage_);
+            vtable_ = other.vtable_;
+            other.vtable_ = nullptr;
+        }
+    }
+
+    void Reset() {
+        if (vtable_) {
+            vtable_->destroy(&storage_);
+            vtable_ = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char storage_[INLINE_SIZE];
+    const VTable* vtable_ = nullptr;
+};
+
+/**
+ * Executor statistics
+ */
+struct ExecutorStatistics {
+    size_t worker_count = 0;
+    size_t queued_tasks = 0;
+    size_t injection_queue_depth = 0;
+    std::vector<size_t> worker_queue_depths;
+    uint64_t executed_tasks = 0;
+    uint64_t stolen_tasks = 0;
+};
+
+/**
+ * Thread pool with per-worker Chase-Lev deques and work stealing.
+ *
+ * Tasks submitted from a worker go to that worker's own deque and are popped
+ * LIFO without contention; idle workers steal FIFO from the other end. Tasks
+ * submitted from outside the pool go through a shared injection queue. Idle
+ * workers sleep on a condition variable, which submitters only touch when a
+ * worker is actually asleep.
+ *
+ * On destruction every queued task is run before the workers are joined.
+ */
+class WorkStealingExecutor {
+public:
+    explicit WorkStealingExecutor(size_t thread_count = std::thread::hardware_concurrency());
+    ~WorkStealingExecutor();
+
+    WorkStealingExecutor(const WorkStealingExecutor&) = delete;
+    WorkStealingExecutor& operator=(const WorkStealingExecutor&) = delete;
+
+    /**
+     * Process-wide pool shared by the multiplayer components
+     */
+    static std::shared_ptr<WorkStealingExecutor> GetShared();
+
+    /**
+     * Queue a fire-and-forget task
+     * @return False if the executor is shutting down
+     */
+    bool Post(SmallTask task);
+
+    /**
+     * Queue a task and obtain its result through a future
+     */
+    template <typename Func>
+    auto Submit(Func&& f) -> std::future<std::invoke_result_t<Func>> {
+        using ReturnT = std::invoke_result_t<Func>;
+        std::packaged_task<ReturnT()> task(std::forward<Func>(f));
+        auto future = task.get_future();
+        Post(SmallTask(std::move(task)));
+        return future;
+    }
+
+    /**
+     * Run one queued task on the calling thread, if any is available.
+     * Lets a thread that waits on pool work help instead of blocking.
+     * @return True if a task was run
+     */
+    bool TryRunPendingTask();
+
+    size_t GetWorkerCount() const { return workers_.size(); }
+    ExecutorStatistics GetStatistics() const;
+
+private:
+    class WorkDeque;
+    struct Worker;
+
+    bool TryTakeTask(size_t worker_index, SmallTask*& task);
+    bool TryStealTask(size_t thief_index, SmallTask*& task);
+    bool TryTakeInjected(SmallTask*& task);
+    void RunTask(SmallTask* task);
+    void WorkerLoop(size_t worker_index);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    mutable std::mutex injection_mutex_;
+    std::deque<SmallTask*> injection_queue_;
+
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+    std::atomic<size_t> sleeping_workers_{0};
+    std::atomic<size_t> pending_tasks_{0};
+    std::atomic<bool> stop_requested_{false};
+
+    std::atomic<uint64_t> executed_tasks_{0};
+    std::atomic<uint64_t> stolen_tasks_{0};
+};
+
+/**
+ * Tracks tasks one owner submits to a shared executor so the owner can wait
+ * for them before tearing down state they capture. The destructor waits.
+ */
+class ExecutorTaskGroup {
+public:
+    explicit ExecutorTaskGroup(std::shared_ptr<WorkStealingExecutor> executor);
+    ~ExecutorTaskGroup();
+
+    ExecutorTaskGroup(const ExecutorTaskGroup&) = delete;
+    ExecutorTaskGroup& operator=(const ExecutorTaskGroup&) = delete;
+
+    template <typename Func>
+    auto Submit(Func&& f) -> std::future<std::invoke_result_t<Func>> {
+        using ReturnT = std::invoke_result_t<Func>;
+        outstanding_.fetch_add(1, std::memory_order_relaxed);
+        return executor_->Submit(
+            [this, func = std::forward<Func>(f)]() mutable -> ReturnT {
+                struct Completion {
+                    ExecutorTaskGroup* group;
+                    ~Completion() { group->TaskFinished(); }
+                } completion{this};
+                return func();
+            });
+    }
+
+    /**
+     * Block until every task submitted through this group has finished,
+     * running pool work on the calling thread while waiting
+     */
+    void Wait();
+
+    size_t GetOutstandingCount() const { return outstanding_.load(std::memory_order_acquire); }
+
+private:
+    void TaskFinished();
+
+    std::shared_ptr<WorkStealingExecutor> executor_;
+    std::atomic<size_t> outstanding_{0};
+    std::mutex mutex_;
+    std::condition_variable done_cv_;
+};
+
+} // namespace Core::Multiplayer
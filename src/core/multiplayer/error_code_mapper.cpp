@@ -3,10 +3,10 @@
 
 #include "error_code_mapper.h"
 
-#include <algorithm>
 #include <array>
+#include <cstddef>
+#include <optional>
 #include <string_view>
-#include <unordered_map>
 #include <memory>
 
 #include "sudachi/src/core/hle/result.h"
@@ -36,8 +36,13 @@ struct LdnDesc {
   std::string_view description;
 };
 
+// ConfigurationMissing is the last enumerator; the dense tables below are
+// sized from it
+constexpr size_t ERROR_CODE_COUNT =
+    static_cast<size_t>(ErrorCode::ConfigurationMissing) + 1;
+
 // Multiplayer Error -> LDN Result mappings
-constexpr std::array<ErrorToLdn, 40> multiplayer_to_ldn_map_{
+constexpr std::array<ErrorToLdn, ERROR_CODE_COUNT> multiplayer_to_ldn_map_{
     {{ErrorCode::Success, Service::LDN::ResultSuccess},
 
      // Connection errors
@@ -76,6 +81,7 @@ constexpr std::array<ErrorToLdn, 40> multiplayer_to_ldn_map_{
      {ErrorCode::SSLError, Service::LDN::ResultConnectionFailed},
      {ErrorCode::Timeout, Service::LDN::ResultAuthenticationTimeout},
      {ErrorCode::NotSupported, Service::LDN::ResultDisabled},
+     {ErrorCode::NotImplemented, Service::LDN::ResultDisabled},
      {ErrorCode::PermissionDenied,
       Service::LDN::ResultAccessPointConnectionFailed},
 
@@ -107,7 +113,7 @@ constexpr std::array<ErrorToLdn, 40> multiplayer_to_ldn_map_{
      {ErrorCode::ConfigurationMissing, Service::LDN::ResultBadInput}}};
 
 // Reverse mapping from LDN Result -> Multiplayer Error
-constexpr std::array<LdnToError, 13> ldn_to_multiplayer_map_{
+constexpr std::array<LdnToError, 18> ldn_to_multiplayer_map_{
     {{Service::LDN::ResultSuccess, ErrorCode::Success},
      {Service::LDN::ResultConnectionFailed, ErrorCode::ConnectionFailed},
      {Service::LDN::ResultAuthenticationTimeout, ErrorCode::ConnectionTimeout},
@@ -123,10 +129,17 @@ constexpr std::array<LdnToError, 13> ldn_to_multiplayer_map_{
      {Service::LDN::ResultInternalError, ErrorCode::InternalError},
      {Service::LDN::ResultDisabled, ErrorCode::NotSupported},
      {Service::LDN::ResultAccessPointConnectionFailed,
-      ErrorCode::PermissionDenied}}};
+      ErrorCode::PermissionDenied},
+     {Service::LDN::ResultAirplaneModeEnabled, ErrorCode::ServiceUnavailable},
+     {Service::LDN::ResultInvalidNodeCount, ErrorCode::InvalidParameter},
+     {Service::LDN::ResultNoIpAddress, ErrorCode::NetworkError},
+     {Service::LDN::ResultLocalCommunicationVersionTooLow,
+      ErrorCode::ProtocolError},
+     {Service::LDN::ResultLocalCommunicationVersionTooHigh,
+      ErrorCode::ProtocolError}}};
 
 // Human readable descriptions for multiplayer errors
-constexpr std::array<ErrorDesc, 40> error_descriptions_{
+constexpr std::array<ErrorDesc, ERROR_CODE_COUNT> error_descriptions_{
     {{ErrorCode::Success, "Operation completed successfully"},
      {ErrorCode::ConnectionFailed, "Failed to establish network connection"},
      {ErrorCode::ConnectionTimeout, "Connection attempt timed out"},
@@ -156,6 +169,7 @@ constexpr std::array<ErrorDesc, 40> error_descriptions_{
      {ErrorCode::SSLError, "SSL/TLS encryption error"},
      {ErrorCode::Timeout, "Operation timed out"},
      {ErrorCode::NotSupported, "Operation not supported on this platform"},
+     {ErrorCode::NotImplemented, "Operation not implemented"},
      {ErrorCode::PermissionDenied, "Permission denied for requested operation"},
      {ErrorCode::NotInitialized, "System not initialized"},
      {ErrorCode::InvalidState, "System is in invalid state for this operation"},
@@ -198,55 +212,168 @@ constexpr std::array<LdnDesc, 18> ldn_result_descriptions_{
       "Local communication version too high"},
      {Service::LDN::ResultInternalError, "Internal LDN error occurred"}}};
 
-// Helper to build unordered_maps for fast lookups
-const std::unordered_map<ErrorCode, Service::LDN::Result>& GetMultiplayerToLdnMap() {
-  static const std::unordered_map<ErrorCode, Service::LDN::Result> map = [] {
-    std::unordered_map<ErrorCode, Service::LDN::Result> m;
-    m.reserve(multiplayer_to_ldn_map_.size());
-    for (const auto& e : multiplayer_to_ldn_map_) {
-      m.emplace(e.error, e.result);
-    }
-    return m;
-  }();
-  return map;
+constexpr size_t ToIndex(ErrorCode error) {
+  return static_cast<size_t>(error);
 }
 
-const std::unordered_map<Service::LDN::Result, ErrorCode>& GetLdnToMultiplayerMap() {
-  static const std::unordered_map<Service::LDN::Result, ErrorCode> map = [] {
-    std::unordered_map<Service::LDN::Result, ErrorCode> m;
-    m.reserve(ldn_to_multiplayer_map_.size());
-    for (const auto& e : ldn_to_multiplayer_map_) {
-      m.emplace(e.result, e.error);
-    }
-    return m;
-  }();
-  return map;
+// Every LDN result shares one module, so the description alone is a dense
+// key; Success sits at description 0, which no LDN error uses
+constexpr auto LDN_MODULE = Service::LDN::ResultConnectionFailed.GetModule();
+
+constexpr std::optional<size_t> LdnSlot(Service::LDN::Result result) {
+  if (result == Service::LDN::ResultSuccess) {
+    return 0;
+  }
+  if (result.GetModule() != LDN_MODULE) {
+    return std::nullopt;
+  }
+  return static_cast<size_t>(result.GetDescription());
 }
 
-const std::unordered_map<ErrorCode, std::string_view>& GetErrorDescriptions() {
-  static const std::unordered_map<ErrorCode, std::string_view> map = [] {
-    std::unordered_map<ErrorCode, std::string_view> m;
-    m.reserve(error_descriptions_.size());
-    for (const auto& e : error_descriptions_) {
-      m.emplace(e.error, e.description);
+constexpr size_t LDN_SLOT_COUNT = [] {
+  size_t count = 0;
+  for (const auto& e : ldn_result_descriptions_) {
+    const auto slot = LdnSlot(e.result);
+    if (slot && *slot + 1 > count) {
+      count = *slot + 1;
+    }
+  }
+  return count;
+}();
+
+// Dense tables, built at compile time from the lists above. Each is
+// total: a code missing from its list fails the static_asserts below.
+template <typename T, size_t N>
+struct DenseTable {
+  std::array<T, N> values{};
+  std::array<bool, N> present{};
+  bool duplicate = false;
+
+  constexpr void Set(std::optional<size_t> slot, T value) {
+    if (!slot || *slot >= N) {
+      duplicate = true; // Unreachable slot, reported with the duplicates
+      return;
+    }
+    duplicate |= present[*slot];
+    present[*slot] = true;
+    values[*slot] = value;
+  }
+};
+
+constexpr auto multiplayer_to_ldn_table_ = [] {
+  DenseTable<Service::LDN::Result, ERROR_CODE_COUNT> table;
+  for (const auto& e : multiplayer_to_ldn_map_) {
+    table.Set(ToIndex(e.error), e.result);
+  }
+  return table;
+}();
+
+constexpr auto error_description_table_ = [] {
+  DenseTable<std::string_view, ERROR_CODE_COUNT> table;
+  for (const auto& e : error_descriptions_) {
+    table.Set(ToIndex(e.error), e.description);
+  }
+  return table;
+}();
+
+constexpr auto ldn_to_multiplayer_table_ = [] {
+  DenseTable<ErrorCode, LDN_SLOT_COUNT> table;
+  for (const auto& e : ldn_to_multiplayer_map_) {
+    table.Set(LdnSlot(e.result), e.error);
+  }
+  return table;
+}();
+
+constexpr auto ldn_description_table_ = [] {
+  DenseTable<std::string_view, LDN_SLOT_COUNT> table;
+  for (const auto& e : ldn_result_descriptions_) {
+    table.Set(LdnSlot(e.result), e.description);
+  }
+  return table;
+}();
+
+template <typename Table>
+constexpr bool CoversEveryErrorCode(const Table& table) {
+  for (bool present : table.present) {
+    if (!present) {
+      return false;
     }
-    return m;
-  }();
-  return map;
+  }
+  return !table.duplicate;
 }
 
-const std::unordered_map<Service::LDN::Result, std::string_view>& GetLdnResultDescriptions() {
-  static const std::unordered_map<Service::LDN::Result, std::string_view> map = [] {
-    std::unordered_map<Service::LDN::Result, std::string_view> m;
-    m.reserve(ldn_result_descriptions_.size());
-    for (const auto& e : ldn_result_descriptions_) {
-      m.emplace(e.result, e.description);
+// Every described LDN result must also map back to an ErrorCode
+constexpr bool MapsEveryLdnResult() {
+  for (const auto& e : ldn_result_descriptions_) {
+    const auto slot = LdnSlot(e.result);
+    if (!slot || !ldn_to_multiplayer_table_.present[*slot]) {
+      return false;
     }
-    return m;
-  }();
-  return map;
+  }
+  return !ldn_to_multiplayer_table_.duplicate && !ldn_description_table_.duplicate;
 }
 
+static_assert(CoversEveryErrorCode(multiplayer_to_ldn_table_),
+              "every ErrorCode needs exactly one LDN result mapping");
+static_assert(CoversEveryErrorCode(error_description_table_),
+              "every ErrorCode needs exactly one description");
+static_assert(MapsEveryLdnResult(),
+              "every described LDN result needs exactly one ErrorCode mapping");
+
+constexpr Service::LDN::Result ToLdnResult(ErrorCode error) noexcept {
+  const size_t index = ToIndex(error);
+  return index < ERROR_CODE_COUNT ? multiplayer_to_ldn_table_.values[index]
+                                  : Service::LDN::ResultInternalError;
+}
+
+constexpr ErrorCode FromLdnResult(Service::LDN::Result result) noexcept {
+  const auto slot = LdnSlot(result);
+  if (slot && *slot < LDN_SLOT_COUNT && ldn_to_multiplayer_table_.present[*slot]) {
+    return ldn_to_multiplayer_table_.values[*slot];
+  }
+  return ErrorCode::InternalError;
+}
+
+constexpr bool IsRecoverableError(ErrorCode error) noexcept {
+  // Define which errors are recoverable (can be retried)
+  switch (error) {
+  case ErrorCode::NetworkTimeout:
+  case ErrorCode::ConnectionTimeout:
+  case ErrorCode::HostUnreachable:
+  case ErrorCode::ServiceUnavailable:
+  case ErrorCode::ResourceExhausted:
+    return true;
+
+  default:
+    return false; // Conservative approach
+  }
+}
+
+constexpr std::chrono::milliseconds RetryDelayFor(ErrorCode error) noexcept {
+  // Return appropriate retry delays based on error type
+  switch (error) {
+  case ErrorCode::NetworkTimeout:
+  case ErrorCode::ConnectionTimeout:
+    return std::chrono::milliseconds(1000); // 1 second
+
+  case ErrorCode::HostUnreachable:
+    return std::chrono::milliseconds(5000); // 5 seconds
+
+  case ErrorCode::ServiceUnavailable:
+    return std::chrono::milliseconds(2000); // 2 seconds
+
+  case ErrorCode::ResourceExhausted:
+    return std::chrono::milliseconds(3000); // 3 seconds
+
+  default:
+    return std::chrono::milliseconds(0); // No retry
+  }
+}
+
+static_assert(ToLdnResult(ErrorCode::RoomFull) == Service::LDN::ResultMaximumNodeCount);
+static_assert(FromLdnResult(Service::LDN::ResultBadInput) == ErrorCode::InvalidMessage);
+static_assert(FromLdnResult(ToLdnResult(ErrorCode::Success)) == ErrorCode::Success);
+
 } // namespace
 
 /**
@@ -256,90 +383,41 @@ class ConcreteErrorCodeMapper : public ErrorCodeMapper {
 public:
   ConcreteErrorCodeMapper() = default;
 
-  Service::LDN::Result MapToLdnResult(ErrorCode error) override {
-    const auto& map = GetMultiplayerToLdnMap();
-    auto it = map.find(error);
-    if (it != map.end()) {
-      return it->second;
-    }
-    return Service::LDN::ResultInternalError;
+  Service::LDN::Result MapToLdnResult(ErrorCode error) noexcept override {
+    return ToLdnResult(error);
   }
 
-  ErrorCode MapFromLdnResult(Service::LDN::Result result) override {
-    const auto& map = GetLdnToMultiplayerMap();
-    auto it = map.find(result);
-    if (it != map.end()) {
-      return it->second;
-    }
-    return ErrorCode::InternalError;
+  ErrorCode MapFromLdnResult(Service::LDN::Result result) noexcept override {
+    return FromLdnResult(result);
   }
 
   std::string GetErrorDescription(ErrorCode error) override {
-    const auto& map = GetErrorDescriptions();
-    auto it = map.find(error);
-    if (it != map.end()) {
-      return std::string{it->second};
+    const size_t index = ToIndex(error);
+    if (index < ERROR_CODE_COUNT) {
+      return std::string{error_description_table_.values[index]};
     }
     return "Unknown multiplayer error";
   }
 
   std::string GetLdnResultDescription(Service::LDN::Result result) override {
-    const auto& map = GetLdnResultDescriptions();
-    auto it = map.find(result);
-    if (it != map.end()) {
-      return std::string{it->second};
+    const auto slot = LdnSlot(result);
+    if (slot && *slot < LDN_SLOT_COUNT && ldn_description_table_.present[*slot]) {
+      return std::string{ldn_description_table_.values[*slot]};
     }
     return "Unknown LDN result";
   }
 
-  bool IsRecoverable(ErrorCode error) override {
-    // Define which errors are recoverable (can be retried)
-    switch (error) {
-    case ErrorCode::NetworkTimeout:
-    case ErrorCode::ConnectionTimeout:
-    case ErrorCode::HostUnreachable:
-    case ErrorCode::ServiceUnavailable:
-    case ErrorCode::ResourceExhausted:
-      return true;
-
-    case ErrorCode::Success:
-    case ErrorCode::AuthenticationFailed:
-    case ErrorCode::InvalidParameter:
-    case ErrorCode::ConfigurationInvalid:
-    case ErrorCode::NotSupported:
-    case ErrorCode::PermissionDenied:
-      return false;
-
-    default:
-      return false; // Conservative approach
-    }
+  bool IsRecoverable(ErrorCode error) noexcept override {
+    return IsRecoverableError(error);
   }
 
-  bool IsRecoverable(Service::LDN::Result result) override {
+  bool IsRecoverable(Service::LDN::Result result) noexcept override {
     // Map LDN result to multiplayer error and check recoverability
-    auto error = MapFromLdnResult(result);
-    return IsRecoverable(error);
+    return IsRecoverableError(FromLdnResult(result));
   }
 
-  std::chrono::milliseconds GetRetryDelay(ErrorCode error) override {
-    // Return appropriate retry delays based on error type
-    switch (error) {
-    case ErrorCode::NetworkTimeout:
-    case ErrorCode::ConnectionTimeout:
-      return std::chrono::milliseconds(1000); // 1 second
-
-    case ErrorCode::HostUnreachable:
-      return std::chrono::milliseconds(5000); // 5 seconds
-
-    case ErrorCode::ServiceUnavailable:
-      return std::chrono::milliseconds(2000); // 2 seconds
-
-    case ErrorCode::ResourceExhausted:
-      return std::chrono::milliseconds(3000); // 3 seconds
-
-    default:
-      return std::chrono::milliseconds(0); // No retry
-    }
+  std::chrono::milliseconds GetRetryDelay(ErrorCode error) noexcept override {
+    return RetryDelayFor(error);
   }
 };
 
@@ -0,0 +1,436 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "hybrid_router.h"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <utility>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <iphlpapi.h>
+#pragma comment(lib, "iphlpapi.lib")
+#else
+#include <arpa/inet.h>
+#include <ifaddrs.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#endif
+
+namespace Core::Multiplayer::HLE {
+
+namespace {
+
+// Probe: kind, whether the sender hears the receiver, session tag (LE)
+constexpr uint8_t PROBE_KIND = 1;
+constexpr size_t PROBE_SIZE = 10;
+
+ModelB::AdHocDataPlaneConfig UnicastOnly(ModelB::AdHocDataPlaneConfig config) {
+    config.use_multicast = false;
+    return config;
+}
+
+bool ParseNumber(std::string_view text, uint32_t max, uint32_t& out) {
+    const char* end = text.data() + text.size();
+    const auto [next, error] = std::from_chars(text.data(), end, out);
+    return error == std::errc{} && next == end && !text.empty() && out <= max;
+}
+
+} // namespace
+
+std::optional<uint32_t> ParseIpv4(std::string_view address) {
+    uint32_t result = 0;
+    for (int part = 0; part < 4; ++part) {
+        const size_t dot = part < 3 ? address.find('.') : address.size();
+        uint32_t octet = 0;
+        if (dot == std::string_view::npos || !ParseNumber(address.substr(0, dot), 255, octet)) {
+            return std::nullopt;
+        }
+        result = (result << 8) | octet;
+        address.remove_prefix(std::min(dot + 1, address.size()));
+    }
+    return result;
+}
+
+std::optional<Ipv4Subnet> Ipv4Subnet::Parse(std::string_view cidr) {
+    const size_t slash = cidr.find('/');
+    const auto address = ParseIpv4(cidr.substr(0, slash));
+    if (!address) {
+        return std::nullopt;
+    }
+    uint32_t prefix_length = 32;
+    if (slash != std::string_view::npos &&
+        !ParseNumber(cidr.substr(slash + 1), 32, prefix_length)) {
+        return std::nullopt;
+    }
+    return Ipv4Subnet{*address, static_cast<uint8_t>(prefix_length)};
+}
+
+bool Ipv4Subnet::Contains(uint32_t other) const {
+    const uint32_t mask = prefix_length == 0 ? 0 : ~uint32_t{0} << (32 - prefix_length);
+    return (address & mask) == (other & mask);
+}
+
+std::vector<Ipv4Subnet> DetectLocalSubnets() {
+    std::vector<Ipv4Subnet> subnets;
+#ifdef _WIN32
+    ULONG size = 16 * 1024;
+    std::vector<uint8_t> buffer(size);
+    constexpr ULONG flags =
+        GAA_FLAG_SKIP_ANYCAST | GAA_FLAG_SKIP_MULTICAST | GAA_FLAG_SKIP_DNS_SERVER;
+    ULONG result = GetAdaptersAddresses(
+        AF_INET, flags, nullptr, reinterpret_cast<IP_ADAPTER_ADDRESSES*>(buffer.data()), &size);
+    if (result == ERROR_BUFFER_OVERFLOW) {
+        buffer.resize(size);
+        result = GetAdaptersAddresses(AF_INET, flags, nullptr,
+                                      reinterpret_cast<IP_ADAPTER_ADDRESSES*>(buffer.data()),
+                                      &size);
+    }
+    if (result != NO_ERROR) {
+        return subnets;
+    }
+    for (auto* adapter = reinterpret_cast<IP_ADAPTER_ADDRESSES*>(buffer.data());
+         adapter != nullptr; adapter = adapter->Next) {
+        if (adapter->OperStatus != IfOperStatusUp ||
+            adapter->IfType == IF_TYPE_SOFTWARE_LOOPBACK) {
+            continue;
+        }
+        for (auto* unicast = adapter->FirstUnicastAddress; unicast != nullptr;
+             unicast = unicast->Next) {
+            const auto* address = reinterpret_cast<const sockaddr_in*>(
+                unicast->Address.lpSockaddr);
+            if (address->sin_family == AF_INET) {
+                subnets.push_back({ntohl(address->sin_addr.s_addr),
+                                   static_cast<uint8_t>(unicast->OnLinkPrefixLength)});
+            }
+        }
+    }
+#else
+    ifaddrs* interfaces = nullptr;
+    if (getifaddrs(&interfaces) != 0) {
+        return subnets;
+    }
+    for (const ifaddrs* entry = interfaces; entry != nullptr; entry = entry->ifa_next) {
+        if (entry->ifa_addr == nullptr || entry->ifa_netmask == nullptr ||
+            entry->ifa_addr->sa_family != AF_INET || (entry->ifa_flags & IFF_UP) == 0 ||
+            (entry->ifa_flags & IFF_LOOPBACK) != 0) {
+            continue;
+        }
+        const auto* address = reinterpret_cast<const sockaddr_in*>(entry->ifa_addr);
+        const auto* netmask = reinterpret_cast<const sockaddr_in*>(entry->ifa_netmask);
+        subnets.push_back({ntohl(address->sin_addr.s_addr),
+                           static_cast<uint8_t>(std::popcount(ntohl(netmask->sin_addr.s_addr)))});
+    }
+    freeifaddrs(interfaces);
+#endif
+    return subnets;
+}
+
+HybridRouter::HybridRouter(ModelA::ModelABackend& backend, HybridRouterConfig config,
+                           std::shared_ptr<TimerWheel> timer_wheel)
+    : backend_(backend), config_(std::move(config)),
+      timer_wheel_(timer_wheel ? std::move(timer_wheel) : TimerWheel::GetShared()),
+      lan_(UnicastOnly(config_.lan)),
+      local_subnets_(config_.local_subnets.empty() ? DetectLocalSubnets()
+                                                   : config_.local_subnets) {}
+
+HybridRouter::~HybridRouter() {
+    Stop();
+}
+
+ErrorCode HybridRouter::Start(uint8_t local_node_id, uint64_t session_tag,
+                              ModelA::ModelABackend::PacketSender internet_sender,
+                              ModelA::ModelABackend::BroadcastSender internet_broadcast,
+                              ModelA::ModelABackend::LatestValueSender internet_latest) {
+    if (running_.load(std::memory_order_acquire)) {
+        return ErrorCode::InvalidState;
+    }
+    if (!internet_sender) {
+        return ErrorCode::InvalidParameter;
+    }
+    ErrorCode result = lan_.Open(local_node_id);
+    if (result != ErrorCode::Success) {
+        return result;
+    }
+    local_node_id_ = local_node_id;
+    session_tag_ = session_tag;
+    result = lan_.Start(
+        [this](uint8_t node_id, const uint8_t* data, size_t size) {
+            OnLanPacket(node_id, data, size);
+        },
+        [this](uint8_t node_id, const uint8_t* data, size_t size) {
+            OnLanControl(node_id, data, size);
+        });
+    if (result != ErrorCode::Success) {
+        lan_.Close();
+        return result;
+    }
+
+    internet_sender_ = std::move(internet_sender);
+    internet_broadcast_ = std::move(internet_broadcast);
+    internet_latest_ = std::move(internet_latest);
+    backend_.SetPacketSender([this](uint8_t node_id, const uint8_t* data, size_t size,
+                                    SendPriority priority) {
+        return SendPacket(node_id, data, size, priority);
+    });
+    if (internet_broadcast_) {
+        backend_.SetBroadcastSender([this](uint8_t destination_mask, const uint8_t* data,
+                                           size_t size, SendPriority priority) {
+            return SendBroadcast(destination_mask, data, size, priority);
+        });
+    }
+    if (internet_latest_) {
+        backend_.SetLatestValueSender([this](uint8_t node_id, const uint8_t* data, size_t size,
+                                             SendPriority priority, uint64_t key) {
+            return SendLatest(node_id, data, size, priority, key);
+        });
+    } else {
+        // Keyed packets would otherwise skip the LAN
+        backend_.SetLatestValueSender(nullptr);
+    }
+    running_.store(true, std::memory_order_release);
+    probe_timer_ = timer_wheel_->ScheduleRepeating(config_.probe_interval, [this] { ProbeNodes(); });
+    return ErrorCode::Success;
+}
+
+void HybridRouter::Stop() {
+    if (!running_.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+    timer_wheel_->Cancel(probe_timer_);
+    probe_timer_ = TimerWheel::INVALID_TIMER_ID;
+    backend_.SetPacketSender(internet_sender_);
+    if (internet_broadcast_) {
+        backend_.SetBroadcastSender(internet_broadcast_);
+    }
+    backend_.SetLatestValueSender(internet_latest_);
+    lan_.Close();
+    for (Node& node : nodes_) {
+        node.state.store(NodeState::Internet, std::memory_order_release);
+        node.last_heard_ns.store(0, std::memory_order_relaxed);
+    }
+}
+
+bool HybridRouter::IsRunning() const {
+    return running_.load(std::memory_order_acquire);
+}
+
+bool HybridRouter::ReportNodeCandidates(uint8_t node_id,
+                                        const std::vector<std::string>& addresses) {
+    if (node_id >= MAX_NODES) {
+        return false;
+    }
+    for (const std::string& candidate : addresses) {
+        const auto address = ParseIpv4(candidate);
+        if (!address) {
+            continue;
+        }
+        const auto is_own = [&](const Ipv4Subnet& subnet) { return subnet.address == *address; };
+        const auto is_local = [&](const Ipv4Subnet& subnet) { return subnet.Contains(*address); };
+        if (std::any_of(local_subnets_.begin(), local_subnets_.end(), is_own) ||
+            std::none_of(local_subnets_.begin(), local_subnets_.end(), is_local)) {
+            continue;
+        }
+        DatagramEndpoint endpoint;
+        if (DatagramEndpoint::FromString(candidate, config_.lan.port, endpoint)) {
+            ReportLanEndpoint(node_id, endpoint);
+            return true;
+        }
+    }
+    return false;
+}
+
+void HybridRouter::ReportLanEndpoint(uint8_t node_id, const DatagramEndpoint& endpoint) {
+    if (node_id >= MAX_NODES || !endpoint.IsValid() ||
+        (IsRunning() && node_id == local_node_id_)) {
+        return;
+    }
+    lan_.SetNodeEndpoint(node_id, endpoint);
+    NodeState expected = NodeState::Internet;
+    nodes_[node_id].state.compare_exchange_strong(expected, NodeState::Candidate,
+                                                  std::memory_order_acq_rel);
+}
+
+void HybridRouter::RemoveNode(uint8_t node_id) {
+    if (node_id >= MAX_NODES) {
+        return;
+    }
+    nodes_[node_id].state.store(NodeState::Internet, std::memory_order_release);
+    nodes_[node_id].last_heard_ns.store(0, std::memory_order_relaxed);
+    lan_.RemoveNode(node_id);
+}
+
+bool HybridRouter::IsLocal(uint8_t node_id) const {
+    return node_id < MAX_NODES &&
+           nodes_[node_id].state.load(std::memory_order_acquire) == NodeState::Local;
+}
+
+DatagramEndpoint HybridRouter::GetLanEndpoint() const {
+    return lan_.GetLocalEndpoint();
+}
+
+HybridRouterStatistics HybridRouter::GetStatistics() const {
+    HybridRouterStatistics statistics;
+    statistics.lan_packets_sent = lan_sent_.load(std::memory_order_relaxed);
+    statistics.internet_packets_sent = internet_sent_.load(std::memory_order_relaxed);
+    statistics.lan_packets_received = lan_received_.load(std::memory_order_relaxed);
+    statistics.lan_send_failures = lan_send_failures_.load(std::memory_order_relaxed);
+    statistics.lan_fallbacks = lan_fallbacks_.load(std::memory_order_relaxed);
+    for (uint8_t node_id = 0; node_id < MAX_NODES; ++node_id) {
+        statistics.lan_nodes += IsLocal(node_id) ? 1 : 0;
+    }
+    return statistics;
+}
+
+ErrorCode HybridRouter::SendPacket(uint8_t node_id, const uint8_t* data, size_t size,
+                                   SendPriority priority) {
+    if (IsLocal(node_id)) {
+        ErrorCode result;
+        {
+            std::lock_guard<std::mutex> lock(send_mutex_);
+            result = lan_.Send(node_id, data, size);
+            if (result == ErrorCode::Success) {
+                result = lan_.Flush();
+            }
+        }
+        if (result == ErrorCode::Success) {
+            lan_sent_.fetch_add(1, std::memory_order_relaxed);
+            return result;
+        }
+        lan_send_failures_.fetch_add(1, std::memory_order_relaxed);
+    }
+    const ErrorCode result = internet_sender_(node_id, data, size, priority);
+    if (result == ErrorCode::Success) {
+        internet_sent_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return result;
+}
+
+ErrorCode HybridRouter::SendLatest(uint8_t node_id, const uint8_t* data, size_t size,
+                                   SendPriority priority, uint64_t key) {
+    if (IsLocal(node_id)) {
+        return SendPacket(node_id, data, size, priority);
+    }
+    const ErrorCode result = internet_latest_(node_id, data, size, priority, key);
+    if (result == ErrorCode::Success) {
+        internet_sent_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return result;
+}
+
+ErrorCode HybridRouter::SendBroadcast(uint8_t destination_mask, const uint8_t* data, size_t size,
+                                      SendPriority priority) {
+    uint8_t lan_mask = 0;
+    for (uint8_t node_id = 0; node_id < MAX_NODES; ++node_id) {
+        if ((destination_mask & (1u << node_id)) != 0 && IsLocal(node_id)) {
+            lan_mask |= static_cast<uint8_t>(1u << node_id);
+        }
+    }
+    if (lan_mask != 0) {
+        bool sent = true;
+        {
+            std::lock_guard<std::mutex> lock(send_mutex_);
+            for (uint8_t node_id = 0; node_id < MAX_NODES && sent; ++node_id) {
+                if ((lan_mask & (1u << node_id)) != 0) {
+                    sent = lan_.Send(node_id, data, size) == ErrorCode::Success;
+                }
+            }
+            sent = lan_.Flush() == ErrorCode::Success && sent;
+        }
+        if (sent) {
+            lan_sent_.fetch_add(static_cast<uint64_t>(std::popcount(lan_mask)),
+                                std::memory_order_relaxed);
+            destination_mask &= static_cast<uint8_t>(~lan_mask);
+        } else {
+            // The relay copy reaches every node even if some LAN copy went out
+            lan_send_failures_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    if (destination_mask == 0) {
+        return ErrorCode::Success;
+    }
+    const ErrorCode result = internet_broadcast_(destination_mask, data, size, priority);
+    if (result == ErrorCode::Success) {
+        internet_sent_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return result;
+}
+
+void HybridRouter::OnLanPacket(uint8_t node_id, const uint8_t* data, size_t size) {
+    Node& node = nodes_[node_id];
+    // Only nodes whose probes carried this session's tag are listened to
+    if (node.state.load(std::memory_order_acquire) == NodeState::Internet ||
+        node.last_heard_ns.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+    node.last_heard_ns.store(ModelB::AdHocDataPlane::Now(), std::memory_order_relaxed);
+    // The sender only uses the LAN once it knows we hear it
+    NodeState expected = NodeState::Candidate;
+    node.state.compare_exchange_strong(expected, NodeState::Local, std::memory_order_acq_rel);
+    lan_received_.fetch_add(1, std::memory_order_relaxed);
+    backend_.DeliverPacket(node_id, data, size);
+}
+
+void HybridRouter::OnLanControl(uint8_t node_id, const uint8_t* data, size_t size) {
+    if (size != PROBE_SIZE || data[0] != PROBE_KIND) {
+        return;
+    }
+    uint64_t tag = 0;
+    for (size_t i = 0; i < sizeof(tag); ++i) {
+        tag |= uint64_t{data[2 + i]} << (8 * i);
+    }
+    Node& node = nodes_[node_id];
+    if (tag != session_tag_ || node.state.load(std::memory_order_acquire) == NodeState::Internet) {
+        return;
+    }
+    node.last_heard_ns.store(ModelB::AdHocDataPlane::Now(), std::memory_order_relaxed);
+    const bool heard_by_peer = data[1] != 0;
+    if (heard_by_peer) {
+        NodeState expected = NodeState::Candidate;
+        node.state.compare_exchange_strong(expected, NodeState::Local, std::memory_order_acq_rel);
+    } else {
+        // Answer right away rather than a probe interval later
+        std::lock_guard<std::mutex> lock(send_mutex_);
+        SendProbeLocked(node_id, true);
+        (void)lan_.Flush();
+    }
+}
+
+void HybridRouter::ProbeNodes() {
+    const uint64_t now = ModelB::AdHocDataPlane::Now();
+    std::lock_guard<std::mutex> lock(send_mutex_);
+    for (uint8_t node_id = 0; node_id < MAX_NODES; ++node_id) {
+        Node& node = nodes_[node_id];
+        if (node.state.load(std::memory_order_acquire) == NodeState::Internet) {
+            continue;
+        }
+        const bool heard = IsHeard(node, now);
+        NodeState expected = NodeState::Local;
+        if (!heard && node.state.compare_exchange_strong(expected, NodeState::Candidate,
+                                                         std::memory_order_acq_rel)) {
+            lan_fallbacks_.fetch_add(1, std::memory_order_relaxed);
+        }
+        SendProbeLocked(node_id, heard);
+    }
+    (void)lan_.Flush();
+}
+
+void HybridRouter::SendProbeLocked(uint8_t node_id, bool heard) {
+    std::array<uint8_t, PROBE_SIZE> probe{PROBE_KIND, static_cast<uint8_t>(heard ? 1 : 0)};
+    for (size_t i = 0; i < sizeof(session_tag_); ++i) {
+        probe[2 + i] = static_cast<uint8_t>(session_tag_ >> (8 * i));
+    }
+    (void)lan_.SendControl(node_id, probe.data(), probe.size());
+}
+
+bool HybridRouter::IsHeard(const Node& node, uint64_t now_ns) const {
+    const uint64_t last = node.last_heard_ns.load(std::memory_order_relaxed);
+    const auto timeout_ns = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(config_.lan_timeout).count());
+    return last != 0 && now_ns - last < timeout_ns;
+}
+
+} // namespace Core::Multiplayer::HLE
@@ -0,0 +1,172 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "common/timer_wheel.h"
+#include "model_a/model_a_backend.h"
+#include "model_b/adhoc_data_plane.h"
+
+namespace Core::Multiplayer::HLE {
+
+// Host byte order, e.g. 0xC0A80001 for 192.168.0.1
+std::optional<uint32_t> ParseIpv4(std::string_view address);
+
+/**
+ * A local interface address and its prefix, e.g. 192.168.1.20/24
+ */
+struct Ipv4Subnet {
+    uint32_t address = 0;
+    uint8_t prefix_length = 32;
+
+    static std::optional<Ipv4Subnet> Parse(std::string_view cidr);
+    bool Contains(uint32_t other) const;
+};
+
+// Subnets of the host's IPv4 interfaces that are up, loopback excluded
+std::vector<Ipv4Subnet> DetectLocalSubnets();
+
+struct HybridRouterConfig {
+    // Unicast only: other sessions may share the LAN and the group
+    ModelB::AdHocDataPlaneConfig lan;
+    // Candidates in these subnets are probed over the LAN; empty detects
+    // them from the host's interfaces
+    std::vector<Ipv4Subnet> local_subnets;
+    std::chrono::milliseconds probe_interval{250};
+    // A LAN node not heard from for this long goes back to the internet path
+    std::chrono::milliseconds lan_timeout{2000};
+};
+
+struct HybridRouterStatistics {
+    uint64_t lan_packets_sent = 0;
+    uint64_t internet_packets_sent = 0;
+    uint64_t lan_packets_received = 0;
+    // LAN sends that failed and went out over the internet instead
+    uint64_t lan_send_failures = 0;
+    // Times a LAN node timed out and went back to the internet path
+    uint64_t lan_fallbacks = 0;
+    size_t lan_nodes = 0;
+};
+
+/**
+ * Sends the packets of an internet session to the nodes on this host's
+ * local network over Model B's ad-hoc data plane, and everything else
+ * through Model A's transport, keeping Model A's node ids for both.
+ *
+ * It sits between ModelABackend and its packet sender, so delta coding,
+ * FEC and statistics stay the backend's, whichever path a packet takes,
+ * and LAN packets go to DeliverPacket like the transport's.
+ *
+ * A node becomes a LAN candidate when one of its host candidates, e.g. the
+ * room's network_info.local_ip, lies in a local subnet, or when
+ * MdnsDiscovery resolved it. Same-subnet addresses are not proof of the
+ * same network, so candidates are probed and a node is only sent to over
+ * the LAN once probes went both ways. Probes carry a session tag, so nodes
+ * of another session on the LAN are never taken for this one's. A LAN node
+ * that goes quiet falls back to the internet path and is probed again.
+ */
+class HybridRouter {
+public:
+    explicit HybridRouter(ModelA::ModelABackend& backend, HybridRouterConfig config = {},
+                          std::shared_ptr<TimerWheel> timer_wheel = nullptr);
+    ~HybridRouter();
+
+    HybridRouter(const HybridRouter&) = delete;
+    HybridRouter& operator=(const HybridRouter&) = delete;
+
+    /**
+     * Opens the LAN path and installs itself as the backend's packet
+     * sender, and broadcast and latest value senders if they are given.
+     * State packets to local nodes go out over the LAN at once, so only
+     * internet ones reach the keyed sender.
+     * @param session_tag The same on every node of the session, e.g. a hash
+     *                    of the room id
+     * @return The data plane's error if the LAN path could not be opened;
+     *         the backend's senders are then left alone
+     */
+    [[nodiscard]] ErrorCode Start(uint8_t local_node_id, uint64_t session_tag,
+                                  ModelA::ModelABackend::PacketSender internet_sender,
+                                  ModelA::ModelABackend::BroadcastSender internet_broadcast = nullptr,
+                                  ModelA::ModelABackend::LatestValueSender internet_latest = nullptr);
+    // Gives the backend its internet senders back
+    void Stop();
+    bool IsRunning() const;
+
+    /**
+     * A node's host candidates, as IPv4 address strings
+     * @return True if one lies in a local subnet and is being probed
+     */
+    bool ReportNodeCandidates(uint8_t node_id, const std::vector<std::string>& addresses);
+    // A node's LAN endpoint, e.g. from the hosts MdnsDiscovery resolved
+    void ReportLanEndpoint(uint8_t node_id, const DatagramEndpoint& endpoint);
+    // For the backend's ReportNodeLeft
+    void RemoveNode(uint8_t node_id);
+
+    // True while the node is sent to over the LAN
+    bool IsLocal(uint8_t node_id) const;
+    DatagramEndpoint GetLanEndpoint() const;
+    HybridRouterStatistics GetStatistics() const;
+
+private:
+    enum class NodeState : uint8_t { Internet, Candidate, Local };
+
+    struct Node {
+        std::atomic<NodeState> state{NodeState::Internet};
+        // Last matching probe or packet over the LAN; 0 if none yet
+        std::atomic<uint64_t> last_heard_ns{0};
+    };
+
+    static constexpr size_t MAX_NODES = ModelB::AdHocDataPlane::MAX_NODES;
+
+    ErrorCode SendPacket(uint8_t node_id, const uint8_t* data, size_t size,
+                         SendPriority priority);
+    ErrorCode SendBroadcast(uint8_t destination_mask, const uint8_t* data, size_t size,
+                            SendPriority priority);
+    ErrorCode SendLatest(uint8_t node_id, const uint8_t* data, size_t size,
+                         SendPriority priority, uint64_t key);
+    void OnLanPacket(uint8_t node_id, const uint8_t* data, size_t size);
+    void OnLanControl(uint8_t node_id, const uint8_t* data, size_t size);
+    void ProbeNodes();
+    void SendProbeLocked(uint8_t node_id, bool heard);
+    bool IsHeard(const Node& node, uint64_t now_ns) const;
+
+    ModelA::ModelABackend& backend_;
+    const HybridRouterConfig config_;
+    std::shared_ptr<TimerWheel> timer_wheel_;
+    ModelB::AdHocDataPlane lan_;
+    std::vector<Ipv4Subnet> local_subnets_;
+
+    ModelA::ModelABackend::PacketSender internet_sender_;
+    ModelA::ModelABackend::BroadcastSender internet_broadcast_;
+    ModelA::ModelABackend::LatestValueSender internet_latest_;
+    uint8_t local_node_id_ = 0;
+    uint64_t session_tag_ = 0;
+    TimerWheel::TimerId probe_timer_ = TimerWheel::INVALID_TIMER_ID;
+    std::atomic<bool> running_{false};
+
+    // The data plane has one sending thread at a time: the game's, the
+    // timer wheel's for probes or the receive thread's for probe replies
+    std::mutex send_mutex_;
+    // States only change by compare-exchange, so a removed node stays removed
+    std::array<Node, MAX_NODES> nodes_{};
+
+    std::atomic<uint64_t> lan_sent_{0};
+    std::atomic<uint64_t> internet_sent_{0};
+    std::atomic<uint64_t> lan_received_{0};
+    std::atomic<uint64_t> lan_send_failures_{0};
+    std::atomic<uint64_t> lan_fallbacks_{0};
+};
+
+} // namespace Core::Multiplayer::HLE
@@ -3,13 +3,25 @@
 
 #include "ldn_service_bridge.h"
 
+#include "backend_dispatch.h"
+#include "common/node_event_queue.h"
+#include "common/packet_trace.h"
+#include "common/seqlock.h"
+#include "common/spsc_ring.h"
 #include "error_code_mapper.h"
+#include "type_translator.h"
 
 #include "sudachi/src/core/hle/service/ldn/ldn_types.h"
 #include "sudachi/src/core/hle/service/ldn/ldn_results.h"
 #include "sudachi/src/core/hle/result.h"
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <future>
 #include <mutex>
+#include <optional>
+#include <span>
 
 namespace Service::LDN {
 
@@ -21,22 +33,35 @@ class ConcreteLdnServiceBridge : public LdnServiceBridge {
 public:
     ConcreteLdnServiceBridge(std::unique_ptr<Core::Multiplayer::HLE::BackendFactory> factory)
         : LdnServiceBridge(std::move(factory)),
-          error_mapper_(Core::Multiplayer::HLE::CreateErrorCodeMapper()) {}
+          error_mapper_(Core::Multiplayer::HLE::CreateErrorCodeMapper()),
+          type_translator_(Core::Multiplayer::HLE::CreateTypeTranslator()) {}
+
+    ~ConcreteLdnServiceBridge() override {
+        AbandonBackendSwitch();
+    }
 
     Result Initialize() override {
+        const auto watch = call_watchdog_.Watch("LdnServiceBridge::Initialize");
+        std::lock_guard lock(control_mutex_);
         if (current_state_ != State::None) {
             return ResultBadState;
         }
         
-        // Create backend using factory
-        auto backend_type = backend_factory_->GetPreferredBackend();
-        current_backend_ = backend_factory_->CreateBackend(backend_type);
+        // Create backend using factory; in Auto mode the availability checks
+        // must have settled, or Internet is picked while ad-hoc is still pending
+        auto backend_type = backend_factory_->WaitForPreferredBackend();
+        auto backend = backend_factory_->CreateBackend(backend_type);
         
-        if (!current_backend_) {
+        if (!backend) {
             return ResultInternalError;  // Backend creation failed
         }
         
         current_backend_type_ = backend_type;
+        {
+            std::lock_guard data_lock(data_mutex_);
+            current_backend_ = std::move(backend);
+            backend_dispatch_.Bind(current_backend_.get());
+        }
         
         // Initialize the backend
         auto error = current_backend_->Initialize();
@@ -49,25 +74,41 @@ public:
             [this](uint8_t node_id) { OnNodeJoined(node_id); },
             [this](uint8_t node_id) { OnNodeLeft(node_id); });
 
-        current_state_ = State::Initialized;
+        SetState(State::Initialized);
         return ResultSuccess;
     }
     
     Result Finalize() override {
-        if (current_backend_) {
-            current_backend_->Finalize();
-            current_backend_.reset();
-        }
-        current_state_ = State::None;
+        const auto watch = call_watchdog_.Watch("LdnServiceBridge::Finalize");
+        std::lock_guard lock(control_mutex_);
+        AbandonBackendSwitch();
+        scan_cache_.Invalidate();
+        std::unique_ptr<Core::Multiplayer::HLE::MultiplayerBackend> backend;
+        {
+            // Out of the data path's reach before it is finalized
+            std::lock_guard data_lock(data_mutex_);
+            backend = std::move(current_backend_);
+            backend_dispatch_.Reset();
+            DropHandedOverPackets();
+            retired_backend_.reset();
+        }
+        if (backend) {
+            backend->Finalize();
+        }
+        session_ = {};
+        SetState(State::None);
         return ResultSuccess;
     }
     
     Result GetState(State& out_state) override {
-        out_state = current_state_;
+        const auto watch = call_watchdog_.Watch("LdnServiceBridge::GetState");
+        out_state = published_state_.load(std::memory_order_acquire);
         return ResultSuccess;
     }
     
     Result CreateNetwork(const CreateNetworkConfig& config) override {
+        const auto watch = call_watchdog_.Watch("LdnServiceBridge::CreateNetwork");
+        std::lock_guard lock(control_mutex_);
         if (current_state_ != State::AccessPointOpened) {
             return ResultBadState;
         }
@@ -81,11 +122,15 @@ public:
             return error_mapper_->MapToLdnResult(error);
         }
         
-        current_state_ = State::AccessPointCreated;
+        session_.network_config = config;
+        BeginTrafficProfile(config.network_config.intent_id.local_communication_id);
+        SetState(State::AccessPointCreated);
         return ResultSuccess;
     }
     
     Result DestroyNetwork() override {
+        const auto watch = call_watchdog_.Watch("LdnServiceBridge::DestroyNetwork");
+        std::lock_guard lock(control_mutex_);
         if (current_state_ != State::AccessPointCreated) {
             return ResultBadState;
         }
@@ -99,11 +144,16 @@ public:
             return error_mapper_->MapToLdnResult(error);
         }
         
-        current_state_ = State::AccessPointOpened;
+        EndTrafficProfile();
+        session_.network_config.reset();
+        session_.advertise_data.clear();
+        SetState(State::AccessPointOpened);
         return ResultSuccess;
     }
     
     Result OpenAccessPoint() override {
+        const auto watch = call_watchdog_.Watch("LdnServiceBridge::OpenAccessPoint");
+        std::lock_guard lock(control_mutex_);
         if (current_state_ != State::Initialized) {
             return ResultBadState;
         }
@@ -117,11 +167,13 @@ public:
             return error_mapper_->MapToLdnResult(error);
         }
         
-        current_state_ = State::AccessPointOpened;
+        SetState(State::AccessPointOpened);
         return ResultSuccess;
     }
     
     Result CloseAccessPoint() override {
+        const auto watch = call_watchdog_.Watch("LdnServiceBridge::CloseAccessPoint");
+        std::lock_guard lock(control_mutex_);
         if (current_state_ != State::AccessPointOpened && 
             current_state_ != State::AccessPointCreated) {
             return ResultBadState;
@@ -141,11 +193,14 @@ public:
             return error_mapper_->MapToLdnResult(error);
         }
         
-        current_state_ = State::Initialized;
+        session_ = {};
+        SetState(State::Initialized);
         return ResultSuccess;
     }
     
     Result OpenStation() override {
+        const auto watch = call_watchdog_.Watch("LdnServiceBridge::OpenStation");
+        std::lock_guard lock(control_mutex_);
         if (current_state_ != State::Initialized) {
             return ResultBadState;
         }
@@ -159,11 +214,13 @@ public:
             return error_mapper_->MapToLdnResult(error);
         }
         
-        current_state_ = State::StationOpened;
+        SetState(State::StationOpened);
         return ResultSuccess;
     }
     
     Result CloseStation() override {
+        const auto watch = call_watchdog_.Watch("LdnServiceBridge::CloseStation");
+        std::lock_guard lock(control_mutex_);
         if (current_state_ != State::StationOpened && 
             current_state_ != State::StationConnected) {
             return ResultBadState;
@@ -183,12 +240,15 @@ public:
             return error_mapper_->MapToLdnResult(error);
         }
         
-        current_state_ = State::Initialized;
+        session_ = {};
+        SetState(State::Initialized);
         return ResultSuccess;
     }
     
     Result Connect(const ConnectNetworkData& connect_data, 
                    const NetworkInfo& network_info) override {
+        const auto watch = call_watchdog_.Watch("LdnServiceBridge::Connect");
+        std::lock_guard lock(control_mutex_);
         if (current_state_ != State::StationOpened) {
             return ResultBadState;
         }
@@ -197,16 +257,23 @@ public:
             return ResultInternalError;
         }
         
+        // Like a station that stops scanning to associate
+        scan_cache_.WaitForRefresh();
         auto error = current_backend_->Connect(connect_data, network_info);
         if (error != Core::Multiplayer::ErrorCode::Success) {
             return error_mapper_->MapToLdnResult(error);
         }
         
-        current_state_ = State::StationConnected;
+        session_.connect_data = connect_data;
+        session_.network_info = network_info;
+        BeginTrafficProfile(network_info.network_id.intent_id.local_communication_id);
+        SetState(State::StationConnected);
         return ResultSuccess;
     }
     
     Result Disconnect() override {
+        const auto watch = call_watchdog_.Watch("LdnServiceBridge::Disconnect");
+        std::lock_guard lock(control_mutex_);
         if (current_state_ != State::StationConnected) {
             return ResultBadState;
         }
@@ -220,12 +287,17 @@ public:
             return error_mapper_->MapToLdnResult(error);
         }
         
-        current_state_ = State::StationOpened;
+        EndTrafficProfile();
+        session_.connect_data.reset();
+        session_.network_info.reset();
+        SetState(State::StationOpened);
         return ResultSuccess;
     }
     
     Result Scan(std::vector<NetworkInfo>& out_networks, 
                 WifiChannel channel, const ScanFilter& filter) override {
+        const auto watch = call_watchdog_.Watch("LdnServiceBridge::Scan");
+        std::lock_guard lock(control_mutex_);
         if (current_state_ != State::Initialized && 
             current_state_ != State::StationOpened) {
             return ResultBadState;
@@ -235,7 +307,21 @@ public:
             return ResultInternalError;
         }
         
-        auto error = current_backend_->Scan(out_networks, filter);
+        // The refresh may outlive this call; the cache is drained before the
+        // backend is switched or finalized
+        auto* backend = current_backend_.get();
+        const std::span<const uint8_t> filter_key(reinterpret_cast<const uint8_t*>(&filter),
+                                                  sizeof(filter));
+        scan_cache_.SetConfig(scan_cache_config_);
+        auto error = scan_cache_.Get(
+            filter_key, backend->GetNetworksEpoch(),
+            [backend, filter, discovery_filter = type_translator_->ToDiscoveryFilter(filter)](
+                std::vector<NetworkInfo>& networks) {
+                // Lets the backend drop other titles before they reach Scan
+                backend->SetDiscoveryFilter(discovery_filter);
+                return backend->Scan(networks, filter);
+            },
+            out_networks);
         if (error != Core::Multiplayer::ErrorCode::Success) {
             return error_mapper_->MapToLdnResult(error);
         }
@@ -243,56 +329,71 @@ public:
         return ResultSuccess;
     }
     
+    Core::Multiplayer::HLE::ScanCacheStatistics GetScanCacheStatistics() const override {
+        return scan_cache_.GetStatistics();
+    }
+    
     Result GetNetworkInfo(NetworkInfo& out_info) override {
-        if (current_state_ != State::AccessPointCreated && 
-            current_state_ != State::StationConnected) {
+        const auto watch = call_watchdog_.Watch("LdnServiceBridge::GetNetworkInfo");
+        const SessionView view = LoadSessionView();
+        if (view.state != State::AccessPointCreated && 
+            view.state != State::StationConnected) {
             return ResultBadState;
         }
         
-        if (!current_backend_) {
+        if (!view.has_backend) {
             return ResultInternalError;
         }
         
-        auto error = current_backend_->GetNetworkInfo(out_info);
-        if (error != Core::Multiplayer::ErrorCode::Success) {
-            return error_mapper_->MapToLdnResult(error);
+        if (view.network_info_error != Core::Multiplayer::ErrorCode::Success) {
+            return error_mapper_->MapToLdnResult(view.network_info_error);
         }
         
+        out_info = view.network_info;
         return ResultSuccess;
     }
     
     Result GetNetworkInfoLatestUpdate(NetworkInfo& out_info,
                                     std::vector<NodeLatestUpdate>& out_updates) override {
+        const auto watch = call_watchdog_.Watch("LdnServiceBridge::GetNetworkInfoLatestUpdate");
         // First get basic network info
         auto result = GetNetworkInfo(out_info);
         if (result != ResultSuccess) {
             return result;
         }
 
-        // Retrieve and clear pending node updates atomically
-        {
-            std::lock_guard<std::mutex> lock(node_updates_mutex_);
-            out_updates = node_updates_;
-            node_updates_.clear();
-        }
+        // One update per node whose state changed since the last call
+        out_updates.clear();
+        std::lock_guard lock(node_events_mutex_);
+        node_events_.Drain([&out_updates](uint8_t node_id, bool connected) {
+            NodeLatestUpdate update{};
+            update.node_id = node_id;
+            update.is_connected = connected ? 1 : 0;
+            out_updates.push_back(update);
+        });
 
         return ResultSuccess;
     }
 
     Result GetIpv4Address(Ipv4Address& out_address, Ipv4Address& out_subnet) override {
-        if (!current_backend_) {
+        const auto watch = call_watchdog_.Watch("LdnServiceBridge::GetIpv4Address");
+        const SessionView view = LoadSessionView();
+        if (!view.has_backend) {
             return ResultInternalError;
         }
 
-        auto error = current_backend_->GetIpv4Address(out_address, out_subnet);
-        if (error != Core::Multiplayer::ErrorCode::Success) {
-            return error_mapper_->MapToLdnResult(error);
+        if (view.address_error != Core::Multiplayer::ErrorCode::Success) {
+            return error_mapper_->MapToLdnResult(view.address_error);
         }
 
+        out_address = view.address;
+        out_subnet = view.subnet;
         return ResultSuccess;
     }
 
     Result GetNetworkConfig(NetworkConfig& out_config) override {
+        const auto watch = call_watchdog_.Watch("LdnServiceBridge::GetNetworkConfig");
+        std::lock_guard lock(control_mutex_);
         if (!current_backend_) {
             return ResultInternalError;
         }
@@ -306,6 +407,8 @@ public:
     }
     
     Result GetSecurityParameter(SecurityParameter& out_param) override {
+        const auto watch = call_watchdog_.Watch("LdnServiceBridge::GetSecurityParameter");
+        std::lock_guard lock(control_mutex_);
         if (!current_backend_) {
             return ResultInternalError;
         }
@@ -319,6 +422,8 @@ public:
     }
     
     Result GetDisconnectReason(DisconnectReason& out_reason) override {
+        const auto watch = call_watchdog_.Watch("LdnServiceBridge::GetDisconnectReason");
+        std::lock_guard lock(control_mutex_);
         if (!current_backend_) {
             return ResultInternalError;
         }
@@ -332,6 +437,8 @@ public:
     }
     
     Result SetAdvertiseData(const std::vector<uint8_t>& data) override {
+        const auto watch = call_watchdog_.Watch("LdnServiceBridge::SetAdvertiseData");
+        std::lock_guard lock(control_mutex_);
         if (current_state_ != State::AccessPointCreated) {
             return ResultBadState;
         }
@@ -349,10 +456,102 @@ public:
             return error_mapper_->MapToLdnResult(error);
         }
         
+        session_.advertise_data = data;
+        // The advertise data is part of NetworkInfo
+        PublishSessionView();
         return ResultSuccess;
     }
 
+    Result SendPackets(const Core::Multiplayer::HLE::PacketRef* packets, size_t count,
+                       size_t& out_sent) override {
+        const uint64_t entry = Core::Multiplayer::DataPathLatency::Now();
+        MULTIPLAYER_TRACE_PACKET();
+        // Inside the packet scope so a slow send keeps its trace id
+        const auto watch = call_watchdog_.Watch("LdnServiceBridge::SendPackets");
+        MULTIPLAYER_TRACE_ZONE("LdnServiceBridge::SendPackets");
+        out_sent = 0;
+        if (!IsDataPathState(published_state_.load(std::memory_order_acquire))) {
+            return ResultBadState;
+        }
+        
+        TryCompleteBackendSwitch();
+        
+        std::lock_guard lock(data_mutex_);
+        if (!current_backend_) {
+            return ResultInternalError;
+        }
+        
+        auto error = backend_dispatch_.SendPackets(packets, count, out_sent);
+        if (traffic_capture_.IsOpen()) {
+            for (size_t i = 0; i < out_sent; ++i) {
+                traffic_capture_.Record(Core::Multiplayer::TrafficDirection::Sent,
+                                        packets[i].node_id, packets[i].data, packets[i].size,
+                                        entry);
+            }
+        }
+        if (learning_traffic_profile_) {
+            for (size_t i = 0; i < out_sent; ++i) {
+                traffic_learner_.Observe(packets[i].size, entry);
+            }
+        }
+        if (auto* latency = current_backend_->GetDataPathLatency()) {
+            latency->RecordSince(Core::Multiplayer::DataPathHop::BridgeEntry, entry);
+        }
+        if (error != Core::Multiplayer::ErrorCode::Success) {
+            return error_mapper_->MapToLdnResult(error);
+        }
+        
+        return ResultSuccess;
+    }
+    
+    Result ReceivePackets(Core::Multiplayer::ReceivedPacket* out_packets, size_t max_packets,
+                          size_t& out_received) override {
+        const auto watch = call_watchdog_.Watch("LdnServiceBridge::ReceivePackets");
+        out_received = 0;
+        if (!IsDataPathState(published_state_.load(std::memory_order_acquire))) {
+            return ResultBadState;
+        }
+        
+        TryCompleteBackendSwitch();
+        
+        std::lock_guard lock(data_mutex_);
+        // Packets the previous backend had queued are delivered first
+        while (out_received < max_packets && handover_ring_.TryPop(out_packets[out_received])) {
+            ++out_received;
+        }
+        if (out_received > 0) {
+            CaptureReceived(out_packets, out_received);
+            return ResultSuccess;
+        }
+        
+        if (!current_backend_) {
+            return ResultInternalError;
+        }
+        
+        auto error = backend_dispatch_.ReceivePackets(out_packets, max_packets, out_received);
+        if (error != Core::Multiplayer::ErrorCode::Success) {
+            return error_mapper_->MapToLdnResult(error);
+        }
+        
+        CaptureReceived(out_packets, out_received);
+        return ResultSuccess;
+    }
+
+    void OnFrameBoundary() override {
+        const auto watch = call_watchdog_.Watch("LdnServiceBridge::OnFrameBoundary");
+        if (!IsDataPathState(published_state_.load(std::memory_order_acquire))) {
+            return;
+        }
+        std::lock_guard lock(data_mutex_);
+        if (!current_backend_) {
+            return;
+        }
+        backend_dispatch_.OnFrameBoundary();
+    }
+
     Result SetStationAcceptPolicy(AcceptPolicy policy) override {
+        const auto watch = call_watchdog_.Watch("LdnServiceBridge::SetStationAcceptPolicy");
+        std::lock_guard lock(control_mutex_);
         if (!current_backend_) {
             return ResultInternalError;
         }
@@ -364,6 +563,8 @@ public:
     }
 
     Result AddAcceptFilterEntry(const MacAddress& mac_address) override {
+        const auto watch = call_watchdog_.Watch("LdnServiceBridge::AddAcceptFilterEntry");
+        std::lock_guard lock(control_mutex_);
         if (!current_backend_) {
             return ResultInternalError;
         }
@@ -375,56 +576,368 @@ public:
     }
     
     Result SwitchBackend(Core::Multiplayer::HLE::BackendFactory::BackendType type) override {
-        if (current_state_ != State::Initialized) {
+        const auto watch = call_watchdog_.Watch("LdnServiceBridge::SwitchBackend");
+        std::lock_guard lock(control_mutex_);
+        auto result = BeginBackendSwitchLocked(type);
+        if (result != ResultSuccess) {
+            return result;
+        }
+        
+        pending_switch_.wait();
+        auto error = CompleteBackendSwitch();
+        if (error != Core::Multiplayer::ErrorCode::Success) {
+            return error_mapper_->MapToLdnResult(error);
+        }
+        
+        return ResultSuccess;
+    }
+    
+    Result BeginBackendSwitch(Core::Multiplayer::HLE::BackendFactory::BackendType type) override {
+        const auto watch = call_watchdog_.Watch("LdnServiceBridge::BeginBackendSwitch");
+        std::lock_guard lock(control_mutex_);
+        // The data path commits the switch, so there must be one
+        if (!IsDataPathState()) {
+            return ResultBadState;
+        }
+        return BeginBackendSwitchLocked(type);
+    }
+    
+    bool IsBackendSwitchPending() const override {
+        return switch_pending_.load(std::memory_order_acquire);
+    }
+    
+    Core::Multiplayer::HLE::BackendFactory::BackendType GetCurrentBackendType() override {
+        std::lock_guard lock(control_mutex_);
+        return current_backend_type_;
+    }
+
+private:
+    // Configuration needed to bring a standby backend to the current state
+    struct SessionSnapshot {
+        std::optional<CreateNetworkConfig> network_config;
+        std::optional<ConnectNetworkData> connect_data;
+        std::optional<NetworkInfo> network_info;
+        std::vector<uint8_t> advertise_data;
+    };
+    
+    // Already-translated answers for the getters games call every frame
+    struct SessionView {
+        State state{};
+        bool has_backend = false;
+        Core::Multiplayer::ErrorCode network_info_error = Core::Multiplayer::ErrorCode::InvalidState;
+        NetworkInfo network_info{};
+        Core::Multiplayer::ErrorCode address_error = Core::Multiplayer::ErrorCode::InvalidState;
+        Ipv4Address address{};
+        Ipv4Address subnet{};
+    };
+    
+    struct StandbyBackend {
+        std::unique_ptr<Core::Multiplayer::HLE::MultiplayerBackend> backend;
+        Core::Multiplayer::ErrorCode error = Core::Multiplayer::ErrorCode::Success;
+    };
+    
+    static constexpr size_t HandoverRingCapacity = 256;
+    static constexpr size_t HandoverBatchSize = 32;
+    
+    /**
+     * Runs off the HLE thread: initializes the standby and replays the
+     * session so it carries the same network; the current backend is untouched
+     */
+    static StandbyBackend PrepareStandby(
+        std::unique_ptr<Core::Multiplayer::HLE::MultiplayerBackend> backend,
+        const SessionSnapshot& session, State state) {
+        StandbyBackend standby{std::move(backend)};
+        standby.error = ReplaySession(*standby.backend, session, state);
+        if (standby.error != Core::Multiplayer::ErrorCode::Success) {
+            standby.backend->Finalize();
+            standby.backend.reset();
+        }
+        return standby;
+    }
+    
+    static Core::Multiplayer::ErrorCode ReplaySession(
+        Core::Multiplayer::HLE::MultiplayerBackend& backend, const SessionSnapshot& session,
+        State state) {
+        using Core::Multiplayer::ErrorCode;
+        
+        auto error = backend.Initialize();
+        if (error != ErrorCode::Success) {
+            return error;
+        }
+        
+        switch (state) {
+        case State::AccessPointOpened:
+        case State::AccessPointCreated:
+            error = backend.OpenAccessPoint();
+            if (error != ErrorCode::Success || state != State::AccessPointCreated) {
+                return error;
+            }
+            if (!session.network_config) {
+                return ErrorCode::InvalidState;
+            }
+            error = backend.CreateNetwork(*session.network_config);
+            if (error != ErrorCode::Success || session.advertise_data.empty()) {
+                return error;
+            }
+            return backend.SetAdvertiseData(session.advertise_data);
+        case State::StationOpened:
+        case State::StationConnected:
+            error = backend.OpenStation();
+            if (error != ErrorCode::Success || state != State::StationConnected) {
+                return error;
+            }
+            if (!session.connect_data || !session.network_info) {
+                return ErrorCode::InvalidState;
+            }
+            return backend.Connect(*session.connect_data, *session.network_info);
+        default:
+            return ErrorCode::Success;
+        }
+    }
+    
+    void BeginTrafficProfile(uint64_t title_id) {
+        active_title_id_ = title_id;
+        active_traffic_profile_ = traffic_profiles_.Lookup(title_id);
+        current_backend_->ApplyTrafficProfile(active_traffic_profile_);
+        std::lock_guard data_lock(data_mutex_);
+        traffic_learner_.Reset();
+    }
+    
+    void EndTrafficProfile() {
+        std::lock_guard data_lock(data_mutex_);
+        if (learning_traffic_profile_) {
+            if (const auto learned = traffic_learner_.Derive(active_traffic_profile_)) {
+                traffic_profiles_.Set(active_title_id_, *learned);
+            }
+        }
+        traffic_learner_.Reset();
+        active_traffic_profile_ = {};
+    }
+    
+    Result BeginBackendSwitchLocked(Core::Multiplayer::HLE::BackendFactory::BackendType type) {
+        if (current_state_ == State::None || current_state_ == State::Error) {
             return ResultBadState;
         }
         
-        // Finalize current backend
-        if (current_backend_) {
-            current_backend_->Finalize();
+        if (pending_switch_.valid()) {
+            return ResultBadState;  // A switch is already being prepared
         }
         
-        // Create new backend
-        current_backend_ = backend_factory_->CreateBackend(type);
-        if (!current_backend_) {
+        auto standby = backend_factory_->CreateBackend(type);
+        if (!standby) {
             return ResultInternalError;
         }
         
-        current_backend_type_ = type;
+        pending_backend_type_ = type;
+        pending_switch_state_ = current_state_;
+        pending_switch_ = std::async(
+            std::launch::async,
+            [backend = std::move(standby), session = session_, state = current_state_]() mutable {
+                return PrepareStandby(std::move(backend), session, state);
+            });
+        switch_pending_.store(true, std::memory_order_release);
         
-        // Initialize new backend
-        auto error = current_backend_->Initialize();
-        if (error != Core::Multiplayer::ErrorCode::Success) {
-            return error_mapper_->MapToLdnResult(error);
+        return ResultSuccess;
+    }
+    
+    // Called on the data path, before the data lock; a switch waits for the
+    // next packet rather than for a control operation in progress
+    void TryCompleteBackendSwitch() {
+        if (!switch_pending_.load(std::memory_order_acquire)) {
+            return;
+        }
+        std::unique_lock lock(control_mutex_, std::try_to_lock);
+        if (!lock.owns_lock() || !pending_switch_.valid() ||
+            pending_switch_.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return;
+        }
+        // A failed standby is dropped; the current backend keeps the session
+        CompleteBackendSwitch();
+    }
+    
+    // Called with the control lock held
+    Core::Multiplayer::ErrorCode CompleteBackendSwitch() {
+        auto standby = pending_switch_.get();
+        switch_pending_.store(false, std::memory_order_release);
+        if (standby.error != Core::Multiplayer::ErrorCode::Success) {
+            return standby.error;
         }
         
-        return ResultSuccess;
+        standby.backend->RegisterNodeEventCallbacks(
+            [this](uint8_t node_id) { OnNodeJoined(node_id); },
+            [this](uint8_t node_id) { OnNodeLeft(node_id); });
+        if (IsDataPathState()) {
+            standby.backend->ApplyTrafficProfile(active_traffic_profile_);
+        }
+        
+        // Networks found through the old backend may not be joinable through the new one
+        scan_cache_.Invalidate();
+        
+        {
+            // The data path sees the old backend or the new one, at a packet boundary
+            std::lock_guard data_lock(data_mutex_);
+            // The retired backend's pool backs the packets that are still queued
+            DropHandedOverPackets();
+            HandOverReceivedPackets();
+            
+            // What the outgoing backend batched this frame still goes out
+            backend_dispatch_.OnFrameBoundary();
+            
+            current_backend_.swap(standby.backend);
+            backend_dispatch_.Bind(current_backend_.get());
+        }
+        current_backend_type_ = pending_backend_type_;
+        
+        if (standby.backend) {
+            standby.backend->Finalize();
+        }
+        retired_backend_ = std::move(standby.backend);
+        PublishSessionView();
+        return Core::Multiplayer::ErrorCode::Success;
     }
     
-    Core::Multiplayer::HLE::BackendFactory::BackendType GetCurrentBackendType() override {
-        return current_backend_type_;
+    // Drains what the outgoing backend already received; overflow is dropped like any lost datagram
+    void HandOverReceivedPackets() {
+        if (!IsDataPathState()) {
+            return;
+        }
+        
+        std::array<Core::Multiplayer::ReceivedPacket, HandoverBatchSize> batch;
+        size_t received = 0;
+        do {
+            if (backend_dispatch_.ReceivePackets(batch.data(), batch.size(), received) !=
+                Core::Multiplayer::ErrorCode::Success) {
+                return;
+            }
+            for (size_t i = 0; i < received; ++i) {
+                if (!handover_ring_.TryPush(std::move(batch[i]))) {
+                    return;
+                }
+            }
+        } while (received == batch.size());
+    }
+    
+    void DropHandedOverPackets() {
+        Core::Multiplayer::ReceivedPacket packet;
+        while (handover_ring_.TryPop(packet)) {
+        }
+    }
+    
+    // Waits for a preparation in progress, then drops the standby
+    void AbandonBackendSwitch() {
+        if (!pending_switch_.valid()) {
+            return;
+        }
+        auto standby = pending_switch_.get();
+        switch_pending_.store(false, std::memory_order_release);
+        if (standby.backend) {
+            standby.backend->Finalize();
+        }
+    }
+    
+    void CaptureReceived(const Core::Multiplayer::ReceivedPacket* packets, size_t count) {
+        if (!traffic_capture_.IsOpen() || count == 0) {
+            return;
+        }
+        const uint64_t now = Core::Multiplayer::DataPathLatency::Now();
+        for (size_t i = 0; i < count; ++i) {
+            traffic_capture_.Record(Core::Multiplayer::TrafficDirection::Received,
+                                    packets[i].node_id, packets[i].packet.data(),
+                                    packets[i].packet.size(), now);
+        }
+    }
+    
+    // Called with the control lock held, like everything that publishes
+    void SetState(State state) {
+        current_state_ = state;
+        published_state_.store(state, std::memory_order_release);
+        // A standby prepared for the state being left could never take over
+        if (state != pending_switch_state_) {
+            AbandonBackendSwitch();
+        }
+        if (!IsDataPathState()) {
+            std::lock_guard lock(node_events_mutex_);
+            node_events_.Reset(); // The next session starts with no nodes
+        }
+        PublishSessionView();
+    }
+    
+    /**
+     * Translates what the getters report once, under the control lock,
+     * whenever the state or membership changes; the getters then only copy it
+     */
+    void PublishSessionView() {
+        session_view_stale_.store(false, std::memory_order_relaxed);
+        SessionView view{};
+        view.state = current_state_;
+        view.has_backend = current_backend_ != nullptr;
+        if (view.has_backend) {
+            if (IsDataPathState()) {
+                view.network_info_error = current_backend_->GetNetworkInfo(view.network_info);
+            }
+            view.address_error = current_backend_->GetIpv4Address(view.address, view.subnet);
+        }
+        session_view_.Store(view);
+    }
+    
+    SessionView LoadSessionView() {
+        if (session_view_stale_.load(std::memory_order_acquire)) {
+            // A control operation in progress publishes when it changes the
+            // state; until then the getters answer from the last view
+            std::unique_lock lock(control_mutex_, std::try_to_lock);
+            if (lock.owns_lock()) {
+                PublishSessionView();
+            }
+        }
+        return session_view_.Load();
+    }
+    
+    bool IsDataPathState() const {
+        return IsDataPathState(current_state_);
+    }
+    
+    static bool IsDataPathState(State state) {
+        return state == State::AccessPointCreated || state == State::StationConnected;
     }
 
-private:
+    // Run on backend threads; neither takes a lock, the getters drain and republish
     void OnNodeJoined(uint8_t node_id) {
-        std::lock_guard<std::mutex> lock(node_updates_mutex_);
-        NodeLatestUpdate update{};
-        update.node_id = node_id;
-        update.is_connected = 1;
-        node_updates_.push_back(update);
+        node_events_.PostJoined(node_id);
+        session_view_stale_.store(true, std::memory_order_release);
     }
 
     void OnNodeLeft(uint8_t node_id) {
-        std::lock_guard<std::mutex> lock(node_updates_mutex_);
-        NodeLatestUpdate update{};
-        update.node_id = node_id;
-        update.is_connected = 0;
-        node_updates_.push_back(update);
+        node_events_.PostLeft(node_id);
+        session_view_stale_.store(true, std::memory_order_release);
     }
 
-    std::mutex node_updates_mutex_;
-    std::vector<NodeLatestUpdate> node_updates_;
+    Core::Multiplayer::NodeEventQueue node_events_;
+    // Drain and Reset belong to one consumer at a time
+    std::mutex node_events_mutex_;
+    // current_state_ for the getters and the data path, which take no control lock
+    std::atomic<State> published_state_{};
     std::unique_ptr<Core::Multiplayer::HLE::ErrorCodeMapper> error_mapper_;
+    std::unique_ptr<Core::Multiplayer::HLE::TypeTranslator> type_translator_;
+    // Per-packet calls go through here instead of current_backend_
+    Core::Multiplayer::HLE::BackendDispatch backend_dispatch_;
+    
+    SessionSnapshot session_;
+    Core::Multiplayer::SeqLock<SessionView> session_view_;
+    std::atomic<bool> session_view_stale_{false};
+    Core::Multiplayer::HLE::ScanResultCache<std::vector<NetworkInfo>> scan_cache_;
+    std::future<StandbyBackend> pending_switch_;
+    std::atomic<bool> switch_pending_{false};
+    Core::Multiplayer::HLE::BackendFactory::BackendType pending_backend_type_{};
+    State pending_switch_state_{};
+    // Kept after a switch until its handed-over packets are released
+    std::unique_ptr<Core::Multiplayer::HLE::MultiplayerBackend> retired_backend_;
+    Core::Multiplayer::SpscRing<Core::Multiplayer::ReceivedPacket> handover_ring_{
+        HandoverRingCapacity};
 };
 
+std::unique_ptr<LdnServiceBridge> CreateLdnServiceBridge(
+    std::unique_ptr<Core::Multiplayer::HLE::BackendFactory> factory) {
+    return std::make_unique<ConcreteLdnServiceBridge>(std::move(factory));
+}
+
 } // namespace Service::LDN
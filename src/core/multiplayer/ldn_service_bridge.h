@@ -3,11 +3,19 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 
 #include "backend_factory.h"
+#include "common/call_watchdog.h"
+#include "common/lock_contention.h"
+#include "common/traffic_capture.h"
+#include "common/traffic_profile.h"
 #include "multiplayer_backend.h"
+#include "scan_result_cache.h"
 
 // Forward declarations for LDN types
 namespace Service::LDN {
@@ -32,6 +40,12 @@ namespace Service::LDN {
 /**
  * LDN Service Bridge - The critical component that connects LDN HLE to multiplayer backends
  * This MUST be implemented to replace the legacy LANDiscovery usage in user_local_communication_service.cpp
+ *
+ * Games call the service from several emulated threads at once, e.g. one
+ * polling GetState while another sends. Control operations take an
+ * exclusive control lock; packet send and receive take a data lock of
+ * their own, so a slow Scan or Connect never holds up a packet. GetState,
+ * GetNetworkInfo and GetIpv4Address read a published view and take no lock.
  */
 class LdnServiceBridge {
 public:
@@ -62,6 +76,17 @@ public:
     virtual Result Scan(std::vector<NetworkInfo>& out_networks, 
                        WifiChannel channel, const ScanFilter& filter) = 0;
     virtual Result GetNetworkInfo(NetworkInfo& out_info) = 0;
+
+    /**
+     * Scan answers from the last snapshot taken with the same filter and
+     * refreshes it in the background, see ScanResultCache; config bounds
+     * how old an answer may be. Call from the HLE thread.
+     */
+    void SetScanCacheConfig(const Core::Multiplayer::HLE::ScanCacheConfig& config) {
+        std::lock_guard lock(control_mutex_);
+        scan_cache_config_ = config;
+    }
+    virtual Core::Multiplayer::HLE::ScanCacheStatistics GetScanCacheStatistics() const = 0;
     virtual Result GetNetworkInfoLatestUpdate(NetworkInfo& out_info,
                                             std::vector<NodeLatestUpdate>& out_updates) = 0;
     
@@ -72,19 +97,126 @@ public:
     virtual Result GetDisconnectReason(DisconnectReason& out_reason) = 0;
     
     // Data transmission
+    virtual Result SendPackets(const Core::Multiplayer::HLE::PacketRef* packets, size_t count,
+                               size_t& out_sent) = 0;
+    virtual Result ReceivePackets(Core::Multiplayer::ReceivedPacket* out_packets,
+                                  size_t max_packets, size_t& out_received) = 0;
+    // Call once per emulated frame, e.g. on vsync, from the HLE thread; the
+    // backend flushes what it batched over the frame
+    virtual void OnFrameBoundary() = 0;
     virtual Result SetAdvertiseData(const std::vector<uint8_t>& data) = 0;
     virtual Result SetStationAcceptPolicy(AcceptPolicy policy) = 0;
     virtual Result AddAcceptFilterEntry(const MacAddress& mac_address) = 0;
     
     // Backend management
     virtual Result SwitchBackend(Core::Multiplayer::HLE::BackendFactory::BackendType type) = 0;
+    
+    /**
+     * Make-before-break switch: the new backend initializes and rejoins the
+     * current session in the background while the current one keeps carrying
+     * traffic. The data path swaps to it once it is ready; if preparation
+     * fails the current backend is kept. Only while a network is up
+     * (AccessPointCreated or StationConnected); a state change before the
+     * swap abandons the switch.
+     */
+    virtual Result BeginBackendSwitch(Core::Multiplayer::HLE::BackendFactory::BackendType type) = 0;
+    virtual bool IsBackendSwitchPending() const = 0;
     virtual Core::Multiplayer::HLE::BackendFactory::BackendType GetCurrentBackendType() = 0;
 
+    /**
+     * Every service entry point is timed; calls that hold the HLE thread past
+     * the threshold are kept, with the caller's stack, for GetSlowCalls.
+     */
+    void SetSlowCallThreshold(std::chrono::nanoseconds threshold) {
+        call_watchdog_.SetThreshold(threshold);
+    }
+    std::vector<Core::Multiplayer::SlowCallRecord> GetSlowCalls() const {
+        return call_watchdog_.GetSlowCalls();
+    }
+
+    // The current backend's statistics plus the service call counts; waits
+    // for a control operation in progress
+    Core::Multiplayer::ErrorCode GetStatistics(Core::Multiplayer::BackendStats& out_stats) const {
+        std::lock_guard lock(control_mutex_);
+        out_stats = {};
+        const auto error = current_backend_ ? current_backend_->GetStatistics(out_stats)
+                                            : Core::Multiplayer::ErrorCode::NotInitialized;
+        const auto calls = call_watchdog_.GetStatistics();
+        out_stats.service_calls = calls.calls;
+        out_stats.slow_service_calls = calls.slow_calls;
+        return error;
+    }
+
+    /**
+     * Records every packet sent and received through the bridge, with its
+     * time, size and node id, into a capture file for TrafficReplayer. The
+     * file is mapped at capacity_bytes; packets past that are dropped.
+     */
+    Core::Multiplayer::ErrorCode StartTrafficCapture(const std::string& path, size_t capacity_bytes,
+                                                     bool capture_payloads = true) {
+        std::lock_guard lock(data_mutex_);
+        return traffic_capture_.Open(path, capacity_bytes, capture_payloads);
+    }
+    Core::Multiplayer::ErrorCode StopTrafficCapture() {
+        std::lock_guard lock(data_mutex_);
+        return traffic_capture_.Close();
+    }
+    bool IsCapturingTraffic() const {
+        std::lock_guard lock(data_mutex_);
+        return traffic_capture_.IsOpen();
+    }
+
+    /**
+     * Profiles applied to the backend when a network is created or joined,
+     * looked up by the title's local_communication_id. Edit, load or save
+     * the table from the HLE thread.
+     */
+    Core::Multiplayer::TrafficProfileTable& GetTrafficProfiles() {
+        return traffic_profiles_;
+    }
+    // The profile the current session started with
+    const Core::Multiplayer::TrafficProfile& GetActiveTrafficProfile() const {
+        return active_traffic_profile_;
+    }
+
+    /**
+     * Learning mode: the sizes and rate of sent packets are measured, and
+     * when the network is destroyed or left, the profile derived from them
+     * is set in the table for the title
+     */
+    void SetTrafficProfileLearning(bool enabled) {
+        std::lock_guard lock(data_mutex_);
+        learning_traffic_profile_ = enabled;
+        traffic_learner_.Reset();
+    }
+    bool IsLearningTrafficProfile() const {
+        std::lock_guard lock(data_mutex_);
+        return learning_traffic_profile_;
+    }
+
 protected:
+    // Lock order: control, then data. The data path never waits for control.
+    mutable Core::Multiplayer::ProfiledMutex<Core::Multiplayer::LockSite::LdnServiceControl>
+        control_mutex_;
+    mutable Core::Multiplayer::ProfiledMutex<Core::Multiplayer::LockSite::LdnServiceData>
+        data_mutex_;
+
     std::unique_ptr<Core::Multiplayer::HLE::BackendFactory> backend_factory_;
     std::unique_ptr<Core::Multiplayer::HLE::MultiplayerBackend> current_backend_;
     Core::Multiplayer::HLE::BackendFactory::BackendType current_backend_type_;
-    State current_state_;
+    State current_state_{};
+    Core::Multiplayer::CallWatchdog call_watchdog_;
+    Core::Multiplayer::TrafficCaptureWriter traffic_capture_;
+    Core::Multiplayer::HLE::ScanCacheConfig scan_cache_config_;
+    Core::Multiplayer::TrafficProfileTable traffic_profiles_;
+    Core::Multiplayer::TrafficProfile active_traffic_profile_;
+    Core::Multiplayer::TrafficProfileLearner traffic_learner_;
+    uint64_t active_title_id_ = 0;
+    bool learning_traffic_profile_ = false;
 };
 
+// Factory function for the bridge the LDN service uses
+std::unique_ptr<LdnServiceBridge> CreateLdnServiceBridge(
+    std::unique_ptr<Core::Multiplayer::HLE::BackendFactory> factory);
+
 } // namespace Service::LDN
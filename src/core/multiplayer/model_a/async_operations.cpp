@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "async_operations.h"
+
+#include <functional>
+#include <utility>
+
+namespace Core::Multiplayer::ModelA {
+
+namespace {
+
+using SessionCallback = std::function<void(bool, uint32_t)>;
+
+SessionCallback ToSessionCallback(
+    std::function<void(RelaySessionResult)> complete) {
+    return [complete = std::move(complete)](bool success, uint32_t session_token) {
+        complete(RelaySessionResult{success, session_token});
+    };
+}
+
+} // namespace
+
+Task<std::optional<bool>> AwaitRelayConnect(IRelayClient& relay, std::string jwt_token,
+                                            CancellationToken token) {
+    co_return co_await AwaitCallback<bool>(
+        [&relay, &jwt_token](std::function<void(bool)> complete) {
+            relay.ConnectAsync(jwt_token, std::move(complete));
+        },
+        token);
+}
+
+Task<std::optional<RelaySessionResult>> AwaitRelayCreateSession(IRelayClient& relay,
+                                                                uint32_t session_token,
+                                                                CancellationToken token) {
+    co_return co_await AwaitCallback<RelaySessionResult>(
+        [&relay, session_token](std::function<void(RelaySessionResult)> complete) {
+            relay.CreateSessionAsync(session_token, ToSessionCallback(std::move(complete)));
+        },
+        token);
+}
+
+Task<std::optional<RelaySessionResult>> AwaitRelayJoinSession(IRelayClient& relay,
+                                                              uint32_t session_token,
+                                                              CancellationToken token) {
+    co_return co_await AwaitCallback<RelaySessionResult>(
+        [&relay, session_token](std::function<void(RelaySessionResult)> complete) {
+            relay.JoinSessionAsync(session_token, ToSessionCallback(std::move(complete)));
+        },
+        token);
+}
+
+Task<std::optional<MultiplayerResult>> AwaitNetworkStart(IP2PNetwork& network,
+                                                         CancellationToken token) {
+    co_return co_await AwaitFuture(network.Start(), token);
+}
+
+Task<std::optional<MultiplayerResult>> AwaitPeerConnect(IP2PNetwork& network, std::string peer_id,
+                                                        std::string multiaddr,
+                                                        CancellationToken token) {
+    co_return co_await AwaitFuture(network.ConnectToPeer(peer_id, multiaddr), token);
+}
+
+Task<PeerPath> ConnectPeerOrRelay(IP2PNetwork& network, IRelayClient& relay, PeerConnectPlan plan,
+                                  CancellationToken token) {
+    for (const auto& multiaddr : plan.multiaddrs) {
+        const auto result = co_await AwaitPeerConnect(network, plan.peer_id, multiaddr, token);
+        if (!result) {
+            co_return PeerPath::None;
+        }
+        if (*result == MultiplayerResult::Success) {
+            co_return PeerPath::Direct;
+        }
+    }
+
+    if (!relay.IsConnected()) {
+        const auto connected = co_await AwaitRelayConnect(relay, plan.relay_jwt_token, token);
+        if (!connected || !*connected) {
+            co_return PeerPath::None;
+        }
+    }
+    const auto joined = co_await AwaitRelayJoinSession(relay, plan.relay_session_token, token);
+    co_return joined && joined->success ? PeerPath::Relay : PeerPath::None;
+}
+
+} // namespace Core::Multiplayer::ModelA
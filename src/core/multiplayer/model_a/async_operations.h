@@ -0,0 +1,66 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "core/multiplayer/common/async_task.h"
+#include "i_p2p_network.h"
+#include "i_relay_client.h"
+
+namespace Core::Multiplayer::ModelA {
+
+/**
+ * Awaitable forms of the relay client's callbacks and the P2P network's
+ * futures, for connection setup written as one coroutine instead of
+ * callbacks and future.get() calls on executor threads.
+ *
+ * Each resumes on the shared executor and yields std::nullopt if the token
+ * is cancelled first; the operation itself is not aborted, its late result
+ * is dropped. The client or network must outlive the task.
+ */
+Task<std::optional<bool>> AwaitRelayConnect(IRelayClient& relay, std::string jwt_token,
+                                            CancellationToken token = {});
+
+struct RelaySessionResult {
+    bool success = false;
+    uint32_t session_token = 0;
+};
+
+Task<std::optional<RelaySessionResult>> AwaitRelayCreateSession(IRelayClient& relay,
+                                                                uint32_t session_token,
+                                                                CancellationToken token = {});
+Task<std::optional<RelaySessionResult>> AwaitRelayJoinSession(IRelayClient& relay,
+                                                              uint32_t session_token,
+                                                              CancellationToken token = {});
+
+Task<std::optional<MultiplayerResult>> AwaitNetworkStart(IP2PNetwork& network,
+                                                         CancellationToken token = {});
+Task<std::optional<MultiplayerResult>> AwaitPeerConnect(IP2PNetwork& network, std::string peer_id,
+                                                        std::string multiaddr,
+                                                        CancellationToken token = {});
+
+struct PeerConnectPlan {
+    std::string peer_id;
+    // Dialed in order, see OrderDialAddresses
+    std::vector<std::string> multiaddrs;
+    // Relay fallback; used only if the relay client is not already connected
+    std::string relay_jwt_token;
+    uint32_t relay_session_token = 0;
+};
+
+/**
+ * Dials the peer's addresses one after another and falls back to joining
+ * the relay session when none connects
+ * @return PeerPath::None if every address failed and so did the relay, or
+ *         the token was cancelled
+ */
+Task<PeerPath> ConnectPeerOrRelay(IP2PNetwork& network, IRelayClient& relay, PeerConnectPlan plan,
+                                  CancellationToken token = {});
+
+} // namespace Core::Multiplayer::ModelA
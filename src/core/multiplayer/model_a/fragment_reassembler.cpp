@@ -0,0 +1,162 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "fragment_reassembler.h"
+
+namespace Core::Multiplayer::ModelA {
+
+namespace {
+struct FragmentHeader {
+    uint8_t index = 0;
+    uint8_t count = 0;
+};
+using FragmentHeaderLayout =
+    Wire::Layout<RelayProtocol::FRAGMENT_HEADER_SIZE, Wire::Field<&FragmentHeader::index, 0>,
+                 Wire::Field<&FragmentHeader::count, 1>>;
+} // namespace
+
+FragmentReassembler::FragmentReassembler(PacketPool& pool, std::chrono::milliseconds timeout)
+    : pool_(pool), timeout_(timeout) {}
+
+bool FragmentReassembler::WriteHeader(std::span<uint8_t, RelayProtocol::FRAGMENT_HEADER_SIZE> out,
+                                      size_t index, size_t count) {
+    if (count < 2 || count > MAX_FRAGMENTS || index >= count) {
+        return false;
+    }
+    FragmentHeaderLayout::Encode({static_cast<uint8_t>(index), static_cast<uint8_t>(count)}, out);
+    return true;
+}
+
+FragmentReassembler::Segments FragmentReassembler::Add(uint32_t source, uint8_t sender,
+                                                       uint32_t sequence,
+                                                       std::span<const uint8_t> fragment,
+                                                       Clock::time_point now) {
+    if (completed_) {
+        Release(*completed_);
+        completed_ = nullptr;
+    }
+    DropExpired(now);
+    ++stats_.fragments;
+
+    FragmentHeader header;
+    if (!FragmentHeaderLayout::TryDecode(fragment, header)) {
+        ++stats_.malformed;
+        return {};
+    }
+    const uint8_t index = header.index;
+    const uint8_t count = header.count;
+    const auto bytes = fragment.subspan(RelayProtocol::FRAGMENT_HEADER_SIZE);
+    if (count < 2 || count > MAX_FRAGMENTS || index >= count || bytes.empty() ||
+        bytes.size() > PacketBuffer::capacity()) {
+        ++stats_.malformed;
+        return {};
+    }
+
+    Pending* pending = Find(source, sender, sequence);
+    if (!pending) {
+        pending = &Open(source, sender, sequence, count, now);
+    } else if (pending->count != count) {
+        ++stats_.malformed;
+        return {};
+    }
+    const uint64_t bit = uint64_t{1} << index;
+    if ((pending->received_mask & bit) != 0) {
+        ++stats_.duplicates;
+        return {};
+    }
+
+    pending->fragments[index] = pool_.Acquire(bytes.data(), bytes.size());
+    if (!pending->fragments[index]) {
+        ++stats_.pool_exhausted;
+        return {};
+    }
+    pending->received_mask |= bit;
+    if (++pending->received < pending->count) {
+        return {};
+    }
+
+    for (size_t i = 0; i < pending->count; ++i) {
+        const PacketBuffer& buffer = pending->fragments[i];
+        segments_[i] = std::span<const uint8_t>(buffer.data(), buffer.size());
+    }
+    pending->active = false;
+    completed_ = pending;
+    ++stats_.completed;
+    return Segments(segments_.data(), pending->count);
+}
+
+void FragmentReassembler::Remove(uint32_t source) {
+    for (auto& pending : pending_) {
+        if (pending.active && pending.source == source) {
+            Release(pending);
+        }
+    }
+}
+
+size_t FragmentReassembler::GetPendingCount() const {
+    size_t count = 0;
+    for (const auto& pending : pending_) {
+        count += pending.active ? 1 : 0;
+    }
+    return count;
+}
+
+FragmentReassembler::Pending* FragmentReassembler::Find(uint32_t source, uint8_t sender,
+                                                        uint32_t sequence) {
+    for (auto& pending : pending_) {
+        if (pending.active && pending.source == source && pending.sender == sender &&
+            pending.sequence == sequence) {
+            return &pending;
+        }
+    }
+    return nullptr;
+}
+
+FragmentReassembler::Pending& FragmentReassembler::Open(uint32_t source, uint8_t sender,
+                                                        uint32_t sequence, uint8_t count,
+                                                        Clock::time_point now) {
+    // A free slot, or else the oldest message, which is the least likely to complete
+    Pending* slot = &pending_[0];
+    for (auto& pending : pending_) {
+        if (!pending.active) {
+            slot = &pending;
+            break;
+        }
+        if (pending.first_arrival < slot->first_arrival) {
+            slot = &pending;
+        }
+    }
+    if (slot->active) {
+        ++stats_.evicted;
+        Release(*slot);
+    }
+
+    slot->active = true;
+    slot->source = source;
+    slot->sender = sender;
+    slot->sequence = sequence;
+    slot->count = count;
+    slot->first_arrival = now;
+    return *slot;
+}
+
+void FragmentReassembler::DropExpired(Clock::time_point now) {
+    for (auto& pending : pending_) {
+        if (pending.active && now - pending.first_arrival >= timeout_) {
+            ++stats_.timed_out;
+            Release(pending);
+        }
+    }
+}
+
+void FragmentReassembler::Release(Pending& pending) {
+    for (size_t i = 0; i < pending.count; ++i) {
+        pending.fragments[i].Reset();
+    }
+    pending.active = false;
+    pending.count = 0;
+    pending.received = 0;
+    pending.received_mask = 0;
+}
+
+} // namespace Core::Multiplayer::ModelA
@@ -0,0 +1,102 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "core/multiplayer/common/packet_buffer.h"
+#include "relay_protocol.h"
+
+namespace Core::Multiplayer::ModelA {
+
+struct FragmentReassemblyStatistics {
+    uint64_t fragments = 0;
+    uint64_t completed = 0;
+    uint64_t duplicates = 0;
+    uint64_t timed_out = 0;      // Partial messages dropped after the timeout
+    uint64_t evicted = 0;        // Partial messages dropped to make room
+    uint64_t malformed = 0;
+    uint64_t pool_exhausted = 0; // Fragments dropped for want of a buffer
+};
+
+/**
+ * Reassembles relay messages sent as EXT_FLAG_FRAGMENT fragments
+ *
+ * Each fragment is kept in a PacketPool buffer as it arrives, in any order,
+ * under its (source, sender, sequence), since each sender of a source numbers
+ * its messages independently; the completed message is handed over as the
+ * list of those buffers' bytes, so it is copied once, by its consumer,
+ * rather than into a contiguous buffer first. A partial message is dropped
+ * once the timeout has passed since its first fragment, checked whenever a
+ * fragment arrives, or to make room when MAX_PENDING are open.
+ *
+ * Allocates nothing after construction. Not thread-safe.
+ */
+class FragmentReassembler {
+public:
+    using Clock = std::chrono::steady_clock;
+    // A message's fragments in order
+    using Segments = std::span<const std::span<const uint8_t>>;
+
+    static constexpr size_t MAX_FRAGMENTS = RelayProtocol::MAX_FRAGMENT_COUNT;
+    static constexpr size_t MAX_PENDING = 8;
+    static constexpr std::chrono::milliseconds DEFAULT_TIMEOUT{200};
+
+    explicit FragmentReassembler(PacketPool& pool,
+                                 std::chrono::milliseconds timeout = DEFAULT_TIMEOUT);
+
+    /**
+     * Adds one fragment, extension included
+     * @return The completed message if this was its last missing fragment,
+     *         otherwise empty. The spans stay valid until the next Add.
+     */
+    Segments Add(uint32_t source, uint8_t sender, uint32_t sequence,
+                 std::span<const uint8_t> fragment, Clock::time_point now = Clock::now());
+
+    // Drops every sender's partial messages from source, e.g. when its session ends
+    void Remove(uint32_t source);
+
+    size_t GetPendingCount() const;
+    FragmentReassemblyStatistics GetStatistics() const { return stats_; }
+
+    /**
+     * Writes a fragment's extension
+     * @return False if index or count is out of range
+     */
+    static bool WriteHeader(std::span<uint8_t, RelayProtocol::FRAGMENT_HEADER_SIZE> out,
+                            size_t index, size_t count);
+
+private:
+    struct Pending {
+        bool active = false;
+        uint32_t source = 0;
+        uint8_t sender = 0;
+        uint32_t sequence = 0;
+        uint8_t count = 0;
+        uint8_t received = 0;
+        uint64_t received_mask = 0;
+        Clock::time_point first_arrival;
+        std::array<PacketBuffer, MAX_FRAGMENTS> fragments;
+    };
+
+    Pending* Find(uint32_t source, uint8_t sender, uint32_t sequence);
+    Pending& Open(uint32_t source, uint8_t sender, uint32_t sequence, uint8_t count,
+                  Clock::time_point now);
+    void DropExpired(Clock::time_point now);
+    static void Release(Pending& pending);
+
+    PacketPool& pool_;
+    const std::chrono::milliseconds timeout_;
+    std::array<Pending, MAX_PENDING> pending_{};
+    // The message last handed out; released by the next Add
+    Pending* completed_ = nullptr;
+    std::array<std::span<const uint8_t>, MAX_FRAGMENTS> segments_{};
+    FragmentReassemblyStatistics stats_;
+};
+
+} // namespace Core::Multiplayer::ModelA
@@ -0,0 +1,110 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "host_identity.h"
+
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+#include <nlohmann/json.hpp>
+
+namespace Core::Multiplayer::ModelA {
+
+namespace {
+using json = nlohmann::json;
+
+constexpr int IDENTITY_FORMAT_VERSION = 1;
+
+std::string ToHex(const std::vector<uint8_t>& bytes) {
+    static constexpr char DIGITS[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(bytes.size() * 2);
+    for (const uint8_t byte : bytes) {
+        hex.push_back(DIGITS[byte >> 4]);
+        hex.push_back(DIGITS[byte & 0xF]);
+    }
+    return hex;
+}
+
+bool FromHex(const std::string& hex, std::vector<uint8_t>& bytes) {
+    if (hex.size() % 2 != 0) {
+        return false;
+    }
+    const auto nibble = [](char c) -> int {
+        if (c >= '0' && c <= '9') {
+            return c - '0';
+        }
+        if (c >= 'a' && c <= 'f') {
+            return c - 'a' + 10;
+        }
+        return -1;
+    };
+    bytes.clear();
+    bytes.reserve(hex.size() / 2);
+    for (size_t i = 0; i < hex.size(); i += 2) {
+        const int high = nibble(hex[i]);
+        const int low = nibble(hex[i + 1]);
+        if (high < 0 || low < 0) {
+            return false;
+        }
+        bytes.push_back(static_cast<uint8_t>(high << 4 | low));
+    }
+    return true;
+}
+} // namespace
+
+std::optional<HostIdentity> LoadHostIdentity(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        return std::nullopt;
+    }
+
+    HostIdentity identity;
+    try {
+        const json document = json::parse(file);
+        if (document.value("version", 0) != IDENTITY_FORMAT_VERSION) {
+            return std::nullopt;
+        }
+        identity.key_type = document.at("key_type").get<std::string>();
+        if (!FromHex(document.at("private_key").get<std::string>(), identity.private_key) ||
+            !FromHex(document.at("public_key").get<std::string>(), identity.public_key)) {
+            return std::nullopt;
+        }
+    } catch (const json::exception&) {
+        return std::nullopt;
+    }
+    if (!identity.IsValid()) {
+        return std::nullopt;
+    }
+    return identity;
+}
+
+bool SaveHostIdentity(const std::string& path, const HostIdentity& identity) {
+    const json document{{"version", IDENTITY_FORMAT_VERSION},
+                        {"key_type", identity.key_type},
+                        {"private_key", ToHex(identity.private_key)},
+                        {"public_key", ToHex(identity.public_key)}};
+
+    // Written aside and renamed over, so a crash never leaves half a key
+    const std::string temp_path = path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+        file << document.dump();
+        if (!file.flush()) {
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::permissions(temp_path,
+                                 std::filesystem::perms::owner_read |
+                                     std::filesystem::perms::owner_write,
+                                 std::filesystem::perm_options::replace, error);
+    std::filesystem::rename(temp_path, path, error);
+    return !error;
+}
+
+} // namespace Core::Multiplayer::ModelA
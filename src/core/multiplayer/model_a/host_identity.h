@@ -0,0 +1,39 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Core::Multiplayer::ModelA {
+
+/**
+ * The libp2p host's key pair. The peer id is derived from the public key,
+ * so keeping the pair keeps the id other players know this host by.
+ */
+struct HostIdentity {
+    std::string key_type; // e.g. "ed25519"
+    std::vector<uint8_t> private_key;
+    std::vector<uint8_t> public_key;
+
+    bool IsValid() const {
+        return !key_type.empty() && !private_key.empty() && !public_key.empty();
+    }
+};
+
+/**
+ * Reads an identity saved by SaveHostIdentity
+ * @return Nothing if the file is missing or unreadable
+ */
+std::optional<HostIdentity> LoadHostIdentity(const std::string& path);
+
+/**
+ * Writes an identity through a temporary file, readable by the owner only
+ * @return False if the file could not be written
+ */
+bool SaveHostIdentity(const std::string& path, const HostIdentity& identity);
+
+} // namespace Core::Multiplayer::ModelA
@@ -3,12 +3,18 @@
 
 #pragma once
 
+#include "core/multiplayer/common/channel_multiplexer.h"
+#include "core/multiplayer/common/clock_sync.h"
+#include "core/multiplayer/common/error_codes.h"
+#include "core/multiplayer/common/packet_buffer.h"
+#include "core/multiplayer/common/priority_send_queue.h"
 #include "p2p_types.h"
 #include <string>
 #include <vector>
 #include <functional>
 #include <cstdint>
 #include <future>
+#include <optional>
 
 namespace Core::Multiplayer::ModelA {
 
@@ -53,9 +59,54 @@ public:
     // Message handling
     virtual MultiplayerResult SendMessage(const std::string& peer_id, const std::string& protocol, const std::vector<uint8_t>& data) = 0;
     virtual MultiplayerResult BroadcastMessage(const std::string& protocol, const std::vector<uint8_t>& data) = 0;
+    // Pooled send path; the default copies for implementations without one
+    virtual MultiplayerResult SendMessage(const std::string& peer_id, const std::string& protocol, const PacketBuffer& packet) {
+        return SendMessage(peer_id, protocol, std::vector<uint8_t>(packet.data(), packet.data() + packet.size()));
+    }
+    // Prioritized send; implementations without send classes ignore the priority
+    virtual MultiplayerResult SendMessage(const std::string& peer_id, const std::string& protocol, const std::vector<uint8_t>& data, SendPriority priority) {
+        return SendMessage(peer_id, protocol, data);
+    }
+    /**
+     * Latest-value-wins send for state packets: a message still waiting for
+     * the peer's stream on the same protocol with the same key is replaced
+     * instead of queued behind. Implementations without a send queue send
+     * it as it is.
+     */
+    virtual MultiplayerResult SendLatestMessage(const std::string& peer_id, const std::string& protocol, const std::vector<uint8_t>& data, SendPriority priority, uint64_t key) {
+        return SendMessage(peer_id, protocol, data, priority);
+    }
+    /**
+     * Sends with a channel's delivery guarantees. Peer streams are already
+     * reliable and ordered, which satisfies every mode, so the default sends
+     * every mode on them and only picks the class: reliable-ordered goes out
+     * as Control, the unreliable modes as Realtime. A datagram-based
+     * implementation would run a ChannelMultiplexer per peer instead.
+     */
+    virtual MultiplayerResult SendMessage(const std::string& peer_id, const std::string& protocol, const std::vector<uint8_t>& data, ChannelMode mode) {
+        return SendMessage(peer_id, protocol, data,
+                           mode == ChannelMode::ReliableOrdered ? SendPriority::Control
+                                                                : SendPriority::Realtime);
+    }
     virtual void RegisterProtocolHandler(const std::string& protocol) = 0;
     virtual void HandleIncomingMessage(const std::string& peer_id, const std::string& protocol, const std::vector<uint8_t>& data) = 0;
 
+    // Handle-based per-packet path; implementations without handles return
+    // invalid handles and reject the overloads
+    virtual PeerHandle GetPeerHandle(const std::string& peer_id) const {
+        return INVALID_PEER_HANDLE;
+    }
+    virtual ProtocolHandle GetProtocolHandle(const std::string& protocol) const {
+        return INVALID_PROTOCOL_HANDLE;
+    }
+    virtual MultiplayerResult SendMessage(PeerHandle peer, ProtocolHandle protocol, const std::vector<uint8_t>& data) {
+        return MultiplayerResult::InvalidParameter;
+    }
+    virtual MultiplayerResult SendMessage(PeerHandle peer, ProtocolHandle protocol, const PacketBuffer& packet) {
+        return SendMessage(peer, protocol, std::vector<uint8_t>(packet.data(), packet.data() + packet.size()));
+    }
+    virtual void HandleIncomingMessage(PeerHandle peer, ProtocolHandle protocol, const std::vector<uint8_t>& data) {}
+
     // NAT traversal
     virtual std::future<MultiplayerResult> DetectNATType() = 0;
     virtual bool CanTraverseNAT(NATType local_nat, NATType remote_nat) const = 0;
@@ -64,6 +115,22 @@ public:
     // Relay management
     virtual std::vector<std::string> GetConfiguredRelayServers() const = 0;
 
+    /**
+     * Private addresses of a peer on this host's LAN, verified by
+     * LanCandidateExchange; dialed before any other address of the peer.
+     * Networks without direct dials ignore them.
+     */
+    virtual void SetPeerLanAddresses(const std::string& peer_id, std::vector<std::string> multiaddrs) {}
+
+    /**
+     * The peer's clock against ours, from timestamps its keepalive echoes
+     * carry: offset, drift, one-way delays and their confidence. Nothing
+     * until synchronized, or from networks that do not measure it.
+     */
+    virtual std::optional<ClockSyncSnapshot> GetPeerClockSync(const std::string& peer_id) const {
+        return std::nullopt;
+    }
+
     // Callbacks
     virtual void SetOnPeerConnectedCallback(std::function<void(const std::string&)> callback) = 0;
     virtual void SetOnPeerDisconnectedCallback(std::function<void(const std::string&)> callback) = 0;
@@ -8,6 +8,7 @@
 #include <functional>
 #include <chrono>
 #include <cstdint>
+#include "core/multiplayer/common/priority_send_queue.h"
 #include "relay_types.h"
 
 namespace Core::Multiplayer::ModelA {
@@ -31,6 +32,10 @@ public:
 
     // Data transmission
     virtual bool SendData(const std::vector<uint8_t>& data) = 0;
+    // Prioritized send; implementations without send classes ignore the priority
+    virtual bool SendData(const std::vector<uint8_t>& data, SendPriority priority) {
+        return SendData(data);
+    }
     virtual void SetOnDataReceived(std::function<void(const std::vector<uint8_t>&)> callback) = 0;
 
     // P2P fallback
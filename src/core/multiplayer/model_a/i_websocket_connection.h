@@ -3,11 +3,64 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "permessage_deflate.h"
 
 namespace Core::Multiplayer::ModelA {
 
+enum class WebSocketFrameType : uint8_t {
+    Text,
+    Binary,
+};
+
+/**
+ * An inbound message as the transport received it, without copying it out
+ * of the receive buffer. A message that arrived in several frames is their
+ * payloads in order rather than one concatenated buffer.
+ *
+ * The fragments are only valid during the callback. A transport that
+ * receives into pooled buffers sets owner; holding it keeps them valid
+ * until it is released, so a consumer can keep the message without a copy.
+ */
+struct WebSocketMessageView {
+    WebSocketFrameType type = WebSocketFrameType::Text;
+    std::span<const std::span<const uint8_t>> fragments;
+    std::shared_ptr<const void> owner;
+
+    size_t size() const {
+        size_t total = 0;
+        for (const auto fragment : fragments) {
+            total += fragment.size();
+        }
+        return total;
+    }
+
+    bool IsContiguous() const { return fragments.size() <= 1; }
+
+    // The payload of a single-fragment message; empty for a fragmented one
+    std::string_view Contiguous() const {
+        if (fragments.size() != 1) {
+            return {};
+        }
+        return {reinterpret_cast<const char*>(fragments[0].data()), fragments[0].size()};
+    }
+
+    // Appends every fragment to out; for consumers that need one buffer
+    void AppendTo(std::string& out) const {
+        out.reserve(out.size() + size());
+        for (const auto fragment : fragments) {
+            out.append(reinterpret_cast<const char*>(fragment.data()), fragment.size());
+        }
+    }
+};
+
 /**
  * WebSocket connection interface
  * This interface abstracts WebSocket connectivity for testing and implementation flexibility
@@ -25,9 +78,41 @@ public:
     // Authentication
     virtual void SetAuthToken(const std::string& token) = 0;
     
+    // TLS session resumption; connections without TLS keep the defaults
+    virtual std::vector<uint8_t> GetTlsSessionTicket() const { return {}; }
+    virtual void SetTlsSessionTicket(const std::vector<uint8_t>& /*ticket*/) {}
+    
+    // permessage-deflate, offered in the next handshake; connections that do
+    // not implement it exchange uncompressed frames
+    virtual void SetCompression(const PerMessageDeflateConfig& /*config*/) {}
+    virtual bool IsCompressionActive() const { return false; }
+    
     // Message handling
     virtual void SendMessage(const std::string& message) = 0;
     virtual void SetOnMessageCallback(std::function<void(const std::string&)> callback) = 0;
+
+    /**
+     * Sends one message from the caller's buffer as a text or binary frame.
+     * Connections without binary frames send it as text, which is all the
+     * string overload could do.
+     */
+    virtual void SendMessage(std::span<const uint8_t> data, WebSocketFrameType /*type*/) {
+        SendMessage(std::string(reinterpret_cast<const char*>(data.data()), data.size()));
+    }
+
+    /**
+     * Receives messages as views over the receive buffer instead of strings;
+     * replaces the string callback. Connections without it deliver each
+     * string they build as a single text fragment.
+     */
+    virtual void SetOnMessageViewCallback(
+        std::function<void(const WebSocketMessageView&)> callback) {
+        SetOnMessageCallback([callback = std::move(callback)](const std::string& message) {
+            const std::span<const uint8_t> fragment(
+                reinterpret_cast<const uint8_t*>(message.data()), message.size());
+            callback(WebSocketMessageView{WebSocketFrameType::Text, {&fragment, 1}, nullptr});
+        });
+    }
     
     // Event callbacks
     virtual void SetOnConnectCallback(std::function<void()> callback) = 0;
@@ -0,0 +1,120 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "ice_candidate_trickle.h"
+
+#include <utility>
+
+namespace Core::Multiplayer::ModelA {
+
+IceCandidateTrickle::IceCandidateTrickle(std::string local_player, std::string connection_type,
+                                         SendCallback send)
+    : local_player_(std::move(local_player)), connection_type_(std::move(connection_type)),
+      send_(std::move(send)) {}
+
+void IceCandidateTrickle::SetOnRemoteCandidate(CandidateCallback callback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    on_remote_candidate_ = std::move(callback);
+}
+
+void IceCandidateTrickle::Begin(const std::string& player, const SessionDescription& description) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    open_.insert(player);
+
+    P2PInfoMessage message = MakeMessage(player);
+    message.session_description = description;
+    message.ice_candidates = local_candidates_;
+    message.end_of_candidates = local_complete_;
+    send_(message);
+}
+
+void IceCandidateTrickle::End(const std::string& player) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    open_.erase(player);
+    remote_.erase(player);
+}
+
+void IceCandidateTrickle::AddLocalCandidate(const IceCandidate& candidate) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (local_complete_ || !local_seen_.insert(candidate.candidate).second) {
+        return;
+    }
+    local_candidates_.push_back(candidate);
+
+    for (const auto& player : open_) {
+        P2PInfoMessage message = MakeMessage(player);
+        message.ice_candidates.push_back(candidate);
+        send_(message);
+    }
+}
+
+void IceCandidateTrickle::CompleteLocalGathering() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (local_complete_) {
+        return;
+    }
+    local_complete_ = true;
+
+    for (const auto& player : open_) {
+        P2PInfoMessage message = MakeMessage(player);
+        message.end_of_candidates = true;
+        send_(message);
+    }
+}
+
+void IceCandidateTrickle::OnP2PInfo(const P2PInfoMessage& message) {
+    std::vector<IceCandidate> added;
+    CandidateCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const bool restart =
+            !message.session_description.type.empty() || !message.session_description.sdp.empty();
+        auto& exchange = remote_[message.from_player];
+        if (restart) {
+            exchange = RemoteExchange{};
+        }
+        for (const auto& candidate : message.ice_candidates) {
+            if (exchange.seen.insert(candidate.candidate).second) {
+                exchange.candidates.push_back(candidate);
+                added.push_back(candidate);
+            }
+        }
+        exchange.complete = exchange.complete || message.end_of_candidates;
+        callback = on_remote_candidate_;
+    }
+
+    // Outside the lock, so checks started from here may query the exchange
+    if (callback) {
+        for (const auto& candidate : added) {
+            callback(message.from_player, candidate);
+        }
+    }
+}
+
+std::vector<IceCandidate> IceCandidateTrickle::GetLocalCandidates() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return local_candidates_;
+}
+
+std::vector<IceCandidate> IceCandidateTrickle::GetRemoteCandidates(
+    const std::string& player) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = remote_.find(player);
+    return it != remote_.end() ? it->second.candidates : std::vector<IceCandidate>{};
+}
+
+bool IceCandidateTrickle::IsRemoteGatheringComplete(const std::string& player) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = remote_.find(player);
+    return it != remote_.end() && it->second.complete;
+}
+
+P2PInfoMessage IceCandidateTrickle::MakeMessage(const std::string& player) const {
+    P2PInfoMessage message;
+    message.from_player = local_player_;
+    message.to_player = player;
+    message.connection_type = connection_type_;
+    return message;
+}
+
+} // namespace Core::Multiplayer::ModelA
@@ -0,0 +1,95 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "room_messages.h"
+
+namespace Core::Multiplayer::ModelA {
+
+/**
+ * Trickle exchange of ICE candidates through the room server.
+ *
+ * Instead of waiting for gathering to finish and sending every candidate in
+ * one P2PInfo message, the session description goes out with whatever has
+ * been gathered so far, normally the host candidates, which are known at
+ * once. Server-reflexive and relay candidates then follow one message each
+ * as their gatherers produce them. Gatherers for different interfaces may
+ * report from any thread at the same time.
+ *
+ * On the receiving side every new remote candidate is handed on as soon as
+ * it arrives, so connectivity checks can start on the first pair while the
+ * peer is still gathering.
+ */
+class IceCandidateTrickle {
+public:
+    // Called with the exchange's lock held, so messages to a player stay in order
+    using SendCallback = std::function<void(const P2PInfoMessage&)>;
+    using CandidateCallback =
+        std::function<void(const std::string& player, const IceCandidate& candidate)>;
+
+    IceCandidateTrickle(std::string local_player, std::string connection_type,
+                        SendCallback send);
+
+    IceCandidateTrickle(const IceCandidateTrickle&) = delete;
+    IceCandidateTrickle& operator=(const IceCandidateTrickle&) = delete;
+
+    void SetOnRemoteCandidate(CandidateCallback callback);
+
+    /**
+     * Opens an exchange with a player, sending the description together with
+     * every local candidate gathered so far
+     */
+    void Begin(const std::string& player, const SessionDescription& description);
+    void End(const std::string& player);
+
+    /**
+     * A candidate from any gatherer, forwarded to every open exchange.
+     * Candidates reported twice are sent once.
+     */
+    void AddLocalCandidate(const IceCandidate& candidate);
+
+    // Every gatherer has finished; each open exchange is told so
+    void CompleteLocalGathering();
+
+    /**
+     * Takes a P2PInfo message received from the room server. One carrying a
+     * description starts the exchange with its sender over.
+     */
+    void OnP2PInfo(const P2PInfoMessage& message);
+
+    std::vector<IceCandidate> GetLocalCandidates() const;
+    std::vector<IceCandidate> GetRemoteCandidates(const std::string& player) const;
+    bool IsRemoteGatheringComplete(const std::string& player) const;
+
+private:
+    struct RemoteExchange {
+        std::vector<IceCandidate> candidates;
+        std::unordered_set<std::string> seen;
+        bool complete = false;
+    };
+
+    P2PInfoMessage MakeMessage(const std::string& player) const;
+
+    const std::string local_player_;
+    const std::string connection_type_;
+    const SendCallback send_;
+
+    mutable std::mutex mutex_;
+    CandidateCallback on_remote_candidate_;
+    std::vector<IceCandidate> local_candidates_;
+    std::unordered_set<std::string> local_seen_;
+    bool local_complete_ = false;
+    // Players an exchange is open with
+    std::unordered_set<std::string> open_;
+    std::unordered_map<std::string, RemoteExchange> remote_;
+};
+
+} // namespace Core::Multiplayer::ModelA
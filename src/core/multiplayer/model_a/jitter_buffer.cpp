@@ -0,0 +1,181 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "jitter_buffer.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace Core::Multiplayer::ModelA {
+
+namespace {
+// Inter-arrival gaps needed before the adaptive delay replaces the target
+constexpr uint32_t MIN_JITTER_SAMPLES = 8;
+// Unwrapped sequences start one wrap in so earlier packets stay positive
+constexpr uint64_t SEQUENCE_ORIGIN = uint64_t{1} << 32;
+} // namespace
+
+JitterBuffer::JitterBuffer(const JitterBufferConfig& config) : config_(config) {
+    config_.reorder_window = std::clamp<uint32_t>(config_.reorder_window, 1, MAX_REORDER_WINDOW);
+    config_.max_delay = std::max(config_.max_delay, config_.min_delay);
+}
+
+JitterBuffer::InsertResult JitterBuffer::Insert(uint32_t sequence,
+                                                std::span<const uint8_t> payload,
+                                                Clock::time_point arrival) {
+    const std::span<const uint8_t> segments[] = {payload};
+    return Insert(sequence, segments, arrival);
+}
+
+JitterBuffer::InsertResult JitterBuffer::Insert(uint32_t sequence,
+                                                std::span<const std::span<const uint8_t>> segments,
+                                                Clock::time_point arrival) {
+    ++stats_.received;
+
+    uint64_t unwrapped;
+    if (!started_) {
+        started_ = true;
+        unwrapped = SEQUENCE_ORIGIN + sequence;
+        next_sequence_ = unwrapped;
+        highest_sequence_ = unwrapped;
+        received_.Mark(unwrapped);
+        UpdateJitter(arrival);
+    } else {
+        unwrapped = Unwrap(sequence);
+        if (received_.CheckAndMark(unwrapped) == decltype(received_)::Result::Duplicate) {
+            ++stats_.duplicates;
+            return InsertResult::Duplicate;
+        }
+        if (unwrapped > highest_sequence_) {
+            highest_sequence_ = unwrapped;
+            UpdateJitter(arrival);
+        } else if (unwrapped < next_sequence_) {
+            ++stats_.late_dropped;
+            return InsertResult::Late;
+        } else {
+            ++stats_.reordered;
+        }
+    }
+
+    if (unwrapped - next_sequence_ >= SLOT_COUNT) {
+        // The sender jumped further ahead than the buffer spans; start over
+        for (auto& slot : slots_) {
+            slot.occupied = false;
+        }
+        stats_.lost += buffered_count_;
+        buffered_count_ = 0;
+        next_sequence_ = unwrapped;
+        ++stats_.resyncs;
+    }
+
+    Slot& slot = SlotFor(unwrapped);
+    slot.occupied = true;
+    slot.sequence = unwrapped;
+    slot.arrival = arrival;
+    slot.payload.clear();
+    for (const auto segment : segments) {
+        slot.payload.insert(slot.payload.end(), segment.begin(), segment.end());
+    }
+    ++buffered_count_;
+    return InsertResult::Accepted;
+}
+
+bool JitterBuffer::PopReady(Clock::time_point now, std::vector<uint8_t>& out_payload,
+                            uint32_t& out_sequence) {
+    const auto release = GetNextReleaseTime();
+    if (!release || now < *release) {
+        return false;
+    }
+
+    // GetNextReleaseTime found one, so this is never null
+    const Slot* next = FindNextBuffered();
+    Slot& slot = SlotFor(next->sequence);
+    stats_.lost += slot.sequence - next_sequence_;
+    next_sequence_ = slot.sequence + 1;
+
+    out_payload.swap(slot.payload);
+    out_sequence = static_cast<uint32_t>(slot.sequence);
+    slot.occupied = false;
+    --buffered_count_;
+    ++stats_.delivered;
+    return true;
+}
+
+std::optional<JitterBuffer::Clock::time_point> JitterBuffer::GetNextReleaseTime() const {
+    const Slot* next = FindNextBuffered();
+    if (!next) {
+        return std::nullopt;
+    }
+    // Once the newest packet is a full window ahead, stop waiting for gaps
+    if (highest_sequence_ - next_sequence_ >= config_.reorder_window) {
+        return next->arrival;
+    }
+    return next->arrival + GetCurrentDelay();
+}
+
+std::chrono::microseconds JitterBuffer::GetCurrentDelay() const {
+    if (!config_.adaptive || jitter_samples_ < MIN_JITTER_SAMPLES) {
+        return config_.target_delay;
+    }
+    return std::clamp(std::chrono::microseconds(jitter_us_ * 2), config_.min_delay,
+                      config_.max_delay);
+}
+
+JitterBufferStatistics JitterBuffer::GetStatistics() const {
+    JitterBufferStatistics stats = stats_;
+    stats.jitter = std::chrono::microseconds(jitter_us_);
+    stats.delay = GetCurrentDelay();
+    return stats;
+}
+
+void JitterBuffer::Reset() {
+    for (auto& slot : slots_) {
+        slot.occupied = false;
+    }
+    buffered_count_ = 0;
+    started_ = false;
+    next_sequence_ = 0;
+    highest_sequence_ = 0;
+    received_.Reset();
+    last_arrival_.reset();
+    gap_average_us_ = 0;
+    jitter_us_ = 0;
+    jitter_samples_ = 0;
+    stats_ = {};
+}
+
+uint64_t JitterBuffer::Unwrap(uint32_t sequence) const {
+    return UnwrapSequence(sequence, highest_sequence_);
+}
+
+void JitterBuffer::UpdateJitter(Clock::time_point arrival) {
+    if (last_arrival_) {
+        const int64_t gap_us =
+            std::chrono::duration_cast<std::chrono::microseconds>(arrival - *last_arrival_)
+                .count();
+        if (jitter_samples_ == 0) {
+            gap_average_us_ = gap_us;
+        } else {
+            gap_average_us_ += (gap_us - gap_average_us_) / 8;
+        }
+        // Smoothed like the RFC 3550 interarrival jitter estimate
+        jitter_us_ += (std::abs(gap_us - gap_average_us_) - jitter_us_) / 16;
+        ++jitter_samples_;
+    }
+    last_arrival_ = arrival;
+}
+
+const JitterBuffer::Slot* JitterBuffer::FindNextBuffered() const {
+    if (buffered_count_ == 0) {
+        return nullptr;
+    }
+    for (uint64_t sequence = next_sequence_; sequence <= highest_sequence_; ++sequence) {
+        const Slot& slot = SlotFor(sequence);
+        if (slot.occupied && slot.sequence == sequence) {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace Core::Multiplayer::ModelA
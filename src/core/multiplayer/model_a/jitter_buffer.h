@@ -0,0 +1,250 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "core/multiplayer/common/replay_window.h"
+#include "core/multiplayer/common/timer_wheel.h"
+
+namespace Core::Multiplayer::ModelA {
+
+/**
+ * Jitter buffer tuning
+ */
+struct JitterBufferConfig {
+    // Playout delay before any jitter has been measured, and the fixed delay
+    // when adaptation is off
+    std::chrono::microseconds target_delay{5000};
+    // Bounds for the adaptive delay; the PRD budget for relay jitter is 10ms
+    std::chrono::microseconds min_delay{0};
+    std::chrono::microseconds max_delay{10000};
+    bool adaptive = true;
+    // How far behind the newest packet a missing one is waited for
+    uint32_t reorder_window = 32;
+};
+
+struct JitterBufferStatistics {
+    uint64_t received = 0;
+    uint64_t delivered = 0;
+    uint64_t reordered = 0;      // Arrived after a higher sequence
+    uint64_t duplicates = 0;
+    uint64_t late_dropped = 0;   // Arrived after its slot was played out
+    uint64_t lost = 0;           // Skipped over when the wait ran out
+    uint64_t resyncs = 0;        // Sequence jumped past the buffer
+    std::chrono::microseconds jitter{0};
+    std::chrono::microseconds delay{0};
+};
+
+/**
+ * Sequence-number jitter buffer for one peer
+ *
+ * Packets are held for a playout delay and released in sequence order, so
+ * bursty or reordered arrival reaches the game as a smooth stream. A packet
+ * whose predecessor is missing waits at most the playout delay, or until it
+ * falls out of the reorder window, before the gap is skipped; the missing
+ * packet is then dropped as late if it still turns up. Duplicates are
+ * suppressed with a sliding bitmap over the last 64 sequence numbers.
+ *
+ * In adaptive mode the delay tracks twice the smoothed inter-arrival jitter,
+ * clamped to [min_delay, max_delay].
+ *
+ * Not thread-safe; KeyedJitterBuffer adds locking and timed release.
+ */
+class JitterBuffer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class InsertResult {
+        Accepted,
+        Duplicate,
+        Late,
+    };
+
+    static constexpr uint32_t MAX_REORDER_WINDOW = 64;
+
+    explicit JitterBuffer(const JitterBufferConfig& config = JitterBufferConfig{});
+
+    InsertResult Insert(uint32_t sequence, std::span<const uint8_t> payload,
+                        Clock::time_point arrival = Clock::now());
+    // Gathers a payload held in several pieces, e.g. reassembled fragments, into its slot
+    InsertResult Insert(uint32_t sequence, std::span<const std::span<const uint8_t>> segments,
+                        Clock::time_point arrival = Clock::now());
+
+    /**
+     * Releases the next packet in sequence order if its playout time has come
+     * @param out_payload Receives the payload; its capacity is swapped into
+     *                    the freed slot for reuse
+     * @return False if nothing is ready yet
+     */
+    bool PopReady(Clock::time_point now, std::vector<uint8_t>& out_payload,
+                  uint32_t& out_sequence);
+
+    // Earliest time PopReady can release something, if anything is buffered
+    std::optional<Clock::time_point> GetNextReleaseTime() const;
+
+    size_t GetBufferedCount() const { return buffered_count_; }
+    std::chrono::microseconds GetCurrentDelay() const;
+    JitterBufferStatistics GetStatistics() const;
+    void Reset();
+
+private:
+    static constexpr size_t SLOT_COUNT = MAX_REORDER_WINDOW * 2;
+
+    struct Slot {
+        bool occupied = false;
+        uint64_t sequence = 0;
+        Clock::time_point arrival;
+        std::vector<uint8_t> payload;
+    };
+
+    uint64_t Unwrap(uint32_t sequence) const;
+    void UpdateJitter(Clock::time_point arrival);
+    const Slot* FindNextBuffered() const;
+    Slot& SlotFor(uint64_t sequence) { return slots_[sequence % SLOT_COUNT]; }
+    const Slot& SlotFor(uint64_t sequence) const { return slots_[sequence % SLOT_COUNT]; }
+
+    JitterBufferConfig config_;
+    std::array<Slot, SLOT_COUNT> slots_{};
+    size_t buffered_count_ = 0;
+
+    bool started_ = false;
+    uint64_t next_sequence_ = 0;    // Next sequence to play out
+    uint64_t highest_sequence_ = 0;
+    // Spans every slot, so no buffered packet is taken twice
+    ReplayWindow<SLOT_COUNT> received_;
+
+    std::optional<Clock::time_point> last_arrival_;
+    int64_t gap_average_us_ = 0;
+    int64_t jitter_us_ = 0;
+    uint32_t jitter_samples_ = 0;
+
+    JitterBufferStatistics stats_;
+};
+
+/**
+ * Per-peer jitter buffers with timed release
+ *
+ * Inserting a packet releases whatever has become ready and schedules a
+ * TimerWheel callback for the next playout time, so held packets go out even
+ * if nothing else arrives. The deliver callback runs under the buffer lock,
+ * on the inserting thread or the wheel thread, in sequence order per key.
+ */
+template <typename Key>
+class KeyedJitterBuffer {
+public:
+    using DeliverCallback = std::function<void(const Key& key, std::vector<uint8_t>& payload)>;
+
+    KeyedJitterBuffer(const JitterBufferConfig& config, DeliverCallback deliver,
+                      std::shared_ptr<TimerWheel> timer_wheel = nullptr)
+        : config_(config), deliver_(std::move(deliver)),
+          timer_wheel_(timer_wheel ? std::move(timer_wheel) : TimerWheel::GetShared()) {}
+
+    ~KeyedJitterBuffer() {
+        Clear();
+    }
+
+    KeyedJitterBuffer(const KeyedJitterBuffer&) = delete;
+    KeyedJitterBuffer& operator=(const KeyedJitterBuffer&) = delete;
+
+    JitterBuffer::InsertResult Insert(const Key& key, uint32_t sequence,
+                                      std::span<const uint8_t> payload) {
+        const std::span<const uint8_t> segments[] = {payload};
+        return Insert(key, sequence, segments);
+    }
+
+    JitterBuffer::InsertResult Insert(const Key& key, uint32_t sequence,
+                                      std::span<const std::span<const uint8_t>> segments) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = buffers_.find(key);
+        if (it == buffers_.end()) {
+            it = buffers_.emplace(key, std::make_unique<JitterBuffer>(config_)).first;
+        }
+        const auto result = it->second->Insert(sequence, segments);
+        ReleaseLocked(JitterBuffer::Clock::now());
+        return result;
+    }
+
+    void Remove(const Key& key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffers_.erase(key);
+    }
+
+    // Drops the buffers of every key the predicate accepts
+    template <typename Predicate>
+    void RemoveIf(Predicate predicate) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::erase_if(buffers_, [&](const auto& entry) { return predicate(entry.first); });
+    }
+
+    std::optional<JitterBufferStatistics> GetStatistics(const Key& key) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = buffers_.find(key);
+        if (it == buffers_.end()) {
+            return std::nullopt;
+        }
+        return it->second->GetStatistics();
+    }
+
+    // Drops every buffer and pending release
+    void Clear() {
+        TimerWheel::TimerId timer;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            buffers_.clear();
+            timer = std::exchange(release_timer_, TimerWheel::INVALID_TIMER_ID);
+        }
+        // Outside the lock: Cancel waits for a running release, which takes it
+        if (timer != TimerWheel::INVALID_TIMER_ID) {
+            timer_wheel_->Cancel(timer);
+        }
+    }
+
+private:
+    void ReleaseLocked(JitterBuffer::Clock::time_point now) {
+        std::optional<JitterBuffer::Clock::time_point> next_release;
+        for (auto& [key, buffer] : buffers_) {
+            uint32_t sequence = 0;
+            while (buffer->PopReady(now, scratch_, sequence)) {
+                deliver_(key, scratch_);
+            }
+            const auto release = buffer->GetNextReleaseTime();
+            if (release && (!next_release || *release < *next_release)) {
+                next_release = release;
+            }
+        }
+
+        if (!next_release || release_timer_ != TimerWheel::INVALID_TIMER_ID) {
+            return;
+        }
+        const auto delay = std::chrono::ceil<std::chrono::milliseconds>(*next_release - now);
+        release_timer_ = timer_wheel_->Schedule(
+            std::max(delay, std::chrono::milliseconds(1)), [this]() {
+                std::lock_guard<std::mutex> lock(mutex_);
+                release_timer_ = TimerWheel::INVALID_TIMER_ID;
+                ReleaseLocked(JitterBuffer::Clock::now());
+            });
+    }
+
+    const JitterBufferConfig config_;
+    const DeliverCallback deliver_;
+    std::shared_ptr<TimerWheel> timer_wheel_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<Key, std::unique_ptr<JitterBuffer>> buffers_;
+    std::vector<uint8_t> scratch_;
+    TimerWheel::TimerId release_timer_{TimerWheel::INVALID_TIMER_ID}; // guarded by mutex_
+};
+
+} // namespace Core::Multiplayer::ModelA
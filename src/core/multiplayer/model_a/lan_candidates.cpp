@@ -0,0 +1,239 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "lan_candidates.h"
+
+#include <array>
+#include <cctype>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <utility>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#endif
+
+namespace Core::Multiplayer::ModelA {
+
+namespace {
+
+constexpr const char* OFFER_TYPE = "lan-host";
+
+// FNV-1a; zero is kept for "unknown"
+uint64_t HashField(std::string_view field) {
+    if (field.empty()) {
+        return 0;
+    }
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (const char c : field) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001B3ull;
+    }
+    return hash != 0 ? hash : 1;
+}
+
+uint64_t NewNonce() {
+    static thread_local std::mt19937_64 generator{std::random_device{}()};
+    uint64_t nonce = 0;
+    while (nonce == 0) {
+        nonce = generator();
+    }
+    return nonce;
+}
+
+bool ParseUnsigned(const std::string& value, int base, uint64_t& out) {
+    char* end = nullptr;
+    out = std::strtoull(value.c_str(), &end, base);
+    return !value.empty() && *end == '\0';
+}
+
+} // namespace
+
+LanFingerprint LanFingerprint::From(const NetworkFingerprint& fingerprint) {
+    return {HashField(fingerprint.public_ip), HashField(fingerprint.gateway_mac)};
+}
+
+bool LanFingerprint::Matches(const LanFingerprint& other) const {
+    if (network == 0 || network != other.network) {
+        return false;
+    }
+    return gateway == 0 || other.gateway == 0 || gateway == other.gateway;
+}
+
+bool IsPrivateAddress(std::string_view ip) {
+    const std::string address(ip);
+    std::array<uint8_t, 16> bytes{};
+    if (inet_pton(AF_INET, address.c_str(), bytes.data()) == 1) {
+        return bytes[0] == 10 || (bytes[0] == 172 && (bytes[1] & 0xF0) == 16) ||
+               (bytes[0] == 192 && bytes[1] == 168) || (bytes[0] == 169 && bytes[1] == 254);
+    }
+    if (inet_pton(AF_INET6, address.c_str(), bytes.data()) == 1) {
+        return (bytes[0] & 0xFE) == 0xFC || (bytes[0] == 0xFE && (bytes[1] & 0xC0) == 0x80);
+    }
+    return false;
+}
+
+P2PInfoMessage EncodeLanCandidateOffer(const LanCandidateOffer& offer,
+                                       const std::string& from_player,
+                                       const std::string& to_player) {
+    P2PInfoMessage message;
+    message.from_player = from_player;
+    message.to_player = to_player;
+    message.connection_type = OFFER_TYPE;
+    for (size_t i = 0; i < offer.candidates.size(); ++i) {
+        const LanHostCandidate& candidate = offer.candidates[i];
+        std::string transport = candidate.transport;
+        for (auto& c : transport) {
+            c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        }
+        // Listed first, tried first
+        const uint32_t priority = static_cast<uint32_t>(offer.candidates.size() - i);
+        message.ice_candidates.push_back(
+            {"candidate:" + std::to_string(i) + " 1 " + transport + ' ' +
+                 std::to_string(priority) + ' ' + candidate.ip + ' ' +
+                 std::to_string(candidate.port) + " typ host",
+             "0", 0});
+    }
+    std::ostringstream sdp;
+    sdp << std::hex << "net=" << offer.fingerprint.network << " gw=" << offer.fingerprint.gateway
+        << std::dec << " nonce=" << offer.nonce << " echo=" << offer.echo;
+    message.session_description.type = OFFER_TYPE;
+    message.session_description.sdp = sdp.str();
+    message.end_of_candidates = true;
+    return message;
+}
+
+std::optional<LanCandidateOffer> DecodeLanCandidateOffer(const P2PInfoMessage& message) {
+    if (message.session_description.type != OFFER_TYPE) {
+        return std::nullopt;
+    }
+
+    LanCandidateOffer offer;
+    std::istringstream fields(message.session_description.sdp);
+    std::string field;
+    bool has_nonce = false;
+    while (fields >> field) {
+        const size_t separator = field.find('=');
+        if (separator == std::string::npos) {
+            continue;
+        }
+        const std::string key = field.substr(0, separator);
+        const std::string value = field.substr(separator + 1);
+        uint64_t number = 0;
+        if (key == "net" && ParseUnsigned(value, 16, number)) {
+            offer.fingerprint.network = number;
+        } else if (key == "gw" && ParseUnsigned(value, 16, number)) {
+            offer.fingerprint.gateway = number;
+        } else if (key == "nonce" && ParseUnsigned(value, 10, number)) {
+            offer.nonce = number;
+            has_nonce = number != 0;
+        } else if (key == "echo" && ParseUnsigned(value, 10, number)) {
+            offer.echo = number;
+        }
+    }
+    if (!has_nonce) {
+        return std::nullopt;
+    }
+
+    for (const auto& candidate : message.ice_candidates) {
+        std::istringstream candidate_fields(candidate.candidate);
+        std::string foundation, component, transport, priority, address;
+        uint32_t port = 0;
+        if (!(candidate_fields >> foundation >> component >> transport >> priority >> address >>
+              port) ||
+            port == 0 || port > 0xFFFF || !IsPrivateAddress(address)) {
+            continue;
+        }
+        for (auto& c : transport) {
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        if (transport != "tcp" && transport != "udp") {
+            continue;
+        }
+        offer.candidates.push_back({address, static_cast<uint16_t>(port), transport});
+    }
+    return offer;
+}
+
+LanCandidateExchange::LanCandidateExchange(std::string local_player, LanFingerprint fingerprint,
+                                           std::vector<LanHostCandidate> candidates,
+                                           SendCallback send, VerifiedCallback on_verified)
+    : local_player_(std::move(local_player)), fingerprint_(fingerprint),
+      candidates_(std::move(candidates)), send_(std::move(send)),
+      on_verified_(std::move(on_verified)) {}
+
+void LanCandidateExchange::Begin(const std::string& player) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Exchange& exchange = exchanges_[player];
+    exchange.nonce = NewNonce();
+    exchange.verified = false;
+    exchange.candidates.clear();
+    SendOfferLocked(player, exchange);
+}
+
+void LanCandidateExchange::End(const std::string& player) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    exchanges_.erase(player);
+}
+
+bool LanCandidateExchange::OnP2PInfo(const P2PInfoMessage& message) {
+    const auto offer = DecodeLanCandidateOffer(message);
+    if (!offer) {
+        return false;
+    }
+    // Players elsewhere are not answered, so they learn nothing of this network
+    if (message.from_player.empty() || !offer->fingerprint.Matches(fingerprint_)) {
+        return true;
+    }
+
+    bool verified_now = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Exchange& exchange = exchanges_[message.from_player];
+        if (exchange.nonce == 0) {
+            exchange.nonce = NewNonce();
+        }
+        if (offer->echo == exchange.nonce) {
+            verified_now = !exchange.verified || exchange.candidates != offer->candidates;
+            exchange.verified = true;
+            exchange.candidates = offer->candidates;
+        }
+        if (exchange.echoed != offer->nonce) {
+            exchange.echoed = offer->nonce;
+            SendOfferLocked(message.from_player, exchange);
+        }
+    }
+
+    // Outside the lock, so the callback may dial and query the exchange
+    if (verified_now && on_verified_) {
+        on_verified_(message.from_player, offer->candidates);
+    }
+    return true;
+}
+
+std::vector<LanHostCandidate> LanCandidateExchange::GetVerifiedCandidates(
+    const std::string& player) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = exchanges_.find(player);
+    if (it == exchanges_.end() || !it->second.verified) {
+        return {};
+    }
+    return it->second.candidates;
+}
+
+void LanCandidateExchange::SendOfferLocked(const std::string& player, Exchange& exchange) {
+    if (!send_) {
+        return;
+    }
+    LanCandidateOffer offer;
+    offer.fingerprint = fingerprint_;
+    offer.nonce = exchange.nonce;
+    offer.echo = exchange.echoed;
+    offer.candidates = candidates_;
+    send_(EncodeLanCandidateOffer(offer, local_player_, player));
+}
+
+} // namespace Core::Multiplayer::ModelA
@@ -0,0 +1,127 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "reachability_cache.h"
+#include "room_messages.h"
+
+namespace Core::Multiplayer::ModelA {
+
+/**
+ * What two players compare to tell whether they sit behind the same router:
+ * hashes of the public address and of the gateway's MAC, so the MAC itself
+ * is never sent to other players. 0 means unknown.
+ */
+struct LanFingerprint {
+    uint64_t network = 0;
+    uint64_t gateway = 0;
+
+    static LanFingerprint From(const NetworkFingerprint& fingerprint);
+
+    // Same public address, and the same gateway when both sides know theirs
+    bool Matches(const LanFingerprint& other) const;
+};
+
+/**
+ * A private address this host accepts connections on
+ */
+struct LanHostCandidate {
+    std::string ip;
+    uint16_t port = 0;
+    std::string transport = "tcp"; // "tcp" or "udp"
+
+    bool operator==(const LanHostCandidate& other) const = default;
+};
+
+// RFC 1918, link-local and unique local addresses
+bool IsPrivateAddress(std::string_view ip);
+
+/**
+ * A player's private host candidates, as a P2PInfo message of its own type.
+ * nonce is the sender's for this exchange; echo is the last nonce it
+ * received from the other player, 0 if none yet.
+ */
+struct LanCandidateOffer {
+    LanFingerprint fingerprint;
+    uint64_t nonce = 0;
+    uint64_t echo = 0;
+    std::vector<LanHostCandidate> candidates;
+};
+
+P2PInfoMessage EncodeLanCandidateOffer(const LanCandidateOffer& offer,
+                                       const std::string& from_player,
+                                       const std::string& to_player);
+// Nothing for another message type; public candidates are dropped
+std::optional<LanCandidateOffer> DecodeLanCandidateOffer(const P2PInfoMessage& message);
+
+/**
+ * Exchange of private host candidates with the other players of a room, so
+ * players behind the same router dial each other's LAN address first
+ * instead of a public address their router may not hairpin.
+ *
+ * Only players whose fingerprint matches are answered. A player's
+ * candidates are handed on once it has echoed the nonce of this side's
+ * current offer, which shows both sides saw each other's offer in this
+ * session and agree they share a network; a stale or replayed offer is
+ * never trusted. The dial itself authenticates the peer id, so a private
+ * address that belongs to another host fails there.
+ */
+class LanCandidateExchange {
+public:
+    // Called with the exchange's lock held, so offers to a player stay in order
+    using SendCallback = std::function<void(const P2PInfoMessage&)>;
+    using VerifiedCallback = std::function<void(const std::string& player,
+                                                const std::vector<LanHostCandidate>& candidates)>;
+
+    LanCandidateExchange(std::string local_player, LanFingerprint fingerprint,
+                         std::vector<LanHostCandidate> candidates, SendCallback send,
+                         VerifiedCallback on_verified);
+
+    LanCandidateExchange(const LanCandidateExchange&) = delete;
+    LanCandidateExchange& operator=(const LanCandidateExchange&) = delete;
+
+    // Sends the player an offer with a fresh nonce, which verification then needs
+    void Begin(const std::string& player);
+    void End(const std::string& player);
+
+    /**
+     * Takes a P2PInfo message received from the room server
+     * @return False if it is not a LAN candidate offer, for other handlers
+     */
+    bool OnP2PInfo(const P2PInfoMessage& message);
+
+    // Empty until the player is verified
+    std::vector<LanHostCandidate> GetVerifiedCandidates(const std::string& player) const;
+
+private:
+    struct Exchange {
+        uint64_t nonce = 0;
+        // Last nonce of the player's this side echoed
+        uint64_t echoed = 0;
+        bool verified = false;
+        std::vector<LanHostCandidate> candidates;
+    };
+
+    void SendOfferLocked(const std::string& player, Exchange& exchange);
+
+    const std::string local_player_;
+    const LanFingerprint fingerprint_;
+    const std::vector<LanHostCandidate> candidates_;
+    const SendCallback send_;
+    const VerifiedCallback on_verified_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Exchange> exchanges_;
+};
+
+} // namespace Core::Multiplayer::ModelA
@@ -2,12 +2,24 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "libp2p_p2p_network.h"
+#include "relay_protocol.h"
+#include "core/multiplayer/common/build_policy.h"
 #include "common/error_codes.h"
+#include "core/multiplayer/common/packet_trace.h"
+#include "core/multiplayer/common/startup_profile.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
 #include <stdexcept>
 #include <sstream>
+#include <utility>
 
 // cpp-libp2p includes
+#include <libp2p/crypto/ed25519_provider/ed25519_provider_impl.hpp>
 #include <libp2p/host/basic_host.hpp>
+#include <libp2p/injector/host_injector.hpp>
+#include <libp2p/transport/quic/transport.hpp>
 #include <libp2p/transport/tcp.hpp>
 #include <libp2p/transport/ws.hpp>
 #include <libp2p/security/noise.hpp>
@@ -23,9 +35,70 @@ using namespace libp2p::protocol;
 
 namespace Core::Multiplayer::ModelA {
 
-Libp2pP2PNetwork::Libp2pP2PNetwork(const P2PNetworkConfig& config)
-    : config_(config), started_(false), detected_nat_type_(NATType::Unknown) {
+namespace {
+/**
+ * One ConnectToPeer race between the direct and relay dials. Whichever
+ * dial finishes after the winner is decided acts on the decision itself.
+ */
+struct ConnectRace {
+    enum class Winner { None, Direct, Relay, Abandoned };
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::optional<MultiplayerResult> direct_result;
+    std::optional<MultiplayerResult> relay_result;
+    std::shared_ptr<connection::Stream> direct_stream;
+    std::shared_ptr<connection::Stream> relay_stream;
+    // Address the direct dial got through on
+    std::string direct_multiaddr;
+    Winner winner = Winner::None;
+};
+
+constexpr const char* LDN_PROTOCOL_ID = "/sudachi/ldn/1.0.0";
+constexpr const char* LDN_BUNDLE_PROTOCOL_ID = "/sudachi/ldn-bundle/1.0.0";
+constexpr const char* KEEPALIVE_PROTOCOL_ID = "/sudachi/keepalive/1.0.0";
+// Protocol ids as framed on the stream, for the paths that write them directly
+constexpr std::string_view LDN_HEADER = "/sudachi/ldn/1.0.0\n";
+constexpr std::string_view LDN_BUNDLE_HEADER = "/sudachi/ldn-bundle/1.0.0\n";
+constexpr std::string_view KEEPALIVE_HEADER = "/sudachi/keepalive/1.0.0\n";
+constexpr size_t SEQUENCE_PREFIX_SIZE = 4;
+
+// Fixed handles of the built-in protocols, in MakeBuiltinProtocols order
+constexpr ProtocolHandle LDN_PROTOCOL_HANDLE = 0;
+constexpr ProtocolHandle LDN_BUNDLE_PROTOCOL_HANDLE = 1;
+constexpr ProtocolHandle KEEPALIVE_PROTOCOL_HANDLE = 2;
+
+// Peer handles keep the table slot in the low bits and its generation above
+constexpr uint32_t PEER_SLOT_BITS = 16;
+constexpr uint32_t PEER_SLOT_MASK = (1u << PEER_SLOT_BITS) - 1;
+
+std::array<uint8_t, SEQUENCE_PREFIX_SIZE> EncodeSequence(uint32_t sequence) {
+    return {static_cast<uint8_t>(sequence), static_cast<uint8_t>(sequence >> 8),
+            static_cast<uint8_t>(sequence >> 16), static_cast<uint8_t>(sequence >> 24)};
+}
+
+constexpr const char* ED25519_KEY_TYPE = "ed25519";
+
+crypto::KeyPair ToKeyPair(const HostIdentity& identity) {
+    return crypto::KeyPair{crypto::PublicKey{{crypto::Key::Type::Ed25519, identity.public_key}},
+                           crypto::PrivateKey{{crypto::Key::Type::Ed25519, identity.private_key}}};
+}
+
+uint64_t NowMicroseconds() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+}
+} // namespace
+
+Libp2pP2PNetwork::Libp2pP2PNetwork(const P2PNetworkConfig& config,
+                                   std::shared_ptr<WorkStealingExecutor> executor)
+    : config_(config), started_(false), detected_nat_type_(NATType::Unknown),
+      executor_(executor ? std::move(executor) : WorkStealingExecutor::GetShared()) {
+    InitializePeerSlab();
     InitializeHost();
+    InitializeReachabilityCache();
+    InitializeAddressBook();
 }
 
 Libp2pP2PNetwork::Libp2pP2PNetwork(
@@ -34,11 +107,14 @@ Libp2pP2PNetwork::Libp2pP2PNetwork(
     std::shared_ptr<transport::TransportManager> transport_manager,
     std::shared_ptr<security::SecurityManager> security_manager)
     : config_(config), host_(host), transport_manager_(transport_manager), 
-      security_manager_(security_manager), started_(false), detected_nat_type_(NATType::Unknown) {
-    
+      security_manager_(security_manager), started_(false), detected_nat_type_(NATType::Unknown),
+      executor_(WorkStealingExecutor::GetShared()) {
+    InitializePeerSlab();
     if (!host_ || !transport_manager_ || !security_manager_) {
         InitializeHost();
     }
+    InitializeReachabilityCache();
+    InitializeAddressBook();
 }
 
 Libp2pP2PNetwork::~Libp2pP2PNetwork() {
@@ -47,35 +123,96 @@ Libp2pP2PNetwork::~Libp2pP2PNetwork() {
     }
 }
 
+void Libp2pP2PNetwork::InitializePeerSlab() {
+    const size_t capacity = std::clamp<size_t>(config_.max_connections, 1, PEER_SLOT_MASK + 1);
+    peer_slab_.reserve(capacity);
+    for (size_t i = 0; i < capacity; ++i) {
+        peer_slab_.push_back(std::make_shared<PeerState>());
+    }
+    slot_generations_.assign(capacity, 0);
+
+    PeerTable table;
+    table.by_id.reserve(capacity);
+    table.by_handle.resize(capacity);
+    PublishPeers(std::move(table));
+}
+
 void Libp2pP2PNetwork::InitializeHost() {
+    StartupSpan span(StartupPhase::HostInit);
     try {
-        // Create basic host with default configuration
-        host_ = std::make_shared<host::BasicHost>();
+        // A persisted key keeps the peer id stable across sessions
+        if (const auto identity = LoadOrCreateIdentity()) {
+            auto injector = injector::makeHostInjector(injector::useKeyPair(ToKeyPair(*identity)));
+            host_ = injector.create<std::shared_ptr<Host>>();
+        } else {
+            host_ = std::make_shared<host::BasicHost>();
+        }
         
         ConfigureTransports();
         ConfigureSecurity();
         SetupProtocolHandlers();
         
     } catch (const std::exception& e) {
+        span.Fail();
         throw std::runtime_error("Failed to initialize libp2p host: " + std::string(e.what()));
     }
 }
 
+std::optional<HostIdentity> Libp2pP2PNetwork::LoadOrCreateIdentity() const {
+    if (config_.identity_key_path.empty()) {
+        return std::nullopt;
+    }
+    if (auto identity = LoadHostIdentity(config_.identity_key_path);
+        identity && identity->key_type == ED25519_KEY_TYPE) {
+        return identity;
+    }
+
+    crypto::ed25519::Ed25519ProviderImpl provider;
+    auto keypair = provider.generate();
+    if (!keypair) {
+        return std::nullopt;
+    }
+    HostIdentity identity;
+    identity.key_type = ED25519_KEY_TYPE;
+    identity.private_key.assign(keypair.value().private_key.begin(), keypair.value().private_key.end());
+    identity.public_key.assign(keypair.value().public_key.begin(), keypair.value().public_key.end());
+    // A failed save only costs the next session this peer id
+    SaveHostIdentity(config_.identity_key_path, identity);
+    return identity;
+}
+
 void Libp2pP2PNetwork::ConfigureTransports() {
     if (!transport_manager_) {
         transport_manager_ = std::make_shared<transport::TransportManager>();
     }
     
-    // Add TCP transport
-    if (config_.enable_tcp) {
-        auto tcp_transport = std::make_shared<transport::TcpTransport>();
-        transport_manager_->add(tcp_transport);
+    // Transports the build policy leaves out are never referenced, so their
+    // stacks are not linked in; the config can only turn built ones off
+    using Transports = ActiveBuildPolicy::Transports;
+
+    // QUIC goes first: one round trip to a secured, multiplexed connection
+    // whose streams do not block each other. Dials prefer it, see OrderDialAddresses
+    if constexpr (Transports::quic) {
+        if (config_.enable_quic) {
+            auto quic_transport = std::make_shared<transport::QuicTransport>();
+            transport_manager_->add(quic_transport);
+        }
+    }
+    
+    // TCP is the fallback for peers or networks without UDP
+    if constexpr (Transports::tcp) {
+        if (config_.enable_tcp) {
+            auto tcp_transport = std::make_shared<transport::TcpTransport>();
+            transport_manager_->add(tcp_transport);
+        }
     }
     
     // Add WebSocket transport
-    if (config_.enable_websocket) {
-        auto ws_transport = std::make_shared<transport::WsTransport>();
-        transport_manager_->add(ws_transport);
+    if constexpr (Transports::websocket) {
+        if (config_.enable_websocket) {
+            auto ws_transport = std::make_shared<transport::WsTransport>();
+            transport_manager_->add(ws_transport);
+        }
     }
 }
 
@@ -91,7 +228,7 @@ void Libp2pP2PNetwork::ConfigureSecurity() {
 
 void Libp2pP2PNetwork::SetupProtocolHandlers() {
     // Register default Sudachi LDN protocol
-    RegisterProtocolHandler("/sudachi/ldn/1.0.0");
+    RegisterProtocolHandler(LDN_PROTOCOL_ID);
     
     // Setup AutoNAT for NAT detection
     if (config_.enable_nat_traversal) {
@@ -105,17 +242,25 @@ void Libp2pP2PNetwork::SetupProtocolHandlers() {
 }
 
 MultiplayerResult Libp2pP2PNetwork::Start() {
-    std::lock_guard<std::mutex> lock(state_mutex_);
+    std::lock_guard lock(state_mutex_);
     
     if (started_) {
         return {ErrorCode::AlreadyConnected, "P2P network already started"};
     }
     
+    StartupSpan span(StartupPhase::HostStart);
     try {
         // Start the host
         host_->start();
         
-        // Start AutoNAT service
+        // A known network starts from its cached NAT type
+        if (const auto cached = GetCachedReachability();
+            cached && cached->nat_type >= 0 && cached->nat_type <= static_cast<int>(NATType::NoNAT)) {
+            detected_nat_type_ = static_cast<NATType>(cached->nat_type);
+            on_nat_detected_.Publish(detected_nat_type_, cached->can_traverse);
+        }
+        
+        // Start AutoNAT service; with a cached result this revalidates it
         if (autonat_service_) {
             DetectNATType(); // Trigger NAT detection
         }
@@ -129,12 +274,17 @@ MultiplayerResult Libp2pP2PNetwork::Start() {
         return {ErrorCode::Success, "P2P network started successfully"};
         
     } catch (const std::exception& e) {
+        span.Fail();
         return {ErrorCode::InternalError, "Failed to start P2P network: " + std::string(e.what())};
     }
 }
 
 MultiplayerResult Libp2pP2PNetwork::Stop() {
-    std::lock_guard<std::mutex> lock(state_mutex_);
+    if (jitter_buffer_) {
+        jitter_buffer_->Clear();
+    }
+
+    std::lock_guard lock(state_mutex_);
     
     if (!started_) {
         return {ErrorCode::NotConnected, "P2P network not started"};
@@ -151,9 +301,7 @@ MultiplayerResult Libp2pP2PNetwork::Stop() {
         }
         
         // Close all connections
-        connected_peers_.clear();
-        relay_connected_peers_.clear();
-        peer_streams_.clear();
+        PublishPeers({});
         
         started_ = false;
         return {ErrorCode::Success, "P2P network stopped successfully"};
@@ -168,7 +316,7 @@ MultiplayerResult Libp2pP2PNetwork::Shutdown() {
 }
 
 bool Libp2pP2PNetwork::IsStarted() const {
-    std::lock_guard<std::mutex> lock(state_mutex_);
+    std::lock_guard lock(state_mutex_);
     return started_;
 }
 
@@ -180,10 +328,16 @@ std::string Libp2pP2PNetwork::GetPeerId() const {
 }
 
 MultiplayerResult Libp2pP2PNetwork::ConnectToPeer(const std::string& peer_id, const std::string& multiaddr) {
-    std::lock_guard<std::mutex> lock(state_mutex_);
-    
-    if (!started_) {
-        return {ErrorCode::NotInitialized, "P2P network not started"};
+    {
+        std::lock_guard lock(state_mutex_);
+        if (!started_) {
+            return {ErrorCode::NotInitialized, "P2P network not started"};
+        }
+        // Checked again when the peer is installed, as dials run concurrently
+        const auto peers = peers_.load(std::memory_order_acquire);
+        if (peers->by_id.size() >= peer_slab_.size() && !peers->by_id.contains(peer_id)) {
+            return {ErrorCode::ResourceExhausted, "Connection limit reached"};
+        }
     }
     
     try {
@@ -194,41 +348,288 @@ MultiplayerResult Libp2pP2PNetwork::ConnectToPeer(const std::string& peer_id, co
             return {ErrorCode::InvalidParameter, "Invalid multiaddress: " + multiaddr};
         }
         
-        // Try direct connection first
-        auto result = AttemptDirectConnection(peer_id_obj, addr.value());
-        if (result.IsSuccess()) {
-            return result;
+        // A peer reached before is dialed the way that last worked first
+        std::vector<std::string> multiaddrs{multiaddr};
+        auto relay_head_start = std::chrono::milliseconds(config_.relay_head_start_ms);
+        const auto known = GetKnownPeerAddress(peer_id);
+        if (known && !known->multiaddr.empty() && known->multiaddr != multiaddr) {
+            multiaddrs.insert(multiaddrs.begin(), known->multiaddr);
+        }
+        if (known && known->via_relay) {
+            relay_head_start = std::chrono::milliseconds(0);
+        }
+        multiaddrs = OrderDialAddresses(std::move(multiaddrs), config_);
+        // A peer on the same LAN is dialed there first, whatever the transport
+        // preference, and the relay waits for it even if it won last time
+        auto lan_multiaddrs = OrderDialAddresses(GetPeerLanAddresses(peer_id), config_);
+        if (!lan_multiaddrs.empty()) {
+            std::erase_if(multiaddrs, [&](const std::string& multiaddr) {
+                return std::find(lan_multiaddrs.begin(), lan_multiaddrs.end(), multiaddr) != lan_multiaddrs.end();
+            });
+            multiaddrs.insert(multiaddrs.begin(), lan_multiaddrs.begin(), lan_multiaddrs.end());
+            relay_head_start = std::chrono::milliseconds(config_.relay_head_start_ms);
+        }
+        if (multiaddrs.empty()) {
+            return {ErrorCode::InvalidParameter, "No enabled transport for: " + multiaddr};
         }
         
-        // Fall back to relay connection if direct fails
         if (config_.enable_relay) {
-            return AttemptRelayConnection(peer_id_obj);
+            return RaceConnections(peer_id_obj, std::move(multiaddrs), relay_head_start);
         }
         
-        return result;
+        std::shared_ptr<connection::Stream> stream;
+        std::string connected_multiaddr;
+        auto result = AttemptDirectConnections(peer_id_obj, multiaddrs, stream, connected_multiaddr);
+        if (!result.IsSuccess()) {
+            if (address_book_) {
+                address_book_->Forget(peer_id);
+            }
+            return result;
+        }
+        if (address_book_) {
+            address_book_->RecordSuccess(peer_id, connected_multiaddr, false);
+        }
+        std::lock_guard lock(state_mutex_);
+        return InstallPeer(peer_id_obj, std::move(stream), false, ClassifyMultiaddr(connected_multiaddr));
         
     } catch (const std::exception& e) {
         return {ErrorCode::ConnectionFailed, "Failed to connect to peer: " + std::string(e.what())};
     }
 }
 
-MultiplayerResult Libp2pP2PNetwork::AttemptDirectConnection(const peer::PeerId& peer_id, const multi::Multiaddress& addr) {
+void Libp2pP2PNetwork::SetPeerLanAddresses(const std::string& peer_id, std::vector<std::string> multiaddrs) {
+    std::lock_guard lock(lan_addresses_mutex_);
+    if (multiaddrs.empty()) {
+        lan_addresses_.erase(peer_id);
+    } else {
+        lan_addresses_[peer_id] = std::move(multiaddrs);
+    }
+}
+
+std::vector<std::string> Libp2pP2PNetwork::GetPeerLanAddresses(const std::string& peer_id) const {
+    std::lock_guard lock(lan_addresses_mutex_);
+    const auto it = lan_addresses_.find(peer_id);
+    return it != lan_addresses_.end() ? it->second : std::vector<std::string>{};
+}
+
+MultiplayerResult Libp2pP2PNetwork::RaceConnections(const peer::PeerId& peer_id,
+                                                    std::vector<std::string> multiaddrs,
+                                                    std::chrono::milliseconds relay_head_start) {
+    auto race = std::make_shared<ConnectRace>();
+    const std::string peer_id_str = PeerIdToString(peer_id);
+    // Recorded for a later direct attempt should the relay win
+    const std::string fallback_multiaddr = multiaddrs.back();
+    
+    connect_tasks_.Submit([this, race, peer_id, multiaddrs = std::move(multiaddrs), peer_id_str] {
+        std::shared_ptr<connection::Stream> stream;
+        std::string connected_multiaddr;
+        auto result = AttemptDirectConnections(peer_id, multiaddrs, stream, connected_multiaddr);
+        ConnectRace::Winner winner;
+        {
+            std::lock_guard<std::mutex> lock(race->mutex);
+            race->direct_result = result;
+            race->direct_stream = stream;
+            race->direct_multiaddr = connected_multiaddr;
+            winner = race->winner;
+        }
+        race->cv.notify_all();
+        
+        // Undecided races pick this stream up themselves
+        if (stream && winner == ConnectRace::Winner::Relay) {
+            if (address_book_) {
+                address_book_->RecordSuccess(peer_id_str, connected_multiaddr, false);
+            }
+            UpgradeToDirect(peer_id_str, std::move(stream), ClassifyMultiaddr(connected_multiaddr));
+        } else if (stream && winner == ConnectRace::Winner::Abandoned) {
+            stream->close();
+        }
+    });
+    
+    // Waits on the race, running pool work meanwhile; this may itself be a
+    // pool thread, and the dials need one
+    const auto wait_until = [&](std::chrono::steady_clock::time_point until, auto done) {
+        while (true) {
+            {
+                std::lock_guard<std::mutex> lock(race->mutex);
+                if (done() || std::chrono::steady_clock::now() >= until) {
+                    return;
+                }
+            }
+            if (executor_->TryRunPendingTask()) {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(race->mutex);
+            race->cv.wait_until(lock, std::min(until, std::chrono::steady_clock::now() + std::chrono::milliseconds(1)), done);
+        }
+    };
+    const auto direct_succeeded = [&] {
+        return race->direct_result && race->direct_result->IsSuccess();
+    };
+    
+    const auto start = std::chrono::steady_clock::now();
+    const auto deadline = start + std::chrono::milliseconds(config_.connection_timeout_ms);
+    wait_until(start + relay_head_start, [&] { return race->direct_result.has_value(); });
+    
+    bool relay_started = false;
+    {
+        std::lock_guard<std::mutex> lock(race->mutex);
+        relay_started = !direct_succeeded();
+    }
+    if (relay_started) {
+        connect_tasks_.Submit([this, race, peer_id] {
+            std::shared_ptr<connection::Stream> stream;
+            auto result = AttemptRelayConnection(peer_id, stream);
+            ConnectRace::Winner winner;
+            {
+                std::lock_guard<std::mutex> lock(race->mutex);
+                race->relay_result = result;
+                race->relay_stream = stream;
+                winner = race->winner;
+            }
+            race->cv.notify_all();
+            
+            if (stream && winner != ConnectRace::Winner::None) {
+                stream->close();
+            }
+        });
+        wait_until(deadline, [&] {
+            return direct_succeeded() || (race->relay_result && race->relay_result->IsSuccess()) ||
+                   (race->direct_result && race->relay_result);
+        });
+    }
+    
+    // Lock order is state_mutex_, then the race
+    std::lock_guard state_lock(state_mutex_);
+    std::shared_ptr<connection::Stream> stream;
+    bool via_relay = false;
+    std::string connected_multiaddr = fallback_multiaddr;
+    MultiplayerResult failure{ErrorCode::ConnectionTimeout, "Connection to peer timed out"};
+    {
+        std::lock_guard<std::mutex> lock(race->mutex);
+        if (direct_succeeded()) {
+            race->winner = ConnectRace::Winner::Direct;
+            stream = race->direct_stream;
+            connected_multiaddr = race->direct_multiaddr;
+            if (race->relay_stream) {
+                race->relay_stream->close();
+            }
+        } else if (race->relay_result && race->relay_result->IsSuccess()) {
+            // The direct dial keeps going and upgrades the connection if it gets through
+            race->winner = ConnectRace::Winner::Relay;
+            stream = race->relay_stream;
+            via_relay = true;
+        } else {
+            race->winner = ConnectRace::Winner::Abandoned;
+            if (race->relay_result) {
+                failure = *race->relay_result;
+            } else if (race->direct_result) {
+                failure = *race->direct_result;
+            }
+        }
+    }
+    if (!stream) {
+        if (address_book_) {
+            address_book_->Forget(peer_id_str);
+        }
+        return failure;
+    }
+    if (address_book_) {
+        address_book_->RecordSuccess(peer_id_str, connected_multiaddr, via_relay);
+    }
+    return InstallPeer(peer_id, std::move(stream), via_relay,
+                       via_relay ? P2PTransport::Relay : ClassifyMultiaddr(connected_multiaddr));
+}
+
+MultiplayerResult Libp2pP2PNetwork::InstallPeer(const peer::PeerId& peer_id,
+                                                std::shared_ptr<connection::Stream> stream,
+                                                bool via_relay, P2PTransport transport) {
+    // Caller must hold state_mutex_
+    const std::string peer_id_str = PeerIdToString(peer_id);
+    auto peer = AcquirePeer(peer_id_str);
+    if (!peer) {
+        stream->close();
+        on_connection_failed_.Publish(peer_id_str, "connection-limit-reached");
+        return {ErrorCode::ResourceExhausted, "Connection limit reached"};
+    }
+    peer->stream = stream;
+    peer->transport.store(transport, std::memory_order_relaxed);
+    peer->via_relay.store(via_relay, std::memory_order_relaxed);
+    OpenControlStream(*peer);
+    const auto control_stream = peer->control_stream;
+    const PeerHandle handle = peer->handle;
+    AddPeer(std::move(peer));
+    
+    // Setup stream handling
+    OnConnectionEstablished(handle, stream);
+    if (control_stream) {
+        OnControlStreamEstablished(handle, control_stream);
+    }
+    
+    on_peer_connected_.Publish(peer_id_str);
+    if (!via_relay) {
+        return {ErrorCode::Success, "Connected to peer directly"};
+    }
+    
+    on_relay_connected_.Publish(peer_id_str, "relay-connection");
+    return {ErrorCode::Success, "Connected to peer via relay"};
+}
+
+void Libp2pP2PNetwork::UpgradeToDirect(const std::string& peer_id,
+                                       std::shared_ptr<connection::Stream> stream,
+                                       P2PTransport transport) {
+    std::lock_guard lock(state_mutex_);
+    const auto peer = FindPeer(peer_id);
+    if (!peer || !peer->via_relay.load(std::memory_order_relaxed)) {
+        // Disconnected, or replaced by a newer connection, in the meantime
+        stream->close();
+        return;
+    }
+    
+    std::shared_ptr<connection::Stream> relay_stream;
+    std::shared_ptr<connection::Stream> control_stream;
+    {
+        // Held messages leave on the relay, then the next write takes the
+        // direct path; the handle, sequence numbers and RTT carry over
+        std::lock_guard write_lock(peer->write_mutex);
+        FlushBundleLocked(*peer);
+        relay_stream = std::exchange(peer->stream, stream);
+        peer->transport.store(transport, std::memory_order_relaxed);
+        OpenControlStream(*peer);
+        control_stream = peer->control_stream;
+        peer->via_relay.store(false, std::memory_order_relaxed);
+    }
+    OnConnectionEstablished(peer->handle, stream);
+    if (control_stream) {
+        OnControlStreamEstablished(peer->handle, control_stream);
+    }
+    relay_stream->close();
+}
+
+void Libp2pP2PNetwork::OpenControlStream(PeerState& peer) {
+    // QUIC streams are independent, so a lost game packet no longer holds up
+    // keepalives and RTT samples stay honest; over TCP a second stream would
+    // share the same byte stream and gain nothing
+    if (peer.transport.load(std::memory_order_relaxed) != P2PTransport::Quic || peer.control_stream) {
+        return;
+    }
+    try {
+        auto stream_result = host_->newStream(StringToPeerId(peer.peer_id), KEEPALIVE_PROTOCOL_ID);
+        if (stream_result) {
+            peer.control_stream = stream_result.value();
+        }
+    } catch (const std::exception&) {
+        // Keepalives stay on the game stream
+    }
+}
+
+MultiplayerResult Libp2pP2PNetwork::AttemptDirectConnection(const peer::PeerId& peer_id, const multi::Multiaddress& addr,
+                                                            std::shared_ptr<connection::Stream>& stream) {
     try {
         // Connect using libp2p host
         auto connection_result = host_->connect(peer_id, addr);
         
         if (connection_result) {
-            auto stream = connection_result.value();
-            peer_streams_[PeerIdToString(peer_id)] = stream;
-            connected_peers_.insert(PeerIdToString(peer_id));
-            
-            // Setup stream handling
-            OnConnectionEstablished(peer_id, stream);
-            
-            if (on_peer_connected_) {
-                on_peer_connected_(PeerIdToString(peer_id));
-            }
-            
+            stream = connection_result.value();
             return {ErrorCode::Success, "Connected to peer directly"};
         } else {
             return {ErrorCode::ConnectionFailed, "Direct connection failed"};
@@ -239,7 +640,27 @@ MultiplayerResult Libp2pP2PNetwork::AttemptDirectConnection(const peer::PeerId&
     }
 }
 
-MultiplayerResult Libp2pP2PNetwork::AttemptRelayConnection(const peer::PeerId& peer_id) {
+MultiplayerResult Libp2pP2PNetwork::AttemptDirectConnections(const peer::PeerId& peer_id,
+                                                             const std::vector<std::string>& multiaddrs,
+                                                             std::shared_ptr<connection::Stream>& stream,
+                                                             std::string& connected_multiaddr) {
+    MultiplayerResult result{ErrorCode::InvalidParameter, "No usable multiaddress"};
+    for (const auto& multiaddr : multiaddrs) {
+        auto addr = multi::Multiaddress::create(multiaddr);
+        if (!addr) {
+            continue;
+        }
+        result = AttemptDirectConnection(peer_id, addr.value(), stream);
+        if (result.IsSuccess()) {
+            connected_multiaddr = multiaddr;
+            break;
+        }
+    }
+    return result;
+}
+
+MultiplayerResult Libp2pP2PNetwork::AttemptRelayConnection(const peer::PeerId& peer_id,
+                                                           std::shared_ptr<connection::Stream>& stream) {
     try {
         if (!circuit_relay_) {
             return {ErrorCode::NotSupported, "Circuit relay not enabled"};
@@ -249,53 +670,36 @@ MultiplayerResult Libp2pP2PNetwork::AttemptRelayConnection(const peer::PeerId& p
         auto relay_result = circuit_relay_->connect(peer_id);
         
         if (relay_result) {
-            auto stream = relay_result.value();
-            peer_streams_[PeerIdToString(peer_id)] = stream;
-            connected_peers_.insert(PeerIdToString(peer_id));
-            relay_connected_peers_.insert(PeerIdToString(peer_id));
-            
-            OnConnectionEstablished(peer_id, stream);
-            
-            if (on_peer_connected_) {
-                on_peer_connected_(PeerIdToString(peer_id));
-            }
-            
-            if (on_relay_connected_) {
-                on_relay_connected_(PeerIdToString(peer_id), "relay-connection");
-            }
-            
+            stream = relay_result.value();
             return {ErrorCode::Success, "Connected to peer via relay"};
         } else {
-            if (on_relay_failed_) {
-                on_relay_failed_(PeerIdToString(peer_id), "relay-connection-failed");
-            }
+            on_relay_failed_.Publish(PeerIdToString(peer_id), "relay-connection-failed");
             return {ErrorCode::ConnectionFailed, "Relay connection failed"};
         }
         
     } catch (const std::exception& e) {
-        if (on_relay_failed_) {
-            on_relay_failed_(PeerIdToString(peer_id), e.what());
-        }
+        on_relay_failed_.Publish(PeerIdToString(peer_id), e.what());
         return {ErrorCode::ConnectionFailed, "Relay connection error: " + std::string(e.what())};
     }
 }
 
 MultiplayerResult Libp2pP2PNetwork::DisconnectFromPeer(const std::string& peer_id) {
-    std::lock_guard<std::mutex> lock(state_mutex_);
+    std::lock_guard lock(state_mutex_);
     
     try {
-        auto it = peer_streams_.find(peer_id);
-        if (it != peer_streams_.end()) {
-            it->second->close();
-            peer_streams_.erase(it);
+        if (auto peer = RemovePeer(peer_id)) {
+            if (jitter_buffer_) {
+                jitter_buffer_->Remove(peer->handle);
+            }
+            // Senders still holding the old table finish before the close
+            std::lock_guard write_lock(peer->write_mutex);
+            if (peer->control_stream) {
+                peer->control_stream->close();
+            }
+            peer->stream->close();
         }
         
-        connected_peers_.erase(peer_id);
-        relay_connected_peers_.erase(peer_id);
-        
-        if (on_peer_disconnected_) {
-            on_peer_disconnected_(peer_id);
-        }
+        on_peer_disconnected_.Publish(peer_id);
         
         return {ErrorCode::Success, "Disconnected from peer"};
         
@@ -305,88 +709,340 @@ MultiplayerResult Libp2pP2PNetwork::DisconnectFromPeer(const std::string& peer_i
 }
 
 bool Libp2pP2PNetwork::IsConnectedToPeer(const std::string& peer_id) const {
-    std::lock_guard<std::mutex> lock(state_mutex_);
-    return connected_peers_.count(peer_id) > 0;
+    return peers_.load(std::memory_order_acquire)->by_id.count(peer_id) > 0;
 }
 
 bool Libp2pP2PNetwork::IsConnectedViaRelay(const std::string& peer_id) const {
-    std::lock_guard<std::mutex> lock(state_mutex_);
-    return relay_connected_peers_.count(peer_id) > 0;
+    const auto peer = FindPeer(peer_id);
+    return peer && peer->via_relay.load(std::memory_order_relaxed);
 }
 
 size_t Libp2pP2PNetwork::GetConnectionCount() const {
-    std::lock_guard<std::mutex> lock(state_mutex_);
-    return connected_peers_.size();
+    return peers_.load(std::memory_order_acquire)->by_id.size();
 }
 
 std::vector<std::string> Libp2pP2PNetwork::GetConnectedPeers() const {
-    std::lock_guard<std::mutex> lock(state_mutex_);
-    return std::vector<std::string>(connected_peers_.begin(), connected_peers_.end());
+    const auto peers = peers_.load(std::memory_order_acquire);
+    std::vector<std::string> result;
+    result.reserve(peers->by_id.size());
+    for (const auto& [peer_id, peer] : peers->by_id) {
+        result.push_back(peer_id);
+    }
+    return result;
 }
 
 MultiplayerResult Libp2pP2PNetwork::SendMessage(const std::string& peer_id, const std::string& protocol, const std::vector<uint8_t>& data) {
-    std::lock_guard<std::mutex> lock(state_mutex_);
-    
-    auto it = peer_streams_.find(peer_id);
-    if (it == peer_streams_.end()) {
+    const auto peer = FindPeer(peer_id);
+    if (!peer) {
         return {ErrorCode::NotConnected, "Not connected to peer: " + peer_id};
     }
-    
-    try {
-        auto& stream = it->second;
-        
-        // Write protocol header
-        std::string header = protocol + "\n";
-        stream->write(gsl::span<const uint8_t>(reinterpret_cast<const uint8_t*>(header.data()), header.size()));
-        
-        // Write data
-        stream->write(gsl::span<const uint8_t>(data.data(), data.size()));
-        
-        return {ErrorCode::Success, "Message sent successfully"};
-        
-    } catch (const std::exception& e) {
-        return {ErrorCode::NetworkError, "Failed to send message: " + std::string(e.what())};
+    return SendByName(*peer, protocol, data.data(), data.size());
+}
+
+MultiplayerResult Libp2pP2PNetwork::SendMessage(const std::string& peer_id, const std::string& protocol, const PacketBuffer& packet) {
+    const auto peer = FindPeer(peer_id);
+    if (!peer) {
+        return {ErrorCode::NotConnected, "Not connected to peer: " + peer_id};
     }
+    // Stream writes straight from the pooled slab, no intermediate vector
+    return SendByName(*peer, protocol, packet.data(), packet.size());
+}
+
+MultiplayerResult Libp2pP2PNetwork::SendMessage(const std::string& peer_id, const std::string& protocol, const std::vector<uint8_t>& data, SendPriority priority) {
+    const auto peer = FindPeer(peer_id);
+    if (!peer) {
+        return {ErrorCode::NotConnected, "Not connected to peer: " + peer_id};
+    }
+    return SendByName(*peer, protocol, data.data(), data.size(), priority);
+}
+
+MultiplayerResult Libp2pP2PNetwork::SendLatestMessage(const std::string& peer_id, const std::string& protocol, const std::vector<uint8_t>& data, SendPriority priority, uint64_t key) {
+    const auto peer = FindPeer(peer_id);
+    if (!peer) {
+        return {ErrorCode::NotConnected, "Not connected to peer: " + peer_id};
+    }
+    return SendByName(*peer, protocol, data.data(), data.size(), priority, key);
 }
 
 MultiplayerResult Libp2pP2PNetwork::BroadcastMessage(const std::string& protocol, const std::vector<uint8_t>& data) {
-    std::lock_guard<std::mutex> lock(state_mutex_);
+    // Peers joining or leaving mid-broadcast publish a new table; this one stays intact
+    const auto peers = peers_.load(std::memory_order_acquire);
+    if (peers->by_id.empty()) {
+        return {ErrorCode::Success, "Broadcast sent to all peers"};
+    }
     
-    size_t success_count = 0;
-    size_t total_peers = connected_peers_.size();
+    // The protocol is resolved and its header built once for every peer
+    const auto protocols = protocols_.load(std::memory_order_acquire);
+    const auto registered = protocols->handles.find(protocol);
+    const ProtocolHandle protocol_handle =
+        registered != protocols->handles.end() ? registered->second : INVALID_PROTOCOL_HANDLE;
+    const std::string header = protocol_handle != INVALID_PROTOCOL_HANDLE
+                                   ? protocols->entries[protocol_handle].header
+                                   : protocol + "\n";
     
-    for (const auto& peer_id : connected_peers_) {
-        auto result = SendMessage(peer_id, protocol, data);
-        if (result.IsSuccess()) {
+    // Every peer writes from the caller's data, which outlives the group
+    // since Wait returns only once all writes are done
+    ExecutorTaskGroup writes(executor_);
+    std::vector<std::pair<const std::string*, std::future<MultiplayerResult>>> pending;
+    pending.reserve(peers->by_id.size() - 1);
+    auto it = peers->by_id.begin();
+    const auto& [first_id, first_peer] = *it;
+    for (++it; it != peers->by_id.end(); ++it) {
+        PeerState* peer = it->second.get();
+        pending.emplace_back(&it->first, writes.Submit([this, peer, protocol_handle, &header, &data] {
+            return SendToPeer(*peer, protocol_handle, header, data.data(), data.size());
+        }));
+    }
+    const bool first_sent =
+        SendToPeer(*first_peer, protocol_handle, header, data.data(), data.size()).IsSuccess();
+    writes.Wait();
+    
+    size_t total_peers = peers->by_id.size();
+    size_t success_count = first_sent ? 1 : 0;
+    std::string failed_peers = first_sent ? "" : first_id;
+    for (auto& [peer_id, result] : pending) {
+        if (result.get().IsSuccess()) {
             success_count++;
+        } else {
+            failed_peers += (failed_peers.empty() ? "" : ", ") + *peer_id;
         }
     }
     
     if (success_count == total_peers) {
         return {ErrorCode::Success, "Broadcast sent to all peers"};
     } else if (success_count > 0) {
-        return {ErrorCode::Success, "Broadcast sent to " + std::to_string(success_count) + "/" + std::to_string(total_peers) + " peers"};
+        return {ErrorCode::Success, "Broadcast sent to " + std::to_string(success_count) + "/" + std::to_string(total_peers) + " peers, failed: " + failed_peers};
     } else {
         return {ErrorCode::NetworkError, "Broadcast failed to all peers"};
     }
 }
 
 void Libp2pP2PNetwork::RegisterProtocolHandler(const std::string& protocol) {
-    std::lock_guard<std::mutex> lock(state_mutex_);
+    SetProtocolHandler(protocol, [this, protocol](const std::string& peer_id, std::span<const uint8_t> data) {
+        on_message_received_.Publish(peer_id, protocol, std::vector<uint8_t>(data.begin(), data.end()));
+    });
+}
+
+void Libp2pP2PNetwork::SetProtocolHandler(
+    const std::string& protocol,
+    std::function<void(const std::string&, std::span<const uint8_t>)> handler) {
+    std::lock_guard lock(state_mutex_);
     
-    protocol_handlers_[protocol] = [this](const std::string& peer_id, const std::vector<uint8_t>& data) {
-        if (on_message_received_) {
-            on_message_received_(peer_id, "/sudachi/ldn/1.0.0", data);
-        }
-    };
+    auto protocols = std::make_shared<ProtocolTable>(*protocols_.load(std::memory_order_acquire));
+    auto [it, inserted] = protocols->handles.try_emplace(
+        protocol, static_cast<ProtocolHandle>(protocols->entries.size()));
+    if (inserted) {
+        protocols->entries.push_back({protocol, protocol + "\n", {}});
+    }
+    protocols->entries[it->second].handler = std::move(handler);
+    protocols_.store(std::move(protocols), std::memory_order_release);
+}
+
+PeerHandle Libp2pP2PNetwork::GetPeerHandle(const std::string& peer_id) const {
+    const auto peer = FindPeer(peer_id);
+    return peer ? peer->handle : INVALID_PEER_HANDLE;
+}
+
+ProtocolHandle Libp2pP2PNetwork::GetProtocolHandle(const std::string& protocol) const {
+    const auto protocols = protocols_.load(std::memory_order_acquire);
+    const auto it = protocols->handles.find(protocol);
+    return it != protocols->handles.end() ? it->second : INVALID_PROTOCOL_HANDLE;
+}
+
+MultiplayerResult Libp2pP2PNetwork::SendMessage(PeerHandle peer_handle, ProtocolHandle protocol,
+                                                const std::vector<uint8_t>& data) {
+    const auto peer = FindPeer(peer_handle);
+    if (!peer) {
+        return {ErrorCode::NotConnected, "Not connected to peer handle: " + std::to_string(peer_handle)};
+    }
+    const auto protocols = protocols_.load(std::memory_order_acquire);
+    if (protocol >= protocols->entries.size()) {
+        return {ErrorCode::InvalidParameter, "Unknown protocol handle: " + std::to_string(protocol)};
+    }
+    return SendToPeer(*peer, protocol, protocols->entries[protocol].header, data.data(), data.size());
+}
+
+MultiplayerResult Libp2pP2PNetwork::SendMessage(PeerHandle peer_handle, ProtocolHandle protocol,
+                                                const PacketBuffer& packet) {
+    const auto peer = FindPeer(peer_handle);
+    if (!peer) {
+        return {ErrorCode::NotConnected, "Not connected to peer handle: " + std::to_string(peer_handle)};
+    }
+    const auto protocols = protocols_.load(std::memory_order_acquire);
+    if (protocol >= protocols->entries.size()) {
+        return {ErrorCode::InvalidParameter, "Unknown protocol handle: " + std::to_string(protocol)};
+    }
+    return SendToPeer(*peer, protocol, protocols->entries[protocol].header, packet.data(), packet.size());
 }
 
 void Libp2pP2PNetwork::HandleIncomingMessage(const std::string& peer_id, const std::string& protocol, const std::vector<uint8_t>& data) {
-    std::lock_guard<std::mutex> lock(state_mutex_);
+    ReceiveMessage(FindPeer(peer_id), peer_id, GetProtocolHandle(protocol), data);
+}
+
+void Libp2pP2PNetwork::HandleIncomingMessage(PeerHandle peer_handle, ProtocolHandle protocol,
+                                             std::span<const uint8_t> data) {
+    const auto peer = FindPeer(peer_handle);
+    if (!peer) {
+        return;
+    }
+    ReceiveMessage(peer, peer->peer_id, protocol, data);
+}
+
+void Libp2pP2PNetwork::ReceiveMessage(const std::shared_ptr<PeerState>& peer, const std::string& peer_id,
+                                      ProtocolHandle protocol, std::span<const uint8_t> data) {
+    MULTIPLAYER_TRACE_PACKET();
+    MULTIPLAYER_TRACE_ZONE("Libp2pP2PNetwork::ReceiveMessage");
+    // peer is null for messages from peers that are not connected
+    if (protocol == LDN_BUNDLE_PROTOCOL_HANDLE) {
+        // Each bundled message takes the LDN path, jitter buffer included
+        PacketBundler::ForEachPacket(data, [&](std::span<const uint8_t> packet) {
+            ReceiveMessage(peer, peer_id, LDN_PROTOCOL_HANDLE, packet);
+        });
+        return;
+    }
+    
+    if (protocol == KEEPALIVE_PROTOCOL_HANDLE) {
+        if (peer) {
+            HandleKeepalive(*peer, data);
+        }
+        return;
+    }
+
+    if (jitter_buffer_ && protocol == LDN_PROTOCOL_HANDLE) {
+        if (!peer || data.size() < SEQUENCE_PREFIX_SIZE) {
+            return;
+        }
+        const uint32_t sequence = static_cast<uint32_t>(data[0]) |
+                                  (static_cast<uint32_t>(data[1]) << 8) |
+                                  (static_cast<uint32_t>(data[2]) << 16) |
+                                  (static_cast<uint32_t>(data[3]) << 24);
+        jitter_buffer_->Insert(peer->handle, sequence, data.subspan(SEQUENCE_PREFIX_SIZE));
+        return;
+    }
+
+    DispatchMessage(peer_id, protocol, data);
+}
+
+void Libp2pP2PNetwork::DispatchMessage(const std::string& peer_id, ProtocolHandle protocol,
+                                       std::span<const uint8_t> data) {
+    const auto protocols = protocols_.load(std::memory_order_acquire);
+    if (protocol < protocols->entries.size() && protocols->entries[protocol].handler) {
+        protocols->entries[protocol].handler(peer_id, data);
+    }
+}
+
+void Libp2pP2PNetwork::EnableJitterBuffer(const JitterBufferConfig& config) {
+    jitter_buffer_ = std::make_unique<KeyedJitterBuffer<PeerHandle>>(
+        config, [this](PeerHandle peer_handle, std::vector<uint8_t>& payload) {
+            if (const auto peer = FindPeer(peer_handle)) {
+                DispatchMessage(peer->peer_id, LDN_PROTOCOL_HANDLE, payload);
+            }
+        });
+}
+
+std::optional<JitterBufferStatistics> Libp2pP2PNetwork::GetJitterStatistics(
+    const std::string& peer_id) const {
+    if (!jitter_buffer_) {
+        return std::nullopt;
+    }
+    const PeerHandle handle = GetPeerHandle(peer_id);
+    if (handle == INVALID_PEER_HANDLE) {
+        return std::nullopt;
+    }
+    return jitter_buffer_->GetStatistics(handle);
+}
+
+void Libp2pP2PNetwork::EnableCoalescing(size_t flush_threshold) {
+    // Stored first: a sender that still saw the old threshold appends before
+    // the flush below takes its peer's write_mutex
+    coalescing_threshold_.store(flush_threshold, std::memory_order_release);
+    const auto peers = peers_.load(std::memory_order_acquire);
+    for (const auto& [peer_id, peer] : peers->by_id) {
+        std::lock_guard write_lock(peer->write_mutex);
+        FlushBundleLocked(*peer);
+        peer->pending_bundle.reset();
+    }
+}
+
+MultiplayerResult Libp2pP2PNetwork::FlushCoalescedMessages() {
+    const auto peers = peers_.load(std::memory_order_acquire);
+    MultiplayerResult result{ErrorCode::Success, "Coalesced messages flushed"};
+    for (const auto& [peer_id, peer] : peers->by_id) {
+        std::lock_guard write_lock(peer->write_mutex);
+        auto flushed = FlushBundleLocked(*peer);
+        if (!flushed.IsSuccess() && result.IsSuccess()) {
+            result = flushed;
+        }
+    }
+    return result;
+}
+
+MultiplayerResult Libp2pP2PNetwork::SendKeepalive(const std::string& peer_id) {
+    std::array<uint8_t, RelayProtocol::KEEPALIVE_PAYLOAD_SIZE> payload;
+    RelayProtocol::WriteKeepalivePayload(payload, NowMicroseconds(), 0);
     
-    auto it = protocol_handlers_.find(protocol);
-    if (it != protocol_handlers_.end()) {
-        it->second(peer_id, data);
+    const auto peer = FindPeer(peer_id);
+    if (!peer) {
+        return {ErrorCode::NotConnected, "Not connected to peer: " + peer_id};
+    }
+    std::lock_guard write_lock(peer->write_mutex);
+    return WriteToPeerStream(*peer, KEEPALIVE_PROTOCOL_HANDLE, KEEPALIVE_HEADER, payload.data(),
+                             payload.size());
+}
+
+std::shared_ptr<const RttEstimator> Libp2pP2PNetwork::GetPeerRttEstimator(
+    const std::string& peer_id) const {
+    const auto peer = FindPeer(peer_id);
+    return peer && peer->rtt->HasSamples() ? peer->rtt : nullptr;
+}
+
+std::optional<ClockSyncSnapshot> Libp2pP2PNetwork::GetPeerClockSync(
+    const std::string& peer_id) const {
+    const auto peer = FindPeer(peer_id);
+    if (!peer) {
+        return std::nullopt;
+    }
+    const ClockSyncSnapshot snapshot = peer->clock.GetSnapshot();
+    if (!snapshot.IsSynchronized()) {
+        return std::nullopt;
+    }
+    return snapshot;
+}
+
+std::optional<P2PTransport> Libp2pP2PNetwork::GetPeerTransport(const std::string& peer_id) const {
+    const auto peer = FindPeer(peer_id);
+    if (!peer) {
+        return std::nullopt;
+    }
+    if (peer->via_relay.load(std::memory_order_relaxed)) {
+        return P2PTransport::Relay;
+    }
+    return peer->transport.load(std::memory_order_relaxed);
+}
+
+void Libp2pP2PNetwork::HandleKeepalive(PeerState& peer, std::span<const uint8_t> data) {
+    uint64_t timestamp_us = 0;
+    uint64_t echo_timestamp_us = 0;
+    uint64_t responder_time_us = 0;
+    if (!RelayProtocol::ParseKeepalivePayload(data, timestamp_us, echo_timestamp_us,
+                                              responder_time_us)) {
+        return;
+    }
+    if (echo_timestamp_us != 0) {
+        const uint64_t now = NowMicroseconds();
+        if (now < echo_timestamp_us) {
+            return;
+        }
+        peer.rtt->AddSample(std::chrono::microseconds(static_cast<int64_t>(now - echo_timestamp_us)));
+        if (responder_time_us != 0) {
+            peer.clock.AddSample({echo_timestamp_us, responder_time_us, responder_time_us, now});
+        }
+    } else if (timestamp_us != 0) {
+        // Echo the peer's probe back with our clock; replies are never answered
+        std::array<uint8_t, RelayProtocol::KEEPALIVE_CLOCK_PAYLOAD_SIZE> reply;
+        RelayProtocol::WriteKeepalivePayload(reply, 0, timestamp_us, NowMicroseconds());
+        std::lock_guard write_lock(peer.write_mutex);
+        WriteToPeerStream(peer, KEEPALIVE_PROTOCOL_HANDLE, KEEPALIVE_HEADER, reply.data(), reply.size());
     }
 }
 
@@ -396,33 +1052,115 @@ MultiplayerResult Libp2pP2PNetwork::DetectNATType() {
     }
     
     try {
-        // Start NAT detection
+        // Start NAT detection; startup timing runs until the first verdict
+        BeginStartupPhase(StartupPhase::NatDetection);
         autonat_service_->detectNAT([this](const autonat::NATType& nat_type, bool can_traverse) {
+            EndStartupPhase(StartupPhase::NatDetection);
             detected_nat_type_ = ConvertLibp2pNATType(nat_type);
+            UpdateReachability([&](ReachabilityRecord& record) {
+                record.nat_type = static_cast<int>(detected_nat_type_);
+                record.can_traverse = can_traverse;
+            });
             
-            if (on_nat_detected_) {
-                on_nat_detected_(detected_nat_type_, can_traverse);
-            }
+            on_nat_detected_.Publish(detected_nat_type_, can_traverse);
         });
         
         return {ErrorCode::Success, "NAT detection started"};
         
     } catch (const std::exception& e) {
+        EndStartupPhase(StartupPhase::NatDetection, false);
         return {ErrorCode::InternalError, "NAT detection failed: " + std::string(e.what())};
     }
 }
 
+void Libp2pP2PNetwork::SetNetworkFingerprint(const NetworkFingerprint& fingerprint) {
+    std::lock_guard<std::mutex> lock(reachability_mutex_);
+    network_fingerprint_ = fingerprint;
+}
+
+std::optional<ReachabilityRecord> Libp2pP2PNetwork::GetCachedReachability() const {
+    if (!reachability_cache_) {
+        return std::nullopt;
+    }
+    std::lock_guard<std::mutex> lock(reachability_mutex_);
+    if (network_fingerprint_.IsEmpty()) {
+        return std::nullopt;
+    }
+    return reachability_cache_->Lookup(network_fingerprint_);
+}
+
+void Libp2pP2PNetwork::RecordRelayLatencies(std::vector<RelayServerProbeResult> relay_rtts) {
+    UpdateReachability([&](ReachabilityRecord& record) { record.relay_rtts = std::move(relay_rtts); });
+}
+
+void Libp2pP2PNetwork::RecordExternalAddress(const std::string& external_address) {
+    UpdateReachability([&](ReachabilityRecord& record) { record.external_address = external_address; });
+}
+
+void Libp2pP2PNetwork::RecordPortPredictionResult(const PortAllocationProfile& profile,
+                                                  bool connected) {
+    UpdateReachability([&](ReachabilityRecord& record) {
+        record.port_allocation = static_cast<int>(profile.allocation);
+        record.port_delta = profile.delta;
+        ++record.port_prediction_attempts;
+        if (connected) {
+            ++record.port_prediction_successes;
+        }
+    });
+}
+
+void Libp2pP2PNetwork::InitializeReachabilityCache() {
+    if (config_.reachability_cache_path.empty()) {
+        return;
+    }
+    reachability_cache_ = std::make_unique<ReachabilityCache>(
+        config_.reachability_cache_path, std::chrono::seconds(config_.reachability_cache_ttl_s));
+    // An unreadable file only costs this session its head start
+    reachability_cache_->Load();
+}
+
+void Libp2pP2PNetwork::InitializeAddressBook() {
+    if (config_.peer_address_book_path.empty()) {
+        return;
+    }
+    address_book_ = std::make_unique<PeerAddressBook>(config_.peer_address_book_path,
+                                                      config_.peer_address_book_size);
+    // An unreadable file only means dialing every peer from scratch
+    address_book_->Load();
+}
+
+std::optional<PeerAddressRecord> Libp2pP2PNetwork::GetKnownPeerAddress(const std::string& peer_id) const {
+    if (!address_book_) {
+        return std::nullopt;
+    }
+    return address_book_->Lookup(peer_id);
+}
+
+void Libp2pP2PNetwork::UpdateReachability(const std::function<void(ReachabilityRecord&)>& update) {
+    if (!reachability_cache_) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(reachability_mutex_);
+    if (network_fingerprint_.IsEmpty()) {
+        return;
+    }
+    auto record = reachability_cache_->Lookup(network_fingerprint_).value_or(ReachabilityRecord{});
+    update(record);
+    record.observed_at = std::chrono::system_clock::now();
+    reachability_cache_->Store(network_fingerprint_, record);
+}
+
 bool Libp2pP2PNetwork::CanTraverseNAT(NATType local_nat, NATType remote_nat) const {
-    // Simple NAT traversal logic - can be enhanced
-    if (local_nat == NATType::None || remote_nat == NATType::None) {
+    if (local_nat == NATType::NoNAT || remote_nat == NATType::NoNAT) {
         return true; // Direct connection possible
     }
-    
-    if (local_nat == NATType::Cone && remote_nat == NATType::Cone) {
-        return true; // Both cone NATs can traverse
-    }
-    
-    return false; // Symmetric NATs require relay
+
+    // Plain hole punching needs one mapping per socket on both sides
+    const auto is_cone = [](NATType nat) {
+        return nat == NATType::FullCone || nat == NATType::RestrictedCone ||
+               nat == NATType::PortRestrictedCone;
+    };
+    return is_cone(local_nat) && is_cone(remote_nat);
 }
 
 std::vector<std::string> Libp2pP2PNetwork::GetTraversalStrategies(NATType local_nat, NATType remote_nat) const {
@@ -432,6 +1170,17 @@ std::vector<std::string> Libp2pP2PNetwork::GetTraversalStrategies(NATType local_
         strategies.push_back("direct");
         strategies.push_back("hole-punching");
     }
+
+    if (local_nat == NATType::Symmetric || remote_nat == NATType::Symmetric) {
+        // The remote side judges its own network; ours is what the cache knows
+        const auto cached = GetCachedReachability();
+        const auto allocation = cached ? static_cast<PortAllocation>(cached->port_allocation)
+                                       : PortAllocation::Unknown;
+        if (!cached || ShouldTryPortPrediction(allocation, cached->port_prediction_attempts,
+                                               cached->port_prediction_successes)) {
+            strategies.push_back("port-prediction");
+        }
+    }
     
     if (config_.enable_relay) {
         strategies.push_back("circuit-relay");
@@ -446,48 +1195,62 @@ std::vector<std::string> Libp2pP2PNetwork::GetConfiguredRelayServers() const {
 
 // Callback setters
 void Libp2pP2PNetwork::SetOnPeerConnectedCallback(std::function<void(const std::string&)> callback) {
-    std::lock_guard<std::mutex> lock(callback_mutex_);
-    on_peer_connected_ = callback;
+    on_peer_connected_.Reset(std::move(callback));
 }
 
 void Libp2pP2PNetwork::SetOnPeerDisconnectedCallback(std::function<void(const std::string&)> callback) {
-    std::lock_guard<std::mutex> lock(callback_mutex_);
-    on_peer_disconnected_ = callback;
+    on_peer_disconnected_.Reset(std::move(callback));
 }
 
 void Libp2pP2PNetwork::SetOnConnectionFailedCallback(std::function<void(const std::string&, const std::string&)> callback) {
-    std::lock_guard<std::mutex> lock(callback_mutex_);
-    on_connection_failed_ = callback;
+    on_connection_failed_.Reset(std::move(callback));
 }
 
 void Libp2pP2PNetwork::SetOnMessageReceivedCallback(std::function<void(const std::string&, const std::string&, const std::vector<uint8_t>&)> callback) {
-    std::lock_guard<std::mutex> lock(callback_mutex_);
-    on_message_received_ = callback;
+    on_message_received_.Reset(std::move(callback));
 }
 
 void Libp2pP2PNetwork::SetOnNATDetectedCallback(std::function<void(NATType, bool)> callback) {
-    std::lock_guard<std::mutex> lock(callback_mutex_);
-    on_nat_detected_ = callback;
+    on_nat_detected_.Reset(std::move(callback));
 }
 
 void Libp2pP2PNetwork::SetOnRelayConnectedCallback(std::function<void(const std::string&, const std::string&)> callback) {
-    std::lock_guard<std::mutex> lock(callback_mutex_);
-    on_relay_connected_ = callback;
+    on_relay_connected_.Reset(std::move(callback));
 }
 
 void Libp2pP2PNetwork::SetOnRelayFailedCallback(std::function<void(const std::string&, const std::string&)> callback) {
-    std::lock_guard<std::mutex> lock(callback_mutex_);
-    on_relay_failed_ = callback;
+    on_relay_failed_.Reset(std::move(callback));
+}
+
+void Libp2pP2PNetwork::SetCallbackQueue(std::shared_ptr<EventQueue> queue) {
+    on_peer_connected_.SetDeferredQueue(queue);
+    on_peer_disconnected_.SetDeferredQueue(queue);
+    on_connection_failed_.SetDeferredQueue(queue);
+    on_message_received_.SetDeferredQueue(queue);
+    on_nat_detected_.SetDeferredQueue(queue);
+    on_relay_connected_.SetDeferredQueue(queue);
+    on_relay_failed_.SetDeferredQueue(std::move(queue));
 }
 
 // Helper methods
-void Libp2pP2PNetwork::OnConnectionEstablished(const peer::PeerId& peer_id, std::shared_ptr<connection::Stream> stream) {
-    // Setup stream reading
-    stream->read([this, peer_id](outcome::result<size_t> result) {
+void Libp2pP2PNetwork::OnConnectionEstablished(PeerHandle peer, std::shared_ptr<connection::Stream> stream) {
+    // Setup stream reading; the handle spares a peer id conversion per read
+    stream->read([this, peer](outcome::result<size_t> result) {
         if (result) {
             // Handle incoming data
             std::vector<uint8_t> buffer(result.value());
-            HandleIncomingMessage(PeerIdToString(peer_id), "/sudachi/ldn/1.0.0", buffer);
+            HandleIncomingMessage(peer, LDN_PROTOCOL_HANDLE, buffer);
+        }
+    });
+}
+
+void Libp2pP2PNetwork::OnControlStreamEstablished(PeerHandle peer,
+                                                  std::shared_ptr<connection::Stream> stream) {
+    // Only keepalives travel on the control stream
+    stream->read([this, peer](outcome::result<size_t> result) {
+        if (result) {
+            std::vector<uint8_t> buffer(result.value());
+            HandleIncomingMessage(peer, KEEPALIVE_PROTOCOL_HANDLE, buffer);
         }
     });
 }
@@ -495,14 +1258,13 @@ void Libp2pP2PNetwork::OnConnectionEstablished(const peer::PeerId& peer_id, std:
 void Libp2pP2PNetwork::OnConnectionClosed(const peer::PeerId& peer_id) {
     std::string peer_id_str = PeerIdToString(peer_id);
     
-    std::lock_guard<std::mutex> lock(state_mutex_);
-    connected_peers_.erase(peer_id_str);
-    relay_connected_peers_.erase(peer_id_str);
-    peer_streams_.erase(peer_id_str);
-    
-    if (on_peer_disconnected_) {
-        on_peer_disconnected_(peer_id_str);
+    std::lock_guard lock(state_mutex_);
+    const auto peer = RemovePeer(peer_id_str);
+    if (peer && jitter_buffer_) {
+        jitter_buffer_->Remove(peer->handle);
     }
+    
+    on_peer_disconnected_.Publish(peer_id_str);
 }
 
 NATType Libp2pP2PNetwork::ConvertLibp2pNATType(const autonat::NATType& nat_type) const {
@@ -540,4 +1302,268 @@ peer::PeerId Libp2pP2PNetwork::StringToPeerId(const std::string& peer_id_str) co
     return peer::PeerId::fromBase58(peer_id_str).value();
 }
 
+std::shared_ptr<const Libp2pP2PNetwork::ProtocolTable> Libp2pP2PNetwork::MakeBuiltinProtocols() {
+    auto protocols = std::make_shared<ProtocolTable>();
+    for (const char* protocol : {LDN_PROTOCOL_ID, LDN_BUNDLE_PROTOCOL_ID, KEEPALIVE_PROTOCOL_ID}) {
+        protocols->handles.emplace(protocol, static_cast<ProtocolHandle>(protocols->entries.size()));
+        protocols->entries.push_back({protocol, std::string(protocol) + "\n", {}});
+    }
+    return protocols;
+}
+
+std::shared_ptr<Libp2pP2PNetwork::PeerState> Libp2pP2PNetwork::FindPeer(
+    const std::string& peer_id) const {
+    const auto peers = peers_.load(std::memory_order_acquire);
+    const auto it = peers->by_id.find(peer_id);
+    return it != peers->by_id.end() ? it->second : nullptr;
+}
+
+std::shared_ptr<Libp2pP2PNetwork::PeerState> Libp2pP2PNetwork::FindPeer(PeerHandle handle) const {
+    const auto peers = peers_.load(std::memory_order_acquire);
+    const size_t slot = handle & PEER_SLOT_MASK;
+    if (slot >= peers->by_handle.size() || !peers->by_handle[slot] ||
+        peers->by_handle[slot]->handle != handle) {
+        return nullptr;
+    }
+    return peers->by_handle[slot];
+}
+
+void Libp2pP2PNetwork::PublishPeers(PeerTable table) {
+    // Caller must hold state_mutex_; readers holding the old table keep it alive
+    peers_.store(std::make_shared<const PeerTable>(std::move(table)), std::memory_order_release);
+}
+
+std::shared_ptr<Libp2pP2PNetwork::PeerState> Libp2pP2PNetwork::AcquirePeer(
+    const std::string& peer_id) {
+    // Caller must hold state_mutex_
+    for (size_t slot = 0; slot < peer_slab_.size(); ++slot) {
+        const auto& peer = peer_slab_[slot];
+        // Published tables and senders that loaded one hold a reference
+        if (peer.use_count() != 1) {
+            continue;
+        }
+        peer->peer_id = peer_id;
+        peer->stream.reset();
+        peer->control_stream.reset();
+        peer->transport.store(P2PTransport::Unknown, std::memory_order_relaxed);
+        peer->via_relay.store(false, std::memory_order_relaxed);
+        peer->send_sequence = 0;
+        peer->pending_bundle.reset();
+        peer->send_queue.Clear();
+        peer->next_send_ticket = 0;
+        peer->queued_sends.store(0, std::memory_order_relaxed);
+        if (peer->rtt.use_count() == 1) {
+            peer->rtt->Reset();
+        } else {
+            // A GetPeerRtt caller still reads the previous peer's estimator
+            peer->rtt = std::make_shared<RttEstimator>();
+        }
+        peer->clock.Reset();
+
+        const uint32_t generation = ++slot_generations_[slot];
+        peer->handle = (generation << PEER_SLOT_BITS) | static_cast<uint32_t>(slot);
+        if (peer->handle == INVALID_PEER_HANDLE) {
+            peer->handle = (++slot_generations_[slot] << PEER_SLOT_BITS) | static_cast<uint32_t>(slot);
+        }
+        return peer;
+    }
+    return nullptr;
+}
+
+void Libp2pP2PNetwork::AddPeer(std::shared_ptr<PeerState> peer) {
+    // Caller must hold state_mutex_
+    PeerTable table = *peers_.load(std::memory_order_acquire);
+    if (const auto existing = table.by_id.find(peer->peer_id); existing != table.by_id.end()) {
+        table.by_handle[existing->second->handle & PEER_SLOT_MASK] = nullptr;
+    }
+    // Stop publishes an empty table
+    table.by_handle.resize(peer_slab_.size());
+    table.by_handle[peer->handle & PEER_SLOT_MASK] = peer;
+    table.by_id[peer->peer_id] = std::move(peer);
+    PublishPeers(std::move(table));
+}
+
+std::shared_ptr<Libp2pP2PNetwork::PeerState> Libp2pP2PNetwork::RemovePeer(const std::string& peer_id) {
+    // Caller must hold state_mutex_
+    PeerTable table = *peers_.load(std::memory_order_acquire);
+    const auto it = table.by_id.find(peer_id);
+    if (it == table.by_id.end()) {
+        return nullptr;
+    }
+    auto peer = std::move(it->second);
+    table.by_id.erase(it);
+    table.by_handle[peer->handle & PEER_SLOT_MASK] = nullptr;
+    PublishPeers(std::move(table));
+    return peer;
+}
+
+MultiplayerResult Libp2pP2PNetwork::SendByName(PeerState& peer, const std::string& protocol,
+                                               const uint8_t* data, size_t size,
+                                               SendPriority priority,
+                                               std::optional<uint64_t> latest_key) {
+    const auto protocols = protocols_.load(std::memory_order_acquire);
+    const auto it = protocols->handles.find(protocol);
+    if (it != protocols->handles.end()) {
+        return SendToPeer(peer, it->second, protocols->entries[it->second].header, data, size,
+                          priority, latest_key);
+    }
+    // Unregistered protocols are still sent, under a header built here
+    return SendToPeer(peer, INVALID_PROTOCOL_HANDLE, protocol + "\n", data, size, priority);
+}
+
+MultiplayerResult Libp2pP2PNetwork::SendToPeer(PeerState& peer, ProtocolHandle protocol,
+                                               std::string_view header, const uint8_t* data,
+                                               size_t size, SendPriority priority,
+                                               std::optional<uint64_t> latest_key) {
+    MULTIPLAYER_TRACE_ZONE("Libp2pP2PNetwork::SendToPeer");
+    {
+        std::unique_lock write_lock(peer.write_mutex, std::try_to_lock);
+        if (write_lock.owns_lock() && peer.queued_sends.load(std::memory_order_acquire) == 0) {
+            return SendToPeerLocked(peer, protocol, header, data, size);
+        }
+    }
+
+    // The stream is busy: wait in line by class. Every queued writer takes
+    // the stream afterwards and drains the queue, so nothing is left behind.
+    uint64_t ticket;
+    {
+        std::lock_guard queue_lock(peer.send_queue_mutex);
+        ticket = peer.next_send_ticket++;
+        QueuedSend queued{ticket, protocol, std::string(header),
+                          std::vector<uint8_t>(data, data + size)};
+        if (latest_key && protocol != INVALID_PROTOCOL_HANDLE) {
+            switch (peer.send_queue.PushLatest(protocol, priority, *latest_key, std::move(queued),
+                                               size)) {
+            case PushResult::Replaced:
+                // The writer that queued the old value drains this one
+                replaced_sends_.fetch_add(1, std::memory_order_relaxed);
+                return {ErrorCode::Success, "Message replaced a queued one"};
+            case PushResult::Full:
+                return {ErrorCode::MessageQueueFull, "Send queue full for peer: " + peer.peer_id};
+            case PushResult::Queued:
+                break;
+            }
+        } else if (!peer.send_queue.Push(protocol, priority, std::move(queued), size)) {
+            return {ErrorCode::MessageQueueFull, "Send queue full for peer: " + peer.peer_id};
+        }
+        peer.queued_sends.fetch_add(1, std::memory_order_release);
+    }
+    std::lock_guard write_lock(peer.write_mutex);
+    return DrainSendQueueLocked(peer, ticket);
+}
+
+MultiplayerResult Libp2pP2PNetwork::DrainSendQueueLocked(PeerState& peer, uint64_t ticket) {
+    MultiplayerResult result{ErrorCode::Success, "Message sent"};
+    QueuedSend queued;
+    while (true) {
+        {
+            std::lock_guard queue_lock(peer.send_queue_mutex);
+            if (!peer.send_queue.Pop(queued)) {
+                break;
+            }
+        }
+        peer.queued_sends.fetch_sub(1, std::memory_order_release);
+        auto sent = SendToPeerLocked(peer, queued.protocol, queued.header, queued.data.data(),
+                                     queued.data.size());
+        if (queued.ticket == ticket) {
+            result = std::move(sent);
+        }
+    }
+    return result;
+}
+
+MultiplayerResult Libp2pP2PNetwork::SendToPeerLocked(PeerState& peer, ProtocolHandle protocol,
+                                                     std::string_view header, const uint8_t* data,
+                                                     size_t size) {
+    const size_t threshold = coalescing_threshold_.load(std::memory_order_acquire);
+    if (peer.pending_bundle && peer.pending_bundle->GetCapacity() != threshold) {
+        // Coalescing was turned off or resized since this bundle was started
+        FlushBundleLocked(peer);
+        peer.pending_bundle.reset();
+    }
+    if (threshold == 0 || protocol != LDN_PROTOCOL_HANDLE) {
+        return WriteToPeerStream(peer, protocol, header, data, size);
+    }
+    
+    // The sequence prefix travels inside the bundle entry
+    std::array<uint8_t, SEQUENCE_PREFIX_SIZE> prefix{};
+    std::span<const uint8_t> head;
+    if (jitter_buffer_) {
+        prefix = EncodeSequence(peer.send_sequence++);
+        head = prefix;
+    }
+    const std::span<const uint8_t> body(data, size);
+    
+    if (!peer.pending_bundle) {
+        peer.pending_bundle.emplace(threshold);
+    }
+    auto& bundler = *peer.pending_bundle;
+    if (bundler.Append(head, body)) {
+        return {ErrorCode::Success, "Message coalesced"};
+    }
+    // Full: what is held goes first, then this message starts the next bundle
+    auto flushed = FlushBundleLocked(peer);
+    if (bundler.Append(head, body)) {
+        return flushed;
+    }
+    // Too large to bundle at all
+    return WriteStreamSegments(peer, LDN_HEADER, head, body);
+}
+
+MultiplayerResult Libp2pP2PNetwork::FlushBundleLocked(PeerState& peer) {
+    // Caller must hold peer.write_mutex
+    if (!peer.pending_bundle || peer.pending_bundle->Empty()) {
+        return {ErrorCode::Success, "Nothing to flush"};
+    }
+    auto& bundler = *peer.pending_bundle;
+    // A lone message is written plain, without the bundle's length prefix
+    auto result = bundler.GetPacketCount() == 1
+                      ? WriteStreamSegments(peer, LDN_HEADER, bundler.GetSinglePacket(), {})
+                      : WriteStreamSegments(peer, LDN_BUNDLE_HEADER, bundler.GetBundle(), {});
+    bundler.Clear();
+    return result;
+}
+
+MultiplayerResult Libp2pP2PNetwork::WriteToPeerStream(PeerState& peer, ProtocolHandle protocol,
+                                                      std::string_view header, const uint8_t* data,
+                                                      size_t size) {
+    // Caller must hold peer.write_mutex
+    MULTIPLAYER_TRACE_ZONE("Libp2pP2PNetwork::WriteToPeerStream");
+    // Sequence number for the receiver's jitter buffer
+    std::array<uint8_t, SEQUENCE_PREFIX_SIZE> prefix{};
+    std::span<const uint8_t> head;
+    if (jitter_buffer_ && protocol == LDN_PROTOCOL_HANDLE) {
+        prefix = EncodeSequence(peer.send_sequence++);
+        head = prefix;
+    }
+    return WriteStreamSegments(peer, header, head, std::span<const uint8_t>(data, size));
+}
+
+MultiplayerResult Libp2pP2PNetwork::WriteStreamSegments(PeerState& peer,
+                                                        std::string_view header,
+                                                        std::span<const uint8_t> head,
+                                                        std::span<const uint8_t> body) {
+    // Caller must hold peer.write_mutex
+    try {
+        // Keepalives take the control stream where there is one
+        auto& stream = header == KEEPALIVE_HEADER && peer.control_stream ? peer.control_stream
+                                                                          : peer.stream;
+        
+        // Write protocol header
+        stream->write(gsl::span<const uint8_t>(reinterpret_cast<const uint8_t*>(header.data()), header.size()));
+        
+        if (!head.empty()) {
+            stream->write(gsl::span<const uint8_t>(head.data(), head.size()));
+        }
+        
+        // Write data
+        stream->write(gsl::span<const uint8_t>(body.data(), body.size()));
+        
+        return {ErrorCode::Success, "Message sent successfully"};
+        
+    } catch (const std::exception& e) {
+        return {ErrorCode::NetworkError, "Failed to send message: " + std::string(e.what())};
+    }
+}
+
 } // namespace Core::Multiplayer::ModelA
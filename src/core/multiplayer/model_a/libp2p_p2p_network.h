@@ -3,9 +3,29 @@
 
 #pragma once
 
+#include "core/multiplayer/common/clock_sync.h"
+#include "core/multiplayer/common/event_bus.h"
+#include "core/multiplayer/common/lock_contention.h"
+#include "core/multiplayer/common/packet_buffer.h"
+#include "core/multiplayer/common/priority_send_queue.h"
+#include "core/multiplayer/common/rtt_estimator.h"
+#include "core/multiplayer/common/work_stealing_executor.h"
+#include "jitter_buffer.h"
+#include "packet_bundle.h"
+#include "host_identity.h"
 #include "p2p_types.h"
+#include "peer_address_book.h"
+#include "port_prediction.h"
+#include "protocol_decoder.h"
+#include "reachability_cache.h"
+#include "transport_preference.h"
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <span>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -34,8 +54,10 @@ public:
         Symmetric,
         NoNAT
     };
-    // Constructor for production use
-    explicit Libp2pP2PNetwork(const P2PNetworkConfig& config);
+    // Constructor for production use; broadcasts fan out on the shared
+    // executor when none is given
+    explicit Libp2pP2PNetwork(const P2PNetworkConfig& config,
+                              std::shared_ptr<WorkStealingExecutor> executor = nullptr);
     
     // Constructor for dependency injection (testing)
     Libp2pP2PNetwork(
@@ -56,7 +78,13 @@ public:
     // Identity and addressing
     std::string GetPeerId() const;
 
-    // Connection management
+    /**
+     * Connects directly, racing a relay connection when relays are enabled.
+     * The relay dial starts once the direct one has had relay_head_start_ms
+     * to itself; the first to connect wins, preferring direct. When relay
+     * wins, the direct dial carries on and, if it gets through, the peer is
+     * moved onto it in the background without changing its handle.
+     */
     MultiplayerResult ConnectToPeer(const std::string& peer_id, const std::string& multiaddr);
     MultiplayerResult DisconnectFromPeer(const std::string& peer_id);
     bool IsConnectedToPeer(const std::string& peer_id) const;
@@ -70,13 +98,139 @@ public:
 
     // Message handling
     MultiplayerResult SendMessage(const std::string& peer_id, const std::string& protocol, const std::vector<uint8_t>& data);
+    /**
+     * Sends to every connected peer concurrently, one executor task per peer
+     * besides the first, which the calling thread writes itself. Returns once
+     * every write has completed, so it takes as long as the slowest peer
+     * rather than the sum of all of them. Peers whose write failed are named
+     * in the result message.
+     */
     MultiplayerResult BroadcastMessage(const std::string& protocol, const std::vector<uint8_t>& data);
+    MultiplayerResult SendMessage(const std::string& peer_id, const std::string& protocol, const PacketBuffer& packet);
+    /**
+     * Sends in a class. The plain overloads send realtime. A writer that
+     * finds the peer's stream busy queues its message, and whichever writer
+     * gets the stream next writes the queue out control first, then
+     * realtime, with protocols sharing bulk by deficit round-robin.
+     */
+    MultiplayerResult SendMessage(const std::string& peer_id, const std::string& protocol, const std::vector<uint8_t>& data, SendPriority priority);
+    /**
+     * As SendMessage, but a message still queued on the protocol with the
+     * same key is overwritten and only the newest is written. Messages on
+     * unregistered protocols share a queue lane, so they are never replaced.
+     */
+    MultiplayerResult SendLatestMessage(const std::string& peer_id, const std::string& protocol, const std::vector<uint8_t>& data, SendPriority priority, uint64_t key);
+    // Queued messages a newer one with the same key replaced before they were written
+    uint64_t GetReplacedSendCount() const {
+        return replaced_sends_.load(std::memory_order_relaxed);
+    }
+    // Messages on the protocol are copied out to the message received callback
     void RegisterProtocolHandler(const std::string& protocol);
+
+    /**
+     * Decodes each message on the protocol as a T, in place in the buffer it
+     * was read into, and calls handler(peer_id, message) without copying it
+     * out. Messages that fail to decode are dropped. Takes the protocol's
+     * message received callback over; the message does not outlive the call.
+     */
+    template <DecodableMessage T, typename Handler>
+        requires std::invocable<Handler&, const std::string&, const T&>
+    void RegisterProtocolHandler(const std::string& protocol, Handler handler) {
+        SetProtocolHandler(protocol, [handler = std::move(handler)](const std::string& peer_id,
+                                                                    std::span<const uint8_t> data) mutable {
+            if (const auto message = ProtocolDecoder<T>::Decode(data)) {
+                handler(peer_id, *message);
+            }
+        });
+    }
     void HandleIncomingMessage(const std::string& peer_id, const std::string& protocol, const std::vector<uint8_t>& data);
 
+    /**
+     * Handles for the per-packet path. A peer gets its handle when it
+     * connects and a protocol when it is registered; the built-in LDN
+     * protocols are always registered. The overloads below index dense
+     * tables with them instead of hashing strings.
+     * @return The invalid handle for an unknown peer or protocol
+     */
+    PeerHandle GetPeerHandle(const std::string& peer_id) const;
+    ProtocolHandle GetProtocolHandle(const std::string& protocol) const;
+    MultiplayerResult SendMessage(PeerHandle peer, ProtocolHandle protocol, const std::vector<uint8_t>& data);
+    MultiplayerResult SendMessage(PeerHandle peer, ProtocolHandle protocol, const PacketBuffer& packet);
+    void HandleIncomingMessage(PeerHandle peer, ProtocolHandle protocol, std::span<const uint8_t> data);
+
+    /**
+     * Sequences LDN protocol messages and plays incoming ones out through a
+     * per-peer jitter buffer. Each message is prefixed with a 4-byte
+     * little-endian sequence number, so both peers must enable it.
+     */
+    void EnableJitterBuffer(const JitterBufferConfig& config);
+    std::optional<JitterBufferStatistics> GetJitterStatistics(const std::string& peer_id) const;
+
+    /**
+     * Sends a timestamped keepalive on the keepalive protocol, using the
+     * relay keepalive payload. The peer echoes it and the echo updates that
+     * peer's RTT estimator; keepalives from peers are echoed in turn, with
+     * this host's clock, so echoes also feed the peer's clock estimator.
+     */
+    MultiplayerResult SendKeepalive(const std::string& peer_id);
+    // The estimator can be held and read lock-free; null if no echo has arrived
+    std::shared_ptr<const RttEstimator> GetPeerRttEstimator(const std::string& peer_id) const;
+    // Nothing until an echo with the peer's clock has arrived
+    std::optional<ClockSyncSnapshot> GetPeerClockSync(const std::string& peer_id) const;
+    // How a connected peer was reached
+    std::optional<P2PTransport> GetPeerTransport(const std::string& peer_id) const;
+
+    /**
+     * Opt-in coalescing of LDN protocol messages. Messages to the same peer
+     * are held and written as one bundle, on the LDN bundle protocol, once
+     * the next would push it past flush_threshold bytes or when
+     * FlushCoalescedMessages is called at the end of the frame, see
+     * ModelABackend::SetFrameBoundaryHandler. A threshold
+     * of 0 flushes what is held and turns coalescing off.
+     */
+    void EnableCoalescing(size_t flush_threshold);
+    MultiplayerResult FlushCoalescedMessages();
+
     // NAT traversal
     MultiplayerResult DetectNATType();
+
+    /**
+     * Reachability cache, enabled by reachability_cache_path. With a
+     * fingerprint of the current network set, Start reports a cached NAT
+     * type through the NAT callback right away and DetectNATType then
+     * revalidates it in the background. Detected NAT types, and the relay
+     * RTTs and external address recorded here, are stored for the network.
+     */
+    void SetNetworkFingerprint(const NetworkFingerprint& fingerprint);
+    std::optional<ReachabilityRecord> GetCachedReachability() const;
+    // E.g. from RelayServerSelector::GetProbeResults, for SeedProbeResults next session
+    void RecordRelayLatencies(std::vector<RelayServerProbeResult> relay_rtts);
+    void RecordExternalAddress(const std::string& external_address);
+    // How this network allocates ports, and whether a punch from it connected
+    void RecordPortPredictionResult(const PortAllocationProfile& profile, bool connected);
     bool CanTraverseNAT(NATType local_nat, NATType remote_nat) const;
+
+    /**
+     * Address book, enabled by peer_address_book_path. ConnectToPeer dials a
+     * peer reached before on its remembered address first, and starts the
+     * relay at once when that is how it was last reached.
+     */
+    std::optional<PeerAddressRecord> GetKnownPeerAddress(const std::string& peer_id) const;
+
+    /**
+     * Private addresses of a peer behind the same router, see
+     * LanCandidateExchange. ConnectToPeer dials them before the public
+     * address, which a router without hairpinning never connects, and
+     * before the relay gets its head start.
+     */
+    void SetPeerLanAddresses(const std::string& peer_id, std::vector<std::string> multiaddrs);
+
+    /**
+     * Ways to reach a peer, in the order to try them. A symmetric NAT on
+     * either side gets "port-prediction" ahead of the relay, unless the
+     * reachability cache shows this network allocates ports randomly or
+     * its earlier punches mostly failed.
+     */
     std::vector<std::string> GetTraversalStrategies(NATType local_nat, NATType remote_nat) const;
 
     // Relay management
@@ -91,6 +245,13 @@ public:
     void SetOnRelayConnectedCallback(std::function<void(const std::string&, const std::string&)> callback);
     void SetOnRelayFailedCallback(std::function<void(const std::string&, const std::string&)> callback);
 
+    /**
+     * Delivers every callback through the queue instead of on the network
+     * thread that raised it; the owner dispatches it from its own loop.
+     * Null returns to calling them inline.
+     */
+    void SetCallbackQueue(std::shared_ptr<EventQueue> queue);
+
 private:
     // Configuration
     P2PNetworkConfig config_;
@@ -102,41 +263,194 @@ private:
     std::shared_ptr<libp2p::protocol::autonat::AutoNAT> autonat_service_;
     std::shared_ptr<libp2p::protocol::relay::Relay> circuit_relay_;
 
-    // State tracking
-    mutable std::mutex state_mutex_;
+    // A message waiting for a peer's stream; the ticket tells its sender's result apart
+    struct QueuedSend {
+        uint64_t ticket = 0;
+        ProtocolHandle protocol = INVALID_PROTOCOL_HANDLE;
+        std::string header;
+        std::vector<uint8_t> data;
+    };
+    static constexpr size_t MAX_QUEUED_SENDS = 256;
+
+    /**
+     * One connected peer. The table only holds pointers to these, so state
+     * that changes per message lives here and carries over from one
+     * published table to the next.
+     */
+    struct PeerState {
+        std::string peer_id;
+        PeerHandle handle = INVALID_PEER_HANDLE;
+        std::shared_ptr<libp2p::connection::Stream> stream;
+        // QUIC peers get a second stream for keepalives, so control never
+        // waits behind game traffic on the same stream; null otherwise
+        std::shared_ptr<libp2p::connection::Stream> control_stream;
+        std::atomic<P2PTransport> transport{P2PTransport::Unknown};
+        // Cleared when a relayed peer is upgraded to a direct stream
+        std::atomic<bool> via_relay{false};
+        // Serializes writes to, and replacement of, the stream so concurrent
+        // frames never interleave
+        ProfiledMutex<LockSite::P2PPeerWrite> write_mutex;
+        // Guarded by write_mutex, so sequence order matches order on the wire
+        uint32_t send_sequence = 0;
+        std::optional<PacketBundler> pending_bundle;
+        // Messages whose writers found write_mutex held, keyed by protocol
+        ProfiledMutex<LockSite::P2PPeerSendQueue> send_queue_mutex;
+        PrioritySendQueue<QueuedSend> send_queue{MAX_QUEUED_SENDS}; // guarded by send_queue_mutex
+        uint64_t next_send_ticket = 0;                              // guarded by send_queue_mutex
+        std::atomic<size_t> queued_sends{0};
+        std::shared_ptr<RttEstimator> rtt = std::make_shared<RttEstimator>();
+        ClockSyncEstimator clock;
+    };
+    struct PeerTable {
+        std::unordered_map<std::string, std::shared_ptr<PeerState>> by_id;
+        // Indexed by the slot in the low bits of a handle; null when free
+        std::vector<std::shared_ptr<PeerState>> by_handle;
+    };
+    struct ProtocolEntry {
+        std::string name;
+        // Name and newline, written ahead of every message on the stream
+        std::string header;
+        std::function<void(const std::string&, std::span<const uint8_t>)> handler;
+    };
+    struct ProtocolTable {
+        // Indexed by handle; entries are only ever appended
+        std::vector<ProtocolEntry> entries;
+        std::unordered_map<std::string, ProtocolHandle> handles;
+    };
+
+    // State tracking; state_mutex_ serializes writers only
+    mutable ProfiledMutex<LockSite::P2PState> state_mutex_;
     bool started_;
-    std::unordered_set<std::string> connected_peers_;
-    std::unordered_set<std::string> relay_connected_peers_;
-    std::unordered_map<std::string, std::shared_ptr<libp2p::connection::Stream>> peer_streams_;
     NATType detected_nat_type_;
 
-    // Protocol handlers
-    std::unordered_map<std::string, std::function<void(const std::string&, const std::vector<uint8_t>&)>> protocol_handlers_;
+    /**
+     * Immutable snapshots, replaced whole by writers under state_mutex_.
+     * Send, broadcast and receive paths load them without taking a lock.
+     */
+    std::atomic<std::shared_ptr<const PeerTable>> peers_{std::make_shared<const PeerTable>()};
+    std::atomic<std::shared_ptr<const ProtocolTable>> protocols_{MakeBuiltinProtocols()};
+    /**
+     * Slab of config_.max_connections peer records, made once at
+     * construction; record i backs slot i of the handles. A record is only
+     * reset for a new peer once no published table or in-flight sender
+     * still holds it, so connecting allocates no peer state and a stale
+     * handle or table never reaches the new peer. Guarded by state_mutex_.
+     */
+    std::vector<std::shared_ptr<PeerState>> peer_slab_;
+    // Bumped each time a peer slot is reused, so stale handles never match;
+    // guarded by state_mutex_
+    std::vector<uint16_t> slot_generations_;
 
-    // Callbacks
-    std::function<void(const std::string&)> on_peer_connected_;
-    std::function<void(const std::string&)> on_peer_disconnected_;
-    std::function<void(const std::string&, const std::string&)> on_connection_failed_;
-    std::function<void(const std::string&, const std::string&, const std::vector<uint8_t>&)> on_message_received_;
-    std::function<void(NATType, bool)> on_nat_detected_;
-    std::function<void(const std::string&, const std::string&)> on_relay_connected_;
-    std::function<void(const std::string&, const std::string&)> on_relay_failed_;
-    mutable std::mutex callback_mutex_;
+    // Callbacks; published without a lock, see EventChannel
+    EventChannel<std::string> on_peer_connected_;
+    EventChannel<std::string> on_peer_disconnected_;
+    EventChannel<std::string, std::string> on_connection_failed_;
+    EventChannel<std::string, std::string, std::vector<uint8_t>> on_message_received_;
+    EventChannel<NATType, bool> on_nat_detected_;
+    EventChannel<std::string, std::string> on_relay_connected_;
+    EventChannel<std::string, std::string> on_relay_failed_;
+
+    // Runs the per-peer writes of a broadcast
+    std::shared_ptr<WorkStealingExecutor> executor_;
+
+    // Persisted reachability of the current network
+    std::unique_ptr<ReachabilityCache> reachability_cache_;
+    mutable std::mutex reachability_mutex_;
+    NetworkFingerprint network_fingerprint_;
+
+    // Last working path per peer, across sessions
+    std::unique_ptr<PeerAddressBook> address_book_;
+
+    // Verified LAN addresses per peer, for this session only
+    mutable std::mutex lan_addresses_mutex_;
+    std::unordered_map<std::string, std::vector<std::string>> lan_addresses_;
+
+    // Dials of ConnectToPeer, which may finish after it has returned
+    ExecutorTaskGroup connect_tasks_{executor_};
+
+    // Receive reordering
+    std::unique_ptr<KeyedJitterBuffer<PeerHandle>> jitter_buffer_;
+
+    // Coalesced LDN messages are held in each peer's pending_bundle
+    std::atomic<size_t> coalescing_threshold_{0};
+    std::atomic<uint64_t> replaced_sends_{0};
 
     // Helper methods
     void InitializeHost();
+    void InitializePeerSlab();
+    // The persisted identity, generated and saved on first use
+    std::optional<HostIdentity> LoadOrCreateIdentity() const;
     void ConfigureTransports();
     void ConfigureSecurity();
     void SetupProtocolHandlers();
-    void OnConnectionEstablished(const libp2p::peer::PeerId& peer_id, std::shared_ptr<libp2p::connection::Stream> stream);
+    void InitializeReachabilityCache();
+    void UpdateReachability(const std::function<void(ReachabilityRecord&)>& update);
+    void InitializeAddressBook();
+    std::vector<std::string> GetPeerLanAddresses(const std::string& peer_id) const;
+    void OnConnectionEstablished(PeerHandle peer, std::shared_ptr<libp2p::connection::Stream> stream);
+    void OnControlStreamEstablished(PeerHandle peer, std::shared_ptr<libp2p::connection::Stream> stream);
     void OnConnectionClosed(const libp2p::peer::PeerId& peer_id);
     void OnStreamReceived(std::shared_ptr<libp2p::connection::Stream> stream);
-    MultiplayerResult AttemptDirectConnection(const libp2p::peer::PeerId& peer_id, const libp2p::multi::Multiaddress& addr);
-    MultiplayerResult AttemptRelayConnection(const libp2p::peer::PeerId& peer_id);
+    MultiplayerResult AttemptDirectConnection(const libp2p::peer::PeerId& peer_id, const libp2p::multi::Multiaddress& addr,
+                                              std::shared_ptr<libp2p::connection::Stream>& stream);
+    MultiplayerResult AttemptRelayConnection(const libp2p::peer::PeerId& peer_id,
+                                             std::shared_ptr<libp2p::connection::Stream>& stream);
+    // Tries each address in turn, reporting the one that got through
+    MultiplayerResult AttemptDirectConnections(const libp2p::peer::PeerId& peer_id,
+                                               const std::vector<std::string>& multiaddrs,
+                                               std::shared_ptr<libp2p::connection::Stream>& stream,
+                                               std::string& connected_multiaddr);
+    MultiplayerResult RaceConnections(const libp2p::peer::PeerId& peer_id,
+                                      std::vector<std::string> multiaddrs,
+                                      std::chrono::milliseconds relay_head_start);
+    // Caller must hold state_mutex_
+    MultiplayerResult InstallPeer(const libp2p::peer::PeerId& peer_id,
+                                  std::shared_ptr<libp2p::connection::Stream> stream, bool via_relay,
+                                  P2PTransport transport);
+    void UpgradeToDirect(const std::string& peer_id, std::shared_ptr<libp2p::connection::Stream> stream,
+                         P2PTransport transport);
+    // Opens the keepalive stream of a QUIC peer; without it keepalives share the game stream
+    void OpenControlStream(PeerState& peer);
     NATType ConvertLibp2pNATType(const libp2p::protocol::autonat::NATType& nat_type) const;
     libp2p::protocol::autonat::NATType ConvertToLibp2pNATType(NATType nat_type) const;
     std::string PeerIdToString(const libp2p::peer::PeerId& peer_id) const;
     libp2p::peer::PeerId StringToPeerId(const std::string& peer_id_str) const;
+    static std::shared_ptr<const ProtocolTable> MakeBuiltinProtocols();
+    // Interns the protocol and publishes a table with its handler replaced
+    void SetProtocolHandler(const std::string& protocol,
+                            std::function<void(const std::string&, std::span<const uint8_t>)> handler);
+    void ReceiveMessage(const std::shared_ptr<PeerState>& peer, const std::string& peer_id,
+                        ProtocolHandle protocol, std::span<const uint8_t> data);
+    void DispatchMessage(const std::string& peer_id, ProtocolHandle protocol,
+                         std::span<const uint8_t> data);
+    void HandleKeepalive(PeerState& peer, std::span<const uint8_t> data);
+    std::shared_ptr<PeerState> FindPeer(const std::string& peer_id) const;
+    std::shared_ptr<PeerState> FindPeer(PeerHandle handle) const;
+    // Caller must hold state_mutex_
+    void PublishPeers(PeerTable table);
+    // A free slab record, reset and given a new handle; null at max_connections
+    std::shared_ptr<PeerState> AcquirePeer(const std::string& peer_id);
+    void AddPeer(std::shared_ptr<PeerState> peer);
+    std::shared_ptr<PeerState> RemovePeer(const std::string& peer_id);
+    MultiplayerResult SendByName(PeerState& peer, const std::string& protocol,
+                                 const uint8_t* data, size_t size,
+                                 SendPriority priority = SendPriority::Realtime,
+                                 std::optional<uint64_t> latest_key = std::nullopt);
+    MultiplayerResult SendToPeer(PeerState& peer, ProtocolHandle protocol, std::string_view header,
+                                 const uint8_t* data, size_t size,
+                                 SendPriority priority = SendPriority::Realtime,
+                                 std::optional<uint64_t> latest_key = std::nullopt);
+    // The remaining helpers require peer.write_mutex to be held
+    MultiplayerResult SendToPeerLocked(PeerState& peer, ProtocolHandle protocol, std::string_view header,
+                                       const uint8_t* data, size_t size);
+    // @return The result of the message with this ticket, or success if another writer sent it
+    MultiplayerResult DrainSendQueueLocked(PeerState& peer, uint64_t ticket);
+    MultiplayerResult WriteToPeerStream(PeerState& peer, ProtocolHandle protocol, std::string_view header,
+                                        const uint8_t* data, size_t size);
+    MultiplayerResult WriteStreamSegments(PeerState& peer, std::string_view header,
+                                          std::span<const uint8_t> head,
+                                          std::span<const uint8_t> body);
+    MultiplayerResult FlushBundleLocked(PeerState& peer);
 };
 
 } // namespace Core::Multiplayer::ModelA
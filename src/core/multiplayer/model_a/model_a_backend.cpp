@@ -3,22 +3,65 @@
 
 #include "model_a_backend.h"
 
+#include <cctype>
+#include <sstream>
+#include <utility>
+
+#include "core/multiplayer/common/packet_trace.h"
+#include "core/multiplayer/common/startup_profile.h"
+
 namespace Core::Multiplayer::ModelA {
 
+namespace {
+
+std::string MakeMultiaddr(const std::string& ip, const std::string& transport, uint16_t port) {
+    const std::string family = ip.find(':') != std::string::npos ? "/ip6/" : "/ip4/";
+    if (transport == "udp") {
+        return family + ip + "/udp/" + std::to_string(port) + "/quic-v1";
+    }
+    return family + ip + "/tcp/" + std::to_string(port);
+}
+
+// Address of an ICE candidate line: "candidate:<foundation> <component>
+// <transport> <priority> <address> <port> typ <type> ..."
+std::string MultiaddrFromCandidate(const IceCandidate& candidate) {
+    std::istringstream fields(candidate.candidate);
+    std::string foundation, component, transport, priority, address;
+    uint32_t port = 0;
+    if (!(fields >> foundation >> component >> transport >> priority >> address >> port) ||
+        port == 0 || port > 0xFFFF) {
+        return {};
+    }
+    for (auto& c : transport) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return MakeMultiaddr(address, transport, static_cast<uint16_t>(port));
+}
+
+} // namespace
+
 bool ModelABackend::IsSupported() {
     return true;
 }
 
 ModelABackend::ModelABackend(std::shared_ptr<HLE::ConfigurationManager> config,
                              std::unique_ptr<IP2PNetwork> network)
-    : config_(std::move(config)), network_(std::move(network)) {}
+    : config_(std::move(config)), network_(std::move(network)),
+      advertise_data_([this](const AdvertiseDataPatch& patch, std::span<const uint8_t>) {
+          if (advertise_data_handler_) {
+              advertise_data_handler_(patch);
+          }
+      }) {}
 
 ErrorCode ModelABackend::Initialize() {
+    StartupSpan span(StartupPhase::BackendInitialize);
     initialized_ = true;
     return ErrorCode::Success;
 }
 
 ErrorCode ModelABackend::Finalize() {
+    node_routes_.Clear();
+    advertise_data_.Reset();
     initialized_ = false;
     return ErrorCode::Success;
 }
@@ -49,6 +92,20 @@ ErrorCode ModelABackend::Scan(std::vector<Service::LDN::NetworkInfo>&,
     return ErrorCode::NotImplemented;
 }
 
+void ModelABackend::SetDiscoveryFilter(const DiscoveryFilter& filter) {
+    if (filter == discovery_filter_) {
+        return;
+    }
+    discovery_filter_ = filter;
+    if (discovery_filter_handler_) {
+        discovery_filter_handler_(filter);
+    }
+}
+
+uint64_t ModelABackend::GetNetworksEpoch() const {
+    return networks_epoch_.load(std::memory_order_acquire);
+}
+
 ErrorCode ModelABackend::GetNetworkInfo(Service::LDN::NetworkInfo&) {
     return ErrorCode::NotImplemented;
 }
@@ -73,16 +130,276 @@ ErrorCode ModelABackend::CloseStation() {
     return ErrorCode::NotImplemented;
 }
 
-ErrorCode ModelABackend::SendPacket(const std::vector<uint8_t>&, uint8_t) {
-    return ErrorCode::NotImplemented;
+ErrorCode ModelABackend::SendPacket(const std::vector<uint8_t>& data, uint8_t node_id) {
+    return SendBytes(data.data(), data.size(), node_id, default_priority_);
 }
 
-ErrorCode ModelABackend::ReceivePacket(std::vector<uint8_t>&, uint8_t&) {
-    return ErrorCode::NotImplemented;
+ErrorCode ModelABackend::ReceivePacket(std::vector<uint8_t>& out_data, uint8_t& out_node_id) {
+    ReceivedPacket received;
+    const ErrorCode result = ReceivePacket(received.packet, received.node_id);
+    if (result != ErrorCode::Success) {
+        return result;
+    }
+
+    out_data.assign(received.packet.data(), received.packet.data() + received.packet.size());
+    out_node_id = received.node_id;
+    return ErrorCode::Success;
 }
 
-ErrorCode ModelABackend::SetAdvertiseData(const std::vector<uint8_t>&) {
-    return ErrorCode::NotImplemented;
+ErrorCode ModelABackend::SendPacket(const PacketBuffer& packet, uint8_t node_id) {
+    return SendBytes(packet.data(), packet.size(), node_id, default_priority_);
+}
+
+ErrorCode ModelABackend::SendPacket(const std::vector<uint8_t>& data, uint8_t node_id,
+                                    SendPriority priority) {
+    return SendBytes(data.data(), data.size(), node_id, priority);
+}
+
+ErrorCode ModelABackend::SendPacket(const PacketBuffer& packet, uint8_t node_id,
+                                    SendPriority priority) {
+    return SendBytes(packet.data(), packet.size(), node_id, priority);
+}
+
+ErrorCode ModelABackend::ReceivePacket(PacketBuffer& out_packet, uint8_t& out_node_id) {
+    if (!initialized_) {
+        return ErrorCode::NotInitialized;
+    }
+
+    // An empty queue yields an empty packet, matching the vector overload
+    ReceivedPacket received;
+    if (!receive_queue_.TryPop(received)) {
+        out_packet.Reset();
+        out_node_id = 0;
+        return ErrorCode::Success;
+    }
+    latency_.RecordSince(DataPathHop::ReceiveDequeue, received.queued_at);
+    MULTIPLAYER_TRACE_SPAN("ModelABackend::ReceiveQueue", received.trace_id, received.queued_at);
+
+    out_packet = std::move(received.packet);
+    out_node_id = received.node_id;
+    return ErrorCode::Success;
+}
+
+ErrorCode ModelABackend::SendPackets(const HLE::PacketRef* packets, size_t count,
+                                  size_t& out_sent) {
+    out_sent = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const ErrorCode result = SendBytes(packets[i].data, packets[i].size, packets[i].node_id,
+                                           default_priority_);
+        if (result != ErrorCode::Success) {
+            return result;
+        }
+        ++out_sent;
+    }
+    return ErrorCode::Success;
+}
+
+ErrorCode ModelABackend::SendBytes(const uint8_t* data, size_t size, uint8_t node_id,
+                                   SendPriority priority) {
+    if (!packet_sender_) {
+        return ErrorCode::NotImplemented;
+    }
+    if (node_id == NodeRoutingTable::BROADCAST_NODE_ID && node_routes_.GetActiveCount() != 0) {
+        return SendToEveryNode(data, size, priority);
+    }
+    MULTIPLAYER_TRACE_PACKET();
+    MULTIPLAYER_TRACE_ZONE("ModelABackend::SendPacket");
+    const uint64_t send_start = Latency::Now();
+    wire_bytes_sent_ = 0;
+    ErrorCode result;
+    if (const auto key = GetLatestValueKey(node_id, data, size)) {
+        latency_.RecordSince(DataPathHop::BackendEnqueue, send_start);
+        const uint64_t start = Latency::Now();
+        result = latest_value_sender_(node_id, data, size, priority, *key);
+        latency_.RecordSince(DataPathHop::TransportWrite, start);
+        if (result == ErrorCode::Success) {
+            wire_bytes_sent_ = size;
+        }
+    } else if (!delta_codec_) {
+        result = SendFramed(data, size, node_id, priority, send_start);
+    } else {
+        const size_t encoded_size =
+            delta_codec_->Encode(DeltaStreamKey{node_id}, data, size, encode_buffer_.data());
+        if (encoded_size == 0) {
+            return ErrorCode::InvalidParameter;
+        }
+        result = SendFramed(encode_buffer_.data(), encoded_size, node_id, priority, send_start);
+    }
+    if (result == ErrorCode::Success) {
+        stats_.OnSent(node_id, size, wire_bytes_sent_, send_start);
+        node_routes_.RecordSent(node_id);
+    } else {
+        node_routes_.RecordSendFailure(node_id);
+    }
+    return result;
+}
+
+ErrorCode ModelABackend::SendToEveryNode(const uint8_t* data, size_t size,
+                                         SendPriority priority) {
+    if (const auto mask = GetBroadcastMask()) {
+        // One uplink send; the relay replicates it
+        const uint64_t send_start = Latency::Now();
+        latency_.RecordSince(DataPathHop::BackendEnqueue, send_start);
+        const ErrorCode result = broadcast_sender_(*mask, data, size, priority);
+        latency_.RecordSince(DataPathHop::TransportWrite, send_start);
+        // The uplink paid for the bytes once, so only the first node is charged them
+        size_t wire_bytes = size;
+        node_routes_.ForEachActive([&](uint8_t node_id, const NodeRoute&) {
+            if (result != ErrorCode::Success) {
+                node_routes_.RecordSendFailure(node_id);
+                return;
+            }
+            stats_.OnSent(node_id, size, std::exchange(wire_bytes, 0), send_start);
+            node_routes_.RecordSent(node_id);
+        });
+        return result;
+    }
+
+    // One send per node keeps each node's delta and parity stream its own
+    ErrorCode result = ErrorCode::Success;
+    node_routes_.ForEachActive([&](uint8_t node_id, const NodeRoute&) {
+        const ErrorCode sent = SendBytes(data, size, node_id, priority);
+        if (sent != ErrorCode::Success) {
+            result = sent;
+        }
+    });
+    return result;
+}
+
+std::optional<uint64_t> ModelABackend::GetLatestValueKey(uint8_t node_id, const uint8_t* data,
+                                                         size_t size) const {
+    if (!latest_value_sender_ || delta_codec_ || fec_codec_ || multipath_codec_) {
+        return std::nullopt;
+    }
+    const auto slot = latest_value_key_.Extract({data, size});
+    if (!slot) {
+        return std::nullopt;
+    }
+    return *slot | (static_cast<uint64_t>(node_id) << 56);
+}
+
+std::optional<uint8_t> ModelABackend::GetBroadcastMask() const {
+    if (!broadcast_sender_ || delta_codec_ || fec_codec_ || multipath_codec_) {
+        return std::nullopt;
+    }
+    uint8_t mask = 0;
+    bool addressable = true;
+    node_routes_.ForEachActive([&](uint8_t node_id, const NodeRoute&) {
+        if (node_id >= 8) {
+            addressable = false;
+        } else {
+            mask |= static_cast<uint8_t>(1u << node_id);
+        }
+    });
+    if (!addressable) {
+        return std::nullopt;
+    }
+    return mask;
+}
+
+ErrorCode ModelABackend::SendFramed(const uint8_t* data, size_t size, uint8_t node_id,
+                                    SendPriority priority, uint64_t send_start) {
+    if (!fec_codec_) {
+        latency_.RecordSince(DataPathHop::BackendEnqueue, send_start);
+        return WriteToTransport(node_id, data, size, priority);
+    }
+
+    const uint8_t group_size = fec_group_target_.load(std::memory_order_relaxed);
+    if (group_size != 0 && group_size != fec_codec_->GetConfig().group_size) {
+        fec_codec_->SetGroupSize(group_size);
+    }
+
+    size_t framed_size = fec_codec_->Encode(node_id, data, size, fec_buffer_.data());
+    if (framed_size == 0) {
+        return ErrorCode::InvalidParameter;
+    }
+    latency_.RecordSince(DataPathHop::BackendEnqueue, send_start);
+    const ErrorCode result = WriteToTransport(node_id, fec_buffer_.data(), framed_size, priority);
+    if (result != ErrorCode::Success) {
+        return result;
+    }
+
+    // Parity is best effort; the data packet already went out
+    framed_size = fec_codec_->TakeParity(node_id, fec_buffer_.data());
+    if (framed_size != 0) {
+        WriteToTransport(node_id, fec_buffer_.data(), framed_size, priority);
+    }
+    return ErrorCode::Success;
+}
+
+ErrorCode ModelABackend::WriteToTransport(uint8_t node_id, const uint8_t* data, size_t size,
+                                          SendPriority priority) {
+    MULTIPLAYER_TRACE_ZONE("ModelABackend::TransportWrite");
+    const uint64_t start = Latency::Now();
+    if (multipath_codec_) {
+        const ErrorCode result = WriteToEveryPath(node_id, data, size, priority);
+        latency_.RecordSince(DataPathHop::TransportWrite, start);
+        return result;
+    }
+    const ErrorCode result = packet_sender_(node_id, data, size, priority);
+    latency_.RecordSince(DataPathHop::TransportWrite, start);
+    if (result == ErrorCode::Success) {
+        wire_bytes_sent_ += size;
+    }
+    return result;
+}
+
+ErrorCode ModelABackend::WriteToEveryPath(uint8_t node_id, const uint8_t* data, size_t size,
+                                          SendPriority priority) {
+    const bool redundant = priority == SendPriority::Realtime && secondary_sender_;
+    const size_t framed_size =
+        multipath_codec_->Encode(node_id, redundant, data, size, multipath_buffer_.data());
+    if (framed_size == 0) {
+        return ErrorCode::InvalidParameter;
+    }
+
+    ErrorCode result = packet_sender_(node_id, multipath_buffer_.data(), framed_size, priority);
+    if (result == ErrorCode::Success) {
+        multipath_codec_->OnSent(0, redundant);
+        wire_bytes_sent_ += framed_size;
+    }
+    if (!redundant) {
+        return result;
+    }
+    // Either copy arriving is enough
+    if (secondary_sender_(node_id, multipath_buffer_.data(), framed_size, priority) ==
+        ErrorCode::Success) {
+        multipath_codec_->OnSent(1, redundant);
+        wire_bytes_sent_ += framed_size;
+        result = ErrorCode::Success;
+    }
+    return result;
+}
+
+ErrorCode ModelABackend::ReceivePackets(ReceivedPacket* out_packets, size_t max_packets,
+                                     size_t& out_received) {
+    out_received = 0;
+    if (!initialized_) {
+        return ErrorCode::NotInitialized;
+    }
+
+    // Drain up to max_packets from the ring in one pass
+    while (out_received < max_packets && receive_queue_.TryPop(out_packets[out_received])) {
+        ++out_received;
+    }
+    if (out_received > 0) {
+        // One clock read for the whole batch
+        const uint64_t now = Latency::Now();
+        for (size_t i = 0; i < out_received; ++i) {
+            const uint64_t queued_at = out_packets[i].queued_at;
+            latency_.Record(DataPathHop::ReceiveDequeue, now > queued_at ? now - queued_at : 0);
+            MULTIPLAYER_TRACE_SPAN("ModelABackend::ReceiveQueue", out_packets[i].trace_id,
+                                   queued_at);
+        }
+    }
+    return ErrorCode::Success;
+}
+
+ErrorCode ModelABackend::SetAdvertiseData(const std::vector<uint8_t>& data) {
+    if (!advertise_data_.Set(data)) {
+        return ErrorCode::MessageTooLarge;
+    }
+    return ErrorCode::Success;
 }
 
 ErrorCode ModelABackend::SetStationAcceptPolicy(Service::LDN::AcceptPolicy) {
@@ -101,5 +418,362 @@ ErrorCode ModelABackend::GetDisconnectReason(Service::LDN::DisconnectReason&) {
     return ErrorCode::NotImplemented;
 }
 
+ErrorCode ModelABackend::GetIpv4Address(Service::LDN::Ipv4Address&, Service::LDN::Ipv4Address&) {
+    return ErrorCode::NotImplemented;
+}
+
+ErrorCode ModelABackend::GetNetworkConfig(Service::LDN::NetworkConfig&) {
+    return ErrorCode::NotImplemented;
+}
+
+void ModelABackend::RegisterNodeEventCallbacks(std::function<void(uint8_t)> on_node_joined,
+                                               std::function<void(uint8_t)> on_node_left) {
+    std::lock_guard<std::mutex> lock(node_event_mutex_);
+    on_node_joined_ = std::move(on_node_joined);
+    on_node_left_ = std::move(on_node_left);
+}
+
+void ModelABackend::ReportNodeJoined(uint8_t node_id, const NodeRoute& route) {
+    std::function<void(uint8_t)> on_node_joined;
+    {
+        std::lock_guard<std::mutex> lock(node_event_mutex_);
+        node_routes_.Join(node_id, route);
+        on_node_joined = on_node_joined_;
+    }
+    if (on_node_joined) {
+        on_node_joined(node_id);
+    }
+}
+
+void ModelABackend::ReportNodeLeft(uint8_t node_id) {
+    std::function<void(uint8_t)> on_node_left;
+    {
+        std::lock_guard<std::mutex> lock(node_event_mutex_);
+        node_routes_.Leave(node_id);
+        on_node_left = on_node_left_;
+    }
+    if (on_node_left) {
+        on_node_left(node_id);
+    }
+}
+
+const NodeRoutingTable& ModelABackend::GetNodeRoutes() const {
+    return node_routes_;
+}
+
+void ModelABackend::RegisterRateHintCallback(std::function<void(const RateHint&)> on_rate_hint) {
+    on_rate_hint_.Reset(std::move(on_rate_hint));
+}
+
+ErrorCode ModelABackend::GetStatistics(BackendStats& out_stats) const {
+    stats_.Fill(out_stats);
+    out_stats.receive_queue_depth = receive_queue_.Size();
+    out_stats.receive_queue_capacity = receive_queue_.Capacity();
+    return ErrorCode::Success;
+}
+
+DataPathStatistics ModelABackend::GetStatistics() const {
+    return latency_.Snapshot();
+}
+
+DataPathLatency* ModelABackend::GetDataPathLatency() {
+    return GetRecordableLatency(latency_);
+}
+
+void ModelABackend::ReportRateHint(const RateHint& hint) {
+    on_rate_hint_.Publish(hint);
+}
+
+void ModelABackend::ReportAvailableBandwidth(uint64_t bytes_per_second) {
+    available_bandwidth_.store(bytes_per_second, std::memory_order_relaxed);
+    TrafficProfile profile;
+    profile.fec_group_size = profile_fec_group_size_.load(std::memory_order_relaxed);
+    fec_group_target_.store(AdaptToBandwidth(profile, bytes_per_second).fec_group_size,
+                            std::memory_order_relaxed);
+}
+
+void ModelABackend::ReportRoomListChanged() {
+    networks_epoch_.fetch_add(1, std::memory_order_acq_rel);
+}
+
+bool ModelABackend::DeliverPacket(uint8_t node_id, const uint8_t* data, size_t size) {
+    return DeliverPacket(node_id, 0, data, size);
+}
+
+bool ModelABackend::DeliverPacket(uint8_t node_id, size_t path, const uint8_t* data,
+                                  size_t size) {
+    MULTIPLAYER_TRACE_PACKET();
+    MULTIPLAYER_TRACE_ZONE("ModelABackend::DeliverPacket");
+    const uint64_t start = Latency::Now();
+    const size_t wire_size = size;
+    std::lock_guard<std::mutex> lock(delivery_mutex_);
+    if (multipath_codec_) {
+        size_t offset = 0;
+        if (!multipath_codec_->Decode(node_id, path, data, size, offset)) {
+            // The other path's copy already came in, or the frame is not ours
+            return true;
+        }
+        data += offset;
+        size -= offset;
+    }
+    payload_bytes_queued_ = 0;
+    if (!fec_codec_) {
+        const bool queued = QueuePacket(node_id, data, size);
+        stats_.OnReceived(node_id, wire_size, payload_bytes_queued_, start);
+        latency_.RecordSince(DataPathHop::TransportRead, start);
+        return queued;
+    }
+
+    std::array<FecPacketView, 2> packets{};
+    const size_t count = fec_codec_->Decode(node_id, data, size, packets);
+    bool queued = true;
+    for (size_t i = 0; i < count; ++i) {
+        queued = QueuePacket(node_id, packets[i].data, packets[i].size) && queued;
+    }
+    const FecStatistics fec_statistics = fec_codec_->GetDecodeStatistics();
+    stats_.OnFecCounts(fec_statistics.packets_recovered, fec_statistics.packets_lost);
+    stats_.OnReceived(node_id, wire_size, payload_bytes_queued_, start);
+    latency_.RecordSince(DataPathHop::TransportRead, start);
+    return queued;
+}
+
+bool ModelABackend::QueuePacket(uint8_t node_id, const uint8_t* data, size_t size) {
+    ReceivedPacket received;
+    if (delta_codec_) {
+        // Decoded straight into the pooled buffer
+        received.packet = packet_pool_.Acquire();
+        size_t decoded_size = 0;
+        if (!received.packet ||
+            !delta_codec_->Decode(DeltaStreamKey{node_id}, data, size, received.packet.data(),
+                                  decoded_size)) {
+            return false;
+        }
+        received.packet.Resize(decoded_size);
+    } else {
+        received.packet = packet_pool_.Acquire(data, size);
+        if (!received.packet) {
+            return false;
+        }
+    }
+    received.node_id = node_id;
+    received.trace_id = MULTIPLAYER_TRACE_ID();
+    received.queued_at = Latency::Now();
+    const size_t payload_size = received.packet.size();
+    if (!receive_queue_.TryPush(std::move(received))) {
+        return false;
+    }
+    payload_bytes_queued_ += payload_size;
+    return true;
+}
+
+SpscRingStatistics ModelABackend::GetReceiveQueueStatistics() const {
+    return receive_queue_.GetStatistics();
+}
+
+void ModelABackend::ReportNodeLink(uint8_t node_id, const NodeLinkSample& sample) {
+    stats_.ReportLink(node_id, sample);
+}
+
+void ModelABackend::SetPacketSender(PacketSender sender) {
+    packet_sender_ = std::move(sender);
+}
+
+void ModelABackend::SetBroadcastSender(BroadcastSender sender) {
+    broadcast_sender_ = std::move(sender);
+}
+
+void ModelABackend::SetLatestValueSender(LatestValueSender sender) {
+    latest_value_sender_ = std::move(sender);
+}
+
+void ModelABackend::SetTrafficProfileHandler(TrafficProfileHandler handler) {
+    traffic_profile_handler_ = std::move(handler);
+}
+
+void ModelABackend::SetFrameBoundaryHandler(FrameBoundaryHandler handler) {
+    frame_boundary_handler_ = std::move(handler);
+}
+
+void ModelABackend::SetDiscoveryFilterHandler(DiscoveryFilterHandler handler) {
+    discovery_filter_handler_ = std::move(handler);
+}
+
+void ModelABackend::SetAdvertiseDataHandler(AdvertiseDataHandler handler) {
+    advertise_data_handler_ = std::move(handler);
+}
+
+void ModelABackend::RequestFullAdvertiseData() {
+    advertise_data_.RequestFull();
+}
+
+void ModelABackend::ApplyTrafficProfile(const TrafficProfile& profile) {
+    if (profile.fec_group_size == 0) {
+        DisableForwardErrorCorrection();
+    } else if (!fec_codec_ || profile_fec_group_size_ != profile.fec_group_size) {
+        EnableForwardErrorCorrection(FecConfig{profile.fec_group_size});
+    }
+    profile_fec_group_size_ = profile.fec_group_size;
+    ReportAvailableBandwidth(available_bandwidth_.load(std::memory_order_relaxed));
+    default_priority_ = profile.priority;
+    latest_value_key_ = profile.latest_value_key;
+    if (traffic_profile_handler_) {
+        traffic_profile_handler_(profile);
+    }
+}
+
+void ModelABackend::OnFrameBoundary() {
+    if (frame_boundary_handler_) {
+        frame_boundary_handler_();
+    }
+}
+
+void ModelABackend::EnableDeltaCoding(const DeltaCodecConfig& config) {
+    delta_codec_ = std::make_unique<DeltaCodec>(config);
+}
+
+void ModelABackend::DisableDeltaCoding() {
+    delta_codec_.reset();
+}
+
+void ModelABackend::AcknowledgeDeltaPacket(uint8_t node_id, uint16_t frame_id) {
+    if (delta_codec_) {
+        delta_codec_->Acknowledge(DeltaStreamKey{node_id}, frame_id);
+    }
+}
+
+std::optional<DeltaCodecStatistics> ModelABackend::GetDeltaCodecStatistics() const {
+    if (!delta_codec_) {
+        return std::nullopt;
+    }
+    return delta_codec_->GetStatistics();
+}
+
+void ModelABackend::EnableForwardErrorCorrection(const FecConfig& config) {
+    fec_codec_ = std::make_unique<FecCodec>(config);
+}
+
+void ModelABackend::DisableForwardErrorCorrection() {
+    fec_codec_.reset();
+}
+
+std::optional<FecStatistics> ModelABackend::GetFecStatistics() const {
+    if (!fec_codec_) {
+        return std::nullopt;
+    }
+    return fec_codec_->GetStatistics();
+}
+
+void ModelABackend::EnableRedundantSend(PacketSender secondary_sender) {
+    secondary_sender_ = std::move(secondary_sender);
+    multipath_codec_ = std::make_unique<MultipathCodec>();
+}
+
+void ModelABackend::DisableRedundantSend() {
+    multipath_codec_.reset();
+    secondary_sender_ = nullptr;
+}
+
+std::optional<MultipathStatistics> ModelABackend::GetMultipathStatistics() const {
+    if (!multipath_codec_) {
+        return std::nullopt;
+    }
+    return multipath_codec_->GetStatistics();
+}
+
+void ModelABackend::EnableSpeculativeConnect(const SpeculativeConnectConfig& config) {
+    if (!network_) {
+        return;
+    }
+    // The dial's future is dropped; the pool only needs the attempt started
+    speculative_connector_ = std::make_unique<SpeculativeConnector>(
+        config,
+        [this](const std::string& peer_id, const std::string& multiaddr) {
+            network_->ConnectToPeer(peer_id, multiaddr);
+        },
+        [this](const std::string& peer_id) { network_->DisconnectFromPeer(peer_id); });
+}
+
+void ModelABackend::DisableSpeculativeConnect() {
+    speculative_connector_.reset();
+}
+
+void ModelABackend::OnPlayerJoined(const PlayerJoinedMessage& message) {
+    if (lan_candidates_) {
+        lan_candidates_->Begin(message.player.id);
+    }
+    const auto& info = message.player.network_info;
+    if (!speculative_connector_ || info.public_ip.empty() || info.port == 0 ||
+        network_->IsConnectedToPeer(message.player.id)) {
+        return;
+    }
+    speculative_connector_->Prepare(message.player.id,
+                                    MakeMultiaddr(info.public_ip, "tcp", info.port));
+}
+
+void ModelABackend::OnPlayerLeft(const PlayerLeftMessage& message) {
+    if (lan_candidates_) {
+        lan_candidates_->End(message.player_id);
+        if (network_) {
+            network_->SetPeerLanAddresses(message.player_id, {});
+        }
+    }
+    if (speculative_connector_) {
+        speculative_connector_->Forget(message.player_id);
+    }
+}
+
+void ModelABackend::OnP2PInfoReceived(const P2PInfoMessage& message) {
+    if (lan_candidates_ && lan_candidates_->OnP2PInfo(message)) {
+        return;
+    }
+    if (!speculative_connector_ || network_->IsConnectedToPeer(message.from_player)) {
+        return;
+    }
+    // The first usable candidate is dialed; later ones are for ICE proper
+    for (const auto& candidate : message.ice_candidates) {
+        const std::string multiaddr = MultiaddrFromCandidate(candidate);
+        if (!multiaddr.empty()) {
+            speculative_connector_->Prepare(message.from_player, multiaddr);
+            return;
+        }
+    }
+}
+
+void ModelABackend::EnableLanCandidates(const std::string& local_player,
+                                        const NetworkFingerprint& network,
+                                        std::vector<LanHostCandidate> candidates,
+                                        LanCandidateExchange::SendCallback send) {
+    std::erase_if(candidates,
+                  [](const LanHostCandidate& candidate) { return !IsPrivateAddress(candidate.ip); });
+    lan_candidates_ = std::make_unique<LanCandidateExchange>(
+        local_player, LanFingerprint::From(network), std::move(candidates), std::move(send),
+        [this](const std::string& player, const std::vector<LanHostCandidate>& verified) {
+            if (!network_) {
+                return;
+            }
+            std::vector<std::string> multiaddrs;
+            for (const auto& candidate : verified) {
+                multiaddrs.push_back(MakeMultiaddr(candidate.ip, candidate.transport, candidate.port));
+            }
+            network_->SetPeerLanAddresses(player, std::move(multiaddrs));
+        });
+}
+
+void ModelABackend::DisableLanCandidates() {
+    lan_candidates_.reset();
+}
+
+bool ModelABackend::ClaimPeerConnection(const std::string& peer_id) {
+    return speculative_connector_ && speculative_connector_->Claim(peer_id);
+}
+
+std::optional<SpeculativeConnectStatistics> ModelABackend::GetSpeculativeConnectStatistics()
+    const {
+    if (!speculative_connector_) {
+        return std::nullopt;
+    }
+    return speculative_connector_->GetStatistics();
+}
+
 } // namespace Core::Multiplayer::ModelA
 
@@ -3,16 +3,33 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <vector>
 #include <cstdint>
 
+#include "core/multiplayer/common/advertise_data_publisher.h"
+#include "core/multiplayer/common/build_policy.h"
+#include "core/multiplayer/common/delta_codec.h"
+#include "core/multiplayer/common/event_bus.h"
+#include "core/multiplayer/common/fec_codec.h"
+#include "core/multiplayer/common/latency_histogram.h"
+#include "core/multiplayer/common/multipath_codec.h"
+#include "core/multiplayer/common/node_routing_table.h"
+#include "core/multiplayer/common/spsc_ring.h"
 #include "core/multiplayer/multiplayer_backend.h"
 #include "i_p2p_network.h"
+#include "lan_candidates.h"
+#include "room_messages.h"
+#include "speculative_connector.h"
 
 namespace Core::Multiplayer::ModelA {
 
-class ModelABackend : public HLE::MultiplayerBackend {
+class ModelABackend final : public HLE::MultiplayerBackend {
 public:
     static bool IsSupported();
 
@@ -33,6 +50,8 @@ public:
                    const Service::LDN::ScanFilter& filter) override;
     ErrorCode GetNetworkInfo(Service::LDN::NetworkInfo& out_info) override;
     ErrorCode GetCurrentState(Service::LDN::State& out_state) override;
+    void SetDiscoveryFilter(const DiscoveryFilter& filter) override;
+    uint64_t GetNetworksEpoch() const override;
 
     ErrorCode OpenAccessPoint() override;
     ErrorCode CloseAccessPoint() override;
@@ -41,17 +60,276 @@ public:
 
     ErrorCode SendPacket(const std::vector<uint8_t>& data, uint8_t node_id) override;
     ErrorCode ReceivePacket(std::vector<uint8_t>& out_data, uint8_t& out_node_id) override;
+    ErrorCode SendPacket(const PacketBuffer& packet, uint8_t node_id) override;
+    ErrorCode SendPacket(const std::vector<uint8_t>& data, uint8_t node_id,
+                         SendPriority priority) override;
+    ErrorCode SendPacket(const PacketBuffer& packet, uint8_t node_id,
+                         SendPriority priority) override;
+    ErrorCode ReceivePacket(PacketBuffer& out_packet, uint8_t& out_node_id) override;
+    ErrorCode SendPackets(const HLE::PacketRef* packets, size_t count, size_t& out_sent) override;
+    ErrorCode ReceivePackets(ReceivedPacket* out_packets, size_t max_packets,
+                             size_t& out_received) override;
 
     ErrorCode SetAdvertiseData(const std::vector<uint8_t>& data) override;
     ErrorCode SetStationAcceptPolicy(Service::LDN::AcceptPolicy policy) override;
     ErrorCode AddAcceptFilterEntry(const Service::LDN::MacAddress& mac) override;
     ErrorCode GetSecurityParameter(Service::LDN::SecurityParameter& out_param) override;
     ErrorCode GetDisconnectReason(Service::LDN::DisconnectReason& out_reason) override;
+    ErrorCode GetIpv4Address(Service::LDN::Ipv4Address& out_address,
+                             Service::LDN::Ipv4Address& out_subnet) override;
+    ErrorCode GetNetworkConfig(Service::LDN::NetworkConfig& out_config) override;
+
+    void RegisterNodeEventCallbacks(std::function<void(uint8_t)> on_node_joined,
+                                    std::function<void(uint8_t)> on_node_left) override;
+    void RegisterRateHintCallback(std::function<void(const RateHint&)> on_rate_hint) override;
+    void ApplyTrafficProfile(const TrafficProfile& profile) override;
+    void OnFrameBoundary() override;
+    ErrorCode GetStatistics(BackendStats& out_stats) const override;
+    DataPathStatistics GetStatistics() const override;
+    DataPathLatency* GetDataPathLatency() override;
+
+    /**
+     * Queue an inbound packet for ReceivePacket. May be called from several
+     * transport threads, e.g. the LAN and internet paths of a HybridRouter;
+     * deliveries are serialized, so callers never race one another.
+     * @return False if the pool or receive queue is exhausted (packet dropped)
+     */
+    bool DeliverPacket(uint8_t node_id, const uint8_t* data, size_t size);
+    // As above, for a packet that arrived over the given path of redundant sending
+    bool DeliverPacket(uint8_t node_id, size_t path, const uint8_t* data, size_t size);
+    // Entry point for the transport's congestion controller, e.g. RelayClient::SetOnRateHint
+    void ReportRateHint(const RateHint& hint);
+    /**
+     * Entry point for the transport's available-bandwidth estimate, e.g.
+     * RelayClient::SetOnBandwidthEstimate. FEC groups are resized from the
+     * traffic profile's by AdaptToBandwidth, from the next group on.
+     */
+    void ReportAvailableBandwidth(uint64_t bytes_per_second);
+    // Entry point for the room client's room list deltas; bumps GetNetworksEpoch
+    void ReportRoomListChanged();
+    SpscRingStatistics GetReceiveQueueStatistics() const;
+    // Entry point for the transport's view of a node's link: RTT, jitter,
+    // loss, whether it is direct or relayed and its encryption overhead
+    void ReportNodeLink(uint8_t node_id, const NodeLinkSample& sample);
+    // Entry points for the transport's membership changes; the route is
+    // what GetNodeRoutes() then resolves the node to
+    void ReportNodeJoined(uint8_t node_id, const NodeRoute& route = {});
+    void ReportNodeLeft(uint8_t node_id);
+    /**
+     * Nodes the transport reported, for its packet sender to resolve a node
+     * without a peer id lookup. A send to BROADCAST_NODE_ID goes to each of
+     * them in turn; with none reported, it is handed to the transport as is.
+     */
+    const NodeRoutingTable& GetNodeRoutes() const;
+
+    /**
+     * Transport sink for outgoing packets, handed the send class to pass on
+     * to the P2P network or relay; without one, sends fail with
+     * NotImplemented
+     */
+    using PacketSender = std::function<ErrorCode(uint8_t node_id, const uint8_t* data, size_t size,
+                                                 SendPriority priority)>;
+    void SetPacketSender(PacketSender sender);
+
+    /**
+     * Transport sink for a broadcast sent once and replicated by the relay
+     * to the nodes in destination_mask, bit n for node n, e.g.
+     * RelayClient::SendMulticast. A send to BROADCAST_NODE_ID uses it while
+     * every reported node has an id below 8 and no per-node stream (delta
+     * coding, FEC, redundant sending) is on; otherwise each node gets its
+     * own send.
+     */
+    using BroadcastSender = std::function<ErrorCode(uint8_t destination_mask, const uint8_t* data,
+                                                    size_t size, SendPriority priority)>;
+    void SetBroadcastSender(BroadcastSender sender);
+
+    /**
+     * Transport sink for state packets of a profile with a latest value
+     * key, e.g. RelayClient::SendLatest or IP2PNetwork::SendLatestMessage:
+     * a packet still queued with the same key is replaced rather than sent
+     * stale. The key is the packet's slot with the destination node in its
+     * top byte. Unused while delta coding, FEC or redundant sending is on,
+     * since replacing one of their packets would break the stream.
+     */
+    using LatestValueSender = std::function<ErrorCode(uint8_t node_id, const uint8_t* data,
+                                                      size_t size, SendPriority priority,
+                                                      uint64_t key)>;
+    void SetLatestValueSender(LatestValueSender sender);
+
+    /**
+     * Gets the transport half of a traffic profile: coalescing, jitter
+     * buffer and compression live in the P2P network or relay client, so
+     * their owner applies them. FEC and the default send class are applied
+     * here.
+     */
+    using TrafficProfileHandler = std::function<void(const TrafficProfile& profile)>;
+    void SetTrafficProfileHandler(TrafficProfileHandler handler);
+
+    /**
+     * Gets every frame boundary, for the owner to flush what the transport
+     * batched over the frame, e.g. RelayClient::FlushCoalescedPackets or
+     * Libp2pP2PNetwork::FlushCoalescedMessages
+     */
+    using FrameBoundaryHandler = std::function<void()>;
+    void SetFrameBoundaryHandler(FrameBoundaryHandler handler);
+
+    /**
+     * Gets the discovery filter whenever it changes, for the room client's
+     * owner to list and subscribe with, see ApplyDiscoveryFilter in
+     * room_list_index.h
+     */
+    using DiscoveryFilterHandler = std::function<void(const DiscoveryFilter& filter)>;
+    void SetDiscoveryFilterHandler(DiscoveryFilterHandler handler);
+
+    /**
+     * Gets the host's advertise data changes, diffed and at most one per
+     * AdvertiseDataPublisher::DEFAULT_INTERVAL, for the room client's owner
+     * to send with RoomClient::UpdateAdvertiseData. Runs on the thread
+     * calling SetAdvertiseData or on the timer wheel's.
+     */
+    using AdvertiseDataHandler = std::function<void(const AdvertiseDataPatch& patch)>;
+    void SetAdvertiseDataHandler(AdvertiseDataHandler handler);
+    // The next advertise data change goes out whole, e.g. after the room client reconnects
+    void RequestFullAdvertiseData();
+
+    /**
+     * Opt-in delta coding of LDN packets per node, between SendPacket and
+     * the packet sender and between the transport and DeliverPacket. Every
+     * node of the network must enable it; call before packets flow.
+     */
+    void EnableDeltaCoding(const DeltaCodecConfig& config);
+    void DisableDeltaCoding();
+    // For transports that learn which packets a node received
+    void AcknowledgeDeltaPacket(uint8_t node_id, uint16_t frame_id);
+    std::optional<DeltaCodecStatistics> GetDeltaCodecStatistics() const;
+
+    /**
+     * Opt-in XOR parity over each node's packets, outside delta coding. A
+     * packet lost from a group is rebuilt from the rest and handed to
+     * DeliverPacket's queue like any other; the recovered and lost counts
+     * are for the degradation manager's ReportPacketLoss.
+     */
+    void EnableForwardErrorCorrection(const FecConfig& config);
+    void DisableForwardErrorCorrection();
+    std::optional<FecStatistics> GetFecStatistics() const;
+
+    /**
+     * Opt-in redundant sending for latency-critical titles: Realtime packets
+     * also go out through the secondary sender, e.g. the relay beside the
+     * direct connection or a second relay, and the receiving side keeps
+     * whichever copy arrives first. Every node of the network must enable
+     * it, and the transport delivers the secondary's packets with path 1.
+     */
+    void EnableRedundantSend(PacketSender secondary_sender);
+    void DisableRedundantSend();
+    // Per-path win rates are GetWinRate of the result
+    std::optional<MultipathStatistics> GetMultipathStatistics() const;
+
+    /**
+     * Opt-in dialing of room members as soon as the room server announces
+     * them, so the P2P connection is already up when the session asks for
+     * it. The room client's message handler forwards the announcements.
+     */
+    void EnableSpeculativeConnect(const SpeculativeConnectConfig& config);
+    void DisableSpeculativeConnect();
+    void OnPlayerJoined(const PlayerJoinedMessage& message);
+    void OnPlayerLeft(const PlayerLeftMessage& message);
+    void OnP2PInfoReceived(const P2PInfoMessage& message);
+
+    /**
+     * Takes a peer's connection for the session, keeping it open past the
+     * speculative TTL
+     * @return True if it was dialed ahead of time
+     */
+    bool ClaimPeerConnection(const std::string& peer_id);
+    std::optional<SpeculativeConnectStatistics> GetSpeculativeConnectStatistics() const;
+
+    /**
+     * Opt-in exchange of private host candidates with room members behind
+     * the same router, see LanCandidateExchange. Each member that joins is
+     * sent an offer through send, e.g. RoomClient::SendP2PInfo, and once a
+     * member is verified the network dials its LAN addresses first; one
+     * already on the relay moves over when PathUpgrader next dials it.
+     * @param candidates This host's private listen addresses; public ones are dropped
+     */
+    void EnableLanCandidates(const std::string& local_player, const NetworkFingerprint& network,
+                             std::vector<LanHostCandidate> candidates,
+                             LanCandidateExchange::SendCallback send);
+    void DisableLanCandidates();
 
 private:
+    ErrorCode SendBytes(const uint8_t* data, size_t size, uint8_t node_id,
+                        SendPriority priority);
+    ErrorCode SendToEveryNode(const uint8_t* data, size_t size, SendPriority priority);
+    // Nodes a single broadcast send can address, or nullopt if it cannot be used
+    std::optional<uint8_t> GetBroadcastMask() const;
+    std::optional<uint64_t> GetLatestValueKey(uint8_t node_id, const uint8_t* data,
+                                              size_t size) const;
+    ErrorCode SendFramed(const uint8_t* data, size_t size, uint8_t node_id,
+                         SendPriority priority, uint64_t send_start);
+    ErrorCode WriteToTransport(uint8_t node_id, const uint8_t* data, size_t size,
+                               SendPriority priority);
+    ErrorCode WriteToEveryPath(uint8_t node_id, const uint8_t* data, size_t size,
+                               SendPriority priority);
+    bool QueuePacket(uint8_t node_id, const uint8_t* data, size_t size);
+
     std::shared_ptr<HLE::ConfigurationManager> config_;
     std::unique_ptr<IP2PNetwork> network_;
     bool initialized_ {false};
+    std::mutex node_event_mutex_;
+    std::function<void(uint8_t)> on_node_joined_;
+    std::function<void(uint8_t)> on_node_left_;
+    // Raised from transport threads
+    EventChannel<RateHint> on_rate_hint_;
+    std::atomic<uint64_t> networks_epoch_{0};
+
+    // Preallocated packet storage for the data path
+    static constexpr size_t RECEIVE_QUEUE_CAPACITY = 256;
+    PacketPool packet_pool_;
+    SpscRing<ReceivedPacket> receive_queue_{RECEIVE_QUEUE_CAPACITY};
+    // Held across DeliverPacket: the receive ring takes a single producer, and
+    // the multipath, FEC and delta decoders a single writer
+    std::mutex delivery_mutex_;
+
+    PacketSender packet_sender_;
+    BroadcastSender broadcast_sender_;
+    LatestValueSender latest_value_sender_;
+    NodeRoutingTable node_routes_;
+    TrafficProfileHandler traffic_profile_handler_;
+    FrameBoundaryHandler frame_boundary_handler_;
+    DiscoveryFilterHandler discovery_filter_handler_;
+    DiscoveryFilter discovery_filter_;
+    AdvertiseDataHandler advertise_data_handler_;
+    AdvertiseDataPublisher advertise_data_;
+    // Send class of packets sent without one
+    SendPriority default_priority_ = SendPriority::Realtime;
+    LatestValueKey latest_value_key_;
+    std::unique_ptr<DeltaCodec> delta_codec_;
+    std::unique_ptr<FecCodec> fec_codec_;
+    // FEC group size of the applied profile, and that adapted to the
+    // available bandwidth; the send path regroups to the latter
+    std::atomic<uint8_t> profile_fec_group_size_{0};
+    std::atomic<uint8_t> fec_group_target_{0};
+    std::atomic<uint64_t> available_bandwidth_{0};
+    std::unique_ptr<SpeculativeConnector> speculative_connector_;
+    std::unique_ptr<LanCandidateExchange> lan_candidates_;
+    std::unique_ptr<MultipathCodec> multipath_codec_;
+    PacketSender secondary_sender_;
+    // Only touched by the send path
+    std::array<uint8_t, DeltaCodec::MAX_ENCODED_SIZE> encode_buffer_{};
+    std::array<uint8_t, FecCodec::MAX_FRAMED_SIZE> fec_buffer_{};
+    std::array<uint8_t, MultipathCodec::MAX_FRAMED_SIZE> multipath_buffer_{};
+
+    // Recorded from the send, network and game threads alike; stand-ins
+    // that record nothing when the build policy leaves instrumentation out
+    using Instrumentation = ActiveBuildPolicy::Instrumentation;
+    using Latency = Instrumentation::Select<DataPathLatency, NullDataPathLatency>;
+    Latency latency_;
+    Instrumentation::Select<BackendStatsRecorder, NullBackendStatsRecorder> stats_;
+    // Bytes handed to the transport for the packet being sent; send path only
+    size_t wire_bytes_sent_ = 0;
+    // Bytes queued for the datagram being delivered; guarded by delivery_mutex_
+    size_t payload_bytes_queued_ = 0;
 };
 
 } // namespace Core::Multiplayer::ModelA
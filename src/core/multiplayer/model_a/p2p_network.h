@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "core/multiplayer/common/work_stealing_executor.h"
 #include "i_p2p_network.h"
 #include "p2p_types.h"
 #include <future>
@@ -12,7 +13,6 @@
 namespace Core::Multiplayer::ModelA {
 
 class Libp2pP2PNetwork; // forward declaration
-class AsyncExecutor;    // forward declaration for shared executor
 
 /**
  * High level P2P network facade.
@@ -21,7 +21,12 @@ class AsyncExecutor;    // forward declaration for shared executor
  */
 class P2PNetwork : public IP2PNetwork {
 public:
-    explicit P2PNetwork(const P2PNetworkConfig& config);
+    /**
+     * @param executor Pool for the asynchronous operations; the process-wide
+     *                 shared executor is used when null
+     */
+    explicit P2PNetwork(const P2PNetworkConfig& config,
+                        std::shared_ptr<WorkStealingExecutor> executor = nullptr);
     ~P2PNetwork() override;
 
     // Network lifecycle
@@ -44,8 +49,16 @@ public:
     // Message handling
     MultiplayerResult SendMessage(const std::string& peer_id, const std::string& protocol, const std::vector<uint8_t>& data) override;
     MultiplayerResult BroadcastMessage(const std::string& protocol, const std::vector<uint8_t>& data) override;
+    MultiplayerResult SendMessage(const std::string& peer_id, const std::string& protocol, const PacketBuffer& packet) override;
+    MultiplayerResult SendMessage(const std::string& peer_id, const std::string& protocol, const std::vector<uint8_t>& data, SendPriority priority) override;
+    MultiplayerResult SendLatestMessage(const std::string& peer_id, const std::string& protocol, const std::vector<uint8_t>& data, SendPriority priority, uint64_t key) override;
     void RegisterProtocolHandler(const std::string& protocol) override;
     void HandleIncomingMessage(const std::string& peer_id, const std::string& protocol, const std::vector<uint8_t>& data) override;
+    PeerHandle GetPeerHandle(const std::string& peer_id) const override;
+    ProtocolHandle GetProtocolHandle(const std::string& protocol) const override;
+    MultiplayerResult SendMessage(PeerHandle peer, ProtocolHandle protocol, const std::vector<uint8_t>& data) override;
+    MultiplayerResult SendMessage(PeerHandle peer, ProtocolHandle protocol, const PacketBuffer& packet) override;
+    void HandleIncomingMessage(PeerHandle peer, ProtocolHandle protocol, const std::vector<uint8_t>& data) override;
 
     // NAT traversal
     std::future<MultiplayerResult> DetectNATType() override;
@@ -54,6 +67,8 @@ public:
 
     // Relay management
     std::vector<std::string> GetConfiguredRelayServers() const override;
+    void SetPeerLanAddresses(const std::string& peer_id, std::vector<std::string> multiaddrs) override;
+    std::optional<ClockSyncSnapshot> GetPeerClockSync(const std::string& peer_id) const override;
 
     // Callbacks
     void SetOnPeerConnectedCallback(std::function<void(const std::string&)> callback) override;
@@ -69,15 +84,14 @@ private:
     mutable std::mutex callback_mutex_;
 
     /**
-     * @brief Shared executor providing a reusable worker thread pool.
+     * @brief Tasks submitted to the shared work-stealing executor.
      *
-     * The executor is thread-safe and used by asynchronous APIs such as
-     * Start(), ConnectToPeer() and DetectNATType(). Tasks submitted to the
-     * executor run on a fixed pool of worker threads rather than spawning new
-     * threads on each request. The executor's lifetime is bound to the
-     * P2PNetwork instance and all worker threads are joined on destruction.
+     * Start(), ConnectToPeer() and DetectNATType() run on the executor that
+     * P2PNetwork shares with the other multiplayer components instead of a
+     * private pool. Declared last so it is destroyed first: its destructor
+     * waits for every outstanding task while impl_ is still alive.
      */
-    std::shared_ptr<AsyncExecutor> executor_;
+    ExecutorTaskGroup tasks_;
 };
 
 } // namespace Core::Multiplayer::ModelA
@@ -32,22 +32,56 @@ namespace Core::Multiplayer::ModelA {
 struct P2PNetworkConfig {
     // Transport configuration
     bool enable_tcp = true;
-    bool enable_quic = false;
+    bool enable_quic = true;
     bool enable_websocket = false;
+    // Dial a peer's QUIC addresses before its TCP ones; TCP stays the fallback
+    bool prefer_quic = true;
     uint16_t tcp_port = 4001;
     uint16_t quic_port = 4001;
     uint16_t websocket_port = 4001;
     
-    // Connection limits
+    // Connection limits; peer state for max_connections peers is allocated up front
     size_t max_connections = 100;
     uint32_t connection_timeout_ms = 5000;
     
     // NAT traversal
     bool enable_autonat = true;
     bool enable_relay = true;
+    // Head start of the direct dial before a relay dial races it
+    uint32_t relay_head_start_ms = 250;
     
     // Relay servers
     std::vector<std::string> relay_servers;
+    
+    // Reachability persisted per network; empty path disables the cache
+    std::string reachability_cache_path;
+    uint32_t reachability_cache_ttl_s = 24 * 60 * 60;
+    
+    // Host key pair, created on first use; empty path makes a new peer id each session
+    std::string identity_key_path;
+    
+    // Last working path per peer; empty path disables the address book
+    std::string peer_address_book_path;
+    size_t peer_address_book_size = 256;
+};
+
+/**
+ * Compact handles for peers and protocols. They are resolved once, at
+ * connect or register time, so the per-packet path can skip string keys.
+ * A peer handle is never reused for a later connection.
+ */
+using PeerHandle = uint32_t;
+using ProtocolHandle = uint32_t;
+constexpr PeerHandle INVALID_PEER_HANDLE = 0xFFFFFFFF;
+constexpr ProtocolHandle INVALID_PROTOCOL_HANDLE = 0xFFFFFFFF;
+
+/**
+ * Which path carries a peer's packets
+ */
+enum class PeerPath : uint8_t {
+    None,
+    Direct, // P2P connection
+    Relay,  // Relay server session
 };
 
 } // namespace Core::Multiplayer::ModelA
@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "packet_bundle.h"
+
+namespace Core::Multiplayer::ModelA {
+
+PacketBundler::PacketBundler(size_t capacity) : capacity_(capacity) {
+    buffer_.reserve(capacity_);
+}
+
+bool PacketBundler::Append(std::span<const uint8_t> head, std::span<const uint8_t> tail) {
+    const size_t size = head.size() + tail.size();
+    if (!Fits(size)) {
+        return false;
+    }
+    buffer_.push_back(static_cast<uint8_t>(size & 0xFF));
+    buffer_.push_back(static_cast<uint8_t>((size >> 8) & 0xFF));
+    buffer_.insert(buffer_.end(), head.begin(), head.end());
+    buffer_.insert(buffer_.end(), tail.begin(), tail.end());
+    ++packet_count_;
+    return true;
+}
+
+void PacketBundler::Clear() {
+    // Keeps the capacity for the next bundle
+    buffer_.clear();
+    packet_count_ = 0;
+}
+
+size_t PacketBundler::CountPackets(std::span<const uint8_t> bundle) {
+    size_t count = 0;
+    size_t offset = 0;
+    while (offset < bundle.size()) {
+        if (bundle.size() - offset < LENGTH_PREFIX_SIZE) {
+            return 0;
+        }
+        const size_t size = ReadLength(bundle, offset);
+        offset += LENGTH_PREFIX_SIZE;
+        if (bundle.size() - offset < size) {
+            return 0;
+        }
+        offset += size;
+        ++count;
+    }
+    return count;
+}
+
+} // namespace Core::Multiplayer::ModelA
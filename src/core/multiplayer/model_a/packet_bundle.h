@@ -0,0 +1,88 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Core::Multiplayer::ModelA {
+
+/**
+ * Coalesces small packets for one destination into a single bundle
+ *
+ * A bundle is a sequence of entries, each a 2-byte little-endian length
+ * followed by that many bytes. LDN games send several tiny packets to the
+ * same node every frame; bundling them pays for one relay header and one
+ * send instead of one per packet.
+ *
+ * The buffer is reused across bundles, so steady-state appends do not
+ * allocate.
+ */
+class PacketBundler {
+public:
+    static constexpr size_t LENGTH_PREFIX_SIZE = 2;
+    static constexpr size_t MAX_ENTRY_SIZE = 0xFFFF;
+
+    // capacity bounds the encoded bundle, length prefixes included
+    explicit PacketBundler(size_t capacity);
+
+    // Whether an entry of entry_size bytes would still fit
+    bool Fits(size_t entry_size) const {
+        return entry_size <= MAX_ENTRY_SIZE &&
+               buffer_.size() + LENGTH_PREFIX_SIZE + entry_size <= capacity_;
+    }
+
+    /**
+     * Appends one packet made of head followed by tail
+     * @return False if it does not fit; the bundle is unchanged
+     */
+    bool Append(std::span<const uint8_t> head, std::span<const uint8_t> tail = {});
+
+    std::span<const uint8_t> GetBundle() const { return buffer_; }
+    // The only packet, without its length prefix; valid when the count is 1
+    std::span<const uint8_t> GetSinglePacket() const {
+        return std::span<const uint8_t>(buffer_).subspan(LENGTH_PREFIX_SIZE);
+    }
+    size_t GetPacketCount() const { return packet_count_; }
+    bool Empty() const { return packet_count_ == 0; }
+    size_t GetCapacity() const { return capacity_; }
+
+    void Clear();
+
+    /**
+     * Calls visitor(packet) for each packet of an encoded bundle, in order.
+     * The whole bundle is checked first, so a malformed one delivers nothing.
+     * @return False if the bundle is malformed
+     */
+    template <typename Visitor>
+    static bool ForEachPacket(std::span<const uint8_t> bundle, Visitor&& visitor) {
+        if (CountPackets(bundle) == 0) {
+            return false;
+        }
+        size_t offset = 0;
+        while (offset < bundle.size()) {
+            const size_t size = ReadLength(bundle, offset);
+            visitor(bundle.subspan(offset + LENGTH_PREFIX_SIZE, size));
+            offset += LENGTH_PREFIX_SIZE + size;
+        }
+        return true;
+    }
+
+    // Number of packets in an encoded bundle, or 0 if it is malformed or empty
+    static size_t CountPackets(std::span<const uint8_t> bundle);
+
+private:
+    static size_t ReadLength(std::span<const uint8_t> bundle, size_t offset) {
+        return static_cast<size_t>(bundle[offset]) |
+               (static_cast<size_t>(bundle[offset + 1]) << 8);
+    }
+
+    size_t capacity_;
+    std::vector<uint8_t> buffer_;
+    size_t packet_count_ = 0;
+};
+
+} // namespace Core::Multiplayer::ModelA
@@ -0,0 +1,175 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "packet_cipher.h"
+#include "core/multiplayer/common/build_policy.h"
+#include "core/multiplayer/common/cpu_features.h"
+#include "core/multiplayer/common/packet_trace.h"
+
+#include <array>
+#include <cstring>
+
+#include <openssl/evp.h>
+
+namespace Core::Multiplayer::ModelA {
+
+namespace {
+constexpr size_t IV_SIZE = 12;
+
+const EVP_CIPHER* CipherFor(AeadAlgorithm algorithm) {
+    return algorithm == AeadAlgorithm::Aes256Gcm ? EVP_aes_256_gcm() : EVP_chacha20_poly1305();
+}
+
+// 96-bit IV: four zero bytes, then the nonce little-endian
+std::array<uint8_t, IV_SIZE> MakeIv(uint64_t nonce) {
+    std::array<uint8_t, IV_SIZE> iv{};
+    for (size_t i = 0; i < 8; ++i) {
+        iv[4 + i] = static_cast<uint8_t>(nonce >> (8 * i));
+    }
+    return iv;
+}
+
+EVP_CIPHER_CTX* NewContext(AeadAlgorithm algorithm, const uint8_t* key, bool encrypt) {
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    if (ctx == nullptr) {
+        return nullptr;
+    }
+    // The key schedule is computed here once; per packet only the IV changes
+    if (EVP_CipherInit_ex(ctx, CipherFor(algorithm), nullptr, key, nullptr, encrypt ? 1 : 0) != 1) {
+        EVP_CIPHER_CTX_free(ctx);
+        return nullptr;
+    }
+    return ctx;
+}
+
+bool AddAssociatedData(EVP_CIPHER_CTX* ctx, std::span<const uint8_t> associated_data) {
+    if (associated_data.empty()) {
+        return true;
+    }
+    int length = 0;
+    return EVP_CipherUpdate(ctx, nullptr, &length, associated_data.data(),
+                            static_cast<int>(associated_data.size())) == 1;
+}
+
+// Unused when the build policy fixes the cipher
+[[maybe_unused]] AeadAlgorithm ProbeAlgorithm() {
+    const CpuFeatures& features = GetCpuFeatures();
+    if (features.Has(CpuFeature::Aes | CpuFeature::Pclmul) ||
+        features.Has(CpuFeature::ArmAes | CpuFeature::ArmPmull)) {
+        return AeadAlgorithm::Aes256Gcm;
+    }
+    return AeadAlgorithm::ChaCha20Poly1305;
+}
+} // namespace
+
+AeadAlgorithm PacketCipher::PreferredAlgorithm() {
+    constexpr CipherSelection selection = ActiveBuildPolicy::Encryption::cipher;
+    if constexpr (selection == CipherSelection::ChaCha20Poly1305) {
+        return AeadAlgorithm::ChaCha20Poly1305;
+    } else if constexpr (selection == CipherSelection::Aes256Gcm) {
+        return AeadAlgorithm::Aes256Gcm;
+    } else {
+        return ProbeAlgorithm();
+    }
+}
+
+PacketCipher::PacketCipher(AeadAlgorithm algorithm, std::span<const uint8_t, KEY_SIZE> key)
+    : algorithm_(algorithm) {
+    encrypt_ctx_ = NewContext(algorithm, key.data(), true);
+    decrypt_ctx_ = NewContext(algorithm, key.data(), false);
+}
+
+PacketCipher::~PacketCipher() {
+    EVP_CIPHER_CTX_free(encrypt_ctx_);
+    EVP_CIPHER_CTX_free(decrypt_ctx_);
+}
+
+size_t PacketCipher::SealBatch(std::span<PacketBuffer> packets,
+                               std::span<const uint8_t> associated_data) {
+    size_t sealed = 0;
+    for (auto& packet : packets) {
+        if (Seal(packet, associated_data)) {
+            ++sealed;
+        } else {
+            packet.Reset();
+        }
+    }
+    statistics_.sealed += sealed;
+    return sealed;
+}
+
+size_t PacketCipher::OpenBatch(std::span<PacketBuffer> packets,
+                               std::span<const uint8_t> associated_data) {
+    size_t opened = 0;
+    for (auto& packet : packets) {
+        if (Open(packet, associated_data)) {
+            ++opened;
+        } else {
+            packet.Reset();
+        }
+    }
+    statistics_.opened += opened;
+    return opened;
+}
+
+bool PacketCipher::Seal(PacketBuffer& packet, std::span<const uint8_t> associated_data) {
+    MULTIPLAYER_TRACE_ZONE("PacketCipher::Seal");
+    if (!IsValid() || packet.empty() || packet.size() + OVERHEAD > packet.capacity()) {
+        return false;
+    }
+
+    const uint64_t nonce = next_nonce_++;
+    const auto iv = MakeIv(nonce);
+    uint8_t* data = packet.data();
+    const int size = static_cast<int>(packet.size());
+    int length = 0;
+    if (EVP_CipherInit_ex(encrypt_ctx_, nullptr, nullptr, nullptr, iv.data(), 1) != 1 ||
+        !AddAssociatedData(encrypt_ctx_, associated_data) ||
+        EVP_CipherUpdate(encrypt_ctx_, data, &length, data, size) != 1 ||
+        EVP_CipherFinal_ex(encrypt_ctx_, data + length, &length) != 1 ||
+        EVP_CIPHER_CTX_ctrl(encrypt_ctx_, EVP_CTRL_AEAD_GET_TAG, TAG_SIZE, data + size) != 1) {
+        return false;
+    }
+    std::memcpy(data + size + TAG_SIZE, iv.data() + 4, NONCE_SIZE);
+    return packet.Resize(packet.size() + OVERHEAD);
+}
+
+bool PacketCipher::Open(PacketBuffer& packet, std::span<const uint8_t> associated_data) {
+    MULTIPLAYER_TRACE_ZONE("PacketCipher::Open");
+    if (!IsValid() || packet.size() < OVERHEAD) {
+        return false;
+    }
+
+    uint8_t* data = packet.data();
+    const size_t size = packet.size() - OVERHEAD;
+    std::array<uint8_t, IV_SIZE> iv{};
+    std::memcpy(iv.data() + 4, data + size + TAG_SIZE, NONCE_SIZE);
+    uint64_t nonce = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        nonce |= static_cast<uint64_t>(iv[4 + i]) << (8 * i);
+    }
+    // Nonce zero is never sent
+    if (nonce == 0 || received_.Check(nonce) != decltype(received_)::Result::New) {
+        ++statistics_.replays_rejected;
+        return false;
+    }
+
+    int length = 0;
+    if (EVP_CipherInit_ex(decrypt_ctx_, nullptr, nullptr, nullptr, iv.data(), 0) != 1 ||
+        EVP_CIPHER_CTX_ctrl(decrypt_ctx_, EVP_CTRL_AEAD_SET_TAG, TAG_SIZE, data + size) != 1 ||
+        !AddAssociatedData(decrypt_ctx_, associated_data) ||
+        EVP_CipherUpdate(decrypt_ctx_, data, &length, data, static_cast<int>(size)) != 1) {
+        return false;
+    }
+    if (EVP_CipherFinal_ex(decrypt_ctx_, data + length, &length) != 1) {
+        // The plaintext written so far is not authentic; the buffer is released
+        ++statistics_.authentication_failures;
+        return false;
+    }
+
+    // Only authentic packets move the window, so forgeries cannot shift it
+    received_.Mark(nonce);
+    return packet.Resize(size);
+}
+
+} // namespace Core::Multiplayer::ModelA
@@ -0,0 +1,120 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "core/multiplayer/common/packet_buffer.h"
+#include "core/multiplayer/common/replay_window.h"
+
+typedef struct evp_cipher_ctx_st EVP_CIPHER_CTX;
+
+namespace Core::Multiplayer::ModelA {
+
+enum class AeadAlgorithm : uint8_t {
+    ChaCha20Poly1305,
+    Aes256Gcm,
+};
+
+/**
+ * Counters for one PacketCipher
+ */
+struct PacketCipherStatistics {
+    uint64_t sealed = 0;
+    uint64_t opened = 0;
+    // Tag mismatches: corrupted or forged packets
+    uint64_t authentication_failures = 0;
+    // Nonces already seen or too old for the replay window
+    uint64_t replays_rejected = 0;
+};
+
+/**
+ * Authenticated encryption of data packets for one direction of a session.
+ *
+ * The key is set up once and the OpenSSL context is kept, so each packet only
+ * costs a nonce reset and the cipher pass itself; SealBatch and OpenBatch
+ * handle a whole burst per call. OpenSSL picks the implementation for the CPU
+ * at runtime (AES-NI and PCLMULQDQ, ARMv8 AES and PMULL, or AVX2 and NEON
+ * for ChaCha20).
+ *
+ * Packets are transformed in place in their pooled buffers. A sealed packet
+ * is the ciphertext followed by the 16-byte tag and the 8-byte nonce, so
+ * sealing grows a packet by OVERHEAD bytes and opening shrinks it back.
+ * Nonces count up from 1; each key must only ever be used by one sender.
+ *
+ * Not thread-safe: use one cipher per direction per session.
+ */
+class PacketCipher {
+public:
+    static constexpr size_t KEY_SIZE = 32;
+    static constexpr size_t TAG_SIZE = 16;
+    static constexpr size_t NONCE_SIZE = 8;
+    static constexpr size_t OVERHEAD = TAG_SIZE + NONCE_SIZE;
+    // Packets this far behind the newest one received are rejected as replays;
+    // wide enough that a burst reordered across batches is not mistaken for one
+    static constexpr uint64_t REPLAY_WINDOW = 1024;
+
+    /**
+     * AES-256-GCM where the CPU has AES and carry-less multiply
+     * instructions, otherwise ChaCha20-Poly1305, which is faster in software.
+     * A build policy with a fixed cipher returns it without probing.
+     */
+    static AeadAlgorithm PreferredAlgorithm();
+
+    PacketCipher(AeadAlgorithm algorithm, std::span<const uint8_t, KEY_SIZE> key);
+    ~PacketCipher();
+
+    PacketCipher(const PacketCipher&) = delete;
+    PacketCipher& operator=(const PacketCipher&) = delete;
+
+    // False if OpenSSL could not set up the cipher
+    bool IsValid() const {
+        return encrypt_ctx_ != nullptr && decrypt_ctx_ != nullptr;
+    }
+
+    AeadAlgorithm GetAlgorithm() const {
+        return algorithm_;
+    }
+
+    /**
+     * Encrypts each packet in place and appends its tag and nonce
+     * @param associated_data Authenticated but not encrypted, e.g. the
+     *        transport header; the receiver must pass the same bytes
+     * @return Number of packets sealed. Packets that could not be sealed
+     *         (empty, or no room for OVERHEAD more bytes) are released, so
+     *         the caller can send the batch skipping empty handles.
+     */
+    size_t SealBatch(std::span<PacketBuffer> packets,
+                     std::span<const uint8_t> associated_data = {});
+
+    /**
+     * Verifies and decrypts each packet in place, dropping the tag and nonce
+     * @return Number of packets opened. Packets that fail authentication or
+     *         replay checks are released.
+     */
+    size_t OpenBatch(std::span<PacketBuffer> packets,
+                     std::span<const uint8_t> associated_data = {});
+
+    PacketCipherStatistics GetStatistics() const {
+        return statistics_;
+    }
+
+private:
+    bool Seal(PacketBuffer& packet, std::span<const uint8_t> associated_data);
+    bool Open(PacketBuffer& packet, std::span<const uint8_t> associated_data);
+
+    AeadAlgorithm algorithm_;
+    EVP_CIPHER_CTX* encrypt_ctx_ = nullptr;
+    EVP_CIPHER_CTX* decrypt_ctx_ = nullptr;
+    uint64_t next_nonce_ = 1;
+
+    // Nonces opened, over the last REPLAY_WINDOW
+    ReplayWindow<REPLAY_WINDOW> received_;
+
+    PacketCipherStatistics statistics_;
+};
+
+} // namespace Core::Multiplayer::ModelA
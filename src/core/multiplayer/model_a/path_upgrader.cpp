@@ -0,0 +1,345 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "path_upgrader.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <utility>
+
+namespace Core::Multiplayer::ModelA {
+
+namespace {
+
+constexpr uint8_t FRAME_PLAIN = 0;
+constexpr uint8_t FRAME_SEQUENCED = 1;
+
+} // namespace
+
+PathUpgrader::PathUpgrader(const PathUpgradeConfig& config, DialFunction dial, SendFunction send,
+                           PathFunction on_path_changed, std::shared_ptr<TimerWheel> timer_wheel)
+    : config_(config), dial_(std::move(dial)), send_(std::move(send)),
+      on_path_changed_(std::move(on_path_changed)),
+      timer_wheel_(timer_wheel ? std::move(timer_wheel) : TimerWheel::GetShared()) {}
+
+PathUpgrader::~PathUpgrader() {
+    std::unordered_map<std::string, Peer> peers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        peers.swap(peers_);
+    }
+    // Cancel waits out a running OnTimer, which then finds no peer
+    for (const auto& [peer_id, peer] : peers) {
+        timer_wheel_->Cancel(peer.timer);
+    }
+}
+
+void PathUpgrader::AddPeer(const std::string& peer_id, PeerPath path) {
+    Effects effects;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto [it, inserted] = peers_.try_emplace(peer_id);
+        if (!inserted) {
+            return;
+        }
+        Peer& peer = it->second;
+        if (path == PeerPath::Direct) {
+            peer.state = PathState::Direct;
+            return;
+        }
+        EnterLocked(peer, PathState::Dialing, effects);
+        ArmLocked(peer, config_.verify_timeout, effects);
+        effects.dial = true;
+        ++statistics_.attempts;
+    }
+    Apply(peer_id, effects);
+}
+
+void PathUpgrader::RemovePeer(const std::string& peer_id) {
+    TimerWheel::TimerId timer;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = peers_.find(peer_id);
+        if (it == peers_.end()) {
+            return;
+        }
+        timer = it->second.timer;
+        if (it->second.state == PathState::DualSend) {
+            dual_sending_.fetch_sub(1, std::memory_order_release);
+        }
+        peers_.erase(it);
+    }
+    timer_wheel_->Cancel(timer);
+}
+
+void PathUpgrader::OnDirectConnected(const std::string& peer_id) {
+    Effects effects;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = peers_.find(peer_id);
+        if (it == peers_.end()) {
+            return;
+        }
+        Peer& peer = it->second;
+        if (peer.state != PathState::Relayed && peer.state != PathState::Dialing) {
+            return;
+        }
+        EnterLocked(peer, PathState::DualSend, effects);
+        ArmLocked(peer, config_.dual_send_duration, effects);
+    }
+    Apply(peer_id, effects);
+}
+
+void PathUpgrader::OnDirectDisconnected(const std::string& peer_id) {
+    Effects effects;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = peers_.find(peer_id);
+        if (it == peers_.end()) {
+            return;
+        }
+        Peer& peer = it->second;
+        switch (peer.state) {
+        case PathState::Relayed:
+            return;
+        case PathState::Dialing:
+        case PathState::DualSend:
+            ++statistics_.failures;
+            break;
+        case PathState::Direct:
+            ++statistics_.fallbacks;
+            effects.path_changed = PeerPath::Relay;
+            break;
+        }
+        RetryLaterLocked(peer, effects);
+    }
+    Apply(peer_id, effects);
+}
+
+bool PathUpgrader::Send(const std::string& peer_id, const uint8_t* data, size_t size) {
+    if (size > MAX_PAYLOAD_SIZE) {
+        return false;
+    }
+
+    PathState state;
+    uint32_t sequence = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = peers_.find(peer_id);
+        if (it == peers_.end()) {
+            return false;
+        }
+        state = it->second.state;
+        if (state == PathState::DualSend) {
+            sequence = it->second.next_send_sequence++;
+            ++statistics_.dual_sent;
+        }
+    }
+
+    std::array<uint8_t, SEQUENCED_HEADER_SIZE + MAX_PAYLOAD_SIZE> frame;
+    if (state != PathState::DualSend) {
+        frame[0] = FRAME_PLAIN;
+        std::memcpy(frame.data() + 1, data, size);
+        const PeerPath path = state == PathState::Direct ? PeerPath::Direct : PeerPath::Relay;
+        return send_(peer_id, path, frame.data(), size + 1);
+    }
+
+    frame[0] = FRAME_SEQUENCED;
+    for (size_t i = 0; i < 4; ++i) {
+        frame[1 + i] = static_cast<uint8_t>(sequence >> (8 * i));
+    }
+    std::memcpy(frame.data() + SEQUENCED_HEADER_SIZE, data, size);
+    const size_t frame_size = SEQUENCED_HEADER_SIZE + size;
+    // Relay first: it is the path known to work
+    const bool relayed = send_(peer_id, PeerPath::Relay, frame.data(), frame_size);
+    const bool direct = send_(peer_id, PeerPath::Direct, frame.data(), frame_size);
+    return relayed || direct;
+}
+
+std::optional<std::span<const uint8_t>> PathUpgrader::Receive(const std::string& peer_id,
+                                                              PeerPath path,
+                                                              std::span<const uint8_t> frame) {
+    if (frame.empty()) {
+        return std::nullopt;
+    }
+    const uint8_t kind = frame[0];
+    if (kind != FRAME_PLAIN && kind != FRAME_SEQUENCED) {
+        return std::nullopt;
+    }
+    if (kind == FRAME_SEQUENCED && frame.size() < SEQUENCED_HEADER_SIZE) {
+        return std::nullopt;
+    }
+    const size_t header_size = kind == FRAME_PLAIN ? 1 : SEQUENCED_HEADER_SIZE;
+    // Plain frames over the relay, or once no peer is dual sending, need no bookkeeping
+    if (kind == FRAME_PLAIN &&
+        (path != PeerPath::Direct || dual_sending_.load(std::memory_order_acquire) == 0)) {
+        return frame.subspan(1);
+    }
+
+    Effects effects;
+    bool duplicate = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = peers_.find(peer_id);
+        if (it == peers_.end()) {
+            return frame.subspan(header_size);
+        }
+        Peer& peer = it->second;
+        if (kind == FRAME_SEQUENCED) {
+            uint32_t sequence = 0;
+            for (size_t i = 0; i < 4; ++i) {
+                sequence |= static_cast<uint32_t>(frame[1 + i]) << (8 * i);
+            }
+            duplicate = !AcceptSequenceLocked(peer, sequence);
+            if (duplicate) {
+                ++statistics_.duplicates;
+            }
+        }
+        // Anything arriving over it proves the direct path works both ways
+        if (path == PeerPath::Direct && peer.state == PathState::DualSend) {
+            peer.direct_verified = true;
+            if (peer.window_elapsed) {
+                EnterLocked(peer, PathState::Direct, effects);
+                peer.retry_delay = std::chrono::milliseconds{0};
+                effects.path_changed = PeerPath::Direct;
+                ++statistics_.upgrades;
+            }
+        }
+    }
+    Apply(peer_id, effects);
+    if (duplicate) {
+        return std::nullopt;
+    }
+    return frame.subspan(header_size);
+}
+
+std::optional<PathState> PathUpgrader::GetState(const std::string& peer_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = peers_.find(peer_id);
+    if (it == peers_.end()) {
+        return std::nullopt;
+    }
+    return it->second.state;
+}
+
+PathUpgradeStatistics PathUpgrader::GetStatistics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return statistics_;
+}
+
+void PathUpgrader::EnterLocked(Peer& peer, PathState state, Effects& effects) {
+    if ((peer.state == PathState::DualSend) != (state == PathState::DualSend)) {
+        if (state == PathState::DualSend) {
+            dual_sending_.fetch_add(1, std::memory_order_release);
+        } else {
+            dual_sending_.fetch_sub(1, std::memory_order_release);
+        }
+    }
+    peer.state = state;
+    ++peer.generation;
+    peer.window_elapsed = false;
+    peer.direct_verified = false;
+    if (peer.timer != TimerWheel::INVALID_TIMER_ID) {
+        effects.cancel = peer.timer;
+        peer.timer = TimerWheel::INVALID_TIMER_ID;
+    }
+}
+
+void PathUpgrader::ArmLocked(Peer& peer, std::chrono::milliseconds delay, Effects& effects) {
+    effects.arm = delay;
+    effects.generation = peer.generation;
+}
+
+void PathUpgrader::RetryLaterLocked(Peer& peer, Effects& effects) {
+    EnterLocked(peer, PathState::Relayed, effects);
+    peer.retry_delay = peer.retry_delay.count() == 0
+                           ? config_.retry_interval
+                           : std::min(peer.retry_delay * 2, config_.max_retry_interval);
+    ArmLocked(peer, peer.retry_delay, effects);
+}
+
+void PathUpgrader::Apply(const std::string& peer_id, const Effects& effects) {
+    timer_wheel_->Cancel(effects.cancel);
+    if (effects.arm) {
+        // Scheduled outside the lock, since OnTimer takes it on the wheel thread
+        const uint64_t generation = effects.generation;
+        const TimerWheel::TimerId timer = timer_wheel_->Schedule(
+            *effects.arm, [this, peer_id, generation] { OnTimer(peer_id, generation); });
+        bool attached = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            const auto it = peers_.find(peer_id);
+            if (it != peers_.end() && it->second.generation == generation) {
+                it->second.timer = timer;
+                attached = true;
+            }
+        }
+        if (!attached) {
+            timer_wheel_->Cancel(timer);
+        }
+    }
+    if (effects.dial) {
+        dial_(peer_id);
+    }
+    if (effects.path_changed && on_path_changed_) {
+        on_path_changed_(peer_id, *effects.path_changed);
+    }
+}
+
+void PathUpgrader::OnTimer(const std::string& peer_id, uint64_t generation) {
+    Effects effects;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = peers_.find(peer_id);
+        if (it == peers_.end() || it->second.generation != generation) {
+            return;
+        }
+        Peer& peer = it->second;
+        peer.timer = TimerWheel::INVALID_TIMER_ID;
+        switch (peer.state) {
+        case PathState::Relayed:
+            EnterLocked(peer, PathState::Dialing, effects);
+            ArmLocked(peer, config_.verify_timeout, effects);
+            effects.dial = true;
+            ++statistics_.attempts;
+            break;
+        case PathState::Dialing:
+            ++statistics_.failures;
+            RetryLaterLocked(peer, effects);
+            break;
+        case PathState::DualSend:
+            if (peer.window_elapsed) {
+                ++statistics_.failures;
+                RetryLaterLocked(peer, effects);
+            } else if (peer.direct_verified) {
+                EnterLocked(peer, PathState::Direct, effects);
+                peer.retry_delay = std::chrono::milliseconds{0};
+                effects.path_changed = PeerPath::Direct;
+                ++statistics_.upgrades;
+            } else {
+                // Keep dual sending until something arrives directly or verify_timeout
+                peer.window_elapsed = true;
+                ArmLocked(peer,
+                          std::max(config_.verify_timeout - config_.dual_send_duration,
+                                   std::chrono::milliseconds{1}),
+                          effects);
+            }
+            break;
+        case PathState::Direct:
+            break;
+        }
+    }
+    Apply(peer_id, effects);
+}
+
+bool PathUpgrader::AcceptSequenceLocked(Peer& peer, uint32_t sequence) {
+    // Unwrapped from one wrap in, so sequences before the first stay positive
+    const uint64_t unwrapped =
+        peer.received.IsStarted()
+            ? UnwrapSequence(sequence, peer.received.GetHighest())
+            : (uint64_t{1} << 32) + sequence;
+    return peer.received.CheckAndMark(unwrapped) == ReplayWindow<64>::Result::New;
+}
+
+} // namespace Core::Multiplayer::ModelA
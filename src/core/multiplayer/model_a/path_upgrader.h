@@ -0,0 +1,165 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+
+#include "core/multiplayer/common/packet_buffer.h"
+#include "core/multiplayer/common/replay_window.h"
+#include "core/multiplayer/common/timer_wheel.h"
+#include "p2p_types.h"
+
+namespace Core::Multiplayer::ModelA {
+
+struct PathUpgradeConfig {
+    // First retry after a failed upgrade; doubles up to max_retry_interval
+    std::chrono::milliseconds retry_interval{5000};
+    std::chrono::milliseconds max_retry_interval{60000};
+    // Every packet goes over both paths for at least this long
+    std::chrono::milliseconds dual_send_duration{500};
+    // A dial, or a direct path nothing arrives over, is given up after this long
+    std::chrono::milliseconds verify_timeout{3000};
+};
+
+struct PathUpgradeStatistics {
+    uint64_t attempts = 0;    // Dials started
+    uint64_t upgrades = 0;    // Relay retired for a verified direct path
+    uint64_t failures = 0;    // Dials or direct paths given up on
+    uint64_t fallbacks = 0;   // Direct path lost after the relay was retired
+    uint64_t dual_sent = 0;   // Packets sent over both paths
+    uint64_t duplicates = 0;  // Received copies dropped
+};
+
+enum class PathState : uint8_t {
+    Relayed,  // Relay only, waiting to retry
+    Dialing,  // Relay only, direct dial in flight
+    DualSend, // Both paths, sequenced, until the direct one is verified
+    Direct,   // Direct only; the relay was retired
+};
+
+/**
+ * Make-before-break move of relayed peers onto direct P2P connections.
+ *
+ * A peer that starts out relayed is dialed in the background, with backoff
+ * between failed attempts. Once a direct connection is up, every packet goes
+ * out over both paths with a sequence number for dual_send_duration, and
+ * the receiving side drops whichever copy arrives second. When the window
+ * is over and a packet has arrived over the direct path, the relay is
+ * retired for the peer; if nothing arrives over it in verify_timeout, the
+ * peer stays on the relay. A direct path lost later falls back to the relay.
+ *
+ * Frames carry a one byte header, plus a sequence number while dual
+ * sending, so both ends of a peer connection must use a PathUpgrader.
+ *
+ * Thread-safe. The dial, send and path functions are called without the
+ * lock held, dial and path also from the wheel thread, and must not block
+ * for long.
+ */
+class PathUpgrader {
+public:
+    // Header of a frame sent while dual sending
+    static constexpr size_t SEQUENCED_HEADER_SIZE = 5;
+    static constexpr size_t MAX_PAYLOAD_SIZE = PACKET_BUFFER_SIZE;
+
+    // Starts a direct connection; its outcome comes back through OnDirectConnected/Disconnected
+    using DialFunction = std::function<void(const std::string& peer_id)>;
+    using SendFunction = std::function<bool(const std::string& peer_id, PeerPath path,
+                                            const uint8_t* data, size_t size)>;
+    /**
+     * The peer's packets moved to the path: Direct once the relay can be
+     * released, Relay when the direct path was lost and it is needed again
+     */
+    using PathFunction = std::function<void(const std::string& peer_id, PeerPath path)>;
+
+    PathUpgrader(const PathUpgradeConfig& config, DialFunction dial, SendFunction send,
+                 PathFunction on_path_changed, std::shared_ptr<TimerWheel> timer_wheel = nullptr);
+    ~PathUpgrader();
+
+    PathUpgrader(const PathUpgrader&) = delete;
+    PathUpgrader& operator=(const PathUpgrader&) = delete;
+
+    /**
+     * Starts tracking a peer reached over the given path; a relayed one is
+     * dialed right away
+     */
+    void AddPeer(const std::string& peer_id, PeerPath path);
+    void RemovePeer(const std::string& peer_id);
+
+    // A direct connection to the peer is up, dialed by either side
+    void OnDirectConnected(const std::string& peer_id);
+    // A dial failed or the direct connection dropped
+    void OnDirectDisconnected(const std::string& peer_id);
+
+    /**
+     * Frames the packet and sends it over the peer's current path, or both
+     * @return False if no path took it, or it is over MAX_PAYLOAD_SIZE
+     */
+    bool Send(const std::string& peer_id, const uint8_t* data, size_t size);
+
+    /**
+     * Unframes a packet from the peer that arrived over the path
+     * @return The payload, a view into frame, or std::nullopt for a
+     *         duplicate or malformed frame
+     */
+    std::optional<std::span<const uint8_t>> Receive(const std::string& peer_id, PeerPath path,
+                                                    std::span<const uint8_t> frame);
+
+    std::optional<PathState> GetState(const std::string& peer_id) const;
+    PathUpgradeStatistics GetStatistics() const;
+
+private:
+    struct Peer {
+        PathState state = PathState::Relayed;
+        // Bumped on every transition; older timers find it changed and do nothing
+        uint64_t generation = 0;
+        TimerWheel::TimerId timer = TimerWheel::INVALID_TIMER_ID;
+        std::chrono::milliseconds retry_delay{0};
+        bool window_elapsed = false;
+        bool direct_verified = false;
+        uint32_t next_send_sequence = 0;
+        // Sequences received, unwrapped to 64 bits
+        ReplayWindow<64> received;
+    };
+
+    // What a transition leaves to do once the lock is released
+    struct Effects {
+        TimerWheel::TimerId cancel = TimerWheel::INVALID_TIMER_ID;
+        std::optional<std::chrono::milliseconds> arm;
+        uint64_t generation = 0;
+        bool dial = false;
+        std::optional<PeerPath> path_changed;
+    };
+
+    void EnterLocked(Peer& peer, PathState state, Effects& effects);
+    void ArmLocked(Peer& peer, std::chrono::milliseconds delay, Effects& effects);
+    void RetryLaterLocked(Peer& peer, Effects& effects);
+    void Apply(const std::string& peer_id, const Effects& effects);
+    void OnTimer(const std::string& peer_id, uint64_t generation);
+    // Records the sequence; false if it was already received or is too old to tell
+    bool AcceptSequenceLocked(Peer& peer, uint32_t sequence);
+
+    const PathUpgradeConfig config_;
+    const DialFunction dial_;
+    const SendFunction send_;
+    const PathFunction on_path_changed_;
+    const std::shared_ptr<TimerWheel> timer_wheel_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Peer> peers_;
+    PathUpgradeStatistics statistics_;
+    // Peers in DualSend; with none, plain frames skip the lock on receive
+    std::atomic<size_t> dual_sending_{0};
+};
+
+} // namespace Core::Multiplayer::ModelA
@@ -0,0 +1,66 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "payload_compression.h"
+
+#include <memory>
+#include <lz4.h>
+
+namespace Core::Multiplayer::ModelA {
+
+namespace {
+// Favours speed over ratio; game payloads are small and sent every frame
+constexpr int LZ4_ACCELERATION = 1;
+
+struct CompressionContext {
+    CompressionContext()
+        : state(std::make_unique<uint64_t[]>(
+              (static_cast<size_t>(LZ4_sizeofState()) + sizeof(uint64_t) - 1) /
+              sizeof(uint64_t))),
+          compressed(std::make_unique<uint8_t[]>(PayloadCompressor::MAX_INPUT_SIZE)),
+          decompressed(std::make_unique<uint8_t[]>(PayloadCompressor::MAX_INPUT_SIZE)) {}
+
+    // LZ4 requires its state to be 8-byte aligned
+    std::unique_ptr<uint64_t[]> state;
+    std::unique_ptr<uint8_t[]> compressed;
+    std::unique_ptr<uint8_t[]> decompressed;
+};
+
+CompressionContext& GetContext() {
+    thread_local CompressionContext context;
+    return context;
+}
+} // namespace
+
+std::span<const uint8_t> PayloadCompressor::Compress(std::span<const uint8_t> payload) {
+    if (payload.size() < 2 || payload.size() > MAX_INPUT_SIZE) {
+        return {};
+    }
+    auto& context = GetContext();
+    // One byte short of the input, so LZ4 gives up on anything that would not shrink
+    const int size = LZ4_compress_fast_extState(
+        context.state.get(), reinterpret_cast<const char*>(payload.data()),
+        reinterpret_cast<char*>(context.compressed.get()), static_cast<int>(payload.size()),
+        static_cast<int>(payload.size() - 1), LZ4_ACCELERATION);
+    if (size <= 0) {
+        return {};
+    }
+    return {context.compressed.get(), static_cast<size_t>(size)};
+}
+
+std::span<const uint8_t> PayloadCompressor::Decompress(std::span<const uint8_t> payload) {
+    if (payload.empty() || payload.size() > MAX_INPUT_SIZE) {
+        return {};
+    }
+    auto& context = GetContext();
+    const int size = LZ4_decompress_safe(reinterpret_cast<const char*>(payload.data()),
+                                         reinterpret_cast<char*>(context.decompressed.get()),
+                                         static_cast<int>(payload.size()),
+                                         static_cast<int>(MAX_INPUT_SIZE));
+    if (size <= 0) {
+        return {};
+    }
+    return {context.decompressed.get(), static_cast<size_t>(size)};
+}
+
+} // namespace Core::Multiplayer::ModelA
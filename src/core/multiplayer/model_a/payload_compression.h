@@ -0,0 +1,39 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace Core::Multiplayer::ModelA {
+
+/**
+ * LZ4 compression of relay payloads (EXT_FLAG_COMPRESSED)
+ *
+ * Each thread owns one LZ4 state and one output buffer per direction,
+ * allocated on its first use and reused afterwards, so compressing or
+ * decompressing a packet never allocates. Results are views of that
+ * thread's buffer and stay valid until its next call in the same direction.
+ */
+class PayloadCompressor {
+public:
+    // Largest payload that is compressed, and largest a compressed one expands to
+    static constexpr size_t MAX_INPUT_SIZE = 0xFFFF;
+
+    /**
+     * Compresses a payload
+     * @return The compressed bytes, or an empty span if LZ4 could not make
+     *         the payload any smaller; it is then sent as is
+     */
+    static std::span<const uint8_t> Compress(std::span<const uint8_t> payload);
+
+    /**
+     * Decompresses a payload produced by Compress
+     * @return The original bytes, or an empty span if the input is corrupt
+     */
+    static std::span<const uint8_t> Decompress(std::span<const uint8_t> payload);
+};
+
+} // namespace Core::Multiplayer::ModelA
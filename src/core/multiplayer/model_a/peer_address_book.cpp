@@ -0,0 +1,128 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "peer_address_book.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <utility>
+
+#include <nlohmann/json.hpp>
+
+namespace Core::Multiplayer::ModelA {
+
+namespace {
+using json = nlohmann::json;
+
+constexpr int BOOK_FORMAT_VERSION = 1;
+
+int64_t ToUnixSeconds(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+}
+} // namespace
+
+PeerAddressBook::PeerAddressBook(std::string path, size_t max_entries)
+    : path_(std::move(path)), max_entries_(std::max<size_t>(max_entries, 1)) {}
+
+bool PeerAddressBook::Load() {
+    std::ifstream file(path_);
+    if (!file) {
+        return true;
+    }
+
+    decltype(records_) records{GetMemoryResource(MemorySubsystem::P2P)};
+    try {
+        const json document = json::parse(file);
+        if (document.value("version", 0) != BOOK_FORMAT_VERSION) {
+            return false;
+        }
+        for (const auto& entry : document.at("peers")) {
+            PeerAddressRecord record;
+            record.multiaddr = entry.at("multiaddr").get<std::string>();
+            record.via_relay = entry.value("via_relay", false);
+            record.success_count = entry.value("success_count", 0u);
+            record.last_connected = std::chrono::system_clock::time_point(
+                std::chrono::seconds(entry.at("last_connected").get<int64_t>()));
+            records[entry.at("peer_id").get<std::string>()] = std::move(record);
+        }
+    } catch (const json::exception&) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    records_ = std::move(records);
+    return true;
+}
+
+std::optional<PeerAddressRecord> PeerAddressBook::Lookup(const std::string& peer_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = records_.find(peer_id);
+    if (it == records_.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+bool PeerAddressBook::RecordSuccess(const std::string& peer_id, const std::string& multiaddr,
+                                    bool via_relay, std::chrono::system_clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& record = records_[peer_id];
+    record.multiaddr = multiaddr;
+    record.via_relay = via_relay;
+    ++record.success_count;
+    record.last_connected = now;
+
+    if (records_.size() > max_entries_) {
+        const auto oldest = std::min_element(
+            records_.begin(), records_.end(), [](const auto& lhs, const auto& rhs) {
+                return lhs.second.last_connected < rhs.second.last_connected;
+            });
+        records_.erase(oldest);
+    }
+    return SaveLocked();
+}
+
+bool PeerAddressBook::Forget(const std::string& peer_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (records_.erase(peer_id) == 0) {
+        return true;
+    }
+    return SaveLocked();
+}
+
+size_t PeerAddressBook::GetRecordCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return records_.size();
+}
+
+bool PeerAddressBook::SaveLocked() const {
+    json peers = json::array();
+    for (const auto& [peer_id, record] : records_) {
+        peers.push_back({{"peer_id", peer_id},
+                         {"multiaddr", record.multiaddr},
+                         {"via_relay", record.via_relay},
+                         {"success_count", record.success_count},
+                         {"last_connected", ToUnixSeconds(record.last_connected)}});
+    }
+    const json document{{"version", BOOK_FORMAT_VERSION}, {"peers", std::move(peers)}};
+
+    // Written aside and renamed over, so a crash never leaves half a file
+    const std::string temp_path = path_ + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+        file << document.dump();
+        if (!file.flush()) {
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temp_path, path_, error);
+    return !error;
+}
+
+} // namespace Core::Multiplayer::ModelA
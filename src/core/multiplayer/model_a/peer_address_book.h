@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "core/multiplayer/common/memory_accounting.h"
+
+namespace Core::Multiplayer::ModelA {
+
+/**
+ * How a peer was last reached
+ */
+struct PeerAddressRecord {
+    // Address the direct dial got through on, or was given when it did not
+    std::string multiaddr;
+    // The relay won; the next attempt starts it without a head start
+    bool via_relay = false;
+    uint32_t success_count = 0;
+    std::chrono::system_clock::time_point last_connected;
+};
+
+/**
+ * Recently reached peers, kept across sessions so a player met before is
+ * dialed on the path that last worked instead of from scratch. Peer ids
+ * only stay meaningful while hosts keep their identity keys.
+ *
+ * Holds at most max_entries peers, forgetting the least recently reached.
+ * The file is JSON, rewritten whole through a temporary file whenever a
+ * record changes; a missing or unreadable file just starts an empty book.
+ */
+class PeerAddressBook {
+public:
+    PeerAddressBook(std::string path, size_t max_entries);
+
+    PeerAddressBook(const PeerAddressBook&) = delete;
+    PeerAddressBook& operator=(const PeerAddressBook&) = delete;
+
+    /**
+     * Reads the file, replacing what is held
+     * @return False if the file exists but could not be parsed
+     */
+    bool Load();
+
+    std::optional<PeerAddressRecord> Lookup(const std::string& peer_id) const;
+
+    /**
+     * Records a successful connection and writes the file
+     * @return False if the file could not be written; the record is kept
+     */
+    bool RecordSuccess(const std::string& peer_id, const std::string& multiaddr, bool via_relay,
+                       std::chrono::system_clock::time_point now = std::chrono::system_clock::now());
+
+    // Drops a peer whose remembered path failed, and writes the file
+    bool Forget(const std::string& peer_id);
+
+    size_t GetRecordCount() const;
+
+private:
+    bool SaveLocked() const;
+
+    const std::string path_;
+    const size_t max_entries_;
+
+    mutable std::mutex mutex_;
+    std::pmr::unordered_map<std::string, PeerAddressRecord> records_{
+        GetMemoryResource(MemorySubsystem::P2P)};
+};
+
+} // namespace Core::Multiplayer::ModelA
@@ -0,0 +1,132 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "pending_request_table.h"
+
+#include <utility>
+#include <vector>
+
+namespace Core::Multiplayer::ModelA {
+
+PendingRequestTable::PendingRequestTable(std::shared_ptr<TimerWheel> timer_wheel,
+                                         size_t max_in_flight, std::chrono::milliseconds timeout)
+    : timer_wheel_(timer_wheel ? std::move(timer_wheel) : TimerWheel::GetShared()),
+      max_in_flight_(max_in_flight), timeout_(timeout) {
+    pending_.reserve(max_in_flight_);
+}
+
+PendingRequestTable::~PendingRequestTable() {
+    // Cancel waits out a running Expire, so nothing touches this afterwards
+    Clear();
+}
+
+void PendingRequestTable::SetOnTimeout(TimeoutCallback callback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    on_timeout_ = std::move(callback);
+}
+
+uint32_t PendingRequestTable::Begin(MessageType type) {
+    uint32_t request_id = INVALID_REQUEST_ID;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pending_.size() >= max_in_flight_) {
+            return INVALID_REQUEST_ID;
+        }
+        // Skips 0 and any id still waiting after the counter wraps
+        do {
+            request_id = next_id_++;
+        } while (request_id == INVALID_REQUEST_ID || pending_.count(request_id) != 0);
+        pending_[request_id].type = type;
+    }
+
+    // Scheduled outside the lock, since Expire takes it on the wheel thread
+    AttachTimer(request_id, ScheduleTimeout(request_id));
+    return request_id;
+}
+
+bool PendingRequestTable::Extend(uint32_t request_id) {
+    TimerWheel::TimerId old_timer;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = pending_.find(request_id);
+        if (it == pending_.end()) {
+            return false;
+        }
+        old_timer = std::exchange(it->second.timer, TimerWheel::INVALID_TIMER_ID);
+    }
+    timer_wheel_->Cancel(old_timer);
+    return AttachTimer(request_id, ScheduleTimeout(request_id));
+}
+
+bool PendingRequestTable::Complete(uint32_t request_id) {
+    TimerWheel::TimerId timer;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = pending_.find(request_id);
+        if (it == pending_.end()) {
+            return false;
+        }
+        timer = it->second.timer;
+        pending_.erase(it);
+    }
+    timer_wheel_->Cancel(timer);
+    return true;
+}
+
+void PendingRequestTable::Clear() {
+    std::vector<TimerWheel::TimerId> timers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        timers.reserve(pending_.size());
+        for (const auto& [request_id, pending] : pending_) {
+            timers.push_back(pending.timer);
+        }
+        pending_.clear();
+    }
+    for (const auto timer : timers) {
+        timer_wheel_->Cancel(timer);
+    }
+}
+
+size_t PendingRequestTable::GetInFlightCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.size();
+}
+
+TimerWheel::TimerId PendingRequestTable::ScheduleTimeout(uint32_t request_id) {
+    return timer_wheel_->Schedule(timeout_, [this, request_id]() { Expire(request_id); });
+}
+
+bool PendingRequestTable::AttachTimer(uint32_t request_id, TimerWheel::TimerId timer) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = pending_.find(request_id);
+        if (it != pending_.end()) {
+            it->second.timer = timer;
+            return true;
+        }
+    }
+    // Answered in the meantime; the timer must not outlive the table
+    timer_wheel_->Cancel(timer);
+    return false;
+}
+
+void PendingRequestTable::Expire(uint32_t request_id) {
+    MessageType type;
+    TimeoutCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = pending_.find(request_id);
+        if (it == pending_.end()) {
+            return; // Answered while the timer was firing
+        }
+        type = it->second.type;
+        pending_.erase(it);
+        callback = on_timeout_;
+    }
+    if (callback) {
+        callback(request_id, type);
+    }
+}
+
+} // namespace Core::Multiplayer::ModelA
@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "core/multiplayer/common/timer_wheel.h"
+#include "room_messages.h"
+
+namespace Core::Multiplayer::ModelA {
+
+/**
+ * Requests sent to the room server and still waiting for their reply,
+ * keyed by the request id the reply echoes.
+ *
+ * Each request holds one timer on the shared TimerWheel, so starting,
+ * answering and expiring a request are all O(1) however many are in
+ * flight. The table caps how many may wait at once, so a stalled server
+ * pushes back on callers instead of accumulating requests.
+ *
+ * Thread-safe. The timeout callback runs on the wheel thread without the
+ * table's lock held.
+ */
+class PendingRequestTable {
+public:
+    using TimeoutCallback = std::function<void(uint32_t request_id, MessageType type)>;
+
+    static constexpr uint32_t INVALID_REQUEST_ID = 0;
+
+    PendingRequestTable(std::shared_ptr<TimerWheel> timer_wheel, size_t max_in_flight,
+                        std::chrono::milliseconds timeout);
+    ~PendingRequestTable();
+
+    PendingRequestTable(const PendingRequestTable&) = delete;
+    PendingRequestTable& operator=(const PendingRequestTable&) = delete;
+
+    void SetOnTimeout(TimeoutCallback callback);
+
+    /**
+     * Registers a request about to be sent
+     * @return Its id, or INVALID_REQUEST_ID when max_in_flight are waiting
+     */
+    uint32_t Begin(MessageType type);
+
+    /**
+     * Gives a request expecting further replies, such as the next page of a
+     * room query, a fresh timeout
+     * @return False if it is not waiting
+     */
+    bool Extend(uint32_t request_id);
+
+    /**
+     * Matches a reply, or withdraws a request that could not be sent
+     * @return False for unknown, expired or already answered ids
+     */
+    bool Complete(uint32_t request_id);
+
+    // Forgets every request without reporting them, e.g. on shutdown
+    void Clear();
+
+    size_t GetInFlightCount() const;
+    size_t GetMaxInFlight() const { return max_in_flight_; }
+
+private:
+    struct Pending {
+        MessageType type = MessageType::Unknown;
+        TimerWheel::TimerId timer = TimerWheel::INVALID_TIMER_ID;
+    };
+
+    TimerWheel::TimerId ScheduleTimeout(uint32_t request_id);
+    // Records the request's timer, or cancels it if the request is gone
+    bool AttachTimer(uint32_t request_id, TimerWheel::TimerId timer);
+    void Expire(uint32_t request_id);
+
+    const std::shared_ptr<TimerWheel> timer_wheel_;
+    const size_t max_in_flight_;
+    const std::chrono::milliseconds timeout_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<uint32_t, Pending> pending_;
+    uint32_t next_id_ = 1;
+    TimeoutCallback on_timeout_;
+};
+
+} // namespace Core::Multiplayer::ModelA
@@ -0,0 +1,299 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "permessage_deflate.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+
+#include <zlib.h>
+
+namespace Core::Multiplayer::ModelA {
+
+namespace {
+
+constexpr std::string_view EXTENSION_NAME = "permessage-deflate";
+constexpr std::string_view DICTIONARY_PARAMETER = "x-sudachi-room-dictionary";
+
+// Every message ends with an empty stored block, which the sender strips
+constexpr std::array<uint8_t, 4> TAIL{0x00, 0x00, 0xFF, 0xFF};
+
+// zlib cannot produce a raw deflate stream with an 8-bit window
+constexpr int MIN_WINDOW_BITS = 9;
+constexpr int MAX_WINDOW_BITS = 15;
+
+// zlib weighs the end of the dictionary most, so the commonest strings go last
+constexpr std::string_view ROOM_MESSAGE_DICTIONARY =
+    R"({"type":"error","error_code":"","message":"","details":"","retry_after":)"
+    R"({"type":"p2p_info","session_description":{"type":"offer","sdp":"v=0"},)"
+    R"("ice_candidates":[{"candidate":"candidate:","sdp_mid":"0","sdp_mline_index":0}],)"
+    R"("end_of_candidates":true,"from_player":"","to_player":"","connection_type":"relay",)"
+    R"("relay_server":"","relay_port":,"session_id":"","resume_token":"","expires_at":)"
+    R"({"type":"player_left","player_id":"","reason":"")"
+    R"({"type":"player_joined","player":{"id":"","username":"","is_host":false},)"
+    R"("player_slot":{"type":"join_room_response","success":true,"room_id":"","players":[)"
+    R"({"type":"room_list_response","total_count":,"next_cursor":"","rooms":[)"
+    R"({"type":"room_list_delta","base_version":,"version":,"snapshot":false,)"
+    R"("removed":["],"upserted":[{"id":"","game_id":"0100","game_name":"","host_name":"",)"
+    R"("current_players":1,"max_players":8,"ping":,"region":"eu"},{"id":"","game_id":"0100",)"
+    R"("game_name":"","host_name":"","current_players":,"max_players":,"ping":,"region":"us"},)";
+
+// Splits on a separator outside quoted strings, trimming blanks
+std::vector<std::string_view> Split(std::string_view text, char separator) {
+    std::vector<std::string_view> parts;
+    bool quoted = false;
+    size_t start = 0;
+    for (size_t i = 0; i <= text.size(); ++i) {
+        if (i < text.size() && text[i] == '"') {
+            quoted = !quoted;
+        }
+        if (i == text.size() || (text[i] == separator && !quoted)) {
+            std::string_view part = text.substr(start, i - start);
+            while (!part.empty() && (part.front() == ' ' || part.front() == '\t')) {
+                part.remove_prefix(1);
+            }
+            while (!part.empty() && (part.back() == ' ' || part.back() == '\t')) {
+                part.remove_suffix(1);
+            }
+            parts.push_back(part);
+            start = i + 1;
+        }
+    }
+    return parts;
+}
+
+std::optional<int> ParseWindowBits(std::string_view value) {
+    if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+        value = value.substr(1, value.size() - 2);
+    }
+    int bits = 0;
+    const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), bits);
+    if (error != std::errc{} || end != value.data() + value.size() || bits < 8 ||
+        bits > MAX_WINDOW_BITS) {
+        return std::nullopt;
+    }
+    return bits;
+}
+
+// One extension element of the response, against what was offered
+std::optional<PerMessageDeflateParameters> ParseElement(std::string_view element,
+                                                        const PerMessageDeflateConfig& config) {
+    const auto parts = Split(element, ';');
+    if (parts.empty() || parts[0] != EXTENSION_NAME) {
+        return std::nullopt;
+    }
+
+    PerMessageDeflateParameters parameters;
+    std::vector<std::string_view> seen;
+    for (size_t i = 1; i < parts.size(); ++i) {
+        const std::string_view part = parts[i];
+        const size_t equals = part.find('=');
+        std::string_view name = part.substr(0, equals);
+        while (!name.empty() && name.back() == ' ') {
+            name.remove_suffix(1);
+        }
+        std::string_view value;
+        if (equals != std::string_view::npos) {
+            value = part.substr(equals + 1);
+            while (!value.empty() && value.front() == ' ') {
+                value.remove_prefix(1);
+            }
+        }
+        if (std::find(seen.begin(), seen.end(), name) != seen.end()) {
+            return std::nullopt; // Each parameter at most once
+        }
+        seen.push_back(name);
+
+        if (name == "server_no_context_takeover" && value.empty()) {
+            parameters.server_no_context_takeover = true;
+        } else if (name == "client_no_context_takeover" && value.empty()) {
+            parameters.client_no_context_takeover = true;
+        } else if (name == "server_max_window_bits") {
+            const auto bits = ParseWindowBits(value);
+            if (!bits || *bits > config.server_max_window_bits) {
+                return std::nullopt;
+            }
+            parameters.server_max_window_bits = *bits;
+        } else if (name == "client_max_window_bits") {
+            // Below MIN_WINDOW_BITS zlib cannot keep to the limit
+            const auto bits = ParseWindowBits(value);
+            if (!bits || *bits < MIN_WINDOW_BITS) {
+                return std::nullopt;
+            }
+            parameters.client_max_window_bits = *bits;
+        } else if (name == DICTIONARY_PARAMETER && value.empty() && config.room_dictionary) {
+            parameters.room_dictionary = true;
+        } else {
+            return std::nullopt;
+        }
+    }
+    if (!config.context_takeover && !parameters.server_no_context_takeover) {
+        return std::nullopt; // Asked for, and a server must honour it
+    }
+    if (!config.context_takeover) {
+        parameters.client_no_context_takeover = true;
+    }
+    return parameters;
+}
+
+} // namespace
+
+struct PerMessageDeflate::Streams {
+    z_stream deflate{};
+    z_stream inflate{};
+    bool deflate_ready = false;
+    bool inflate_ready = false;
+};
+
+std::string_view GetRoomMessageDictionary() {
+    return ROOM_MESSAGE_DICTIONARY;
+}
+
+std::string MakePerMessageDeflateOffer(const PerMessageDeflateConfig& config) {
+    if (!config.enabled) {
+        return {};
+    }
+    std::string plain(EXTENSION_NAME);
+    plain += "; client_max_window_bits";
+    if (config.server_max_window_bits < MAX_WINDOW_BITS) {
+        plain += "; server_max_window_bits=" + std::to_string(config.server_max_window_bits);
+    }
+    if (!config.context_takeover) {
+        plain += "; server_no_context_takeover; client_no_context_takeover";
+    }
+    if (!config.room_dictionary) {
+        return plain;
+    }
+    // Preferred first
+    return plain + "; " + std::string(DICTIONARY_PARAMETER) + ", " + plain;
+}
+
+std::optional<PerMessageDeflateParameters> ParsePerMessageDeflateResponse(
+    std::string_view header, const PerMessageDeflateConfig& config) {
+    if (!config.enabled) {
+        return std::nullopt;
+    }
+    // The server accepts exactly one of the offers
+    for (const auto element : Split(header, ',')) {
+        if (element.substr(0, EXTENSION_NAME.size()) == EXTENSION_NAME) {
+            return ParseElement(element, config);
+        }
+    }
+    return std::nullopt;
+}
+
+PerMessageDeflate::PerMessageDeflate(const PerMessageDeflateParameters& parameters,
+                                     const PerMessageDeflateConfig& config)
+    : parameters_(parameters), config_(config), streams_(std::make_unique<Streams>()) {
+    const auto dictionary = reinterpret_cast<const Bytef*>(ROOM_MESSAGE_DICTIONARY.data());
+    const auto dictionary_size = static_cast<uInt>(ROOM_MESSAGE_DICTIONARY.size());
+
+    // Negative window bits select raw deflate, as the extension carries it
+    const int deflate_bits = std::max(MIN_WINDOW_BITS, parameters_.client_max_window_bits);
+    streams_->deflate_ready =
+        deflateInit2(&streams_->deflate, config_.compression_level, Z_DEFLATED, -deflate_bits,
+                     8, Z_DEFAULT_STRATEGY) == Z_OK;
+    if (streams_->deflate_ready && parameters_.room_dictionary) {
+        deflateSetDictionary(&streams_->deflate, dictionary, dictionary_size);
+    }
+
+    const int inflate_bits = std::max(MIN_WINDOW_BITS, parameters_.server_max_window_bits);
+    streams_->inflate_ready = inflateInit2(&streams_->inflate, -inflate_bits) == Z_OK;
+    if (streams_->inflate_ready && parameters_.room_dictionary) {
+        inflateSetDictionary(&streams_->inflate, dictionary, dictionary_size);
+    }
+}
+
+PerMessageDeflate::~PerMessageDeflate() {
+    if (streams_->deflate_ready) {
+        deflateEnd(&streams_->deflate);
+    }
+    if (streams_->inflate_ready) {
+        inflateEnd(&streams_->inflate);
+    }
+}
+
+std::optional<std::span<const uint8_t>> PerMessageDeflate::Compress(std::string_view message) {
+    if (!streams_->deflate_ready || message.size() < config_.min_compress_size) {
+        return std::nullopt;
+    }
+
+    z_stream& stream = streams_->deflate;
+    // deflateBound assumes Z_FINISH; a sync flush adds the empty block
+    compressed_.resize(deflateBound(&stream, static_cast<uLong>(message.size())) + 16);
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(message.data()));
+    stream.avail_in = static_cast<uInt>(message.size());
+    size_t size = 0;
+    int result = Z_OK;
+    do {
+        if (size == compressed_.size()) {
+            compressed_.resize(compressed_.size() * 2);
+        }
+        stream.next_out = compressed_.data() + size;
+        stream.avail_out = static_cast<uInt>(compressed_.size() - size);
+        result = deflate(&stream, Z_SYNC_FLUSH);
+        size = compressed_.size() - stream.avail_out;
+    } while (result == Z_OK && stream.avail_out == 0);
+
+    if (parameters_.client_no_context_takeover) {
+        deflateReset(&stream);
+        if (parameters_.room_dictionary) {
+            deflateSetDictionary(&stream,
+                                 reinterpret_cast<const Bytef*>(ROOM_MESSAGE_DICTIONARY.data()),
+                                 static_cast<uInt>(ROOM_MESSAGE_DICTIONARY.size()));
+        }
+    }
+    // Once deflated the message is in our window, so it has to go out
+    // compressed even where that did not help
+    if (result != Z_OK || size < TAIL.size() ||
+        !std::equal(TAIL.begin(), TAIL.end(), compressed_.begin() + (size - TAIL.size()))) {
+        return std::nullopt;
+    }
+    return std::span<const uint8_t>(compressed_.data(), size - TAIL.size());
+}
+
+std::optional<std::string_view> PerMessageDeflate::Decompress(std::span<const uint8_t> payload) {
+    if (!streams_->inflate_ready) {
+        return std::nullopt;
+    }
+
+    z_stream& stream = streams_->inflate;
+    inflated_.clear();
+    std::array<uint8_t, 16 * 1024> chunk;
+    // The payload, then the tail the sender stripped
+    const std::array<std::span<const uint8_t>, 2> inputs{payload, std::span(TAIL)};
+    for (const auto input : inputs) {
+        stream.next_in = const_cast<Bytef*>(input.data());
+        stream.avail_in = static_cast<uInt>(input.size());
+        // A full chunk may leave output pending after the input is used up
+        do {
+            stream.next_out = chunk.data();
+            stream.avail_out = static_cast<uInt>(chunk.size());
+            const int result = inflate(&stream, Z_SYNC_FLUSH);
+            if (result != Z_OK && result != Z_BUF_ERROR) {
+                return std::nullopt;
+            }
+            const size_t produced = chunk.size() - stream.avail_out;
+            if (inflated_.size() + produced > config_.max_message_size) {
+                return std::nullopt;
+            }
+            inflated_.append(reinterpret_cast<const char*>(chunk.data()), produced);
+            if (produced == 0) {
+                break;
+            }
+        } while (stream.avail_in != 0 || stream.avail_out == 0);
+    }
+
+    if (parameters_.server_no_context_takeover) {
+        inflateReset(&stream);
+        if (parameters_.room_dictionary) {
+            inflateSetDictionary(&stream,
+                                 reinterpret_cast<const Bytef*>(ROOM_MESSAGE_DICTIONARY.data()),
+                                 static_cast<uInt>(ROOM_MESSAGE_DICTIONARY.size()));
+        }
+    }
+    return std::string_view(inflated_);
+}
+
+} // namespace Core::Multiplayer::ModelA
@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Core::Multiplayer::ModelA {
+
+/**
+ * What a client offers for permessage-deflate (RFC 7692)
+ */
+struct PerMessageDeflateConfig {
+    bool enabled = true;
+    // Keep the compression context between messages in both directions;
+    // repeated keys then cost a back-reference from the second message on
+    bool context_takeover = true;
+    // Window the server may use towards us, 9..15; smaller saves inflate memory
+    int server_max_window_bits = 15;
+    // Offer the room message dictionary first, plain deflate as the fallback
+    bool room_dictionary = true;
+    int compression_level = 6;
+    // Messages shorter than this go out uncompressed
+    size_t min_compress_size = 64;
+    // Larger inflated messages are refused, so a small frame cannot balloon
+    size_t max_message_size = 16 * 1024 * 1024;
+};
+
+/**
+ * Parameters both ends agreed on in the handshake
+ */
+struct PerMessageDeflateParameters {
+    bool server_no_context_takeover = false;
+    bool client_no_context_takeover = false;
+    int server_max_window_bits = 15;
+    int client_max_window_bits = 15;
+    // Both deflate streams start from ROOM_MESSAGE_DICTIONARY
+    bool room_dictionary = false;
+};
+
+/**
+ * Preset deflate dictionary of the keys, message types and values room
+ * server JSON repeats. Negotiated with the x-sudachi-room-dictionary
+ * extension parameter, so servers that do not know it fall back to the
+ * plain offer.
+ */
+std::string_view GetRoomMessageDictionary();
+
+// Sec-WebSocket-Extensions value for the client handshake
+std::string MakePerMessageDeflateOffer(const PerMessageDeflateConfig& config);
+
+/**
+ * Reads the server's Sec-WebSocket-Extensions answer
+ * @return Nothing if the server declined the extension or answered with
+ *         parameters that were not offered, in which case RFC 7692 has the
+ *         client fail the connection if the header named it at all
+ */
+std::optional<PerMessageDeflateParameters> ParsePerMessageDeflateResponse(
+    std::string_view header, const PerMessageDeflateConfig& config);
+
+/**
+ * Client-side permessage-deflate codec for one connection.
+ *
+ * Compress and Decompress return views of buffers the codec reuses, valid
+ * until its next call in the same direction, so steady traffic does not
+ * allocate. Not thread-safe; one sender and one receiver may use the two
+ * directions concurrently.
+ */
+class PerMessageDeflate {
+public:
+    PerMessageDeflate(const PerMessageDeflateParameters& parameters,
+                      const PerMessageDeflateConfig& config = {});
+    ~PerMessageDeflate();
+
+    PerMessageDeflate(const PerMessageDeflate&) = delete;
+    PerMessageDeflate& operator=(const PerMessageDeflate&) = delete;
+
+    /**
+     * Compresses one outgoing message; send it with RSV1 set
+     * @return Nothing if the message should go out as is
+     */
+    std::optional<std::span<const uint8_t>> Compress(std::string_view message);
+
+    /**
+     * Inflates the payload of a message that arrived with RSV1 set
+     * @return Nothing if it is corrupt or larger than max_message_size; the
+     *         connection should then be failed, as the context is lost
+     */
+    std::optional<std::string_view> Decompress(std::span<const uint8_t> payload);
+
+    const PerMessageDeflateParameters& GetParameters() const {
+        return parameters_;
+    }
+
+private:
+    struct Streams;
+
+    const PerMessageDeflateParameters parameters_;
+    const PerMessageDeflateConfig config_;
+    std::unique_ptr<Streams> streams_;
+    std::vector<uint8_t> compressed_;
+    std::string inflated_;
+};
+
+} // namespace Core::Multiplayer::ModelA
@@ -0,0 +1,499 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "port_prediction.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <thread>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#endif
+
+namespace Core::Multiplayer::ModelA {
+
+namespace {
+
+constexpr uint32_t STUN_MAGIC_COOKIE = 0x2112A442;
+constexpr uint16_t STUN_BINDING_REQUEST = 0x0001;
+constexpr uint16_t STUN_BINDING_SUCCESS = 0x0101;
+constexpr uint16_t STUN_ATTR_MAPPED_ADDRESS = 0x0001;
+constexpr uint16_t STUN_ATTR_XOR_MAPPED_ADDRESS = 0x0020;
+constexpr size_t STUN_HEADER_SIZE = 20;
+
+constexpr const char* OFFER_TYPE = "port-prediction";
+
+// Punch packets: magic, kind, then the token shared through the room server
+constexpr std::array<uint8_t, 4> PUNCH_MAGIC = {'S', 'P', 'P', 'H'};
+constexpr uint8_t PUNCH_KIND_PROBE = 0;
+constexpr uint8_t PUNCH_KIND_ACK = 1;
+constexpr size_t PUNCH_PACKET_SIZE = PUNCH_MAGIC.size() + 1 + sizeof(uint64_t);
+// A lost ack costs the peer its whole punch window, so it is repeated
+constexpr int PUNCH_ACK_COPIES = 3;
+
+// Lowest port predictions go to; below are ports no NAT allocates from
+constexpr int MIN_PREDICTED_PORT = 1024;
+
+uint16_t ReadU16(const uint8_t* data) {
+    return static_cast<uint16_t>((data[0] << 8) | data[1]);
+}
+
+uint32_t ReadU32(const uint8_t* data) {
+    return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16) |
+           (static_cast<uint32_t>(data[2]) << 8) | data[3];
+}
+
+void WriteU16(uint8_t* data, uint16_t value) {
+    data[0] = static_cast<uint8_t>(value >> 8);
+    data[1] = static_cast<uint8_t>(value);
+}
+
+void WriteU32(uint8_t* data, uint32_t value) {
+    WriteU16(data, static_cast<uint16_t>(value >> 16));
+    WriteU16(data + 2, static_cast<uint16_t>(value));
+}
+
+/**
+ * Address value of a (XOR-)MAPPED-ADDRESS attribute; the XOR pad is the
+ * magic cookie followed by the transaction id
+ */
+std::optional<MappedAddress> ReadAddressAttribute(const uint8_t* value, size_t length, bool xored,
+                                                  const StunTransactionId& transaction_id) {
+    if (length < 4) {
+        return std::nullopt;
+    }
+    std::array<uint8_t, 16> pad{};
+    WriteU32(pad.data(), STUN_MAGIC_COOKIE);
+    std::memcpy(pad.data() + 4, transaction_id.data(), transaction_id.size());
+
+    const uint8_t family = value[1];
+    const size_t address_size = family == 0x01 ? 4 : family == 0x02 ? 16 : 0;
+    if (address_size == 0 || length < 4 + address_size) {
+        return std::nullopt;
+    }
+    uint16_t port = ReadU16(value + 2);
+    std::array<uint8_t, 16> address{};
+    std::memcpy(address.data(), value + 4, address_size);
+    if (xored) {
+        port ^= static_cast<uint16_t>(STUN_MAGIC_COOKIE >> 16);
+        for (size_t i = 0; i < address_size; ++i) {
+            address[i] ^= pad[i];
+        }
+    }
+
+    char text[INET6_ADDRSTRLEN] = {};
+    if (!inet_ntop(family == 0x01 ? AF_INET : AF_INET6, address.data(), text, sizeof(text))) {
+        return std::nullopt;
+    }
+    return MappedAddress{text, port};
+}
+
+std::array<uint8_t, PUNCH_PACKET_SIZE> EncodePunch(uint8_t kind, uint64_t token) {
+    std::array<uint8_t, PUNCH_PACKET_SIZE> packet{};
+    std::copy(PUNCH_MAGIC.begin(), PUNCH_MAGIC.end(), packet.begin());
+    packet[PUNCH_MAGIC.size()] = kind;
+    WriteU32(packet.data() + PUNCH_MAGIC.size() + 1, static_cast<uint32_t>(token >> 32));
+    WriteU32(packet.data() + PUNCH_MAGIC.size() + 5, static_cast<uint32_t>(token));
+    return packet;
+}
+
+// Kind of a punch packet carrying token, if that is what the datagram is
+std::optional<uint8_t> DecodePunch(const uint8_t* data, size_t size, uint64_t token) {
+    if (size != PUNCH_PACKET_SIZE ||
+        !std::equal(PUNCH_MAGIC.begin(), PUNCH_MAGIC.end(), data)) {
+        return std::nullopt;
+    }
+    const uint64_t received = (static_cast<uint64_t>(ReadU32(data + PUNCH_MAGIC.size() + 1)) << 32) |
+                              ReadU32(data + PUNCH_MAGIC.size() + 5);
+    if (received != token) {
+        return std::nullopt;
+    }
+    return data[PUNCH_MAGIC.size()];
+}
+
+int64_t ToUnixMilliseconds(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
+}
+
+} // namespace
+
+std::array<uint8_t, 20> EncodeStunBindingRequest(const StunTransactionId& transaction_id) {
+    std::array<uint8_t, STUN_HEADER_SIZE> request{};
+    WriteU16(request.data(), STUN_BINDING_REQUEST);
+    WriteU16(request.data() + 2, 0);
+    WriteU32(request.data() + 4, STUN_MAGIC_COOKIE);
+    std::memcpy(request.data() + 8, transaction_id.data(), transaction_id.size());
+    return request;
+}
+
+std::optional<MappedAddress> ParseStunBindingResponse(const uint8_t* data, size_t size,
+                                                      const StunTransactionId& transaction_id) {
+    if (size < STUN_HEADER_SIZE || ReadU16(data) != STUN_BINDING_SUCCESS ||
+        ReadU32(data + 4) != STUN_MAGIC_COOKIE ||
+        std::memcmp(data + 8, transaction_id.data(), transaction_id.size()) != 0) {
+        return std::nullopt;
+    }
+    const size_t body_size = ReadU16(data + 2);
+    if (STUN_HEADER_SIZE + body_size > size) {
+        return std::nullopt;
+    }
+
+    std::optional<MappedAddress> mapped;
+    size_t offset = STUN_HEADER_SIZE;
+    const size_t end = STUN_HEADER_SIZE + body_size;
+    while (offset + 4 <= end) {
+        const uint16_t type = ReadU16(data + offset);
+        const size_t length = ReadU16(data + offset + 2);
+        const uint8_t* value = data + offset + 4;
+        if (offset + 4 + length > end) {
+            return std::nullopt;
+        }
+        if (type == STUN_ATTR_XOR_MAPPED_ADDRESS) {
+            if (auto address = ReadAddressAttribute(value, length, true, transaction_id)) {
+                return address;
+            }
+        } else if (type == STUN_ATTR_MAPPED_ADDRESS && !mapped) {
+            mapped = ReadAddressAttribute(value, length, false, transaction_id);
+        }
+        // Attribute values are padded to four bytes
+        offset += 4 + ((length + 3) & ~size_t{3});
+    }
+    return mapped;
+}
+
+PortAllocationProfile AnalyzePortAllocation(std::span<const MappedAddress> mappings,
+                                            const PortPredictionConfig& config) {
+    PortAllocationProfile profile;
+    if (mappings.empty()) {
+        return profile;
+    }
+    profile.last_mapping = mappings.back();
+    if (mappings.size() < 2) {
+        return profile;
+    }
+
+    // A NAT that changes address per destination leaves nothing to predict
+    const bool same_address = std::all_of(mappings.begin(), mappings.end(),
+                                          [&](const MappedAddress& mapping) {
+                                              return mapping.ip == mappings.front().ip;
+                                          });
+    if (!same_address) {
+        profile.allocation = PortAllocation::Random;
+        return profile;
+    }
+
+    std::vector<int32_t> steps;
+    for (size_t i = 1; i < mappings.size(); ++i) {
+        steps.push_back(static_cast<int32_t>(mappings[i].port) - mappings[i - 1].port);
+    }
+    if (std::all_of(steps.begin(), steps.end(), [](int32_t step) { return step == 0; })) {
+        profile.allocation = PortAllocation::Stable;
+        profile.exact = true;
+        return profile;
+    }
+
+    // Every step has to go the same way and stay small; a wrap at the end
+    // of the port range or one large jump reads as random
+    const bool upwards = steps.front() > 0;
+    const bool regular = std::all_of(steps.begin(), steps.end(), [&](int32_t step) {
+        return step != 0 && (step > 0) == upwards && std::abs(step) <= config.max_delta;
+    });
+    if (!regular) {
+        profile.allocation = PortAllocation::Random;
+        return profile;
+    }
+    profile.allocation = PortAllocation::Sequential;
+    profile.delta = *std::min_element(steps.begin(), steps.end(), [](int32_t a, int32_t b) {
+        return std::abs(a) < std::abs(b);
+    });
+    profile.exact = std::all_of(steps.begin(), steps.end(),
+                                [&](int32_t step) { return step == profile.delta; });
+    return profile;
+}
+
+std::vector<uint16_t> PredictPorts(const PortAllocationProfile& profile, size_t window) {
+    std::vector<uint16_t> ports;
+    switch (profile.allocation) {
+    case PortAllocation::Stable:
+        ports.push_back(profile.last_mapping.port);
+        break;
+    case PortAllocation::Sequential: {
+        // Other hosts behind the NAT take ports in between, so an irregular
+        // sequence is covered port by port past the smallest step
+        const int32_t step = profile.exact ? profile.delta : (profile.delta > 0 ? 1 : -1);
+        int32_t port = profile.last_mapping.port + profile.delta;
+        for (size_t i = 0; i < window; ++i, port += step) {
+            if (port < MIN_PREDICTED_PORT || port > 0xFFFF) {
+                break;
+            }
+            ports.push_back(static_cast<uint16_t>(port));
+        }
+        break;
+    }
+    case PortAllocation::Unknown:
+    case PortAllocation::Random:
+        break;
+    }
+    return ports;
+}
+
+bool ShouldTryPortPrediction(PortAllocation allocation, uint32_t attempts, uint32_t successes,
+                             const PortPredictionConfig& config) {
+    if (allocation == PortAllocation::Random) {
+        return false;
+    }
+    if (attempts < config.min_attempts) {
+        return true;
+    }
+    return static_cast<double>(successes) >= config.min_success_rate * attempts;
+}
+
+P2PInfoMessage EncodePortPredictionOffer(const PortPredictionOffer& offer,
+                                         const std::string& from_player,
+                                         const std::string& to_player) {
+    P2PInfoMessage message;
+    message.from_player = from_player;
+    message.to_player = to_player;
+    message.connection_type = OFFER_TYPE;
+    for (size_t i = 0; i < offer.ports.size(); ++i) {
+        // Nearest predictions first, so they get the highest priority
+        const uint32_t priority = static_cast<uint32_t>(offer.ports.size() - i);
+        message.ice_candidates.push_back(
+            {"candidate:" + std::to_string(i) + " 1 UDP " + std::to_string(priority) + ' ' +
+                 offer.address.ip + ' ' + std::to_string(offer.ports[i]) + " typ prflx",
+             "0", 0});
+    }
+    message.session_description.type = OFFER_TYPE;
+    message.session_description.sdp =
+        "punch_at=" + std::to_string(ToUnixMilliseconds(offer.punch_at)) +
+        " token=" + std::to_string(offer.token) +
+        " allocation=" + std::to_string(static_cast<int>(offer.allocation));
+    message.end_of_candidates = true;
+    return message;
+}
+
+std::optional<PortPredictionOffer> DecodePortPredictionOffer(const P2PInfoMessage& message) {
+    if (message.session_description.type != OFFER_TYPE) {
+        return std::nullopt;
+    }
+
+    PortPredictionOffer offer;
+    std::istringstream fields(message.session_description.sdp);
+    std::string field;
+    bool has_punch_at = false;
+    bool has_token = false;
+    while (fields >> field) {
+        const size_t separator = field.find('=');
+        if (separator == std::string::npos) {
+            continue;
+        }
+        const std::string key = field.substr(0, separator);
+        const std::string value = field.substr(separator + 1);
+        char* end = nullptr;
+        if (key == "punch_at") {
+            const long long milliseconds = std::strtoll(value.c_str(), &end, 10);
+            offer.punch_at = std::chrono::system_clock::time_point(
+                std::chrono::milliseconds(milliseconds));
+            has_punch_at = *end == '\0' && !value.empty();
+        } else if (key == "token") {
+            offer.token = std::strtoull(value.c_str(), &end, 10);
+            has_token = *end == '\0' && !value.empty();
+        } else if (key == "allocation") {
+            const long allocation = std::strtol(value.c_str(), &end, 10);
+            if (*end == '\0' && allocation >= 0 &&
+                allocation <= static_cast<long>(PortAllocation::Random)) {
+                offer.allocation = static_cast<PortAllocation>(allocation);
+            }
+        }
+    }
+    if (!has_punch_at || !has_token) {
+        return std::nullopt;
+    }
+
+    for (const auto& candidate : message.ice_candidates) {
+        std::istringstream candidate_fields(candidate.candidate);
+        std::string foundation, component, transport, priority, address;
+        uint32_t port = 0;
+        if (!(candidate_fields >> foundation >> component >> transport >> priority >> address >>
+              port) ||
+            port == 0 || port > 0xFFFF) {
+            continue;
+        }
+        if (offer.address.ip.empty()) {
+            offer.address.ip = address;
+        } else if (address != offer.address.ip) {
+            continue;
+        }
+        offer.ports.push_back(static_cast<uint16_t>(port));
+    }
+    if (offer.ports.empty()) {
+        return std::nullopt;
+    }
+    offer.address.port = offer.ports.front();
+    return offer;
+}
+
+PortPredictionPuncher::PortPredictionPuncher(PortPredictionConfig config) : config_(config) {}
+
+ErrorCode PortPredictionPuncher::Open(const std::string& bind_address, uint16_t port) {
+    return socket_.Open(bind_address, port);
+}
+
+PortAllocationProfile PortPredictionPuncher::Probe(const std::vector<DatagramEndpoint>& stun_servers) {
+    // In server order; the mappings have to be the NAT's consecutive ones
+    std::vector<MappedAddress> mappings;
+    for (const auto& server : stun_servers) {
+        if (auto mapping = ProbeServer(server)) {
+            mappings.push_back(std::move(*mapping));
+        }
+    }
+    profile_ = AnalyzePortAllocation(mappings, config_);
+    return profile_;
+}
+
+std::optional<MappedAddress> PortPredictionPuncher::ProbeServer(const DatagramEndpoint& server) {
+    if (!socket_.IsOpen()) {
+        return std::nullopt;
+    }
+    static thread_local std::mt19937_64 generator{std::random_device{}()};
+    StunTransactionId transaction_id;
+    for (auto& byte : transaction_id) {
+        byte = static_cast<uint8_t>(generator());
+    }
+    const auto request = EncodeStunBindingRequest(transaction_id);
+    OutgoingDatagram outgoing{request.data(), request.size()};
+    outgoing.to = &server;
+
+    const auto deadline = std::chrono::steady_clock::now() + config_.probe_timeout;
+    auto next_send = std::chrono::steady_clock::now();
+    std::array<uint8_t, 548> buffer;
+    while (true) {
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            return std::nullopt;
+        }
+        if (now >= next_send) {
+            socket_.SendBatch(&outgoing, 1);
+            next_send = now + config_.probe_retransmit_interval;
+        }
+        const auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::min(next_send, deadline) - now);
+        if (!socket_.WaitReadable(std::max(wait, std::chrono::milliseconds(1)))) {
+            continue;
+        }
+        DatagramReceiveSlot slot{};
+        slot.buffer = buffer.data();
+        slot.capacity = buffer.size();
+        while (socket_.ReceiveBatch(&slot, 1) == 1) {
+            if (slot.from != server || slot.truncated) {
+                continue;
+            }
+            if (auto mapping = ParseStunBindingResponse(buffer.data(), slot.size, transaction_id)) {
+                return mapping;
+            }
+        }
+    }
+}
+
+PortPredictionOffer PortPredictionPuncher::MakeOffer(std::chrono::system_clock::time_point punch_at,
+                                                     uint64_t token) const {
+    PortPredictionOffer offer;
+    offer.address = profile_.last_mapping;
+    offer.ports = PredictPorts(profile_, config_.window);
+    offer.allocation = profile_.allocation;
+    offer.punch_at = punch_at;
+    offer.token = token;
+    return offer;
+}
+
+PortPredictionOffer PortPredictionPuncher::MakeAnswer(const PortPredictionOffer& initiator) const {
+    return MakeOffer(initiator.punch_at, initiator.token);
+}
+
+std::optional<DatagramEndpoint> PortPredictionPuncher::Punch(const PortPredictionOffer& remote,
+                                                             uint64_t token) {
+    if (!socket_.IsOpen()) {
+        return std::nullopt;
+    }
+    std::vector<DatagramEndpoint> targets;
+    for (const uint16_t port : remote.ports) {
+        DatagramEndpoint endpoint;
+        if (DatagramEndpoint::FromString(remote.address.ip, port, endpoint)) {
+            targets.push_back(endpoint);
+        }
+    }
+    if (targets.empty()) {
+        return std::nullopt;
+    }
+
+    const auto punch = EncodePunch(PUNCH_KIND_PROBE, token);
+    std::vector<OutgoingDatagram> sprays(targets.size());
+    for (size_t i = 0; i < targets.size(); ++i) {
+        sprays[i] = {punch.data(), punch.size()};
+        sprays[i].to = &targets[i];
+    }
+
+    std::this_thread::sleep_until(remote.punch_at);
+    const auto deadline = std::chrono::steady_clock::now() + config_.punch_duration;
+    auto next_round = std::chrono::steady_clock::now();
+    std::array<uint8_t, 548> buffer;
+    while (true) {
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            return std::nullopt;
+        }
+        if (now >= next_round) {
+            // Each round sprays the same ports, so only the first opens mappings
+            for (size_t sent = 0; sent < sprays.size();) {
+                const size_t count =
+                    std::min(sprays.size() - sent, DatagramSocket::MAX_BATCH_SIZE);
+                sent += std::max<size_t>(socket_.SendBatch(sprays.data() + sent, count), 1);
+            }
+            next_round = now + config_.punch_interval;
+        }
+        const auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::min(next_round, deadline) - now);
+        if (!socket_.WaitReadable(std::max(wait, std::chrono::milliseconds(1)))) {
+            continue;
+        }
+        DatagramReceiveSlot slot{};
+        slot.buffer = buffer.data();
+        slot.capacity = buffer.size();
+        while (socket_.ReceiveBatch(&slot, 1) == 1) {
+            // Punches count from the peer's address on any port
+            DatagramEndpoint from_peer_address;
+            if (!DatagramEndpoint::FromString(remote.address.ip, slot.from.Port(),
+                                              from_peer_address) ||
+                from_peer_address != slot.from) {
+                continue;
+            }
+            const auto kind = DecodePunch(buffer.data(), slot.size, token);
+            if (!kind) {
+                continue;
+            }
+            if (*kind == PUNCH_KIND_PROBE) {
+                for (int i = 0; i < PUNCH_ACK_COPIES; ++i) {
+                    SendControl(PUNCH_KIND_ACK, token, slot.from);
+                }
+            }
+            socket_.Connect(slot.from);
+            return slot.from;
+        }
+    }
+}
+
+void PortPredictionPuncher::SendControl(uint8_t kind, uint64_t token, const DatagramEndpoint& to) {
+    const auto packet = EncodePunch(kind, token);
+    OutgoingDatagram outgoing{packet.data(), packet.size()};
+    outgoing.to = &to;
+    socket_.SendBatch(&outgoing, 1);
+}
+
+} // namespace Core::Multiplayer::ModelA
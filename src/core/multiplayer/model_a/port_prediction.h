@@ -0,0 +1,191 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "core/multiplayer/common/datagram_socket.h"
+#include "core/multiplayer/common/error_codes.h"
+#include "room_messages.h"
+
+namespace Core::Multiplayer::ModelA {
+
+/**
+ * External address a NAT gave one local socket towards one server
+ */
+struct MappedAddress {
+    std::string ip;
+    uint16_t port = 0;
+
+    bool operator==(const MappedAddress& other) const = default;
+};
+
+using StunTransactionId = std::array<uint8_t, 12>;
+
+// RFC 5389 Binding request with no attributes
+std::array<uint8_t, 20> EncodeStunBindingRequest(const StunTransactionId& transaction_id);
+
+/**
+ * Reads the mapped address out of a Binding success response, preferring
+ * XOR-MAPPED-ADDRESS over MAPPED-ADDRESS
+ * @return Nothing for another message type or transaction, or a malformed response
+ */
+std::optional<MappedAddress> ParseStunBindingResponse(const uint8_t* data, size_t size,
+                                                      const StunTransactionId& transaction_id);
+
+/**
+ * How a NAT picks the external port of each new mapping
+ */
+enum class PortAllocation : uint8_t {
+    Unknown, // Not probed, or too few probes answered
+    Stable,  // One external port whatever the destination; plain punching works
+    Sequential, // A new port per destination, a small step from the last
+    Random,     // A new port per destination with no usable pattern, or a new address
+};
+
+struct PortAllocationProfile {
+    PortAllocation allocation = PortAllocation::Unknown;
+    // Step between consecutive mappings; for an irregular sequence the smallest one
+    int32_t delta = 0;
+    // Whether every observed step was exactly delta
+    bool exact = false;
+    // Most recent mapping observed
+    MappedAddress last_mapping;
+};
+
+struct PortPredictionConfig {
+    // Predicted ports offered, and sprayed by the peer
+    size_t window = 16;
+    // Steps larger than this count as random allocation
+    uint16_t max_delta = 64;
+    // Each STUN probe is retransmitted until answered or this runs out
+    std::chrono::milliseconds probe_timeout{500};
+    std::chrono::milliseconds probe_retransmit_interval{100};
+    // From making an offer to both sides spraying; covers the room server round trip
+    std::chrono::milliseconds lead_time{750};
+    // Spraying goes on this long, which also absorbs clock skew between peers
+    std::chrono::milliseconds punch_duration{2000};
+    std::chrono::milliseconds punch_interval{20};
+    // After this many attempts from a network, it needs min_success_rate to keep trying
+    uint32_t min_attempts = 4;
+    double min_success_rate = 0.15;
+};
+
+/**
+ * Classifies a NAT from the mappings one local socket got towards two or
+ * more servers, in the order they were probed
+ */
+PortAllocationProfile AnalyzePortAllocation(std::span<const MappedAddress> mappings,
+                                            const PortPredictionConfig& config = {});
+
+/**
+ * External ports the next mappings will likely get, nearest first. A stable
+ * NAT gives its one port; an exact sequence steps by delta, and an
+ * irregular one covers every port from the first predicted one on.
+ * @return Empty for unknown or random allocation
+ */
+std::vector<uint16_t> PredictPorts(const PortAllocationProfile& profile, size_t window);
+
+/**
+ * Whether port prediction is worth trying from a network before relaying,
+ * given its allocation and how earlier attempts from it went
+ */
+bool ShouldTryPortPrediction(PortAllocation allocation, uint32_t attempts, uint32_t successes,
+                             const PortPredictionConfig& config = {});
+
+/**
+ * One side's half of a punch, exchanged through the room server. The
+ * initiator picks punch_at and the token; the answer copies both so the
+ * two sides spray at the same moment and recognise each other's packets.
+ */
+struct PortPredictionOffer {
+    MappedAddress address; // External address the ports belong to
+    std::vector<uint16_t> ports;
+    PortAllocation allocation = PortAllocation::Unknown;
+    std::chrono::system_clock::time_point punch_at;
+    uint64_t token = 0;
+};
+
+/**
+ * Carries an offer in a P2PInfo message: each port as a peer-reflexive
+ * candidate, and the timing in a session description of type
+ * "port-prediction"
+ */
+P2PInfoMessage EncodePortPredictionOffer(const PortPredictionOffer& offer,
+                                         const std::string& from_player,
+                                         const std::string& to_player);
+std::optional<PortPredictionOffer> DecodePortPredictionOffer(const P2PInfoMessage& message);
+
+/**
+ * Hole punching towards a peer behind a NAT that allocates a new port per
+ * destination.
+ *
+ * The local NAT is probed with STUN Binding requests to two or more
+ * servers from one socket, which shows how far apart its consecutive
+ * mappings are. Both peers offer the ports their next mappings should get,
+ * and at the agreed time each sprays the other's predicted ports from the
+ * probed socket. Every spray opens another mapping, so a packet that lands
+ * on an open one gets through; the first side to receive answers, and the
+ * socket is then connected to the peer.
+ *
+ * Probe and Punch block the calling thread. Not thread-safe.
+ */
+class PortPredictionPuncher {
+public:
+    explicit PortPredictionPuncher(PortPredictionConfig config = {});
+
+    PortPredictionPuncher(const PortPredictionPuncher&) = delete;
+    PortPredictionPuncher& operator=(const PortPredictionPuncher&) = delete;
+
+    // Binds the socket everything is sent from; port 0 is ephemeral
+    ErrorCode Open(const std::string& bind_address = "0.0.0.0", uint16_t port = 0);
+
+    /**
+     * Probes each server in turn
+     * @return Unknown allocation when fewer than two answered
+     */
+    PortAllocationProfile Probe(const std::vector<DatagramEndpoint>& stun_servers);
+
+    /**
+     * Offer for the peer from the last probe. An initiator passes the time
+     * to punch at; an answer passes the initiator's offer to copy it from.
+     */
+    PortPredictionOffer MakeOffer(std::chrono::system_clock::time_point punch_at,
+                                  uint64_t token) const;
+    PortPredictionOffer MakeAnswer(const PortPredictionOffer& initiator) const;
+
+    /**
+     * Waits for the offer's punch time, then sprays its ports for
+     * punch_duration
+     * @return The peer's endpoint once a packet from it got through; the
+     *         socket is then connected to it
+     */
+    std::optional<DatagramEndpoint> Punch(const PortPredictionOffer& remote, uint64_t token);
+
+    const PortAllocationProfile& GetProfile() const {
+        return profile_;
+    }
+
+    // The punched socket, for the caller's data path
+    DatagramSocket& GetSocket() {
+        return socket_;
+    }
+
+private:
+    std::optional<MappedAddress> ProbeServer(const DatagramEndpoint& server);
+    void SendControl(uint8_t kind, uint64_t token, const DatagramEndpoint& to);
+
+    PortPredictionConfig config_;
+    DatagramSocket socket_;
+    PortAllocationProfile profile_;
+};
+
+} // namespace Core::Multiplayer::ModelA
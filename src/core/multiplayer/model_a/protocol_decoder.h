@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include "core/multiplayer/common/packet_protocol.h"
+
+namespace Core::Multiplayer::ModelA {
+
+/**
+ * Decodes a protocol message of type T from the bytes it arrived in.
+ * Specialize it with
+ *     static std::optional<T> Decode(std::span<const uint8_t> data);
+ * to register typed handlers for T. A decoded message may point into data,
+ * so it is only valid for the duration of the handler call.
+ */
+template <typename T>
+struct ProtocolDecoder;
+
+template <typename T>
+concept DecodableMessage = requires(std::span<const uint8_t> data) {
+    { ProtocolDecoder<T>::Decode(data) } -> std::same_as<std::optional<T>>;
+};
+
+// The raw message
+template <>
+struct ProtocolDecoder<std::span<const uint8_t>> {
+    static std::optional<std::span<const uint8_t>> Decode(std::span<const uint8_t> data) {
+        return data;
+    }
+};
+
+// An LDN packet, checked and parsed in place; the payload is a view of data
+template <>
+struct ProtocolDecoder<LdnPacketView> {
+    static std::optional<LdnPacketView> Decode(std::span<const uint8_t> data) {
+        LdnPacketView packet;
+        if (!DeserializePacket(data, packet)) {
+            return std::nullopt;
+        }
+        return packet;
+    }
+};
+
+} // namespace Core::Multiplayer::ModelA
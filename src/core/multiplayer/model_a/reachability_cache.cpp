@@ -0,0 +1,151 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "reachability_cache.h"
+
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <utility>
+
+#include <nlohmann/json.hpp>
+
+namespace Core::Multiplayer::ModelA {
+
+namespace {
+using json = nlohmann::json;
+
+constexpr int CACHE_FORMAT_VERSION = 1;
+
+int64_t ToUnixSeconds(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+}
+} // namespace
+
+std::string NetworkFingerprint::ToKey() const {
+    // Fields are separated by a character none of them contains
+    return gateway_mac + '\n' + ssid + '\n' + public_ip;
+}
+
+ReachabilityCache::ReachabilityCache(std::string path, std::chrono::seconds ttl)
+    : path_(std::move(path)), ttl_(ttl) {}
+
+bool ReachabilityCache::Load() {
+    std::ifstream file(path_);
+    if (!file) {
+        return true;
+    }
+
+    std::unordered_map<std::string, ReachabilityRecord> records;
+    try {
+        const json document = json::parse(file);
+        if (document.value("version", 0) != CACHE_FORMAT_VERSION) {
+            return false;
+        }
+        for (const auto& entry : document.at("networks")) {
+            ReachabilityRecord record;
+            record.nat_type = entry.at("nat_type").get<int>();
+            record.can_traverse = entry.value("can_traverse", false);
+            record.external_address = entry.value("external_address", "");
+            record.observed_at = std::chrono::system_clock::time_point(
+                std::chrono::seconds(entry.at("observed_at").get<int64_t>()));
+            for (const auto& relay : entry.value("relays", json::array())) {
+                RelayServerProbeResult result;
+                result.server = relay.at("server").get<std::string>();
+                if (relay.contains("rtt_us")) {
+                    result.rtt = std::chrono::microseconds(relay["rtt_us"].get<int64_t>());
+                }
+                record.relay_rtts.push_back(std::move(result));
+            }
+            if (entry.contains("port_prediction")) {
+                const auto& prediction = entry["port_prediction"];
+                record.port_allocation = prediction.value("allocation", 0);
+                record.port_delta = prediction.value("delta", 0);
+                record.port_prediction_attempts = prediction.value("attempts", 0u);
+                record.port_prediction_successes = prediction.value("successes", 0u);
+            }
+            records[entry.at("key").get<std::string>()] = std::move(record);
+        }
+    } catch (const json::exception&) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    records_ = std::move(records);
+    return true;
+}
+
+std::optional<ReachabilityRecord> ReachabilityCache::Lookup(
+    const NetworkFingerprint& fingerprint, std::chrono::system_clock::time_point now) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = records_.find(fingerprint.ToKey());
+    if (it == records_.end() || now - it->second.observed_at > ttl_) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+bool ReachabilityCache::Store(const NetworkFingerprint& fingerprint,
+                              const ReachabilityRecord& record) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    records_[fingerprint.ToKey()] = record;
+
+    // Expired networks are dropped so the file does not grow without bound
+    for (auto it = records_.begin(); it != records_.end();) {
+        if (record.observed_at - it->second.observed_at > ttl_) {
+            it = records_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return SaveLocked();
+}
+
+size_t ReachabilityCache::GetRecordCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return records_.size();
+}
+
+bool ReachabilityCache::SaveLocked() const {
+    json networks = json::array();
+    for (const auto& [key, record] : records_) {
+        json relays = json::array();
+        for (const auto& relay : record.relay_rtts) {
+            json entry{{"server", relay.server}};
+            if (relay.rtt) {
+                entry["rtt_us"] = relay.rtt->count();
+            }
+            relays.push_back(std::move(entry));
+        }
+        networks.push_back({{"key", key},
+                            {"nat_type", record.nat_type},
+                            {"can_traverse", record.can_traverse},
+                            {"external_address", record.external_address},
+                            {"observed_at", ToUnixSeconds(record.observed_at)},
+                            {"relays", std::move(relays)},
+                            {"port_prediction",
+                             {{"allocation", record.port_allocation},
+                              {"delta", record.port_delta},
+                              {"attempts", record.port_prediction_attempts},
+                              {"successes", record.port_prediction_successes}}}});
+    }
+    const json document{{"version", CACHE_FORMAT_VERSION}, {"networks", std::move(networks)}};
+
+    // Written aside and renamed over, so a crash never leaves half a file
+    const std::string temp_path = path_ + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+        file << document.dump();
+        if (!file.flush()) {
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temp_path, path_, error);
+    return !error;
+}
+
+} // namespace Core::Multiplayer::ModelA
@@ -0,0 +1,94 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "relay_server_selector.h"
+
+namespace Core::Multiplayer::ModelA {
+
+/**
+ * Identifies the network the client is attached to. Whatever the platform
+ * can tell is filled in; two fingerprints match only when every field does.
+ */
+struct NetworkFingerprint {
+    std::string gateway_mac;
+    std::string ssid;
+    std::string public_ip;
+
+    bool IsEmpty() const { return gateway_mac.empty() && ssid.empty() && public_ip.empty(); }
+    std::string ToKey() const;
+};
+
+/**
+ * What was learned about reaching the outside world from one network
+ */
+struct ReachabilityRecord {
+    // The network's NATType enumerator, stored by value
+    int nat_type = 0;
+    bool can_traverse = false;
+    // External address mapping as observed from outside, if known
+    std::string external_address;
+    std::vector<RelayServerProbeResult> relay_rtts;
+    std::chrono::system_clock::time_point observed_at;
+    // The network's PortAllocation enumerator and mapping step, stored by value
+    int port_allocation = 0;
+    int32_t port_delta = 0;
+    // Port prediction punches tried from this network, and how many connected
+    uint32_t port_prediction_attempts = 0;
+    uint32_t port_prediction_successes = 0;
+};
+
+/**
+ * Reachability results persisted per network, so a session on a known
+ * network can start with its NAT type and relay ranking at once and
+ * revalidate them in the background instead of probing first.
+ *
+ * Records older than the TTL are not returned. The file is JSON, rewritten
+ * whole through a temporary file on every Store; a missing or unreadable
+ * file just starts an empty cache.
+ */
+class ReachabilityCache {
+public:
+    ReachabilityCache(std::string path, std::chrono::seconds ttl);
+
+    ReachabilityCache(const ReachabilityCache&) = delete;
+    ReachabilityCache& operator=(const ReachabilityCache&) = delete;
+
+    /**
+     * Reads the cache file, replacing what is held
+     * @return False if the file exists but could not be parsed
+     */
+    bool Load();
+
+    std::optional<ReachabilityRecord> Lookup(
+        const NetworkFingerprint& fingerprint,
+        std::chrono::system_clock::time_point now = std::chrono::system_clock::now()) const;
+
+    /**
+     * Replaces the record for a network and writes the file
+     * @return False if the file could not be written; the record is kept
+     */
+    bool Store(const NetworkFingerprint& fingerprint, const ReachabilityRecord& record);
+
+    size_t GetRecordCount() const;
+
+private:
+    bool SaveLocked() const;
+
+    const std::string path_;
+    const std::chrono::seconds ttl_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, ReachabilityRecord> records_;
+};
+
+} // namespace Core::Multiplayer::ModelA
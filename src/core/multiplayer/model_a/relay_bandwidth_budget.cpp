@@ -0,0 +1,164 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "relay_bandwidth_budget.h"
+
+#include <algorithm>
+#include <mutex>
+
+namespace Core::Multiplayer::ModelA {
+
+namespace {
+
+// Share of a parent's rate or burst, never rounded down to nothing
+template <typename T>
+T WeightedShare(T total, uint32_t weight, uint64_t total_weight) {
+    if (total_weight == 0) {
+        return total;
+    }
+    return std::max<T>(1, static_cast<T>(static_cast<uint64_t>(total) * weight / total_weight));
+}
+
+} // namespace
+
+RelayBandwidthBudget::RelayBandwidthBudget(uint64_t bytes_per_second, size_t burst_size)
+    : bytes_per_second_(bytes_per_second), burst_size_(burst_size),
+      global_bucket_(bytes_per_second, burst_size) {}
+
+void RelayBandwidthBudget::SetSessionWeight(uint32_t session_token, uint32_t weight) {
+    std::unique_lock lock(classes_mutex_);
+    AddSessionLocked(session_token).weight = std::max<uint32_t>(weight, 1);
+    RebalanceLocked();
+}
+
+void RelayBandwidthBudget::SetNodeWeight(uint32_t session_token, uint8_t node_id,
+                                         uint32_t weight) {
+    std::unique_lock lock(classes_mutex_);
+    auto& session = AddSessionLocked(session_token);
+    AddNodeLocked(session, node_id).weight = std::max<uint32_t>(weight, 1);
+    RebalanceNodesLocked(session);
+}
+
+void RelayBandwidthBudget::RemoveSession(uint32_t session_token) {
+    std::unique_lock lock(classes_mutex_);
+    if (sessions_.erase(session_token) != 0) {
+        RebalanceLocked();
+    }
+}
+
+template <typename Function>
+auto RelayBandwidthBudget::WithClasses(uint32_t session_token, uint8_t node_id,
+                                       Function&& function) {
+    {
+        std::shared_lock lock(classes_mutex_);
+        const auto session = sessions_.find(session_token);
+        if (session != sessions_.end()) {
+            const auto node = session->second.nodes.find(node_id);
+            if (node != session->second.nodes.end()) {
+                return function(session->second, node->second);
+            }
+        }
+    }
+
+    std::unique_lock lock(classes_mutex_);
+    auto& session = AddSessionLocked(session_token);
+    return function(session, AddNodeLocked(session, node_id));
+}
+
+bool RelayBandwidthBudget::TryConsumeBytes(uint32_t session_token, uint8_t node_id,
+                                           size_t byte_count) {
+    return WithClasses(session_token, node_id, [&](SessionClass& session, NodeClass& node) {
+        // Within the node's assured share
+        if (node.bucket->TryConsumeBytes(byte_count)) {
+            session.bucket->ConsumeBytes(byte_count);
+            global_bucket_.ConsumeBytes(byte_count);
+            return true;
+        }
+        // Borrowed from what the session's other nodes left unused
+        if (session.bucket->TryConsumeBytes(byte_count)) {
+            global_bucket_.ConsumeBytes(byte_count);
+            return true;
+        }
+        // Borrowed from what the other sessions left unused
+        return global_bucket_.TryConsumeBytes(byte_count);
+    });
+}
+
+void RelayBandwidthBudget::ConsumePriorityBytes(size_t byte_count) {
+    global_bucket_.ConsumeBytes(byte_count);
+}
+
+std::chrono::milliseconds RelayBandwidthBudget::GetNextAvailableTime(uint32_t session_token,
+                                                                     uint8_t node_id,
+                                                                     size_t byte_count) {
+    return WithClasses(session_token, node_id, [&](SessionClass& session, NodeClass& node) {
+        return std::min({node.bucket->GetNextAvailableTime(byte_count),
+                         session.bucket->GetNextAvailableTime(byte_count),
+                         global_bucket_.GetNextAvailableTime(byte_count)});
+    });
+}
+
+uint64_t RelayBandwidthBudget::GetSessionRate(uint32_t session_token) const {
+    std::shared_lock lock(classes_mutex_);
+    const auto it = sessions_.find(session_token);
+    return it != sessions_.end() ? it->second.bytes_per_second : 0;
+}
+
+uint64_t RelayBandwidthBudget::GetNodeRate(uint32_t session_token, uint8_t node_id) const {
+    std::shared_lock lock(classes_mutex_);
+    const auto session = sessions_.find(session_token);
+    if (session == sessions_.end()) {
+        return 0;
+    }
+    const auto node = session->second.nodes.find(node_id);
+    return node != session->second.nodes.end() ? node->second.bytes_per_second : 0;
+}
+
+RelayBandwidthBudget::SessionClass& RelayBandwidthBudget::AddSessionLocked(
+    uint32_t session_token) {
+    const auto [it, inserted] = sessions_.try_emplace(session_token);
+    if (inserted) {
+        RebalanceLocked();
+    }
+    return it->second;
+}
+
+RelayBandwidthBudget::NodeClass& RelayBandwidthBudget::AddNodeLocked(SessionClass& session,
+                                                                     uint8_t node_id) {
+    const auto [it, inserted] = session.nodes.try_emplace(node_id);
+    if (inserted) {
+        RebalanceNodesLocked(session);
+    }
+    return it->second;
+}
+
+void RelayBandwidthBudget::RebalanceLocked() {
+    uint64_t total_weight = 0;
+    for (const auto& [token, session] : sessions_) {
+        total_weight += session.weight;
+    }
+
+    for (auto& [token, session] : sessions_) {
+        session.bytes_per_second = WeightedShare(bytes_per_second_, session.weight, total_weight);
+        session.burst_size = WeightedShare(burst_size_, session.weight, total_weight);
+        session.bucket =
+            std::make_unique<BandwidthLimiter>(session.bytes_per_second, session.burst_size);
+        RebalanceNodesLocked(session);
+    }
+}
+
+void RelayBandwidthBudget::RebalanceNodesLocked(SessionClass& session) {
+    uint64_t total_weight = 0;
+    for (const auto& [id, node] : session.nodes) {
+        total_weight += node.weight;
+    }
+
+    for (auto& [id, node] : session.nodes) {
+        node.bytes_per_second =
+            WeightedShare(session.bytes_per_second, node.weight, total_weight);
+        node.bucket = std::make_unique<BandwidthLimiter>(
+            node.bytes_per_second, WeightedShare(session.burst_size, node.weight, total_weight));
+    }
+}
+
+} // namespace Core::Multiplayer::ModelA
@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "relay_client.h"
+
+namespace Core::Multiplayer::ModelA {
+
+/**
+ * Hierarchical bandwidth budget shared by the RelayClients of a relay gateway
+ *
+ * A global rate is split across sessions, and each session's share across
+ * its nodes, in proportion to their weights. Every class has its own token
+ * bucket for its assured share. A send is admitted from the node's bucket
+ * first, then by borrowing whatever its session has left over, then from
+ * the global spare, and every admitted send is charged to all levels above
+ * it. A noisy session can therefore use idle bandwidth but cannot eat into
+ * another session's assured share.
+ *
+ * Control and keepalive frames have strict priority: they are always
+ * admitted and only charged, so they are never delayed behind game data.
+ *
+ * Sessions and nodes are registered with weight 1 on first use.
+ */
+class RelayBandwidthBudget {
+public:
+    static constexpr uint32_t DEFAULT_WEIGHT = 1;
+
+    RelayBandwidthBudget(uint64_t bytes_per_second, size_t burst_size);
+
+    RelayBandwidthBudget(const RelayBandwidthBudget&) = delete;
+    RelayBandwidthBudget& operator=(const RelayBandwidthBudget&) = delete;
+
+    void SetSessionWeight(uint32_t session_token, uint32_t weight);
+    void SetNodeWeight(uint32_t session_token, uint8_t node_id, uint32_t weight);
+    void RemoveSession(uint32_t session_token);
+
+    /**
+     * Admits a data send for a node of a session
+     * @return False if neither the node, its session nor the global budget
+     *         has byte_count tokens to spare
+     */
+    bool TryConsumeBytes(uint32_t session_token, uint8_t node_id, size_t byte_count);
+
+    // Charges a strict priority frame without ever refusing it
+    void ConsumePriorityBytes(size_t byte_count);
+
+    std::chrono::milliseconds GetNextAvailableTime(uint32_t session_token, uint8_t node_id,
+                                                   size_t byte_count);
+
+    uint64_t GetBandwidthLimit() const { return bytes_per_second_; }
+
+    // Assured rates after weighting; zero for unknown classes
+    uint64_t GetSessionRate(uint32_t session_token) const;
+    uint64_t GetNodeRate(uint32_t session_token, uint8_t node_id) const;
+
+private:
+    struct NodeClass {
+        uint32_t weight = DEFAULT_WEIGHT;
+        uint64_t bytes_per_second = 0;
+        std::unique_ptr<BandwidthLimiter> bucket;
+    };
+
+    struct SessionClass {
+        uint32_t weight = DEFAULT_WEIGHT;
+        uint64_t bytes_per_second = 0;
+        size_t burst_size = 0;
+        std::unique_ptr<BandwidthLimiter> bucket;
+        std::unordered_map<uint8_t, NodeClass> nodes;
+    };
+
+    // Runs function on a node's classes, registering them on first use
+    template <typename Function>
+    auto WithClasses(uint32_t session_token, uint8_t node_id, Function&& function);
+
+    SessionClass& AddSessionLocked(uint32_t session_token);
+    NodeClass& AddNodeLocked(SessionClass& session, uint8_t node_id);
+    void RebalanceLocked();
+    void RebalanceNodesLocked(SessionClass& session);
+
+    const uint64_t bytes_per_second_;
+    const size_t burst_size_;
+    BandwidthLimiter global_bucket_;
+
+    // Shared for sends; exclusive when classes or weights change
+    mutable std::shared_mutex classes_mutex_;
+    std::unordered_map<uint32_t, SessionClass> sessions_;
+};
+
+} // namespace Core::Multiplayer::ModelA
@@ -2,8 +2,16 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "relay_client.h"
+#include "core/multiplayer/common/monotonic_clock.h"
+#include "core/multiplayer/common/packet_trace.h"
+#include "core/multiplayer/common/traffic_profile.h"
+#include "payload_compression.h"
+#include "relay_bandwidth_budget.h"
+#include "relay_server_selector.h"
 #include <algorithm>
+#include <array>
 #include <thread>
+#include <utility>
 
 // Only include mock headers when building tests
 #ifdef BUILDING_TESTS
@@ -13,58 +21,158 @@
 namespace Core::Multiplayer::ModelA {
 
 // BandwidthLimiter implementation
-BandwidthLimiter::BandwidthLimiter(uint64_t bytes_per_second, size_t burst_size)
-    : bytes_per_second_(bytes_per_second), burst_size_(burst_size), 
-      tokens_(static_cast<int64_t>(burst_size)), 
-      last_refill_(std::chrono::steady_clock::now()) {}
+namespace {
+constexpr int64_t NANOSECONDS_PER_SECOND = 1'000'000'000;
+constexpr int64_t NANOSECONDS_PER_MILLISECOND = 1'000'000;
+
+// Pacing reads MonotonicClock unless the wheel runs on simulated time
+std::shared_ptr<const ClockSource> PacingClock(const std::shared_ptr<TimerWheel>& timer_wheel) {
+    return timer_wheel && timer_wheel->IsManual() ? timer_wheel->GetClock() : nullptr;
+}
+
+// Keepalive clock; only ever compared with itself, so any epoch will do
+uint64_t NowMicroseconds() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+}
+
+// Jitter buffer key: members number their frames independently, so each
+// sender of a session is ordered on its own
+constexpr uint64_t StreamKey(uint32_t session_token, uint8_t sender) {
+    return (static_cast<uint64_t>(sender) << 32) | session_token;
+}
+
+constexpr uint32_t StreamSession(uint64_t key) {
+    return static_cast<uint32_t>(key);
+}
+
+constexpr size_t SenderTrailerSize(uint8_t sender) {
+    return sender != RelayProtocol::NO_NODE_ID ? RelayProtocol::SENDER_TRAILER_SIZE : 0;
+}
+} // namespace
+
+BandwidthLimiter::BandwidthLimiter(uint64_t bytes_per_second, size_t burst_size,
+                                   std::shared_ptr<const ClockSource> clock)
+    : clock_(std::move(clock)), bytes_per_second_(bytes_per_second), burst_size_(burst_size),
+      burst_ns_(CostNanoseconds(burst_size, bytes_per_second)), full_at_ns_(NowNanoseconds()) {}
 
 bool BandwidthLimiter::CanSendBytes(size_t byte_count) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    RefillTokens();
-    return tokens_.load() >= static_cast<int64_t>(byte_count);
+    const uint64_t rate = bytes_per_second_.load(std::memory_order_relaxed);
+    if (rate == 0) {
+        return true;
+    }
+    const int64_t now = NowNanoseconds();
+    const int64_t start = std::max(full_at_ns_.load(std::memory_order_acquire), now);
+    return start == now ||
+           start - now + CostNanoseconds(byte_count, rate) <=
+               burst_ns_.load(std::memory_order_relaxed);
 }
 
 void BandwidthLimiter::ConsumeBytes(size_t byte_count) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    RefillTokens();
-    tokens_ -= static_cast<int64_t>(byte_count);
+    const uint64_t rate = bytes_per_second_.load(std::memory_order_relaxed);
+    if (rate == 0) {
+        return;
+    }
+    const int64_t now = NowNanoseconds();
+    const int64_t cost = CostNanoseconds(byte_count, rate);
+    int64_t full_at = full_at_ns_.load(std::memory_order_relaxed);
+    while (!full_at_ns_.compare_exchange_weak(full_at, std::max(full_at, now) + cost,
+                                              std::memory_order_acq_rel,
+                                              std::memory_order_relaxed)) {
+    }
+}
+
+bool BandwidthLimiter::TryConsumeBytes(size_t byte_count) {
+    const uint64_t rate = bytes_per_second_.load(std::memory_order_relaxed);
+    if (rate == 0) {
+        return true;
+    }
+    const int64_t now = NowNanoseconds();
+    const int64_t cost = CostNanoseconds(byte_count, rate);
+    const int64_t burst_ns = burst_ns_.load(std::memory_order_relaxed);
+    int64_t full_at = full_at_ns_.load(std::memory_order_relaxed);
+    while (true) {
+        // Tokens refilled since the last send are implied by how far now has
+        // caught up with full_at
+        const int64_t start = std::max(full_at, now);
+        if (start != now && start - now + cost > burst_ns) {
+            return false;
+        }
+        if (full_at_ns_.compare_exchange_weak(full_at, start + cost, std::memory_order_acq_rel,
+                                              std::memory_order_relaxed)) {
+            return true;
+        }
+    }
 }
 
 std::chrono::milliseconds BandwidthLimiter::GetNextAvailableTime(size_t byte_count) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    RefillTokens();
-    
-    int64_t needed_tokens = static_cast<int64_t>(byte_count) - tokens_.load();
-    if (needed_tokens <= 0) {
+    const uint64_t rate = bytes_per_second_.load(std::memory_order_relaxed);
+    if (rate == 0) {
         return std::chrono::milliseconds(0);
     }
-    
-    // Calculate time needed to refill the required tokens
-    uint64_t ms_per_token = 1000 / (bytes_per_second_ / 1000); // milliseconds per token
-    return std::chrono::milliseconds(needed_tokens * ms_per_token);
+    const int64_t now = NowNanoseconds();
+    const int64_t start = std::max(full_at_ns_.load(std::memory_order_acquire), now);
+    const int64_t cost = CostNanoseconds(byte_count, rate);
+    const int64_t burst_ns = burst_ns_.load(std::memory_order_relaxed);
+
+    // Oversized packets wait for a full bucket, everything else for its cost
+    const int64_t wait = cost > burst_ns ? start - now : start - now + cost - burst_ns;
+    if (wait <= 0) {
+        return std::chrono::milliseconds(0);
+    }
+    return std::chrono::milliseconds((wait + NANOSECONDS_PER_MILLISECOND - 1) /
+                                     NANOSECONDS_PER_MILLISECOND);
+}
+
+size_t BandwidthLimiter::GetAvailableBytes() const {
+    const uint64_t rate = bytes_per_second_.load(std::memory_order_relaxed);
+    if (rate == 0) {
+        return burst_size_;
+    }
+    const int64_t now = NowNanoseconds();
+    const int64_t start = std::max(full_at_ns_.load(std::memory_order_acquire), now);
+    const int64_t available_ns = burst_ns_.load(std::memory_order_relaxed) - (start - now);
+    if (available_ns <= 0) {
+        return 0;
+    }
+    return static_cast<size_t>(static_cast<double>(available_ns) * static_cast<double>(rate) /
+                               NANOSECONDS_PER_SECOND);
 }
 
 void BandwidthLimiter::Reset() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    tokens_ = static_cast<int64_t>(burst_size_);
-    last_refill_ = std::chrono::steady_clock::now();
+    full_at_ns_.store(NowNanoseconds(), std::memory_order_release);
 }
 
-void BandwidthLimiter::RefillTokens() {
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_refill_);
-    
-    if (elapsed.count() > 0) {
-        int64_t new_tokens = (elapsed.count() * bytes_per_second_) / 1000;
-        tokens_ = std::min(static_cast<int64_t>(burst_size_), 
-                          tokens_.load() + new_tokens);
-        last_refill_ = now;
+void BandwidthLimiter::SetRate(uint64_t bytes_per_second) {
+    // Debt already taken stays measured in time, so a cut applies from the next send
+    burst_ns_.store(CostNanoseconds(burst_size_, bytes_per_second), std::memory_order_relaxed);
+    bytes_per_second_.store(bytes_per_second, std::memory_order_relaxed);
+}
+
+int64_t BandwidthLimiter::CostNanoseconds(size_t byte_count, uint64_t bytes_per_second) {
+    if (bytes_per_second == 0) {
+        return 0;
+    }
+    return static_cast<int64_t>(byte_count) * NANOSECONDS_PER_SECOND /
+           static_cast<int64_t>(bytes_per_second);
+}
+
+int64_t BandwidthLimiter::NowNanoseconds() const {
+    if (clock_) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   clock_->Now().time_since_epoch())
+            .count();
     }
+    return static_cast<int64_t>(MonotonicClock::Now());
 }
 
 // RelayClient implementation
-RelayClient::RelayClient() 
-    : bandwidth_limiter_(std::make_unique<BandwidthLimiter>(DEFAULT_BANDWIDTH_LIMIT, DEFAULT_BANDWIDTH_LIMIT / 10)) {
+RelayClient::RelayClient(std::shared_ptr<TimerWheel> timer_wheel)
+    : bandwidth_limiter_(std::make_unique<BandwidthLimiter>(DEFAULT_BANDWIDTH_LIMIT, DEFAULT_BANDWIDTH_LIMIT / 10,
+                                                            PacingClock(timer_wheel))),
+      timer_wheel_(timer_wheel ? std::move(timer_wheel) : TimerWheel::GetShared()) {
+    SetJitterBufferConfig(JitterBufferConfig{});
 }
 
 RelayClient::RelayClient(std::unique_ptr<Test::MockRelayConnection> connection,
@@ -72,19 +180,33 @@ RelayClient::RelayClient(std::unique_ptr<Test::MockRelayConnection> connection,
                         std::unique_ptr<Test::MockBandwidthLimiter> bandwidth_limiter,
                         std::unique_ptr<Test::MockRelayServerSelector> server_selector)
 #ifdef BUILDING_TESTS
-    : mock_connection_(std::move(connection)),
+    : timer_wheel_(TimerWheel::GetShared()),
+      reconnect_throttle_(ReconnectThrottle::GetShared()),
+      mock_connection_(std::move(connection)),
       mock_p2p_(std::move(p2p)),
       mock_bandwidth_limiter_(std::move(bandwidth_limiter)),
       mock_server_selector_(std::move(server_selector)) {
 #else
-    {
+    : timer_wheel_(TimerWheel::GetShared()),
+      reconnect_throttle_(ReconnectThrottle::GetShared()) {
 #endif
+    SetJitterBufferConfig(JitterBufferConfig{});
 }
 
 RelayClient::~RelayClient() {
+    DisableFailover();
+    DisableBandwidthAdaptation();
+    StopKeepalive();
+    ClearChannels();
     if (IsConnected()) {
         Disconnect();
     }
+    // Stops the receive thread before the jitter buffer it feeds goes away
+    datagram_transport_.reset();
+    ClearSpectatedSessions();
+    ClearPacedPackets();
+    FailSessionRequests();
+    jitter_buffer_.reset();
 }
 
 void RelayClient::ConnectAsync(const std::string& jwt_token, std::function<void(bool)> callback) {
@@ -111,13 +233,41 @@ void RelayClient::ConnectAsync(const std::string& jwt_token, std::function<void(
         return;
     }
 #endif
-    // Production implementation - minimal functionality for now
-    UpdateConnectionState(ConnectionState::Error);
-    callback(false);
+    // The relay protocol has no connect handshake; once a transport is
+    // attached, the session requests are the first frames on the wire
+    if (!HasTransport()) {
+        UpdateConnectionState(ConnectionState::Error);
+        callback(false);
+        return;
+    }
+    is_connected_ = true;
+    connection_type_ = "relay";
+    UpdateConnectionState(ConnectionState::Connected);
+    callback(true);
 }
 
 void RelayClient::Disconnect() {
+    DisableFailover();
     is_connected_ = false;
+    {
+        std::lock_guard<std::mutex> lock(coalescing_mutex_);
+        pending_bundles_.clear();
+    }
+    ClearPacedPackets();
+    FailSessionRequests();
+    ClearChannels();
+    if (datagram_transport_) {
+        datagram_transport_->Close();
+    }
+    jitter_buffer_->Clear();
+    bandwidth_estimator_.Reset();
+    relay_clock_.Reset();
+    ClearSpectatedSessions();
+    {
+        std::unique_lock lock(sessions_mutex_);
+        sessions_.clear();
+        compressed_sessions_.clear();
+    }
     current_session_ = 0;
     connection_type_ = "disconnected";
     UpdateConnectionState(ConnectionState::Disconnected);
@@ -132,35 +282,1451 @@ RelayClient::ConnectionState RelayClient::GetConnectionState() const {
 }
 
 void RelayClient::CreateSessionAsync(uint32_t session_token, std::function<void(bool, uint32_t)> callback) {
-    callback(false, 0);
+    RequestSession(session_token, RelayProtocol::FLAG_SESSION_CREATE, std::move(callback));
 }
 
 void RelayClient::JoinSessionAsync(uint32_t session_token, std::function<void(bool, uint32_t)> callback) {
-    callback(false, 0);
+    RequestSession(session_token, RelayProtocol::FLAG_SESSION_JOIN, std::move(callback));
+}
+
+void RelayClient::RequestSession(uint32_t session_token, uint8_t flag,
+                                 std::function<void(bool, uint32_t)> callback,
+                                 std::chrono::milliseconds timeout, uint8_t extended_flags) {
+    if (!IsConnected() || !HasTransport()) {
+        callback(false, 0);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(session_requests_mutex_);
+        const auto [it, inserted] = session_requests_.try_emplace(session_token);
+        if (!inserted) {
+            // One request per session at a time
+            callback(false, 0);
+            return;
+        }
+        it->second.flag = flag;
+        it->second.extended_flags = extended_flags;
+        it->second.callback = std::move(callback);
+        it->second.timeout =
+            timer_wheel_->Schedule(timeout, [this, session_token, flag]() {
+                CompleteSessionRequest(session_token, flag, false, 0);
+            });
+    }
+
+    // A spectator is no member: it neither negotiates compression nor has a node id
+    const bool spectate = (extended_flags & RelayProtocol::EXT_FLAG_SPECTATE) != 0;
+    if (!spectate && compression_threshold_.load(std::memory_order_acquire) != 0) {
+        extended_flags |= RelayProtocol::EXT_FLAG_COMPRESSED;
+    }
+    const std::array<uint8_t, 1> node_id{node_id_.load(std::memory_order_relaxed)};
+    RelayFrame frame;
+    if (!spectate && node_id[0] != RelayProtocol::NO_NODE_ID) {
+        frame.payload = node_id;
+    }
+    ChargePriorityBytes(frame.TotalSize());
+    protocol_.WriteHeader(frame.header, session_token, static_cast<uint16_t>(frame.payload.size()),
+                          flag, NextSequence(session_token), extended_flags);
+    if (!WriteFrame(frame)) {
+        CompleteSessionRequest(session_token, flag, false, 0);
+    }
+}
+
+void RelayClient::HandleSessionReply(const RelayHeaderView& header) {
+    // Both bits for a resume
+    const uint8_t flag = header.flags & RelayProtocol::FLAG_SESSION_RESUME;
+    const bool accepted = (header.flags & RelayProtocol::FLAG_CONTROL) == 0;
+    CompleteSessionRequest(header.session_token, flag, accepted, header.extended_flags);
+}
+
+void RelayClient::CompleteSessionRequest(uint32_t session_token, uint8_t flag, bool accepted,
+                                         uint8_t extended_flags) {
+    SessionRequest request;
+    {
+        std::lock_guard<std::mutex> lock(session_requests_mutex_);
+        const auto it = session_requests_.find(session_token);
+        if (it == session_requests_.end() || it->second.flag != flag) {
+            return; // Answered, timed out or never asked
+        }
+        request = std::move(it->second);
+        session_requests_.erase(it);
+    }
+    // Outside the lock: Cancel waits for a running timeout, which takes it
+    timer_wheel_->Cancel(request.timeout);
+
+    if (!accepted) {
+        request.callback(false, 0);
+        return;
+    }
+    if ((request.extended_flags & RelayProtocol::EXT_FLAG_SPECTATE) != 0) {
+        request.callback(true, session_token);
+        return;
+    }
+    {
+        std::unique_lock lock(sessions_mutex_);
+        // The offer was only made while compression was on
+        if ((extended_flags & RelayProtocol::EXT_FLAG_COMPRESSED) != 0 &&
+            compression_threshold_.load(std::memory_order_acquire) != 0) {
+            compressed_sessions_.insert(session_token);
+        } else {
+            compressed_sessions_.erase(session_token);
+        }
+    }
+    // A resumed session keeps whatever role it had
+    if (request.flag != RelayProtocol::FLAG_SESSION_RESUME) {
+        current_session_ = session_token;
+    }
+    request.callback(true, session_token);
+}
+
+void RelayClient::FailSessionRequests() {
+    std::unordered_map<uint32_t, SessionRequest> requests;
+    {
+        std::lock_guard<std::mutex> lock(session_requests_mutex_);
+        requests.swap(session_requests_);
+    }
+    for (auto& [session_token, request] : requests) {
+        timer_wheel_->Cancel(request.timeout);
+        request.callback(false, 0);
+    }
+}
+
+void RelayClient::EnableFailover(std::vector<std::string> servers,
+                                 const std::string& active_server,
+                                 const RelayFailoverConfig& config) {
+    DisableFailover();
+    // Resolved ahead, so a failover redirects without waiting on DNS
+    for (const auto& server : servers) {
+        std::string host;
+        uint16_t port = 0;
+        if (RelayServerSelector::ParseEndpoint(server, config.default_port, host, port)) {
+            DnsResolver::GetShared()->Prefetch(host);
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(failover_mutex_);
+        failover_config_ = config;
+        failover_servers_ = std::move(servers);
+        active_server_ = active_server;
+        failover_candidates_.clear();
+        failover_in_progress_ = false;
+    }
+    last_received_us_.store(NowMicroseconds(), std::memory_order_relaxed);
+    failover_active_ = true;
+    failover_timer_ = timer_wheel_->ScheduleRepeating(config.check_interval,
+                                                      [this]() { OnFailoverTimer(); });
+}
+
+void RelayClient::DisableFailover() {
+    failover_active_ = false;
+    for (auto* timer : {&failover_timer_, &failover_retry_timer_}) {
+        const auto id = timer->exchange(TimerWheel::INVALID_TIMER_ID);
+        if (id != TimerWheel::INVALID_TIMER_ID) {
+            timer_wheel_->Cancel(id);
+        }
+    }
+}
+
+void RelayClient::SetReconnectThrottle(std::shared_ptr<ReconnectThrottle> throttle) {
+    std::lock_guard<std::mutex> lock(failover_mutex_);
+    reconnect_throttle_ = std::move(throttle);
+}
+
+void RelayClient::SetOnFailover(std::function<void(const std::string& server)> callback) {
+    std::lock_guard<std::mutex> lock(failover_mutex_);
+    on_failover_ = std::move(callback);
+}
+
+void RelayClient::OnFailoverTimer() {
+    if (!failover_active_.load() || !IsConnected()) {
+        return;
+    }
+    std::chrono::microseconds silence_timeout;
+    {
+        std::lock_guard<std::mutex> lock(failover_mutex_);
+        if (failover_in_progress_) {
+            return; // The resume requests' timeouts decide
+        }
+        silence_timeout = failover_config_.silence_timeout;
+    }
+    const uint64_t last_received = last_received_us_.load(std::memory_order_relaxed);
+    const uint64_t now = NowMicroseconds();
+    const std::chrono::microseconds silence(
+        static_cast<int64_t>(now > last_received ? now - last_received : 0));
+    if (silence >= silence_timeout) {
+        FailOver();
+    } else if (silence >= silence_timeout / 2) {
+        // An idle relay answers the probe; a dead one stays silent
+        SendKeepalive();
+    }
+}
+
+bool RelayClient::FailOver() {
+    if (!failover_active_.load() || !IsUsingDatagramTransport()) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(failover_mutex_);
+        if (failover_in_progress_) {
+            return false;
+        }
+        failover_in_progress_ = true;
+        failover_candidates_ = RelayServerSelector::RankForSession(failover_servers_,
+                                                                   current_session_.load());
+        std::erase(failover_candidates_, active_server_);
+        // Tried from the back
+        std::reverse(failover_candidates_.begin(), failover_candidates_.end());
+    }
+    TryNextRelay();
+    return true;
+}
+
+void RelayClient::TryNextRelay() {
+    std::chrono::milliseconds wait{0};
+    {
+        std::lock_guard<std::mutex> lock(failover_mutex_);
+        if (failover_active_.load() && !failover_candidates_.empty() && reconnect_throttle_) {
+            wait = reconnect_throttle_->TryAcquire();
+        }
+    }
+    if (wait > std::chrono::milliseconds::zero()) {
+        failover_retry_timer_ = timer_wheel_->Schedule(wait, [this]() { TryNextRelay(); });
+        // DisableFailover may have run in between and missed the timer
+        if (!failover_active_.load()) {
+            const auto id = failover_retry_timer_.exchange(TimerWheel::INVALID_TIMER_ID);
+            if (id != TimerWheel::INVALID_TIMER_ID) {
+                timer_wheel_->Cancel(id);
+            }
+        }
+        return;
+    }
+
+    while (true) {
+        std::string server;
+        uint16_t default_port = 0;
+        {
+            std::lock_guard<std::mutex> lock(failover_mutex_);
+            if (!failover_active_.load() || failover_candidates_.empty()) {
+                failover_in_progress_ = false;
+                if (!failover_active_.load()) {
+                    return;
+                }
+                // Stays off until enabled again, rather than cycling through dead relays
+                failover_active_ = false;
+                break;
+            }
+            server = std::move(failover_candidates_.back());
+            failover_candidates_.pop_back();
+            default_port = failover_config_.default_port;
+        }
+
+        std::string host;
+        uint16_t port = 0;
+        if (RelayServerSelector::ParseEndpoint(server, default_port, host, port) &&
+            datagram_transport_ && datagram_transport_->Redirect(host, port)) {
+            ResumeSessions(server);
+            return;
+        }
+    }
+    HandleConnectionError("Relay lost and no alternate relay resumed the session");
+}
+
+void RelayClient::ResumeSessions(const std::string& server) {
+    auto sessions = GetSessions();
+    const uint32_t current = current_session_.load();
+    if (current != 0 && std::find(sessions.begin(), sessions.end(), current) == sessions.end()) {
+        sessions.push_back(current);
+    }
+    if (sessions.empty()) {
+        OnSessionsResumed(server, true);
+        return;
+    }
+
+    struct Progress {
+        std::atomic<size_t> remaining;
+        std::atomic<bool> failed{false};
+    };
+    auto progress = std::make_shared<Progress>();
+    progress->remaining = sessions.size();
+    std::chrono::milliseconds timeout;
+    {
+        std::lock_guard<std::mutex> lock(failover_mutex_);
+        timeout = failover_config_.resume_timeout;
+    }
+    for (const uint32_t session_token : sessions) {
+        RequestSession(
+            session_token, RelayProtocol::FLAG_SESSION_RESUME,
+            [this, progress, server](bool accepted, uint32_t) {
+                if (!accepted) {
+                    progress->failed = true;
+                }
+                if (progress->remaining.fetch_sub(1) == 1) {
+                    OnSessionsResumed(server, !progress->failed.load());
+                }
+            },
+            timeout);
+    }
+}
+
+void RelayClient::OnSessionsResumed(const std::string& server, bool resumed) {
+    if (!resumed) {
+        TryNextRelay();
+        return;
+    }
+    std::function<void(const std::string&)> callback;
+    {
+        std::lock_guard<std::mutex> lock(failover_mutex_);
+        active_server_ = server;
+        failover_candidates_.clear();
+        failover_in_progress_ = false;
+        callback = on_failover_;
+    }
+    last_received_us_.store(NowMicroseconds(), std::memory_order_relaxed);
+    // The new relay is reached over another path, and keeps its own clock
+    bandwidth_estimator_.Reset();
+    relay_clock_.Reset();
+    failovers_.fetch_add(1, std::memory_order_relaxed);
+    if (callback) {
+        callback(server);
+    }
 }
 
 uint32_t RelayClient::GetCurrentSession() const {
     return current_session_.load();
 }
 
+bool RelayClient::AddSession(uint32_t session_token, SessionDataCallback on_data) {
+    if (session_token == 0) {
+        return false;
+    }
+    std::unique_lock lock(sessions_mutex_);
+    const auto [it, inserted] = sessions_.try_emplace(session_token);
+    if (inserted) {
+        it->second.on_data = std::make_shared<const SessionDataCallback>(std::move(on_data));
+    }
+    return inserted;
+}
+
+void RelayClient::RemoveSession(uint32_t session_token) {
+    {
+        std::lock_guard<std::mutex> lock(coalescing_mutex_);
+        pending_bundles_.erase(session_token);
+    }
+    {
+        std::unique_lock lock(sessions_mutex_);
+        sessions_.erase(session_token);
+        compressed_sessions_.erase(session_token);
+    }
+    jitter_buffer_->RemoveIf(
+        [session_token](uint64_t key) { return StreamSession(key) == session_token; });
+    {
+        std::lock_guard<std::mutex> lock(fragment_mutex_);
+        fragment_reassembler_.Remove(session_token);
+    }
+    std::shared_ptr<ChannelMultiplexer> channels;
+    {
+        std::lock_guard<std::mutex> lock(channels_mutex_);
+        const auto it = channel_sessions_.find(session_token);
+        if (it != channel_sessions_.end()) {
+            channels = std::move(it->second);
+            channel_sessions_.erase(it);
+        }
+    }
+    // Released outside the lock: its destructor waits for a running poll
+    channels.reset();
+}
+
+std::vector<uint32_t> RelayClient::GetSessions() const {
+    std::shared_lock lock(sessions_mutex_);
+    std::vector<uint32_t> sessions;
+    sessions.reserve(sessions_.size());
+    for (const auto& [token, session] : sessions_) {
+        sessions.push_back(token);
+    }
+    return sessions;
+}
+
 bool RelayClient::SendData(const std::vector<uint8_t>& data) {
+    return SendData(std::span<const uint8_t>(data));
+}
+
+bool RelayClient::SendData(const std::vector<uint8_t>& data, SendPriority priority) {
+    return SendData(current_session_.load(), std::span<const uint8_t>(data), priority);
+}
+
+bool RelayClient::SendData(std::span<const uint8_t> payload) {
+    return SendData(current_session_.load(), payload);
+}
+
+bool RelayClient::SendData(uint32_t session_token, std::span<const uint8_t> payload,
+                           SendPriority priority) {
     if (!IsConnected()) {
         return false;
     }
     
-    // Check bandwidth limiting
-    if (bandwidth_limiter_ && !bandwidth_limiter_->CanSendBytes(data.size())) {
+    if (!HasTransport()) {
         return false;
     }
     
-    if (bandwidth_limiter_) {
-        bandwidth_limiter_->ConsumeBytes(data.size());
+    if (priority == SendPriority::Realtime &&
+        coalescing_threshold_.load(std::memory_order_acquire) != 0) {
+        return CoalescePacket(session_token, payload);
+    }
+    return SendDataFrame(session_token, payload, 1, priority);
+}
+
+bool RelayClient::SendLatest(uint32_t session_token, std::span<const uint8_t> payload,
+                             uint64_t key, SendPriority priority) {
+    if (!IsConnected() || !HasTransport()) {
+        return false;
+    }
+    if (priority == SendPriority::Realtime &&
+        coalescing_threshold_.load(std::memory_order_acquire) != 0) {
+        return CoalescePacket(session_token, payload);
+    }
+    return SendDataFrame(session_token, payload, 1, priority, 0, key);
+}
+
+bool RelayClient::SendMulticast(uint32_t session_token, uint8_t destination_mask,
+                                std::span<const uint8_t> payload, SendPriority priority) {
+    if (!IsConnected() || !HasTransport() ||
+        payload.size() + RelayProtocol::MULTICAST_HEADER_SIZE > protocol_.GetMaxPayloadSize()) {
+        return false;
+    }
+    // The frame's payload is one span, so the mask goes in front of a copy
+    thread_local std::vector<uint8_t> framed;
+    framed.clear();
+    framed.push_back(destination_mask);
+    framed.insert(framed.end(), payload.begin(), payload.end());
+    return SendDataFrame(session_token, framed, 1, priority, RelayProtocol::EXT_FLAG_MULTICAST);
+}
+
+bool RelayClient::SendBroadcast(uint32_t session_token, std::span<const uint8_t> payload,
+                                SendPriority priority) {
+    if (!IsConnected() || !HasTransport()) {
+        return false;
+    }
+    // Never coalesced: the flag is per frame, and spectators see only flagged ones
+    return SendDataFrame(session_token, payload, 1, priority, RelayProtocol::EXT_FLAG_SPECTATE);
+}
+
+bool RelayClient::SendSpectatorSnapshot(uint32_t session_token,
+                                        std::span<const uint8_t> snapshot) {
+    if (!IsConnected() || !HasTransport()) {
+        return false;
+    }
+    constexpr uint8_t extended_flags =
+        RelayProtocol::EXT_FLAG_SPECTATE | RelayProtocol::EXT_FLAG_SNAPSHOT;
+    // The next data frame's sequence number, without taking it, so members
+    // see no gap in the sequence for a frame they never receive
+    const uint32_t sequence = NextSequence(session_token, 0);
+    ChargePriorityBytes(sizeof(RelayHeader) + snapshot.size());
+    const uint8_t sender = node_id_.load(std::memory_order_relaxed);
+    const size_t path_mtu = path_mtu_.load(std::memory_order_relaxed);
+    if (IsUsingDatagramTransport() &&
+        sizeof(RelayHeader) + snapshot.size() + SenderTrailerSize(sender) > path_mtu) {
+        return WriteFragments(session_token, snapshot, sequence, extended_flags, path_mtu);
+    }
+    return WriteFrame(
+        protocol_.FrameDataMessage(session_token, snapshot, sequence, extended_flags, sender));
+}
+
+void RelayClient::SpectateSessionAsync(uint32_t session_token, const SpectatorConfig& config,
+                                       SpectatorDataCallback on_data,
+                                       std::function<void(bool, uint32_t)> callback) {
+    // Set up before asking, so a snapshot the relay sends right after its answer is kept
+    auto buffer = std::make_shared<SpectatorDelayBuffer>(
+        config,
+        [on_data = std::move(on_data)](bool snapshot, std::vector<uint8_t>& payload) {
+            if (on_data) {
+                on_data(snapshot, payload);
+            }
+        },
+        timer_wheel_);
+    bool added = false;
+    {
+        std::lock_guard<std::mutex> lock(spectators_mutex_);
+        if (session_token != 0) {
+            added = spectated_sessions_.try_emplace(session_token, buffer).second;
+        }
+        if (added && spectator_refresh_timer_ == TimerWheel::INVALID_TIMER_ID) {
+            spectator_refresh_timer_ = timer_wheel_->ScheduleRepeating(
+                SPECTATOR_REFRESH_INTERVAL, [this] { RefreshSpectatorSubscriptions(); });
+        }
+    }
+    if (!added) {
+        callback(false, 0);
+        return;
+    }
+
+    RequestSession(
+        session_token, RelayProtocol::FLAG_SESSION_JOIN,
+        [this, session_token, buffer, callback = std::move(callback)](bool accepted,
+                                                                      uint32_t token) {
+            if (!accepted) {
+                std::lock_guard<std::mutex> lock(spectators_mutex_);
+                const auto it = spectated_sessions_.find(session_token);
+                if (it != spectated_sessions_.end() && it->second == buffer) {
+                    spectated_sessions_.erase(it);
+                }
+            }
+            callback(accepted, token);
+        },
+        SESSION_REQUEST_TIMEOUT, RelayProtocol::EXT_FLAG_SPECTATE);
+}
+
+void RelayClient::StopSpectating(uint32_t session_token) {
+    std::shared_ptr<SpectatorDelayBuffer> buffer;
+    TimerWheel::TimerId refresh_timer = TimerWheel::INVALID_TIMER_ID;
+    {
+        std::lock_guard<std::mutex> lock(spectators_mutex_);
+        const auto it = spectated_sessions_.find(session_token);
+        if (it == spectated_sessions_.end()) {
+            return;
+        }
+        buffer = std::move(it->second);
+        spectated_sessions_.erase(it);
+        if (spectated_sessions_.empty()) {
+            refresh_timer = std::exchange(spectator_refresh_timer_, TimerWheel::INVALID_TIMER_ID);
+        }
+    }
+    // Outside the lock: Cancel waits for a running refresh, which takes it
+    if (refresh_timer != TimerWheel::INVALID_TIMER_ID) {
+        timer_wheel_->Cancel(refresh_timer);
+    }
+    {
+        std::lock_guard<std::mutex> lock(fragment_mutex_);
+        fragment_reassembler_.Remove(session_token);
+        fragment_reassembler_.Remove(~session_token);
+    }
+    if (IsConnected() && HasTransport()) {
+        RelayFrame frame;
+        ChargePriorityBytes(frame.TotalSize());
+        protocol_.WriteHeader(frame.header, session_token, 0, RelayProtocol::FLAG_SESSION_LEAVE,
+                              NextSequence(session_token), RelayProtocol::EXT_FLAG_SPECTATE);
+        WriteFrame(frame);
+    }
+}
+
+std::optional<SpectatorStatistics> RelayClient::GetSpectatorStatistics(
+    uint32_t session_token) const {
+    const auto buffer = GetSpectatorBuffer(session_token);
+    if (!buffer) {
+        return std::nullopt;
+    }
+    return buffer->GetStatistics();
+}
+
+std::shared_ptr<SpectatorDelayBuffer> RelayClient::GetSpectatorBuffer(
+    uint32_t session_token) const {
+    std::lock_guard<std::mutex> lock(spectators_mutex_);
+    const auto it = spectated_sessions_.find(session_token);
+    return it != spectated_sessions_.end() ? it->second : nullptr;
+}
+
+void RelayClient::RefreshSpectatorSubscriptions() {
+    std::vector<uint32_t> sessions;
+    {
+        std::lock_guard<std::mutex> lock(spectators_mutex_);
+        for (const auto& [session_token, buffer] : spectated_sessions_) {
+            sessions.push_back(session_token);
+        }
+    }
+    // The relay drops spectators it has not heard from, however much they receive
+    for (const uint32_t session_token : sessions) {
+        SendKeepalive(session_token);
+    }
+}
+
+void RelayClient::ClearSpectatedSessions() {
+    std::unordered_map<uint32_t, std::shared_ptr<SpectatorDelayBuffer>> sessions;
+    TimerWheel::TimerId refresh_timer;
+    {
+        std::lock_guard<std::mutex> lock(spectators_mutex_);
+        sessions.swap(spectated_sessions_);
+        refresh_timer = std::exchange(spectator_refresh_timer_, TimerWheel::INVALID_TIMER_ID);
+    }
+    if (refresh_timer != TimerWheel::INVALID_TIMER_ID) {
+        timer_wheel_->Cancel(refresh_timer);
+    }
+    // The buffers go here, outside the lock, cancelling their releases
+}
+
+void RelayClient::SetNodeId(uint8_t node_id) {
+    node_id_.store(node_id, std::memory_order_relaxed);
+}
+
+void RelayClient::EnableChannels(const ChannelConfig& config,
+                                 ChannelDataCallback on_channel_data) {
+    ClearChannels();
+    std::lock_guard<std::mutex> lock(channels_mutex_);
+    channel_config_ = config;
+    on_channel_data_ = std::make_shared<const ChannelDataCallback>(std::move(on_channel_data));
+}
+
+bool RelayClient::SendOnChannel(uint32_t session_token, uint8_t channel,
+                                std::span<const uint8_t> payload) {
+    if (!IsConnected() || !HasTransport()) {
+        return false;
+    }
+    const auto channels = GetChannels(session_token);
+    return channels && channels->Send(channel, payload);
+}
+
+std::optional<ChannelStatistics> RelayClient::GetChannelStatistics(uint32_t session_token) const {
+    std::lock_guard<std::mutex> lock(channels_mutex_);
+    const auto it = channel_sessions_.find(session_token);
+    if (it == channel_sessions_.end()) {
+        return std::nullopt;
+    }
+    return it->second->GetStatistics();
+}
+
+std::shared_ptr<ChannelMultiplexer> RelayClient::GetChannels(uint32_t session_token) {
+    std::lock_guard<std::mutex> lock(channels_mutex_);
+    if (!channel_config_) {
+        return nullptr;
+    }
+    const auto it = channel_sessions_.find(session_token);
+    if (it != channel_sessions_.end()) {
+        return it->second;
+    }
+    auto channels = std::make_shared<ChannelMultiplexer>(
+        *channel_config_,
+        [this, session_token, config = *channel_config_](std::span<const uint8_t> frame) {
+            return SendDataFrame(session_token, frame, 1,
+                                 ChannelMultiplexer::FramePriority(config, frame),
+                                 RelayProtocol::EXT_FLAG_CHANNEL);
+        },
+        [on_channel_data = on_channel_data_, session_token](uint8_t channel,
+                                                            std::span<const uint8_t> payload) {
+            (*on_channel_data)(session_token, channel, payload);
+        },
+        timer_wheel_);
+    channel_sessions_.emplace(session_token, channels);
+    return channels;
+}
+
+void RelayClient::ClearChannels() {
+    std::unordered_map<uint32_t, std::shared_ptr<ChannelMultiplexer>> channels;
+    {
+        std::lock_guard<std::mutex> lock(channels_mutex_);
+        channels.swap(channel_sessions_);
+    }
+    // Destroyed outside the lock: each waits for a running poll, which sends
+}
+
+bool RelayClient::SendDataFrame(uint32_t session_token, std::span<const uint8_t> payload,
+                                uint32_t packet_count, SendPriority priority,
+                                uint8_t extended_flags, std::optional<uint64_t> latest_key) {
+    MULTIPLAYER_TRACE_ZONE("RelayClient::SendDataFrame");
+    // Compressed first, so the bandwidth charged is what goes on the wire. The
+    // relay reads a multicast's mask, so those stay plain; it only reads a
+    // broadcast's flags.
+    if ((extended_flags & ~RelayProtocol::EXT_FLAG_SPECTATE) == 0) {
+        const auto compressed = CompressPayload(session_token, payload);
+        if (!compressed.empty()) {
+            payload = compressed;
+            extended_flags |= RelayProtocol::EXT_FLAG_COMPRESSED;
+        }
+    }
+
+    // Packets of this class or higher already waiting for tokens go first
+    if (IsBandwidthLimited() && (HasPacedPacketsAhead(priority) ||
+                                 !TryConsumeBandwidth(session_token, payload.size()))) {
+        return QueuePacedPacket(session_token, payload, packet_count, extended_flags, priority,
+                                latest_key);
     }
     
-    // Production implementation would send data here
+    return WriteDataFrame(session_token, payload, packet_count, extended_flags);
+}
+
+std::span<const uint8_t> RelayClient::CompressPayload(uint32_t session_token,
+                                                      std::span<const uint8_t> payload) {
+    std::span<const uint8_t> compressed;
+    const size_t threshold = compression_threshold_.load(std::memory_order_acquire);
+    if (threshold != 0 && payload.size() >= threshold && IsCompressionNegotiated(session_token)) {
+        compressed = PayloadCompressor::Compress(payload);
+    }
+    uncompressed_bytes_.fetch_add(payload.size(), std::memory_order_relaxed);
+    compressed_bytes_.fetch_add(compressed.empty() ? payload.size() : compressed.size(),
+                                std::memory_order_relaxed);
+    return compressed;
+}
+
+void RelayClient::SetCompression(size_t min_payload_size) {
+    base_compression_threshold_.store(min_payload_size, std::memory_order_relaxed);
+    compression_threshold_.store(min_payload_size, std::memory_order_release);
+}
+
+bool RelayClient::IsCompressionNegotiated(uint32_t session_token) const {
+    std::shared_lock lock(sessions_mutex_);
+    return compressed_sessions_.contains(session_token);
+}
+
+uint32_t RelayClient::NextSequence(uint32_t session_token, uint32_t count) {
+    std::shared_lock lock(sessions_mutex_);
+    const auto it = sessions_.find(session_token);
+    auto& sequence = it != sessions_.end() ? it->second.next_sequence : next_sequence_;
+    return sequence.fetch_add(count, std::memory_order_relaxed);
+}
+
+bool RelayClient::WriteDataFrame(uint32_t session_token, std::span<const uint8_t> payload,
+                                 uint32_t packet_count, uint8_t extended_flags) {
+    // A bundle takes one sequence number per packet it carries
+    const uint32_t sequence = NextSequence(session_token, packet_count);
+    if (packet_count > 1) {
+        extended_flags |= RelayProtocol::EXT_FLAG_BUNDLE;
+    }
+    const uint8_t sender = node_id_.load(std::memory_order_relaxed);
+    const size_t path_mtu = path_mtu_.load(std::memory_order_relaxed);
+    if (IsUsingDatagramTransport() &&
+        sizeof(RelayHeader) + payload.size() + SenderTrailerSize(sender) > path_mtu) {
+        if (!WriteFragments(session_token, payload, sequence, extended_flags, path_mtu)) {
+            return false;
+        }
+    } else if (!WriteFrame(protocol_.FrameDataMessage(session_token, payload, sequence,
+                                                      extended_flags, sender))) {
+        return false;
+    }
+    if (congestion_controller_) {
+        SendCongestionProbe(session_token);
+    }
+    return true;
+}
+
+bool RelayClient::WriteFragments(uint32_t session_token, std::span<const uint8_t> payload,
+                                 uint32_t sequence, uint8_t extended_flags, size_t path_mtu) {
+    // The relay reads a multicast mask from the front of every fragment
+    const size_t prefix_size = (extended_flags & RelayProtocol::EXT_FLAG_MULTICAST) != 0
+                                   ? RelayProtocol::MULTICAST_HEADER_SIZE
+                                   : 0;
+    const auto message = payload.subspan(prefix_size);
+    const size_t header_size = prefix_size + RelayProtocol::FRAGMENT_HEADER_SIZE;
+    // Every fragment carries the sender, so it is reassembled with its own
+    const uint8_t sender = node_id_.load(std::memory_order_relaxed);
+    const size_t fragment_size =
+        path_mtu - sizeof(RelayHeader) - header_size - SenderTrailerSize(sender);
+    const size_t count = (message.size() + fragment_size - 1) / fragment_size;
+    if (count > RelayProtocol::MAX_FRAGMENT_COUNT) {
+        return false;
+    }
+
+    std::array<uint8_t, PACKET_BUFFER_SIZE> fragment;
+    std::copy(payload.begin(), payload.begin() + prefix_size, fragment.begin());
+    for (size_t index = 0; index < count; ++index) {
+        const size_t offset = index * fragment_size;
+        const auto bytes = message.subspan(offset, std::min(fragment_size, message.size() - offset));
+        FragmentReassembler::WriteHeader(
+            std::span(fragment).subspan(prefix_size).first<RelayProtocol::FRAGMENT_HEADER_SIZE>(),
+            index, count);
+        std::copy(bytes.begin(), bytes.end(), fragment.begin() + header_size);
+        const auto frame = protocol_.FrameDataMessage(
+            session_token, std::span(fragment).first(header_size + bytes.size()), sequence,
+            extended_flags | RelayProtocol::EXT_FLAG_FRAGMENT, sender);
+        if (!WriteFrame(frame)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void RelayClient::ProbePathMtu() {
+    if (!IsUsingDatagramTransport()) {
+        return;
+    }
+    const uint32_t session_token = current_session_.load();
+    const uint64_t now = NowMicroseconds();
+    {
+        std::lock_guard<std::mutex> lock(mtu_probe_mutex_);
+        for (size_t i = 0; i < mtu_probes_.size(); ++i) {
+            // Distinct timestamps tell the answers apart
+            mtu_probes_[i] = {now + i, RelayProtocol::PATH_MTU_CANDIDATES[i]};
+        }
+        mtu_probing_.store(true, std::memory_order_release);
+    }
+
+    std::array<uint8_t, PACKET_BUFFER_SIZE> payload{};
+    for (size_t i = 0; i < RelayProtocol::PATH_MTU_CANDIDATES.size(); ++i) {
+        RelayProtocol::WriteKeepalivePayload(payload, now + i, 0);
+        RelayFrame frame;
+        frame.payload = std::span(payload).first(RelayProtocol::PATH_MTU_CANDIDATES[i] -
+                                                 sizeof(RelayHeader));
+        protocol_.WriteHeader(frame.header, session_token,
+                              static_cast<uint16_t>(frame.payload.size()),
+                              RelayProtocol::FLAG_KEEPALIVE, NextSequence(session_token));
+        // Only the datagram path has an MTU to find; never fall back to the stream
+        datagram_transport_->SendFrame(frame);
+    }
+}
+
+void RelayClient::HandleMtuProbeAnswer(uint64_t echo_timestamp_us) {
+    std::lock_guard<std::mutex> lock(mtu_probe_mutex_);
+    for (size_t i = 0; i < mtu_probes_.size(); ++i) {
+        if (mtu_probes_[i].timestamp_us != echo_timestamp_us) {
+            continue;
+        }
+        // An answer sets the MTU, lower than before if need be, and retires
+        // the smaller probes; a larger one answering later still raises it
+        path_mtu_.store(mtu_probes_[i].size, std::memory_order_relaxed);
+        for (size_t j = i; j < mtu_probes_.size(); ++j) {
+            mtu_probes_[j] = MtuProbe{};
+        }
+        bool outstanding = false;
+        for (const auto& probe : mtu_probes_) {
+            outstanding |= probe.timestamp_us != 0;
+        }
+        mtu_probing_.store(outstanding, std::memory_order_release);
+        return;
+    }
+}
+
+FragmentReassemblyStatistics RelayClient::GetFragmentStatistics() const {
+    std::lock_guard<std::mutex> lock(fragment_mutex_);
+    return fragment_reassembler_.GetStatistics();
+}
+
+void RelayClient::SetCoalescing(size_t flush_threshold) {
+    std::lock_guard<std::mutex> lock(coalescing_mutex_);
+    for (auto& [session_token, bundler] : pending_bundles_) {
+        FlushBundleLocked(session_token, bundler);
+    }
+    pending_bundles_.clear();
+    coalescing_threshold_.store(std::min(flush_threshold, protocol_.GetMaxPayloadSize()),
+                                std::memory_order_release);
+}
+
+void RelayClient::FlushCoalescedPackets() {
+    std::lock_guard<std::mutex> lock(coalescing_mutex_);
+    for (auto& [session_token, bundler] : pending_bundles_) {
+        FlushBundleLocked(session_token, bundler);
+    }
+}
+
+bool RelayClient::CoalescePacket(uint32_t session_token, std::span<const uint8_t> payload) {
+    std::lock_guard<std::mutex> lock(coalescing_mutex_);
+    const size_t threshold = coalescing_threshold_.load(std::memory_order_relaxed);
+    if (threshold == 0) {
+        return SendDataFrame(session_token, payload, 1, SendPriority::Realtime);
+    }
+
+    auto& bundler = pending_bundles_.try_emplace(session_token, threshold).first->second;
+    if (bundler.Append(payload)) {
+        return true;
+    }
+    // Full: what is held goes first, then this packet starts the next bundle
+    FlushBundleLocked(session_token, bundler);
+    if (bundler.Append(payload)) {
+        return true;
+    }
+    // Too large to bundle at all
+    return SendDataFrame(session_token, payload, 1, SendPriority::Realtime);
+}
+
+bool RelayClient::FlushBundleLocked(uint32_t session_token, PacketBundler& bundler) {
+    if (bundler.Empty()) {
+        return true;
+    }
+    if (!IsConnected() || !HasTransport()) {
+        bundler.Clear();
+        return false;
+    }
+    // A lone packet is sent plain, without the bundle's length prefix
+    const uint32_t packet_count = static_cast<uint32_t>(bundler.GetPacketCount());
+    const bool sent =
+        packet_count == 1
+            ? SendDataFrame(session_token, bundler.GetSinglePacket(), 1, SendPriority::Realtime)
+            : SendDataFrame(session_token, bundler.GetBundle(), packet_count,
+                            SendPriority::Realtime);
+    bundler.Clear();
+    return sent;
+}
+
+bool RelayClient::SendControlMessage(uint8_t control_type) {
+    return SendControlMessage(current_session_.load(), control_type);
+}
+
+bool RelayClient::SendControlMessage(uint32_t session_token, uint8_t control_type) {
+    if (!IsConnected() || !HasTransport()) {
+        return false;
+    }
+
+    RelayFrame frame;
+    ChargePriorityBytes(frame.TotalSize());
+    protocol_.WriteHeader(frame.header, session_token, 0, control_type,
+                          NextSequence(session_token));
+    return WriteFrame(frame);
+}
+
+bool RelayClient::SendKeepalive() {
+    return SendKeepalive(current_session_.load());
+}
+
+bool RelayClient::SendKeepalive(uint32_t session_token) {
+    if (!WriteKeepalive(session_token, NowMicroseconds(), 0)) {
+        return false;
+    }
+    liveness_.OnKeepaliveSent();
+    return true;
+}
+
+bool RelayClient::WriteKeepalive(uint32_t session_token, uint64_t timestamp_us,
+                                 uint64_t echo_timestamp_us) {
+    if (!IsConnected() || !HasTransport()) {
+        return false;
+    }
+
+    std::array<uint8_t, RelayProtocol::KEEPALIVE_PAYLOAD_SIZE> payload;
+    RelayProtocol::WriteKeepalivePayload(payload, timestamp_us, echo_timestamp_us);
+    RelayFrame frame;
+    frame.payload = payload;
+    ChargePriorityBytes(frame.TotalSize());
+    protocol_.WriteHeader(frame.header, session_token, static_cast<uint16_t>(payload.size()),
+                          RelayProtocol::FLAG_KEEPALIVE, NextSequence(session_token));
+    return WriteFrame(frame);
+}
+
+void RelayClient::StartKeepalive() {
+    if (keepalive_active_.exchange(true)) {
+        return; // Already active
+    }
+    ScheduleKeepalive();
+}
+
+void RelayClient::StopKeepalive() {
+    keepalive_active_ = false;
+    // A running check may schedule the next one before it returns
+    for (auto id = keepalive_timer_.exchange(TimerWheel::INVALID_TIMER_ID);
+         id != TimerWheel::INVALID_TIMER_ID;
+         id = keepalive_timer_.exchange(TimerWheel::INVALID_TIMER_ID)) {
+        timer_wheel_->Cancel(id);
+    }
+}
+
+std::chrono::milliseconds RelayClient::GetKeepaliveInterval() const {
+    return liveness_.GetKeepaliveInterval();
+}
+
+uint64_t RelayClient::GetKeepaliveCount() const {
+    return liveness_.GetKeepaliveCount();
+}
+
+void RelayClient::ScheduleKeepalive() {
+    auto delay = liveness_.TimeUntilKeepalive();
+    if (liveness_.HasOutstandingProbe()) {
+        // Also wake when the probe should have been answered
+        const auto timeout = std::chrono::ceil<std::chrono::milliseconds>(
+            rtt_estimator_.GetRetransmissionTimeout());
+        delay = std::min(delay, std::max(timeout - liveness_.GetProbeAge(),
+                                         std::chrono::milliseconds::zero()));
+    }
+    keepalive_timer_ = timer_wheel_->Schedule(std::max(delay, timer_wheel_->GetTickInterval()),
+                                              [this]() { OnKeepaliveTimer(); });
+}
+
+void RelayClient::OnKeepaliveTimer() {
+    if (!keepalive_active_.load()) {
+        return;
+    }
+    if (liveness_.HasOutstandingProbe() &&
+        liveness_.GetProbeAge() >= rtt_estimator_.GetRetransmissionTimeout()) {
+        // The binding may have expired during the idle period; probe again now
+        liveness_.OnBindingLost();
+        SendKeepalive();
+    } else if (liveness_.TimeUntilKeepalive() == std::chrono::milliseconds::zero()) {
+        SendKeepalive();
+    }
+    ScheduleKeepalive();
+}
+
+void RelayClient::HandleKeepalive(const RelayHeaderView& header) {
+    uint64_t timestamp_us = 0;
+    uint64_t echo_timestamp_us = 0;
+    uint64_t responder_time_us = 0;
+    if (!RelayProtocol::ParseKeepalivePayload(header.payload, timestamp_us, echo_timestamp_us,
+                                              responder_time_us)) {
+        return;
+    }
+
+    if (echo_timestamp_us != 0) {
+        if (mtu_probing_.load(std::memory_order_acquire)) {
+            HandleMtuProbeAnswer(echo_timestamp_us);
+        }
+        const uint64_t now = NowMicroseconds();
+        if (now >= echo_timestamp_us) {
+            const std::chrono::microseconds rtt(static_cast<int64_t>(now - echo_timestamp_us));
+            rtt_estimator_.AddSample(rtt);
+            if (responder_time_us != 0) {
+                relay_clock_.AddSample(
+                    {echo_timestamp_us, responder_time_us, responder_time_us, now});
+            }
+            if (congestion_controller_) {
+                OnCongestionSample(rtt);
+            }
+        }
+    } else if (timestamp_us != 0) {
+        WriteKeepalive(header.session_token, 0, timestamp_us);
+    }
+}
+
+bool RelayClient::SendData(const PacketBuffer& packet) {
+    return SendData(std::span<const uint8_t>(packet.data(), packet.size()));
+}
+
+void RelayClient::SetFrameWriter(FrameWriter writer) {
+    frame_writer_ = std::move(writer);
+}
+
+void RelayClient::SetDatagramTransport(std::unique_ptr<IRelayTransport> transport) {
+    if (datagram_transport_) {
+        datagram_transport_->Close();
+    }
+    datagram_transport_ = std::move(transport);
+    if (datagram_transport_) {
+        datagram_transport_->SetOnDatagramReceived(
+            [this](std::span<const uint8_t> datagram) { HandleIncomingFrame(datagram); });
+    }
+}
+
+bool RelayClient::OpenDatagramTransport(const std::string& host, uint16_t port) {
+    if (!datagram_transport_) {
+        SetDatagramTransport(std::make_unique<UdpRelayTransport>());
+    }
+    return datagram_transport_->Open(host, port);
+}
+
+bool RelayClient::IsUsingDatagramTransport() const {
+    return datagram_transport_ && datagram_transport_->IsOpen();
+}
+
+bool RelayClient::MigrateDatagramTransport() {
+    return IsUsingDatagramTransport() && datagram_transport_->Migrate();
+}
+
+bool RelayClient::HasTransport() const {
+    return IsUsingDatagramTransport() || static_cast<bool>(frame_writer_);
+}
+
+bool RelayClient::WriteFrame(const RelayFrame& frame) {
+    MULTIPLAYER_TRACE_ZONE("RelayClient::WriteFrame");
+    // Datagrams first; the stream connection carries what they could not
+    const bool sent = (IsUsingDatagramTransport() && datagram_transport_->SendFrame(frame)) ||
+                      (frame_writer_ && frame_writer_(frame));
+    if (sent) {
+        liveness_.OnSent();
+    }
+    return sent;
+}
+
+void RelayClient::SetBandwidthLimit(uint64_t bytes_per_second, size_t burst_size) {
+    std::lock_guard<std::mutex> lock(pacing_mutex_);
+    bandwidth_limiter_ =
+        std::make_unique<BandwidthLimiter>(bytes_per_second, burst_size, PacingClock(timer_wheel_));
+    configured_bandwidth_limit_ = bytes_per_second;
+    ApplyBandwidthLimitLocked();
+}
+
+void RelayClient::SetBandwidthBudget(std::shared_ptr<RelayBandwidthBudget> budget,
+                                     uint8_t node_id) {
+    std::lock_guard<std::mutex> lock(pacing_mutex_);
+    bandwidth_budget_ = std::move(budget);
+    budget_node_id_ = node_id;
+}
+
+void RelayClient::EnableCongestionControl(const CongestionControlConfig& config,
+                                          std::chrono::milliseconds probe_interval) {
+    std::lock_guard<std::mutex> lock(pacing_mutex_);
+    congestion_controller_ = std::make_unique<DelayBasedController>(config);
+    congestion_probe_interval_ = probe_interval;
+    ApplyBandwidthLimitLocked();
+}
+
+void RelayClient::SetOnRateHint(std::function<void(const RateHint&)> callback) {
+    on_rate_hint_.Reset(std::move(callback));
+}
+
+std::optional<CongestionStatistics> RelayClient::GetCongestionStatistics() const {
+    if (!congestion_controller_) {
+        return std::nullopt;
+    }
+    return congestion_controller_->GetStatistics();
+}
+
+void RelayClient::OnCongestionSample(std::chrono::microseconds rtt) {
+    const auto hint = congestion_controller_->OnRttSample(rtt);
+    if (IsUsingDatagramTransport()) {
+        datagram_transport_->OnQueuingDelay(congestion_controller_->GetStatistics().queuing_delay);
+    }
+    {
+        std::lock_guard<std::mutex> lock(pacing_mutex_);
+        ApplyBandwidthLimitLocked();
+    }
+    if (hint) {
+        on_rate_hint_.Publish(*hint);
+    }
+}
+
+void RelayClient::EnableBandwidthAdaptation(std::chrono::milliseconds interval) {
+    DisableBandwidthAdaptation();
+    estimated_bytes_sent_ = 0;
+    estimated_bytes_acked_ = 0;
+    bandwidth_timer_ =
+        timer_wheel_->ScheduleRepeating(interval, [this]() { OnBandwidthTick(); });
+}
+
+void RelayClient::DisableBandwidthAdaptation() {
+    const auto id = bandwidth_timer_.exchange(TimerWheel::INVALID_TIMER_ID);
+    if (id != TimerWheel::INVALID_TIMER_ID) {
+        timer_wheel_->Cancel(id);
+    }
+    {
+        std::lock_guard<std::mutex> lock(pacing_mutex_);
+        adapted_bandwidth_limit_ = 0;
+        ApplyBandwidthLimitLocked();
+    }
+    compression_threshold_.store(base_compression_threshold_.load(std::memory_order_relaxed),
+                                 std::memory_order_release);
+}
+
+void RelayClient::SetOnBandwidthEstimate(std::function<void(const BandwidthEstimate&)> callback) {
+    on_bandwidth_estimate_.Reset(std::move(callback));
+}
+
+BandwidthEstimate RelayClient::GetBandwidthEstimate() const {
+    return bandwidth_estimator_.GetEstimate();
+}
+
+void RelayClient::OnBandwidthTick() {
+    // Relay data frames are not acknowledged, so the send and delivery
+    // rates come from the reliable channels
+    uint64_t sent = 0;
+    uint64_t acked = 0;
+    {
+        std::lock_guard<std::mutex> lock(channels_mutex_);
+        for (const auto& [token, channels] : channel_sessions_) {
+            const auto stats = channels->GetStatistics();
+            sent += stats.reliable_bytes_sent;
+            acked += stats.reliable_bytes_acked;
+        }
+    }
+    // Closed sessions take their counts with them; start over from here
+    if (sent >= estimated_bytes_sent_ && acked >= estimated_bytes_acked_) {
+        bandwidth_estimator_.OnBytesSent(sent - estimated_bytes_sent_);
+        bandwidth_estimator_.OnBytesAcked(acked - estimated_bytes_acked_);
+    }
+    estimated_bytes_sent_ = sent;
+    estimated_bytes_acked_ = acked;
+
+    const auto estimate = bandwidth_estimator_.GetEstimate();
+    {
+        // Only a building queue lowers the limit; a low packet-pair estimate
+        // may just be the spacing pacing put between packets
+        std::lock_guard<std::mutex> lock(pacing_mutex_);
+        adapted_bandwidth_limit_ = estimate.queue_building ? estimate.available_bytes_per_second : 0;
+        ApplyBandwidthLimitLocked();
+    }
+    const size_t base_threshold = base_compression_threshold_.load(std::memory_order_relaxed);
+    if (base_threshold != 0) {
+        TrafficProfile profile;
+        profile.compression_threshold = base_threshold;
+        compression_threshold_.store(
+            Core::Multiplayer::AdaptToBandwidth(profile, estimate.available_bytes_per_second)
+                .compression_threshold,
+            std::memory_order_release);
+    }
+    on_bandwidth_estimate_.Publish(estimate);
+}
+
+void RelayClient::ApplyBandwidthLimitLocked() {
+    if (!bandwidth_limiter_ || bandwidth_budget_) {
+        return;
+    }
+    uint64_t rate =
+        congestion_controller_ ? congestion_controller_->GetRate() : configured_bandwidth_limit_;
+    if (adapted_bandwidth_limit_ != 0) {
+        rate = std::min(rate, adapted_bandwidth_limit_);
+    }
+    if (rate != bandwidth_limiter_->GetBandwidthLimit()) {
+        bandwidth_limiter_->SetRate(rate);
+    }
+}
+
+void RelayClient::SendCongestionProbe(uint32_t session_token) {
+    // One sender per interval wins the slot; the rest skip the probe
+    const uint64_t now = NowMicroseconds();
+    uint64_t last = last_congestion_probe_us_.load(std::memory_order_relaxed);
+    if (now - last < static_cast<uint64_t>(congestion_probe_interval_.count()) ||
+        !last_congestion_probe_us_.compare_exchange_strong(last, now,
+                                                           std::memory_order_relaxed)) {
+        return;
+    }
+    WriteKeepalive(session_token, now, 0);
+}
+
+bool RelayClient::IsBandwidthLimited() const {
+    return bandwidth_budget_ || bandwidth_limiter_;
+}
+
+void RelayClient::ChargePriorityBytes(size_t byte_count) {
+    if (bandwidth_budget_) {
+        bandwidth_budget_->ConsumePriorityBytes(byte_count);
+    } else if (bandwidth_limiter_) {
+        bandwidth_limiter_->ConsumeBytes(byte_count);
+    }
+}
+
+bool RelayClient::TryConsumeBandwidth(uint32_t session_token, size_t byte_count) {
+    if (bandwidth_budget_) {
+        return bandwidth_budget_->TryConsumeBytes(session_token, budget_node_id_, byte_count);
+    }
+    return bandwidth_limiter_->TryConsumeBytes(byte_count);
+}
+
+std::chrono::milliseconds RelayClient::GetNextBandwidthTime(uint32_t session_token,
+                                                            size_t byte_count) {
+    if (bandwidth_budget_) {
+        return bandwidth_budget_->GetNextAvailableTime(session_token, budget_node_id_,
+                                                       byte_count);
+    }
+    return bandwidth_limiter_->GetNextAvailableTime(byte_count);
+}
+
+size_t RelayClient::GetPacedPacketCount() const {
+    size_t count = 0;
+    for (const auto& paced : paced_counts_) {
+        count += paced.load(std::memory_order_acquire);
+    }
+    return count;
+}
+
+bool RelayClient::HasPacedPacketsAhead(SendPriority priority) const {
+    for (size_t index = 0; index <= static_cast<size_t>(priority); ++index) {
+        if (paced_counts_[index].load(std::memory_order_acquire) != 0) {
+            return true;
+        }
+    }
     return false;
 }
 
+bool RelayClient::QueuePacedPacket(uint32_t session_token, std::span<const uint8_t> payload,
+                                   uint32_t packet_count, uint8_t extended_flags,
+                                   SendPriority priority, std::optional<uint64_t> latest_key) {
+    std::lock_guard<std::mutex> lock(pacing_mutex_);
+    // The caller's buffer is only borrowed, so a waiting packet needs a copy
+    PacedPacket packet{session_token, std::vector<uint8_t>(payload.begin(), payload.end()),
+                       packet_count, extended_flags, priority};
+    if (latest_key) {
+        const auto result = paced_packets_.PushLatest(session_token, priority, *latest_key,
+                                                      std::move(packet), payload.size());
+        if (result == PushResult::Replaced) {
+            // Already counted and already scheduled
+            replaced_packets_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        if (result == PushResult::Full) {
+            dropped_packets_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    } else if (!paced_packets_.Push(session_token, priority, std::move(packet), payload.size())) {
+        dropped_packets_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    paced_counts_[static_cast<size_t>(priority)].fetch_add(1, std::memory_order_release);
+    SchedulePacingLocked(*paced_packets_.Front());
+    return true;
+}
+
+void RelayClient::SchedulePacingLocked(const PacedPacket& packet) {
+    if (pacing_timer_ != TimerWheel::INVALID_TIMER_ID) {
+        return;
+    }
+    const auto delay = std::max(GetNextBandwidthTime(packet.session_token, packet.payload.size()),
+                                std::chrono::milliseconds(1));
+    pacing_timer_ = timer_wheel_->Schedule(delay, [this]() { DrainPacedPackets(); });
+}
+
+void RelayClient::DrainPacedPackets() {
+    std::lock_guard<std::mutex> lock(pacing_mutex_);
+    pacing_timer_ = TimerWheel::INVALID_TIMER_ID;
+
+    // Highest class first; bulk sessions take turns
+    PacedPacket packet;
+    while (const PacedPacket* next = paced_packets_.Front()) {
+        if (!TryConsumeBandwidth(next->session_token, next->payload.size())) {
+            SchedulePacingLocked(*next);
+            return;
+        }
+        paced_packets_.Pop(packet);
+        paced_counts_[static_cast<size_t>(packet.priority)].fetch_sub(1,
+                                                                      std::memory_order_release);
+        if (IsConnected() && HasTransport()) {
+            WriteDataFrame(packet.session_token, packet.payload, packet.packet_count,
+                           packet.extended_flags);
+        }
+    }
+}
+
+void RelayClient::ClearPacedPackets() {
+    TimerWheel::TimerId timer;
+    {
+        std::lock_guard<std::mutex> lock(pacing_mutex_);
+        timer = std::exchange(pacing_timer_, TimerWheel::INVALID_TIMER_ID);
+        paced_packets_.Clear();
+        for (auto& paced : paced_counts_) {
+            paced.store(0, std::memory_order_release);
+        }
+    }
+    // Outside the lock: Cancel waits for a running drain, which takes it
+    if (timer != TimerWheel::INVALID_TIMER_ID) {
+        timer_wheel_->Cancel(timer);
+    }
+}
+
+void RelayClient::HandleIncomingFrame(std::span<const uint8_t> datagram) {
+    MULTIPLAYER_TRACE_PACKET();
+    MULTIPLAYER_TRACE_ZONE("RelayClient::HandleIncomingFrame");
+    RelayHeaderView header;
+    if (!protocol_.ValidateMessage(datagram, &header)) {
+        return;
+    }
+    liveness_.OnReceived();
+    if (failover_active_.load(std::memory_order_relaxed)) {
+        last_received_us_.store(NowMicroseconds(), std::memory_order_relaxed);
+    }
+
+    if ((header.flags & RelayProtocol::FLAG_KEEPALIVE) != 0) {
+        HandleKeepalive(header);
+        return;
+    }
+
+    if ((header.flags & (RelayProtocol::FLAG_SESSION_CREATE | RelayProtocol::FLAG_SESSION_JOIN)) !=
+        0) {
+        HandleSessionReply(header);
+        return;
+    }
+
+    // Only game data is reordered; control frames carry no playout timing
+    if (header.flags != RelayProtocol::FLAG_DATA) {
+        return;
+    }
+    if (bandwidth_timer_.load(std::memory_order_relaxed) != TimerWheel::INVALID_TIMER_ID) {
+        bandwidth_estimator_.OnPacketArrived(datagram.size());
+    }
+    // Broadcast frames of a spectated session go to its delay buffer instead
+    const auto spectator = (header.extended_flags & RelayProtocol::EXT_FLAG_SPECTATE) != 0
+                               ? GetSpectatorBuffer(header.session_token)
+                               : nullptr;
+    const bool snapshot = (header.extended_flags & RelayProtocol::EXT_FLAG_SNAPSHOT) != 0;
+    if (snapshot && !spectator) {
+        return;
+    }
+    std::span<const uint8_t> payload = header.payload;
+    uint8_t sender = RelayProtocol::NO_NODE_ID;
+    if ((header.extended_flags & RelayProtocol::EXT_FLAG_SENDER) != 0) {
+        if (payload.size() < RelayProtocol::SENDER_TRAILER_SIZE) {
+            return;
+        }
+        sender = payload.back();
+        payload = payload.first(payload.size() - RelayProtocol::SENDER_TRAILER_SIZE);
+    }
+    const uint64_t stream = StreamKey(header.session_token, sender);
+    const auto insert = [&](uint32_t sequence, std::span<const uint8_t> packet) {
+        if (spectator) {
+            spectator->Insert(sequence, packet, snapshot);
+        } else {
+            jitter_buffer_->Insert(stream, sequence, packet);
+        }
+    };
+
+    if ((header.extended_flags & RelayProtocol::EXT_FLAG_MULTICAST) != 0) {
+        if (payload.size() < RelayProtocol::MULTICAST_HEADER_SIZE) {
+            return;
+        }
+        payload = payload.subspan(RelayProtocol::MULTICAST_HEADER_SIZE);
+    }
+    if ((header.extended_flags & RelayProtocol::EXT_FLAG_FRAGMENT) != 0) {
+        std::lock_guard<std::mutex> lock(fragment_mutex_);
+        // A snapshot shares the next frame's sequence number, so it is reassembled apart
+        const uint32_t reassembly_key = snapshot ? ~header.session_token : header.session_token;
+        const auto segments =
+            fragment_reassembler_.Add(reassembly_key, sender, header.sequence_num, payload);
+        if (segments.empty()) {
+            return;
+        }
+        if (!spectator && (header.extended_flags & (RelayProtocol::EXT_FLAG_COMPRESSED |
+                                      RelayProtocol::EXT_FLAG_BUNDLE |
+                                      RelayProtocol::EXT_FLAG_CHANNEL)) == 0) {
+            // Gathered straight from the fragment buffers into the jitter buffer
+            jitter_buffer_->Insert(stream, header.sequence_num, segments);
+            return;
+        }
+        // Decompression, bundle parsing and the channel layer need the message in one piece
+        thread_local std::vector<uint8_t> message;
+        message.clear();
+        for (const auto segment : segments) {
+            message.insert(message.end(), segment.begin(), segment.end());
+        }
+        payload = message;
+    }
+    if ((header.extended_flags & RelayProtocol::EXT_FLAG_CHANNEL) != 0) {
+        // A peer's first channel frame sets up this side's multiplexer
+        if (const auto channels = GetChannels(header.session_token)) {
+            channels->Receive(payload);
+        }
+        return;
+    }
+    if ((header.extended_flags & RelayProtocol::EXT_FLAG_COMPRESSED) != 0) {
+        // The jitter buffer copies, so the per-thread output may be reused
+        payload = PayloadCompressor::Decompress(payload);
+        if (payload.empty()) {
+            return;
+        }
+    }
+    if ((header.extended_flags & RelayProtocol::EXT_FLAG_BUNDLE) != 0) {
+        uint32_t sequence = header.sequence_num;
+        PacketBundler::ForEachPacket(payload, [&](std::span<const uint8_t> packet) {
+            insert(sequence++, packet);
+        });
+        return;
+    }
+    insert(header.sequence_num, payload);
+}
+
+void RelayClient::SetJitterBufferConfig(const JitterBufferConfig& config) {
+    jitter_buffer_ = std::make_unique<KeyedJitterBuffer<uint64_t>>(
+        config,
+        [this](uint64_t stream, std::vector<uint8_t>& payload) {
+            DeliverData(StreamSession(stream), payload);
+        },
+        timer_wheel_);
+}
+
+std::optional<JitterBufferStatistics> RelayClient::GetJitterStatistics(uint32_t session_token,
+                                                                       uint8_t sender) const {
+    return jitter_buffer_->GetStatistics(StreamKey(session_token, sender));
+}
+
+void RelayClient::DeliverData(uint32_t session_token, std::vector<uint8_t>& payload) {
+    std::shared_ptr<const SessionDataCallback> on_session_data;
+    {
+        std::shared_lock lock(sessions_mutex_);
+        const auto it = sessions_.find(session_token);
+        if (it != sessions_.end()) {
+            on_session_data = it->second.on_data;
+        }
+    }
+    // Outside the lock so the callback may add or remove sessions
+    if (on_session_data) {
+        if (*on_session_data) {
+            (*on_session_data)(payload);
+        }
+        return;
+    }
+
+    if (on_data_received_) {
+        on_data_received_(payload);
+    }
+}
+
 void RelayClient::SetOnDataReceived(std::function<void(const std::vector<uint8_t>&)> callback) {
     on_data_received_ = callback;
 }
@@ -176,10 +1742,13 @@ std::string RelayClient::GetConnectionType() const {
 }
 
 std::chrono::milliseconds RelayClient::GetLatency() const {
-    return std::chrono::milliseconds(0);
+    return std::chrono::round<std::chrono::milliseconds>(rtt_estimator_.GetSmoothedRtt());
 }
 
 uint64_t RelayClient::GetBandwidthLimit() const {
+    if (bandwidth_budget_) {
+        return bandwidth_budget_->GetBandwidthLimit();
+    }
     if (bandwidth_limiter_) {
         return bandwidth_limiter_->GetBandwidthLimit();
     }
@@ -191,24 +1760,42 @@ void RelayClient::SetErrorCallback(std::function<void(const std::string&)> callb
 }
 
 void RelayClient::TriggerRecovery() {
-    // Production implementation would trigger actual recovery
+    FailOver();
 }
 
 ConnectionMetrics RelayClient::GetConnectionMetrics(const std::string& peer_id) const {
-    std::lock_guard<std::mutex> lock(metrics_mutex_);
-    
-    auto it = peer_metrics_.find(peer_id);
-    if (it != peer_metrics_.end()) {
-        return it->second;
+    ConnectionMetrics metrics{};
+    {
+        std::lock_guard<std::mutex> lock(metrics_mutex_);
+        auto it = peer_metrics_.find(peer_id);
+        if (it != peer_metrics_.end()) {
+            metrics = it->second;
+        } else {
+            // Default metrics
+            metrics.connection_time_ms = 0;
+            metrics.connection_type = ConnectionType::Relay;
+            metrics.bytes_sent = 0;
+            metrics.bytes_received = 0;
+        }
     }
     
-    // Return default metrics
-    ConnectionMetrics metrics{};
-    metrics.connection_time_ms = 0;
-    metrics.connection_type = ConnectionType::Relay;
-    metrics.bytes_sent = 0;
-    metrics.bytes_received = 0;
+    // Every relayed peer is reached through the relay, so they share its RTT
     metrics.latency = GetLatency();
+    metrics.jitter = std::chrono::round<std::chrono::milliseconds>(rtt_estimator_.GetRttVariation());
+    const auto estimate = bandwidth_estimator_.GetEstimate();
+    metrics.bottleneck_bandwidth = estimate.bottleneck_bytes_per_second;
+    metrics.available_bandwidth = estimate.available_bytes_per_second;
+    // Like latency, measured to the relay: peers behind it keep clocks of their own
+    const ClockSyncSnapshot clock = relay_clock_.GetSnapshot();
+    metrics.one_way_latency = clock.outbound_delay;
+    metrics.clock_offset = clock.OffsetAt(NowMicroseconds());
+    metrics.clock_confidence = clock.confidence;
+
+    const uint64_t compressed = compressed_bytes_.load(std::memory_order_relaxed);
+    metrics.compression_ratio =
+        compressed == 0 ? 1.0
+                        : static_cast<double>(uncompressed_bytes_.load(std::memory_order_relaxed)) /
+                              static_cast<double>(compressed);
     
     return metrics;
 }
@@ -3,17 +3,44 @@
 
 #pragma once
 
+#include <array>
 #include <string>
 #include <vector>
 #include <functional>
 #include <chrono>
 #include <cstdint>
 #include <memory>
+#include <memory_resource>
 #include <atomic>
 #include <mutex>
 #include <map>
+#include <optional>
+#include <deque>
+#include <shared_mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <span>
+#include "core/multiplayer/common/bandwidth_estimator.h"
+#include "core/multiplayer/common/channel_multiplexer.h"
+#include "core/multiplayer/common/clock_source.h"
+#include "core/multiplayer/common/clock_sync.h"
+#include "core/multiplayer/common/congestion_controller.h"
+#include "core/multiplayer/common/event_bus.h"
+#include "core/multiplayer/common/liveness_tracker.h"
+#include "core/multiplayer/common/memory_accounting.h"
+#include "core/multiplayer/common/packet_buffer.h"
+#include "core/multiplayer/common/priority_send_queue.h"
+#include "core/multiplayer/common/reconnect_throttle.h"
+#include "core/multiplayer/common/rtt_estimator.h"
+#include "core/multiplayer/common/timer_wheel.h"
+#include "fragment_reassembler.h"
 #include "i_relay_client.h"
+#include "jitter_buffer.h"
+#include "packet_bundle.h"
+#include "relay_transport.h"
+#include "relay_protocol.h"
 #include "relay_types.h"
+#include "spectator_delay_buffer.h"
 
 namespace Core::Multiplayer::ModelA {
 
@@ -25,26 +52,67 @@ namespace Test {
     class MockRelayServerSelector;
 }
 
+class RelayBandwidthBudget;
+
+/**
+ * Relay failover tuning. Together the silence timeout and the resume
+ * timeout bound the interruption when a relay dies.
+ */
+struct RelayFailoverConfig {
+    // Nothing heard from the relay for this long counts as the relay lost;
+    // a keepalive probes the path from halfway through
+    std::chrono::milliseconds silence_timeout{250};
+    std::chrono::milliseconds check_interval{50};
+    // How long an alternate relay gets to confirm the sessions
+    std::chrono::milliseconds resume_timeout{200};
+    // Port used for servers configured without one
+    uint16_t default_port = 8443;
+};
+
 /**
  * Token bucket bandwidth limiter implementation
+ *
+ * Lock-free: the bucket is kept as the time at which it will next be full
+ * (a virtual scheduling time), so refilling and consuming are a single CAS
+ * on one atomic. A packet larger than the burst size is admitted once the
+ * bucket is full and leaves it in debt, so it is delayed but never starved.
+ * Time comes from MonotonicClock unless a clock is given.
  */
 class BandwidthLimiter {
 public:
-    BandwidthLimiter(uint64_t bytes_per_second, size_t burst_size);
+    BandwidthLimiter(uint64_t bytes_per_second, size_t burst_size,
+                     std::shared_ptr<const ClockSource> clock = nullptr);
     bool CanSendBytes(size_t byte_count);
     void ConsumeBytes(size_t byte_count);
+
+    /**
+     * Refills and consumes in one step
+     * @return False if the bucket does not hold byte_count tokens yet
+     */
+    bool TryConsumeBytes(size_t byte_count);
+
     std::chrono::milliseconds GetNextAvailableTime(size_t byte_count);
-    uint64_t GetBandwidthLimit() const { return bytes_per_second_; }
+    uint64_t GetBandwidthLimit() const { return bytes_per_second_.load(std::memory_order_relaxed); }
+    size_t GetAvailableBytes() const;
     void Reset();
 
+    /**
+     * Changes the rate in place, for a congestion controller; safe while
+     * other threads send. The burst keeps its size in bytes.
+     */
+    void SetRate(uint64_t bytes_per_second);
+
 private:
-    uint64_t bytes_per_second_;
+    static int64_t CostNanoseconds(size_t byte_count, uint64_t bytes_per_second);
+    int64_t NowNanoseconds() const;
+
+    const std::shared_ptr<const ClockSource> clock_;
+    std::atomic<uint64_t> bytes_per_second_;
     size_t burst_size_;
-    std::atomic<int64_t> tokens_;
-    std::chrono::steady_clock::time_point last_refill_;
-    std::mutex mutex_;
-    
-    void RefillTokens();
+    // Time the burst takes at the current rate
+    std::atomic<int64_t> burst_ns_;
+    // Time at which the bucket is full again; tokens are derived from it
+    std::atomic<int64_t> full_at_ns_;
 };
 
 /**
@@ -63,7 +131,7 @@ public:
     };
 
     // Constructor for production use
-    RelayClient();
+    explicit RelayClient(std::shared_ptr<TimerWheel> timer_wheel = nullptr);
     
     // Constructor for dependency injection (tests)
     RelayClient(std::unique_ptr<Test::MockRelayConnection> connection,
@@ -79,15 +147,307 @@ public:
     bool IsConnected() const override;
     ConnectionState GetConnectionState() const;
 
-    // Session management
+    /**
+     * Session management. Create and join send a request to the relay and
+     * complete when it answers with the same flag, or fail after
+     * SESSION_REQUEST_TIMEOUT; an answer that also carries FLAG_CONTROL is
+     * a refusal. An accepted session becomes the current one.
+     */
+    static constexpr std::chrono::milliseconds SESSION_REQUEST_TIMEOUT{5000};
     void CreateSessionAsync(uint32_t session_token, std::function<void(bool, uint32_t)> callback) override;
     void JoinSessionAsync(uint32_t session_token, std::function<void(bool, uint32_t)> callback) override;
     uint32_t GetCurrentSession() const override;
 
+    /**
+     * Carries an additional session over this connection. Its data frames
+     * are delivered to on_data instead of the SetOnDataReceived callback,
+     * and it gets its own sequence space; all sessions share the pacing
+     * queue and bandwidth limit of the connection.
+     * @return False for session 0 or a session that is already carried
+     */
+    using SessionDataCallback = std::function<void(const std::vector<uint8_t>&)>;
+    bool AddSession(uint32_t session_token, SessionDataCallback on_data);
+    void RemoveSession(uint32_t session_token);
+    std::vector<uint32_t> GetSessions() const;
+
     // Data transmission
     bool SendData(const std::vector<uint8_t>& data) override;
+    bool SendData(const std::vector<uint8_t>& data, SendPriority priority) override;
     void SetOnDataReceived(std::function<void(const std::vector<uint8_t>&)> callback) override;
 
+    /**
+     * Scatter-gather send path. The relay header is framed into an inline
+     * buffer and handed to the frame writer together with a view of the
+     * caller's payload, so sending a packet performs no allocation or copy.
+     */
+    bool SendData(std::span<const uint8_t> payload);
+    bool SendData(const PacketBuffer& packet);
+    /**
+     * Realtime packets may be coalesced; control and bulk are framed alone.
+     * While the bandwidth limit holds packets back, a packet only waits
+     * behind those of its own class or higher, and bulk from different
+     * sessions is paced out by deficit round-robin.
+     */
+    bool SendData(uint32_t session_token, std::span<const uint8_t> payload,
+                  SendPriority priority = SendPriority::Realtime);
+
+    /**
+     * Latest-value-wins send for state packets. While the bandwidth limit
+     * holds packets back, a paced packet of the session with the same key
+     * is overwritten in place instead of queued behind, so the relay gets
+     * the newest state as soon as tokens allow rather than every stale one
+     * before it. Sequence numbers are taken when a paced packet is written,
+     * so a replaced packet leaves no gap. Coalesced packets go out at the
+     * end of the frame anyway and are not replaced.
+     */
+    bool SendLatest(uint32_t session_token, std::span<const uint8_t> payload, uint64_t key,
+                    SendPriority priority = SendPriority::Realtime);
+
+    /**
+     * Sends one frame that the relay replicates to the session members
+     * destination_mask selects, by the LDN node id they announced (see
+     * SetNodeId), instead of one send per destination. Multicast frames are
+     * never coalesced or compressed. A member left out of a partial mask
+     * sees a gap in this client's sequence numbers, which its jitter buffer
+     * skips once the gap's playout time passes.
+     */
+    bool SendMulticast(uint32_t session_token, uint8_t destination_mask,
+                       std::span<const uint8_t> payload,
+                       SendPriority priority = SendPriority::Realtime);
+
+    /**
+     * LDN node id announced in later session requests, so multicast masks
+     * reach this client. Data frames carry it from then on (EXT_FLAG_SENDER),
+     * so receivers order them apart from other members' frames.
+     */
+    void SetNodeId(uint8_t node_id);
+
+    /**
+     * Spectator broadcast. A member sends the frames an audience should see
+     * with SendBroadcast, once: the relay copies them to the session's
+     * spectators, and edge relays subscribed to it copy them on to theirs,
+     * so the upload stays the same however many watch. Members receive
+     * broadcast frames like any other data. SendSpectatorSnapshot sends the
+     * full state late joiners start from; it reaches spectators only, takes
+     * no sequence number, and the relay keeps the latest one per session.
+     */
+    bool SendBroadcast(uint32_t session_token, std::span<const uint8_t> payload,
+                       SendPriority priority = SendPriority::Realtime);
+    bool SendSpectatorSnapshot(uint32_t session_token, std::span<const uint8_t> snapshot);
+
+    /**
+     * Subscribes to a session's broadcast as a spectator, which takes no
+     * member slot and cannot send into the session. Frames go through a
+     * SpectatorDelayBuffer and reach on_data after the configured delay,
+     * starting with a snapshot. The subscription is kept alive with
+     * keepalives every SPECTATOR_REFRESH_INTERVAL; spectated sessions are
+     * not carried over on relay failover.
+     */
+    static constexpr std::chrono::milliseconds SPECTATOR_REFRESH_INTERVAL{10000};
+    using SpectatorDataCallback =
+        std::function<void(bool snapshot, const std::vector<uint8_t>& payload)>;
+    void SpectateSessionAsync(uint32_t session_token, const SpectatorConfig& config,
+                              SpectatorDataCallback on_data,
+                              std::function<void(bool, uint32_t)> callback);
+    void StopSpectating(uint32_t session_token);
+    std::optional<SpectatorStatistics> GetSpectatorStatistics(uint32_t session_token) const;
+
+    /**
+     * Channel layer over the relay. Each session gets a ChannelMultiplexer
+     * whose frames go out as EXT_FLAG_CHANNEL data; reliable messages are
+     * retransmitted until the peer acknowledges them, and acknowledgements
+     * ride on this client's own channel frames. Received channel frames skip
+     * the jitter buffer and reach on_channel_data in the channel's order.
+     * Acknowledgements are not per member, so reliable channels suit
+     * sessions with a single peer on the far side. Both ends must use the
+     * same config; call before creating or joining.
+     */
+    using ChannelDataCallback = std::function<void(uint32_t session_token, uint8_t channel,
+                                                   std::span<const uint8_t> payload)>;
+    void EnableChannels(const ChannelConfig& config, ChannelDataCallback on_channel_data);
+    bool SendOnChannel(uint32_t session_token, uint8_t channel, std::span<const uint8_t> payload);
+    std::optional<ChannelStatistics> GetChannelStatistics(uint32_t session_token) const;
+
+    /**
+     * Sets the transport sink that receives framed messages as separate
+     * header and payload segments (suitable for writev/sendmsg).
+     */
+    using FrameWriter = std::function<bool(const RelayFrame& frame)>;
+    void SetFrameWriter(FrameWriter writer);
+
+    /**
+     * Entry point for datagrams from the relay transport. Data frames are
+     * played out per session through a jitter buffer, in sequence order,
+     * before reaching the SetOnDataReceived callback.
+     */
+    void HandleIncomingFrame(std::span<const uint8_t> datagram);
+
+    /**
+     * Datagram transport for relay frames. While it is open, frames go out
+     * as datagrams and the frame writer is only the fallback for sends the
+     * datagram transport could not make.
+     */
+    void SetDatagramTransport(std::unique_ptr<IRelayTransport> transport);
+    // Opens the datagram transport, creating a UdpRelayTransport if none was set
+    bool OpenDatagramTransport(const std::string& host, uint16_t port);
+    bool IsUsingDatagramTransport() const;
+    // Call on a network change to move the datagram transport to the new network
+    bool MigrateDatagramTransport();
+
+    /**
+     * Data frames that would not fit in the path MTU go out over the
+     * datagram transport as EXT_FLAG_FRAGMENT fragments, which the receiving
+     * client reassembles; the stream connection carries them whole. The MTU
+     * starts at the smallest of RelayProtocol::PATH_MTU_CANDIDATES.
+     * ProbePathMtu sends a keepalive padded to each candidate size and
+     * raises it to the largest one the relay answers; a probe too large for
+     * the path is simply lost. Call it once the datagram transport is open,
+     * and again after a migration or failover.
+     */
+    void ProbePathMtu();
+    size_t GetPathMtu() const { return path_mtu_.load(std::memory_order_relaxed); }
+    FragmentReassemblyStatistics GetFragmentStatistics() const;
+
+    /**
+     * Opt-in coalescing of small packets. Data packets are held per session
+     * and sent together as one bundled frame (EXT_FLAG_BUNDLE) when the next
+     * one would push the bundle past flush_threshold bytes, or when
+     * FlushCoalescedPackets is called at the end of every frame, see
+     * ModelABackend::SetFrameBoundaryHandler. A threshold of 0 flushes what is held and turns
+     * coalescing off.
+     */
+    static constexpr size_t DEFAULT_COALESCING_THRESHOLD = 1200;
+    void SetCoalescing(size_t flush_threshold);
+    void FlushCoalescedPackets();
+
+    /**
+     * Opt-in LZ4 compression of data payloads of at least min_payload_size
+     * bytes (EXT_FLAG_COMPRESSED). While it is on, session create and join
+     * requests offer it, and it is only used on sessions whose relay
+     * accepted the offer; payloads LZ4 cannot shrink are sent as they are.
+     * Set it before creating or joining; 0 turns it off.
+     */
+    static constexpr size_t DEFAULT_COMPRESSION_THRESHOLD = 256;
+    void SetCompression(size_t min_payload_size);
+    bool IsCompressionNegotiated(uint32_t session_token) const;
+
+    // Replaces the receive jitter buffer; call before connecting
+    void SetJitterBufferConfig(const JitterBufferConfig& config);
+    /**
+     * Statistics of one sender's stream in a session. Members that announced
+     * a node id each have their own; frames from the rest share NO_NODE_ID's.
+     */
+    std::optional<JitterBufferStatistics> GetJitterStatistics(
+        uint32_t session_token, uint8_t sender = RelayProtocol::NO_NODE_ID) const;
+
+    /**
+     * Replaces the bandwidth limit. Packets that find the bucket empty are
+     * held in a pacing queue and sent, in order, once enough tokens have
+     * accumulated; they are only dropped if the queue is full.
+     */
+    void SetBandwidthLimit(uint64_t bytes_per_second, size_t burst_size);
+    size_t GetPacedPacketCount() const;
+
+    /**
+     * Opt-in delay-based congestion control. Keepalive echoes feed a
+     * DelayBasedController, and while data flows a timestamped keepalive
+     * goes out with it at most every probe_interval, so samples keep coming
+     * under load when idle keepalives stop. Each sample retunes the
+     * bandwidth limit to the controller's rate; a shared bandwidth budget is
+     * left alone. Call before data flows.
+     */
+    static constexpr std::chrono::milliseconds DEFAULT_CONGESTION_PROBE_INTERVAL{100};
+    void EnableCongestionControl(
+        const CongestionControlConfig& config,
+        std::chrono::milliseconds probe_interval = DEFAULT_CONGESTION_PROBE_INTERVAL);
+    // Raised when congestion starts or ends, e.g. for ModelABackend::ReportRateHint
+    void SetOnRateHint(std::function<void(const RateHint&)> callback);
+    std::optional<CongestionStatistics> GetCongestionStatistics() const;
+
+    /**
+     * Opt-in bandwidth adaptation. Arriving data frames and the reliable
+     * channels' acknowledgements feed a BandwidthEstimator, and every
+     * interval its estimate retunes the bandwidth limit (never above what
+     * congestion control allows) and the compression threshold. A shared
+     * bandwidth budget is left alone.
+     */
+    static constexpr std::chrono::milliseconds DEFAULT_BANDWIDTH_ADAPTATION_INTERVAL{500};
+    void EnableBandwidthAdaptation(
+        std::chrono::milliseconds interval = DEFAULT_BANDWIDTH_ADAPTATION_INTERVAL);
+    void DisableBandwidthAdaptation();
+    // Raised every interval, e.g. for ModelABackend::ReportAvailableBandwidth
+    void SetOnBandwidthEstimate(std::function<void(const BandwidthEstimate&)> callback);
+    BandwidthEstimate GetBandwidthEstimate() const;
+
+    /**
+     * Charges sends against a budget shared with the gateway's other
+     * clients, as node node_id of the session sent on, instead of this
+     * client's own limiter
+     */
+    void SetBandwidthBudget(std::shared_ptr<RelayBandwidthBudget> budget, uint8_t node_id);
+
+    /**
+     * Sends a header-only control frame (FLAG_CONTROL, FLAG_KEEPALIVE, ...).
+     * Control frames have strict priority: they skip the pacing queue and
+     * are charged to the bandwidth budget without waiting for tokens.
+     */
+    bool SendControlMessage(uint8_t control_type);
+    bool SendControlMessage(uint32_t session_token, uint8_t control_type);
+    uint64_t GetDroppedPacketCount() const { return dropped_packets_.load(); }
+    uint64_t GetReplacedPacketCount() const { return replaced_packets_.load(); }
+
+    /**
+     * Sends a timestamped keepalive. The relay echoes the timestamp back and
+     * the echo feeds the RTT estimator behind GetLatency; keepalive requests
+     * arriving from the relay are answered the same way.
+     */
+    bool SendKeepalive();
+    bool SendKeepalive(uint32_t session_token);
+
+    /**
+     * Keeps the relay session and the NAT binding to the relay alive. A
+     * keepalive on the current session only goes out once no frame at all
+     * has been sent for the keepalive interval, since the relay refreshes a
+     * peer on every frame it routes. The interval adapts to the path's NAT
+     * binding timeout: it grows while idle keepalives keep being answered
+     * and drops below an idle period whose keepalive was not answered within
+     * the retransmission timeout.
+     */
+    void StartKeepalive();
+    void StopKeepalive();
+    std::chrono::milliseconds GetKeepaliveInterval() const;
+    uint64_t GetKeepaliveCount() const;
+    // Lock-free view of the relay round-trip time and its variation
+    const RttEstimator& GetRttEstimator() const { return rtt_estimator_; }
+    // The relay's clock against ours, from relays that stamp keepalive echoes
+    ClockSyncSnapshot GetRelayClockSync() const { return relay_clock_.GetSnapshot(); }
+
+    /**
+     * Relay failover. While enabled, a relay that goes silent for
+     * silence_timeout is abandoned for an alternate from servers, tried in
+     * RelayServerSelector::RankForSession order so every peer of the session
+     * picks the same one. The datagram transport is redirected to it and
+     * every carried session is resumed there under the same token
+     * (FLAG_SESSION_RESUME); sequence numbers, the jitter buffers and the
+     * pacing queue carry on, so the game only sees a short gap. An alternate
+     * that does not confirm within resume_timeout is skipped; once none is
+     * left the connection error callback is raised. Each alternate tried
+     * takes a token from the reconnect throttle first, so the clients of a
+     * relay that went down do not all land on the next one at once.
+     * Alternates' host names are prefetched into the shared DnsResolver.
+     * Requires the datagram transport; active_server is the one in use.
+     */
+    void EnableFailover(std::vector<std::string> servers, const std::string& active_server,
+                        const RelayFailoverConfig& config = RelayFailoverConfig{});
+    void DisableFailover();
+    // Called with the new relay once every session has resumed on it
+    void SetOnFailover(std::function<void(const std::string& server)> callback);
+    // Moves to the next alternate relay now; false if failover is off or under way
+    bool FailOver();
+    uint64_t GetFailoverCount() const { return failovers_.load(std::memory_order_relaxed); }
+    // ReconnectThrottle::GetShared() unless replaced
+    void SetReconnectThrottle(std::shared_ptr<ReconnectThrottle> throttle);
+
     // P2P fallback
     void ConnectToPeerAsync(const std::string& peer_id, 
                            std::function<void(bool, const std::string&)> callback) override;
@@ -107,9 +467,138 @@ private:
     std::atomic<bool> is_connected_{false};
     std::string connection_type_{"disconnected"};
     
+    // Framing
+    RelayProtocol protocol_;
+    std::atomic<uint32_t> next_sequence_{0};
+    std::atomic<uint8_t> node_id_{RelayProtocol::NO_NODE_ID};
+    FrameWriter frame_writer_;
+    std::unique_ptr<IRelayTransport> datagram_transport_;
+    
     // Bandwidth limiting (10 Mbps = 10 * 1024 * 1024 bytes/second)
     static constexpr uint64_t DEFAULT_BANDWIDTH_LIMIT = 10 * 1024 * 1024;
     std::unique_ptr<BandwidthLimiter> bandwidth_limiter_;
+    uint64_t configured_bandwidth_limit_ = DEFAULT_BANDWIDTH_LIMIT; // pacing_mutex_
+
+    // Send pacing for packets that found the bucket empty
+    static constexpr size_t MAX_PACED_PACKETS = 256;
+    std::shared_ptr<TimerWheel> timer_wheel_;
+    mutable std::mutex pacing_mutex_;
+    struct PacedPacket {
+        uint32_t session_token;
+        std::vector<uint8_t> payload;
+        uint32_t packet_count;  // More than one for a bundle
+        uint8_t extended_flags;
+        SendPriority priority;
+    };
+    // Keyed by session token
+    PrioritySendQueue<PacedPacket> paced_packets_{MAX_PACED_PACKETS};
+    // Per class, read without pacing_mutex_ on the send path
+    std::array<std::atomic<size_t>, SEND_PRIORITY_COUNT> paced_counts_{};
+    TimerWheel::TimerId pacing_timer_{TimerWheel::INVALID_TIMER_ID}; // guarded by pacing_mutex_
+    std::atomic<uint64_t> dropped_packets_{0};
+    std::atomic<uint64_t> replaced_packets_{0};
+    std::shared_ptr<RelayBandwidthBudget> bandwidth_budget_;
+    uint8_t budget_node_id_{0};
+
+    // Per-session bundles of coalesced packets; held while sending to keep order
+    std::mutex coalescing_mutex_;
+    std::atomic<size_t> coalescing_threshold_{0};
+    std::unordered_map<uint32_t, PacketBundler> pending_bundles_;
+
+    // Round-trip time to the relay, from echoed keepalives
+    RttEstimator rtt_estimator_;
+    ClockSyncEstimator relay_clock_;
+
+    // Delay-based rate control; set before data flows
+    std::unique_ptr<DelayBasedController> congestion_controller_;
+    std::chrono::microseconds congestion_probe_interval_{0};
+    std::atomic<uint64_t> last_congestion_probe_us_{0};
+    EventChannel<RateHint> on_rate_hint_;
+
+    // Bandwidth adaptation; the byte counts are those last fed in
+    BandwidthEstimator bandwidth_estimator_;
+    uint64_t adapted_bandwidth_limit_ = 0; // pacing_mutex_; 0 while no queue builds
+    EventChannel<BandwidthEstimate> on_bandwidth_estimate_;
+    std::atomic<TimerWheel::TimerId> bandwidth_timer_{TimerWheel::INVALID_TIMER_ID};
+    uint64_t estimated_bytes_sent_ = 0;  // Timer wheel thread only
+    uint64_t estimated_bytes_acked_ = 0; // Timer wheel thread only
+
+    // Traffic-driven keepalives
+    LivenessTracker liveness_;
+    std::atomic<bool> keepalive_active_{false};
+    std::atomic<TimerWheel::TimerId> keepalive_timer_{TimerWheel::INVALID_TIMER_ID};
+
+    // Create and join requests waiting for the relay's answer
+    struct SessionRequest {
+        uint8_t flag;
+        uint8_t extended_flags; // EXT_FLAG_SPECTATE for a spectator subscription
+        std::function<void(bool, uint32_t)> callback;
+        TimerWheel::TimerId timeout;
+    };
+    std::mutex session_requests_mutex_;
+    std::unordered_map<uint32_t, SessionRequest> session_requests_;
+
+    // Relay failover; the check runs on the timer wheel
+    std::mutex failover_mutex_;
+    RelayFailoverConfig failover_config_;
+    std::vector<std::string> failover_servers_;
+    std::string active_server_;
+    // Alternates still to try in the failover under way
+    std::vector<std::string> failover_candidates_;
+    bool failover_in_progress_{false};
+    std::function<void(const std::string&)> on_failover_;
+    std::atomic<bool> failover_active_{false};
+    std::atomic<TimerWheel::TimerId> failover_timer_{TimerWheel::INVALID_TIMER_ID};
+    // Next alternate, when the throttle put it off
+    std::atomic<TimerWheel::TimerId> failover_retry_timer_{TimerWheel::INVALID_TIMER_ID};
+    std::shared_ptr<ReconnectThrottle> reconnect_throttle_; // failover_mutex_
+    std::atomic<uint64_t> last_received_us_{0};
+    std::atomic<uint64_t> failovers_{0};
+
+    // Payload compression; data payload bytes are counted before and after it
+    std::atomic<size_t> compression_threshold_{0};
+    std::atomic<size_t> base_compression_threshold_{0}; // As SetCompression set it
+    std::atomic<uint64_t> uncompressed_bytes_{0};
+    std::atomic<uint64_t> compressed_bytes_{0};
+
+    // Path MTU probing; a probe is matched to its answer by its timestamp
+    struct MtuProbe {
+        uint64_t timestamp_us = 0;
+        size_t size = 0;
+    };
+    std::atomic<size_t> path_mtu_{RelayProtocol::PATH_MTU_CANDIDATES.back()};
+    std::atomic<bool> mtu_probing_{false};
+    std::mutex mtu_probe_mutex_;
+    std::array<MtuProbe, RelayProtocol::PATH_MTU_CANDIDATES.size()> mtu_probes_{};
+
+    // Reassembly of fragmented data frames; enough buffers for one maximum
+    // size message at the smallest MTU and a few more in flight
+    static constexpr size_t FRAGMENT_POOL_CAPACITY = 96;
+    PacketPool fragment_pool_{FRAGMENT_POOL_CAPACITY};
+    mutable std::mutex fragment_mutex_;
+    FragmentReassembler fragment_reassembler_{fragment_pool_};
+
+    // Channel layer, one multiplexer per session, created on first use
+    mutable std::mutex channels_mutex_;
+    std::optional<ChannelConfig> channel_config_;
+    std::shared_ptr<const ChannelDataCallback> on_channel_data_;
+    std::unordered_map<uint32_t, std::shared_ptr<ChannelMultiplexer>> channel_sessions_;
+
+    // Sessions multiplexed over the connection besides current_session_
+    struct MultiplexedSession {
+        std::shared_ptr<const SessionDataCallback> on_data;
+        std::atomic<uint32_t> next_sequence{0};
+    };
+    mutable std::shared_mutex sessions_mutex_;
+    std::pmr::unordered_map<uint32_t, MultiplexedSession> sessions_{
+        GetMemoryResource(MemorySubsystem::Relay)};
+    // Sessions whose relay accepted compression; guarded by sessions_mutex_
+    std::unordered_set<uint32_t> compressed_sessions_;
+
+    // Sessions spectated rather than joined
+    mutable std::mutex spectators_mutex_;
+    std::unordered_map<uint32_t, std::shared_ptr<SpectatorDelayBuffer>> spectated_sessions_;
+    TimerWheel::TimerId spectator_refresh_timer_{TimerWheel::INVALID_TIMER_ID};
     
     // Mock dependencies for testing (only used when BUILDING_TESTS is defined)
 #ifdef BUILDING_TESTS
@@ -122,6 +611,10 @@ private:
     // Callbacks
     std::function<void(const std::vector<uint8_t>&)> on_data_received_;
     std::function<void(const std::string&)> on_error_;
+
+    // Declared after the callbacks so its pending releases stop first. Keyed
+    // by (session, sender); see StreamKey.
+    std::unique_ptr<KeyedJitterBuffer<uint64_t>> jitter_buffer_;
     
     // Connection metrics tracking
     mutable std::mutex metrics_mutex_;
@@ -131,6 +624,59 @@ private:
     mutable std::mutex state_mutex_;
     
     // Helper methods
+    bool HasTransport() const;
+    bool WriteFrame(const RelayFrame& frame);
+    bool IsBandwidthLimited() const;
+    void ChargePriorityBytes(size_t byte_count);
+    bool WriteKeepalive(uint32_t session_token, uint64_t timestamp_us, uint64_t echo_timestamp_us);
+    void HandleKeepalive(const RelayHeaderView& header);
+    void ScheduleKeepalive();
+    void OnKeepaliveTimer();
+    bool TryConsumeBandwidth(uint32_t session_token, size_t byte_count);
+    std::chrono::milliseconds GetNextBandwidthTime(uint32_t session_token, size_t byte_count);
+    uint32_t NextSequence(uint32_t session_token, uint32_t count = 1);
+    bool SendDataFrame(uint32_t session_token, std::span<const uint8_t> payload,
+                       uint32_t packet_count, SendPriority priority,
+                       uint8_t extended_flags = 0,
+                       std::optional<uint64_t> latest_key = std::nullopt);
+    bool WriteDataFrame(uint32_t session_token, std::span<const uint8_t> payload,
+                        uint32_t packet_count, uint8_t extended_flags);
+    bool WriteFragments(uint32_t session_token, std::span<const uint8_t> payload,
+                        uint32_t sequence, uint8_t extended_flags, size_t path_mtu);
+    void HandleMtuProbeAnswer(uint64_t echo_timestamp_us);
+    std::span<const uint8_t> CompressPayload(uint32_t session_token,
+                                             std::span<const uint8_t> payload);
+    void RequestSession(uint32_t session_token, uint8_t flag,
+                        std::function<void(bool, uint32_t)> callback,
+                        std::chrono::milliseconds timeout = SESSION_REQUEST_TIMEOUT,
+                        uint8_t extended_flags = 0);
+    void HandleSessionReply(const RelayHeaderView& header);
+    void CompleteSessionRequest(uint32_t session_token, uint8_t flag, bool accepted,
+                                uint8_t extended_flags);
+    void FailSessionRequests();
+    void OnFailoverTimer();
+    void TryNextRelay();
+    void ResumeSessions(const std::string& server);
+    void OnSessionsResumed(const std::string& server, bool resumed);
+    bool CoalescePacket(uint32_t session_token, std::span<const uint8_t> payload);
+    bool FlushBundleLocked(uint32_t session_token, PacketBundler& bundler);
+    bool QueuePacedPacket(uint32_t session_token, std::span<const uint8_t> payload,
+                          uint32_t packet_count, uint8_t extended_flags,
+                          SendPriority priority, std::optional<uint64_t> latest_key);
+    bool HasPacedPacketsAhead(SendPriority priority) const;
+    void OnCongestionSample(std::chrono::microseconds rtt);
+    void OnBandwidthTick();
+    void ApplyBandwidthLimitLocked();
+    void SendCongestionProbe(uint32_t session_token);
+    void SchedulePacingLocked(const PacedPacket& packet);
+    void DrainPacedPackets();
+    void ClearPacedPackets();
+    void DeliverData(uint32_t session_token, std::vector<uint8_t>& payload);
+    std::shared_ptr<SpectatorDelayBuffer> GetSpectatorBuffer(uint32_t session_token) const;
+    void RefreshSpectatorSubscriptions();
+    void ClearSpectatedSessions();
+    std::shared_ptr<ChannelMultiplexer> GetChannels(uint32_t session_token);
+    void ClearChannels();
     void HandleConnectionError(const std::string& error);
     void UpdateConnectionState(ConnectionState new_state);
     bool IsUsingMocks() const { 
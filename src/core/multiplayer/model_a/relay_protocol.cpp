@@ -14,79 +14,113 @@ static constexpr uint16_t MAX_PAYLOAD_SIZE = 65535;
 // Flag constants for easy access
 using namespace RelayProtocolFlags;
 
+namespace {
+struct KeepalivePayload {
+    uint64_t timestamp_us = 0;
+    uint64_t echo_timestamp_us = 0;
+    uint64_t responder_time_us = 0;
+};
+using KeepaliveLayout =
+    Wire::Layout<RelayProtocol::KEEPALIVE_PAYLOAD_SIZE, Wire::Field<&KeepalivePayload::timestamp_us, 0>,
+                 Wire::Field<&KeepalivePayload::echo_timestamp_us, 8>>;
+using KeepaliveClockLayout =
+    Wire::Layout<RelayProtocol::KEEPALIVE_CLOCK_PAYLOAD_SIZE,
+                 Wire::Field<&KeepalivePayload::timestamp_us, 0>,
+                 Wire::Field<&KeepalivePayload::echo_timestamp_us, 8>,
+                 Wire::Field<&KeepalivePayload::responder_time_us, 16>>;
+} // namespace
+
+size_t RelayProtocol::WriteHeader(std::span<uint8_t> out, uint32_t session_token,
+                                  uint16_t payload_size, uint8_t flags,
+                                  uint32_t sequence_num, uint8_t extended_flags) const {
+    RelayHeaderView header;
+    header.session_token = session_token;
+    header.payload_size = payload_size;
+    header.flags = flags;
+    header.extended_flags = extended_flags;
+    header.sequence_num = sequence_num;
+    return RelayHeaderLayout::TryEncode(header, out) ? RELAY_HEADER_SIZE : 0;
+}
+
 std::vector<uint8_t> RelayProtocol::SerializeHeader(uint32_t session_token, uint16_t payload_size,
                                                     uint8_t flags, uint32_t sequence_num) {
     std::vector<uint8_t> header(RELAY_HEADER_SIZE);
-    
-    // Little-endian serialization
-    // Session token (4 bytes)
-    header[0] = static_cast<uint8_t>(session_token & 0xFF);
-    header[1] = static_cast<uint8_t>((session_token >> 8) & 0xFF);
-    header[2] = static_cast<uint8_t>((session_token >> 16) & 0xFF);
-    header[3] = static_cast<uint8_t>((session_token >> 24) & 0xFF);
-    
-    // Payload size (2 bytes)
-    header[4] = static_cast<uint8_t>(payload_size & 0xFF);
-    header[5] = static_cast<uint8_t>((payload_size >> 8) & 0xFF);
-    
-    // Flags (1 byte)
-    header[6] = flags;
-    
-    // Reserved (1 byte) - set to 0
-    header[7] = 0x00;
-    
-    // Sequence number (4 bytes)
-    header[8] = static_cast<uint8_t>(sequence_num & 0xFF);
-    header[9] = static_cast<uint8_t>((sequence_num >> 8) & 0xFF);
-    header[10] = static_cast<uint8_t>((sequence_num >> 16) & 0xFF);
-    header[11] = static_cast<uint8_t>((sequence_num >> 24) & 0xFF);
-    
+    WriteHeader(header, session_token, payload_size, flags, sequence_num);
     return header;
 }
 
+bool RelayProtocol::ParseHeader(std::span<const uint8_t> data, RelayHeaderView& view) const {
+    if (!RelayHeaderLayout::TryDecode(data, view)) {
+        return false;
+    }
+    view.payload = data.subspan(RELAY_HEADER_SIZE);
+    return true;
+}
+
 bool RelayProtocol::DeserializeHeader(const std::vector<uint8_t>& data, uint32_t& session_token,
                                      uint16_t& payload_size, uint8_t& flags, uint32_t& sequence_num) {
-    if (data.size() < RELAY_HEADER_SIZE) {
+    RelayHeaderView view;
+    if (!ParseHeader(data, view)) {
         return false;
     }
     
-    // Little-endian deserialization
-    // Session token (4 bytes)
-    session_token = static_cast<uint32_t>(data[0]) |
-                   (static_cast<uint32_t>(data[1]) << 8) |
-                   (static_cast<uint32_t>(data[2]) << 16) |
-                   (static_cast<uint32_t>(data[3]) << 24);
-    
-    // Payload size (2 bytes)
-    payload_size = static_cast<uint16_t>(data[4]) |
-                  (static_cast<uint16_t>(data[5]) << 8);
+    session_token = view.session_token;
+    payload_size = view.payload_size;
+    flags = view.flags;
+    sequence_num = view.sequence_num;
     
-    // Flags (1 byte)
-    flags = data[6];
-    
-    // Skip reserved byte (data[7])
+    return true;
+}
+
+size_t RelayProtocol::WriteDataMessage(std::span<uint8_t> out, uint32_t session_token,
+                                       std::span<const uint8_t> payload,
+                                       uint32_t sequence_num) const {
+    const size_t payload_size = std::min(payload.size(), static_cast<size_t>(MAX_PAYLOAD_SIZE));
+    if (out.size() < RELAY_HEADER_SIZE + payload_size) {
+        return 0;
+    }
     
-    // Sequence number (4 bytes)
-    sequence_num = static_cast<uint32_t>(data[8]) |
-                  (static_cast<uint32_t>(data[9]) << 8) |
-                  (static_cast<uint32_t>(data[10]) << 16) |
-                  (static_cast<uint32_t>(data[11]) << 24);
+    WriteHeader(out, session_token, static_cast<uint16_t>(payload_size), FLAG_DATA, sequence_num);
+    if (payload_size > 0) {
+        std::memcpy(out.data() + RELAY_HEADER_SIZE, payload.data(), payload_size);
+    }
     
-    return true;
+    return RELAY_HEADER_SIZE + payload_size;
+}
+
+RelayFrame RelayProtocol::FrameDataMessage(uint32_t session_token,
+                                           std::span<const uint8_t> payload,
+                                           uint32_t sequence_num,
+                                           uint8_t extended_flags, uint8_t sender) const {
+    RelayFrame frame;
+    if (sender != NO_NODE_ID) {
+        frame.trailer[0] = sender;
+        frame.trailer_size = SENDER_TRAILER_SIZE;
+        extended_flags |= EXT_FLAG_SENDER;
+    }
+    frame.payload = payload.first(
+        std::min(payload.size(), static_cast<size_t>(MAX_PAYLOAD_SIZE) - frame.trailer_size));
+    WriteHeader(frame.header, session_token,
+                static_cast<uint16_t>(frame.payload.size() + frame.trailer_size), FLAG_DATA,
+                sequence_num, extended_flags);
+    return frame;
+}
+
+RelayFrame RelayProtocol::FrameBundleMessage(uint32_t session_token,
+                                             std::span<const uint8_t> bundle,
+                                             uint32_t first_sequence_num,
+                                             uint8_t extended_flags) const {
+    return FrameDataMessage(session_token, bundle, first_sequence_num,
+                            extended_flags | EXT_FLAG_BUNDLE);
 }
 
 std::vector<uint8_t> RelayProtocol::CreateDataMessage(uint32_t session_token,
                                                      const std::vector<uint8_t>& payload,
                                                      uint32_t sequence_num) {
-    uint16_t payload_size = static_cast<uint16_t>(std::min(payload.size(), static_cast<size_t>(MAX_PAYLOAD_SIZE)));
-    
-    std::vector<uint8_t> header = SerializeHeader(session_token, payload_size, FLAG_DATA, sequence_num);
-    
-    // Combine header and payload
-    std::vector<uint8_t> message;
-    message.reserve(header.size() + payload_size);
-    message.insert(message.end(), header.begin(), header.end());
-    message.insert(message.end(), payload.begin(), payload.begin() + payload_size);
+    // Single allocation sized for the framed message; header is written in place
+    const size_t payload_size = std::min(payload.size(), static_cast<size_t>(MAX_PAYLOAD_SIZE));
+    std::vector<uint8_t> message(RELAY_HEADER_SIZE + payload_size);
+    WriteDataMessage(message, session_token, payload, sequence_num);
     
     return message;
 }
@@ -97,14 +131,63 @@ std::vector<uint8_t> RelayProtocol::CreateControlMessage(uint32_t session_token,
     return SerializeHeader(session_token, 0, control_type, sequence_num);
 }
 
-bool RelayProtocol::ValidateHeader(const std::vector<uint8_t>& header_data) {
+size_t RelayProtocol::WriteKeepalivePayload(std::span<uint8_t> out, uint64_t timestamp_us,
+                                            uint64_t echo_timestamp_us) {
+    if (out.size() < KEEPALIVE_PAYLOAD_SIZE) {
+        return 0;
+    }
+    KeepalivePayload payload{timestamp_us, echo_timestamp_us};
+    KeepaliveLayout::Encode(payload, out.first<KEEPALIVE_PAYLOAD_SIZE>());
+    return KEEPALIVE_PAYLOAD_SIZE;
+}
+
+size_t RelayProtocol::WriteKeepalivePayload(std::span<uint8_t> out, uint64_t timestamp_us,
+                                            uint64_t echo_timestamp_us,
+                                            uint64_t responder_time_us) {
+    if (out.size() < KEEPALIVE_CLOCK_PAYLOAD_SIZE) {
+        return 0;
+    }
+    KeepalivePayload payload{timestamp_us, echo_timestamp_us, responder_time_us};
+    KeepaliveClockLayout::Encode(payload, out.first<KEEPALIVE_CLOCK_PAYLOAD_SIZE>());
+    return KEEPALIVE_CLOCK_PAYLOAD_SIZE;
+}
+
+bool RelayProtocol::ParseKeepalivePayload(std::span<const uint8_t> payload,
+                                          uint64_t& timestamp_us, uint64_t& echo_timestamp_us) {
+    if (payload.size() < KEEPALIVE_PAYLOAD_SIZE) {
+        return false;
+    }
+    KeepalivePayload decoded;
+    KeepaliveLayout::Decode(payload.first<KEEPALIVE_PAYLOAD_SIZE>(), decoded);
+    timestamp_us = decoded.timestamp_us;
+    echo_timestamp_us = decoded.echo_timestamp_us;
+    return true;
+}
+
+bool RelayProtocol::ParseKeepalivePayload(std::span<const uint8_t> payload,
+                                          uint64_t& timestamp_us, uint64_t& echo_timestamp_us,
+                                          uint64_t& responder_time_us) {
+    if (!ParseKeepalivePayload(payload, timestamp_us, echo_timestamp_us)) {
+        return false;
+    }
+    responder_time_us = 0;
+    // Only replies carry the responder's clock; MTU probes are padded with zeros
+    if (echo_timestamp_us != 0 && payload.size() >= KEEPALIVE_CLOCK_PAYLOAD_SIZE) {
+        KeepalivePayload decoded;
+        KeepaliveClockLayout::Decode(payload.first<KEEPALIVE_CLOCK_PAYLOAD_SIZE>(), decoded);
+        responder_time_us = decoded.responder_time_us;
+    }
+    return true;
+}
+
+bool RelayProtocol::ValidateHeader(std::span<const uint8_t> header_data) const {
     if (header_data.size() != RELAY_HEADER_SIZE) {
         return false;
     }
     
     // Extract payload size for basic validation
-    uint16_t payload_size = static_cast<uint16_t>(header_data[4]) |
-                           (static_cast<uint16_t>(header_data[5]) << 8);
+    const uint16_t payload_size = Wire::LoadLittle<uint16_t>(
+        header_data.subspan(offsetof(RelayHeader, payload_size)).first<sizeof(uint16_t)>());
     
     // Check if payload size is within reasonable limits
     if (payload_size > MAX_PAYLOAD_SIZE) {
@@ -114,25 +197,37 @@ bool RelayProtocol::ValidateHeader(const std::vector<uint8_t>& header_data) {
     return true;
 }
 
-bool RelayProtocol::ValidateMessage(const std::vector<uint8_t>& message_data) {
+bool RelayProtocol::ValidateHeader(const std::vector<uint8_t>& header_data) {
+    return ValidateHeader(std::span<const uint8_t>(header_data));
+}
+
+bool RelayProtocol::ValidateMessage(std::span<const uint8_t> message_data,
+                                    RelayHeaderView* view) const {
     if (message_data.size() < RELAY_HEADER_SIZE) {
         return false;
     }
     
-    // Extract header portion
-    std::vector<uint8_t> header(message_data.begin(), message_data.begin() + RELAY_HEADER_SIZE);
-    
-    if (!ValidateHeader(header)) {
+    // Validate the header portion in place
+    if (!ValidateHeader(message_data.first(RELAY_HEADER_SIZE))) {
         return false;
     }
     
-    // Extract payload size from header
-    uint16_t payload_size = static_cast<uint16_t>(header[4]) |
-                           (static_cast<uint16_t>(header[5]) << 8);
+    RelayHeaderView parsed;
+    ParseHeader(message_data, parsed);
     
     // Check if actual message size matches expected size
-    size_t expected_size = RELAY_HEADER_SIZE + payload_size;
-    return message_data.size() == expected_size;
+    if (parsed.payload.size() != parsed.payload_size) {
+        return false;
+    }
+    
+    if (view) {
+        *view = parsed;
+    }
+    return true;
+}
+
+bool RelayProtocol::ValidateMessage(const std::vector<uint8_t>& message_data) {
+    return ValidateMessage(std::span<const uint8_t>(message_data));
 }
 
 size_t RelayProtocol::GetHeaderSize() const {
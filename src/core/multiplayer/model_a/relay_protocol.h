@@ -3,9 +3,13 @@
 
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <span>
 #include <vector>
 #include "relay_types.h"
+#include "core/multiplayer/common/wire_format.h"
 
 namespace Core::Multiplayer::ModelA {
 
@@ -17,12 +21,54 @@ struct RelayHeader {
     uint32_t session_token;  // 4 bytes - unique session ID
     uint16_t payload_size;   // 2 bytes - size of following data
     uint8_t  flags;          // 1 byte  - control flags
-    uint8_t  reserved;       // 1 byte  - future use
+    uint8_t  reserved;       // 1 byte  - extended flags (EXT_FLAG_*)
     uint32_t sequence_num;   // 4 bytes - packet sequencing
 } __attribute__((packed));
 
 static_assert(sizeof(RelayHeader) == 12, "RelayHeader must be exactly 12 bytes");
 
+/**
+ * Scatter-gather view of a framed relay data message.
+ * The header and trailer bytes are stored inline and the payload refers to
+ * caller-owned memory, so framing a packet performs no allocation and no
+ * payload copy. The payload must outlive the frame.
+ */
+struct RelayFrame {
+    std::array<uint8_t, sizeof(RelayHeader)> header{};
+    std::span<const uint8_t> payload;
+    // Sent after the payload and counted in the header's payload size; holds
+    // the sender's node id on EXT_FLAG_SENDER frames
+    std::array<uint8_t, 1> trailer{};
+    size_t trailer_size = 0;
+
+    std::span<const uint8_t> Trailer() const { return std::span(trailer).first(trailer_size); }
+    size_t TotalSize() const { return header.size() + payload.size() + trailer_size; }
+};
+
+/**
+ * Decoded relay header that refers back into the inspected datagram.
+ * Produced by RelayProtocol::ParseHeader without allocating; the payload
+ * span aliases the bytes following the header and is only valid while the
+ * underlying buffer is.
+ */
+struct RelayHeaderView {
+    uint32_t session_token = 0;
+    uint16_t payload_size = 0;
+    uint8_t flags = 0;
+    uint8_t extended_flags = 0;
+    uint32_t sequence_num = 0;
+    std::span<const uint8_t> payload;
+};
+
+#define RELAY_HEADER_FIELD(view_field, header_field)                                               \
+    Wire::Field<&RelayHeaderView::view_field, offsetof(RelayHeader, header_field)>
+using RelayHeaderLayout =
+    Wire::Layout<sizeof(RelayHeader), RELAY_HEADER_FIELD(session_token, session_token),
+                 RELAY_HEADER_FIELD(payload_size, payload_size), RELAY_HEADER_FIELD(flags, flags),
+                 RELAY_HEADER_FIELD(extended_flags, reserved),
+                 RELAY_HEADER_FIELD(sequence_num, sequence_num)>;
+#undef RELAY_HEADER_FIELD
+
 /**
  * RelayProtocol class for handling relay message serialization/deserialization
  */
@@ -35,23 +81,161 @@ public:
     static constexpr uint8_t FLAG_SESSION_CREATE = 0x20;
     static constexpr uint8_t FLAG_SESSION_JOIN = 0x10;
     static constexpr uint8_t FLAG_SESSION_LEAVE = 0x08;
+    // Create and join together: rejoin a session after relay failover,
+    // creating it if this relay does not carry it yet
+    static constexpr uint8_t FLAG_SESSION_RESUME = FLAG_SESSION_CREATE | FLAG_SESSION_JOIN;
+
+    // Extended flags, carried in the header's reserved byte
+    // Payload is a PacketBundle; packet i has sequence sequence_num + i
+    static constexpr uint8_t EXT_FLAG_BUNDLE = 0x01;
+    // Payload is LZ4 compressed (PayloadCompressor), bundle included. On a
+    // session create or join request it offers compression, and on the
+    // relay's answer it accepts the offer for that session.
+    static constexpr uint8_t EXT_FLAG_COMPRESSED = 0x02;
+    // Payload starts with a MULTICAST_HEADER_SIZE destination mask; the relay
+    // forwards the frame, as is, only to the members it selects. Bit n selects
+    // the member that announced LDN node id n in its session request.
+    static constexpr uint8_t EXT_FLAG_MULTICAST = 0x04;
+    // Payload is one fragment of a message larger than the path MTU: a
+    // FRAGMENT_HEADER_SIZE extension (index, count), then its share of the
+    // message. Every fragment carries the message's sequence number and
+    // extended flags, and a multicast mask stays in front of the extension.
+    static constexpr uint8_t EXT_FLAG_FRAGMENT = 0x08;
+    // Payload is a ChannelMultiplexer frame for the receiving client's
+    // channel layer rather than its jitter buffer; never compressed
+    static constexpr uint8_t EXT_FLAG_CHANNEL = 0x10;
+    // On a data frame: the relay also copies it to the session's spectators.
+    // On a join request it subscribes the sender as a spectator, which
+    // receives only these frames and takes no member slot; on a leave it
+    // unsubscribes.
+    static constexpr uint8_t EXT_FLAG_SPECTATE = 0x20;
+    // With EXT_FLAG_SPECTATE: a full state snapshot for late-joining
+    // spectators, which members never see. The relay keeps the latest one per
+    // session and sends it to each new spectator. It carries the sequence
+    // number of the next data frame, so it takes none of its own.
+    static constexpr uint8_t EXT_FLAG_SNAPSHOT = 0x40;
+    // Payload ends with the sending member's LDN node id. Every member
+    // numbers its frames from its own counter, so receivers keep one
+    // sequence per sender; frames without it share the session's.
+    static constexpr uint8_t EXT_FLAG_SENDER = 0x80;
+
+    // Multicast destination mask ahead of the payload
+    static constexpr size_t MULTICAST_HEADER_SIZE = 1;
+    static constexpr uint8_t MULTICAST_ALL_NODES = 0xFF;
+    // A create, join or resume request may carry the member's LDN node id as
+    // a one byte payload; members that sent none have NO_NODE_ID
+    static constexpr uint8_t NO_NODE_ID = 0xFF;
+    static constexpr size_t SENDER_TRAILER_SIZE = 1;
+
+    static constexpr size_t FRAGMENT_HEADER_SIZE = 2;
+    static constexpr size_t MAX_FRAGMENT_COUNT = 64;
+    /**
+     * Datagram sizes, header included, probed for the path MTU, largest
+     * first: the PRD's 1400 byte packet cap, down to 1232, which fits the
+     * IPv6 minimum MTU and so crosses any path unfragmented
+     */
+    static constexpr std::array<size_t, 3> PATH_MTU_CANDIDATES{1400, 1320, 1232};
+
+    /**
+     * Whether a member is among a multicast's destinations. Members without
+     * a node id the mask can address get every multicast, so an unknown
+     * member sees too much rather than missing packets.
+     */
+    static constexpr bool IsMulticastDestination(uint8_t destination_mask, uint8_t node_id) {
+        return node_id >= 8 || ((destination_mask >> node_id) & 1) != 0;
+    }
 
     // Header serialization
+    /**
+     * Writes a little-endian header into a caller-provided buffer.
+     * @return Number of bytes written, or 0 if the buffer is too small
+     */
+    size_t WriteHeader(std::span<uint8_t> out, uint32_t session_token, uint16_t payload_size,
+                       uint8_t flags, uint32_t sequence_num, uint8_t extended_flags = 0) const;
     std::vector<uint8_t> SerializeHeader(uint32_t session_token, uint16_t payload_size, 
                                         uint8_t flags, uint32_t sequence_num);
     bool DeserializeHeader(const std::vector<uint8_t>& data, uint32_t& session_token, 
                           uint16_t& payload_size, uint8_t& flags, uint32_t& sequence_num);
+
+    /**
+     * Parses a header in place from the start of a datagram.
+     * @param data Datagram bytes; anything past the header becomes view.payload
+     * @return False if data is shorter than a header
+     */
+    bool ParseHeader(std::span<const uint8_t> data, RelayHeaderView& view) const;
+    bool ParseHeader(const uint8_t* data, size_t size, RelayHeaderView& view) const {
+        return ParseHeader(std::span<const uint8_t>(data, size), view);
+    }
     
     // Message handling
     std::vector<uint8_t> CreateDataMessage(uint32_t session_token, 
                                           const std::vector<uint8_t>& payload, 
                                           uint32_t sequence_num);
+    /**
+     * Writes a complete data message (header + payload) into a caller-provided
+     * or pooled buffer. Payloads larger than the maximum are truncated exactly
+     * as CreateDataMessage does.
+     * @return Number of bytes written, or 0 if the buffer is too small
+     */
+    size_t WriteDataMessage(std::span<uint8_t> out, uint32_t session_token,
+                            std::span<const uint8_t> payload, uint32_t sequence_num) const;
+    /**
+     * Frames a data message for scatter-gather transmission without touching
+     * the heap. The returned payload span aliases the input. A sender other
+     * than NO_NODE_ID is appended as an EXT_FLAG_SENDER trailer.
+     */
+    RelayFrame FrameDataMessage(uint32_t session_token, std::span<const uint8_t> payload,
+                                uint32_t sequence_num, uint8_t extended_flags = 0,
+                                uint8_t sender = NO_NODE_ID) const;
+    /**
+     * Frames a bundle of coalesced packets as one data message. The bundle
+     * must fit in a single payload; first_sequence_num is the sequence of
+     * its first packet.
+     */
+    RelayFrame FrameBundleMessage(uint32_t session_token, std::span<const uint8_t> bundle,
+                                  uint32_t first_sequence_num, uint8_t extended_flags = 0) const;
     std::vector<uint8_t> CreateControlMessage(uint32_t session_token, uint8_t control_type, 
                                              uint32_t sequence_num);
+
+    /**
+     * Keepalive timestamps for RTT measurement. A request carries the
+     * sender's timestamp and a zero echo; the receiver answers with a
+     * keepalive whose echo is that timestamp and whose own timestamp is
+     * zero, so replies are never answered. Both values are little-endian
+     * microseconds on the requester's clock. Header-only keepalives remain
+     * valid and simply carry no timestamps.
+     *
+     * A reply may append the responder's own clock as it answered, which
+     * turns the exchange into a clock synchronization sample; the field is
+     * 0 when absent, as in replies from older peers and relays.
+     */
+    static constexpr size_t KEEPALIVE_PAYLOAD_SIZE = 16;
+    static constexpr size_t KEEPALIVE_CLOCK_PAYLOAD_SIZE = 24;
+    static size_t WriteKeepalivePayload(std::span<uint8_t> out, uint64_t timestamp_us,
+                                        uint64_t echo_timestamp_us);
+    static size_t WriteKeepalivePayload(std::span<uint8_t> out, uint64_t timestamp_us,
+                                        uint64_t echo_timestamp_us, uint64_t responder_time_us);
+    static bool ParseKeepalivePayload(std::span<const uint8_t> payload, uint64_t& timestamp_us,
+                                      uint64_t& echo_timestamp_us);
+    static bool ParseKeepalivePayload(std::span<const uint8_t> payload, uint64_t& timestamp_us,
+                                      uint64_t& echo_timestamp_us, uint64_t& responder_time_us);
     
     // Validation
     bool ValidateHeader(const std::vector<uint8_t>& header_data);
     bool ValidateMessage(const std::vector<uint8_t>& message_data);
+
+    // Non-allocating validation; the vector overloads forward to these
+    bool ValidateHeader(std::span<const uint8_t> header_data) const;
+    /**
+     * Validates a complete message and, on success, optionally returns the
+     * parsed header so the receive path decodes each datagram only once.
+     */
+    bool ValidateMessage(std::span<const uint8_t> message_data,
+                         RelayHeaderView* view = nullptr) const;
+    bool ValidateMessage(const uint8_t* data, size_t size,
+                         RelayHeaderView* view = nullptr) const {
+        return ValidateMessage(std::span<const uint8_t>(data, size), view);
+    }
     size_t GetHeaderSize() const;
     size_t GetMaxPayloadSize() const;
 };
@@ -0,0 +1,392 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "relay_server_selector.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <random>
+#include <string_view>
+#include <utility>
+
+#ifndef _WIN32
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace Core::Multiplayer::ModelA {
+
+namespace {
+
+#ifndef _WIN32
+// One keepalive probe to one resolved address of a server
+struct PendingProbe {
+    size_t server_index;
+    int socket;
+    uint32_t sequence;
+    std::chrono::steady_clock::time_point sent_at;
+};
+
+// Connected datagram sockets for every resolved address of a server
+std::vector<int> OpenProbeSockets(const DnsResolver::Addresses& addresses) {
+    std::vector<int> sockets;
+    for (const auto& address : addresses) {
+        const auto* native = reinterpret_cast<const sockaddr*>(address.storage.data());
+        const int socket = ::socket(native->sa_family, SOCK_DGRAM, 0);
+        if (socket < 0) {
+            continue;
+        }
+        if (::connect(socket, native, address.length) != 0) {
+            ::close(socket);
+            continue;
+        }
+        sockets.push_back(socket);
+    }
+    return sockets;
+}
+#endif
+
+} // namespace
+
+RelayServerSelector::RelayServerSelector(std::vector<std::string> servers,
+                                         const RelayServerSelectorConfig& config,
+                                         std::shared_ptr<DnsResolver> resolver)
+    : servers_(std::move(servers)), config_(config),
+      resolver_(resolver ? std::move(resolver) : DnsResolver::GetShared()) {
+    // The first probe round then finds every host already resolved
+    PrefetchHosts();
+}
+
+std::vector<std::string> RelayServerSelector::GetAvailableServers() const {
+    return servers_;
+}
+
+std::string RelayServerSelector::SelectBestServer() {
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        if (IsCacheFreshLocked(Clock::now())) {
+            ++stats_.cache_hits;
+            return SelectCachedLocked();
+        }
+    }
+
+    std::lock_guard<std::mutex> probe_lock(probe_mutex_);
+    {
+        // Another caller may have finished a round while this one waited
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        if (IsCacheFreshLocked(Clock::now())) {
+            ++stats_.cache_hits;
+            return SelectCachedLocked();
+        }
+    }
+    RunProbeRound();
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    return SelectCachedLocked();
+}
+
+std::vector<RelayServerProbeResult> RelayServerSelector::ProbeServers() {
+    std::lock_guard<std::mutex> probe_lock(probe_mutex_);
+    return RunProbeRound();
+}
+
+std::optional<std::chrono::microseconds> RelayServerSelector::GetServerLatency(
+    const std::string& server) const {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    const auto it = std::find_if(results_.begin(), results_.end(),
+                                 [&](const auto& result) { return result.server == server; });
+    return it != results_.end() ? it->rtt : std::nullopt;
+}
+
+bool RelayServerSelector::IsServerHealthy(const std::string& server) const {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    if (unhealthy_.count(server) != 0) {
+        return false;
+    }
+    const auto it = std::find_if(results_.begin(), results_.end(),
+                                 [&](const auto& result) { return result.server == server; });
+    // Servers not probed yet get the benefit of the doubt
+    return it == results_.end() || it->rtt.has_value();
+}
+
+void RelayServerSelector::MarkServerUnhealthy(const std::string& server) {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    unhealthy_.insert(server);
+}
+
+std::string RelayServerSelector::GetNextAvailableServer(const std::string& failed_server) {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    unhealthy_.insert(failed_server);
+    return SelectCachedLocked();
+}
+
+std::vector<std::string> RelayServerSelector::GetFailoverOrder(uint32_t session_token,
+                                                               const std::string& failed_server) {
+    auto order = RankForSession(servers_, session_token);
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    unhealthy_.insert(failed_server);
+    std::erase_if(order, [this](const auto& server) { return unhealthy_.count(server) != 0; });
+    return order;
+}
+
+std::vector<std::string> RelayServerSelector::RankForSession(std::vector<std::string> servers,
+                                                             uint32_t session_token) {
+    // FNV-1a over the token and the server name, then a final mix so that
+    // servers with similar names still spread out
+    const auto score = [session_token](const std::string& server) {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        const auto mix = [&hash](uint8_t byte) {
+            hash ^= byte;
+            hash *= 0x100000001b3ULL;
+        };
+        for (int shift = 0; shift < 32; shift += 8) {
+            mix(static_cast<uint8_t>(session_token >> shift));
+        }
+        for (const char c : server) {
+            mix(static_cast<uint8_t>(c));
+        }
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 33;
+        return hash;
+    };
+    std::vector<std::pair<uint64_t, std::string>> scored;
+    scored.reserve(servers.size());
+    for (auto& server : servers) {
+        scored.emplace_back(score(server), std::move(server));
+    }
+    std::sort(scored.begin(), scored.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.first != rhs.first ? lhs.first > rhs.first : lhs.second < rhs.second;
+    });
+    servers.clear();
+    for (auto& [hash, server] : scored) {
+        servers.push_back(std::move(server));
+    }
+    return servers;
+}
+
+void RelayServerSelector::RefreshServerList() {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    probed_at_.reset();
+}
+
+std::vector<RelayServerProbeResult> RelayServerSelector::GetProbeResults() const {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    return results_;
+}
+
+void RelayServerSelector::SeedProbeResults(std::vector<RelayServerProbeResult> results) {
+    // Servers no longer configured are dropped
+    std::erase_if(results, [this](const auto& result) {
+        return std::find(servers_.begin(), servers_.end(), result.server) == servers_.end();
+    });
+    SortByRtt(results);
+
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    results_ = std::move(results);
+    probed_at_ = Clock::now();
+}
+
+void RelayServerSelector::SortByRtt(std::vector<RelayServerProbeResult>& results) {
+    // Fastest first; unreachable servers keep their configured order at the end
+    std::stable_sort(results.begin(), results.end(), [](const auto& lhs, const auto& rhs) {
+        if (lhs.rtt && rhs.rtt) {
+            return *lhs.rtt < *rhs.rtt;
+        }
+        return lhs.rtt.has_value() && !rhs.rtt.has_value();
+    });
+}
+
+RelayServerSelectorStatistics RelayServerSelector::GetStatistics() const {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    return stats_;
+}
+
+bool RelayServerSelector::ParseEndpoint(const std::string& server, uint16_t default_port,
+                                        std::string& out_host, uint16_t& out_port) {
+    std::string_view port_text;
+    if (!server.empty() && server.front() == '[') {
+        const size_t close = server.find(']');
+        if (close == std::string::npos) {
+            return false;
+        }
+        out_host = server.substr(1, close - 1);
+        if (close + 1 < server.size()) {
+            if (server[close + 1] != ':') {
+                return false;
+            }
+            port_text = std::string_view(server).substr(close + 2);
+        }
+    } else {
+        const size_t colon = server.rfind(':');
+        // A bare IPv6 address has several colons and no port
+        if (colon != std::string::npos && server.find(':') == colon) {
+            out_host = server.substr(0, colon);
+            port_text = std::string_view(server).substr(colon + 1);
+        } else {
+            out_host = server;
+        }
+    }
+
+    if (out_host.empty()) {
+        return false;
+    }
+    if (port_text.empty()) {
+        out_port = default_port;
+        return true;
+    }
+    uint16_t port = 0;
+    const auto [end, error] =
+        std::from_chars(port_text.data(), port_text.data() + port_text.size(), port);
+    if (error != std::errc{} || end != port_text.data() + port_text.size() || port == 0) {
+        return false;
+    }
+    out_port = port;
+    return true;
+}
+
+void RelayServerSelector::PrefetchHosts() {
+    for (const auto& server : servers_) {
+        std::string host;
+        uint16_t port = 0;
+        if (ParseEndpoint(server, config_.default_port, host, port)) {
+            resolver_->Prefetch(host);
+        }
+    }
+}
+
+std::vector<RelayServerProbeResult> RelayServerSelector::RunProbeRound() {
+    std::vector<RelayServerProbeResult> results(servers_.size());
+    for (size_t i = 0; i < servers_.size(); ++i) {
+        results[i].server = servers_[i];
+    }
+    uint64_t probes_sent = 0;
+    uint64_t probes_answered = 0;
+
+#ifndef _WIN32
+    // A random base keeps stale echoes from an earlier round from matching
+    const uint32_t sequence_base = std::random_device{}();
+    std::vector<PendingProbe> probes;
+    // Hosts not yet cached are looked up in parallel rather than one by one
+    PrefetchHosts();
+    for (size_t i = 0; i < servers_.size(); ++i) {
+        std::string host;
+        uint16_t port = 0;
+        if (!ParseEndpoint(servers_[i], config_.default_port, host, port)) {
+            continue;
+        }
+        for (const int socket : OpenProbeSockets(resolver_->Resolve(host, port))) {
+            probes.push_back({i, socket, sequence_base + static_cast<uint32_t>(probes.size()), {}});
+        }
+    }
+
+    // Everything is resolved and bound first so the probes leave back to back
+    std::array<uint8_t, sizeof(RelayHeader)> keepalive{};
+    for (auto& probe : probes) {
+        protocol_.WriteHeader(keepalive, 0, 0, RelayProtocol::FLAG_KEEPALIVE, probe.sequence);
+        probe.sent_at = Clock::now();
+        if (::send(probe.socket, keepalive.data(), keepalive.size(), MSG_DONTWAIT) ==
+            static_cast<ssize_t>(keepalive.size())) {
+            ++probes_sent;
+        }
+    }
+
+    const auto deadline = Clock::now() + config_.probe_deadline;
+    auto stop_at = deadline;
+    std::vector<pollfd> descriptors;
+    std::array<uint8_t, sizeof(RelayHeader) + 64> reply{};
+
+    while (!probes.empty()) {
+        const auto now = Clock::now();
+        if (now >= stop_at) {
+            break;
+        }
+        descriptors.clear();
+        for (const auto& probe : probes) {
+            descriptors.push_back({probe.socket, POLLIN, 0});
+        }
+        const auto wait = std::chrono::ceil<std::chrono::milliseconds>(stop_at - now);
+        if (::poll(descriptors.data(), descriptors.size(), static_cast<int>(wait.count())) <= 0) {
+            continue;
+        }
+        const auto received_at = Clock::now();
+
+        for (size_t i = 0; i < descriptors.size(); ++i) {
+            if ((descriptors[i].revents & POLLIN) == 0) {
+                continue;
+            }
+            const auto& probe = probes[i];
+            const ssize_t size =
+                ::recv(probe.socket, reply.data(), reply.size(), MSG_DONTWAIT);
+            RelayHeaderView header;
+            if (size <= 0 ||
+                !protocol_.ParseHeader(reply.data(), static_cast<size_t>(size), header) ||
+                (header.flags & RelayProtocol::FLAG_KEEPALIVE) == 0 ||
+                header.sequence_num != probe.sequence) {
+                continue;
+            }
+
+            auto& result = results[probe.server_index];
+            if (!result.rtt) {
+                result.rtt = std::chrono::duration_cast<std::chrono::microseconds>(
+                    received_at - probe.sent_at);
+                ++probes_answered;
+                if (stop_at == deadline) {
+                    stop_at = std::min(deadline, received_at + config_.settle_time);
+                }
+            }
+        }
+
+        // A server's other addresses are not needed once one has answered
+        const auto answered = std::remove_if(probes.begin(), probes.end(), [&](const auto& probe) {
+            if (!results[probe.server_index].rtt) {
+                return false;
+            }
+            ::close(probe.socket);
+            return true;
+        });
+        probes.erase(answered, probes.end());
+    }
+
+    for (const auto& probe : probes) {
+        ::close(probe.socket);
+    }
+#endif
+
+    SortByRtt(results);
+
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    results_ = results;
+    probed_at_ = Clock::now();
+    for (const auto& result : results_) {
+        if (result.rtt) {
+            unhealthy_.erase(result.server);
+        }
+    }
+    ++stats_.probe_rounds;
+    stats_.probes_sent += probes_sent;
+    stats_.probes_answered += probes_answered;
+    return results;
+}
+
+std::string RelayServerSelector::SelectCachedLocked() const {
+    for (const auto& result : results_) {
+        if (result.rtt && unhealthy_.count(result.server) == 0) {
+            return result.server;
+        }
+    }
+    // Nothing answered; an unprobed attempt beats giving up
+    for (const auto& server : servers_) {
+        if (unhealthy_.count(server) == 0) {
+            return server;
+        }
+    }
+    return {};
+}
+
+bool RelayServerSelector::IsCacheFreshLocked(Clock::time_point now) const {
+    return probed_at_ && now - *probed_at_ < config_.cache_ttl;
+}
+
+} // namespace Core::Multiplayer::ModelA
@@ -0,0 +1,159 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "core/multiplayer/common/dns_resolver.h"
+#include "relay_protocol.h"
+
+namespace Core::Multiplayer::ModelA {
+
+/**
+ * Relay server selection tuning
+ */
+struct RelayServerSelectorConfig {
+    // Longest a probe round may take; servers silent by then are unreachable
+    std::chrono::milliseconds probe_deadline{500};
+    // How long to keep listening after the first answer to rank the others
+    std::chrono::milliseconds settle_time{20};
+    // How long a probe round's results are reused before probing again
+    std::chrono::seconds cache_ttl{300};
+    // Port used for servers configured without one
+    uint16_t default_port = 8443;
+};
+
+struct RelayServerProbeResult {
+    std::string server;
+    // Unset if the server did not answer before the deadline
+    std::optional<std::chrono::microseconds> rtt;
+};
+
+struct RelayServerSelectorStatistics {
+    uint64_t probe_rounds = 0;
+    uint64_t probes_sent = 0;
+    uint64_t probes_answered = 0;
+    uint64_t cache_hits = 0;
+};
+
+/**
+ * Picks the relay server with the lowest round-trip time
+ *
+ * A probe round sends one header-only FLAG_KEEPALIVE frame to every address
+ * of every configured server at once, IPv6 and IPv4 alike, and times the
+ * echoed keepalive. Because all probes leave together, the first answer is
+ * from the fastest server, so the round ends shortly after it instead of
+ * waiting out the slowest region; the settle time lets close runners-up be
+ * ranked for failover.
+ *
+ * Results are cached for cache_ttl so later sessions connect without
+ * probing. Servers are given as "host", "host:port" or "[ipv6]:port".
+ * Host names go through the resolver, which starts looking them all up at
+ * construction.
+ */
+class RelayServerSelector {
+public:
+    // Without a resolver, the process-wide DnsResolver is used
+    explicit RelayServerSelector(std::vector<std::string> servers,
+                                 const RelayServerSelectorConfig& config = RelayServerSelectorConfig{},
+                                 std::shared_ptr<DnsResolver> resolver = nullptr);
+
+    RelayServerSelector(const RelayServerSelector&) = delete;
+    RelayServerSelector& operator=(const RelayServerSelector&) = delete;
+
+    std::vector<std::string> GetAvailableServers() const;
+
+    /**
+     * Returns the lowest-RTT healthy server, probing first if the cached
+     * results have expired. If no server answers, the first configured
+     * healthy server is returned so the caller can still attempt it; empty
+     * only when every server is marked unhealthy.
+     */
+    std::string SelectBestServer();
+
+    // Runs a probe round now and replaces the cached results
+    std::vector<RelayServerProbeResult> ProbeServers();
+
+    // Cached RTT from the last probe round
+    std::optional<std::chrono::microseconds> GetServerLatency(const std::string& server) const;
+    bool IsServerHealthy(const std::string& server) const;
+
+    // Excludes a server until it answers a later probe round
+    void MarkServerUnhealthy(const std::string& server);
+
+    /**
+     * Failover: marks failed_server unhealthy and returns the next-best
+     * server by cached RTT, or empty if none is left
+     */
+    std::string GetNextAvailableServer(const std::string& failed_server);
+
+    /**
+     * Alternate relays for a session whose relay failed, best first: the
+     * configured servers other than failed_server, skipping unhealthy ones,
+     * in RankForSession order. Marks failed_server unhealthy.
+     */
+    std::vector<std::string> GetFailoverOrder(uint32_t session_token,
+                                              const std::string& failed_server);
+
+    /**
+     * Orders servers by rendezvous hash of the session token and server.
+     * Every peer of a session computes the same order without coordination,
+     * so after a relay failure they all converge on the same alternate,
+     * and losing one server only moves the sessions that were on it.
+     */
+    static std::vector<std::string> RankForSession(std::vector<std::string> servers,
+                                                   uint32_t session_token);
+
+    // Drops the cached results so the next selection probes again
+    void RefreshServerList();
+
+    // Results of the last probe round, fastest first, for persisting
+    std::vector<RelayServerProbeResult> GetProbeResults() const;
+
+    /**
+     * Adopts results persisted from an earlier session as a fresh probe
+     * round, so selection needs no probing until they age out or
+     * ProbeServers revalidates them
+     */
+    void SeedProbeResults(std::vector<RelayServerProbeResult> results);
+
+    RelayServerSelectorStatistics GetStatistics() const;
+
+    // Splits an endpoint into host and port; false if it is malformed
+    static bool ParseEndpoint(const std::string& server, uint16_t default_port,
+                              std::string& out_host, uint16_t& out_port);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void PrefetchHosts();
+    std::vector<RelayServerProbeResult> RunProbeRound();
+    static void SortByRtt(std::vector<RelayServerProbeResult>& results);
+    std::string SelectCachedLocked() const;
+    bool IsCacheFreshLocked(Clock::time_point now) const;
+
+    const std::vector<std::string> servers_;
+    const RelayServerSelectorConfig config_;
+    const std::shared_ptr<DnsResolver> resolver_;
+    RelayProtocol protocol_;
+
+    // Serializes probe rounds so concurrent selections share one round
+    std::mutex probe_mutex_;
+
+    mutable std::mutex cache_mutex_;
+    // Sorted by RTT, unreachable servers last
+    std::vector<RelayServerProbeResult> results_;
+    std::optional<Clock::time_point> probed_at_;
+    std::unordered_set<std::string> unhealthy_;
+    RelayServerSelectorStatistics stats_;
+};
+
+} // namespace Core::Multiplayer::ModelA
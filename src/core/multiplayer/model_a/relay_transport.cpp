@@ -0,0 +1,289 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "relay_transport.h"
+#include "core/multiplayer/common/thread_policy.h"
+
+#include <utility>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace Core::Multiplayer::ModelA {
+
+namespace {
+// How often the receive thread rechecks for shutdown
+constexpr int RECEIVE_POLL_TIMEOUT_MS = 20;
+
+#ifndef _WIN32
+// Send errors meaning the local address is gone rather than the network lossy
+bool IsAddressLost(int error) {
+    return error == ENETUNREACH || error == ENETDOWN || error == EADDRNOTAVAIL ||
+           error == EHOSTUNREACH;
+}
+#endif
+} // namespace
+
+UdpRelayTransport::UdpRelayTransport(SocketTuningProfile tuning,
+                                     std::shared_ptr<DnsResolver> resolver)
+    : resolver_(resolver ? std::move(resolver) : DnsResolver::GetShared()), tuning_(tuning),
+      send_buffer_(tuning.adapt_send_buffer ? tuning.send_buffer_size : 0),
+      send_buffer_size_(tuning.send_buffer_size) {}
+
+UdpRelayTransport::~UdpRelayTransport() {
+    Close();
+}
+
+bool UdpRelayTransport::Open(const std::string& host, uint16_t port) {
+#ifdef _WIN32
+    // No Winsock implementation yet; RelayClient keeps the stream transport
+    (void)host;
+    (void)port;
+    return false;
+#else
+    Close();
+
+    {
+        std::unique_lock lock(socket_mutex_);
+        host_ = host;
+        port_ = port;
+        const int socket = ConnectSocket();
+        if (socket < 0) {
+            return false;
+        }
+        socket_.store(socket);
+    }
+
+    stop_requested_ = false;
+    receive_thread_ = SpawnThread(ThreadRole::NetworkIo, "mp-relay-rx", [this]() { ReceiveLoop(); });
+    return true;
+#endif
+}
+
+void UdpRelayTransport::Close() {
+    stop_requested_ = true;
+    if (receive_thread_.joinable()) {
+        receive_thread_.join();
+    }
+
+#ifndef _WIN32
+    std::unique_lock lock(socket_mutex_);
+    for (auto* slot : {&socket_, &retired_socket_}) {
+        const int socket = slot->exchange(-1);
+        if (socket >= 0) {
+            ::close(socket);
+        }
+    }
+#endif
+}
+
+bool UdpRelayTransport::SendFrame(const RelayFrame& frame) {
+#ifdef _WIN32
+    (void)frame;
+    return false;
+#else
+    // Header, payload and trailer go out as one datagram without being copied together
+    iovec segments[3];
+    size_t segment_count = 0;
+    segments[segment_count++] = {const_cast<uint8_t*>(frame.header.data()), frame.header.size()};
+    if (!frame.payload.empty()) {
+        segments[segment_count++] = {const_cast<uint8_t*>(frame.payload.data()),
+                                     frame.payload.size()};
+    }
+    if (frame.trailer_size != 0) {
+        segments[segment_count++] = {const_cast<uint8_t*>(frame.trailer.data()),
+                                     frame.trailer_size};
+    }
+
+    msghdr message{};
+    message.msg_iov = segments;
+    message.msg_iovlen = segment_count;
+
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        int error = 0;
+        {
+            std::shared_lock lock(socket_mutex_);
+            const int socket = socket_.load();
+            if (socket < 0) {
+                return false;
+            }
+            if (::sendmsg(socket, &message, MSG_DONTWAIT) >= 0) {
+                datagrams_sent_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+            error = errno;
+        }
+
+        send_errors_.fetch_add(1, std::memory_order_relaxed);
+        if (attempt != 0 || !IsAddressLost(error) || !Migrate()) {
+            return false;
+        }
+    }
+    return false;
+#endif
+}
+
+void UdpRelayTransport::SetOnDatagramReceived(DatagramCallback callback) {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    on_datagram_ = std::move(callback);
+}
+
+bool UdpRelayTransport::Migrate() {
+#ifdef _WIN32
+    return false;
+#else
+    std::unique_lock lock(socket_mutex_);
+    // Re-resolving picks up answers and routing for whichever network is now
+    // active, e.g. NAT64 addresses on an IPv6-only mobile network
+    resolver_->Invalidate(host_);
+    if (!ReplaceSocketLocked()) {
+        return false;
+    }
+    migrations_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+#endif
+}
+
+bool UdpRelayTransport::Redirect(const std::string& host, uint16_t port) {
+#ifdef _WIN32
+    (void)host;
+    (void)port;
+    return false;
+#else
+    std::unique_lock lock(socket_mutex_);
+    std::string previous_host = std::exchange(host_, host);
+    const uint16_t previous_port = std::exchange(port_, port);
+    if (!ReplaceSocketLocked()) {
+        host_ = std::move(previous_host);
+        port_ = previous_port;
+        return false;
+    }
+    return true;
+#endif
+}
+
+bool UdpRelayTransport::ReplaceSocketLocked() {
+#ifdef _WIN32
+    return false;
+#else
+    // At most one replacement per receive poll, so the poll never sees a closed socket
+    if (socket_.load() < 0 || retired_socket_.load() >= 0) {
+        return false;
+    }
+    const int socket = ConnectSocket();
+    if (socket < 0) {
+        return false;
+    }
+    retired_socket_.store(socket_.exchange(socket));
+    return true;
+#endif
+}
+
+void UdpRelayTransport::OnQueuingDelay(std::chrono::microseconds queuing_delay) {
+    std::lock_guard lock(send_buffer_mutex_);
+    const auto size = send_buffer_.OnQueuingDelay(queuing_delay);
+    if (!size) {
+        return;
+    }
+    send_buffer_size_.store(*size, std::memory_order_relaxed);
+#ifndef _WIN32
+    std::shared_lock socket_lock(socket_mutex_);
+    const int socket = socket_.load();
+    if (socket >= 0) {
+        SetSocketSendBufferSize(socket, *size);
+    }
+#endif
+}
+
+uint16_t UdpRelayTransport::GetLocalPort() const {
+#ifdef _WIN32
+    return 0;
+#else
+    std::shared_lock lock(socket_mutex_);
+    const int socket = socket_.load();
+    if (socket < 0) {
+        return 0;
+    }
+    sockaddr_storage address{};
+    socklen_t length = sizeof(address);
+    if (::getsockname(socket, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        return 0;
+    }
+    if (address.ss_family == AF_INET6) {
+        return ntohs(reinterpret_cast<const sockaddr_in6*>(&address)->sin6_port);
+    }
+    return ntohs(reinterpret_cast<const sockaddr_in*>(&address)->sin_port);
+#endif
+}
+
+UdpRelayTransportStatistics UdpRelayTransport::GetStatistics() const {
+    UdpRelayTransportStatistics stats;
+    stats.datagrams_sent = datagrams_sent_.load(std::memory_order_relaxed);
+    stats.datagrams_received = datagrams_received_.load(std::memory_order_relaxed);
+    stats.send_errors = send_errors_.load(std::memory_order_relaxed);
+    stats.migrations = migrations_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+int UdpRelayTransport::ConnectSocket() const {
+#ifdef _WIN32
+    return -1;
+#else
+    // Addresses come in Happy Eyeballs order, IPv6 and IPv4 alternating
+    for (const auto& address : resolver_->Resolve(host_, port_)) {
+        const auto* native = reinterpret_cast<const sockaddr*>(address.storage.data());
+        const int socket = ::socket(native->sa_family, SOCK_DGRAM, 0);
+        if (socket < 0) {
+            continue;
+        }
+        // Connected, so the kernel filters out datagrams from anyone else
+        if (::connect(socket, native, address.length) == 0) {
+            SocketTuningProfile tuning = tuning_;
+            tuning.send_buffer_size = send_buffer_size_.load(std::memory_order_relaxed);
+            ApplySocketTuning(socket, tuning);
+            return socket;
+        }
+        ::close(socket);
+    }
+    return -1;
+#endif
+}
+
+void UdpRelayTransport::ReceiveLoop() {
+#ifndef _WIN32
+    while (!stop_requested_) {
+        const int retired = retired_socket_.exchange(-1);
+        if (retired >= 0) {
+            ::close(retired);
+        }
+
+        pollfd descriptor{socket_.load(), POLLIN, 0};
+        if (descriptor.fd < 0) {
+            return;
+        }
+        ssize_t received = -1;
+        if (::poll(&descriptor, 1, RECEIVE_POLL_TIMEOUT_MS) > 0 && (descriptor.revents & POLLIN)) {
+            received = ::recv(descriptor.fd, receive_buffer_.data(), receive_buffer_.size(),
+                              MSG_DONTWAIT);
+        }
+        if (received <= 0) {
+            continue;
+        }
+
+        datagrams_received_.fetch_add(1, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(callback_mutex_);
+        if (on_datagram_) {
+            on_datagram_(std::span<const uint8_t>(receive_buffer_.data(),
+                                                  static_cast<size_t>(received)));
+        }
+    }
+#endif
+}
+
+} // namespace Core::Multiplayer::ModelA
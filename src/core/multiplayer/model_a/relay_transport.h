@@ -0,0 +1,147 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <thread>
+
+#include "core/multiplayer/common/dns_resolver.h"
+#include "core/multiplayer/common/socket_tuning.h"
+#include "relay_protocol.h"
+
+namespace Core::Multiplayer::ModelA {
+
+/**
+ * Transport that carries framed relay messages to and from the relay server
+ */
+class IRelayTransport {
+public:
+    using DatagramCallback = std::function<void(std::span<const uint8_t> datagram)>;
+
+    virtual ~IRelayTransport() = default;
+
+    virtual bool Open(const std::string& host, uint16_t port) = 0;
+    virtual void Close() = 0;
+    virtual bool IsOpen() const = 0;
+
+    // Sends one framed message as a single datagram
+    virtual bool SendFrame(const RelayFrame& frame) = 0;
+
+    // Called on the transport's receive thread with each framed message
+    virtual void SetOnDatagramReceived(DatagramCallback callback) = 0;
+
+    /**
+     * Moves the transport onto a new local endpoint after a network change,
+     * keeping the relay session. The relay server identifies sessions by
+     * session token rather than by address, so the next frame from the new
+     * endpoint continues the session.
+     */
+    virtual bool Migrate() = 0;
+
+    /**
+     * Points an open transport at another relay server, e.g. on failover.
+     * The default reopens; implementations may keep their receive thread.
+     */
+    virtual bool Redirect(const std::string& host, uint16_t port) {
+        Close();
+        return Open(host, port);
+    }
+
+    // Queuing delay the congestion controller measured, for transports that
+    // size their socket buffers from it
+    virtual void OnQueuingDelay(std::chrono::microseconds /*queuing_delay*/) {}
+};
+
+struct UdpRelayTransportStatistics {
+    uint64_t datagrams_sent = 0;
+    uint64_t datagrams_received = 0;
+    uint64_t send_errors = 0;
+    uint64_t migrations = 0;
+};
+
+/**
+ * UDP transport for relay messages
+ *
+ * Each frame is one datagram written with a scatter-gather send of the
+ * 12-byte header and the payload, so a lost datagram only loses that game
+ * packet instead of stalling every later one behind a TCP retransmit.
+ *
+ * A send failing because the local address went away (Wi-Fi to mobile
+ * handover, DHCP renewal) triggers a migration onto a freshly bound socket.
+ *
+ * Every socket gets the tuning profile, with the send buffer at whatever
+ * size OnQueuingDelay last adapted it to. Host names are resolved through
+ * the DnsResolver cache, so a redirect to a prefetched relay does not wait
+ * on a lookup.
+ */
+class UdpRelayTransport final : public IRelayTransport {
+public:
+    // Without a resolver, the process-wide DnsResolver is used
+    explicit UdpRelayTransport(SocketTuningProfile tuning = SocketTuningProfile::Realtime(),
+                               std::shared_ptr<DnsResolver> resolver = nullptr);
+    ~UdpRelayTransport() override;
+
+    UdpRelayTransport(const UdpRelayTransport&) = delete;
+    UdpRelayTransport& operator=(const UdpRelayTransport&) = delete;
+
+    bool Open(const std::string& host, uint16_t port) override;
+    void Close() override;
+    bool IsOpen() const override { return socket_.load() >= 0; }
+    bool SendFrame(const RelayFrame& frame) override;
+    void SetOnDatagramReceived(DatagramCallback callback) override;
+    bool Migrate() override;
+    // Swaps sockets like Migrate, so it is safe from the receive callback
+    bool Redirect(const std::string& host, uint16_t port) override;
+    void OnQueuingDelay(std::chrono::microseconds queuing_delay) override;
+
+    // Local port of the current socket, or 0 when closed
+    uint16_t GetLocalPort() const;
+    UdpRelayTransportStatistics GetStatistics() const;
+
+private:
+    static constexpr size_t MAX_DATAGRAM_SIZE = 65535 + sizeof(RelayHeader);
+
+    int ConnectSocket() const;
+    bool ReplaceSocketLocked();
+    void ReceiveLoop();
+
+    const std::shared_ptr<DnsResolver> resolver_;
+    std::string host_;
+    uint16_t port_ = 0;
+
+    const SocketTuningProfile tuning_;
+    std::mutex send_buffer_mutex_;
+    AdaptiveSendBuffer send_buffer_;
+    // Current adapted size, for sockets created on migration
+    std::atomic<size_t> send_buffer_size_;
+
+    // Shared while sending, exclusive while the socket is replaced
+    mutable std::shared_mutex socket_mutex_;
+    std::atomic<int> socket_{-1};
+    // Replaced by Migrate; closed by the receive thread once it stops polling it
+    std::atomic<int> retired_socket_{-1};
+
+    std::mutex callback_mutex_;
+    DatagramCallback on_datagram_;
+
+    std::atomic<bool> stop_requested_{false};
+    std::thread receive_thread_;
+    std::array<uint8_t, MAX_DATAGRAM_SIZE> receive_buffer_{};
+
+    std::atomic<uint64_t> datagrams_sent_{0};
+    std::atomic<uint64_t> datagrams_received_{0};
+    std::atomic<uint64_t> send_errors_{0};
+    std::atomic<uint64_t> migrations_{0};
+};
+
+} // namespace Core::Multiplayer::ModelA
@@ -26,7 +26,14 @@ struct ConnectionMetrics {
     ConnectionType connection_type;
     uint64_t bytes_sent;
     uint64_t bytes_received;
-    std::chrono::milliseconds latency;
+    std::chrono::milliseconds latency;   // Smoothed round-trip time
+    std::chrono::milliseconds jitter;    // Round-trip time variation
+    double compression_ratio;            // Data bytes before compression per byte after
+    uint64_t bottleneck_bandwidth;       // Bytes/s; 0 until estimated
+    uint64_t available_bandwidth;        // Bytes/s; 0 until estimated
+    std::chrono::microseconds one_way_latency; // Outbound share of latency; 0 until clocks sync
+    std::chrono::microseconds clock_offset;    // Remote clock minus ours
+    float clock_confidence;                    // 0..1, see ClockSyncSnapshot
 };
 
 /**
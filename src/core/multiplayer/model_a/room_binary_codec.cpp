@@ -0,0 +1,1289 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "room_binary_codec.h"
+
+namespace Core::Multiplayer::ModelA {
+
+namespace {
+
+// Field tags. These values are part of the wire format and must never be reused.
+namespace HeartbeatTag {
+constexpr uint8_t Timestamp = 1;
+}
+
+namespace NetworkInfoTag {
+constexpr uint8_t LocalIp = 1;
+constexpr uint8_t PublicIp = 2;
+constexpr uint8_t Port = 3;
+}
+
+namespace ClientInfoTag {
+constexpr uint8_t Username = 1;
+constexpr uint8_t Platform = 2;
+constexpr uint8_t Network = 3;
+}
+
+namespace PlayerInfoTag {
+constexpr uint8_t Id = 1;
+constexpr uint8_t Username = 2;
+constexpr uint8_t IsHost = 3;
+constexpr uint8_t Network = 4;
+}
+
+namespace RoomSummaryTag {
+constexpr uint8_t Id = 1;
+constexpr uint8_t GameName = 2;
+constexpr uint8_t HostName = 3;
+constexpr uint8_t CurrentPlayers = 4;
+constexpr uint8_t MaxPlayers = 5;
+constexpr uint8_t Ping = 6;
+constexpr uint8_t Region = 7;
+constexpr uint8_t GameId = 8;
+}
+
+namespace RoomInfoTag {
+constexpr uint8_t Id = 1;
+constexpr uint8_t GameId = 2;
+constexpr uint8_t GameName = 3;
+constexpr uint8_t HostId = 4;
+constexpr uint8_t HostName = 5;
+constexpr uint8_t MaxPlayers = 6;
+constexpr uint8_t CurrentPlayers = 7;
+constexpr uint8_t IsPrivate = 8;
+constexpr uint8_t CreatedAt = 9;
+constexpr uint8_t Description = 10;
+}
+
+namespace IceCandidateTag {
+constexpr uint8_t Candidate = 1;
+constexpr uint8_t SdpMid = 2;
+constexpr uint8_t SdpMlineIndex = 3;
+}
+
+namespace SessionDescriptionTag {
+constexpr uint8_t Type = 1;
+constexpr uint8_t Sdp = 2;
+}
+
+namespace DetailTag {
+constexpr uint8_t Key = 1;
+constexpr uint8_t Value = 2;
+}
+
+namespace RegisterTag {
+constexpr uint8_t ClientId = 1;
+constexpr uint8_t Username = 2;
+constexpr uint8_t Platform = 3;
+constexpr uint8_t SudachiVersion = 4;
+constexpr uint8_t RequestId = 5;
+}
+
+namespace CreateRoomTag {
+constexpr uint8_t GameId = 1;
+constexpr uint8_t GameName = 2;
+constexpr uint8_t MaxPlayers = 3;
+constexpr uint8_t IsPrivate = 4;
+constexpr uint8_t Password = 5;
+constexpr uint8_t Description = 6;
+constexpr uint8_t RequestId = 7;
+}
+
+namespace RoomListRequestTag {
+constexpr uint8_t GameId = 1;
+constexpr uint8_t Region = 2;
+constexpr uint8_t MaxResults = 3;
+constexpr uint8_t Offset = 4;
+constexpr uint8_t IncludePrivate = 5;
+constexpr uint8_t IncludeFull = 6;
+constexpr uint8_t Cursor = 7;
+constexpr uint8_t RequestId = 8;
+}
+
+namespace JoinRoomTag {
+constexpr uint8_t RoomId = 1;
+constexpr uint8_t Password = 2;
+constexpr uint8_t Client = 3;
+constexpr uint8_t RequestId = 4;
+constexpr uint8_t Spectator = 5;
+}
+
+namespace RoomCreatedTag {
+constexpr uint8_t Success = 1;
+constexpr uint8_t Room = 2;
+constexpr uint8_t RequestId = 3;
+}
+
+namespace RoomListResponseTag {
+constexpr uint8_t Success = 1;
+constexpr uint8_t TotalCount = 2;
+constexpr uint8_t Room = 3;
+constexpr uint8_t RequestId = 4;
+constexpr uint8_t NextCursor = 5;
+}
+
+namespace JoinRoomResponseTag {
+constexpr uint8_t Success = 1;
+constexpr uint8_t RoomId = 2;
+constexpr uint8_t PlayerId = 3;
+constexpr uint8_t Player = 4;
+constexpr uint8_t RequestId = 5;
+constexpr uint8_t ResumeToken = 6;
+}
+
+namespace P2PInfoTag {
+constexpr uint8_t FromPlayer = 1;
+constexpr uint8_t ToPlayer = 2;
+constexpr uint8_t ConnectionType = 3;
+constexpr uint8_t IceCandidate = 4;
+constexpr uint8_t SessionDescription = 5;
+constexpr uint8_t EndOfCandidates = 6;
+}
+
+namespace UseProxyTag {
+constexpr uint8_t RelayServer = 1;
+constexpr uint8_t RelayPort = 2;
+constexpr uint8_t AuthToken = 3;
+constexpr uint8_t SessionId = 4;
+constexpr uint8_t TargetPlayer = 5;
+constexpr uint8_t ExpiresAt = 6;
+}
+
+namespace ErrorTag {
+constexpr uint8_t ErrorCode = 1;
+constexpr uint8_t Message = 2;
+constexpr uint8_t Detail = 3;
+constexpr uint8_t RetryAfter = 4;
+constexpr uint8_t RequestId = 5;
+}
+
+namespace PlayerJoinedTag {
+constexpr uint8_t RoomId = 1;
+constexpr uint8_t Player = 2;
+}
+
+namespace PlayerLeftTag {
+constexpr uint8_t RoomId = 1;
+constexpr uint8_t PlayerId = 2;
+constexpr uint8_t Reason = 3;
+}
+
+void AppendVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+bool ReadVarint(std::string_view data, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos >= data.size()) {
+            return false;
+        }
+        const auto byte = static_cast<uint8_t>(data[pos++]);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false; // Varint longer than 10 bytes
+}
+
+uint64_t ZigZagEncode(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t ZigZagDecode(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+/**
+ * Appends fields to a frame. Fields equal to their default value are omitted;
+ * decoders start from a default-constructed message, so omission is lossless.
+ */
+class TlvWriter {
+public:
+    explicit TlvWriter(std::string& out) : out_(out) {}
+
+    void Uint(uint8_t tag, uint64_t value) {
+        if (value == 0) {
+            return;
+        }
+        std::string encoded;
+        AppendVarint(encoded, value);
+        Field(tag, encoded);
+    }
+
+    void Int(uint8_t tag, int64_t value) {
+        Uint(tag, ZigZagEncode(value));
+    }
+
+    void Bool(uint8_t tag, bool value) {
+        Uint(tag, value ? 1 : 0);
+    }
+
+    void String(uint8_t tag, std::string_view value) {
+        if (!value.empty()) {
+            Field(tag, value);
+        }
+    }
+
+    template <typename F>
+    void Nested(uint8_t tag, F&& body) {
+        std::string nested;
+        TlvWriter writer(nested);
+        body(writer);
+        Field(tag, nested);
+    }
+
+private:
+    void Field(uint8_t tag, std::string_view value) {
+        out_.push_back(static_cast<char>(tag));
+        AppendVarint(out_, value.size());
+        out_.append(value.data(), value.size());
+    }
+
+    std::string& out_;
+};
+
+/**
+ * Walks the fields of a frame body in place
+ */
+class TlvReader {
+public:
+    explicit TlvReader(std::string_view data) : data_(data) {}
+
+    bool Next(uint8_t& tag, std::string_view& value) {
+        if (pos_ >= data_.size()) {
+            return false;
+        }
+
+        tag = static_cast<uint8_t>(data_[pos_++]);
+        uint64_t length = 0;
+        if (!ReadVarint(data_, pos_, length) || length > data_.size() - pos_) {
+            error_ = true;
+            return false;
+        }
+
+        value = data_.substr(pos_, static_cast<size_t>(length));
+        pos_ += static_cast<size_t>(length);
+        return true;
+    }
+
+    bool Ok() const { return !error_; }
+
+private:
+    std::string_view data_;
+    size_t pos_ = 0;
+    bool error_ = false;
+};
+
+bool ReadUint(std::string_view value, uint64_t& out) {
+    size_t pos = 0;
+    return ReadVarint(value, pos, out) && pos == value.size();
+}
+
+template <typename T>
+bool ReadUnsigned(std::string_view value, T& out) {
+    uint64_t raw = 0;
+    if (!ReadUint(value, raw)) {
+        return false;
+    }
+    out = static_cast<T>(raw);
+    return true;
+}
+
+bool ReadInt(std::string_view value, int& out) {
+    uint64_t raw = 0;
+    if (!ReadUint(value, raw)) {
+        return false;
+    }
+    out = static_cast<int>(ZigZagDecode(raw));
+    return true;
+}
+
+bool ReadBool(std::string_view value, bool& out) {
+    uint64_t raw = 0;
+    if (!ReadUint(value, raw)) {
+        return false;
+    }
+    out = raw != 0;
+    return true;
+}
+
+bool ReadString(std::string_view value, std::string& out) {
+    out.assign(value.data(), value.size());
+    return true;
+}
+
+std::string BeginFrame(MessageType type) {
+    std::string frame;
+    frame.reserve(64);
+    frame.push_back(static_cast<char>(RoomBinaryCodec::FRAME_MAGIC));
+    frame.push_back(static_cast<char>(RoomBinaryCodec::FORMAT_VERSION));
+    frame.push_back(static_cast<char>(type));
+    return frame;
+}
+
+bool OpenFrame(std::string_view frame, MessageType expected, std::string_view& body) {
+    if (RoomBinaryCodec::PeekType(frame) != expected) {
+        return false;
+    }
+    body = frame.substr(RoomBinaryCodec::FRAME_HEADER_SIZE);
+    return true;
+}
+
+// Nested record encoders
+void WriteNetworkInfo(TlvWriter& writer, const NetworkInfo& info) {
+    writer.String(NetworkInfoTag::LocalIp, info.local_ip);
+    writer.String(NetworkInfoTag::PublicIp, info.public_ip);
+    writer.Uint(NetworkInfoTag::Port, info.port);
+}
+
+void WriteClientInfo(TlvWriter& writer, const ClientInfo& info) {
+    writer.String(ClientInfoTag::Username, info.username);
+    writer.String(ClientInfoTag::Platform, info.platform);
+    writer.Nested(ClientInfoTag::Network,
+                  [&](TlvWriter& nested) { WriteNetworkInfo(nested, info.network_info); });
+}
+
+void WritePlayerInfo(TlvWriter& writer, const PlayerInfo& player) {
+    writer.String(PlayerInfoTag::Id, player.id);
+    writer.String(PlayerInfoTag::Username, player.username);
+    writer.Bool(PlayerInfoTag::IsHost, player.is_host);
+    writer.Nested(PlayerInfoTag::Network,
+                  [&](TlvWriter& nested) { WriteNetworkInfo(nested, player.network_info); });
+}
+
+void WriteRoomSummary(TlvWriter& writer, const RoomSummary& room) {
+    writer.String(RoomSummaryTag::Id, room.id);
+    writer.String(RoomSummaryTag::GameName, room.game_name);
+    writer.String(RoomSummaryTag::HostName, room.host_name);
+    writer.Int(RoomSummaryTag::CurrentPlayers, room.current_players);
+    writer.Int(RoomSummaryTag::MaxPlayers, room.max_players);
+    writer.Int(RoomSummaryTag::Ping, room.ping);
+    writer.String(RoomSummaryTag::Region, room.region);
+    writer.Uint(RoomSummaryTag::GameId, room.game_id);
+}
+
+void WriteRoomInfo(TlvWriter& writer, const RoomInfo& room) {
+    writer.String(RoomInfoTag::Id, room.id);
+    writer.Uint(RoomInfoTag::GameId, room.game_id);
+    writer.String(RoomInfoTag::GameName, room.game_name);
+    writer.String(RoomInfoTag::HostId, room.host_id);
+    writer.String(RoomInfoTag::HostName, room.host_name);
+    writer.Int(RoomInfoTag::MaxPlayers, room.max_players);
+    writer.Int(RoomInfoTag::CurrentPlayers, room.current_players);
+    writer.Bool(RoomInfoTag::IsPrivate, room.is_private);
+    writer.Uint(RoomInfoTag::CreatedAt, room.created_at);
+    writer.String(RoomInfoTag::Description, room.description);
+}
+
+// Nested record decoders
+bool ReadNetworkInfo(std::string_view data, NetworkInfo& info) {
+    TlvReader reader(data);
+    uint8_t tag = 0;
+    std::string_view value;
+    while (reader.Next(tag, value)) {
+        bool ok = true;
+        switch (tag) {
+        case NetworkInfoTag::LocalIp:
+            ok = ReadString(value, info.local_ip);
+            break;
+        case NetworkInfoTag::PublicIp:
+            ok = ReadString(value, info.public_ip);
+            break;
+        case NetworkInfoTag::Port:
+            ok = ReadUnsigned(value, info.port);
+            break;
+        default:
+            break;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return reader.Ok();
+}
+
+bool ReadClientInfo(std::string_view data, ClientInfo& info) {
+    TlvReader reader(data);
+    uint8_t tag = 0;
+    std::string_view value;
+    while (reader.Next(tag, value)) {
+        bool ok = true;
+        switch (tag) {
+        case ClientInfoTag::Username:
+            ok = ReadString(value, info.username);
+            break;
+        case ClientInfoTag::Platform:
+            ok = ReadString(value, info.platform);
+            break;
+        case ClientInfoTag::Network:
+            ok = ReadNetworkInfo(value, info.network_info);
+            break;
+        default:
+            break;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return reader.Ok();
+}
+
+bool ReadPlayerInfo(std::string_view data, PlayerInfo& player) {
+    TlvReader reader(data);
+    uint8_t tag = 0;
+    std::string_view value;
+    while (reader.Next(tag, value)) {
+        bool ok = true;
+        switch (tag) {
+        case PlayerInfoTag::Id:
+            ok = ReadString(value, player.id);
+            break;
+        case PlayerInfoTag::Username:
+            ok = ReadString(value, player.username);
+            break;
+        case PlayerInfoTag::IsHost:
+            ok = ReadBool(value, player.is_host);
+            break;
+        case PlayerInfoTag::Network:
+            ok = ReadNetworkInfo(value, player.network_info);
+            break;
+        default:
+            break;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return reader.Ok();
+}
+
+bool ReadRoomSummary(std::string_view data, RoomSummary& room) {
+    TlvReader reader(data);
+    uint8_t tag = 0;
+    std::string_view value;
+    while (reader.Next(tag, value)) {
+        bool ok = true;
+        switch (tag) {
+        case RoomSummaryTag::Id:
+            ok = ReadString(value, room.id);
+            break;
+        case RoomSummaryTag::GameName:
+            ok = ReadString(value, room.game_name);
+            break;
+        case RoomSummaryTag::HostName:
+            ok = ReadString(value, room.host_name);
+            break;
+        case RoomSummaryTag::CurrentPlayers:
+            ok = ReadInt(value, room.current_players);
+            break;
+        case RoomSummaryTag::MaxPlayers:
+            ok = ReadInt(value, room.max_players);
+            break;
+        case RoomSummaryTag::Ping:
+            ok = ReadInt(value, room.ping);
+            break;
+        case RoomSummaryTag::Region:
+            ok = ReadString(value, room.region);
+            break;
+        case RoomSummaryTag::GameId:
+            ok = ReadUint(value, room.game_id);
+            break;
+        default:
+            break;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return reader.Ok();
+}
+
+bool ReadRoomInfo(std::string_view data, RoomInfo& room) {
+    TlvReader reader(data);
+    uint8_t tag = 0;
+    std::string_view value;
+    while (reader.Next(tag, value)) {
+        bool ok = true;
+        switch (tag) {
+        case RoomInfoTag::Id:
+            ok = ReadString(value, room.id);
+            break;
+        case RoomInfoTag::GameId:
+            ok = ReadUint(value, room.game_id);
+            break;
+        case RoomInfoTag::GameName:
+            ok = ReadString(value, room.game_name);
+            break;
+        case RoomInfoTag::HostId:
+            ok = ReadString(value, room.host_id);
+            break;
+        case RoomInfoTag::HostName:
+            ok = ReadString(value, room.host_name);
+            break;
+        case RoomInfoTag::MaxPlayers:
+            ok = ReadInt(value, room.max_players);
+            break;
+        case RoomInfoTag::CurrentPlayers:
+            ok = ReadInt(value, room.current_players);
+            break;
+        case RoomInfoTag::IsPrivate:
+            ok = ReadBool(value, room.is_private);
+            break;
+        case RoomInfoTag::CreatedAt:
+            ok = ReadUint(value, room.created_at);
+            break;
+        case RoomInfoTag::Description:
+            ok = ReadString(value, room.description);
+            break;
+        default:
+            break;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return reader.Ok();
+}
+
+bool ReadIceCandidate(std::string_view data, IceCandidate& candidate) {
+    TlvReader reader(data);
+    uint8_t tag = 0;
+    std::string_view value;
+    while (reader.Next(tag, value)) {
+        bool ok = true;
+        switch (tag) {
+        case IceCandidateTag::Candidate:
+            ok = ReadString(value, candidate.candidate);
+            break;
+        case IceCandidateTag::SdpMid:
+            ok = ReadString(value, candidate.sdp_mid);
+            break;
+        case IceCandidateTag::SdpMlineIndex:
+            ok = ReadInt(value, candidate.sdp_mline_index);
+            break;
+        default:
+            break;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return reader.Ok();
+}
+
+bool ReadSessionDescription(std::string_view data, SessionDescription& description) {
+    TlvReader reader(data);
+    uint8_t tag = 0;
+    std::string_view value;
+    while (reader.Next(tag, value)) {
+        if (tag == SessionDescriptionTag::Type) {
+            ReadString(value, description.type);
+        } else if (tag == SessionDescriptionTag::Sdp) {
+            ReadString(value, description.sdp);
+        }
+    }
+    return reader.Ok();
+}
+
+bool ReadDetail(std::string_view data, std::map<std::string, std::string>& details) {
+    TlvReader reader(data);
+    uint8_t tag = 0;
+    std::string_view value;
+    std::string key;
+    std::string detail_value;
+    while (reader.Next(tag, value)) {
+        if (tag == DetailTag::Key) {
+            ReadString(value, key);
+        } else if (tag == DetailTag::Value) {
+            ReadString(value, detail_value);
+        }
+    }
+    if (!reader.Ok()) {
+        return false;
+    }
+    details[key] = detail_value;
+    return true;
+}
+
+} // anonymous namespace
+
+bool RoomBinaryCodec::IsBinaryFrame(std::string_view data) {
+    return !data.empty() && static_cast<uint8_t>(data[0]) == FRAME_MAGIC;
+}
+
+MessageType RoomBinaryCodec::PeekType(std::string_view frame) {
+    if (frame.size() < FRAME_HEADER_SIZE || !IsBinaryFrame(frame) ||
+        static_cast<uint8_t>(frame[1]) != FORMAT_VERSION) {
+        return MessageType::Unknown;
+    }
+
+    // Room list subscriptions have no binary encoding and stay on JSON
+    const auto type = static_cast<uint8_t>(frame[2]);
+    if (type > static_cast<uint8_t>(MessageType::Heartbeat)) {
+        return MessageType::Unknown;
+    }
+    return static_cast<MessageType>(type);
+}
+
+// Heartbeat
+std::string RoomBinaryCodec::EncodeHeartbeat(uint64_t timestamp) {
+    std::string frame = BeginFrame(MessageType::Heartbeat);
+    TlvWriter writer(frame);
+    writer.Uint(HeartbeatTag::Timestamp, timestamp);
+    return frame;
+}
+
+bool RoomBinaryCodec::DecodeHeartbeat(std::string_view frame, uint64_t& timestamp) {
+    std::string_view body;
+    if (!OpenFrame(frame, MessageType::Heartbeat, body)) {
+        return false;
+    }
+
+    timestamp = 0;
+    TlvReader reader(body);
+    uint8_t tag = 0;
+    std::string_view value;
+    while (reader.Next(tag, value)) {
+        if (tag == HeartbeatTag::Timestamp && !ReadUint(value, timestamp)) {
+            return false;
+        }
+    }
+    return reader.Ok();
+}
+
+// Client requests
+std::string RoomBinaryCodec::Encode(const RegisterRequest& request) {
+    std::string frame = BeginFrame(MessageType::Register);
+    TlvWriter writer(frame);
+    writer.String(RegisterTag::ClientId, request.client_id);
+    writer.String(RegisterTag::Username, request.username);
+    writer.String(RegisterTag::Platform, request.platform);
+    writer.String(RegisterTag::SudachiVersion, request.sudachi_version);
+    writer.Uint(RegisterTag::RequestId, request.request_id);
+    return frame;
+}
+
+std::string RoomBinaryCodec::Encode(const CreateRoomRequest& request) {
+    std::string frame = BeginFrame(MessageType::CreateRoom);
+    TlvWriter writer(frame);
+    writer.Uint(CreateRoomTag::GameId, request.game_id);
+    writer.String(CreateRoomTag::GameName, request.game_name);
+    writer.Int(CreateRoomTag::MaxPlayers, request.max_players);
+    writer.Bool(CreateRoomTag::IsPrivate, request.is_private);
+    writer.String(CreateRoomTag::Password, request.password);
+    writer.String(CreateRoomTag::Description, request.description);
+    writer.Uint(CreateRoomTag::RequestId, request.request_id);
+    return frame;
+}
+
+std::string RoomBinaryCodec::Encode(const RoomListRequest& request) {
+    std::string frame = BeginFrame(MessageType::RoomList);
+    TlvWriter writer(frame);
+    writer.Uint(RoomListRequestTag::GameId, request.game_id);
+    writer.String(RoomListRequestTag::Region, request.region);
+    writer.Int(RoomListRequestTag::MaxResults, request.max_results);
+    writer.Int(RoomListRequestTag::Offset, request.offset);
+    writer.Bool(RoomListRequestTag::IncludePrivate, request.include_private);
+    writer.Bool(RoomListRequestTag::IncludeFull, request.include_full);
+    writer.String(RoomListRequestTag::Cursor, request.cursor);
+    writer.Uint(RoomListRequestTag::RequestId, request.request_id);
+    return frame;
+}
+
+std::string RoomBinaryCodec::Encode(const JoinRoomRequest& request) {
+    std::string frame = BeginFrame(MessageType::JoinRoom);
+    TlvWriter writer(frame);
+    writer.String(JoinRoomTag::RoomId, request.room_id);
+    writer.String(JoinRoomTag::Password, request.password);
+    writer.Nested(JoinRoomTag::Client,
+                  [&](TlvWriter& nested) { WriteClientInfo(nested, request.client_info); });
+    writer.Uint(JoinRoomTag::RequestId, request.request_id);
+    // Only when set, so player joins encode as before
+    if (request.spectator) {
+        writer.Bool(JoinRoomTag::Spectator, true);
+    }
+    return frame;
+}
+
+// Server messages
+std::string RoomBinaryCodec::Encode(const RoomCreatedResponse& response) {
+    std::string frame = BeginFrame(MessageType::RoomCreated);
+    TlvWriter writer(frame);
+    writer.Bool(RoomCreatedTag::Success, response.success);
+    writer.Nested(RoomCreatedTag::Room,
+                  [&](TlvWriter& nested) { WriteRoomInfo(nested, response.room); });
+    writer.Uint(RoomCreatedTag::RequestId, response.request_id);
+    return frame;
+}
+
+std::string RoomBinaryCodec::Encode(const RoomListResponse& response) {
+    std::string frame = BeginFrame(MessageType::RoomListResponse);
+    TlvWriter writer(frame);
+    writer.Bool(RoomListResponseTag::Success, response.success);
+    writer.Int(RoomListResponseTag::TotalCount, response.total_count);
+    for (const auto& room : response.rooms) {
+        writer.Nested(RoomListResponseTag::Room,
+                      [&](TlvWriter& nested) { WriteRoomSummary(nested, room); });
+    }
+    writer.Uint(RoomListResponseTag::RequestId, response.request_id);
+    writer.String(RoomListResponseTag::NextCursor, response.next_cursor);
+    return frame;
+}
+
+std::string RoomBinaryCodec::Encode(const JoinRoomResponse& response) {
+    std::string frame = BeginFrame(MessageType::JoinRoomResponse);
+    TlvWriter writer(frame);
+    writer.Bool(JoinRoomResponseTag::Success, response.success);
+    writer.String(JoinRoomResponseTag::RoomId, response.room_id);
+    writer.String(JoinRoomResponseTag::PlayerId, response.player_id);
+    for (const auto& player : response.players) {
+        writer.Nested(JoinRoomResponseTag::Player,
+                      [&](TlvWriter& nested) { WritePlayerInfo(nested, player); });
+    }
+    writer.Uint(JoinRoomResponseTag::RequestId, response.request_id);
+    writer.String(JoinRoomResponseTag::ResumeToken, response.resume_token);
+    return frame;
+}
+
+std::string RoomBinaryCodec::Encode(const P2PInfoMessage& message) {
+    std::string frame = BeginFrame(MessageType::P2PInfo);
+    TlvWriter writer(frame);
+    writer.String(P2PInfoTag::FromPlayer, message.from_player);
+    writer.String(P2PInfoTag::ToPlayer, message.to_player);
+    writer.String(P2PInfoTag::ConnectionType, message.connection_type);
+    for (const auto& candidate : message.ice_candidates) {
+        writer.Nested(P2PInfoTag::IceCandidate, [&](TlvWriter& nested) {
+            nested.String(IceCandidateTag::Candidate, candidate.candidate);
+            nested.String(IceCandidateTag::SdpMid, candidate.sdp_mid);
+            nested.Int(IceCandidateTag::SdpMlineIndex, candidate.sdp_mline_index);
+        });
+    }
+    // Trickled candidates follow without a description
+    if (!message.session_description.type.empty() || !message.session_description.sdp.empty()) {
+        writer.Nested(P2PInfoTag::SessionDescription, [&](TlvWriter& nested) {
+            nested.String(SessionDescriptionTag::Type, message.session_description.type);
+            nested.String(SessionDescriptionTag::Sdp, message.session_description.sdp);
+        });
+    }
+    writer.Bool(P2PInfoTag::EndOfCandidates, message.end_of_candidates);
+    return frame;
+}
+
+std::string RoomBinaryCodec::Encode(const UseProxyMessage& message) {
+    std::string frame = BeginFrame(MessageType::UseProxy);
+    TlvWriter writer(frame);
+    writer.String(UseProxyTag::RelayServer, message.relay_server);
+    writer.Uint(UseProxyTag::RelayPort, message.relay_port);
+    writer.String(UseProxyTag::AuthToken, message.auth_token);
+    writer.String(UseProxyTag::SessionId, message.session_id);
+    writer.String(UseProxyTag::TargetPlayer, message.target_player);
+    writer.Uint(UseProxyTag::ExpiresAt, message.expires_at);
+    return frame;
+}
+
+std::string RoomBinaryCodec::Encode(const ErrorMessage& message) {
+    std::string frame = BeginFrame(MessageType::Error);
+    TlvWriter writer(frame);
+    writer.String(ErrorTag::ErrorCode, message.error_code);
+    writer.String(ErrorTag::Message, message.message);
+    for (const auto& [key, value] : message.details) {
+        writer.Nested(ErrorTag::Detail, [&](TlvWriter& nested) {
+            nested.String(DetailTag::Key, key);
+            nested.String(DetailTag::Value, value);
+        });
+    }
+    writer.Uint(ErrorTag::RetryAfter, message.retry_after);
+    writer.Uint(ErrorTag::RequestId, message.request_id);
+    return frame;
+}
+
+std::string RoomBinaryCodec::Encode(const PlayerJoinedMessage& message) {
+    std::string frame = BeginFrame(MessageType::PlayerJoined);
+    TlvWriter writer(frame);
+    writer.String(PlayerJoinedTag::RoomId, message.room_id);
+    writer.Nested(PlayerJoinedTag::Player,
+                  [&](TlvWriter& nested) { WritePlayerInfo(nested, message.player); });
+    return frame;
+}
+
+std::string RoomBinaryCodec::Encode(const PlayerLeftMessage& message) {
+    std::string frame = BeginFrame(MessageType::PlayerLeft);
+    TlvWriter writer(frame);
+    writer.String(PlayerLeftTag::RoomId, message.room_id);
+    writer.String(PlayerLeftTag::PlayerId, message.player_id);
+    writer.String(PlayerLeftTag::Reason, message.reason);
+    return frame;
+}
+
+// Decoders
+bool RoomBinaryCodec::Decode(std::string_view frame, RegisterRequest& out) {
+    std::string_view body;
+    if (!OpenFrame(frame, MessageType::Register, body)) {
+        return false;
+    }
+
+    out = RegisterRequest{};
+    TlvReader reader(body);
+    uint8_t tag = 0;
+    std::string_view value;
+    while (reader.Next(tag, value)) {
+        switch (tag) {
+        case RegisterTag::ClientId:
+            ReadString(value, out.client_id);
+            break;
+        case RegisterTag::Username:
+            ReadString(value, out.username);
+            break;
+        case RegisterTag::Platform:
+            ReadString(value, out.platform);
+            break;
+        case RegisterTag::SudachiVersion:
+            ReadString(value, out.sudachi_version);
+            break;
+        case RegisterTag::RequestId:
+            ReadUnsigned(value, out.request_id);
+            break;
+        default:
+            break;
+        }
+    }
+    return reader.Ok();
+}
+
+bool RoomBinaryCodec::Decode(std::string_view frame, CreateRoomRequest& out) {
+    std::string_view body;
+    if (!OpenFrame(frame, MessageType::CreateRoom, body)) {
+        return false;
+    }
+
+    // Start from a zeroed request so omitted fields decode as their wire defaults
+    out = CreateRoomRequest{};
+    out.max_players = 0;
+    TlvReader reader(body);
+    uint8_t tag = 0;
+    std::string_view value;
+    while (reader.Next(tag, value)) {
+        bool ok = true;
+        switch (tag) {
+        case CreateRoomTag::GameId:
+            ok = ReadUint(value, out.game_id);
+            break;
+        case CreateRoomTag::GameName:
+            ok = ReadString(value, out.game_name);
+            break;
+        case CreateRoomTag::MaxPlayers:
+            ok = ReadInt(value, out.max_players);
+            break;
+        case CreateRoomTag::IsPrivate:
+            ok = ReadBool(value, out.is_private);
+            break;
+        case CreateRoomTag::Password:
+            ok = ReadString(value, out.password);
+            break;
+        case CreateRoomTag::Description:
+            ok = ReadString(value, out.description);
+            break;
+        case CreateRoomTag::RequestId:
+            ok = ReadUnsigned(value, out.request_id);
+            break;
+        default:
+            break;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return reader.Ok();
+}
+
+bool RoomBinaryCodec::Decode(std::string_view frame, RoomListRequest& out) {
+    std::string_view body;
+    if (!OpenFrame(frame, MessageType::RoomList, body)) {
+        return false;
+    }
+
+    // Start from a zeroed request so omitted fields decode as their wire defaults
+    out = RoomListRequest{};
+    out.max_results = 0;
+    TlvReader reader(body);
+    uint8_t tag = 0;
+    std::string_view value;
+    while (reader.Next(tag, value)) {
+        bool ok = true;
+        switch (tag) {
+        case RoomListRequestTag::GameId:
+            ok = ReadUint(value, out.game_id);
+            break;
+        case RoomListRequestTag::Region:
+            ok = ReadString(value, out.region);
+            break;
+        case RoomListRequestTag::MaxResults:
+            ok = ReadInt(value, out.max_results);
+            break;
+        case RoomListRequestTag::Offset:
+            ok = ReadInt(value, out.offset);
+            break;
+        case RoomListRequestTag::IncludePrivate:
+            ok = ReadBool(value, out.include_private);
+            break;
+        case RoomListRequestTag::IncludeFull:
+            ok = ReadBool(value, out.include_full);
+            break;
+        case RoomListRequestTag::Cursor:
+            ok = ReadString(value, out.cursor);
+            break;
+        case RoomListRequestTag::RequestId:
+            ok = ReadUnsigned(value, out.request_id);
+            break;
+        default:
+            break;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return reader.Ok();
+}
+
+bool RoomBinaryCodec::Decode(std::string_view frame, JoinRoomRequest& out) {
+    std::string_view body;
+    if (!OpenFrame(frame, MessageType::JoinRoom, body)) {
+        return false;
+    }
+
+    out = JoinRoomRequest{};
+    TlvReader reader(body);
+    uint8_t tag = 0;
+    std::string_view value;
+    while (reader.Next(tag, value)) {
+        bool ok = true;
+        switch (tag) {
+        case JoinRoomTag::RoomId:
+            ok = ReadString(value, out.room_id);
+            break;
+        case JoinRoomTag::Password:
+            ok = ReadString(value, out.password);
+            break;
+        case JoinRoomTag::Client:
+            ok = ReadClientInfo(value, out.client_info);
+            break;
+        case JoinRoomTag::RequestId:
+            ok = ReadUnsigned(value, out.request_id);
+            break;
+        case JoinRoomTag::Spectator:
+            ok = ReadBool(value, out.spectator);
+            break;
+        default:
+            break;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return reader.Ok();
+}
+
+bool RoomBinaryCodec::Decode(std::string_view frame, RoomCreatedResponse& out) {
+    std::string_view body;
+    if (!OpenFrame(frame, MessageType::RoomCreated, body)) {
+        return false;
+    }
+
+    out = RoomCreatedResponse{};
+    TlvReader reader(body);
+    uint8_t tag = 0;
+    std::string_view value;
+    while (reader.Next(tag, value)) {
+        bool ok = true;
+        switch (tag) {
+        case RoomCreatedTag::Success:
+            ok = ReadBool(value, out.success);
+            break;
+        case RoomCreatedTag::Room:
+            ok = ReadRoomInfo(value, out.room);
+            break;
+        case RoomCreatedTag::RequestId:
+            ok = ReadUnsigned(value, out.request_id);
+            break;
+        default:
+            break;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return reader.Ok();
+}
+
+bool RoomBinaryCodec::Decode(std::string_view frame, RoomListResponse& out) {
+    std::string_view body;
+    if (!OpenFrame(frame, MessageType::RoomListResponse, body)) {
+        return false;
+    }
+
+    out = RoomListResponse{};
+    TlvReader reader(body);
+    uint8_t tag = 0;
+    std::string_view value;
+    while (reader.Next(tag, value)) {
+        bool ok = true;
+        switch (tag) {
+        case RoomListResponseTag::Success:
+            ok = ReadBool(value, out.success);
+            break;
+        case RoomListResponseTag::TotalCount:
+            ok = ReadInt(value, out.total_count);
+            break;
+        case RoomListResponseTag::Room: {
+            RoomSummary room;
+            ok = ReadRoomSummary(value, room);
+            out.rooms.push_back(std::move(room));
+            break;
+        }
+        case RoomListResponseTag::RequestId:
+            ok = ReadUnsigned(value, out.request_id);
+            break;
+        case RoomListResponseTag::NextCursor:
+            ok = ReadString(value, out.next_cursor);
+            break;
+        default:
+            break;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return reader.Ok();
+}
+
+bool RoomBinaryCodec::Decode(std::string_view frame, JoinRoomResponse& out) {
+    std::string_view body;
+    if (!OpenFrame(frame, MessageType::JoinRoomResponse, body)) {
+        return false;
+    }
+
+    out = JoinRoomResponse{};
+    TlvReader reader(body);
+    uint8_t tag = 0;
+    std::string_view value;
+    while (reader.Next(tag, value)) {
+        bool ok = true;
+        switch (tag) {
+        case JoinRoomResponseTag::Success:
+            ok = ReadBool(value, out.success);
+            break;
+        case JoinRoomResponseTag::RoomId:
+            ok = ReadString(value, out.room_id);
+            break;
+        case JoinRoomResponseTag::PlayerId:
+            ok = ReadString(value, out.player_id);
+            break;
+        case JoinRoomResponseTag::Player: {
+            PlayerInfo player;
+            ok = ReadPlayerInfo(value, player);
+            out.players.push_back(std::move(player));
+            break;
+        }
+        case JoinRoomResponseTag::RequestId:
+            ok = ReadUnsigned(value, out.request_id);
+            break;
+        case JoinRoomResponseTag::ResumeToken:
+            ok = ReadString(value, out.resume_token);
+            break;
+        default:
+            break;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return reader.Ok();
+}
+
+bool RoomBinaryCodec::Decode(std::string_view frame, P2PInfoMessage& out) {
+    std::string_view body;
+    if (!OpenFrame(frame, MessageType::P2PInfo, body)) {
+        return false;
+    }
+
+    out = P2PInfoMessage{};
+    TlvReader reader(body);
+    uint8_t tag = 0;
+    std::string_view value;
+    while (reader.Next(tag, value)) {
+        bool ok = true;
+        switch (tag) {
+        case P2PInfoTag::FromPlayer:
+            ok = ReadString(value, out.from_player);
+            break;
+        case P2PInfoTag::ToPlayer:
+            ok = ReadString(value, out.to_player);
+            break;
+        case P2PInfoTag::ConnectionType:
+            ok = ReadString(value, out.connection_type);
+            break;
+        case P2PInfoTag::IceCandidate: {
+            IceCandidate candidate;
+            ok = ReadIceCandidate(value, candidate);
+            out.ice_candidates.push_back(std::move(candidate));
+            break;
+        }
+        case P2PInfoTag::SessionDescription:
+            ok = ReadSessionDescription(value, out.session_description);
+            break;
+        case P2PInfoTag::EndOfCandidates:
+            ok = ReadBool(value, out.end_of_candidates);
+            break;
+        default:
+            break;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return reader.Ok();
+}
+
+bool RoomBinaryCodec::Decode(std::string_view frame, UseProxyMessage& out) {
+    std::string_view body;
+    if (!OpenFrame(frame, MessageType::UseProxy, body)) {
+        return false;
+    }
+
+    out = UseProxyMessage{};
+    TlvReader reader(body);
+    uint8_t tag = 0;
+    std::string_view value;
+    while (reader.Next(tag, value)) {
+        bool ok = true;
+        switch (tag) {
+        case UseProxyTag::RelayServer:
+            ok = ReadString(value, out.relay_server);
+            break;
+        case UseProxyTag::RelayPort:
+            ok = ReadUnsigned(value, out.relay_port);
+            break;
+        case UseProxyTag::AuthToken:
+            ok = ReadString(value, out.auth_token);
+            break;
+        case UseProxyTag::SessionId:
+            ok = ReadString(value, out.session_id);
+            break;
+        case UseProxyTag::TargetPlayer:
+            ok = ReadString(value, out.target_player);
+            break;
+        case UseProxyTag::ExpiresAt:
+            ok = ReadUint(value, out.expires_at);
+            break;
+        default:
+            break;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return reader.Ok();
+}
+
+bool RoomBinaryCodec::Decode(std::string_view frame, ErrorMessage& out) {
+    std::string_view body;
+    if (!OpenFrame(frame, MessageType::Error, body)) {
+        return false;
+    }
+
+    out = ErrorMessage{};
+    TlvReader reader(body);
+    uint8_t tag = 0;
+    std::string_view value;
+    while (reader.Next(tag, value)) {
+        bool ok = true;
+        switch (tag) {
+        case ErrorTag::ErrorCode:
+            ok = ReadString(value, out.error_code);
+            break;
+        case ErrorTag::Message:
+            ok = ReadString(value, out.message);
+            break;
+        case ErrorTag::Detail:
+            ok = ReadDetail(value, out.details);
+            break;
+        case ErrorTag::RetryAfter:
+            ok = ReadUint(value, out.retry_after);
+            break;
+        case ErrorTag::RequestId:
+            ok = ReadUnsigned(value, out.request_id);
+            break;
+        default:
+            break;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return reader.Ok();
+}
+
+bool RoomBinaryCodec::Decode(std::string_view frame, PlayerJoinedMessage& out) {
+    std::string_view body;
+    if (!OpenFrame(frame, MessageType::PlayerJoined, body)) {
+        return false;
+    }
+
+    out = PlayerJoinedMessage{};
+    TlvReader reader(body);
+    uint8_t tag = 0;
+    std::string_view value;
+    while (reader.Next(tag, value)) {
+        bool ok = true;
+        switch (tag) {
+        case PlayerJoinedTag::RoomId:
+            ok = ReadString(value, out.room_id);
+            break;
+        case PlayerJoinedTag::Player:
+            ok = ReadPlayerInfo(value, out.player);
+            break;
+        default:
+            break;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return reader.Ok();
+}
+
+bool RoomBinaryCodec::Decode(std::string_view frame, PlayerLeftMessage& out) {
+    std::string_view body;
+    if (!OpenFrame(frame, MessageType::PlayerLeft, body)) {
+        return false;
+    }
+
+    out = PlayerLeftMessage{};
+    TlvReader reader(body);
+    uint8_t tag = 0;
+    std::string_view value;
+    while (reader.Next(tag, value)) {
+        switch (tag) {
+        case PlayerLeftTag::RoomId:
+            ReadString(value, out.room_id);
+            break;
+        case PlayerLeftTag::PlayerId:
+            ReadString(value, out.player_id);
+            break;
+        case PlayerLeftTag::Reason:
+            ReadString(value, out.reason);
+            break;
+        default:
+            break;
+        }
+    }
+    return reader.Ok();
+}
+
+} // namespace Core::Multiplayer::ModelA
@@ -0,0 +1,88 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "room_messages.h"
+
+namespace Core::Multiplayer::ModelA {
+
+/**
+ * Compact tag-length-value encoding for room server messages.
+ *
+ * Frame layout:
+ *   [magic 0xB5][version][MessageType][field]*
+ *   field = [tag u8][length varint][value]
+ *
+ * Integers are LEB128 varints (signed values zigzag-encoded), strings are raw
+ * UTF-8, nested records and repeated entries are embedded field sequences.
+ * Unknown tags are skipped so either side can add fields without breaking the
+ * other. The magic byte can never start a JSON document, which lets JSON stay
+ * on the same connection as the fallback encoding.
+ *
+ * Decoding walks the frame in place without building a DOM.
+ */
+class RoomBinaryCodec {
+public:
+    static constexpr uint8_t FRAME_MAGIC = 0xB5;
+    static constexpr uint8_t FORMAT_VERSION = 1;
+    static constexpr size_t FRAME_HEADER_SIZE = 3;
+
+    /**
+     * Name advertised during wire format negotiation
+     */
+    static constexpr const char* FORMAT_NAME = "tlv1";
+
+    /**
+     * Check whether a message is a binary frame rather than JSON
+     */
+    static bool IsBinaryFrame(std::string_view data);
+
+    /**
+     * Read the message type from a frame header
+     * @return MessageType::Unknown if the header is malformed or unsupported
+     */
+    static MessageType PeekType(std::string_view frame);
+
+    // Heartbeat
+    static std::string EncodeHeartbeat(uint64_t timestamp);
+    static bool DecodeHeartbeat(std::string_view frame, uint64_t& timestamp);
+
+    // Client requests
+    static std::string Encode(const RegisterRequest& request);
+    static std::string Encode(const CreateRoomRequest& request);
+    static std::string Encode(const RoomListRequest& request);
+    static std::string Encode(const JoinRoomRequest& request);
+
+    // Server messages
+    static std::string Encode(const RoomCreatedResponse& response);
+    static std::string Encode(const RoomListResponse& response);
+    static std::string Encode(const JoinRoomResponse& response);
+    static std::string Encode(const P2PInfoMessage& message);
+    static std::string Encode(const UseProxyMessage& message);
+    static std::string Encode(const ErrorMessage& message);
+    static std::string Encode(const PlayerJoinedMessage& message);
+    static std::string Encode(const PlayerLeftMessage& message);
+
+    /**
+     * Decode a frame into the matching message type
+     * @return False if the frame is malformed or carries a different type
+     */
+    static bool Decode(std::string_view frame, RegisterRequest& out);
+    static bool Decode(std::string_view frame, CreateRoomRequest& out);
+    static bool Decode(std::string_view frame, RoomListRequest& out);
+    static bool Decode(std::string_view frame, JoinRoomRequest& out);
+    static bool Decode(std::string_view frame, RoomCreatedResponse& out);
+    static bool Decode(std::string_view frame, RoomListResponse& out);
+    static bool Decode(std::string_view frame, JoinRoomResponse& out);
+    static bool Decode(std::string_view frame, P2PInfoMessage& out);
+    static bool Decode(std::string_view frame, UseProxyMessage& out);
+    static bool Decode(std::string_view frame, ErrorMessage& out);
+    static bool Decode(std::string_view frame, PlayerJoinedMessage& out);
+    static bool Decode(std::string_view frame, PlayerLeftMessage& out);
+};
+
+} // namespace Core::Multiplayer::ModelA
@@ -2,7 +2,12 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "room_client.h"
+#include "room_binary_codec.h"
+#include "room_json_writer.h"
+#include "room_message_router.h"
+#include "core/multiplayer/common/startup_profile.h"
 #include <algorithm>
+#include <array>
 #include <iomanip>
 #include <nlohmann/json.hpp>
 #include <random>
@@ -22,7 +27,7 @@ ExponentialBackoff::CalculateDelay(int attempt) const {
 
   auto delay = base_delay_.count() * std::pow(multiplier_, attempt - 1);
   auto delay_ms = static_cast<long long>(delay);
-  return std::chrono::milliseconds(std::min(delay_ms, max_delay_.count()));
+  return std::chrono::milliseconds(std::min<long long>(delay_ms, max_delay_.count()));
 }
 
 std::chrono::milliseconds
@@ -30,44 +35,285 @@ ExponentialBackoff::CalculateDelayWithJitter(int attempt) const {
   auto base_delay = CalculateDelay(attempt);
 
   // Add up to 25% jitter to avoid thundering herd problem
-  std::random_device rd;
-  std::mt19937 gen(rd());
+  thread_local std::mt19937 gen{std::random_device{}()};
   std::uniform_real_distribution<> dis(0.75, 1.25);
+  const double factor = seeded_gen_ ? dis(*seeded_gen_) : dis(gen);
 
-  auto jittered_delay = static_cast<long long>(base_delay.count() * dis(gen));
+  auto jittered_delay = static_cast<long long>(base_delay.count() * factor);
   return std::chrono::milliseconds(
-      std::min(jittered_delay, max_delay_.count()));
+      std::min<long long>(jittered_delay, max_delay_.count()));
+}
+
+std::chrono::milliseconds ExponentialBackoff::CalculateDecorrelatedDelay(
+    std::chrono::milliseconds previous) const {
+  using Rep = std::chrono::milliseconds::rep;
+  const Rep low = base_delay_.count();
+  const Rep high = std::min(std::max(low, previous.count() * 3), max_delay_.count());
+  if (high <= low) {
+    return std::chrono::milliseconds(std::min(low, max_delay_.count()));
+  }
+
+  thread_local std::mt19937_64 gen{std::random_device{}()};
+  std::uniform_int_distribution<Rep> dis(low, high);
+  return std::chrono::milliseconds(seeded_gen_ ? dis(*seeded_gen_) : dis(gen));
 }
 
 void ExponentialBackoff::Reset() {
   // No state to reset in this simple implementation
 }
 
+void ExponentialBackoff::SeedJitter(uint64_t seed) {
+  if (seed == 0) {
+    seeded_gen_.reset();
+  } else {
+    seeded_gen_.emplace(seed);
+  }
+}
+
 namespace Core::Multiplayer::ModelA {
 
 using json = nlohmann::json;
 
+namespace {
+
+uint64_t ParseGameId(const json &value) {
+  try {
+    return std::stoull(value.get<std::string>(), nullptr, 16);
+  } catch (const std::exception &) {
+    return 0; // Invalid game_id format
+  }
+}
+
+RoomSummary ParseRoomSummary(const json &room_data) {
+  RoomSummary room;
+  if (room_data.contains("id") && room_data["id"].is_string()) {
+    room.id = room_data["id"];
+  }
+  if (room_data.contains("game_id") && room_data["game_id"].is_string()) {
+    room.game_id = ParseGameId(room_data["game_id"]);
+  }
+  if (room_data.contains("game_name") && room_data["game_name"].is_string()) {
+    room.game_name = room_data["game_name"];
+  }
+  if (room_data.contains("host_name") && room_data["host_name"].is_string()) {
+    room.host_name = room_data["host_name"];
+  }
+  if (room_data.contains("current_players") &&
+      room_data["current_players"].is_number_integer()) {
+    room.current_players = room_data["current_players"];
+  }
+  if (room_data.contains("max_players") &&
+      room_data["max_players"].is_number_integer()) {
+    room.max_players = room_data["max_players"];
+  }
+  if (room_data.contains("ping") && room_data["ping"].is_number_integer()) {
+    room.ping = room_data["ping"];
+  }
+  if (room_data.contains("region") && room_data["region"].is_string()) {
+    room.region = room_data["region"];
+  }
+  return room;
+}
+
+RoomInfo ParseRoomInfo(const json &room_data) {
+  RoomInfo room;
+  if (room_data.contains("id") && room_data["id"].is_string()) {
+    room.id = room_data["id"];
+  }
+  if (room_data.contains("game_id") && room_data["game_id"].is_string()) {
+    room.game_id = ParseGameId(room_data["game_id"]);
+  }
+  if (room_data.contains("game_name") && room_data["game_name"].is_string()) {
+    room.game_name = room_data["game_name"];
+  }
+  if (room_data.contains("host_id") && room_data["host_id"].is_string()) {
+    room.host_id = room_data["host_id"];
+  }
+  if (room_data.contains("host_name") && room_data["host_name"].is_string()) {
+    room.host_name = room_data["host_name"];
+  }
+  if (room_data.contains("max_players") &&
+      room_data["max_players"].is_number_integer()) {
+    room.max_players = room_data["max_players"];
+  }
+  if (room_data.contains("current_players") &&
+      room_data["current_players"].is_number_integer()) {
+    room.current_players = room_data["current_players"];
+  }
+  if (room_data.contains("is_private") && room_data["is_private"].is_boolean()) {
+    room.is_private = room_data["is_private"];
+  }
+  if (room_data.contains("created_at") &&
+      room_data["created_at"].is_number_unsigned()) {
+    room.created_at = room_data["created_at"];
+  }
+  if (room_data.contains("description") &&
+      room_data["description"].is_string()) {
+    room.description = room_data["description"];
+  }
+  return room;
+}
+
+PlayerInfo ParsePlayerInfo(const json &player_data) {
+  PlayerInfo player;
+  if (player_data.contains("id") && player_data["id"].is_string()) {
+    player.id = player_data["id"];
+  }
+  if (player_data.contains("username") && player_data["username"].is_string()) {
+    player.username = player_data["username"];
+  }
+  if (player_data.contains("is_host") && player_data["is_host"].is_boolean()) {
+    player.is_host = player_data["is_host"];
+  }
+  return player;
+}
+
+IceCandidate ParseIceCandidate(const json &candidate_data) {
+  IceCandidate candidate;
+  if (candidate_data.contains("candidate") &&
+      candidate_data["candidate"].is_string()) {
+    candidate.candidate = candidate_data["candidate"];
+  }
+  if (candidate_data.contains("sdp_mid") &&
+      candidate_data["sdp_mid"].is_string()) {
+    candidate.sdp_mid = candidate_data["sdp_mid"];
+  }
+  if (candidate_data.contains("sdp_mline_index") &&
+      candidate_data["sdp_mline_index"].is_number_integer()) {
+    candidate.sdp_mline_index = candidate_data["sdp_mline_index"];
+  }
+  return candidate;
+}
+
+P2PInfoMessage ParseP2PInfo(const json &j) {
+  P2PInfoMessage message;
+  if (j.contains("from_player") && j["from_player"].is_string()) {
+    message.from_player = j["from_player"];
+  }
+  if (j.contains("to_player") && j["to_player"].is_string()) {
+    message.to_player = j["to_player"];
+  }
+  if (j.contains("connection_type") && j["connection_type"].is_string()) {
+    message.connection_type = j["connection_type"];
+  }
+  if (j.contains("ice_candidates") && j["ice_candidates"].is_array()) {
+    for (const auto &candidate_data : j["ice_candidates"]) {
+      if (candidate_data.is_object()) {
+        message.ice_candidates.push_back(ParseIceCandidate(candidate_data));
+      }
+    }
+  }
+  if (j.contains("session_description") &&
+      j["session_description"].is_object()) {
+    const auto &description = j["session_description"];
+    if (description.contains("type") && description["type"].is_string()) {
+      message.session_description.type = description["type"];
+    }
+    if (description.contains("sdp") && description["sdp"].is_string()) {
+      message.session_description.sdp = description["sdp"];
+    }
+  }
+  if (j.contains("end_of_candidates") && j["end_of_candidates"].is_boolean()) {
+    message.end_of_candidates = j["end_of_candidates"];
+  }
+  return message;
+}
+
+constexpr std::array<std::pair<RoomErrorType, std::string_view>, 6>
+    ROOM_ERROR_NAMES{{{RoomErrorType::Network, "NETWORK_ERROR"},
+                      {RoomErrorType::Timeout, "TIMEOUT"},
+                      {RoomErrorType::Auth, "AUTH_FAILED"},
+                      {RoomErrorType::Protocol, "PROTOCOL_ERROR"},
+                      {RoomErrorType::ServerClosed, "SERVER_CLOSED"},
+                      {RoomErrorType::Other, "OTHER"}}};
+
+} // namespace
+
+RoomErrorType ClassifyRoomError(std::string_view error) {
+  for (const auto &[type, name] : ROOM_ERROR_NAMES) {
+    if (error == name) {
+      return type;
+    }
+  }
+  return RoomErrorType::Other;
+}
+
+RoomClientConfig RoomClientConfig::FromProvider(const IConfigProvider &provider) {
+  RoomClientConfig config;
+  config.connection_timeout = provider.GetConnectionTimeout();
+  config.heartbeat_interval = provider.GetHeartbeatInterval();
+  config.max_heartbeat_interval = provider.GetMaxHeartbeatInterval();
+  config.message_timeout = provider.GetMessageTimeout();
+  config.max_concurrent_messages = provider.GetMaxConcurrentMessages();
+  config.message_queue_size = provider.GetMessageQueueSize();
+  config.auto_reconnect = provider.IsAutoReconnectEnabled();
+  config.max_reconnect_attempts = provider.GetMaxReconnectAttempts();
+  config.reconnect_backoff = ExponentialBackoff(
+      provider.GetReconnectBaseDelay(), provider.GetReconnectBackoffMultiplier(),
+      provider.GetMaxReconnectDelay());
+  config.reconnect_backoff.SeedJitter(provider.GetReconnectJitterSeed());
+  // Each kind is asked about once, by name, instead of per error
+  for (const auto &[type, name] : ROOM_ERROR_NAMES) {
+    if (provider.ShouldReconnectOnError(std::string(name))) {
+      config.reconnect_error_mask |= static_cast<uint32_t>(type);
+    }
+  }
+  config.binary_wire_format = provider.IsBinaryWireFormatEnabled();
+  config.compression.enabled = provider.IsMessageCompressionEnabled();
+  config.membership_batch_window = provider.GetMembershipBatchWindow();
+  return config;
+}
+
+void IMessageHandler::OnMembershipChanged(
+    std::span<const MembershipChange> changes) {
+  for (const auto &change : changes) {
+    if (change.kind == MembershipChange::Kind::Joined) {
+      OnPlayerJoined(PlayerJoinedMessage{change.room_id, change.player});
+    } else {
+      OnPlayerLeft(
+          PlayerLeftMessage{change.room_id, change.player.id, change.reason});
+    }
+  }
+}
+
 RoomClient::RoomClient(std::shared_ptr<IWebSocketConnection> connection,
-                       std::shared_ptr<IConfigProvider> config)
-    : connection_(connection), config_(config) {
+                       std::shared_ptr<IConfigProvider> config,
+                       std::shared_ptr<TimerWheel> timer_wheel)
+    : connection_(connection), config_(config),
+      timer_wheel_(timer_wheel ? std::move(timer_wheel)
+                               : TimerWheel::GetShared()) {
+  reconnect_throttle_ = ReconnectThrottle::GetShared();
 
   client_id_ = GenerateClientId();
   created_at_ = GetCurrentTimestamp();
 
-  // Initialize exponential backoff for reconnection
-  if (config_) {
-    reconnection_backoff_ = std::make_unique<ExponentialBackoff>(
-        config_->GetReconnectBaseDelay(),
-        config_->GetReconnectBackoffMultiplier(),
-        config_->GetMaxReconnectDelay());
-  } else {
-    // Default backoff parameters
-    reconnection_backoff_ = std::make_unique<ExponentialBackoff>(
-        std::chrono::milliseconds(1000), // 1 second base delay
-        2.0,                             // Double delay each time
-        std::chrono::milliseconds(30000) // Max 30 seconds
-    );
-  }
+  const auto settings = std::make_shared<const RoomClientConfig>(
+      config_ ? RoomClientConfig::FromProvider(*config_) : RoomClientConfig{});
+  settings_.store(settings, std::memory_order_release);
+
+  message_queue_limit_ = settings->message_queue_size;
+  message_queue_ =
+      std::make_unique<MpmcRing<OutboundMessage>>(message_queue_limit_);
+
+  const int max_requests = settings->max_concurrent_messages;
+  const auto request_timeout = settings->message_timeout;
+  pending_requests_ = std::make_unique<PendingRequestTable>(
+      timer_wheel_,
+      max_requests > 0 ? static_cast<size_t>(max_requests)
+                       : DEFAULT_MAX_CONCURRENT_REQUESTS,
+      request_timeout > std::chrono::milliseconds::zero()
+          ? request_timeout
+          : DEFAULT_REQUEST_TIMEOUT);
+  pending_requests_->SetOnTimeout([this](uint32_t request_id, MessageType type) {
+    HandleRequestTimeout(request_id, type);
+  });
+
+  LivenessConfig liveness_config;
+  liveness_config.initial_interval = settings->heartbeat_interval;
+  liveness_config.min_interval =
+      std::min(liveness_config.min_interval, liveness_config.initial_interval);
+  liveness_config.max_interval = settings->max_heartbeat_interval;
+  liveness_ = std::make_unique<LivenessTracker>(liveness_config);
 
   if (connection_) {
     InitializeWebSocketCallbacks();
@@ -77,54 +323,144 @@ RoomClient::RoomClient(std::shared_ptr<IWebSocketConnection> connection,
 RoomClient::~RoomClient() { Shutdown(); }
 
 void RoomClient::InitializeWebSocketCallbacks() {
-  connection_->SetOnConnectCallback([this]() { OnWebSocketConnected(); });
+  auto connection = GetConnection();
+  connection->SetOnConnectCallback([this]() { OnWebSocketConnected(); });
 
-  connection_->SetOnDisconnectCallback(
+  connection->SetOnDisconnectCallback(
       [this](const std::string &reason) { OnWebSocketDisconnected(reason); });
 
-  connection_->SetOnErrorCallback(
+  connection->SetOnErrorCallback(
       [this](const std::string &error) { OnWebSocketError(error); });
 
-  connection_->SetOnMessageCallback(
-      [this](const std::string &message) { OnWebSocketMessage(message); });
+  connection->SetOnMessageViewCallback(
+      [this](const WebSocketMessageView &message) {
+        OnWebSocketMessage(message);
+      });
 }
 
-ErrorCode RoomClient::Connect() {
-  if (!connection_ || !config_) {
-    return ErrorCode::InvalidParameter;
+std::shared_ptr<IWebSocketConnection> RoomClient::GetConnection() const {
+  std::lock_guard lock(connection_mutex_);
+  return connection_;
+}
+
+void RoomClient::SetConnectionPool(
+    std::shared_ptr<WebSocketConnectionPool> pool) {
+  std::lock_guard lock(connection_mutex_);
+  connection_pool_ = std::move(pool);
+  if (connection_ && connection_url_.empty()) {
+    connection_url_ = connection_->GetUri();
   }
+}
 
-  if (IsConnected()) {
-    return ErrorCode::AlreadyConnected;
+bool RoomClient::AcquirePooledConnection(const std::string &server_url) {
+  std::shared_ptr<IWebSocketConnection> previous;
+  std::shared_ptr<IWebSocketConnection> acquired;
+  std::shared_ptr<WebSocketConnectionPool> pool;
+  std::string previous_url;
+  {
+    std::lock_guard lock(connection_mutex_);
+    if (connection_ && connection_url_ == server_url &&
+        connection_->IsConnected()) {
+      return false; // Already on this server
+    }
+    pool = connection_pool_;
+    previous = connection_;
+    previous_url = connection_url_;
   }
 
-  std::string auth_token = config_->GetAuthToken();
-  if (auth_token.empty()) {
-    return ErrorCode::AuthenticationFailed;
+  // A dead connection is discarded here, but its session ticket is kept
+  // so the replacement can resume TLS
+  if (previous) {
+    pool->Release(previous_url, previous);
   }
+  acquired = pool->Acquire(server_url);
 
-  connection_->SetAuthToken(auth_token);
+  {
+    std::lock_guard lock(connection_mutex_);
+    connection_ = acquired;
+    connection_url_ = server_url;
+  }
+  InitializeWebSocketCallbacks();
+  return acquired->IsConnected();
+}
 
-  std::string server_url = config_->GetRoomServerUrl();
-  connection_->Connect(server_url);
+void RoomClient::ReleasePooledConnection() {
+  std::shared_ptr<IWebSocketConnection> connection;
+  std::shared_ptr<WebSocketConnectionPool> pool;
+  std::string url;
+  {
+    std::lock_guard lock(connection_mutex_);
+    if (!connection_pool_ || !connection_) {
+      return;
+    }
+    connection = std::move(connection_);
+    pool = connection_pool_;
+    url = std::move(connection_url_);
+    connection_url_.clear();
+  }
+  pool->Release(url, std::move(connection));
+}
+
+ErrorCode RoomClient::Connect() {
+  auto result = BeginConnect();
+  if (result != ErrorCode::Success) {
+    return result;
+  }
 
   // Wait for connection or timeout using condition variable
-  auto timeout = config_->GetConnectionTimeout();
+  const auto timeout = GetConfig()->connection_timeout;
   std::unique_lock<std::mutex> lock(state_mutex_);
-  bool connected = connection_cv_.wait_for(lock, timeout, [this]() {
-    return connection_ && connection_->IsConnected();
-  });
+  bool connected = connection_cv_.wait_for(
+      lock, timeout, [this]() { return IsConnected(); });
 
   if (!connected) {
+    EndStartupPhase(StartupPhase::RoomConnect, false);
     return ErrorCode::ConnectionTimeout;
   }
 
   return ErrorCode::Success;
 }
 
+ErrorCode RoomClient::BeginConnect() {
+  bool pooled;
+  {
+    std::lock_guard lock(connection_mutex_);
+    pooled = connection_pool_ != nullptr;
+    if ((!connection_ && !pooled) || !config_) {
+      return ErrorCode::InvalidParameter;
+    }
+  }
+
+  std::string auth_token = config_->GetAuthToken();
+  std::string server_url = config_->GetRoomServerUrl();
+  BeginStartupPhase(StartupPhase::RoomConnect);
+  if (pooled && !auth_token.empty() &&
+      AcquirePooledConnection(server_url)) {
+    // Reused an open connection; no handshake needed
+    OnWebSocketConnected();
+    return ErrorCode::Success;
+  }
+
+  if (IsConnected()) {
+    EndStartupPhase(StartupPhase::RoomConnect);
+    return ErrorCode::AlreadyConnected;
+  }
+
+  if (auth_token.empty()) {
+    EndStartupPhase(StartupPhase::RoomConnect, false);
+    return ErrorCode::AuthenticationFailed;
+  }
+
+  auto connection = GetConnection();
+  connection->SetAuthToken(auth_token);
+  connection->SetCompression(GetConfig()->compression);
+  connection->Connect(server_url);
+  return ErrorCode::Success;
+}
+
 void RoomClient::Disconnect() {
-  if (connection_) {
-    connection_->Disconnect("Client requested disconnect");
+  if (auto connection = GetConnection()) {
+    connection->Disconnect("Client requested disconnect");
   }
   connection_state_ = ConnectionState::Disconnected;
 }
@@ -136,25 +472,31 @@ void RoomClient::Shutdown() {
 
   StopHeartbeat();
 
-  // Stop reconnection
+  // Stop reconnection; pending timers are cancelled rather than waited out
   {
     std::lock_guard<std::mutex> lock(reconnection_mutex_);
     is_reconnecting_ = false;
   }
-
-  if (reconnection_thread_.joinable()) {
-    reconnection_thread_.join();
+  CancelReconnectionTimer();
+  if (const auto id = membership_timer_.exchange(TimerWheel::INVALID_TIMER_ID);
+      id != TimerWheel::INVALID_TIMER_ID) {
+    timer_wheel_->Cancel(id);
   }
+  pending_requests_->Clear();
+  resuming_ = false;
 
-  if (connection_ && IsConnected()) {
-    connection_->Disconnect("Client shutdown");
+  // A pooled connection stays open for the next client of the same server
+  ReleasePooledConnection();
+  if (auto connection = GetConnection(); connection && connection->IsConnected()) {
+    connection->Disconnect("Client shutdown");
   }
 
   connection_state_ = ConnectionState::Disconnected;
 }
 
 bool RoomClient::IsConnected() const {
-  return connection_ && connection_->IsConnected();
+  auto connection = GetConnection();
+  return connection && connection->IsConnected();
 }
 
 ConnectionState RoomClient::GetConnectionState() const {
@@ -163,14 +505,28 @@ ConnectionState RoomClient::GetConnectionState() const {
 
 ConnectionInfo RoomClient::GetConnectionInfo() const {
   ConnectionInfo info;
-  info.server_url = connection_ ? connection_->GetUri() : "";
+  auto connection = GetConnection();
+  info.server_url = connection ? connection->GetUri() : "";
   info.state = GetConnectionState();
-  info.client_id = client_id_;
+  info.client_id = GetClientId();
   info.created_at = created_at_;
+
+  info.pending_messages = GetPendingMessageCount();
+  info.rejected_messages = rejected_messages_.load(std::memory_order_relaxed);
+  const uint64_t sent = sent_from_queue_.load(std::memory_order_relaxed);
+  if (sent > 0) {
+    info.queue_latency_average_us =
+        queue_latency_total_us_.load(std::memory_order_relaxed) / sent;
+  }
+  info.queue_latency_max_us =
+      queue_latency_max_us_.load(std::memory_order_relaxed);
   return info;
 }
 
-std::string RoomClient::GetClientId() const { return client_id_; }
+std::string RoomClient::GetClientId() const {
+  std::lock_guard<std::mutex> lock(room_mutex_);
+  return client_id_;
+}
 
 void RoomClient::SetCurrentRoomId(const std::string &room_id) {
   std::lock_guard<std::mutex> lock(room_mutex_);
@@ -197,6 +553,18 @@ bool RoomClient::IsInRoom() const {
   return !current_room_id_.empty();
 }
 
+std::string RoomClient::GetResumeToken() const {
+  std::lock_guard<std::mutex> lock(room_mutex_);
+  return resume_token_;
+}
+
+void RoomClient::SetResumeToken(const std::string &token) {
+  std::lock_guard<std::mutex> lock(room_mutex_);
+  resume_token_ = token;
+}
+
+bool RoomClient::IsResumingSession() const { return resuming_.load(); }
+
 ErrorCode RoomClient::JoinRoom(const std::string &room_id) {
   if (!IsConnected()) {
     return ErrorCode::NotConnected;
@@ -216,64 +584,406 @@ ErrorCode RoomClient::LeaveRoom() {
   return ErrorCode::Success;
 }
 
-ErrorCode RoomClient::SendMessage(const std::string &message) {
+ErrorCode RoomClient::SubscribeRoomList(const RoomListSubscribeRequest &request) {
   if (!IsConnected()) {
     return ErrorCode::NotConnected;
   }
 
+  {
+    std::lock_guard<std::mutex> lock(room_list_mutex_);
+    if (!room_list_subscribed_ ||
+        room_list_subscription_.game_id != request.game_id ||
+        room_list_subscription_.region != request.region) {
+      room_list_.Clear(); // A different list; its versions are unrelated
+    }
+    room_list_subscribed_ = true;
+    room_list_subscription_ = request;
+  }
+  return SendRoomListSubscription();
+}
+
+ErrorCode RoomClient::UnsubscribeRoomList() {
+  {
+    std::lock_guard<std::mutex> lock(room_list_mutex_);
+    if (!room_list_subscribed_) {
+      return ErrorCode::InvalidState;
+    }
+    room_list_subscribed_ = false;
+    room_list_.Clear();
+  }
+  return SendMessage("{\"type\":\"room_list_unsubscribe\"}");
+}
+
+bool RoomClient::IsRoomListSubscribed() const {
+  std::lock_guard<std::mutex> lock(room_list_mutex_);
+  return room_list_subscribed_;
+}
+
+uint64_t RoomClient::GetRoomListVersion() const {
+  std::lock_guard<std::mutex> lock(room_list_mutex_);
+  return room_list_.GetVersion();
+}
+
+std::vector<RoomSummary>
+RoomClient::QueryRooms(const RoomListFilter &filter) const {
+  std::lock_guard<std::mutex> lock(room_list_mutex_);
+  return room_list_.Query(filter);
+}
+
+std::vector<RoomSummary>
+RoomClient::QueryRooms(const RoomListFilter &filter,
+                       uint64_t &out_version) const {
+  std::lock_guard<std::mutex> lock(room_list_mutex_);
+  out_version = room_list_.GetVersion();
+  return room_list_.Query(filter);
+}
+
+std::optional<RoomSummary>
+RoomClient::FindRoom(const std::string &room_id) const {
+  std::lock_guard<std::mutex> lock(room_list_mutex_);
+  const auto room = room_list_.Find(room_id);
+  if (!room) {
+    return std::nullopt;
+  }
+  return room->ToSummary();
+}
+
+ErrorCode RoomClient::GetRoomDetails(const std::string &room_id,
+                                     uint32_t *out_request_id) {
+  if (room_id.empty()) {
+    return ErrorCode::InvalidParameter;
+  }
+
+  RoomDetailsRequest request;
+  request.room_id = room_id;
+  {
+    std::lock_guard<std::mutex> lock(room_details_mutex_);
+    if (room_details_ && room_details_->room.id == room_id) {
+      request.known_version = room_details_->version;
+    }
+  }
+  return SendTrackedRequest(MessageType::RoomDetails, request, out_request_id);
+}
+
+std::optional<RoomDetailsResponse>
+RoomClient::GetCachedRoomDetails(const std::string &room_id) const {
+  std::lock_guard<std::mutex> lock(room_details_mutex_);
+  if (!room_details_ || room_details_->room.id != room_id) {
+    return std::nullopt;
+  }
+  return room_details_;
+}
+
+ErrorCode RoomClient::StartRoomQuery(const RoomListRequest &request,
+                                     size_t max_rooms,
+                                     uint32_t *out_query_id) {
+  if (!IsConnected()) {
+    return ErrorCode::NotConnected;
+  }
+  if (request.max_results <= 0) {
+    return ErrorCode::InvalidParameter;
+  }
+
+  RoomListRequest first_page = request;
+  first_page.cursor.clear();
+  first_page.offset = 0;
+  if (max_rooms != 0) {
+    first_page.max_results = static_cast<int>(
+        std::min<size_t>(first_page.max_results, max_rooms));
+  }
+  first_page.request_id = pending_requests_->Begin(MessageType::RoomList);
+  if (first_page.request_id == PendingRequestTable::INVALID_REQUEST_ID) {
+    return ErrorCode::ResourceExhausted;
+  }
+  {
+    std::lock_guard<std::mutex> lock(room_query_mutex_);
+    room_queries_[first_page.request_id] = {first_page, max_rooms, 0};
+  }
+
+  const ErrorCode result = SendRequestMessage(first_page);
+  if (result != ErrorCode::Success) {
+    CancelRoomQuery(first_page.request_id);
+    return result;
+  }
+  if (out_query_id) {
+    *out_query_id = first_page.request_id;
+  }
+  return ErrorCode::Success;
+}
+
+void RoomClient::CancelRoomQuery(uint32_t query_id) {
+  {
+    std::lock_guard<std::mutex> lock(room_query_mutex_);
+    room_queries_.erase(query_id);
+  }
+  pending_requests_->Complete(query_id);
+}
+
+ErrorCode RoomClient::Register(const RegisterRequest &request,
+                               uint32_t *out_request_id) {
+  BeginStartupPhase(StartupPhase::RoomRegister);
+  const ErrorCode result =
+      SendTrackedRequest(MessageType::Register, request, out_request_id);
+  if (result != ErrorCode::Success) {
+    EndStartupPhase(StartupPhase::RoomRegister, false);
+  }
+  return result;
+}
+
+ErrorCode RoomClient::CreateRoom(const CreateRoomRequest &request,
+                                 uint32_t *out_request_id) {
+  return SendTrackedRequest(MessageType::CreateRoom, request, out_request_id);
+}
+
+ErrorCode RoomClient::RequestJoinRoom(const JoinRoomRequest &request,
+                                      uint32_t *out_request_id) {
+  return SendTrackedRequest(MessageType::JoinRoom, request, out_request_id);
+}
+
+ErrorCode RoomClient::SpectateRoom(const std::string &room_id,
+                                   uint32_t *out_request_id) {
+  JoinRoomRequest request;
+  request.room_id = room_id;
+  request.spectator = true;
+  return SendTrackedRequest(MessageType::JoinRoom, request, out_request_id);
+}
+
+size_t RoomClient::GetPendingRequestCount() const {
+  return pending_requests_->GetInFlightCount();
+}
+
+template <typename Request>
+ErrorCode RoomClient::SendTrackedRequest(MessageType type, Request request,
+                                         uint32_t *out_request_id) {
+  if (!IsConnected()) {
+    return ErrorCode::NotConnected;
+  }
+
+  request.request_id = pending_requests_->Begin(type);
+  if (request.request_id == PendingRequestTable::INVALID_REQUEST_ID) {
+    return ErrorCode::ResourceExhausted;
+  }
+
+  const ErrorCode result = SendRequestMessage(request);
+  if (result != ErrorCode::Success) {
+    pending_requests_->Complete(request.request_id);
+    return result;
+  }
+  if (out_request_id) {
+    *out_request_id = request.request_id;
+  }
+  return ErrorCode::Success;
+}
+
+template <typename Request>
+ErrorCode RoomClient::SendRequestMessage(const Request &request) {
+  // Requests without a binary frame go as JSON, which the server takes on
+  // either wire format
+  if constexpr (requires { RoomBinaryCodec::Encode(request); }) {
+    if (binary_wire_format_.load()) {
+      return SendMessage(RoomBinaryCodec::Encode(request));
+    }
+  }
+  return SendJsonRequest(request);
+}
+
+template <typename Request>
+ErrorCode RoomClient::SendJsonRequest(const Request &request) {
+  if constexpr (requires(RoomJsonWriter &writer) { writer.Write(request); }) {
+    std::lock_guard lock(json_writer_mutex_);
+    const auto message = json_writer_.Write(request);
+    if (!message) {
+      return ErrorCode::InvalidParameter; // Not valid UTF-8
+    }
+    return SendTextMessage(*message);
+  } else {
+    return SendMessage(MessageSerializer::Serialize(request));
+  }
+}
+
+void RoomClient::CompleteRequest(uint32_t request_id) {
+  if (request_id == PendingRequestTable::INVALID_REQUEST_ID) {
+    return;
+  }
+  // An error ends a room query as well as a single request
+  {
+    std::lock_guard<std::mutex> lock(room_query_mutex_);
+    room_queries_.erase(request_id);
+  }
+  pending_requests_->Complete(request_id);
+}
+
+void RoomClient::HandleRequestTimeout(uint32_t request_id, MessageType type) {
+  {
+    std::lock_guard<std::mutex> lock(room_query_mutex_);
+    room_queries_.erase(request_id);
+  }
+  FailSessionResume(request_id);
+  if (message_handler_) {
+    message_handler_->OnRequestTimedOut(request_id, type);
+  }
+}
+
+ErrorCode RoomClient::SendRoomListSubscription() {
+  RoomListSubscribeRequest request;
+  {
+    std::lock_guard<std::mutex> lock(room_list_mutex_);
+    request = room_list_subscription_;
+    request.known_version = room_list_.GetVersion();
+    room_list_awaiting_snapshot_ = request.known_version == 0;
+  }
+  return SendMessage(MessageSerializer::Serialize(request));
+}
+
+ErrorCode RoomClient::SendP2PInfo(const P2PInfoMessage &message) {
+  if (!IsConnected()) {
+    return ErrorCode::NotConnected;
+  }
+  return SendRequestMessage(message);
+}
+
+ErrorCode RoomClient::UpdateAdvertiseData(const AdvertiseDataUpdate &update) {
+  if (!IsConnected()) {
+    return ErrorCode::NotConnected;
+  }
+  return SendMessage(MessageSerializer::Serialize(update));
+}
+
+ErrorCode RoomClient::SendMessage(const std::string &message) {
+  auto connection = GetConnection();
+  if (!connection || !connection->IsConnected()) {
+    return ErrorCode::NotConnected;
+  }
+
   try {
-    connection_->SendMessage(message);
+    // Encoded frames go out as binary frames, JSON as text
+    if (RoomBinaryCodec::IsBinaryFrame(message)) {
+      connection->SendMessage(
+          std::span(reinterpret_cast<const uint8_t *>(message.data()),
+                    message.size()),
+          WebSocketFrameType::Binary);
+    } else {
+      connection->SendMessage(message);
+    }
+    liveness_->OnSent();
     return ErrorCode::Success;
   } catch (...) {
     return ErrorCode::NetworkError;
   }
 }
 
-ErrorCode RoomClient::QueueMessage(const std::string &message) {
-  std::lock_guard<std::mutex> lock(message_mutex_);
+ErrorCode RoomClient::SendTextMessage(std::string_view message) {
+  auto connection = GetConnection();
+  if (!connection || !connection->IsConnected()) {
+    return ErrorCode::NotConnected;
+  }
+
+  try {
+    connection->SendMessage(
+        std::span(reinterpret_cast<const uint8_t *>(message.data()),
+                  message.size()),
+        WebSocketFrameType::Text);
+    liveness_->OnSent();
+    return ErrorCode::Success;
+  } catch (...) {
+    return ErrorCode::NetworkError;
+  }
+}
 
-  if (config_ && message_queue_.size() >= config_->GetMessageQueueSize()) {
+ErrorCode RoomClient::QueueMessage(std::string &&message) {
+  // The ring is rounded up to a power of two; the configured size is the limit
+  OutboundMessage queued{std::move(message), timer_wheel_->GetClock()->Now()};
+  if (message_queue_->Size() >= message_queue_limit_ ||
+      !message_queue_->TryPush(std::move(queued))) {
+    message = std::move(queued.payload); // Handed back for a later retry
+    rejected_messages_.fetch_add(1, std::memory_order_relaxed);
+    NotifyBackpressure(true);
     return ErrorCode::MessageQueueFull;
   }
 
-  message_queue_.push(message);
-  message_cv_.notify_one();
+  if (message_queue_->Size() * 4 >= message_queue_limit_ * 3) {
+    NotifyBackpressure(true);
+  }
   return ErrorCode::Success;
 }
 
+ErrorCode RoomClient::QueueMessage(const std::string &message) {
+  return QueueMessage(std::string(message));
+}
+
 bool RoomClient::ProcessPendingMessages() {
-  std::unique_lock<std::mutex> lock(message_mutex_);
-  if (message_queue_.empty()) {
+  // Messages queued while offline stay queued, in order, until the session
+  // is back
+  if (resuming_.load() || !IsConnected()) {
     return false;
   }
 
-  std::string message = message_queue_.front();
-  message_queue_.pop();
-  lock.unlock();
+  OutboundMessage message;
+  if (!message_queue_->TryPop(message)) {
+    return false;
+  }
 
-  SendMessage(message);
+  const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+                           timer_wheel_->GetClock()->Now() - message.queued_at)
+                           .count();
+  const auto latency_us = static_cast<uint64_t>(std::max<int64_t>(latency, 0));
+  queue_latency_total_us_.fetch_add(latency_us, std::memory_order_relaxed);
+  sent_from_queue_.fetch_add(1, std::memory_order_relaxed);
+  uint64_t max_us = queue_latency_max_us_.load(std::memory_order_relaxed);
+  while (latency_us > max_us &&
+         !queue_latency_max_us_.compare_exchange_weak(
+             max_us, latency_us, std::memory_order_relaxed)) {
+  }
+
+  if (message_queue_->Size() * 4 <= message_queue_limit_) {
+    NotifyBackpressure(false);
+  }
+
+  SendMessage(message.payload);
   return true;
 }
 
 size_t RoomClient::GetPendingMessageCount() const {
-  std::lock_guard<std::mutex> lock(message_mutex_);
-  return message_queue_.size();
+  return message_queue_->Size();
+}
+
+void RoomClient::SetOnBackpressureCallback(std::function<void(bool)> callback) {
+  std::lock_guard lock(callback_mutex_);
+  on_backpressure_ = std::move(callback);
+}
+
+bool RoomClient::IsBackpressured() const { return backpressured_.load(); }
+
+void RoomClient::NotifyBackpressure(bool active) {
+  // Only transitions reach the callback, so the steady state stays lock-free
+  if (backpressured_.exchange(active) == active) {
+    return;
+  }
+
+  std::function<void(bool)> callback;
+  {
+    std::lock_guard lock(callback_mutex_);
+    callback = on_backpressure_;
+  }
+  if (callback) {
+    callback(active);
+  }
 }
 
 void RoomClient::SetOnConnectedCallback(std::function<void()> callback) {
-  std::lock_guard<std::mutex> lock(callback_mutex_);
+  std::lock_guard lock(callback_mutex_);
   on_connected_ = callback;
 }
 
 void RoomClient::SetOnDisconnectedCallback(
     std::function<void(const std::string &)> callback) {
-  std::lock_guard<std::mutex> lock(callback_mutex_);
+  std::lock_guard lock(callback_mutex_);
   on_disconnected_ = callback;
 }
 
 void RoomClient::SetOnMessageCallback(
     std::function<void(const std::string &)> callback) {
-  std::lock_guard<std::mutex> lock(callback_mutex_);
+  std::lock_guard lock(callback_mutex_);
   on_message_ = callback;
 }
 
@@ -293,18 +1003,70 @@ int RoomClient::GetReconnectionAttempts() const {
 }
 
 std::chrono::milliseconds
-RoomClient::CalculateReconnectDelay(int attempt) const {
-  if (!reconnection_backoff_) {
-    return std::chrono::milliseconds(1000);
+RoomClient::CalculateReconnectDelay(int attempt,
+                                    std::chrono::milliseconds previous) const {
+  const auto config = GetConfig();
+  if (previous <= std::chrono::milliseconds::zero()) {
+    return config->reconnect_backoff.CalculateDelayWithJitter(attempt);
   }
+  return config->reconnect_backoff.CalculateDecorrelatedDelay(previous);
+}
+
+void RoomClient::SetReconnectThrottle(
+    std::shared_ptr<ReconnectThrottle> throttle) {
+  std::lock_guard<std::mutex> lock(reconnection_mutex_);
+  reconnect_throttle_ = std::move(throttle);
+}
 
-  // Use exponential backoff with jitter to avoid thundering herd problem
-  return reconnection_backoff_->CalculateDelayWithJitter(attempt);
+void RoomClient::NoteRetryAfter(uint64_t seconds) {
+  if (seconds == 0) {
+    return;
+  }
+  const auto until = timer_wheel_->GetClock()->Now() +
+                     std::chrono::seconds(std::min<uint64_t>(seconds, 3600));
+  retry_after_until_ms_ =
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          until.time_since_epoch())
+          .count();
+}
+
+std::chrono::milliseconds RoomClient::TimeUntilRetryAllowed() const {
+  const auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                          timer_wheel_->GetClock()->Now().time_since_epoch())
+                          .count();
+  return std::chrono::milliseconds(
+      std::max<int64_t>(0, retry_after_until_ms_.load() - now_ms));
+}
+
+void RoomClient::ReloadConfig() {
+  if (config_) {
+    settings_.store(std::make_shared<const RoomClientConfig>(
+                        RoomClientConfig::FromProvider(*config_)),
+                    std::memory_order_release);
+  }
+}
+
+std::shared_ptr<const RoomClientConfig> RoomClient::GetConfig() const {
+  return settings_.load(std::memory_order_acquire);
 }
 
 ReconnectionStatistics RoomClient::GetReconnectionStatistics() const {
   std::lock_guard<std::mutex> lock(reconnection_mutex_);
-  return reconnection_stats_;
+  ReconnectionStatistics stats = reconnection_stats_;
+  stats.reconnect_time = reconnect_time_.Snapshot();
+  stats.average_reconnect_time_ms = stats.reconnect_time.mean_ns / 1000000;
+
+  // Oldest first
+  const size_t oldest =
+      (reconnection_history_next_ + reconnection_history_.size() -
+       reconnection_history_count_) %
+      reconnection_history_.size();
+  for (size_t i = 0; i < reconnection_history_count_; ++i) {
+    stats.recent_events[i] =
+        reconnection_history_[(oldest + i) % reconnection_history_.size()];
+  }
+  stats.recent_event_count = reconnection_history_count_;
+  return stats;
 }
 
 void RoomClient::StartHeartbeat() {
@@ -312,24 +1074,79 @@ void RoomClient::StartHeartbeat() {
     return; // Already active
   }
 
-  heartbeat_thread_ = std::thread([this]() { HeartbeatWorker(); });
+  SendHeartbeat();
+  ScheduleHeartbeat();
 }
 
 void RoomClient::StopHeartbeat() {
   heartbeat_active_ = false;
-  if (heartbeat_thread_.joinable()) {
-    heartbeat_thread_.join();
+  // A running check may schedule the next one before it returns
+  for (auto id = heartbeat_timer_.exchange(TimerWheel::INVALID_TIMER_ID);
+       id != TimerWheel::INVALID_TIMER_ID;
+       id = heartbeat_timer_.exchange(TimerWheel::INVALID_TIMER_ID)) {
+    timer_wheel_->Cancel(id);
+  }
+}
+
+std::chrono::milliseconds RoomClient::GetHeartbeatInterval() const {
+  return liveness_->GetKeepaliveInterval();
+}
+
+uint64_t RoomClient::GetHeartbeatCount() const {
+  return liveness_->GetKeepaliveCount();
+}
+
+void RoomClient::ScheduleHeartbeat() {
+  // Wake when the connection would next have been idle for a whole interval;
+  // anything sent meanwhile pushes that back
+  const auto delay = std::max(liveness_->TimeUntilKeepalive(),
+                              timer_wheel_->GetTickInterval());
+  heartbeat_timer_ = timer_wheel_->Schedule(delay, [this]() { OnHeartbeatTimer(); });
+}
+
+void RoomClient::OnHeartbeatTimer() {
+  if (!heartbeat_active_.load()) {
+    return;
+  }
+  if (liveness_->TimeUntilKeepalive() == std::chrono::milliseconds::zero()) {
+    SendHeartbeat();
   }
+  ScheduleHeartbeat();
+}
+
+bool RoomClient::IsBinaryWireFormatActive() const {
+  return binary_wire_format_.load();
 }
 
 void RoomClient::OnWebSocketConnected() {
+  EndStartupPhase(StartupPhase::RoomConnect);
   connection_state_ = ConnectionState::Connected;
-  is_reconnecting_ = false;
+  liveness_->Reset();
+  const bool was_reconnecting = is_reconnecting_.exchange(false);
   connection_cv_.notify_all();
 
+  if (was_reconnecting) {
+    CancelReconnectionTimer();
+    std::lock_guard<std::mutex> lock(reconnection_mutex_);
+    reconnection_stats_.successful_reconnections++;
+    reconnection_stats_.total_attempts++;
+    EndOutageLocked(ReconnectionEvent::Outcome::Reconnected,
+                    reconnection_attempts_.load());
+  }
+
+  // Every connection starts in JSON; binary is only used once acknowledged
+  binary_wire_format_ = false;
+
+  // The resume request goes out first so nothing queued overtakes it
+  const bool resuming = was_reconnecting && BeginSessionResume();
+  if (GetConfig()->binary_wire_format) {
+    SendMessage(std::string("{\"type\":\"wire_format\",\"formats\":[\"") +
+                RoomBinaryCodec::FORMAT_NAME + "\",\"json\"]}");
+  }
+
   std::function<void()> callback;
   {
-    std::lock_guard<std::mutex> lock(callback_mutex_);
+    std::lock_guard lock(callback_mutex_);
     callback = on_connected_;
   }
 
@@ -343,14 +1160,90 @@ void RoomClient::OnWebSocketConnected() {
       reconnection_listener_->OnReconnectionSucceeded(attempts);
     }
   }
+
+  // Without a session to resume, rejoin the room if we were in one
+  if (was_reconnecting && !resuming) {
+    SendRejoinRoom();
+  }
+
+  // A new connection has no subscription on the server; pick up from the
+  // last version seen so only the changes missed while away are sent
+  if (IsRoomListSubscribed()) {
+    SendRoomListSubscription();
+  }
+}
+
+bool RoomClient::BeginSessionResume() {
+  // A resume cut short by another drop is superseded by this one
+  ResumeRequest request;
+  {
+    std::lock_guard<std::mutex> lock(room_mutex_);
+    if (resume_token_.empty()) {
+      resuming_ = false;
+      return false;
+    }
+    request.resume_token = resume_token_;
+    request.client_id = client_id_;
+    request.room_id = current_room_id_;
+  }
+
+  request.request_id = pending_requests_->Begin(MessageType::Resume);
+  if (request.request_id == PendingRequestTable::INVALID_REQUEST_ID) {
+    resuming_ = false;
+    return false;
+  }
+  resume_request_id_ = request.request_id;
+  resuming_ = true;
+
+  // Always JSON: the wire format has not been negotiated yet
+  if (SendJsonRequest(request) != ErrorCode::Success) {
+    resuming_ = false;
+    resume_request_id_ = PendingRequestTable::INVALID_REQUEST_ID;
+    pending_requests_->Complete(request.request_id);
+    return false;
+  }
+  return true;
+}
+
+void RoomClient::FailSessionResume(uint32_t request_id) {
+  if (request_id == PendingRequestTable::INVALID_REQUEST_ID ||
+      !resuming_.load() || resume_request_id_.load() != request_id) {
+    return;
+  }
+
+  // The token is spent either way; fall back to rejoining
+  SetResumeToken("");
+  SendRejoinRoom();
+  FinishSessionResume();
+}
+
+void RoomClient::FinishSessionResume() {
+  resume_request_id_ = PendingRequestTable::INVALID_REQUEST_ID;
+  resuming_ = false;
+
+  // Replay what was queued while offline, oldest first
+  while (ProcessPendingMessages()) {
+  }
+}
+
+void RoomClient::SendRejoinRoom() {
+  std::string room_id = GetCurrentRoomId();
+  if (!room_id.empty()) {
+    SendMessage("{\"type\":\"rejoin_room\",\"room_id\":\"" + room_id +
+                "\"}");
+  }
 }
 
 void RoomClient::OnWebSocketDisconnected(const std::string &reason) {
   connection_state_ = ConnectionState::Disconnected;
+  FlushMembershipChanges();
+  // Dropped while a heartbeat waited for an answer: the path does not stay
+  // up that long idle
+  liveness_->OnBindingLost();
 
   std::function<void(const std::string &)> callback;
   {
-    std::lock_guard<std::mutex> lock(callback_mutex_);
+    std::lock_guard lock(callback_mutex_);
     callback = on_disconnected_;
   }
 
@@ -363,27 +1256,40 @@ void RoomClient::OnWebSocketDisconnected(const std::string &reason) {
   }
 
   // Start reconnection if enabled
-  if (config_ && config_->IsAutoReconnectEnabled() && !shutdown_requested_) {
+  if (GetConfig()->auto_reconnect && !shutdown_requested_) {
     StartReconnectionProcess(reason);
   }
 }
 
 void RoomClient::OnWebSocketError(const std::string &error) {
-  if (config_ && config_->ShouldReconnectOnError(error) &&
+  if (GetConfig()->ShouldReconnectOn(ClassifyRoomError(error)) &&
       !shutdown_requested_) {
     StartReconnectionProcess(error);
   }
 }
 
-void RoomClient::OnWebSocketMessage(const std::string &message) {
+void RoomClient::OnWebSocketMessage(const WebSocketMessageView &message) {
+  if (message.IsContiguous()) {
+    OnWebSocketMessage(message.Contiguous());
+    return;
+  }
+  // Both decoders walk one buffer, so only a fragmented message is joined
+  std::string joined;
+  message.AppendTo(joined);
+  OnWebSocketMessage(std::string_view(joined));
+}
+
+void RoomClient::OnWebSocketMessage(std::string_view message) {
+  liveness_->OnReceived();
+
   std::function<void(const std::string &)> callback;
   {
-    std::lock_guard<std::mutex> lock(callback_mutex_);
+    std::lock_guard lock(callback_mutex_);
     callback = on_message_;
   }
 
   if (callback) {
-    callback(message);
+    callback(std::string(message));
   }
 
   ProcessMessage(message);
@@ -394,140 +1300,410 @@ void RoomClient::SimulateIncomingMessage(const std::string &message) {
 }
 
 void RoomClient::StartReconnectionProcess(const std::string &reason) {
-  std::lock_guard<std::mutex> lock(reconnection_mutex_);
+  {
+    std::lock_guard<std::mutex> lock(reconnection_mutex_);
+
+    if (is_reconnecting_.load()) {
+      return; // Already reconnecting
+    }
+
+    is_reconnecting_ = true;
+    reconnection_attempts_ = 0;
+    last_reconnect_delay_ = std::chrono::milliseconds::zero();
+    outage_started_ = timer_wheel_->GetClock()->Now();
+    outage_ = {};
+    outage_.lost_at = timer_wheel_->GetClock()->WallNow();
+    outage_.cause = ClassifyRoomError(reason);
+  }
+
+  ScheduleReconnectionAttempt();
+}
+
+void RoomClient::ScheduleReconnectionAttempt() {
+  if (!is_reconnecting_.load() || shutdown_requested_) {
+    return;
+  }
+
+  int attempt = ++reconnection_attempts_;
+
+  if (attempt > GetConfig()->max_reconnect_attempts) {
+    {
+      std::lock_guard<std::mutex> lock(reconnection_mutex_);
+      reconnection_stats_.failed_reconnections++;
+      EndOutageLocked(ReconnectionEvent::Outcome::GaveUp, attempt - 1);
+    }
+
+    if (reconnection_listener_) {
+      reconnection_listener_->OnReconnectionGivenUp(attempt - 1);
+    }
+
+    is_reconnecting_ = false;
+    return;
+  }
+
+  if (reconnection_listener_) {
+    reconnection_listener_->OnReconnectionStarted(attempt);
+  }
+
+  connection_state_ = ConnectionState::Reconnecting;
+
+  std::chrono::milliseconds delay;
+  {
+    std::lock_guard<std::mutex> lock(reconnection_mutex_);
+    delay = CalculateReconnectDelay(attempt, last_reconnect_delay_);
+    last_reconnect_delay_ = delay;
+  }
+  // A server that asked for a pause gets it, however short the backoff
+  delay = std::max(delay, TimeUntilRetryAllowed());
+  reconnection_timer_ =
+      timer_wheel_->Schedule(delay, [this]() { AttemptReconnection(); });
+}
+
+void RoomClient::AttemptReconnection() {
+  if (!is_reconnecting_.load() || shutdown_requested_) {
+    return;
+  }
+
+  // Other clients in the process may be reconnecting at the same moment;
+  // a deferred attempt keeps its number and backoff
+  std::chrono::milliseconds wait = TimeUntilRetryAllowed();
+  {
+    std::lock_guard<std::mutex> lock(reconnection_mutex_);
+    if (wait == std::chrono::milliseconds::zero() && reconnect_throttle_) {
+      wait = reconnect_throttle_->TryAcquire();
+    }
+    if (wait > std::chrono::milliseconds::zero()) {
+      reconnection_stats_.deferred_attempts++;
+    }
+  }
+  if (wait > std::chrono::milliseconds::zero()) {
+    reconnection_timer_ =
+        timer_wheel_->Schedule(wait, [this]() { AttemptReconnection(); });
+    return;
+  }
+
+  const int attempt = reconnection_attempts_.load();
+  auto result = BeginConnect();
+  if (result != ErrorCode::Success) {
+    HandleReconnectionFailure(attempt, "Connection failed");
+    return;
+  }
+
+  if (!is_reconnecting_.load()) {
+    return; // Connected synchronously
+  }
+
+  // Success arrives through OnWebSocketConnected; otherwise time out the
+  // attempt and back off again
+  const auto timeout = GetConfig()->connection_timeout;
+  reconnection_timer_ = timer_wheel_->Schedule(timeout, [this, attempt]() {
+    if (is_reconnecting_.load() && reconnection_attempts_.load() == attempt &&
+        !IsConnected()) {
+      HandleReconnectionFailure(attempt, "Connection timeout");
+    }
+  });
+}
+
+void RoomClient::HandleReconnectionFailure(int attempt,
+                                           const std::string &reason) {
+  {
+    std::lock_guard<std::mutex> lock(reconnection_mutex_);
+    reconnection_stats_.failed_reconnections++;
+    reconnection_stats_.total_attempts++;
+  }
+
+  if (reconnection_listener_) {
+    reconnection_listener_->OnReconnectionFailed(attempt, reason);
+  }
+
+  ScheduleReconnectionAttempt();
+}
+
+void RoomClient::EndOutageLocked(ReconnectionEvent::Outcome outcome,
+                                 int attempts) {
+  outage_.outcome = outcome;
+  outage_.attempts = attempts;
+  outage_.downtime = std::chrono::duration_cast<std::chrono::milliseconds>(
+      timer_wheel_->GetClock()->Now() - outage_started_);
+
+  const auto downtime_ms = static_cast<uint64_t>(outage_.downtime.count());
+  reconnection_stats_.total_downtime_ms += downtime_ms;
+  if (outcome == ReconnectionEvent::Outcome::Reconnected) {
+    reconnect_time_.Record(outage_.downtime);
+    reconnection_stats_.max_reconnect_time_ms =
+        std::max(reconnection_stats_.max_reconnect_time_ms, downtime_ms);
+  }
+
+  reconnection_history_[reconnection_history_next_] = outage_;
+  reconnection_history_next_ =
+      (reconnection_history_next_ + 1) % reconnection_history_.size();
+  reconnection_history_count_ = std::min(reconnection_history_count_ + 1,
+                                         reconnection_history_.size());
+}
+
+void RoomClient::CancelReconnectionTimer() {
+  // A running attempt may schedule its successor before it returns, so keep
+  // cancelling until there is nothing left
+  for (auto id = reconnection_timer_.exchange(TimerWheel::INVALID_TIMER_ID);
+       id != TimerWheel::INVALID_TIMER_ID;
+       id = reconnection_timer_.exchange(TimerWheel::INVALID_TIMER_ID)) {
+    timer_wheel_->Cancel(id);
+  }
+}
+
+void RoomClient::SendHeartbeat() {
+  if (!IsConnected()) {
+    return;
+  }
+
+  liveness_->OnKeepaliveSent();
+
+  if (binary_wire_format_.load()) {
+    SendMessage(RoomBinaryCodec::EncodeHeartbeat(GetCurrentTimestamp()));
+  } else {
+    std::lock_guard lock(json_writer_mutex_);
+    SendTextMessage(json_writer_.WriteHeartbeat(GetCurrentTimestamp()));
+  }
+}
+
+void RoomClient::ProcessMessage(std::string_view message) {
+  if (RoomBinaryCodec::IsBinaryFrame(message)) {
+    ProcessBinaryMessage(message);
+    return;
+  }
+
+  // Route on the type string alone; the body is only parsed once a handler
+  // has been found for it
+  const std::string_view type_name = PeekMessageType(message);
+
+  BaseMessage base_message;
+  base_message.type = ResolveMessageType(type_name);
+  base_message.is_valid = base_message.type != MessageType::Unknown;
+
+  // Batched joins and leaves go out before anything that arrived after them
+  if (base_message.type != MessageType::PlayerJoined &&
+      base_message.type != MessageType::PlayerLeft) {
+    FlushMembershipChanges();
+  }
+
+  // Negotiation is handled even before a message handler is attached
+  if (type_name == "wire_format") {
+    try {
+      ProcessWireFormatMessage(json::parse(message));
+    } catch (const json::exception &e) {
+      // A malformed reply leaves the wire format unchanged
+    }
+    return;
+  }
+
+  // Resumption is completed even without a message handler, since it holds
+  // the outbound queue
+  if (base_message.type == MessageType::ResumeResponse) {
+    try {
+      ProcessResumeResponseMessage(json::parse(message));
+    } catch (const json::exception &e) {
+      // A malformed reply is left to the request timeout
+    }
+    return;
+  }
+
+  // The room list index is kept current even without a message handler
+  if (base_message.type == MessageType::RoomListDelta) {
+    try {
+      ProcessRoomListDeltaMessage(json::parse(message));
+    } catch (const json::exception &e) {
+      // A malformed delta is dropped; the next one reports the gap
+    }
+    return;
+  }
+
+  DispatchMessage(base_message, message);
+}
+
+void RoomClient::ProcessBinaryMessage(std::string_view message) {
+  if (!message_handler_) {
+    return;
+  }
 
-  if (is_reconnecting_.load()) {
-    return; // Already reconnecting
+  const MessageType type = RoomBinaryCodec::PeekType(message);
+  if (type != MessageType::PlayerJoined && type != MessageType::PlayerLeft) {
+    FlushMembershipChanges();
   }
 
-  is_reconnecting_ = true;
-  reconnection_attempts_ = 0;
+  // Malformed frames are dropped, matching the JSON path
+  switch (type) {
+  case MessageType::RoomCreated: {
+    RoomCreatedResponse response;
+    if (RoomBinaryCodec::Decode(message, response)) {
+      CompleteRequest(response.request_id);
+      message_handler_->OnRoomCreated(response);
+    }
+    break;
+  }
+  case MessageType::Error: {
+    ErrorMessage error;
+    if (RoomBinaryCodec::Decode(message, error)) {
+      NoteRetryAfter(error.retry_after);
+      CompleteRequest(error.request_id);
+      FailSessionResume(error.request_id);
+      message_handler_->OnErrorReceived(error);
+    }
+    break;
+  }
+  case MessageType::RoomListResponse: {
+    RoomListResponse response;
+    if (RoomBinaryCodec::Decode(message, response)) {
+      HandleRoomListResponse(std::move(response));
+    }
+    break;
+  }
+  case MessageType::JoinRoomResponse: {
+    JoinRoomResponse response;
+    if (RoomBinaryCodec::Decode(message, response)) {
+      CompleteRequest(response.request_id);
+      if (response.success && !response.resume_token.empty()) {
+        SetResumeToken(response.resume_token);
+      }
+      message_handler_->OnJoinedRoom(response);
+    }
+    break;
+  }
+  case MessageType::P2PInfo: {
+    P2PInfoMessage p2p_message;
+    if (RoomBinaryCodec::Decode(message, p2p_message)) {
+      message_handler_->OnP2PInfoReceived(p2p_message);
+    }
+    break;
+  }
+  case MessageType::UseProxy: {
+    UseProxyMessage proxy_message;
+    if (RoomBinaryCodec::Decode(message, proxy_message)) {
+      message_handler_->OnUseProxyMessage(proxy_message);
+    }
+    break;
+  }
+  case MessageType::PlayerJoined: {
+    PlayerJoinedMessage joined_message;
+    if (RoomBinaryCodec::Decode(message, joined_message)) {
+      QueueMembershipChange({MembershipChange::Kind::Joined,
+                             std::move(joined_message.room_id),
+                             std::move(joined_message.player),
+                             {}});
+    }
+    break;
+  }
+  case MessageType::PlayerLeft: {
+    PlayerLeftMessage left_message;
+    if (RoomBinaryCodec::Decode(message, left_message)) {
+      MembershipChange change{MembershipChange::Kind::Left,
+                              std::move(left_message.room_id),
+                              {},
+                              std::move(left_message.reason)};
+      change.player.id = std::move(left_message.player_id);
+      QueueMembershipChange(std::move(change));
+    }
+    break;
+  }
+  default:
+    // Heartbeat echoes and unknown types are ignored
+    break;
+  }
+}
 
-  if (reconnection_thread_.joinable()) {
-    reconnection_thread_.join();
+void RoomClient::ProcessWireFormatMessage(const json &j) {
+  if (!GetConfig()->binary_wire_format) {
+    return; // Never offered, so never switch
   }
 
-  reconnection_thread_ = std::thread([this]() { ReconnectionWorker(); });
+  binary_wire_format_ = j.contains("format") && j["format"].is_string() &&
+                        j["format"] == RoomBinaryCodec::FORMAT_NAME;
 }
 
-void RoomClient::ReconnectionWorker() {
-  while (is_reconnecting_.load() && !shutdown_requested_) {
-    int attempt = ++reconnection_attempts_;
+void RoomClient::ProcessRegisterResponseMessage(const json &j) {
+  RegisterResponse response;
 
-    if (config_ && attempt > config_->GetMaxReconnectAttempts()) {
-      {
-        std::lock_guard<std::mutex> lock(reconnection_mutex_);
-        reconnection_stats_.failed_reconnections++;
-      }
+  if (j.contains("success") && j["success"].is_boolean()) {
+    response.success = j["success"];
+  }
 
-      if (reconnection_listener_) {
-        reconnection_listener_->OnReconnectionGivenUp(attempt - 1);
-      }
+  if (j.contains("client_id") && j["client_id"].is_string()) {
+    response.client_id = j["client_id"];
+  }
 
-      is_reconnecting_ = false;
-      break;
-    }
+  if (j.contains("server_time") && j["server_time"].is_number_unsigned()) {
+    response.server_time = j["server_time"];
+  }
 
-    if (reconnection_listener_) {
-      reconnection_listener_->OnReconnectionStarted(attempt);
-    }
+  if (j.contains("server_version") && j["server_version"].is_string()) {
+    response.server_version = j["server_version"];
+  }
 
-    connection_state_ = ConnectionState::Reconnecting;
+  if (j.contains("request_id") && j["request_id"].is_number_unsigned()) {
+    response.request_id = j["request_id"];
+  }
 
-    auto delay = CalculateReconnectDelay(attempt);
-    std::this_thread::sleep_for(delay);
+  if (j.contains("resume_token") && j["resume_token"].is_string()) {
+    response.resume_token = j["resume_token"];
+  }
 
-    if (!is_reconnecting_.load() || shutdown_requested_) {
-      break;
-    }
+  CompleteRequest(response.request_id);
+  EndStartupPhase(StartupPhase::RoomRegister, response.success);
+  if (response.success && !response.resume_token.empty()) {
+    SetResumeToken(response.resume_token);
+  }
+  message_handler_->OnRegistered(response);
+}
 
-    // Attempt reconnection
-    auto result = Connect();
+void RoomClient::ProcessResumeResponseMessage(const json &j) {
+  ResumeResponse response;
 
-    if (result == ErrorCode::Success) {
-      {
-        std::lock_guard<std::mutex> lock(reconnection_mutex_);
-        reconnection_stats_.successful_reconnections++;
-        reconnection_stats_.total_attempts++;
-      }
+  if (j.contains("success") && j["success"].is_boolean()) {
+    response.success = j["success"];
+  }
 
-      // Try to rejoin room if we were in one
-      std::string room_id = GetCurrentRoomId();
-      if (!room_id.empty()) {
-        SendMessage("{\"type\":\"rejoin_room\",\"room_id\":\"" + room_id +
-                    "\"}");
-      }
+  if (j.contains("client_id") && j["client_id"].is_string()) {
+    response.client_id = j["client_id"];
+  }
 
-      break;
-    } else {
-      {
-        std::lock_guard<std::mutex> lock(reconnection_mutex_);
-        reconnection_stats_.failed_reconnections++;
-        reconnection_stats_.total_attempts++;
-      }
+  if (j.contains("room_id") && j["room_id"].is_string()) {
+    response.room_id = j["room_id"];
+  }
 
-      if (reconnection_listener_) {
-        reconnection_listener_->OnReconnectionFailed(attempt,
-                                                     "Connection failed");
-      }
-    }
+  if (j.contains("player_slot") && j["player_slot"].is_number_integer()) {
+    response.player_slot = j["player_slot"];
   }
-}
 
-void RoomClient::HeartbeatWorker() {
-  while (heartbeat_active_.load() && !shutdown_requested_) {
-    if (IsConnected()) {
-      SendMessage("{\"type\":\"heartbeat\",\"timestamp\":" +
-                  std::to_string(GetCurrentTimestamp()) + "}");
-    }
+  if (j.contains("resume_token") && j["resume_token"].is_string()) {
+    response.resume_token = j["resume_token"];
+  }
 
-    auto interval = config_ ? config_->GetHeartbeatInterval()
-                            : std::chrono::milliseconds(30000);
-    std::this_thread::sleep_for(interval);
+  if (j.contains("request_id") && j["request_id"].is_number_unsigned()) {
+    response.request_id = j["request_id"];
   }
-}
 
-void RoomClient::ProcessMessage(const std::string &message) {
-  if (!message_handler_) {
+  if (!response.success) {
+    CompleteRequest(response.request_id);
+    FailSessionResume(response.request_id);
     return;
   }
+  if (!resuming_.load() || resume_request_id_.load() != response.request_id) {
+    return; // Answered after the timeout; the fallback already ran
+  }
 
-  try {
-    json j = json::parse(message);
-
-    if (!j.contains("type") || !j["type"].is_string()) {
-      return; // Invalid message format
-    }
-
-    std::string message_type = j["type"];
-
-    if (message_type == "room_created") {
-      ProcessRoomCreatedMessage(j);
-    } else if (message_type == "error") {
-      ProcessErrorMessage(j);
-    } else if (message_type == "room_list_response") {
-      ProcessRoomListMessage(j);
-    } else if (message_type == "join_room_response") {
-      ProcessJoinRoomMessage(j);
-    } else if (message_type == "p2p_info") {
-      ProcessP2PInfoMessage(j);
-    } else if (message_type == "use_proxy") {
-      ProcessUseProxyMessage(j);
-    } else if (message_type == "player_joined") {
-      ProcessPlayerJoinedMessage(j);
-    } else if (message_type == "player_left") {
-      ProcessPlayerLeftMessage(j);
+  CompleteRequest(response.request_id);
+  {
+    std::lock_guard<std::mutex> lock(room_mutex_);
+    if (!response.client_id.empty()) {
+      client_id_ = response.client_id;
     }
-    // Unknown message types are silently ignored
+    current_room_id_ = response.room_id;
+    player_slot_ = response.player_slot;
+    resume_token_ = response.resume_token;
+  }
+  FinishSessionResume();
 
-  } catch (const json::parse_error &e) {
-    // Log parse error but don't crash - malformed JSON should be handled
-    // gracefully
-    return;
-  } catch (const json::type_error &e) {
-    // Log type error but don't crash - unexpected JSON structure should be
-    // handled gracefully
-    return;
+  if (message_handler_) {
+    message_handler_->OnSessionResumed(response);
   }
 }
 
@@ -547,7 +1723,7 @@ void RoomClient::ProcessRoomCreatedMessage(const json &j) {
 
     if (room_obj.contains("game_id") && room_obj["game_id"].is_string()) {
       try {
-        response.room.game_id = std::stoull(room_obj["game_id"], nullptr, 16);
+        response.room.game_id = std::stoull(room_obj["game_id"].get<std::string>(), nullptr, 16);
       } catch (const std::exception &) {
         // Invalid game_id format, leave as 0
       }
@@ -558,6 +1734,11 @@ void RoomClient::ProcessRoomCreatedMessage(const json &j) {
     }
   }
 
+  if (j.contains("request_id") && j["request_id"].is_number_unsigned()) {
+    response.request_id = j["request_id"];
+  }
+
+  CompleteRequest(response.request_id);
   message_handler_->OnRoomCreated(response);
 }
 
@@ -584,6 +1765,13 @@ void RoomClient::ProcessErrorMessage(const json &j) {
     }
   }
 
+  if (j.contains("request_id") && j["request_id"].is_number_unsigned()) {
+    error.request_id = j["request_id"];
+  }
+
+  NoteRetryAfter(error.retry_after);
+  CompleteRequest(error.request_id);
+  FailSessionResume(error.request_id);
   message_handler_->OnErrorReceived(error);
 }
 
@@ -603,32 +1791,171 @@ void RoomClient::ProcessRoomListMessage(const json &j) {
       if (!room_data.is_object())
         continue;
 
-      RoomSummary room;
-      if (room_data.contains("id") && room_data["id"].is_string()) {
-        room.id = room_data["id"];
-      }
-      if (room_data.contains("game_name") &&
-          room_data["game_name"].is_string()) {
-        room.game_name = room_data["game_name"];
+      response.rooms.push_back(ParseRoomSummary(room_data));
+    }
+  }
+
+  if (j.contains("request_id") && j["request_id"].is_number_unsigned()) {
+    response.request_id = j["request_id"];
+  }
+
+  if (j.contains("next_cursor") && j["next_cursor"].is_string()) {
+    response.next_cursor = j["next_cursor"];
+  }
+
+  HandleRoomListResponse(std::move(response));
+}
+
+void RoomClient::HandleRoomListResponse(RoomListResponse &&response) {
+  if (response.request_id == 0) {
+    message_handler_->OnRoomListUpdate(response);
+    return;
+  }
+
+  bool last_page = true;
+  RoomListRequest next_page;
+  {
+    std::lock_guard<std::mutex> lock(room_query_mutex_);
+    const auto it = room_queries_.find(response.request_id);
+    if (it == room_queries_.end()) {
+      return; // Cancelled, timed out, or not ours
+    }
+
+    auto &query = it->second;
+    if (query.max_rooms != 0) {
+      const size_t remaining = query.max_rooms - query.delivered;
+      if (response.rooms.size() > remaining) {
+        response.rooms.resize(remaining);
       }
-      if (room_data.contains("host_name") &&
-          room_data["host_name"].is_string()) {
-        room.host_name = room_data["host_name"];
+    }
+    query.delivered += response.rooms.size();
+
+    last_page = !response.success || response.next_cursor.empty() ||
+                (query.max_rooms != 0 && query.delivered >= query.max_rooms);
+    if (last_page) {
+      room_queries_.erase(it);
+    } else {
+      next_page = query.request;
+      next_page.cursor = response.next_cursor;
+      if (query.max_rooms != 0) {
+        next_page.max_results = static_cast<int>(std::min<size_t>(
+            next_page.max_results, query.max_rooms - query.delivered));
       }
-      if (room_data.contains("current_players") &&
-          room_data["current_players"].is_number_integer()) {
-        room.current_players = room_data["current_players"];
+    }
+  }
+
+  // Ask for the next page before handing this one over, so the round trip
+  // overlaps whatever the handler does with it
+  if (last_page) {
+    pending_requests_->Complete(response.request_id);
+  } else if (pending_requests_->Extend(response.request_id)) {
+    SendRequestMessage(next_page);
+  }
+  message_handler_->OnRoomQueryPage(response, last_page);
+}
+
+void RoomClient::ProcessRoomListDeltaMessage(const json &j) {
+  RoomListDelta delta;
+
+  if (j.contains("snapshot") && j["snapshot"].is_boolean()) {
+    delta.snapshot = j["snapshot"];
+  }
+  if (j.contains("base_version") && j["base_version"].is_number_unsigned()) {
+    delta.base_version = j["base_version"];
+  }
+  if (j.contains("version") && j["version"].is_number_unsigned()) {
+    delta.version = j["version"];
+  }
+  if (j.contains("rooms") && j["rooms"].is_array()) {
+    for (const auto &room_data : j["rooms"]) {
+      if (room_data.is_object()) {
+        delta.upserted.push_back(ParseRoomSummary(room_data));
       }
-      if (room_data.contains("max_players") &&
-          room_data["max_players"].is_number_integer()) {
-        room.max_players = room_data["max_players"];
+    }
+  }
+  if (j.contains("removed") && j["removed"].is_array()) {
+    for (const auto &room_id : j["removed"]) {
+      if (room_id.is_string()) {
+        delta.removed.push_back(room_id);
       }
+    }
+  }
+
+  RoomListIndex::ApplyResult result;
+  {
+    std::lock_guard<std::mutex> lock(room_list_mutex_);
+    if (!room_list_subscribed_) {
+      return; // Sent before the server saw the unsubscribe
+    }
+    if (room_list_awaiting_snapshot_ && !delta.snapshot) {
+      return; // Based on a version already discarded
+    }
+    result = room_list_.Apply(delta);
+    if (result == RoomListIndex::ApplyResult::Gap) {
+      room_list_.Clear();
+    } else if (delta.snapshot) {
+      room_list_awaiting_snapshot_ = false;
+    }
+  }
+
+  if (result == RoomListIndex::ApplyResult::Applied && !delta.removed.empty()) {
+    std::lock_guard<std::mutex> lock(room_details_mutex_);
+    if (room_details_ &&
+        std::find(delta.removed.begin(), delta.removed.end(),
+                  room_details_->room.id) != delta.removed.end()) {
+      room_details_.reset(); // The room closed
+    }
+  }
+
+  if (result == RoomListIndex::ApplyResult::Gap) {
+    // A delta went missing; start over from a snapshot
+    SendRoomListSubscription();
+  } else if (result == RoomListIndex::ApplyResult::Applied && message_handler_) {
+    message_handler_->OnRoomListChanged(delta);
+  }
+}
 
-      response.rooms.push_back(room);
+void RoomClient::ProcessRoomDetailsMessage(const json &j) {
+  RoomDetailsResponse response;
+
+  if (j.contains("success") && j["success"].is_boolean()) {
+    response.success = j["success"];
+  }
+  if (j.contains("not_modified") && j["not_modified"].is_boolean()) {
+    response.not_modified = j["not_modified"];
+  }
+  if (j.contains("version") && j["version"].is_number_unsigned()) {
+    response.version = j["version"];
+  }
+  if (j.contains("room") && j["room"].is_object()) {
+    response.room = ParseRoomInfo(j["room"]);
+  }
+  if (j.contains("players") && j["players"].is_array()) {
+    for (const auto &player_data : j["players"]) {
+      if (player_data.is_object()) {
+        response.players.push_back(ParsePlayerInfo(player_data));
+      }
     }
   }
+  if (j.contains("request_id") && j["request_id"].is_number_unsigned()) {
+    response.request_id = j["request_id"];
+  }
 
-  message_handler_->OnRoomListUpdate(response);
+  CompleteRequest(response.request_id);
+  if (response.success) {
+    std::lock_guard<std::mutex> lock(room_details_mutex_);
+    if (!response.not_modified) {
+      // Only the selected room is kept; details of another replace it
+      room_details_ = response;
+    } else if (room_details_ && room_details_->version == response.version) {
+      // Hand over the cached details, as if the server had sent them
+      const uint32_t request_id = response.request_id;
+      response = *room_details_;
+      response.not_modified = true;
+      response.request_id = request_id;
+    }
+  }
+  message_handler_->OnRoomDetails(response);
 }
 
 void RoomClient::ProcessJoinRoomMessage(const json &j) {
@@ -652,52 +1979,27 @@ void RoomClient::ProcessJoinRoomMessage(const json &j) {
       if (!player_data.is_object())
         continue;
 
-      PlayerInfo player;
-      if (player_data.contains("id") && player_data["id"].is_string()) {
-        player.id = player_data["id"];
-      }
-      if (player_data.contains("username") &&
-          player_data["username"].is_string()) {
-        player.username = player_data["username"];
-      }
-      if (player_data.contains("is_host") &&
-          player_data["is_host"].is_boolean()) {
-        player.is_host = player_data["is_host"];
-      }
-
-      response.players.push_back(player);
+      response.players.push_back(ParsePlayerInfo(player_data));
     }
   }
 
-  message_handler_->OnJoinedRoom(response);
-}
-
-void RoomClient::ProcessP2PInfoMessage(const json &j) {
-  P2PInfoMessage message;
-
-  if (j.contains("from_player") && j["from_player"].is_string()) {
-    message.from_player = j["from_player"];
-  }
-
-  if (j.contains("to_player") && j["to_player"].is_string()) {
-    message.to_player = j["to_player"];
+  if (j.contains("request_id") && j["request_id"].is_number_unsigned()) {
+    response.request_id = j["request_id"];
   }
 
-  if (j.contains("connection_type") && j["connection_type"].is_string()) {
-    message.connection_type = j["connection_type"];
+  if (j.contains("resume_token") && j["resume_token"].is_string()) {
+    response.resume_token = j["resume_token"];
   }
 
-  // For simplicity, create a dummy ICE candidate if ice_candidates array exists
-  if (j.contains("ice_candidates") && j["ice_candidates"].is_array()) {
-    IceCandidate candidate;
-    candidate.candidate =
-        "candidate:1 1 UDP 2113667326 192.168.1.1 54400 typ host";
-    candidate.sdp_mid = "0";
-    candidate.sdp_mline_index = 0;
-    message.ice_candidates.push_back(candidate);
+  CompleteRequest(response.request_id);
+  if (response.success && !response.resume_token.empty()) {
+    SetResumeToken(response.resume_token);
   }
+  message_handler_->OnJoinedRoom(response);
+}
 
-  message_handler_->OnP2PInfoReceived(message);
+void RoomClient::ProcessP2PInfoMessage(const json &j) {
+  message_handler_->OnP2PInfoReceived(ParseP2PInfo(j));
 }
 
 void RoomClient::ProcessUseProxyMessage(const json &j) {
@@ -753,7 +2055,9 @@ void RoomClient::ProcessPlayerJoinedMessage(const json &j) {
     }
   }
 
-  message_handler_->OnPlayerJoined(message);
+  QueueMembershipChange({MembershipChange::Kind::Joined,
+                         std::move(message.room_id), std::move(message.player),
+                         {}});
 }
 
 void RoomClient::ProcessPlayerLeftMessage(const json &j) {
@@ -771,12 +2075,131 @@ void RoomClient::ProcessPlayerLeftMessage(const json &j) {
     message.reason = j["reason"];
   }
 
-  message_handler_->OnPlayerLeft(message);
+  MembershipChange change{MembershipChange::Kind::Left,
+                          std::move(message.room_id),
+                          {},
+                          std::move(message.reason)};
+  change.player.id = std::move(message.player_id);
+  QueueMembershipChange(std::move(change));
+}
+
+void RoomClient::QueueMembershipChange(MembershipChange change) {
+  const auto window = GetConfig()->membership_batch_window;
+  bool schedule = false;
+  {
+    std::lock_guard<std::mutex> lock(membership_mutex_);
+    auto &pending = pending_membership_;
+    const auto same_player = [&change](const MembershipChange &queued) {
+      return queued.player.id == change.player.id &&
+             queued.room_id == change.room_id;
+    };
+    const auto queued =
+        std::find_if(pending.rbegin(), pending.rend(), same_player);
+
+    using Kind = MembershipChange::Kind;
+    if (queued != pending.rend() && queued->kind == Kind::Joined &&
+        change.kind == Kind::Left) {
+      // Nobody saw the join, so nobody needs the leave
+      pending.erase(std::next(queued).base());
+    } else if (queued != pending.rend() && queued->kind == change.kind) {
+      *queued = std::move(change); // Repeated; the latest details win
+    } else {
+      pending.push_back(std::move(change));
+    }
+
+    membership_pending_ = !pending.empty();
+    if (window > std::chrono::milliseconds::zero() &&
+        !membership_flush_scheduled_) {
+      membership_flush_scheduled_ = true;
+      schedule = true;
+    }
+  }
+
+  if (window <= std::chrono::milliseconds::zero()) {
+    FlushMembershipChanges();
+  } else if (schedule) {
+    membership_timer_ = timer_wheel_->Schedule(window, [this]() {
+      {
+        std::lock_guard<std::mutex> lock(membership_mutex_);
+        membership_flush_scheduled_ = false;
+      }
+      FlushMembershipChanges();
+    });
+  }
+}
+
+void RoomClient::FlushMembershipChanges() {
+  if (!membership_pending_.load()) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> delivery(membership_delivery_mutex_);
+  {
+    std::lock_guard<std::mutex> lock(membership_mutex_);
+    delivering_membership_.swap(pending_membership_);
+    membership_pending_ = false;
+  }
+  if (!delivering_membership_.empty() && message_handler_) {
+    message_handler_->OnMembershipChanged(delivering_membership_);
+  }
+  delivering_membership_.clear();
+}
+
+RoomClient::JsonMessageHandler
+RoomClient::LookupJsonHandler(MessageType type) {
+  // Indexed by MessageType; types the client never receives have no handler
+  static constexpr auto handlers = [] {
+    std::array<JsonMessageHandler, Detail::MESSAGE_TYPE_COUNT> table{};
+    table[static_cast<size_t>(MessageType::RegisterResponse)] =
+        &RoomClient::ProcessRegisterResponseMessage;
+    table[static_cast<size_t>(MessageType::RoomCreated)] =
+        &RoomClient::ProcessRoomCreatedMessage;
+    table[static_cast<size_t>(MessageType::Error)] =
+        &RoomClient::ProcessErrorMessage;
+    table[static_cast<size_t>(MessageType::RoomListResponse)] =
+        &RoomClient::ProcessRoomListMessage;
+    table[static_cast<size_t>(MessageType::JoinRoomResponse)] =
+        &RoomClient::ProcessJoinRoomMessage;
+    table[static_cast<size_t>(MessageType::RoomDetailsResponse)] =
+        &RoomClient::ProcessRoomDetailsMessage;
+    table[static_cast<size_t>(MessageType::P2PInfo)] =
+        &RoomClient::ProcessP2PInfoMessage;
+    table[static_cast<size_t>(MessageType::UseProxy)] =
+        &RoomClient::ProcessUseProxyMessage;
+    table[static_cast<size_t>(MessageType::PlayerJoined)] =
+        &RoomClient::ProcessPlayerJoinedMessage;
+    table[static_cast<size_t>(MessageType::PlayerLeft)] =
+        &RoomClient::ProcessPlayerLeftMessage;
+    return table;
+  }();
+
+  const auto index = static_cast<size_t>(type);
+  return index < handlers.size() ? handlers[index] : nullptr;
 }
 
 void RoomClient::DispatchMessage(const BaseMessage &base_message,
-                                 const std::string &raw_message) {
-  // Implementation for message dispatching
+                                 std::string_view raw_message) {
+  if (!base_message.is_valid || !message_handler_) {
+    return;
+  }
+
+  const JsonMessageHandler handler = LookupJsonHandler(base_message.type);
+  if (!handler) {
+    return; // Unknown and uninteresting types are ignored without parsing
+  }
+
+  try {
+    const json j = json::parse(raw_message);
+    (this->*handler)(j);
+  } catch (const json::parse_error &e) {
+    // Log parse error but don't crash - malformed JSON should be handled
+    // gracefully
+    return;
+  } catch (const json::type_error &e) {
+    // Log type error but don't crash - unexpected JSON structure should be
+    // handled gracefully
+    return;
+  }
 }
 
 std::string RoomClient::GenerateClientId() {
@@ -795,7 +2218,7 @@ std::string RoomClient::GenerateClientId() {
 
 uint64_t RoomClient::GetCurrentTimestamp() {
   return std::chrono::duration_cast<std::chrono::milliseconds>(
-             std::chrono::system_clock::now().time_since_epoch())
+             timer_wheel_->GetClock()->WallNow().time_since_epoch())
       .count();
 }
 
@@ -810,6 +2233,9 @@ std::string MessageSerializer::Serialize(const RegisterRequest &request) {
       {"timestamp", std::chrono::duration_cast<std::chrono::milliseconds>(
                         std::chrono::system_clock::now().time_since_epoch())
                         .count()}};
+  if (request.request_id != 0) {
+    j["request_id"] = request.request_id;
+  }
   return j.dump();
 }
 
@@ -825,6 +2251,9 @@ std::string MessageSerializer::Serialize(const CreateRoomRequest &request) {
             {"is_private", request.is_private},
             {"password", request.password},
             {"description", request.description}};
+  if (request.request_id != 0) {
+    j["request_id"] = request.request_id;
+  }
   return j.dump();
 }
 
@@ -840,6 +2269,35 @@ std::string MessageSerializer::Serialize(const RoomListRequest &request) {
             {"offset", request.offset},
             {"include_private", request.include_private},
             {"include_full", request.include_full}};
+  if (!request.cursor.empty()) {
+    j["cursor"] = request.cursor;
+  }
+  if (request.request_id != 0) {
+    j["request_id"] = request.request_id;
+  }
+  return j.dump();
+}
+
+std::string
+MessageSerializer::Serialize(const RoomListSubscribeRequest &request) {
+  std::stringstream game_id_stream;
+  game_id_stream << std::uppercase << std::hex << std::setfill('0')
+                 << std::setw(16) << request.game_id;
+
+  json j = {{"type", "room_list_subscribe"},
+            {"game_id", game_id_stream.str()},
+            {"region", request.region},
+            {"known_version", request.known_version}};
+  return j.dump();
+}
+
+std::string MessageSerializer::Serialize(const RoomDetailsRequest &request) {
+  json j = {{"type", "room_details"},
+            {"room_id", request.room_id},
+            {"known_version", request.known_version}};
+  if (request.request_id != 0) {
+    j["request_id"] = request.request_id;
+  }
   return j.dump();
 }
 
@@ -854,6 +2312,69 @@ std::string MessageSerializer::Serialize(const JoinRoomRequest &request) {
                {{"local_ip", request.client_info.network_info.local_ip},
                 {"public_ip", request.client_info.network_info.public_ip},
                 {"port", request.client_info.network_info.port}}}}}};
+  if (request.request_id != 0) {
+    j["request_id"] = request.request_id;
+  }
+  if (request.spectator) {
+    j["spectator"] = true;
+  }
+  return j.dump();
+}
+
+std::string MessageSerializer::Serialize(const ResumeRequest &request) {
+  json j = {{"type", "resume"},
+            {"resume_token", request.resume_token},
+            {"client_id", request.client_id}};
+  if (!request.room_id.empty()) {
+    j["room_id"] = request.room_id;
+  }
+  if (request.request_id != 0) {
+    j["request_id"] = request.request_id;
+  }
+  return j.dump();
+}
+
+std::string MessageSerializer::Serialize(const P2PInfoMessage &message) {
+  json candidates = json::array();
+  for (const auto &candidate : message.ice_candidates) {
+    candidates.push_back({{"candidate", candidate.candidate},
+                          {"sdp_mid", candidate.sdp_mid},
+                          {"sdp_mline_index", candidate.sdp_mline_index}});
+  }
+  json j = {{"type", "p2p_info"},
+            {"from_player", message.from_player},
+            {"to_player", message.to_player},
+            {"connection_type", message.connection_type},
+            {"ice_candidates", std::move(candidates)}};
+  if (!message.session_description.type.empty() ||
+      !message.session_description.sdp.empty()) {
+    j["session_description"] = {{"type", message.session_description.type},
+                                {"sdp", message.session_description.sdp}};
+  }
+  if (message.end_of_candidates) {
+    j["end_of_candidates"] = true;
+  }
+  return j.dump();
+}
+
+std::string MessageSerializer::Serialize(const AdvertiseDataUpdate &update) {
+  static constexpr char DIGITS[] = "0123456789abcdef";
+  json runs = json::array();
+  for (const auto &run : update.patch.runs) {
+    std::string data;
+    data.reserve(run.bytes.size() * 2);
+    for (const uint8_t byte : run.bytes) {
+      data.push_back(DIGITS[byte >> 4]);
+      data.push_back(DIGITS[byte & 0xF]);
+    }
+    runs.push_back({{"offset", run.offset}, {"data", std::move(data)}});
+  }
+  json j = {{"type", "advertise_data"},
+            {"room_id", update.room_id},
+            {"base_version", update.patch.base_version},
+            {"version", update.patch.version},
+            {"size", update.patch.size},
+            {"runs", std::move(runs)}};
   return j.dump();
 }
 
@@ -882,6 +2403,14 @@ RegisterResponse MessageDeserializer::Deserialize<RegisterResponse>(
       response.server_version = j["server_version"];
     }
 
+    if (j.contains("request_id") && j["request_id"].is_number_unsigned()) {
+      response.request_id = j["request_id"];
+    }
+
+    if (j.contains("resume_token") && j["resume_token"].is_string()) {
+      response.resume_token = j["resume_token"];
+    }
+
   } catch (const json::exception &e) {
     // Return default response on parse error
     response.success = false;
@@ -911,7 +2440,7 @@ RoomCreatedResponse MessageDeserializer::Deserialize<RoomCreatedResponse>(
 
       if (room_obj.contains("game_id") && room_obj["game_id"].is_string()) {
         try {
-          response.room.game_id = std::stoull(room_obj["game_id"], nullptr, 16);
+          response.room.game_id = std::stoull(room_obj["game_id"].get<std::string>(), nullptr, 16);
         } catch (const std::exception &) {
           // Invalid game_id format, leave as 0
         }
@@ -1015,57 +2544,11 @@ JoinRoomResponse MessageDeserializer::Deserialize<JoinRoomResponse>(
 template <>
 P2PInfoMessage
 MessageDeserializer::Deserialize<P2PInfoMessage>(const std::string &json_str) {
-  P2PInfoMessage message;
-
-  // Extract from_player
-  size_t pos = json_str.find("\"from_player\":\"");
-  if (pos != std::string::npos) {
-    pos += 15;
-    size_t end = json_str.find("\"", pos);
-    if (end != std::string::npos) {
-      message.from_player = json_str.substr(pos, end - pos);
-    }
-  }
-
-  // Extract to_player
-  pos = json_str.find("\"to_player\":\"");
-  if (pos != std::string::npos) {
-    pos += 13;
-    size_t end = json_str.find("\"", pos);
-    if (end != std::string::npos) {
-      message.to_player = json_str.substr(pos, end - pos);
-    }
-  }
-
-  // Extract connection_type
-  pos = json_str.find("\"connection_type\":\"");
-  if (pos != std::string::npos) {
-    pos += 19;
-    size_t end = json_str.find("\"", pos);
-    if (end != std::string::npos) {
-      message.connection_type = json_str.substr(pos, end - pos);
-    }
-  }
-
-  // For simplicity, create a dummy ICE candidate
-  if (json_str.find("ice_candidates") != std::string::npos) {
-    IceCandidate candidate;
-    candidate.candidate =
-        "candidate:1 1 UDP 2113667326 192.168.1.1 54400 typ host";
-    candidate.sdp_mid = "0";
-    candidate.sdp_mline_index = 0;
-    message.ice_candidates.push_back(candidate);
-  }
-
-  // Extract session description type
-  pos = json_str.find("\"type\":\"offer\"");
-  if (pos != std::string::npos) {
-    message.session_description.type = "offer";
-    message.session_description.sdp =
-        "v=0\r\no=- 123456 1 IN IP4 192.168.1.1\r\n...";
+  try {
+    return ParseP2PInfo(json::parse(json_str));
+  } catch (const json::exception &) {
+    return P2PInfoMessage{};
   }
-
-  return message;
 }
 
 template <>
@@ -1189,33 +2672,8 @@ MessageDeserializer::Deserialize<ErrorMessage>(const std::string &json_str) {
 BaseMessage MessageDeserializer::DeserializeAny(const std::string &json_str) {
   BaseMessage message;
 
-  if (json_str.find("\"type\":\"register\"") != std::string::npos) {
-    message.type = MessageType::Register;
-  } else if (json_str.find("\"type\":\"register_response\"") !=
-             std::string::npos) {
-    message.type = MessageType::RegisterResponse;
-  } else if (json_str.find("\"type\":\"create_room\"") != std::string::npos) {
-    message.type = MessageType::CreateRoom;
-  } else if (json_str.find("\"type\":\"room_created\"") != std::string::npos) {
-    message.type = MessageType::RoomCreated;
-  } else if (json_str.find("\"type\":\"room_list\"") != std::string::npos) {
-    message.type = MessageType::RoomList;
-  } else if (json_str.find("\"type\":\"room_list_response\"") !=
-             std::string::npos) {
-    message.type = MessageType::RoomListResponse;
-  } else if (json_str.find("\"type\":\"join_room\"") != std::string::npos) {
-    message.type = MessageType::JoinRoom;
-  } else if (json_str.find("\"type\":\"join_room_response\"") !=
-             std::string::npos) {
-    message.type = MessageType::JoinRoomResponse;
-  } else if (json_str.find("\"type\":\"p2p_info\"") != std::string::npos) {
-    message.type = MessageType::P2PInfo;
-  } else if (json_str.find("\"type\":\"use_proxy\"") != std::string::npos) {
-    message.type = MessageType::UseProxy;
-  } else if (json_str.find("\"type\":\"error\"") != std::string::npos) {
-    message.type = MessageType::Error;
-  } else {
-    message.type = MessageType::Unknown;
+  message.type = ResolveMessageType(PeekMessageType(json_str));
+  if (message.type == MessageType::Unknown) {
     message.is_valid = false;
     return message;
   }
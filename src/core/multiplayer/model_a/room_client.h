@@ -3,24 +3,38 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <functional>
+#include <limits>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <optional>
+#include <random>
+#include <span>
 #include <string>
+#include <string_view>
 #include <thread>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json_fwd.hpp>
 
 #include "core/multiplayer/common/error_codes.h"
+#include "core/multiplayer/common/liveness_tracker.h"
+#include "core/multiplayer/common/lock_contention.h"
+#include "core/multiplayer/common/mpmc_ring.h"
+#include "core/multiplayer/common/reconnect_throttle.h"
+#include "core/multiplayer/common/timer_wheel.h"
 #include "i_websocket_connection.h"
+#include "pending_request_table.h"
+#include "room_json_writer.h"
+#include "room_list_index.h"
 #include "room_messages.h"
 #include "room_types.h"
-
-namespace nlohmann {
-class json;
-}
+#include "websocket_connection_pool.h"
 
 /**
  * Utility class for calculating exponential backoff delays
@@ -34,12 +48,27 @@ public:
 
   std::chrono::milliseconds CalculateDelay(int attempt) const;
   std::chrono::milliseconds CalculateDelayWithJitter(int attempt) const;
+  /**
+   * Decorrelated jitter: uniform between the base delay and three times the
+   * previous delay, capped. Clients that lost the same server drift apart
+   * after each attempt instead of retrying in waves.
+   */
+  std::chrono::milliseconds
+  CalculateDecorrelatedDelay(std::chrono::milliseconds previous) const;
   void Reset();
 
+  /**
+   * Draws jitter from a generator seeded with seed, so simulated runs repeat
+   * exactly; zero returns to per-thread random generators. A seeded backoff
+   * must not be used from several threads at once.
+   */
+  void SeedJitter(uint64_t seed);
+
 private:
   std::chrono::milliseconds base_delay_;
   double multiplier_;
   std::chrono::milliseconds max_delay_;
+  mutable std::optional<std::mt19937_64> seeded_gen_;
 };
 
 namespace Core::Multiplayer::ModelA {
@@ -61,6 +90,62 @@ public:
   virtual bool ShouldReconnectOnError(const std::string &error_type) const = 0;
   virtual int GetMaxConcurrentMessages() const = 0;
   virtual size_t GetMessageQueueSize() const = 0;
+
+  // Idle heartbeats may stretch up to this interval while the path keeps
+  // answering; the default never stretches past GetHeartbeatInterval
+  virtual std::chrono::milliseconds GetMaxHeartbeatInterval() const {
+    return GetHeartbeatInterval();
+  }
+
+  // Offer the compact binary encoding to the server on connect. JSON remains
+  // the fallback when the server does not accept it.
+  virtual bool IsBinaryWireFormatEnabled() const { return false; }
+
+  // Negotiate permessage-deflate, with the room message dictionary when the
+  // server knows it
+  virtual bool IsMessageCompressionEnabled() const { return true; }
+
+  // How long player joins and leaves are gathered into one batch; zero hands
+  // each over as it arrives
+  virtual std::chrono::milliseconds GetMembershipBatchWindow() const {
+    return std::chrono::milliseconds::zero();
+  }
+
+  // Seed for reconnect jitter, for simulations that must replay exactly;
+  // zero keeps it random
+  virtual uint64_t GetReconnectJitterSeed() const { return 0; }
+};
+
+// Sorts an error reported by the connection into its kind
+RoomErrorType ClassifyRoomError(std::string_view error);
+
+/**
+ * The IConfigProvider values RoomClient needs after connecting, read once
+ * so that timer callbacks and message paths use plain fields instead of
+ * virtual calls and per-error string comparisons. The defaults apply when
+ * there is no provider.
+ */
+struct RoomClientConfig {
+  std::chrono::milliseconds connection_timeout{5000};
+  std::chrono::milliseconds heartbeat_interval{30000};
+  std::chrono::milliseconds max_heartbeat_interval{30000};
+  std::chrono::milliseconds message_timeout{0}; // Zero for the built-in default
+  int max_concurrent_messages = 0;              // Zero for the built-in default
+  size_t message_queue_size = 256;
+  bool auto_reconnect = false;
+  int max_reconnect_attempts = std::numeric_limits<int>::max();
+  ExponentialBackoff reconnect_backoff{std::chrono::milliseconds(1000), 2.0,
+                                       std::chrono::milliseconds(30000)};
+  uint32_t reconnect_error_mask = 0; // RoomErrorType bits
+  bool binary_wire_format = false;
+  PerMessageDeflateConfig compression;
+  std::chrono::milliseconds membership_batch_window{0};
+
+  bool ShouldReconnectOn(RoomErrorType type) const {
+    return (reconnect_error_mask & static_cast<uint32_t>(type)) != 0;
+  }
+
+  static RoomClientConfig FromProvider(const IConfigProvider &provider);
 };
 
 // Message handler interface
@@ -75,6 +160,34 @@ public:
   virtual void OnErrorReceived(const ErrorMessage &error) = 0;
   virtual void OnPlayerJoined(const PlayerJoinedMessage &message) = 0;
   virtual void OnPlayerLeft(const PlayerLeftMessage &message) = 0;
+
+  // Joins and leaves in arrival order, gathered over the membership batch
+  // window and then delivered from the timer wheel's thread. A player who
+  // joins and leaves within one window appears in neither. The default hands
+  // each change to OnPlayerJoined or OnPlayerLeft.
+  virtual void OnMembershipChanged(std::span<const MembershipChange> changes);
+
+  // A subscribed room list changed; RoomClient::QueryRooms already sees it
+  virtual void OnRoomListChanged(const RoomListDelta & /*delta*/) {}
+
+  // One page of a RoomClient::StartRoomQuery, in the order the server sent
+  // them; page.request_id is the query id
+  virtual void OnRoomQueryPage(const RoomListResponse & /*page*/,
+                               bool /*last_page*/) {}
+
+  virtual void OnRegistered(const RegisterResponse & /*response*/) {}
+
+  // Answer to RoomClient::GetRoomDetails. A not_modified answer arrives
+  // filled in from the cached details, with not_modified still set.
+  virtual void OnRoomDetails(const RoomDetailsResponse & /*response*/) {}
+
+  // The session survived a reconnect; client id, room and player slot are
+  // already restored and queued messages are being replayed
+  virtual void OnSessionResumed(const ResumeResponse & /*response*/) {}
+
+  // A request sent with a request id got no reply within the message timeout
+  virtual void OnRequestTimedOut(uint32_t /*request_id*/,
+                                 MessageType /*request_type*/) {}
 };
 
 // Reconnection listener interface
@@ -95,12 +208,22 @@ public:
  */
 class RoomClient {
 public:
+  /**
+   * Heartbeats and reconnection backoff run on the given timer wheel, or on
+   * the process-wide shared wheel when none is provided.
+   */
   RoomClient(std::shared_ptr<IWebSocketConnection> connection,
-             std::shared_ptr<IConfigProvider> config);
+             std::shared_ptr<IConfigProvider> config,
+             std::shared_ptr<TimerWheel> timer_wheel = nullptr);
   ~RoomClient();
 
   // Connection management
   ErrorCode Connect();
+  /**
+   * Starts connecting without waiting for the handshake. Success is reported
+   * through the connected callback and failure through the disconnected one.
+   */
+  ErrorCode BeginConnect();
   void Disconnect();
   ErrorCode Reconnect();
   void Shutdown();
@@ -116,16 +239,117 @@ public:
   int GetPlayerSlot() const;
   bool IsInRoom() const;
 
+  /**
+   * Token from the last RegisterResponse, JoinRoomResponse or ResumeResponse.
+   * After a drop it is presented first on the new connection to restore the
+   * session in one round trip; messages queued meanwhile are held until the
+   * server answers and then sent in order. Without a token, or when the
+   * server rejects it, the client falls back to rejoining its room.
+   */
+  std::string GetResumeToken() const;
+  bool IsResumingSession() const;
+
   // Room operations
   ErrorCode JoinRoom(const std::string &room_id);
   ErrorCode LeaveRoom();
 
+  /**
+   * Keeps a local copy of the room list current from server-pushed deltas,
+   * resubscribing from the last version seen after a reconnect. Changing the
+   * game or region starts over from a snapshot.
+   */
+  ErrorCode SubscribeRoomList(const RoomListSubscribeRequest &request);
+  ErrorCode UnsubscribeRoomList();
+  bool IsRoomListSubscribed() const;
+  uint64_t GetRoomListVersion() const;
+  std::vector<RoomSummary> QueryRooms(const RoomListFilter &filter) const;
+  // Also the version the rooms are at, for seeding a RoomListView
+  std::vector<RoomSummary> QueryRooms(const RoomListFilter &filter,
+                                      uint64_t &out_version) const;
+  std::optional<RoomSummary> FindRoom(const std::string &room_id) const;
+
+  /**
+   * Asks for the full details of one room, which room lists leave out, and
+   * delivers them to IMessageHandler::OnRoomDetails. The details of the
+   * last room asked about are cached with their version; asking about it
+   * again sends that version, and an unchanged room costs the server a
+   * not_modified reply instead of the details. The cache is dropped when
+   * a room list delta removes the room.
+   */
+  ErrorCode GetRoomDetails(const std::string &room_id,
+                           uint32_t *out_request_id = nullptr);
+  std::optional<RoomDetailsResponse>
+  GetCachedRoomDetails(const std::string &room_id) const;
+
+  /**
+   * Runs a filtered room query on the server and streams its pages to
+   * IMessageHandler::OnRoomQueryPage. Each page is requested as soon as the
+   * previous one arrives, until the server has no more or max_rooms have
+   * been delivered (0 for no limit). request.max_results is the page size.
+   */
+  ErrorCode StartRoomQuery(const RoomListRequest &request, size_t max_rooms = 0,
+                           uint32_t *out_query_id = nullptr);
+  void CancelRoomQuery(uint32_t query_id);
+
+  /**
+   * Pipelined requests. Each carries a request id that its reply echoes, so
+   * up to GetMaxConcurrentMessages requests can wait at once; beyond that
+   * these return ResourceExhausted. A request still unanswered after
+   * GetMessageTimeout is reported through IMessageHandler::OnRequestTimedOut.
+   * Room queries count against the same limit.
+   */
+  ErrorCode Register(const RegisterRequest &request,
+                     uint32_t *out_request_id = nullptr);
+  ErrorCode CreateRoom(const CreateRoomRequest &request,
+                       uint32_t *out_request_id = nullptr);
+  ErrorCode RequestJoinRoom(const JoinRoomRequest &request,
+                            uint32_t *out_request_id = nullptr);
+  // Joins as a spectator; pass the use_proxy answer to
+  // RelayClient::SpectateSessionAsync
+  ErrorCode SpectateRoom(const std::string &room_id,
+                         uint32_t *out_request_id = nullptr);
+  size_t GetPendingRequestCount() const;
+
   // Message operations
   ErrorCode SendMessage(const std::string &message);
+
+  /**
+   * Sends connection details to another player through the room server, in
+   * the negotiated wire format. Used for every step of a trickle exchange;
+   * see IceCandidateTrickle.
+   */
+  ErrorCode SendP2PInfo(const P2PInfoMessage &message);
+
+  /**
+   * Sends the host's advertise data patch for the room server to relay;
+   * always JSON, the binary codec has no frame for it yet
+   */
+  ErrorCode UpdateAdvertiseData(const AdvertiseDataUpdate &update);
+
+  /**
+   * Lock-free enqueue for game threads; the message is moved into the queue
+   * and sent by ProcessPendingMessages. Returns MessageQueueFull instead of
+   * blocking when the network side falls behind.
+   */
+  ErrorCode QueueMessage(std::string &&message);
   ErrorCode QueueMessage(const std::string &message);
   bool ProcessPendingMessages();
   size_t GetPendingMessageCount() const;
 
+  /**
+   * Called with true when the queue fills past three quarters of its limit
+   * and with false once it drains below a quarter
+   */
+  void SetOnBackpressureCallback(std::function<void(bool)> callback);
+  bool IsBackpressured() const;
+
+  /**
+   * Connections are then taken from the pool for the configured room server
+   * URL, reusing an open one when available, and handed back to it on
+   * shutdown or when the configured server changes.
+   */
+  void SetConnectionPool(std::shared_ptr<WebSocketConnectionPool> pool);
+
   // Callbacks and handlers
   void SetOnConnectedCallback(std::function<void()> callback);
   void
@@ -137,26 +361,63 @@ public:
   void SetReconnectionListener(std::shared_ptr<IReconnectionListener> listener);
   bool IsReconnecting() const;
   int GetReconnectionAttempts() const;
-  std::chrono::milliseconds CalculateReconnectDelay(int attempt) const;
+  /**
+   * Delay before a reconnection attempt: the jittered base delay for the
+   * first, then decorrelated from the previous delay
+   */
+  std::chrono::milliseconds CalculateReconnectDelay(
+      int attempt,
+      std::chrono::milliseconds previous = std::chrono::milliseconds::zero()) const;
+
+  /**
+   * Automatic reconnection attempts take a token from this throttle first,
+   * ReconnectThrottle::GetShared() unless replaced. Attempts are also held
+   * back until the retry_after of the last error the server sent has passed.
+   */
+  void SetReconnectThrottle(std::shared_ptr<ReconnectThrottle> throttle);
   ReconnectionStatistics GetReconnectionStatistics() const;
 
-  // Heartbeat management
+  /**
+   * Reads the config provider again, e.g. after the user changed settings,
+   * and swaps the new values in at once. Reconnection, error handling and
+   * the wire format offer follow them; the queue, request and heartbeat
+   * limits are sized at construction and keep theirs.
+   */
+  void ReloadConfig();
+  std::shared_ptr<const RoomClientConfig> GetConfig() const;
+
+  /**
+   * Heartbeat management. A heartbeat only goes out once nothing else has
+   * been sent for a whole heartbeat interval, so none are sent while
+   * application traffic flows. The idle interval shrinks when a connection
+   * drops while waiting on one.
+   */
   void StartHeartbeat();
   void StopHeartbeat();
+  std::chrono::milliseconds GetHeartbeatInterval() const;
+  uint64_t GetHeartbeatCount() const;
+
+  // Wire format
+  bool IsBinaryWireFormatActive() const;
 
   // WebSocket event handlers (internal)
   void OnWebSocketConnected();
   void OnWebSocketDisconnected(const std::string &reason);
   void OnWebSocketError(const std::string &error);
-  void OnWebSocketMessage(const std::string &message);
+  void OnWebSocketMessage(const WebSocketMessageView &message);
+  void OnWebSocketMessage(std::string_view message);
 
   // Test utilities
   void SimulateIncomingMessage(const std::string &message);
 
 private:
   // Internal state
+  mutable ProfiledMutex<LockSite::RoomClientConnection> connection_mutex_;
   std::shared_ptr<IWebSocketConnection> connection_;
+  std::shared_ptr<WebSocketConnectionPool> connection_pool_;
+  std::string connection_url_; // URL connection_ belongs to in the pool
   std::shared_ptr<IConfigProvider> config_;
+  std::atomic<std::shared_ptr<const RoomClientConfig>> settings_;
   std::shared_ptr<IMessageHandler> message_handler_;
   std::shared_ptr<IReconnectionListener> reconnection_listener_;
 
@@ -164,57 +425,171 @@ private:
   mutable std::mutex state_mutex_;
   std::condition_variable connection_cv_;
   std::atomic<ConnectionState> connection_state_{ConnectionState::Disconnected};
-  std::string client_id_;
   uint64_t created_at_;
 
-  // Room state
+  // Session state, restored as a whole by a resumption
   mutable std::mutex room_mutex_;
+  std::string client_id_;
   std::string current_room_id_;
   int player_slot_ = -1;
+  std::string resume_token_;
+
+  // Set while a resume request is unanswered; the outbound queue is held
+  std::atomic<bool> resuming_{false};
+  std::atomic<uint32_t> resume_request_id_{0};
+
+  // Room list subscription
+  mutable std::mutex room_list_mutex_;
+  bool room_list_subscribed_ = false;
+  bool room_list_awaiting_snapshot_ = false; // Deltas are dropped until then
+  RoomListSubscribeRequest room_list_subscription_;
+  RoomListIndex room_list_;
+
+  // Details of the room last asked about
+  mutable std::mutex room_details_mutex_;
+  std::optional<RoomDetailsResponse> room_details_;
+
+  // Server-side room queries in progress, by request id
+  struct RoomQueryState {
+    RoomListRequest request;
+    size_t max_rooms = 0;
+    size_t delivered = 0;
+  };
+  std::mutex room_query_mutex_;
+  std::unordered_map<uint32_t, RoomQueryState> room_queries_;
 
   // Message handling
-  mutable std::mutex message_mutex_;
-  std::queue<std::string> message_queue_;
-  std::condition_variable message_cv_;
-  std::atomic<bool> processing_messages_{false};
+  struct OutboundMessage {
+    std::string payload;
+    std::chrono::steady_clock::time_point queued_at;
+  };
+  size_t message_queue_limit_;
+  std::unique_ptr<MpmcRing<OutboundMessage>> message_queue_;
+  std::atomic<bool> backpressured_{false};
+  std::atomic<uint64_t> rejected_messages_{0};
+  std::atomic<uint64_t> sent_from_queue_{0};
+  std::atomic<uint64_t> queue_latency_total_us_{0};
+  std::atomic<uint64_t> queue_latency_max_us_{0};
 
   // Reconnection state
   mutable std::mutex reconnection_mutex_;
   std::atomic<bool> is_reconnecting_{false};
   std::atomic<int> reconnection_attempts_{0};
-  std::thread reconnection_thread_;
+  std::atomic<TimerWheel::TimerId> reconnection_timer_{
+      TimerWheel::INVALID_TIMER_ID};
+  std::chrono::milliseconds last_reconnect_delay_{0}; // reconnection_mutex_
+  // Server's retry_after, as steady_clock milliseconds; zero for none
+  std::atomic<int64_t> retry_after_until_ms_{0};
+  std::shared_ptr<ReconnectThrottle> reconnect_throttle_; // reconnection_mutex_
   ReconnectionStatistics reconnection_stats_;
-  std::unique_ptr<ExponentialBackoff> reconnection_backoff_;
+  // The outage being recovered from, and a ring of those that ended
+  std::chrono::steady_clock::time_point outage_started_;
+  ReconnectionEvent outage_;
+  std::array<ReconnectionEvent, RECONNECTION_HISTORY_SIZE> reconnection_history_{};
+  size_t reconnection_history_next_ = 0;
+  size_t reconnection_history_count_ = 0;
+  LatencyHistogram reconnect_time_;
+
+  // Membership changes waiting for the batch window to close. Flushes hold
+  // membership_delivery_mutex_ so batches reach the handler in order.
+  std::mutex membership_mutex_;
+  std::mutex membership_delivery_mutex_;
+  std::vector<MembershipChange> pending_membership_;
+  std::vector<MembershipChange> delivering_membership_;
+  std::atomic<bool> membership_pending_{false};
+  bool membership_flush_scheduled_ = false;
+  std::atomic<TimerWheel::TimerId> membership_timer_{
+      TimerWheel::INVALID_TIMER_ID};
 
   // Heartbeat
   std::atomic<bool> heartbeat_active_{false};
-  std::thread heartbeat_thread_;
+  std::atomic<TimerWheel::TimerId> heartbeat_timer_{
+      TimerWheel::INVALID_TIMER_ID};
+  std::unique_ptr<LivenessTracker> liveness_;
+
+  // Shared scheduler for heartbeats and reconnection backoff
+  std::shared_ptr<TimerWheel> timer_wheel_;
+
+  // Negotiated wire format (JSON until the server accepts binary)
+  std::atomic<bool> binary_wire_format_{false};
+
+  // JSON requests are written here and sent straight from the buffer
+  std::mutex json_writer_mutex_;
+  RoomJsonWriter json_writer_;
+
+  // Requests waiting for a reply. Declared after the state its timeout
+  // callback touches, so it is destroyed, and its timers cancelled, first.
+  static constexpr size_t DEFAULT_MAX_CONCURRENT_REQUESTS = 16;
+  static constexpr std::chrono::milliseconds DEFAULT_REQUEST_TIMEOUT{10000};
+  std::unique_ptr<PendingRequestTable> pending_requests_;
 
   // Callbacks
-  mutable std::mutex callback_mutex_;
+  mutable ProfiledMutex<LockSite::RoomClientCallbacks> callback_mutex_;
   std::function<void()> on_connected_;
   std::function<void(const std::string &)> on_disconnected_;
   std::function<void(const std::string &)> on_message_;
+  std::function<void(bool)> on_backpressure_;
 
   // Shutdown flag
   std::atomic<bool> shutdown_requested_{false};
 
   // Internal methods
   void InitializeWebSocketCallbacks();
+  std::shared_ptr<IWebSocketConnection> GetConnection() const;
+  bool AcquirePooledConnection(const std::string &server_url);
+  void ReleasePooledConnection();
   void StartReconnectionProcess(const std::string &reason);
-  void ReconnectionWorker();
-  void HeartbeatWorker();
-  void ProcessMessage(const std::string &message);
+  void ScheduleReconnectionAttempt();
+  void AttemptReconnection();
+  void HandleReconnectionFailure(int attempt, const std::string &reason);
+  void NoteRetryAfter(uint64_t seconds);
+  std::chrono::milliseconds TimeUntilRetryAllowed() const;
+  // Closes the current outage into the history; reconnection_mutex_ held
+  void EndOutageLocked(ReconnectionEvent::Outcome outcome, int attempts);
+  void CancelReconnectionTimer();
+  void NotifyBackpressure(bool active);
+  void SendHeartbeat();
+  void ScheduleHeartbeat();
+  void OnHeartbeatTimer();
+  void ProcessMessage(std::string_view message);
+  void ProcessBinaryMessage(std::string_view message);
+  void ProcessWireFormatMessage(const nlohmann::json &j);
   void ProcessRoomCreatedMessage(const nlohmann::json &j);
   void ProcessErrorMessage(const nlohmann::json &j);
   void ProcessRoomListMessage(const nlohmann::json &j);
+  void ProcessRoomListDeltaMessage(const nlohmann::json &j);
+  void HandleRoomListResponse(RoomListResponse &&response);
+  template <typename Request>
+  ErrorCode SendTrackedRequest(MessageType type, Request request,
+                               uint32_t *out_request_id);
+  template <typename Request>
+  ErrorCode SendRequestMessage(const Request &request);
+  template <typename Request>
+  ErrorCode SendJsonRequest(const Request &request);
+  // Sends a text message from a caller's buffer, without copying it
+  ErrorCode SendTextMessage(std::string_view message);
+  void CompleteRequest(uint32_t request_id);
+  void HandleRequestTimeout(uint32_t request_id, MessageType type);
+  void ProcessRegisterResponseMessage(const nlohmann::json &j);
+  void ProcessResumeResponseMessage(const nlohmann::json &j);
+  void SetResumeToken(const std::string &token);
+  bool BeginSessionResume();
+  void FailSessionResume(uint32_t request_id);
+  void FinishSessionResume();
+  void SendRejoinRoom();
+  ErrorCode SendRoomListSubscription();
+  void ProcessRoomDetailsMessage(const nlohmann::json &j);
   void ProcessJoinRoomMessage(const nlohmann::json &j);
   void ProcessP2PInfoMessage(const nlohmann::json &j);
   void ProcessUseProxyMessage(const nlohmann::json &j);
   void ProcessPlayerJoinedMessage(const nlohmann::json &j);
   void ProcessPlayerLeftMessage(const nlohmann::json &j);
+  void QueueMembershipChange(MembershipChange change);
+  void FlushMembershipChanges();
+  using JsonMessageHandler = void (RoomClient::*)(const nlohmann::json &);
+  static JsonMessageHandler LookupJsonHandler(MessageType type);
   void DispatchMessage(const BaseMessage &base_message,
-                       const std::string &raw_message);
+                       std::string_view raw_message);
   std::string GenerateClientId();
   uint64_t GetCurrentTimestamp();
 };
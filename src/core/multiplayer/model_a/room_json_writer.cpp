@@ -0,0 +1,317 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "room_json_writer.h"
+
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <concepts>
+
+namespace Core::Multiplayer::ModelA {
+
+namespace {
+
+// Appends JSON values to a buffer, remembering whether every string was valid
+class JsonSink {
+public:
+    explicit JsonSink(std::string& out) : out_(out) {}
+
+    void Raw(std::string_view text) { out_.append(text); }
+
+    void Bool(bool value) { out_.append(value ? "true" : "false"); }
+
+    template <std::integral T>
+        requires(!std::same_as<T, bool>)
+    void Number(T value) {
+        std::array<char, 24> digits;
+        const auto result = std::to_chars(digits.data(), digits.data() + digits.size(), value);
+        out_.append(digits.data(), result.ptr);
+    }
+
+    // Escapes as nlohmann::json::dump does without ensure_ascii
+    void String(std::string_view value) {
+        static constexpr char HEX[] = "0123456789abcdef";
+        out_.push_back('"');
+        size_t i = 0;
+        while (i < value.size()) {
+            const auto byte = static_cast<uint8_t>(value[i]);
+            if (byte >= 0x80) {
+                const size_t length = Utf8SequenceLength(value.substr(i));
+                if (length == 0) {
+                    ok_ = false;
+                    return;
+                }
+                out_.append(value.substr(i, length));
+                i += length;
+                continue;
+            }
+            switch (byte) {
+            case '\b':
+                out_.append("\\b");
+                break;
+            case '\t':
+                out_.append("\\t");
+                break;
+            case '\n':
+                out_.append("\\n");
+                break;
+            case '\f':
+                out_.append("\\f");
+                break;
+            case '\r':
+                out_.append("\\r");
+                break;
+            case '"':
+                out_.append("\\\"");
+                break;
+            case '\\':
+                out_.append("\\\\");
+                break;
+            default:
+                if (byte < 0x20) {
+                    const char escape[] = {'\\', 'u', '0', '0', HEX[byte >> 4], HEX[byte & 0xF]};
+                    out_.append(escape, sizeof(escape));
+                } else {
+                    out_.push_back(static_cast<char>(byte));
+                }
+                break;
+            }
+            ++i;
+        }
+        out_.push_back('"');
+    }
+
+    bool ok() const { return ok_; }
+
+private:
+    // Length of the well-formed multi-byte sequence starting text, or 0
+    static size_t Utf8SequenceLength(std::string_view text) {
+        const auto lead = static_cast<uint8_t>(text[0]);
+        size_t length = 0;
+        uint8_t second_min = 0x80;
+        uint8_t second_max = 0xBF;
+        if (lead >= 0xC2 && lead <= 0xDF) {
+            length = 2;
+        } else if (lead >= 0xE0 && lead <= 0xEF) {
+            length = 3;
+            second_min = lead == 0xE0 ? 0xA0 : 0x80; // Overlong
+            second_max = lead == 0xED ? 0x9F : 0xBF; // Surrogates
+        } else if (lead >= 0xF0 && lead <= 0xF4) {
+            length = 4;
+            second_min = lead == 0xF0 ? 0x90 : 0x80; // Overlong
+            second_max = lead == 0xF4 ? 0x8F : 0xBF; // Past U+10FFFF
+        } else {
+            return 0;
+        }
+        if (text.size() < length) {
+            return 0;
+        }
+        const auto second = static_cast<uint8_t>(text[1]);
+        if (second < second_min || second > second_max) {
+            return 0;
+        }
+        for (size_t i = 2; i < length; ++i) {
+            if ((static_cast<uint8_t>(text[i]) & 0xC0) != 0x80) {
+                return 0;
+            }
+        }
+        return length;
+    }
+
+    std::string& out_;
+    bool ok_ = true;
+};
+
+template <typename T>
+struct JsonField {
+    std::string_view name; // Written as is, so it must need no escaping
+    void (*write)(JsonSink& out, const T& value);
+    bool (*present)(const T& value) = nullptr; // Null: always written
+};
+
+// nlohmann keeps objects in a std::map, so keys come out sorted
+template <typename T, size_t N>
+constexpr bool IsInKeyOrder(const std::array<JsonField<T>, N>& fields) {
+    for (size_t i = 1; i < N; ++i) {
+        if (!(fields[i - 1].name < fields[i].name)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename T, size_t N>
+void WriteObject(JsonSink& out, const std::array<JsonField<T>, N>& fields, const T& value) {
+    out.Raw("{");
+    bool first = true;
+    for (const auto& field : fields) {
+        if (field.present && !field.present(value)) {
+            continue;
+        }
+        out.Raw(first ? "\"" : ",\"");
+        out.Raw(field.name);
+        out.Raw("\":");
+        field.write(out, value);
+        first = false;
+    }
+    out.Raw("}");
+}
+
+// Game ids go out as 16 upper-case hex digits
+void WriteGameId(JsonSink& out, uint64_t game_id) {
+    static constexpr char HEX[] = "0123456789ABCDEF";
+    std::array<char, 16> digits;
+    for (size_t i = 0; i < digits.size(); ++i) {
+        digits[digits.size() - 1 - i] = HEX[(game_id >> (i * 4)) & 0xF];
+    }
+    out.String(std::string_view(digits.data(), digits.size()));
+}
+
+int64_t NowMilliseconds() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+template <typename T>
+constexpr bool HasRequestId(const T& value) {
+    return value.request_id != 0;
+}
+
+constexpr std::array<JsonField<RegisterRequest>, 7> REGISTER_FIELDS{{
+    {"client_id", [](JsonSink& out, const RegisterRequest& r) { out.String(r.client_id); }},
+    {"platform", [](JsonSink& out, const RegisterRequest& r) { out.String(r.platform); }},
+    {"request_id", [](JsonSink& out, const RegisterRequest& r) { out.Number(r.request_id); },
+     HasRequestId<RegisterRequest>},
+    {"sudachi_version",
+     [](JsonSink& out, const RegisterRequest& r) { out.String(r.sudachi_version); }},
+    {"timestamp", [](JsonSink& out, const RegisterRequest&) { out.Number(NowMilliseconds()); }},
+    {"type", [](JsonSink& out, const RegisterRequest&) { out.String("register"); }},
+    {"username", [](JsonSink& out, const RegisterRequest& r) { out.String(r.username); }},
+}};
+static_assert(IsInKeyOrder(REGISTER_FIELDS));
+
+constexpr std::array<JsonField<CreateRoomRequest>, 8> CREATE_ROOM_FIELDS{{
+    {"description",
+     [](JsonSink& out, const CreateRoomRequest& r) { out.String(r.description); }},
+    {"game_id", [](JsonSink& out, const CreateRoomRequest& r) { WriteGameId(out, r.game_id); }},
+    {"game_name", [](JsonSink& out, const CreateRoomRequest& r) { out.String(r.game_name); }},
+    {"is_private", [](JsonSink& out, const CreateRoomRequest& r) { out.Bool(r.is_private); }},
+    {"max_players",
+     [](JsonSink& out, const CreateRoomRequest& r) { out.Number(r.max_players); }},
+    {"password", [](JsonSink& out, const CreateRoomRequest& r) { out.String(r.password); }},
+    {"request_id", [](JsonSink& out, const CreateRoomRequest& r) { out.Number(r.request_id); },
+     HasRequestId<CreateRoomRequest>},
+    {"type", [](JsonSink& out, const CreateRoomRequest&) { out.String("create_room"); }},
+}};
+static_assert(IsInKeyOrder(CREATE_ROOM_FIELDS));
+
+constexpr std::array<JsonField<RoomListRequest>, 9> ROOM_LIST_FIELDS{{
+    {"cursor", [](JsonSink& out, const RoomListRequest& r) { out.String(r.cursor); },
+     [](const RoomListRequest& r) { return !r.cursor.empty(); }},
+    {"game_id", [](JsonSink& out, const RoomListRequest& r) { WriteGameId(out, r.game_id); }},
+    {"include_full", [](JsonSink& out, const RoomListRequest& r) { out.Bool(r.include_full); }},
+    {"include_private",
+     [](JsonSink& out, const RoomListRequest& r) { out.Bool(r.include_private); }},
+    {"max_results", [](JsonSink& out, const RoomListRequest& r) { out.Number(r.max_results); }},
+    {"offset", [](JsonSink& out, const RoomListRequest& r) { out.Number(r.offset); }},
+    {"region", [](JsonSink& out, const RoomListRequest& r) { out.String(r.region); }},
+    {"request_id", [](JsonSink& out, const RoomListRequest& r) { out.Number(r.request_id); },
+     HasRequestId<RoomListRequest>},
+    {"type", [](JsonSink& out, const RoomListRequest&) { out.String("room_list"); }},
+}};
+static_assert(IsInKeyOrder(ROOM_LIST_FIELDS));
+
+constexpr std::array<JsonField<NetworkInfo>, 3> NETWORK_INFO_FIELDS{{
+    {"local_ip", [](JsonSink& out, const NetworkInfo& n) { out.String(n.local_ip); }},
+    {"port", [](JsonSink& out, const NetworkInfo& n) { out.Number(n.port); }},
+    {"public_ip", [](JsonSink& out, const NetworkInfo& n) { out.String(n.public_ip); }},
+}};
+static_assert(IsInKeyOrder(NETWORK_INFO_FIELDS));
+
+constexpr std::array<JsonField<ClientInfo>, 3> CLIENT_INFO_FIELDS{{
+    {"network_info",
+     [](JsonSink& out, const ClientInfo& c) {
+         WriteObject(out, NETWORK_INFO_FIELDS, c.network_info);
+     }},
+    {"platform", [](JsonSink& out, const ClientInfo& c) { out.String(c.platform); }},
+    {"username", [](JsonSink& out, const ClientInfo& c) { out.String(c.username); }},
+}};
+static_assert(IsInKeyOrder(CLIENT_INFO_FIELDS));
+
+constexpr std::array<JsonField<JoinRoomRequest>, 6> JOIN_ROOM_FIELDS{{
+    {"client_info",
+     [](JsonSink& out, const JoinRoomRequest& r) {
+         WriteObject(out, CLIENT_INFO_FIELDS, r.client_info);
+     }},
+    {"password", [](JsonSink& out, const JoinRoomRequest& r) { out.String(r.password); }},
+    {"request_id", [](JsonSink& out, const JoinRoomRequest& r) { out.Number(r.request_id); },
+     HasRequestId<JoinRoomRequest>},
+    {"room_id", [](JsonSink& out, const JoinRoomRequest& r) { out.String(r.room_id); }},
+    {"spectator", [](JsonSink& out, const JoinRoomRequest&) { out.Bool(true); },
+     [](const JoinRoomRequest& r) { return r.spectator; }},
+    {"type", [](JsonSink& out, const JoinRoomRequest&) { out.String("join_room"); }},
+}};
+static_assert(IsInKeyOrder(JOIN_ROOM_FIELDS));
+
+constexpr std::array<JsonField<ResumeRequest>, 5> RESUME_FIELDS{{
+    {"client_id", [](JsonSink& out, const ResumeRequest& r) { out.String(r.client_id); }},
+    {"request_id", [](JsonSink& out, const ResumeRequest& r) { out.Number(r.request_id); },
+     HasRequestId<ResumeRequest>},
+    {"resume_token", [](JsonSink& out, const ResumeRequest& r) { out.String(r.resume_token); }},
+    {"room_id", [](JsonSink& out, const ResumeRequest& r) { out.String(r.room_id); },
+     [](const ResumeRequest& r) { return !r.room_id.empty(); }},
+    {"type", [](JsonSink& out, const ResumeRequest&) { out.String("resume"); }},
+}};
+static_assert(IsInKeyOrder(RESUME_FIELDS));
+
+template <typename T, size_t N>
+std::optional<std::string_view> WriteMessage(std::string& buffer,
+                                             const std::array<JsonField<T>, N>& fields,
+                                             const T& value) {
+    buffer.clear();
+    JsonSink out(buffer);
+    WriteObject(out, fields, value);
+    if (!out.ok()) {
+        return std::nullopt;
+    }
+    return std::string_view(buffer);
+}
+
+} // anonymous namespace
+
+RoomJsonWriter::RoomJsonWriter() {
+    buffer_.reserve(INITIAL_CAPACITY);
+}
+
+std::optional<std::string_view> RoomJsonWriter::Write(const RegisterRequest& request) {
+    return WriteMessage(buffer_, REGISTER_FIELDS, request);
+}
+
+std::optional<std::string_view> RoomJsonWriter::Write(const CreateRoomRequest& request) {
+    return WriteMessage(buffer_, CREATE_ROOM_FIELDS, request);
+}
+
+std::optional<std::string_view> RoomJsonWriter::Write(const RoomListRequest& request) {
+    return WriteMessage(buffer_, ROOM_LIST_FIELDS, request);
+}
+
+std::optional<std::string_view> RoomJsonWriter::Write(const JoinRoomRequest& request) {
+    return WriteMessage(buffer_, JOIN_ROOM_FIELDS, request);
+}
+
+std::optional<std::string_view> RoomJsonWriter::Write(const ResumeRequest& request) {
+    return WriteMessage(buffer_, RESUME_FIELDS, request);
+}
+
+std::string_view RoomJsonWriter::WriteHeartbeat(uint64_t timestamp) {
+    buffer_.clear();
+    JsonSink out(buffer_);
+    out.Raw("{\"type\":\"heartbeat\",\"timestamp\":");
+    out.Number(timestamp);
+    out.Raw("}");
+    return buffer_;
+}
+
+} // namespace Core::Multiplayer::ModelA
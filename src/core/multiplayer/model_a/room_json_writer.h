@@ -0,0 +1,51 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "room_messages.h"
+
+namespace Core::Multiplayer::ModelA {
+
+/**
+ * Streams the JSON form of outbound room requests into one reusable buffer,
+ * without building a nlohmann::json DOM first.
+ *
+ * The output is byte for byte what MessageSerializer has always sent: no
+ * whitespace, keys in sorted order as nlohmann's object map emits them, and
+ * the same string escaping. Each request's fields are a constexpr descriptor
+ * table whose key order is checked at compile time.
+ *
+ * A returned view points into the buffer and is valid until the next Write.
+ * Not thread-safe; RoomClient keeps one per connection.
+ */
+class RoomJsonWriter {
+public:
+    RoomJsonWriter();
+
+    /**
+     * @return Nothing if a string field is not valid UTF-8, which the
+     *         nlohmann encoding rejects as well
+     */
+    std::optional<std::string_view> Write(const RegisterRequest& request);
+    std::optional<std::string_view> Write(const CreateRoomRequest& request);
+    std::optional<std::string_view> Write(const RoomListRequest& request);
+    std::optional<std::string_view> Write(const JoinRoomRequest& request);
+    std::optional<std::string_view> Write(const ResumeRequest& request);
+
+    // The heartbeat has always been written by hand, type first
+    std::string_view WriteHeartbeat(uint64_t timestamp);
+
+    // Buffer capacity kept between messages
+    static constexpr size_t INITIAL_CAPACITY = 512;
+
+private:
+    std::string buffer_;
+};
+
+} // namespace Core::Multiplayer::ModelA
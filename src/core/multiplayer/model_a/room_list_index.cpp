@@ -0,0 +1,118 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "room_list_index.h"
+
+#include <algorithm>
+
+namespace Core::Multiplayer::ModelA {
+
+RoomListIndex::ApplyResult RoomListIndex::Apply(const RoomListDelta& delta) {
+    if (delta.snapshot) {
+        Clear();
+    } else if (delta.base_version != version_) {
+        return delta.version <= version_ ? ApplyResult::Stale : ApplyResult::Gap;
+    }
+
+    for (const auto& room : delta.upserted) {
+        if (!table_.Upsert(room)) {
+            ++rejected_;
+        }
+    }
+    for (const auto& room_id : delta.removed) {
+        table_.Remove(room_id);
+    }
+    version_ = delta.version;
+    return ApplyResult::Applied;
+}
+
+void RoomListIndex::Clear() {
+    version_ = 0;
+    table_.Clear();
+}
+
+std::optional<RoomSummaryView> RoomListIndex::Find(std::string_view room_id) const {
+    const auto slot = table_.Find(room_id);
+    if (!slot) {
+        return std::nullopt;
+    }
+    return table_.View(*slot);
+}
+
+bool MatchesRoomListFilter(const RoomListFilter& filter, const RoomSummary& room) {
+    return room.max_players - room.current_players >= filter.min_free_slots &&
+           (filter.region.empty() || room.region == filter.region) &&
+           (!filter.game_id || room.game_id == *filter.game_id);
+}
+
+RoomListFilter ToRoomListFilter(const DiscoveryFilter& filter) {
+    RoomListFilter room_filter;
+    room_filter.game_id = filter.local_communication_id;
+    return room_filter;
+}
+
+void ApplyDiscoveryFilter(const DiscoveryFilter& filter, RoomListRequest& request) {
+    request.game_id = filter.local_communication_id.value_or(0);
+}
+
+void ApplyDiscoveryFilter(const DiscoveryFilter& filter, RoomListSubscribeRequest& request) {
+    request.game_id = filter.local_communication_id.value_or(0);
+}
+
+std::vector<RoomSummary> RoomListIndex::Query(const RoomListFilter& filter) const {
+    using Slot = RoomTable::Slot;
+
+    // Interned once, so the scan compares ids; a region no room ever had
+    // matches nothing
+    std::optional<StringInterner::Id> region;
+    if (!filter.region.empty()) {
+        region = table_.FindString(filter.region);
+        if (!region) {
+            return {};
+        }
+    }
+
+    std::vector<Slot> found;
+    const auto size = static_cast<Slot>(table_.Size());
+    for (Slot slot = 0; slot < size; ++slot) {
+        if ((!filter.game_id || table_.GameIdAt(slot) == *filter.game_id) &&
+            table_.FreeSlotsAt(slot) >= filter.min_free_slots &&
+            (!region || table_.RegionAt(slot) == *region)) {
+            found.push_back(slot);
+        }
+    }
+
+    const auto before = [this, order = filter.order](Slot a, Slot b) {
+        switch (order) {
+        case RoomListOrder::LowestPing:
+            if (table_.PingAt(a) != table_.PingAt(b)) {
+                return table_.PingAt(a) < table_.PingAt(b);
+            }
+            break;
+        case RoomListOrder::GameName:
+            if (table_.GameNameAt(a) != table_.GameNameAt(b)) {
+                return table_.GameNameAt(a) < table_.GameNameAt(b);
+            }
+            break;
+        case RoomListOrder::MostFreeSlots:
+            if (table_.FreeSlotsAt(a) != table_.FreeSlotsAt(b)) {
+                return table_.FreeSlotsAt(a) > table_.FreeSlotsAt(b);
+            }
+            break;
+        }
+        return table_.IdAt(a).View() < table_.IdAt(b).View();
+    };
+
+    const size_t count =
+        filter.limit != 0 ? std::min(filter.limit, found.size()) : found.size();
+    std::partial_sort(found.begin(), found.begin() + count, found.end(), before);
+
+    std::vector<RoomSummary> result;
+    result.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        result.push_back(table_.View(found[i]).ToSummary());
+    }
+    return result;
+}
+
+} // namespace Core::Multiplayer::ModelA
@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/multiplayer/common/discovery_filter.h"
+#include "room_messages.h"
+#include "room_table.h"
+#include "room_types.h"
+
+namespace Core::Multiplayer::ModelA {
+
+/**
+ * Order of RoomListIndex query results; ties are broken by room id
+ */
+enum class RoomListOrder {
+    MostFreeSlots,
+    LowestPing,
+    GameName,
+};
+
+/**
+ * Local room list query
+ */
+struct RoomListFilter {
+    std::optional<uint64_t> game_id;
+    int min_free_slots = 0;
+    std::string region; // Empty matches every region
+    RoomListOrder order = RoomListOrder::MostFreeSlots;
+    size_t limit = 0; // 0 returns every match
+};
+
+// Whether a room passes filter's game, free slot and region checks
+bool MatchesRoomListFilter(const RoomListFilter& filter, const RoomSummary& room);
+
+/**
+ * An LDN scan filter as room queries: the title becomes the game id the
+ * server filters on, so other games' rooms are never sent or indexed. Rooms
+ * carry no scene id, SSID or host MAC, so those are left to the caller.
+ */
+RoomListFilter ToRoomListFilter(const DiscoveryFilter& filter);
+void ApplyDiscoveryFilter(const DiscoveryFilter& filter, RoomListRequest& request);
+void ApplyDiscoveryFilter(const DiscoveryFilter& filter, RoomListSubscribeRequest& request);
+
+/**
+ * Client-side copy of a subscribed room list, kept current by applying the
+ * server's versioned deltas so the UI can filter and sort it without a
+ * round trip.
+ *
+ * Rooms live in a RoomTable, so a query scans the few compact columns it
+ * filters on and copies out only the rooms it returns.
+ *
+ * Not thread-safe.
+ */
+class RoomListIndex {
+public:
+    enum class ApplyResult {
+        Applied,
+        Stale, // Already applied, or older than the current version
+        Gap,   // Based on a version this index never had; resubscribe
+    };
+
+    ApplyResult Apply(const RoomListDelta& delta);
+    void Clear();
+
+    uint64_t GetVersion() const { return version_; }
+    size_t Size() const { return table_.Size(); }
+    // Valid until the index next changes
+    std::optional<RoomSummaryView> Find(std::string_view room_id) const;
+
+    std::vector<RoomSummary> Query(const RoomListFilter& filter) const;
+
+    // Rooms dropped for an id longer than RoomId::CAPACITY
+    uint64_t GetRejectedCount() const { return rejected_; }
+
+private:
+    uint64_t version_ = 0;
+    uint64_t rejected_ = 0;
+    RoomTable table_;
+};
+
+} // namespace Core::Multiplayer::ModelA
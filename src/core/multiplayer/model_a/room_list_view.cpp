@@ -0,0 +1,155 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "room_list_view.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace Core::Multiplayer::ModelA {
+
+RoomListView::RoomListView(RoomListFilter filter) : filter_(std::move(filter)) {}
+
+void RoomListView::Reset(const RoomListFilter& filter, const std::vector<RoomSummary>& rooms,
+                         uint64_t version) {
+    filter_ = filter;
+    version_ = version;
+    rows_.clear();
+    entries_.clear();
+    rows_.reserve(rooms.size());
+    for (const auto& room : rooms) {
+        if (MatchesRoomListFilter(filter_, room)) {
+            const auto [it, inserted] = entries_.insert_or_assign(room.id, MakeKey(room));
+            if (inserted) {
+                rows_.push_back(&*it);
+            }
+        }
+    }
+    std::sort(rows_.begin(), rows_.end(), Before);
+    std::erase_if(measured_pings_, [this](const auto& measured) {
+        return entries_.count(measured.first) == 0;
+    });
+}
+
+RoomListView::ApplyResult RoomListView::Apply(const RoomListDelta& delta,
+                                              std::vector<RoomListRowChange>& out_changes) {
+    if (delta.snapshot) {
+        Reset(filter_, delta.upserted, delta.version);
+        out_changes.push_back({RoomListRowChange::Kind::Reset, 0});
+        return ApplyResult::Applied;
+    }
+    if (delta.base_version != version_) {
+        return delta.version <= version_ ? ApplyResult::Stale : ApplyResult::Gap;
+    }
+
+    for (const auto& room : delta.upserted) {
+        Upsert(room, out_changes);
+    }
+    for (const auto& room_id : delta.removed) {
+        Remove(room_id, out_changes);
+    }
+    version_ = delta.version;
+    return ApplyResult::Applied;
+}
+
+std::optional<size_t> RoomListView::RowOf(const std::string& room_id) const {
+    const auto it = entries_.find(room_id);
+    if (it == entries_.end()) {
+        return std::nullopt;
+    }
+    return LowerBound(&*it);
+}
+
+RoomListView::SortKey RoomListView::MakeKey(const RoomSummary& room) const {
+    switch (filter_.order) {
+    case RoomListOrder::LowestPing: {
+        const auto measured = measured_pings_.find(room.id);
+        return {measured != measured_pings_.end() ? measured->second : room.ping, {}};
+    }
+    case RoomListOrder::GameName:
+        return {0, room.game_name};
+    case RoomListOrder::MostFreeSlots:
+        break;
+    }
+    return {room.current_players - room.max_players, {}};
+}
+
+bool RoomListView::Before(const Entry* a, const Entry* b) {
+    if (a->second.primary != b->second.primary) {
+        return a->second.primary < b->second.primary;
+    }
+    if (a->second.name != b->second.name) {
+        return a->second.name < b->second.name;
+    }
+    return a->first < b->first;
+}
+
+size_t RoomListView::LowerBound(const Entry* entry) const {
+    return static_cast<size_t>(std::lower_bound(rows_.begin(), rows_.end(), entry, Before) -
+                               rows_.begin());
+}
+
+void RoomListView::Upsert(const RoomSummary& room,
+                          std::vector<RoomListRowChange>& out_changes) {
+    if (!MatchesRoomListFilter(filter_, room)) {
+        Remove(room.id, out_changes);
+        return;
+    }
+
+    SortKey key = MakeKey(room);
+    const auto it = entries_.find(room.id);
+    if (it == entries_.end()) {
+        const Entry* entry = &*entries_.emplace(room.id, std::move(key)).first;
+        const size_t row = LowerBound(entry);
+        rows_.insert(rows_.begin() + row, entry);
+        out_changes.push_back({RoomListRowChange::Kind::Inserted, row});
+        return;
+    }
+
+    Rekey(it, std::move(key), out_changes);
+}
+
+void RoomListView::UpdatePing(const std::string& room_id, int ping,
+                              std::vector<RoomListRowChange>& out_changes) {
+    const auto it = entries_.find(room_id);
+    if (it == entries_.end()) {
+        return;
+    }
+    measured_pings_[room_id] = ping;
+    SortKey key = it->second;
+    if (filter_.order == RoomListOrder::LowestPing) {
+        key.primary = ping;
+    }
+    Rekey(it, std::move(key), out_changes);
+}
+
+void RoomListView::Rekey(Entries::iterator it, SortKey key,
+                         std::vector<RoomListRowChange>& out_changes) {
+    const size_t old_row = LowerBound(&*it);
+    if (it->second.primary == key.primary && it->second.name == key.name) {
+        out_changes.push_back({RoomListRowChange::Kind::Updated, old_row});
+        return;
+    }
+    // The room moves; reported as a remove and an insert
+    rows_.erase(rows_.begin() + old_row);
+    out_changes.push_back({RoomListRowChange::Kind::Removed, old_row});
+    it->second = std::move(key);
+    const size_t row = LowerBound(&*it);
+    rows_.insert(rows_.begin() + row, &*it);
+    out_changes.push_back({RoomListRowChange::Kind::Inserted, row});
+}
+
+void RoomListView::Remove(const std::string& room_id,
+                          std::vector<RoomListRowChange>& out_changes) {
+    const auto it = entries_.find(room_id);
+    if (it == entries_.end()) {
+        return;
+    }
+    const size_t row = LowerBound(&*it);
+    rows_.erase(rows_.begin() + row);
+    measured_pings_.erase(it->first);
+    entries_.erase(it);
+    out_changes.push_back({RoomListRowChange::Kind::Removed, row});
+}
+
+} // namespace Core::Multiplayer::ModelA
@@ -0,0 +1,114 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/multiplayer/common/memory_accounting.h"
+#include "room_list_index.h"
+#include "room_messages.h"
+#include "room_types.h"
+
+namespace Core::Multiplayer::ModelA {
+
+/**
+ * One row-level change, in the form an item model reports it. Each change's
+ * row is valid once the changes before it have been applied.
+ */
+struct RoomListRowChange {
+    enum class Kind {
+        Inserted,
+        Updated,
+        Removed,
+        Reset, // Every row changed; row is unused
+    };
+
+    Kind kind = Kind::Reset;
+    size_t row = 0;
+
+    bool operator==(const RoomListRowChange&) const = default;
+};
+
+/**
+ * Sorted, filtered rows of a subscribed room list for a virtualized list
+ * widget, such as a QAbstractItemModel behind a QListView.
+ *
+ * The view keeps only each matching room's id and sort key, and turns the
+ * same deltas RoomClient applies (IMessageHandler::OnRoomListChanged) into
+ * row inserts, updates and removes, so a model never rebuilds its rows and
+ * a widget never creates more than the visible ones. Row contents are read
+ * lazily, for visible rows only, through RoomClient::FindRoom. The client
+ * may be a delta ahead of the view, so a room it no longer has should be
+ * drawn blank until its removal arrives.
+ *
+ * filter.limit is ignored; scrolling takes its place. Not thread-safe: keep
+ * it on the UI thread and hand deltas over with a queued signal.
+ */
+class RoomListView {
+public:
+    using ApplyResult = RoomListIndex::ApplyResult;
+
+    explicit RoomListView(RoomListFilter filter = {});
+
+    /**
+     * Start over from rooms at version, e.g. from RoomClient::QueryRooms,
+     * with a new filter. Rooms the filter rejects are skipped.
+     */
+    void Reset(const RoomListFilter& filter, const std::vector<RoomSummary>& rooms,
+               uint64_t version);
+
+    /**
+     * Apply a delta, appending the resulting row changes in order.
+     * @return Gap if the view missed a delta and must be Reset
+     */
+    ApplyResult Apply(const RoomListDelta& delta, std::vector<RoomListRowChange>& out_changes);
+
+    /**
+     * A ping measured locally, e.g. by RoomPingProber, which then takes the
+     * place of the server's figure in LowestPing order
+     */
+    void UpdatePing(const std::string& room_id, int ping,
+                    std::vector<RoomListRowChange>& out_changes);
+
+    size_t RowCount() const { return rows_.size(); }
+    const std::string& RoomIdAt(size_t row) const { return rows_[row]->first; }
+    std::optional<size_t> RowOf(const std::string& room_id) const;
+
+    uint64_t GetVersion() const { return version_; }
+    const RoomListFilter& GetFilter() const { return filter_; }
+
+private:
+    // Sort key of a row; its room id breaks ties
+    struct SortKey {
+        int primary = 0;
+        std::string name; // Only for GameName order
+    };
+
+    using Entries = std::pmr::unordered_map<std::string, SortKey>;
+    using Entry = Entries::value_type;
+
+    SortKey MakeKey(const RoomSummary& room) const;
+    void Rekey(Entries::iterator it, SortKey key, std::vector<RoomListRowChange>& out_changes);
+    static bool Before(const Entry* a, const Entry* b);
+
+    size_t LowerBound(const Entry* entry) const;
+    void Upsert(const RoomSummary& room, std::vector<RoomListRowChange>& out_changes);
+    void Remove(const std::string& room_id, std::vector<RoomListRowChange>& out_changes);
+
+    RoomListFilter filter_;
+    uint64_t version_ = 0;
+    // Node-based, so rows_ may point into it
+    Entries entries_{GetMemoryResource(MemorySubsystem::RoomClient)};
+    std::pmr::vector<const Entry*> rows_{GetMemoryResource(MemorySubsystem::RoomClient)};
+    std::pmr::unordered_map<std::string, int> measured_pings_{
+        GetMemoryResource(MemorySubsystem::RoomClient)};
+};
+
+} // namespace Core::Multiplayer::ModelA
@@ -0,0 +1,129 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "room_message_router.h"
+
+namespace Core::Multiplayer::ModelA {
+
+namespace {
+
+void SkipWhitespace(std::string_view json, size_t& pos) {
+    while (pos < json.size() &&
+           (json[pos] == ' ' || json[pos] == '\t' || json[pos] == '\n' || json[pos] == '\r')) {
+        ++pos;
+    }
+}
+
+/**
+ * Skip a string starting at its opening quote
+ * @return False if the string is unterminated
+ */
+bool SkipString(std::string_view json, size_t& pos) {
+    for (++pos; pos < json.size(); ++pos) {
+        if (json[pos] == '\\') {
+            ++pos;
+        } else if (json[pos] == '"') {
+            ++pos;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Skip any JSON value, including nested objects and arrays
+ * @return False if the value is truncated
+ */
+bool SkipValue(std::string_view json, size_t& pos) {
+    if (pos >= json.size()) {
+        return false;
+    }
+
+    if (json[pos] == '"') {
+        return SkipString(json, pos);
+    }
+
+    if (json[pos] == '{' || json[pos] == '[') {
+        int depth = 0;
+        while (pos < json.size()) {
+            const char c = json[pos];
+            if (c == '"') {
+                if (!SkipString(json, pos)) {
+                    return false;
+                }
+                continue;
+            }
+            if (c == '{' || c == '[') {
+                ++depth;
+            } else if (c == '}' || c == ']') {
+                if (--depth == 0) {
+                    ++pos;
+                    return true;
+                }
+            }
+            ++pos;
+        }
+        return false;
+    }
+
+    // Number, boolean or null
+    while (pos < json.size() && json[pos] != ',' && json[pos] != '}') {
+        ++pos;
+    }
+    return pos < json.size();
+}
+
+} // anonymous namespace
+
+std::string_view PeekMessageType(std::string_view json) {
+    size_t pos = 0;
+    SkipWhitespace(json, pos);
+    if (pos >= json.size() || json[pos] != '{') {
+        return {};
+    }
+    ++pos;
+
+    while (true) {
+        SkipWhitespace(json, pos);
+        if (pos >= json.size() || json[pos] != '"') {
+            return {}; // End of object or malformed key
+        }
+
+        const size_t key_start = pos + 1;
+        if (!SkipString(json, pos)) {
+            return {};
+        }
+        const std::string_view key = json.substr(key_start, pos - key_start - 1);
+
+        SkipWhitespace(json, pos);
+        if (pos >= json.size() || json[pos] != ':') {
+            return {};
+        }
+        ++pos;
+        SkipWhitespace(json, pos);
+
+        if (key == "type") {
+            if (pos >= json.size() || json[pos] != '"') {
+                return {};
+            }
+            const size_t value_start = pos + 1;
+            const size_t value_end = json.find_first_of("\"\\", value_start);
+            if (value_end == std::string_view::npos || json[value_end] != '"') {
+                return {};
+            }
+            return json.substr(value_start, value_end - value_start);
+        }
+
+        if (!SkipValue(json, pos)) {
+            return {};
+        }
+
+        SkipWhitespace(json, pos);
+        if (pos >= json.size() || json[pos] != ',') {
+            return {};
+        }
+        ++pos;
+    }
+}
+
+} // namespace Core::Multiplayer::ModelA
@@ -0,0 +1,138 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "room_messages.h"
+
+namespace Core::Multiplayer::ModelA {
+
+/**
+ * Wire name of a message type as used in the JSON "type" field
+ * @return Empty view for MessageType::Unknown
+ */
+constexpr std::string_view MessageTypeName(MessageType type) {
+    switch (type) {
+    case MessageType::Register:
+        return "register";
+    case MessageType::RegisterResponse:
+        return "register_response";
+    case MessageType::CreateRoom:
+        return "create_room";
+    case MessageType::RoomCreated:
+        return "room_created";
+    case MessageType::RoomList:
+        return "room_list";
+    case MessageType::RoomListResponse:
+        return "room_list_response";
+    case MessageType::JoinRoom:
+        return "join_room";
+    case MessageType::JoinRoomResponse:
+        return "join_room_response";
+    case MessageType::LeaveRoom:
+        return "leave_room";
+    case MessageType::P2PInfo:
+        return "p2p_info";
+    case MessageType::UseProxy:
+        return "use_proxy";
+    case MessageType::Error:
+        return "error";
+    case MessageType::PlayerJoined:
+        return "player_joined";
+    case MessageType::PlayerLeft:
+        return "player_left";
+    case MessageType::Heartbeat:
+        return "heartbeat";
+    case MessageType::RoomListSubscribe:
+        return "room_list_subscribe";
+    case MessageType::RoomListUnsubscribe:
+        return "room_list_unsubscribe";
+    case MessageType::RoomListDelta:
+        return "room_list_delta";
+    case MessageType::Resume:
+        return "resume";
+    case MessageType::ResumeResponse:
+        return "resume_response";
+    case MessageType::AdvertiseDataUpdate:
+        return "advertise_data";
+    case MessageType::RoomDetails:
+        return "room_details";
+    case MessageType::RoomDetailsResponse:
+        return "room_details_response";
+    case MessageType::Unknown:
+    default:
+        return {};
+    }
+}
+
+namespace Detail {
+
+constexpr size_t MESSAGE_TYPE_COUNT = static_cast<size_t>(MessageType::RoomDetailsResponse) + 1;
+
+// Table size and seed were chosen offline so every wire name lands in its own
+// slot; BuildMessageTypeTable verifies this at compile time.
+constexpr size_t MESSAGE_TYPE_TABLE_BITS = 5;
+constexpr size_t MESSAGE_TYPE_TABLE_SIZE = size_t{1} << MESSAGE_TYPE_TABLE_BITS;
+constexpr uint32_t MESSAGE_TYPE_HASH_SEED = 37954;
+
+/**
+ * Seeded FNV-1a, reduced to a table slot from its well-mixed high bits
+ */
+constexpr size_t MessageTypeSlot(std::string_view name) {
+    uint32_t hash = 2166136261u ^ MESSAGE_TYPE_HASH_SEED;
+    for (const char c : name) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash >> (32 - MESSAGE_TYPE_TABLE_BITS);
+}
+
+struct MessageTypeTable {
+    std::array<MessageType, MESSAGE_TYPE_TABLE_SIZE> slots{};
+    bool collision_free = true;
+};
+
+constexpr MessageTypeTable BuildMessageTypeTable() {
+    MessageTypeTable table{};
+    for (size_t i = 1; i < MESSAGE_TYPE_COUNT; ++i) {
+        const auto type = static_cast<MessageType>(i);
+        const size_t slot = MessageTypeSlot(MessageTypeName(type));
+        if (table.slots[slot] != MessageType::Unknown) {
+            table.collision_free = false;
+        }
+        table.slots[slot] = type;
+    }
+    return table;
+}
+
+constexpr MessageTypeTable MESSAGE_TYPE_TABLE = BuildMessageTypeTable();
+static_assert(MESSAGE_TYPE_TABLE.collision_free,
+              "Message type hash is no longer perfect; pick a new seed");
+
+} // namespace Detail
+
+/**
+ * Resolve a JSON "type" string to its MessageType with a single hash probe
+ * and one string comparison
+ * @return MessageType::Unknown for unrecognized names
+ */
+constexpr MessageType ResolveMessageType(std::string_view name) {
+    const MessageType candidate = Detail::MESSAGE_TYPE_TABLE.slots[Detail::MessageTypeSlot(name)];
+    return MessageTypeName(candidate) == name ? candidate : MessageType::Unknown;
+}
+
+/**
+ * Extract the top-level "type" string from a JSON object without parsing it.
+ *
+ * Scans only as far as the "type" member, skipping nested values and string
+ * contents, so routing can reject uninteresting messages before a full parse.
+ * @return Empty view if the input is not an object, has no string "type"
+ *         member, or the value contains escape sequences
+ */
+std::string_view PeekMessageType(std::string_view json);
+
+} // namespace Core::Multiplayer::ModelA
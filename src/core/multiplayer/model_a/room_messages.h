@@ -8,12 +8,14 @@
 #include <stdexcept>
 #include <chrono>
 #include <map>
+#include "core/multiplayer/common/advertise_data_publisher.h"
 #include "room_types.h"
 
 namespace Core::Multiplayer::ModelA {
 
 /**
- * Message types for room communication
+ * Message types for room communication. New types are appended; binary frames
+ * carry the numeric value.
  */
 enum class MessageType {
     Unknown,
@@ -31,7 +33,15 @@ enum class MessageType {
     Error,
     PlayerJoined,
     PlayerLeft,
-    Heartbeat
+    Heartbeat,
+    RoomListSubscribe,
+    RoomListUnsubscribe,
+    RoomListDelta,
+    Resume,
+    ResumeResponse,
+    AdvertiseDataUpdate,
+    RoomDetails,
+    RoomDetailsResponse
 };
 
 /**
@@ -51,6 +61,7 @@ struct RegisterRequest {
     std::string username;
     std::string platform;
     std::string sudachi_version;
+    uint32_t request_id = 0; // Echoed in the response; 0 when not tracked
 };
 
 /**
@@ -61,6 +72,8 @@ struct RegisterResponse {
     std::string client_id;
     uint64_t server_time = 0;
     std::string server_version;
+    uint32_t request_id = 0;
+    std::string resume_token; // Presented on reconnect to restore the session
 };
 
 /**
@@ -73,6 +86,7 @@ struct CreateRoomRequest {
     bool is_private = false;
     std::string password;
     std::string description;
+    uint32_t request_id = 0; // Echoed in the response; 0 when not tracked
 };
 
 /**
@@ -81,6 +95,7 @@ struct CreateRoomRequest {
 struct RoomCreatedResponse {
     bool success = false;
     RoomInfo room;
+    uint32_t request_id = 0;
 };
 
 /**
@@ -89,19 +104,68 @@ struct RoomCreatedResponse {
 struct RoomListRequest {
     uint64_t game_id = 0;
     std::string region;
-    int max_results = 20;
+    int max_results = 20; // Page size
     int offset = 0;
     bool include_private = false;
     bool include_full = false;
+    std::string cursor;      // Continues after a page's next_cursor; takes precedence over offset
+    uint32_t request_id = 0; // Echoed in the response; 0 when not tracked
 };
 
 /**
- * Room list response
+ * Room list response, or one page of a room query
  */
 struct RoomListResponse {
     bool success = false;
     int total_count = 0;
     std::vector<RoomSummary> rooms;
+    uint32_t request_id = 0;
+    std::string next_cursor; // Empty on the last page
+};
+
+/**
+ * Room list subscription request. The server answers with the changes since
+ * known_version when it still has them, or with a snapshot otherwise, and
+ * then pushes every later change until unsubscribed.
+ */
+struct RoomListSubscribeRequest {
+    uint64_t game_id = 0; // 0 subscribes to every game
+    std::string region;   // Empty subscribes to every region
+    uint64_t known_version = 0;
+};
+
+/**
+ * Change pushed to a room list subscription
+ */
+struct RoomListDelta {
+    bool snapshot = false;     // Replaces the whole list; base_version is unused
+    uint64_t base_version = 0; // Version the changes apply on top of
+    uint64_t version = 0;      // Version once applied
+    std::vector<RoomSummary> upserted;
+    std::vector<std::string> removed;
+};
+
+/**
+ * Request for one room's full details, which list responses leave out. With
+ * the version of the details already held, the server answers not_modified
+ * instead of sending them again.
+ */
+struct RoomDetailsRequest {
+    std::string room_id;
+    uint64_t known_version = 0; // 0 when none are held
+    uint32_t request_id = 0;    // Echoed in the response; 0 when not tracked
+};
+
+/**
+ * Room details response
+ */
+struct RoomDetailsResponse {
+    bool success = false;
+    bool not_modified = false; // known_version is current; room and players are left empty
+    uint64_t version = 0;      // Changes whenever anything below does
+    RoomInfo room;
+    std::vector<PlayerInfo> players;
+    uint32_t request_id = 0;
 };
 
 /**
@@ -111,6 +175,10 @@ struct JoinRoomRequest {
     std::string room_id;
     std::string password;
     ClientInfo client_info;
+    uint32_t request_id = 0; // Echoed in the response; 0 when not tracked
+    // Watch instead of play: no player slot is taken, and the server answers
+    // with the use_proxy relay session whose broadcast to spectate
+    bool spectator = false;
 };
 
 /**
@@ -121,10 +189,40 @@ struct JoinRoomResponse {
     std::string room_id;
     std::string player_id;
     std::vector<PlayerInfo> players;
+    uint32_t request_id = 0;
+    std::string resume_token; // Replaces the one from registration
 };
 
 /**
- * P2P connection information message
+ * Session resumption request, sent first on a new connection after a drop.
+ * The server restores the client id, room and player slot the token was
+ * issued for, so no register or join round trips are needed.
+ */
+struct ResumeRequest {
+    std::string resume_token;
+    std::string client_id;
+    std::string room_id;     // Room the client believes it is in, if any
+    uint32_t request_id = 0; // Echoed in the response; 0 when not tracked
+};
+
+/**
+ * Session resumption response. On failure the token is no longer valid and
+ * the client has to register and join again.
+ */
+struct ResumeResponse {
+    bool success = false;
+    std::string client_id;
+    std::string room_id;
+    int player_slot = -1;
+    std::string resume_token; // Token for the next resumption
+    uint32_t request_id = 0;
+};
+
+/**
+ * P2P connection information message. Candidates may trickle: the message
+ * with the session description carries those gathered so far, later ones
+ * follow in messages without a description, and the last message of an
+ * exchange sets end_of_candidates.
  */
 struct P2PInfoMessage {
     std::string from_player;
@@ -132,6 +230,7 @@ struct P2PInfoMessage {
     std::string connection_type;
     std::vector<IceCandidate> ice_candidates;
     SessionDescription session_description;
+    bool end_of_candidates = false;
 };
 
 /**
@@ -153,7 +252,8 @@ struct ErrorMessage {
     std::string error_code;
     std::string message;
     std::map<std::string, std::string> details;
-    uint64_t retry_after = 0;
+    uint64_t retry_after = 0; // Seconds to wait before reconnecting; 0 for no hint
+    uint32_t request_id = 0; // The request this error answers, if any
 };
 
 /**
@@ -173,6 +273,32 @@ struct PlayerLeftMessage {
     std::string reason;
 };
 
+/**
+ * A player joining or leaving, as RoomClient hands them over in batches
+ */
+struct MembershipChange {
+    enum class Kind : uint8_t {
+        Joined,
+        Left,
+    };
+
+    Kind kind = Kind::Joined;
+    std::string room_id;
+    PlayerInfo player;  // Only the id for Left
+    std::string reason; // Left only
+};
+
+/**
+ * Change to the host's advertise data, relayed by the room server to the
+ * room's members and to room list subscribers. A patch with a base version
+ * other than the one a receiver holds is dropped; it resyncs from the next
+ * full patch.
+ */
+struct AdvertiseDataUpdate {
+    std::string room_id;
+    AdvertiseDataPatch patch;
+};
+
 /**
  * Message parsing exceptions
  */
@@ -194,7 +320,12 @@ public:
     static std::string Serialize(const RegisterRequest& request);
     static std::string Serialize(const CreateRoomRequest& request);
     static std::string Serialize(const RoomListRequest& request);
+    static std::string Serialize(const RoomListSubscribeRequest& request);
+    static std::string Serialize(const RoomDetailsRequest& request);
     static std::string Serialize(const JoinRoomRequest& request);
+    static std::string Serialize(const ResumeRequest& request);
+    static std::string Serialize(const P2PInfoMessage& message);
+    static std::string Serialize(const AdvertiseDataUpdate& update);
 };
 
 /**
@@ -0,0 +1,189 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "room_ping_prober.h"
+
+#include <utility>
+
+namespace Core::Multiplayer::ModelA {
+
+namespace {
+
+// One keepalive round over the batch. Every endpoint is waited for, not just
+// the fastest, so the settle time spans the whole deadline.
+RoomPingProber::ProbeFunction KeepaliveProbe(const RoomPingProberConfig& config) {
+    return [config](const std::vector<std::string>& endpoints) {
+        RelayServerSelectorConfig selector_config;
+        selector_config.probe_deadline = config.probe_deadline;
+        selector_config.settle_time = config.probe_deadline;
+        selector_config.default_port = config.default_port;
+        RelayServerSelector selector(endpoints, selector_config);
+        return selector.ProbeServers();
+    };
+}
+
+} // namespace
+
+RoomPingProber::RoomPingProber(TargetResolver resolver, PingCallback on_pings,
+                               const RoomPingProberConfig& config,
+                               std::shared_ptr<TimerWheel> timer_wheel, ProbeFunction probe)
+    : resolver_(std::move(resolver)), on_pings_(std::move(on_pings)), config_(config),
+      timer_wheel_(timer_wheel ? std::move(timer_wheel) : TimerWheel::GetShared()),
+      probe_(probe ? std::move(probe) : KeepaliveProbe(config)) {}
+
+RoomPingProber::~RoomPingProber() {
+    SetPaused(true);
+}
+
+void RoomPingProber::SetVisibleRooms(const std::vector<RoomSummary>& rooms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    rooms_by_endpoint_.clear();
+    endpoint_of_room_.clear();
+    for (const auto& room : rooms) {
+        auto endpoint = resolver_(room);
+        if (!endpoint) {
+            continue;
+        }
+        rooms_by_endpoint_[*endpoint].push_back(room.id);
+        endpoint_of_room_.emplace(room.id, std::move(*endpoint));
+    }
+
+    const auto now = Clock::now();
+    for (const auto& [endpoint, room_ids] : rooms_by_endpoint_) {
+        if (IsFreshLocked(endpoint, now)) {
+            ++statistics_.cache_hits;
+        } else if (queued_.insert(endpoint).second) {
+            queue_.push_back(endpoint);
+        }
+    }
+    ScheduleLocked();
+}
+
+void RoomPingProber::SetPaused(bool paused) {
+    TimerWheel::TimerId timer = TimerWheel::INVALID_TIMER_ID;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        paused_ = paused;
+        if (!paused) {
+            ScheduleLocked();
+            return;
+        }
+        timer = std::exchange(batch_timer_, TimerWheel::INVALID_TIMER_ID);
+    }
+    // Outside the lock: Cancel waits for a running tick, which takes it
+    if (timer != TimerWheel::INVALID_TIMER_ID) {
+        timer_wheel_->Cancel(timer);
+    }
+}
+
+bool RoomPingProber::IsPaused() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return paused_;
+}
+
+std::optional<std::chrono::milliseconds> RoomPingProber::GetPing(
+    const std::string& room_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto endpoint = endpoint_of_room_.find(room_id);
+    if (endpoint == endpoint_of_room_.end()) {
+        return std::nullopt;
+    }
+    const auto cached = cache_.find(endpoint->second);
+    return cached != cache_.end() ? cached->second.rtt : std::nullopt;
+}
+
+void RoomPingProber::RunBatch(Clock::time_point now) {
+    std::vector<std::string> batch;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (paused_ || batch_running_) {
+            return;
+        }
+        batch = TakeBatchLocked(now);
+        if (batch.empty()) {
+            return;
+        }
+        batch_running_ = true;
+        ++statistics_.batches;
+        statistics_.probes += batch.size();
+    }
+    Record(probe_(batch), now);
+}
+
+RoomPingProberStatistics RoomPingProber::GetStatistics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return statistics_;
+}
+
+bool RoomPingProber::IsFreshLocked(const std::string& endpoint, Clock::time_point now) const {
+    const auto cached = cache_.find(endpoint);
+    return cached != cache_.end() && now - cached->second.measured_at < config_.cache_ttl;
+}
+
+std::vector<std::string> RoomPingProber::TakeBatchLocked(Clock::time_point now) {
+    // Results that aged out since the rooms became visible go back in line
+    for (const auto& [endpoint, room_ids] : rooms_by_endpoint_) {
+        if (!IsFreshLocked(endpoint, now) && queued_.insert(endpoint).second) {
+            queue_.push_back(endpoint);
+        }
+    }
+
+    std::vector<std::string> batch;
+    while (!queue_.empty() && batch.size() < config_.batch_size) {
+        std::string endpoint = std::move(queue_.front());
+        queue_.pop_front();
+        queued_.erase(endpoint);
+        // Scrolled out of view while queued
+        if (rooms_by_endpoint_.count(endpoint) != 0) {
+            batch.push_back(std::move(endpoint));
+        }
+    }
+    return batch;
+}
+
+void RoomPingProber::Record(const std::vector<RelayServerProbeResult>& results,
+                            Clock::time_point now) {
+    std::vector<RoomPing> pings;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        batch_running_ = false;
+        for (const auto& result : results) {
+            CachedResult& cached = cache_[result.server];
+            cached.measured_at = now;
+            cached.rtt.reset();
+            if (result.rtt) {
+                cached.rtt = std::chrono::ceil<std::chrono::milliseconds>(*result.rtt);
+                ++statistics_.answered;
+            }
+            const auto rooms = rooms_by_endpoint_.find(result.server);
+            if (rooms == rooms_by_endpoint_.end()) {
+                continue;
+            }
+            for (const auto& room_id : rooms->second) {
+                pings.push_back({room_id, cached.rtt});
+            }
+        }
+    }
+    if (!pings.empty() && on_pings_) {
+        on_pings_(pings);
+    }
+}
+
+void RoomPingProber::ScheduleLocked() {
+    if (paused_ || batch_timer_ != TimerWheel::INVALID_TIMER_ID ||
+        config_.batch_interval.count() <= 0) {
+        return;
+    }
+    // Probes block for up to the deadline, so they leave the wheel thread
+    batch_timer_ = timer_wheel_->ScheduleRepeating(config_.batch_interval, [this]() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (paused_ || batch_running_ || rooms_by_endpoint_.empty()) {
+                return;
+            }
+        }
+        tasks_.Submit([this]() { RunBatch(); });
+    });
+}
+
+} // namespace Core::Multiplayer::ModelA
@@ -0,0 +1,132 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "core/multiplayer/common/timer_wheel.h"
+#include "core/multiplayer/common/work_stealing_executor.h"
+#include "relay_server_selector.h"
+#include "room_types.h"
+
+namespace Core::Multiplayer::ModelA {
+
+struct RoomPingProberConfig {
+    // Endpoints probed together; one batch is in flight at a time
+    size_t batch_size = 16;
+    // Gap between batches, which caps the probe rate
+    std::chrono::milliseconds batch_interval{1000};
+    std::chrono::milliseconds probe_deadline{500};
+    // How long a result, answered or not, stands before it is probed again
+    std::chrono::seconds cache_ttl{60};
+    uint16_t default_port = 8443;
+};
+
+struct RoomPing {
+    std::string room_id;
+    // Unset if the endpoint did not answer
+    std::optional<std::chrono::milliseconds> rtt;
+
+    bool operator==(const RoomPing&) const = default;
+};
+
+struct RoomPingProberStatistics {
+    uint64_t batches = 0;
+    uint64_t probes = 0;
+    uint64_t answered = 0;
+    uint64_t cache_hits = 0; // Visible endpoints whose result was still fresh
+};
+
+/**
+ * Measures the ping of listed rooms, which the server cannot know.
+ *
+ * The owner says which rooms are visible and how to reach each one, its
+ * host or the relay it is hosted through. Endpoints without a fresh result
+ * are queued and probed batch_size at a time, one batch per
+ * batch_interval, with the relay keepalive RelayServerSelector times.
+ * Results are cached per endpoint, so rooms sharing a relay cost one probe,
+ * and the visible rooms behind each new result are reported to the
+ * callback, e.g. for RoomListView::UpdatePing.
+ *
+ * Probing stops while paused, as it should during a session so the probes
+ * never compete with game traffic. Probes run on the shared executor and the
+ * callback on its workers, without the prober's lock.
+ */
+class RoomPingProber {
+public:
+    using Clock = std::chrono::steady_clock;
+    // The endpoint, "host[:port]", a room is reached through; nothing to skip it
+    using TargetResolver = std::function<std::optional<std::string>(const RoomSummary& room)>;
+    using ProbeFunction =
+        std::function<std::vector<RelayServerProbeResult>(const std::vector<std::string>&)>;
+    using PingCallback = std::function<void(const std::vector<RoomPing>& pings)>;
+
+    RoomPingProber(TargetResolver resolver, PingCallback on_pings,
+                   const RoomPingProberConfig& config = {},
+                   std::shared_ptr<TimerWheel> timer_wheel = nullptr,
+                   ProbeFunction probe = nullptr);
+    ~RoomPingProber();
+
+    RoomPingProber(const RoomPingProber&) = delete;
+    RoomPingProber& operator=(const RoomPingProber&) = delete;
+
+    // Replace the visible rooms; only these are probed
+    void SetVisibleRooms(const std::vector<RoomSummary>& rooms);
+
+    void SetPaused(bool paused);
+    bool IsPaused() const;
+
+    // Cached ping of a visible room
+    std::optional<std::chrono::milliseconds> GetPing(const std::string& room_id) const;
+
+    // Probe the next batch now rather than at the next interval; waits for it
+    void RunBatch(Clock::time_point now = Clock::now());
+
+    RoomPingProberStatistics GetStatistics() const;
+
+private:
+    struct CachedResult {
+        std::optional<std::chrono::milliseconds> rtt;
+        Clock::time_point measured_at;
+    };
+
+    bool IsFreshLocked(const std::string& endpoint, Clock::time_point now) const;
+    std::vector<std::string> TakeBatchLocked(Clock::time_point now);
+    void Record(const std::vector<RelayServerProbeResult>& results, Clock::time_point now);
+    void ScheduleLocked();
+
+    const TargetResolver resolver_;
+    const PingCallback on_pings_;
+    const RoomPingProberConfig config_;
+    std::shared_ptr<TimerWheel> timer_wheel_;
+    const ProbeFunction probe_;
+
+    mutable std::mutex mutex_;
+    // Visible rooms by endpoint, and the endpoint of each
+    std::unordered_map<std::string, std::vector<std::string>> rooms_by_endpoint_;
+    std::unordered_map<std::string, std::string> endpoint_of_room_;
+    std::deque<std::string> queue_;
+    std::unordered_set<std::string> queued_;
+    std::unordered_map<std::string, CachedResult> cache_;
+    bool paused_ = false;
+    bool batch_running_ = false;
+    TimerWheel::TimerId batch_timer_{TimerWheel::INVALID_TIMER_ID}; // guarded by mutex_
+    RoomPingProberStatistics statistics_;
+
+    // Declared last so it is destroyed first, waiting out a running batch
+    ExecutorTaskGroup tasks_{WorkStealingExecutor::GetShared()};
+};
+
+} // namespace Core::Multiplayer::ModelA
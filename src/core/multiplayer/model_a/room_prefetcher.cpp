@@ -0,0 +1,140 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "room_prefetcher.h"
+
+#include <utility>
+
+namespace Core::Multiplayer::ModelA {
+
+RoomPrefetcher::RoomPrefetcher(const RoomPrefetchConfig& config, ClientFactory make_client,
+                               LdnTitleLookup lookup, RegisterRequest registration,
+                               std::shared_ptr<TimerWheel> timer_wheel)
+    : config_(config), make_client_(std::move(make_client)), lookup_(std::move(lookup)),
+      registration_(std::move(registration)),
+      timer_wheel_(timer_wheel ? std::move(timer_wheel) : TimerWheel::GetShared()) {}
+
+RoomPrefetcher::~RoomPrefetcher() {
+    OnTitleStopped();
+}
+
+bool RoomPrefetcher::OnTitleLaunched(uint64_t title_id) {
+    if (!config_.enabled) {
+        return false;
+    }
+    const auto game_id = lookup_ ? lookup_(title_id) : std::nullopt;
+    if (!game_id) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++statistics_.skipped;
+        return false;
+    }
+    OnTitleStopped();
+
+    auto client = make_client_ ? make_client_() : nullptr;
+    if (!client) {
+        return false;
+    }
+    // The client owns its callback, so it must not hold the client itself
+    std::weak_ptr<RoomClient> weak_client = client;
+    const RoomListSubscribeRequest subscription{*game_id, config_.region};
+    client->SetOnConnectedCallback([weak_client, registration = registration_, subscription] {
+        if (const auto connected = weak_client.lock()) {
+            connected->Register(registration);
+            connected->SubscribeRoomList(subscription);
+        }
+    });
+    if (client->BeginConnect() != ErrorCode::Success) {
+        return false;
+    }
+
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        client_ = std::move(client);
+        game_id_ = *game_id;
+        generation = ++generation_;
+        ++statistics_.started;
+    }
+    // Scheduled outside the lock, since Expire takes it on the wheel thread
+    const auto expiry = timer_wheel_->Schedule(config_.idle_timeout,
+                                               [this, generation] { Expire(generation); });
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (generation_ == generation && client_) {
+            expiry_ = expiry;
+            return true;
+        }
+    }
+    timer_wheel_->Cancel(expiry);
+    return true;
+}
+
+void RoomPrefetcher::OnTitleStopped() {
+    std::shared_ptr<RoomClient> client;
+    TimerWheel::TimerId expiry;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        client = TakeLocked(expiry);
+    }
+    // Cancel waits out a running Expire, so nothing touches this afterwards
+    timer_wheel_->Cancel(expiry);
+    if (client) {
+        client->Shutdown();
+    }
+}
+
+std::shared_ptr<RoomClient> RoomPrefetcher::Claim(uint64_t game_id) {
+    std::shared_ptr<RoomClient> client;
+    TimerWheel::TimerId expiry;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!client_ || game_id_ != game_id) {
+            return nullptr;
+        }
+        client = TakeLocked(expiry);
+        ++statistics_.claimed;
+    }
+    timer_wheel_->Cancel(expiry);
+    client->SetOnConnectedCallback(nullptr);
+    return client;
+}
+
+bool RoomPrefetcher::IsWarm() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return client_ != nullptr;
+}
+
+std::optional<uint64_t> RoomPrefetcher::GetGameId() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!client_) {
+        return std::nullopt;
+    }
+    return game_id_;
+}
+
+RoomPrefetchStatistics RoomPrefetcher::GetStatistics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return statistics_;
+}
+
+std::shared_ptr<RoomClient> RoomPrefetcher::TakeLocked(TimerWheel::TimerId& out_expiry) {
+    out_expiry = std::exchange(expiry_, TimerWheel::INVALID_TIMER_ID);
+    ++generation_;
+    return std::move(client_);
+}
+
+void RoomPrefetcher::Expire(uint64_t generation) {
+    std::shared_ptr<RoomClient> client;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (generation != generation_ || !client_) {
+            return;
+        }
+        expiry_ = TimerWheel::INVALID_TIMER_ID;
+        client = std::move(client_);
+        ++statistics_.expired;
+    }
+    client->Shutdown();
+}
+
+} // namespace Core::Multiplayer::ModelA
@@ -0,0 +1,107 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include "core/multiplayer/common/timer_wheel.h"
+#include "room_client.h"
+
+namespace Core::Multiplayer::ModelA {
+
+struct RoomPrefetchConfig {
+    // Off by default: it contacts the room server before the user asked to
+    bool enabled = false;
+    // A client the room browser has not claimed is released after this long
+    std::chrono::milliseconds idle_timeout{120000};
+    // Region the room list is subscribed for; empty for every region
+    std::string region;
+};
+
+struct RoomPrefetchStatistics {
+    uint64_t started = 0;
+    uint64_t claimed = 0;
+    uint64_t expired = 0;
+    uint64_t skipped = 0; // Titles without LDN support
+};
+
+/**
+ * Warms up the room server session while a title starts, so the room
+ * browser opens already populated instead of waiting for a connect,
+ * registration and room list fetch.
+ *
+ * When a title with LDN support launches, a RoomClient is created and
+ * connected in the background. Once connected it registers and subscribes
+ * to the room list of the title's game id, which fills the client's local
+ * room index. The browser claims the client for good; one left unclaimed
+ * for idle_timeout, or when the title stops, is shut down. The idle timer
+ * is one entry on the shared TimerWheel.
+ *
+ * Thread-safe. The factory and lookup are called without the lock held.
+ */
+class RoomPrefetcher {
+public:
+    // A client for the configured room server, not yet connected
+    using ClientFactory = std::function<std::shared_ptr<RoomClient>()>;
+    // The game id a title announces its LDN sessions under, or nothing when
+    // the title does not use LDN
+    using LdnTitleLookup = std::function<std::optional<uint64_t>(uint64_t title_id)>;
+
+    RoomPrefetcher(const RoomPrefetchConfig& config, ClientFactory make_client,
+                   LdnTitleLookup lookup, RegisterRequest registration,
+                   std::shared_ptr<TimerWheel> timer_wheel = nullptr);
+    // Shuts down an unclaimed client
+    ~RoomPrefetcher();
+
+    RoomPrefetcher(const RoomPrefetcher&) = delete;
+    RoomPrefetcher& operator=(const RoomPrefetcher&) = delete;
+
+    /**
+     * Starts prefetching for a title, replacing the previous title's client
+     * @return False if disabled, the title has no LDN support or connecting
+     *         could not start
+     */
+    bool OnTitleLaunched(uint64_t title_id);
+
+    // Releases an unclaimed client
+    void OnTitleStopped();
+
+    /**
+     * Takes the prefetched client for the room browser. The prefetcher
+     * clears the connected callback it set, so the browser sets its own.
+     * @return Null unless a client was prefetched for this game id
+     */
+    std::shared_ptr<RoomClient> Claim(uint64_t game_id);
+
+    bool IsWarm() const;
+    std::optional<uint64_t> GetGameId() const;
+    RoomPrefetchStatistics GetStatistics() const;
+
+private:
+    // Takes the unclaimed client out and cancels its timer
+    std::shared_ptr<RoomClient> TakeLocked(TimerWheel::TimerId& out_expiry);
+    void Expire(uint64_t generation);
+
+    const RoomPrefetchConfig config_;
+    const ClientFactory make_client_;
+    const LdnTitleLookup lookup_;
+    const RegisterRequest registration_;
+    const std::shared_ptr<TimerWheel> timer_wheel_;
+
+    mutable std::mutex mutex_;
+    std::shared_ptr<RoomClient> client_;
+    uint64_t game_id_ = 0;
+    // Tells a stale expiry from the current client's
+    uint64_t generation_ = 0;
+    TimerWheel::TimerId expiry_ = TimerWheel::INVALID_TIMER_ID;
+    RoomPrefetchStatistics statistics_;
+};
+
+} // namespace Core::Multiplayer::ModelA
@@ -0,0 +1,168 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "room_table.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace Core::Multiplayer::ModelA {
+
+std::optional<RoomId> RoomId::From(std::string_view id) {
+    if (id.size() > CAPACITY) {
+        return std::nullopt;
+    }
+    RoomId room_id;
+    std::copy(id.begin(), id.end(), room_id.bytes_.begin());
+    room_id.size_ = static_cast<uint8_t>(id.size());
+    return room_id;
+}
+
+size_t RoomIdHash::operator()(const RoomId& id) const {
+    return std::hash<std::string_view>{}(id.View());
+}
+
+StringInterner::StringInterner(std::pmr::memory_resource* resource)
+    : strings_(resource), ids_(resource) {}
+
+StringInterner::Id StringInterner::Intern(std::string_view value) {
+    const auto it = ids_.find(value);
+    if (it != ids_.end()) {
+        return it->second;
+    }
+    const auto id = static_cast<Id>(strings_.size());
+    const std::pmr::string& stored = strings_.emplace_back(value);
+    ids_.emplace(std::string_view(stored), id);
+    return id;
+}
+
+std::optional<StringInterner::Id> StringInterner::Find(std::string_view value) const {
+    const auto it = ids_.find(value);
+    if (it == ids_.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+void StringInterner::Clear() {
+    ids_.clear();
+    strings_.clear();
+}
+
+RoomSummary RoomSummaryView::ToSummary() const {
+    RoomSummary room;
+    room.id = id;
+    room.game_id = game_id;
+    room.game_name = game_name;
+    room.host_name = host_name;
+    room.current_players = current_players;
+    room.max_players = max_players;
+    room.ping = ping;
+    room.region = region;
+    return room;
+}
+
+RoomTable::RoomTable(std::pmr::memory_resource* upstream) : pool_(upstream) {}
+
+std::optional<RoomTable::Slot> RoomTable::Upsert(const RoomSummary& room) {
+    const auto id = RoomId::From(room.id);
+    if (!id) {
+        return std::nullopt;
+    }
+
+    const auto [it, inserted] = slots_.try_emplace(*id, static_cast<Slot>(ids_.size()));
+    const Slot slot = it->second;
+    if (inserted) {
+        ids_.push_back(*id);
+        game_ids_.emplace_back();
+        game_names_.emplace_back();
+        regions_.emplace_back();
+        current_players_.emplace_back();
+        max_players_.emplace_back();
+        pings_.emplace_back();
+        host_names_.emplace_back();
+    }
+    game_ids_[slot] = room.game_id;
+    game_names_[slot] = strings_.Intern(room.game_name);
+    regions_[slot] = strings_.Intern(room.region);
+    current_players_[slot] = room.current_players;
+    max_players_[slot] = room.max_players;
+    pings_[slot] = room.ping;
+    host_names_[slot] = room.host_name;
+    return slot;
+}
+
+bool RoomTable::Remove(std::string_view room_id) {
+    const auto id = RoomId::From(room_id);
+    if (!id) {
+        return false;
+    }
+    const auto it = slots_.find(*id);
+    if (it == slots_.end()) {
+        return false;
+    }
+
+    const Slot slot = it->second;
+    const Slot last = static_cast<Slot>(ids_.size() - 1);
+    slots_.erase(it);
+    if (slot != last) {
+        ids_[slot] = ids_[last];
+        game_ids_[slot] = game_ids_[last];
+        game_names_[slot] = game_names_[last];
+        regions_[slot] = regions_[last];
+        current_players_[slot] = current_players_[last];
+        max_players_[slot] = max_players_[last];
+        pings_[slot] = pings_[last];
+        host_names_[slot] = std::move(host_names_[last]);
+        slots_[ids_[slot]] = slot;
+    }
+    ids_.pop_back();
+    game_ids_.pop_back();
+    game_names_.pop_back();
+    regions_.pop_back();
+    current_players_.pop_back();
+    max_players_.pop_back();
+    pings_.pop_back();
+    host_names_.pop_back();
+    return true;
+}
+
+void RoomTable::Clear() {
+    slots_.clear();
+    ids_.clear();
+    game_ids_.clear();
+    game_names_.clear();
+    regions_.clear();
+    current_players_.clear();
+    max_players_.clear();
+    pings_.clear();
+    host_names_.clear();
+    strings_.Clear();
+}
+
+std::optional<RoomTable::Slot> RoomTable::Find(std::string_view room_id) const {
+    const auto id = RoomId::From(room_id);
+    if (!id) {
+        return std::nullopt;
+    }
+    const auto it = slots_.find(*id);
+    if (it == slots_.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+RoomSummaryView RoomTable::View(Slot slot) const {
+    RoomSummaryView view;
+    view.id = ids_[slot].View();
+    view.game_id = game_ids_[slot];
+    view.game_name = strings_.Get(game_names_[slot]);
+    view.host_name = host_names_[slot];
+    view.current_players = current_players_[slot];
+    view.max_players = max_players_[slot];
+    view.ping = pings_[slot];
+    view.region = strings_.Get(regions_[slot]);
+    return view;
+}
+
+} // namespace Core::Multiplayer::ModelA
@@ -0,0 +1,166 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "core/multiplayer/common/memory_accounting.h"
+#include "room_types.h"
+
+namespace Core::Multiplayer::ModelA {
+
+/**
+ * Room id stored inline. Server ids are UUIDs, well within CAPACITY.
+ */
+class RoomId {
+public:
+    static constexpr size_t CAPACITY = 63;
+
+    // @return Nothing if id is longer than CAPACITY
+    static std::optional<RoomId> From(std::string_view id);
+
+    std::string_view View() const {
+        return {bytes_.data(), size_};
+    }
+
+    // Unused bytes stay zero, so the bytes compare as a whole
+    bool operator==(const RoomId&) const = default;
+
+private:
+    std::array<char, CAPACITY> bytes_{};
+    uint8_t size_ = 0;
+};
+
+struct RoomIdHash {
+    size_t operator()(const RoomId& id) const;
+};
+
+/**
+ * Deduplicated strings behind small ids, for the few hundred game names and
+ * regions a room list repeats. Strings are kept until Clear.
+ */
+class StringInterner {
+public:
+    using Id = uint32_t;
+
+    explicit StringInterner(std::pmr::memory_resource* resource);
+
+    Id Intern(std::string_view value);
+    std::optional<Id> Find(std::string_view value) const;
+    std::string_view Get(Id id) const {
+        return strings_[id];
+    }
+
+    size_t Size() const {
+        return strings_.size();
+    }
+    void Clear();
+
+private:
+    // A deque never moves its strings, so the map's views stay valid
+    std::pmr::deque<std::pmr::string> strings_;
+    std::pmr::unordered_map<std::string_view, Id> ids_;
+};
+
+/**
+ * A room as stored in a RoomTable. The views are valid until the table
+ * next changes.
+ */
+struct RoomSummaryView {
+    std::string_view id;
+    uint64_t game_id = 0;
+    std::string_view game_name;
+    std::string_view host_name;
+    int current_players = 0;
+    int max_players = 0;
+    int ping = 0;
+    std::string_view region;
+
+    RoomSummary ToSummary() const;
+};
+
+/**
+ * Struct-of-arrays storage for a large room list.
+ *
+ * A RoomSummary costs four string allocations and a hash node, and a list of
+ * ten thousand scatters them all over the heap. The table keeps each field in
+ * its own column instead: ids inline, game names and regions interned, so
+ * only host names allocate, and those from a pool private to the table. A
+ * filter reads just the columns it checks, front to back. Removal moves the
+ * last room into the freed slot, so slots are only stable between changes.
+ *
+ * Not thread-safe.
+ */
+class RoomTable {
+public:
+    using Slot = uint32_t;
+
+    explicit RoomTable(std::pmr::memory_resource* upstream =
+                           GetMemoryResource(MemorySubsystem::RoomClient));
+
+    RoomTable(const RoomTable&) = delete;
+    RoomTable& operator=(const RoomTable&) = delete;
+
+    // @return The room's slot, or nothing if its id is longer than RoomId::CAPACITY
+    std::optional<Slot> Upsert(const RoomSummary& room);
+    bool Remove(std::string_view room_id);
+    void Clear();
+
+    std::optional<Slot> Find(std::string_view room_id) const;
+    size_t Size() const {
+        return ids_.size();
+    }
+
+    RoomSummaryView View(Slot slot) const;
+
+    // Columns, indexed by slot
+    const RoomId& IdAt(Slot slot) const {
+        return ids_[slot];
+    }
+    uint64_t GameIdAt(Slot slot) const {
+        return game_ids_[slot];
+    }
+    int FreeSlotsAt(Slot slot) const {
+        return max_players_[slot] - current_players_[slot];
+    }
+    int PingAt(Slot slot) const {
+        return pings_[slot];
+    }
+    StringInterner::Id RegionAt(Slot slot) const {
+        return regions_[slot];
+    }
+    std::string_view GameNameAt(Slot slot) const {
+        return strings_.Get(game_names_[slot]);
+    }
+
+    // The interned id of a region or game name, if any room ever had it
+    std::optional<StringInterner::Id> FindString(std::string_view value) const {
+        return strings_.Find(value);
+    }
+
+private:
+    std::pmr::unsynchronized_pool_resource pool_;
+    StringInterner strings_{&pool_};
+
+    std::pmr::unordered_map<RoomId, Slot, RoomIdHash> slots_{&pool_};
+    std::pmr::vector<RoomId> ids_{&pool_};
+    std::pmr::vector<uint64_t> game_ids_{&pool_};
+    std::pmr::vector<StringInterner::Id> game_names_{&pool_};
+    std::pmr::vector<StringInterner::Id> regions_{&pool_};
+    std::pmr::vector<int> current_players_{&pool_};
+    std::pmr::vector<int> max_players_{&pool_};
+    std::pmr::vector<int> pings_{&pool_};
+    std::pmr::vector<std::pmr::string> host_names_{&pool_};
+};
+
+} // namespace Core::Multiplayer::ModelA
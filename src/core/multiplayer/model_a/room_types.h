@@ -3,12 +3,15 @@
 
 #pragma once
 
+#include <array>
 #include <string>
 #include <vector>
 #include <cstdint>
 #include <chrono>
 #include <map>
 
+#include "core/multiplayer/common/latency_histogram.h"
+
 namespace Core::Multiplayer::ModelA {
 
 /**
@@ -55,6 +58,7 @@ struct PlayerInfo {
  */
 struct RoomSummary {
     std::string id;
+    uint64_t game_id = 0;
     std::string game_name;
     std::string host_name;
     int current_players = 0;
@@ -87,6 +91,12 @@ struct ConnectionInfo {
     ConnectionState state = ConnectionState::Disconnected;
     std::string client_id;
     uint64_t created_at = 0;
+
+    // Outbound message queue
+    size_t pending_messages = 0;
+    uint64_t rejected_messages = 0;         // Refused because the queue was full
+    uint64_t queue_latency_average_us = 0;  // Time from QueueMessage to send
+    uint64_t queue_latency_max_us = 0;
 };
 
 /**
@@ -106,6 +116,38 @@ struct SessionDescription {
     std::string sdp;
 };
 
+/**
+ * Kinds of connection error, each a bit of RoomClientConfig's reconnect
+ * mask. The comments give the name ShouldReconnectOnError is asked about.
+ */
+enum class RoomErrorType : uint32_t {
+    Network = 1u << 0,      // NETWORK_ERROR
+    Timeout = 1u << 1,      // TIMEOUT
+    Auth = 1u << 2,         // AUTH_FAILED
+    Protocol = 1u << 3,     // PROTOCOL_ERROR
+    ServerClosed = 1u << 4, // SERVER_CLOSED
+    Other = 1u << 5,        // OTHER; anything not named above
+};
+
+/**
+ * One outage RoomClient tried to recover from
+ */
+struct ReconnectionEvent {
+    enum class Outcome : uint8_t {
+        Reconnected,
+        GaveUp,
+    };
+
+    // Wall clock, to line outages up with server logs
+    std::chrono::system_clock::time_point lost_at{};
+    RoomErrorType cause = RoomErrorType::Other;
+    Outcome outcome = Outcome::Reconnected;
+    int attempts = 0;
+    std::chrono::milliseconds downtime{0};
+};
+
+constexpr size_t RECONNECTION_HISTORY_SIZE = 32;
+
 /**
  * Reconnection statistics
  */
@@ -113,8 +155,17 @@ struct ReconnectionStatistics {
     int total_attempts = 0;
     int successful_reconnections = 0;
     int failed_reconnections = 0;
-    uint64_t total_downtime_ms = 0;
+    // Attempts put off by the server's retry_after or the process throttle
+    int deferred_attempts = 0;
+    uint64_t total_downtime_ms = 0; // Including outages given up on
     uint64_t average_reconnect_time_ms = 0;
+    uint64_t max_reconnect_time_ms = 0;
+    // Connection lost to connection back, for outages that recovered;
+    // percentiles stop at the histogram's ceiling of about 68 seconds
+    LatencyHistogramSnapshot reconnect_time;
+    // The latest outages, oldest first
+    std::array<ReconnectionEvent, RECONNECTION_HISTORY_SIZE> recent_events{};
+    size_t recent_event_count = 0;
 };
 
 } // namespace Core::Multiplayer::ModelA
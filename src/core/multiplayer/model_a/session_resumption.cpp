@@ -0,0 +1,173 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "session_resumption.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/kdf.h>
+#include <openssl/rand.h>
+
+namespace Core::Multiplayer::ModelA {
+
+namespace {
+constexpr size_t RANDOM_SIZE = ResumptionOffer::HELLO_SIZE - SessionResumptionCache::TICKET_ID_SIZE;
+
+// HKDF-SHA256 (RFC 5869) of the secret into out
+bool Hkdf(std::span<const uint8_t> secret, std::span<const uint8_t> salt, std::string_view info,
+          std::span<uint8_t> out) {
+    EVP_PKEY_CTX* ctx = EVP_PKEY_CTX_new_id(EVP_PKEY_HKDF, nullptr);
+    if (ctx == nullptr) {
+        return false;
+    }
+    size_t length = out.size();
+    const bool ok =
+        EVP_PKEY_derive_init(ctx) == 1 && EVP_PKEY_CTX_set_hkdf_md(ctx, EVP_sha256()) == 1 &&
+        EVP_PKEY_CTX_set1_hkdf_key(ctx, secret.data(), static_cast<int>(secret.size())) == 1 &&
+        (salt.empty() ||
+         EVP_PKEY_CTX_set1_hkdf_salt(ctx, salt.data(), static_cast<int>(salt.size())) == 1) &&
+        EVP_PKEY_CTX_add1_hkdf_info(ctx, reinterpret_cast<const unsigned char*>(info.data()),
+                                    static_cast<int>(info.size())) == 1 &&
+        EVP_PKEY_derive(ctx, out.data(), &length) == 1 && length == out.size();
+    EVP_PKEY_CTX_free(ctx);
+    return ok;
+}
+
+std::optional<ResumedSessionKeys> DeriveKeys(std::span<const uint8_t> secret,
+                                             std::span<const uint8_t> random) {
+    ResumedSessionKeys keys;
+    if (!Hkdf(secret, random, "sudachi resume initiator", keys.initiator_to_responder) ||
+        !Hkdf(secret, random, "sudachi resume responder", keys.responder_to_initiator) ||
+        !Hkdf(secret, random, "sudachi resume next", keys.next_secret)) {
+        OPENSSL_cleanse(&keys, sizeof(keys));
+        return std::nullopt;
+    }
+    return keys;
+}
+} // namespace
+
+SessionResumptionCache::SessionResumptionCache(const SessionResumptionConfig& config)
+    : config_(config) {}
+
+SessionResumptionCache::~SessionResumptionCache() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (!tickets_.empty()) {
+        EraseLocked(tickets_.begin());
+    }
+}
+
+void SessionResumptionCache::Remember(const std::string& peer_id,
+                                      std::span<const uint8_t, SECRET_SIZE> session_secret,
+                                      Clock::time_point now) {
+    Ticket ticket;
+    std::copy(session_secret.begin(), session_secret.end(), ticket.secret.begin());
+    // Both peers derive the same id from the secret, so it never has to be sent
+    if (!Hkdf(ticket.secret, {}, "sudachi resume ticket", ticket.id)) {
+        OPENSSL_cleanse(ticket.secret.data(), ticket.secret.size());
+        return;
+    }
+    ticket.issued = now;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = tickets_.find(peer_id);
+    if (it != tickets_.end()) {
+        EraseLocked(it);
+    } else if (config_.max_tickets > 0 && tickets_.size() >= config_.max_tickets) {
+        EraseLocked(std::min_element(tickets_.begin(), tickets_.end(),
+                                     [](const auto& a, const auto& b) {
+                                         return a.second.issued < b.second.issued;
+                                     }));
+    }
+    tickets_.emplace(peer_id, ticket);
+    OPENSSL_cleanse(ticket.secret.data(), ticket.secret.size());
+}
+
+std::optional<ResumptionOffer> SessionResumptionCache::BeginResumption(const std::string& peer_id,
+                                                                       Clock::time_point now) {
+    std::array<uint8_t, SECRET_SIZE> secret;
+    ResumptionOffer offer;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = tickets_.find(peer_id);
+        if (it == tickets_.end()) {
+            return std::nullopt;
+        }
+        const bool live = IsLive(it->second, now);
+        secret = it->second.secret;
+        std::copy(it->second.id.begin(), it->second.id.end(), offer.hello.begin());
+        EraseLocked(it);
+        if (!live) {
+            OPENSSL_cleanse(secret.data(), secret.size());
+            return std::nullopt;
+        }
+    }
+
+    const std::span<uint8_t> random = std::span(offer.hello).subspan(TICKET_ID_SIZE);
+    std::optional<ResumedSessionKeys> keys;
+    if (RAND_bytes(random.data(), static_cast<int>(random.size())) == 1) {
+        keys = DeriveKeys(secret, random);
+    }
+    OPENSSL_cleanse(secret.data(), secret.size());
+    if (!keys) {
+        return std::nullopt;
+    }
+    offer.keys = *keys;
+    return offer;
+}
+
+std::optional<ResumedSessionKeys> SessionResumptionCache::AcceptResumption(
+    const std::string& peer_id, std::span<const uint8_t> hello, Clock::time_point now) {
+    if (hello.size() != ResumptionOffer::HELLO_SIZE) {
+        return std::nullopt;
+    }
+
+    std::array<uint8_t, SECRET_SIZE> secret;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = tickets_.find(peer_id);
+        if (it == tickets_.end() ||
+            CRYPTO_memcmp(it->second.id.data(), hello.data(), TICKET_ID_SIZE) != 0) {
+            return std::nullopt;
+        }
+        const bool live = IsLive(it->second, now);
+        secret = it->second.secret;
+        // Used up even when expired; a replay of this hello finds nothing
+        EraseLocked(it);
+        if (!live) {
+            OPENSSL_cleanse(secret.data(), secret.size());
+            return std::nullopt;
+        }
+    }
+
+    auto keys = DeriveKeys(secret, hello.subspan(TICKET_ID_SIZE, RANDOM_SIZE));
+    OPENSSL_cleanse(secret.data(), secret.size());
+    return keys;
+}
+
+void SessionResumptionCache::Forget(const std::string& peer_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = tickets_.find(peer_id);
+    if (it != tickets_.end()) {
+        EraseLocked(it);
+    }
+}
+
+size_t SessionResumptionCache::GetTicketCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tickets_.size();
+}
+
+bool SessionResumptionCache::IsLive(const Ticket& ticket, Clock::time_point now) const {
+    return now - ticket.issued <= config_.ticket_lifetime;
+}
+
+void SessionResumptionCache::EraseLocked(std::unordered_map<std::string, Ticket>::iterator it) {
+    OPENSSL_cleanse(it->second.secret.data(), it->second.secret.size());
+    tickets_.erase(it);
+}
+
+} // namespace Core::Multiplayer::ModelA
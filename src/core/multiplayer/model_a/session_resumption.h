@@ -0,0 +1,126 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+
+namespace Core::Multiplayer::ModelA {
+
+struct SessionResumptionConfig {
+    // How long after a full handshake a peer may resume without another one
+    std::chrono::seconds ticket_lifetime{600};
+    // Peers remembered at once; the oldest ticket is dropped beyond this
+    size_t max_tickets = 256;
+};
+
+/**
+ * Keys for a resumed session, both derived from the previous session's
+ * secret and the initiator's random value
+ */
+struct ResumedSessionKeys {
+    static constexpr size_t KEY_SIZE = 32;
+
+    // For PacketCipher: the initiator seals with the first, the responder with the second
+    std::array<uint8_t, KEY_SIZE> initiator_to_responder{};
+    std::array<uint8_t, KEY_SIZE> responder_to_initiator{};
+    // Remembered by both sides in place of the old secret, so the session
+    // after this one can resume too
+    std::array<uint8_t, KEY_SIZE> next_secret{};
+};
+
+/**
+ * What the initiator sends in its first flight, ahead of its 0-RTT data
+ */
+struct ResumptionOffer {
+    static constexpr size_t HELLO_SIZE = 32;
+
+    // Ticket id (16 bytes) then the initiator's random value (16 bytes)
+    std::array<uint8_t, HELLO_SIZE> hello{};
+    ResumedSessionKeys keys;
+};
+
+/**
+ * Resumption tickets for encrypted peer sessions, so a peer that reconnects
+ * soon after a full handshake can send data in its first flight.
+ *
+ * After a handshake both peers Remember the session secret. To reconnect,
+ * the initiator calls BeginResumption, sends the hello and can immediately
+ * seal data with the returned keys; the responder passes the hello to
+ * AcceptResumption and derives the same keys. Keys come from HKDF-SHA256
+ * over the secret, salted with the initiator's random value, so every
+ * resumption has fresh keys.
+ *
+ * A ticket is single use on both sides: a replayed hello finds no ticket
+ * and falls back to a full handshake. Replayed data packets within the
+ * resumed session are caught by PacketCipher's sequence window. Tickets
+ * expire after ticket_lifetime whether used or not, which bounds how long
+ * one handshake's secret keeps producing keys.
+ *
+ * Thread-safe.
+ */
+class SessionResumptionCache {
+public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr size_t SECRET_SIZE = 32;
+    static constexpr size_t TICKET_ID_SIZE = 16;
+
+    explicit SessionResumptionCache(const SessionResumptionConfig& config = {});
+    ~SessionResumptionCache();
+
+    SessionResumptionCache(const SessionResumptionCache&) = delete;
+    SessionResumptionCache& operator=(const SessionResumptionCache&) = delete;
+
+    /**
+     * Stores the secret of a session just established with peer_id,
+     * replacing any earlier ticket
+     */
+    void Remember(const std::string& peer_id, std::span<const uint8_t, SECRET_SIZE> session_secret,
+                  Clock::time_point now = Clock::now());
+
+    /**
+     * Initiator side: uses up the ticket for peer_id
+     * @return The hello to send and the keys for the new session, or nothing
+     *         if there is no live ticket and a full handshake is needed
+     */
+    std::optional<ResumptionOffer> BeginResumption(const std::string& peer_id,
+                                                   Clock::time_point now = Clock::now());
+
+    /**
+     * Responder side: checks a hello against the ticket for peer_id and
+     * uses it up
+     * @return The keys for the new session, or nothing if the hello does
+     *         not match a live ticket (unknown, expired or already used)
+     */
+    std::optional<ResumedSessionKeys> AcceptResumption(const std::string& peer_id,
+                                                       std::span<const uint8_t> hello,
+                                                       Clock::time_point now = Clock::now());
+
+    void Forget(const std::string& peer_id);
+
+    size_t GetTicketCount() const;
+
+private:
+    struct Ticket {
+        std::array<uint8_t, SECRET_SIZE> secret{};
+        std::array<uint8_t, TICKET_ID_SIZE> id{};
+        Clock::time_point issued;
+    };
+
+    bool IsLive(const Ticket& ticket, Clock::time_point now) const;
+    void EraseLocked(std::unordered_map<std::string, Ticket>::iterator it);
+
+    SessionResumptionConfig config_;
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Ticket> tickets_;
+};
+
+} // namespace Core::Multiplayer::ModelA
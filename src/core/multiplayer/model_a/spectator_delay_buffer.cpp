@@ -0,0 +1,138 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "spectator_delay_buffer.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace Core::Multiplayer::ModelA {
+
+SpectatorDelayBuffer::SpectatorDelayBuffer(const SpectatorConfig& config, DeliverCallback deliver,
+                                           std::shared_ptr<TimerWheel> timer_wheel)
+    : config_(config), deliver_(std::move(deliver)),
+      timer_wheel_(timer_wheel ? std::move(timer_wheel) : TimerWheel::GetShared()) {}
+
+SpectatorDelayBuffer::~SpectatorDelayBuffer() {
+    TimerWheel::TimerId timer;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        frames_.clear();
+        snapshot_.reset();
+        timer = std::exchange(release_timer_, TimerWheel::INVALID_TIMER_ID);
+    }
+    // Outside the lock: Cancel waits for a running release, which takes it
+    if (timer != TimerWheel::INVALID_TIMER_ID) {
+        timer_wheel_->Cancel(timer);
+    }
+}
+
+void SpectatorDelayBuffer::Insert(uint32_t sequence, std::span<const uint8_t> payload,
+                                  bool snapshot) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto now = Clock::now();
+    const int64_t key = UnwrapLocked(sequence);
+    Frame frame{now + config_.delay, std::vector<uint8_t>(payload.begin(), payload.end())};
+
+    if (snapshot) {
+        // Only the newest snapshot is worth waiting for
+        if ((!playing_ || key >= next_key_) && (!snapshot_ || key > snapshot_->first)) {
+            snapshot_.emplace(key, std::move(frame));
+        }
+    } else {
+        ++statistics_.received;
+        if (playing_ && key < next_key_) {
+            ++statistics_.late_dropped;
+            return;
+        }
+        if (!frames_.try_emplace(key, std::move(frame)).second) {
+            return; // Duplicate
+        }
+        if (frames_.size() > config_.max_buffered_frames) {
+            frames_.erase(frames_.begin());
+            ++statistics_.overflow_dropped;
+        }
+    }
+    ReleaseLocked(now);
+}
+
+bool SpectatorDelayBuffer::IsPlaying() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return playing_;
+}
+
+SpectatorStatistics SpectatorDelayBuffer::GetStatistics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return statistics_;
+}
+
+int64_t SpectatorDelayBuffer::UnwrapLocked(uint32_t sequence) {
+    if (!sequenced_) {
+        sequenced_ = true;
+        newest_sequence_ = sequence;
+        newest_key_ = 0;
+        return 0;
+    }
+    const int64_t key = newest_key_ + static_cast<int32_t>(sequence - newest_sequence_);
+    if (key > newest_key_) {
+        newest_key_ = key;
+        newest_sequence_ = sequence;
+    }
+    return key;
+}
+
+void SpectatorDelayBuffer::ReleaseLocked(Clock::time_point now) {
+    // A snapshot goes first: it covers every frame before its sequence
+    if (snapshot_ && snapshot_->second.due <= now) {
+        const int64_t key = snapshot_->first;
+        if (!playing_ || (lost_since_snapshot_ && key >= next_key_)) {
+            while (!frames_.empty() && frames_.begin()->first < key) {
+                frames_.erase(frames_.begin());
+                ++statistics_.superseded;
+            }
+            playing_ = true;
+            next_key_ = key;
+            lost_since_snapshot_ = false;
+            ++statistics_.snapshots;
+            deliver_(true, snapshot_->second.payload);
+        }
+        snapshot_.reset();
+    }
+
+    if (!playing_ && !config_.wait_for_snapshot && !frames_.empty()) {
+        playing_ = true;
+        next_key_ = frames_.begin()->first;
+    }
+    while (playing_ && !frames_.empty() && frames_.begin()->second.due <= now) {
+        auto it = frames_.begin();
+        if (it->first > next_key_) {
+            statistics_.lost += static_cast<uint64_t>(it->first - next_key_);
+            lost_since_snapshot_ = true;
+        }
+        next_key_ = it->first + 1;
+        ++statistics_.delivered;
+        deliver_(false, it->second.payload);
+        frames_.erase(it);
+    }
+
+    // Held frames wait for the snapshot rather than for a timer
+    std::optional<Clock::time_point> next_release;
+    if (snapshot_) {
+        next_release = snapshot_->second.due;
+    }
+    if (playing_ && !frames_.empty()) {
+        const auto due = frames_.begin()->second.due;
+        next_release = next_release ? std::min(*next_release, due) : due;
+    }
+    if (!next_release || release_timer_ != TimerWheel::INVALID_TIMER_ID) {
+        return;
+    }
+    const auto delay = std::chrono::ceil<std::chrono::milliseconds>(*next_release - now);
+    release_timer_ = timer_wheel_->Schedule(std::max(delay, std::chrono::milliseconds(1)), [this] {
+        std::lock_guard<std::mutex> lock(mutex_);
+        release_timer_ = TimerWheel::INVALID_TIMER_ID;
+        ReleaseLocked(Clock::now());
+    });
+}
+
+} // namespace Core::Multiplayer::ModelA
@@ -0,0 +1,106 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "core/multiplayer/common/timer_wheel.h"
+
+namespace Core::Multiplayer::ModelA {
+
+struct SpectatorConfig {
+    // Broadcast delay every frame is held for, so a stream cannot be used
+    // to coach a player live; 0 still puts frames in sequence order
+    std::chrono::milliseconds delay{0};
+    // Hold frames until a snapshot gives them a base to apply to. Off for
+    // streams whose frames stand alone.
+    bool wait_for_snapshot = true;
+    // Frames held at once; the oldest goes when a new one would exceed it
+    size_t max_buffered_frames = 4096;
+};
+
+struct SpectatorStatistics {
+    uint64_t received = 0;
+    uint64_t delivered = 0;
+    uint64_t snapshots = 0;        // Snapshots delivered
+    uint64_t superseded = 0;       // Frames a delivered snapshot already covered
+    uint64_t late_dropped = 0;     // Arrived after a later frame was played out
+    uint64_t lost = 0;             // Frames skipped over in playout
+    uint64_t overflow_dropped = 0;
+};
+
+/**
+ * Playout buffer for one spectated session's broadcast stream.
+ *
+ * Frames are held for the broadcast delay and released in sequence order.
+ * A spectator that joins late has no base for the frames it receives, so
+ * playout starts with a snapshot: it is delivered first, the frames it
+ * covers (sequence numbers before its own) are dropped, and the frames
+ * after it follow. Once playing, later snapshots are only delivered when a
+ * frame was lost since the last one, to resynchronize.
+ *
+ * Thread-safe. The callback runs under the buffer's lock, on the thread that
+ * inserted a frame or on the TimerWheel thread.
+ */
+class SpectatorDelayBuffer {
+public:
+    using DeliverCallback = std::function<void(bool snapshot, std::vector<uint8_t>& payload)>;
+
+    SpectatorDelayBuffer(const SpectatorConfig& config, DeliverCallback deliver,
+                         std::shared_ptr<TimerWheel> timer_wheel = nullptr);
+    // Cancels the pending release; frames still held are dropped
+    ~SpectatorDelayBuffer();
+
+    SpectatorDelayBuffer(const SpectatorDelayBuffer&) = delete;
+    SpectatorDelayBuffer& operator=(const SpectatorDelayBuffer&) = delete;
+
+    /**
+     * @param sequence The relay frame's sequence number; a snapshot carries
+     *                 that of the first frame it does not cover
+     */
+    void Insert(uint32_t sequence, std::span<const uint8_t> payload, bool snapshot);
+
+    // Whether playout has started
+    bool IsPlaying() const;
+    SpectatorStatistics GetStatistics() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Frame {
+        Clock::time_point due;
+        std::vector<uint8_t> payload;
+    };
+
+    // Sequence numbers widened so wraparound keeps their order
+    int64_t UnwrapLocked(uint32_t sequence);
+    void ReleaseLocked(Clock::time_point now);
+
+    const SpectatorConfig config_;
+    const DeliverCallback deliver_;
+    const std::shared_ptr<TimerWheel> timer_wheel_;
+
+    mutable std::mutex mutex_;
+    std::map<int64_t, Frame> frames_;
+    std::optional<std::pair<int64_t, Frame>> snapshot_;
+    bool sequenced_ = false;
+    uint32_t newest_sequence_ = 0;
+    int64_t newest_key_ = 0;
+    bool playing_ = false;
+    int64_t next_key_ = 0;
+    bool lost_since_snapshot_ = false;
+    SpectatorStatistics statistics_;
+    TimerWheel::TimerId release_timer_{TimerWheel::INVALID_TIMER_ID}; // guarded by mutex_
+};
+
+} // namespace Core::Multiplayer::ModelA
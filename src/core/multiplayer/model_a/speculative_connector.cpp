@@ -0,0 +1,128 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "speculative_connector.h"
+
+#include <utility>
+#include <vector>
+
+namespace Core::Multiplayer::ModelA {
+
+SpeculativeConnector::SpeculativeConnector(const SpeculativeConnectConfig& config,
+                                           DialFunction dial, CloseFunction close,
+                                           std::shared_ptr<TimerWheel> timer_wheel)
+    : config_(config), dial_(std::move(dial)), close_(std::move(close)),
+      timer_wheel_(timer_wheel ? std::move(timer_wheel) : TimerWheel::GetShared()) {}
+
+SpeculativeConnector::~SpeculativeConnector() {
+    std::unordered_map<std::string, WarmPeer> warm;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        warm.swap(warm_);
+    }
+    // Cancel waits out a running Expire, so nothing touches this afterwards
+    for (const auto& [peer_id, peer] : warm) {
+        timer_wheel_->Cancel(peer.expiry);
+        if (!peer.expiring) {
+            close_(peer_id);
+        }
+    }
+}
+
+bool SpeculativeConnector::Prepare(const std::string& peer_id, const std::string& multiaddr) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (warm_.count(peer_id) != 0) {
+            return false;
+        }
+        if (warm_.size() >= config_.max_warm_peers) {
+            ++statistics_.rejected;
+            return false;
+        }
+        warm_.emplace(peer_id, WarmPeer{});
+        ++statistics_.dialed;
+    }
+
+    // Scheduled outside the lock, since Expire takes it on the wheel thread
+    AttachTimer(peer_id, timer_wheel_->Schedule(config_.idle_ttl,
+                                                [this, peer_id] { Expire(peer_id); }));
+    dial_(peer_id, multiaddr);
+    return true;
+}
+
+bool SpeculativeConnector::Claim(const std::string& peer_id) {
+    TimerWheel::TimerId expiry;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = warm_.find(peer_id);
+        if (it == warm_.end() || it->second.expiring) {
+            return false;
+        }
+        expiry = it->second.expiry;
+        warm_.erase(it);
+        ++statistics_.claimed;
+    }
+    timer_wheel_->Cancel(expiry);
+    return true;
+}
+
+void SpeculativeConnector::Forget(const std::string& peer_id) {
+    TimerWheel::TimerId expiry;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = warm_.find(peer_id);
+        if (it == warm_.end() || it->second.expiring) {
+            return;
+        }
+        expiry = it->second.expiry;
+        warm_.erase(it);
+    }
+    timer_wheel_->Cancel(expiry);
+    close_(peer_id);
+}
+
+size_t SpeculativeConnector::GetWarmCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return warm_.size();
+}
+
+bool SpeculativeConnector::IsWarm(const std::string& peer_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = warm_.find(peer_id);
+    return it != warm_.end() && !it->second.expiring;
+}
+
+SpeculativeConnectStatistics SpeculativeConnector::GetStatistics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return statistics_;
+}
+
+void SpeculativeConnector::Expire(const std::string& peer_id) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = warm_.find(peer_id);
+        if (it == warm_.end()) {
+            return;
+        }
+        it->second.expiring = true;
+        ++statistics_.expired;
+    }
+    close_(peer_id);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    warm_.erase(peer_id);
+}
+
+void SpeculativeConnector::AttachTimer(const std::string& peer_id, TimerWheel::TimerId timer) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = warm_.find(peer_id);
+        if (it != warm_.end()) {
+            it->second.expiry = timer;
+            return;
+        }
+    }
+    timer_wheel_->Cancel(timer);
+}
+
+} // namespace Core::Multiplayer::ModelA
@@ -0,0 +1,98 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "core/multiplayer/common/timer_wheel.h"
+
+namespace Core::Multiplayer::ModelA {
+
+struct SpeculativeConnectConfig {
+    // Unclaimed connections kept at once; announcements beyond this are ignored
+    size_t max_warm_peers = 4;
+    // An unclaimed connection is closed after this long
+    std::chrono::milliseconds idle_ttl{30000};
+};
+
+struct SpeculativeConnectStatistics {
+    uint64_t dialed = 0;
+    uint64_t claimed = 0;
+    uint64_t expired = 0;
+    uint64_t rejected = 0; // Pool was full
+};
+
+/**
+ * Dials room members as soon as they are announced, ahead of the game
+ * asking to connect, so NAT traversal and stream setup are done by the time
+ * the session needs them.
+ *
+ * Warmed connections wait in a bounded pool. Claiming one hands it to the
+ * session for good; one left unclaimed for idle_ttl, or whose player leaves,
+ * is closed again. Each pooled peer holds one timer on the shared TimerWheel.
+ *
+ * Thread-safe. The dial and close functions are called without the lock
+ * held, close also from the wheel thread, and must not block for long.
+ */
+class SpeculativeConnector {
+public:
+    using DialFunction = std::function<void(const std::string& peer_id, const std::string& multiaddr)>;
+    using CloseFunction = std::function<void(const std::string& peer_id)>;
+
+    SpeculativeConnector(const SpeculativeConnectConfig& config, DialFunction dial,
+                         CloseFunction close, std::shared_ptr<TimerWheel> timer_wheel = nullptr);
+    // Closes every unclaimed connection
+    ~SpeculativeConnector();
+
+    SpeculativeConnector(const SpeculativeConnector&) = delete;
+    SpeculativeConnector& operator=(const SpeculativeConnector&) = delete;
+
+    /**
+     * Starts dialing a peer unless it is already pooled or the pool is full
+     * @return False if nothing was started
+     */
+    bool Prepare(const std::string& peer_id, const std::string& multiaddr);
+
+    /**
+     * Takes a peer out of the pool for the session
+     * @return True if it was dialed ahead of time
+     */
+    bool Claim(const std::string& peer_id);
+
+    // The player left; an unclaimed connection is closed
+    void Forget(const std::string& peer_id);
+
+    size_t GetWarmCount() const;
+    bool IsWarm(const std::string& peer_id) const;
+    SpeculativeConnectStatistics GetStatistics() const;
+
+private:
+    struct WarmPeer {
+        TimerWheel::TimerId expiry = TimerWheel::INVALID_TIMER_ID;
+        // Set while Expire closes it; the entry stays so teardown can wait
+        bool expiring = false;
+    };
+
+    void Expire(const std::string& peer_id);
+    // Records the peer's timer, or cancels it if the peer is gone
+    void AttachTimer(const std::string& peer_id, TimerWheel::TimerId timer);
+
+    const SpeculativeConnectConfig config_;
+    const DialFunction dial_;
+    const CloseFunction close_;
+    const std::shared_ptr<TimerWheel> timer_wheel_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, WarmPeer> warm_;
+    SpeculativeConnectStatistics statistics_;
+};
+
+} // namespace Core::Multiplayer::ModelA
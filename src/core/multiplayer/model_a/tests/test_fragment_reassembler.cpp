@@ -0,0 +1,164 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "../fragment_reassembler.h"
+
+using namespace Core::Multiplayer;
+using namespace Core::Multiplayer::ModelA;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr uint32_t SOURCE = 7;
+constexpr uint8_t SENDER = 1;
+
+std::vector<uint8_t> Fragment(size_t index, size_t count, std::vector<uint8_t> bytes) {
+    std::array<uint8_t, RelayProtocol::FRAGMENT_HEADER_SIZE> header{};
+    EXPECT_TRUE(FragmentReassembler::WriteHeader(header, index, count));
+    bytes.insert(bytes.begin(), header.begin(), header.end());
+    return bytes;
+}
+
+std::vector<uint8_t> Gather(FragmentReassembler::Segments segments) {
+    std::vector<uint8_t> message;
+    for (const auto segment : segments) {
+        message.insert(message.end(), segment.begin(), segment.end());
+    }
+    return message;
+}
+
+} // namespace
+
+TEST(FragmentReassemblerTest, OutOfOrderFragmentsComeBackInOrder) {
+    PacketPool pool(8);
+    FragmentReassembler reassembler(pool);
+    const auto now = FragmentReassembler::Clock::now();
+
+    EXPECT_TRUE(reassembler.Add(SOURCE, SENDER, 1, Fragment(2, 3, {5, 6}), now).empty());
+    EXPECT_TRUE(reassembler.Add(SOURCE, SENDER, 1, Fragment(0, 3, {1, 2}), now).empty());
+    EXPECT_EQ(reassembler.GetPendingCount(), 1u);
+
+    const auto segments = reassembler.Add(SOURCE, SENDER, 1, Fragment(1, 3, {3, 4}), now);
+    ASSERT_EQ(segments.size(), 3u);
+    EXPECT_EQ(Gather(segments), (std::vector<uint8_t>{1, 2, 3, 4, 5, 6}));
+    EXPECT_EQ(reassembler.GetPendingCount(), 0u);
+    // Held until the next Add, then back in the pool
+    EXPECT_EQ(pool.Available(), 5u);
+    reassembler.Add(SOURCE, SENDER, 2, Fragment(0, 2, {9}), now);
+    EXPECT_EQ(pool.Available(), 7u);
+    EXPECT_EQ(reassembler.GetStatistics().completed, 1u);
+}
+
+TEST(FragmentReassemblerTest, MessagesAreKeptApartBySourceAndSequence) {
+    PacketPool pool(8);
+    FragmentReassembler reassembler(pool);
+    const auto now = FragmentReassembler::Clock::now();
+
+    reassembler.Add(SOURCE, SENDER, 1, Fragment(0, 2, {1}), now);
+    reassembler.Add(SOURCE + 1, SENDER, 1, Fragment(1, 2, {20}), now);
+    reassembler.Add(SOURCE, SENDER, 2, Fragment(0, 2, {10}), now);
+    EXPECT_EQ(reassembler.GetPendingCount(), 3u);
+
+    EXPECT_EQ(Gather(reassembler.Add(SOURCE, SENDER, 2, Fragment(1, 2, {11}), now)),
+              (std::vector<uint8_t>{10, 11}));
+    EXPECT_EQ(Gather(reassembler.Add(SOURCE, SENDER, 1, Fragment(1, 2, {2}), now)),
+              (std::vector<uint8_t>{1, 2}));
+
+    reassembler.Remove(SOURCE + 1);
+    EXPECT_EQ(reassembler.GetPendingCount(), 0u);
+}
+
+// Two members of a session may send fragmented messages under the same sequence
+TEST(FragmentReassemblerTest, SendersOfOneSourceAreKeptApart) {
+    PacketPool pool(8);
+    FragmentReassembler reassembler(pool);
+    const auto now = FragmentReassembler::Clock::now();
+
+    reassembler.Add(SOURCE, SENDER, 1, Fragment(0, 2, {1}), now);
+    reassembler.Add(SOURCE, SENDER + 1, 1, Fragment(0, 2, {10}), now);
+    EXPECT_EQ(reassembler.GetPendingCount(), 2u);
+    EXPECT_EQ(reassembler.GetStatistics().duplicates, 0u);
+
+    EXPECT_EQ(Gather(reassembler.Add(SOURCE, SENDER + 1, 1, Fragment(1, 2, {11}), now)),
+              (std::vector<uint8_t>{10, 11}));
+    EXPECT_EQ(Gather(reassembler.Add(SOURCE, SENDER, 1, Fragment(1, 2, {2}), now)),
+              (std::vector<uint8_t>{1, 2}));
+
+    // Removing the source drops every sender's partial messages
+    reassembler.Add(SOURCE, SENDER, 2, Fragment(0, 2, {1}), now);
+    reassembler.Add(SOURCE, SENDER + 1, 2, Fragment(0, 2, {1}), now);
+    reassembler.Remove(SOURCE);
+    EXPECT_EQ(reassembler.GetPendingCount(), 0u);
+}
+
+TEST(FragmentReassemblerTest, DuplicatesAndMalformedFragmentsAreDropped) {
+    PacketPool pool(8);
+    FragmentReassembler reassembler(pool);
+    const auto now = FragmentReassembler::Clock::now();
+
+    reassembler.Add(SOURCE, SENDER, 1, Fragment(0, 2, {1}), now);
+    EXPECT_TRUE(reassembler.Add(SOURCE, SENDER, 1, Fragment(0, 2, {1}), now).empty());
+    // Disagrees with the first fragment about the count
+    EXPECT_TRUE(reassembler.Add(SOURCE, SENDER, 1, Fragment(1, 3, {2}), now).empty());
+    EXPECT_TRUE(reassembler.Add(SOURCE, SENDER, 1, std::vector<uint8_t>{5, 2, 0}, now).empty());
+    EXPECT_TRUE(reassembler.Add(SOURCE, SENDER, 1, std::vector<uint8_t>{0}, now).empty());
+
+    const auto statistics = reassembler.GetStatistics();
+    EXPECT_EQ(statistics.duplicates, 1u);
+    EXPECT_EQ(statistics.malformed, 3u);
+    EXPECT_EQ(Gather(reassembler.Add(SOURCE, SENDER, 1, Fragment(1, 2, {2}), now)),
+              (std::vector<uint8_t>{1, 2}));
+
+    std::array<uint8_t, RelayProtocol::FRAGMENT_HEADER_SIZE> header{};
+    EXPECT_FALSE(FragmentReassembler::WriteHeader(header, 0, 1));
+    EXPECT_FALSE(FragmentReassembler::WriteHeader(header, 2, 2));
+    EXPECT_FALSE(
+        FragmentReassembler::WriteHeader(header, 0, FragmentReassembler::MAX_FRAGMENTS + 1));
+}
+
+TEST(FragmentReassemblerTest, PartialMessagesTimeOut) {
+    PacketPool pool(8);
+    FragmentReassembler reassembler(pool, 50ms);
+    const auto start = FragmentReassembler::Clock::now();
+
+    reassembler.Add(SOURCE, SENDER, 1, Fragment(0, 2, {1}), start);
+    reassembler.Add(SOURCE, SENDER, 2, Fragment(0, 2, {1}), start + 40ms);
+    EXPECT_TRUE(reassembler.Add(SOURCE, SENDER, 1, Fragment(1, 2, {2}), start + 60ms).empty());
+    EXPECT_EQ(reassembler.GetStatistics().timed_out, 1u);
+    // The late fragment opened a fresh message of its own
+    EXPECT_EQ(reassembler.GetPendingCount(), 2u);
+    EXPECT_FALSE(reassembler.Add(SOURCE, SENDER, 2, Fragment(1, 2, {2}), start + 60ms).empty());
+}
+
+TEST(FragmentReassemblerTest, OldestMessageMakesRoom) {
+    PacketPool pool(FragmentReassembler::MAX_PENDING + 1);
+    FragmentReassembler reassembler(pool);
+    const auto start = FragmentReassembler::Clock::now();
+
+    for (uint32_t sequence = 0; sequence <= FragmentReassembler::MAX_PENDING; ++sequence) {
+        reassembler.Add(SOURCE, SENDER, sequence, Fragment(0, 2, {1}),
+                        start + std::chrono::milliseconds(sequence));
+    }
+    EXPECT_EQ(reassembler.GetStatistics().evicted, 1u);
+    EXPECT_EQ(reassembler.GetPendingCount(), FragmentReassembler::MAX_PENDING);
+    // Sequence 0 was evicted, so its second fragment starts over
+    EXPECT_TRUE(reassembler.Add(SOURCE, SENDER, 0, Fragment(1, 2, {2}), start + 10ms).empty());
+    EXPECT_EQ(reassembler.GetStatistics().evicted, 2u);
+}
+
+TEST(FragmentReassemblerTest, ExhaustedPoolDropsTheFragment) {
+    PacketPool pool(1);
+    FragmentReassembler reassembler(pool);
+    const auto now = FragmentReassembler::Clock::now();
+
+    reassembler.Add(SOURCE, SENDER, 1, Fragment(0, 2, {1}), now);
+    EXPECT_TRUE(reassembler.Add(SOURCE, SENDER, 1, Fragment(1, 2, {2}), now).empty());
+    EXPECT_EQ(reassembler.GetStatistics().pool_exhausted, 1u);
+    EXPECT_EQ(reassembler.GetPendingCount(), 1u);
+}
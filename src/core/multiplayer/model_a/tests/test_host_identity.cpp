@@ -0,0 +1,59 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "../host_identity.h"
+
+using namespace Core::Multiplayer::ModelA;
+
+namespace {
+
+class HostIdentityTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = (std::filesystem::temp_directory_path() /
+                 ("host_identity_test_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) +
+                  "_" + ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".json"))
+                    .string();
+        std::filesystem::remove(path_);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(path_);
+    }
+
+    std::string path_;
+};
+
+} // namespace
+
+TEST_F(HostIdentityTest, IdentitySurvivesReload) {
+    HostIdentity identity;
+    identity.key_type = "ed25519";
+    identity.private_key = {0x00, 0x7f, 0x80, 0xff};
+    identity.public_key = {0x12, 0x34};
+    ASSERT_TRUE(SaveHostIdentity(path_, identity));
+
+    const auto loaded = LoadHostIdentity(path_);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->key_type, "ed25519");
+    EXPECT_EQ(loaded->private_key, identity.private_key);
+    EXPECT_EQ(loaded->public_key, identity.public_key);
+
+    const auto perms = std::filesystem::status(path_).permissions();
+    EXPECT_EQ(perms & std::filesystem::perms::others_read, std::filesystem::perms::none);
+}
+
+TEST_F(HostIdentityTest, MissingOrCorruptFileYieldsNothing) {
+    EXPECT_FALSE(LoadHostIdentity(path_).has_value());
+
+    std::ofstream(path_) << R"({"version":1,"key_type":"ed25519","private_key":"zz","public_key":"12"})";
+    EXPECT_FALSE(LoadHostIdentity(path_).has_value());
+
+    std::ofstream(path_, std::ios::trunc) << "{ not json";
+    EXPECT_FALSE(LoadHostIdentity(path_).has_value());
+}
@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../ice_candidate_trickle.h"
+
+using namespace Core::Multiplayer::ModelA;
+
+namespace {
+
+const IceCandidate HOST{"candidate:1 1 UDP 2113667326 192.168.1.10 54400 typ host", "0", 0};
+const IceCandidate SRFLX{"candidate:2 1 UDP 1686052607 203.0.113.5 61000 typ srflx", "0", 0};
+const IceCandidate RELAY{"candidate:3 1 UDP 41885439 198.51.100.7 3478 typ relay", "0", 0};
+
+class IceCandidateTrickleTest : public ::testing::Test {
+protected:
+    IceCandidateTrickle trickle_{"player_1", "direct",
+                                 [this](const P2PInfoMessage& message) { sent_.push_back(message); }};
+    std::vector<P2PInfoMessage> sent_;
+};
+
+TEST_F(IceCandidateTrickleTest, DescriptionCarriesCandidatesGatheredSoFar) {
+    trickle_.AddLocalCandidate(HOST);
+    trickle_.Begin("player_2", {"offer", "v=0"});
+
+    ASSERT_EQ(sent_.size(), 1u);
+    EXPECT_EQ(sent_[0].to_player, "player_2");
+    EXPECT_EQ(sent_[0].session_description.type, "offer");
+    ASSERT_EQ(sent_[0].ice_candidates.size(), 1u);
+    EXPECT_EQ(sent_[0].ice_candidates[0].candidate, HOST.candidate);
+    EXPECT_FALSE(sent_[0].end_of_candidates);
+}
+
+TEST_F(IceCandidateTrickleTest, LaterCandidatesTrickleOneAtATime) {
+    trickle_.AddLocalCandidate(HOST);
+    trickle_.Begin("player_2", {"offer", "v=0"});
+    trickle_.AddLocalCandidate(SRFLX);
+    trickle_.AddLocalCandidate(SRFLX);
+    trickle_.AddLocalCandidate(RELAY);
+    trickle_.CompleteLocalGathering();
+
+    ASSERT_EQ(sent_.size(), 4u);
+    EXPECT_TRUE(sent_[1].session_description.type.empty());
+    ASSERT_EQ(sent_[1].ice_candidates.size(), 1u);
+    EXPECT_EQ(sent_[1].ice_candidates[0].candidate, SRFLX.candidate);
+    EXPECT_EQ(sent_[2].ice_candidates[0].candidate, RELAY.candidate);
+    EXPECT_TRUE(sent_[3].ice_candidates.empty());
+    EXPECT_TRUE(sent_[3].end_of_candidates);
+}
+
+TEST_F(IceCandidateTrickleTest, RemoteCandidatesAreReportedOnArrival) {
+    std::vector<std::string> reported;
+    trickle_.SetOnRemoteCandidate([&](const std::string& player, const IceCandidate& candidate) {
+        EXPECT_EQ(player, "player_2");
+        reported.push_back(candidate.candidate);
+    });
+
+    P2PInfoMessage offer;
+    offer.from_player = "player_2";
+    offer.session_description = {"offer", "v=0"};
+    offer.ice_candidates = {HOST};
+    trickle_.OnP2PInfo(offer);
+    EXPECT_EQ(reported.size(), 1u);
+    EXPECT_FALSE(trickle_.IsRemoteGatheringComplete("player_2"));
+
+    P2PInfoMessage update;
+    update.from_player = "player_2";
+    update.ice_candidates = {HOST, SRFLX};
+    update.end_of_candidates = true;
+    trickle_.OnP2PInfo(update);
+
+    EXPECT_EQ(reported, (std::vector<std::string>{HOST.candidate, SRFLX.candidate}));
+    EXPECT_EQ(trickle_.GetRemoteCandidates("player_2").size(), 2u);
+    EXPECT_TRUE(trickle_.IsRemoteGatheringComplete("player_2"));
+
+    // A new description restarts the exchange
+    trickle_.OnP2PInfo(offer);
+    EXPECT_EQ(trickle_.GetRemoteCandidates("player_2").size(), 1u);
+    EXPECT_FALSE(trickle_.IsRemoteGatheringComplete("player_2"));
+}
+
+} // namespace
@@ -0,0 +1,128 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "../jitter_buffer.h"
+
+using namespace Core::Multiplayer::ModelA;
+using namespace std::chrono_literals;
+
+namespace {
+
+JitterBufferConfig FixedDelay(std::chrono::microseconds delay) {
+    JitterBufferConfig config;
+    config.target_delay = delay;
+    config.adaptive = false;
+    return config;
+}
+
+std::vector<uint8_t> Payload(uint8_t value) {
+    return std::vector<uint8_t>(4, value);
+}
+
+// Pops everything ready at now and returns the sequences in release order
+std::vector<uint32_t> PopAll(JitterBuffer& buffer, JitterBuffer::Clock::time_point now) {
+    std::vector<uint32_t> released;
+    std::vector<uint8_t> payload;
+    uint32_t sequence = 0;
+    while (buffer.PopReady(now, payload, sequence)) {
+        EXPECT_EQ(payload, Payload(static_cast<uint8_t>(sequence)));
+        released.push_back(sequence);
+    }
+    return released;
+}
+
+} // anonymous namespace
+
+TEST(JitterBufferTest, ReordersWithinPlayoutDelay) {
+    JitterBuffer buffer(FixedDelay(5ms));
+    const auto start = JitterBuffer::Clock::now();
+
+    EXPECT_EQ(buffer.Insert(1, Payload(1), start), JitterBuffer::InsertResult::Accepted);
+    EXPECT_EQ(buffer.Insert(3, Payload(3), start + 1ms), JitterBuffer::InsertResult::Accepted);
+    EXPECT_EQ(buffer.Insert(2, Payload(2), start + 2ms), JitterBuffer::InsertResult::Accepted);
+
+    // Nothing is played out before the delay has passed
+    EXPECT_TRUE(PopAll(buffer, start + 4ms).empty());
+    EXPECT_EQ(PopAll(buffer, start + 10ms), (std::vector<uint32_t>{1, 2, 3}));
+
+    const auto stats = buffer.GetStatistics();
+    EXPECT_EQ(stats.reordered, 1u);
+    EXPECT_EQ(stats.lost, 0u);
+}
+
+TEST(JitterBufferTest, SuppressesDuplicatesAndDropsLatePackets) {
+    JitterBuffer buffer(FixedDelay(5ms));
+    const auto start = JitterBuffer::Clock::now();
+
+    buffer.Insert(10, Payload(10), start);
+    EXPECT_EQ(buffer.Insert(10, Payload(10), start), JitterBuffer::InsertResult::Duplicate);
+    buffer.Insert(12, Payload(12), start + 1ms);
+
+    // 11 never shows up in time, so the gap is skipped
+    EXPECT_EQ(PopAll(buffer, start + 20ms), (std::vector<uint32_t>{10, 12}));
+    EXPECT_EQ(buffer.Insert(11, Payload(11), start + 21ms), JitterBuffer::InsertResult::Late);
+    EXPECT_EQ(buffer.Insert(12, Payload(12), start + 22ms), JitterBuffer::InsertResult::Duplicate);
+
+    const auto stats = buffer.GetStatistics();
+    EXPECT_EQ(stats.duplicates, 2u);
+    EXPECT_EQ(stats.late_dropped, 1u);
+    EXPECT_EQ(stats.lost, 1u);
+}
+
+TEST(JitterBufferTest, ReorderWindowBoundsTheWait) {
+    JitterBufferConfig config = FixedDelay(1s);
+    config.reorder_window = 4;
+    JitterBuffer buffer(config);
+    const auto start = JitterBuffer::Clock::now();
+
+    buffer.Insert(0, Payload(0), start);
+    buffer.Insert(2, Payload(2), start);
+    buffer.Insert(3, Payload(3), start);
+    EXPECT_TRUE(PopAll(buffer, start).empty());
+
+    // Once the newest packet is a full window ahead, packets stop waiting
+    buffer.Insert(4, Payload(4), start);
+    EXPECT_EQ(PopAll(buffer, start), (std::vector<uint32_t>{0}));
+    buffer.Insert(5, Payload(5), start);
+    EXPECT_EQ(PopAll(buffer, start), (std::vector<uint32_t>{2}));
+    EXPECT_EQ(buffer.GetStatistics().lost, 1u);
+}
+
+TEST(JitterBufferTest, HandlesSequenceWraparound) {
+    JitterBuffer buffer(FixedDelay(0us));
+    const auto start = JitterBuffer::Clock::now();
+
+    buffer.Insert(0xFFFFFFFFu, Payload(0xFF), start);
+    buffer.Insert(1, Payload(1), start);
+    buffer.Insert(0, Payload(0), start);
+
+    EXPECT_EQ(PopAll(buffer, start), (std::vector<uint32_t>{0xFFFFFFFFu, 0, 1}));
+}
+
+TEST(JitterBufferTest, AdaptiveDelayFollowsJitter) {
+    JitterBufferConfig config;
+    config.max_delay = 10ms;
+    JitterBuffer buffer(config);
+    auto arrival = JitterBuffer::Clock::now();
+
+    // Steady 1ms spacing settles well below the 5ms starting target
+    for (uint32_t sequence = 0; sequence < 32; ++sequence) {
+        buffer.Insert(sequence, Payload(static_cast<uint8_t>(sequence)), arrival);
+        arrival += 1ms;
+    }
+    PopAll(buffer, arrival + 1s);
+    EXPECT_LT(buffer.GetCurrentDelay(), 1ms);
+
+    // Bursts separated by long gaps push it up to the ceiling
+    for (uint32_t sequence = 32; sequence < 128; ++sequence) {
+        buffer.Insert(sequence, Payload(static_cast<uint8_t>(sequence)), arrival);
+        arrival += (sequence % 4 == 0) ? 30ms : 0ms;
+        PopAll(buffer, arrival);
+    }
+    EXPECT_EQ(buffer.GetCurrentDelay(), 10ms);
+}
@@ -0,0 +1,172 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../lan_candidates.h"
+
+using namespace Core::Multiplayer::ModelA;
+
+namespace {
+
+const NetworkFingerprint HOME{"aa:bb:cc:dd:ee:ff", "home-wifi", "203.0.113.5"};
+const NetworkFingerprint ELSEWHERE{"11:22:33:44:55:66", "cafe", "198.51.100.9"};
+
+// Two exchanges talking through a room server that delivers in order
+class LanCandidateExchangeTest : public ::testing::Test {
+protected:
+    std::unique_ptr<LanCandidateExchange> MakeExchange(const std::string& player,
+                                                       const NetworkFingerprint& network,
+                                                       std::vector<LanHostCandidate> candidates) {
+        return std::make_unique<LanCandidateExchange>(
+            player, LanFingerprint::From(network), std::move(candidates),
+            [this](const P2PInfoMessage& message) { in_flight_.push_back(message); },
+            [this, player](const std::string& peer, const std::vector<LanHostCandidate>& found) {
+                verified_[player + "<-" + peer] = found;
+            });
+    }
+
+    void Deliver() {
+        while (!in_flight_.empty()) {
+            const P2PInfoMessage message = in_flight_.front();
+            in_flight_.pop_front();
+            ++delivered_;
+            auto& exchange = message.to_player == "alice" ? alice_ : bob_;
+            EXPECT_TRUE(exchange->OnP2PInfo(message));
+        }
+    }
+
+    const LanHostCandidate alice_host_{"192.168.1.10", 4001, "tcp"};
+    const LanHostCandidate bob_host_{"192.168.1.11", 4001, "udp"};
+    std::unique_ptr<LanCandidateExchange> alice_;
+    std::unique_ptr<LanCandidateExchange> bob_;
+    std::deque<P2PInfoMessage> in_flight_;
+    std::map<std::string, std::vector<LanHostCandidate>> verified_;
+    size_t delivered_ = 0;
+};
+
+} // namespace
+
+TEST(LanCandidatesTest, PrivateAddresses) {
+    EXPECT_TRUE(IsPrivateAddress("10.0.0.1"));
+    EXPECT_TRUE(IsPrivateAddress("172.16.5.4"));
+    EXPECT_FALSE(IsPrivateAddress("172.32.0.1"));
+    EXPECT_TRUE(IsPrivateAddress("192.168.0.20"));
+    EXPECT_TRUE(IsPrivateAddress("169.254.10.10"));
+    EXPECT_TRUE(IsPrivateAddress("fd12:3456::1"));
+    EXPECT_TRUE(IsPrivateAddress("fe80::1"));
+    EXPECT_FALSE(IsPrivateAddress("203.0.113.5"));
+    EXPECT_FALSE(IsPrivateAddress("2001:db8::1"));
+    EXPECT_FALSE(IsPrivateAddress("not-an-ip"));
+}
+
+TEST(LanCandidatesTest, FingerprintsMatchOnTheSameNetwork) {
+    const auto home = LanFingerprint::From(HOME);
+    EXPECT_TRUE(home.Matches(LanFingerprint::From(HOME)));
+    EXPECT_FALSE(home.Matches(LanFingerprint::From(ELSEWHERE)));
+    // Wired and wireless players of a household see different SSIDs
+    EXPECT_TRUE(home.Matches(LanFingerprint::From({HOME.gateway_mac, "", HOME.public_ip})));
+    // A gateway only one side knows is not held against the match
+    EXPECT_TRUE(home.Matches(LanFingerprint::From({"", "", HOME.public_ip})));
+    // Behind the same carrier-grade NAT but a different router
+    EXPECT_FALSE(home.Matches(LanFingerprint::From({"00:00:00:00:00:01", "", HOME.public_ip})));
+    EXPECT_FALSE(LanFingerprint{}.Matches(LanFingerprint{}));
+}
+
+TEST(LanCandidatesTest, OfferRoundTripsAndDropsPublicCandidates) {
+    LanCandidateOffer offer;
+    offer.fingerprint = LanFingerprint::From(HOME);
+    offer.nonce = 77;
+    offer.echo = 12;
+    offer.candidates = {{"192.168.1.10", 4001, "tcp"},
+                        {"203.0.113.5", 4001, "tcp"},
+                        {"fd00::5", 4002, "udp"}};
+
+    const P2PInfoMessage message = EncodeLanCandidateOffer(offer, "alice", "bob");
+    EXPECT_EQ(message.from_player, "alice");
+    EXPECT_EQ(message.to_player, "bob");
+
+    const auto decoded = DecodeLanCandidateOffer(message);
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_TRUE(decoded->fingerprint.Matches(offer.fingerprint));
+    EXPECT_EQ(decoded->fingerprint.gateway, offer.fingerprint.gateway);
+    EXPECT_EQ(decoded->nonce, 77u);
+    EXPECT_EQ(decoded->echo, 12u);
+    const std::vector<LanHostCandidate> expected{{"192.168.1.10", 4001, "tcp"},
+                                                 {"fd00::5", 4002, "udp"}};
+    EXPECT_EQ(decoded->candidates, expected);
+
+    P2PInfoMessage other;
+    other.session_description.type = "offer";
+    EXPECT_FALSE(DecodeLanCandidateOffer(other).has_value());
+}
+
+TEST_F(LanCandidateExchangeTest, SameNetworkPlayersVerifyEachOther) {
+    alice_ = MakeExchange("alice", HOME, {alice_host_});
+    bob_ = MakeExchange("bob", HOME, {bob_host_});
+
+    alice_->Begin("bob");
+    Deliver();
+
+    // Offer, answer echoing it, and the echo of the answer
+    EXPECT_EQ(delivered_, 3u);
+    ASSERT_EQ(verified_.size(), 2u);
+    EXPECT_EQ(verified_["alice<-bob"], std::vector<LanHostCandidate>{bob_host_});
+    EXPECT_EQ(verified_["bob<-alice"], std::vector<LanHostCandidate>{alice_host_});
+    EXPECT_EQ(alice_->GetVerifiedCandidates("bob"), std::vector<LanHostCandidate>{bob_host_});
+}
+
+TEST_F(LanCandidateExchangeTest, SimultaneousOffersSettle) {
+    alice_ = MakeExchange("alice", HOME, {alice_host_});
+    bob_ = MakeExchange("bob", HOME, {bob_host_});
+
+    alice_->Begin("bob");
+    bob_->Begin("alice");
+    Deliver();
+
+    EXPECT_EQ(verified_.size(), 2u);
+    EXPECT_LE(delivered_, 4u);
+}
+
+TEST_F(LanCandidateExchangeTest, OtherNetworksAreNotAnswered) {
+    alice_ = MakeExchange("alice", HOME, {alice_host_});
+    bob_ = MakeExchange("bob", ELSEWHERE, {bob_host_});
+
+    alice_->Begin("bob");
+    Deliver();
+
+    EXPECT_EQ(delivered_, 1u);
+    EXPECT_TRUE(verified_.empty());
+    EXPECT_TRUE(bob_->GetVerifiedCandidates("alice").empty());
+}
+
+TEST_F(LanCandidateExchangeTest, StaleOffersAreNotTrusted) {
+    alice_ = MakeExchange("alice", HOME, {alice_host_});
+    bob_ = MakeExchange("bob", HOME, {bob_host_});
+
+    alice_->Begin("bob");
+    ASSERT_EQ(in_flight_.size(), 1u);
+    const P2PInfoMessage first_offer = in_flight_.front();
+    Deliver();
+    ASSERT_EQ(verified_.size(), 2u);
+
+    // Bob starts over; an answer replayed from before echoes the old nonce
+    verified_.clear();
+    bob_->Begin("alice");
+    in_flight_.clear();
+    auto replayed = DecodeLanCandidateOffer(first_offer);
+    replayed->echo = 1;
+    EXPECT_TRUE(bob_->OnP2PInfo(EncodeLanCandidateOffer(*replayed, "alice", "bob")));
+    EXPECT_TRUE(verified_.empty());
+    EXPECT_TRUE(bob_->GetVerifiedCandidates("alice").empty());
+
+    // Other P2PInfo messages are left to their own handlers
+    P2PInfoMessage ice;
+    ice.from_player = "alice";
+    ice.session_description.type = "offer";
+    EXPECT_FALSE(bob_->OnP2PInfo(ice));
+}
@@ -0,0 +1,68 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "../packet_bundle.h"
+
+using namespace Core::Multiplayer::ModelA;
+
+namespace {
+
+std::vector<std::vector<uint8_t>> Unbundle(std::span<const uint8_t> bundle) {
+    std::vector<std::vector<uint8_t>> packets;
+    PacketBundler::ForEachPacket(bundle, [&](std::span<const uint8_t> packet) {
+        packets.emplace_back(packet.begin(), packet.end());
+    });
+    return packets;
+}
+
+} // anonymous namespace
+
+TEST(PacketBundlerTest, RoundTripsPacketsInOrder) {
+    PacketBundler bundler(64);
+    const std::vector<uint8_t> first{1, 2, 3};
+    const std::vector<uint8_t> second{4};
+    const std::vector<uint8_t> prefix{0xAA, 0xBB};
+    ASSERT_TRUE(bundler.Append(first));
+    ASSERT_TRUE(bundler.Append(prefix, second));
+    ASSERT_TRUE(bundler.Append({}));
+
+    EXPECT_EQ(bundler.GetPacketCount(), 3u);
+    EXPECT_EQ(bundler.GetBundle().size(), 3 * PacketBundler::LENGTH_PREFIX_SIZE + 6);
+    EXPECT_EQ(PacketBundler::CountPackets(bundler.GetBundle()), 3u);
+    EXPECT_EQ(Unbundle(bundler.GetBundle()),
+              (std::vector<std::vector<uint8_t>>{{1, 2, 3}, {0xAA, 0xBB, 4}, {}}));
+}
+
+TEST(PacketBundlerTest, RefusesPacketsPastCapacity) {
+    PacketBundler bundler(12);
+    const std::vector<uint8_t> packet(4, 0x11);
+    ASSERT_TRUE(bundler.Append(packet));
+    EXPECT_TRUE(bundler.Fits(4));
+    ASSERT_TRUE(bundler.Append(packet));
+    EXPECT_FALSE(bundler.Fits(0));
+    EXPECT_FALSE(bundler.Append(packet));
+    EXPECT_EQ(bundler.GetPacketCount(), 2u);
+
+    bundler.Clear();
+    EXPECT_TRUE(bundler.Empty());
+    EXPECT_TRUE(bundler.Append(packet));
+    EXPECT_EQ(std::vector<uint8_t>(bundler.GetSinglePacket().begin(),
+                                   bundler.GetSinglePacket().end()),
+              packet);
+}
+
+TEST(PacketBundlerTest, RejectsMalformedBundlesWithoutDelivering) {
+    // Second entry claims 5 bytes but only 1 follows
+    const std::vector<uint8_t> truncated{1, 0, 0x42, 5, 0, 0x43};
+    EXPECT_EQ(PacketBundler::CountPackets(truncated), 0u);
+    EXPECT_TRUE(Unbundle(truncated).empty());
+    EXPECT_FALSE(PacketBundler::ForEachPacket(truncated, [](std::span<const uint8_t>) {}));
+
+    // Dangling half of a length prefix
+    const std::vector<uint8_t> dangling{1, 0, 0x42, 1};
+    EXPECT_EQ(PacketBundler::CountPackets(dangling), 0u);
+    EXPECT_EQ(PacketBundler::CountPackets({}), 0u);
+}
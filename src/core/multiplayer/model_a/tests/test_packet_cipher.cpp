@@ -0,0 +1,138 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstring>
+#include <vector>
+
+#include "core/multiplayer/model_a/packet_cipher.h"
+
+using namespace Core::Multiplayer;
+using namespace Core::Multiplayer::ModelA;
+
+namespace {
+constexpr std::array<uint8_t, PacketCipher::KEY_SIZE> TEST_KEY = {
+    0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a,
+    0x8b, 0x8c, 0x8d, 0x8e, 0x8f, 0x90, 0x91, 0x92, 0x93, 0x94, 0x95,
+    0x96, 0x97, 0x98, 0x99, 0x9a, 0x9b, 0x9c, 0x9d, 0x9e, 0x9f};
+
+std::vector<PacketBuffer> MakeBurst(PacketPool& pool, size_t count, size_t size) {
+    std::vector<PacketBuffer> packets;
+    for (size_t i = 0; i < count; ++i) {
+        std::vector<uint8_t> payload(size);
+        for (size_t j = 0; j < size; ++j) {
+            payload[j] = static_cast<uint8_t>(i * 31 + j);
+        }
+        packets.push_back(pool.Acquire(payload.data(), payload.size()));
+    }
+    return packets;
+}
+
+class PacketCipherTest : public ::testing::TestWithParam<AeadAlgorithm> {};
+} // namespace
+
+TEST_P(PacketCipherTest, RoundTripsABurstInPlace) {
+    PacketCipher sender(GetParam(), TEST_KEY);
+    PacketCipher receiver(GetParam(), TEST_KEY);
+    ASSERT_TRUE(sender.IsValid());
+
+    PacketPool pool(16);
+    auto packets = MakeBurst(pool, 8, 200);
+    const auto originals = MakeBurst(pool, 8, 200);
+    const std::array<uint8_t, 4> header{1, 2, 3, 4};
+
+    EXPECT_EQ(sender.SealBatch(packets, header), 8u);
+    for (size_t i = 0; i < packets.size(); ++i) {
+        ASSERT_EQ(packets[i].size(), 200 + PacketCipher::OVERHEAD);
+        EXPECT_NE(std::memcmp(packets[i].data(), originals[i].data(), 200), 0);
+    }
+
+    EXPECT_EQ(receiver.OpenBatch(packets, header), 8u);
+    for (size_t i = 0; i < packets.size(); ++i) {
+        ASSERT_EQ(packets[i].size(), 200u);
+        EXPECT_EQ(std::memcmp(packets[i].data(), originals[i].data(), 200), 0);
+    }
+}
+
+TEST_P(PacketCipherTest, RejectsTamperingAndWrongHeader) {
+    PacketCipher sender(GetParam(), TEST_KEY);
+    PacketCipher receiver(GetParam(), TEST_KEY);
+    PacketPool pool(8);
+    auto packets = MakeBurst(pool, 3, 64);
+    const std::array<uint8_t, 2> header{7, 7};
+    const std::array<uint8_t, 2> other_header{7, 8};
+
+    sender.SealBatch(packets, header);
+    packets[0].data()[10] ^= 1;                                   // ciphertext
+    packets[1].data()[64 + PacketCipher::TAG_SIZE] ^= 1;          // nonce
+    EXPECT_EQ(receiver.OpenBatch(std::span(packets).first(2), header), 0u);
+    EXPECT_FALSE(packets[0].IsValid());
+    EXPECT_FALSE(packets[1].IsValid());
+
+    EXPECT_EQ(receiver.OpenBatch(std::span(packets).subspan(2), other_header), 0u);
+    EXPECT_EQ(receiver.GetStatistics().authentication_failures, 3u);
+}
+
+TEST_P(PacketCipherTest, RejectsReplaysButAcceptsReordering) {
+    PacketCipher sender(GetParam(), TEST_KEY);
+    PacketCipher receiver(GetParam(), TEST_KEY);
+    PacketPool pool(8);
+    auto packets = MakeBurst(pool, 3, 32);
+    sender.SealBatch(packets);
+
+    // Keep copies of the sealed bytes to replay later
+    std::vector<PacketBuffer> replay;
+    for (const auto& packet : packets) {
+        replay.push_back(pool.Acquire(packet.data(), packet.size()));
+    }
+
+    std::vector<PacketBuffer> reordered{packets[2], packets[0], packets[1]};
+    EXPECT_EQ(receiver.OpenBatch(reordered), 3u);
+    EXPECT_EQ(receiver.OpenBatch(replay), 0u);
+    EXPECT_EQ(receiver.GetStatistics().replays_rejected, 3u);
+}
+
+TEST_P(PacketCipherTest, ReleasesPacketsWithoutRoomForTheTag) {
+    PacketCipher sender(GetParam(), TEST_KEY);
+    PacketPool pool(4);
+    auto packets = MakeBurst(pool, 2, 16);
+    packets[1].Resize(PacketBuffer::capacity() - PacketCipher::OVERHEAD + 1);
+
+    EXPECT_EQ(sender.SealBatch(packets), 1u);
+    EXPECT_TRUE(packets[0].IsValid());
+    EXPECT_FALSE(packets[1].IsValid());
+}
+
+// Components/PacketCipher/SealOpenBurst in the component benchmarks times
+// this loop
+TEST_P(PacketCipherTest, SealsAndOpensTheSameBuffersRoundAfterRound) {
+    PacketCipher sender(GetParam(), TEST_KEY);
+    PacketCipher receiver(GetParam(), TEST_KEY);
+    PacketPool pool(32);
+    constexpr size_t BURST = 16;
+    constexpr size_t SIZE = 1200;
+    constexpr size_t ROUNDS = 20;
+
+    auto packets = MakeBurst(pool, BURST, SIZE);
+    const auto originals = MakeBurst(pool, BURST, SIZE);
+    for (size_t round = 0; round < ROUNDS; ++round) {
+        ASSERT_EQ(sender.SealBatch(packets), BURST);
+        ASSERT_EQ(receiver.OpenBatch(packets), BURST);
+    }
+    EXPECT_EQ(receiver.GetStatistics().opened, BURST * ROUNDS);
+    for (size_t i = 0; i < BURST; ++i) {
+        ASSERT_EQ(packets[i].size(), SIZE);
+        EXPECT_EQ(std::memcmp(packets[i].data(), originals[i].data(), SIZE), 0);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Algorithms, PacketCipherTest,
+                         ::testing::Values(AeadAlgorithm::ChaCha20Poly1305,
+                                           AeadAlgorithm::Aes256Gcm));
+
+TEST(PacketCipherSelectionTest, PreferredAlgorithmIsUsable) {
+    PacketCipher cipher(PacketCipher::PreferredAlgorithm(), TEST_KEY);
+    EXPECT_TRUE(cipher.IsValid());
+}
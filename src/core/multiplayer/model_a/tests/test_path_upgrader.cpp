@@ -0,0 +1,214 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../path_upgrader.h"
+
+using namespace Core::Multiplayer;
+using namespace Core::Multiplayer::ModelA;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct SentFrame {
+    PeerPath path;
+    std::vector<uint8_t> bytes;
+};
+
+class PathUpgraderTest : public ::testing::Test {
+protected:
+    std::unique_ptr<PathUpgrader> MakeUpgrader(const PathUpgradeConfig& config) {
+        return std::make_unique<PathUpgrader>(
+            config,
+            [this](const std::string& peer_id) {
+                std::lock_guard<std::mutex> lock(mutex);
+                dialed.push_back(peer_id);
+            },
+            [this](const std::string&, PeerPath path, const uint8_t* data, size_t size) {
+                std::lock_guard<std::mutex> lock(mutex);
+                sent.push_back({path, std::vector<uint8_t>(data, data + size)});
+                return true;
+            },
+            [this](const std::string&, PeerPath path) {
+                std::lock_guard<std::mutex> lock(mutex);
+                path_changes.push_back(path);
+            },
+            wheel);
+    }
+
+    std::vector<SentFrame> TakeSent() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return std::exchange(sent, {});
+    }
+
+    size_t DialCount() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return dialed.size();
+    }
+
+    std::vector<PeerPath> PathChanges() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return path_changes;
+    }
+
+    static bool WaitFor(const std::function<bool()>& condition) {
+        const auto deadline = std::chrono::steady_clock::now() + 2s;
+        while (!condition()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(1ms);
+        }
+        return true;
+    }
+
+    static PathUpgradeConfig FastConfig() {
+        PathUpgradeConfig config;
+        config.retry_interval = 20ms;
+        config.max_retry_interval = 40ms;
+        config.dual_send_duration = 10ms;
+        config.verify_timeout = 50ms;
+        return config;
+    }
+
+    std::shared_ptr<TimerWheel> wheel = std::make_shared<TimerWheel>(1ms);
+    std::mutex mutex;
+    std::vector<std::string> dialed;
+    std::vector<SentFrame> sent;
+    std::vector<PeerPath> path_changes;
+    const std::vector<uint8_t> payload{1, 2, 3, 4};
+};
+
+} // anonymous namespace
+
+TEST_F(PathUpgraderTest, RelayedPeerIsDialedRightAway) {
+    auto upgrader = MakeUpgrader(FastConfig());
+    upgrader->AddPeer("peer", PeerPath::Relay);
+
+    EXPECT_EQ(dialed, std::vector<std::string>{"peer"});
+    EXPECT_EQ(upgrader->GetState("peer"), PathState::Dialing);
+
+    ASSERT_TRUE(upgrader->Send("peer", payload.data(), payload.size()));
+    const auto frames = TakeSent();
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_EQ(frames[0].path, PeerPath::Relay);
+    EXPECT_EQ(frames[0].bytes.size(), payload.size() + 1);
+}
+
+TEST_F(PathUpgraderTest, DualSendsUntilTheDirectPathIsVerified) {
+    auto upgrader = MakeUpgrader(FastConfig());
+    upgrader->AddPeer("peer", PeerPath::Relay);
+    upgrader->OnDirectConnected("peer");
+    EXPECT_EQ(upgrader->GetState("peer"), PathState::DualSend);
+
+    upgrader->Send("peer", payload.data(), payload.size());
+    auto frames = TakeSent();
+    ASSERT_EQ(frames.size(), 2u);
+    EXPECT_EQ(frames[0].path, PeerPath::Relay);
+    EXPECT_EQ(frames[1].path, PeerPath::Direct);
+    EXPECT_EQ(frames[0].bytes, frames[1].bytes);
+    EXPECT_EQ(frames[0].bytes.size(), payload.size() + PathUpgrader::SEQUENCED_HEADER_SIZE);
+
+    // The peer's own frame arriving directly verifies the path
+    const std::vector<uint8_t> reply{0, 9};
+    const auto received = upgrader->Receive("peer", PeerPath::Direct, reply);
+    ASSERT_TRUE(received.has_value());
+    EXPECT_EQ(std::vector<uint8_t>(received->begin(), received->end()), std::vector<uint8_t>{9});
+
+    ASSERT_TRUE(WaitFor([&] { return upgrader->GetState("peer") == PathState::Direct; }));
+    EXPECT_EQ(PathChanges(), std::vector<PeerPath>{PeerPath::Direct});
+    EXPECT_EQ(upgrader->GetStatistics().upgrades, 1u);
+
+    upgrader->Send("peer", payload.data(), payload.size());
+    frames = TakeSent();
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_EQ(frames[0].path, PeerPath::Direct);
+}
+
+TEST_F(PathUpgraderTest, SecondCopyIsDropped) {
+    auto sender = MakeUpgrader(FastConfig());
+    sender->AddPeer("receiver", PeerPath::Relay);
+    sender->OnDirectConnected("receiver");
+    for (uint8_t i = 0; i < 3; ++i) {
+        sender->Send("receiver", &i, 1);
+    }
+    const auto frames = TakeSent();
+    ASSERT_EQ(frames.size(), 6u);
+
+    PathUpgrader receiver(FastConfig(), [](const std::string&) {},
+                          [](const std::string&, PeerPath, const uint8_t*, size_t) { return true; },
+                          nullptr, wheel);
+    receiver.AddPeer("sender", PeerPath::Direct);
+
+    // Direct copies first, then the relay's late ones, one out of order
+    std::vector<uint8_t> delivered;
+    for (const size_t index : {1u, 5u, 3u, 0u, 2u, 4u}) {
+        const auto result = receiver.Receive("sender", frames[index].path, frames[index].bytes);
+        if (result) {
+            delivered.push_back((*result)[0]);
+        }
+    }
+    EXPECT_EQ(delivered, (std::vector<uint8_t>{0, 2, 1}));
+    EXPECT_EQ(receiver.GetStatistics().duplicates, 3u);
+}
+
+TEST_F(PathUpgraderTest, UnverifiedDirectPathStaysOnRelayAndRetries) {
+    auto upgrader = MakeUpgrader(FastConfig());
+    upgrader->AddPeer("peer", PeerPath::Relay);
+    upgrader->OnDirectConnected("peer");
+
+    ASSERT_TRUE(WaitFor([&] { return upgrader->GetState("peer") == PathState::Relayed; }));
+    EXPECT_EQ(upgrader->GetStatistics().failures, 1u);
+    EXPECT_TRUE(PathChanges().empty());
+
+    ASSERT_TRUE(WaitFor([&] { return DialCount() == 2; }));
+    EXPECT_EQ(upgrader->GetState("peer"), PathState::Dialing);
+}
+
+TEST_F(PathUpgraderTest, DialWithoutAnswerTimesOut) {
+    auto upgrader = MakeUpgrader(FastConfig());
+    upgrader->AddPeer("peer", PeerPath::Relay);
+
+    ASSERT_TRUE(WaitFor([&] { return upgrader->GetStatistics().failures == 1; }));
+    ASSERT_TRUE(WaitFor([&] { return DialCount() >= 2; }));
+    EXPECT_GE(upgrader->GetStatistics().attempts, 2u);
+}
+
+TEST_F(PathUpgraderTest, LostDirectPathFallsBackToTheRelay) {
+    auto upgrader = MakeUpgrader(FastConfig());
+    upgrader->AddPeer("peer", PeerPath::Direct);
+    EXPECT_TRUE(dialed.empty());
+
+    upgrader->OnDirectDisconnected("peer");
+    EXPECT_EQ(upgrader->GetState("peer"), PathState::Relayed);
+    EXPECT_EQ(PathChanges(), std::vector<PeerPath>{PeerPath::Relay});
+    EXPECT_EQ(upgrader->GetStatistics().fallbacks, 1u);
+
+    upgrader->Send("peer", payload.data(), payload.size());
+    const auto frames = TakeSent();
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_EQ(frames[0].path, PeerPath::Relay);
+
+    ASSERT_TRUE(WaitFor([&] { return DialCount() == 1; }));
+}
+
+TEST_F(PathUpgraderTest, MalformedFramesAreRejected) {
+    auto upgrader = MakeUpgrader(FastConfig());
+    upgrader->AddPeer("peer", PeerPath::Direct);
+    EXPECT_FALSE(upgrader->Receive("peer", PeerPath::Relay, std::vector<uint8_t>{}));
+    EXPECT_FALSE(upgrader->Receive("peer", PeerPath::Relay, std::vector<uint8_t>{7, 1}));
+    EXPECT_FALSE(upgrader->Receive("peer", PeerPath::Relay, std::vector<uint8_t>{1, 0, 0}));
+
+    const std::vector<uint8_t> oversized(PathUpgrader::MAX_PAYLOAD_SIZE + 1, 0);
+    EXPECT_FALSE(upgrader->Send("peer", oversized.data(), oversized.size()));
+    EXPECT_FALSE(upgrader->Send("stranger", payload.data(), payload.size()));
+}
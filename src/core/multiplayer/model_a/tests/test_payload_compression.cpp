@@ -0,0 +1,64 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include "../payload_compression.h"
+
+using namespace Core::Multiplayer::ModelA;
+
+namespace {
+
+std::vector<uint8_t> CompressiblePayload(size_t size) {
+    std::vector<uint8_t> payload(size);
+    for (size_t i = 0; i < size; ++i) {
+        payload[i] = static_cast<uint8_t>(i % 16);
+    }
+    return payload;
+}
+
+} // anonymous namespace
+
+TEST(PayloadCompressorTest, RoundTripsCompressiblePayloads) {
+    const auto payload = CompressiblePayload(4096);
+    const auto compressed = PayloadCompressor::Compress(payload);
+    ASSERT_FALSE(compressed.empty());
+    EXPECT_LT(compressed.size(), payload.size() / 4);
+
+    const std::vector<uint8_t> wire(compressed.begin(), compressed.end());
+    const auto restored = PayloadCompressor::Decompress(wire);
+    EXPECT_EQ(std::vector<uint8_t>(restored.begin(), restored.end()), payload);
+}
+
+TEST(PayloadCompressorTest, LeavesIncompressiblePayloadsAlone) {
+    // LZ4 cannot shrink a handful of distinct bytes
+    const std::vector<uint8_t> payload{1, 2, 3, 4, 5, 6, 7, 8};
+    EXPECT_TRUE(PayloadCompressor::Compress(payload).empty());
+    EXPECT_TRUE(PayloadCompressor::Compress({}).empty());
+}
+
+TEST(PayloadCompressorTest, RejectsCorruptInput) {
+    const auto compressed = PayloadCompressor::Compress(CompressiblePayload(1024));
+    ASSERT_FALSE(compressed.empty());
+    // Truncated mid-sequence
+    const std::vector<uint8_t> truncated(compressed.begin(), compressed.begin() + 4);
+    EXPECT_TRUE(PayloadCompressor::Decompress(truncated).empty());
+    EXPECT_TRUE(PayloadCompressor::Decompress({}).empty());
+}
+
+TEST(PayloadCompressorTest, ThreadsUseTheirOwnBuffers) {
+    const auto first_payload = CompressiblePayload(2048);
+    const auto first = PayloadCompressor::Compress(first_payload);
+    ASSERT_FALSE(first.empty());
+    const std::vector<uint8_t> expected(first.begin(), first.end());
+
+    std::thread([] {
+        const std::vector<uint8_t> other(3000, 0x7F);
+        EXPECT_FALSE(PayloadCompressor::Compress(other).empty());
+    }).join();
+
+    // Another thread's call did not overwrite this thread's result
+    EXPECT_EQ(std::vector<uint8_t>(first.begin(), first.end()), expected);
+}
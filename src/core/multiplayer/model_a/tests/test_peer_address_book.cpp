@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "../peer_address_book.h"
+
+using namespace Core::Multiplayer::ModelA;
+
+namespace {
+
+class PeerAddressBookTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = (std::filesystem::temp_directory_path() /
+                 ("peer_address_book_test_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) +
+                  "_" + ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".json"))
+                    .string();
+        std::filesystem::remove(path_);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(path_);
+    }
+
+    std::string path_;
+};
+
+} // namespace
+
+TEST_F(PeerAddressBookTest, RecordSurvivesReload) {
+    const auto now = std::chrono::system_clock::now();
+    {
+        PeerAddressBook book(path_, 8);
+        ASSERT_TRUE(book.Load());
+        ASSERT_TRUE(book.RecordSuccess("peer_a", "/ip4/203.0.113.7/tcp/4001", false, now));
+        ASSERT_TRUE(book.RecordSuccess("peer_a", "/ip4/203.0.113.7/tcp/4002", true, now));
+    }
+
+    PeerAddressBook book(path_, 8);
+    ASSERT_TRUE(book.Load());
+    const auto record = book.Lookup("peer_a");
+    ASSERT_TRUE(record.has_value());
+    EXPECT_EQ(record->multiaddr, "/ip4/203.0.113.7/tcp/4002");
+    EXPECT_TRUE(record->via_relay);
+    EXPECT_EQ(record->success_count, 2u);
+    EXPECT_FALSE(book.Lookup("peer_b").has_value());
+}
+
+TEST_F(PeerAddressBookTest, LeastRecentlyReachedPeerIsEvicted) {
+    PeerAddressBook book(path_, 2);
+    const auto now = std::chrono::system_clock::now();
+    book.RecordSuccess("peer_a", "/ip4/203.0.113.1/tcp/4001", false, now - std::chrono::hours(2));
+    book.RecordSuccess("peer_b", "/ip4/203.0.113.2/tcp/4001", false, now - std::chrono::hours(1));
+    book.RecordSuccess("peer_c", "/ip4/203.0.113.3/tcp/4001", false, now);
+
+    EXPECT_EQ(book.GetRecordCount(), 2u);
+    EXPECT_FALSE(book.Lookup("peer_a").has_value());
+    EXPECT_TRUE(book.Lookup("peer_c").has_value());
+}
+
+TEST_F(PeerAddressBookTest, ForgottenPeersStayForgotten) {
+    {
+        PeerAddressBook book(path_, 8);
+        book.RecordSuccess("peer_a", "/ip4/203.0.113.1/tcp/4001", false);
+        ASSERT_TRUE(book.Forget("peer_a"));
+    }
+    PeerAddressBook book(path_, 8);
+    ASSERT_TRUE(book.Load());
+    EXPECT_EQ(book.GetRecordCount(), 0u);
+}
+
+TEST_F(PeerAddressBookTest, MissingOrCorruptFileStartsEmpty) {
+    PeerAddressBook missing(path_, 8);
+    EXPECT_TRUE(missing.Load());
+    EXPECT_EQ(missing.GetRecordCount(), 0u);
+
+    std::ofstream(path_) << "{ not json";
+    PeerAddressBook corrupt(path_, 8);
+    EXPECT_FALSE(corrupt.Load());
+    EXPECT_EQ(corrupt.GetRecordCount(), 0u);
+}
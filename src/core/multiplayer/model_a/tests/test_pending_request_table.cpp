@@ -0,0 +1,128 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "../pending_request_table.h"
+
+using namespace Core::Multiplayer;
+using namespace Core::Multiplayer::ModelA;
+
+namespace {
+
+class PendingRequestTableTest : public ::testing::Test {
+protected:
+    std::unique_ptr<PendingRequestTable> MakeTable(size_t max_in_flight,
+                                                   std::chrono::milliseconds timeout) {
+        auto table = std::make_unique<PendingRequestTable>(wheel, max_in_flight, timeout);
+        table->SetOnTimeout([this](uint32_t request_id, MessageType type) {
+            std::lock_guard<std::mutex> lock(mutex);
+            timed_out.emplace_back(request_id, type);
+        });
+        return table;
+    }
+
+    size_t TimedOutCount() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return timed_out.size();
+    }
+
+    bool WaitForTimeouts(size_t count) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (TimedOutCount() < count) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    std::shared_ptr<TimerWheel> wheel =
+        std::make_shared<TimerWheel>(std::chrono::milliseconds(1));
+    std::mutex mutex;
+    std::vector<std::pair<uint32_t, MessageType>> timed_out;
+};
+
+} // anonymous namespace
+
+TEST_F(PendingRequestTableTest, CapsRequestsInFlight) {
+    auto table = MakeTable(3, std::chrono::seconds(10));
+    std::set<uint32_t> ids;
+    for (int i = 0; i < 3; ++i) {
+        const uint32_t id = table->Begin(MessageType::RoomList);
+        ASSERT_NE(id, PendingRequestTable::INVALID_REQUEST_ID);
+        ids.insert(id);
+    }
+    EXPECT_EQ(ids.size(), 3u);
+    EXPECT_EQ(table->Begin(MessageType::JoinRoom), PendingRequestTable::INVALID_REQUEST_ID);
+
+    ASSERT_TRUE(table->Complete(*ids.begin()));
+    EXPECT_EQ(table->GetInFlightCount(), 2u);
+    EXPECT_NE(table->Begin(MessageType::JoinRoom), PendingRequestTable::INVALID_REQUEST_ID);
+}
+
+TEST_F(PendingRequestTableTest, MatchesEachReplyOnce) {
+    auto table = MakeTable(8, std::chrono::seconds(10));
+    const uint32_t id = table->Begin(MessageType::CreateRoom);
+    EXPECT_TRUE(table->Complete(id));
+    EXPECT_FALSE(table->Complete(id));
+    EXPECT_FALSE(table->Complete(id + 100));
+    EXPECT_FALSE(table->Extend(id));
+    EXPECT_EQ(table->GetInFlightCount(), 0u);
+    EXPECT_EQ(wheel->GetTimerCount(), 0u);
+}
+
+TEST_F(PendingRequestTableTest, ReportsUnansweredRequests) {
+    auto table = MakeTable(8, std::chrono::milliseconds(20));
+    const uint32_t answered = table->Begin(MessageType::Register);
+    const uint32_t unanswered = table->Begin(MessageType::JoinRoom);
+    table->Complete(answered);
+
+    ASSERT_TRUE(WaitForTimeouts(1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(timed_out.size(), 1u);
+    EXPECT_EQ(timed_out[0].first, unanswered);
+    EXPECT_EQ(timed_out[0].second, MessageType::JoinRoom);
+    EXPECT_FALSE(table->Complete(unanswered));
+}
+
+TEST_F(PendingRequestTableTest, ExtendRestartsTheTimeout) {
+    auto table = MakeTable(8, std::chrono::milliseconds(60));
+    const uint32_t id = table->Begin(MessageType::RoomList);
+    for (int i = 0; i < 4; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        ASSERT_TRUE(table->Extend(id));
+    }
+    EXPECT_EQ(TimedOutCount(), 0u);
+    EXPECT_TRUE(WaitForTimeouts(1));
+}
+
+TEST_F(PendingRequestTableTest, ClearForgetsWithoutReporting) {
+    auto table = MakeTable(8, std::chrono::milliseconds(20));
+    table->Begin(MessageType::RoomList);
+    table->Begin(MessageType::CreateRoom);
+    table->Clear();
+    EXPECT_EQ(table->GetInFlightCount(), 0u);
+    EXPECT_EQ(wheel->GetTimerCount(), 0u);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(TimedOutCount(), 0u);
+}
+
+TEST_F(PendingRequestTableTest, DestructionCancelsTimers) {
+    auto table = MakeTable(8, std::chrono::milliseconds(5));
+    for (int i = 0; i < 8; ++i) {
+        table->Begin(MessageType::RoomList);
+    }
+    table.reset();
+    EXPECT_EQ(wheel->GetTimerCount(), 0u);
+}
@@ -0,0 +1,159 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../permessage_deflate.h"
+
+using namespace Core::Multiplayer::ModelA;
+
+namespace {
+
+std::string RoomDelta(int version) {
+    return R"({"type":"room_list_delta","base_version":)" + std::to_string(version) +
+           R"(,"version":)" + std::to_string(version + 1) +
+           R"(,"snapshot":false,"removed":[],"upserted":[{"id":"room)" +
+           std::to_string(version) +
+           R"(","game_id":"0100000000010000","game_name":"Mario Kart 8 Deluxe",)"
+           R"("host_name":"host","current_players":3,"max_players":8,"ping":42,)"
+           R"("region":"eu"}]})";
+}
+
+// Client and server ends of one connection, sharing the negotiated parameters
+struct Link {
+    explicit Link(const PerMessageDeflateParameters& parameters)
+        : client(parameters), server(parameters) {}
+
+    // Client to server; the server side inflates with the client's window
+    std::string Send(const std::string& message, size_t* wire_size = nullptr) {
+        const auto compressed = client.Compress(message);
+        EXPECT_TRUE(compressed);
+        if (!compressed) {
+            return {};
+        }
+        if (wire_size) {
+            *wire_size = compressed->size();
+        }
+        const std::vector<uint8_t> wire(compressed->begin(), compressed->end());
+        const auto inflated = server.Decompress(wire);
+        EXPECT_TRUE(inflated);
+        return inflated ? std::string(*inflated) : std::string{};
+    }
+
+    PerMessageDeflate client;
+    PerMessageDeflate server;
+};
+
+} // anonymous namespace
+
+TEST(PerMessageDeflateTest, OfferPrefersTheRoomDictionary) {
+    PerMessageDeflateConfig config;
+    EXPECT_EQ(MakePerMessageDeflateOffer(config),
+              "permessage-deflate; client_max_window_bits; x-sudachi-room-dictionary, "
+              "permessage-deflate; client_max_window_bits");
+
+    config.room_dictionary = false;
+    config.context_takeover = false;
+    config.server_max_window_bits = 12;
+    EXPECT_EQ(MakePerMessageDeflateOffer(config),
+              "permessage-deflate; client_max_window_bits; server_max_window_bits=12; "
+              "server_no_context_takeover; client_no_context_takeover");
+
+    config.enabled = false;
+    EXPECT_TRUE(MakePerMessageDeflateOffer(config).empty());
+}
+
+TEST(PerMessageDeflateTest, ParsesTheAcceptedOffer) {
+    const PerMessageDeflateConfig config;
+    const auto accepted = ParsePerMessageDeflateResponse(
+        "permessage-deflate; client_max_window_bits=10; server_no_context_takeover; "
+        "x-sudachi-room-dictionary",
+        config);
+    ASSERT_TRUE(accepted);
+    EXPECT_EQ(accepted->client_max_window_bits, 10);
+    EXPECT_TRUE(accepted->server_no_context_takeover);
+    EXPECT_FALSE(accepted->client_no_context_takeover);
+    EXPECT_TRUE(accepted->room_dictionary);
+
+    EXPECT_FALSE(ParsePerMessageDeflateResponse("", config));
+    EXPECT_FALSE(ParsePerMessageDeflateResponse("permessage-deflate; bogus", config));
+    EXPECT_FALSE(ParsePerMessageDeflateResponse(
+        "permessage-deflate; server_no_context_takeover; server_no_context_takeover", config));
+    EXPECT_FALSE(
+        ParsePerMessageDeflateResponse("permessage-deflate; client_max_window_bits=8", config));
+
+    // A window above the one the client asked for
+    PerMessageDeflateConfig small_window;
+    small_window.server_max_window_bits = 10;
+    EXPECT_FALSE(ParsePerMessageDeflateResponse(
+        "permessage-deflate; server_max_window_bits=12", small_window));
+}
+
+TEST(PerMessageDeflateTest, ContextTakeoverShrinksRepeatedMessages) {
+    Link link(PerMessageDeflateParameters{});
+    size_t first = 0;
+    size_t second = 0;
+    EXPECT_EQ(link.Send(RoomDelta(1), &first), RoomDelta(1));
+    EXPECT_EQ(link.Send(RoomDelta(2), &second), RoomDelta(2));
+    EXPECT_LT(second * 2, first);
+
+    PerMessageDeflateParameters no_takeover;
+    no_takeover.client_no_context_takeover = true;
+    no_takeover.server_no_context_takeover = true;
+    Link fresh(no_takeover);
+    size_t again = 0;
+    fresh.Send(RoomDelta(1), &again);
+    fresh.Send(RoomDelta(2), &again);
+    EXPECT_GT(again, second * 2);
+}
+
+TEST(PerMessageDeflateTest, DictionaryShrinksTheFirstMessage) {
+    size_t plain = 0;
+    size_t primed = 0;
+    Link(PerMessageDeflateParameters{}).Send(RoomDelta(1), &plain);
+
+    PerMessageDeflateParameters dictionary;
+    dictionary.room_dictionary = true;
+    dictionary.client_no_context_takeover = true;
+    dictionary.server_no_context_takeover = true;
+    Link link(dictionary);
+    EXPECT_EQ(link.Send(RoomDelta(1), &primed), RoomDelta(1));
+    EXPECT_LT(primed, plain);
+    // The dictionary is restored after each reset
+    EXPECT_EQ(link.Send(RoomDelta(2)), RoomDelta(2));
+}
+
+TEST(PerMessageDeflateTest, SmallMessagesGoOutUncompressed) {
+    PerMessageDeflate codec(PerMessageDeflateParameters{});
+    EXPECT_FALSE(codec.Compress(R"({"type":"ping"})"));
+}
+
+TEST(PerMessageDeflateTest, RefusesOversizedAndCorruptPayloads) {
+    PerMessageDeflateConfig config;
+    config.max_message_size = 1024;
+    PerMessageDeflate sender(PerMessageDeflateParameters{});
+    PerMessageDeflate receiver(PerMessageDeflateParameters{}, config);
+
+    // Compresses to a few dozen bytes, inflates to 64 KiB
+    const auto bomb = sender.Compress(std::string(64 * 1024, 'a'));
+    ASSERT_TRUE(bomb);
+    EXPECT_LT(bomb->size(), 1024u);
+    EXPECT_FALSE(receiver.Decompress(*bomb));
+
+    PerMessageDeflate corrupt(PerMessageDeflateParameters{});
+    const std::vector<uint8_t> garbage{0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    EXPECT_FALSE(corrupt.Decompress(garbage));
+}
+
+TEST(PerMessageDeflateTest, LargeMessagesSpanSeveralChunks) {
+    Link link(PerMessageDeflateParameters{});
+    std::string message;
+    for (int i = 0; message.size() < 200 * 1024; ++i) {
+        message += RoomDelta(i);
+    }
+    EXPECT_EQ(link.Send(message), message);
+    EXPECT_EQ(link.Send(message), message);
+}
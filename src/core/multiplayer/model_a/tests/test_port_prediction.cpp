@@ -0,0 +1,261 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "../port_prediction.h"
+
+using namespace Core::Multiplayer;
+using namespace Core::Multiplayer::ModelA;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr StunTransactionId TRANSACTION_ID = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+
+// Binding success response with one IPv4 address attribute
+std::vector<uint8_t> MakeBindingResponse(const StunTransactionId& transaction_id,
+                                         const std::array<uint8_t, 4>& address, uint16_t port,
+                                         bool xored) {
+    std::vector<uint8_t> response = {0x01, 0x01, 0x00, 0x0C, 0x21, 0x12, 0xA4, 0x42};
+    response.insert(response.end(), transaction_id.begin(), transaction_id.end());
+    const uint8_t cookie[4] = {0x21, 0x12, 0xA4, 0x42};
+    const uint16_t wire_port = xored ? static_cast<uint16_t>(port ^ 0x2112) : port;
+    response.insert(response.end(), {0x00, static_cast<uint8_t>(xored ? 0x20 : 0x01), 0x00, 0x08,
+                                     0x00, 0x01, static_cast<uint8_t>(wire_port >> 8),
+                                     static_cast<uint8_t>(wire_port)});
+    for (size_t i = 0; i < 4; ++i) {
+        response.push_back(xored ? static_cast<uint8_t>(address[i] ^ cookie[i]) : address[i]);
+    }
+    return response;
+}
+
+std::vector<MappedAddress> Mappings(std::initializer_list<uint16_t> ports) {
+    std::vector<MappedAddress> mappings;
+    for (const uint16_t port : ports) {
+        mappings.push_back({"198.51.100.4", port});
+    }
+    return mappings;
+}
+
+/**
+ * Answers Binding requests on loopback with the sender's address, like a
+ * STUN server with no NAT in between
+ */
+class LoopbackStunServer {
+public:
+    LoopbackStunServer() {
+        socket_.Open("127.0.0.1", 0);
+        thread_ = std::thread([this] { Run(); });
+    }
+
+    ~LoopbackStunServer() {
+        stop_ = true;
+        thread_.join();
+    }
+
+    DatagramEndpoint GetEndpoint() const {
+        return socket_.GetLocalEndpoint();
+    }
+
+private:
+    void Run() {
+        std::array<uint8_t, 548> buffer;
+        while (!stop_) {
+            if (!socket_.WaitReadable(10ms)) {
+                continue;
+            }
+            DatagramReceiveSlot slot{};
+            slot.buffer = buffer.data();
+            slot.capacity = buffer.size();
+            while (socket_.ReceiveBatch(&slot, 1) == 1) {
+                if (slot.size != 20) {
+                    continue;
+                }
+                StunTransactionId transaction_id;
+                std::memcpy(transaction_id.data(), buffer.data() + 8, transaction_id.size());
+                const auto response = MakeBindingResponse(transaction_id, {127, 0, 0, 1},
+                                                          slot.from.Port(), true);
+                OutgoingDatagram outgoing{response.data(), response.size()};
+                outgoing.to = &slot.from;
+                socket_.SendBatch(&outgoing, 1);
+            }
+        }
+    }
+
+    DatagramSocket socket_;
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
+
+} // namespace
+
+TEST(PortPredictionTest, BindingRequestHeader) {
+    const auto request = EncodeStunBindingRequest(TRANSACTION_ID);
+    EXPECT_EQ(request[0], 0x00);
+    EXPECT_EQ(request[1], 0x01);
+    EXPECT_EQ(request[3], 0x00);
+    EXPECT_EQ(request[4], 0x21);
+    EXPECT_EQ(request[7], 0x42);
+    EXPECT_TRUE(std::equal(TRANSACTION_ID.begin(), TRANSACTION_ID.end(), request.begin() + 8));
+}
+
+TEST(PortPredictionTest, ParsesXorAndPlainMappedAddress) {
+    const auto xored = MakeBindingResponse(TRANSACTION_ID, {203, 0, 113, 9}, 40001, true);
+    const auto mapped = ParseStunBindingResponse(xored.data(), xored.size(), TRANSACTION_ID);
+    ASSERT_TRUE(mapped.has_value());
+    EXPECT_EQ(*mapped, (MappedAddress{"203.0.113.9", 40001}));
+
+    const auto plain = MakeBindingResponse(TRANSACTION_ID, {203, 0, 113, 9}, 40001, false);
+    EXPECT_EQ(ParseStunBindingResponse(plain.data(), plain.size(), TRANSACTION_ID), mapped);
+}
+
+TEST(PortPredictionTest, RejectsOtherTransactionsAndTruncation) {
+    const auto response = MakeBindingResponse(TRANSACTION_ID, {203, 0, 113, 9}, 40001, true);
+    StunTransactionId other = TRANSACTION_ID;
+    other[11] ^= 0xFF;
+    EXPECT_FALSE(ParseStunBindingResponse(response.data(), response.size(), other).has_value());
+    EXPECT_FALSE(
+        ParseStunBindingResponse(response.data(), response.size() - 2, TRANSACTION_ID).has_value());
+}
+
+TEST(PortPredictionTest, ClassifiesAllocation) {
+    EXPECT_EQ(AnalyzePortAllocation(Mappings({40000})).allocation, PortAllocation::Unknown);
+    EXPECT_EQ(AnalyzePortAllocation(Mappings({40000, 40000, 40000})).allocation,
+              PortAllocation::Stable);
+
+    const auto exact = AnalyzePortAllocation(Mappings({40000, 40002, 40004}));
+    EXPECT_EQ(exact.allocation, PortAllocation::Sequential);
+    EXPECT_EQ(exact.delta, 2);
+    EXPECT_TRUE(exact.exact);
+    EXPECT_EQ(exact.last_mapping.port, 40004);
+
+    const auto irregular = AnalyzePortAllocation(Mappings({40000, 40003, 40004}));
+    EXPECT_EQ(irregular.allocation, PortAllocation::Sequential);
+    EXPECT_EQ(irregular.delta, 1);
+    EXPECT_FALSE(irregular.exact);
+
+    EXPECT_EQ(AnalyzePortAllocation(Mappings({40000, 52311})).allocation, PortAllocation::Random);
+    EXPECT_EQ(AnalyzePortAllocation(Mappings({40000, 40004, 40001})).allocation,
+              PortAllocation::Random);
+
+    auto moved = Mappings({40000, 40001});
+    moved[1].ip = "198.51.100.5";
+    EXPECT_EQ(AnalyzePortAllocation(moved).allocation, PortAllocation::Random);
+}
+
+TEST(PortPredictionTest, PredictsNextPorts) {
+    EXPECT_EQ(PredictPorts(AnalyzePortAllocation(Mappings({40000, 40000})), 4),
+              std::vector<uint16_t>{40000});
+    EXPECT_EQ(PredictPorts(AnalyzePortAllocation(Mappings({40000, 40002, 40004})), 3),
+              (std::vector<uint16_t>{40006, 40008, 40010}));
+    EXPECT_EQ(PredictPorts(AnalyzePortAllocation(Mappings({40000, 40003, 40004})), 3),
+              (std::vector<uint16_t>{40005, 40006, 40007}));
+    EXPECT_EQ(PredictPorts(AnalyzePortAllocation(Mappings({1030, 1028})), 8),
+              (std::vector<uint16_t>{1026, 1024}));
+    EXPECT_TRUE(PredictPorts(AnalyzePortAllocation(Mappings({40000, 52311})), 8).empty());
+}
+
+TEST(PortPredictionTest, GivesUpOnNetworksThatKeepFailing) {
+    PortPredictionConfig config;
+    config.min_attempts = 4;
+    config.min_success_rate = 0.25;
+    EXPECT_TRUE(ShouldTryPortPrediction(PortAllocation::Unknown, 0, 0, config));
+    EXPECT_FALSE(ShouldTryPortPrediction(PortAllocation::Random, 0, 0, config));
+    EXPECT_TRUE(ShouldTryPortPrediction(PortAllocation::Sequential, 3, 0, config));
+    EXPECT_FALSE(ShouldTryPortPrediction(PortAllocation::Sequential, 8, 1, config));
+    EXPECT_TRUE(ShouldTryPortPrediction(PortAllocation::Sequential, 8, 2, config));
+}
+
+TEST(PortPredictionTest, OfferSurvivesP2PInfoMessage) {
+    PortPredictionOffer offer;
+    offer.address = {"203.0.113.9", 40006};
+    offer.ports = {40006, 40008, 40010};
+    offer.allocation = PortAllocation::Sequential;
+    offer.punch_at = std::chrono::system_clock::time_point(1750000000123ms);
+    offer.token = 0xFEDCBA9876543210ull;
+
+    const auto message = EncodePortPredictionOffer(offer, "alice", "bob");
+    EXPECT_EQ(message.to_player, "bob");
+    EXPECT_EQ(message.ice_candidates.size(), 3u);
+    const auto decoded = DecodePortPredictionOffer(message);
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_EQ(decoded->address, offer.address);
+    EXPECT_EQ(decoded->ports, offer.ports);
+    EXPECT_EQ(decoded->allocation, offer.allocation);
+    EXPECT_EQ(decoded->punch_at, offer.punch_at);
+    EXPECT_EQ(decoded->token, offer.token);
+
+    P2PInfoMessage other = message;
+    other.session_description.type = "offer";
+    EXPECT_FALSE(DecodePortPredictionOffer(other).has_value());
+}
+
+TEST(PortPredictionTest, PunchesThroughOnLoopback) {
+    LoopbackStunServer first_server;
+    LoopbackStunServer second_server;
+    const std::vector<DatagramEndpoint> servers = {first_server.GetEndpoint(),
+                                                   second_server.GetEndpoint()};
+
+    PortPredictionConfig config;
+    config.punch_duration = 1000ms;
+    PortPredictionPuncher initiator(config);
+    PortPredictionPuncher responder(config);
+    ASSERT_EQ(initiator.Open("127.0.0.1"), ErrorCode::Success);
+    ASSERT_EQ(responder.Open("127.0.0.1"), ErrorCode::Success);
+
+    // Without a NAT every server sees the bound port
+    const auto profile = initiator.Probe(servers);
+    EXPECT_EQ(profile.allocation, PortAllocation::Stable);
+    EXPECT_EQ(profile.last_mapping.port, initiator.GetSocket().GetLocalEndpoint().Port());
+    ASSERT_EQ(responder.Probe(servers).allocation, PortAllocation::Stable);
+
+    const uint64_t token = 42;
+    const auto offer = initiator.MakeOffer(std::chrono::system_clock::now() + 50ms, token);
+    const auto answer =
+        *DecodePortPredictionOffer(EncodePortPredictionOffer(responder.MakeAnswer(offer), "b", "a"));
+    EXPECT_EQ(answer.punch_at, std::chrono::time_point_cast<std::chrono::milliseconds>(offer.punch_at));
+
+    std::optional<DatagramEndpoint> initiator_peer;
+    std::thread initiator_thread([&] { initiator_peer = initiator.Punch(answer, token); });
+    const auto responder_peer = responder.Punch(offer, token);
+    initiator_thread.join();
+
+    ASSERT_TRUE(initiator_peer.has_value());
+    ASSERT_TRUE(responder_peer.has_value());
+    EXPECT_EQ(*initiator_peer, responder.GetSocket().GetLocalEndpoint());
+    EXPECT_EQ(*responder_peer, initiator.GetSocket().GetLocalEndpoint());
+}
+
+TEST(PortPredictionTest, PunchIgnoresOtherTokens) {
+    PortPredictionConfig config;
+    config.punch_duration = 200ms;
+    PortPredictionPuncher first(config);
+    PortPredictionPuncher second(config);
+    ASSERT_EQ(first.Open("127.0.0.1"), ErrorCode::Success);
+    ASSERT_EQ(second.Open("127.0.0.1"), ErrorCode::Success);
+
+    const auto at = std::chrono::system_clock::now();
+    const PortPredictionOffer to_second{{"127.0.0.1", 0},
+                                        {second.GetSocket().GetLocalEndpoint().Port()},
+                                        PortAllocation::Unknown,
+                                        at,
+                                        0};
+    const PortPredictionOffer to_first{{"127.0.0.1", 0},
+                                       {first.GetSocket().GetLocalEndpoint().Port()},
+                                       PortAllocation::Unknown,
+                                       at,
+                                       0};
+
+    std::optional<DatagramEndpoint> first_peer;
+    std::thread first_thread([&] { first_peer = first.Punch(to_second, 1); });
+    EXPECT_FALSE(second.Punch(to_first, 2).has_value());
+    first_thread.join();
+    EXPECT_FALSE(first_peer.has_value());
+}
@@ -0,0 +1,47 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "../protocol_decoder.h"
+
+using namespace Core::Multiplayer;
+using namespace Core::Multiplayer::ModelA;
+
+namespace {
+
+struct Undecodable {};
+
+} // anonymous namespace
+
+static_assert(DecodableMessage<std::span<const uint8_t>>);
+static_assert(DecodableMessage<LdnPacketView>);
+static_assert(!DecodableMessage<Undecodable>);
+
+TEST(ProtocolDecoderTest, RawMessageIsTheBufferItself) {
+    const std::vector<uint8_t> data{1, 2, 3};
+    const auto message = ProtocolDecoder<std::span<const uint8_t>>::Decode(data);
+    ASSERT_TRUE(message.has_value());
+    EXPECT_EQ(message->data(), data.data());
+    EXPECT_EQ(message->size(), data.size());
+}
+
+TEST(ProtocolDecoderTest, LdnPacketIsDecodedInPlace) {
+    const std::vector<uint8_t> payload{0xDE, 0xAD, 0xBE, 0xEF};
+    LdnPacketHeader header;
+    header.session_id = 7;
+    header.sequence_number = 42;
+    std::vector<uint8_t> data(LDN_PACKET_HEADER_SIZE + payload.size());
+    ASSERT_TRUE(SerializePacket(header, payload, data).has_value());
+
+    const auto packet = ProtocolDecoder<LdnPacketView>::Decode(data);
+    ASSERT_TRUE(packet.has_value());
+    EXPECT_EQ(packet->header.session_id, 7u);
+    EXPECT_EQ(packet->header.sequence_number, 42u);
+    EXPECT_EQ(packet->payload.data(), data.data() + LDN_PACKET_HEADER_SIZE);
+    EXPECT_EQ(packet->payload.size(), payload.size());
+
+    data.back() ^= 0xFF;
+    EXPECT_FALSE(ProtocolDecoder<LdnPacketView>::Decode(data).has_value());
+}
@@ -0,0 +1,113 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "../reachability_cache.h"
+
+using namespace Core::Multiplayer::ModelA;
+
+namespace {
+
+class ReachabilityCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = (std::filesystem::temp_directory_path() /
+                 ("reachability_cache_test_" + std::to_string(::testing::UnitTest::GetInstance()->random_seed()) +
+                  "_" + ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".json"))
+                    .string();
+        std::filesystem::remove(path_);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(path_);
+    }
+
+    static NetworkFingerprint HomeNetwork() {
+        return {"00:11:22:33:44:55", "home-wifi", "203.0.113.7"};
+    }
+
+    static ReachabilityRecord MakeRecord(std::chrono::system_clock::time_point observed_at) {
+        ReachabilityRecord record;
+        record.nat_type = 2;
+        record.can_traverse = true;
+        record.external_address = "203.0.113.7:40123";
+        record.relay_rtts = {{"relay-a.example.org:8443", std::chrono::microseconds(15000)},
+                             {"relay-b.example.org:8443", std::nullopt}};
+        record.observed_at = observed_at;
+        record.port_allocation = 2;
+        record.port_delta = 2;
+        record.port_prediction_attempts = 5;
+        record.port_prediction_successes = 3;
+        return record;
+    }
+
+    std::string path_;
+};
+
+} // namespace
+
+TEST_F(ReachabilityCacheTest, RecordSurvivesReload) {
+    const auto now = std::chrono::system_clock::now();
+    {
+        ReachabilityCache cache(path_, std::chrono::hours(24));
+        ASSERT_TRUE(cache.Load());
+        ASSERT_TRUE(cache.Store(HomeNetwork(), MakeRecord(now)));
+    }
+
+    ReachabilityCache cache(path_, std::chrono::hours(24));
+    ASSERT_TRUE(cache.Load());
+    const auto record = cache.Lookup(HomeNetwork(), now);
+    ASSERT_TRUE(record.has_value());
+    EXPECT_EQ(record->nat_type, 2);
+    EXPECT_TRUE(record->can_traverse);
+    EXPECT_EQ(record->external_address, "203.0.113.7:40123");
+    ASSERT_EQ(record->relay_rtts.size(), 2u);
+    EXPECT_EQ(record->relay_rtts[0].server, "relay-a.example.org:8443");
+    EXPECT_EQ(record->relay_rtts[0].rtt, std::chrono::microseconds(15000));
+    EXPECT_FALSE(record->relay_rtts[1].rtt.has_value());
+    EXPECT_EQ(record->port_allocation, 2);
+    EXPECT_EQ(record->port_delta, 2);
+    EXPECT_EQ(record->port_prediction_attempts, 5u);
+    EXPECT_EQ(record->port_prediction_successes, 3u);
+}
+
+TEST_F(ReachabilityCacheTest, OtherNetworksMiss) {
+    ReachabilityCache cache(path_, std::chrono::hours(24));
+    const auto now = std::chrono::system_clock::now();
+    ASSERT_TRUE(cache.Store(HomeNetwork(), MakeRecord(now)));
+
+    auto elsewhere = HomeNetwork();
+    elsewhere.public_ip = "198.51.100.20";
+    EXPECT_FALSE(cache.Lookup(elsewhere, now).has_value());
+}
+
+TEST_F(ReachabilityCacheTest, ExpiredRecordsAreNotReturned) {
+    ReachabilityCache cache(path_, std::chrono::hours(1));
+    const auto observed = std::chrono::system_clock::now();
+    ASSERT_TRUE(cache.Store(HomeNetwork(), MakeRecord(observed)));
+
+    EXPECT_TRUE(cache.Lookup(HomeNetwork(), observed + std::chrono::minutes(59)).has_value());
+    EXPECT_FALSE(cache.Lookup(HomeNetwork(), observed + std::chrono::minutes(61)).has_value());
+
+    // A later store prunes networks that have expired by then
+    auto office = HomeNetwork();
+    office.ssid = "office";
+    ASSERT_TRUE(cache.Store(office, MakeRecord(observed + std::chrono::hours(2))));
+    EXPECT_EQ(cache.GetRecordCount(), 1u);
+}
+
+TEST_F(ReachabilityCacheTest, MissingOrCorruptFileStartsEmpty) {
+    ReachabilityCache missing(path_, std::chrono::hours(24));
+    EXPECT_TRUE(missing.Load());
+    EXPECT_EQ(missing.GetRecordCount(), 0u);
+
+    std::ofstream(path_) << "{ not json";
+    ReachabilityCache corrupt(path_, std::chrono::hours(24));
+    EXPECT_FALSE(corrupt.Load());
+    EXPECT_EQ(corrupt.GetRecordCount(), 0u);
+}
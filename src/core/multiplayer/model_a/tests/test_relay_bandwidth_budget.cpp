@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include "../relay_bandwidth_budget.h"
+
+using namespace Core::Multiplayer::ModelA;
+
+namespace {
+
+constexpr uint32_t kSessionA = 0x1000;
+constexpr uint32_t kSessionB = 0x2000;
+
+// Sends 100-byte packets until the budget refuses one
+int SendUntilRefused(RelayBandwidthBudget& budget, uint32_t session, uint8_t node) {
+    int sent = 0;
+    while (sent < 1000 && budget.TryConsumeBytes(session, node, 100)) {
+        ++sent;
+    }
+    return sent;
+}
+
+} // anonymous namespace
+
+TEST(RelayBandwidthBudgetTest, SplitsRateByWeight) {
+    RelayBandwidthBudget budget(3000, 3000);
+    budget.SetSessionWeight(kSessionA, 2);
+    budget.SetSessionWeight(kSessionB, 1);
+    EXPECT_EQ(budget.GetSessionRate(kSessionA), 2000u);
+    EXPECT_EQ(budget.GetSessionRate(kSessionB), 1000u);
+
+    budget.SetNodeWeight(kSessionA, 0, 3);
+    budget.SetNodeWeight(kSessionA, 1, 1);
+    EXPECT_EQ(budget.GetNodeRate(kSessionA, 0), 1500u);
+    EXPECT_EQ(budget.GetNodeRate(kSessionA, 1), 500u);
+
+    budget.RemoveSession(kSessionB);
+    EXPECT_EQ(budget.GetSessionRate(kSessionA), 3000u);
+    EXPECT_EQ(budget.GetSessionRate(kSessionB), 0u);
+}
+
+TEST(RelayBandwidthBudgetTest, NoisySessionCannotStarveAnother) {
+    RelayBandwidthBudget budget(1000, 1000);
+    budget.SetSessionWeight(kSessionA, 1);
+    budget.SetSessionWeight(kSessionB, 1);
+
+    // A uses its own share and then borrows everything B left idle
+    EXPECT_EQ(SendUntilRefused(budget, kSessionA, 0), 10);
+
+    // B still gets its assured share
+    EXPECT_EQ(SendUntilRefused(budget, kSessionB, 0), 5);
+    EXPECT_FALSE(budget.TryConsumeBytes(kSessionA, 0, 100));
+    EXPECT_GT(budget.GetNextAvailableTime(kSessionA, 0, 100).count(), 0);
+}
+
+TEST(RelayBandwidthBudgetTest, NodesShareSessionBudget) {
+    RelayBandwidthBudget budget(1000, 1000);
+    budget.SetNodeWeight(kSessionA, 0, 1);
+    budget.SetNodeWeight(kSessionA, 1, 1);
+
+    EXPECT_EQ(SendUntilRefused(budget, kSessionA, 0), 10);
+    EXPECT_EQ(SendUntilRefused(budget, kSessionA, 1), 5);
+}
+
+TEST(RelayBandwidthBudgetTest, PriorityBytesAreNeverRefused) {
+    RelayBandwidthBudget budget(1000, 100);
+    EXPECT_TRUE(budget.TryConsumeBytes(kSessionA, 0, 100));
+
+    // Keepalives still go out and push data further back
+    budget.ConsumePriorityBytes(12);
+    budget.ConsumePriorityBytes(12);
+    EXPECT_FALSE(budget.TryConsumeBytes(kSessionA, 0, 100));
+}
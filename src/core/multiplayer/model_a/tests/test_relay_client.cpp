@@ -3,11 +3,20 @@
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
+#include "../model_a_backend.h"
+#include "../relay_bandwidth_budget.h"
 #include "../relay_client.h"
+#include "../relay_server_selector.h"
 #include "mock_relay_connection.h"
 #include "../../common/error_codes.h"
 
@@ -18,6 +27,41 @@ using namespace Core::Multiplayer::ModelA::Test;
 
 namespace {
 
+// Datagram transport that records frames and the relay it points at
+class FakeRelayTransport final : public IRelayTransport {
+public:
+    bool Open(const std::string& host, uint16_t port) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        endpoint = host + ":" + std::to_string(port);
+        open = true;
+        return true;
+    }
+    void Close() override { open = false; }
+    bool IsOpen() const override { return open; }
+    bool SendFrame(const RelayFrame& frame) override {
+        std::vector<uint8_t> bytes(frame.header.begin(), frame.header.end());
+        bytes.insert(bytes.end(), frame.payload.begin(), frame.payload.end());
+        bytes.insert(bytes.end(), frame.Trailer().begin(), frame.Trailer().end());
+        std::lock_guard<std::mutex> lock(mutex);
+        sent.push_back(std::move(bytes));
+        return true;
+    }
+    void SetOnDatagramReceived(DatagramCallback) override {}
+    bool Migrate() override { return open; }
+    bool Redirect(const std::string& host, uint16_t port) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        endpoint = host + ":" + std::to_string(port);
+        ++redirects;
+        return true;
+    }
+
+    std::mutex mutex;
+    std::atomic<bool> open{false};
+    std::string endpoint;
+    int redirects = 0;
+    std::vector<std::vector<uint8_t>> sent;
+};
+
 class RelayClientTest : public Test {
 protected:
     void SetUp() override {
@@ -138,4 +182,1091 @@ TEST_F(RelayClientTest, SessionJoiningFails) {
     EXPECT_EQ(relay_client->GetCurrentSession(), 0u);
 }
 
+// Scatter-gather send frames the header and forwards the caller's payload
+TEST_F(RelayClientTest, SendDataUsesScatterGatherFrameWriter) {
+    EXPECT_CALL(*mock_server_selector, SelectBestServer())
+        .WillOnce(Return(std::string(TEST_SERVER_HOST)));
+    EXPECT_CALL(*mock_connection,
+                Connect(TEST_SERVER_HOST, TEST_SERVER_PORT))
+        .Times(1);
+    EXPECT_CALL(*mock_connection, SetAuthToken(TEST_JWT_TOKEN)).Times(1);
+    EXPECT_CALL(*mock_connection, Authenticate()).WillOnce(Return(true));
+    relay_client->ConnectAsync(TEST_JWT_TOKEN, [](bool) {});
+
+    std::vector<uint8_t> payload = {0x01, 0x02, 0x03};
+    std::vector<const uint8_t*> payload_ptrs;
+    std::vector<uint32_t> sequences;
+    relay_client->SetFrameWriter([&](const RelayFrame& frame) {
+        payload_ptrs.push_back(frame.payload.data());
+        sequences.push_back(static_cast<uint32_t>(frame.header[8]) |
+                            (static_cast<uint32_t>(frame.header[9]) << 8));
+        EXPECT_EQ(frame.header[4], payload.size());
+        EXPECT_EQ(frame.header[6], RelayProtocol::FLAG_DATA);
+        return true;
+    });
+
+    EXPECT_TRUE(relay_client->SendData(payload));
+    EXPECT_TRUE(relay_client->SendData(std::span<const uint8_t>(payload)));
+
+    ASSERT_EQ(payload_ptrs.size(), 2u);
+    EXPECT_EQ(payload_ptrs[0], payload.data());
+    EXPECT_EQ(payload_ptrs[1], payload.data());
+    EXPECT_EQ(sequences[0], 0u);
+    EXPECT_EQ(sequences[1], 1u);
+}
+
+// Without a transport attached the send path reports failure
+TEST_F(RelayClientTest, SendDataWithoutFrameWriterFails) {
+    std::vector<uint8_t> payload = {0x01};
+    EXPECT_FALSE(relay_client->SendData(payload));
+}
+
+// Refill and consume happen in one step and never overdraw the burst
+TEST(BandwidthLimiterTest, TryConsumeStopsAtBurst) {
+    BandwidthLimiter limiter(1000, 300);
+
+    EXPECT_TRUE(limiter.TryConsumeBytes(100));
+    EXPECT_TRUE(limiter.TryConsumeBytes(200));
+    EXPECT_FALSE(limiter.TryConsumeBytes(100));
+    EXPECT_FALSE(limiter.CanSendBytes(100));
+
+    // 100 bytes at 1000 B/s take 100ms to refill
+    const auto wait = limiter.GetNextAvailableTime(100);
+    EXPECT_GT(wait.count(), 50);
+    EXPECT_LE(wait.count(), 100);
+
+    limiter.Reset();
+    EXPECT_EQ(limiter.GetAvailableBytes(), 300u);
+}
+
+// A packet larger than the burst is delayed rather than refused forever
+TEST(BandwidthLimiterTest, OversizedPacketAdmittedWhenFull) {
+    BandwidthLimiter limiter(1000, 100);
+
+    EXPECT_TRUE(limiter.TryConsumeBytes(500));
+    EXPECT_EQ(limiter.GetAvailableBytes(), 0u);
+    EXPECT_FALSE(limiter.TryConsumeBytes(500));
+    EXPECT_GT(limiter.GetNextAvailableTime(500).count(), 400);
+}
+
+// A congestion controller retunes the rate without replacing the limiter
+TEST(BandwidthLimiterTest, SetRateKeepsBurstBytes) {
+    BandwidthLimiter limiter(1000, 100);
+    EXPECT_TRUE(limiter.TryConsumeBytes(100));
+    EXPECT_GT(limiter.GetNextAvailableTime(100).count(), 50);
+
+    limiter.SetRate(100'000);
+    limiter.Reset();
+    EXPECT_EQ(limiter.GetBandwidthLimit(), 100'000u);
+    EXPECT_TRUE(limiter.TryConsumeBytes(100));
+    EXPECT_FALSE(limiter.TryConsumeBytes(100));
+    // 100 bytes at 100 kB/s take 1ms to refill
+    EXPECT_LE(limiter.GetNextAvailableTime(100).count(), 1);
+}
+
+// Packets that find the bucket empty are paced out in order, not dropped
+TEST_F(RelayClientTest, SendDataPacesPacketsWhenBucketEmpty) {
+    EXPECT_CALL(*mock_server_selector, SelectBestServer())
+        .WillOnce(Return(std::string(TEST_SERVER_HOST)));
+    EXPECT_CALL(*mock_connection,
+                Connect(TEST_SERVER_HOST, TEST_SERVER_PORT))
+        .Times(1);
+    EXPECT_CALL(*mock_connection, SetAuthToken(TEST_JWT_TOKEN)).Times(1);
+    EXPECT_CALL(*mock_connection, Authenticate()).WillOnce(Return(true));
+    relay_client->ConnectAsync(TEST_JWT_TOKEN, [](bool) {});
+
+    std::mutex sent_mutex;
+    std::vector<uint8_t> sent;
+    relay_client->SetFrameWriter([&](const RelayFrame& frame) {
+        std::lock_guard<std::mutex> lock(sent_mutex);
+        sent.push_back(frame.payload[0]);
+        return true;
+    });
+    relay_client->SetBandwidthLimit(10000, 100);
+
+    for (uint8_t i = 0; i < 3; ++i) {
+        const std::vector<uint8_t> payload(100, i);
+        EXPECT_TRUE(relay_client->SendData(payload));
+    }
+    EXPECT_EQ(relay_client->GetPacedPacketCount(), 2u);
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (relay_client->GetPacedPacketCount() != 0 &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    std::lock_guard<std::mutex> lock(sent_mutex);
+    EXPECT_EQ(sent, (std::vector<uint8_t>{0, 1, 2}));
+    EXPECT_EQ(relay_client->GetDroppedPacketCount(), 0u);
+}
+
+// Keepalives bypass data waiting for tokens
+TEST_F(RelayClientTest, ControlMessagesSkipPacedData) {
+    EXPECT_CALL(*mock_server_selector, SelectBestServer())
+        .WillOnce(Return(std::string(TEST_SERVER_HOST)));
+    EXPECT_CALL(*mock_connection,
+                Connect(TEST_SERVER_HOST, TEST_SERVER_PORT))
+        .Times(1);
+    EXPECT_CALL(*mock_connection, SetAuthToken(TEST_JWT_TOKEN)).Times(1);
+    EXPECT_CALL(*mock_connection, Authenticate()).WillOnce(Return(true));
+    relay_client->ConnectAsync(TEST_JWT_TOKEN, [](bool) {});
+
+    std::mutex sent_mutex;
+    std::vector<uint8_t> sent_flags;
+    relay_client->SetFrameWriter([&](const RelayFrame& frame) {
+        std::lock_guard<std::mutex> lock(sent_mutex);
+        sent_flags.push_back(frame.header[6]);
+        return true;
+    });
+    relay_client->SetBandwidthBudget(std::make_shared<RelayBandwidthBudget>(1000, 100), 0);
+
+    const std::vector<uint8_t> payload(100, 0xAB);
+    EXPECT_TRUE(relay_client->SendData(payload));
+    EXPECT_TRUE(relay_client->SendData(payload));
+    EXPECT_EQ(relay_client->GetPacedPacketCount(), 1u);
+
+    EXPECT_TRUE(relay_client->SendControlMessage(RelayProtocol::FLAG_KEEPALIVE));
+    std::lock_guard<std::mutex> lock(sent_mutex);
+    EXPECT_EQ(sent_flags,
+              (std::vector<uint8_t>{RelayProtocol::FLAG_DATA, RelayProtocol::FLAG_KEEPALIVE}));
+}
+
+// Realtime data neither waits behind nor is paced out after bulk
+TEST_F(RelayClientTest, RealtimeOvertakesPacedBulk) {
+    EXPECT_CALL(*mock_server_selector, SelectBestServer())
+        .WillOnce(Return(std::string(TEST_SERVER_HOST)));
+    EXPECT_CALL(*mock_connection,
+                Connect(TEST_SERVER_HOST, TEST_SERVER_PORT))
+        .Times(1);
+    EXPECT_CALL(*mock_connection, SetAuthToken(TEST_JWT_TOKEN)).Times(1);
+    EXPECT_CALL(*mock_connection, Authenticate()).WillOnce(Return(true));
+    relay_client->ConnectAsync(TEST_JWT_TOKEN, [](bool) {});
+
+    std::mutex sent_mutex;
+    std::vector<uint8_t> sent;
+    relay_client->SetFrameWriter([&](const RelayFrame& frame) {
+        std::lock_guard<std::mutex> lock(sent_mutex);
+        sent.push_back(frame.payload[0]);
+        return true;
+    });
+    relay_client->SetBandwidthLimit(10000, 100);
+
+    EXPECT_TRUE(relay_client->SendData(std::vector<uint8_t>(100, 1), SendPriority::Bulk));
+    EXPECT_TRUE(relay_client->SendData(std::vector<uint8_t>(100, 2), SendPriority::Bulk));
+    EXPECT_TRUE(relay_client->SendData(std::vector<uint8_t>(100, 3), SendPriority::Realtime));
+    EXPECT_EQ(relay_client->GetPacedPacketCount(), 2u);
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (relay_client->GetPacedPacketCount() != 0 &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    std::lock_guard<std::mutex> lock(sent_mutex);
+    EXPECT_EQ(sent, (std::vector<uint8_t>{1, 3, 2}));
+}
+
+// A paced state packet is overwritten by a newer one for the same slot
+TEST_F(RelayClientTest, LatestValueReplacesPacedState) {
+    EXPECT_CALL(*mock_server_selector, SelectBestServer())
+        .WillOnce(Return(std::string(TEST_SERVER_HOST)));
+    EXPECT_CALL(*mock_connection,
+                Connect(TEST_SERVER_HOST, TEST_SERVER_PORT))
+        .Times(1);
+    EXPECT_CALL(*mock_connection, SetAuthToken(TEST_JWT_TOKEN)).Times(1);
+    EXPECT_CALL(*mock_connection, Authenticate()).WillOnce(Return(true));
+    relay_client->ConnectAsync(TEST_JWT_TOKEN, [](bool) {});
+
+    std::mutex sent_mutex;
+    std::vector<uint8_t> sent;
+    relay_client->SetFrameWriter([&](const RelayFrame& frame) {
+        std::lock_guard<std::mutex> lock(sent_mutex);
+        sent.push_back(frame.payload[0]);
+        return true;
+    });
+    relay_client->SetBandwidthLimit(10000, 100);
+
+    const uint32_t session = 0;
+    EXPECT_TRUE(relay_client->SendLatest(session, std::vector<uint8_t>(100, 0), 7));
+    EXPECT_TRUE(relay_client->SendLatest(session, std::vector<uint8_t>(100, 1), 7));
+    EXPECT_TRUE(relay_client->SendLatest(session, std::vector<uint8_t>(100, 2), 9));
+    EXPECT_TRUE(relay_client->SendLatest(session, std::vector<uint8_t>(100, 3), 7));
+    EXPECT_EQ(relay_client->GetPacedPacketCount(), 2u);
+    EXPECT_EQ(relay_client->GetReplacedPacketCount(), 1u);
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (relay_client->GetPacedPacketCount() != 0 &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    std::lock_guard<std::mutex> lock(sent_mutex);
+    EXPECT_EQ(sent, (std::vector<uint8_t>{0, 3, 2}));
+    EXPECT_EQ(relay_client->GetDroppedPacketCount(), 0u);
+}
+
+// Relayed data is handed on in sequence order, not arrival order
+TEST_F(RelayClientTest, IncomingFramesAreReordered) {
+    JitterBufferConfig config;
+    config.target_delay = std::chrono::milliseconds(5);
+    config.adaptive = false;
+    relay_client->SetJitterBufferConfig(config);
+
+    std::mutex received_mutex;
+    std::vector<uint8_t> received;
+    relay_client->SetOnDataReceived([&](const std::vector<uint8_t>& data) {
+        std::lock_guard<std::mutex> lock(received_mutex);
+        received.push_back(data[0]);
+    });
+
+    RelayProtocol protocol;
+    for (const uint32_t sequence : {0u, 2u, 1u}) {
+        const std::vector<uint8_t> payload{static_cast<uint8_t>(sequence)};
+        const auto frame = protocol.CreateDataMessage(TEST_SESSION_TOKEN, payload, sequence);
+        relay_client->HandleIncomingFrame(frame);
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (std::chrono::steady_clock::now() < deadline) {
+        {
+            std::lock_guard<std::mutex> lock(received_mutex);
+            if (received.size() == 3) {
+                break;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(received_mutex);
+        EXPECT_EQ(received, (std::vector<uint8_t>{0, 1, 2}));
+    }
+    ASSERT_TRUE(relay_client->GetJitterStatistics(TEST_SESSION_TOKEN).has_value());
+    EXPECT_EQ(relay_client->GetJitterStatistics(TEST_SESSION_TOKEN)->reordered, 1u);
+}
+
+// Members of a session number their frames independently; each is ordered on its own
+TEST_F(RelayClientTest, FramesFromSeveralSendersAreOrderedPerSender) {
+    JitterBufferConfig config;
+    config.target_delay = std::chrono::milliseconds(5);
+    config.adaptive = false;
+    relay_client->SetJitterBufferConfig(config);
+
+    std::mutex received_mutex;
+    std::vector<std::vector<uint8_t>> received;
+    relay_client->SetOnDataReceived([&](const std::vector<uint8_t>& data) {
+        std::lock_guard<std::mutex> lock(received_mutex);
+        received.push_back(data);
+    });
+
+    // Two peers' frames as the relay interleaves them, each stream out of order
+    RelayProtocol protocol;
+    const std::vector<std::pair<uint8_t, uint32_t>> arrivals{{1, 0}, {2, 0}, {2, 2}, {1, 2},
+                                                            {1, 1}, {2, 1}};
+    for (const auto& [sender, sequence] : arrivals) {
+        const std::vector<uint8_t> payload{sender, static_cast<uint8_t>(sequence)};
+        const auto frame = protocol.FrameDataMessage(TEST_SESSION_TOKEN, payload, sequence, 0,
+                                                     sender);
+        std::vector<uint8_t> datagram(frame.header.begin(), frame.header.end());
+        datagram.insert(datagram.end(), frame.payload.begin(), frame.payload.end());
+        datagram.insert(datagram.end(), frame.Trailer().begin(), frame.Trailer().end());
+        relay_client->HandleIncomingFrame(datagram);
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (std::chrono::steady_clock::now() < deadline) {
+        {
+            std::lock_guard<std::mutex> lock(received_mutex);
+            if (received.size() == arrivals.size()) {
+                break;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(received_mutex);
+        ASSERT_EQ(received.size(), arrivals.size());
+        for (const uint8_t sender : {1, 2}) {
+            std::vector<uint8_t> sequences;
+            for (const auto& packet : received) {
+                if (packet[0] == sender) {
+                    sequences.push_back(packet[1]);
+                }
+            }
+            EXPECT_EQ(sequences, (std::vector<uint8_t>{0, 1, 2})) << "sender " << int{sender};
+        }
+    }
+    for (const uint8_t sender : {1, 2}) {
+        const auto statistics = relay_client->GetJitterStatistics(TEST_SESSION_TOKEN, sender);
+        ASSERT_TRUE(statistics.has_value());
+        EXPECT_EQ(statistics->delivered, 3u);
+        EXPECT_EQ(statistics->duplicates, 0u);
+    }
+}
+
+// Several sessions share one connection, each with its own sequence space
+TEST_F(RelayClientTest, MultiplexesSessionsOverOneConnection) {
+    EXPECT_CALL(*mock_server_selector, SelectBestServer())
+        .WillOnce(Return(std::string(TEST_SERVER_HOST)));
+    EXPECT_CALL(*mock_connection,
+                Connect(TEST_SERVER_HOST, TEST_SERVER_PORT))
+        .Times(1);
+    EXPECT_CALL(*mock_connection, SetAuthToken(TEST_JWT_TOKEN)).Times(1);
+    EXPECT_CALL(*mock_connection, Authenticate()).WillOnce(Return(true));
+    relay_client->ConnectAsync(TEST_JWT_TOKEN, [](bool) {});
+
+    JitterBufferConfig config;
+    config.target_delay = std::chrono::microseconds(0);
+    config.adaptive = false;
+    relay_client->SetJitterBufferConfig(config);
+
+    constexpr uint32_t kSpectatorSession = 0x0A0A0A0A;
+    std::vector<uint8_t> session_a;
+    std::vector<uint8_t> session_b;
+    EXPECT_TRUE(relay_client->AddSession(TEST_SESSION_TOKEN, [&](const std::vector<uint8_t>& data) {
+        session_a.push_back(data[0]);
+    }));
+    EXPECT_TRUE(relay_client->AddSession(kSpectatorSession, [&](const std::vector<uint8_t>& data) {
+        session_b.push_back(data[0]);
+    }));
+    EXPECT_FALSE(relay_client->AddSession(kSpectatorSession, nullptr));
+    EXPECT_EQ(relay_client->GetSessions().size(), 2u);
+
+    RelayProtocol protocol;
+    std::vector<std::pair<uint32_t, uint32_t>> sent;
+    relay_client->SetFrameWriter([&](const RelayFrame& frame) {
+        RelayHeaderView header;
+        EXPECT_TRUE(protocol.ParseHeader(frame.header.data(), frame.header.size(), header));
+        sent.emplace_back(header.session_token, header.sequence_num);
+        return true;
+    });
+
+    const std::vector<uint8_t> payload{0x01};
+    EXPECT_TRUE(relay_client->SendData(TEST_SESSION_TOKEN, payload));
+    EXPECT_TRUE(relay_client->SendData(kSpectatorSession, payload));
+    EXPECT_TRUE(relay_client->SendData(TEST_SESSION_TOKEN, payload));
+    EXPECT_EQ(sent, (std::vector<std::pair<uint32_t, uint32_t>>{
+                        {TEST_SESSION_TOKEN, 0}, {kSpectatorSession, 0}, {TEST_SESSION_TOKEN, 1}}));
+
+    relay_client->HandleIncomingFrame(
+        protocol.CreateDataMessage(kSpectatorSession, std::vector<uint8_t>{0xBB}, 0));
+    relay_client->HandleIncomingFrame(
+        protocol.CreateDataMessage(TEST_SESSION_TOKEN, std::vector<uint8_t>{0xAA}, 0));
+    EXPECT_EQ(session_a, (std::vector<uint8_t>{0xAA}));
+    EXPECT_EQ(session_b, (std::vector<uint8_t>{0xBB}));
+
+    relay_client->RemoveSession(kSpectatorSession);
+    EXPECT_EQ(relay_client->GetSessions(), (std::vector<uint32_t>{TEST_SESSION_TOKEN}));
+}
+
+// Echoed keepalive timestamps drive GetLatency, and relay probes are answered
+TEST_F(RelayClientTest, KeepaliveEchoesMeasureLatency) {
+    EXPECT_CALL(*mock_server_selector, SelectBestServer())
+        .WillOnce(Return(std::string(TEST_SERVER_HOST)));
+    EXPECT_CALL(*mock_connection,
+                Connect(TEST_SERVER_HOST, TEST_SERVER_PORT))
+        .Times(1);
+    EXPECT_CALL(*mock_connection, SetAuthToken(TEST_JWT_TOKEN)).Times(1);
+    EXPECT_CALL(*mock_connection, Authenticate()).WillOnce(Return(true));
+    relay_client->ConnectAsync(TEST_JWT_TOKEN, [](bool) {});
+
+    std::vector<std::vector<uint8_t>> sent;
+    relay_client->SetFrameWriter([&](const RelayFrame& frame) {
+        std::vector<uint8_t> bytes(frame.header.begin(), frame.header.end());
+        bytes.insert(bytes.end(), frame.payload.begin(), frame.payload.end());
+        sent.push_back(std::move(bytes));
+        return true;
+    });
+
+    EXPECT_EQ(relay_client->GetLatency(), std::chrono::milliseconds(0));
+    ASSERT_TRUE(relay_client->SendKeepalive());
+    ASSERT_EQ(sent.size(), 1u);
+
+    RelayProtocol protocol;
+    RelayHeaderView header;
+    ASSERT_TRUE(protocol.ValidateMessage(sent[0], &header));
+    EXPECT_EQ(header.flags, RelayProtocol::FLAG_KEEPALIVE);
+    uint64_t timestamp = 0;
+    uint64_t echo = 0;
+    ASSERT_TRUE(RelayProtocol::ParseKeepalivePayload(header.payload, timestamp, echo));
+    EXPECT_NE(timestamp, 0u);
+    EXPECT_EQ(echo, 0u);
+
+    // The relay answers 20ms later
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    std::vector<uint8_t> reply = protocol.SerializeHeader(
+        TEST_SESSION_TOKEN, RelayProtocol::KEEPALIVE_PAYLOAD_SIZE, RelayProtocol::FLAG_KEEPALIVE, 0);
+    reply.resize(reply.size() + RelayProtocol::KEEPALIVE_PAYLOAD_SIZE);
+    RelayProtocol::WriteKeepalivePayload(std::span<uint8_t>(reply).subspan(12), 0, timestamp);
+    relay_client->HandleIncomingFrame(reply);
+
+    EXPECT_EQ(relay_client->GetRttEstimator().GetSampleCount(), 1u);
+    EXPECT_GE(relay_client->GetLatency(), std::chrono::milliseconds(20));
+    EXPECT_EQ(relay_client->GetConnectionMetrics("peer").latency, relay_client->GetLatency());
+    // A reply is never answered
+    EXPECT_EQ(sent.size(), 1u);
+
+    // A probe from the relay is echoed back with its timestamp
+    std::vector<uint8_t> probe = protocol.SerializeHeader(
+        TEST_SESSION_TOKEN, RelayProtocol::KEEPALIVE_PAYLOAD_SIZE, RelayProtocol::FLAG_KEEPALIVE, 1);
+    probe.resize(probe.size() + RelayProtocol::KEEPALIVE_PAYLOAD_SIZE);
+    RelayProtocol::WriteKeepalivePayload(std::span<uint8_t>(probe).subspan(12), 777, 0);
+    relay_client->HandleIncomingFrame(probe);
+
+    ASSERT_EQ(sent.size(), 2u);
+    ASSERT_TRUE(protocol.ValidateMessage(sent[1], &header));
+    ASSERT_TRUE(RelayProtocol::ParseKeepalivePayload(header.payload, timestamp, echo));
+    EXPECT_EQ(timestamp, 0u);
+    EXPECT_EQ(echo, 777u);
+
+    // Replies without the relay's clock leave it unsynchronized
+    EXPECT_FALSE(relay_client->GetRelayClockSync().IsSynchronized());
+    ASSERT_TRUE(relay_client->SendKeepalive());
+    ASSERT_TRUE(protocol.ValidateMessage(sent[2], &header));
+    ASSERT_TRUE(RelayProtocol::ParseKeepalivePayload(header.payload, timestamp, echo));
+
+    // A relay whose clock reads five seconds ahead stamps its answer
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    std::vector<uint8_t> stamped = protocol.SerializeHeader(
+        TEST_SESSION_TOKEN, RelayProtocol::KEEPALIVE_CLOCK_PAYLOAD_SIZE,
+        RelayProtocol::FLAG_KEEPALIVE, 2);
+    stamped.resize(stamped.size() + RelayProtocol::KEEPALIVE_CLOCK_PAYLOAD_SIZE);
+    RelayProtocol::WriteKeepalivePayload(std::span<uint8_t>(stamped).subspan(12), 0, timestamp,
+                                         timestamp + 5'000'000);
+    relay_client->HandleIncomingFrame(stamped);
+
+    const ClockSyncSnapshot clock = relay_client->GetRelayClockSync();
+    ASSERT_TRUE(clock.IsSynchronized());
+    EXPECT_GT(clock.offset, std::chrono::seconds(4));
+    EXPECT_LT(clock.offset, std::chrono::seconds(5));
+    const ConnectionMetrics metrics = relay_client->GetConnectionMetrics("peer");
+    EXPECT_EQ(metrics.clock_offset, clock.offset);
+    EXPECT_EQ(metrics.one_way_latency, clock.outbound_delay);
+    EXPECT_GT(metrics.clock_confidence, 0.0f);
+}
+
+// Small packets leave as one bundled frame and arrive as separate packets
+TEST_F(RelayClientTest, CoalescesSmallPacketsIntoBundles) {
+    EXPECT_CALL(*mock_server_selector, SelectBestServer())
+        .WillOnce(Return(std::string(TEST_SERVER_HOST)));
+    EXPECT_CALL(*mock_connection,
+                Connect(TEST_SERVER_HOST, TEST_SERVER_PORT))
+        .Times(1);
+    EXPECT_CALL(*mock_connection, SetAuthToken(TEST_JWT_TOKEN)).Times(1);
+    EXPECT_CALL(*mock_connection, Authenticate()).WillOnce(Return(true));
+    relay_client->ConnectAsync(TEST_JWT_TOKEN, [](bool) {});
+
+    std::vector<std::vector<uint8_t>> sent;
+    relay_client->SetFrameWriter([&](const RelayFrame& frame) {
+        std::vector<uint8_t> bytes(frame.header.begin(), frame.header.end());
+        bytes.insert(bytes.end(), frame.payload.begin(), frame.payload.end());
+        sent.push_back(std::move(bytes));
+        return true;
+    });
+    relay_client->SetCoalescing(12);
+
+    for (uint8_t i = 0; i < 4; ++i) {
+        EXPECT_TRUE(relay_client->SendData(std::vector<uint8_t>{i, i}));
+    }
+    // Three 4-byte entries fill the 12-byte bundle; the fourth starts the next
+    ASSERT_EQ(sent.size(), 1u);
+    relay_client->FlushCoalescedPackets();
+    ASSERT_EQ(sent.size(), 2u);
+
+    RelayProtocol protocol;
+    RelayHeaderView header;
+    ASSERT_TRUE(protocol.ValidateMessage(sent[0], &header));
+    EXPECT_EQ(header.extended_flags, RelayProtocol::EXT_FLAG_BUNDLE);
+    EXPECT_EQ(header.sequence_num, 0u);
+    EXPECT_EQ(PacketBundler::CountPackets(header.payload), 3u);
+    // A lone packet goes out plain, after the sequences the bundle used
+    ASSERT_TRUE(protocol.ValidateMessage(sent[1], &header));
+    EXPECT_EQ(header.extended_flags, 0u);
+    EXPECT_EQ(header.sequence_num, 3u);
+
+    JitterBufferConfig config;
+    config.target_delay = std::chrono::microseconds(0);
+    config.adaptive = false;
+    relay_client->SetJitterBufferConfig(config);
+    std::vector<uint8_t> received;
+    relay_client->SetOnDataReceived(
+        [&](const std::vector<uint8_t>& data) { received.push_back(data[0]); });
+
+    // Looped back, the bundle unpacks into consecutive sequence numbers
+    relay_client->HandleIncomingFrame(sent[0]);
+    relay_client->HandleIncomingFrame(sent[1]);
+    EXPECT_EQ(received, (std::vector<uint8_t>{0, 1, 2, 3}));
+}
+
+TEST_F(RelayClientTest, CompressionIsNegotiatedWithTheSession) {
+    EXPECT_CALL(*mock_server_selector, SelectBestServer())
+        .WillOnce(Return(std::string(TEST_SERVER_HOST)));
+    EXPECT_CALL(*mock_connection,
+                Connect(TEST_SERVER_HOST, TEST_SERVER_PORT))
+        .Times(1);
+    EXPECT_CALL(*mock_connection, SetAuthToken(TEST_JWT_TOKEN)).Times(1);
+    EXPECT_CALL(*mock_connection, Authenticate()).WillOnce(Return(true));
+    relay_client->ConnectAsync(TEST_JWT_TOKEN, [](bool) {});
+
+    std::vector<std::vector<uint8_t>> sent;
+    relay_client->SetFrameWriter([&](const RelayFrame& frame) {
+        std::vector<uint8_t> bytes(frame.header.begin(), frame.header.end());
+        bytes.insert(bytes.end(), frame.payload.begin(), frame.payload.end());
+        sent.push_back(std::move(bytes));
+        return true;
+    });
+    relay_client->SetCompression(64);
+
+    bool created = false;
+    uint32_t session_id = 0;
+    relay_client->CreateSessionAsync(TEST_SESSION_TOKEN, [&](bool success, uint32_t id) {
+        created = success;
+        session_id = id;
+    });
+    ASSERT_EQ(sent.size(), 1u);
+    RelayProtocol protocol;
+    RelayHeaderView header;
+    ASSERT_TRUE(protocol.ValidateMessage(sent[0], &header));
+    EXPECT_EQ(header.flags, RelayProtocol::FLAG_SESSION_CREATE);
+    EXPECT_EQ(header.extended_flags, RelayProtocol::EXT_FLAG_COMPRESSED);
+    EXPECT_FALSE(created);
+
+    // The relay accepts the session and the compression offer
+    std::array<uint8_t, 12> reply{};
+    protocol.WriteHeader(reply, TEST_SESSION_TOKEN, 0, RelayProtocol::FLAG_SESSION_CREATE, 0,
+                         RelayProtocol::EXT_FLAG_COMPRESSED);
+    relay_client->HandleIncomingFrame(reply);
+    EXPECT_TRUE(created);
+    EXPECT_EQ(session_id, TEST_SESSION_TOKEN);
+    EXPECT_EQ(relay_client->GetCurrentSession(), TEST_SESSION_TOKEN);
+    EXPECT_TRUE(relay_client->IsCompressionNegotiated(TEST_SESSION_TOKEN));
+
+    std::vector<uint8_t> large(1024);
+    for (size_t i = 0; i < large.size(); ++i) {
+        large[i] = static_cast<uint8_t>(i % 8);
+    }
+    const std::vector<uint8_t> small(32, 0x55);
+    ASSERT_TRUE(relay_client->SendData(large));
+    ASSERT_TRUE(relay_client->SendData(small));
+    ASSERT_EQ(sent.size(), 3u);
+
+    ASSERT_TRUE(protocol.ValidateMessage(sent[1], &header));
+    EXPECT_EQ(header.extended_flags, RelayProtocol::EXT_FLAG_COMPRESSED);
+    EXPECT_LT(header.payload.size(), large.size());
+    // Below the threshold payloads go out as they are
+    ASSERT_TRUE(protocol.ValidateMessage(sent[2], &header));
+    EXPECT_EQ(header.extended_flags, 0u);
+    EXPECT_EQ(header.payload.size(), small.size());
+    EXPECT_GT(relay_client->GetConnectionMetrics("relay").compression_ratio, 1.0);
+
+    JitterBufferConfig config;
+    config.target_delay = std::chrono::microseconds(0);
+    config.adaptive = false;
+    relay_client->SetJitterBufferConfig(config);
+    std::vector<std::vector<uint8_t>> received;
+    relay_client->SetOnDataReceived(
+        [&](const std::vector<uint8_t>& data) { received.push_back(data); });
+    relay_client->HandleIncomingFrame(sent[1]);
+    relay_client->HandleIncomingFrame(sent[2]);
+    ASSERT_EQ(received.size(), 2u);
+    EXPECT_EQ(received[0], large);
+    EXPECT_EQ(received[1], small);
+}
+
+TEST_F(RelayClientTest, RefusedJoinLeavesCompressionOff) {
+    EXPECT_CALL(*mock_server_selector, SelectBestServer())
+        .WillOnce(Return(std::string(TEST_SERVER_HOST)));
+    EXPECT_CALL(*mock_connection,
+                Connect(TEST_SERVER_HOST, TEST_SERVER_PORT))
+        .Times(1);
+    EXPECT_CALL(*mock_connection, SetAuthToken(TEST_JWT_TOKEN)).Times(1);
+    EXPECT_CALL(*mock_connection, Authenticate()).WillOnce(Return(true));
+    relay_client->ConnectAsync(TEST_JWT_TOKEN, [](bool) {});
+    relay_client->SetFrameWriter([](const RelayFrame&) { return true; });
+    relay_client->SetCompression(RelayClient::DEFAULT_COMPRESSION_THRESHOLD);
+
+    bool joined = true;
+    relay_client->JoinSessionAsync(TEST_SESSION_TOKEN,
+                                   [&](bool success, uint32_t) { joined = success; });
+
+    // A refusal carries FLAG_CONTROL alongside the request's flag
+    RelayProtocol protocol;
+    std::array<uint8_t, 12> reply{};
+    protocol.WriteHeader(reply, TEST_SESSION_TOKEN, 0,
+                         RelayProtocol::FLAG_CONTROL | RelayProtocol::FLAG_SESSION_JOIN, 0,
+                         RelayProtocol::EXT_FLAG_COMPRESSED);
+    relay_client->HandleIncomingFrame(reply);
+    EXPECT_FALSE(joined);
+    EXPECT_EQ(relay_client->GetCurrentSession(), 0u);
+    EXPECT_FALSE(relay_client->IsCompressionNegotiated(TEST_SESSION_TOKEN));
+
+    // Disconnecting fails a request the relay never answered
+    joined = true;
+    relay_client->JoinSessionAsync(TEST_SESSION_TOKEN,
+                                   [&](bool success, uint32_t) { joined = success; });
+    relay_client->Disconnect();
+    EXPECT_FALSE(joined);
+}
+
+// A broadcast leaves once with a destination mask and arrives without it
+TEST_F(RelayClientTest, MulticastCarriesTheDestinationMask) {
+    EXPECT_CALL(*mock_server_selector, SelectBestServer())
+        .WillOnce(Return(std::string(TEST_SERVER_HOST)));
+    EXPECT_CALL(*mock_connection,
+                Connect(TEST_SERVER_HOST, TEST_SERVER_PORT))
+        .Times(1);
+    EXPECT_CALL(*mock_connection, SetAuthToken(TEST_JWT_TOKEN)).Times(1);
+    EXPECT_CALL(*mock_connection, Authenticate()).WillOnce(Return(true));
+    relay_client->ConnectAsync(TEST_JWT_TOKEN, [](bool) {});
+
+    std::vector<std::vector<uint8_t>> sent;
+    relay_client->SetFrameWriter([&](const RelayFrame& frame) {
+        std::vector<uint8_t> bytes(frame.header.begin(), frame.header.end());
+        bytes.insert(bytes.end(), frame.payload.begin(), frame.payload.end());
+        bytes.insert(bytes.end(), frame.Trailer().begin(), frame.Trailer().end());
+        sent.push_back(std::move(bytes));
+        return true;
+    });
+    relay_client->SetCompression(1);
+    relay_client->SetNodeId(3);
+    relay_client->CreateSessionAsync(TEST_SESSION_TOKEN, [](bool, uint32_t) {});
+
+    RelayProtocol protocol;
+    RelayHeaderView header;
+    ASSERT_EQ(sent.size(), 1u);
+    ASSERT_TRUE(protocol.ValidateMessage(sent[0], &header));
+    EXPECT_EQ(std::vector<uint8_t>(header.payload.begin(), header.payload.end()),
+              std::vector<uint8_t>{3});
+
+    std::array<uint8_t, 12> reply{};
+    protocol.WriteHeader(reply, TEST_SESSION_TOKEN, 0, RelayProtocol::FLAG_SESSION_CREATE, 0,
+                         RelayProtocol::EXT_FLAG_COMPRESSED);
+    relay_client->HandleIncomingFrame(reply);
+
+    const std::vector<uint8_t> packet(300, 0x11);
+    ASSERT_TRUE(relay_client->SendMulticast(TEST_SESSION_TOKEN, 0b0110, packet));
+    ASSERT_EQ(sent.size(), 2u);
+    ASSERT_TRUE(protocol.ValidateMessage(sent[1], &header));
+    // Never compressed, since the relay reads the mask; the sender's node id trails
+    EXPECT_EQ(header.extended_flags,
+              RelayProtocol::EXT_FLAG_MULTICAST | RelayProtocol::EXT_FLAG_SENDER);
+    ASSERT_EQ(header.payload.size(), RelayProtocol::MULTICAST_HEADER_SIZE + packet.size() +
+                                         RelayProtocol::SENDER_TRAILER_SIZE);
+    EXPECT_EQ(header.payload[0], 0b0110);
+    EXPECT_EQ(header.payload.back(), 3);
+
+    JitterBufferConfig config;
+    config.target_delay = std::chrono::microseconds(0);
+    config.adaptive = false;
+    relay_client->SetJitterBufferConfig(config);
+    std::vector<std::vector<uint8_t>> received;
+    relay_client->SetOnDataReceived(
+        [&](const std::vector<uint8_t>& data) { received.push_back(data); });
+    relay_client->HandleIncomingFrame(sent[1]);
+    ASSERT_EQ(received.size(), 1u);
+    EXPECT_EQ(received[0], packet);
+}
+
+// A spectator starts from the snapshot, then plays the broadcast frames after it
+TEST_F(RelayClientTest, SpectatorPlaysOutFromTheSnapshot) {
+    EXPECT_CALL(*mock_server_selector, SelectBestServer())
+        .WillOnce(Return(std::string(TEST_SERVER_HOST)));
+    EXPECT_CALL(*mock_connection,
+                Connect(TEST_SERVER_HOST, TEST_SERVER_PORT))
+        .Times(1);
+    EXPECT_CALL(*mock_connection, SetAuthToken(TEST_JWT_TOKEN)).Times(1);
+    EXPECT_CALL(*mock_connection, Authenticate()).WillOnce(Return(true));
+    relay_client->ConnectAsync(TEST_JWT_TOKEN, [](bool) {});
+
+    std::vector<std::vector<uint8_t>> sent;
+    relay_client->SetFrameWriter([&](const RelayFrame& frame) {
+        std::vector<uint8_t> bytes(frame.header.begin(), frame.header.end());
+        bytes.insert(bytes.end(), frame.payload.begin(), frame.payload.end());
+        sent.push_back(std::move(bytes));
+        return true;
+    });
+
+    std::vector<std::pair<bool, std::vector<uint8_t>>> played;
+    bool accepted = false;
+    relay_client->SpectateSessionAsync(
+        TEST_SESSION_TOKEN, SpectatorConfig{},
+        [&](bool snapshot, const std::vector<uint8_t>& payload) {
+            played.emplace_back(snapshot, payload);
+        },
+        [&](bool ok, uint32_t) { accepted = ok; });
+
+    RelayProtocol protocol;
+    RelayHeaderView header;
+    ASSERT_EQ(sent.size(), 1u);
+    ASSERT_TRUE(protocol.ValidateMessage(sent[0], &header));
+    EXPECT_EQ(header.flags, RelayProtocol::FLAG_SESSION_JOIN);
+    EXPECT_EQ(header.extended_flags, RelayProtocol::EXT_FLAG_SPECTATE);
+
+    std::array<uint8_t, 12> reply{};
+    protocol.WriteHeader(reply, TEST_SESSION_TOKEN, 0, RelayProtocol::FLAG_SESSION_JOIN, 0,
+                         RelayProtocol::EXT_FLAG_SPECTATE);
+    relay_client->HandleIncomingFrame(reply);
+    EXPECT_TRUE(accepted);
+
+    // The same client stands in for the host; the relay would echo these back
+    const std::vector<uint8_t> early{1};
+    const std::vector<uint8_t> state{2, 2};
+    const std::vector<uint8_t> later{3};
+    ASSERT_TRUE(relay_client->SendBroadcast(TEST_SESSION_TOKEN, early));
+    ASSERT_TRUE(relay_client->SendSpectatorSnapshot(TEST_SESSION_TOKEN, state));
+    ASSERT_TRUE(relay_client->SendBroadcast(TEST_SESSION_TOKEN, later));
+    ASSERT_EQ(sent.size(), 4u);
+    ASSERT_TRUE(protocol.ValidateMessage(sent[2], &header));
+    EXPECT_EQ(header.extended_flags,
+              RelayProtocol::EXT_FLAG_SPECTATE | RelayProtocol::EXT_FLAG_SNAPSHOT);
+
+    // Delivered out of order, with the early frame arriving last
+    relay_client->HandleIncomingFrame(sent[3]);
+    EXPECT_TRUE(played.empty());
+    relay_client->HandleIncomingFrame(sent[2]);
+    relay_client->HandleIncomingFrame(sent[1]);
+    ASSERT_EQ(played.size(), 2u);
+    EXPECT_EQ(played[0], std::make_pair(true, state));
+    EXPECT_EQ(played[1], std::make_pair(false, later));
+
+    const auto stats = relay_client->GetSpectatorStatistics(TEST_SESSION_TOKEN);
+    ASSERT_TRUE(stats.has_value());
+    EXPECT_EQ(stats->late_dropped, 1u);
+
+    relay_client->StopSpectating(TEST_SESSION_TOKEN);
+    ASSERT_EQ(sent.size(), 5u);
+    ASSERT_TRUE(protocol.ValidateMessage(sent[4], &header));
+    EXPECT_EQ(header.flags, RelayProtocol::FLAG_SESSION_LEAVE);
+    EXPECT_FALSE(relay_client->GetSpectatorStatistics(TEST_SESSION_TOKEN).has_value());
+}
+
+// Frames over the probed MTU go out in fragments and come back whole
+TEST_F(RelayClientTest, FragmentsFramesLargerThanThePathMtu) {
+    EXPECT_CALL(*mock_server_selector, SelectBestServer())
+        .WillOnce(Return(std::string(TEST_SERVER_HOST)));
+    EXPECT_CALL(*mock_connection,
+                Connect(TEST_SERVER_HOST, TEST_SERVER_PORT))
+        .Times(1);
+    EXPECT_CALL(*mock_connection, SetAuthToken(TEST_JWT_TOKEN)).Times(1);
+    EXPECT_CALL(*mock_connection, Authenticate()).WillOnce(Return(true));
+    relay_client->ConnectAsync(TEST_JWT_TOKEN, [](bool) {});
+
+    auto owned_transport = std::make_unique<FakeRelayTransport>();
+    auto* transport = owned_transport.get();
+    relay_client->SetDatagramTransport(std::move(owned_transport));
+    ASSERT_TRUE(relay_client->OpenDatagramTransport("relay.invalid", 9000));
+    EXPECT_EQ(relay_client->GetPathMtu(), RelayProtocol::PATH_MTU_CANDIDATES.back());
+
+    // One padded keepalive per candidate; the relay answers all but the largest
+    relay_client->ProbePathMtu();
+    std::vector<std::vector<uint8_t>> probes;
+    {
+        std::lock_guard<std::mutex> lock(transport->mutex);
+        probes = std::exchange(transport->sent, {});
+    }
+    ASSERT_EQ(probes.size(), RelayProtocol::PATH_MTU_CANDIDATES.size());
+    RelayProtocol protocol;
+    RelayHeaderView header;
+    for (size_t i = 1; i < probes.size(); ++i) {
+        EXPECT_EQ(probes[i].size(), RelayProtocol::PATH_MTU_CANDIDATES[i]);
+        ASSERT_TRUE(protocol.ValidateMessage(probes[i], &header));
+        uint64_t timestamp_us = 0;
+        uint64_t echo_timestamp_us = 0;
+        ASSERT_TRUE(
+            RelayProtocol::ParseKeepalivePayload(header.payload, timestamp_us, echo_timestamp_us));
+        std::array<uint8_t, 12 + RelayProtocol::KEEPALIVE_PAYLOAD_SIZE> answer{};
+        protocol.WriteHeader(answer, 0, RelayProtocol::KEEPALIVE_PAYLOAD_SIZE,
+                             RelayProtocol::FLAG_KEEPALIVE, header.sequence_num);
+        RelayProtocol::WriteKeepalivePayload(std::span(answer).subspan(12), 0, timestamp_us);
+        relay_client->HandleIncomingFrame(answer);
+    }
+    // The smaller answer came later and was retired by the larger one
+    EXPECT_EQ(relay_client->GetPathMtu(), RelayProtocol::PATH_MTU_CANDIDATES[1]);
+
+    std::vector<uint8_t> packet(3000);
+    for (size_t i = 0; i < packet.size(); ++i) {
+        packet[i] = static_cast<uint8_t>(i * 7);
+    }
+    ASSERT_TRUE(relay_client->SendData(TEST_SESSION_TOKEN, packet));
+    std::vector<std::vector<uint8_t>> fragments;
+    {
+        std::lock_guard<std::mutex> lock(transport->mutex);
+        fragments = std::exchange(transport->sent, {});
+    }
+    ASSERT_EQ(fragments.size(), 3u);
+    for (const auto& fragment : fragments) {
+        EXPECT_LE(fragment.size(), relay_client->GetPathMtu());
+        ASSERT_TRUE(protocol.ValidateMessage(fragment, &header));
+        EXPECT_EQ(header.extended_flags, RelayProtocol::EXT_FLAG_FRAGMENT);
+    }
+
+    JitterBufferConfig config;
+    config.target_delay = std::chrono::microseconds(0);
+    config.adaptive = false;
+    relay_client->SetJitterBufferConfig(config);
+    std::vector<std::vector<uint8_t>> received;
+    relay_client->SetOnDataReceived(
+        [&](const std::vector<uint8_t>& data) { received.push_back(data); });
+    for (auto it = fragments.rbegin(); it != fragments.rend(); ++it) {
+        relay_client->HandleIncomingFrame(*it);
+    }
+    ASSERT_EQ(received.size(), 1u);
+    EXPECT_EQ(received[0], packet);
+    EXPECT_EQ(relay_client->GetFragmentStatistics().completed, 1u);
+}
+
+// Fragments of two members' messages with the same sequence number reassemble apart
+TEST_F(RelayClientTest, FragmentsFromTwoSendersReassembleApart) {
+    JitterBufferConfig config;
+    config.target_delay = std::chrono::microseconds(0);
+    config.adaptive = false;
+    relay_client->SetJitterBufferConfig(config);
+    std::vector<std::vector<uint8_t>> received;
+    relay_client->SetOnDataReceived(
+        [&](const std::vector<uint8_t>& data) { received.push_back(data); });
+
+    RelayProtocol protocol;
+    const auto fragment = [&](uint8_t sender, size_t index) {
+        std::vector<uint8_t> bytes(RelayProtocol::FRAGMENT_HEADER_SIZE);
+        FragmentReassembler::WriteHeader(
+            std::span(bytes).first<RelayProtocol::FRAGMENT_HEADER_SIZE>(), index, 2);
+        bytes.insert(bytes.end(), 4, static_cast<uint8_t>(sender * 16 + index));
+        const auto frame = protocol.FrameDataMessage(
+            TEST_SESSION_TOKEN, bytes, 0, RelayProtocol::EXT_FLAG_FRAGMENT, sender);
+        std::vector<uint8_t> datagram(frame.header.begin(), frame.header.end());
+        datagram.insert(datagram.end(), frame.payload.begin(), frame.payload.end());
+        datagram.insert(datagram.end(), frame.Trailer().begin(), frame.Trailer().end());
+        return datagram;
+    };
+    relay_client->HandleIncomingFrame(fragment(1, 0));
+    relay_client->HandleIncomingFrame(fragment(2, 1));
+    relay_client->HandleIncomingFrame(fragment(2, 0));
+    relay_client->HandleIncomingFrame(fragment(1, 1));
+
+    ASSERT_EQ(received.size(), 2u);
+    EXPECT_EQ(received[0], (std::vector<uint8_t>{32, 32, 32, 32, 33, 33, 33, 33}));
+    EXPECT_EQ(received[1], (std::vector<uint8_t>{16, 16, 16, 16, 17, 17, 17, 17}));
+    EXPECT_EQ(relay_client->GetFragmentStatistics().completed, 2u);
+    EXPECT_EQ(relay_client->GetFragmentStatistics().duplicates, 0u);
+}
+
+// A frame past the pooled buffer size crosses the relay in fragments and
+// reaches the receiving game whole
+TEST_F(RelayClientTest, BackendReceivesFramesLargerThanAPooledBuffer) {
+    EXPECT_CALL(*mock_server_selector, SelectBestServer())
+        .WillOnce(Return(std::string(TEST_SERVER_HOST)));
+    EXPECT_CALL(*mock_connection,
+                Connect(TEST_SERVER_HOST, TEST_SERVER_PORT))
+        .Times(1);
+    EXPECT_CALL(*mock_connection, SetAuthToken(TEST_JWT_TOKEN)).Times(1);
+    EXPECT_CALL(*mock_connection, Authenticate()).WillOnce(Return(true));
+    relay_client->ConnectAsync(TEST_JWT_TOKEN, [](bool) {});
+
+    auto owned_transport = std::make_unique<FakeRelayTransport>();
+    auto* transport = owned_transport.get();
+    relay_client->SetDatagramTransport(std::move(owned_transport));
+    ASSERT_TRUE(relay_client->OpenDatagramTransport("relay.invalid", 9000));
+
+    ModelABackend sender{nullptr, nullptr};
+    sender.SetPacketSender(
+        [this](uint8_t, const uint8_t* data, size_t size, SendPriority priority) {
+            return relay_client->SendData(TEST_SESSION_TOKEN, {data, size}, priority)
+                       ? ErrorCode::Success
+                       : ErrorCode::NetworkError;
+        });
+    ASSERT_EQ(sender.Initialize(), ErrorCode::Success);
+
+    std::vector<uint8_t> packet(PACKET_BUFFER_SIZE * 2 + 100);
+    for (size_t i = 0; i < packet.size(); ++i) {
+        packet[i] = static_cast<uint8_t>(i * 13);
+    }
+    ASSERT_EQ(sender.SendPacket(packet, 1), ErrorCode::Success);
+    std::vector<std::vector<uint8_t>> fragments;
+    {
+        std::lock_guard<std::mutex> lock(transport->mutex);
+        fragments = std::exchange(transport->sent, {});
+    }
+    ASSERT_EQ(fragments.size(), 3u);
+
+    ModelABackend receiver{nullptr, nullptr};
+    ASSERT_EQ(receiver.Initialize(), ErrorCode::Success);
+    JitterBufferConfig config;
+    config.target_delay = std::chrono::microseconds(0);
+    config.adaptive = false;
+    relay_client->SetJitterBufferConfig(config);
+    relay_client->SetOnDataReceived([&receiver](const std::vector<uint8_t>& data) {
+        EXPECT_TRUE(receiver.DeliverPacket(0, data.data(), data.size()));
+    });
+    for (const auto& fragment : fragments) {
+        relay_client->HandleIncomingFrame(fragment);
+    }
+
+    std::vector<uint8_t> received;
+    uint8_t from = 0xFF;
+    ASSERT_EQ(receiver.ReceivePacket(received, from), ErrorCode::Success);
+    EXPECT_EQ(received, packet);
+    EXPECT_EQ(from, 0);
+}
+
+// Channel frames bypass the jitter buffer, and acks ride on the client's own frames
+TEST_F(RelayClientTest, ChannelsCarryReliableMessagesAndTheirAcks) {
+    EXPECT_CALL(*mock_server_selector, SelectBestServer())
+        .WillOnce(Return(std::string(TEST_SERVER_HOST)));
+    EXPECT_CALL(*mock_connection,
+                Connect(TEST_SERVER_HOST, TEST_SERVER_PORT))
+        .Times(1);
+    EXPECT_CALL(*mock_connection, SetAuthToken(TEST_JWT_TOKEN)).Times(1);
+    EXPECT_CALL(*mock_connection, Authenticate()).WillOnce(Return(true));
+    relay_client->ConnectAsync(TEST_JWT_TOKEN, [](bool) {});
+
+    std::vector<std::vector<uint8_t>> sent;
+    relay_client->SetFrameWriter([&](const RelayFrame& frame) {
+        std::vector<uint8_t> bytes(frame.header.begin(), frame.header.end());
+        bytes.insert(bytes.end(), frame.payload.begin(), frame.payload.end());
+        sent.push_back(std::move(bytes));
+        return true;
+    });
+    ChannelConfig config;
+    config.poll_interval = std::chrono::milliseconds(0);
+    std::vector<std::pair<uint8_t, std::vector<uint8_t>>> received;
+    relay_client->EnableChannels(config, [&](uint32_t session_token, uint8_t channel,
+                                             std::span<const uint8_t> payload) {
+        EXPECT_EQ(session_token, TEST_SESSION_TOKEN);
+        received.emplace_back(channel, std::vector<uint8_t>(payload.begin(), payload.end()));
+    });
+
+    // The peer's end of the session, wrapping its frames for the relay
+    RelayProtocol protocol;
+    uint32_t peer_sequence = 0;
+    std::vector<std::vector<uint8_t>> peer_frames;
+    ChannelMultiplexer peer(
+        config,
+        [&](std::span<const uint8_t> frame) {
+            const auto relay_frame = protocol.FrameDataMessage(
+                TEST_SESSION_TOKEN, frame, peer_sequence++, RelayProtocol::EXT_FLAG_CHANNEL);
+            std::vector<uint8_t> bytes(relay_frame.header.begin(), relay_frame.header.end());
+            bytes.insert(bytes.end(), frame.begin(), frame.end());
+            peer_frames.push_back(std::move(bytes));
+            return true;
+        },
+        [&](uint8_t channel, std::span<const uint8_t> payload) {
+            received.emplace_back(channel + 100,
+                                  std::vector<uint8_t>(payload.begin(), payload.end()));
+        });
+
+    const std::vector<uint8_t> join{1, 2, 3};
+    ASSERT_TRUE(peer.Send(0, join));
+    ASSERT_EQ(peer_frames.size(), 1u);
+    relay_client->HandleIncomingFrame(peer_frames[0]);
+    ASSERT_EQ(received.size(), 1u);
+    EXPECT_EQ(received[0], (std::pair<uint8_t, std::vector<uint8_t>>{0, join}));
+    EXPECT_EQ(peer.GetUnackedCount(), 1u);
+
+    // The client's unreliable reply acknowledges the join
+    const std::vector<uint8_t> state{9};
+    ASSERT_TRUE(relay_client->SendOnChannel(TEST_SESSION_TOKEN, 1, state));
+    ASSERT_EQ(sent.size(), 1u);
+    RelayHeaderView header;
+    ASSERT_TRUE(protocol.ValidateMessage(sent[0], &header));
+    EXPECT_EQ(header.extended_flags, RelayProtocol::EXT_FLAG_CHANNEL);
+    peer.Receive(header.payload);
+    EXPECT_EQ(peer.GetUnackedCount(), 0u);
+    ASSERT_EQ(received.size(), 2u);
+    EXPECT_EQ(received[1], (std::pair<uint8_t, std::vector<uint8_t>>{101, state}));
+
+    const auto statistics = relay_client->GetChannelStatistics(TEST_SESSION_TOKEN);
+    ASSERT_TRUE(statistics.has_value());
+    EXPECT_EQ(statistics->acks_piggybacked, 1u);
+    EXPECT_FALSE(relay_client->GetJitterStatistics(TEST_SESSION_TOKEN).has_value());
+}
+
+// A silent relay is abandoned for the alternate every peer of the session picks
+TEST_F(RelayClientTest, FailsOverToTheSessionsAlternateRelay) {
+    EXPECT_CALL(*mock_server_selector, SelectBestServer())
+        .WillOnce(Return(std::string(TEST_SERVER_HOST)));
+    EXPECT_CALL(*mock_connection,
+                Connect(TEST_SERVER_HOST, TEST_SERVER_PORT))
+        .Times(1);
+    EXPECT_CALL(*mock_connection, SetAuthToken(TEST_JWT_TOKEN)).Times(1);
+    EXPECT_CALL(*mock_connection, Authenticate()).WillOnce(Return(true));
+    relay_client->ConnectAsync(TEST_JWT_TOKEN, [](bool) {});
+
+    auto owned_transport = std::make_unique<FakeRelayTransport>();
+    auto* transport = owned_transport.get();
+    relay_client->SetDatagramTransport(std::move(owned_transport));
+    ASSERT_TRUE(relay_client->OpenDatagramTransport("relay-a.invalid", 9000));
+
+    RelayProtocol protocol;
+    std::array<uint8_t, 12> reply{};
+    relay_client->CreateSessionAsync(TEST_SESSION_TOKEN, [](bool, uint32_t) {});
+    protocol.WriteHeader(reply, TEST_SESSION_TOKEN, 0, RelayProtocol::FLAG_SESSION_CREATE, 0);
+    relay_client->HandleIncomingFrame(reply);
+    ASSERT_EQ(relay_client->GetCurrentSession(), TEST_SESSION_TOKEN);
+    ASSERT_TRUE(relay_client->SendData(std::vector<uint8_t>{1}));
+
+    const std::vector<std::string> servers{"relay-a.invalid:9000", "relay-b.invalid:9000",
+                                           "relay-c.invalid:9000"};
+    auto order = RelayServerSelector::RankForSession(servers, TEST_SESSION_TOKEN);
+    std::erase(order, servers[0]);
+
+    std::mutex failover_mutex;
+    std::string failed_over_to;
+    relay_client->SetOnFailover([&](const std::string& server) {
+        std::lock_guard<std::mutex> lock(failover_mutex);
+        failed_over_to = server;
+    });
+    RelayFailoverConfig config;
+    config.silence_timeout = std::chrono::milliseconds(40);
+    config.check_interval = std::chrono::milliseconds(5);
+    config.resume_timeout = std::chrono::milliseconds(30);
+    relay_client->EnableFailover(servers, servers[0], config);
+
+    // Waits for the resume request on the next alternate, then answers or ignores it
+    RelayHeaderView header;
+    const auto await_resume = [&](int redirects) {
+        for (int i = 0; i < 200; ++i) {
+            {
+                std::lock_guard<std::mutex> lock(transport->mutex);
+                if (transport->redirects == redirects && !transport->sent.empty() &&
+                    protocol.ValidateMessage(transport->sent.back(), &header) &&
+                    header.flags == RelayProtocol::FLAG_SESSION_RESUME) {
+                    return transport->endpoint;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return std::string{};
+    };
+
+    // The first alternate stays silent, the second resumes the session
+    ASSERT_EQ(await_resume(1), order[0]);
+    ASSERT_EQ(await_resume(2), order[1]);
+    EXPECT_EQ(header.session_token, TEST_SESSION_TOKEN);
+    protocol.WriteHeader(reply, TEST_SESSION_TOKEN, 0, RelayProtocol::FLAG_SESSION_RESUME, 0);
+    relay_client->HandleIncomingFrame(reply);
+    {
+        std::lock_guard<std::mutex> lock(failover_mutex);
+        EXPECT_EQ(failed_over_to, order[1]);
+    }
+    EXPECT_EQ(relay_client->GetFailoverCount(), 1u);
+    EXPECT_EQ(relay_client->GetCurrentSession(), TEST_SESSION_TOKEN);
+    relay_client->DisableFailover();
+
+    // Sequence numbers carry on across the move
+    uint32_t last_data_sequence = 0;
+    {
+        std::lock_guard<std::mutex> lock(transport->mutex);
+        ASSERT_TRUE(protocol.ValidateMessage(transport->sent[1], &header));
+        last_data_sequence = header.sequence_num;
+        transport->sent.clear();
+    }
+    ASSERT_TRUE(relay_client->SendData(std::vector<uint8_t>{2}));
+    std::lock_guard<std::mutex> lock(transport->mutex);
+    ASSERT_EQ(transport->sent.size(), 1u);
+    ASSERT_TRUE(protocol.ValidateMessage(transport->sent[0], &header));
+    EXPECT_GT(header.sequence_num, last_data_sequence);
+}
+
 } // namespace
@@ -2,6 +2,8 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
 #include <vector>
 
 #include "../relay_protocol.h"
@@ -119,6 +121,49 @@ TEST_F(RelayProtocolTest, CreateDataMessage) {
     EXPECT_EQ(message[RELAY_HEADER_SIZE + 3], 0xDD);
 }
 
+// Write a data message into a caller-provided buffer without allocating
+TEST_F(RelayProtocolTest, WriteDataMessageIntoCallerBuffer) {
+    std::vector<uint8_t> payload = {0xAA, 0xBB, 0xCC, 0xDD};
+    std::array<uint8_t, 64> buffer{};
+
+    size_t written = protocol_handler->WriteDataMessage(
+        buffer, TEST_SESSION_TOKEN, payload, TEST_SEQUENCE_NUM);
+
+    ASSERT_EQ(written, RELAY_HEADER_SIZE + payload.size());
+    std::vector<uint8_t> expected = protocol_handler->CreateDataMessage(
+        TEST_SESSION_TOKEN, payload, TEST_SEQUENCE_NUM);
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), buffer.begin()));
+}
+
+// Reject buffers that cannot hold the framed message
+TEST_F(RelayProtocolTest, WriteDataMessageBufferTooSmall) {
+    std::vector<uint8_t> payload(8, 0x11);
+    std::array<uint8_t, RELAY_HEADER_SIZE + 4> buffer{};
+
+    EXPECT_EQ(protocol_handler->WriteDataMessage(buffer, TEST_SESSION_TOKEN, payload,
+                                                 TEST_SEQUENCE_NUM), 0u);
+
+    std::array<uint8_t, 4> header_buffer{};
+    EXPECT_EQ(protocol_handler->WriteHeader(header_buffer, TEST_SESSION_TOKEN, 0,
+                                            RelayProtocol::FLAG_DATA, TEST_SEQUENCE_NUM), 0u);
+}
+
+// Frame a data message as separate header and payload segments
+TEST_F(RelayProtocolTest, FrameDataMessageAliasesPayload) {
+    std::vector<uint8_t> payload = {0xAA, 0xBB, 0xCC, 0xDD};
+    RelayFrame frame = protocol_handler->FrameDataMessage(
+        TEST_SESSION_TOKEN, payload, TEST_SEQUENCE_NUM);
+
+    EXPECT_EQ(frame.payload.data(), payload.data());
+    EXPECT_EQ(frame.payload.size(), payload.size());
+    EXPECT_EQ(frame.TotalSize(), RELAY_HEADER_SIZE + payload.size());
+
+    std::vector<uint8_t> header = protocol_handler->SerializeHeader(
+        TEST_SESSION_TOKEN, static_cast<uint16_t>(payload.size()),
+        RelayProtocol::FLAG_DATA, TEST_SEQUENCE_NUM);
+    EXPECT_TRUE(std::equal(header.begin(), header.end(), frame.header.begin()));
+}
+
 // Create a control message with no payload
 TEST_F(RelayProtocolTest, CreateControlMessage) {
     std::vector<uint8_t> message = protocol_handler->CreateControlMessage(
@@ -169,6 +214,49 @@ TEST_F(RelayProtocolTest, ValidateCompleteMessage) {
     EXPECT_FALSE(protocol_handler->ValidateMessage(bad_message));
 }
 
+// Parse a header in place and expose the trailing payload without copying
+TEST_F(RelayProtocolTest, ParseHeaderViewInPlace) {
+    std::vector<uint8_t> message = {
+        0x78, 0x56, 0x34, 0x12,
+        0x04, 0x00,
+        0x01,
+        0x00,
+        0x21, 0x43, 0x65, 0x87,
+        0xAA, 0xBB, 0xCC, 0xDD};
+
+    RelayHeaderView view;
+    ASSERT_TRUE(protocol_handler->ParseHeader(message.data(), message.size(), view));
+    EXPECT_EQ(view.session_token, TEST_SESSION_TOKEN);
+    EXPECT_EQ(view.payload_size, 4);
+    EXPECT_EQ(view.flags, 0x01);
+    EXPECT_EQ(view.sequence_num, TEST_SEQUENCE_NUM);
+    EXPECT_EQ(view.payload.data(), message.data() + RELAY_HEADER_SIZE);
+    EXPECT_EQ(view.payload.size(), 4u);
+
+    EXPECT_FALSE(protocol_handler->ParseHeader(message.data(), RELAY_HEADER_SIZE - 1, view));
+}
+
+// Span validation agrees with the vector overloads and returns the header
+TEST_F(RelayProtocolTest, ValidateMessageSpanReturnsView) {
+    std::vector<uint8_t> payload = {0x10, 0x20, 0x30};
+    std::vector<uint8_t> message = protocol_handler->CreateDataMessage(
+        TEST_SESSION_TOKEN, payload, TEST_SEQUENCE_NUM);
+
+    RelayHeaderView view;
+    ASSERT_TRUE(protocol_handler->ValidateMessage(std::span<const uint8_t>(message), &view));
+    EXPECT_EQ(view.session_token, TEST_SESSION_TOKEN);
+    EXPECT_EQ(view.sequence_num, TEST_SEQUENCE_NUM);
+    EXPECT_TRUE(std::equal(payload.begin(), payload.end(), view.payload.begin()));
+
+    EXPECT_TRUE(protocol_handler->ValidateHeader(
+        std::span<const uint8_t>(message).first(RELAY_HEADER_SIZE)));
+
+    // Truncated datagram is rejected by both overload families
+    message.pop_back();
+    EXPECT_FALSE(protocol_handler->ValidateMessage(message.data(), message.size()));
+    EXPECT_FALSE(protocol_handler->ValidateMessage(message));
+}
+
 // Confirm protocol constants and limits
 TEST_F(RelayProtocolTest, ProtocolLimitsAndConstants) {
     EXPECT_EQ(protocol_handler->GetHeaderSize(), RELAY_HEADER_SIZE);
@@ -187,6 +275,52 @@ TEST_F(RelayProtocolTest, EndiannessHandling) {
     EXPECT_EQ(serialized[5], 0x12);
 }
 
+// Keepalive timestamps survive a round trip in little-endian order
+TEST_F(RelayProtocolTest, KeepalivePayloadRoundTrip) {
+    std::array<uint8_t, RelayProtocol::KEEPALIVE_PAYLOAD_SIZE> payload{};
+    ASSERT_EQ(RelayProtocol::WriteKeepalivePayload(payload, 0x0102030405060708ULL, 42),
+              RelayProtocol::KEEPALIVE_PAYLOAD_SIZE);
+    EXPECT_EQ(payload[0], 0x08);
+    EXPECT_EQ(payload[7], 0x01);
+    EXPECT_EQ(payload[8], 42);
+
+    uint64_t timestamp = 0;
+    uint64_t echo = 0;
+    ASSERT_TRUE(RelayProtocol::ParseKeepalivePayload(payload, timestamp, echo));
+    EXPECT_EQ(timestamp, 0x0102030405060708ULL);
+    EXPECT_EQ(echo, 42u);
+
+    EXPECT_FALSE(RelayProtocol::ParseKeepalivePayload(
+        std::span<const uint8_t>(payload).first(8), timestamp, echo));
+}
+
+// Replies may carry the responder's clock; older replies read as 0
+TEST_F(RelayProtocolTest, KeepaliveReplyCarriesResponderClock) {
+    std::array<uint8_t, RelayProtocol::KEEPALIVE_CLOCK_PAYLOAD_SIZE> payload{};
+    ASSERT_EQ(RelayProtocol::WriteKeepalivePayload(payload, 0, 1000, 777),
+              RelayProtocol::KEEPALIVE_CLOCK_PAYLOAD_SIZE);
+
+    uint64_t timestamp = 1;
+    uint64_t echo = 0;
+    uint64_t responder_time = 0;
+    ASSERT_TRUE(RelayProtocol::ParseKeepalivePayload(payload, timestamp, echo, responder_time));
+    EXPECT_EQ(timestamp, 0u);
+    EXPECT_EQ(echo, 1000u);
+    EXPECT_EQ(responder_time, 777u);
+
+    // Readers that predate the field still see the timestamps
+    ASSERT_TRUE(RelayProtocol::ParseKeepalivePayload(payload, timestamp, echo));
+    EXPECT_EQ(echo, 1000u);
+
+    ASSERT_TRUE(RelayProtocol::ParseKeepalivePayload(
+        std::span<const uint8_t>(payload).first(RelayProtocol::KEEPALIVE_PAYLOAD_SIZE), timestamp,
+        echo, responder_time));
+    EXPECT_EQ(responder_time, 0u);
+
+    std::array<uint8_t, RelayProtocol::KEEPALIVE_PAYLOAD_SIZE> short_payload{};
+    EXPECT_EQ(RelayProtocol::WriteKeepalivePayload(short_payload, 0, 1000, 777), 0u);
+}
+
 // Verify protocol flag definitions
 TEST_F(RelayProtocolTest, ProtocolFlags) {
     EXPECT_EQ(RelayProtocol::FLAG_DATA, 0x00);
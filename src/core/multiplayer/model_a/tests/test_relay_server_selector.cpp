@@ -0,0 +1,237 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "../relay_server_selector.h"
+
+using namespace Core::Multiplayer::ModelA;
+
+TEST(RelayServerSelectorTest, ParsesEndpoints) {
+    std::string host;
+    uint16_t port = 0;
+
+    ASSERT_TRUE(RelayServerSelector::ParseEndpoint("relay.example.org:9000", 8443, host, port));
+    EXPECT_EQ(host, "relay.example.org");
+    EXPECT_EQ(port, 9000);
+
+    ASSERT_TRUE(RelayServerSelector::ParseEndpoint("relay.example.org", 8443, host, port));
+    EXPECT_EQ(host, "relay.example.org");
+    EXPECT_EQ(port, 8443);
+
+    ASSERT_TRUE(RelayServerSelector::ParseEndpoint("[2001:db8::1]:9000", 8443, host, port));
+    EXPECT_EQ(host, "2001:db8::1");
+    EXPECT_EQ(port, 9000);
+
+    ASSERT_TRUE(RelayServerSelector::ParseEndpoint("2001:db8::1", 8443, host, port));
+    EXPECT_EQ(host, "2001:db8::1");
+    EXPECT_EQ(port, 8443);
+
+    EXPECT_FALSE(RelayServerSelector::ParseEndpoint("relay:notaport", 8443, host, port));
+    EXPECT_FALSE(RelayServerSelector::ParseEndpoint(":9000", 8443, host, port));
+    EXPECT_FALSE(RelayServerSelector::ParseEndpoint("[2001:db8::1", 8443, host, port));
+}
+
+TEST(RelayServerSelectorTest, FailoverOrderIsTheSameForEveryPeer) {
+    const std::vector<std::string> servers{"relay-a.invalid", "relay-b.invalid",
+                                           "relay-c.invalid", "relay-d.invalid"};
+    auto reversed = servers;
+    std::reverse(reversed.begin(), reversed.end());
+    const auto order = RelayServerSelector::RankForSession(servers, 7);
+    EXPECT_EQ(RelayServerSelector::RankForSession(reversed, 7), order);
+
+    // Sessions spread over the servers instead of all failing over to one
+    std::set<std::string> first_choices;
+    for (uint32_t session = 0; session < 64; ++session) {
+        first_choices.insert(RelayServerSelector::RankForSession(servers, session)[0]);
+    }
+    EXPECT_GT(first_choices.size(), 1u);
+
+    // The failed and unhealthy servers are skipped, the rest keep their rank
+    RelayServerSelector selector(servers);
+    selector.MarkServerUnhealthy(order[2]);
+    EXPECT_EQ(selector.GetFailoverOrder(7, order[0]),
+              (std::vector<std::string>{order[1], order[3]}));
+    EXPECT_FALSE(selector.IsServerHealthy(order[0]));
+}
+
+TEST(RelayServerSelectorTest, SeededResultsSelectWithoutProbing) {
+    RelayServerSelector selector({"relay-a.invalid:9000", "relay-b.invalid:9000"});
+    selector.SeedProbeResults({{"relay-a.invalid:9000", std::chrono::microseconds(40000)},
+                               {"relay-b.invalid:9000", std::chrono::microseconds(12000)},
+                               {"relay-gone.invalid:9000", std::chrono::microseconds(1000)}});
+
+    EXPECT_EQ(selector.SelectBestServer(), "relay-b.invalid:9000");
+    EXPECT_EQ(selector.GetStatistics().probe_rounds, 0u);
+    EXPECT_EQ(selector.GetStatistics().cache_hits, 1u);
+
+    // Servers no longer configured are not adopted
+    const auto results = selector.GetProbeResults();
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_EQ(results[0].server, "relay-b.invalid:9000");
+}
+
+#ifndef _WIN32
+
+namespace {
+
+/**
+ * Loopback relay that echoes keepalive probes after a fixed delay, or never
+ */
+class EchoRelayServer {
+public:
+    explicit EchoRelayServer(std::chrono::milliseconds delay, bool answers = true)
+        : delay_(delay), answers_(answers) {
+        socket_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ::bind(socket_, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        socklen_t length = sizeof(address);
+        ::getsockname(socket_, reinterpret_cast<sockaddr*>(&address), &length);
+        endpoint_ = "127.0.0.1:" + std::to_string(ntohs(address.sin_port));
+        thread_ = std::thread([this]() { Run(); });
+    }
+
+    ~EchoRelayServer() {
+        stop_ = true;
+        thread_.join();
+        ::close(socket_);
+    }
+
+    const std::string& GetEndpoint() const { return endpoint_; }
+    uint32_t GetProbeCount() const { return probes_.load(); }
+
+private:
+    void Run() {
+        std::vector<uint8_t> buffer(64);
+        while (!stop_) {
+            pollfd descriptor{socket_, POLLIN, 0};
+            if (::poll(&descriptor, 1, 10) <= 0) {
+                continue;
+            }
+            sockaddr_in from{};
+            socklen_t length = sizeof(from);
+            const auto received = ::recvfrom(socket_, buffer.data(), buffer.size(), 0,
+                                             reinterpret_cast<sockaddr*>(&from), &length);
+            if (received <= 0) {
+                continue;
+            }
+            probes_.fetch_add(1);
+            if (!answers_) {
+                continue;
+            }
+            std::this_thread::sleep_for(delay_);
+            ::sendto(socket_, buffer.data(), static_cast<size_t>(received), 0,
+                     reinterpret_cast<const sockaddr*>(&from), length);
+        }
+    }
+
+    const std::chrono::milliseconds delay_;
+    const bool answers_;
+    int socket_ = -1;
+    std::string endpoint_;
+    std::atomic<bool> stop_{false};
+    std::atomic<uint32_t> probes_{0};
+    std::thread thread_;
+};
+
+RelayServerSelectorConfig FastProbeConfig() {
+    RelayServerSelectorConfig config;
+    config.probe_deadline = std::chrono::milliseconds(200);
+    config.settle_time = std::chrono::milliseconds(100);
+    return config;
+}
+
+} // anonymous namespace
+
+TEST(RelayServerSelectorTest, SelectsLowestRttServer) {
+    EchoRelayServer slow(std::chrono::milliseconds(40));
+    EchoRelayServer fast(std::chrono::milliseconds(0));
+    EchoRelayServer silent(std::chrono::milliseconds(0), false);
+
+    RelayServerSelector selector(
+        {slow.GetEndpoint(), silent.GetEndpoint(), fast.GetEndpoint()}, FastProbeConfig());
+    EXPECT_EQ(selector.SelectBestServer(), fast.GetEndpoint());
+
+    // Every server was probed in the same round
+    EXPECT_EQ(slow.GetProbeCount(), 1u);
+    EXPECT_EQ(fast.GetProbeCount(), 1u);
+    EXPECT_EQ(silent.GetProbeCount(), 1u);
+
+    const auto fast_rtt = selector.GetServerLatency(fast.GetEndpoint());
+    const auto slow_rtt = selector.GetServerLatency(slow.GetEndpoint());
+    ASSERT_TRUE(fast_rtt.has_value());
+    ASSERT_TRUE(slow_rtt.has_value());
+    EXPECT_LT(*fast_rtt, *slow_rtt);
+    EXPECT_FALSE(selector.GetServerLatency(silent.GetEndpoint()).has_value());
+    EXPECT_FALSE(selector.IsServerHealthy(silent.GetEndpoint()));
+}
+
+TEST(RelayServerSelectorTest, ReusesResultsUntilTtlExpires) {
+    EchoRelayServer server(std::chrono::milliseconds(0));
+    auto config = FastProbeConfig();
+    config.cache_ttl = std::chrono::seconds(1);
+    RelayServerSelector selector({server.GetEndpoint()}, config);
+
+    EXPECT_EQ(selector.SelectBestServer(), server.GetEndpoint());
+    EXPECT_EQ(selector.SelectBestServer(), server.GetEndpoint());
+    EXPECT_EQ(server.GetProbeCount(), 1u);
+    EXPECT_EQ(selector.GetStatistics().probe_rounds, 1u);
+    EXPECT_EQ(selector.GetStatistics().cache_hits, 1u);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    EXPECT_EQ(selector.SelectBestServer(), server.GetEndpoint());
+    EXPECT_EQ(server.GetProbeCount(), 2u);
+
+    // An explicit refresh probes again without waiting for the TTL
+    selector.RefreshServerList();
+    selector.SelectBestServer();
+    EXPECT_EQ(selector.GetStatistics().probe_rounds, 3u);
+}
+
+TEST(RelayServerSelectorTest, FailsOverInRttOrder) {
+    EchoRelayServer first(std::chrono::milliseconds(0));
+    EchoRelayServer second(std::chrono::milliseconds(30));
+
+    RelayServerSelector selector({second.GetEndpoint(), first.GetEndpoint()}, FastProbeConfig());
+    ASSERT_EQ(selector.SelectBestServer(), first.GetEndpoint());
+
+    EXPECT_EQ(selector.GetNextAvailableServer(first.GetEndpoint()), second.GetEndpoint());
+    EXPECT_EQ(selector.SelectBestServer(), second.GetEndpoint());
+    EXPECT_EQ(selector.GetNextAvailableServer(second.GetEndpoint()), "");
+
+    // Answering a new probe round clears the unhealthy mark
+    selector.ProbeServers();
+    EXPECT_EQ(selector.SelectBestServer(), first.GetEndpoint());
+}
+
+TEST(RelayServerSelectorTest, FallsBackToConfiguredOrderWhenNothingAnswers) {
+    EchoRelayServer silent(std::chrono::milliseconds(0), false);
+    auto config = FastProbeConfig();
+    config.probe_deadline = std::chrono::milliseconds(50);
+    RelayServerSelector selector({silent.GetEndpoint(), "relay.invalid:9000"}, config);
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(selector.SelectBestServer(), silent.GetEndpoint());
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(1000));
+    EXPECT_EQ(selector.GetStatistics().probes_answered, 0u);
+}
+
+#endif // _WIN32
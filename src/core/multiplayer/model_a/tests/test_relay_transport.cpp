@@ -0,0 +1,190 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "../relay_transport.h"
+
+using namespace Core::Multiplayer;
+using namespace Core::Multiplayer::ModelA;
+
+#ifndef _WIN32
+
+namespace {
+
+/**
+ * Loopback UDP socket standing in for the relay server
+ */
+class LoopbackRelayServer {
+public:
+    LoopbackRelayServer() {
+        socket_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ::bind(socket_, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        socklen_t length = sizeof(address);
+        ::getsockname(socket_, reinterpret_cast<sockaddr*>(&address), &length);
+        port_ = ntohs(address.sin_port);
+
+        timeval timeout{2, 0};
+        ::setsockopt(socket_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    }
+
+    ~LoopbackRelayServer() {
+        ::close(socket_);
+    }
+
+    uint16_t GetPort() const { return port_; }
+
+    // Receives one datagram and remembers who sent it
+    std::vector<uint8_t> Receive(uint16_t& out_client_port) {
+        std::vector<uint8_t> buffer(2048);
+        sockaddr_in from{};
+        socklen_t length = sizeof(from);
+        const auto received = ::recvfrom(socket_, buffer.data(), buffer.size(), 0,
+                                         reinterpret_cast<sockaddr*>(&from), &length);
+        buffer.resize(received > 0 ? static_cast<size_t>(received) : 0);
+        last_client_ = from;
+        out_client_port = ntohs(from.sin_port);
+        return buffer;
+    }
+
+    void ReplyToLastClient(const std::vector<uint8_t>& datagram) {
+        ::sendto(socket_, datagram.data(), datagram.size(), 0,
+                 reinterpret_cast<const sockaddr*>(&last_client_), sizeof(last_client_));
+    }
+
+private:
+    int socket_ = -1;
+    uint16_t port_ = 0;
+    sockaddr_in last_client_{};
+};
+
+} // anonymous namespace
+
+TEST(UdpRelayTransportTest, SendsHeaderAndPayloadAsOneDatagram) {
+    LoopbackRelayServer server;
+    UdpRelayTransport transport;
+    ASSERT_TRUE(transport.Open("127.0.0.1", server.GetPort()));
+
+    RelayProtocol protocol;
+    const std::vector<uint8_t> payload{0xDE, 0xAD, 0xBE, 0xEF};
+    ASSERT_TRUE(transport.SendFrame(protocol.FrameDataMessage(0x1234, payload, 7)));
+
+    uint16_t client_port = 0;
+    const auto datagram = server.Receive(client_port);
+    RelayHeaderView header;
+    ASSERT_TRUE(protocol.ValidateMessage(datagram, &header));
+    EXPECT_EQ(header.session_token, 0x1234u);
+    EXPECT_EQ(header.sequence_num, 7u);
+    EXPECT_EQ(std::vector<uint8_t>(header.payload.begin(), header.payload.end()), payload);
+    EXPECT_EQ(client_port, transport.GetLocalPort());
+}
+
+TEST(UdpRelayTransportTest, DeliversIncomingDatagrams) {
+    LoopbackRelayServer server;
+    UdpRelayTransport transport;
+
+    std::mutex received_mutex;
+    std::vector<std::vector<uint8_t>> received;
+    transport.SetOnDatagramReceived([&](std::span<const uint8_t> datagram) {
+        std::lock_guard<std::mutex> lock(received_mutex);
+        received.emplace_back(datagram.begin(), datagram.end());
+    });
+    ASSERT_TRUE(transport.Open("127.0.0.1", server.GetPort()));
+
+    RelayProtocol protocol;
+    ASSERT_TRUE(transport.SendFrame(protocol.FrameDataMessage(1, std::vector<uint8_t>{1}, 0)));
+    uint16_t client_port = 0;
+    server.Receive(client_port);
+    const auto reply = protocol.CreateDataMessage(1, std::vector<uint8_t>{0x42}, 0);
+    server.ReplyToLastClient(reply);
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (std::chrono::steady_clock::now() < deadline) {
+        {
+            std::lock_guard<std::mutex> lock(received_mutex);
+            if (!received.empty()) {
+                break;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    std::lock_guard<std::mutex> lock(received_mutex);
+    ASSERT_EQ(received.size(), 1u);
+    EXPECT_EQ(received[0], reply);
+    EXPECT_EQ(transport.GetStatistics().datagrams_received, 1u);
+}
+
+TEST(UdpRelayTransportTest, MigrationMovesToNewLocalEndpoint) {
+    LoopbackRelayServer server;
+    UdpRelayTransport transport;
+    ASSERT_TRUE(transport.Open("127.0.0.1", server.GetPort()));
+    const uint16_t first_port = transport.GetLocalPort();
+
+    ASSERT_TRUE(transport.Migrate());
+    EXPECT_NE(transport.GetLocalPort(), first_port);
+    EXPECT_EQ(transport.GetStatistics().migrations, 1u);
+
+    // The session keeps going from the new endpoint
+    RelayProtocol protocol;
+    ASSERT_TRUE(transport.SendFrame(protocol.FrameDataMessage(9, std::vector<uint8_t>{9}, 1)));
+    uint16_t client_port = 0;
+    EXPECT_FALSE(server.Receive(client_port).empty());
+    EXPECT_EQ(client_port, transport.GetLocalPort());
+
+    transport.Close();
+    EXPECT_FALSE(transport.IsOpen());
+    EXPECT_FALSE(transport.SendFrame(protocol.FrameDataMessage(9, std::vector<uint8_t>{9}, 2)));
+}
+
+TEST(UdpRelayTransportTest, HostNamesResolveThroughTheCache) {
+    LoopbackRelayServer server;
+    std::atomic<int> queries{0};
+    auto resolver = std::make_shared<DnsResolver>(
+        DnsResolverConfig{}, [&queries](const std::string& host, DnsResolver::Family family) {
+            ++queries;
+            DatagramEndpoint loopback;
+            if (host == "relay.example" && family == DnsResolver::Family::IPv4) {
+                DatagramEndpoint::FromString("127.0.0.1", 0, loopback);
+                return DnsResolver::Addresses{loopback};
+            }
+            return DnsResolver::Addresses{};
+        });
+    UdpRelayTransport transport(SocketTuningProfile::Realtime(), resolver);
+    ASSERT_TRUE(transport.Open("relay.example", server.GetPort()));
+    EXPECT_EQ(queries.load(), 2);
+
+    RelayProtocol protocol;
+    ASSERT_TRUE(transport.SendFrame(protocol.FrameDataMessage(3, std::vector<uint8_t>{3}, 0)));
+    uint16_t client_port = 0;
+    EXPECT_FALSE(server.Receive(client_port).empty());
+
+    // A redirect back to a cached host needs no lookup; migrating looks up again
+    ASSERT_TRUE(transport.Redirect("relay.example", server.GetPort()));
+    EXPECT_EQ(queries.load(), 2);
+    // One replacement per receive poll, so wait for the redirect's to finish
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (!transport.Migrate() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(transport.GetStatistics().migrations, 1u);
+    EXPECT_EQ(queries.load(), 4);
+    EXPECT_FALSE(transport.Open("unknown.example", server.GetPort()));
+}
+
+#endif // _WIN32
@@ -0,0 +1,248 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <string>
+
+#include "../room_binary_codec.h"
+
+using namespace testing;
+using namespace Core::Multiplayer::ModelA;
+
+namespace {
+
+class RoomBinaryCodecTest : public Test {
+protected:
+    static RoomListResponse MakeRoomList() {
+        RoomListResponse response;
+        response.success = true;
+        response.total_count = 2;
+
+        RoomSummary first;
+        first.id = "room_1";
+        first.game_id = 0x0100152000022000ULL;
+        first.game_name = "Mario Kart 8 Deluxe";
+        first.host_name = "host";
+        first.current_players = 3;
+        first.max_players = 8;
+        first.ping = 42;
+        first.region = "eu";
+        response.rooms.push_back(first);
+
+        RoomSummary second;
+        second.id = "room_2";
+        second.game_name = "Splatoon 3";
+        second.current_players = 1;
+        second.max_players = 4;
+        second.ping = -1;
+        response.rooms.push_back(second);
+        return response;
+    }
+};
+
+TEST_F(RoomBinaryCodecTest, HeartbeatRoundTrip) {
+    const std::string frame = RoomBinaryCodec::EncodeHeartbeat(1700000000123ULL);
+    ASSERT_TRUE(RoomBinaryCodec::IsBinaryFrame(frame));
+    EXPECT_EQ(RoomBinaryCodec::PeekType(frame), MessageType::Heartbeat);
+
+    uint64_t timestamp = 0;
+    ASSERT_TRUE(RoomBinaryCodec::DecodeHeartbeat(frame, timestamp));
+    EXPECT_EQ(timestamp, 1700000000123ULL);
+}
+
+TEST_F(RoomBinaryCodecTest, RoomListResponseRoundTrip) {
+    const RoomListResponse original = MakeRoomList();
+    const std::string frame = RoomBinaryCodec::Encode(original);
+
+    RoomListResponse decoded;
+    ASSERT_TRUE(RoomBinaryCodec::Decode(frame, decoded));
+    EXPECT_TRUE(decoded.success);
+    EXPECT_EQ(decoded.total_count, 2);
+    ASSERT_EQ(decoded.rooms.size(), 2u);
+    EXPECT_EQ(decoded.rooms[0].id, "room_1");
+    EXPECT_EQ(decoded.rooms[0].game_id, 0x0100152000022000ULL);
+    EXPECT_EQ(decoded.rooms[0].game_name, "Mario Kart 8 Deluxe");
+    EXPECT_EQ(decoded.rooms[0].host_name, "host");
+    EXPECT_EQ(decoded.rooms[0].current_players, 3);
+    EXPECT_EQ(decoded.rooms[0].max_players, 8);
+    EXPECT_EQ(decoded.rooms[0].ping, 42);
+    EXPECT_EQ(decoded.rooms[0].region, "eu");
+    EXPECT_EQ(decoded.rooms[1].host_name, "");
+    EXPECT_EQ(decoded.rooms[1].ping, -1);
+}
+
+TEST_F(RoomBinaryCodecTest, RoomQueryPagesRoundTrip) {
+    RoomListRequest request;
+    request.game_id = 0x0100152000022000ULL;
+    request.region = "eu";
+    request.max_results = 50;
+    request.cursor = "opaque-cursor";
+    request.request_id = 7;
+
+    RoomListRequest decoded_request;
+    ASSERT_TRUE(RoomBinaryCodec::Decode(RoomBinaryCodec::Encode(request), decoded_request));
+    EXPECT_EQ(decoded_request.max_results, 50);
+    EXPECT_EQ(decoded_request.cursor, "opaque-cursor");
+    EXPECT_EQ(decoded_request.request_id, 7u);
+    EXPECT_FALSE(decoded_request.include_full);
+
+    RoomListResponse page = MakeRoomList();
+    page.request_id = 7;
+    page.next_cursor = "next";
+
+    RoomListResponse decoded_page;
+    ASSERT_TRUE(RoomBinaryCodec::Decode(RoomBinaryCodec::Encode(page), decoded_page));
+    EXPECT_EQ(decoded_page.request_id, 7u);
+    EXPECT_EQ(decoded_page.next_cursor, "next");
+    EXPECT_EQ(decoded_page.rooms.size(), 2u);
+}
+
+TEST_F(RoomBinaryCodecTest, RequestIdsRoundTrip) {
+    JoinRoomRequest join;
+    join.room_id = "room_1";
+    join.request_id = 41;
+    JoinRoomRequest decoded_join;
+    ASSERT_TRUE(RoomBinaryCodec::Decode(RoomBinaryCodec::Encode(join), decoded_join));
+    EXPECT_EQ(decoded_join.request_id, 41u);
+
+    RoomCreatedResponse created;
+    created.success = true;
+    created.request_id = 42;
+    RoomCreatedResponse decoded_created;
+    ASSERT_TRUE(RoomBinaryCodec::Decode(RoomBinaryCodec::Encode(created), decoded_created));
+    EXPECT_EQ(decoded_created.request_id, 42u);
+
+    ErrorMessage error;
+    error.error_code = "room_full";
+    error.request_id = 41;
+    ErrorMessage decoded_error;
+    ASSERT_TRUE(RoomBinaryCodec::Decode(RoomBinaryCodec::Encode(error), decoded_error));
+    EXPECT_EQ(decoded_error.request_id, 41u);
+}
+
+TEST_F(RoomBinaryCodecTest, JoinResponseResumeTokenRoundTrip) {
+    JoinRoomResponse join;
+    join.success = true;
+    join.room_id = "room_1";
+    join.resume_token = "resume-abc";
+    JoinRoomResponse decoded;
+    ASSERT_TRUE(RoomBinaryCodec::Decode(RoomBinaryCodec::Encode(join), decoded));
+    EXPECT_EQ(decoded.resume_token, "resume-abc");
+
+    join.resume_token.clear();
+    ASSERT_TRUE(RoomBinaryCodec::Decode(RoomBinaryCodec::Encode(join), decoded));
+    EXPECT_TRUE(decoded.resume_token.empty());
+}
+
+TEST_F(RoomBinaryCodecTest, NestedMessagesRoundTrip) {
+    JoinRoomResponse join;
+    join.success = true;
+    join.room_id = "room_1";
+    join.player_id = "player_2";
+    PlayerInfo player;
+    player.id = "player_1";
+    player.username = "host";
+    player.is_host = true;
+    player.network_info.public_ip = "203.0.113.5";
+    player.network_info.port = 4242;
+    join.players.push_back(player);
+
+    JoinRoomResponse decoded_join;
+    ASSERT_TRUE(RoomBinaryCodec::Decode(RoomBinaryCodec::Encode(join), decoded_join));
+    ASSERT_EQ(decoded_join.players.size(), 1u);
+    EXPECT_TRUE(decoded_join.players[0].is_host);
+    EXPECT_EQ(decoded_join.players[0].network_info.public_ip, "203.0.113.5");
+    EXPECT_EQ(decoded_join.players[0].network_info.port, 4242);
+
+    ErrorMessage error;
+    error.error_code = "room_full";
+    error.message = "Room is full";
+    error.details["room_id"] = "room_1";
+    error.retry_after = 30;
+
+    ErrorMessage decoded_error;
+    ASSERT_TRUE(RoomBinaryCodec::Decode(RoomBinaryCodec::Encode(error), decoded_error));
+    EXPECT_EQ(decoded_error.error_code, "room_full");
+    EXPECT_EQ(decoded_error.details.at("room_id"), "room_1");
+    EXPECT_EQ(decoded_error.retry_after, 30u);
+}
+
+TEST_F(RoomBinaryCodecTest, TrickledCandidatesRoundTrip) {
+    P2PInfoMessage message;
+    message.from_player = "player_1";
+    message.to_player = "player_2";
+    message.connection_type = "direct";
+    message.ice_candidates.push_back(
+        {"candidate:2 1 UDP 1686052607 203.0.113.5 61000 typ srflx", "0", 0});
+
+    P2PInfoMessage decoded;
+    ASSERT_TRUE(RoomBinaryCodec::Decode(RoomBinaryCodec::Encode(message), decoded));
+    ASSERT_EQ(decoded.ice_candidates.size(), 1u);
+    EXPECT_EQ(decoded.ice_candidates[0].candidate, message.ice_candidates[0].candidate);
+    EXPECT_TRUE(decoded.session_description.type.empty());
+    EXPECT_FALSE(decoded.end_of_candidates);
+
+    message.ice_candidates.clear();
+    message.end_of_candidates = true;
+    ASSERT_TRUE(RoomBinaryCodec::Decode(RoomBinaryCodec::Encode(message), decoded));
+    EXPECT_TRUE(decoded.ice_candidates.empty());
+    EXPECT_TRUE(decoded.end_of_candidates);
+}
+
+TEST_F(RoomBinaryCodecTest, DefaultsAreOmittedAndRestored) {
+    CreateRoomRequest request;
+    request.game_id = 0x0100152000022000ULL;
+    request.max_players = 0;
+
+    CreateRoomRequest decoded;
+    ASSERT_TRUE(RoomBinaryCodec::Decode(RoomBinaryCodec::Encode(request), decoded));
+    EXPECT_EQ(decoded.game_id, request.game_id);
+    EXPECT_EQ(decoded.max_players, 0);
+    EXPECT_FALSE(decoded.is_private);
+}
+
+TEST_F(RoomBinaryCodecTest, UnknownFieldsAreSkipped) {
+    PlayerLeftMessage message;
+    message.room_id = "room_1";
+    message.player_id = "player_3";
+    std::string frame = RoomBinaryCodec::Encode(message);
+
+    // Append a field with a tag the decoder does not know about
+    frame += std::string("\x7F\x03xyz", 5);
+
+    PlayerLeftMessage decoded;
+    ASSERT_TRUE(RoomBinaryCodec::Decode(frame, decoded));
+    EXPECT_EQ(decoded.room_id, "room_1");
+    EXPECT_EQ(decoded.player_id, "player_3");
+}
+
+TEST_F(RoomBinaryCodecTest, MalformedFramesAreRejected) {
+    const std::string frame = RoomBinaryCodec::Encode(MakeRoomList());
+
+    RoomListResponse decoded;
+    EXPECT_FALSE(RoomBinaryCodec::Decode(frame.substr(0, frame.size() - 3), decoded));
+    EXPECT_FALSE(RoomBinaryCodec::Decode(frame.substr(0, 2), decoded));
+
+    std::string wrong_version = frame;
+    wrong_version[1] = static_cast<char>(RoomBinaryCodec::FORMAT_VERSION + 1);
+    EXPECT_EQ(RoomBinaryCodec::PeekType(wrong_version), MessageType::Unknown);
+    EXPECT_FALSE(RoomBinaryCodec::Decode(wrong_version, decoded));
+
+    // A valid frame of a different type must not decode as this one
+    PlayerLeftMessage left;
+    EXPECT_FALSE(RoomBinaryCodec::Decode(frame, left));
+}
+
+TEST_F(RoomBinaryCodecTest, JsonIsNotMistakenForBinary) {
+    EXPECT_FALSE(RoomBinaryCodec::IsBinaryFrame("{\"type\":\"heartbeat\"}"));
+    EXPECT_FALSE(RoomBinaryCodec::IsBinaryFrame(""));
+    EXPECT_EQ(RoomBinaryCodec::PeekType("{\"type\":\"error\"}"), MessageType::Unknown);
+}
+
+TEST_F(RoomBinaryCodecTest, BinaryIsSmallerThanJson) {
+    const std::string frame = RoomBinaryCodec::EncodeHeartbeat(1700000000123ULL);
+    const std::string json = "{\"type\":\"heartbeat\",\"timestamp\":1700000000123}";
+    EXPECT_LT(frame.size(), json.size() / 3);
+}
+
+} // namespace
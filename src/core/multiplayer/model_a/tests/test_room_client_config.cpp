@@ -0,0 +1,200 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "../room_client.h"
+
+using namespace Core::Multiplayer;
+using namespace Core::Multiplayer::ModelA;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Reconnects on everything but authentication failures, and counts the
+// questions asked about it
+class FakeConfigProvider : public IConfigProvider {
+public:
+    std::string GetRoomServerUrl() const override { return "wss://rooms.example"; }
+    std::string GetAuthToken() const override { return "token"; }
+    std::chrono::milliseconds GetConnectionTimeout() const override { return 2000ms; }
+    std::chrono::milliseconds GetHeartbeatInterval() const override { return 5000ms; }
+    std::chrono::milliseconds GetMessageTimeout() const override { return 3000ms; }
+    bool IsAutoReconnectEnabled() const override { return auto_reconnect; }
+    int GetMaxReconnectAttempts() const override { return 4; }
+    std::chrono::milliseconds GetReconnectBaseDelay() const override { return base_delay; }
+    double GetReconnectBackoffMultiplier() const override { return 2.0; }
+    std::chrono::milliseconds GetMaxReconnectDelay() const override { return 60000ms; }
+    bool ShouldReconnectOnError(const std::string& error_type) const override {
+        ++error_questions;
+        return error_type != "AUTH_FAILED";
+    }
+    int GetMaxConcurrentMessages() const override { return 8; }
+    size_t GetMessageQueueSize() const override { return 64; }
+    uint64_t GetReconnectJitterSeed() const override { return jitter_seed; }
+
+    bool auto_reconnect = false;
+    std::chrono::milliseconds base_delay = 1000ms;
+    uint64_t jitter_seed = 0;
+    mutable std::atomic<int> error_questions{0};
+};
+
+} // namespace
+
+TEST(RoomClientConfigTest, ErrorsAreClassifiedByName) {
+    EXPECT_EQ(ClassifyRoomError("NETWORK_ERROR"), RoomErrorType::Network);
+    EXPECT_EQ(ClassifyRoomError("TIMEOUT"), RoomErrorType::Timeout);
+    EXPECT_EQ(ClassifyRoomError("AUTH_FAILED"), RoomErrorType::Auth);
+    EXPECT_EQ(ClassifyRoomError("PROTOCOL_ERROR"), RoomErrorType::Protocol);
+    EXPECT_EQ(ClassifyRoomError("SERVER_CLOSED"), RoomErrorType::ServerClosed);
+    EXPECT_EQ(ClassifyRoomError("Connection reset by peer"), RoomErrorType::Other);
+}
+
+TEST(RoomClientConfigTest, SnapshotAsksAboutEachErrorKindOnce) {
+    FakeConfigProvider provider;
+    const auto config = RoomClientConfig::FromProvider(provider);
+    EXPECT_EQ(provider.error_questions.load(), 6);
+
+    EXPECT_EQ(config.connection_timeout, 2000ms);
+    EXPECT_EQ(config.heartbeat_interval, 5000ms);
+    EXPECT_EQ(config.max_heartbeat_interval, 5000ms);
+    EXPECT_EQ(config.max_concurrent_messages, 8);
+    EXPECT_EQ(config.message_queue_size, 64u);
+    EXPECT_EQ(config.max_reconnect_attempts, 4);
+    EXPECT_TRUE(config.ShouldReconnectOn(RoomErrorType::Network));
+    EXPECT_TRUE(config.ShouldReconnectOn(RoomErrorType::Other));
+    EXPECT_FALSE(config.ShouldReconnectOn(RoomErrorType::Auth));
+}
+
+TEST(RoomClientConfigTest, ClientReadsTheSnapshotUntilReloaded) {
+    auto provider = std::make_shared<FakeConfigProvider>();
+    RoomClient client(nullptr, provider);
+    EXPECT_EQ(provider->error_questions.load(), 6);
+
+    // Handling an error no longer goes back to the provider
+    client.OnWebSocketError("AUTH_FAILED");
+    EXPECT_FALSE(client.IsReconnecting());
+    EXPECT_EQ(provider->error_questions.load(), 6);
+
+    provider->base_delay = 8000ms;
+    EXPECT_LE(client.CalculateReconnectDelay(1), 1250ms);
+    const auto before = client.GetConfig();
+    client.ReloadConfig();
+    EXPECT_NE(client.GetConfig(), before);
+    EXPECT_GE(client.CalculateReconnectDelay(1), 6000ms);
+    EXPECT_EQ(provider->error_questions.load(), 12);
+}
+
+TEST(RoomClientConfigTest, DefaultsApplyWithoutAProvider) {
+    RoomClient client(nullptr, nullptr);
+    const auto config = client.GetConfig();
+    ASSERT_NE(config, nullptr);
+    EXPECT_FALSE(config->auto_reconnect);
+    EXPECT_EQ(config->reconnect_error_mask, 0u);
+    EXPECT_EQ(client.GetHeartbeatInterval(), 30000ms);
+}
+
+TEST(RoomClientConfigTest, ReconnectionHistoryKeepsTheLatestOutages) {
+    auto provider = std::make_shared<FakeConfigProvider>();
+    provider->auto_reconnect = true;
+    provider->base_delay = 60000ms; // No attempt fires on its own
+    RoomClient client(nullptr, provider);
+
+    const size_t outages = RECONNECTION_HISTORY_SIZE + 8;
+    for (size_t i = 0; i < outages; ++i) {
+        client.OnWebSocketError(i % 2 == 0 ? "NETWORK_ERROR" : "TIMEOUT");
+        ASSERT_TRUE(client.IsReconnecting());
+        client.OnWebSocketConnected();
+    }
+
+    const auto stats = client.GetReconnectionStatistics();
+    EXPECT_EQ(stats.successful_reconnections, static_cast<int>(outages));
+    EXPECT_EQ(stats.reconnect_time.count, outages);
+    EXPECT_EQ(stats.recent_event_count, RECONNECTION_HISTORY_SIZE);
+    for (size_t i = 1; i < stats.recent_event_count; ++i) {
+        EXPECT_LE(stats.recent_events[i - 1].lost_at, stats.recent_events[i].lost_at);
+    }
+    // The newest outage is last; the first eight have been overwritten
+    const auto& newest = stats.recent_events[RECONNECTION_HISTORY_SIZE - 1];
+    EXPECT_EQ(newest.cause, RoomErrorType::Timeout);
+    EXPECT_EQ(newest.outcome, ReconnectionEvent::Outcome::Reconnected);
+    EXPECT_EQ(newest.attempts, 1);
+    EXPECT_EQ(stats.recent_events[0].cause, RoomErrorType::Network);
+}
+
+TEST(RoomClientConfigTest, LaterReconnectDelaysAreDecorrelated) {
+    const ExponentialBackoff backoff(1000ms, 2.0, 30000ms);
+    for (int i = 0; i < 200; ++i) {
+        const auto delay = backoff.CalculateDecorrelatedDelay(4000ms);
+        EXPECT_GE(delay, 1000ms);
+        EXPECT_LE(delay, 12000ms);
+    }
+    EXPECT_LE(backoff.CalculateDecorrelatedDelay(20000ms), 30000ms);
+
+    // The first attempt still starts from the jittered base delay
+    RoomClient client(nullptr, std::make_shared<FakeConfigProvider>());
+    EXPECT_GE(client.CalculateReconnectDelay(1), 750ms);
+    EXPECT_LE(client.CalculateReconnectDelay(1), 1250ms);
+    EXPECT_LE(client.CalculateReconnectDelay(2, 1000ms), 3000ms);
+}
+
+TEST(RoomClientConfigTest, SeededJitterRepeatsAcrossClients) {
+    auto provider = std::make_shared<FakeConfigProvider>();
+    provider->jitter_seed = 99;
+    RoomClient first(nullptr, provider);
+    RoomClient second(nullptr, provider);
+
+    std::chrono::milliseconds previous{0};
+    for (int attempt = 1; attempt <= 20; ++attempt) {
+        const auto delay = first.CalculateReconnectDelay(attempt, previous);
+        EXPECT_EQ(second.CalculateReconnectDelay(attempt, previous), delay);
+        previous = delay;
+    }
+}
+
+TEST(RoomClientConfigTest, OutagesAreTimedOnTheWheelClock) {
+    const auto clock = std::make_shared<VirtualClock>();
+    auto provider = std::make_shared<FakeConfigProvider>();
+    provider->auto_reconnect = true;
+    provider->base_delay = 60000ms;
+    RoomClient client(nullptr, provider, std::make_shared<TimerWheel>(clock));
+
+    client.OnWebSocketError("NETWORK_ERROR");
+    ASSERT_TRUE(client.IsReconnecting());
+    clock->Advance(45s);
+    client.OnWebSocketConnected();
+
+    const auto stats = client.GetReconnectionStatistics();
+    ASSERT_EQ(stats.recent_event_count, 1u);
+    EXPECT_EQ(stats.recent_events[0].downtime, 45s);
+    EXPECT_EQ(stats.recent_events[0].lost_at, clock->WallNow() - 45s);
+}
+
+TEST(RoomClientConfigTest, ReconnectAttemptsShareTheProcessThrottle) {
+    auto provider = std::make_shared<FakeConfigProvider>();
+    provider->auto_reconnect = true;
+    provider->base_delay = 10ms;
+    const auto throttle =
+        std::make_shared<ReconnectThrottle>(ReconnectThrottleConfig{1.0, 0.5});
+
+    RoomClient first(nullptr, provider);
+    RoomClient second(nullptr, provider);
+    first.SetReconnectThrottle(throttle);
+    second.SetReconnectThrottle(throttle);
+    first.OnWebSocketError("NETWORK_ERROR");
+    second.OnWebSocketError("NETWORK_ERROR");
+    std::this_thread::sleep_for(200ms);
+
+    // One token between them: only one attempt went out, the other waits
+    EXPECT_EQ(first.GetReconnectionStatistics().total_attempts +
+                  second.GetReconnectionStatistics().total_attempts,
+              1);
+    EXPECT_GE(throttle->GetDeferredCount(), 1u);
+    first.Shutdown();
+    second.Shutdown();
+}
@@ -0,0 +1,167 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "../room_binary_codec.h"
+#include "../room_client.h"
+
+using namespace Core::Multiplayer;
+using namespace Core::Multiplayer::ModelA;
+using namespace std::chrono_literals;
+
+namespace {
+
+class FakeConfigProvider : public IConfigProvider {
+public:
+    std::string GetRoomServerUrl() const override { return "wss://rooms.example"; }
+    std::string GetAuthToken() const override { return "token"; }
+    std::chrono::milliseconds GetConnectionTimeout() const override { return 2000ms; }
+    std::chrono::milliseconds GetHeartbeatInterval() const override { return 5000ms; }
+    std::chrono::milliseconds GetMessageTimeout() const override { return 3000ms; }
+    bool IsAutoReconnectEnabled() const override { return false; }
+    int GetMaxReconnectAttempts() const override { return 0; }
+    std::chrono::milliseconds GetReconnectBaseDelay() const override { return 1000ms; }
+    double GetReconnectBackoffMultiplier() const override { return 2.0; }
+    std::chrono::milliseconds GetMaxReconnectDelay() const override { return 60000ms; }
+    bool ShouldReconnectOnError(const std::string&) const override { return false; }
+    int GetMaxConcurrentMessages() const override { return 8; }
+    size_t GetMessageQueueSize() const override { return 64; }
+    std::chrono::milliseconds GetMembershipBatchWindow() const override { return window; }
+
+    std::chrono::milliseconds window = 0ms;
+};
+
+// Records batches, or single callbacks when batching is left to the default
+class RecordingHandler : public IMessageHandler {
+public:
+    explicit RecordingHandler(bool batched) : batched_(batched) {}
+
+    void OnRoomCreated(const RoomCreatedResponse&) override {}
+    void OnRoomListUpdate(const RoomListResponse&) override {}
+    void OnJoinedRoom(const JoinRoomResponse&) override {}
+    void OnP2PInfoReceived(const P2PInfoMessage&) override {}
+    void OnUseProxyMessage(const UseProxyMessage&) override {}
+    void OnErrorReceived(const ErrorMessage&) override {
+        std::lock_guard lock(mutex);
+        log.push_back("error");
+    }
+    void OnPlayerJoined(const PlayerJoinedMessage& message) override {
+        std::lock_guard lock(mutex);
+        log.push_back("+" + message.player.id);
+    }
+    void OnPlayerLeft(const PlayerLeftMessage& message) override {
+        std::lock_guard lock(mutex);
+        log.push_back("-" + message.player_id);
+    }
+
+    void OnMembershipChanged(std::span<const MembershipChange> changes) override {
+        if (!batched_) {
+            IMessageHandler::OnMembershipChanged(changes);
+            return;
+        }
+        std::lock_guard lock(mutex);
+        std::string batch;
+        for (const auto& change : changes) {
+            batch += (change.kind == MembershipChange::Kind::Joined ? "+" : "-") +
+                     change.player.id;
+        }
+        log.push_back(batch);
+        cv.notify_all();
+    }
+
+    bool WaitForEntries(size_t count) {
+        std::unique_lock lock(mutex);
+        return cv.wait_for(lock, 2s, [&] { return log.size() >= count; });
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::string> log;
+
+private:
+    bool batched_;
+};
+
+std::string Joined(const std::string& player) {
+    return R"({"type":"player_joined","room_id":"room","player":{"id":")" + player +
+           R"(","username":"user"}})";
+}
+
+std::string Left(const std::string& player) {
+    return R"({"type":"player_left","room_id":"room","player_id":")" + player + R"("})";
+}
+
+} // anonymous namespace
+
+TEST(RoomClientMembershipTest, WithoutAWindowEachChangeIsDeliveredAtOnce) {
+    auto handler = std::make_shared<RecordingHandler>(false);
+    RoomClient client(nullptr, std::make_shared<FakeConfigProvider>());
+    client.SetMessageHandler(handler);
+
+    client.SimulateIncomingMessage(Joined("a"));
+    client.SimulateIncomingMessage(Left("a"));
+    EXPECT_EQ(handler->log, (std::vector<std::string>{"+a", "-a"}));
+}
+
+TEST(RoomClientMembershipTest, BurstsArriveAsOneBatchWithPairsCancelled) {
+    auto provider = std::make_shared<FakeConfigProvider>();
+    provider->window = 20ms;
+    auto handler = std::make_shared<RecordingHandler>(true);
+    RoomClient client(nullptr, provider);
+    client.SetMessageHandler(handler);
+
+    client.SimulateIncomingMessage(Left("old"));
+    client.SimulateIncomingMessage(Joined("a"));
+    client.SimulateIncomingMessage(Joined("b"));
+    client.SimulateIncomingMessage(Left("a")); // Cancels a's join
+    client.SimulateIncomingMessage(Joined("c"));
+    client.SimulateIncomingMessage(Joined("b")); // Replaces b's join in place
+    client.SimulateIncomingMessage(Joined("old"));
+
+    ASSERT_TRUE(handler->WaitForEntries(1));
+    EXPECT_EQ(handler->log, (std::vector<std::string>{"-old+b+c+old"}));
+}
+
+TEST(RoomClientMembershipTest, OtherMessagesFlushTheBatchFirst) {
+    auto provider = std::make_shared<FakeConfigProvider>();
+    provider->window = 10s;
+    auto handler = std::make_shared<RecordingHandler>(true);
+    RoomClient client(nullptr, provider);
+    client.SetMessageHandler(handler);
+
+    client.SimulateIncomingMessage(Joined("a"));
+    client.SimulateIncomingMessage(Joined("b"));
+    client.SimulateIncomingMessage(R"({"type":"error","error_code":"ROOM_FULL"})");
+    EXPECT_EQ(handler->log, (std::vector<std::string>{"+a+b", "error"}));
+}
+
+TEST(RoomClientMembershipTest, FragmentedFramesAreDecodedAsOneMessage) {
+    auto handler = std::make_shared<RecordingHandler>(false);
+    RoomClient client(nullptr, std::make_shared<FakeConfigProvider>());
+    client.SetMessageHandler(handler);
+
+    PlayerJoinedMessage joined;
+    joined.room_id = "room";
+    joined.player.id = "a";
+    const std::string binary = RoomBinaryCodec::Encode(joined);
+    const std::string json = Left("a");
+    const auto bytes = [](const std::string& message, size_t offset, size_t count) {
+        return std::span(reinterpret_cast<const uint8_t*>(message.data()) + offset, count);
+    };
+
+    const std::array binary_fragments{bytes(binary, 0, 2), bytes(binary, 2, binary.size() - 2)};
+    client.OnWebSocketMessage(WebSocketMessageView{WebSocketFrameType::Binary, binary_fragments});
+    const std::array json_fragments{bytes(json, 0, 10), bytes(json, 10, 0),
+                                    bytes(json, 10, json.size() - 10)};
+    client.OnWebSocketMessage(WebSocketMessageView{WebSocketFrameType::Text, json_fragments});
+    EXPECT_EQ(handler->log, (std::vector<std::string>{"+a", "-a"}));
+}
@@ -0,0 +1,175 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "../room_client.h"
+
+using namespace Core::Multiplayer;
+using namespace Core::Multiplayer::ModelA;
+using namespace std::chrono_literals;
+using json = nlohmann::json;
+
+namespace {
+
+// Reconnects, but never before a test has finished with the drop
+class FakeConfigProvider : public IConfigProvider {
+public:
+    std::string GetRoomServerUrl() const override { return "wss://rooms.example"; }
+    std::string GetAuthToken() const override { return "token"; }
+    std::chrono::milliseconds GetConnectionTimeout() const override { return 2000ms; }
+    std::chrono::milliseconds GetHeartbeatInterval() const override { return 5000ms; }
+    std::chrono::milliseconds GetMessageTimeout() const override { return 3000ms; }
+    bool IsAutoReconnectEnabled() const override { return true; }
+    int GetMaxReconnectAttempts() const override { return 5; }
+    std::chrono::milliseconds GetReconnectBaseDelay() const override { return 60000ms; }
+    double GetReconnectBackoffMultiplier() const override { return 2.0; }
+    std::chrono::milliseconds GetMaxReconnectDelay() const override { return 60000ms; }
+    bool ShouldReconnectOnError(const std::string&) const override { return false; }
+    int GetMaxConcurrentMessages() const override { return 8; }
+    size_t GetMessageQueueSize() const override { return 64; }
+};
+
+// Always connected; records what is sent
+class FakeConnection : public IWebSocketConnection {
+public:
+    void Connect(const std::string&) override {}
+    void Disconnect(const std::string&) override {}
+    bool IsConnected() const override { return true; }
+    std::string GetUri() const override { return "wss://rooms.example"; }
+    void SetAuthToken(const std::string&) override {}
+    void SendMessage(const std::string& message) override {
+        std::lock_guard lock(mutex);
+        sent.push_back(json::parse(message));
+    }
+    void SetOnMessageCallback(std::function<void(const std::string&)>) override {}
+    void SetOnConnectCallback(std::function<void()>) override {}
+    void SetOnDisconnectCallback(std::function<void(const std::string&)>) override {}
+    void SetOnErrorCallback(std::function<void(const std::string&)>) override {}
+
+    std::vector<json> TakeSent() {
+        std::lock_guard lock(mutex);
+        return std::exchange(sent, {});
+    }
+
+    std::mutex mutex;
+    std::vector<json> sent;
+};
+
+class ResumeHandler : public IMessageHandler {
+public:
+    void OnRoomCreated(const RoomCreatedResponse&) override {}
+    void OnRoomListUpdate(const RoomListResponse&) override {}
+    void OnJoinedRoom(const JoinRoomResponse&) override {}
+    void OnP2PInfoReceived(const P2PInfoMessage&) override {}
+    void OnUseProxyMessage(const UseProxyMessage&) override {}
+    void OnErrorReceived(const ErrorMessage&) override {}
+    void OnPlayerJoined(const PlayerJoinedMessage&) override {}
+    void OnPlayerLeft(const PlayerLeftMessage&) override {}
+    void OnSessionResumed(const ResumeResponse&) override {
+        ++resumed;
+    }
+
+    int resumed = 0;
+};
+
+// Registered with a token, in a room, and just back from a drop
+class RoomClientResumeTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        client_.SetMessageHandler(handler_);
+        client_.OnWebSocketConnected();
+        client_.SimulateIncomingMessage(json{{"type", "register_response"},
+                                             {"success", true},
+                                             {"resume_token", "tok_1"}}
+                                            .dump());
+        client_.SetCurrentRoomId("room_abc123");
+        client_.SetPlayerSlot(2);
+
+        client_.OnWebSocketDisconnected("connection lost");
+        connection_->TakeSent();
+        client_.OnWebSocketConnected();
+    }
+
+    std::shared_ptr<FakeConnection> connection_ = std::make_shared<FakeConnection>();
+    std::shared_ptr<ResumeHandler> handler_ = std::make_shared<ResumeHandler>();
+    RoomClient client_{connection_, std::make_shared<FakeConfigProvider>()};
+};
+
+} // anonymous namespace
+
+TEST(RoomClientResumeMessagesTest, ResumeRequestSerialization) {
+    json response_json = {{"type", "register_response"},
+                          {"success", true},
+                          {"client_id", "assigned_client_67890"},
+                          {"resume_token", "tok_4f2a"}};
+    const auto response = MessageDeserializer::Deserialize<RegisterResponse>(response_json.dump());
+
+    ResumeRequest request;
+    request.resume_token = response.resume_token;
+    request.client_id = response.client_id;
+    request.room_id = "room_abc123";
+    request.request_id = 3;
+
+    const auto parsed = json::parse(MessageSerializer::Serialize(request));
+    EXPECT_EQ(parsed["type"], "resume");
+    EXPECT_EQ(parsed["resume_token"], "tok_4f2a");
+    EXPECT_EQ(parsed["client_id"], "assigned_client_67890");
+    EXPECT_EQ(parsed["room_id"], "room_abc123");
+    EXPECT_EQ(parsed["request_id"], 3);
+
+    // Outside a room there is nothing to restore but the client id
+    request.room_id.clear();
+    EXPECT_FALSE(json::parse(MessageSerializer::Serialize(request)).contains("room_id"));
+}
+
+TEST_F(RoomClientResumeTest, ReconnectPresentsTheTokenInsteadOfRejoining) {
+    const auto sent = connection_->TakeSent();
+    ASSERT_EQ(sent.size(), 1u);
+    EXPECT_EQ(sent[0]["type"], "resume");
+    EXPECT_EQ(sent[0]["resume_token"], "tok_1");
+    EXPECT_EQ(sent[0]["client_id"], client_.GetClientId());
+    EXPECT_EQ(sent[0]["room_id"], "room_abc123");
+    EXPECT_TRUE(client_.IsResumingSession());
+
+    client_.SimulateIncomingMessage(json{{"type", "resume_response"},
+                                         {"success", true},
+                                         {"request_id", sent[0]["request_id"]},
+                                         {"room_id", "room_abc123"},
+                                         {"player_slot", 2},
+                                         {"resume_token", "tok_2"}}
+                                        .dump());
+    EXPECT_FALSE(client_.IsResumingSession());
+    EXPECT_EQ(handler_->resumed, 1);
+    EXPECT_EQ(client_.GetResumeToken(), "tok_2");
+    EXPECT_EQ(client_.GetCurrentRoomId(), "room_abc123");
+    EXPECT_EQ(client_.GetPlayerSlot(), 2);
+    EXPECT_TRUE(connection_->TakeSent().empty());
+}
+
+TEST_F(RoomClientResumeTest, RejectedTokenFallsBackToRejoining) {
+    const auto sent = connection_->TakeSent();
+    ASSERT_EQ(sent.size(), 1u);
+
+    client_.SimulateIncomingMessage(json{{"type", "resume_response"},
+                                         {"success", false},
+                                         {"request_id", sent[0]["request_id"]}}
+                                        .dump());
+    EXPECT_FALSE(client_.IsResumingSession());
+    EXPECT_EQ(handler_->resumed, 0);
+    EXPECT_TRUE(client_.GetResumeToken().empty());
+
+    const auto fallback = connection_->TakeSent();
+    ASSERT_EQ(fallback.size(), 1u);
+    EXPECT_EQ(fallback[0]["type"], "rejoin_room");
+    EXPECT_EQ(fallback[0]["room_id"], "room_abc123");
+}
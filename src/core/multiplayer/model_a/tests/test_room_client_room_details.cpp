@@ -0,0 +1,164 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "../room_client.h"
+
+using namespace Core::Multiplayer;
+using namespace Core::Multiplayer::ModelA;
+using namespace std::chrono_literals;
+using json = nlohmann::json;
+
+namespace {
+
+class FakeConfigProvider : public IConfigProvider {
+public:
+    std::string GetRoomServerUrl() const override { return "wss://rooms.example"; }
+    std::string GetAuthToken() const override { return "token"; }
+    std::chrono::milliseconds GetConnectionTimeout() const override { return 2000ms; }
+    std::chrono::milliseconds GetHeartbeatInterval() const override { return 5000ms; }
+    std::chrono::milliseconds GetMessageTimeout() const override { return 3000ms; }
+    bool IsAutoReconnectEnabled() const override { return false; }
+    int GetMaxReconnectAttempts() const override { return 0; }
+    std::chrono::milliseconds GetReconnectBaseDelay() const override { return 1000ms; }
+    double GetReconnectBackoffMultiplier() const override { return 2.0; }
+    std::chrono::milliseconds GetMaxReconnectDelay() const override { return 60000ms; }
+    bool ShouldReconnectOnError(const std::string&) const override { return false; }
+    int GetMaxConcurrentMessages() const override { return 8; }
+    size_t GetMessageQueueSize() const override { return 64; }
+};
+
+// Always connected; records what is sent
+class FakeConnection : public IWebSocketConnection {
+public:
+    void Connect(const std::string&) override {}
+    void Disconnect(const std::string&) override {}
+    bool IsConnected() const override { return true; }
+    std::string GetUri() const override { return "wss://rooms.example"; }
+    void SetAuthToken(const std::string&) override {}
+    void SendMessage(const std::string& message) override {
+        std::lock_guard lock(mutex);
+        sent.push_back(json::parse(message));
+    }
+    void SetOnMessageCallback(std::function<void(const std::string&)>) override {}
+    void SetOnConnectCallback(std::function<void()>) override {}
+    void SetOnDisconnectCallback(std::function<void(const std::string&)>) override {}
+    void SetOnErrorCallback(std::function<void(const std::string&)>) override {}
+
+    json Last() {
+        std::lock_guard lock(mutex);
+        return sent.empty() ? json::object() : sent.back();
+    }
+
+    std::mutex mutex;
+    std::vector<json> sent;
+};
+
+class DetailsHandler : public IMessageHandler {
+public:
+    void OnRoomCreated(const RoomCreatedResponse&) override {}
+    void OnRoomListUpdate(const RoomListResponse&) override {}
+    void OnJoinedRoom(const JoinRoomResponse&) override {}
+    void OnP2PInfoReceived(const P2PInfoMessage&) override {}
+    void OnUseProxyMessage(const UseProxyMessage&) override {}
+    void OnErrorReceived(const ErrorMessage&) override {}
+    void OnPlayerJoined(const PlayerJoinedMessage&) override {}
+    void OnPlayerLeft(const PlayerLeftMessage&) override {}
+    void OnRoomDetails(const RoomDetailsResponse& response) override {
+        details.push_back(response);
+    }
+
+    std::vector<RoomDetailsResponse> details;
+};
+
+std::string DetailsReply(uint32_t request_id, uint64_t version, size_t players) {
+    json reply = {{"type", "room_details_response"},
+                  {"success", true},
+                  {"version", version},
+                  {"request_id", request_id},
+                  {"room",
+                   {{"id", "room-1"},
+                    {"game_id", "0100000000010000"},
+                    {"host_id", "host"},
+                    {"current_players", players},
+                    {"description", "Casual"}}},
+                  {"players", json::array()}};
+    for (size_t i = 0; i < players; ++i) {
+        reply["players"].push_back({{"id", "p" + std::to_string(i)}, {"is_host", i == 0}});
+    }
+    return reply.dump();
+}
+
+} // anonymous namespace
+
+TEST(RoomClientRoomDetailsTest, DetailsAreCachedAndRevalidatedByVersion) {
+    auto connection = std::make_shared<FakeConnection>();
+    auto handler = std::make_shared<DetailsHandler>();
+    RoomClient client(connection, std::make_shared<FakeConfigProvider>());
+    client.SetMessageHandler(handler);
+    client.OnWebSocketConnected();
+
+    uint32_t request_id = 0;
+    ASSERT_EQ(client.GetRoomDetails("room-1", &request_id), ErrorCode::Success);
+    json request = connection->Last();
+    EXPECT_EQ(request["type"], "room_details");
+    EXPECT_EQ(request["room_id"], "room-1");
+    EXPECT_EQ(request["known_version"], 0);
+
+    client.SimulateIncomingMessage(DetailsReply(request_id, 4, 2));
+    ASSERT_EQ(handler->details.size(), 1u);
+    EXPECT_EQ(handler->details[0].room.game_id, 0x0100000000010000u);
+    EXPECT_EQ(handler->details[0].room.description, "Casual");
+    ASSERT_EQ(handler->details[0].players.size(), 2u);
+    EXPECT_TRUE(handler->details[0].players[0].is_host);
+    EXPECT_EQ(client.GetPendingRequestCount(), 0u);
+    ASSERT_TRUE(client.GetCachedRoomDetails("room-1"));
+    EXPECT_FALSE(client.GetCachedRoomDetails("room-2"));
+
+    // Asking again sends the cached version; not_modified is answered from the cache
+    ASSERT_EQ(client.GetRoomDetails("room-1", &request_id), ErrorCode::Success);
+    EXPECT_EQ(connection->Last()["known_version"], 4);
+    client.SimulateIncomingMessage(json{{"type", "room_details_response"},
+                                        {"success", true},
+                                        {"not_modified", true},
+                                        {"version", 4},
+                                        {"request_id", request_id}}
+                                       .dump());
+    ASSERT_EQ(handler->details.size(), 2u);
+    EXPECT_TRUE(handler->details[1].not_modified);
+    EXPECT_EQ(handler->details[1].request_id, request_id);
+    EXPECT_EQ(handler->details[1].players.size(), 2u);
+
+    // Another room has no version to offer
+    ASSERT_EQ(client.GetRoomDetails("room-2"), ErrorCode::Success);
+    EXPECT_EQ(connection->Last()["known_version"], 0);
+}
+
+TEST(RoomClientRoomDetailsTest, RemovedRoomDropsTheCache) {
+    auto connection = std::make_shared<FakeConnection>();
+    auto handler = std::make_shared<DetailsHandler>();
+    RoomClient client(connection, std::make_shared<FakeConfigProvider>());
+    client.SetMessageHandler(handler);
+    client.OnWebSocketConnected();
+
+    ASSERT_EQ(client.SubscribeRoomList({}), ErrorCode::Success);
+    client.SimulateIncomingMessage(R"({"type":"room_list_delta","snapshot":true,"version":1,)"
+                                   R"("rooms":[{"id":"room-1"}],"removed":[]})");
+    uint32_t request_id = 0;
+    ASSERT_EQ(client.GetRoomDetails("room-1", &request_id), ErrorCode::Success);
+    client.SimulateIncomingMessage(DetailsReply(request_id, 1, 1));
+    ASSERT_TRUE(client.GetCachedRoomDetails("room-1"));
+
+    client.SimulateIncomingMessage(R"({"type":"room_list_delta","base_version":1,"version":2,)"
+                                   R"("rooms":[],"removed":["room-1"]})");
+    EXPECT_FALSE(client.GetCachedRoomDetails("room-1"));
+}
@@ -0,0 +1,197 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "../room_client.h"
+
+using namespace Core::Multiplayer;
+using namespace Core::Multiplayer::ModelA;
+using namespace std::chrono_literals;
+using json = nlohmann::json;
+
+namespace {
+
+class FakeConfigProvider : public IConfigProvider {
+public:
+    std::string GetRoomServerUrl() const override { return "wss://rooms.example"; }
+    std::string GetAuthToken() const override { return "token"; }
+    std::chrono::milliseconds GetConnectionTimeout() const override { return 2000ms; }
+    std::chrono::milliseconds GetHeartbeatInterval() const override { return 5000ms; }
+    std::chrono::milliseconds GetMessageTimeout() const override { return 3000ms; }
+    bool IsAutoReconnectEnabled() const override { return false; }
+    int GetMaxReconnectAttempts() const override { return 0; }
+    std::chrono::milliseconds GetReconnectBaseDelay() const override { return 1000ms; }
+    double GetReconnectBackoffMultiplier() const override { return 2.0; }
+    std::chrono::milliseconds GetMaxReconnectDelay() const override { return 60000ms; }
+    bool ShouldReconnectOnError(const std::string&) const override { return false; }
+    int GetMaxConcurrentMessages() const override { return 8; }
+    size_t GetMessageQueueSize() const override { return 64; }
+};
+
+// Always connected; records what is sent
+class FakeConnection : public IWebSocketConnection {
+public:
+    void Connect(const std::string&) override {}
+    void Disconnect(const std::string&) override {}
+    bool IsConnected() const override { return true; }
+    std::string GetUri() const override { return "wss://rooms.example"; }
+    void SetAuthToken(const std::string&) override {}
+    void SendMessage(const std::string& message) override {
+        std::lock_guard lock(mutex);
+        sent.push_back(json::parse(message));
+    }
+    void SetOnMessageCallback(std::function<void(const std::string&)>) override {}
+    void SetOnConnectCallback(std::function<void()>) override {}
+    void SetOnDisconnectCallback(std::function<void(const std::string&)>) override {}
+    void SetOnErrorCallback(std::function<void(const std::string&)>) override {}
+
+    json Last() {
+        std::lock_guard lock(mutex);
+        return sent.empty() ? json::object() : sent.back();
+    }
+
+    std::mutex mutex;
+    std::vector<json> sent;
+};
+
+// Keeps the pages of room queries; everything else is ignored
+class QueryPageHandler : public IMessageHandler {
+public:
+    void OnRoomCreated(const RoomCreatedResponse&) override {}
+    void OnRoomListUpdate(const RoomListResponse&) override {}
+    void OnJoinedRoom(const JoinRoomResponse&) override {}
+    void OnP2PInfoReceived(const P2PInfoMessage&) override {}
+    void OnUseProxyMessage(const UseProxyMessage&) override {}
+    void OnErrorReceived(const ErrorMessage&) override {}
+    void OnPlayerJoined(const PlayerJoinedMessage&) override {}
+    void OnPlayerLeft(const PlayerLeftMessage&) override {}
+    void OnRoomQueryPage(const RoomListResponse& page, bool last_page) override {
+        pages.push_back(page);
+        last.push_back(last_page);
+    }
+
+    std::vector<RoomListResponse> pages;
+    std::vector<bool> last;
+};
+
+} // anonymous namespace
+
+TEST(RoomClientRoomListTest, RoomListRequestPageSerialization) {
+    RoomListRequest request;
+    request.max_results = 50;
+    request.cursor = "eyJyb29tIjoiYWJjIn0";
+    request.request_id = 12;
+
+    const auto parsed = json::parse(MessageSerializer::Serialize(request));
+    EXPECT_EQ(parsed["cursor"], "eyJyb29tIjoiYWJjIn0");
+    EXPECT_EQ(parsed["request_id"], 12);
+
+    // Untracked requests keep their original shape
+    const auto plain = json::parse(MessageSerializer::Serialize(RoomListRequest{}));
+    EXPECT_FALSE(plain.contains("cursor"));
+    EXPECT_FALSE(plain.contains("request_id"));
+}
+
+TEST(RoomClientRoomListTest, QueryPagesAreRequestedUntilTheCursorRunsOut) {
+    auto connection = std::make_shared<FakeConnection>();
+    auto handler = std::make_shared<QueryPageHandler>();
+    RoomClient client(connection, std::make_shared<FakeConfigProvider>());
+    client.SetMessageHandler(handler);
+    client.OnWebSocketConnected();
+
+    RoomListRequest request;
+    request.game_id = 0x0100152000022000ULL;
+    request.max_results = 2;
+    uint32_t query_id = 0;
+    ASSERT_EQ(client.StartRoomQuery(request, 0, &query_id), ErrorCode::Success);
+    const auto first = connection->Last();
+    EXPECT_EQ(first["type"], "room_list");
+    EXPECT_EQ(first["request_id"], query_id);
+    EXPECT_FALSE(first.contains("cursor"));
+
+    // The next page goes out as soon as this one arrives
+    client.SimulateIncomingMessage(json{{"type", "room_list_response"},
+                                        {"success", true},
+                                        {"request_id", query_id},
+                                        {"rooms", {{{"id", "room-1"}}, {{"id", "room-2"}}}},
+                                        {"next_cursor", "page-2"}}
+                                       .dump());
+    const auto second = connection->Last();
+    EXPECT_EQ(second["cursor"], "page-2");
+    EXPECT_EQ(second["request_id"], query_id);
+    EXPECT_EQ(second["game_id"], "0100152000022000");
+
+    client.SimulateIncomingMessage(json{{"type", "room_list_response"},
+                                        {"success", true},
+                                        {"request_id", query_id},
+                                        {"rooms", {{{"id", "room-3"}}}}}
+                                       .dump());
+    ASSERT_EQ(handler->pages.size(), 2u);
+    EXPECT_EQ(handler->pages[0].rooms.size(), 2u);
+    EXPECT_EQ(handler->pages[1].rooms[0].id, "room-3");
+    EXPECT_EQ(handler->last, (std::vector<bool>{false, true}));
+    EXPECT_EQ(connection->sent.size(), 2u);
+    EXPECT_EQ(client.GetPendingRequestCount(), 0u);
+}
+
+TEST(RoomClientRoomListTest, QueryStopsAtMaxRooms) {
+    auto connection = std::make_shared<FakeConnection>();
+    auto handler = std::make_shared<QueryPageHandler>();
+    RoomClient client(connection, std::make_shared<FakeConfigProvider>());
+    client.SetMessageHandler(handler);
+    client.OnWebSocketConnected();
+
+    RoomListRequest request;
+    request.max_results = 10;
+    uint32_t query_id = 0;
+    ASSERT_EQ(client.StartRoomQuery(request, 3, &query_id), ErrorCode::Success);
+    EXPECT_EQ(connection->Last()["max_results"], 3);
+
+    // Extra rooms past the limit are cut, and no further page is asked for
+    client.SimulateIncomingMessage(
+        json{{"type", "room_list_response"},
+             {"success", true},
+             {"request_id", query_id},
+             {"rooms", {{{"id", "a"}}, {{"id", "b"}}, {{"id", "c"}}, {{"id", "d"}}}},
+             {"next_cursor", "more"}}
+            .dump());
+    ASSERT_EQ(handler->pages.size(), 1u);
+    EXPECT_EQ(handler->pages[0].rooms.size(), 3u);
+    EXPECT_EQ(handler->last, (std::vector<bool>{true}));
+    EXPECT_EQ(connection->sent.size(), 1u);
+}
+
+TEST(RoomClientRoomListTest, DeltasAfterTheSnapshotAreApplied) {
+    auto connection = std::make_shared<FakeConnection>();
+    RoomClient client(connection, std::make_shared<FakeConfigProvider>());
+    client.OnWebSocketConnected();
+
+    ASSERT_EQ(client.SubscribeRoomList({}), ErrorCode::Success);
+    EXPECT_EQ(connection->Last()["type"], "room_list_subscribe");
+
+    // Deltas are ignored until the snapshot they build on arrives
+    client.SimulateIncomingMessage(R"({"type":"room_list_delta","base_version":1,"version":2,)"
+                                   R"("rooms":[{"id":"early"}],"removed":[]})");
+    EXPECT_TRUE(client.QueryRooms({}).empty());
+
+    client.SimulateIncomingMessage(R"({"type":"room_list_delta","snapshot":true,"version":1,)"
+                                   R"("rooms":[{"id":"room-1"}],"removed":[]})");
+    ASSERT_EQ(client.QueryRooms({}).size(), 1u);
+    EXPECT_EQ(client.GetRoomListVersion(), 1u);
+
+    client.SimulateIncomingMessage(R"({"type":"room_list_delta","base_version":1,"version":2,)"
+                                   R"("rooms":[{"id":"room-2"}],"removed":["room-1"]})");
+    const auto rooms = client.QueryRooms({});
+    ASSERT_EQ(rooms.size(), 1u);
+    EXPECT_EQ(rooms[0].id, "room-2");
+    EXPECT_EQ(client.GetRoomListVersion(), 2u);
+}
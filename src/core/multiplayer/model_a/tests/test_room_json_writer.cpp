@@ -0,0 +1,94 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+#include <string>
+
+#include "../room_json_writer.h"
+
+using namespace Core::Multiplayer::ModelA;
+
+namespace {
+
+// Every escape nlohmann makes, plus multi-byte UTF-8 that it leaves alone
+const std::string kAwkward = "q\"b\\s/\b\f\n\r\t\x01\x1f\x7f caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x8E\xAE";
+
+std::string WithoutTimestamp(std::string_view message) {
+    auto parsed = nlohmann::json::parse(message);
+    parsed.erase("timestamp");
+    return parsed.dump();
+}
+
+} // anonymous namespace
+
+TEST(RoomJsonWriterTest, MatchesTheSerializerByteForByte) {
+    RoomJsonWriter writer;
+
+    CreateRoomRequest create;
+    create.game_id = 0x0100152000022000ULL;
+    create.game_name = kAwkward;
+    create.max_players = 8;
+    create.is_private = true;
+    create.password = "";
+    create.description = kAwkward;
+    EXPECT_EQ(writer.Write(create), MessageSerializer::Serialize(create));
+    create.request_id = 7;
+    EXPECT_EQ(writer.Write(create), MessageSerializer::Serialize(create));
+
+    RoomListRequest list;
+    list.region = "eu";
+    list.offset = -1;
+    EXPECT_EQ(writer.Write(list), MessageSerializer::Serialize(list));
+    list.cursor = kAwkward;
+    list.request_id = 4294967295u;
+    EXPECT_EQ(writer.Write(list), MessageSerializer::Serialize(list));
+
+    JoinRoomRequest join;
+    join.room_id = "room_1";
+    join.client_info.username = kAwkward;
+    join.client_info.platform = "Linux";
+    join.client_info.network_info.local_ip = "192.168.1.2";
+    join.client_info.network_info.port = 65535;
+    EXPECT_EQ(writer.Write(join), MessageSerializer::Serialize(join));
+    join.spectator = true;
+    join.request_id = 3;
+    EXPECT_EQ(writer.Write(join), MessageSerializer::Serialize(join));
+
+    ResumeRequest resume;
+    resume.resume_token = "token";
+    resume.client_id = "client";
+    EXPECT_EQ(writer.Write(resume), MessageSerializer::Serialize(resume));
+    resume.room_id = "room_1";
+    resume.request_id = 9;
+    EXPECT_EQ(writer.Write(resume), MessageSerializer::Serialize(resume));
+
+    // Only the clock differs between two register messages
+    RegisterRequest reg;
+    reg.client_id = "client";
+    reg.username = kAwkward;
+    reg.platform = "Windows";
+    reg.sudachi_version = "1.0.0";
+    reg.request_id = 1;
+    const auto written = writer.Write(reg);
+    ASSERT_TRUE(written.has_value());
+    EXPECT_EQ(WithoutTimestamp(*written), WithoutTimestamp(MessageSerializer::Serialize(reg)));
+    EXPECT_EQ(written->find("\"timestamp\":"), written->find("\"sudachi_version\":\"1.0.0\",") + 26);
+}
+
+TEST(RoomJsonWriterTest, RejectsMalformedUtf8LikeTheSerializer) {
+    RoomJsonWriter writer;
+    for (const std::string bad : {"\x80", "\xC0\xAF", "\xE0\x80\xAF", "\xED\xA0\x80",
+                                  "\xF4\x90\x80\x80", "\xF0\x9F\x8E"}) {
+        JoinRoomRequest join;
+        join.room_id = bad;
+        EXPECT_FALSE(writer.Write(join).has_value());
+        EXPECT_THROW(MessageSerializer::Serialize(join), nlohmann::json::type_error);
+    }
+}
+
+TEST(RoomJsonWriterTest, HeartbeatKeepsItsFieldOrder) {
+    RoomJsonWriter writer;
+    EXPECT_EQ(writer.WriteHeartbeat(1641024000000),
+              R"({"type":"heartbeat","timestamp":1641024000000})");
+}
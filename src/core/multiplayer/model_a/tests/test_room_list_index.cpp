@@ -0,0 +1,167 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "../room_list_index.h"
+#include "../room_messages.h"
+
+using namespace Core::Multiplayer::ModelA;
+
+namespace {
+
+RoomSummary Room(const std::string& id, uint64_t game_id, int current, int max,
+                 const std::string& region = "eu", int ping = 50) {
+    RoomSummary room;
+    room.id = id;
+    room.game_id = game_id;
+    room.game_name = "Game " + std::to_string(game_id);
+    room.current_players = current;
+    room.max_players = max;
+    room.region = region;
+    room.ping = ping;
+    return room;
+}
+
+RoomListDelta Snapshot(uint64_t version, std::vector<RoomSummary> rooms) {
+    RoomListDelta delta;
+    delta.snapshot = true;
+    delta.version = version;
+    delta.upserted = std::move(rooms);
+    return delta;
+}
+
+std::vector<std::string> Ids(const std::vector<RoomSummary>& rooms) {
+    std::vector<std::string> ids;
+    for (const auto& room : rooms) {
+        ids.push_back(room.id);
+    }
+    return ids;
+}
+
+} // anonymous namespace
+
+TEST(RoomListIndexTest, SnapshotReplacesTheList) {
+    RoomListIndex index;
+    ASSERT_EQ(index.Apply(Snapshot(3, {Room("a", 1, 1, 4), Room("b", 2, 2, 2)})),
+              RoomListIndex::ApplyResult::Applied);
+    EXPECT_EQ(index.GetVersion(), 3u);
+    EXPECT_EQ(index.Size(), 2u);
+
+    ASSERT_EQ(index.Apply(Snapshot(9, {Room("c", 1, 0, 8)})), RoomListIndex::ApplyResult::Applied);
+    EXPECT_EQ(index.Size(), 1u);
+    EXPECT_FALSE(index.Find("a"));
+    EXPECT_TRUE(index.Find("c"));
+}
+
+TEST(RoomListIndexTest, AppliesDeltasInVersionOrder) {
+    RoomListIndex index;
+    index.Apply(Snapshot(1, {Room("a", 1, 1, 4), Room("b", 1, 3, 4)}));
+
+    RoomListDelta delta;
+    delta.base_version = 1;
+    delta.version = 2;
+    delta.upserted = {Room("a", 1, 4, 4), Room("c", 7, 0, 2)};
+    delta.removed = {"b", "unknown"};
+    ASSERT_EQ(index.Apply(delta), RoomListIndex::ApplyResult::Applied);
+
+    EXPECT_EQ(index.GetVersion(), 2u);
+    EXPECT_EQ(index.Size(), 2u);
+    EXPECT_EQ(index.Find("a")->current_players, 4);
+    EXPECT_FALSE(index.Find("b"));
+
+    // Replayed after a reconnect
+    EXPECT_EQ(index.Apply(delta), RoomListIndex::ApplyResult::Stale);
+    EXPECT_EQ(index.Size(), 2u);
+}
+
+TEST(RoomListIndexTest, ReportsMissingDeltas) {
+    RoomListIndex index;
+    index.Apply(Snapshot(1, {Room("a", 1, 1, 4)}));
+
+    RoomListDelta delta;
+    delta.base_version = 2;
+    delta.version = 3;
+    delta.removed = {"a"};
+    EXPECT_EQ(index.Apply(delta), RoomListIndex::ApplyResult::Gap);
+    EXPECT_EQ(index.GetVersion(), 1u);
+    EXPECT_TRUE(index.Find("a"));
+}
+
+TEST(RoomListIndexTest, FiltersByGameAndFreeSlots) {
+    RoomListIndex index;
+    index.Apply(Snapshot(1, {Room("a", 1, 1, 4), Room("b", 1, 4, 4), Room("c", 2, 0, 8),
+                             Room("d", 1, 0, 2, "us")}));
+
+    RoomListFilter by_game;
+    by_game.game_id = 1;
+    EXPECT_EQ(Ids(index.Query(by_game)), (std::vector<std::string>{"a", "d", "b"}));
+
+    by_game.min_free_slots = 1;
+    by_game.region = "eu";
+    EXPECT_EQ(Ids(index.Query(by_game)), (std::vector<std::string>{"a"}));
+
+    RoomListFilter open_rooms;
+    open_rooms.min_free_slots = 2;
+    EXPECT_EQ(Ids(index.Query(open_rooms)), (std::vector<std::string>{"c", "a", "d"}));
+
+    open_rooms.limit = 2;
+    EXPECT_EQ(Ids(index.Query(open_rooms)), (std::vector<std::string>{"c", "a"}));
+}
+
+TEST(RoomListIndexTest, UpdatesMoveRoomsBetweenIndexes) {
+    RoomListIndex index;
+    index.Apply(Snapshot(1, {Room("a", 1, 0, 4)}));
+
+    RoomListDelta delta;
+    delta.base_version = 1;
+    delta.version = 2;
+    delta.upserted = {Room("a", 5, 4, 4)};
+    index.Apply(delta);
+
+    RoomListFilter old_game;
+    old_game.game_id = 1;
+    EXPECT_TRUE(index.Query(old_game).empty());
+
+    RoomListFilter open_rooms;
+    open_rooms.min_free_slots = 1;
+    EXPECT_TRUE(index.Query(open_rooms).empty());
+
+    RoomListFilter new_game;
+    new_game.game_id = 5;
+    EXPECT_EQ(Ids(index.Query(new_game)), (std::vector<std::string>{"a"}));
+}
+
+TEST(RoomListIndexTest, SortsByPing) {
+    RoomListIndex index;
+    index.Apply(Snapshot(1, {Room("a", 1, 0, 4, "eu", 80), Room("b", 1, 0, 4, "eu", 20),
+                             Room("c", 1, 3, 4, "eu", 40)}));
+
+    RoomListFilter filter;
+    filter.order = RoomListOrder::LowestPing;
+    EXPECT_EQ(Ids(index.Query(filter)), (std::vector<std::string>{"b", "c", "a"}));
+
+    filter.limit = 1;
+    filter.game_id = 1;
+    EXPECT_EQ(Ids(index.Query(filter)), (std::vector<std::string>{"b"}));
+}
+
+TEST(RoomListIndexTest, DiscoveryFilterNarrowsQueriesToTheTitle) {
+    Core::Multiplayer::DiscoveryFilter filter;
+    filter.local_communication_id = 2;
+    filter.scene_id = 7;
+
+    RoomListIndex index;
+    index.Apply(Snapshot(1, {Room("a", 1, 1, 4), Room("b", 2, 1, 4)}));
+    EXPECT_EQ(Ids(index.Query(ToRoomListFilter(filter))), (std::vector<std::string>{"b"}));
+
+    RoomListRequest request;
+    ApplyDiscoveryFilter(filter, request);
+    EXPECT_EQ(request.game_id, 2u);
+
+    RoomListSubscribeRequest subscribe;
+    ApplyDiscoveryFilter(Core::Multiplayer::DiscoveryFilter{}, subscribe);
+    EXPECT_EQ(subscribe.game_id, 0u);
+}
@@ -0,0 +1,151 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "../room_list_index.h"
+#include "../room_list_view.h"
+
+using namespace Core::Multiplayer::ModelA;
+
+namespace {
+
+using Change = RoomListRowChange;
+using Kind = RoomListRowChange::Kind;
+
+RoomSummary Room(const std::string& id, int current, int max, int ping = 50,
+                 uint64_t game_id = 1) {
+    RoomSummary room;
+    room.id = id;
+    room.game_id = game_id;
+    room.game_name = "Game " + std::to_string(game_id);
+    room.current_players = current;
+    room.max_players = max;
+    room.region = "eu";
+    room.ping = ping;
+    return room;
+}
+
+RoomListDelta Delta(uint64_t base, uint64_t version, std::vector<RoomSummary> upserted,
+                    std::vector<std::string> removed = {}) {
+    RoomListDelta delta;
+    delta.base_version = base;
+    delta.version = version;
+    delta.upserted = std::move(upserted);
+    delta.removed = std::move(removed);
+    return delta;
+}
+
+std::vector<std::string> Rows(const RoomListView& view) {
+    std::vector<std::string> ids;
+    for (size_t row = 0; row < view.RowCount(); ++row) {
+        ids.push_back(view.RoomIdAt(row));
+    }
+    return ids;
+}
+
+} // namespace
+
+TEST(RoomListViewTest, SnapshotResetsSortedRows) {
+    RoomListView view;
+    RoomListDelta snapshot = Delta(0, 1, {Room("a", 3, 4), Room("b", 1, 4), Room("c", 2, 4)});
+    snapshot.snapshot = true;
+    std::vector<Change> changes;
+    EXPECT_EQ(view.Apply(snapshot, changes), RoomListView::ApplyResult::Applied);
+    EXPECT_EQ(changes, (std::vector<Change>{{Kind::Reset, 0}}));
+    EXPECT_EQ(Rows(view), (std::vector<std::string>{"b", "c", "a"}));
+    EXPECT_EQ(view.RowOf("c"), 1u);
+    EXPECT_EQ(view.GetVersion(), 1u);
+}
+
+TEST(RoomListViewTest, DeltasBecomeRowChanges) {
+    RoomListView view;
+    view.Reset({}, {Room("a", 3, 4), Room("b", 1, 4)}, 1);
+
+    std::vector<Change> changes;
+    // c slots in between, a changes in place, b is removed
+    ASSERT_EQ(view.Apply(Delta(1, 2, {Room("c", 2, 4), Room("a", 3, 4, 80)}, {"b"}), changes),
+              RoomListView::ApplyResult::Applied);
+    EXPECT_EQ(changes, (std::vector<Change>{
+                           {Kind::Inserted, 1}, {Kind::Updated, 2}, {Kind::Removed, 0}}));
+    EXPECT_EQ(Rows(view), (std::vector<std::string>{"c", "a"}));
+
+    // a empties out and moves to the top
+    changes.clear();
+    view.Apply(Delta(2, 3, {Room("a", 0, 4)}), changes);
+    EXPECT_EQ(changes, (std::vector<Change>{{Kind::Removed, 1}, {Kind::Inserted, 0}}));
+    EXPECT_EQ(Rows(view), (std::vector<std::string>{"a", "c"}));
+}
+
+TEST(RoomListViewTest, FilterDropsRoomsThatStopMatching) {
+    RoomListFilter filter;
+    filter.min_free_slots = 2;
+    filter.order = RoomListOrder::LowestPing;
+    RoomListView view;
+    view.Reset(filter, {Room("a", 0, 4, 90), Room("b", 1, 4, 30), Room("full", 4, 4, 10)}, 1);
+    EXPECT_EQ(Rows(view), (std::vector<std::string>{"b", "a"}));
+
+    std::vector<Change> changes;
+    view.Apply(Delta(1, 2, {Room("b", 3, 4, 30), Room("full", 3, 4, 10)}), changes);
+    EXPECT_EQ(changes, (std::vector<Change>{{Kind::Removed, 0}}));
+    EXPECT_EQ(Rows(view), (std::vector<std::string>{"a"}));
+}
+
+TEST(RoomListViewTest, OutOfOrderDeltasAreRefused) {
+    RoomListView view;
+    view.Reset({}, {Room("a", 1, 4)}, 5);
+    std::vector<Change> changes;
+    EXPECT_EQ(view.Apply(Delta(3, 4, {Room("b", 1, 4)}), changes),
+              RoomListView::ApplyResult::Stale);
+    EXPECT_EQ(view.Apply(Delta(6, 7, {Room("b", 1, 4)}), changes),
+              RoomListView::ApplyResult::Gap);
+    EXPECT_TRUE(changes.empty());
+    EXPECT_EQ(view.RowCount(), 1u);
+}
+
+TEST(RoomListViewTest, MatchesIndexQueryOrder) {
+    RoomListIndex index;
+    RoomListView view;
+    std::vector<RoomSummary> rooms;
+    for (int i = 0; i < 200; ++i) {
+        rooms.push_back(Room("room" + std::to_string(i), i % 7, 8, (i * 37) % 150));
+    }
+    RoomListDelta snapshot = Delta(0, 1, rooms);
+    snapshot.snapshot = true;
+    index.Apply(snapshot);
+    std::vector<Change> changes;
+    view.Apply(snapshot, changes);
+
+    // Churn the list, then compare with a fresh query
+    for (int i = 0; i < 100; ++i) {
+        const auto delta =
+            Delta(1 + i, 2 + i, {Room("room" + std::to_string(i * 3 % 200), i % 8, 8)},
+                  {"room" + std::to_string((i * 11 + 5) % 200)});
+        index.Apply(delta);
+        view.Apply(delta, changes);
+    }
+    std::vector<std::string> expected;
+    for (const auto& room : index.Query({})) {
+        expected.push_back(room.id);
+    }
+    EXPECT_EQ(Rows(view), expected);
+}
+
+TEST(RoomListViewTest, MeasuredPingsReorderLowestPing) {
+    RoomListFilter filter;
+    filter.order = RoomListOrder::LowestPing;
+    RoomListView view;
+    view.Reset(filter, {Room("a", 1, 4, 20), Room("b", 1, 4, 40)}, 1);
+
+    std::vector<Change> changes;
+    view.UpdatePing("a", 90, changes);
+    EXPECT_EQ(changes, (std::vector<Change>{{Kind::Removed, 0}, {Kind::Inserted, 1}}));
+    EXPECT_EQ(Rows(view), (std::vector<std::string>{"b", "a"}));
+
+    // The measured ping outlasts the server's figure in later deltas
+    changes.clear();
+    view.Apply(Delta(1, 2, {Room("a", 2, 4, 20)}), changes);
+    EXPECT_EQ(changes, (std::vector<Change>{{Kind::Updated, 1}}));
+}
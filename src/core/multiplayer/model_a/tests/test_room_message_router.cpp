@@ -0,0 +1,54 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <string_view>
+
+#include "../room_message_router.h"
+
+using namespace testing;
+using namespace Core::Multiplayer::ModelA;
+
+namespace {
+
+// Resolution is usable in constant expressions
+static_assert(ResolveMessageType("room_list_response") == MessageType::RoomListResponse);
+static_assert(ResolveMessageType("room_list") == MessageType::RoomList);
+static_assert(ResolveMessageType("not_a_type") == MessageType::Unknown);
+
+TEST(RoomMessageRouterTest, ResolvesEveryWireName) {
+    for (size_t i = 1; i < Detail::MESSAGE_TYPE_COUNT; ++i) {
+        const auto type = static_cast<MessageType>(i);
+        EXPECT_EQ(ResolveMessageType(MessageTypeName(type)), type);
+    }
+}
+
+TEST(RoomMessageRouterTest, RejectsNearMisses) {
+    EXPECT_EQ(ResolveMessageType(""), MessageType::Unknown);
+    EXPECT_EQ(ResolveMessageType("Error"), MessageType::Unknown);
+    EXPECT_EQ(ResolveMessageType("room_lis"), MessageType::Unknown);
+    EXPECT_EQ(ResolveMessageType("heartbeat_ack"), MessageType::Unknown);
+}
+
+TEST(RoomMessageRouterTest, PeeksTopLevelType) {
+    EXPECT_EQ(PeekMessageType(R"({"type":"error","message":"x"})"), "error");
+    EXPECT_EQ(PeekMessageType(R"(  { "timestamp" : 12, "type" : "p2p_info" })"), "p2p_info");
+
+    // Nested "type" members and string contents must not be mistaken for it
+    EXPECT_EQ(PeekMessageType(
+                  R"({"room":{"type":"error"},"note":"\"type\":\"x\"","type":"room_created"})"),
+              "room_created");
+    EXPECT_EQ(PeekMessageType(R"({"players":[{"type":"a"},[1,2]],"type":"player_joined"})"),
+              "player_joined");
+}
+
+TEST(RoomMessageRouterTest, PeekRejectsMalformedInput) {
+    EXPECT_EQ(PeekMessageType(""), "");
+    EXPECT_EQ(PeekMessageType("{invalid json structure"), "");
+    EXPECT_EQ(PeekMessageType(R"(["type","error"])"), "");
+    EXPECT_EQ(PeekMessageType(R"({"type":5})"), "");
+    EXPECT_EQ(PeekMessageType(R"({"type":"err)"), "");
+    EXPECT_EQ(PeekMessageType(R"({"data":"x"})"), "");
+}
+
+} // namespace
@@ -0,0 +1,125 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "../room_ping_prober.h"
+
+using namespace Core::Multiplayer::ModelA;
+using namespace std::chrono_literals;
+
+namespace {
+
+RoomSummary Room(const std::string& id, const std::string& region) {
+    RoomSummary room;
+    room.id = id;
+    room.region = region;
+    return room;
+}
+
+// Rooms are reached through their region's relay; "none" has no relay
+std::optional<std::string> RelayFor(const RoomSummary& room) {
+    if (room.region == "none") {
+        return std::nullopt;
+    }
+    return "relay-" + room.region + ".example:8443";
+}
+
+struct Harness {
+    explicit Harness(size_t batch_size = 16)
+        : prober(
+              RelayFor, [this](const std::vector<RoomPing>& pings) {
+                  reported.insert(reported.end(), pings.begin(), pings.end());
+              },
+              Config(batch_size), nullptr,
+              [this](const std::vector<std::string>& endpoints) {
+                  batches.push_back(endpoints);
+                  std::vector<RelayServerProbeResult> results;
+                  for (const auto& endpoint : endpoints) {
+                      RelayServerProbeResult result{endpoint, std::nullopt};
+                      if (endpoint.find("silent") == std::string::npos) {
+                          result.rtt = 20ms + 10ms * static_cast<int>(endpoint.size() % 3);
+                      }
+                      results.push_back(result);
+                  }
+                  return results;
+              }) {}
+
+    static RoomPingProberConfig Config(size_t batch_size) {
+        RoomPingProberConfig config;
+        config.batch_size = batch_size;
+        config.batch_interval = 0ms; // Batches run by hand
+        config.cache_ttl = 60s;
+        return config;
+    }
+
+    std::vector<std::vector<std::string>> batches;
+    std::vector<RoomPing> reported;
+    RoomPingProber prober;
+};
+
+} // anonymous namespace
+
+TEST(RoomPingProberTest, ProbesEachEndpointOnceInBoundedBatches) {
+    Harness harness(2);
+    harness.prober.SetVisibleRooms({Room("a", "eu"), Room("b", "eu"), Room("c", "us"),
+                                    Room("d", "asia"), Room("e", "none")});
+
+    const auto now = RoomPingProber::Clock::now();
+    harness.prober.RunBatch(now);
+    harness.prober.RunBatch(now);
+    harness.prober.RunBatch(now);
+    ASSERT_EQ(harness.batches.size(), 2u);
+    EXPECT_EQ(harness.batches[0].size(), 2u);
+    EXPECT_EQ(harness.batches[1].size(), 1u);
+
+    // Both eu rooms come from the one probe; the room without a relay is skipped
+    EXPECT_EQ(harness.reported.size(), 4u);
+    EXPECT_TRUE(harness.prober.GetPing("a"));
+    EXPECT_EQ(harness.prober.GetPing("a"), harness.prober.GetPing("b"));
+    EXPECT_FALSE(harness.prober.GetPing("e"));
+    EXPECT_EQ(harness.prober.GetStatistics().probes, 3u);
+}
+
+TEST(RoomPingProberTest, CachedResultsAreReusedUntilTheyExpire) {
+    Harness harness;
+    harness.prober.SetVisibleRooms({Room("a", "eu")});
+    const auto now = RoomPingProber::Clock::now();
+    harness.prober.RunBatch(now);
+    ASSERT_EQ(harness.batches.size(), 1u);
+
+    // Scrolled away and back
+    harness.prober.SetVisibleRooms({});
+    harness.prober.SetVisibleRooms({Room("a", "eu")});
+    harness.prober.RunBatch(now + 1s);
+    EXPECT_EQ(harness.batches.size(), 1u);
+    EXPECT_EQ(harness.prober.GetStatistics().cache_hits, 1u);
+
+    harness.prober.RunBatch(now + 61s);
+    EXPECT_EQ(harness.batches.size(), 2u);
+}
+
+TEST(RoomPingProberTest, UnansweredProbesReportNoPing) {
+    Harness harness;
+    harness.prober.SetVisibleRooms({Room("a", "silent")});
+    harness.prober.RunBatch();
+    ASSERT_EQ(harness.reported.size(), 1u);
+    EXPECT_EQ(harness.reported[0], (RoomPing{"a", std::nullopt}));
+    EXPECT_EQ(harness.prober.GetStatistics().answered, 0u);
+}
+
+TEST(RoomPingProberTest, PausedProberSendsNothing) {
+    Harness harness;
+    harness.prober.SetPaused(true);
+    harness.prober.SetVisibleRooms({Room("a", "eu")});
+    harness.prober.RunBatch();
+    EXPECT_TRUE(harness.batches.empty());
+
+    harness.prober.SetPaused(false);
+    harness.prober.RunBatch();
+    EXPECT_EQ(harness.batches.size(), 1u);
+}
@@ -0,0 +1,200 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../room_prefetcher.h"
+
+using namespace Core::Multiplayer;
+using namespace Core::Multiplayer::ModelA;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr uint64_t LDN_TITLE = 0x0100000000010000;
+constexpr uint64_t LDN_GAME = 0x0100000000010001;
+constexpr uint64_t OFFLINE_TITLE = 0x0100000000020000;
+
+class FakeConfigProvider : public IConfigProvider {
+public:
+    std::string GetRoomServerUrl() const override { return "wss://rooms.example"; }
+    std::string GetAuthToken() const override { return "token"; }
+    std::chrono::milliseconds GetConnectionTimeout() const override { return 2000ms; }
+    std::chrono::milliseconds GetHeartbeatInterval() const override { return 5000ms; }
+    std::chrono::milliseconds GetMessageTimeout() const override { return 3000ms; }
+    bool IsAutoReconnectEnabled() const override { return false; }
+    int GetMaxReconnectAttempts() const override { return 0; }
+    std::chrono::milliseconds GetReconnectBaseDelay() const override { return 1000ms; }
+    double GetReconnectBackoffMultiplier() const override { return 2.0; }
+    std::chrono::milliseconds GetMaxReconnectDelay() const override { return 60000ms; }
+    bool ShouldReconnectOnError(const std::string&) const override { return false; }
+    int GetMaxConcurrentMessages() const override { return 8; }
+    size_t GetMessageQueueSize() const override { return 64; }
+};
+
+// Connects when the test says so and records what is sent
+class FakeConnection : public IWebSocketConnection {
+public:
+    void Connect(const std::string& uri) override {
+        std::lock_guard lock(mutex);
+        uri_ = uri;
+        connect_requested = true;
+    }
+    void Disconnect(const std::string&) override {
+        std::lock_guard lock(mutex);
+        connected = false;
+        ++disconnects;
+    }
+    bool IsConnected() const override {
+        std::lock_guard lock(mutex);
+        return connected;
+    }
+    std::string GetUri() const override { return uri_; }
+    void SetAuthToken(const std::string&) override {}
+    void SendMessage(const std::string& message) override {
+        std::lock_guard lock(mutex);
+        sent.push_back(message);
+    }
+    void SetOnMessageCallback(std::function<void(const std::string&)>) override {}
+    void SetOnConnectCallback(std::function<void()> callback) override {
+        on_connect_ = std::move(callback);
+    }
+    void SetOnDisconnectCallback(std::function<void(const std::string&)>) override {}
+    void SetOnErrorCallback(std::function<void(const std::string&)>) override {}
+
+    void CompleteHandshake() {
+        {
+            std::lock_guard lock(mutex);
+            connected = true;
+        }
+        on_connect_();
+    }
+
+    bool SentContaining(const std::string& text) {
+        std::lock_guard lock(mutex);
+        for (const auto& message : sent) {
+            if (message.find(text) != std::string::npos) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    mutable std::mutex mutex;
+    bool connect_requested = false;
+    bool connected = false;
+    int disconnects = 0;
+    std::vector<std::string> sent;
+
+private:
+    std::string uri_;
+    std::function<void()> on_connect_;
+};
+
+class RoomPrefetcherTest : public ::testing::Test {
+protected:
+    std::unique_ptr<RoomPrefetcher> MakePrefetcher(bool enabled,
+                                                   std::chrono::milliseconds idle_timeout) {
+        RoomPrefetchConfig config;
+        config.enabled = enabled;
+        config.idle_timeout = idle_timeout;
+        config.region = "eu";
+        RegisterRequest registration;
+        registration.username = "player";
+        return std::make_unique<RoomPrefetcher>(
+            config,
+            [this] {
+                connections.push_back(std::make_shared<FakeConnection>());
+                return std::make_shared<RoomClient>(connections.back(),
+                                                    std::make_shared<FakeConfigProvider>(),
+                                                    wheel);
+            },
+            [](uint64_t title_id) -> std::optional<uint64_t> {
+                if (title_id == LDN_TITLE) {
+                    return LDN_GAME;
+                }
+                return std::nullopt;
+            },
+            registration, wheel);
+    }
+
+    std::shared_ptr<TimerWheel> wheel = std::make_shared<TimerWheel>(1ms);
+    std::vector<std::shared_ptr<FakeConnection>> connections;
+};
+
+} // anonymous namespace
+
+TEST_F(RoomPrefetcherTest, DisabledByDefault) {
+    EXPECT_FALSE(RoomPrefetchConfig{}.enabled);
+    auto prefetcher = MakePrefetcher(false, 10s);
+    EXPECT_FALSE(prefetcher->OnTitleLaunched(LDN_TITLE));
+    EXPECT_TRUE(connections.empty());
+}
+
+TEST_F(RoomPrefetcherTest, TitlesWithoutLdnAreSkipped) {
+    auto prefetcher = MakePrefetcher(true, 10s);
+    EXPECT_FALSE(prefetcher->OnTitleLaunched(OFFLINE_TITLE));
+    EXPECT_TRUE(connections.empty());
+    EXPECT_EQ(prefetcher->GetStatistics().skipped, 1u);
+}
+
+TEST_F(RoomPrefetcherTest, RegistersAndSubscribesOnceConnected) {
+    auto prefetcher = MakePrefetcher(true, 10s);
+    ASSERT_TRUE(prefetcher->OnTitleLaunched(LDN_TITLE));
+    ASSERT_EQ(connections.size(), 1u);
+    EXPECT_TRUE(connections[0]->connect_requested);
+    EXPECT_EQ(prefetcher->GetGameId(), std::optional<uint64_t>{LDN_GAME});
+
+    connections[0]->CompleteHandshake();
+    EXPECT_TRUE(connections[0]->SentContaining("\"register\""));
+    EXPECT_TRUE(connections[0]->SentContaining("\"room_list_subscribe\""));
+    EXPECT_TRUE(connections[0]->SentContaining("0100000000010001"));
+
+    // Only the game it was prefetched for can claim it, and only once
+    EXPECT_EQ(prefetcher->Claim(LDN_GAME + 1), nullptr);
+    const auto client = prefetcher->Claim(LDN_GAME);
+    ASSERT_NE(client, nullptr);
+    EXPECT_TRUE(client->IsConnected());
+    EXPECT_TRUE(client->IsRoomListSubscribed());
+    EXPECT_EQ(prefetcher->Claim(LDN_GAME), nullptr);
+    EXPECT_FALSE(prefetcher->IsWarm());
+    EXPECT_EQ(prefetcher->GetStatistics().claimed, 1u);
+}
+
+TEST_F(RoomPrefetcherTest, UnclaimedClientIsReleasedWhenIdle) {
+    auto prefetcher = MakePrefetcher(true, 20ms);
+    ASSERT_TRUE(prefetcher->OnTitleLaunched(LDN_TITLE));
+    connections[0]->CompleteHandshake();
+
+    const auto deadline = std::chrono::steady_clock::now() + 2s;
+    while (connections[0]->IsConnected() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(1ms);
+    }
+    EXPECT_FALSE(connections[0]->IsConnected());
+    EXPECT_FALSE(prefetcher->IsWarm());
+    EXPECT_EQ(prefetcher->GetStatistics().expired, 1u);
+    EXPECT_EQ(prefetcher->Claim(LDN_GAME), nullptr);
+}
+
+TEST_F(RoomPrefetcherTest, StoppingOrSwitchingTitlesReleasesTheClient) {
+    auto prefetcher = MakePrefetcher(true, 10s);
+    ASSERT_TRUE(prefetcher->OnTitleLaunched(LDN_TITLE));
+    connections[0]->CompleteHandshake();
+    ASSERT_TRUE(prefetcher->OnTitleLaunched(LDN_TITLE));
+    EXPECT_FALSE(connections[0]->IsConnected());
+    ASSERT_EQ(connections.size(), 2u);
+
+    connections[1]->CompleteHandshake();
+    prefetcher->OnTitleStopped();
+    EXPECT_FALSE(connections[1]->IsConnected());
+    EXPECT_FALSE(prefetcher->IsWarm());
+    EXPECT_EQ(prefetcher->GetStatistics().expired, 0u);
+}
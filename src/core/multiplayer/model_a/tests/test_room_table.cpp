@@ -0,0 +1,84 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <string>
+
+#include "../room_table.h"
+
+using namespace Core::Multiplayer::ModelA;
+
+namespace {
+
+RoomSummary Room(const std::string& id, const std::string& game_name, const std::string& region,
+                 int current = 1) {
+    RoomSummary room;
+    room.id = id;
+    room.game_id = 7;
+    room.game_name = game_name;
+    room.host_name = "host of " + id;
+    room.current_players = current;
+    room.max_players = 4;
+    room.ping = 30;
+    room.region = region;
+    return room;
+}
+
+} // anonymous namespace
+
+TEST(RoomTableTest, StoresAndUpdatesRooms) {
+    RoomTable table;
+    ASSERT_TRUE(table.Upsert(Room("a", "Mario Kart", "eu")));
+    ASSERT_TRUE(table.Upsert(Room("b", "Mario Kart", "us")));
+    const auto slot = table.Upsert(Room("a", "Mario Kart", "eu", 3));
+    ASSERT_TRUE(slot);
+    EXPECT_EQ(table.Size(), 2u);
+
+    const RoomSummaryView view = table.View(*slot);
+    EXPECT_EQ(view.id, "a");
+    EXPECT_EQ(view.host_name, "host of a");
+    EXPECT_EQ(view.current_players, 3);
+    EXPECT_EQ(table.FreeSlotsAt(*slot), 1);
+
+    const RoomSummary summary = view.ToSummary();
+    EXPECT_EQ(summary.game_name, "Mario Kart");
+    EXPECT_EQ(summary.region, "eu");
+}
+
+TEST(RoomTableTest, InternsRepeatedStrings) {
+    RoomTable table;
+    for (int i = 0; i < 100; ++i) {
+        table.Upsert(Room("room" + std::to_string(i), "Smash", i % 2 ? "eu" : "us"));
+    }
+    const auto eu = table.FindString("eu");
+    ASSERT_TRUE(eu);
+    EXPECT_EQ(table.RegionAt(*table.Find("room1")), *eu);
+    EXPECT_NE(table.RegionAt(*table.Find("room2")), *eu);
+    EXPECT_EQ(table.GameNameAt(*table.Find("room2")), "Smash");
+    EXPECT_FALSE(table.FindString("asia"));
+}
+
+TEST(RoomTableTest, RemoveMovesTheLastRoomIntoTheGap) {
+    RoomTable table;
+    table.Upsert(Room("a", "g", "eu"));
+    table.Upsert(Room("b", "g", "eu"));
+    table.Upsert(Room("c", "g", "us"));
+
+    EXPECT_TRUE(table.Remove("a"));
+    EXPECT_FALSE(table.Remove("a"));
+    EXPECT_EQ(table.Size(), 2u);
+    EXPECT_FALSE(table.Find("a"));
+    const auto c = table.Find("c");
+    ASSERT_TRUE(c);
+    EXPECT_EQ(table.View(*c).region, "us");
+    EXPECT_EQ(table.View(*c).host_name, "host of c");
+    EXPECT_EQ(table.View(*table.Find("b")).id, "b");
+}
+
+TEST(RoomTableTest, RejectsOverlongIds) {
+    RoomTable table;
+    EXPECT_FALSE(table.Upsert(Room(std::string(RoomId::CAPACITY + 1, 'x'), "g", "eu")));
+    EXPECT_TRUE(table.Upsert(Room(std::string(RoomId::CAPACITY, 'x'), "g", "eu")));
+    EXPECT_EQ(table.Size(), 1u);
+    EXPECT_FALSE(table.Find(std::string(RoomId::CAPACITY + 1, 'x')));
+}
@@ -0,0 +1,154 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstring>
+#include <vector>
+
+#include "core/multiplayer/model_a/packet_cipher.h"
+#include "core/multiplayer/model_a/session_resumption.h"
+
+using namespace Core::Multiplayer;
+using namespace Core::Multiplayer::ModelA;
+
+namespace {
+using Clock = SessionResumptionCache::Clock;
+
+std::array<uint8_t, SessionResumptionCache::SECRET_SIZE> MakeSecret(uint8_t seed) {
+    std::array<uint8_t, SessionResumptionCache::SECRET_SIZE> secret{};
+    for (size_t i = 0; i < secret.size(); ++i) {
+        secret[i] = static_cast<uint8_t>(seed + i);
+    }
+    return secret;
+}
+} // namespace
+
+TEST(SessionResumptionTest, BothSidesDeriveTheSameKeys) {
+    SessionResumptionCache initiator;
+    SessionResumptionCache responder;
+    const auto secret = MakeSecret(1);
+    initiator.Remember("responder", secret);
+    responder.Remember("initiator", secret);
+
+    const auto offer = initiator.BeginResumption("responder");
+    ASSERT_TRUE(offer.has_value());
+    const auto keys = responder.AcceptResumption("initiator", offer->hello);
+    ASSERT_TRUE(keys.has_value());
+
+    EXPECT_EQ(keys->initiator_to_responder, offer->keys.initiator_to_responder);
+    EXPECT_EQ(keys->responder_to_initiator, offer->keys.responder_to_initiator);
+    EXPECT_EQ(keys->next_secret, offer->keys.next_secret);
+    EXPECT_NE(keys->initiator_to_responder, keys->responder_to_initiator);
+    EXPECT_EQ(initiator.GetTicketCount(), 0u);
+    EXPECT_EQ(responder.GetTicketCount(), 0u);
+}
+
+TEST(SessionResumptionTest, FirstFlightDataOpensOnTheResponder) {
+    SessionResumptionCache initiator;
+    SessionResumptionCache responder;
+    const auto secret = MakeSecret(2);
+    initiator.Remember("b", secret);
+    responder.Remember("a", secret);
+
+    // The initiator seals data before hearing anything back
+    const auto offer = initiator.BeginResumption("b");
+    ASSERT_TRUE(offer.has_value());
+    PacketCipher sender(AeadAlgorithm::ChaCha20Poly1305, offer->keys.initiator_to_responder);
+    PacketPool pool(4);
+    const std::vector<uint8_t> payload{'h', 'e', 'l', 'l', 'o'};
+    std::vector<PacketBuffer> flight{pool.Acquire(payload.data(), payload.size())};
+    ASSERT_EQ(sender.SealBatch(flight, offer->hello), 1u);
+
+    const auto keys = responder.AcceptResumption("a", offer->hello);
+    ASSERT_TRUE(keys.has_value());
+    PacketCipher receiver(AeadAlgorithm::ChaCha20Poly1305, keys->initiator_to_responder);
+    ASSERT_EQ(receiver.OpenBatch(flight, offer->hello), 1u);
+    EXPECT_EQ(std::memcmp(flight[0].data(), payload.data(), payload.size()), 0);
+}
+
+TEST(SessionResumptionTest, ReplayedHelloIsRejected) {
+    SessionResumptionCache initiator;
+    SessionResumptionCache responder;
+    const auto secret = MakeSecret(3);
+    initiator.Remember("b", secret);
+    responder.Remember("a", secret);
+
+    const auto offer = initiator.BeginResumption("b");
+    ASSERT_TRUE(offer.has_value());
+    EXPECT_TRUE(responder.AcceptResumption("a", offer->hello).has_value());
+    EXPECT_FALSE(responder.AcceptResumption("a", offer->hello).has_value());
+    EXPECT_FALSE(initiator.BeginResumption("b").has_value());
+}
+
+TEST(SessionResumptionTest, ExpiredTicketsNeedAFullHandshake) {
+    SessionResumptionConfig config;
+    config.ticket_lifetime = std::chrono::seconds(30);
+    SessionResumptionCache initiator(config);
+    SessionResumptionCache responder(config);
+    const auto secret = MakeSecret(4);
+    const auto issued = Clock::now();
+    initiator.Remember("b", secret, issued);
+    responder.Remember("a", secret, issued);
+
+    const auto late = issued + std::chrono::seconds(31);
+    EXPECT_FALSE(initiator.BeginResumption("b", late).has_value());
+
+    // A hello from a peer whose clock ran slower is still refused
+    initiator.Remember("b", secret, issued);
+    const auto offer = initiator.BeginResumption("b", issued);
+    ASSERT_TRUE(offer.has_value());
+    EXPECT_FALSE(responder.AcceptResumption("a", offer->hello, late).has_value());
+    EXPECT_EQ(responder.GetTicketCount(), 0u);
+}
+
+TEST(SessionResumptionTest, RejectsHellosForOtherSecrets) {
+    SessionResumptionCache initiator;
+    SessionResumptionCache responder;
+    initiator.Remember("b", MakeSecret(5));
+    responder.Remember("a", MakeSecret(6));
+
+    const auto offer = initiator.BeginResumption("b");
+    ASSERT_TRUE(offer.has_value());
+    EXPECT_FALSE(responder.AcceptResumption("a", offer->hello).has_value());
+    EXPECT_FALSE(responder.AcceptResumption("a", std::span(offer->hello).first(16)).has_value());
+    // A mismatched hello does not use up the responder's ticket
+    EXPECT_EQ(responder.GetTicketCount(), 1u);
+}
+
+TEST(SessionResumptionTest, NextSecretChainsResumptions) {
+    SessionResumptionCache initiator;
+    SessionResumptionCache responder;
+    const auto secret = MakeSecret(7);
+    initiator.Remember("b", secret);
+    responder.Remember("a", secret);
+
+    const auto first = initiator.BeginResumption("b");
+    ASSERT_TRUE(first.has_value());
+    const auto first_keys = responder.AcceptResumption("a", first->hello);
+    ASSERT_TRUE(first_keys.has_value());
+    initiator.Remember("b", first->keys.next_secret);
+    responder.Remember("a", first_keys->next_secret);
+
+    const auto second = initiator.BeginResumption("b");
+    ASSERT_TRUE(second.has_value());
+    const auto second_keys = responder.AcceptResumption("a", second->hello);
+    ASSERT_TRUE(second_keys.has_value());
+    EXPECT_EQ(second_keys->initiator_to_responder, second->keys.initiator_to_responder);
+    EXPECT_NE(second_keys->initiator_to_responder, first_keys->initiator_to_responder);
+}
+
+TEST(SessionResumptionTest, DropsTheOldestTicketWhenFull) {
+    SessionResumptionConfig config;
+    config.max_tickets = 2;
+    SessionResumptionCache cache(config);
+    const auto now = Clock::now();
+    cache.Remember("a", MakeSecret(8), now);
+    cache.Remember("b", MakeSecret(9), now + std::chrono::seconds(1));
+    cache.Remember("c", MakeSecret(10), now + std::chrono::seconds(2));
+
+    EXPECT_EQ(cache.GetTicketCount(), 2u);
+    EXPECT_FALSE(cache.BeginResumption("a", now + std::chrono::seconds(3)).has_value());
+    EXPECT_TRUE(cache.BeginResumption("c", now + std::chrono::seconds(3)).has_value());
+}
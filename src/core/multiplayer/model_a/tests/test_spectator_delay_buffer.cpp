@@ -0,0 +1,130 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../spectator_delay_buffer.h"
+
+using namespace Core::Multiplayer::ModelA;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Records what playout delivered; a snapshot is recorded as its value + 100
+class Recorder {
+public:
+    SpectatorDelayBuffer::DeliverCallback Callback() {
+        return [this](bool snapshot, std::vector<uint8_t>& payload) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            delivered_.push_back(payload[0] + (snapshot ? 100 : 0));
+        };
+    }
+
+    std::vector<int> Delivered() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return delivered_;
+    }
+
+    bool WaitFor(size_t count, std::chrono::milliseconds timeout = 2s) const {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (std::chrono::steady_clock::now() < deadline) {
+            if (Delivered().size() >= count) {
+                return true;
+            }
+            std::this_thread::sleep_for(1ms);
+        }
+        return false;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<int> delivered_;
+};
+
+std::vector<uint8_t> Payload(uint8_t value) {
+    return std::vector<uint8_t>(4, value);
+}
+
+} // anonymous namespace
+
+TEST(SpectatorDelayBufferTest, HoldsFramesUntilASnapshotArrives) {
+    Recorder recorder;
+    SpectatorDelayBuffer buffer(SpectatorConfig{}, recorder.Callback());
+
+    buffer.Insert(10, Payload(10), false);
+    buffer.Insert(11, Payload(11), false);
+    buffer.Insert(12, Payload(12), false);
+    EXPECT_FALSE(buffer.IsPlaying());
+    EXPECT_TRUE(recorder.Delivered().empty());
+
+    // The snapshot covers everything before 11
+    buffer.Insert(11, Payload(11), true);
+    EXPECT_TRUE(buffer.IsPlaying());
+    EXPECT_EQ(recorder.Delivered(), (std::vector<int>{111, 11, 12}));
+
+    const auto stats = buffer.GetStatistics();
+    EXPECT_EQ(stats.snapshots, 1u);
+    EXPECT_EQ(stats.superseded, 1u);
+    EXPECT_EQ(stats.delivered, 2u);
+}
+
+TEST(SpectatorDelayBufferTest, ResynchronizesOnlyAfterALoss) {
+    Recorder recorder;
+    SpectatorDelayBuffer buffer(SpectatorConfig{}, recorder.Callback());
+
+    buffer.Insert(1, Payload(1), true);
+    buffer.Insert(1, Payload(1), false);
+    buffer.Insert(2, Payload(2), false);
+    // Nothing was lost, so the next snapshot is not needed
+    buffer.Insert(3, Payload(3), true);
+    buffer.Insert(3, Payload(3), false);
+    EXPECT_EQ(recorder.Delivered(), (std::vector<int>{101, 1, 2, 3}));
+
+    // 4 is lost; the snapshot taken before 6 resynchronizes playout
+    buffer.Insert(5, Payload(5), false);
+    buffer.Insert(6, Payload(6), true);
+    buffer.Insert(6, Payload(6), false);
+    buffer.Insert(4, Payload(4), false);
+    EXPECT_EQ(recorder.Delivered(), (std::vector<int>{101, 1, 2, 3, 5, 106, 6}));
+
+    const auto stats = buffer.GetStatistics();
+    EXPECT_EQ(stats.snapshots, 2u);
+    EXPECT_EQ(stats.lost, 1u);
+    EXPECT_EQ(stats.late_dropped, 1u);
+}
+
+TEST(SpectatorDelayBufferTest, AppliesTheBroadcastDelay) {
+    Recorder recorder;
+    SpectatorConfig config;
+    config.delay = 30ms;
+    SpectatorDelayBuffer buffer(config, recorder.Callback());
+
+    const auto start = std::chrono::steady_clock::now();
+    buffer.Insert(7, Payload(7), true);
+    buffer.Insert(8, Payload(8), false);
+    buffer.Insert(7, Payload(7), false);
+    EXPECT_TRUE(recorder.Delivered().empty());
+
+    ASSERT_TRUE(recorder.WaitFor(3));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, 30ms);
+    EXPECT_EQ(recorder.Delivered(), (std::vector<int>{107, 7, 8}));
+}
+
+TEST(SpectatorDelayBufferTest, PlaysStandaloneFramesWithoutASnapshot) {
+    Recorder recorder;
+    SpectatorConfig config;
+    config.wait_for_snapshot = false;
+    config.max_buffered_frames = 2;
+    SpectatorDelayBuffer buffer(config, recorder.Callback());
+
+    buffer.Insert(0xFFFFFFFF, Payload(1), false);
+    buffer.Insert(0, Payload(2), false);
+    EXPECT_TRUE(buffer.IsPlaying());
+    EXPECT_EQ(recorder.Delivered(), (std::vector<int>{1, 2}));
+    EXPECT_EQ(buffer.GetStatistics().lost, 0u);
+}
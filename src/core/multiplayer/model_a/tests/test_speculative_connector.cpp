@@ -0,0 +1,96 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../speculative_connector.h"
+
+using namespace Core::Multiplayer;
+using namespace Core::Multiplayer::ModelA;
+
+namespace {
+
+class SpeculativeConnectorTest : public ::testing::Test {
+protected:
+    std::unique_ptr<SpeculativeConnector> MakeConnector(size_t max_warm_peers,
+                                                        std::chrono::milliseconds ttl) {
+        return std::make_unique<SpeculativeConnector>(
+            SpeculativeConnectConfig{max_warm_peers, ttl},
+            [this](const std::string& peer_id, const std::string&) {
+                std::lock_guard<std::mutex> lock(mutex);
+                dialed.push_back(peer_id);
+            },
+            [this](const std::string& peer_id) {
+                std::lock_guard<std::mutex> lock(mutex);
+                closed.push_back(peer_id);
+            },
+            wheel);
+    }
+
+    std::vector<std::string> Closed() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return closed;
+    }
+
+    std::shared_ptr<TimerWheel> wheel =
+        std::make_shared<TimerWheel>(std::chrono::milliseconds(1));
+    std::mutex mutex;
+    std::vector<std::string> dialed;
+    std::vector<std::string> closed;
+};
+
+} // anonymous namespace
+
+TEST_F(SpeculativeConnectorTest, PoolIsBounded) {
+    auto connector = MakeConnector(2, std::chrono::seconds(10));
+    EXPECT_TRUE(connector->Prepare("peer_1", "/ip4/203.0.113.1/tcp/4001"));
+    EXPECT_FALSE(connector->Prepare("peer_1", "/ip4/203.0.113.1/tcp/4001"));
+    EXPECT_TRUE(connector->Prepare("peer_2", "/ip4/203.0.113.2/tcp/4001"));
+    EXPECT_FALSE(connector->Prepare("peer_3", "/ip4/203.0.113.3/tcp/4001"));
+
+    EXPECT_EQ(dialed, (std::vector<std::string>{"peer_1", "peer_2"}));
+    EXPECT_EQ(connector->GetWarmCount(), 2u);
+    EXPECT_EQ(connector->GetStatistics().rejected, 1u);
+}
+
+TEST_F(SpeculativeConnectorTest, ClaimedPeersStayOpen) {
+    auto connector = MakeConnector(2, std::chrono::milliseconds(20));
+    connector->Prepare("peer_1", "/ip4/203.0.113.1/tcp/4001");
+    EXPECT_TRUE(connector->Claim("peer_1"));
+    EXPECT_FALSE(connector->Claim("peer_1"));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    connector.reset();
+    EXPECT_TRUE(Closed().empty());
+    EXPECT_EQ(wheel->GetTimerCount(), 0u);
+}
+
+TEST_F(SpeculativeConnectorTest, UnclaimedPeersExpire) {
+    auto connector = MakeConnector(2, std::chrono::milliseconds(20));
+    connector->Prepare("peer_1", "/ip4/203.0.113.1/tcp/4001");
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (Closed().empty() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(Closed(), std::vector<std::string>{"peer_1"});
+    EXPECT_FALSE(connector->Claim("peer_1"));
+    EXPECT_EQ(connector->GetStatistics().expired, 1u);
+}
+
+TEST_F(SpeculativeConnectorTest, ForgottenAndRemainingPeersAreClosed) {
+    auto connector = MakeConnector(4, std::chrono::seconds(10));
+    connector->Prepare("peer_1", "/ip4/203.0.113.1/tcp/4001");
+    connector->Prepare("peer_2", "/ip4/203.0.113.2/tcp/4001");
+    connector->Forget("peer_1");
+    EXPECT_EQ(Closed(), std::vector<std::string>{"peer_1"});
+
+    connector.reset();
+    EXPECT_EQ(Closed(), (std::vector<std::string>{"peer_1", "peer_2"}));
+}
@@ -0,0 +1,56 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "../transport_preference.h"
+
+using namespace Core::Multiplayer::ModelA;
+
+TEST(TransportPreferenceTest, ClassifiesMultiaddrs) {
+    EXPECT_EQ(ClassifyMultiaddr("/ip4/203.0.113.7/udp/4001/quic-v1"), P2PTransport::Quic);
+    EXPECT_EQ(ClassifyMultiaddr("/ip6/::1/udp/4001/quic"), P2PTransport::Quic);
+    EXPECT_EQ(ClassifyMultiaddr("/ip4/203.0.113.7/tcp/4001"), P2PTransport::Tcp);
+    EXPECT_EQ(ClassifyMultiaddr("/dns4/example.org/tcp/443/wss"), P2PTransport::WebSocket);
+    EXPECT_EQ(ClassifyMultiaddr("/ip4/198.51.100.1/tcp/4001/p2p/QmRelay/p2p-circuit/p2p/QmPeer"),
+              P2PTransport::Relay);
+    // Components are matched whole, not as substrings
+    EXPECT_EQ(ClassifyMultiaddr("/dns4/quic.example.org/tcp/4001"), P2PTransport::Tcp);
+    EXPECT_EQ(ClassifyMultiaddr("/ip4/203.0.113.7/udp/4001"), P2PTransport::Unknown);
+}
+
+TEST(TransportPreferenceTest, QuicIsDialedFirstAndTcpKeepsItsOrder) {
+    P2PNetworkConfig config;
+    const std::vector<std::string> ordered = OrderDialAddresses(
+        {"/ip4/203.0.113.7/tcp/4001", "/ip4/192.168.1.5/tcp/4001",
+         "/ip4/203.0.113.7/udp/4001/quic-v1"},
+        config);
+    const std::vector<std::string> expected{"/ip4/203.0.113.7/udp/4001/quic-v1",
+                                            "/ip4/203.0.113.7/tcp/4001",
+                                            "/ip4/192.168.1.5/tcp/4001"};
+    EXPECT_EQ(ordered, expected);
+}
+
+TEST(TransportPreferenceTest, WithoutPreferenceTheGivenOrderIsKept) {
+    P2PNetworkConfig config;
+    config.prefer_quic = false;
+    const std::vector<std::string> addresses{"/ip4/203.0.113.7/tcp/4001",
+                                             "/ip4/203.0.113.7/udp/4001/quic-v1"};
+    EXPECT_EQ(OrderDialAddresses(addresses, config), addresses);
+}
+
+TEST(TransportPreferenceTest, DisabledTransportsAreDropped) {
+    P2PNetworkConfig config;
+    config.enable_quic = false;
+    const std::vector<std::string> ordered = OrderDialAddresses(
+        {"/ip4/203.0.113.7/udp/4001/quic-v1", "/ip4/203.0.113.7/tcp/4001",
+         "/dns4/example.org/tcp/443/wss"},
+        config);
+    EXPECT_EQ(ordered, std::vector<std::string>{"/ip4/203.0.113.7/tcp/4001"});
+
+    config.enable_quic = true;
+    config.enable_tcp = false;
+    EXPECT_EQ(OrderDialAddresses({"/ip4/203.0.113.7/tcp/4001"}, config).size(), 0u);
+}
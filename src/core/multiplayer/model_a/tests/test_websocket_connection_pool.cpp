@@ -0,0 +1,166 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/multiplayer/model_a/websocket_connection_pool.h"
+
+using namespace Core::Multiplayer::ModelA;
+
+namespace {
+
+/**
+ * Connection fake whose handshake completes when the test says so
+ */
+class FakeWebSocketConnection : public IWebSocketConnection {
+public:
+    void Connect(const std::string& uri) override {
+        uri_ = uri;
+        ++connect_calls;
+    }
+    void Disconnect(const std::string&) override {
+        connected = false;
+        ++disconnect_calls;
+    }
+    bool IsConnected() const override { return connected; }
+    std::string GetUri() const override { return uri_; }
+    void SetAuthToken(const std::string& token) override { auth_token = token; }
+    void SendMessage(const std::string&) override {}
+    void SetOnMessageCallback(std::function<void(const std::string&)>) override {}
+    void SetOnConnectCallback(std::function<void()> callback) override {
+        on_connect = std::move(callback);
+    }
+    void SetOnDisconnectCallback(std::function<void(const std::string&)>) override {}
+    void SetOnErrorCallback(std::function<void(const std::string&)>) override {}
+
+    std::vector<uint8_t> GetTlsSessionTicket() const override { return issued_ticket; }
+    void SetTlsSessionTicket(const std::vector<uint8_t>& ticket) override {
+        resumed_ticket = ticket;
+    }
+
+    bool connected = false;
+    int connect_calls = 0;
+    int disconnect_calls = 0;
+    std::string auth_token;
+    std::vector<uint8_t> issued_ticket;
+    std::vector<uint8_t> resumed_ticket;
+    std::function<void()> on_connect;
+
+private:
+    std::string uri_;
+};
+
+constexpr const char* kEuServer = "wss://eu.rooms.sudachi.org/ws";
+constexpr const char* kUsServer = "wss://us.rooms.sudachi.org/ws";
+
+} // anonymous namespace
+
+class WebSocketConnectionPoolTest : public ::testing::Test {
+protected:
+    WebSocketConnectionPool::ConnectionFactory MakeFactory() {
+        return [this]() {
+            auto connection = std::make_shared<FakeWebSocketConnection>();
+            created_.push_back(connection);
+            return connection;
+        };
+    }
+
+    std::vector<std::shared_ptr<FakeWebSocketConnection>> created_;
+};
+
+TEST_F(WebSocketConnectionPoolTest, ReusesOpenConnectionForSameUrl) {
+    WebSocketConnectionPool pool(MakeFactory());
+
+    auto first = pool.Acquire(kEuServer);
+    ASSERT_EQ(created_.size(), 1u);
+    created_[0]->connected = true;
+
+    pool.Release(kEuServer, first);
+    EXPECT_EQ(pool.GetIdleCount(kEuServer), 1u);
+    EXPECT_EQ(pool.GetIdleCount(kUsServer), 0u);
+
+    auto second = pool.Acquire(kEuServer);
+    EXPECT_EQ(second, first);
+    EXPECT_EQ(created_.size(), 1u);
+    EXPECT_EQ(pool.GetStatistics().reused, 1u);
+
+    // Another server never gets the EU connection
+    auto us = pool.Acquire(kUsServer);
+    EXPECT_NE(us, first);
+    EXPECT_EQ(created_.size(), 2u);
+}
+
+TEST_F(WebSocketConnectionPoolTest, ReleaseDetachesCallbacks) {
+    WebSocketConnectionPool pool(MakeFactory());
+
+    auto connection = pool.Acquire(kEuServer);
+    bool called = false;
+    connection->SetOnConnectCallback([&called]() { called = true; });
+    created_[0]->connected = true;
+
+    pool.Release(kEuServer, connection);
+    created_[0]->on_connect();
+    EXPECT_FALSE(called);
+}
+
+TEST_F(WebSocketConnectionPoolTest, ClosedConnectionLeavesSessionTicket) {
+    WebSocketConnectionPool pool(MakeFactory());
+
+    auto connection = pool.Acquire(kEuServer);
+    created_[0]->issued_ticket = {0x01, 0x02, 0x03};
+
+    // Dropped by the server: not kept, but its TLS session can be resumed
+    pool.Release(kEuServer, connection);
+    EXPECT_EQ(pool.GetIdleCount(kEuServer), 0u);
+    EXPECT_TRUE(pool.HasSessionTicket(kEuServer));
+
+    pool.Acquire(kEuServer);
+    ASSERT_EQ(created_.size(), 2u);
+    EXPECT_EQ(created_[1]->resumed_ticket, (std::vector<uint8_t>{0x01, 0x02, 0x03}));
+    EXPECT_EQ(pool.GetStatistics().resumed, 1u);
+
+    pool.Acquire(kUsServer);
+    EXPECT_TRUE(created_[2]->resumed_ticket.empty());
+}
+
+TEST_F(WebSocketConnectionPoolTest, PrewarmedConnectionIsUsedOnceConnected) {
+    WebSocketConnectionPool pool(MakeFactory());
+
+    pool.Prewarm(kUsServer, "token");
+    ASSERT_EQ(created_.size(), 1u);
+    EXPECT_EQ(created_[0]->connect_calls, 1);
+    EXPECT_EQ(created_[0]->auth_token, "token");
+
+    // Still handshaking: a fresh connection is handed out and the standby stays
+    auto while_warming = pool.Acquire(kUsServer);
+    EXPECT_NE(while_warming, created_[0]);
+    EXPECT_EQ(created_[0]->disconnect_calls, 0);
+
+    created_[0]->connected = true;
+    EXPECT_EQ(pool.Acquire(kUsServer), created_[0]);
+}
+
+TEST_F(WebSocketConnectionPoolTest, IdleLimitAndTimeoutCloseConnections) {
+    WebSocketPoolConfig config;
+    config.max_idle_per_url = 1;
+    config.idle_timeout = std::chrono::milliseconds(0);
+    WebSocketConnectionPool pool(MakeFactory(), config);
+
+    auto first = pool.Acquire(kEuServer);
+    auto second = pool.Acquire(kEuServer);
+    created_[0]->connected = true;
+    created_[1]->connected = true;
+
+    pool.Release(kEuServer, first);
+    pool.Release(kEuServer, second);
+    EXPECT_EQ(created_[1]->disconnect_calls, 1);
+
+    // With a zero idle timeout the remaining one has expired by the next use
+    auto third = pool.Acquire(kEuServer);
+    EXPECT_NE(third, first);
+    EXPECT_EQ(created_[0]->disconnect_calls, 1);
+    EXPECT_EQ(pool.GetStatistics().discarded, 2u);
+}
@@ -0,0 +1,73 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "transport_preference.h"
+#include "core/multiplayer/common/build_policy.h"
+
+#include <algorithm>
+
+namespace Core::Multiplayer::ModelA {
+
+namespace {
+// Whether the multiaddress has the protocol component name, e.g. "tcp"
+bool HasComponent(std::string_view multiaddr, std::string_view name) {
+    size_t position = 0;
+    while ((position = multiaddr.find(name, position)) != std::string_view::npos) {
+        const bool starts = position > 0 && multiaddr[position - 1] == '/';
+        const size_t end = position + name.size();
+        const bool ends = end == multiaddr.size() || multiaddr[end] == '/';
+        if (starts && ends) {
+            return true;
+        }
+        position = end;
+    }
+    return false;
+}
+} // namespace
+
+P2PTransport ClassifyMultiaddr(std::string_view multiaddr) {
+    if (HasComponent(multiaddr, "p2p-circuit")) {
+        return P2PTransport::Relay;
+    }
+    if (HasComponent(multiaddr, "udp") &&
+        (HasComponent(multiaddr, "quic-v1") || HasComponent(multiaddr, "quic"))) {
+        return P2PTransport::Quic;
+    }
+    if (HasComponent(multiaddr, "tcp")) {
+        if (HasComponent(multiaddr, "ws") || HasComponent(multiaddr, "wss")) {
+            return P2PTransport::WebSocket;
+        }
+        return P2PTransport::Tcp;
+    }
+    return P2PTransport::Unknown;
+}
+
+bool IsTransportEnabled(P2PTransport transport, const P2PNetworkConfig& config) {
+    switch (transport) {
+    case P2PTransport::Tcp:
+        return ActiveBuildPolicy::Transports::tcp && config.enable_tcp;
+    case P2PTransport::Quic:
+        return ActiveBuildPolicy::Transports::quic && config.enable_quic;
+    case P2PTransport::WebSocket:
+        return ActiveBuildPolicy::Transports::websocket && config.enable_websocket;
+    case P2PTransport::Relay:
+    case P2PTransport::Unknown:
+        return true;
+    }
+    return true;
+}
+
+std::vector<std::string> OrderDialAddresses(std::vector<std::string> multiaddrs,
+                                            const P2PNetworkConfig& config) {
+    std::erase_if(multiaddrs, [&config](const std::string& multiaddr) {
+        return !IsTransportEnabled(ClassifyMultiaddr(multiaddr), config);
+    });
+    if (config.prefer_quic) {
+        std::stable_partition(multiaddrs.begin(), multiaddrs.end(), [](const std::string& multiaddr) {
+            return ClassifyMultiaddr(multiaddr) == P2PTransport::Quic;
+        });
+    }
+    return multiaddrs;
+}
+
+} // namespace Core::Multiplayer::ModelA
@@ -0,0 +1,43 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "p2p_types.h"
+
+namespace Core::Multiplayer::ModelA {
+
+/**
+ * Transport a multiaddress dials over
+ */
+enum class P2PTransport : uint8_t {
+    Unknown,
+    Tcp,
+    Quic,      // /udp/<port>/quic-v1
+    WebSocket, // /tcp/<port>/ws or /wss
+    Relay,     // Through a /p2p-circuit
+};
+
+P2PTransport ClassifyMultiaddr(std::string_view multiaddr);
+
+/**
+ * Whether the build policy and config let this node dial the transport.
+ * Relayed and unrecognized addresses are left to libp2p.
+ */
+bool IsTransportEnabled(P2PTransport transport, const P2PNetworkConfig& config);
+
+/**
+ * Dial order for a peer's addresses: those of disabled transports are
+ * dropped and, with prefer_quic, QUIC addresses move ahead of the rest.
+ * Otherwise the given order, which puts the last working address first,
+ * is kept.
+ */
+std::vector<std::string> OrderDialAddresses(std::vector<std::string> multiaddrs,
+                                            const P2PNetworkConfig& config);
+
+} // namespace Core::Multiplayer::ModelA
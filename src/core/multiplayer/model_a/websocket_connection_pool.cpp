@@ -0,0 +1,197 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "websocket_connection_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace Core::Multiplayer::ModelA {
+
+WebSocketConnectionPool::WebSocketConnectionPool(ConnectionFactory factory,
+                                                 WebSocketPoolConfig config)
+    : factory_(std::move(factory)), config_(config) {}
+
+WebSocketConnectionPool::~WebSocketConnectionPool() {
+    Clear();
+}
+
+std::shared_ptr<IWebSocketConnection> WebSocketConnectionPool::Acquire(const std::string& url) {
+    std::vector<std::shared_ptr<IWebSocketConnection>> closed;
+    std::shared_ptr<IWebSocketConnection> connection;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        PruneLocked(url, std::chrono::steady_clock::now(), closed);
+
+        auto it = idle_.find(url);
+        if (it != idle_.end()) {
+            // Most recently released first; standby connections still
+            // handshaking stay in the pool
+            auto& entries = it->second;
+            auto entry = std::find_if(entries.rbegin(), entries.rend(), [](const IdleConnection& idle) {
+                return idle.connection->IsConnected();
+            });
+            if (entry != entries.rend()) {
+                connection = std::move(entry->connection);
+                entries.erase(std::next(entry).base());
+                ++stats_.reused;
+            }
+        }
+
+        if (!connection) {
+            connection = CreateLocked(url);
+        }
+    }
+
+    for (auto& stale : closed) {
+        stale->Disconnect("Idle connection expired");
+    }
+    return connection;
+}
+
+void WebSocketConnectionPool::Release(const std::string& url,
+                                      std::shared_ptr<IWebSocketConnection> connection) {
+    if (!connection) {
+        return;
+    }
+
+    DetachCallbacks(*connection);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        CacheTicketLocked(url, *connection);
+
+        if (connection->IsConnected()) {
+            auto& entries = idle_[url];
+            if (entries.size() < config_.max_idle_per_url) {
+                entries.push_back({std::move(connection), std::chrono::steady_clock::now()});
+                return;
+            }
+        }
+        ++stats_.discarded;
+    }
+
+    if (connection->IsConnected()) {
+        connection->Disconnect("Connection pool full");
+    }
+}
+
+void WebSocketConnectionPool::Prewarm(const std::string& url, const std::string& auth_token) {
+    std::vector<std::shared_ptr<IWebSocketConnection>> closed;
+    std::shared_ptr<IWebSocketConnection> connection;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        PruneLocked(url, std::chrono::steady_clock::now(), closed);
+
+        auto& entries = idle_[url];
+        if (entries.size() < config_.max_idle_per_url) {
+            connection = CreateLocked(url);
+            DetachCallbacks(*connection);
+            entries.push_back({connection, std::chrono::steady_clock::now(), true});
+        }
+    }
+
+    for (auto& stale : closed) {
+        stale->Disconnect("Idle connection expired");
+    }
+
+    if (connection) {
+        connection->SetAuthToken(auth_token);
+        connection->SetCompression(config_.compression);
+        connection->Connect(url);
+    }
+}
+
+size_t WebSocketConnectionPool::GetIdleCount(const std::string& url) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = idle_.find(url);
+    if (it == idle_.end()) {
+        return 0;
+    }
+    return static_cast<size_t>(
+        std::count_if(it->second.begin(), it->second.end(), [](const IdleConnection& idle) {
+            return idle.connection->IsConnected();
+        }));
+}
+
+bool WebSocketConnectionPool::HasSessionTicket(const std::string& url) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return session_tickets_.count(url) != 0;
+}
+
+WebSocketPoolStatistics WebSocketConnectionPool::GetStatistics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void WebSocketConnectionPool::Clear() {
+    std::unordered_map<std::string, std::vector<IdleConnection>> idle;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& [url, entries] : idle_) {
+            for (const auto& entry : entries) {
+                CacheTicketLocked(url, *entry.connection);
+            }
+        }
+        idle.swap(idle_);
+    }
+
+    for (auto& [url, entries] : idle) {
+        for (auto& entry : entries) {
+            entry.connection->Disconnect("Connection pool cleared");
+        }
+    }
+}
+
+std::shared_ptr<IWebSocketConnection> WebSocketConnectionPool::CreateLocked(const std::string& url) {
+    auto connection = factory_();
+    ++stats_.created;
+
+    const auto ticket = session_tickets_.find(url);
+    if (ticket != session_tickets_.end()) {
+        connection->SetTlsSessionTicket(ticket->second);
+        ++stats_.resumed;
+    }
+    return connection;
+}
+
+void WebSocketConnectionPool::PruneLocked(
+    const std::string& url, std::chrono::steady_clock::time_point now,
+    std::vector<std::shared_ptr<IWebSocketConnection>>& out_closed) {
+    auto it = idle_.find(url);
+    if (it == idle_.end()) {
+        return;
+    }
+
+    auto& entries = it->second;
+    auto stale = std::stable_partition(entries.begin(), entries.end(), [&](const IdleConnection& idle) {
+        const bool expired = now - idle.idle_since >= config_.idle_timeout;
+        const bool dropped = !idle.warming && !idle.connection->IsConnected();
+        return !expired && !dropped;
+    });
+
+    for (auto entry = stale; entry != entries.end(); ++entry) {
+        CacheTicketLocked(url, *entry->connection);
+        out_closed.push_back(std::move(entry->connection));
+        ++stats_.discarded;
+    }
+    entries.erase(stale, entries.end());
+}
+
+void WebSocketConnectionPool::CacheTicketLocked(const std::string& url,
+                                                const IWebSocketConnection& connection) {
+    auto ticket = connection.GetTlsSessionTicket();
+    if (!ticket.empty()) {
+        session_tickets_[url] = std::move(ticket);
+    }
+}
+
+void WebSocketConnectionPool::DetachCallbacks(IWebSocketConnection& connection) {
+    connection.SetOnConnectCallback([]() {});
+    connection.SetOnDisconnectCallback([](const std::string&) {});
+    connection.SetOnErrorCallback([](const std::string&) {});
+    connection.SetOnMessageViewCallback([](const WebSocketMessageView&) {});
+    connection.SetOnMessageCallback([](const std::string&) {});
+}
+
+} // namespace Core::Multiplayer::ModelA
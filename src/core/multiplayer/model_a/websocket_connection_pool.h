@@ -0,0 +1,104 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "i_websocket_connection.h"
+
+namespace Core::Multiplayer::ModelA {
+
+/**
+ * Limits for connections kept open between uses
+ */
+struct WebSocketPoolConfig {
+    size_t max_idle_per_url = 2;
+    std::chrono::milliseconds idle_timeout{60000};
+    // Offered by prewarmed connections, as RoomClient offers it on connect
+    PerMessageDeflateConfig compression;
+};
+
+struct WebSocketPoolStatistics {
+    uint64_t created = 0;
+    uint64_t reused = 0;
+    uint64_t resumed = 0;   // Created with a cached TLS session ticket
+    uint64_t discarded = 0;
+};
+
+/**
+ * WebSocket Connection Pool - Keep-alive reuse of room server connections
+ *
+ * Connections are keyed by room server URL. A connection released while
+ * still open is kept idle and handed to the next Acquire for that URL, so
+ * switching back to a recently used server skips the TCP, TLS and WebSocket
+ * handshakes. Prewarm opens a standby connection ahead of time.
+ *
+ * The TLS session ticket of every released connection is cached per URL
+ * and applied to new connections, letting a reconnect resume the session
+ * instead of doing a full handshake.
+ *
+ * Pooled connections have their callbacks detached; the caller installs
+ * its own after Acquire.
+ */
+class WebSocketConnectionPool {
+public:
+    using ConnectionFactory = std::function<std::shared_ptr<IWebSocketConnection>()>;
+
+    explicit WebSocketConnectionPool(ConnectionFactory factory,
+                                     WebSocketPoolConfig config = WebSocketPoolConfig{});
+    ~WebSocketConnectionPool();
+
+    WebSocketConnectionPool(const WebSocketConnectionPool&) = delete;
+    WebSocketConnectionPool& operator=(const WebSocketConnectionPool&) = delete;
+
+    /**
+     * Returns an open idle connection for the URL when there is one,
+     * otherwise a new unconnected one for the caller to connect
+     */
+    std::shared_ptr<IWebSocketConnection> Acquire(const std::string& url);
+
+    // Keeps the connection for reuse if it is still open and there is room
+    void Release(const std::string& url, std::shared_ptr<IWebSocketConnection> connection);
+
+    // Opens a standby connection; it becomes available once connected
+    void Prewarm(const std::string& url, const std::string& auth_token);
+
+    size_t GetIdleCount(const std::string& url) const;
+    bool HasSessionTicket(const std::string& url) const;
+    WebSocketPoolStatistics GetStatistics() const;
+
+    // Closes every idle connection; cached session tickets are kept
+    void Clear();
+
+private:
+    struct IdleConnection {
+        std::shared_ptr<IWebSocketConnection> connection;
+        std::chrono::steady_clock::time_point idle_since;
+        bool warming = false;  // Prewarmed and possibly still handshaking
+    };
+
+    std::shared_ptr<IWebSocketConnection> CreateLocked(const std::string& url);
+    void PruneLocked(const std::string& url, std::chrono::steady_clock::time_point now,
+                     std::vector<std::shared_ptr<IWebSocketConnection>>& out_closed);
+    void CacheTicketLocked(const std::string& url, const IWebSocketConnection& connection);
+
+    static void DetachCallbacks(IWebSocketConnection& connection);
+
+    ConnectionFactory factory_;
+    WebSocketPoolConfig config_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::vector<IdleConnection>> idle_;
+    std::unordered_map<std::string, std::vector<uint8_t>> session_tickets_;
+    WebSocketPoolStatistics stats_;
+};
+
+} // namespace Core::Multiplayer::ModelA
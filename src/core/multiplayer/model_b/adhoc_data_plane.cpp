@@ -0,0 +1,387 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "adhoc_data_plane.h"
+#include "../common/crc32c.h"
+#include "../common/thread_policy.h"
+
+#ifdef _WIN32
+#include "platform/windows/windows_capability_detector.h"
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace Core::Multiplayer::ModelB {
+
+namespace {
+
+constexpr uint8_t HEADER_MAGIC = 0xAD;
+constexpr uint8_t FLAG_GROUP = 0x01;  // Sent to the multicast group
+constexpr uint8_t FLAG_CRC32C = 0x02; // Ends in a CRC32C trailer
+constexpr uint8_t FLAG_CONTROL = 0x04; // For the control sink
+
+constexpr std::chrono::milliseconds RECEIVE_POLL_INTERVAL{50};
+
+} // namespace
+
+AdHocDataPlane::AdHocDataPlane(AdHocDataPlaneConfig config) : config_(std::move(config)) {}
+
+AdHocDataPlane::~AdHocDataPlane() {
+    Close();
+}
+
+ErrorCode AdHocDataPlane::Open(uint8_t local_node_id) {
+    if (socket_.IsOpen()) {
+        return ErrorCode::InvalidState;
+    }
+    if (local_node_id >= MAX_NODES) {
+        return ErrorCode::InvalidParameter;
+    }
+
+    DatagramSocketOptions options;
+    // Other processes on this host may be in the same group
+    options.reuse_address = true;
+#ifdef _WIN32
+    options.registered_io =
+        config_.registered_io && Windows::WindowsCapabilityDetector::IsRegisteredIoSupported();
+#endif
+    ErrorCode result = socket_.Open(config_.bind_address, config_.port, options);
+    if (result == ErrorCode::PlatformFeatureUnavailable && options.registered_io) {
+        // Queues that could not be built, e.g. out of non-paged pool
+        options.registered_io = false;
+        result = socket_.Open(config_.bind_address, config_.port, options);
+    }
+    if (result != ErrorCode::Success) {
+        return result;
+    }
+    socket_.Tune(config_.tuning);
+
+    local_node_id_ = local_node_id;
+    staged_count_ = 0;
+    outgoing_count_ = 0;
+    last_group_receive_ns_.store(0, std::memory_order_relaxed);
+    group_joined_ = false;
+    if (config_.use_multicast &&
+        DatagramEndpoint::FromString(config_.group_address, socket_.GetLocalEndpoint().Port(),
+                                     group_endpoint_)) {
+        group_joined_ = socket_.JoinMulticastGroup(config_.group_address,
+                                                   config_.interface_address) ==
+                        ErrorCode::Success;
+    }
+    return ErrorCode::Success;
+}
+
+void AdHocDataPlane::Close() {
+    Stop();
+    socket_.Close();
+    group_joined_ = false;
+    staged_count_ = 0;
+    outgoing_count_ = 0;
+    ClearNodes();
+}
+
+bool AdHocDataPlane::IsOpen() const {
+    return socket_.IsOpen();
+}
+
+DatagramEndpoint AdHocDataPlane::GetLocalEndpoint() const {
+    return socket_.GetLocalEndpoint();
+}
+
+void AdHocDataPlane::SetNodeEndpoint(uint8_t node_id, const DatagramEndpoint& endpoint) {
+    if (node_id >= MAX_NODES || node_id == local_node_id_) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(nodes_mutex_);
+    endpoints_[node_id].Store(endpoint);
+    if (peers_known_since_ns_.load(std::memory_order_relaxed) == 0) {
+        peers_known_since_ns_.store(Now(), std::memory_order_relaxed);
+    }
+}
+
+void AdHocDataPlane::RemoveNode(uint8_t node_id) {
+    if (node_id >= MAX_NODES) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(nodes_mutex_);
+    endpoints_[node_id].Store(DatagramEndpoint{});
+    const bool any_known = std::any_of(endpoints_.begin(), endpoints_.end(),
+                                       [](const auto& entry) { return entry.Load().IsValid(); });
+    if (!any_known) {
+        peers_known_since_ns_.store(0, std::memory_order_relaxed);
+    }
+}
+
+void AdHocDataPlane::ClearNodes() {
+    std::lock_guard<std::mutex> lock(nodes_mutex_);
+    for (auto& endpoint : endpoints_) {
+        endpoint.Store(DatagramEndpoint{});
+    }
+    peers_known_since_ns_.store(0, std::memory_order_relaxed);
+}
+
+bool AdHocDataPlane::UseMulticast(uint64_t now_ns) const {
+    if (!group_joined_) {
+        return false;
+    }
+    const auto timeout_ns = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(config_.multicast_timeout).count());
+    const uint64_t last_group = last_group_receive_ns_.load(std::memory_order_relaxed);
+    if (last_group != 0 && now_ns - last_group < timeout_ns) {
+        return true;
+    }
+    // Peers get one timeout to show up in the group before it is written off
+    const uint64_t known_since = peers_known_since_ns_.load(std::memory_order_relaxed);
+    return known_since == 0 || now_ns - known_since < timeout_ns;
+}
+
+ErrorCode AdHocDataPlane::Send(uint8_t node_id, const uint8_t* data, size_t size) {
+    return Stage(node_id, data, size, 0);
+}
+
+ErrorCode AdHocDataPlane::SendLatest(uint8_t node_id, const uint8_t* data, size_t size,
+                                     uint64_t key) {
+    return Stage(node_id, data, size, 0, key);
+}
+
+ErrorCode AdHocDataPlane::SendControl(uint8_t node_id, const uint8_t* data, size_t size) {
+    return Stage(node_id, data, size, FLAG_CONTROL);
+}
+
+ErrorCode AdHocDataPlane::Stage(uint8_t node_id, const uint8_t* data, size_t size,
+                                uint8_t flags, std::optional<uint64_t> key) {
+    if (!socket_.IsOpen()) {
+        return ErrorCode::NotInitialized;
+    }
+    if (size > MAX_PAYLOAD_SIZE) {
+        return ErrorCode::MessageTooLarge;
+    }
+    const bool broadcast = node_id == BROADCAST_NODE_ID;
+    if (!broadcast && node_id >= MAX_NODES) {
+        return ErrorCode::InvalidParameter;
+    }
+
+    if (key) {
+        for (size_t i = 0; i < staged_count_; ++i) {
+            StagedPacket& staged = staged_[i];
+            if (staged_keys_[i] != key || staged.header[3] != node_id) {
+                continue;
+            }
+            // Every copy already points at this packet; only the tail changes
+            const size_t tail_size = WritePayload(staged, data, size);
+            for (size_t j = 0; j < outgoing_count_; ++j) {
+                if (outgoing_[j].data == staged.header.data()) {
+                    outgoing_[j].tail = tail_size != 0 ? staged.payload.data() : nullptr;
+                    outgoing_[j].tail_size = tail_size;
+                }
+            }
+            replaced_.fetch_add(1, std::memory_order_relaxed);
+            return ErrorCode::Success;
+        }
+    }
+
+    // Work out every destination before staging anything
+    std::array<DatagramEndpoint, MAX_NODES> destinations{};
+    size_t destination_count = 0;
+    const bool multicast = broadcast && UseMulticast(Now());
+    if (multicast) {
+        destinations[destination_count++] = group_endpoint_;
+    } else if (broadcast) {
+        for (uint8_t node = 0; node < MAX_NODES; ++node) {
+            const DatagramEndpoint endpoint = endpoints_[node].Load();
+            if (node != local_node_id_ && endpoint.IsValid()) {
+                destinations[destination_count++] = endpoint;
+            }
+        }
+        if (destination_count == 0) {
+            return ErrorCode::Success; // Nobody to reach yet
+        }
+    } else {
+        destinations[destination_count] = endpoints_[node_id].Load();
+        if (!destinations[destination_count].IsValid()) {
+            return ErrorCode::NotConnected;
+        }
+        ++destination_count;
+    }
+
+    if (staged_count_ == MAX_STAGED || outgoing_count_ + destination_count > MAX_STAGED) {
+        // Staged datagrams that did not fit the socket buffer are lost like
+        // any other UDP datagram; this one still goes out
+        (void)Flush();
+    }
+
+    staged_keys_[staged_count_] = key;
+    StagedPacket& staged = staged_[staged_count_++];
+    flags |= (multicast ? FLAG_GROUP : uint8_t{0}) |
+             (config_.integrity_check ? FLAG_CRC32C : uint8_t{0});
+    staged.header = {HEADER_MAGIC, flags, local_node_id_, node_id};
+    const size_t tail_size = WritePayload(staged, data, size);
+    for (size_t i = 0; i < destination_count; ++i) {
+        destinations_[outgoing_count_] = destinations[i];
+        OutgoingDatagram& datagram = outgoing_[outgoing_count_];
+        datagram.data = staged.header.data();
+        datagram.size = HEADER_SIZE;
+        datagram.tail = tail_size != 0 ? staged.payload.data() : nullptr;
+        datagram.tail_size = tail_size;
+        datagram.to = &destinations_[outgoing_count_];
+        ++outgoing_count_;
+    }
+    return ErrorCode::Success;
+}
+
+size_t AdHocDataPlane::WritePayload(StagedPacket& staged, const uint8_t* data,
+                                    size_t size) const {
+    if (size != 0) {
+        std::memcpy(staged.payload.data(), data, size);
+    }
+    if (!config_.integrity_check) {
+        return size;
+    }
+    uint32_t crc = Crc32c(staged.header);
+    crc = Crc32c(std::span(staged.payload.data(), size), crc);
+    for (size_t i = 0; i < TRAILER_SIZE; ++i) {
+        staged.payload[size + i] = static_cast<uint8_t>(crc >> (8 * i));
+    }
+    return size + TRAILER_SIZE;
+}
+
+ErrorCode AdHocDataPlane::Flush() {
+    if (outgoing_count_ == 0) {
+        return ErrorCode::Success;
+    }
+    const size_t sent = socket_.SendBatch(outgoing_.data(), outgoing_count_);
+    send_batches_.fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t group = 0;
+    for (size_t i = 0; i < sent; ++i) {
+        if ((outgoing_[i].data[1] & FLAG_GROUP) != 0) {
+            ++group;
+        }
+    }
+    group_sent_.fetch_add(group, std::memory_order_relaxed);
+    unicast_sent_.fetch_add(sent - group, std::memory_order_relaxed);
+
+    const bool complete = sent == outgoing_count_;
+    staged_count_ = 0;
+    outgoing_count_ = 0;
+    return complete ? ErrorCode::Success : ErrorCode::MessageQueueFull;
+}
+
+ErrorCode AdHocDataPlane::Start(ReceiveSink sink, ControlSink control_sink) {
+    if (!socket_.IsOpen()) {
+        return ErrorCode::NotInitialized;
+    }
+    if (receiving_.load(std::memory_order_acquire)) {
+        return ErrorCode::InvalidState;
+    }
+    sink_ = std::move(sink);
+    control_sink_ = std::move(control_sink);
+    receiving_.store(true, std::memory_order_release);
+    receive_thread_ = SpawnThread(ThreadRole::NetworkIo, "mp-adhoc-rx", [this] { ReceiveLoop(); });
+    return ErrorCode::Success;
+}
+
+void AdHocDataPlane::Stop() {
+    receiving_.store(false, std::memory_order_release);
+    if (receive_thread_.joinable()) {
+        receive_thread_.join();
+    }
+    sink_ = nullptr;
+    control_sink_ = nullptr;
+}
+
+void AdHocDataPlane::ReceiveLoop() {
+    std::array<DatagramReceiveSlot, RECEIVE_BATCH> slots{};
+    while (receiving_.load(std::memory_order_acquire)) {
+        if (!socket_.WaitReadable(RECEIVE_POLL_INTERVAL)) {
+            continue;
+        }
+        for (size_t i = 0; i < RECEIVE_BATCH; ++i) {
+            slots[i].buffer = receive_buffers_[i].data();
+            slots[i].capacity = receive_buffers_[i].size();
+        }
+        const size_t count = socket_.ReceiveBatch(slots.data(), slots.size());
+        const uint64_t now = Now();
+        for (size_t i = 0; i < count; ++i) {
+            HandleDatagram(slots[i], now);
+        }
+    }
+}
+
+void AdHocDataPlane::HandleDatagram(const DatagramReceiveSlot& slot, uint64_t now_ns) {
+    if (slot.truncated || slot.size < HEADER_SIZE || slot.buffer[0] != HEADER_MAGIC) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    size_t size = slot.size;
+    if (config_.integrity_check) {
+        // Little endian, over everything before it
+        if ((slot.buffer[1] & FLAG_CRC32C) == 0 || size < HEADER_SIZE + TRAILER_SIZE) {
+            integrity_failures_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        size -= TRAILER_SIZE;
+        uint32_t expected = 0;
+        for (size_t i = 0; i < TRAILER_SIZE; ++i) {
+            expected |= uint32_t{slot.buffer[size + i]} << (8 * i);
+        }
+        if (Crc32c(std::span(slot.buffer, size)) != expected) {
+            integrity_failures_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    } else if ((slot.buffer[1] & FLAG_CRC32C) != 0) {
+        // From a node set up differently; the trailer goes unchecked
+        if (size < HEADER_SIZE + TRAILER_SIZE) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        size -= TRAILER_SIZE;
+    }
+
+    const bool group = (slot.buffer[1] & FLAG_GROUP) != 0;
+    const uint8_t source = slot.buffer[2];
+    const uint8_t destination = slot.buffer[3];
+    if (source >= MAX_NODES || source == local_node_id_ ||
+        (destination != local_node_id_ && destination != BROADCAST_NODE_ID)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (group) {
+        last_group_receive_ns_.store(now_ns, std::memory_order_relaxed);
+        group_received_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        unicast_received_.fetch_add(1, std::memory_order_relaxed);
+    }
+    // A node that reached us can be answered at the address it sent from
+    if (!endpoints_[source].Load().IsValid()) {
+        SetNodeEndpoint(source, slot.from);
+    }
+
+    const ReceiveSink& sink = (slot.buffer[1] & FLAG_CONTROL) != 0 ? control_sink_ : sink_;
+    if (sink) {
+        sink(source, slot.buffer + HEADER_SIZE, size - HEADER_SIZE);
+    }
+}
+
+bool AdHocDataPlane::IsMulticastActive() const {
+    return UseMulticast(Now());
+}
+
+AdHocDataPlaneStatistics AdHocDataPlane::GetStatistics() const {
+    AdHocDataPlaneStatistics statistics;
+    statistics.group_datagrams_sent = group_sent_.load(std::memory_order_relaxed);
+    statistics.unicast_datagrams_sent = unicast_sent_.load(std::memory_order_relaxed);
+    statistics.group_datagrams_received = group_received_.load(std::memory_order_relaxed);
+    statistics.unicast_datagrams_received = unicast_received_.load(std::memory_order_relaxed);
+    statistics.dropped = dropped_.load(std::memory_order_relaxed);
+    statistics.send_batches = send_batches_.load(std::memory_order_relaxed);
+    statistics.integrity_failures = integrity_failures_.load(std::memory_order_relaxed);
+    statistics.replaced = replaced_.load(std::memory_order_relaxed);
+    statistics.multicast_active = IsMulticastActive();
+    return statistics;
+}
+
+} // namespace Core::Multiplayer::ModelB
@@ -0,0 +1,211 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include "../common/datagram_socket.h"
+#include "../common/error_codes.h"
+#include "../common/packet_buffer.h"
+#include "../common/seqlock.h"
+
+namespace Core::Multiplayer::ModelB {
+
+/**
+ * Where and how AdHocDataPlane sends
+ */
+struct AdHocDataPlaneConfig {
+    std::string bind_address = "0.0.0.0";
+    uint16_t port = 39990; // Every node of a session uses the same port
+    // Administratively scoped, so routers never forward it off the LAN
+    std::string group_address = "239.255.77.12";
+    // Local IPv4 address of the interface MdnsDiscovery found the session
+    // on; empty lets the system choose
+    std::string interface_address;
+    bool use_multicast = true;
+    // Broadcasts fall back to one unicast copy per node once peers are known
+    // and no group datagram has arrived for this long
+    std::chrono::milliseconds multicast_timeout{3000};
+    // Append a CRC32C of each datagram and drop datagrams without a valid
+    // one. For sessions that run unencrypted, where nothing else catches
+    // corruption; every node of the session has to agree, which the host
+    // advertises in GameSessionInfo::integrity_check.
+    bool integrity_check = false;
+    // EF marking puts LDN traffic in the WMM voice queue on Wi-Fi Direct and
+    // hotspot links
+    SocketTuningProfile tuning = SocketTuningProfile::Realtime();
+    // Windows Registered I/O wherever WindowsCapabilityDetector reports it
+    bool registered_io = true;
+};
+
+struct AdHocDataPlaneStatistics {
+    uint64_t group_datagrams_sent = 0;
+    uint64_t unicast_datagrams_sent = 0;
+    uint64_t group_datagrams_received = 0;
+    uint64_t unicast_datagrams_received = 0;
+    uint64_t dropped = 0;      // Malformed, foreign or not for this node
+    uint64_t send_batches = 0; // Flushes that reached the socket
+    uint64_t integrity_failures = 0; // Bad or missing CRC32C trailer, dropped
+    uint64_t replaced = 0; // Staged state packets a newer one overwrote
+    bool multicast_active = false;
+};
+
+/**
+ * Model B's UDP data plane for LDN packets on a local network.
+ *
+ * Most LDN traffic goes to every node, so a broadcast-addressed packet is
+ * sent once to a multicast group instead of once per node; node-addressed
+ * packets go unicast to the node's endpoint. Access points that filter
+ * multicast are detected by the absence of group datagrams from known peers,
+ * after which broadcasts go out as unicast copies until group traffic shows
+ * up again.
+ *
+ * Send() only stages a packet; Flush() hands everything staged to the
+ * socket in one SendBatch, which is a single sendmmsg on Linux and one
+ * registered I/O commit on Windows. A full stage
+ * flushes itself.
+ *
+ * Every datagram carries a 4-byte header: magic, flags, source node and
+ * destination node, and with integrity_check a 4-byte CRC32C trailer over
+ * header and payload. One thread sends; Start() runs the receive thread.
+ */
+class AdHocDataPlane {
+public:
+    static constexpr uint8_t BROADCAST_NODE_ID = 0xFF;
+    static constexpr size_t MAX_NODES = 8; // Service::LDN::NodeCountMax
+    static constexpr size_t HEADER_SIZE = 4;
+    static constexpr size_t TRAILER_SIZE = 4;
+    static constexpr size_t MAX_PAYLOAD_SIZE = PacketBuffer::capacity();
+
+    // Called on the receive thread for each packet meant for this node
+    using ReceiveSink = std::function<void(uint8_t node_id, const uint8_t* data, size_t size)>;
+    // As above, for packets sent with SendControl
+    using ControlSink = ReceiveSink;
+
+    explicit AdHocDataPlane(AdHocDataPlaneConfig config = {});
+    ~AdHocDataPlane();
+
+    AdHocDataPlane(const AdHocDataPlane&) = delete;
+    AdHocDataPlane& operator=(const AdHocDataPlane&) = delete;
+
+    /**
+     * Binds the socket and joins the group. Failing to join only disables
+     * multicast; broadcasts then go out as unicast copies.
+     */
+    [[nodiscard]] ErrorCode Open(uint8_t local_node_id);
+    void Close();
+    bool IsOpen() const;
+    DatagramEndpoint GetLocalEndpoint() const;
+
+    /**
+     * Endpoints of the session's nodes, e.g. from the hosts MdnsDiscovery
+     * resolved. Nodes that send to this one are learned as well.
+     */
+    void SetNodeEndpoint(uint8_t node_id, const DatagramEndpoint& endpoint);
+    void RemoveNode(uint8_t node_id);
+    void ClearNodes();
+
+    /**
+     * Stages a packet for node_id, or for every node with BROADCAST_NODE_ID
+     * @return NotConnected if the node has no endpoint, MessageTooLarge if
+     *         the packet exceeds MAX_PAYLOAD_SIZE
+     */
+    [[nodiscard]] ErrorCode Send(uint8_t node_id, const uint8_t* data, size_t size);
+    /**
+     * Latest-value-wins Send for state packets: a packet for the same node
+     * with the same key still staged is overwritten in place rather than
+     * sent alongside, so a frame's worth of updates to one slot costs one
+     * datagram.
+     */
+    [[nodiscard]] ErrorCode SendLatest(uint8_t node_id, const uint8_t* data, size_t size,
+                                       uint64_t key);
+    /**
+     * Stages a packet of the owner's own, e.g. a reachability probe. It is
+     * flagged as control and goes to the receiver's control sink, never to
+     * its receive sink.
+     */
+    [[nodiscard]] ErrorCode SendControl(uint8_t node_id, const uint8_t* data, size_t size);
+    // Sends everything staged
+    [[nodiscard]] ErrorCode Flush();
+
+    // Control packets are dropped without a control sink
+    [[nodiscard]] ErrorCode Start(ReceiveSink sink, ControlSink control_sink = nullptr);
+    void Stop();
+
+    bool IsMulticastActive() const;
+    AdHocDataPlaneStatistics GetStatistics() const;
+
+    static uint64_t Now() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now().time_since_epoch())
+                                         .count());
+    }
+
+private:
+    static constexpr size_t MAX_STAGED = DatagramSocket::MAX_BATCH_SIZE;
+    static constexpr size_t RECEIVE_BATCH = 16;
+
+    // A staged packet; its header, payload and trailer are shared by every copy
+    struct StagedPacket {
+        std::array<uint8_t, HEADER_SIZE> header{};
+        std::array<uint8_t, MAX_PAYLOAD_SIZE + TRAILER_SIZE> payload{};
+    };
+
+    bool UseMulticast(uint64_t now_ns) const;
+    ErrorCode Stage(uint8_t node_id, const uint8_t* data, size_t size, uint8_t flags,
+                    std::optional<uint64_t> key = std::nullopt);
+    // Copies in the payload and its trailer; returns the bytes after the header
+    size_t WritePayload(StagedPacket& staged, const uint8_t* data, size_t size) const;
+    void ReceiveLoop();
+    void HandleDatagram(const DatagramReceiveSlot& slot, uint64_t now_ns);
+
+    const AdHocDataPlaneConfig config_;
+    DatagramSocket socket_;
+    DatagramEndpoint group_endpoint_;
+    uint8_t local_node_id_ = 0;
+    bool group_joined_ = false;
+
+    // Written under nodes_mutex_, read lock-free by the send path
+    std::mutex nodes_mutex_;
+    std::array<SeqLock<DatagramEndpoint>, MAX_NODES> endpoints_{};
+    std::atomic<uint64_t> peers_known_since_ns_{0}; // 0 while no peer is known
+
+    std::atomic<uint64_t> last_group_receive_ns_{0};
+
+    // Send path only
+    std::array<StagedPacket, MAX_STAGED> staged_{};
+    std::array<std::optional<uint64_t>, MAX_STAGED> staged_keys_{};
+    std::array<DatagramEndpoint, MAX_STAGED> destinations_{};
+    std::array<OutgoingDatagram, MAX_STAGED> outgoing_{};
+    size_t staged_count_ = 0;
+    size_t outgoing_count_ = 0;
+
+    // Receive thread only
+    std::array<std::array<uint8_t, HEADER_SIZE + MAX_PAYLOAD_SIZE + TRAILER_SIZE>, RECEIVE_BATCH>
+        receive_buffers_{};
+    std::thread receive_thread_;
+    std::atomic<bool> receiving_{false};
+    ReceiveSink sink_;
+    ControlSink control_sink_;
+
+    std::atomic<uint64_t> group_sent_{0};
+    std::atomic<uint64_t> unicast_sent_{0};
+    std::atomic<uint64_t> group_received_{0};
+    std::atomic<uint64_t> unicast_received_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> send_batches_{0};
+    std::atomic<uint64_t> integrity_failures_{0};
+    std::atomic<uint64_t> replaced_{0};
+};
+
+} // namespace Core::Multiplayer::ModelB
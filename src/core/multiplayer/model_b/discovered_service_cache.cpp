@@ -0,0 +1,237 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "discovered_service_cache.h"
+
+#include <functional>
+#include <unordered_set>
+#include <utility>
+
+namespace Core::Multiplayer::ModelB {
+
+namespace {
+
+// Every address the service answered from; host_ip is normally one of them
+template <typename Visitor>
+void ForEachAddress(const GameSessionInfo& info, Visitor&& visitor) {
+    visitor(info.host_ip);
+    for (const std::string* address : {&info.host_ipv4, &info.host_ipv6}) {
+        if (!address->empty() && *address != info.host_ip) {
+            visitor(*address);
+        }
+    }
+}
+
+bool HasAddress(const GameSessionInfo& info, const std::string& address) {
+    bool found = false;
+    ForEachAddress(info, [&](const std::string& candidate) { found |= candidate == address; });
+    return found;
+}
+
+} // namespace
+
+uint64_t DiscoveredServiceCache::HashTxtPayload(std::string_view payload) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (const char c : payload) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+const std::string& DiscoveredServiceCache::KeyOf(const GameSessionInfo& info) {
+    return info.host_name.empty() ? info.host_ip : info.host_name;
+}
+
+bool DiscoveredServiceCache::RefreshIfUnchanged(const std::string& source_address,
+                                                uint64_t txt_hash, TimePoint now) {
+    const auto address_it = key_by_address_.find(source_address);
+    if (address_it == key_by_address_.end()) {
+        return false;
+    }
+
+    const auto it = entries_.find(address_it->second);
+    if (it == entries_.end() || it->second.txt_hash != txt_hash) {
+        return false;
+    }
+
+    // Same payload: only liveness changes, which is not a change for pollers
+    it->second.info.last_seen = now;
+    PushExpiry(it->first, now);
+    return true;
+}
+
+DiscoveredServiceCache::UpdateResult DiscoveredServiceCache::Upsert(
+    const GameSessionInfo& info, uint64_t txt_hash, std::optional<IPVersion> preferred) {
+    const std::string& key = KeyOf(info);
+
+    // The address now announces a different host; drop what it announced before
+    const auto address_it = key_by_address_.find(info.host_ip);
+    if (address_it != key_by_address_.end() && address_it->second != key) {
+        const auto previous = entries_.find(address_it->second);
+        if (previous != entries_.end() && HasAddress(previous->second.info, info.host_ip)) {
+            Remove(previous);
+        }
+    }
+
+    auto [it, inserted] = entries_.try_emplace(key);
+    Entry& entry = it->second;
+    GameSessionInfo merged = info;
+    if (!inserted) {
+        // Answering over one family says nothing about the other
+        if (merged.host_ipv4.empty()) {
+            merged.host_ipv4 = entry.info.host_ipv4;
+        }
+        if (merged.host_ipv6.empty()) {
+            merged.host_ipv6 = entry.info.host_ipv6;
+        }
+        merged.discovered_at = entry.info.discovered_at;
+    }
+    if (!merged.host_ipv4.empty() && !merged.host_ipv6.empty()) {
+        merged.ip_version = IPVersion::Both;
+        if (preferred == IPVersion::IPv4) {
+            merged.host_ip = merged.host_ipv4;
+        } else if (preferred == IPVersion::IPv6) {
+            merged.host_ip = merged.host_ipv6;
+        } else if (!inserted && HasAddress(merged, entry.info.host_ip)) {
+            merged.host_ip = entry.info.host_ip; // First to answer
+        }
+    }
+    if (!inserted) {
+        UnindexAddresses(entry.info, it->first);
+    }
+
+    entry.info = std::move(merged);
+    entry.txt_hash = txt_hash;
+    entry.changed_epoch = ++epoch_;
+
+    ForEachAddress(entry.info,
+                   [&](const std::string& address) { key_by_address_[address] = it->first; });
+    PushExpiry(it->first, entry.info.last_seen);
+
+    return inserted ? UpdateResult::Added : UpdateResult::Changed;
+}
+
+std::vector<GameSessionInfo> DiscoveredServiceCache::ExpireBefore(TimePoint cutoff) {
+    std::vector<GameSessionInfo> expired;
+    while (true) {
+        PruneStaleHeapTop();
+        if (expiry_heap_.empty() || expiry_heap_.top().last_seen >= cutoff) {
+            break;
+        }
+
+        const auto it = entries_.find(expiry_heap_.top().key);
+        expiry_heap_.pop();
+        expired.push_back(it->second.info);
+        Remove(it);
+    }
+    return expired;
+}
+
+std::optional<DiscoveredServiceCache::TimePoint> DiscoveredServiceCache::GetOldestLastSeen() {
+    PruneStaleHeapTop();
+    if (expiry_heap_.empty()) {
+        return std::nullopt;
+    }
+    return expiry_heap_.top().last_seen;
+}
+
+std::optional<GameSessionInfo> DiscoveredServiceCache::Find(const std::string& key) const {
+    const auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        return std::nullopt;
+    }
+    return it->second.info;
+}
+
+std::vector<GameSessionInfo> DiscoveredServiceCache::GetAll() const {
+    std::vector<GameSessionInfo> services;
+    services.reserve(entries_.size());
+    for (const auto& [key, entry] : entries_) {
+        services.push_back(entry.info);
+    }
+    return services;
+}
+
+DiscoveredServiceDelta DiscoveredServiceCache::GetChangesSince(uint64_t epoch) const {
+    DiscoveredServiceDelta delta;
+    delta.epoch = epoch_;
+
+    if (epoch > epoch_ || epoch < removal_floor_epoch_) {
+        // Unknown epoch or removals already forgotten
+        delta.full_resync = true;
+        delta.upserted = GetAll();
+        return delta;
+    }
+
+    for (const auto& [key, entry] : entries_) {
+        if (entry.changed_epoch > epoch) {
+            delta.upserted.push_back(entry.info);
+        }
+    }
+
+    std::unordered_set<std::string> reported;
+    for (auto it = removals_.rbegin(); it != removals_.rend() && it->epoch > epoch; ++it) {
+        // A key that came back is reported through upserted instead
+        if (entries_.count(it->key) == 0 && reported.insert(it->key).second) {
+            delta.removed.push_back(it->key);
+        }
+    }
+
+    return delta;
+}
+
+void DiscoveredServiceCache::Remove(EntryMap::iterator it) {
+    UnindexAddresses(it->second.info, it->first);
+
+    removals_.push_back({++epoch_, it->first});
+    if (removals_.size() > MAX_REMOVAL_HISTORY) {
+        removal_floor_epoch_ = removals_.front().epoch;
+        removals_.pop_front();
+    }
+
+    // Its heap nodes are skipped lazily once the entry is gone
+    entries_.erase(it);
+}
+
+void DiscoveredServiceCache::UnindexAddresses(const GameSessionInfo& info,
+                                              const std::string& key) {
+    ForEachAddress(info, [&](const std::string& address) {
+        const auto address_it = key_by_address_.find(address);
+        if (address_it != key_by_address_.end() && address_it->second == key) {
+            key_by_address_.erase(address_it);
+        }
+    });
+}
+
+void DiscoveredServiceCache::PushExpiry(const std::string& key, TimePoint last_seen) {
+    expiry_heap_.push({last_seen, key});
+    CompactHeapIfNeeded();
+}
+
+void DiscoveredServiceCache::PruneStaleHeapTop() {
+    while (!expiry_heap_.empty()) {
+        const HeapNode& top = expiry_heap_.top();
+        const auto it = entries_.find(top.key);
+        if (it != entries_.end() && it->second.info.last_seen == top.last_seen) {
+            return;
+        }
+        expiry_heap_.pop(); // Superseded by a later sighting or removed
+    }
+}
+
+void DiscoveredServiceCache::CompactHeapIfNeeded() {
+    // Every refresh leaves a superseded node behind; rebuild once they dominate
+    if (expiry_heap_.size() <= entries_.size() * 2 + 64) {
+        return;
+    }
+
+    std::vector<HeapNode> nodes;
+    nodes.reserve(entries_.size());
+    for (const auto& [key, entry] : entries_) {
+        nodes.push_back({entry.info.last_seen, key});
+    }
+    expiry_heap_ = decltype(expiry_heap_)(std::greater<HeapNode>(), std::move(nodes));
+}
+
+} // namespace Core::Multiplayer::ModelB
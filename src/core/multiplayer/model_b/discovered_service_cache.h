@@ -0,0 +1,163 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <memory_resource>
+#include <optional>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "../common/memory_accounting.h"
+#include "mdns_discovery.h" // For GameSessionInfo
+
+namespace Core::Multiplayer::ModelB {
+
+/**
+ * Incremental cache of services discovered over mDNS
+ *
+ * Entries are keyed by host name, falling back to the source address for
+ * hosts that do not announce one, with a secondary index by source address so
+ * a repeated announcement can be matched before it is parsed. A host that
+ * answers over both IPv4 and IPv6 is one entry indexed by both addresses. Each entry
+ * remembers a hash of its raw TXT payload; when an announcement carries the
+ * same payload only last_seen is bumped and nothing is re-parsed.
+ *
+ * Expiry uses a min-heap on last_seen with lazy deletion, so finding and
+ * dropping stale entries is O(log n) per entry instead of a full scan.
+ *
+ * Every add, change or removal advances an epoch. GetChangesSince() returns
+ * only what changed after a caller's last epoch; a bounded removal history
+ * backs this, and callers that fall behind it get a full resync.
+ *
+ * Not thread-safe; MdnsDiscovery guards it with its own mutex.
+ */
+class DiscoveredServiceCache {
+public:
+    using TimePoint = std::chrono::system_clock::time_point;
+
+    static constexpr size_t MAX_REMOVAL_HISTORY = 256;
+
+    enum class UpdateResult {
+        Added,   // New service
+        Changed, // Known service with a different TXT payload
+    };
+
+    /**
+     * Hash of a raw TXT payload (64-bit FNV-1a)
+     */
+    static uint64_t HashTxtPayload(std::string_view payload);
+
+    /**
+     * Fast path for repeated announcements: if the service last seen at the
+     * source address carried the same TXT payload, bump its last_seen
+     * @return True if handled; false if the announcement must be parsed
+     */
+    bool RefreshIfUnchanged(const std::string& source_address, uint64_t txt_hash, TimePoint now);
+
+    /**
+     * Insert or replace a parsed service. host_ip and last_seen must be set.
+     * An address the known entry has in the other family is kept, and
+     * host_ip then stays on the family that answered first unless preferred
+     * names one the entry has.
+     */
+    UpdateResult Upsert(const GameSessionInfo& info, uint64_t txt_hash,
+                        std::optional<IPVersion> preferred = std::nullopt);
+
+    /**
+     * Remove every service last seen before the cutoff
+     * @return The removed services
+     */
+    std::vector<GameSessionInfo> ExpireBefore(TimePoint cutoff);
+
+    /**
+     * Remove every service the predicate selects, e.g. when the discovery
+     * filter narrows
+     * @return The removed services
+     */
+    template <typename Predicate>
+    std::vector<GameSessionInfo> RemoveIf(Predicate&& predicate) {
+        std::vector<GameSessionInfo> removed;
+        for (auto it = entries_.begin(); it != entries_.end();) {
+            const auto next = std::next(it);
+            if (predicate(it->second.info)) {
+                removed.push_back(it->second.info);
+                Remove(it);
+            }
+            it = next;
+        }
+        return removed;
+    }
+
+    /**
+     * last_seen of the service that will expire first
+     */
+    std::optional<TimePoint> GetOldestLastSeen();
+
+    /**
+     * Visit every service without copying it
+     */
+    template <typename Visitor>
+    void ForEach(Visitor&& visitor) const {
+        for (const auto& [key, entry] : entries_) {
+            visitor(entry.info);
+        }
+    }
+
+    std::optional<GameSessionInfo> Find(const std::string& key) const;
+    std::vector<GameSessionInfo> GetAll() const;
+    size_t Size() const { return entries_.size(); }
+
+    uint64_t GetEpoch() const { return epoch_; }
+    DiscoveredServiceDelta GetChangesSince(uint64_t epoch) const;
+
+    /**
+     * Key a service is stored under
+     */
+    static const std::string& KeyOf(const GameSessionInfo& info);
+
+private:
+    struct Entry {
+        GameSessionInfo info;
+        uint64_t txt_hash = 0;
+        uint64_t changed_epoch = 0;
+    };
+
+    struct HeapNode {
+        TimePoint last_seen;
+        std::string key;
+
+        bool operator>(const HeapNode& other) const { return last_seen > other.last_seen; }
+    };
+
+    struct Removal {
+        uint64_t epoch;
+        std::string key;
+    };
+
+    using EntryMap = std::pmr::unordered_map<std::string, Entry>;
+
+    void Remove(EntryMap::iterator it);
+    void UnindexAddresses(const GameSessionInfo& info, const std::string& key);
+    void PushExpiry(const std::string& key, TimePoint last_seen);
+    void PruneStaleHeapTop();
+    void CompactHeapIfNeeded();
+
+    EntryMap entries_{GetMemoryResource(MemorySubsystem::Mdns)};
+    std::pmr::unordered_map<std::string, std::string> key_by_address_{
+        GetMemoryResource(MemorySubsystem::Mdns)};
+    std::priority_queue<HeapNode, std::vector<HeapNode>, std::greater<HeapNode>> expiry_heap_;
+
+    uint64_t epoch_ = 0;
+    std::deque<Removal> removals_;
+    uint64_t removal_floor_epoch_ = 0; // Removals at or below this are forgotten
+};
+
+} // namespace Core::Multiplayer::ModelB
@@ -0,0 +1,209 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "discovery_scheduler.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "../common/monotonic_clock.h"
+
+namespace Core::Multiplayer::ModelB {
+
+namespace {
+uint64_t ToNs(std::chrono::milliseconds duration) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+}
+} // namespace
+
+DiscoveryScheduler::DiscoveryScheduler(DiscoverySchedulerConfig config,
+                                       std::shared_ptr<TimerWheel> timer_wheel)
+    : config_(config),
+      timer_wheel_(timer_wheel ? std::move(timer_wheel) : TimerWheel::GetShared()),
+      connected_interval_(config.connected_interval) {}
+
+DiscoveryScheduler::~DiscoveryScheduler() {
+    Stop();
+}
+
+DiscoveryScheduler::ScannerId DiscoveryScheduler::AddScanner(std::string name, ScanFunction scan,
+                                                             ScanFunction suspend) {
+    std::lock_guard lock(mutex_);
+    const ScannerId id = next_scanner_id_++;
+    scanners_.push_back({id, std::move(name), std::move(scan), std::move(suspend)});
+    return id;
+}
+
+void DiscoveryScheduler::RemoveScanner(ScannerId id) {
+    {
+        std::lock_guard lock(mutex_);
+        std::erase_if(scanners_, [id](const Scanner& scanner) { return scanner.id == id; });
+    }
+    // A scan already under way holds this until it returns
+    std::lock_guard scan_lock(scan_mutex_);
+}
+
+void DiscoveryScheduler::Start() {
+    {
+        std::lock_guard lock(mutex_);
+        if (running_) {
+            return;
+        }
+        running_ = true;
+        statistics_.phase = DiscoveryPhase::Searching;
+    }
+    // The first scan goes out on the next tick
+    Arm(std::chrono::milliseconds{0});
+}
+
+void DiscoveryScheduler::Stop() {
+    TimerWheel::TimerId timer;
+    {
+        std::lock_guard lock(mutex_);
+        running_ = false;
+        statistics_.phase = DiscoveryPhase::Stopped;
+        timer = std::exchange(timer_, TimerWheel::INVALID_TIMER_ID);
+    }
+    // Waits for a running OnTimer, which sees running_ unset and stops
+    timer_wheel_->Cancel(timer);
+}
+
+bool DiscoveryScheduler::IsRunning() const {
+    std::lock_guard lock(mutex_);
+    return running_;
+}
+
+void DiscoveryScheduler::SetSessionActive(bool active) {
+    std::lock_guard lock(mutex_);
+    if (session_active_ != active) {
+        session_active_ = active;
+        connected_interval_ = config_.connected_interval;
+    }
+}
+
+void DiscoveryScheduler::RequestScan() {
+    TimerWheel::TimerId timer;
+    {
+        std::lock_guard lock(mutex_);
+        scan_requested_ = true;
+        ++statistics_.requested_scans;
+        connected_interval_ = config_.connected_interval;
+        if (!running_) {
+            return;
+        }
+        timer = std::exchange(timer_, TimerWheel::INVALID_TIMER_ID);
+    }
+    timer_wheel_->Cancel(timer);
+    Arm(std::chrono::milliseconds{0});
+}
+
+std::chrono::milliseconds DiscoveryScheduler::Poll(uint64_t now_ns) {
+    ScanFunction scan;
+    std::vector<ScanFunction> suspends;
+    std::chrono::milliseconds delay;
+    {
+        std::lock_guard lock(mutex_);
+        const bool requested = std::exchange(scan_requested_, false);
+
+        if (!requested && IsRealtimeLocked(now_ns)) {
+            // Look again once the quiet period after the latest packet ends
+            const uint64_t quiet_end =
+                last_traffic_ns_.load(std::memory_order_relaxed) + ToNs(config_.realtime_quiet_period);
+            delay = std::max(std::chrono::milliseconds{1},
+                             std::chrono::duration_cast<std::chrono::milliseconds>(
+                                 std::chrono::nanoseconds(quiet_end - now_ns)));
+            ++statistics_.suspended_polls;
+            if (!suspended_) {
+                suspended_ = true;
+                for (const auto& scanner : scanners_) {
+                    if (scanner.suspend) {
+                        suspends.push_back(scanner.suspend);
+                    }
+                }
+            }
+            statistics_.phase = DiscoveryPhase::Suspended;
+            statistics_.next_interval = delay;
+        } else {
+            suspended_ = false;
+            if (session_active_) {
+                delay = connected_interval_;
+                connected_interval_ =
+                    std::min(connected_interval_ * 2, config_.max_connected_interval);
+                statistics_.phase = DiscoveryPhase::Connected;
+            } else {
+                delay = config_.searching_interval;
+                statistics_.phase = DiscoveryPhase::Searching;
+            }
+            if (!scanners_.empty()) {
+                scan = scanners_[next_scanner_++ % scanners_.size()].scan;
+                ++statistics_.scans;
+            }
+            statistics_.next_interval = delay;
+        }
+    }
+
+    std::lock_guard scan_lock(scan_mutex_);
+    for (const auto& suspend : suspends) {
+        suspend();
+    }
+    if (scan) {
+        scan();
+    }
+    return delay;
+}
+
+DiscoveryPhase DiscoveryScheduler::GetPhase(uint64_t now_ns) const {
+    std::lock_guard lock(mutex_);
+    if (!running_) {
+        return DiscoveryPhase::Stopped;
+    }
+    if (IsRealtimeLocked(now_ns)) {
+        return DiscoveryPhase::Suspended;
+    }
+    return session_active_ ? DiscoveryPhase::Connected : DiscoveryPhase::Searching;
+}
+
+DiscoverySchedulerStatistics DiscoveryScheduler::GetStatistics() const {
+    std::lock_guard lock(mutex_);
+    return statistics_;
+}
+
+uint64_t DiscoveryScheduler::Now() {
+    // The clock NotifyRealtimeTraffic's timestamps come from
+    return MonotonicClock::Now();
+}
+
+bool DiscoveryScheduler::IsRealtimeLocked(uint64_t now_ns) const {
+    const uint64_t last_traffic = last_traffic_ns_.load(std::memory_order_relaxed);
+    return last_traffic != 0 &&
+           (now_ns < last_traffic || now_ns - last_traffic < ToNs(config_.realtime_quiet_period));
+}
+
+void DiscoveryScheduler::Arm(std::chrono::milliseconds delay) {
+    std::lock_guard lock(mutex_);
+    if (!running_) {
+        return;
+    }
+    const uint64_t generation = ++generation_;
+    timer_ = timer_wheel_->Schedule(delay, [this, generation]() { OnTimer(generation); });
+}
+
+void DiscoveryScheduler::OnTimer(uint64_t generation) {
+    {
+        std::lock_guard lock(mutex_);
+        if (!running_ || generation != generation_) {
+            return;
+        }
+    }
+    const auto delay = Poll(Now());
+    std::lock_guard lock(mutex_);
+    if (!running_ || generation != generation_) {
+        return;
+    }
+    const uint64_t next_generation = ++generation_;
+    timer_ = timer_wheel_->Schedule(delay,
+                                    [this, next_generation]() { OnTimer(next_generation); });
+}
+
+} // namespace Core::Multiplayer::ModelB
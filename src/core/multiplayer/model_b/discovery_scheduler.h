@@ -0,0 +1,145 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../common/timer_wheel.h"
+
+namespace Core::Multiplayer::ModelB {
+
+/**
+ * Scan pacing for DiscoveryScheduler
+ */
+struct DiscoverySchedulerConfig {
+    // Between scans while no session is joined
+    std::chrono::milliseconds searching_interval{2000};
+    // First gap after joining a session; doubles with every scan after it
+    std::chrono::milliseconds connected_interval{5000};
+    std::chrono::milliseconds max_connected_interval{60000};
+    // Realtime traffic this recent suspends scanning
+    std::chrono::milliseconds realtime_quiet_period{2000};
+};
+
+enum class DiscoveryPhase : uint8_t {
+    Stopped,
+    Searching, // No session; scanning at searching_interval
+    Connected, // In a session; backing off
+    Suspended, // Realtime traffic is flowing; not scanning
+};
+
+struct DiscoverySchedulerStatistics {
+    DiscoveryPhase phase = DiscoveryPhase::Stopped;
+    uint64_t scans = 0;           // Scanner runs
+    uint64_t requested_scans = 0; // RequestScan() calls
+    uint64_t suspended_polls = 0; // Scans skipped for realtime traffic
+    std::chrono::milliseconds next_interval{0};
+};
+
+/**
+ * Decides when Model B's discovery mechanisms scan, so Wi-Fi Direct peer
+ * discovery and mDNS queries do not keep the radio busy under a running
+ * session.
+ *
+ * Scanners take turns: each due scan runs only the next registered scanner,
+ * so two mechanisms never scan at once. Before a session is joined scans are
+ * searching_interval apart; once one is joined the gap starts at
+ * connected_interval and doubles up to max_connected_interval; while
+ * realtime packets are flowing no scanner runs and each scanner's suspend
+ * function is called once to end a scan in progress. RequestScan(), for the
+ * game's Scan, runs the next scan on the following wheel tick and resets the
+ * backoff.
+ *
+ * Scans run on the timer wheel thread and must not block for long.
+ */
+class DiscoveryScheduler {
+public:
+    using ScanFunction = std::function<void()>;
+    using ScannerId = uint32_t;
+
+    explicit DiscoveryScheduler(DiscoverySchedulerConfig config = {},
+                                std::shared_ptr<TimerWheel> timer_wheel = nullptr);
+    ~DiscoveryScheduler();
+
+    DiscoveryScheduler(const DiscoveryScheduler&) = delete;
+    DiscoveryScheduler& operator=(const DiscoveryScheduler&) = delete;
+
+    /**
+     * Registers a discovery mechanism. scan starts one scan; suspend, if
+     * given, ends a scan still in progress when realtime traffic starts.
+     */
+    ScannerId AddScanner(std::string name, ScanFunction scan, ScanFunction suspend = nullptr);
+    // Waits for a scan of this scanner that is running; not from a scan itself
+    void RemoveScanner(ScannerId id);
+
+    void Start();
+    void Stop();
+    bool IsRunning() const;
+
+    void SetSessionActive(bool active);
+
+    // Data path: a realtime packet went out or came in at now_ns
+    // (DataPathLatency::Now()). A relaxed store; never blocks.
+    void NotifyRealtimeTraffic(uint64_t now_ns) {
+        last_traffic_ns_.store(now_ns, std::memory_order_relaxed);
+    }
+
+    void RequestScan();
+
+    /**
+     * Runs the scan due at now_ns, if any, and returns the delay until the
+     * next one. Called by the wheel timer while running; can also drive the
+     * scheduler directly, e.g. from a test.
+     */
+    std::chrono::milliseconds Poll(uint64_t now_ns);
+
+    DiscoveryPhase GetPhase(uint64_t now_ns) const;
+    DiscoverySchedulerStatistics GetStatistics() const;
+
+    static uint64_t Now();
+
+private:
+    struct Scanner {
+        ScannerId id = 0;
+        std::string name;
+        ScanFunction scan;
+        ScanFunction suspend;
+    };
+
+    bool IsRealtimeLocked(uint64_t now_ns) const;
+    void Arm(std::chrono::milliseconds delay);
+    void OnTimer(uint64_t generation);
+
+    const DiscoverySchedulerConfig config_;
+    std::shared_ptr<TimerWheel> timer_wheel_;
+
+    std::atomic<uint64_t> last_traffic_ns_{0};
+
+    mutable std::mutex mutex_;
+    std::vector<Scanner> scanners_;
+    ScannerId next_scanner_id_ = 1;
+    size_t next_scanner_ = 0;
+    bool running_ = false;
+    bool session_active_ = false;
+    bool scan_requested_ = false;
+    bool suspended_ = false;
+    std::chrono::milliseconds connected_interval_;
+    // Bumped on every Arm(); a timer from an older arm does not re-arm
+    uint64_t generation_ = 0;
+    TimerWheel::TimerId timer_ = TimerWheel::INVALID_TIMER_ID;
+    DiscoverySchedulerStatistics statistics_;
+
+    // Held while a scanner runs, so RemoveScanner can wait it out
+    std::mutex scan_mutex_;
+};
+
+} // namespace Core::Multiplayer::ModelB
@@ -0,0 +1,310 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "interface_monitor.h"
+#include "../common/thread_policy.h"
+
+#include <array>
+#include <utility>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#include <winsock2.h>
+#include <ws2ipdef.h>
+#include <iphlpapi.h>
+#include <netioapi.h>
+#elif defined(__APPLE__)
+#include <SystemConfiguration/SystemConfiguration.h>
+#include <dispatch/dispatch.h>
+#include <netinet/in.h>
+#endif
+
+namespace Core::Multiplayer::ModelB {
+
+#if defined(__linux__)
+
+namespace {
+
+// Wireless extension events ride on RTM_NEWLINK and fire on every scan;
+// they say nothing about addresses
+bool IsWirelessEvent(const nlmsghdr* header) {
+    if (header->nlmsg_type != RTM_NEWLINK) {
+        return false;
+    }
+    const auto* info = static_cast<const ifinfomsg*>(NLMSG_DATA(header));
+    int length = static_cast<int>(IFLA_PAYLOAD(header));
+    for (const rtattr* attribute = IFLA_RTA(info); RTA_OK(attribute, length);
+         attribute = RTA_NEXT(attribute, length)) {
+        if (attribute->rta_type == IFLA_WIRELESS) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Whether anything read from the socket reports a change
+bool DrainNetlink(int socket) {
+    alignas(nlmsghdr) std::array<uint8_t, 8192> buffer;
+    bool changed = false;
+    for (;;) {
+        const ssize_t received = recv(socket, buffer.data(), buffer.size(), MSG_DONTWAIT);
+        if (received < 0) {
+            // Overrun: events were lost, so assume one of them mattered
+            changed |= errno == ENOBUFS;
+            if (errno == EINTR || errno == ENOBUFS) {
+                continue;
+            }
+            return changed;
+        }
+        int length = static_cast<int>(received);
+        for (auto* header = reinterpret_cast<const nlmsghdr*>(buffer.data());
+             NLMSG_OK(header, length); header = NLMSG_NEXT(header, length)) {
+            switch (header->nlmsg_type) {
+            case RTM_NEWLINK:
+            case RTM_DELLINK:
+            case RTM_NEWADDR:
+            case RTM_DELADDR:
+                changed |= !IsWirelessEvent(header);
+                break;
+            default:
+                break;
+            }
+        }
+    }
+}
+
+} // namespace
+
+struct InterfaceMonitor::Platform {
+    int netlink = -1;
+    int wake = -1;
+    std::thread thread;
+
+    ~Platform() {
+        if (netlink >= 0) {
+            close(netlink);
+        }
+        if (wake >= 0) {
+            close(wake);
+        }
+    }
+};
+
+bool InterfaceMonitor::IsSupported() {
+    return true;
+}
+
+ErrorCode InterfaceMonitor::Start(ChangeCallback callback) {
+    if (running_.load(std::memory_order_acquire)) {
+        return ErrorCode::InvalidState;
+    }
+    auto platform = std::make_unique<Platform>();
+    platform->netlink = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    platform->wake = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (platform->netlink < 0 || platform->wake < 0) {
+        return ErrorCode::NetworkError;
+    }
+    sockaddr_nl address{};
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR;
+    if (bind(platform->netlink, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) !=
+        0) {
+        return ErrorCode::NetworkError;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(callback_mutex_);
+        callback_ = std::move(callback);
+        running_.store(true, std::memory_order_release);
+    }
+    platform_ = std::move(platform);
+    const int netlink = platform_->netlink;
+    const int wake = platform_->wake;
+    platform_->thread = SpawnThread(ThreadRole::Background, "mp-ifmon", [this, netlink, wake] {
+        std::array<pollfd, 2> fds{pollfd{netlink, POLLIN, 0}, pollfd{wake, POLLIN, 0}};
+        while (running_.load(std::memory_order_acquire)) {
+            if (poll(fds.data(), fds.size(), -1) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return;
+            }
+            if ((fds[1].revents & POLLIN) != 0) {
+                return;
+            }
+            if ((fds[0].revents & POLLIN) != 0 && DrainNetlink(netlink)) {
+                Notify();
+            }
+        }
+    });
+    return ErrorCode::Success;
+}
+
+void InterfaceMonitor::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(callback_mutex_);
+        running_.store(false, std::memory_order_release);
+        callback_ = nullptr;
+    }
+    if (!platform_) {
+        return;
+    }
+    const uint64_t one = 1;
+    (void)write(platform_->wake, &one, sizeof(one));
+    if (platform_->thread.joinable()) {
+        platform_->thread.join();
+    }
+    platform_.reset();
+}
+
+#elif defined(_WIN32)
+
+struct InterfaceMonitor::Platform {
+    HANDLE notification = nullptr;
+};
+
+bool InterfaceMonitor::IsSupported() {
+    return true;
+}
+
+ErrorCode InterfaceMonitor::Start(ChangeCallback callback) {
+    if (running_.load(std::memory_order_acquire)) {
+        return ErrorCode::InvalidState;
+    }
+    {
+        std::lock_guard<std::mutex> lock(callback_mutex_);
+        callback_ = std::move(callback);
+        running_.store(true, std::memory_order_release);
+    }
+    auto platform = std::make_unique<Platform>();
+    // Called on a system thread for every address and interface change
+    const auto on_change = [](PVOID context, PMIB_IPINTERFACE_ROW, MIB_NOTIFICATION_TYPE) {
+        static_cast<InterfaceMonitor*>(context)->Notify();
+    };
+    if (NotifyIpInterfaceChange(AF_UNSPEC, on_change, this, FALSE, &platform->notification) !=
+        NO_ERROR) {
+        Stop();
+        return ErrorCode::NetworkError;
+    }
+    platform_ = std::move(platform);
+    return ErrorCode::Success;
+}
+
+void InterfaceMonitor::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(callback_mutex_);
+        running_.store(false, std::memory_order_release);
+        callback_ = nullptr;
+    }
+    if (platform_ && platform_->notification) {
+        CancelMibChangeNotify2(platform_->notification);
+    }
+    platform_.reset();
+}
+
+#elif defined(__APPLE__)
+
+struct InterfaceMonitor::Platform {
+    SCNetworkReachabilityRef reachability = nullptr;
+    dispatch_queue_t queue = nullptr;
+};
+
+bool InterfaceMonitor::IsSupported() {
+    return true;
+}
+
+ErrorCode InterfaceMonitor::Start(ChangeCallback callback) {
+    if (running_.load(std::memory_order_acquire)) {
+        return ErrorCode::InvalidState;
+    }
+    auto platform = std::make_unique<Platform>();
+    // The any-address target follows every change to local reachability
+    sockaddr_in any{};
+    any.sin_len = sizeof(any);
+    any.sin_family = AF_INET;
+    platform->reachability = SCNetworkReachabilityCreateWithAddress(
+        kCFAllocatorDefault, reinterpret_cast<const sockaddr*>(&any));
+    if (!platform->reachability) {
+        return ErrorCode::NetworkError;
+    }
+    SCNetworkReachabilityContext context{0, this, nullptr, nullptr, nullptr};
+    const auto on_change = [](SCNetworkReachabilityRef, SCNetworkReachabilityFlags, void* info) {
+        static_cast<InterfaceMonitor*>(info)->Notify();
+    };
+    platform->queue = dispatch_queue_create("mp-ifmon", DISPATCH_QUEUE_SERIAL);
+    {
+        std::lock_guard<std::mutex> lock(callback_mutex_);
+        callback_ = std::move(callback);
+        running_.store(true, std::memory_order_release);
+    }
+    platform_ = std::move(platform);
+    if (!SCNetworkReachabilitySetCallback(platform_->reachability, on_change, &context) ||
+        !SCNetworkReachabilitySetDispatchQueue(platform_->reachability, platform_->queue)) {
+        Stop();
+        return ErrorCode::NetworkError;
+    }
+    return ErrorCode::Success;
+}
+
+void InterfaceMonitor::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(callback_mutex_);
+        running_.store(false, std::memory_order_release);
+        callback_ = nullptr;
+    }
+    if (!platform_) {
+        return;
+    }
+    if (platform_->reachability) {
+        SCNetworkReachabilitySetDispatchQueue(platform_->reachability, nullptr);
+        CFRelease(platform_->reachability);
+    }
+    if (platform_->queue) {
+        // Lets a callback already queued finish first
+        dispatch_sync_f(platform_->queue, nullptr, [](void*) {});
+        dispatch_release(platform_->queue);
+    }
+    platform_.reset();
+}
+
+#else
+
+struct InterfaceMonitor::Platform {};
+
+bool InterfaceMonitor::IsSupported() {
+    return false;
+}
+
+ErrorCode InterfaceMonitor::Start(ChangeCallback) {
+    return ErrorCode::NotSupported;
+}
+
+void InterfaceMonitor::Stop() {}
+
+#endif
+
+InterfaceMonitor::InterfaceMonitor() = default;
+
+InterfaceMonitor::~InterfaceMonitor() {
+    Stop();
+}
+
+bool InterfaceMonitor::IsRunning() const {
+    return running_.load(std::memory_order_acquire);
+}
+
+void InterfaceMonitor::Notify() {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    if (running_.load(std::memory_order_acquire) && callback_) {
+        callback_();
+    }
+}
+
+} // namespace Core::Multiplayer::ModelB
@@ -0,0 +1,61 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "../common/error_codes.h"
+
+namespace Core::Multiplayer::ModelB {
+
+/**
+ * Reports network interface changes as the OS announces them: links going
+ * up or down and addresses being added or removed, such as on joining a
+ * hotspot or Wi-Fi Direct group.
+ *
+ * Listens on a netlink route socket on Linux and Android, through
+ * NotifyIpInterfaceChange on Windows and SCNetworkReachability on macOS.
+ * Events are coalesced: the callback says only that something changed, so
+ * the listener re-reads the interfaces it cares about. It runs on the
+ * monitor's own thread, or on an OS thread on Windows and macOS, and never
+ * after Stop() returns.
+ */
+class InterfaceMonitor {
+public:
+    using ChangeCallback = std::function<void()>;
+
+    InterfaceMonitor();
+    ~InterfaceMonitor();
+
+    InterfaceMonitor(const InterfaceMonitor&) = delete;
+    InterfaceMonitor& operator=(const InterfaceMonitor&) = delete;
+
+    // Whether this platform can report changes at all
+    static bool IsSupported();
+
+    /**
+     * @return NotSupported on platforms without change events, where the
+     *         caller has to keep polling
+     */
+    [[nodiscard]] ErrorCode Start(ChangeCallback callback);
+    void Stop();
+    bool IsRunning() const;
+
+private:
+    struct Platform;
+
+    void Notify();
+
+    std::unique_ptr<Platform> platform_;
+    std::atomic<bool> running_{false};
+    // Held while the callback runs, so Stop() can wait it out
+    std::mutex callback_mutex_;
+    ChangeCallback callback_;
+};
+
+} // namespace Core::Multiplayer::ModelB
@@ -2,18 +2,18 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "mdns_discovery.h"
+#include "discovered_service_cache.h"
 #include "mdns_txt_records.h"
+#include "../common/startup_profile.h"
 
 #include "externals/mdns/mdns.h"
 
 #include <algorithm>
 #include <atomic>
 #include <chrono>
-#include <condition_variable>
 #include <mutex>
-#include <sstream>
-#include <thread>
 #include <unordered_map>
+#include <utility>
 
 namespace Core::Multiplayer::ModelB {
 
@@ -23,8 +23,27 @@ namespace Core::Multiplayer::ModelB {
 namespace MdnsConstants {
 constexpr const char *kMulticastIPv4 = "224.0.0.251";
 constexpr const char *kMulticastIPv6 = "ff02::fb";
+
+// Services not re-announced within this window are dropped
+constexpr std::chrono::milliseconds kServiceTtl{50}; // short timeout for tests
+
+// Query backoff doubles up to this; RFC 6762 allows an hour, but a lobby list
+// should not go stale for that long
+constexpr std::chrono::milliseconds kMaxQueryInterval{60000};
+
+// A record is multicast at most once a second per interface (RFC 6762
+// section 6); queriers asking sooner hear the earlier answer
+constexpr std::chrono::milliseconds kMinMulticastInterval{1000};
 } // namespace MdnsConstants
 
+namespace {
+// DNS-SD subtype of the service for one title, RFC 6763 section 7.1
+std::string SubtypeServiceType(uint64_t title_id,
+                               const std::string &service_type) {
+  return "_" + FormatTitleId(title_id) + "._sub." + service_type;
+}
+} // namespace
+
 // ---------------------------------------------------------------------------
 // Implementation details
 // ---------------------------------------------------------------------------
@@ -40,12 +59,64 @@ struct MdnsDiscovery::Impl {
   bool is_advertising{false};
 
   // Discovered and advertised sessions
-  std::unordered_map<std::string, GameSessionInfo>
-      discovered_services; // keyed by host ip
+  DiscoveredServiceCache discovered_services; // keyed by host name
   GameSessionInfo advertised_session;
 
+  // Encoded announcement for advertised_session; re-encoded only when one of
+  // its TXT fields changes and shared with the advertise timer without a copy
+  TxtRecordBuilder advertised_txt;
+  std::shared_ptr<const std::string> announcement;
+
+  // Apply session to the TXT records; returns true if the announcement changed
+  bool RefreshAnnouncement(const GameSessionInfo &session) {
+    if (advertised_txt.ApplyGameSession(session) == 0 && announcement) {
+      return false;
+    }
+    announcement =
+        std::make_shared<const std::string>(advertised_txt.ToAnnouncementText());
+    return true;
+  }
+
   // Active network interfaces
   std::vector<std::string> active_interfaces;
+  bool sockets_ready{false}; // Initialize succeeded
+
+  // Network each bound interface is on: its name and IPv4 address, which
+  // changes when it joins another network
+  std::unordered_map<std::string, std::string> network_of;
+  // Address family that last won the race on each network
+  std::unordered_map<std::string, IPVersion> preferred_family;
+
+  const std::string &NetworkOf(const std::string &iface) const {
+    const auto it = network_of.find(iface);
+    return it != network_of.end() ? it->second : iface;
+  }
+
+  IPVersion QueryFamilies() const {
+    return config->IsIPv6Enabled() ? IPVersion::Both : IPVersion::IPv4;
+  }
+
+  // Interfaces the provider reports up that the config allows, noting the
+  // network each is on
+  std::vector<std::string> UsableInterfaces() {
+    std::vector<std::string> usable;
+    const auto allowed = config->GetAllowedInterfaces();
+    for (const auto &iface : interface_provider->GetActiveInterfaces()) {
+      if (!iface.is_active) {
+        continue;
+      }
+      if (!allowed.empty() && std::find(allowed.begin(), allowed.end(),
+                                        iface.name) == allowed.end()) {
+        continue;
+      }
+      if (!interface_provider->IsInterfaceUsable(iface.name)) {
+        continue;
+      }
+      usable.push_back(iface.name);
+      network_of[iface.name] = iface.name + '/' + iface.ipv4_address;
+    }
+    return usable;
+  }
 
   // Callbacks
   std::function<void(const GameSessionInfo &)> on_service_discovered;
@@ -55,17 +126,68 @@ struct MdnsDiscovery::Impl {
 
   // Concurrency primitives
   mutable std::mutex mutex;
-  std::thread query_thread;
-  std::thread advertise_thread;
-  std::thread heartbeat_thread;
-  std::atomic<bool> query_running{false};
-  std::atomic<bool> advertise_running{false};
+
+  // Event loop: every periodic operation is a timer on one wheel
+  std::shared_ptr<TimerWheel> timer_wheel;
+  std::atomic<TimerWheel::TimerId> query_timer{TimerWheel::INVALID_TIMER_ID};
+  // Current gap between query rounds; doubles after each (guarded by mutex)
+  std::chrono::milliseconds query_interval{0};
+  // Bumped on every reschedule so a superseded query timer does nothing
+  uint64_t query_generation{0}; // guarded by mutex
+  std::atomic<TimerWheel::TimerId> advertise_timer{TimerWheel::INVALID_TIMER_ID};
+  std::atomic<TimerWheel::TimerId> timeout_timer{TimerWheel::INVALID_TIMER_ID};
   std::atomic<bool> heartbeat_running{false};
-  std::condition_variable query_cv;
-  std::condition_variable advertise_cv;
-  std::condition_variable heartbeat_cv;
+  std::atomic<bool> scheduled_queries{false};
+  MdnsDiscovery::PeriodicSendWindow periodic_send_window; // guarded by mutex
+  TimerWheel::TimerId expiry_timer{TimerWheel::INVALID_TIMER_ID}; // guarded by mutex
+  bool shutting_down{false};                                       // guarded by mutex
+
+  std::string query_service_type;
+  std::string advertise_service_type;
+  // Subtype the advertised title is also published under; empty if none
+  std::string advertise_subtype;
+  uint16_t advertise_port{0};
+
+  // Announcements for other titles are dropped before parsing
+  DiscoveryFilter filter;
+
+  std::string QueryServiceType() const {
+    return filter.local_communication_id
+               ? SubtypeServiceType(*filter.local_communication_id,
+                                    config->GetServiceType())
+               : config->GetServiceType();
+  }
+
+  bool MatchesFilter(std::string_view game_id) const {
+    if (!filter.local_communication_id) {
+      return true;
+    }
+    const auto title_id = ParseTitleId(game_id);
+    return title_id && *title_id == *filter.local_communication_id;
+  }
 
   std::chrono::steady_clock::time_point discovery_start;
+
+  // When the advertised service was last multicast, per interface
+  std::unordered_map<std::string, std::chrono::steady_clock::time_point>
+      last_multicast;
+
+  // Services still good for over half their TTL, for a query's known-answer
+  // list (RFC 6762 section 7.1); caller holds the mutex
+  std::vector<MdnsKnownAnswer> KnownAnswers() const {
+    std::vector<MdnsKnownAnswer> answers;
+    const auto now = std::chrono::system_clock::now();
+    discovered_services.ForEach([&](const GameSessionInfo &service) {
+      const auto remaining =
+          std::chrono::duration_cast<std::chrono::milliseconds>(
+              service.last_seen + MdnsConstants::kServiceTtl - now);
+      if (!service.host_name.empty() &&
+          remaining * 2 >= MdnsConstants::kServiceTtl) {
+        answers.push_back({service.host_name, remaining});
+      }
+    });
+    return answers;
+  }
 };
 
 // ---------------------------------------------------------------------------
@@ -74,11 +196,14 @@ struct MdnsDiscovery::Impl {
 MdnsDiscovery::MdnsDiscovery(
     std::shared_ptr<MockMdnsSocket> socket,
     std::shared_ptr<MockNetworkInterfaceProvider> interface_provider,
-    std::shared_ptr<MockMdnsConfig> config)
+    std::shared_ptr<MockMdnsConfig> config,
+    std::shared_ptr<TimerWheel> timer_wheel)
     : impl_(std::make_unique<Impl>()) {
   impl_->socket = std::move(socket);
   impl_->interface_provider = std::move(interface_provider);
   impl_->config = std::move(config);
+  impl_->timer_wheel =
+      timer_wheel ? std::move(timer_wheel) : TimerWheel::GetShared();
 }
 
 MdnsDiscovery::~MdnsDiscovery() {
@@ -86,7 +211,20 @@ MdnsDiscovery::~MdnsDiscovery() {
   StopDiscovery();
   StopAdvertising();
 
+  // Stop the expiry timer from re-arming itself, then cancel it
+  TimerWheel::TimerId expiry_timer;
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->shutting_down = true;
+    impl_->sockets_ready = false;
+    expiry_timer = std::exchange(impl_->expiry_timer, TimerWheel::INVALID_TIMER_ID);
+  }
+  impl_->timer_wheel->Cancel(expiry_timer);
+
   if (impl_->socket) {
+    impl_->socket->SetOnPacketReceivedCallback(nullptr);
+    impl_->socket->SetOnQueryReceivedCallback(nullptr);
+
     // Leave multicast groups and close socket
     impl_->socket->LeaveMulticastGroup(MdnsConstants::kMulticastIPv4);
     if (impl_->config && impl_->config->IsIPv6Enabled()) {
@@ -119,27 +257,12 @@ ErrorCode MdnsDiscovery::Initialize() {
 
   // Bind to allowed interfaces
   impl_->active_interfaces.clear();
-  auto interfaces = impl_->interface_provider->GetActiveInterfaces();
-  auto allowed = impl_->config->GetAllowedInterfaces();
-
-  for (const auto &iface : interfaces) {
-    if (!iface.is_active) {
-      continue;
-    }
-    if (!allowed.empty() && std::find(allowed.begin(), allowed.end(),
-                                      iface.name) == allowed.end()) {
-      continue;
-    }
-    if (!impl_->interface_provider->IsInterfaceUsable(iface.name)) {
-      continue;
-    }
-
-    if (!impl_->socket->BindToInterface(iface.name)) {
+  for (const auto &name : impl_->UsableInterfaces()) {
+    if (!impl_->socket->BindToInterface(name)) {
       impl_->state = DiscoveryState::Failed;
       return ErrorCode::NetworkError;
     }
-
-    impl_->active_interfaces.push_back(iface.name);
+    impl_->active_interfaces.push_back(name);
   }
 
   // Join multicast groups
@@ -155,6 +278,19 @@ ErrorCode MdnsDiscovery::Initialize() {
     }
   }
 
+  // Incoming packets are pushed by the socket rather than polled
+  impl_->socket->SetOnPacketReceivedCallback(
+      [this](const uint8_t *data, size_t size, const std::string &source,
+             const std::string &iface) {
+        ProcessIncomingPacket(data, size, source, iface);
+      });
+  impl_->socket->SetOnQueryReceivedCallback(
+      [this](const std::string &service_type, const MdnsQueryOptions &options,
+             const std::string &source, const std::string &iface) {
+        ProcessIncomingQuery(service_type, options, source, iface);
+      });
+
+  impl_->sockets_ready = true;
   impl_->state = DiscoveryState::Initialized;
   return ErrorCode::Success;
 }
@@ -163,43 +299,122 @@ ErrorCode MdnsDiscovery::Initialize() {
 // Discovery
 // ---------------------------------------------------------------------------
 ErrorCode MdnsDiscovery::StartDiscovery() {
-  std::lock_guard<std::mutex> lock(impl_->mutex);
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
 
-  if (impl_->is_running) {
-    return ErrorCode::AlreadyConnected;
+    if (impl_->is_running) {
+      return ErrorCode::AlreadyConnected;
+    }
+    if (impl_->state != DiscoveryState::Initialized &&
+        impl_->state != DiscoveryState::Advertising) {
+      return ErrorCode::InvalidParameter;
+    }
+
+    impl_->query_service_type = impl_->QueryServiceType();
+    impl_->is_running = true;
+    impl_->state = DiscoveryState::Discovering;
+    impl_->discovery_start = std::chrono::steady_clock::now();
   }
-  if (impl_->state != DiscoveryState::Initialized &&
-      impl_->state != DiscoveryState::Advertising) {
-    return ErrorCode::InvalidParameter;
+  BeginStartupPhase(StartupPhase::MdnsFirstResult);
+
+  // The initial queries ask for unicast answers, so a host joining a busy LAN
+  // does not set every responder multicasting at once
+  SendQueryRound(true);
+
+  // Re-query with backoff; the first repeat is one interval after the
+  // initial queries above
+  CancelTimer(impl_->query_timer);
+  if (impl_->scheduled_queries) {
+    return ErrorCode::Success;
+  }
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (!impl_->is_running) {
+      return ErrorCode::Success;
+    }
+    impl_->query_interval = impl_->config->GetAdvertiseInterval();
+    ScheduleQuery(impl_->query_interval);
   }
 
-  const auto service_type = impl_->config->GetServiceType();
-  for (const auto &iface : impl_->active_interfaces) {
-    impl_->socket->SendQuery(service_type, MDNS_RECORDTYPE_PTR, iface);
+  StartHeartbeat();
+
+  return ErrorCode::Success;
+}
+
+void MdnsDiscovery::SetScheduledQueries(bool scheduled) {
+  if (impl_->scheduled_queries.exchange(scheduled) == scheduled) {
+    return;
+  }
+  if (scheduled) {
+    CancelTimer(impl_->query_timer);
+    StopHeartbeat();
+    return;
   }
 
-  impl_->is_running = true;
-  impl_->state = DiscoveryState::Discovering;
-  impl_->discovery_start = std::chrono::steady_clock::now();
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (!impl_->is_running) {
+      return;
+    }
+    impl_->query_interval = impl_->config->GetAdvertiseInterval();
+    ScheduleQuery(impl_->query_interval);
+  }
+  StartHeartbeat();
+}
 
-  // Start periodic query loop
-  impl_->query_running = true;
-  auto interval = impl_->config->GetAdvertiseInterval();
-  impl_->query_thread = std::thread([this, service_type, interval]() {
-    std::unique_lock<std::mutex> lock(impl_->mutex);
-    while (impl_->query_running) {
-      lock.unlock();
-      for (const auto &iface : impl_->active_interfaces) {
-        impl_->socket->SendQuery(service_type, MDNS_RECORDTYPE_PTR, iface);
+void MdnsDiscovery::SetDiscoveryFilter(const DiscoveryFilter &filter) {
+  std::vector<GameSessionInfo> removed;
+  std::function<void(const std::string &)> callback;
+  TimerWheel::TimerId superseded_query = TimerWheel::INVALID_TIMER_ID;
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (impl_->filter == filter) {
+      // Scan sets the filter on every call
+      return;
+    }
+    impl_->filter = filter;
+    if (impl_->is_running) {
+      impl_->query_service_type = impl_->QueryServiceType();
+      // The new type has no answers yet; start its backoff from the bottom
+      if (!impl_->scheduled_queries) {
+        superseded_query =
+            impl_->query_timer.exchange(TimerWheel::INVALID_TIMER_ID);
+        impl_->query_interval = impl_->config->GetAdvertiseInterval();
+        ScheduleQuery(impl_->query_interval);
       }
-      lock.lock();
-      impl_->query_cv.wait_for(lock, interval,
-                               [this] { return !impl_->query_running; });
     }
-  });
+    removed = impl_->discovered_services.RemoveIf(
+        [this](const GameSessionInfo &service) {
+          return !impl_->MatchesFilter(service.game_id);
+        });
+    callback = impl_->on_service_removed;
+  }
 
-  StartHeartbeat();
+  // Outside the lock: Cancel waits for a running OnQueryTimer, which takes it
+  if (superseded_query != TimerWheel::INVALID_TIMER_ID) {
+    impl_->timer_wheel->Cancel(superseded_query);
+  }
+
+  if (callback) {
+    for (const auto &service : removed) {
+      callback(service.host_name);
+    }
+  }
+}
 
+void MdnsDiscovery::SetPeriodicSendWindow(PeriodicSendWindow window) {
+  std::lock_guard<std::mutex> lock(impl_->mutex);
+  impl_->periodic_send_window = std::move(window);
+}
+
+ErrorCode MdnsDiscovery::QueryNow() {
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (!impl_->is_running) {
+      return ErrorCode::InvalidState;
+    }
+  }
+  SendQueryRound(false);
   return ErrorCode::Success;
 }
 
@@ -208,14 +423,11 @@ ErrorCode MdnsDiscovery::StopDiscovery() {
     std::lock_guard<std::mutex> lock(impl_->mutex);
     impl_->is_running = false;
     impl_->state = DiscoveryState::Stopped;
-    impl_->query_running = false;
-  }
-
-  impl_->query_cv.notify_all();
-  if (impl_->query_thread.joinable()) {
-    impl_->query_thread.join();
   }
+  // Stopped before anything answered
+  EndStartupPhase(StartupPhase::MdnsFirstResult, false);
 
+  CancelTimer(impl_->query_timer);
   StopHeartbeat();
 
   return ErrorCode::Success;
@@ -225,84 +437,128 @@ ErrorCode MdnsDiscovery::StopDiscovery() {
 // Advertisement
 // ---------------------------------------------------------------------------
 ErrorCode MdnsDiscovery::AdvertiseService(const GameSessionInfo &session_info) {
-  std::lock_guard<std::mutex> lock(impl_->mutex);
+  // Replace any running announcement schedule; cancelled outside the lock
+  // because the timer callback takes it
+  CancelTimer(impl_->advertise_timer);
+
+  std::chrono::milliseconds interval;
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+
+    if (impl_->state != DiscoveryState::Initialized &&
+        impl_->state != DiscoveryState::Discovering &&
+        impl_->state != DiscoveryState::Advertising) {
+      return ErrorCode::InvalidParameter;
+    }
+
+    impl_->advertised_session = session_info;
+    impl_->RefreshAnnouncement(session_info);
+    impl_->advertise_service_type = impl_->config->GetServiceType();
+    impl_->advertise_port =
+        session_info.port ? session_info.port : impl_->config->GetServicePort();
 
-  if (impl_->state != DiscoveryState::Initialized &&
-      impl_->state != DiscoveryState::Discovering) {
-    return ErrorCode::InvalidParameter;
+    if (!impl_->socket->PublishService(impl_->advertise_service_type,
+                                       session_info.host_name,
+                                       impl_->advertise_port,
+                                       *impl_->announcement)) {
+      return ErrorCode::NetworkError;
+    }
+    // Lets filtered scans for this title find it without a full browse
+    const auto title_id = ParseTitleId(session_info.game_id);
+    impl_->advertise_subtype =
+        title_id ? SubtypeServiceType(*title_id, impl_->advertise_service_type)
+                 : std::string{};
+    if (!impl_->advertise_subtype.empty() &&
+        !impl_->socket->PublishService(impl_->advertise_subtype,
+                                       session_info.host_name,
+                                       impl_->advertise_port,
+                                       *impl_->announcement)) {
+      return ErrorCode::NetworkError;
+    }
+
+    impl_->is_advertising = true;
+    impl_->state = DiscoveryState::Advertising;
+    interval = impl_->config->GetAdvertiseInterval();
   }
 
-  impl_->advertised_session = session_info;
+  impl_->advertise_timer = impl_->timer_wheel->ScheduleRepeating(
+      interval, [this]() { OnAdvertiseTimer(); });
+
+  return ErrorCode::Success;
+}
 
-  auto service_type = impl_->config->GetServiceType();
-  uint16_t port =
-      session_info.port ? session_info.port : impl_->config->GetServicePort();
+ErrorCode
+MdnsDiscovery::UpdateAdvertisedSession(const GameSessionInfo &session_info) {
+  std::shared_ptr<const std::string> announcement;
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (!impl_->is_advertising) {
+      return ErrorCode::InvalidState;
+    }
+    if (session_info.host_name != impl_->advertised_session.host_name) {
+      return ErrorCode::InvalidParameter; // Renaming needs AdvertiseService()
+    }
 
-  // Build TXT records string
-  TxtRecordBuilder builder =
-      TxtRecordBuilder::CreateGameSessionTxtRecords(session_info);
-  auto records = builder.GetAllRecords();
-  std::string txt;
-  bool first = true;
-  for (const auto &kv : records) {
-    if (!first)
-      txt += "&";
-    txt += kv.first + "=" + kv.second;
-    first = false;
+    impl_->advertised_session = session_info;
+    if (!impl_->RefreshAnnouncement(session_info)) {
+      return ErrorCode::Success; // Nothing announced changed
+    }
+    announcement = impl_->announcement;
   }
 
-  if (!impl_->socket->PublishService(service_type, session_info.host_name, port,
-                                     txt)) {
+  if (!impl_->socket->UpdateServiceTxtRecords(session_info.host_name,
+                                              *announcement)) {
     return ErrorCode::NetworkError;
   }
+  return ErrorCode::Success;
+}
 
-  impl_->is_advertising = true;
-  impl_->state = DiscoveryState::Advertising;
-
-  impl_->advertise_running = true;
-  auto interval = impl_->config->GetAdvertiseInterval();
-  impl_->advertise_thread = std::thread([this, service_type, port, interval]() {
-    std::unique_lock<std::mutex> lock(impl_->mutex);
-    while (impl_->advertise_running) {
-      GameSessionInfo session = impl_->advertised_session;
-      lock.unlock();
-      TxtRecordBuilder b =
-          TxtRecordBuilder::CreateGameSessionTxtRecords(session);
-      auto recs = b.GetAllRecords();
-      std::string txt_local;
-      bool first_local = true;
-      for (const auto &kv : recs) {
-        if (!first_local)
-          txt_local += "&";
-        txt_local += kv.first + "=" + kv.second;
-        first_local = false;
-      }
-      impl_->socket->PublishService(service_type, session.host_name, port,
-                                    txt_local);
-      lock.lock();
-      impl_->advertise_cv.wait_for(
-          lock, interval, [this] { return !impl_->advertise_running; });
+ErrorCode MdnsDiscovery::SetAdvertiseData(std::span<const uint8_t> data) {
+  std::shared_ptr<const std::string> announcement;
+  std::string host_name;
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (!impl_->is_advertising) {
+      return ErrorCode::InvalidState;
+    }
+    auto &session = impl_->advertised_session;
+    if (std::equal(data.begin(), data.end(), session.advertise_data.begin(),
+                   session.advertise_data.end())) {
+      return ErrorCode::Success;
+    }
+
+    session.advertise_data.assign(data.begin(), data.end());
+    if (!impl_->RefreshAnnouncement(session)) {
+      return ErrorCode::Success;
     }
-  });
+    announcement = impl_->announcement;
+    host_name = session.host_name;
+  }
 
+  if (!impl_->socket->UpdateServiceTxtRecords(host_name, *announcement)) {
+    return ErrorCode::NetworkError;
+  }
   return ErrorCode::Success;
 }
 
 ErrorCode MdnsDiscovery::StopAdvertising() {
+  std::string subtype;
   {
     std::lock_guard<std::mutex> lock(impl_->mutex);
     impl_->is_advertising = false;
-    impl_->advertise_running = false;
+    subtype = std::exchange(impl_->advertise_subtype, std::string{});
   }
 
-  impl_->advertise_cv.notify_all();
-  if (impl_->advertise_thread.joinable()) {
-    impl_->advertise_thread.join();
-  }
+  CancelTimer(impl_->advertise_timer);
 
   impl_->socket->UnpublishService(impl_->config->GetServiceType(),
                                   impl_->advertised_session.host_name);
+  if (!subtype.empty()) {
+    impl_->socket->UnpublishService(subtype,
+                                    impl_->advertised_session.host_name);
+  }
 
+  std::lock_guard<std::mutex> lock(impl_->mutex);
   if (!impl_->is_running) {
     impl_->state = DiscoveryState::Initialized;
   }
@@ -333,54 +589,125 @@ DiscoveryState MdnsDiscovery::GetState() const {
 // ---------------------------------------------------------------------------
 std::vector<GameSessionInfo> MdnsDiscovery::GetDiscoveredServices() const {
   std::lock_guard<std::mutex> lock(impl_->mutex);
-  std::vector<GameSessionInfo> services;
-  services.reserve(impl_->discovered_services.size());
-  for (const auto &[ip, info] : impl_->discovered_services) {
-    services.push_back(info);
-  }
-  return services;
+  return impl_->discovered_services.GetAll();
 }
 
 std::optional<GameSessionInfo>
 MdnsDiscovery::GetServiceByHostName(const std::string &host_name) const {
   std::lock_guard<std::mutex> lock(impl_->mutex);
-  for (const auto &[ip, service] : impl_->discovered_services) {
-    if (service.host_name == host_name) {
-      return service;
-    }
+  auto service = impl_->discovered_services.Find(host_name);
+  if (service && service->host_name != host_name) {
+    return std::nullopt; // Matched an address key, not a host name
   }
-  return std::nullopt;
+  return service;
 }
 
 void MdnsDiscovery::RefreshServices() {
-  std::vector<std::string> removed;
+  std::vector<GameSessionInfo> removed;
+  std::function<void(const std::string &)> callback;
   {
     std::lock_guard<std::mutex> lock(impl_->mutex);
-    auto now = std::chrono::system_clock::now();
-    auto timeout = std::chrono::milliseconds(50); // short timeout for tests
-    for (auto it = impl_->discovered_services.begin();
-         it != impl_->discovered_services.end();) {
-      if (now - it->second.last_seen > timeout) {
-        removed.push_back(it->second.host_name);
-        it = impl_->discovered_services.erase(it);
-      } else {
-        ++it;
-      }
-    }
+    // Only the expired entries are visited, oldest first
+    removed = impl_->discovered_services.ExpireBefore(
+        std::chrono::system_clock::now() - MdnsConstants::kServiceTtl);
+    callback = impl_->on_service_removed;
   }
 
-  if (!removed.empty() && impl_->on_service_removed) {
-    for (const auto &name : removed) {
-      impl_->on_service_removed(name);
+  if (callback) {
+    for (const auto &service : removed) {
+      callback(service.host_name);
     }
   }
 }
 
+uint64_t MdnsDiscovery::GetServicesEpoch() const {
+  std::lock_guard<std::mutex> lock(impl_->mutex);
+  return impl_->discovered_services.GetEpoch();
+}
+
+DiscoveredServiceDelta
+MdnsDiscovery::GetServiceChangesSince(uint64_t epoch) const {
+  std::lock_guard<std::mutex> lock(impl_->mutex);
+  return impl_->discovered_services.GetChangesSince(epoch);
+}
+
+std::optional<IPVersion>
+MdnsDiscovery::GetPreferredAddressFamily(const std::string &interface_name) const {
+  std::lock_guard<std::mutex> lock(impl_->mutex);
+  const auto it = impl_->preferred_family.find(impl_->NetworkOf(interface_name));
+  if (it == impl_->preferred_family.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
 std::vector<std::string> MdnsDiscovery::GetActiveInterfaces() const {
   std::lock_guard<std::mutex> lock(impl_->mutex);
   return impl_->active_interfaces;
 }
 
+void MdnsDiscovery::OnInterfacesChanged() {
+  std::vector<std::string> added;
+  std::vector<std::string> failed;
+  std::string service_type;
+  bool query = false;
+  IPVersion families = IPVersion::IPv4;
+  bool announce = false;
+  std::function<void(ErrorCode, const std::string &)> error_callback;
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (!impl_->sockets_ready) {
+      return; // Initialize binds whatever is up by then
+    }
+
+    const auto usable = impl_->UsableInterfaces();
+    auto &active = impl_->active_interfaces;
+    for (auto it = active.begin(); it != active.end();) {
+      if (std::find(usable.begin(), usable.end(), *it) == usable.end()) {
+        impl_->socket->UnbindFromInterface(*it);
+        it = active.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    for (const auto &name : usable) {
+      if (std::find(active.begin(), active.end(), name) != active.end()) {
+        continue;
+      }
+      // One interface failing leaves the others working
+      if (!impl_->socket->BindToInterface(name)) {
+        failed.push_back(name);
+        continue;
+      }
+      active.push_back(name);
+      added.push_back(name);
+    }
+
+    query = impl_->is_running;
+    families = impl_->QueryFamilies();
+    service_type = impl_->query_service_type;
+    announce = impl_->is_advertising;
+    error_callback = impl_->on_error;
+  }
+
+  // Peers on a link that just came up would otherwise wait out the interval
+  if (query) {
+    const MdnsQueryOptions options{true, {}, families};
+    for (const auto &name : added) {
+      impl_->socket->SendQuery(service_type, MDNS_RECORDTYPE_PTR, options,
+                               name);
+    }
+  }
+  if (announce && !added.empty()) {
+    SendAnnouncement();
+  }
+  if (error_callback) {
+    for (const auto &name : failed) {
+      error_callback(ErrorCode::NetworkError, "Failed to bind mDNS to " + name);
+    }
+  }
+}
+
 // ---------------------------------------------------------------------------
 // Callback registration
 // ---------------------------------------------------------------------------
@@ -412,38 +739,125 @@ void MdnsDiscovery::SetOnErrorCallback(
 // Packet processing
 // ---------------------------------------------------------------------------
 void MdnsDiscovery::ProcessIncomingPacket(const uint8_t *data, size_t size,
-                                          const std::string &source_address) {
-  std::string txt_records = ParseTxtRecordsFromPacket(data, size);
+                                          const std::string &source_address,
+                                          const std::string &interface_name) {
+  const std::string_view txt_records = ParseTxtRecordsFromPacket(data, size);
+  const uint64_t txt_hash =
+      DiscoveredServiceCache::HashTxtPayload(txt_records);
+
+  // Periodic re-announcements usually repeat the same TXT payload; refresh
+  // liveness without parsing it again
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    // Other titles are rejected on the game_id record alone
+    if (impl_->filter.local_communication_id) {
+      const auto game_id =
+          TxtRecordView::FromDelimited(txt_records).Find(TxtRecordConstants::kGameId);
+      if (!game_id || !impl_->MatchesFilter(*game_id)) {
+        return;
+      }
+    }
+    if (impl_->discovered_services.RefreshIfUnchanged(
+            source_address, txt_hash, std::chrono::system_clock::now())) {
+      return;
+    }
+  }
 
   GameSessionInfo session_info;
   if (!ParseGameSessionFromTxtRecords(txt_records, session_info)) {
     return; // Nothing to do
   }
 
+  const IPVersion family = (source_address.find(':') != std::string::npos)
+                               ? IPVersion::IPv6
+                               : IPVersion::IPv4;
   session_info.host_ip = source_address;
+  if (family == IPVersion::IPv6) {
+    session_info.host_ipv6 = source_address;
+  } else {
+    session_info.host_ipv4 = source_address;
+  }
   session_info.last_seen = std::chrono::system_clock::now();
-  session_info.ip_version = (source_address.find(':') != std::string::npos)
-                                ? IPVersion::IPv6
-                                : IPVersion::IPv4;
+  session_info.ip_version = family;
 
   std::function<void(const GameSessionInfo &)> callback;
   {
     std::lock_guard<std::mutex> lock(impl_->mutex);
-    auto it = impl_->discovered_services.find(source_address);
-    if (it != impl_->discovered_services.end()) {
-      it->second = session_info;
-    } else {
-      session_info.discovered_at = std::chrono::system_clock::now();
-      impl_->discovered_services.emplace(source_address, session_info);
+    session_info.discovered_at = session_info.last_seen;
+
+    // Both families are queried at once, so the one a new host answers on
+    // first is the one that works here; hosts on both connect over it
+    const std::string &network = impl_->NetworkOf(interface_name);
+    const auto preferred = impl_->preferred_family.find(network);
+    const auto result = impl_->discovered_services.Upsert(
+        session_info, txt_hash,
+        preferred != impl_->preferred_family.end()
+            ? std::optional<IPVersion>(preferred->second)
+            : std::nullopt);
+    if (result == DiscoveredServiceCache::UpdateResult::Added) {
+      impl_->preferred_family[network] = family;
       callback = impl_->on_service_discovered;
     }
   }
 
+  ScheduleServiceExpiry(MdnsConstants::kServiceTtl);
+  EndStartupPhase(StartupPhase::MdnsFirstResult);
+
   if (callback) {
     callback(session_info);
   }
 }
 
+void MdnsDiscovery::ProcessIncomingQuery(const std::string &service_type,
+                                         const MdnsQueryOptions &options,
+                                         const std::string &source_address,
+                                         const std::string &interface_name) {
+  std::string host_name;
+  std::shared_ptr<const std::string> announcement;
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (!impl_->is_advertising ||
+        (service_type != impl_->advertise_service_type &&
+         service_type != impl_->advertise_subtype)) {
+      return;
+    }
+    host_name = impl_->advertised_session.host_name;
+
+    // Known-answer suppression: the querier still holds our record for at
+    // least half its TTL (RFC 6762 section 7.1)
+    const bool known = std::any_of(
+        options.known_answers.begin(), options.known_answers.end(),
+        [&](const MdnsKnownAnswer &answer) {
+          return answer.instance_name == host_name &&
+                 answer.remaining_ttl * 2 >= MdnsConstants::kServiceTtl;
+        });
+    if (known) {
+      return;
+    }
+
+    // A multicast answer sent under a second ago already reached this
+    // querier; repeating it is what turns a busy LAN into a storm
+    if (!options.unicast_response) {
+      const auto now = std::chrono::steady_clock::now();
+      auto &last = impl_->last_multicast[interface_name];
+      if (now - last < MdnsConstants::kMinMulticastInterval) {
+        return;
+      }
+      last = now;
+    }
+    announcement = impl_->announcement;
+  }
+
+  const std::vector<uint8_t> response(announcement->begin(),
+                                      announcement->end());
+  if (options.unicast_response) {
+    impl_->socket->SendResponse(host_name, response, source_address,
+                                interface_name);
+  } else {
+    impl_->socket->SendResponse(host_name, response, interface_name);
+  }
+}
+
 // ---------------------------------------------------------------------------
 // Lifecycle methods (unused in this implementation but kept for interface)
 // ---------------------------------------------------------------------------
@@ -455,112 +869,215 @@ void MdnsDiscovery::OnWebSocketDisconnected(const std::string &) {}
 // Heartbeat / periodic operations
 // ---------------------------------------------------------------------------
 void MdnsDiscovery::StartHeartbeat() {
-  if (impl_->heartbeat_running) {
+  if (impl_->heartbeat_running.exchange(true)) {
     return;
   }
 
-  impl_->heartbeat_running = true;
-  auto timeout = impl_->config->GetDiscoveryTimeout();
-  impl_->heartbeat_thread = std::thread([this, timeout]() {
-    auto interval = std::chrono::milliseconds(50);
-    std::unique_lock<std::mutex> lock(impl_->mutex);
-    while (impl_->heartbeat_running) {
-      if (impl_->heartbeat_cv.wait_for(
-              lock, interval, [this] { return !impl_->heartbeat_running; })) {
-        break;
-      }
+  // A single deadline replaces polling the discovery start time
+  const auto timeout = impl_->config->GetDiscoveryTimeout();
+  impl_->timeout_timer = impl_->timer_wheel->Schedule(
+      timeout, [this]() { OnDiscoveryTimeout(); });
+}
 
-      bool do_timeout_callback = false;
-      std::function<void()> timeout_callback;
-      if (impl_->is_running &&
-          std::chrono::steady_clock::now() - impl_->discovery_start >=
-              timeout) {
-        impl_->state = DiscoveryState::TimedOut;
-        impl_->is_running = false;
-        impl_->query_running = false;
-        timeout_callback = impl_->on_discovery_timeout;
-        do_timeout_callback = true;
-      }
+void MdnsDiscovery::StopHeartbeat() {
+  impl_->heartbeat_running = false;
+  CancelTimer(impl_->timeout_timer);
+}
 
-      lock.unlock();
-      if (do_timeout_callback) {
-        impl_->query_cv.notify_all();
-        if (impl_->query_thread.joinable()) {
-          impl_->query_thread.join();
-        }
-        if (timeout_callback) {
-          timeout_callback();
-        }
-      }
+// ---------------------------------------------------------------------------
+// Event loop timers
+// ---------------------------------------------------------------------------
+void MdnsDiscovery::OnQueryTimer(uint64_t generation) {
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (!impl_->is_running || generation != impl_->query_generation) {
+      return;
+    }
+    impl_->query_timer = TimerWheel::INVALID_TIMER_ID;
+    impl_->query_interval = std::min(impl_->query_interval * 2,
+                                     MdnsConstants::kMaxQueryInterval);
+    ScheduleQuery(impl_->query_interval);
+  }
 
-      // Periodically clean stale services
-      RefreshServices();
+  SendPeriodic(MdnsPeriodicSend::Query, [this]() { SendQueryRound(false); });
+}
 
-      lock.lock();
+void MdnsDiscovery::SendQueryRound(bool unicast_response) {
+  MdnsQueryOptions options;
+  std::string service_type;
+  std::vector<std::string> interfaces;
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (!impl_->is_running) {
+      return;
     }
-  });
+    options.unicast_response = unicast_response;
+    options.known_answers = impl_->KnownAnswers();
+    options.families = impl_->QueryFamilies();
+    service_type = impl_->query_service_type;
+    interfaces = impl_->active_interfaces;
+  }
+
+  for (const auto &iface : interfaces) {
+    impl_->socket->SendQuery(service_type, MDNS_RECORDTYPE_PTR, options, iface);
+  }
 }
 
-void MdnsDiscovery::StopHeartbeat() {
+void MdnsDiscovery::ScheduleQuery(std::chrono::milliseconds delay) {
+  // The wheel never holds its own lock while running callbacks, so
+  // scheduling under ours cannot deadlock with OnQueryTimer
+  const uint64_t generation = ++impl_->query_generation;
+  impl_->query_timer = impl_->timer_wheel->Schedule(
+      delay, [this, generation]() { OnQueryTimer(generation); });
+}
+
+void MdnsDiscovery::OnAdvertiseTimer() {
+  SendPeriodic(MdnsPeriodicSend::Announce, [this]() { SendAnnouncement(); });
+}
+
+void MdnsDiscovery::SendPeriodic(MdnsPeriodicSend kind,
+                                 std::function<void()> send) {
+  PeriodicSendWindow window;
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    window = impl_->periodic_send_window;
+  }
+  if (window) {
+    window(kind, std::move(send));
+  } else {
+    send();
+  }
+}
+
+void MdnsDiscovery::SendAnnouncement() {
+  std::string host_name;
+  std::string service_type;
+  std::string subtype;
+  uint16_t port;
+  std::shared_ptr<const std::string> announcement;
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (!impl_->is_advertising) {
+      return;
+    }
+    host_name = impl_->advertised_session.host_name;
+    service_type = impl_->advertise_service_type;
+    subtype = impl_->advertise_subtype;
+    port = impl_->advertise_port;
+    announcement = impl_->announcement;
+    const auto now = std::chrono::steady_clock::now();
+    for (const auto &iface : impl_->active_interfaces) {
+      impl_->last_multicast[iface] = now;
+    }
+  }
+
+  // Re-announce the cached encoding; it only changes with the session
+  impl_->socket->PublishService(service_type, host_name, port, *announcement);
+  if (!subtype.empty()) {
+    impl_->socket->PublishService(subtype, host_name, port, *announcement);
+  }
+}
+
+void MdnsDiscovery::OnDiscoveryTimeout() {
+  impl_->timeout_timer = TimerWheel::INVALID_TIMER_ID;
+
+  std::function<void()> timeout_callback;
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (!impl_->is_running) {
+      return;
+    }
+    impl_->state = DiscoveryState::TimedOut;
+    impl_->is_running = false;
+    timeout_callback = impl_->on_discovery_timeout;
+  }
+
+  CancelTimer(impl_->query_timer);
   impl_->heartbeat_running = false;
-  impl_->heartbeat_cv.notify_all();
-  if (impl_->heartbeat_thread.joinable()) {
-    impl_->heartbeat_thread.join();
+
+  if (timeout_callback) {
+    timeout_callback();
+  }
+}
+
+void MdnsDiscovery::OnServiceExpiryTimer() {
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->expiry_timer = TimerWheel::INVALID_TIMER_ID;
+  }
+
+  RefreshServices();
+
+  // Re-arm for the oldest remaining service
+  std::optional<std::chrono::system_clock::time_point> oldest;
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    oldest = impl_->discovered_services.GetOldestLastSeen();
+  }
+
+  if (oldest) {
+    const auto remaining =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            *oldest + MdnsConstants::kServiceTtl -
+            std::chrono::system_clock::now());
+    ScheduleServiceExpiry(
+        std::max(remaining, std::chrono::milliseconds::zero()) +
+        std::chrono::milliseconds(1));
+  }
+}
+
+void MdnsDiscovery::ScheduleServiceExpiry(std::chrono::milliseconds delay) {
+  std::lock_guard<std::mutex> lock(impl_->mutex);
+  if (impl_->shutting_down ||
+      impl_->expiry_timer != TimerWheel::INVALID_TIMER_ID) {
+    return; // Already armed; it re-arms itself for later expiries
+  }
+
+  // The wheel never holds its own lock while running callbacks, so
+  // scheduling under ours cannot deadlock with OnServiceExpiryTimer
+  impl_->expiry_timer = impl_->timer_wheel->Schedule(
+      delay, [this]() { OnServiceExpiryTimer(); });
+}
+
+void MdnsDiscovery::CancelTimer(std::atomic<TimerWheel::TimerId> &timer) {
+  const auto id = timer.exchange(TimerWheel::INVALID_TIMER_ID);
+  if (id != TimerWheel::INVALID_TIMER_ID) {
+    impl_->timer_wheel->Cancel(id);
   }
 }
 
 // ---------------------------------------------------------------------------
 // Helper methods
 // ---------------------------------------------------------------------------
-std::string MdnsDiscovery::ParseTxtRecordsFromPacket(const uint8_t *data,
-                                                     size_t size) {
+std::string_view MdnsDiscovery::ParseTxtRecordsFromPacket(const uint8_t *data,
+                                                          size_t size) {
   // Test packets are simple strings where the TXT record section is the
-  // final space-separated token. Extract that portion so that the parser
-  // can interpret key/value pairs separated by '&'.
-  std::string packet(reinterpret_cast<const char *>(data), size);
-  auto pos = packet.find_last_of(' ');
-  if (pos == std::string::npos) {
+  // final space-separated token. Return a view of that portion so that the
+  // parser can walk key/value pairs separated by '&' in place.
+  const std::string_view packet(reinterpret_cast<const char *>(data), size);
+  const auto pos = packet.find_last_of(' ');
+  if (pos == std::string_view::npos) {
     return packet;
   }
   return packet.substr(pos + 1);
 }
 
 bool MdnsDiscovery::ParseGameSessionFromTxtRecords(
-    const std::string &txt_records, GameSessionInfo &session_info) {
+    std::string_view txt_records, GameSessionInfo &session_info) {
   if (txt_records.empty()) {
     return false;
   }
 
-  std::stringstream ss(txt_records);
-  std::string pair;
-  while (std::getline(ss, pair, '&')) {
-    auto equals_pos = pair.find('=');
-    if (equals_pos == std::string::npos)
-      continue;
-    auto key = pair.substr(0, equals_pos);
-    auto value = pair.substr(equals_pos + 1);
-    if (key == "game_id") {
-      session_info.game_id = value;
-    } else if (key == "version") {
-      session_info.version = value;
-    } else if (key == "players") {
-      session_info.current_players = std::stoi(value);
-    } else if (key == "max_players") {
-      session_info.max_players = std::stoi(value);
-    } else if (key == "has_password") {
-      session_info.has_password = (value == "true");
-    } else if (key == "host_name") {
-      session_info.host_name = value;
-    } else if (key == "session_id") {
-      session_info.session_id = value;
-    }
+  if (!TxtRecordView::FromDelimited(txt_records).ParseGameSession(
+          session_info)) {
+    return false;
   }
 
   if (session_info.port == 0) {
     session_info.port = impl_->config ? impl_->config->GetServicePort() : 7100;
   }
 
-  return !session_info.game_id.empty();
+  return true;
 }
 
 } // namespace Core::Multiplayer::ModelB
@@ -3,14 +3,20 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <optional>
+#include <span>
 #include <functional>
 #include <chrono>
+#include <cstdint>
 
+#include "../common/discovery_filter.h"
 #include "../common/error_codes.h"
+#include "../common/timer_wheel.h"
 
 namespace Core::Multiplayer::ModelB {
 
@@ -52,12 +58,16 @@ struct GameSessionInfo {
     int max_players;                // Maximum number of players (required)
     bool has_password;              // Whether the session requires a password (required)
     std::string host_name;          // Host name
-    std::string host_ip;            // Host IP address
+    std::string host_ip;            // Host IP address to connect to
+    std::string host_ipv4;          // Address the host answered from over IPv4, if any
+    std::string host_ipv6;          // Address the host answered from over IPv6, if any
     uint16_t port;                  // Host port
     std::string session_id;         // Unique session identifier
-    IPVersion ip_version;           // IP version (IPv4 or IPv6)
+    IPVersion ip_version;           // Families the host answered on (Both if both)
     std::chrono::system_clock::time_point discovered_at; // When the service was discovered
     std::chrono::system_clock::time_point last_seen;     // Last time the service was seen
+    std::vector<uint8_t> advertise_data; // Host's LDN advertise data
+    bool integrity_check = false;        // Data plane datagrams carry a CRC32C
     
     GameSessionInfo()
         : current_players(0), max_players(0), has_password(false), 
@@ -66,6 +76,47 @@ struct GameSessionInfo {
           last_seen(std::chrono::system_clock::now()) {}
 };
 
+/**
+ * A PTR answer the querier already holds. Listed in a query so that its
+ * responder stays quiet (RFC 6762 section 7.1).
+ */
+struct MdnsKnownAnswer {
+    std::string instance_name;               // Host name the service is published under
+    std::chrono::milliseconds remaining_ttl; // Before the querier drops it
+};
+
+/**
+ * How a query is sent, or how a received one was
+ */
+struct MdnsQueryOptions {
+    bool unicast_response = false;             // QU bit, RFC 6762 section 5.4
+    std::vector<MdnsKnownAnswer> known_answers; // Known-answer list
+    IPVersion families = IPVersion::IPv4;       // Both sends on both sockets at once
+};
+
+/**
+ * Periodic sends MdnsDiscovery can hand to a send window
+ */
+enum class MdnsPeriodicSend : uint8_t {
+    Query,    // A timer-driven query round
+    Announce, // A re-announcement of the advertised service
+};
+
+/**
+ * Changes to the discovered-service set since an earlier epoch
+ *
+ * Lets a poller such as the UI pull only what changed instead of copying
+ * every service on each refresh. When the requested epoch is too old for the
+ * retained removal history, full_resync is set and upserted holds every
+ * current service.
+ */
+struct DiscoveredServiceDelta {
+    uint64_t epoch = 0;                       // Pass back on the next poll
+    bool full_resync = false;                 // Replace, do not merge
+    std::vector<GameSessionInfo> upserted;    // Added or changed services
+    std::vector<std::string> removed;         // Keys of removed services
+};
+
 /**
  * mDNS Discovery Service
  * 
@@ -81,9 +132,17 @@ struct GameSessionInfo {
  * - Automatic service refresh and cleanup
  *
  * The implementation uses the public domain mdns library (externals/mdns)
- * and provides asynchronous discovery and advertisement loops for both
- * IPv4 and IPv6.  All network interaction happens on worker threads while
- * the public API remains thread safe.
+ * for both IPv4 and IPv6. It owns no threads: periodic queries, announcements,
+ * the discovery timeout and TTL expiry are all timers on one TimerWheel event
+ * loop (shared with the other multiplayer components by default), and incoming
+ * packets are delivered by the socket's receive callback. An idle discovery
+ * instance therefore only wakes when one of its deadlines is due.
+ *
+ * Traffic follows RFC 6762 so a LAN full of hosts does not flood itself:
+ * the first query asks for unicast responses, later ones list the services
+ * already known and back off from one interval to twice that and so on up
+ * to a cap, and the advertised service is not answered to queriers that
+ * know it or multicast again within a second on the same interface.
  */
 class MdnsDiscovery {
 public:
@@ -92,7 +151,8 @@ public:
      */
     MdnsDiscovery(std::shared_ptr<MockMdnsSocket> socket,
                   std::shared_ptr<MockNetworkInterfaceProvider> interface_provider,
-                  std::shared_ptr<MockMdnsConfig> config);
+                  std::shared_ptr<MockMdnsConfig> config,
+                  std::shared_ptr<TimerWheel> timer_wheel = nullptr);
     
     /**
      * Destructor - ensures cleanup of resources
@@ -103,7 +163,50 @@ public:
     ErrorCode Initialize();
     ErrorCode StartDiscovery();
     ErrorCode StopDiscovery();
+
+    /**
+     * Hand re-query timing to a DiscoveryScheduler: StartDiscovery sends its
+     * initial queries only, later ones go out on QueryNow(), and the
+     * discovery timeout does not apply
+     */
+    void SetScheduledQueries(bool scheduled);
+    // Send one round of queries on every interface while discovering
+    ErrorCode QueryNow();
+
+    /**
+     * Hand timer-driven query rounds and re-announcements to window, which
+     * sends them when it likes, e.g. batched by a RadioWakeWindow. First
+     * queries, answers and sends for a new interface still go at once. An
+     * empty window sends directly again.
+     */
+    using PeriodicSendWindow =
+        std::function<void(MdnsPeriodicSend kind, std::function<void()> send)>;
+    void SetPeriodicSendWindow(PeriodicSendWindow window);
+
+    /**
+     * Narrow discovery to the filter's title: queries go to the title's
+     * service subtype, and announcements whose game_id TXT record is for
+     * another title are dropped before the rest of their records are
+     * parsed. Known services the filter rejects are removed. The other
+     * filter fields are not announced, so they are left to the caller.
+     */
+    void SetDiscoveryFilter(const DiscoveryFilter& filter);
+
     ErrorCode AdvertiseService(const GameSessionInfo& session_info);
+
+    /**
+     * Update the advertised session in place, e.g. when a player joins.
+     * Only fields that changed are re-encoded, and the TXT records are pushed
+     * without restarting the announcement schedule. The host name must match
+     * the advertised one.
+     */
+    ErrorCode UpdateAdvertisedSession(const GameSessionInfo& session_info);
+
+    /**
+     * Replace the advertised session's advertise data; the TXT records are
+     * pushed only if it changed, with just its chunks re-encoded
+     */
+    ErrorCode SetAdvertiseData(std::span<const uint8_t> data);
     ErrorCode StopAdvertising();
     
     // State queries
@@ -115,9 +218,27 @@ public:
     std::vector<GameSessionInfo> GetDiscoveredServices() const;
     std::optional<GameSessionInfo> GetServiceByHostName(const std::string& host_name) const;
     void RefreshServices();
+
+    /**
+     * Current change epoch of the discovered-service set
+     */
+    uint64_t GetServicesEpoch() const;
+
+    /**
+     * Services added, changed or removed after the given epoch
+     */
+    DiscoveredServiceDelta GetServiceChangesSince(uint64_t epoch) const;
     
     // Network interface management
     std::vector<std::string> GetActiveInterfaces() const;
+
+    /**
+     * Re-read the interfaces after the OS reported a change, e.g. from an
+     * InterfaceMonitor. Interfaces that went away are unbound and new ones
+     * bound, leaving the others alone; a new interface is queried and
+     * announced on at once instead of at the next interval.
+     */
+    void OnInterfacesChanged();
     
     // Callback registration
     void SetOnServiceDiscoveredCallback(std::function<void(const GameSessionInfo&)> callback);
@@ -126,7 +247,25 @@ public:
     void SetOnErrorCallback(std::function<void(ErrorCode, const std::string&)> callback);
     
     // Packet processing
-    void ProcessIncomingPacket(const uint8_t* data, size_t size, const std::string& source_address);
+    void ProcessIncomingPacket(const uint8_t* data, size_t size, const std::string& source_address,
+                               const std::string& interface_name = {});
+
+    /**
+     * Address family that answered first on the interface's network, which
+     * host_ip prefers for hosts reachable over both; nullopt until one has.
+     * Kept per network (interface and its IPv4 address), so a later session
+     * on the same network goes straight to the family that works.
+     */
+    std::optional<IPVersion> GetPreferredAddressFamily(const std::string& interface_name) const;
+
+    /**
+     * Answer another host's query for the advertised service, unless its
+     * known-answer list holds the service or the answer was multicast on
+     * that interface under a second ago
+     */
+    void ProcessIncomingQuery(const std::string& service_type, const MdnsQueryOptions& options,
+                              const std::string& source_address,
+                              const std::string& interface_name);
     
     // Lifecycle methods
     void OnWebSocketConnected();
@@ -141,9 +280,21 @@ private:
     struct Impl;
     std::unique_ptr<Impl> impl_;
     
+    // Event loop timers
+    void OnQueryTimer(uint64_t generation);
+    void SendQueryRound(bool unicast_response);
+    void ScheduleQuery(std::chrono::milliseconds delay); // Caller holds the mutex
+    void OnAdvertiseTimer();
+    void SendAnnouncement();
+    void SendPeriodic(MdnsPeriodicSend kind, std::function<void()> send);
+    void OnDiscoveryTimeout();
+    void OnServiceExpiryTimer();
+    void ScheduleServiceExpiry(std::chrono::milliseconds delay);
+    void CancelTimer(std::atomic<TimerWheel::TimerId>& timer);
+
     // Helper methods
-    std::string ParseTxtRecordsFromPacket(const uint8_t* data, size_t size);
-    bool ParseGameSessionFromTxtRecords(const std::string& txt_records, GameSessionInfo& session_info);
+    std::string_view ParseTxtRecordsFromPacket(const uint8_t* data, size_t size);
+    bool ParseGameSessionFromTxtRecords(std::string_view txt_records, GameSessionInfo& session_info);
 };
 
 } // namespace Core::Multiplayer::ModelB
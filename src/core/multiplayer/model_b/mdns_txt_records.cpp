@@ -3,15 +3,60 @@
 
 #include "mdns_txt_records.h"
 #include <algorithm>
+#include <array>
+#include <charconv>
 #include <sstream>
 #include <cctype>
+#include <cstring>
 
 namespace Core::Multiplayer::ModelB {
 
+namespace {
+
+std::string AdvertiseDataKey(size_t chunk) {
+    return TxtRecordConstants::kAdvertiseData + std::to_string(chunk);
+}
+
+std::string EncodeHex(const uint8_t* data, size_t size) {
+    static constexpr char DIGITS[] = "0123456789abcdef";
+    std::string text;
+    text.reserve(size * 2);
+    for (size_t i = 0; i < size; ++i) {
+        text.push_back(DIGITS[data[i] >> 4]);
+        text.push_back(DIGITS[data[i] & 0xF]);
+    }
+    return text;
+}
+
+} // anonymous namespace
+
 // TxtRecordBuilder implementation
 struct TxtRecordBuilder::Impl {
     std::unordered_map<std::string, std::string> records;
     size_t total_size = 0;
+
+    // Encodings are rebuilt lazily after a record changes
+    mutable std::vector<uint8_t> encoded_binary;
+    mutable std::string encoded_text;
+    mutable bool binary_dirty = true;
+    mutable bool text_dirty = true;
+
+    void MarkDirty() {
+        binary_dirty = true;
+        text_dirty = true;
+    }
+
+    // Remove a record if present; returns whether anything changed
+    bool Erase(const std::string& key) {
+        auto it = records.find(key);
+        if (it == records.end()) {
+            return false;
+        }
+        total_size -= key.length() + it->second.length() + 2;
+        records.erase(it);
+        MarkDirty();
+        return true;
+    }
 };
 
 TxtRecordBuilder::TxtRecordBuilder() : impl_(std::make_unique<Impl>()) {}
@@ -50,15 +95,20 @@ ErrorCode TxtRecordBuilder::AddRecord(const std::string& key, const std::string&
     }
     
     // Add record
-    if (impl_->records.find(key) == impl_->records.end()) {
+    auto it = impl_->records.find(key);
+    if (it == impl_->records.end()) {
         impl_->total_size += record_size;
-    } else {
+        impl_->records.emplace(key, value);
+    } else if (it->second != value) {
         // Update existing record - adjust size
-        size_t old_size = key.length() + impl_->records[key].length() + 2;
+        size_t old_size = key.length() + it->second.length() + 2;
         impl_->total_size = impl_->total_size - old_size + record_size;
+        it->second = value;
+    } else {
+        return ErrorCode::Success; // Unchanged, keep the cached encodings
     }
-    
-    impl_->records[key] = value;
+
+    impl_->MarkDirty();
     return ErrorCode::Success;
 }
 
@@ -70,20 +120,16 @@ ErrorCode TxtRecordBuilder::UpdateRecord(const std::string& key, const std::stri
 }
 
 ErrorCode TxtRecordBuilder::RemoveRecord(const std::string& key) {
-    auto it = impl_->records.find(key);
-    if (it == impl_->records.end()) {
+    if (!impl_->Erase(key)) {
         return ErrorCode::InvalidParameter; // Use available error code
     }
-    
-    size_t record_size = key.length() + it->second.length() + 2;
-    impl_->total_size -= record_size;
-    impl_->records.erase(it);
     return ErrorCode::Success;
 }
 
 void TxtRecordBuilder::Clear() {
     impl_->records.clear();
     impl_->total_size = 0;
+    impl_->MarkDirty();
 }
 
 bool TxtRecordBuilder::HasRecord(const std::string& key) const {
@@ -112,40 +158,107 @@ size_t TxtRecordBuilder::GetTotalSize() const {
 }
 
 std::vector<uint8_t> TxtRecordBuilder::ToBinary() const {
-    std::vector<uint8_t> data;
+    if (!impl_->binary_dirty) {
+        return impl_->encoded_binary;
+    }
+
+    std::vector<uint8_t>& data = impl_->encoded_binary;
+    data.clear();
     data.reserve(impl_->total_size);
 
     for (const auto& record : impl_->records) {
-        std::string record_str = record.first + "=" + record.second;
-        if (record_str.length() > 255) {
+        const size_t length = record.first.length() + 1 + record.second.length();
+        if (length > 255) {
             continue; // Skip oversized records
         }
         
-        data.push_back(static_cast<uint8_t>(record_str.length()));
-        data.insert(data.end(), record_str.begin(), record_str.end());
+        data.push_back(static_cast<uint8_t>(length));
+        data.insert(data.end(), record.first.begin(), record.first.end());
+        data.push_back('=');
+        data.insert(data.end(), record.second.begin(), record.second.end());
     }
     
+    impl_->binary_dirty = false;
     return data;
 }
 
-TxtRecordBuilder TxtRecordBuilder::CreateGameSessionTxtRecords(const GameSessionInfo& session_info) {
-    TxtRecordBuilder builder;
-    
-    builder.AddRecord(TxtRecordConstants::kGameId, session_info.game_id);
-    builder.AddRecord(TxtRecordConstants::kVersion, session_info.version);
-    builder.AddRecord(TxtRecordConstants::kPlayers, std::to_string(session_info.current_players));
-    builder.AddRecord(TxtRecordConstants::kMaxPlayers, std::to_string(session_info.max_players));
-    builder.AddRecord(TxtRecordConstants::kHasPassword, 
-                     session_info.has_password ? TxtRecordConstants::kBooleanTrue : TxtRecordConstants::kBooleanFalse);
-    
-    if (!session_info.host_name.empty()) {
-        builder.AddRecord(TxtRecordConstants::kHostName, session_info.host_name);
+const std::string& TxtRecordBuilder::ToAnnouncementText() const {
+    if (!impl_->text_dirty) {
+        return impl_->encoded_text;
     }
-    if (!session_info.session_id.empty()) {
-        builder.AddRecord(TxtRecordConstants::kSessionId, session_info.session_id);
+
+    std::string& text = impl_->encoded_text;
+    text.clear();
+    text.reserve(impl_->total_size);
+
+    for (const auto& record : impl_->records) {
+        if (!text.empty()) {
+            text += '&';
+        }
+        text += record.first;
+        text += '=';
+        text += record.second;
     }
-    
-    return std::move(builder);
+
+    impl_->text_dirty = false;
+    return text;
+}
+
+size_t TxtRecordBuilder::ApplyGameSession(const GameSessionInfo& session_info) {
+    size_t changed = 0;
+
+    const auto set = [this, &changed](const char* key, const std::string& value) {
+        const auto it = impl_->records.find(key);
+        if (it != impl_->records.end() && it->second == value) {
+            return; // Clean field
+        }
+        if (AddRecord(key, value) == ErrorCode::Success || impl_->Erase(key)) {
+            ++changed; // A rejected value drops the stale record, like a fresh build
+        }
+    };
+    const auto set_optional = [this, &changed, &set](const char* key, const std::string& value) {
+        if (!value.empty()) {
+            set(key, value);
+        } else if (impl_->Erase(key)) {
+            ++changed;
+        }
+    };
+
+    set(TxtRecordConstants::kGameId, session_info.game_id);
+    set(TxtRecordConstants::kVersion, session_info.version);
+    set(TxtRecordConstants::kPlayers, std::to_string(session_info.current_players));
+    set(TxtRecordConstants::kMaxPlayers, std::to_string(session_info.max_players));
+    set(TxtRecordConstants::kHasPassword,
+        session_info.has_password ? TxtRecordConstants::kBooleanTrue : TxtRecordConstants::kBooleanFalse);
+    set_optional(TxtRecordConstants::kHostName, session_info.host_name);
+    set_optional(TxtRecordConstants::kSessionId, session_info.session_id);
+    set_optional(TxtRecordConstants::kIntegrity,
+                 session_info.integrity_check ? TxtRecordConstants::kIntegrityCrc32c : "");
+
+    const auto& advertise_data = session_info.advertise_data;
+    for (size_t chunk = 0; chunk < TxtRecordConstants::kMaxAdvertiseDataChunks; ++chunk) {
+        const std::string key = AdvertiseDataKey(chunk);
+        const size_t offset = chunk * TxtRecordConstants::kAdvertiseDataChunkSize;
+        if (offset < advertise_data.size()) {
+            const size_t size =
+                std::min(advertise_data.size() - offset, TxtRecordConstants::kAdvertiseDataChunkSize);
+            set(key.c_str(), EncodeHex(advertise_data.data() + offset, size));
+        } else if (impl_->Erase(key)) {
+            ++changed;
+        }
+    }
+
+    return changed;
+}
+
+bool TxtRecordBuilder::IsDirty() const {
+    return impl_->binary_dirty || impl_->text_dirty;
+}
+
+TxtRecordBuilder TxtRecordBuilder::CreateGameSessionTxtRecords(const GameSessionInfo& session_info) {
+    TxtRecordBuilder builder;
+    builder.ApplyGameSession(session_info);
+    return builder;
 }
 
 std::pair<ErrorCode, TxtRecordBuilder> TxtRecordBuilder::FromMap(
@@ -193,42 +306,23 @@ bool TxtRecordParser::ParseBinaryData(const std::vector<uint8_t>& binary_data) {
         return false;
     }
 
+    const auto view = TxtRecordView::FromWire(binary_data.data(), binary_data.size());
+    if (!view.IsValid()) {
+        return false; // Truncated record or missing separator
+    }
+
     impl_->records.clear();
     impl_->records.reserve(binary_data.size() / 2);
 
-    size_t offset = 0;
     size_t total_size = 0;
-    while (offset < binary_data.size()) {
-        if (offset >= binary_data.size()) {
-            return false;
-        }
-
-        uint8_t length = binary_data[offset];
-        if (length == 0) {
-            offset++;
-            continue; // Skip zero-length records
-        }
-
-        if (offset + 1 + length > binary_data.size()) {
-            return false; // Truncated record
-        }
-
-        total_size += length + 1;
+    for (const auto& record : view) {
+        total_size += record.key.size() + record.value.size() + 2;
         if (total_size > TxtRecordConstants::kMaxTotalSize) {
             return false;
         }
 
-        std::string record_data(binary_data.begin() + offset + 1,
-                               binary_data.begin() + offset + 1 + length);
-
-        // Find '=' separator
-        size_t equals_pos = record_data.find('=');
-        if (equals_pos == std::string::npos) {
-            return false; // Missing separator
-        }
-
-        std::string key = record_data.substr(0, equals_pos);
-        std::string value = record_data.substr(equals_pos + 1);
+        std::string key(record.key);
+        std::string value(record.value);
 
         if (!TxtRecordValidator::IsValidKey(key) ||
             !TxtRecordValidator::IsValidValue(key, value)) {
@@ -239,8 +333,6 @@ bool TxtRecordParser::ParseBinaryData(const std::vector<uint8_t>& binary_data) {
         if (!inserted) {
             return false; // Duplicate key
         }
-
-        offset += length + 1;
     }
 
     return true;
@@ -297,6 +389,183 @@ std::pair<ErrorCode, TxtRecordParser> TxtRecordParser::FromMap(
     return {ErrorCode::Success, std::move(parser)};
 }
 
+// TxtRecordView implementation
+namespace {
+
+bool ParseInt(std::string_view text, int& out) {
+    const char* const first = text.data();
+    const char* const last = first + text.size();
+    const auto [ptr, ec] = std::from_chars(first, last, out);
+    return ec == std::errc{} && ptr == last;
+}
+
+// Chunk index of an advertise data key, "adv0".."adv3"
+std::optional<size_t> AdvertiseDataChunk(std::string_view key) {
+    const std::string_view prefix = TxtRecordConstants::kAdvertiseData;
+    if (key.size() != prefix.size() + 1 || !key.starts_with(prefix)) {
+        return std::nullopt;
+    }
+    const size_t chunk = static_cast<size_t>(key.back() - '0');
+    if (chunk >= TxtRecordConstants::kMaxAdvertiseDataChunks) {
+        return std::nullopt;
+    }
+    return chunk;
+}
+
+bool DecodeHex(std::string_view text, uint8_t* out) {
+    const auto nibble = [](char c) -> int {
+        if (c >= '0' && c <= '9') {
+            return c - '0';
+        }
+        if (c >= 'a' && c <= 'f') {
+            return c - 'a' + 10;
+        }
+        if (c >= 'A' && c <= 'F') {
+            return c - 'A' + 10;
+        }
+        return -1;
+    };
+    for (size_t i = 0; i < text.size(); i += 2) {
+        const int high = nibble(text[i]);
+        const int low = nibble(text[i + 1]);
+        if (high < 0 || low < 0) {
+            return false;
+        }
+        out[i / 2] = static_cast<uint8_t>((high << 4) | low);
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+TxtRecordView TxtRecordView::FromWire(const uint8_t* data, size_t size) {
+    return TxtRecordView(reinterpret_cast<const char*>(data), size, Format::Wire, '\0');
+}
+
+TxtRecordView TxtRecordView::FromDelimited(std::string_view text, char separator) {
+    return TxtRecordView(text.data(), text.size(), Format::Delimited, separator);
+}
+
+void TxtRecordView::Iterator::Advance() {
+    const char* const data = view_->data_;
+    const size_t size = view_->size_;
+
+    while (next_ < size) {
+        const size_t offset = next_;
+        std::string_view record;
+
+        if (view_->format_ == Format::Wire) {
+            const size_t length = static_cast<uint8_t>(data[offset]);
+            if (length == 0) {
+                next_ = offset + 1;
+                continue; // Skip zero-length records
+            }
+            if (offset + 1 + length > size) {
+                break; // Truncated record ends the walk
+            }
+            record = std::string_view(data + offset + 1, length);
+            next_ = offset + 1 + length;
+        } else {
+            const void* separator = std::memchr(data + offset, view_->separator_, size - offset);
+            const size_t stop =
+                separator ? static_cast<size_t>(static_cast<const char*>(separator) - data) : size;
+            record = std::string_view(data + offset, stop - offset);
+            next_ = separator ? stop + 1 : size;
+        }
+
+        const size_t equals_pos = record.find('=');
+        if (equals_pos == std::string_view::npos) {
+            continue;
+        }
+
+        position_ = offset;
+        current_.key = record.substr(0, equals_pos);
+        current_.value = record.substr(equals_pos + 1);
+        return;
+    }
+
+    position_ = END;
+    current_ = {};
+}
+
+bool TxtRecordView::IsValid() const {
+    if (format_ != Format::Wire) {
+        return true;
+    }
+
+    size_t offset = 0;
+    while (offset < size_) {
+        const size_t length = static_cast<uint8_t>(data_[offset]);
+        if (offset + 1 + length > size_) {
+            return false;
+        }
+        if (length != 0 &&
+            std::memchr(data_ + offset + 1, '=', length) == nullptr) {
+            return false;
+        }
+        offset += 1 + length;
+    }
+    return true;
+}
+
+std::optional<std::string_view> TxtRecordView::Find(std::string_view key) const {
+    for (const auto& record : *this) {
+        if (record.key == key) {
+            return record.value;
+        }
+    }
+    return std::nullopt;
+}
+
+bool TxtRecordView::ParseGameSession(GameSessionInfo& session_info) const {
+    bool has_game_id = false;
+    // Chunks may come in any order; only the last may be short
+    std::array<uint8_t, TxtRecordConstants::kAdvertiseDataChunkSize *
+                            TxtRecordConstants::kMaxAdvertiseDataChunks>
+        advertise_data{};
+    std::optional<size_t> advertise_data_size;
+
+    for (const auto& [key, value] : *this) {
+        if (key == TxtRecordConstants::kGameId) {
+            session_info.game_id.assign(value.data(), value.size());
+            has_game_id = !value.empty();
+        } else if (key == TxtRecordConstants::kVersion) {
+            session_info.version.assign(value.data(), value.size());
+        } else if (key == TxtRecordConstants::kPlayers) {
+            if (!ParseInt(value, session_info.current_players)) {
+                return false;
+            }
+        } else if (key == TxtRecordConstants::kMaxPlayers) {
+            if (!ParseInt(value, session_info.max_players)) {
+                return false;
+            }
+        } else if (key == TxtRecordConstants::kHasPassword) {
+            session_info.has_password = (value == TxtRecordConstants::kBooleanTrue);
+        } else if (key == TxtRecordConstants::kHostName) {
+            session_info.host_name.assign(value.data(), value.size());
+        } else if (key == TxtRecordConstants::kSessionId) {
+            session_info.session_id.assign(value.data(), value.size());
+        } else if (key == TxtRecordConstants::kIntegrity) {
+            session_info.integrity_check = value == TxtRecordConstants::kIntegrityCrc32c;
+        } else if (const auto chunk = AdvertiseDataChunk(key)) {
+            const size_t offset = *chunk * TxtRecordConstants::kAdvertiseDataChunkSize;
+            if (value.size() % 2 != 0 ||
+                value.size() / 2 > TxtRecordConstants::kAdvertiseDataChunkSize ||
+                !DecodeHex(value, advertise_data.data() + offset)) {
+                return false;
+            }
+            advertise_data_size =
+                std::max(advertise_data_size.value_or(0), offset + value.size() / 2);
+        }
+    }
+
+    if (advertise_data_size) {
+        session_info.advertise_data.assign(advertise_data.begin(),
+                                           advertise_data.begin() + *advertise_data_size);
+    }
+    return has_game_id;
+}
+
 // TxtRecordValidator implementation
 ErrorCode TxtRecordValidator::ValidateGameSessionTxtRecords(const TxtRecordParser& parser) {
     if (!parser.IsValid()) {
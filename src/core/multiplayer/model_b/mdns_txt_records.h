@@ -3,10 +3,15 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 #include <memory>
+#include <optional>
 #include <utility>
 
 #include "../common/error_codes.h"
@@ -32,6 +37,7 @@ namespace Core::Multiplayer::ModelB {
  * - session_id: Unique session identifier
  * - region: Geographic region code
  * - language: Language code
+ * - integrity: Data plane integrity trailer ("crc32c"), absent for none
  * 
  * This is a stub implementation - all methods will fail until implemented
  * following TDD red phase methodology.
@@ -80,6 +86,23 @@ public:
     
     // Serialization
     std::vector<uint8_t> ToBinary() const;
+
+    /**
+     * '&'-delimited key=value form carried by discovery announcements.
+     * Encoded once and reused until a record changes.
+     */
+    const std::string& ToAnnouncementText() const;
+
+    /**
+     * Delta update from a game session: only fields whose value differs from
+     * the current record are rewritten, so an unchanged session keeps the
+     * cached encodings
+     * @return Number of records added, changed or removed
+     */
+    size_t ApplyGameSession(const GameSessionInfo& session_info);
+
+    // True until the encodings are rebuilt after a record change
+    bool IsDirty() const;
     
     // Static factory methods
     static TxtRecordBuilder CreateGameSessionTxtRecords(const GameSessionInfo& session_info);
@@ -153,6 +176,111 @@ private:
     bool ParseBinaryData(const std::vector<uint8_t>& binary_data);
 };
 
+/**
+ * Non-owning view over TXT record data
+ *
+ * Walks key/value pairs in place over the received bytes without copying them
+ * or building a map, so the discovery receive path allocates nothing before it
+ * knows it has a new announcement. Two layouts are understood: the RFC 6763
+ * wire format ([length][key=value]...) and the separator-delimited form that
+ * discovery announcements carry (key=value&key=value).
+ *
+ * Entries without an '=' are skipped while iterating. The viewed bytes must
+ * outlive the view and every string_view it yields.
+ */
+class TxtRecordView {
+public:
+    enum class Format {
+        Wire,      // RFC 6763 length-prefixed strings
+        Delimited, // Pairs joined by a separator character
+    };
+
+    struct Record {
+        std::string_view key;
+        std::string_view value;
+    };
+
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Record;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Record*;
+        using reference = const Record&;
+
+        Iterator() = default;
+
+        reference operator*() const { return current_; }
+        pointer operator->() const { return &current_; }
+
+        Iterator& operator++() {
+            Advance();
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator previous = *this;
+            Advance();
+            return previous;
+        }
+
+        bool operator==(const Iterator& other) const { return position_ == other.position_; }
+        bool operator!=(const Iterator& other) const { return position_ != other.position_; }
+
+    private:
+        friend class TxtRecordView;
+
+        static constexpr size_t END = static_cast<size_t>(-1);
+
+        explicit Iterator(const TxtRecordView* view) : view_(view), next_(0) {
+            Advance();
+        }
+
+        void Advance();
+
+        const TxtRecordView* view_ = nullptr;
+        size_t position_ = END; // Offset of the current record, END once exhausted
+        size_t next_ = 0;       // Offset to resume scanning from
+        Record current_;
+    };
+
+    TxtRecordView() = default;
+
+    static TxtRecordView FromWire(const uint8_t* data, size_t size);
+    static TxtRecordView FromDelimited(std::string_view text, char separator = '&');
+
+    Iterator begin() const { return Iterator(this); }
+    Iterator end() const { return Iterator(); }
+
+    /**
+     * Check the framing: no truncated length prefix and every non-empty
+     * record has a key. Delimited data is always well framed.
+     */
+    bool IsValid() const;
+
+    bool IsEmpty() const { return begin() == end(); }
+    std::optional<std::string_view> Find(std::string_view key) const;
+
+    /**
+     * Typed fast path: fill the session fields announced in the TXT data in a
+     * single pass. Fields that are absent are left untouched.
+     * @return False if a numeric field is malformed or game_id is missing
+     */
+    bool ParseGameSession(GameSessionInfo& session_info) const;
+
+    Format GetFormat() const { return format_; }
+    std::string_view Raw() const { return std::string_view(data_, size_); }
+
+private:
+    TxtRecordView(const char* data, size_t size, Format format, char separator)
+        : data_(data), size_(size), format_(format), separator_(separator) {}
+
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    Format format_ = Format::Delimited;
+    char separator_ = '&';
+};
+
 /**
  * TXT Record Validator
  * 
@@ -217,6 +345,15 @@ namespace TxtRecordConstants {
     constexpr const char* kSessionId = "session_id";
     constexpr const char* kRegion = "region";
     constexpr const char* kLanguage = "language";
+    // Present when the session's data plane uses a CRC32C trailer
+    constexpr const char* kIntegrity = "integrity";
+    constexpr const char* kIntegrityCrc32c = "crc32c";
+
+    // Advertise data, hex encoded as kAdvertiseData + chunk index ("adv0".."adv3"),
+    // so a change re-encodes only the chunks it touches
+    constexpr const char* kAdvertiseData = "adv";
+    constexpr size_t kAdvertiseDataChunkSize = 120;
+    constexpr size_t kMaxAdvertiseDataChunks = 4;
     
     // Size limits (RFC 6763)
     constexpr size_t kMaxKeyLength = 63;        // Maximum key length
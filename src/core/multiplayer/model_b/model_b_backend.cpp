@@ -3,22 +3,71 @@
 
 #include "model_b_backend.h"
 
+#include "core/multiplayer/common/packet_trace.h"
+#include "core/multiplayer/common/startup_profile.h"
+
 namespace Core::Multiplayer::ModelB {
 
+namespace {
+// Wake window task keys; a newer send of a kind replaces a pending one
+constexpr RadioWakeWindow::TaskKey ADVERTISE_DATA_TASK = 1;
+constexpr RadioWakeWindow::TaskKey MDNS_QUERY_TASK = 2;
+constexpr RadioWakeWindow::TaskKey MDNS_ANNOUNCE_TASK = 3;
+} // namespace
+
 bool ModelBBackend::IsSupported() {
     return true;
 }
 
 ModelBBackend::ModelBBackend(std::shared_ptr<HLE::ConfigurationManager> config,
                              std::shared_ptr<MdnsDiscovery> discovery)
-    : config_(std::move(config)), discovery_(std::move(discovery)) {}
+    : config_(std::move(config)), discovery_(std::move(discovery)),
+      advertise_data_([this](const AdvertiseDataPatch&, std::span<const uint8_t> data) {
+          wake_window_.Defer(ADVERTISE_DATA_TASK,
+                             [this, blob = std::vector<uint8_t>(data.begin(), data.end())] {
+                                 discovery_->SetAdvertiseData(blob);
+                             });
+      }) {}
 
 ErrorCode ModelBBackend::Initialize() {
+    StartupSpan span(StartupPhase::BackendInitialize);
+    if (discovery_ && mdns_scanner_ == 0) {
+        discovery_->SetScheduledQueries(true);
+        discovery_->SetPeriodicSendWindow(
+            [this](MdnsPeriodicSend kind, std::function<void()> send) {
+                wake_window_.Defer(kind == MdnsPeriodicSend::Query ? MDNS_QUERY_TASK
+                                                                   : MDNS_ANNOUNCE_TASK,
+                                   std::move(send));
+            });
+        mdns_scanner_ = discovery_scheduler_.AddScanner("mdns", [this] {
+            if (discovery_->IsRunning()) {
+                wake_window_.Defer(MDNS_QUERY_TASK, [this] { discovery_->QueryNow(); });
+            } else {
+                // Sends the first round of queries itself
+                discovery_->StartDiscovery();
+            }
+        });
+    }
+    if (discovery_ && !interface_monitor_.IsRunning()) {
+        // Without change events new interfaces wait for the next Initialize
+        (void)interface_monitor_.Start([this] { discovery_->OnInterfacesChanged(); });
+    }
+    discovery_scheduler_.Start();
     initialized_ = true;
     return ErrorCode::Success;
 }
 
 ErrorCode ModelBBackend::Finalize() {
+    interface_monitor_.Stop();
+    discovery_scheduler_.Stop();
+    DetachDataPlane();
+    advertise_data_.Reset();
+    if (discovery_) {
+        discovery_->SetPeriodicSendWindow(nullptr);
+    }
+    wake_window_.Clear();
+    node_routes_.Clear();
+    frame_aligned_ = false;
     initialized_ = false;
     return ErrorCode::Success;
 }
@@ -46,9 +95,21 @@ ErrorCode ModelBBackend::Disconnect() {
 
 ErrorCode ModelBBackend::Scan(std::vector<Service::LDN::NetworkInfo>&,
                               const Service::LDN::ScanFilter&) {
+    // Results are not translated yet, but the game asking still wakes discovery
+    discovery_scheduler_.RequestScan();
     return ErrorCode::NotImplemented;
 }
 
+void ModelBBackend::SetDiscoveryFilter(const DiscoveryFilter& filter) {
+    if (discovery_) {
+        discovery_->SetDiscoveryFilter(filter);
+    }
+}
+
+uint64_t ModelBBackend::GetNetworksEpoch() const {
+    return discovery_ ? discovery_->GetServicesEpoch() : 0;
+}
+
 ErrorCode ModelBBackend::GetNetworkInfo(Service::LDN::NetworkInfo&) {
     return ErrorCode::NotImplemented;
 }
@@ -73,16 +134,197 @@ ErrorCode ModelBBackend::CloseStation() {
     return ErrorCode::NotImplemented;
 }
 
-ErrorCode ModelBBackend::SendPacket(const std::vector<uint8_t>&, uint8_t) {
-    return ErrorCode::NotImplemented;
+ErrorCode ModelBBackend::SendPacket(const std::vector<uint8_t>& data, uint8_t node_id) {
+    return FlushTransport(SendBytes(data.data(), data.size(), node_id));
 }
 
-ErrorCode ModelBBackend::ReceivePacket(std::vector<uint8_t>&, uint8_t&) {
-    return ErrorCode::NotImplemented;
+ErrorCode ModelBBackend::ReceivePacket(std::vector<uint8_t>& out_data, uint8_t& out_node_id) {
+    ReceivedPacket received;
+    const ErrorCode result = ReceivePacket(received.packet, received.node_id);
+    if (result != ErrorCode::Success) {
+        return result;
+    }
+
+    out_data.assign(received.packet.data(), received.packet.data() + received.packet.size());
+    out_node_id = received.node_id;
+    return ErrorCode::Success;
 }
 
-ErrorCode ModelBBackend::SetAdvertiseData(const std::vector<uint8_t>&) {
-    return ErrorCode::NotImplemented;
+ErrorCode ModelBBackend::SendPacket(const PacketBuffer& packet, uint8_t node_id) {
+    return FlushTransport(SendBytes(packet.data(), packet.size(), node_id));
+}
+
+ErrorCode ModelBBackend::ReceivePacket(PacketBuffer& out_packet, uint8_t& out_node_id) {
+    if (!initialized_) {
+        return ErrorCode::NotInitialized;
+    }
+
+    // An empty queue yields an empty packet, matching the vector overload
+    ReceivedPacket received;
+    if (!receive_queue_.TryPop(received)) {
+        out_packet.Reset();
+        out_node_id = 0;
+        return ErrorCode::Success;
+    }
+    latency_.RecordSince(DataPathHop::ReceiveDequeue, received.queued_at);
+    MULTIPLAYER_TRACE_SPAN("ModelBBackend::ReceiveQueue", received.trace_id, received.queued_at);
+
+    out_packet = std::move(received.packet);
+    out_node_id = received.node_id;
+    return ErrorCode::Success;
+}
+
+ErrorCode ModelBBackend::SendPackets(const HLE::PacketRef* packets, size_t count,
+                                  size_t& out_sent) {
+    out_sent = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const ErrorCode result = SendBytes(packets[i].data, packets[i].size, packets[i].node_id);
+        if (result != ErrorCode::Success) {
+            return FlushTransport(result);
+        }
+        ++out_sent;
+    }
+    // The whole batch leaves in one socket call
+    return FlushTransport(ErrorCode::Success);
+}
+
+ErrorCode ModelBBackend::SendBytes(const uint8_t* data, size_t size, uint8_t node_id) {
+    if (!packet_sender_) {
+        return ErrorCode::NotImplemented;
+    }
+    if (node_id == NodeRoutingTable::BROADCAST_NODE_ID && node_routes_.GetActiveCount() != 0) {
+        return SendToEveryNode(data, size);
+    }
+    MULTIPLAYER_TRACE_PACKET();
+    MULTIPLAYER_TRACE_ZONE("ModelBBackend::SendPacket");
+    const uint64_t send_start = DataPathLatency::Now();
+    wire_bytes_sent_ = 0;
+    ErrorCode result;
+    if (const auto key = GetLatestValueKey(data, size)) {
+        latency_.RecordSince(DataPathHop::BackendEnqueue, send_start);
+        const uint64_t start = Latency::Now();
+        result = data_plane_->SendLatest(node_id, data, size, *key);
+        latency_.RecordSince(DataPathHop::TransportWrite, start);
+        if (result == ErrorCode::Success) {
+            wire_bytes_sent_ = size;
+        }
+    } else if (!delta_codec_) {
+        result = SendFramed(data, size, node_id, send_start);
+    } else {
+        const size_t encoded_size =
+            delta_codec_->Encode(DeltaStreamKey{node_id}, data, size, encode_buffer_.data());
+        if (encoded_size == 0) {
+            return ErrorCode::InvalidParameter;
+        }
+        result = SendFramed(encode_buffer_.data(), encoded_size, node_id, send_start);
+    }
+    if (result == ErrorCode::Success) {
+        stats_.OnSent(node_id, size, wire_bytes_sent_, send_start);
+        discovery_scheduler_.NotifyRealtimeTraffic(send_start);
+        wake_window_.NotifyRadioAwake();
+        node_routes_.RecordSent(node_id);
+    } else {
+        node_routes_.RecordSendFailure(node_id);
+    }
+    return result;
+}
+
+ErrorCode ModelBBackend::SendToEveryNode(const uint8_t* data, size_t size) {
+    // One send per node keeps each node's delta and parity stream its own
+    ErrorCode result = ErrorCode::Success;
+    node_routes_.ForEachActive([&](uint8_t node_id, const NodeRoute&) {
+        const ErrorCode sent = SendBytes(data, size, node_id);
+        if (sent != ErrorCode::Success) {
+            result = sent;
+        }
+    });
+    return result;
+}
+
+ErrorCode ModelBBackend::SendFramed(const uint8_t* data, size_t size, uint8_t node_id,
+                                    uint64_t send_start) {
+    if (!fec_codec_) {
+        latency_.RecordSince(DataPathHop::BackendEnqueue, send_start);
+        return WriteToTransport(node_id, data, size);
+    }
+
+    size_t framed_size = fec_codec_->Encode(node_id, data, size, fec_buffer_.data());
+    if (framed_size == 0) {
+        return ErrorCode::InvalidParameter;
+    }
+    latency_.RecordSince(DataPathHop::BackendEnqueue, send_start);
+    const ErrorCode result = WriteToTransport(node_id, fec_buffer_.data(), framed_size);
+    if (result != ErrorCode::Success) {
+        return result;
+    }
+
+    // Parity is best effort; the data packet already went out
+    framed_size = fec_codec_->TakeParity(node_id, fec_buffer_.data());
+    if (framed_size != 0) {
+        WriteToTransport(node_id, fec_buffer_.data(), framed_size);
+    }
+    return ErrorCode::Success;
+}
+
+ErrorCode ModelBBackend::WriteToTransport(uint8_t node_id, const uint8_t* data, size_t size) {
+    MULTIPLAYER_TRACE_ZONE("ModelBBackend::TransportWrite");
+    const uint64_t start = Latency::Now();
+    const ErrorCode result = packet_sender_(node_id, data, size);
+    latency_.RecordSince(DataPathHop::TransportWrite, start);
+    if (result == ErrorCode::Success) {
+        wire_bytes_sent_ += size;
+    }
+    return result;
+}
+
+std::optional<uint64_t> ModelBBackend::GetLatestValueKey(const uint8_t* data, size_t size) const {
+    // Only a frame's staged packets can be replaced
+    if (!data_plane_ || !frame_aligned_ || delta_codec_ || fec_codec_) {
+        return std::nullopt;
+    }
+    return latest_value_key_.Extract({data, size});
+}
+
+ErrorCode ModelBBackend::FlushTransport(ErrorCode result) {
+    if (!data_plane_ || frame_aligned_) {
+        return result;
+    }
+    const ErrorCode flushed = data_plane_->Flush();
+    return result != ErrorCode::Success ? result : flushed;
+}
+
+ErrorCode ModelBBackend::ReceivePackets(ReceivedPacket* out_packets, size_t max_packets,
+                                     size_t& out_received) {
+    out_received = 0;
+    if (!initialized_) {
+        return ErrorCode::NotInitialized;
+    }
+
+    // Drain up to max_packets from the ring in one pass
+    while (out_received < max_packets && receive_queue_.TryPop(out_packets[out_received])) {
+        ++out_received;
+    }
+    if (out_received > 0) {
+        // One clock read for the whole batch
+        const uint64_t now = Latency::Now();
+        for (size_t i = 0; i < out_received; ++i) {
+            const uint64_t queued_at = out_packets[i].queued_at;
+            latency_.Record(DataPathHop::ReceiveDequeue, now > queued_at ? now - queued_at : 0);
+            MULTIPLAYER_TRACE_SPAN("ModelBBackend::ReceiveQueue", out_packets[i].trace_id,
+                                   queued_at);
+        }
+    }
+    return ErrorCode::Success;
+}
+
+ErrorCode ModelBBackend::SetAdvertiseData(const std::vector<uint8_t>& data) {
+    if (!discovery_ || !discovery_->IsAdvertising()) {
+        return ErrorCode::InvalidState;
+    }
+    if (!advertise_data_.Set(data)) {
+        return ErrorCode::MessageTooLarge;
+    }
+    return ErrorCode::Success;
 }
 
 ErrorCode ModelBBackend::SetStationAcceptPolicy(Service::LDN::AcceptPolicy) {
@@ -101,5 +343,232 @@ ErrorCode ModelBBackend::GetDisconnectReason(Service::LDN::DisconnectReason&) {
     return ErrorCode::NotImplemented;
 }
 
+ErrorCode ModelBBackend::GetIpv4Address(Service::LDN::Ipv4Address&, Service::LDN::Ipv4Address&) {
+    return ErrorCode::NotImplemented;
+}
+
+ErrorCode ModelBBackend::GetNetworkConfig(Service::LDN::NetworkConfig&) {
+    return ErrorCode::NotImplemented;
+}
+
+void ModelBBackend::RegisterNodeEventCallbacks(std::function<void(uint8_t)> on_node_joined,
+                                               std::function<void(uint8_t)> on_node_left) {
+    std::lock_guard<std::mutex> lock(node_event_mutex_);
+    on_node_joined_ = std::move(on_node_joined);
+    on_node_left_ = std::move(on_node_left);
+}
+
+void ModelBBackend::ReportNodeJoined(uint8_t node_id, const NodeRoute& route) {
+    std::function<void(uint8_t)> on_node_joined;
+    {
+        std::lock_guard<std::mutex> lock(node_event_mutex_);
+        node_routes_.Join(node_id, route);
+        on_node_joined = on_node_joined_;
+    }
+    if (on_node_joined) {
+        on_node_joined(node_id);
+    }
+}
+
+void ModelBBackend::ReportNodeLeft(uint8_t node_id) {
+    std::function<void(uint8_t)> on_node_left;
+    {
+        std::lock_guard<std::mutex> lock(node_event_mutex_);
+        node_routes_.Leave(node_id);
+        on_node_left = on_node_left_;
+    }
+    if (on_node_left) {
+        on_node_left(node_id);
+    }
+}
+
+const NodeRoutingTable& ModelBBackend::GetNodeRoutes() const {
+    return node_routes_;
+}
+
+ErrorCode ModelBBackend::GetStatistics(BackendStats& out_stats) const {
+    stats_.Fill(out_stats);
+    out_stats.receive_queue_depth = receive_queue_.Size();
+    out_stats.receive_queue_capacity = receive_queue_.Capacity();
+    if (data_plane_) {
+        out_stats.integrity_failures = data_plane_->GetStatistics().integrity_failures;
+    }
+    return ErrorCode::Success;
+}
+
+DataPathStatistics ModelBBackend::GetStatistics() const {
+    return latency_.Snapshot();
+}
+
+DataPathLatency* ModelBBackend::GetDataPathLatency() {
+    return GetRecordableLatency(latency_);
+}
+
+bool ModelBBackend::DeliverPacket(uint8_t node_id, const uint8_t* data, size_t size) {
+    MULTIPLAYER_TRACE_PACKET();
+    MULTIPLAYER_TRACE_ZONE("ModelBBackend::DeliverPacket");
+    const uint64_t start = DataPathLatency::Now();
+    payload_bytes_queued_ = 0;
+    discovery_scheduler_.NotifyRealtimeTraffic(start);
+    wake_window_.NotifyRadioAwake();
+    if (!fec_codec_) {
+        const bool queued = QueuePacket(node_id, data, size);
+        stats_.OnReceived(node_id, size, payload_bytes_queued_, start);
+        latency_.RecordSince(DataPathHop::TransportRead, start);
+        return queued;
+    }
+
+    std::array<FecPacketView, 2> packets{};
+    const size_t count = fec_codec_->Decode(node_id, data, size, packets);
+    bool queued = true;
+    for (size_t i = 0; i < count; ++i) {
+        queued = QueuePacket(node_id, packets[i].data, packets[i].size) && queued;
+    }
+    const FecStatistics fec_statistics = fec_codec_->GetDecodeStatistics();
+    stats_.OnFecCounts(fec_statistics.packets_recovered, fec_statistics.packets_lost);
+    stats_.OnReceived(node_id, size, payload_bytes_queued_, start);
+    latency_.RecordSince(DataPathHop::TransportRead, start);
+    return queued;
+}
+
+bool ModelBBackend::QueuePacket(uint8_t node_id, const uint8_t* data, size_t size) {
+    ReceivedPacket received;
+    if (delta_codec_) {
+        // Decoded straight into the pooled buffer
+        received.packet = packet_pool_.Acquire();
+        size_t decoded_size = 0;
+        if (!received.packet ||
+            !delta_codec_->Decode(DeltaStreamKey{node_id}, data, size, received.packet.data(),
+                                  decoded_size)) {
+            return false;
+        }
+        received.packet.Resize(decoded_size);
+    } else {
+        received.packet = packet_pool_.Acquire(data, size);
+        if (!received.packet) {
+            return false;
+        }
+    }
+    received.node_id = node_id;
+    received.trace_id = MULTIPLAYER_TRACE_ID();
+    received.queued_at = Latency::Now();
+    const size_t payload_size = received.packet.size();
+    if (!receive_queue_.TryPush(std::move(received))) {
+        return false;
+    }
+    payload_bytes_queued_ += payload_size;
+    return true;
+}
+
+SpscRingStatistics ModelBBackend::GetReceiveQueueStatistics() const {
+    return receive_queue_.GetStatistics();
+}
+
+void ModelBBackend::ReportNodeLink(uint8_t node_id, const NodeLinkSample& sample) {
+    stats_.ReportLink(node_id, sample);
+}
+
+void ModelBBackend::SetPacketSender(PacketSender sender) {
+    packet_sender_ = std::move(sender);
+}
+
+ErrorCode ModelBBackend::AttachDataPlane(std::shared_ptr<AdHocDataPlane> data_plane) {
+    if (!data_plane || !data_plane->IsOpen()) {
+        return ErrorCode::InvalidParameter;
+    }
+    DetachDataPlane();
+    const ErrorCode result = data_plane->Start(
+        [this](uint8_t node_id, const uint8_t* data, size_t size) {
+            DeliverPacket(node_id, data, size);
+        });
+    if (result != ErrorCode::Success) {
+        return result;
+    }
+    packet_sender_ = [plane = data_plane.get()](uint8_t node_id, const uint8_t* data,
+                                                size_t size) {
+        return plane->Send(node_id, data, size);
+    };
+    data_plane_ = std::move(data_plane);
+    return ErrorCode::Success;
+}
+
+void ModelBBackend::DetachDataPlane() {
+    if (!data_plane_) {
+        return;
+    }
+    data_plane_->Stop();
+    packet_sender_ = nullptr;
+    data_plane_.reset();
+}
+
+void ModelBBackend::EnableDeltaCoding(const DeltaCodecConfig& config) {
+    delta_codec_ = std::make_unique<DeltaCodec>(config);
+}
+
+void ModelBBackend::DisableDeltaCoding() {
+    delta_codec_.reset();
+}
+
+void ModelBBackend::AcknowledgeDeltaPacket(uint8_t node_id, uint16_t frame_id) {
+    if (delta_codec_) {
+        delta_codec_->Acknowledge(DeltaStreamKey{node_id}, frame_id);
+    }
+}
+
+std::optional<DeltaCodecStatistics> ModelBBackend::GetDeltaCodecStatistics() const {
+    if (!delta_codec_) {
+        return std::nullopt;
+    }
+    return delta_codec_->GetStatistics();
+}
+
+DiscoveryScheduler& ModelBBackend::GetDiscoveryScheduler() {
+    return discovery_scheduler_;
+}
+
+void ModelBBackend::SetRadioPowerMode(RadioPowerMode mode) {
+    wake_window_.SetEnabled(mode == RadioPowerMode::PowerSave);
+}
+
+RadioPowerMode ModelBBackend::GetRadioPowerMode() const {
+    return wake_window_.IsEnabled() ? RadioPowerMode::PowerSave : RadioPowerMode::Performance;
+}
+
+RadioWakeWindowStatistics ModelBBackend::GetRadioWakeWindowStatistics() const {
+    return wake_window_.GetStatistics();
+}
+
+void ModelBBackend::ApplyTrafficProfile(const TrafficProfile& profile) {
+    if (profile.fec_group_size == 0) {
+        DisableForwardErrorCorrection();
+    } else if (!fec_codec_ || fec_codec_->GetConfig().group_size != profile.fec_group_size) {
+        EnableForwardErrorCorrection(FecConfig{profile.fec_group_size});
+    }
+    latest_value_key_ = profile.latest_value_key;
+}
+
+void ModelBBackend::OnFrameBoundary() {
+    frame_aligned_ = true;
+    if (data_plane_) {
+        // A failed send is counted by the data plane; the frame moves on
+        (void)data_plane_->Flush();
+    }
+}
+
+void ModelBBackend::EnableForwardErrorCorrection(const FecConfig& config) {
+    fec_codec_ = std::make_unique<FecCodec>(config);
+}
+
+void ModelBBackend::DisableForwardErrorCorrection() {
+    fec_codec_.reset();
+}
+
+std::optional<FecStatistics> ModelBBackend::GetFecStatistics() const {
+    if (!fec_codec_) {
+        return std::nullopt;
+    }
+    return fec_codec_->GetStatistics();
+}
+
 } // namespace Core::Multiplayer::ModelB
 
@@ -3,16 +3,31 @@
 
 #pragma once
 
+#include <array>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <vector>
 #include <cstdint>
 
+#include "core/multiplayer/common/advertise_data_publisher.h"
+#include "core/multiplayer/common/build_policy.h"
+#include "core/multiplayer/common/delta_codec.h"
+#include "core/multiplayer/common/fec_codec.h"
+#include "core/multiplayer/common/latency_histogram.h"
+#include "core/multiplayer/common/node_routing_table.h"
+#include "core/multiplayer/common/spsc_ring.h"
 #include "core/multiplayer/multiplayer_backend.h"
+#include "adhoc_data_plane.h"
+#include "discovery_scheduler.h"
+#include "interface_monitor.h"
 #include "mdns_discovery.h"
+#include "radio_wake_window.h"
 
 namespace Core::Multiplayer::ModelB {
 
-class ModelBBackend : public HLE::MultiplayerBackend {
+class ModelBBackend final : public HLE::MultiplayerBackend {
 public:
     static bool IsSupported();
 
@@ -33,25 +48,178 @@ public:
                    const Service::LDN::ScanFilter& filter) override;
     ErrorCode GetNetworkInfo(Service::LDN::NetworkInfo& out_info) override;
     ErrorCode GetCurrentState(Service::LDN::State& out_state) override;
+    // Narrows mDNS discovery, see MdnsDiscovery::SetDiscoveryFilter
+    void SetDiscoveryFilter(const DiscoveryFilter& filter) override;
+    // The mDNS discovered-service epoch
+    uint64_t GetNetworksEpoch() const override;
 
     ErrorCode OpenAccessPoint() override;
     ErrorCode CloseAccessPoint() override;
     ErrorCode OpenStation() override;
     ErrorCode CloseStation() override;
 
+    // Local wireless has one send class; the prioritized overloads ignore it
+    using MultiplayerBackend::SendPacket;
     ErrorCode SendPacket(const std::vector<uint8_t>& data, uint8_t node_id) override;
     ErrorCode ReceivePacket(std::vector<uint8_t>& out_data, uint8_t& out_node_id) override;
+    ErrorCode SendPacket(const PacketBuffer& packet, uint8_t node_id) override;
+    ErrorCode ReceivePacket(PacketBuffer& out_packet, uint8_t& out_node_id) override;
+    ErrorCode SendPackets(const HLE::PacketRef* packets, size_t count, size_t& out_sent) override;
+    ErrorCode ReceivePackets(ReceivedPacket* out_packets, size_t max_packets,
+                             size_t& out_received) override;
 
     ErrorCode SetAdvertiseData(const std::vector<uint8_t>& data) override;
     ErrorCode SetStationAcceptPolicy(Service::LDN::AcceptPolicy policy) override;
     ErrorCode AddAcceptFilterEntry(const Service::LDN::MacAddress& mac) override;
     ErrorCode GetSecurityParameter(Service::LDN::SecurityParameter& out_param) override;
     ErrorCode GetDisconnectReason(Service::LDN::DisconnectReason& out_reason) override;
+    ErrorCode GetIpv4Address(Service::LDN::Ipv4Address& out_address,
+                             Service::LDN::Ipv4Address& out_subnet) override;
+    ErrorCode GetNetworkConfig(Service::LDN::NetworkConfig& out_config) override;
+
+    void RegisterNodeEventCallbacks(std::function<void(uint8_t)> on_node_joined,
+                                    std::function<void(uint8_t)> on_node_left) override;
+    // Ad-hoc traffic has no batching or jitter buffer to tune; FEC only
+    void ApplyTrafficProfile(const TrafficProfile& profile) override;
+    // Flushes the data plane; from the first call on, sends only stage
+    void OnFrameBoundary() override;
+    ErrorCode GetStatistics(BackendStats& out_stats) const override;
+    DataPathStatistics GetStatistics() const override;
+    DataPathLatency* GetDataPathLatency() override;
+
+    /**
+     * Queue an inbound packet for ReceivePacket. Called from the single
+     * network thread that owns the data plane; never blocks.
+     * @return False if the pool or receive queue is exhausted (packet dropped)
+     */
+    bool DeliverPacket(uint8_t node_id, const uint8_t* data, size_t size);
+    SpscRingStatistics GetReceiveQueueStatistics() const;
+    // Entry point for the transport's view of a node's link: RTT, jitter,
+    // loss, whether it is direct or relayed and its encryption overhead
+    void ReportNodeLink(uint8_t node_id, const NodeLinkSample& sample);
+    // Platform membership events, e.g. hotspot clients coming and going;
+    // forwarded to the RegisterNodeEventCallbacks callbacks right away
+    void ReportNodeJoined(uint8_t node_id, const NodeRoute& route = {});
+    void ReportNodeLeft(uint8_t node_id);
+    /**
+     * Nodes the transport reported, for its packet sender to resolve a node
+     * without a device address lookup. A send to BROADCAST_NODE_ID goes to
+     * each of them in turn; with none reported, it is handed to the
+     * transport as is, e.g. to the data plane's own broadcast.
+     */
+    const NodeRoutingTable& GetNodeRoutes() const;
+
+    /**
+     * Transport sink for outgoing packets; without one, sends fail with
+     * NotImplemented
+     */
+    using PacketSender = std::function<ErrorCode(uint8_t node_id, const uint8_t* data, size_t size)>;
+    void SetPacketSender(PacketSender sender);
+
+    /**
+     * Uses a UDP data plane as the transport: it becomes the packet sender,
+     * every SendPacket or SendPackets call ends with one Flush of what it
+     * staged, and what it receives goes to DeliverPacket. Once frame
+     * boundaries arrive, the Flush moves to OnFrameBoundary and a frame's
+     * sends leave in one batch; a traffic profile's latest value key then
+     * lets a newer state packet overwrite one staged earlier in the frame
+     * (AdHocDataPlane::SendLatest), unless delta coding or FEC is on. The
+     * data plane must be open.
+     */
+    ErrorCode AttachDataPlane(std::shared_ptr<AdHocDataPlane> data_plane);
+    void DetachDataPlane();
+
+    /**
+     * Opt-in delta coding of LDN packets per node, between SendPacket and
+     * the packet sender and between the transport and DeliverPacket. Every
+     * node of the network must enable it; call before packets flow.
+     */
+    void EnableDeltaCoding(const DeltaCodecConfig& config);
+    void DisableDeltaCoding();
+    // For transports that learn which packets a node received
+    void AcknowledgeDeltaPacket(uint8_t node_id, uint16_t frame_id);
+    std::optional<DeltaCodecStatistics> GetDeltaCodecStatistics() const;
+
+    /**
+     * Opt-in XOR parity over each node's packets, outside delta coding. A
+     * packet lost from a group is rebuilt from the rest and handed to
+     * DeliverPacket's queue like any other; the recovered and lost counts
+     * are for the degradation manager's ReportPacketLoss.
+     */
+    void EnableForwardErrorCorrection(const FecConfig& config);
+    void DisableForwardErrorCorrection();
+    std::optional<FecStatistics> GetFecStatistics() const;
+
+    /**
+     * Paces mDNS queries while initialized, backing off in a session and
+     * pausing under realtime traffic. Platform discovery such as Wi-Fi
+     * Direct registers as another scanner; whatever joins and leaves
+     * sessions reports it with SetSessionActive.
+     */
+    DiscoveryScheduler& GetDiscoveryScheduler();
+
+    /**
+     * Power save for handhelds on Wi-Fi Direct or a hotspot: advertise
+     * updates, mDNS re-announcements and scheduled queries wait for shared
+     * wake windows so the radio can sleep between bursts. Realtime packets
+     * still go out on every send call, and open a pending window early.
+     * Performance, the default, sends everything at once.
+     */
+    void SetRadioPowerMode(RadioPowerMode mode);
+    RadioPowerMode GetRadioPowerMode() const;
+    RadioWakeWindowStatistics GetRadioWakeWindowStatistics() const;
 
 private:
+    ErrorCode SendBytes(const uint8_t* data, size_t size, uint8_t node_id);
+    ErrorCode SendToEveryNode(const uint8_t* data, size_t size);
+    ErrorCode SendFramed(const uint8_t* data, size_t size, uint8_t node_id, uint64_t send_start);
+    ErrorCode WriteToTransport(uint8_t node_id, const uint8_t* data, size_t size);
+    ErrorCode FlushTransport(ErrorCode result);
+    std::optional<uint64_t> GetLatestValueKey(const uint8_t* data, size_t size) const;
+    bool QueuePacket(uint8_t node_id, const uint8_t* data, size_t size);
+
     std::shared_ptr<HLE::ConfigurationManager> config_;
     std::shared_ptr<MdnsDiscovery> discovery_;
+    // Before everything that defers into it, so it is destroyed after them
+    RadioWakeWindow wake_window_;
     bool initialized_ {false};
+    DiscoveryScheduler discovery_scheduler_;
+    DiscoveryScheduler::ScannerId mdns_scanner_ = 0;
+    // Tells discovery about links coming up, e.g. on joining a hotspot
+    InterfaceMonitor interface_monitor_;
+    // mDNS announcements carry the whole blob, so only the rate limit applies
+    AdvertiseDataPublisher advertise_data_;
+    std::mutex node_event_mutex_;
+    std::function<void(uint8_t)> on_node_joined_;
+    std::function<void(uint8_t)> on_node_left_;
+
+    // Preallocated packet storage for the data path
+    static constexpr size_t RECEIVE_QUEUE_CAPACITY = 256;
+    PacketPool packet_pool_;
+    SpscRing<ReceivedPacket> receive_queue_{RECEIVE_QUEUE_CAPACITY};
+
+    PacketSender packet_sender_;
+    NodeRoutingTable node_routes_;
+    std::shared_ptr<AdHocDataPlane> data_plane_;
+    // Set by the first OnFrameBoundary; the data plane is then flushed per frame
+    bool frame_aligned_ = false;
+    LatestValueKey latest_value_key_;
+    std::unique_ptr<DeltaCodec> delta_codec_;
+    std::unique_ptr<FecCodec> fec_codec_;
+    // Only touched by the send path
+    std::array<uint8_t, DeltaCodec::MAX_ENCODED_SIZE> encode_buffer_{};
+    std::array<uint8_t, FecCodec::MAX_FRAMED_SIZE> fec_buffer_{};
+
+    // Recorded from the send, network and game threads alike; stand-ins
+    // that record nothing when the build policy leaves instrumentation out
+    using Instrumentation = ActiveBuildPolicy::Instrumentation;
+    using Latency = Instrumentation::Select<DataPathLatency, NullDataPathLatency>;
+    Latency latency_;
+    Instrumentation::Select<BackendStatsRecorder, NullBackendStatsRecorder> stats_;
+    // Bytes handed to the transport for the packet being sent; send path only
+    size_t wire_bytes_sent_ = 0;
+    // Bytes queued for the datagram being delivered; network thread only
+    size_t payload_bytes_queued_ = 0;
 };
 
 } // namespace Core::Multiplayer::ModelB
@@ -0,0 +1,150 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "persistent_group_store.h"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <utility>
+
+#include <nlohmann/json.hpp>
+
+namespace Core::Multiplayer::ModelB::Android {
+
+namespace {
+using json = nlohmann::json;
+
+constexpr int STORE_FORMAT_VERSION = 1;
+
+int64_t ToUnixSeconds(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+}
+
+// Android reports device addresses in either case
+std::string NormalizeAddress(const std::string& address) {
+    std::string normalized = address;
+    std::transform(normalized.begin(), normalized.end(), normalized.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return normalized;
+}
+} // namespace
+
+PersistentGroupStore::PersistentGroupStore(std::string path, size_t max_entries)
+    : path_(std::move(path)), max_entries_(std::max<size_t>(max_entries, 1)) {}
+
+bool PersistentGroupStore::Load() {
+    std::ifstream file(path_);
+    if (!file) {
+        return true;
+    }
+
+    decltype(records_) records;
+    try {
+        const json document = json::parse(file);
+        if (document.value("version", 0) != STORE_FORMAT_VERSION) {
+            return false;
+        }
+        for (const auto& entry : document.at("groups")) {
+            PersistentGroupRecord record;
+            record.network_name = entry.at("network_name").get<std::string>();
+            record.passphrase = entry.at("passphrase").get<std::string>();
+            record.is_group_owner = entry.value("is_group_owner", false);
+            record.success_count = entry.value("success_count", 0u);
+            record.last_connected = std::chrono::system_clock::time_point(
+                std::chrono::seconds(entry.at("last_connected").get<int64_t>()));
+            records[NormalizeAddress(entry.at("device_address").get<std::string>())] =
+                std::move(record);
+        }
+    } catch (const json::exception&) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    records_ = std::move(records);
+    return true;
+}
+
+std::optional<PersistentGroupRecord> PersistentGroupStore::Lookup(
+    const std::string& device_address) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = records_.find(NormalizeAddress(device_address));
+    if (it == records_.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+bool PersistentGroupStore::RecordSuccess(const std::string& device_address,
+                                         const WifiP2pGroup& group,
+                                         std::chrono::system_clock::time_point now) {
+    if (device_address.empty() || group.network_name.empty() || group.passphrase.empty()) {
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& record = records_[NormalizeAddress(device_address)];
+    if (record.network_name != group.network_name || record.passphrase != group.passphrase) {
+        record.success_count = 0;
+    }
+    record.network_name = group.network_name;
+    record.passphrase = group.passphrase;
+    record.is_group_owner = group.is_group_owner;
+    ++record.success_count;
+    record.last_connected = now;
+
+    if (records_.size() > max_entries_) {
+        const auto oldest = std::min_element(
+            records_.begin(), records_.end(), [](const auto& lhs, const auto& rhs) {
+                return lhs.second.last_connected < rhs.second.last_connected;
+            });
+        records_.erase(oldest);
+    }
+    return SaveLocked();
+}
+
+bool PersistentGroupStore::Forget(const std::string& device_address) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (records_.erase(NormalizeAddress(device_address)) == 0) {
+        return true;
+    }
+    return SaveLocked();
+}
+
+size_t PersistentGroupStore::GetRecordCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return records_.size();
+}
+
+bool PersistentGroupStore::SaveLocked() const {
+    json groups = json::array();
+    for (const auto& [device_address, record] : records_) {
+        groups.push_back({{"device_address", device_address},
+                          {"network_name", record.network_name},
+                          {"passphrase", record.passphrase},
+                          {"is_group_owner", record.is_group_owner},
+                          {"success_count", record.success_count},
+                          {"last_connected", ToUnixSeconds(record.last_connected)}});
+    }
+    const json document{{"version", STORE_FORMAT_VERSION}, {"groups", std::move(groups)}};
+
+    // Written aside and renamed over, so a crash never leaves half a file
+    const std::string temp_path = path_ + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+        file << document.dump();
+        if (!file.flush()) {
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temp_path, path_, error);
+    return !error;
+}
+
+} // namespace Core::Multiplayer::ModelB::Android
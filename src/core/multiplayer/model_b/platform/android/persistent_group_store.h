@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "wifi_direct_types.h"
+
+namespace Core::Multiplayer::ModelB::Android {
+
+/**
+ * A Wi-Fi Direct group formed with a device before
+ */
+struct PersistentGroupRecord {
+    std::string network_name;
+    std::string passphrase;
+    // This device owned the group, so reusing it means recreating it
+    bool is_group_owner = false;
+    uint32_t success_count = 0;
+    std::chrono::system_clock::time_point last_connected;
+};
+
+/**
+ * Groups formed with recently paired devices, kept across sessions so the
+ * next session with the same device can bring the group back up with its
+ * credentials instead of going through discovery and group owner
+ * negotiation. Keyed by the peer's device address.
+ *
+ * Holds at most max_entries groups, forgetting the least recently used. The
+ * file is JSON, rewritten whole through a temporary file whenever a record
+ * changes, and holds passphrases in the clear; keep it in app-private
+ * storage. A missing or unreadable file just starts an empty store.
+ */
+class PersistentGroupStore {
+public:
+    PersistentGroupStore(std::string path, size_t max_entries);
+
+    PersistentGroupStore(const PersistentGroupStore&) = delete;
+    PersistentGroupStore& operator=(const PersistentGroupStore&) = delete;
+
+    /**
+     * Reads the file, replacing what is held
+     * @return False if the file exists but could not be parsed
+     */
+    bool Load();
+
+    std::optional<PersistentGroupRecord> Lookup(const std::string& device_address) const;
+
+    /**
+     * Records a group that came up with the device and writes the file. A
+     * group without a network name or passphrase cannot be reused and is
+     * ignored.
+     * @return False if the file could not be written; the record is kept
+     */
+    bool RecordSuccess(const std::string& device_address, const WifiP2pGroup& group,
+                       std::chrono::system_clock::time_point now = std::chrono::system_clock::now());
+
+    // Drops a group that could not be brought back, and writes the file
+    bool Forget(const std::string& device_address);
+
+    size_t GetRecordCount() const;
+
+private:
+    bool SaveLocked() const;
+
+    const std::string path_;
+    const size_t max_entries_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, PersistentGroupRecord> records_;
+};
+
+} // namespace Core::Multiplayer::ModelB::Android
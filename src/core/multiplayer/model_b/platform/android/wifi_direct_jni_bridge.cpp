@@ -0,0 +1,321 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "wifi_direct_jni_bridge.h"
+
+#include "wifi_direct_peer_codec.h"
+
+namespace Core::Multiplayer::ModelB::Android {
+
+namespace {
+
+/**
+ * Keeps the current thread attached to the VM from its first JNI call until
+ * it exits. Threads that were already attached, such as Java threads calling
+ * into native code, are left alone.
+ */
+class ThreadAttachment {
+public:
+    ~ThreadAttachment() {
+        if (jvm_ && attached_here_) {
+            jvm_->DetachCurrentThread();
+        }
+    }
+
+    JNIEnv* Get(JavaVM* jvm) {
+        if (env_ && jvm_ == jvm) {
+            return env_;
+        }
+        void* env = nullptr;
+        const jint status = jvm->GetEnv(&env, JNI_VERSION_1_6);
+        if (status == JNI_OK) {
+            env_ = static_cast<JNIEnv*>(env);
+        } else if (status == JNI_EDETACHED) {
+            JNIEnv* attached = nullptr;
+            if (jvm->AttachCurrentThread(&attached, nullptr) != JNI_OK) {
+                return nullptr;
+            }
+            env_ = attached;
+            attached_here_ = true;
+        } else {
+            return nullptr;
+        }
+        jvm_ = jvm;
+        return env_;
+    }
+
+private:
+    JavaVM* jvm_ = nullptr;
+    JNIEnv* env_ = nullptr;
+    bool attached_here_ = false;
+};
+
+thread_local ThreadAttachment thread_attachment;
+
+// Clears a pending Java exception so the next JNI call is legal
+bool ClearException(JNIEnv* env) {
+    if (!env->ExceptionCheck()) {
+        return false;
+    }
+    env->ExceptionClear();
+    return true;
+}
+
+} // namespace
+
+WifiDirectJniBridge::~WifiDirectJniBridge() {
+    Shutdown();
+}
+
+ErrorCode WifiDirectJniBridge::Initialize(JavaVM* jvm, jobject android_context) {
+    if (!jvm || !android_context) {
+        return ErrorCode::InvalidParameter;
+    }
+    if (IsInitialized()) {
+        return ErrorCode::InvalidState;
+    }
+
+    jvm_ = jvm;
+    JNIEnv* env = AttachedEnv();
+    if (!env) {
+        jvm_ = nullptr;
+        return ErrorCode::PlatformAPIError;
+    }
+
+    // FindClass on a natively attached thread only searches the system class
+    // loader, so the app class is resolved here, once, and kept as a global ref
+    jclass local_class = env->FindClass(HELPER_CLASS);
+    if (ClearException(env) || !local_class) {
+        jvm_ = nullptr;
+        return ErrorCode::PlatformFeatureUnavailable;
+    }
+    helper_class_ = static_cast<jclass>(env->NewGlobalRef(local_class));
+    env->DeleteLocalRef(local_class);
+
+    const jmethodID constructor =
+        env->GetMethodID(helper_class_, "<init>", "(Landroid/content/Context;)V");
+    discover_peers_ = env->GetMethodID(helper_class_, "discoverPeers", "()Z");
+    stop_peer_discovery_ = env->GetMethodID(helper_class_, "stopPeerDiscovery", "()Z");
+    connect_ = env->GetMethodID(helper_class_, "connect", "(Ljava/lang/String;)Z");
+    cancel_connect_ = env->GetMethodID(helper_class_, "cancelConnect", "()Z");
+    create_group_ = env->GetMethodID(helper_class_, "createGroup", "()Z");
+    remove_group_ = env->GetMethodID(helper_class_, "removeGroup", "()Z");
+    join_group_ =
+        env->GetMethodID(helper_class_, "joinGroup", "(Ljava/lang/String;Ljava/lang/String;)Z");
+    create_persistent_group_ = env->GetMethodID(helper_class_, "createPersistentGroup",
+                                                "(Ljava/lang/String;Ljava/lang/String;)Z");
+    get_peers_packed_ = env->GetMethodID(helper_class_, "getPeersPacked", "()[B");
+    get_group_info_packed_ = env->GetMethodID(helper_class_, "getGroupInfoPacked", "()[B");
+    if (ClearException(env) || !constructor || !discover_peers_ || !stop_peer_discovery_ ||
+        !connect_ || !cancel_connect_ || !create_group_ || !remove_group_ || !join_group_ ||
+        !create_persistent_group_ || !get_peers_packed_ || !get_group_info_packed_) {
+        Shutdown();
+        return ErrorCode::PlatformFeatureUnavailable;
+    }
+    // Without it group traffic stays on the Java side, which is still usable
+    open_group_socket_ = env->GetMethodID(helper_class_, "openGroupSocket", "(I)I");
+    ClearException(env);
+
+    jobject local_helper = env->NewObject(helper_class_, constructor, android_context);
+    if (ClearException(env) || !local_helper) {
+        Shutdown();
+        return ErrorCode::PlatformAPIError;
+    }
+    helper_ = env->NewGlobalRef(local_helper);
+    env->DeleteLocalRef(local_helper);
+
+    return ErrorCode::Success;
+}
+
+void WifiDirectJniBridge::Shutdown() {
+    if (!jvm_) {
+        return;
+    }
+    if (JNIEnv* env = AttachedEnv()) {
+        if (helper_) {
+            env->DeleteGlobalRef(helper_);
+        }
+        if (helper_class_) {
+            env->DeleteGlobalRef(helper_class_);
+        }
+    }
+    helper_ = nullptr;
+    helper_class_ = nullptr;
+    discover_peers_ = nullptr;
+    stop_peer_discovery_ = nullptr;
+    connect_ = nullptr;
+    cancel_connect_ = nullptr;
+    create_group_ = nullptr;
+    remove_group_ = nullptr;
+    join_group_ = nullptr;
+    create_persistent_group_ = nullptr;
+    get_peers_packed_ = nullptr;
+    get_group_info_packed_ = nullptr;
+    open_group_socket_ = nullptr;
+    jvm_ = nullptr;
+}
+
+bool WifiDirectJniBridge::IsInitialized() const {
+    return helper_ != nullptr;
+}
+
+ErrorCode WifiDirectJniBridge::DiscoverPeers() {
+    return CallBoolean(discover_peers_);
+}
+
+ErrorCode WifiDirectJniBridge::StopPeerDiscovery() {
+    return CallBoolean(stop_peer_discovery_);
+}
+
+ErrorCode WifiDirectJniBridge::Connect(const std::string& device_address) {
+    if (!IsInitialized()) {
+        return ErrorCode::NotInitialized;
+    }
+    JNIEnv* env = AttachedEnv();
+    if (!env) {
+        return ErrorCode::PlatformAPIError;
+    }
+
+    jstring address = env->NewStringUTF(device_address.c_str());
+    if (ClearException(env) || !address) {
+        return ErrorCode::PlatformAPIError;
+    }
+    const jboolean result = env->CallBooleanMethod(helper_, connect_, address);
+    env->DeleteLocalRef(address);
+    if (ClearException(env) || !result) {
+        return ErrorCode::PlatformAPIError;
+    }
+    return ErrorCode::Success;
+}
+
+ErrorCode WifiDirectJniBridge::CancelConnect() {
+    return CallBoolean(cancel_connect_);
+}
+
+ErrorCode WifiDirectJniBridge::CreateGroup() {
+    return CallBoolean(create_group_);
+}
+
+ErrorCode WifiDirectJniBridge::RemoveGroup() {
+    return CallBoolean(remove_group_);
+}
+
+ErrorCode WifiDirectJniBridge::JoinGroup(const std::string& network_name,
+                                         const std::string& passphrase) {
+    return CallBoolean(join_group_, network_name, passphrase);
+}
+
+ErrorCode WifiDirectJniBridge::CreatePersistentGroup(const std::string& network_name,
+                                                     const std::string& passphrase) {
+    return CallBoolean(create_persistent_group_, network_name, passphrase);
+}
+
+ErrorCode WifiDirectJniBridge::GetPeers(std::vector<WifiP2pDevice>& out_peers) {
+    std::lock_guard lock(fetch_mutex_);
+    const ErrorCode result = FetchPacked(get_peers_packed_);
+    if (result != ErrorCode::Success) {
+        return result;
+    }
+    return DecodePackedPeers(packed_buffer_, out_peers) ? ErrorCode::Success
+                                                        : ErrorCode::InvalidResponse;
+}
+
+ErrorCode WifiDirectJniBridge::GetGroupInfo(WifiP2pGroup& out_group) {
+    std::lock_guard lock(fetch_mutex_);
+    const ErrorCode result = FetchPacked(get_group_info_packed_);
+    if (result != ErrorCode::Success) {
+        return result;
+    }
+    return DecodePackedGroup(packed_buffer_, out_group) ? ErrorCode::Success
+                                                        : ErrorCode::InvalidResponse;
+}
+
+ErrorCode WifiDirectJniBridge::OpenGroupSocket(uint16_t port, int& out_fd) {
+    if (!IsInitialized()) {
+        return ErrorCode::NotInitialized;
+    }
+    if (!open_group_socket_) {
+        return ErrorCode::PlatformFeatureUnavailable;
+    }
+    JNIEnv* env = AttachedEnv();
+    if (!env) {
+        return ErrorCode::PlatformAPIError;
+    }
+
+    // -1 when the group is down or the port is taken
+    const jint fd = env->CallIntMethod(helper_, open_group_socket_, static_cast<jint>(port));
+    if (ClearException(env) || fd < 0) {
+        return ErrorCode::PlatformAPIError;
+    }
+    out_fd = static_cast<int>(fd);
+    return ErrorCode::Success;
+}
+
+JNIEnv* WifiDirectJniBridge::AttachedEnv() const {
+    return jvm_ ? thread_attachment.Get(jvm_) : nullptr;
+}
+
+ErrorCode WifiDirectJniBridge::CallBoolean(jmethodID method) {
+    if (!IsInitialized()) {
+        return ErrorCode::NotInitialized;
+    }
+    JNIEnv* env = AttachedEnv();
+    if (!env) {
+        return ErrorCode::PlatformAPIError;
+    }
+    const jboolean result = env->CallBooleanMethod(helper_, method);
+    if (ClearException(env) || !result) {
+        return ErrorCode::PlatformAPIError;
+    }
+    return ErrorCode::Success;
+}
+
+ErrorCode WifiDirectJniBridge::CallBoolean(jmethodID method, const std::string& first,
+                                           const std::string& second) {
+    if (!IsInitialized()) {
+        return ErrorCode::NotInitialized;
+    }
+    JNIEnv* env = AttachedEnv();
+    if (!env) {
+        return ErrorCode::PlatformAPIError;
+    }
+
+    jstring first_string = env->NewStringUTF(first.c_str());
+    jstring second_string = first_string ? env->NewStringUTF(second.c_str()) : nullptr;
+    jboolean result = JNI_FALSE;
+    if (!ClearException(env) && first_string && second_string) {
+        result = env->CallBooleanMethod(helper_, method, first_string, second_string);
+    }
+    if (second_string) {
+        env->DeleteLocalRef(second_string);
+    }
+    if (first_string) {
+        env->DeleteLocalRef(first_string);
+    }
+    if (ClearException(env) || !result) {
+        return ErrorCode::PlatformAPIError;
+    }
+    return ErrorCode::Success;
+}
+
+ErrorCode WifiDirectJniBridge::FetchPacked(jmethodID method) {
+    if (!IsInitialized()) {
+        return ErrorCode::NotInitialized;
+    }
+    JNIEnv* env = AttachedEnv();
+    if (!env) {
+        return ErrorCode::PlatformAPIError;
+    }
+
+    auto packed = static_cast<jbyteArray>(env->CallObjectMethod(helper_, method));
+    if (ClearException(env) || !packed) {
+        return ErrorCode::PlatformAPIError;
+    }
+    const jsize length = env->GetArrayLength(packed);
+    packed_buffer_.resize(static_cast<size_t>(length));
+    env->GetByteArrayRegion(packed, 0, length, reinterpret_cast<jbyte*>(packed_buffer_.data()));
+    env->DeleteLocalRef(packed);
+    return ClearException(env) ? ErrorCode::PlatformAPIError : ErrorCode::Success;
+}
+
+} // namespace Core::Multiplayer::ModelB::Android
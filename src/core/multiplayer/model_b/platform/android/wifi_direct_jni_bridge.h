@@ -0,0 +1,100 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <jni.h>
+
+#include "../../common/error_codes.h"
+#include "wifi_direct_types.h"
+
+namespace Core::Multiplayer::ModelB::Android {
+
+/**
+ * Calls into the app's WifiDirectHelper Java class, which owns the
+ * WifiP2pManager and its listeners.
+ *
+ * Initialize() resolves the helper class and every method id once and keeps
+ * the class and helper instance as global refs, so a call is a cached
+ * Call*Method with no FindClass or GetMethodID lookup. Peer lists and group
+ * info come back as one packed byte[] (see wifi_direct_peer_codec.h) copied
+ * into a reused buffer, rather than a Java object and several field calls per
+ * device. Native threads are attached to the VM on their first call and
+ * detached when they exit.
+ */
+class WifiDirectJniBridge {
+public:
+    // Fully qualified name of the Java counterpart
+    static constexpr const char* HELPER_CLASS = "org/sudachi/sudachi_emu/network/WifiDirectHelper";
+
+    WifiDirectJniBridge() = default;
+    ~WifiDirectJniBridge();
+
+    WifiDirectJniBridge(const WifiDirectJniBridge&) = delete;
+    WifiDirectJniBridge& operator=(const WifiDirectJniBridge&) = delete;
+
+    // Must be called from a thread that can see app classes, such as the
+    // thread that received the context from Java
+    [[nodiscard]] ErrorCode Initialize(JavaVM* jvm, jobject android_context);
+    void Shutdown();
+    bool IsInitialized() const;
+
+    [[nodiscard]] ErrorCode DiscoverPeers();
+    [[nodiscard]] ErrorCode StopPeerDiscovery();
+    [[nodiscard]] ErrorCode Connect(const std::string& device_address);
+    [[nodiscard]] ErrorCode CancelConnect();
+    [[nodiscard]] ErrorCode CreateGroup();
+    [[nodiscard]] ErrorCode RemoveGroup();
+
+    // Bring up a known group from its credentials, with no discovery or group
+    // owner negotiation (WifiP2pConfig.Builder, API 29)
+    [[nodiscard]] ErrorCode JoinGroup(const std::string& network_name,
+                                      const std::string& passphrase);
+    [[nodiscard]] ErrorCode CreatePersistentGroup(const std::string& network_name,
+                                                  const std::string& passphrase);
+
+    // Peers from the latest discovery results, in one JNI round trip
+    [[nodiscard]] ErrorCode GetPeers(std::vector<WifiP2pDevice>& out_peers);
+    [[nodiscard]] ErrorCode GetGroupInfo(WifiP2pGroup& out_group);
+
+    /**
+     * Has Java bind a UDP socket to port on the group interface and detach its
+     * descriptor (ParcelFileDescriptor.detachFd), so group traffic is sent
+     * and received natively with no per-packet JNI call or byte[] copy. The
+     * caller owns out_fd.
+     * @return PlatformFeatureUnavailable if the helper has no openGroupSocket
+     */
+    [[nodiscard]] ErrorCode OpenGroupSocket(uint16_t port, int& out_fd);
+
+private:
+    JNIEnv* AttachedEnv() const;
+    ErrorCode CallBoolean(jmethodID method);
+    ErrorCode CallBoolean(jmethodID method, const std::string& first, const std::string& second);
+    ErrorCode FetchPacked(jmethodID method);
+
+    JavaVM* jvm_ = nullptr;
+    jclass helper_class_ = nullptr; // Global ref
+    jobject helper_ = nullptr;      // Global ref
+
+    jmethodID discover_peers_ = nullptr;
+    jmethodID stop_peer_discovery_ = nullptr;
+    jmethodID connect_ = nullptr;
+    jmethodID cancel_connect_ = nullptr;
+    jmethodID create_group_ = nullptr;
+    jmethodID remove_group_ = nullptr;
+    jmethodID join_group_ = nullptr;
+    jmethodID create_persistent_group_ = nullptr;
+    jmethodID get_peers_packed_ = nullptr;
+    jmethodID get_group_info_packed_ = nullptr;
+    jmethodID open_group_socket_ = nullptr; // Optional; older helpers lack it
+
+    // Guards packed_buffer_, which is reused across fetches
+    std::mutex fetch_mutex_;
+    std::vector<uint8_t> packed_buffer_;
+};
+
+} // namespace Core::Multiplayer::ModelB::Android
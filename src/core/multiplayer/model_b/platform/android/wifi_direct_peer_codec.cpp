@@ -0,0 +1,187 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "wifi_direct_peer_codec.h"
+
+#include <algorithm>
+#include <array>
+#include <string>
+
+namespace Core::Multiplayer::ModelB::Android {
+
+namespace {
+
+constexpr uint8_t FLAG_GROUP_OWNER = 0x01;
+constexpr size_t MAC_LENGTH = 6;
+
+class Reader {
+public:
+    explicit Reader(std::span<const uint8_t> data) : data_(data) {}
+
+    bool ReadU8(uint8_t& out) {
+        if (offset_ + 1 > data_.size()) {
+            return false;
+        }
+        out = data_[offset_++];
+        return true;
+    }
+
+    bool ReadU16(uint16_t& out) {
+        if (offset_ + 2 > data_.size()) {
+            return false;
+        }
+        out = static_cast<uint16_t>((data_[offset_] << 8) | data_[offset_ + 1]);
+        offset_ += 2;
+        return true;
+    }
+
+    bool ReadBytes(size_t length, std::span<const uint8_t>& out) {
+        if (offset_ + length > data_.size()) {
+            return false;
+        }
+        out = data_.subspan(offset_, length);
+        offset_ += length;
+        return true;
+    }
+
+    bool ReadString(std::string& out) {
+        uint8_t length = 0;
+        std::span<const uint8_t> bytes;
+        if (!ReadU8(length) || !ReadBytes(length, bytes)) {
+            return false;
+        }
+        out.assign(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        return true;
+    }
+
+private:
+    std::span<const uint8_t> data_;
+    size_t offset_ = 0;
+};
+
+std::string FormatMac(std::span<const uint8_t> mac) {
+    static constexpr char HEX[] = "0123456789abcdef";
+    std::string address(MAC_LENGTH * 3 - 1, ':');
+    for (size_t i = 0; i < MAC_LENGTH; ++i) {
+        address[i * 3] = HEX[mac[i] >> 4];
+        address[i * 3 + 1] = HEX[mac[i] & 0x0F];
+    }
+    return address;
+}
+
+int HexValue(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+std::array<uint8_t, MAC_LENGTH> ParseMac(const std::string& address) {
+    std::array<uint8_t, MAC_LENGTH> mac{};
+    if (address.size() != MAC_LENGTH * 3 - 1) {
+        return mac;
+    }
+    for (size_t i = 0; i < MAC_LENGTH; ++i) {
+        const int high = HexValue(address[i * 3]);
+        const int low = HexValue(address[i * 3 + 1]);
+        if (high < 0 || low < 0 || (i + 1 < MAC_LENGTH && address[i * 3 + 2] != ':')) {
+            return {};
+        }
+        mac[i] = static_cast<uint8_t>((high << 4) | low);
+    }
+    return mac;
+}
+
+bool DecodePeerBody(Reader& reader, std::vector<WifiP2pDevice>& out_peers) {
+    uint16_t count = 0;
+    if (!reader.ReadU16(count) || count > WIFI_DIRECT_MAX_PEERS) {
+        return false;
+    }
+
+    std::vector<WifiP2pDevice> peers(count);
+    for (auto& peer : peers) {
+        uint8_t status = 0;
+        uint8_t flags = 0;
+        std::span<const uint8_t> mac;
+        if (!reader.ReadU8(status) || !reader.ReadU8(flags) ||
+            !reader.ReadString(peer.device_name) || !reader.ReadBytes(MAC_LENGTH, mac)) {
+            return false;
+        }
+        peer.status = status;
+        peer.is_group_owner = (flags & FLAG_GROUP_OWNER) != 0;
+        peer.device_address = FormatMac(mac);
+    }
+    out_peers = std::move(peers);
+    return true;
+}
+
+void AppendString(std::vector<uint8_t>& out, const std::string& value) {
+    const size_t length = std::min<size_t>(value.size(), 0xFF);
+    out.push_back(static_cast<uint8_t>(length));
+    out.insert(out.end(), value.begin(), value.begin() + length);
+}
+
+void EncodePeerBody(std::vector<uint8_t>& out, const std::vector<WifiP2pDevice>& peers) {
+    const size_t count = std::min(peers.size(), WIFI_DIRECT_MAX_PEERS);
+    out.push_back(static_cast<uint8_t>(count >> 8));
+    out.push_back(static_cast<uint8_t>(count));
+    for (size_t i = 0; i < count; ++i) {
+        const auto& peer = peers[i];
+        out.push_back(static_cast<uint8_t>(peer.status));
+        out.push_back(peer.is_group_owner ? FLAG_GROUP_OWNER : 0);
+        AppendString(out, peer.device_name);
+        const auto mac = ParseMac(peer.device_address);
+        out.insert(out.end(), mac.begin(), mac.end());
+    }
+}
+
+} // namespace
+
+bool DecodePackedPeers(std::span<const uint8_t> packed, std::vector<WifiP2pDevice>& out_peers) {
+    Reader reader(packed);
+    uint8_t version = 0;
+    if (!reader.ReadU8(version) || version != WIFI_DIRECT_PACKED_VERSION) {
+        return false;
+    }
+    return DecodePeerBody(reader, out_peers);
+}
+
+bool DecodePackedGroup(std::span<const uint8_t> packed, WifiP2pGroup& out_group) {
+    Reader reader(packed);
+    uint8_t version = 0;
+    uint8_t flags = 0;
+    WifiP2pGroup group;
+    if (!reader.ReadU8(version) || version != WIFI_DIRECT_PACKED_VERSION ||
+        !reader.ReadU8(flags) || !reader.ReadString(group.network_name) ||
+        !reader.ReadString(group.passphrase) || !DecodePeerBody(reader, group.clients)) {
+        return false;
+    }
+    group.is_group_owner = (flags & FLAG_GROUP_OWNER) != 0;
+    out_group = std::move(group);
+    return true;
+}
+
+std::vector<uint8_t> EncodePackedPeers(const std::vector<WifiP2pDevice>& peers) {
+    std::vector<uint8_t> out;
+    out.push_back(WIFI_DIRECT_PACKED_VERSION);
+    EncodePeerBody(out, peers);
+    return out;
+}
+
+std::vector<uint8_t> EncodePackedGroup(const WifiP2pGroup& group) {
+    std::vector<uint8_t> out;
+    out.push_back(WIFI_DIRECT_PACKED_VERSION);
+    out.push_back(group.is_group_owner ? FLAG_GROUP_OWNER : 0);
+    AppendString(out, group.network_name);
+    AppendString(out, group.passphrase);
+    EncodePeerBody(out, group.clients);
+    return out;
+}
+
+} // namespace Core::Multiplayer::ModelB::Android
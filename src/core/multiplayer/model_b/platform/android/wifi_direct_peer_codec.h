@@ -0,0 +1,43 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "wifi_direct_types.h"
+
+namespace Core::Multiplayer::ModelB::Android {
+
+/**
+ * Packed byte[] formats the Java WifiDirectHelper hands across JNI, so a
+ * whole peer list or group costs one array copy instead of a JNI call per
+ * field of every WifiP2pDevice.
+ *
+ * Peer list:
+ *   u8 version, u16 count (big endian), then per device:
+ *   u8 status, u8 flags (bit 0: group owner), u8 name length, name bytes,
+ *   6 address bytes
+ *
+ * Group:
+ *   u8 version, u8 flags (bit 0: group owner), u8 name length, name bytes,
+ *   u8 passphrase length, passphrase bytes, then a peer list body (count and
+ *   devices, no version) for the clients
+ */
+constexpr uint8_t WIFI_DIRECT_PACKED_VERSION = 1;
+constexpr size_t WIFI_DIRECT_MAX_PEERS = 64;
+
+// Returns false if the buffer is truncated, has an unknown version or lists
+// more than WIFI_DIRECT_MAX_PEERS devices
+bool DecodePackedPeers(std::span<const uint8_t> packed, std::vector<WifiP2pDevice>& out_peers);
+bool DecodePackedGroup(std::span<const uint8_t> packed, WifiP2pGroup& out_group);
+
+// The Java side's encoding, for tests and the mock environment. Names longer
+// than 255 bytes are truncated and unparseable addresses are sent as zeros
+std::vector<uint8_t> EncodePackedPeers(const std::vector<WifiP2pDevice>& peers);
+std::vector<uint8_t> EncodePackedGroup(const WifiP2pGroup& group);
+
+} // namespace Core::Multiplayer::ModelB::Android
@@ -0,0 +1,27 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace Core::Multiplayer::ModelB::Android {
+
+// Represents discovered Wi-Fi Direct peer information
+struct WifiP2pDevice {
+    std::string device_name;
+    std::string device_address;
+    int status; // WifiP2pDevice.CONNECTED, INVITED, FAILED, AVAILABLE, UNAVAILABLE
+    bool is_group_owner;
+};
+
+// Represents Wi-Fi Direct group information
+struct WifiP2pGroup {
+    std::string network_name;
+    std::string passphrase;
+    bool is_group_owner;
+    std::vector<WifiP2pDevice> clients;
+};
+
+} // namespace Core::Multiplayer::ModelB::Android
@@ -3,12 +3,19 @@
 
 
 #include "wifi_direct_wrapper.h"
+#include "../../common/datagram_socket.h"
 #include "../../common/error_codes.h"
+#include "../../common/startup_profile.h"
+#include "../../discovery_scheduler.h"
+#include "persistent_group_store.h"
+#include "wifi_direct_jni_bridge.h"
 #include "../tests/mocks/mock_jni_env.h"
+#include <algorithm>
 #include <mutex>
 #include <atomic>
 #include <thread>
 #include <chrono>
+#include <unistd.h>
 
 namespace Core::Multiplayer::ModelB::Android {
 
@@ -29,6 +36,7 @@ public:
     // JNI objects (real mode)
     JavaVM* jvm_ = nullptr;
     jobject android_context_ = nullptr;
+    WifiDirectJniBridge jni_bridge_;
     
     // Mock objects (test mode)
     MockJNIEnv* mock_env_ = nullptr;
@@ -51,6 +59,15 @@ public:
     // Configuration
     std::chrono::seconds discovery_timeout_{30};
 
+    // Persistent groups, when enabled
+    std::unique_ptr<PersistentGroupStore> group_store_;
+    // Device the connection thread is connecting to
+    std::string connecting_address_;
+
+    // Scheduler pacing discovery, when attached
+    DiscoveryScheduler* scheduler_ = nullptr;
+    DiscoveryScheduler::ScannerId scanner_id_ = 0;
+
     // Thread safety
     mutable std::mutex state_mutex_;
 
@@ -62,7 +79,46 @@ public:
     std::atomic<bool> discovery_cancel_{false};
     std::atomic<bool> connection_cancel_{false};
     
+    // Real mode: how often discovery re-reads the peer list from Java
+    static constexpr std::chrono::milliseconds PEER_POLL_INTERVAL{500};
+
     // Helper methods
+    // Real mode: replaces discovered_peers_ with the helper's current list,
+    // returning true if it changed
+    bool RefreshPeers() {
+        std::vector<WifiP2pDevice> peers;
+        if (jni_bridge_.GetPeers(peers) != ErrorCode::Success) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(peers_mutex_);
+        const bool changed =
+            peers.size() != discovered_peers_.size() ||
+            !std::equal(peers.begin(), peers.end(), discovered_peers_.begin(),
+                        [](const WifiP2pDevice& a, const WifiP2pDevice& b) {
+                            return a.device_address == b.device_address &&
+                                   a.device_name == b.device_name && a.status == b.status &&
+                                   a.is_group_owner == b.is_group_owner;
+                        });
+        discovered_peers_ = std::move(peers);
+        return changed;
+    }
+
+    void NotifyGroup() {
+        std::lock_guard<std::mutex> callback_lock(callbacks_mutex_);
+        std::lock_guard<std::mutex> group_lock(group_mutex_);
+        if (group_callback_) {
+            group_callback_(current_group_);
+        }
+    }
+
+    void NotifyPeers() {
+        std::lock_guard<std::mutex> callback_lock(callbacks_mutex_);
+        std::lock_guard<std::mutex> peers_lock(peers_mutex_);
+        if (discovery_callback_) {
+            discovery_callback_(discovered_peers_);
+        }
+    }
+
     bool IsValidMacAddress(const std::string& address) const {
         if (address.empty() || address.length() != 17) return false;
         // Basic MAC address format check: XX:XX:XX:XX:XX:XX
@@ -105,6 +161,12 @@ ErrorCode WiFiDirectWrapper::Initialize(JavaVM* jvm, jobject android_context) {
         return ErrorCode::InvalidState;
     }
     
+    // Resolves the Java helper and its method ids once, up front
+    const ErrorCode bridge_result = impl_->jni_bridge_.Initialize(jvm, android_context);
+    if (bridge_result != ErrorCode::Success) {
+        return bridge_result;
+    }
+
     impl_->jvm_ = jvm;
     impl_->android_context_ = android_context;
     impl_->is_mock_mode_ = false;
@@ -158,6 +220,8 @@ ErrorCode WiFiDirectWrapper::Initialize(MockJNIEnv* mock_env, MockAndroidContext
 }
 
 void WiFiDirectWrapper::Shutdown() {
+    DetachDiscoveryScheduler();
+
     // Cancel any running operations
     impl_->discovery_cancel_.store(true);
     if (impl_->discovery_thread_.joinable()) {
@@ -190,6 +254,7 @@ void WiFiDirectWrapper::Shutdown() {
     }
 
     // Reset JNI/mock references
+    impl_->jni_bridge_.Shutdown();
     impl_->jvm_ = nullptr;
     impl_->android_context_ = nullptr;
     impl_->mock_env_ = nullptr;
@@ -225,6 +290,13 @@ ErrorCode WiFiDirectWrapper::StartDiscovery(PeerDiscoveryCallback callback) {
         // Real implementation would call mock_wifi_p2p_manager_->DiscoverPeers
     }
 
+    if (!impl_->is_mock_mode_) {
+        const ErrorCode result = impl_->jni_bridge_.DiscoverPeers();
+        if (result != ErrorCode::Success) {
+            return result;
+        }
+    }
+
     impl_->SetState(WifiDirectState::Discovering);
     
     // Clean up any previous discovery thread
@@ -246,22 +318,28 @@ ErrorCode WiFiDirectWrapper::StartDiscovery(PeerDiscoveryCallback callback) {
             std::lock_guard<std::mutex> lock(impl_->peers_mutex_);
             // For now, keep peers empty for minimal implementation
             // Real implementation would populate from mock data
+        } else {
+            impl_->RefreshPeers();
         }
 
         // Notify callback
-        {
-            std::lock_guard<std::mutex> callback_lock(impl_->callbacks_mutex_);
-            std::lock_guard<std::mutex> peers_lock(impl_->peers_mutex_);
-            if (impl_->discovery_callback_) {
-                impl_->discovery_callback_(impl_->discovered_peers_);
-            }
-        }
+        impl_->NotifyPeers();
 
         auto elapsed = std::chrono::milliseconds{0};
+        auto since_poll = std::chrono::milliseconds{0};
         while (!impl_->discovery_cancel_.load() &&
                elapsed < impl_->discovery_timeout_) {
             std::this_thread::sleep_for(std::chrono::milliseconds(50));
             elapsed += std::chrono::milliseconds(50);
+            since_poll += std::chrono::milliseconds(50);
+
+            // One packed array per poll, however many peers are in range
+            if (!impl_->is_mock_mode_ && since_poll >= Impl::PEER_POLL_INTERVAL) {
+                since_poll = {};
+                if (impl_->RefreshPeers()) {
+                    impl_->NotifyPeers();
+                }
+            }
         }
 
         if (!impl_->discovery_cancel_.load() &&
@@ -283,6 +361,10 @@ ErrorCode WiFiDirectWrapper::StopDiscovery() {
         impl_->discovery_thread_.join();
     }
 
+    if (!impl_->is_mock_mode_) {
+        static_cast<void>(impl_->jni_bridge_.StopPeerDiscovery());
+    }
+
     impl_->SetState(WifiDirectState::Initialized);
     return ErrorCode::Success;
 }
@@ -306,6 +388,15 @@ ErrorCode WiFiDirectWrapper::ConnectToPeer(const std::string& device_address) {
         return ErrorCode::InvalidState;
     }
 
+    BeginStartupPhase(StartupPhase::WifiDirectNegotiation);
+    if (!impl_->is_mock_mode_) {
+        const ErrorCode result = impl_->jni_bridge_.Connect(device_address);
+        if (result != ErrorCode::Success) {
+            EndStartupPhase(StartupPhase::WifiDirectNegotiation, false);
+            return result;
+        }
+    }
+
     impl_->SetState(WifiDirectState::Connecting);
 
     // Clean up previous connection thread
@@ -313,15 +404,33 @@ ErrorCode WiFiDirectWrapper::ConnectToPeer(const std::string& device_address) {
     if (impl_->connection_thread_.joinable()) {
         impl_->connection_thread_.join();
     }
+    impl_->connecting_address_ = device_address;
 
     // Simulate connection with timeout
     impl_->connection_thread_ = std::thread([this]() {
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
         if (impl_->connection_cancel_.load()) {
+            EndStartupPhase(StartupPhase::WifiDirectNegotiation, false);
             return;
         }
         // For minimal implementation, assume connection succeeds
+        EndStartupPhase(StartupPhase::WifiDirectNegotiation);
         impl_->SetState(WifiDirectState::Connected);
+
+        // Remember the negotiated group so the next session with this device
+        // can skip straight to JoinGroup
+        WifiP2pGroup group;
+        if (!impl_->is_mock_mode_ &&
+            impl_->jni_bridge_.GetGroupInfo(group) == ErrorCode::Success) {
+            if (impl_->group_store_) {
+                impl_->group_store_->RecordSuccess(impl_->connecting_address_, group);
+            }
+            {
+                std::lock_guard<std::mutex> lock(impl_->group_mutex_);
+                impl_->current_group_ = std::move(group);
+            }
+            impl_->NotifyGroup();
+        }
     });
 
     return ErrorCode::Success;
@@ -352,6 +461,10 @@ ErrorCode WiFiDirectWrapper::CancelConnection() {
         impl_->connection_thread_.join();
     }
 
+    if (!impl_->is_mock_mode_) {
+        static_cast<void>(impl_->jni_bridge_.CancelConnect());
+    }
+
     impl_->SetState(WifiDirectState::Initialized);
     return ErrorCode::Success;
 }
@@ -366,25 +479,36 @@ ErrorCode WiFiDirectWrapper::CreateGroup() {
         return ErrorCode::InvalidState;
     }
     
+    StartupSpan span(StartupPhase::WifiDirectNegotiation);
+    WifiP2pGroup group;
+    if (impl_->is_mock_mode_) {
+        group.network_name = "DIRECT-sudachi";
+        group.passphrase = "sudachi123";
+        group.is_group_owner = true;
+    } else {
+        const ErrorCode result = impl_->jni_bridge_.CreateGroup();
+        if (result != ErrorCode::Success) {
+            span.Fail();
+            return result;
+        }
+        // The framework may not have formed the group yet; an empty name
+        // is filled in by a later GetGroupInfo round trip
+        if (impl_->jni_bridge_.GetGroupInfo(group) != ErrorCode::Success) {
+            group = WifiP2pGroup{};
+        }
+        group.is_group_owner = true;
+    }
+
     // Create group info
     {
         std::lock_guard<std::mutex> lock(impl_->group_mutex_);
-        impl_->current_group_.network_name = "DIRECT-sudachi";
-        impl_->current_group_.passphrase = "sudachi123";
-        impl_->current_group_.is_group_owner = true;
-        impl_->current_group_.clients.clear();
+        impl_->current_group_ = std::move(group);
     }
     
     impl_->SetState(WifiDirectState::GroupOwner);
     
     // Notify group callback
-    {
-        std::lock_guard<std::mutex> callback_lock(impl_->callbacks_mutex_);
-        std::lock_guard<std::mutex> group_lock(impl_->group_mutex_);
-        if (impl_->group_callback_) {
-            impl_->group_callback_(impl_->current_group_);
-        }
-    }
+    impl_->NotifyGroup();
     
     return ErrorCode::Success;
 }
@@ -394,6 +518,10 @@ ErrorCode WiFiDirectWrapper::RemoveGroup() {
         impl_->state_.load() != WifiDirectState::GroupClient) {
         return ErrorCode::InvalidState;
     }
+
+    if (!impl_->is_mock_mode_) {
+        static_cast<void>(impl_->jni_bridge_.RemoveGroup());
+    }
     
     // Clear group info
     {
@@ -418,11 +546,89 @@ ErrorCode WiFiDirectWrapper::JoinGroup(const std::string& device_address) {
         impl_->state_.load() == WifiDirectState::GroupClient) {
         return ErrorCode::InvalidState;
     }
-    
-    impl_->SetState(WifiDirectState::GroupClient);
+
+    const auto record =
+        impl_->group_store_ ? impl_->group_store_->Lookup(device_address) : std::nullopt;
+    if (!record) {
+        impl_->SetState(WifiDirectState::GroupClient);
+        return ErrorCode::Success;
+    }
+
+    // Bring the remembered group back in the role this device had in it: the
+    // owner recreates it with the same credentials and the client joins it
+    StartupSpan span(StartupPhase::WifiDirectNegotiation);
+    if (!impl_->is_mock_mode_) {
+        const ErrorCode result =
+            record->is_group_owner
+                ? impl_->jni_bridge_.CreatePersistentGroup(record->network_name, record->passphrase)
+                : impl_->jni_bridge_.JoinGroup(record->network_name, record->passphrase);
+        if (result != ErrorCode::Success) {
+            // Stale credentials; the caller falls back to discovery
+            impl_->group_store_->Forget(device_address);
+            span.Fail();
+            return result;
+        }
+    }
+
+    WifiP2pGroup group;
+    group.network_name = record->network_name;
+    group.passphrase = record->passphrase;
+    group.is_group_owner = record->is_group_owner;
+    impl_->group_store_->RecordSuccess(device_address, group);
+    {
+        std::lock_guard<std::mutex> lock(impl_->group_mutex_);
+        impl_->current_group_ = std::move(group);
+    }
+
+    impl_->SetState(record->is_group_owner ? WifiDirectState::GroupOwner
+                                           : WifiDirectState::GroupClient);
+    impl_->NotifyGroup();
     return ErrorCode::Success;
 }
 
+ErrorCode WiFiDirectWrapper::OpenGroupSocket(uint16_t port, DatagramSocket& out_socket) {
+    const WifiDirectState state = impl_->state_.load();
+    if (state == WifiDirectState::Uninitialized) {
+        return ErrorCode::NotInitialized;
+    }
+    if (state != WifiDirectState::Connected && state != WifiDirectState::GroupOwner &&
+        state != WifiDirectState::GroupClient) {
+        return ErrorCode::InvalidState;
+    }
+
+    if (impl_->is_mock_mode_) {
+        // No group interface to bind to; any local socket stands in for it
+        return out_socket.Open("0.0.0.0", port);
+    }
+
+    int fd = -1;
+    const ErrorCode result = impl_->jni_bridge_.OpenGroupSocket(port, fd);
+    if (result != ErrorCode::Success) {
+        return result;
+    }
+    const ErrorCode adopted = out_socket.Adopt(static_cast<intptr_t>(fd));
+    if (adopted != ErrorCode::Success) {
+        ::close(fd);
+    }
+    return adopted;
+}
+
+ErrorCode WiFiDirectWrapper::EnablePersistentGroups(const std::string& path, size_t max_groups) {
+    if (path.empty()) {
+        return ErrorCode::InvalidParameter;
+    }
+
+    auto store = std::make_unique<PersistentGroupStore>(path, max_groups);
+    // An unreadable file is replaced on the next write
+    static_cast<void>(store->Load());
+    impl_->group_store_ = std::move(store);
+    return ErrorCode::Success;
+}
+
+bool WiFiDirectWrapper::HasPersistentGroup(const std::string& device_address) const {
+    return impl_->group_store_ && impl_->group_store_->Lookup(device_address).has_value();
+}
+
 WifiP2pGroup WiFiDirectWrapper::GetGroupInfo() const {
     std::lock_guard<std::mutex> lock(impl_->group_mutex_);
     return impl_->current_group_;
@@ -442,4 +648,37 @@ void WiFiDirectWrapper::SetDiscoveryTimeout(std::chrono::seconds timeout) {
     impl_->discovery_timeout_ = timeout;
 }
 
+ErrorCode WiFiDirectWrapper::AttachDiscoveryScheduler(DiscoveryScheduler& scheduler,
+                                                      PeerDiscoveryCallback callback) {
+    if (impl_->state_.load() == WifiDirectState::Uninitialized) {
+        return ErrorCode::NotInitialized;
+    }
+    DetachDiscoveryScheduler();
+
+    impl_->scheduler_ = &scheduler;
+    impl_->scanner_id_ = scheduler.AddScanner(
+        "wifi_direct",
+        [this, callback = std::move(callback)] {
+            // Only from idle; a running discovery or a connection is left alone
+            if (impl_->state_.load() == WifiDirectState::Initialized) {
+                static_cast<void>(StartDiscovery(callback));
+            }
+        },
+        [this] {
+            if (impl_->state_.load() == WifiDirectState::Discovering) {
+                static_cast<void>(StopDiscovery());
+            }
+        });
+    return ErrorCode::Success;
+}
+
+void WiFiDirectWrapper::DetachDiscoveryScheduler() {
+    if (impl_->scheduler_) {
+        // Waits out a scan the scheduler is running on this wrapper
+        impl_->scheduler_->RemoveScanner(impl_->scanner_id_);
+        impl_->scheduler_ = nullptr;
+        impl_->scanner_id_ = 0;
+    }
+}
+
 } // namespace Core::Multiplayer::ModelB::Android
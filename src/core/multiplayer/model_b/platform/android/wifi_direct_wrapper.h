@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -12,6 +14,15 @@
 #include <jni.h>
 
 #include "../../common/error_codes.h"
+#include "wifi_direct_types.h"
+
+namespace Core::Multiplayer {
+class DatagramSocket;
+}
+
+namespace Core::Multiplayer::ModelB {
+class DiscoveryScheduler;
+}
 
 namespace Core::Multiplayer::ModelB::Android {
 
@@ -19,22 +30,6 @@ namespace Core::Multiplayer::ModelB::Android {
 class MockJNIEnv;
 class MockAndroidContext;
 
-// Represents discovered Wi-Fi Direct peer information
-struct WifiP2pDevice {
-    std::string device_name;
-    std::string device_address;
-    int status; // WifiP2pDevice.CONNECTED, INVITED, FAILED, AVAILABLE, UNAVAILABLE
-    bool is_group_owner;
-};
-
-// Represents Wi-Fi Direct group information
-struct WifiP2pGroup {
-    std::string network_name;
-    std::string passphrase;
-    bool is_group_owner;
-    std::vector<WifiP2pDevice> clients;
-};
-
 // Wi-Fi Direct connection state
 enum class WifiDirectState {
     Uninitialized,
@@ -80,9 +75,27 @@ public:
     // Group management
     [[nodiscard]] ErrorCode CreateGroup();
     [[nodiscard]] ErrorCode RemoveGroup();
+    // Reuses the group remembered for the device when persistent groups are
+    // enabled, skipping discovery and group owner negotiation
     [[nodiscard]] ErrorCode JoinGroup(const std::string& device_address);
     [[nodiscard]] WifiP2pGroup GetGroupInfo() const;
 
+    /**
+     * Opens a UDP socket on the group interface that native code owns, so
+     * group traffic goes straight to the native socket layer instead of
+     * through Java byte arrays. Needs a formed group or connection.
+     * @return PlatformFeatureUnavailable if the Java helper cannot hand over
+     *         its socket
+     */
+    [[nodiscard]] ErrorCode OpenGroupSocket(uint16_t port, DatagramSocket& out_socket);
+
+    // Persistent groups: groups formed through ConnectToPeer are remembered in
+    // the file at path, so the next session with that device can go straight
+    // to JoinGroup
+    [[nodiscard]] ErrorCode EnablePersistentGroups(const std::string& path,
+                                                   size_t max_groups = 16);
+    bool HasPersistentGroup(const std::string& device_address) const;
+
     // Callbacks
     void SetConnectionStateCallback(ConnectionStateCallback callback);
     void SetGroupInfoCallback(GroupInfoCallback callback);
@@ -90,6 +103,15 @@ public:
     // Configuration
     void SetDiscoveryTimeout(std::chrono::seconds timeout);
 
+    /**
+     * Lets the scheduler decide when to discover: every scan it grants runs
+     * one discovery of the discovery timeout, reported to callback, and a
+     * discovery still running when realtime traffic starts is stopped
+     */
+    [[nodiscard]] ErrorCode AttachDiscoveryScheduler(DiscoveryScheduler& scheduler,
+                                                     PeerDiscoveryCallback callback);
+    void DetachDiscoveryScheduler();
+
 private:
     class Impl;
     std::unique_ptr<Impl> impl_;
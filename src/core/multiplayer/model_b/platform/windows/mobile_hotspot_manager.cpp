@@ -5,10 +5,96 @@
 #include <mutex>
 #include <vector>
 #include <algorithm>
+#include <cctype>
+#include <utility>
+
+// WinRT headers - conditionally included based on SDK availability
+#if defined(WINRT_BASE_H)
+#include <winrt/Windows.Foundation.Collections.h>
+#include <winrt/Windows.Networking.Connectivity.h>
+#include <winrt/Windows.Networking.NetworkOperators.h>
+#include <winrt/Windows.Networking.h>
+#include <winrt/base.h>
+#endif
 
 namespace Core::Multiplayer::ModelB::Windows {
 
-// Minimal implementation to make tests pass
+namespace {
+
+// LDN networks hold 8 nodes and the host is node 0
+constexpr uint8_t FIRST_CLIENT_NODE_ID = 1;
+constexpr uint8_t MAX_NODE_ID = 7;
+
+struct TrackedClient {
+    uint8_t node_id;
+    ClientInfo info;
+};
+
+// Join and leave events gathered under the lock, dispatched after it
+struct ClientEvents {
+    std::vector<TrackedClient> joined;
+    std::vector<TrackedClient> left;
+};
+
+// Windows reports MAC addresses dash separated, other sources use colons
+std::string NormalizeMac(const std::string& mac_address) {
+    std::string normalized = mac_address;
+    for (char& c : normalized) {
+        c = c == '-' ? ':' : static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+    return normalized;
+}
+
+#if defined(WINRT_BASE_H)
+// Shared with in-flight refreshes, which may outlive the subscription
+struct ClientRefreshTarget {
+    std::mutex mutex;
+    MobileHotspotManager* manager = nullptr; // Cleared when the subscription ends
+};
+
+winrt::fire_and_forget RefreshTetheringClients(std::shared_ptr<ClientRefreshTarget> target) {
+    using namespace winrt::Windows::Networking;
+    using namespace winrt::Windows::Networking::Connectivity;
+    using namespace winrt::Windows::Networking::NetworkOperators;
+
+    // Leave the event thread before querying the tethering manager
+    co_await winrt::resume_background();
+
+    std::vector<ClientInfo> clients;
+    try {
+        auto profile = NetworkInformation::GetInternetConnectionProfile();
+        if (!profile) {
+            co_return;
+        }
+        auto tethering = NetworkOperatorTetheringManager::CreateFromConnectionProfile(profile);
+        if (!tethering) {
+            co_return;
+        }
+        for (const auto& client : tethering.GetTetheringClients()) {
+            ClientInfo info;
+            info.mac_address = winrt::to_string(client.MacAddress());
+            for (const auto& host : client.HostNames()) {
+                if (host.Type() == HostNameType::Ipv4) {
+                    info.ip_address = winrt::to_string(host.CanonicalName());
+                } else if (host.Type() == HostNameType::DomainName) {
+                    info.device_name = winrt::to_string(host.DisplayName());
+                }
+            }
+            clients.push_back(std::move(info));
+        }
+    } catch (...) {
+        co_return;
+    }
+
+    std::lock_guard<std::mutex> lock(target->mutex);
+    if (target->manager) {
+        target->manager->OnClientListChanged(clients);
+    }
+}
+#endif
+
+} // namespace
+
 class MobileHotspotManager::Impl {
 public:
     mutable std::mutex mutex_;
@@ -16,16 +102,131 @@ public:
     OperationMode mode_ = OperationMode::MobileHotspot;
     HotspotConfiguration config_;
     bool has_config_ = false;
-    std::vector<ClientInfo> clients_;
-    
-    // In real implementation, platform APIs would be injected here
-    // For TDD: minimal implementation without actual platform integration
+    // In connection order; keyed by normalized MAC address
+    std::vector<TrackedClient> clients_;
+    ClientEventCallback on_joined_;
+    ClientEventCallback on_left_;
+
+#if defined(WINRT_BASE_H)
+    std::shared_ptr<ClientRefreshTarget> refresh_target_;
+    winrt::event_token status_token_{};
+#endif
+
+    // Callers hold mutex_
+    void AddClient(const ClientInfo& client, ClientEvents& events) {
+        const std::string mac = NormalizeMac(client.mac_address);
+        const auto it = std::find_if(clients_.begin(), clients_.end(),
+            [&mac](const TrackedClient& tracked) { return tracked.info.mac_address == mac; });
+        if (it != clients_.end()) {
+            // Already known; keep the id, refresh what the platform knows
+            it->info.ip_address = client.ip_address;
+            it->info.device_name = client.device_name;
+            return;
+        }
+        for (uint8_t node_id = FIRST_CLIENT_NODE_ID; node_id <= MAX_NODE_ID; ++node_id) {
+            const bool taken = std::any_of(clients_.begin(), clients_.end(),
+                [node_id](const TrackedClient& tracked) { return tracked.node_id == node_id; });
+            if (!taken) {
+                TrackedClient tracked{node_id, client};
+                tracked.info.mac_address = mac;
+                clients_.push_back(tracked);
+                events.joined.push_back(std::move(tracked));
+                return;
+            }
+        }
+        // Network full; the client gets no node until one leaves
+    }
+
+    void RemoveClient(const std::string& mac_address, ClientEvents& events) {
+        const std::string mac = NormalizeMac(mac_address);
+        const auto it = std::find_if(clients_.begin(), clients_.end(),
+            [&mac](const TrackedClient& tracked) { return tracked.info.mac_address == mac; });
+        if (it != clients_.end()) {
+            events.left.push_back(std::move(*it));
+            clients_.erase(it);
+        }
+    }
+
+    void RemoveAllClients(ClientEvents& events) {
+        for (auto& tracked : clients_) {
+            events.left.push_back(std::move(tracked));
+        }
+        clients_.clear();
+    }
+
+    // Leaves before joins, so a freed node id is never reported twice at once
+    void Dispatch(const ClientEvents& events) {
+        if (events.joined.empty() && events.left.empty()) {
+            return;
+        }
+        ClientEventCallback on_joined;
+        ClientEventCallback on_left;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            on_joined = on_joined_;
+            on_left = on_left_;
+        }
+        for (const auto& tracked : events.left) {
+            if (on_left) {
+                on_left(tracked.node_id, tracked.info);
+            }
+        }
+        for (const auto& tracked : events.joined) {
+            if (on_joined) {
+                on_joined(tracked.node_id, tracked.info);
+            }
+        }
+    }
+
+    // Tethering has no per-client events, so every network status change
+    // triggers an asynchronous refresh of the client list
+    void SubscribeClientEvents(MobileHotspotManager* manager) {
+#if defined(WINRT_BASE_H)
+        if (refresh_target_) {
+            return;
+        }
+        refresh_target_ = std::make_shared<ClientRefreshTarget>();
+        refresh_target_->manager = manager;
+        try {
+            using winrt::Windows::Networking::Connectivity::NetworkInformation;
+            status_token_ = NetworkInformation::NetworkStatusChanged(
+                [target = refresh_target_](const auto&) { RefreshTetheringClients(target); });
+        } catch (...) {
+            // Clients then only change through OnClientConnected/Disconnected
+        }
+        RefreshTetheringClients(refresh_target_);
+#else
+        (void)manager;
+#endif
+    }
+
+    // Must not be called with mutex_ held: a refresh in flight holds the
+    // target's lock while it takes mutex_
+    void UnsubscribeClientEvents() {
+#if defined(WINRT_BASE_H)
+        if (!refresh_target_) {
+            return;
+        }
+        try {
+            using winrt::Windows::Networking::Connectivity::NetworkInformation;
+            NetworkInformation::NetworkStatusChanged(status_token_);
+        } catch (...) {
+        }
+        {
+            std::lock_guard<std::mutex> lock(refresh_target_->mutex);
+            refresh_target_->manager = nullptr;
+        }
+        refresh_target_.reset();
+#endif
+    }
 };
 
 MobileHotspotManager::MobileHotspotManager() : impl_(std::make_unique<Impl>()) {
 }
 
-MobileHotspotManager::~MobileHotspotManager() = default;
+MobileHotspotManager::~MobileHotspotManager() {
+    impl_->UnsubscribeClientEvents();
+}
 
 Core::Multiplayer::ErrorCode MobileHotspotManager::Initialize() {
     std::lock_guard<std::mutex> lock(impl_->mutex_);
@@ -54,16 +255,22 @@ Core::Multiplayer::ErrorCode MobileHotspotManager::Initialize() {
 }
 
 void MobileHotspotManager::Shutdown() {
-    std::lock_guard<std::mutex> lock(impl_->mutex_);
-    
-    if (impl_->state_ == HotspotState::Active) {
-        // Stop hotspot if running
-        impl_->state_ = HotspotState::Initialized;
+    impl_->UnsubscribeClientEvents();
+
+    ClientEvents events;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex_);
+
+        if (impl_->state_ == HotspotState::Active) {
+            // Stop hotspot if running
+            impl_->state_ = HotspotState::Initialized;
+        }
+
+        impl_->state_ = HotspotState::Uninitialized;
+        impl_->has_config_ = false;
+        impl_->RemoveAllClients(events);
     }
-    
-    impl_->state_ = HotspotState::Uninitialized;
-    impl_->has_config_ = false;
-    impl_->clients_.clear();
+    impl_->Dispatch(events);
 }
 
 HotspotState MobileHotspotManager::GetState() const {
@@ -140,39 +347,48 @@ HotspotConfiguration MobileHotspotManager::GetCurrentConfiguration() const {
 }
 
 Core::Multiplayer::ErrorCode MobileHotspotManager::StartHotspot() {
-    std::lock_guard<std::mutex> lock(impl_->mutex_);
-    
-    if (impl_->state_ == HotspotState::Uninitialized) {
-        return Core::Multiplayer::ErrorCode::NotInitialized;
-    }
-    
-    if (!impl_->has_config_) {
-        return Core::Multiplayer::ErrorCode::ConfigurationMissing;
-    }
-    
-    if (impl_->state_ == HotspotState::Active) {
-        return Core::Multiplayer::ErrorCode::Success; // Already active
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex_);
+
+        if (impl_->state_ == HotspotState::Uninitialized) {
+            return Core::Multiplayer::ErrorCode::NotInitialized;
+        }
+
+        if (!impl_->has_config_) {
+            return Core::Multiplayer::ErrorCode::ConfigurationMissing;
+        }
+
+        if (impl_->state_ == HotspotState::Active) {
+            return Core::Multiplayer::ErrorCode::Success; // Already active
+        }
+
+        // In real implementation: call NetworkOperatorTetheringManager.StartTethering()
+        // For TDD: assume this is mocked in tests
+        impl_->state_ = HotspotState::Active;
     }
-    
-    // In real implementation: call NetworkOperatorTetheringManager.StartTethering()
-    // For TDD: assume this is mocked in tests
-    impl_->state_ = HotspotState::Active;
-    
+
+    impl_->SubscribeClientEvents(this);
     return Core::Multiplayer::ErrorCode::Success;
 }
 
 Core::Multiplayer::ErrorCode MobileHotspotManager::StopHotspot() {
-    std::lock_guard<std::mutex> lock(impl_->mutex_);
-    
-    if (impl_->state_ != HotspotState::Active) {
-        return Core::Multiplayer::ErrorCode::Success; // Already stopped
+    impl_->UnsubscribeClientEvents();
+
+    ClientEvents events;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex_);
+
+        if (impl_->state_ != HotspotState::Active) {
+            return Core::Multiplayer::ErrorCode::Success; // Already stopped
+        }
+
+        // In real implementation: call NetworkOperatorTetheringManager.StopTethering()
+        // For TDD: assume this is mocked in tests
+        impl_->state_ = HotspotState::Initialized;
+        impl_->RemoveAllClients(events);
     }
-    
-    // In real implementation: call NetworkOperatorTetheringManager.StopTethering()
-    // For TDD: assume this is mocked in tests
-    impl_->state_ = HotspotState::Initialized;
-    impl_->clients_.clear();
-    
+    impl_->Dispatch(events);
+
     return Core::Multiplayer::ErrorCode::Success;
 }
 
@@ -182,7 +398,10 @@ HotspotStatus MobileHotspotManager::GetHotspotStatus() const {
     HotspotStatus status;
     status.is_active = (impl_->state_ == HotspotState::Active);
     status.connected_clients = static_cast<int>(impl_->clients_.size());
-    status.client_list = impl_->clients_;
+    status.client_list.reserve(impl_->clients_.size());
+    for (const auto& tracked : impl_->clients_) {
+        status.client_list.push_back(tracked.info);
+    }
     
     if (impl_->has_config_) {
         status.ssid = impl_->config_.ssid;
@@ -192,18 +411,53 @@ HotspotStatus MobileHotspotManager::GetHotspotStatus() const {
 }
 
 void MobileHotspotManager::OnClientConnected(const ClientInfo& client) {
-    std::lock_guard<std::mutex> lock(impl_->mutex_);
-    impl_->clients_.push_back(client);
+    ClientEvents events;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex_);
+        impl_->AddClient(client, events);
+    }
+    impl_->Dispatch(events);
 }
 
 void MobileHotspotManager::OnClientDisconnected(const std::string& mac_address) {
+    ClientEvents events;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex_);
+        impl_->RemoveClient(mac_address, events);
+    }
+    impl_->Dispatch(events);
+}
+
+void MobileHotspotManager::OnClientListChanged(const std::vector<ClientInfo>& clients) {
+    ClientEvents events;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex_);
+        std::vector<std::string> gone;
+        for (const auto& tracked : impl_->clients_) {
+            const bool present = std::any_of(clients.begin(), clients.end(),
+                [&tracked](const ClientInfo& client) {
+                    return NormalizeMac(client.mac_address) == tracked.info.mac_address;
+                });
+            if (!present) {
+                gone.push_back(tracked.info.mac_address);
+            }
+        }
+        // Leaves first, so their node ids are free for the joins
+        for (const auto& mac : gone) {
+            impl_->RemoveClient(mac, events);
+        }
+        for (const auto& client : clients) {
+            impl_->AddClient(client, events);
+        }
+    }
+    impl_->Dispatch(events);
+}
+
+void MobileHotspotManager::SetClientEventCallbacks(ClientEventCallback on_joined,
+                                                   ClientEventCallback on_left) {
     std::lock_guard<std::mutex> lock(impl_->mutex_);
-    impl_->clients_.erase(
-        std::remove_if(impl_->clients_.begin(), impl_->clients_.end(),
-            [&mac_address](const ClientInfo& client) {
-                return client.mac_address == mac_address;
-            }),
-        impl_->clients_.end());
+    impl_->on_joined_ = std::move(on_joined);
+    impl_->on_left_ = std::move(on_left);
 }
 
 FallbackMode MobileHotspotManager::GetRecommendedFallbackMode() const {
@@ -5,6 +5,8 @@
 
 #include "core/multiplayer/common/error_codes.h"
 #include "windows_types.h"
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -44,8 +46,20 @@ public:
     HotspotStatus GetHotspotStatus() const;
     
     // Client management
+    // Clients are tracked by MAC address; each new one gets the lowest free
+    // LDN node id (1-7, the host is 0) and repeats are ignored
     void OnClientConnected(const ClientInfo& client);
     void OnClientDisconnected(const std::string& mac_address);
+    // Full list from the platform: only the differences become events
+    void OnClientListChanged(const std::vector<ClientInfo>& clients);
+
+    /**
+     * Called as soon as a tracked client joins or leaves, outside the
+     * manager's lock, e.g. to forward node ids to ModelBBackend's
+     * ReportNodeJoined/ReportNodeLeft. Callbacks must not stop the hotspot.
+     */
+    using ClientEventCallback = std::function<void(uint8_t node_id, const ClientInfo& client)>;
+    void SetClientEventCallbacks(ClientEventCallback on_joined, ClientEventCallback on_left);
     
     // Fallback management
     FallbackMode GetRecommendedFallbackMode() const;
@@ -4,6 +4,11 @@
 #include <gtest/gtest.h>
 #include "windows_capability_detector.h"
 
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+
 #ifdef _WIN32
 
 using namespace Core::Multiplayer::ModelB::Windows;
@@ -196,6 +201,15 @@ TEST_F(WindowsCapabilityDetectorTest, IsWiFiDirectSupported_RequiresWindows8AndW
     }
 }
 
+// RIO shipped with Windows 8, which every supported system is past
+TEST_F(WindowsCapabilityDetectorTest, IsRegisteredIoSupported_OnWindows10) {
+    if (WindowsCapabilityDetector::IsWindows10OrLater()) {
+        EXPECT_TRUE(WindowsCapabilityDetector::IsRegisteredIoSupported());
+    }
+    EXPECT_EQ(WindowsCapabilityDetector::IsRegisteredIoSupported(),
+              WindowsCapabilityDetector::IsRegisteredIoSupported());
+}
+
 // Test recommended mode
 TEST_F(WindowsCapabilityDetectorTest, GetRecommendedMode_ReturnsValidMode) {
     auto mode = WindowsCapabilityDetector::GetRecommendedMode();
@@ -243,6 +257,35 @@ TEST_F(WindowsCapabilityDetectorTest, GetDiagnosticReport_ReturnsNonEmptyReport)
     EXPECT_NE(report.find("Recommended Mode:"), std::string::npos);
 }
 
+TEST_F(WindowsCapabilityDetectorTest, BackgroundProbe_PublishesCachedSnapshot) {
+    std::mutex mutex;
+    std::condition_variable published;
+    std::optional<WindowsCapabilityDetector::CapabilitySnapshot> received;
+    const size_t listener = WindowsCapabilityDetector::AddCapabilityListener(
+        [&](const WindowsCapabilityDetector::CapabilitySnapshot& snapshot) {
+            std::lock_guard<std::mutex> lock(mutex);
+            received = snapshot;
+            published.notify_all();
+        });
+
+    WindowsCapabilityDetector::StartBackgroundProbe();
+    // Never blocks, whether or not the probes have finished
+    (void)WindowsCapabilityDetector::GetCachedCapabilities();
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        published.wait_for(lock, std::chrono::seconds(30),
+                           [&] { return received.has_value(); });
+    }
+    WindowsCapabilityDetector::RemoveCapabilityListener(listener);
+
+    auto cached = WindowsCapabilityDetector::GetCachedCapabilities();
+    ASSERT_TRUE(cached.has_value());
+    EXPECT_EQ(cached->version.build_number,
+              WindowsCapabilityDetector::GetWindowsVersion().build_number);
+    EXPECT_EQ(cached->has_wifi_adapter, WindowsCapabilityDetector::HasWiFiAdapter());
+}
+
 #else // Not Windows
 
 TEST(WindowsCapabilityDetectorTest, NotAvailableOnNonWindows) {
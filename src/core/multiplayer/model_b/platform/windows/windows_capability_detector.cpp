@@ -5,10 +5,14 @@
 
 #ifdef _WIN32
 
+#include <filesystem>
+#include <fstream>
 #include <iphlpapi.h>
 #include <mutex>
 #include <shlobj.h>
 #include <sstream>
+#include <system_error>
+#include <utility>
 #include <vector>
 #include <versionhelpers.h>
 #include <windows.h>
@@ -22,6 +26,11 @@
 #include <winrt/base.h>
 #endif
 
+#include <nlohmann/json.hpp>
+
+#include "core/multiplayer/common/registered_io.h"
+#include "core/multiplayer/common/work_stealing_executor.h"
+
 #pragma comment(lib, "iphlpapi.lib")
 #pragma comment(lib, "ws2_32.lib")
 
@@ -58,6 +67,220 @@ PIP_ADAPTER_ADDRESSES GetCachedAdapters() {
   return g_adapter_cache.addresses;
 }
 
+using CapabilitySnapshot = WindowsCapabilityDetector::CapabilitySnapshot;
+using CapabilityListener = WindowsCapabilityDetector::CapabilityListener;
+using json = nlohmann::json;
+
+constexpr int CAPABILITY_CACHE_FORMAT_VERSION = 2;
+
+struct CapabilityCache {
+  std::mutex mutex;
+  std::optional<CapabilitySnapshot> snapshot;
+  std::string path;
+  bool started{false};
+  bool probing{false};
+  bool reprobe{false}; // Invalidated while a probe was running
+  std::vector<std::pair<size_t, CapabilityListener>> listeners;
+  size_t next_listener_id{1};
+};
+
+CapabilityCache g_capability_cache;
+
+bool SameCapabilities(const CapabilitySnapshot& a, const CapabilitySnapshot& b) {
+  return a.version.build_number == b.version.build_number &&
+         a.winrt.winrt_available == b.winrt.winrt_available &&
+         a.winrt.mobile_hotspot_api_available ==
+             b.winrt.mobile_hotspot_api_available &&
+         a.winrt.wifi_direct_available == b.winrt.wifi_direct_available &&
+         a.winrt.loopback_adapter_installed ==
+             b.winrt.loopback_adapter_installed &&
+         a.winrt.elevated_privileges == b.winrt.elevated_privileges &&
+         a.has_wifi_adapter == b.has_wifi_adapter &&
+         a.has_ethernet_adapter == b.has_ethernet_adapter &&
+         a.has_internet_connection == b.has_internet_connection &&
+         a.mobile_hotspot_supported == b.mobile_hotspot_supported &&
+         a.wifi_direct_supported == b.wifi_direct_supported &&
+         a.registered_io_supported == b.registered_io_supported;
+}
+
+// Each probe writes its own fields, so they can all run at once. Wait()
+// runs pool work while waiting, which keeps this safe on a pool thread.
+CapabilitySnapshot ProbeAll() {
+  CapabilitySnapshot snapshot;
+  ExecutorTaskGroup probes{WorkStealingExecutor::GetShared()};
+  probes.Submit([&snapshot] {
+    snapshot.version = WindowsCapabilityDetector::GetWindowsVersion();
+  });
+  probes.Submit([&snapshot] {
+    snapshot.winrt = WindowsCapabilityDetector::DetectWinRTCapabilities();
+  });
+  probes.Submit([&snapshot] {
+    snapshot.has_wifi_adapter = WindowsCapabilityDetector::HasWiFiAdapter();
+  });
+  probes.Submit([&snapshot] {
+    snapshot.has_ethernet_adapter =
+        WindowsCapabilityDetector::HasEthernetAdapter();
+  });
+  probes.Submit([&snapshot] {
+    snapshot.has_internet_connection =
+        WindowsCapabilityDetector::HasInternetConnection();
+  });
+  probes.Submit([&snapshot] {
+    snapshot.mobile_hotspot_supported =
+        WindowsCapabilityDetector::IsMobileHotspotSupported();
+  });
+  probes.Submit([&snapshot] {
+    snapshot.wifi_direct_supported =
+        WindowsCapabilityDetector::IsWiFiDirectSupported();
+  });
+  probes.Submit([&snapshot] {
+    snapshot.registered_io_supported =
+        WindowsCapabilityDetector::IsRegisteredIoSupported();
+  });
+  probes.Wait();
+  return snapshot;
+}
+
+// Only a snapshot taken on the running OS build is returned
+std::optional<CapabilitySnapshot> LoadSnapshot(const std::string& path,
+                                               uint32_t build_number) {
+  std::ifstream file(path);
+  if (!file) {
+    return std::nullopt;
+  }
+  try {
+    const json document = json::parse(file);
+    if (document.value("version", 0) != CAPABILITY_CACHE_FORMAT_VERSION ||
+        document.at("build_number").get<uint32_t>() != build_number) {
+      return std::nullopt;
+    }
+    CapabilitySnapshot snapshot;
+    snapshot.version.build_number = build_number;
+    const auto& winrt = document.at("winrt");
+    snapshot.winrt.winrt_available = winrt.at("available").get<bool>();
+    snapshot.winrt.mobile_hotspot_api_available =
+        winrt.at("mobile_hotspot_api").get<bool>();
+    snapshot.winrt.wifi_direct_available = winrt.at("wifi_direct").get<bool>();
+    snapshot.winrt.loopback_adapter_installed =
+        winrt.at("loopback_adapter").get<bool>();
+    snapshot.winrt.elevated_privileges = winrt.at("elevated").get<bool>();
+    snapshot.has_wifi_adapter = document.at("wifi_adapter").get<bool>();
+    snapshot.has_ethernet_adapter = document.at("ethernet_adapter").get<bool>();
+    snapshot.has_internet_connection =
+        document.at("internet_connection").get<bool>();
+    snapshot.mobile_hotspot_supported =
+        document.at("mobile_hotspot").get<bool>();
+    snapshot.wifi_direct_supported = document.at("wifi_direct").get<bool>();
+    snapshot.registered_io_supported =
+        document.at("registered_io").get<bool>();
+    snapshot.from_disk = true;
+    return snapshot;
+  } catch (const json::exception&) {
+    return std::nullopt;
+  }
+}
+
+void SaveSnapshot(const std::string& path, const CapabilitySnapshot& snapshot) {
+  const json document = {
+      {"version", CAPABILITY_CACHE_FORMAT_VERSION},
+      {"build_number", snapshot.version.build_number},
+      {"winrt",
+       {{"available", snapshot.winrt.winrt_available},
+        {"mobile_hotspot_api", snapshot.winrt.mobile_hotspot_api_available},
+        {"wifi_direct", snapshot.winrt.wifi_direct_available},
+        {"loopback_adapter", snapshot.winrt.loopback_adapter_installed},
+        {"elevated", snapshot.winrt.elevated_privileges}}},
+      {"wifi_adapter", snapshot.has_wifi_adapter},
+      {"ethernet_adapter", snapshot.has_ethernet_adapter},
+      {"internet_connection", snapshot.has_internet_connection},
+      {"mobile_hotspot", snapshot.mobile_hotspot_supported},
+      {"wifi_direct", snapshot.wifi_direct_supported},
+      {"registered_io", snapshot.registered_io_supported},
+  };
+
+  // Write beside the target and rename, so a crash never leaves half a file
+  const std::string temp_path = path + ".tmp";
+  {
+    std::ofstream file(temp_path, std::ios::trunc);
+    if (!file) {
+      return;
+    }
+    file << document.dump(2);
+    if (!file) {
+      return;
+    }
+  }
+  std::error_code ec;
+  std::filesystem::rename(temp_path, path, ec);
+}
+
+void PublishSnapshot(const CapabilitySnapshot& snapshot) {
+  std::vector<CapabilityListener> listeners;
+  {
+    std::lock_guard<std::mutex> lock(g_capability_cache.mutex);
+    const bool changed = !g_capability_cache.snapshot ||
+                         !SameCapabilities(*g_capability_cache.snapshot,
+                                           snapshot);
+    g_capability_cache.snapshot = snapshot;
+    if (!changed) {
+      return;
+    }
+    for (const auto& [id, listener] : g_capability_cache.listeners) {
+      listeners.push_back(listener);
+    }
+  }
+  for (const auto& listener : listeners) {
+    listener(snapshot);
+  }
+}
+
+void RunProbes(bool load_from_disk) {
+  std::string path;
+  {
+    std::lock_guard<std::mutex> lock(g_capability_cache.mutex);
+    path = g_capability_cache.path;
+  }
+  if (load_from_disk && !path.empty()) {
+    const auto build_number =
+        WindowsCapabilityDetector::GetWindowsVersion().build_number;
+    if (auto cached = LoadSnapshot(path, build_number)) {
+      PublishSnapshot(*cached);
+    }
+  }
+
+  while (true) {
+    const auto snapshot = ProbeAll();
+    PublishSnapshot(snapshot);
+    if (!path.empty()) {
+      SaveSnapshot(path, snapshot);
+    }
+
+    std::lock_guard<std::mutex> lock(g_capability_cache.mutex);
+    if (!g_capability_cache.reprobe) {
+      g_capability_cache.probing = false;
+      return;
+    }
+    g_capability_cache.reprobe = false;
+  }
+}
+
+// Starts a probe unless one is running, in which case that one goes again
+void RequestProbe(bool load_from_disk) {
+  {
+    std::lock_guard<std::mutex> lock(g_capability_cache.mutex);
+    if (g_capability_cache.probing) {
+      g_capability_cache.reprobe = true;
+      return;
+    }
+    g_capability_cache.probing = true;
+  }
+  if (!WorkStealingExecutor::GetShared()->Post(
+          SmallTask([load_from_disk] { RunProbes(load_from_disk); }))) {
+    std::lock_guard<std::mutex> lock(g_capability_cache.mutex);
+    g_capability_cache.probing = false;
+  }
+}
+
 } // namespace
 
 WindowsCapabilityDetector::WindowsVersionInfo
@@ -232,11 +455,23 @@ bool WindowsCapabilityDetector::HasEthernetAdapter() {
 }
 
 void WindowsCapabilityDetector::InvalidateNetworkAdapterCache() {
-  std::lock_guard<std::mutex> lock(g_adapter_cache.mutex);
-  g_adapter_cache.buffer.clear();
-  g_adapter_cache.buffer.shrink_to_fit();
-  g_adapter_cache.addresses = nullptr;
-  g_adapter_cache.initialized = false;
+  {
+    std::lock_guard<std::mutex> lock(g_adapter_cache.mutex);
+    g_adapter_cache.buffer.clear();
+    g_adapter_cache.buffer.shrink_to_fit();
+    g_adapter_cache.addresses = nullptr;
+    g_adapter_cache.initialized = false;
+  }
+
+  // Adapter changes can flip most probes, so refresh the cached snapshot
+  bool started = false;
+  {
+    std::lock_guard<std::mutex> lock(g_capability_cache.mutex);
+    started = g_capability_cache.started;
+  }
+  if (started) {
+    RequestProbe(false);
+  }
 }
 
 bool WindowsCapabilityDetector::HasInternetConnection() {
@@ -401,6 +636,10 @@ bool WindowsCapabilityDetector::IsWiFiDirectSupported() {
   return IsWindows8OrGreater() && HasWiFiAdapter();
 }
 
+bool WindowsCapabilityDetector::IsRegisteredIoSupported() {
+  return Core::Multiplayer::RegisteredIoQueue::IsSupported();
+}
+
 bool WindowsCapabilityDetector::IsWiFiDirectEnabled() {
   // This would require checking WlanHostedNetwork status or WiFi Direct API
   // For now, just check if the service is running
@@ -513,7 +752,10 @@ std::string WindowsCapabilityDetector::GetDiagnosticReport() {
   report << "  Mobile Hotspot Active: "
          << (IsMobileHotspotEnabled() ? "Yes" : "No") << "\n";
   report << "  WiFi Direct: "
-         << (IsWiFiDirectSupported() ? "Supported" : "Not Supported") << "\n\n";
+         << (IsWiFiDirectSupported() ? "Supported" : "Not Supported") << "\n";
+  report << "  Registered I/O: "
+         << (IsRegisteredIoSupported() ? "Supported" : "Not Supported")
+         << "\n\n";
 
   // Recommendation
   auto mode = GetRecommendedMode();
@@ -522,6 +764,39 @@ std::string WindowsCapabilityDetector::GetDiagnosticReport() {
   return report.str();
 }
 
+void WindowsCapabilityDetector::StartBackgroundProbe(
+    const std::string& cache_path) {
+  {
+    std::lock_guard<std::mutex> lock(g_capability_cache.mutex);
+    if (g_capability_cache.started) {
+      return;
+    }
+    g_capability_cache.started = true;
+    g_capability_cache.path = cache_path;
+  }
+  RequestProbe(true);
+}
+
+std::optional<WindowsCapabilityDetector::CapabilitySnapshot>
+WindowsCapabilityDetector::GetCachedCapabilities() {
+  std::lock_guard<std::mutex> lock(g_capability_cache.mutex);
+  return g_capability_cache.snapshot;
+}
+
+size_t
+WindowsCapabilityDetector::AddCapabilityListener(CapabilityListener listener) {
+  std::lock_guard<std::mutex> lock(g_capability_cache.mutex);
+  const size_t id = g_capability_cache.next_listener_id++;
+  g_capability_cache.listeners.emplace_back(id, std::move(listener));
+  return id;
+}
+
+void WindowsCapabilityDetector::RemoveCapabilityListener(size_t id) {
+  std::lock_guard<std::mutex> lock(g_capability_cache.mutex);
+  std::erase_if(g_capability_cache.listeners,
+                [id](const auto& entry) { return entry.first == id; });
+}
+
 } // namespace Core::Multiplayer::ModelB::Windows
 
 #endif // _WIN32
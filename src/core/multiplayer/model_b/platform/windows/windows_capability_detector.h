@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <optional>
 #include <string>
 
@@ -52,6 +55,9 @@ public:
   static bool HasInternetConnection();
   static void InvalidateNetworkAdapterCache();
 
+  // Registered I/O sockets (Windows 8 and later), probed once per process
+  static bool IsRegisteredIoSupported();
+
   // Loopback adapter detection and installation
   static bool IsLoopbackAdapterInstalled();
   static std::optional<std::string> GetLoopbackAdapterGuid();
@@ -79,6 +85,34 @@ public:
 
   // Diagnostic information
   static std::string GetDiagnosticReport();
+
+  // Result of every probe, gathered off the caller's thread
+  struct CapabilitySnapshot {
+    WindowsVersionInfo version{};
+    WinRTCapabilities winrt{};
+    bool has_wifi_adapter{false};
+    bool has_ethernet_adapter{false};
+    bool has_internet_connection{false};
+    bool mobile_hotspot_supported{false};
+    bool wifi_direct_supported{false};
+    bool registered_io_supported{false};
+    // Loaded from the cache file for this OS build and not re-probed yet
+    bool from_disk{false};
+  };
+  using CapabilityListener = std::function<void(const CapabilitySnapshot&)>;
+
+  /**
+   * Runs every probe concurrently on the shared executor and caches the
+   * result. When cache_path holds a snapshot taken on the same OS build it
+   * is published first, so callers have an answer before the probes finish.
+   * Later calls are no-ops; InvalidateNetworkAdapterCache re-probes.
+   */
+  static void StartBackgroundProbe(const std::string& cache_path = {});
+  // Never blocks; empty until the first snapshot is published
+  static std::optional<CapabilitySnapshot> GetCachedCapabilities();
+  // Called on the probing thread whenever the published snapshot changes
+  static size_t AddCapabilityListener(CapabilityListener listener);
+  static void RemoveCapabilityListener(size_t id);
 };
 
 } // namespace Core::Multiplayer::ModelB::Windows
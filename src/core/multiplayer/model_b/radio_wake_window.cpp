@@ -0,0 +1,144 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "radio_wake_window.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "../common/monotonic_clock.h"
+
+namespace Core::Multiplayer::ModelB {
+
+RadioWakeWindow::RadioWakeWindow(RadioWakeWindowConfig config,
+                                 std::shared_ptr<TimerWheel> timer_wheel)
+    : config_(config),
+      timer_wheel_(timer_wheel ? std::move(timer_wheel) : TimerWheel::GetShared()) {}
+
+RadioWakeWindow::~RadioWakeWindow() {
+    TimerWheel::TimerId timer;
+    TimerWheel::TimerId early_timer;
+    {
+        std::lock_guard lock(mutex_);
+        enabled_ = false;
+        pending_.clear();
+        has_pending_.store(false, std::memory_order_relaxed);
+        timer = std::exchange(timer_, TimerWheel::INVALID_TIMER_ID);
+        early_timer = std::exchange(early_timer_, TimerWheel::INVALID_TIMER_ID);
+    }
+    timer_wheel_->Cancel(timer);
+    timer_wheel_->Cancel(early_timer);
+    // A window whose timer id was replaced may still be running its tasks
+    std::lock_guard run_lock(run_mutex_);
+}
+
+void RadioWakeWindow::SetEnabled(bool enabled) {
+    {
+        std::lock_guard lock(mutex_);
+        enabled_ = enabled;
+    }
+    if (!enabled) {
+        Flush();
+    }
+}
+
+bool RadioWakeWindow::IsEnabled() const {
+    std::lock_guard lock(mutex_);
+    return enabled_;
+}
+
+void RadioWakeWindow::Defer(TaskKey key, Task task) {
+    {
+        std::lock_guard lock(mutex_);
+        if (enabled_) {
+            ++statistics_.deferred;
+            const auto it = std::find_if(pending_.begin(), pending_.end(),
+                                         [key](const PendingTask& pending) {
+                                             return pending.key == key;
+                                         });
+            if (it != pending_.end()) {
+                it->task = std::move(task);
+                ++statistics_.coalesced;
+            } else {
+                pending_.push_back({key, std::move(task)});
+            }
+            has_pending_.store(true, std::memory_order_relaxed);
+            if (!timer_armed_) {
+                timer_armed_ = true;
+                timer_ = timer_wheel_->Schedule(DelayToNextWindow(MonotonicClock::Now()),
+                                                [this]() { OnTimer(false); });
+            }
+            return;
+        }
+    }
+    task();
+}
+
+void RadioWakeWindow::OpenEarly() {
+    std::lock_guard lock(mutex_);
+    if (!enabled_ || pending_.empty() || early_timer_armed_) {
+        return;
+    }
+    early_timer_armed_ = true;
+    early_timer_ = timer_wheel_->Schedule(std::chrono::milliseconds{0},
+                                          [this]() { OnTimer(true); });
+}
+
+void RadioWakeWindow::OnTimer(bool early) {
+    // run_mutex_ first, so a task may Defer again without inverting the order
+    std::lock_guard run_lock(run_mutex_);
+    std::unique_lock lock(mutex_);
+    (early ? early_timer_armed_ : timer_armed_) = false;
+    if (pending_.empty()) {
+        // The other timer already ran this window
+        return;
+    }
+    ++statistics_.windows;
+    if (early) {
+        ++statistics_.piggybacked;
+    }
+    RunPending(lock);
+}
+
+void RadioWakeWindow::Flush() {
+    std::lock_guard run_lock(run_mutex_);
+    std::unique_lock lock(mutex_);
+    RunPending(lock);
+}
+
+void RadioWakeWindow::RunPending(std::unique_lock<std::mutex>& lock) {
+    std::vector<PendingTask> tasks = std::exchange(pending_, {});
+    has_pending_.store(false, std::memory_order_relaxed);
+    statistics_.tasks_run += tasks.size();
+    lock.unlock();
+    for (const auto& pending : tasks) {
+        pending.task();
+    }
+}
+
+void RadioWakeWindow::Clear() {
+    {
+        std::lock_guard lock(mutex_);
+        pending_.clear();
+        has_pending_.store(false, std::memory_order_relaxed);
+    }
+    std::lock_guard run_lock(run_mutex_);
+}
+
+std::chrono::milliseconds RadioWakeWindow::DelayToNextWindow(uint64_t now_ns) const {
+    constexpr uint64_t NANOSECONDS_PER_MILLISECOND = 1'000'000;
+    const uint64_t interval_ns =
+        std::max<uint64_t>(static_cast<uint64_t>(config_.interval.count()), 1) *
+        NANOSECONDS_PER_MILLISECOND;
+    const uint64_t delay_ns = interval_ns - now_ns % interval_ns;
+    const uint64_t delay_ms =
+        (delay_ns + NANOSECONDS_PER_MILLISECOND - 1) / NANOSECONDS_PER_MILLISECOND;
+    return std::chrono::milliseconds{std::max<uint64_t>(delay_ms, 1)};
+}
+
+RadioWakeWindowStatistics RadioWakeWindow::GetStatistics() const {
+    std::lock_guard lock(mutex_);
+    return statistics_;
+}
+
+} // namespace Core::Multiplayer::ModelB
@@ -0,0 +1,121 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "../common/timer_wheel.h"
+
+namespace Core::Multiplayer::ModelB {
+
+enum class RadioPowerMode : uint8_t {
+    Performance, // Every send goes out at once
+    PowerSave,   // Non-realtime sends wait for a shared wake window
+};
+
+struct RadioWakeWindowConfig {
+    // Deferred sends wait at most this long; windows fall on multiples of it
+    // of the monotonic clock, so every deferring component shares them
+    std::chrono::milliseconds interval{1000};
+};
+
+struct RadioWakeWindowStatistics {
+    uint64_t deferred = 0;    // Defer() calls while enabled
+    uint64_t coalesced = 0;   // Pending tasks replaced by a newer one under their key
+    uint64_t windows = 0;     // Windows that ran at least one task
+    uint64_t piggybacked = 0; // Of those, windows opened early by realtime traffic
+    uint64_t tasks_run = 0;
+};
+
+/**
+ * Groups non-realtime sends into shared wake windows, for handhelds on
+ * Wi-Fi Direct or a hotspot.
+ *
+ * A radio in power save sleeps between transmissions and pays a latency
+ * spike on every wake, so advertise updates, re-announcements and queries
+ * sprinkled between frames keep it awake for little. Deferred sends wait
+ * for the next window boundary and go out together; when a realtime packet
+ * wakes the radio first, the window opens right then instead, since the
+ * radio is awake anyway. Realtime packets themselves are never deferred.
+ *
+ * While disabled, Defer() runs the task on the calling thread. Tasks run
+ * on the timer wheel thread otherwise, and must not block for long.
+ */
+class RadioWakeWindow {
+public:
+    using Task = std::function<void()>;
+    // Identifies a kind of send; a newer task replaces a pending one
+    using TaskKey = uint32_t;
+
+    explicit RadioWakeWindow(RadioWakeWindowConfig config = {},
+                             std::shared_ptr<TimerWheel> timer_wheel = nullptr);
+    ~RadioWakeWindow();
+
+    RadioWakeWindow(const RadioWakeWindow&) = delete;
+    RadioWakeWindow& operator=(const RadioWakeWindow&) = delete;
+
+    // Disabling runs what is pending at once
+    void SetEnabled(bool enabled);
+    bool IsEnabled() const;
+
+    void Defer(TaskKey key, Task task);
+
+    /**
+     * Data path: a realtime packet went out or came in. Opens the window
+     * early if anything is pending; otherwise one relaxed load.
+     */
+    void NotifyRadioAwake() {
+        if (has_pending_.load(std::memory_order_relaxed)) {
+            OpenEarly();
+        }
+    }
+
+    // Runs every pending task now; not from a task
+    void Flush();
+    // Drops pending tasks without running them; not from a task
+    void Clear();
+
+    // Delay from now_ns to the next window boundary, at least one millisecond
+    std::chrono::milliseconds DelayToNextWindow(uint64_t now_ns) const;
+
+    RadioWakeWindowStatistics GetStatistics() const;
+
+private:
+    struct PendingTask {
+        TaskKey key;
+        Task task;
+    };
+
+    void OpenEarly();
+    void OnTimer(bool early);
+    // Runs the pending tasks; called with run_mutex_ and lock held, releases lock
+    void RunPending(std::unique_lock<std::mutex>& lock);
+
+    const RadioWakeWindowConfig config_;
+    std::shared_ptr<TimerWheel> timer_wheel_;
+
+    std::atomic<bool> has_pending_{false};
+
+    mutable std::mutex mutex_;
+    bool enabled_ = false;
+    std::vector<PendingTask> pending_;
+    // The boundary timer, and the one realtime traffic opens the window with;
+    // ids are kept after firing so the destructor can wait a running one out
+    bool timer_armed_ = false;
+    bool early_timer_armed_ = false;
+    TimerWheel::TimerId timer_ = TimerWheel::INVALID_TIMER_ID;
+    TimerWheel::TimerId early_timer_ = TimerWheel::INVALID_TIMER_ID;
+    RadioWakeWindowStatistics statistics_;
+
+    // Held while tasks run, so Clear and the destructor can wait them out
+    std::mutex run_mutex_;
+};
+
+} // namespace Core::Multiplayer::ModelB
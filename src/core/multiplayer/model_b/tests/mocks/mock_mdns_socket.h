@@ -9,6 +9,8 @@
 #include <functional>
 #include <cstdint>
 
+#include "core/multiplayer/model_b/mdns_discovery.h"
+
 namespace Core::Multiplayer::ModelB {
 
 /**
@@ -45,6 +47,7 @@ public:
     MOCK_METHOD(bool, CreateSocket, (int address_family, const std::string& interface_name), ());
     MOCK_METHOD(bool, CloseSocket, (), ());
     MOCK_METHOD(bool, BindToInterface, (const std::string& interface_name), ());
+    MOCK_METHOD(bool, UnbindFromInterface, (const std::string& interface_name), ());
     MOCK_METHOD(bool, SetSocketOptions, (int option, int value), ());
     
     // Multicast group management
@@ -54,8 +57,10 @@ public:
     MOCK_METHOD(bool, SetMulticastTTL, (int ttl), ());
     
     // Service discovery operations
-    MOCK_METHOD(bool, SendQuery, (const std::string& service_type, int query_type, const std::string& interface_name), ());
+    MOCK_METHOD(bool, SendQuery, (const std::string& service_type, int query_type, const MdnsQueryOptions& options, const std::string& interface_name), ());
     MOCK_METHOD(bool, SendResponse, (const std::string& service_name, const std::vector<uint8_t>& response_data, const std::string& interface_name), ());
+    // Unicast to a querier that set the QU bit
+    MOCK_METHOD(bool, SendResponse, (const std::string& service_name, const std::vector<uint8_t>& response_data, const std::string& destination_address, const std::string& interface_name), ());
     
     // Service advertisement operations
     MOCK_METHOD(bool, PublishService, (const std::string& service_type, const std::string& service_name, uint16_t port, const std::string& txt_records), ());
@@ -78,6 +83,7 @@ public:
     
     // Callback registration for asynchronous operations
     MOCK_METHOD(void, SetOnPacketReceivedCallback, (std::function<void(const uint8_t*, size_t, const std::string&, const std::string&)> callback), ());
+    MOCK_METHOD(void, SetOnQueryReceivedCallback, (std::function<void(const std::string&, const MdnsQueryOptions&, const std::string&, const std::string&)> callback), ());
     MOCK_METHOD(void, SetOnServiceDiscoveredCallback, (std::function<void(const std::string&, const std::string&, uint16_t, const std::string&)> callback), ());
     MOCK_METHOD(void, SetOnServiceRemovedCallback, (std::function<void(const std::string&, const std::string&)> callback), ());
     MOCK_METHOD(void, SetOnErrorCallback, (std::function<void(int, const std::string&)> callback), ());
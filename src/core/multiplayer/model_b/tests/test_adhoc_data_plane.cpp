@@ -0,0 +1,268 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "core/multiplayer/common/crc32c.h"
+#include "core/multiplayer/model_b/adhoc_data_plane.h"
+
+using namespace Core::Multiplayer;
+using namespace Core::Multiplayer::ModelB;
+
+namespace {
+
+struct ReceivedFrom {
+    uint8_t node_id;
+    std::vector<uint8_t> data;
+};
+
+// Collects what a data plane's receive thread delivers
+class Inbox {
+public:
+    AdHocDataPlane::ReceiveSink Sink() {
+        return [this](uint8_t node_id, const uint8_t* data, size_t size) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            packets_.push_back({node_id, std::vector<uint8_t>(data, data + size)});
+            arrived_.notify_all();
+        };
+    }
+
+    std::vector<ReceivedFrom> WaitFor(size_t count) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        arrived_.wait_for(lock, std::chrono::seconds(2), [&] { return packets_.size() >= count; });
+        return packets_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable arrived_;
+    std::vector<ReceivedFrom> packets_;
+};
+
+AdHocDataPlaneConfig LoopbackConfig() {
+    AdHocDataPlaneConfig config;
+    config.bind_address = "127.0.0.1";
+    config.port = 0;
+    config.use_multicast = false;
+    return config;
+}
+
+class AdHocDataPlaneTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        for (uint8_t node = 0; node < 3; ++node) {
+            planes[node] = std::make_unique<AdHocDataPlane>(LoopbackConfig());
+            ASSERT_EQ(planes[node]->Open(node), ErrorCode::Success);
+        }
+        ASSERT_EQ(planes[1]->Start(inboxes[1].Sink()), ErrorCode::Success);
+        ASSERT_EQ(planes[2]->Start(inboxes[2].Sink()), ErrorCode::Success);
+    }
+
+    std::unique_ptr<AdHocDataPlane> planes[3];
+    Inbox inboxes[3];
+    const std::vector<uint8_t> payload{1, 2, 3, 4, 5};
+};
+
+TEST_F(AdHocDataPlaneTest, NodeAddressedPacketGoesToThatNodeOnly) {
+    planes[0]->SetNodeEndpoint(1, planes[1]->GetLocalEndpoint());
+    planes[0]->SetNodeEndpoint(2, planes[2]->GetLocalEndpoint());
+
+    ASSERT_EQ(planes[0]->Send(1, payload.data(), payload.size()), ErrorCode::Success);
+    ASSERT_EQ(planes[0]->Flush(), ErrorCode::Success);
+
+    const auto received = inboxes[1].WaitFor(1);
+    ASSERT_EQ(received.size(), 1u);
+    EXPECT_EQ(received[0].node_id, 0);
+    EXPECT_EQ(received[0].data, payload);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_TRUE(inboxes[2].WaitFor(0).empty());
+}
+
+TEST_F(AdHocDataPlaneTest, ControlPacketsGoToTheControlSinkOnly) {
+    planes[1]->Stop();
+    Inbox control;
+    ASSERT_EQ(planes[1]->Start(inboxes[1].Sink(), control.Sink()), ErrorCode::Success);
+    planes[0]->SetNodeEndpoint(1, planes[1]->GetLocalEndpoint());
+    planes[0]->SetNodeEndpoint(2, planes[2]->GetLocalEndpoint());
+
+    ASSERT_EQ(planes[0]->SendControl(1, payload.data(), 2), ErrorCode::Success);
+    ASSERT_EQ(planes[0]->SendControl(2, payload.data(), 2), ErrorCode::Success);
+    ASSERT_EQ(planes[0]->Send(1, payload.data(), payload.size()), ErrorCode::Success);
+    ASSERT_EQ(planes[0]->Flush(), ErrorCode::Success);
+
+    const auto received = control.WaitFor(1);
+    ASSERT_EQ(received.size(), 1u);
+    EXPECT_EQ(received[0].data, std::vector<uint8_t>(payload.begin(), payload.begin() + 2));
+    ASSERT_EQ(inboxes[1].WaitFor(1).size(), 1u);
+    EXPECT_EQ(inboxes[1].WaitFor(1)[0].data, payload);
+    // Without a control sink they are dropped, not taken for data
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_TRUE(inboxes[2].WaitFor(0).empty());
+}
+
+TEST_F(AdHocDataPlaneTest, BroadcastWithoutMulticastSendsOneCopyPerNodeInOneFlush) {
+    planes[0]->SetNodeEndpoint(1, planes[1]->GetLocalEndpoint());
+    planes[0]->SetNodeEndpoint(2, planes[2]->GetLocalEndpoint());
+    EXPECT_FALSE(planes[0]->IsMulticastActive());
+
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_EQ(planes[0]->Send(AdHocDataPlane::BROADCAST_NODE_ID, payload.data(),
+                                  payload.size()),
+                  ErrorCode::Success);
+    }
+    ASSERT_EQ(planes[0]->Flush(), ErrorCode::Success);
+
+    EXPECT_EQ(inboxes[1].WaitFor(3).size(), 3u);
+    EXPECT_EQ(inboxes[2].WaitFor(3).size(), 3u);
+    const auto statistics = planes[0]->GetStatistics();
+    EXPECT_EQ(statistics.unicast_datagrams_sent, 6u);
+    EXPECT_EQ(statistics.group_datagrams_sent, 0u);
+    EXPECT_EQ(statistics.send_batches, 1u);
+}
+
+TEST_F(AdHocDataPlaneTest, LatestValueOverwritesTheStagedPacket) {
+    planes[0]->SetNodeEndpoint(1, planes[1]->GetLocalEndpoint());
+    planes[0]->SetNodeEndpoint(2, planes[2]->GetLocalEndpoint());
+
+    const std::vector<uint8_t> newer{9, 8};
+    ASSERT_EQ(planes[0]->SendLatest(AdHocDataPlane::BROADCAST_NODE_ID, payload.data(),
+                                    payload.size(), 1),
+              ErrorCode::Success);
+    // Same key, other destination: its own packet
+    ASSERT_EQ(planes[0]->SendLatest(1, payload.data(), payload.size(), 1), ErrorCode::Success);
+    ASSERT_EQ(planes[0]->SendLatest(AdHocDataPlane::BROADCAST_NODE_ID, newer.data(),
+                                    newer.size(), 1),
+              ErrorCode::Success);
+    ASSERT_EQ(planes[0]->Flush(), ErrorCode::Success);
+
+    const auto to_node_1 = inboxes[1].WaitFor(2);
+    ASSERT_EQ(to_node_1.size(), 2u);
+    EXPECT_EQ(to_node_1[0].data, newer);
+    EXPECT_EQ(to_node_1[1].data, payload);
+    const auto to_node_2 = inboxes[2].WaitFor(1);
+    ASSERT_EQ(to_node_2.size(), 1u);
+    EXPECT_EQ(to_node_2[0].data, newer);
+    const auto statistics = planes[0]->GetStatistics();
+    EXPECT_EQ(statistics.replaced, 1u);
+    EXPECT_EQ(statistics.unicast_datagrams_sent, 3u);
+
+    // Flushed packets are never replaced
+    ASSERT_EQ(planes[0]->SendLatest(2, newer.data(), newer.size(), 1), ErrorCode::Success);
+    ASSERT_EQ(planes[0]->Flush(), ErrorCode::Success);
+    EXPECT_EQ(inboxes[2].WaitFor(2).size(), 2u);
+    EXPECT_EQ(planes[0]->GetStatistics().replaced, 1u);
+}
+
+TEST_F(AdHocDataPlaneTest, RejectsUnknownNodesAndOversizedPackets) {
+    EXPECT_EQ(planes[0]->Send(1, payload.data(), payload.size()), ErrorCode::NotConnected);
+    EXPECT_EQ(planes[0]->Send(9, payload.data(), payload.size()), ErrorCode::InvalidParameter);
+
+    planes[0]->SetNodeEndpoint(1, planes[1]->GetLocalEndpoint());
+    const std::vector<uint8_t> oversized(AdHocDataPlane::MAX_PAYLOAD_SIZE + 1);
+    EXPECT_EQ(planes[0]->Send(1, oversized.data(), oversized.size()),
+              ErrorCode::MessageTooLarge);
+    // A broadcast with nobody to reach is not an error
+    planes[0]->ClearNodes();
+    EXPECT_EQ(planes[0]->Send(AdHocDataPlane::BROADCAST_NODE_ID, payload.data(), payload.size()),
+              ErrorCode::Success);
+}
+
+TEST_F(AdHocDataPlaneTest, DropsPacketsForOtherNodes) {
+    // Node 1's socket, but addressed to node 2
+    planes[0]->SetNodeEndpoint(2, planes[1]->GetLocalEndpoint());
+    ASSERT_EQ(planes[0]->Send(2, payload.data(), payload.size()), ErrorCode::Success);
+    ASSERT_EQ(planes[0]->Flush(), ErrorCode::Success);
+
+    for (int i = 0; i < 100 && planes[1]->GetStatistics().dropped == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(planes[1]->GetStatistics().dropped, 1u);
+    EXPECT_TRUE(inboxes[1].WaitFor(0).empty());
+}
+
+TEST_F(AdHocDataPlaneTest, LearnsTheSendersEndpoint) {
+    planes[0]->SetNodeEndpoint(1, planes[1]->GetLocalEndpoint());
+    ASSERT_EQ(planes[0]->Start(inboxes[0].Sink()), ErrorCode::Success);
+    ASSERT_EQ(planes[0]->Send(1, payload.data(), payload.size()), ErrorCode::Success);
+    ASSERT_EQ(planes[0]->Flush(), ErrorCode::Success);
+    ASSERT_EQ(inboxes[1].WaitFor(1).size(), 1u);
+
+    // Node 1 was never told where node 0 is
+    ASSERT_EQ(planes[1]->Send(0, payload.data(), payload.size()), ErrorCode::Success);
+    ASSERT_EQ(planes[1]->Flush(), ErrorCode::Success);
+    const auto received = inboxes[0].WaitFor(1);
+    ASSERT_EQ(received.size(), 1u);
+    EXPECT_EQ(received[0].node_id, 1);
+}
+
+TEST(AdHocDataPlaneMulticastTest, FallsBackToUnicastWithoutGroupTraffic) {
+    AdHocDataPlaneConfig config;
+    config.bind_address = "0.0.0.0";
+    config.port = 0;
+    config.multicast_timeout = std::chrono::milliseconds(50);
+    AdHocDataPlane plane(config);
+    ASSERT_EQ(plane.Open(0), ErrorCode::Success);
+    if (!plane.IsMulticastActive()) {
+        GTEST_SKIP() << "No multicast-capable interface";
+    }
+
+    DatagramEndpoint peer;
+    ASSERT_TRUE(DatagramEndpoint::FromString("127.0.0.1", 9, peer));
+    plane.SetNodeEndpoint(1, peer);
+    // Peers get one timeout to appear in the group
+    EXPECT_TRUE(plane.IsMulticastActive());
+    std::this_thread::sleep_for(std::chrono::milliseconds(80));
+    EXPECT_FALSE(plane.IsMulticastActive());
+}
+
+TEST(AdHocDataPlaneIntegrityTest, DropsCorruptedDatagrams) {
+    AdHocDataPlaneConfig config = LoopbackConfig();
+    config.integrity_check = true;
+    AdHocDataPlane sender(config);
+    AdHocDataPlane receiver(config);
+    ASSERT_EQ(sender.Open(0), ErrorCode::Success);
+    ASSERT_EQ(receiver.Open(1), ErrorCode::Success);
+    Inbox inbox;
+    ASSERT_EQ(receiver.Start(inbox.Sink()), ErrorCode::Success);
+
+    // The trailer is stripped before delivery
+    const std::vector<uint8_t> payload{1, 2, 3, 4, 5};
+    sender.SetNodeEndpoint(1, receiver.GetLocalEndpoint());
+    ASSERT_EQ(sender.Send(1, payload.data(), payload.size()), ErrorCode::Success);
+    ASSERT_EQ(sender.Flush(), ErrorCode::Success);
+    const auto received = inbox.WaitFor(1);
+    ASSERT_EQ(received.size(), 1u);
+    EXPECT_EQ(received[0].data, payload);
+
+    // A flipped payload bit, then a datagram without a trailer at all
+    std::vector<uint8_t> datagram{0xAD, 0x02, 0, 1, 1, 2, 3, 4, 5};
+    const uint32_t crc = Crc32c(datagram);
+    for (int i = 0; i < 4; ++i) {
+        datagram.push_back(static_cast<uint8_t>(crc >> (8 * i)));
+    }
+    datagram[6] ^= 0x10;
+    const std::vector<uint8_t> unchecked{0xAD, 0x00, 0, 1, 1, 2, 3, 4, 5};
+    DatagramSocket raw;
+    ASSERT_EQ(raw.Open("127.0.0.1", 0), ErrorCode::Success);
+    const DatagramEndpoint to = receiver.GetLocalEndpoint();
+    const OutgoingDatagram outgoing[2]{{datagram.data(), datagram.size(), nullptr, 0, &to},
+                                       {unchecked.data(), unchecked.size(), nullptr, 0, &to}};
+    ASSERT_EQ(raw.SendBatch(outgoing, 2), 2u);
+
+    for (int i = 0; i < 100 && receiver.GetStatistics().integrity_failures < 2; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(receiver.GetStatistics().integrity_failures, 2u);
+    EXPECT_EQ(inbox.WaitFor(0).size(), 1u);
+}
+
+} // namespace
@@ -0,0 +1,161 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+#include "core/multiplayer/model_b/discovered_service_cache.h"
+
+using namespace Core::Multiplayer::ModelB;
+using namespace std::chrono_literals;
+
+namespace {
+
+GameSessionInfo MakeSession(const std::string& host_name, const std::string& host_ip,
+                            std::chrono::system_clock::time_point last_seen) {
+    GameSessionInfo info;
+    info.game_id = "test_game";
+    info.host_name = host_name;
+    info.host_ip = host_ip;
+    info.last_seen = last_seen;
+    return info;
+}
+
+} // anonymous namespace
+
+TEST(DiscoveredServiceCacheTest, UnchangedAnnouncementOnlyRefreshes) {
+    DiscoveredServiceCache cache;
+    const auto now = std::chrono::system_clock::now();
+    const auto hash = DiscoveredServiceCache::HashTxtPayload("game_id=a&players=1");
+
+    EXPECT_FALSE(cache.RefreshIfUnchanged("10.0.0.1", hash, now));
+    EXPECT_EQ(cache.Upsert(MakeSession("host", "10.0.0.1", now), hash),
+              DiscoveredServiceCache::UpdateResult::Added);
+    const uint64_t epoch = cache.GetEpoch();
+
+    EXPECT_TRUE(cache.RefreshIfUnchanged("10.0.0.1", hash, now + 1s));
+    EXPECT_EQ(cache.GetEpoch(), epoch);
+    EXPECT_EQ(cache.Find("host")->last_seen, now + 1s);
+
+    const auto changed = DiscoveredServiceCache::HashTxtPayload("game_id=a&players=2");
+    EXPECT_FALSE(cache.RefreshIfUnchanged("10.0.0.1", changed, now + 2s));
+}
+
+TEST(DiscoveredServiceCacheTest, ExpiresOldestFirst) {
+    DiscoveredServiceCache cache;
+    const auto now = std::chrono::system_clock::now();
+
+    cache.Upsert(MakeSession("old", "10.0.0.1", now - 10s), 1);
+    cache.Upsert(MakeSession("new", "10.0.0.2", now), 2);
+    cache.Upsert(MakeSession("refreshed", "10.0.0.3", now - 20s), 3);
+    cache.RefreshIfUnchanged("10.0.0.3", 3, now);
+
+    EXPECT_EQ(cache.GetOldestLastSeen(), now - 10s);
+
+    const auto expired = cache.ExpireBefore(now - 5s);
+    ASSERT_EQ(expired.size(), 1u);
+    EXPECT_EQ(expired[0].host_name, "old");
+    EXPECT_EQ(cache.Size(), 2u);
+    EXPECT_EQ(cache.GetOldestLastSeen(), now);
+}
+
+TEST(DiscoveredServiceCacheTest, FallsBackToAddressKey) {
+    DiscoveredServiceCache cache;
+    const auto now = std::chrono::system_clock::now();
+
+    cache.Upsert(MakeSession("", "10.0.0.1", now), 1);
+    cache.Upsert(MakeSession("", "10.0.0.2", now), 2);
+
+    EXPECT_EQ(cache.Size(), 2u);
+    EXPECT_TRUE(cache.Find("10.0.0.1").has_value());
+}
+
+TEST(DiscoveredServiceCacheTest, ChangesSinceReportsOnlyDiff) {
+    DiscoveredServiceCache cache;
+    const auto now = std::chrono::system_clock::now();
+
+    cache.Upsert(MakeSession("a", "10.0.0.1", now), 1);
+    cache.Upsert(MakeSession("b", "10.0.0.2", now - 1min), 2);
+    const uint64_t epoch = cache.GetEpoch();
+
+    auto initial = cache.GetChangesSince(0);
+    EXPECT_FALSE(initial.full_resync);
+    EXPECT_EQ(initial.upserted.size(), 2u);
+
+    cache.Upsert(MakeSession("c", "10.0.0.3", now), 3);
+    cache.ExpireBefore(now - 30s);
+
+    const auto delta = cache.GetChangesSince(epoch);
+    EXPECT_FALSE(delta.full_resync);
+    EXPECT_EQ(delta.epoch, cache.GetEpoch());
+    ASSERT_EQ(delta.upserted.size(), 1u);
+    EXPECT_EQ(delta.upserted[0].host_name, "c");
+    ASSERT_EQ(delta.removed.size(), 1u);
+    EXPECT_EQ(delta.removed[0], "b");
+
+    EXPECT_TRUE(cache.GetChangesSince(cache.GetEpoch()).upserted.empty());
+}
+
+TEST(DiscoveredServiceCacheTest, StaleEpochForcesFullResync) {
+    DiscoveredServiceCache cache;
+    const auto now = std::chrono::system_clock::now();
+
+    for (size_t i = 0; i <= DiscoveredServiceCache::MAX_REMOVAL_HISTORY; ++i) {
+        cache.Upsert(MakeSession("host" + std::to_string(i), "10.0.0.1", now - 1min), i);
+        cache.ExpireBefore(now);
+    }
+    cache.Upsert(MakeSession("survivor", "10.0.0.2", now), 99);
+
+    const auto delta = cache.GetChangesSince(1);
+    EXPECT_TRUE(delta.full_resync);
+    ASSERT_EQ(delta.upserted.size(), 1u);
+    EXPECT_EQ(delta.upserted[0].host_name, "survivor");
+}
+
+TEST(DiscoveredServiceCacheTest, AddressReannouncingNewHostReplacesOld) {
+    DiscoveredServiceCache cache;
+    const auto now = std::chrono::system_clock::now();
+
+    cache.Upsert(MakeSession("first", "10.0.0.1", now), 1);
+    cache.Upsert(MakeSession("second", "10.0.0.1", now), 2);
+
+    EXPECT_EQ(cache.Size(), 1u);
+    EXPECT_FALSE(cache.Find("first").has_value());
+    EXPECT_TRUE(cache.RefreshIfUnchanged("10.0.0.1", 2, now + 1s));
+}
+
+TEST(DiscoveredServiceCacheTest, DualStackHostIsOneEntry) {
+    DiscoveredServiceCache cache;
+    const auto now = std::chrono::system_clock::now();
+
+    auto v4 = MakeSession("host", "10.0.0.1", now);
+    v4.host_ipv4 = "10.0.0.1";
+    auto v6 = MakeSession("host", "fe80::1", now);
+    v6.host_ipv6 = "fe80::1";
+    v6.ip_version = IPVersion::IPv6;
+
+    cache.Upsert(v4, 1);
+    EXPECT_EQ(cache.Upsert(v6, 1), DiscoveredServiceCache::UpdateResult::Changed);
+
+    // Both addresses kept; the first family to answer is the one to use
+    auto host = cache.Find("host");
+    ASSERT_TRUE(host.has_value());
+    EXPECT_EQ(host->ip_version, IPVersion::Both);
+    EXPECT_EQ(host->host_ip, "10.0.0.1");
+    EXPECT_EQ(host->host_ipv6, "fe80::1");
+    EXPECT_EQ(cache.Size(), 1u);
+
+    // Either family's repeats take the fast path
+    EXPECT_TRUE(cache.RefreshIfUnchanged("10.0.0.1", 1, now + 1s));
+    EXPECT_TRUE(cache.RefreshIfUnchanged("fe80::1", 1, now + 1s));
+
+    // A family preferred for the network wins over answer order
+    cache.Upsert(v4, 2, IPVersion::IPv6);
+    EXPECT_EQ(cache.Find("host")->host_ip, "fe80::1");
+
+    cache.ExpireBefore(now + 1min);
+    EXPECT_FALSE(cache.RefreshIfUnchanged("10.0.0.1", 2, now + 2min));
+    EXPECT_FALSE(cache.RefreshIfUnchanged("fe80::1", 2, now + 2min));
+}
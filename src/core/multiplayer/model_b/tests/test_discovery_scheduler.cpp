@@ -0,0 +1,148 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/multiplayer/model_b/discovery_scheduler.h"
+
+using namespace Core::Multiplayer;
+using namespace Core::Multiplayer::ModelB;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr uint64_t MS = 1'000'000; // Nanoseconds
+
+DiscoverySchedulerConfig TestConfig() {
+    DiscoverySchedulerConfig config;
+    config.searching_interval = 1000ms;
+    config.connected_interval = 4000ms;
+    config.max_connected_interval = 16000ms;
+    config.realtime_quiet_period = 500ms;
+    return config;
+}
+
+class DiscoverySchedulerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Never started, so only Poll() drives it
+        scheduler = std::make_unique<DiscoveryScheduler>(TestConfig(), wheel);
+        scheduler->AddScanner("wifi_direct", [this] { scans.push_back("wifi_direct"); },
+                              [this] { suspends.push_back("wifi_direct"); });
+        scheduler->AddScanner("mdns", [this] { scans.push_back("mdns"); });
+    }
+
+    std::shared_ptr<TimerWheel> wheel = std::make_shared<TimerWheel>(1ms);
+    std::unique_ptr<DiscoveryScheduler> scheduler;
+    std::vector<std::string> scans;
+    std::vector<std::string> suspends;
+};
+
+} // namespace
+
+TEST_F(DiscoverySchedulerTest, SearchingScansTakeTurns) {
+    uint64_t now = 1000 * MS;
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(scheduler->Poll(now), 1000ms);
+        now += 1000 * MS;
+    }
+    EXPECT_EQ(scans, (std::vector<std::string>{"wifi_direct", "mdns", "wifi_direct", "mdns"}));
+    EXPECT_EQ(scheduler->GetStatistics().phase, DiscoveryPhase::Searching);
+}
+
+TEST_F(DiscoverySchedulerTest, ConnectedBacksOffExponentially) {
+    scheduler->SetSessionActive(true);
+    EXPECT_EQ(scheduler->Poll(MS), 4000ms);
+    EXPECT_EQ(scheduler->Poll(2 * MS), 8000ms);
+    EXPECT_EQ(scheduler->Poll(3 * MS), 16000ms);
+    EXPECT_EQ(scheduler->Poll(4 * MS), 16000ms);
+    EXPECT_EQ(scheduler->GetStatistics().phase, DiscoveryPhase::Connected);
+
+    // Leaving the session goes back to searching, and rejoining restarts the backoff
+    scheduler->SetSessionActive(false);
+    EXPECT_EQ(scheduler->Poll(5 * MS), 1000ms);
+    scheduler->SetSessionActive(true);
+    EXPECT_EQ(scheduler->Poll(6 * MS), 4000ms);
+}
+
+TEST_F(DiscoverySchedulerTest, RealtimeTrafficSuspendsScans) {
+    scheduler->SetSessionActive(true);
+    const uint64_t traffic = 10'000 * MS;
+    scheduler->NotifyRealtimeTraffic(traffic);
+
+    // Rechecks when the quiet period after the packet would end
+    EXPECT_EQ(scheduler->Poll(traffic + 100 * MS), 400ms);
+    EXPECT_EQ(scheduler->Poll(traffic + 200 * MS), 300ms);
+    EXPECT_TRUE(scans.empty());
+    // A scan in progress is ended once, not on every poll
+    EXPECT_EQ(suspends, std::vector<std::string>{"wifi_direct"});
+    EXPECT_EQ(scheduler->GetStatistics().suspended_polls, 2u);
+    EXPECT_EQ(scheduler->GetStatistics().phase, DiscoveryPhase::Suspended);
+
+    // Traffic stopped; scans resume
+    EXPECT_EQ(scheduler->Poll(traffic + 600 * MS), 4000ms);
+    EXPECT_EQ(scans.size(), 1u);
+}
+
+TEST_F(DiscoverySchedulerTest, RequestedScanOverridesSuspensionAndBackoff) {
+    scheduler->SetSessionActive(true);
+    scheduler->Poll(MS);
+    scheduler->Poll(2 * MS);
+
+    const uint64_t traffic = 10'000 * MS;
+    scheduler->NotifyRealtimeTraffic(traffic);
+    scheduler->RequestScan();
+    EXPECT_EQ(scheduler->Poll(traffic + MS), 4000ms);
+    EXPECT_EQ(scans.size(), 3u);
+    EXPECT_EQ(scheduler->GetStatistics().requested_scans, 1u);
+
+    // Only the one scan; traffic still suspends the next
+    EXPECT_EQ(scheduler->Poll(traffic + 2 * MS), 498ms);
+    EXPECT_EQ(scans.size(), 3u);
+}
+
+TEST_F(DiscoverySchedulerTest, RemovedScannerNoLongerRuns) {
+    const auto id = scheduler->AddScanner("extra", [this] { scans.push_back("extra"); });
+    scheduler->RemoveScanner(id);
+    for (int i = 0; i < 4; ++i) {
+        scheduler->Poll(MS * (i + 1));
+    }
+    EXPECT_EQ(std::count(scans.begin(), scans.end(), "extra"), 0);
+}
+
+TEST(DiscoverySchedulerWheelTest, RequestScanRunsOnNextTick) {
+    auto wheel = std::make_shared<TimerWheel>(1ms);
+    DiscoverySchedulerConfig config = TestConfig();
+    config.searching_interval = 60000ms;
+    DiscoveryScheduler scheduler(config, wheel);
+    std::atomic<int> scans{0};
+    scheduler.AddScanner("mdns", [&scans] { ++scans; });
+
+    scheduler.Start();
+    const auto wait_for = [&scans](int count) {
+        const auto deadline = std::chrono::steady_clock::now() + 2s;
+        while (scans.load() < count && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(1ms);
+        }
+        return scans.load() >= count;
+    };
+    // The first scan goes out right away, the next not for a minute...
+    ASSERT_TRUE(wait_for(1));
+    std::this_thread::sleep_for(20ms);
+    EXPECT_EQ(scans.load(), 1);
+
+    // ...unless the game asks
+    scheduler.RequestScan();
+    EXPECT_TRUE(wait_for(2));
+
+    scheduler.Stop();
+    EXPECT_FALSE(scheduler.IsRunning());
+    wheel->Shutdown();
+}
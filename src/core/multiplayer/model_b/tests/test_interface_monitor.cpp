@@ -0,0 +1,32 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include "core/multiplayer/model_b/interface_monitor.h"
+
+using namespace Core::Multiplayer;
+using namespace Core::Multiplayer::ModelB;
+
+namespace {
+
+TEST(InterfaceMonitorTest, StartsOnceAndStopsCleanly) {
+    InterfaceMonitor monitor;
+    if (!InterfaceMonitor::IsSupported()) {
+        EXPECT_EQ(monitor.Start([] {}), ErrorCode::NotSupported);
+        GTEST_SKIP() << "No interface change events on this platform";
+    }
+
+    ASSERT_EQ(monitor.Start([] {}), ErrorCode::Success);
+    EXPECT_TRUE(monitor.IsRunning());
+    EXPECT_EQ(monitor.Start([] {}), ErrorCode::InvalidState);
+
+    monitor.Stop();
+    EXPECT_FALSE(monitor.IsRunning());
+    monitor.Stop(); // Idempotent
+
+    // Restartable after a stop
+    ASSERT_EQ(monitor.Start([] {}), ErrorCode::Success);
+}
+
+} // namespace
@@ -195,7 +195,7 @@ TEST_F(MdnsDiscoveryTest, StartDiscoveryBeginsServiceDiscovery) {
     // This test will fail because StartDiscovery() doesn't exist yet
     
     // ARRANGE
-    EXPECT_CALL(*mock_socket_, SendQuery("_sudachi-ldn._tcp.local.", _, _))
+    EXPECT_CALL(*mock_socket_, SendQuery("_sudachi-ldn._tcp.local.", _, _, _))
         .Times(2); // Once per interface
     
     auto discovery = std::make_unique<MdnsDiscovery>(mock_socket_, mock_interface_provider_, mock_config_);
@@ -494,9 +494,9 @@ TEST_F(MdnsDiscoveryTest, MultipleNetworkInterfacesSupported) {
     // ARRANGE
     EXPECT_CALL(*mock_socket_, BindToInterface("eth0")).WillOnce(Return(true));
     EXPECT_CALL(*mock_socket_, BindToInterface("wlan0")).WillOnce(Return(true));
-    EXPECT_CALL(*mock_socket_, SendQuery("_sudachi-ldn._tcp.local.", _, "eth0"))
+    EXPECT_CALL(*mock_socket_, SendQuery("_sudachi-ldn._tcp.local.", _, _, "eth0"))
         .WillOnce(Return(true));
-    EXPECT_CALL(*mock_socket_, SendQuery("_sudachi-ldn._tcp.local.", _, "wlan0"))
+    EXPECT_CALL(*mock_socket_, SendQuery("_sudachi-ldn._tcp.local.", _, _, "wlan0"))
         .WillOnce(Return(true));
     
     auto discovery = std::make_unique<MdnsDiscovery>(mock_socket_, mock_interface_provider_, mock_config_);
@@ -513,6 +513,175 @@ TEST_F(MdnsDiscoveryTest, MultipleNetworkInterfacesSupported) {
     EXPECT_THAT(active_interfaces, Contains("wlan0"));
 }
 
+namespace {
+
+// Lets Initialize() bring the sockets up
+void AcceptSocketSetup(MockMdnsSocket& socket) {
+    ON_CALL(socket, CreateSocket(_, _)).WillByDefault(Return(true));
+    ON_CALL(socket, BindToInterface(_)).WillByDefault(Return(true));
+    ON_CALL(socket, JoinMulticastGroup(_)).WillByDefault(Return(true));
+}
+
+} // anonymous namespace
+
+/**
+ * Test: Interface changes are applied incrementally
+ * Verifies that a new interface is bound and queried at once, and that one
+ * that went away is unbound without touching the others
+ */
+TEST_F(MdnsDiscoveryTest, InterfaceChangesBindAndQueryIncrementally) {
+    const NetworkInterface eth0{"eth0", "192.168.1.100", "fe80::1", true, InterfaceType::Ethernet};
+    const NetworkInterface wlan0{"wlan0", "192.168.49.1", "fe80::2", true, InterfaceType::WiFi};
+    EXPECT_CALL(*mock_interface_provider_, GetActiveInterfaces())
+        .WillOnce(Return(std::vector<NetworkInterface>{eth0}))
+        .WillOnce(Return(std::vector<NetworkInterface>{eth0, wlan0}))
+        .WillOnce(Return(std::vector<NetworkInterface>{wlan0}));
+    AcceptSocketSetup(*mock_socket_);
+    EXPECT_CALL(*mock_socket_, BindToInterface("eth0")).WillOnce(Return(true));
+    EXPECT_CALL(*mock_socket_, BindToInterface("wlan0")).WillOnce(Return(true));
+    EXPECT_CALL(*mock_socket_, UnbindFromInterface("eth0")).WillOnce(Return(true));
+    EXPECT_CALL(*mock_socket_, SendQuery("_sudachi-ldn._tcp.local.", _, _, "eth0"))
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mock_socket_, SendQuery("_sudachi-ldn._tcp.local.", _, _, "wlan0"))
+        .WillOnce(Return(true));
+
+    auto discovery = std::make_unique<MdnsDiscovery>(mock_socket_, mock_interface_provider_, mock_config_);
+    discovery->Initialize();
+    discovery->StartDiscovery();
+
+    // A Wi-Fi Direct group comes up: wlan0 is queried without waiting
+    discovery->OnInterfacesChanged();
+    EXPECT_THAT(discovery->GetActiveInterfaces(), UnorderedElementsAre("eth0", "wlan0"));
+
+    // The cable is pulled
+    discovery->OnInterfacesChanged();
+    EXPECT_THAT(discovery->GetActiveInterfaces(), ElementsAre("wlan0"));
+}
+
+/**
+ * Test: Queries follow RFC 6762
+ * Verifies that the first query asks for unicast responses and that later
+ * ones list the services already known
+ */
+TEST_F(MdnsDiscoveryTest, QueriesAskForUnicastFirstThenListKnownAnswers) {
+    const auto unicast = Field(&MdnsQueryOptions::unicast_response, true);
+    const auto knows_host1 =
+        AllOf(Field(&MdnsQueryOptions::unicast_response, false),
+              Field(&MdnsQueryOptions::known_answers,
+                    ElementsAre(Field(&MdnsKnownAnswer::instance_name, "host1"))));
+    {
+        InSequence sequence;
+        EXPECT_CALL(*mock_socket_, SendQuery(_, _, unicast, _)).Times(2);
+        EXPECT_CALL(*mock_socket_, SendQuery(_, _, knows_host1, _)).Times(2);
+    }
+    AcceptSocketSetup(*mock_socket_);
+
+    auto discovery = std::make_unique<MdnsDiscovery>(mock_socket_, mock_interface_provider_, mock_config_);
+    discovery->Initialize();
+    discovery->StartDiscovery();
+
+    const auto response = CreateTestMdnsResponse(
+        "_sudachi-ldn._tcp.local.", "host1", "192.168.1.100", 7100,
+        "game_id=game1&version=1.0&players=1&max_players=4&has_password=false&host_name=host1");
+    discovery->ProcessIncomingPacket(response.data(), response.size(), "192.168.1.100");
+    discovery->QueryNow();
+}
+
+/**
+ * Test: The query interval doubles
+ * Verifies that periodic queries back off instead of repeating every interval
+ */
+TEST_F(MdnsDiscoveryTest, PeriodicQueriesBackOff) {
+    ON_CALL(*mock_config_, GetAdvertiseInterval())
+        .WillByDefault(Return(std::chrono::milliseconds(20)));
+    AcceptSocketSetup(*mock_socket_);
+    ON_CALL(*mock_config_, GetAllowedInterfaces())
+        .WillByDefault(Return(std::vector<std::string>{"eth0"}));
+    std::atomic<int> rounds{0};
+    ON_CALL(*mock_socket_, SendQuery(_, _, _, _))
+        .WillByDefault(InvokeWithoutArgs([&rounds] { return ++rounds, true; }));
+
+    auto wheel = std::make_shared<TimerWheel>(std::chrono::milliseconds(1));
+    auto discovery = std::make_unique<MdnsDiscovery>(mock_socket_, mock_interface_provider_,
+                                                     mock_config_, wheel);
+    discovery->Initialize();
+    discovery->StartDiscovery();
+
+    // Rounds at 0, 20, 60 and 140ms; a fixed interval would have sent 11
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    discovery->StopDiscovery();
+    EXPECT_GE(rounds.load(), 3);
+    EXPECT_LE(rounds.load(), 5);
+}
+
+/**
+ * Test: The advertised service is not answered needlessly
+ * Verifies known-answer suppression, the one-second multicast limit and
+ * unicast answers to QU queries
+ */
+TEST_F(MdnsDiscoveryTest, AdvertiserSuppressesKnownAndRepeatedAnswers) {
+    ON_CALL(*mock_socket_, PublishService(_, _, _, _)).WillByDefault(Return(true));
+    AcceptSocketSetup(*mock_socket_);
+    EXPECT_CALL(*mock_socket_, SendResponse("host_a", _, "eth0")).Times(1);
+    EXPECT_CALL(*mock_socket_, SendResponse("host_a", _, "192.168.1.50", "wlan0")).Times(1);
+
+    auto discovery = std::make_unique<MdnsDiscovery>(mock_socket_, mock_interface_provider_, mock_config_);
+    discovery->Initialize();
+    GameSessionInfo session;
+    session.game_id = "test_game";
+    session.host_name = "host_a";
+    ASSERT_EQ(discovery->AdvertiseService(session), ErrorCode::Success);
+
+    const std::string type = "_sudachi-ldn._tcp.local.";
+    MdnsQueryOptions knows_us;
+    knows_us.known_answers.push_back({"host_a", std::chrono::milliseconds(50)});
+    discovery->ProcessIncomingQuery(type, knows_us, "192.168.1.50", "eth0");
+
+    // Answered once; the repeat falls within the same second
+    discovery->ProcessIncomingQuery(type, {}, "192.168.1.50", "eth0");
+    discovery->ProcessIncomingQuery(type, {}, "192.168.1.51", "eth0");
+
+    MdnsQueryOptions unicast;
+    unicast.unicast_response = true;
+    discovery->ProcessIncomingQuery(type, unicast, "192.168.1.50", "wlan0");
+
+    // Other services are not ours to answer
+    discovery->ProcessIncomingQuery("_other._udp.local.", {}, "192.168.1.50", "wlan0");
+}
+
+/**
+ * Test: Both address families are raced
+ * Verifies that queries go out over IPv4 and IPv6 together, that a host
+ * answering on both is one service, and that the family that answered first
+ * on the network is remembered and used to connect
+ */
+TEST_F(MdnsDiscoveryTest, DualStackAnswersMergeAndPreferTheFirstFamily) {
+    AcceptSocketSetup(*mock_socket_);
+    EXPECT_CALL(*mock_socket_, SendQuery(_, _, Field(&MdnsQueryOptions::families, IPVersion::Both), _))
+        .Times(2);
+
+    auto discovery = std::make_unique<MdnsDiscovery>(mock_socket_, mock_interface_provider_, mock_config_);
+    discovery->Initialize();
+    discovery->StartDiscovery();
+    EXPECT_FALSE(discovery->GetPreferredAddressFamily("eth0").has_value());
+
+    // IPv4 multicast is filtered on this network; IPv6 answers first
+    const auto response = CreateTestMdnsResponse(
+        "_sudachi-ldn._tcp.local.", "host1", "fe80::10", 7100,
+        "game_id=game1&version=1.0&players=1&max_players=4&has_password=false&host_name=host1");
+    discovery->ProcessIncomingPacket(response.data(), response.size(), "fe80::10", "eth0");
+    EXPECT_EQ(discovery->GetPreferredAddressFamily("eth0"), IPVersion::IPv6);
+    EXPECT_FALSE(discovery->GetPreferredAddressFamily("wlan0").has_value());
+
+    discovery->ProcessIncomingPacket(response.data(), response.size(), "192.168.1.10", "eth0");
+    const auto services = discovery->GetDiscoveredServices();
+    ASSERT_EQ(services.size(), 1u);
+    EXPECT_EQ(services[0].ip_version, IPVersion::Both);
+    EXPECT_EQ(services[0].host_ip, "fe80::10");
+    EXPECT_EQ(services[0].host_ipv4, "192.168.1.10");
+    EXPECT_EQ(services[0].host_ipv6, "fe80::10");
+}
+
 /**
  * Test: Thread safety for concurrent operations
  * Verifies that concurrent discovery and advertisement operations are thread-safe
@@ -602,7 +771,7 @@ TEST_F(MdnsDiscoveryTest, ErrorRecoveryFromNetworkFailures) {
     // This test will fail because error recovery doesn't exist yet
     
     // ARRANGE
-    EXPECT_CALL(*mock_socket_, SendQuery(_, _, _))
+    EXPECT_CALL(*mock_socket_, SendQuery(_, _, _, _))
         .WillOnce(Return(false))  // First attempt fails
         .WillOnce(Return(true));  // Retry succeeds
     
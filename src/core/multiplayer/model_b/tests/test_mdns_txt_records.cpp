@@ -48,6 +48,23 @@ struct TestGameSessionData {
           session_id("session_123"), custom_data("") {}
 };
 
+/**
+ * Helper function to create test binary TXT record data
+ * in RFC 6763 format: [length][key=value]
+ */
+std::vector<uint8_t> CreateTestBinaryTxtRecords(
+    const std::vector<std::pair<std::string, std::string>>& records) {
+    std::vector<uint8_t> data;
+    for (const auto& record : records) {
+        std::string record_str = record.first + "=" + record.second;
+        if (record_str.length() <= 255) {
+            data.push_back(static_cast<uint8_t>(record_str.length()));
+            data.insert(data.end(), record_str.begin(), record_str.end());
+        }
+    }
+    return data;
+}
+
 } // anonymous namespace
 
 /**
@@ -540,22 +557,154 @@ TEST_F(MdnsTxtRecordsTest, GetAllRecordsReturnsAllTxtRecords) {
 }
 
 /**
- * Helper function to create test binary TXT record data
- * This would be implemented to create proper RFC 6763 formatted TXT record data
+ * Test: TxtRecordView walks wire-format records in place
+ * Verifies that keys and values point into the original buffer
  */
-std::vector<uint8_t> CreateTestBinaryTxtRecords(
-    const std::vector<std::pair<std::string, std::string>>& records) {
-    // This helper function will fail because it doesn't exist yet
-    // It should create properly formatted binary TXT record data
-    // according to RFC 6763 format: [length][key=value]
-    
-    std::vector<uint8_t> data;
-    for (const auto& record : records) {
-        std::string record_str = record.first + "=" + record.second;
-        if (record_str.length() <= 255) {
-            data.push_back(static_cast<uint8_t>(record_str.length()));
-            data.insert(data.end(), record_str.begin(), record_str.end());
-        }
+TEST(TxtRecordViewTest, IteratesWireRecordsWithoutCopying) {
+    auto binary = CreateTestBinaryTxtRecords({{"game_id", "zelda"}, {"players", "2"}});
+    binary.insert(binary.begin() + binary[0] + 1, 0); // Zero-length record is skipped
+
+    const auto view = TxtRecordView::FromWire(binary.data(), binary.size());
+    ASSERT_TRUE(view.IsValid());
+
+    std::vector<std::pair<std::string, std::string>> records;
+    for (const auto& record : view) {
+        EXPECT_GE(reinterpret_cast<const uint8_t*>(record.key.data()), binary.data());
+        EXPECT_LT(reinterpret_cast<const uint8_t*>(record.value.data()),
+                  binary.data() + binary.size());
+        records.emplace_back(record.key, record.value);
     }
-    return data;
+
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_EQ(records[0], std::make_pair(std::string("game_id"), std::string("zelda")));
+    EXPECT_EQ(records[1], std::make_pair(std::string("players"), std::string("2")));
+    EXPECT_EQ(view.Find("players").value(), "2");
+    EXPECT_FALSE(view.Find("version").has_value());
+}
+
+/**
+ * Test: TxtRecordView rejects truncated wire data
+ */
+TEST(TxtRecordViewTest, TruncatedWireDataIsInvalid) {
+    auto binary = CreateTestBinaryTxtRecords({{"game_id", "zelda"}});
+    binary.push_back(10); // Length prefix with no payload
+
+    const auto view = TxtRecordView::FromWire(binary.data(), binary.size());
+    EXPECT_FALSE(view.IsValid());
+    EXPECT_EQ(std::distance(view.begin(), view.end()), 1);
+
+    const std::vector<uint8_t> missing_separator = {3, 'a', 'b', 'c'};
+    EXPECT_FALSE(TxtRecordView::FromWire(missing_separator.data(), missing_separator.size()).IsValid());
+    EXPECT_FALSE(TxtRecordParser(missing_separator).IsValid());
+}
+
+/**
+ * Test: ParseGameSession fills GameSessionInfo in one pass
+ */
+TEST(TxtRecordViewTest, ParseGameSessionFromDelimitedText) {
+    const std::string txt =
+        "game_id=mario_kart&version=1.2&players=3&max_players=8&has_password=true"
+        "&host_name=living_room&session_id=abc&unknown=skipped&no_separator";
+
+    GameSessionInfo info;
+    ASSERT_TRUE(TxtRecordView::FromDelimited(txt).ParseGameSession(info));
+    EXPECT_EQ(info.game_id, "mario_kart");
+    EXPECT_EQ(info.version, "1.2");
+    EXPECT_EQ(info.current_players, 3);
+    EXPECT_EQ(info.max_players, 8);
+    EXPECT_TRUE(info.has_password);
+    EXPECT_EQ(info.host_name, "living_room");
+    EXPECT_EQ(info.session_id, "abc");
+}
+
+/**
+ * Test: ParseGameSession rejects malformed or incomplete announcements
+ */
+TEST(TxtRecordViewTest, ParseGameSessionRejectsMalformedFields) {
+    GameSessionInfo info;
+    EXPECT_FALSE(TxtRecordView::FromDelimited("game_id=x&players=two").ParseGameSession(info));
+    EXPECT_FALSE(TxtRecordView::FromDelimited("players=2&max_players=4").ParseGameSession(info));
+    EXPECT_FALSE(TxtRecordView::FromDelimited("").ParseGameSession(info));
+    EXPECT_TRUE(TxtRecordView::FromDelimited("game_id=x&").ParseGameSession(info));
+}
+
+/**
+ * Test: ApplyGameSession only rewrites fields that changed
+ * Verifies that an unchanged session keeps the cached announcement encoding
+ */
+TEST(TxtRecordBuilderDeltaTest, ApplyGameSessionTracksDirtyFields) {
+    GameSessionInfo session;
+    session.game_id = "splatoon";
+    session.version = "3.0";
+    session.current_players = 1;
+    session.max_players = 8;
+    session.host_name = "host";
+
+    auto builder = TxtRecordBuilder::CreateGameSessionTxtRecords(session);
+    const std::string first = builder.ToAnnouncementText();
+
+    EXPECT_EQ(builder.ApplyGameSession(session), 0u);
+    EXPECT_EQ(builder.ToAnnouncementText(), first);
+
+    session.current_players = 2;
+    session.host_name.clear();
+    EXPECT_EQ(builder.ApplyGameSession(session), 2u);
+    EXPECT_TRUE(builder.IsDirty());
+    EXPECT_EQ(builder.GetRecord("players"), "2");
+    EXPECT_FALSE(builder.HasRecord("host_name"));
+
+    GameSessionInfo parsed;
+    ASSERT_TRUE(TxtRecordView::FromDelimited(builder.ToAnnouncementText()).ParseGameSession(parsed));
+    EXPECT_EQ(parsed.current_players, 2);
+    EXPECT_TRUE(parsed.host_name.empty());
+}
+
+/**
+ * Test: Advertise data is carried in hex chunks
+ * Verifies that a one-byte change rewrites only its chunk and round-trips
+ */
+TEST(TxtRecordBuilderDeltaTest, AdvertiseDataChunksRoundTrip) {
+    GameSessionInfo session;
+    session.game_id = "splatoon";
+    session.version = "3.0";
+    session.advertise_data.assign(300, 0xAB);
+
+    auto builder = TxtRecordBuilder::CreateGameSessionTxtRecords(session);
+    EXPECT_TRUE(builder.HasRecord("adv0"));
+    EXPECT_TRUE(builder.HasRecord("adv2"));
+    EXPECT_FALSE(builder.HasRecord("adv3"));
+
+    session.advertise_data[250] = 0x01;
+    EXPECT_EQ(builder.ApplyGameSession(session), 1u);
+
+    GameSessionInfo parsed;
+    ASSERT_TRUE(TxtRecordView::FromDelimited(builder.ToAnnouncementText()).ParseGameSession(parsed));
+    EXPECT_EQ(parsed.advertise_data, session.advertise_data);
+
+    session.advertise_data.resize(10);
+    EXPECT_EQ(builder.ApplyGameSession(session), 3u);
+    EXPECT_FALSE(builder.HasRecord("adv1"));
+}
+
+/**
+ * Test: Cached encodings follow record edits
+ */
+TEST(TxtRecordBuilderDeltaTest, EncodingsRebuiltAfterRecordEdits) {
+    TxtRecordBuilder builder;
+    builder.AddRecord("game_id", "x");
+    const auto binary = builder.ToBinary();
+    EXPECT_EQ(builder.ToAnnouncementText(), "game_id=x");
+    EXPECT_FALSE(builder.IsDirty());
+
+    builder.AddRecord("game_id", "x"); // Same value leaves the cache alone
+    EXPECT_FALSE(builder.IsDirty());
+
+    builder.UpdateRecord("game_id", "y");
+    EXPECT_TRUE(builder.IsDirty());
+    EXPECT_EQ(builder.ToAnnouncementText(), "game_id=y");
+    EXPECT_NE(builder.ToBinary(), binary);
+
+    builder.Clear();
+    EXPECT_TRUE(builder.ToAnnouncementText().empty());
+    EXPECT_TRUE(builder.ToBinary().empty());
 }
@@ -4,6 +4,9 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "core/multiplayer/model_b/platform/windows/mobile_hotspot_manager.h"
 
@@ -62,6 +65,74 @@ TEST_F(MobileHotspotManagerTest, ClientConnectionsUpdateStatus) {
     EXPECT_EQ(status.connected_clients, 0);
 }
 
+TEST_F(MobileHotspotManagerTest, ClientEventsCarryNodeIdsImmediately) {
+    CreateManager();
+    std::vector<std::pair<uint8_t, std::string>> joined;
+    std::vector<std::pair<uint8_t, std::string>> left;
+    manager->SetClientEventCallbacks(
+        [&](uint8_t node_id, const ClientInfo& client) { joined.emplace_back(node_id, client.mac_address); },
+        [&](uint8_t node_id, const ClientInfo& client) { left.emplace_back(node_id, client.mac_address); });
+
+    manager->OnClientConnected({"aa-bb-cc-dd-ee-01", "192.168.137.2", "First"});
+    manager->OnClientConnected({"AA:BB:CC:DD:EE:02", "192.168.137.3", "Second"});
+    // The same device again, in another notation: no second join
+    manager->OnClientConnected({"AA:BB:CC:DD:EE:01", "192.168.137.4", "First"});
+    ASSERT_EQ(joined.size(), 2u);
+    EXPECT_EQ(joined[0], std::make_pair(uint8_t{1}, std::string("AA:BB:CC:DD:EE:01")));
+    EXPECT_EQ(joined[1], std::make_pair(uint8_t{2}, std::string("AA:BB:CC:DD:EE:02")));
+    EXPECT_EQ(manager->GetHotspotStatus().connected_clients, 2);
+
+    manager->OnClientDisconnected("aa:bb:cc:dd:ee:01");
+    manager->OnClientDisconnected("aa:bb:cc:dd:ee:01");
+    ASSERT_EQ(left.size(), 1u);
+    EXPECT_EQ(left[0].first, 1);
+
+    // The freed id goes to the next client
+    manager->OnClientConnected({"AA:BB:CC:DD:EE:03", "192.168.137.5", "Third"});
+    ASSERT_EQ(joined.size(), 3u);
+    EXPECT_EQ(joined[2].first, 1);
+}
+
+TEST_F(MobileHotspotManagerTest, ClientListChangeReportsOnlyDifferences) {
+    CreateManager();
+    std::vector<uint8_t> joined;
+    std::vector<uint8_t> left;
+    manager->SetClientEventCallbacks([&](uint8_t node_id, const ClientInfo&) { joined.push_back(node_id); },
+                                     [&](uint8_t node_id, const ClientInfo&) { left.push_back(node_id); });
+
+    const ClientInfo a{"AA:BB:CC:DD:EE:01", "192.168.137.2", "A"};
+    const ClientInfo b{"AA:BB:CC:DD:EE:02", "192.168.137.3", "B"};
+    const ClientInfo c{"AA:BB:CC:DD:EE:03", "192.168.137.4", "C"};
+    manager->OnClientListChanged({a, b});
+    EXPECT_EQ(joined, (std::vector<uint8_t>{1, 2}));
+
+    manager->OnClientListChanged({b, c});
+    EXPECT_EQ(left, (std::vector<uint8_t>{1}));
+    EXPECT_EQ(joined, (std::vector<uint8_t>{1, 2, 1}));
+
+    manager->OnClientListChanged({b, c});
+    EXPECT_EQ(joined.size(), 3u);
+    EXPECT_EQ(left.size(), 1u);
+}
+
+TEST_F(MobileHotspotManagerTest, StopHotspotReportsEveryClientLeft) {
+    CreateManager();
+    manager->Initialize();
+    HotspotConfiguration cfg{"Sudachi", "password", 4, WiFiBand::TwoPointFourGHz, 6};
+    manager->ConfigureHotspot(cfg);
+    manager->StartHotspot();
+
+    std::vector<uint8_t> left;
+    manager->SetClientEventCallbacks(nullptr,
+                                     [&](uint8_t node_id, const ClientInfo&) { left.push_back(node_id); });
+    manager->OnClientConnected({"AA:BB:CC:DD:EE:01", "192.168.137.2", "A"});
+    manager->OnClientConnected({"AA:BB:CC:DD:EE:02", "192.168.137.3", "B"});
+
+    EXPECT_EQ(manager->StopHotspot(), ErrorCode::Success);
+    EXPECT_EQ(left, (std::vector<uint8_t>{1, 2}));
+    EXPECT_EQ(manager->GetHotspotStatus().connected_clients, 0);
+}
+
 TEST_F(MobileHotspotManagerTest, FallbackModeSelectionWorks) {
     CreateManager();
     EXPECT_EQ(manager->GetRecommendedFallbackMode(), FallbackMode::WiFiDirect);
@@ -0,0 +1,122 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "core/multiplayer/model_b/platform/android/persistent_group_store.h"
+
+using namespace Core::Multiplayer::ModelB::Android;
+
+namespace {
+
+WifiP2pGroup MakeGroup(const std::string& name, const std::string& passphrase,
+                       bool is_group_owner) {
+    WifiP2pGroup group;
+    group.network_name = name;
+    group.passphrase = passphrase;
+    group.is_group_owner = is_group_owner;
+    return group;
+}
+
+class PersistentGroupStoreTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = (std::filesystem::temp_directory_path() /
+                 ("persistent_group_store_test_" +
+                  std::to_string(::testing::UnitTest::GetInstance()->random_seed()) + "_" +
+                  ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".json"))
+                    .string();
+        std::filesystem::remove(path_);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(path_);
+    }
+
+    std::string path_;
+};
+
+} // namespace
+
+TEST_F(PersistentGroupStoreTest, GroupSurvivesReload) {
+    const auto now = std::chrono::system_clock::now();
+    {
+        PersistentGroupStore store(path_, 8);
+        ASSERT_TRUE(store.Load());
+        ASSERT_TRUE(store.RecordSuccess("02:00:00:AA:BB:CC",
+                                        MakeGroup("DIRECT-xy-sudachi", "secret12", false), now));
+        ASSERT_TRUE(store.RecordSuccess("02:00:00:aa:bb:cc",
+                                        MakeGroup("DIRECT-xy-sudachi", "secret12", false), now));
+    }
+
+    PersistentGroupStore store(path_, 8);
+    ASSERT_TRUE(store.Load());
+    const auto record = store.Lookup("02:00:00:aa:bb:cc");
+    ASSERT_TRUE(record.has_value());
+    EXPECT_EQ(record->network_name, "DIRECT-xy-sudachi");
+    EXPECT_EQ(record->passphrase, "secret12");
+    EXPECT_FALSE(record->is_group_owner);
+    EXPECT_EQ(record->success_count, 2u);
+    EXPECT_FALSE(store.Lookup("02:00:00:aa:bb:cd").has_value());
+}
+
+TEST_F(PersistentGroupStoreTest, NewCredentialsRestartTheCount) {
+    PersistentGroupStore store(path_, 8);
+    store.RecordSuccess("02:00:00:aa:bb:cc", MakeGroup("DIRECT-ab", "secret12", true));
+    store.RecordSuccess("02:00:00:aa:bb:cc", MakeGroup("DIRECT-cd", "secret34", true));
+
+    const auto record = store.Lookup("02:00:00:aa:bb:cc");
+    ASSERT_TRUE(record.has_value());
+    EXPECT_EQ(record->network_name, "DIRECT-cd");
+    EXPECT_TRUE(record->is_group_owner);
+    EXPECT_EQ(record->success_count, 1u);
+}
+
+TEST_F(PersistentGroupStoreTest, IncompleteGroupsAreIgnored) {
+    PersistentGroupStore store(path_, 8);
+    EXPECT_TRUE(store.RecordSuccess("02:00:00:aa:bb:cc", MakeGroup("", "secret12", false)));
+    EXPECT_TRUE(store.RecordSuccess("02:00:00:aa:bb:cc", MakeGroup("DIRECT-ab", "", false)));
+    EXPECT_TRUE(store.RecordSuccess("", MakeGroup("DIRECT-ab", "secret12", false)));
+    EXPECT_EQ(store.GetRecordCount(), 0u);
+}
+
+TEST_F(PersistentGroupStoreTest, LeastRecentlyUsedGroupIsEvicted) {
+    PersistentGroupStore store(path_, 2);
+    const auto now = std::chrono::system_clock::now();
+    store.RecordSuccess("02:00:00:00:00:01", MakeGroup("DIRECT-1", "secret01", false),
+                        now - std::chrono::hours(2));
+    store.RecordSuccess("02:00:00:00:00:02", MakeGroup("DIRECT-2", "secret02", false),
+                        now - std::chrono::hours(1));
+    store.RecordSuccess("02:00:00:00:00:03", MakeGroup("DIRECT-3", "secret03", false), now);
+
+    EXPECT_EQ(store.GetRecordCount(), 2u);
+    EXPECT_FALSE(store.Lookup("02:00:00:00:00:01").has_value());
+    EXPECT_TRUE(store.Lookup("02:00:00:00:00:03").has_value());
+}
+
+TEST_F(PersistentGroupStoreTest, ForgetRemovesTheGroup) {
+    {
+        PersistentGroupStore store(path_, 8);
+        store.RecordSuccess("02:00:00:aa:bb:cc", MakeGroup("DIRECT-ab", "secret12", false));
+        ASSERT_TRUE(store.Forget("02:00:00:AA:BB:CC"));
+        EXPECT_TRUE(store.Forget("02:00:00:aa:bb:cc"));
+    }
+
+    PersistentGroupStore store(path_, 8);
+    ASSERT_TRUE(store.Load());
+    EXPECT_EQ(store.GetRecordCount(), 0u);
+}
+
+TEST_F(PersistentGroupStoreTest, UnreadableFileIsReported) {
+    {
+        std::ofstream file(path_);
+        file << "{not json";
+    }
+    PersistentGroupStore store(path_, 8);
+    EXPECT_FALSE(store.Load());
+    EXPECT_EQ(store.GetRecordCount(), 0u);
+}
@@ -0,0 +1,116 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "core/multiplayer/model_b/radio_wake_window.h"
+
+using namespace Core::Multiplayer;
+using namespace Core::Multiplayer::ModelB;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr uint64_t MS = 1'000'000; // Nanoseconds
+
+bool WaitFor(const std::atomic<int>& counter, int expected) {
+    const auto deadline = std::chrono::steady_clock::now() + 2s;
+    while (counter.load() < expected) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+class RadioWakeWindowTest : public ::testing::Test {
+protected:
+    std::shared_ptr<TimerWheel> wheel = std::make_shared<TimerWheel>(1ms);
+};
+
+} // namespace
+
+TEST_F(RadioWakeWindowTest, DisabledRunsAtOnce) {
+    RadioWakeWindow window({}, wheel);
+    int runs = 0;
+    window.Defer(1, [&] { ++runs; });
+    EXPECT_EQ(runs, 1);
+    EXPECT_EQ(window.GetStatistics().deferred, 0u);
+}
+
+TEST_F(RadioWakeWindowTest, NewerTaskReplacesPendingOneOfItsKind) {
+    RadioWakeWindow window({10s}, wheel);
+    window.SetEnabled(true);
+    std::vector<int> runs;
+    window.Defer(1, [&] { runs.push_back(1); });
+    window.Defer(2, [&] { runs.push_back(2); });
+    window.Defer(1, [&] { runs.push_back(3); });
+    EXPECT_TRUE(runs.empty());
+
+    window.Flush();
+    EXPECT_EQ(runs, (std::vector<int>{3, 2}));
+    const auto statistics = window.GetStatistics();
+    EXPECT_EQ(statistics.deferred, 3u);
+    EXPECT_EQ(statistics.coalesced, 1u);
+    EXPECT_EQ(statistics.tasks_run, 2u);
+}
+
+TEST_F(RadioWakeWindowTest, WindowOpensAtTheBoundary) {
+    RadioWakeWindow window({20ms}, wheel);
+    window.SetEnabled(true);
+    std::atomic<int> runs{0};
+    window.Defer(1, [&] { ++runs; });
+    window.Defer(2, [&] { ++runs; });
+    ASSERT_TRUE(WaitFor(runs, 2));
+    const auto statistics = window.GetStatistics();
+    EXPECT_EQ(statistics.windows, 1u);
+    EXPECT_EQ(statistics.piggybacked, 0u);
+}
+
+TEST_F(RadioWakeWindowTest, RealtimeTrafficOpensThePendingWindowEarly) {
+    RadioWakeWindow window({60s}, wheel);
+    window.SetEnabled(true);
+    window.NotifyRadioAwake(); // Nothing pending, nothing scheduled
+    std::atomic<int> runs{0};
+    window.Defer(1, [&] { ++runs; });
+    window.NotifyRadioAwake();
+    window.NotifyRadioAwake();
+    ASSERT_TRUE(WaitFor(runs, 1));
+    const auto statistics = window.GetStatistics();
+    EXPECT_EQ(statistics.windows, 1u);
+    EXPECT_EQ(statistics.piggybacked, 1u);
+}
+
+TEST_F(RadioWakeWindowTest, DisablingRunsWhatIsPending) {
+    RadioWakeWindow window({10s}, wheel);
+    window.SetEnabled(true);
+    int runs = 0;
+    window.Defer(1, [&] { ++runs; });
+    window.SetEnabled(false);
+    EXPECT_EQ(runs, 1);
+    window.Defer(1, [&] { ++runs; });
+    EXPECT_EQ(runs, 2);
+}
+
+TEST_F(RadioWakeWindowTest, ClearDropsPendingTasks) {
+    RadioWakeWindow window({10s}, wheel);
+    window.SetEnabled(true);
+    int runs = 0;
+    window.Defer(1, [&] { ++runs; });
+    window.Clear();
+    window.Flush();
+    EXPECT_EQ(runs, 0);
+}
+
+TEST_F(RadioWakeWindowTest, WindowsAreAlignedToTheInterval) {
+    RadioWakeWindow window({1000ms}, wheel);
+    EXPECT_EQ(window.DelayToNextWindow(2500 * MS), 500ms);
+    EXPECT_EQ(window.DelayToNextWindow(3000 * MS), 1000ms);
+    EXPECT_EQ(window.DelayToNextWindow(3999 * MS + 1), 1ms);
+}
@@ -0,0 +1,107 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include "core/multiplayer/model_b/platform/android/wifi_direct_peer_codec.h"
+
+using namespace Core::Multiplayer::ModelB::Android;
+
+namespace {
+
+WifiP2pDevice MakeDevice(const std::string& name, const std::string& address, int status,
+                         bool is_group_owner) {
+    WifiP2pDevice device;
+    device.device_name = name;
+    device.device_address = address;
+    device.status = status;
+    device.is_group_owner = is_group_owner;
+    return device;
+}
+
+TEST(WifiDirectPeerCodecTest, PeerListRoundTrips) {
+    const std::vector<WifiP2pDevice> peers = {
+        MakeDevice("Switch-A", "02:00:00:aa:bb:cc", 3, false),
+        MakeDevice("", "de:ad:be:ef:00:01", 0, true),
+    };
+
+    std::vector<WifiP2pDevice> decoded;
+    ASSERT_TRUE(DecodePackedPeers(EncodePackedPeers(peers), decoded));
+    ASSERT_EQ(decoded.size(), peers.size());
+    for (size_t i = 0; i < peers.size(); ++i) {
+        EXPECT_EQ(decoded[i].device_name, peers[i].device_name);
+        EXPECT_EQ(decoded[i].device_address, peers[i].device_address);
+        EXPECT_EQ(decoded[i].status, peers[i].status);
+        EXPECT_EQ(decoded[i].is_group_owner, peers[i].is_group_owner);
+    }
+}
+
+TEST(WifiDirectPeerCodecTest, DecodesJavaLayout) {
+    // As WifiDirectHelper.getPeersPacked() writes it
+    const std::vector<uint8_t> packed = {
+        0x01, 0x00, 0x01,                  // Version, one device
+        0x03, 0x01,                        // AVAILABLE, group owner
+        0x02, 'h',  'i',                   // Name
+        0x0A, 0x1B, 0x2C, 0x3D, 0x4E, 0x5F, // Address
+    };
+
+    std::vector<WifiP2pDevice> decoded;
+    ASSERT_TRUE(DecodePackedPeers(packed, decoded));
+    ASSERT_EQ(decoded.size(), 1u);
+    EXPECT_EQ(decoded[0].device_name, "hi");
+    EXPECT_EQ(decoded[0].device_address, "0a:1b:2c:3d:4e:5f");
+    EXPECT_EQ(decoded[0].status, 3);
+    EXPECT_TRUE(decoded[0].is_group_owner);
+}
+
+TEST(WifiDirectPeerCodecTest, EmptyListDecodes) {
+    std::vector<WifiP2pDevice> decoded{MakeDevice("stale", "00:00:00:00:00:00", 0, false)};
+    ASSERT_TRUE(DecodePackedPeers(EncodePackedPeers({}), decoded));
+    EXPECT_TRUE(decoded.empty());
+}
+
+TEST(WifiDirectPeerCodecTest, RejectsMalformedInput) {
+    auto packed = EncodePackedPeers({MakeDevice("Switch-A", "02:00:00:aa:bb:cc", 3, false)});
+    std::vector<WifiP2pDevice> decoded{MakeDevice("kept", "00:00:00:00:00:00", 0, false)};
+
+    // Every truncation fails and leaves the output alone
+    for (size_t length = 0; length < packed.size(); ++length) {
+        EXPECT_FALSE(DecodePackedPeers({packed.data(), length}, decoded)) << length;
+    }
+    ASSERT_EQ(decoded.size(), 1u);
+    EXPECT_EQ(decoded[0].device_name, "kept");
+
+    auto wrong_version = packed;
+    wrong_version[0] = WIFI_DIRECT_PACKED_VERSION + 1;
+    EXPECT_FALSE(DecodePackedPeers(wrong_version, decoded));
+
+    const std::vector<uint8_t> too_many = {WIFI_DIRECT_PACKED_VERSION, 0xFF, 0xFF};
+    EXPECT_FALSE(DecodePackedPeers(too_many, decoded));
+}
+
+TEST(WifiDirectPeerCodecTest, GroupRoundTrips) {
+    WifiP2pGroup group;
+    group.network_name = "DIRECT-sudachi";
+    group.passphrase = "sudachi123";
+    group.is_group_owner = true;
+    group.clients = {MakeDevice("Client", "12:34:56:78:9a:bc", 0, false)};
+
+    WifiP2pGroup decoded;
+    ASSERT_TRUE(DecodePackedGroup(EncodePackedGroup(group), decoded));
+    EXPECT_EQ(decoded.network_name, group.network_name);
+    EXPECT_EQ(decoded.passphrase, group.passphrase);
+    EXPECT_TRUE(decoded.is_group_owner);
+    ASSERT_EQ(decoded.clients.size(), 1u);
+    EXPECT_EQ(decoded.clients[0].device_address, "12:34:56:78:9a:bc");
+}
+
+TEST(WifiDirectPeerCodecTest, LongNamesAreTruncated) {
+    const std::string long_name(300, 'x');
+    std::vector<WifiP2pDevice> decoded;
+    ASSERT_TRUE(DecodePackedPeers(
+        EncodePackedPeers({MakeDevice(long_name, "02:00:00:aa:bb:cc", 3, false)}), decoded));
+    ASSERT_EQ(decoded.size(), 1u);
+    EXPECT_EQ(decoded[0].device_name, std::string(255, 'x'));
+}
+
+} // namespace
@@ -5,9 +5,12 @@
 #include <gmock/gmock.h>
 #include <memory>
 #include <chrono>
+#include <filesystem>
 #include <thread>
 
 #include "mocks/mock_jni_env.h"
+#include "core/multiplayer/common/datagram_socket.h"
+#include "core/multiplayer/model_b/platform/android/persistent_group_store.h"
 #include "core/multiplayer/model_b/platform/android/wifi_direct_wrapper.h"
 #include "core/multiplayer/common/error_codes.h"
 
@@ -108,6 +111,20 @@ TEST_F(WiFiDirectWrapperTest, CreateAndRemoveGroup) {
     EXPECT_EQ(wrapper->GetState(), WifiDirectState::Initialized);
 }
 
+TEST_F(WiFiDirectWrapperTest, GroupSocketNeedsAGroup) {
+    CreateWrapper();
+    DatagramSocket socket;
+    EXPECT_EQ(wrapper->OpenGroupSocket(0, socket), ErrorCode::NotInitialized);
+    wrapper->Initialize(mock_env.get(), mock_context.get());
+    EXPECT_EQ(wrapper->OpenGroupSocket(0, socket), ErrorCode::InvalidState);
+    EXPECT_FALSE(socket.IsOpen());
+
+    ASSERT_EQ(wrapper->CreateGroup(), ErrorCode::Success);
+    ASSERT_EQ(wrapper->OpenGroupSocket(0, socket), ErrorCode::Success);
+    EXPECT_TRUE(socket.IsOpen());
+    EXPECT_NE(socket.GetLocalEndpoint().Port(), 0);
+}
+
 TEST_F(WiFiDirectWrapperTest, JoinGroupSucceeds) {
     CreateWrapper();
     wrapper->Initialize(mock_env.get(), mock_context.get());
@@ -115,5 +132,36 @@ TEST_F(WiFiDirectWrapperTest, JoinGroupSucceeds) {
     EXPECT_EQ(wrapper->GetState(), WifiDirectState::GroupClient);
 }
 
+TEST_F(WiFiDirectWrapperTest, JoinGroupReusesPersistentGroup) {
+    const auto path =
+        (std::filesystem::temp_directory_path() / "wifi_direct_persistent_groups_test.json").string();
+    std::filesystem::remove(path);
+    {
+        WifiP2pGroup group;
+        group.network_name = "DIRECT-xy-sudachi";
+        group.passphrase = "secret12";
+        group.is_group_owner = true;
+        PersistentGroupStore store(path, 8);
+        ASSERT_TRUE(store.RecordSuccess("aa:bb:cc:dd:ee:ff", group));
+    }
+
+    CreateWrapper();
+    ASSERT_EQ(wrapper->Initialize(mock_env.get(), mock_context.get()), ErrorCode::Success);
+    ASSERT_EQ(wrapper->EnablePersistentGroups(path), ErrorCode::Success);
+    EXPECT_TRUE(wrapper->HasPersistentGroup("AA:BB:CC:DD:EE:FF"));
+    EXPECT_FALSE(wrapper->HasPersistentGroup("AA:BB:CC:DD:EE:00"));
+
+    // Comes back in the remembered role, with no discovery or negotiation
+    EXPECT_EQ(wrapper->JoinGroup("AA:BB:CC:DD:EE:FF"), ErrorCode::Success);
+    EXPECT_EQ(wrapper->GetState(), WifiDirectState::GroupOwner);
+    const auto info = wrapper->GetGroupInfo();
+    EXPECT_EQ(info.network_name, "DIRECT-xy-sudachi");
+    EXPECT_EQ(info.passphrase, "secret12");
+    EXPECT_TRUE(info.is_group_owner);
+
+    wrapper->Shutdown();
+    std::filesystem::remove(path);
+}
+
 } // namespace
 
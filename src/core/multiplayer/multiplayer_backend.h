@@ -8,7 +8,14 @@
 #include <cstdint>
 #include <functional>
 
+#include "common/backend_stats.h"
+#include "common/congestion_controller.h"
+#include "common/discovery_filter.h"
 #include "common/error_codes.h"
+#include "common/latency_histogram.h"
+#include "common/packet_buffer.h"
+#include "common/priority_send_queue.h"
+#include "common/traffic_profile.h"
 
 // Forward declarations for LDN types
 namespace Service::LDN {
@@ -27,6 +34,18 @@ class MacAddress;
 
 namespace Core::Multiplayer::HLE {
 
+class ConfigurationManager;
+
+/**
+ * Reference to an outbound packet for batched sends.
+ * Points at caller-owned bytes that must stay valid for the duration of the call.
+ */
+struct PacketRef {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    uint8_t node_id = 0;
+};
+
 /**
  * MultiplayerBackend Interface - The unified interface both Model A and B must implement
  * This is the critical missing piece that allows LDN service to use our new backends
@@ -50,8 +69,16 @@ public:
     // Discovery and information
     virtual ErrorCode Scan(std::vector<Service::LDN::NetworkInfo>& out_networks,
                           const Service::LDN::ScanFilter& filter) = 0;
+    // The scan filter in backend terms, set before Scan so sessions it
+    // rejects are dropped at discovery; Scan still applies the full filter
+    virtual void SetDiscoveryFilter(const DiscoveryFilter& /*filter*/) {}
     virtual ErrorCode GetNetworkInfo(Service::LDN::NetworkInfo& out_info) = 0;
     virtual ErrorCode GetCurrentState(Service::LDN::State& out_state) = 0;
+    // Bumped whenever what Scan would find changes, so cached results can be
+    // refreshed; 0 when the backend does not track it
+    virtual uint64_t GetNetworksEpoch() const {
+        return 0;
+    }
     
     // Access point management
     virtual ErrorCode OpenAccessPoint() = 0;
@@ -63,6 +90,59 @@ public:
     virtual ErrorCode SendPacket(const std::vector<uint8_t>& data, uint8_t node_id) = 0;
     virtual ErrorCode ReceivePacket(std::vector<uint8_t>& out_data, uint8_t& out_node_id) = 0;
 
+    // Pooled data transmission - buffers stay in a PacketPool slab end-to-end.
+    // The defaults bridge to the vector overloads for backends without a pool.
+    virtual ErrorCode SendPacket(const PacketBuffer& packet, uint8_t node_id) {
+        return SendPacket(std::vector<uint8_t>(packet.data(), packet.data() + packet.size()), node_id);
+    }
+    virtual ErrorCode ReceivePacket(PacketBuffer& /*out_packet*/, uint8_t& /*out_node_id*/) {
+        return ErrorCode::NotSupported;
+    }
+
+    // Prioritized data transmission - the plain overloads send realtime.
+    // The defaults drop the priority for backends with a single send class.
+    virtual ErrorCode SendPacket(const std::vector<uint8_t>& data, uint8_t node_id,
+                                 SendPriority /*priority*/) {
+        return SendPacket(data, node_id);
+    }
+    virtual ErrorCode SendPacket(const PacketBuffer& packet, uint8_t node_id,
+                                 SendPriority /*priority*/) {
+        return SendPacket(packet, node_id);
+    }
+
+    // Batched data transmission - drains or submits a whole frame in one call.
+    // The defaults loop over the single-packet calls; backends override them to
+    // avoid per-packet dispatch and locking.
+    virtual ErrorCode SendPackets(const PacketRef* packets, size_t count, size_t& out_sent) {
+        out_sent = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const auto error = SendPacket(
+                std::vector<uint8_t>(packets[i].data, packets[i].data + packets[i].size),
+                packets[i].node_id);
+            if (error != ErrorCode::Success) {
+                return error;
+            }
+            ++out_sent;
+        }
+        return ErrorCode::Success;
+    }
+    virtual ErrorCode ReceivePackets(ReceivedPacket* out_packets, size_t max_packets,
+                                     size_t& out_received) {
+        out_received = 0;
+        while (out_received < max_packets) {
+            auto& slot = out_packets[out_received];
+            const auto error = ReceivePacket(slot.packet, slot.node_id);
+            if (error != ErrorCode::Success) {
+                return out_received > 0 ? ErrorCode::Success : error;
+            }
+            if (!slot.packet) {
+                break;
+            }
+            ++out_received;
+        }
+        return ErrorCode::Success;
+    }
+
     // Configuration and status
     virtual ErrorCode SetAdvertiseData(const std::vector<uint8_t>& data) = 0;
     virtual ErrorCode SetStationAcceptPolicy(Service::LDN::AcceptPolicy policy) = 0;
@@ -75,9 +155,42 @@ public:
                                      Service::LDN::Ipv4Address& out_subnet) = 0;
     virtual ErrorCode GetNetworkConfig(Service::LDN::NetworkConfig& out_config) = 0;
 
-    // Event callbacks
+    // Node membership, reported from whichever thread learns of it; the
+    // callbacks must not block, see NodeEventQueue
     virtual void RegisterNodeEventCallbacks(std::function<void(uint8_t)> on_node_joined,
                                             std::function<void(uint8_t)> on_node_left) = 0;
+
+    // Congestion signal from the transport: when reduce is set the game
+    // should send less until a hint clears it. Backends without congestion
+    // control never call it.
+    virtual void RegisterRateHintCallback(std::function<void(const RateHint&)> /*on_rate_hint*/) {}
+
+    // Tuning for the title in session, from LdnServiceBridge's profile table.
+    // Applied before packets flow; backends ignore what they cannot tune.
+    virtual void ApplyTrafficProfile(const TrafficProfile& /*profile*/) {}
+
+    // Once per emulated frame, from the HLE thread. Backends that batch
+    // sends flush here, so batching costs nothing past the frame the game
+    // already waits for; until the first call they send at once.
+    virtual void OnFrameBoundary() {}
+
+    // Per-node link and traffic numbers for overlays and telemetry. Fills a
+    // caller-owned struct without locking, so it is cheap to poll every frame.
+    virtual ErrorCode GetStatistics(BackendStats& /*out_stats*/) const {
+        return ErrorCode::NotSupported;
+    }
+
+    // Data path latency per hop, recorded since the backend was created.
+    // Backends without instrumentation report empty histograms.
+    virtual DataPathStatistics GetStatistics() const {
+        return {};
+    }
+
+    // Histograms the layer above records its own hops into, such as the
+    // LdnServiceBridge entry; null when the backend keeps none.
+    virtual DataPathLatency* GetDataPathLatency() {
+        return nullptr;
+    }
 };
 
 } // namespace Core::Multiplayer::HLE
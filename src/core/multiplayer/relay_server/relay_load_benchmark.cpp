@@ -0,0 +1,375 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// relay_load_benchmark: drives a relay server with many two-peer sessions
+// sending game-rate traffic, and reports throughput, loss and latency.
+// Without --server it runs an in-process RelayServer on the loopback.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "core/multiplayer/model_a/relay_protocol.h"
+#include "relay_server.h"
+
+using namespace Core::Multiplayer;
+using namespace Core::Multiplayer::Relay;
+using ModelA::RelayHeaderView;
+using ModelA::RelayProtocol;
+
+namespace {
+
+struct BenchmarkConfig {
+    std::string server_host = "127.0.0.1";
+    uint16_t server_port = 0; // 0 runs an in-process server
+    size_t sessions = 1000;
+    size_t client_threads = 4;
+    size_t server_reactors = 0;
+    unsigned rate_hz = 60;
+    size_t payload_size = 64;
+    unsigned duration_seconds = 10;
+};
+
+// Latency histogram in 10us buckets up to one second
+class LatencyHistogram {
+public:
+    static constexpr int64_t BUCKET_US = 10;
+    static constexpr size_t BUCKET_COUNT = 100000;
+
+    LatencyHistogram() : buckets_(BUCKET_COUNT, 0) {}
+
+    void Add(int64_t latency_us) {
+        const size_t bucket = std::min<size_t>(std::max<int64_t>(latency_us, 0) / BUCKET_US,
+                                               BUCKET_COUNT - 1);
+        ++buckets_[bucket];
+        ++count_;
+    }
+
+    void Merge(const LatencyHistogram& other) {
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            buckets_[i] += other.buckets_[i];
+        }
+        count_ += other.count_;
+    }
+
+    int64_t PercentileUs(double percentile) const {
+        const uint64_t target = static_cast<uint64_t>(count_ * percentile);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            seen += buckets_[i];
+            if (seen > target) {
+                return static_cast<int64_t>(i) * BUCKET_US;
+            }
+        }
+        return static_cast<int64_t>(BUCKET_COUNT) * BUCKET_US;
+    }
+
+    uint64_t GetCount() const { return count_; }
+
+private:
+    std::vector<uint64_t> buckets_;
+    uint64_t count_ = 0;
+};
+
+struct Client {
+    int socket = -1;
+    uint32_t sequence = 0;
+};
+
+struct Session {
+    uint32_t token = 0;
+    std::array<Client, 2> peers;
+};
+
+struct WorkerResult {
+    uint64_t sent = 0;
+    uint64_t received = 0;
+    LatencyHistogram latency;
+};
+
+int64_t NowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+int OpenClientSocket(const sockaddr_in& server) {
+    const int socket = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (socket < 0) {
+        return -1;
+    }
+    if (::connect(socket, reinterpret_cast<const sockaddr*>(&server), sizeof(server)) != 0) {
+        ::close(socket);
+        return -1;
+    }
+    return socket;
+}
+
+// Sends a session request and waits for its answer, retrying on loss
+bool RequestSession(const RelayProtocol& protocol, Client& client, uint32_t token, uint8_t flag) {
+    constexpr int ATTEMPTS = 5;
+    constexpr int REPLY_TIMEOUT_MS = 200;
+    std::array<uint8_t, sizeof(ModelA::RelayHeader)> request{};
+    std::array<uint8_t, 256> reply{};
+    for (int attempt = 0; attempt < ATTEMPTS; ++attempt) {
+        protocol.WriteHeader(request, token, 0, flag, client.sequence);
+        if (::send(client.socket, request.data(), request.size(), 0) < 0) {
+            return false;
+        }
+        pollfd descriptor{client.socket, POLLIN, 0};
+        while (::poll(&descriptor, 1, REPLY_TIMEOUT_MS) > 0) {
+            const ssize_t size = ::recv(client.socket, reply.data(), reply.size(), 0);
+            RelayHeaderView header;
+            if (size > 0 && protocol.ParseHeader(reply.data(), static_cast<size_t>(size), header) &&
+                (header.flags & flag) != 0 && header.session_token == token) {
+                return (header.flags & RelayProtocol::FLAG_CONTROL) == 0;
+            }
+        }
+    }
+    return false;
+}
+
+void RunWorker(const BenchmarkConfig& config, std::vector<Session>& sessions,
+               const std::atomic<bool>& stop, WorkerResult& result) {
+    RelayProtocol protocol;
+    const int epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+    for (auto& session : sessions) {
+        for (auto& peer : session.peers) {
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.fd = peer.socket;
+            ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, peer.socket, &event);
+        }
+    }
+
+    const size_t frame_size = sizeof(ModelA::RelayHeader) + config.payload_size;
+    std::vector<uint8_t> frame(frame_size, 0);
+    std::vector<uint8_t> receive_buffer(RelayReactor::MAX_DATAGRAM_SIZE);
+    std::array<epoll_event, 256> events{};
+
+    const int64_t interval_us = 1000000 / config.rate_hz;
+    int64_t next_tick_us = NowUs();
+    while (!stop.load(std::memory_order_relaxed)) {
+        const int64_t now_us = NowUs();
+        if (now_us >= next_tick_us) {
+            // Every peer of every session sends one game packet per tick
+            for (auto& session : sessions) {
+                for (auto& peer : session.peers) {
+                    protocol.WriteHeader(frame, session.token,
+                                         static_cast<uint16_t>(config.payload_size),
+                                         RelayProtocol::FLAG_DATA, peer.sequence++);
+                    const int64_t timestamp = NowUs();
+                    std::memcpy(frame.data() + sizeof(ModelA::RelayHeader), &timestamp,
+                                std::min(sizeof(timestamp), config.payload_size));
+                    if (::send(peer.socket, frame.data(), frame.size(), MSG_DONTWAIT) > 0) {
+                        ++result.sent;
+                    }
+                }
+            }
+            next_tick_us += interval_us;
+        }
+
+        const int timeout_ms =
+            static_cast<int>(std::max<int64_t>(0, (next_tick_us - NowUs()) / 1000));
+        const int count = ::epoll_wait(epoll_fd, events.data(), static_cast<int>(events.size()),
+                                       timeout_ms);
+        for (int i = 0; i < count; ++i) {
+            ssize_t size;
+            while ((size = ::recv(events[i].data.fd, receive_buffer.data(), receive_buffer.size(),
+                                  MSG_DONTWAIT)) > 0) {
+                RelayHeaderView header;
+                if (!protocol.ValidateMessage(receive_buffer.data(), static_cast<size_t>(size),
+                                              &header) ||
+                    header.flags != RelayProtocol::FLAG_DATA) {
+                    continue;
+                }
+                ++result.received;
+                if (header.payload.size() >= sizeof(int64_t)) {
+                    int64_t timestamp = 0;
+                    std::memcpy(&timestamp, header.payload.data(), sizeof(timestamp));
+                    result.latency.Add(NowUs() - timestamp);
+                }
+            }
+        }
+    }
+    ::close(epoll_fd);
+}
+
+bool ParseArguments(int argc, char** argv, BenchmarkConfig& config) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string option = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (option == "--server" && has_value) {
+            const std::string endpoint = argv[++i];
+            const size_t colon = endpoint.rfind(':');
+            if (colon == std::string::npos) {
+                return false;
+            }
+            config.server_host = endpoint.substr(0, colon);
+            config.server_port =
+                static_cast<uint16_t>(std::strtoul(endpoint.c_str() + colon + 1, nullptr, 10));
+        } else if (option == "--sessions" && has_value) {
+            config.sessions = std::strtoul(argv[++i], nullptr, 10);
+        } else if (option == "--threads" && has_value) {
+            config.client_threads = std::max<size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+        } else if (option == "--reactors" && has_value) {
+            config.server_reactors = std::strtoul(argv[++i], nullptr, 10);
+        } else if (option == "--rate" && has_value) {
+            config.rate_hz = std::max(1u, static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10)));
+        } else if (option == "--payload" && has_value) {
+            config.payload_size = std::min<size_t>(std::strtoul(argv[++i], nullptr, 10), 1400);
+        } else if (option == "--duration" && has_value) {
+            config.duration_seconds = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+void RaiseDescriptorLimit(size_t needed) {
+    rlimit limit{};
+    if (::getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < needed) {
+        limit.rlim_cur = std::min<rlim_t>(limit.rlim_max, needed);
+        ::setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    BenchmarkConfig config;
+    if (!ParseArguments(argc, argv, config)) {
+        std::fprintf(stderr,
+                     "Usage: %s [--server HOST:PORT] [--sessions N] [--threads N] [--reactors N]\n"
+                     "          [--rate HZ] [--payload BYTES] [--duration SECONDS]\n",
+                     argv[0]);
+        return EXIT_FAILURE;
+    }
+    RaiseDescriptorLimit(config.sessions * 2 + 64);
+
+    std::unique_ptr<RelayServer> server;
+    if (config.server_port == 0) {
+        RelayServerConfig server_config;
+        server_config.bind_address = config.server_host;
+        server_config.port = 0;
+        server_config.reactor_count = config.server_reactors;
+        server_config.max_sessions = config.sessions;
+        // Every simulated client shares the loopback address
+        server_config.ddos.max_connections_per_ip = config.sessions * 2;
+        server_config.ddos.max_total_connections = config.sessions * 2;
+        server = std::make_unique<RelayServer>(server_config);
+        if (server->Start() != ErrorCode::Success) {
+            std::fprintf(stderr, "Failed to start the in-process relay server\n");
+            return EXIT_FAILURE;
+        }
+        config.server_port = server->GetPort();
+    }
+
+    sockaddr_in server_address{};
+    server_address.sin_family = AF_INET;
+    server_address.sin_port = htons(config.server_port);
+    if (::inet_pton(AF_INET, config.server_host.c_str(), &server_address.sin_addr) != 1) {
+        std::fprintf(stderr, "Invalid server address %s\n", config.server_host.c_str());
+        return EXIT_FAILURE;
+    }
+
+    // Sessions are set up one at a time, before any traffic flows
+    RelayProtocol protocol;
+    std::vector<std::vector<Session>> slices(config.client_threads);
+    const auto setup_start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < config.sessions; ++i) {
+        Session session;
+        session.token = static_cast<uint32_t>(0x10000 + i);
+        for (auto& peer : session.peers) {
+            peer.socket = OpenClientSocket(server_address);
+            if (peer.socket < 0) {
+                std::fprintf(stderr, "Out of sockets after %zu sessions\n", i);
+                return EXIT_FAILURE;
+            }
+        }
+        if (!RequestSession(protocol, session.peers[0], session.token,
+                            RelayProtocol::FLAG_SESSION_CREATE) ||
+            !RequestSession(protocol, session.peers[1], session.token,
+                            RelayProtocol::FLAG_SESSION_JOIN)) {
+            std::fprintf(stderr, "Session %zu was refused\n", i);
+            return EXIT_FAILURE;
+        }
+        slices[i % config.client_threads].push_back(session);
+    }
+    const auto setup_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - setup_start);
+    std::printf("Set up %zu sessions in %lld ms\n", config.sessions,
+                static_cast<long long>(setup_time.count()));
+
+    std::atomic<bool> stop{false};
+    std::vector<WorkerResult> results(config.client_threads);
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < config.client_threads; ++i) {
+        workers.emplace_back(
+            [&, i] { RunWorker(config, slices[i], stop, results[i]); });
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(config.duration_seconds));
+    stop = true;
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    WorkerResult total;
+    for (const auto& result : results) {
+        total.sent += result.sent;
+        total.received += result.received;
+        total.latency.Merge(result.latency);
+    }
+    const double seconds = std::max(1u, config.duration_seconds);
+    const double loss = total.sent == 0 ? 0.0
+                                        : 100.0 * (1.0 - static_cast<double>(total.received) /
+                                                             static_cast<double>(total.sent));
+    std::printf("Sessions %zu, %u Hz, %zu-byte payloads, %u s\n", config.sessions, config.rate_hz,
+                config.payload_size, config.duration_seconds);
+    std::printf("Sent %llu, received %llu (%.0f packets/s relayed), loss %.3f%%\n",
+                static_cast<unsigned long long>(total.sent),
+                static_cast<unsigned long long>(total.received),
+                static_cast<double>(total.received) / seconds, loss);
+    std::printf("Latency p50 %lld us, p99 %lld us, p99.9 %lld us\n",
+                static_cast<long long>(total.latency.PercentileUs(0.50)),
+                static_cast<long long>(total.latency.PercentileUs(0.99)),
+                static_cast<long long>(total.latency.PercentileUs(0.999)));
+
+    if (server) {
+        const RelayServerStatistics statistics = server->GetStatistics();
+        std::printf("Server: %zu reactors, received %llu, sent %llu, rate limited %llu, "
+                    "send errors %llu\n",
+                    server->GetReactorCount(),
+                    static_cast<unsigned long long>(statistics.datagrams_received),
+                    static_cast<unsigned long long>(statistics.datagrams_sent),
+                    static_cast<unsigned long long>(statistics.rate_limited_dropped),
+                    static_cast<unsigned long long>(statistics.send_errors));
+        server->Stop();
+    }
+
+    for (auto& slice : slices) {
+        for (auto& session : slice) {
+            for (auto& peer : session.peers) {
+                ::close(peer.socket);
+            }
+        }
+    }
+    return EXIT_SUCCESS;
+}
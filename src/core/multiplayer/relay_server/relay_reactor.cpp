@@ -0,0 +1,605 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "relay_reactor.h"
+
+#include <chrono>
+#include <cerrno>
+
+#include <arpa/inet.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "core/multiplayer/common/monotonic_clock.h"
+#include "core/multiplayer/common/socket_tuning.h"
+
+namespace Core::Multiplayer::Relay {
+
+using ModelA::RelayHeaderView;
+using ModelA::RelayProtocol;
+
+namespace {
+constexpr uint8_t SESSION_FLAGS = RelayProtocol::FLAG_SESSION_CREATE |
+                                  RelayProtocol::FLAG_SESSION_JOIN;
+
+int64_t NowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+uint64_t NowUs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+}
+
+RelayEndpoint ToEndpoint(const sockaddr_in& address) {
+    return RelayEndpoint{address.sin_addr.s_addr, address.sin_port};
+}
+
+sockaddr_in ToSockaddr(const RelayEndpoint& endpoint) {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = endpoint.address;
+    address.sin_port = endpoint.port;
+    return address;
+}
+} // namespace
+
+RelayReactor::RelayReactor(size_t index, const RelayReactorContext& context)
+    : index_(index), context_(context),
+      receive_buffers_(std::make_unique<std::array<uint8_t, MAX_DATAGRAM_SIZE>[]>(BATCH_SIZE)) {
+    for (size_t i = 0; i < BATCH_SIZE; ++i) {
+        receive_iovecs_[i] = {receive_buffers_[i].data(), MAX_DATAGRAM_SIZE};
+        receive_messages_[i].msg_hdr.msg_iov = &receive_iovecs_[i];
+        receive_messages_[i].msg_hdr.msg_iovlen = 1;
+        receive_messages_[i].msg_hdr.msg_name = &receive_addresses_[i];
+    }
+    for (size_t i = 0; i < MAX_SENDS; ++i) {
+        send_messages_[i].msg_hdr.msg_iov = &send_iovecs_[i];
+        send_messages_[i].msg_hdr.msg_iovlen = 1;
+        send_messages_[i].msg_hdr.msg_name = &send_addresses_[i];
+        send_messages_[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+    }
+}
+
+RelayReactor::~RelayReactor() {
+    Stop();
+}
+
+ErrorCode RelayReactor::Open(uint16_t port) {
+    if (socket_ >= 0) {
+        return ErrorCode::InvalidState;
+    }
+    socket_ = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (socket_ < 0) {
+        return ErrorCode::NetworkError;
+    }
+
+    const int enable = 1;
+    ::setsockopt(socket_, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    if (::setsockopt(socket_, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) != 0) {
+        Stop();
+        return ErrorCode::PlatformFeatureUnavailable;
+    }
+    // Best effort; bursts from thousands of clients outrun the default
+    // buffers, and relayed packets keep the clients' EF marking
+    SocketTuningProfile tuning;
+    tuning.send_buffer_size = context_.config.socket_buffer_size;
+    tuning.receive_buffer_size = context_.config.socket_buffer_size;
+    tuning.traffic_class = TrafficClass::Interactive;
+    ApplySocketTuning(socket_, tuning);
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    if (::inet_pton(AF_INET, context_.config.bind_address.c_str(), &address.sin_addr) != 1) {
+        Stop();
+        return ErrorCode::ConfigurationInvalid;
+    }
+    if (::bind(socket_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        Stop();
+        return ErrorCode::ConnectionRefused;
+    }
+
+    epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+    wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epoll_fd_ < 0 || wake_fd_ < 0) {
+        Stop();
+        return ErrorCode::ResourceExhausted;
+    }
+    epoll_event socket_event{};
+    socket_event.events = EPOLLIN;
+    socket_event.data.fd = socket_;
+    epoll_event wake_event{};
+    wake_event.events = EPOLLIN;
+    wake_event.data.fd = wake_fd_;
+    if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, socket_, &socket_event) != 0 ||
+        ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &wake_event) != 0) {
+        Stop();
+        return ErrorCode::ResourceExhausted;
+    }
+    return ErrorCode::Success;
+}
+
+void RelayReactor::Start() {
+    stop_requested_.store(false, std::memory_order_release);
+    thread_ = std::thread([this] { Run(); });
+    if (context_.config.pin_reactors) {
+        const unsigned cores = std::thread::hardware_concurrency();
+        if (cores != 0) {
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            CPU_SET(index_ % cores, &cpus);
+            // Best effort; an unpinned reactor still works
+            pthread_setaffinity_np(thread_.native_handle(), sizeof(cpus), &cpus);
+        }
+    }
+}
+
+void RelayReactor::Stop() {
+    stop_requested_.store(true, std::memory_order_release);
+    if (wake_fd_ >= 0) {
+        const uint64_t wake = 1;
+        [[maybe_unused]] const ssize_t written = ::write(wake_fd_, &wake, sizeof(wake));
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    for (int* fd : {&socket_, &epoll_fd_, &wake_fd_}) {
+        if (*fd >= 0) {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
+}
+
+uint16_t RelayReactor::GetLocalPort() const {
+    if (socket_ < 0) {
+        return 0;
+    }
+    sockaddr_in address{};
+    socklen_t length = sizeof(address);
+    if (::getsockname(socket_, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        return 0;
+    }
+    return ntohs(address.sin_port);
+}
+
+RelayServerStatistics RelayReactor::GetStatistics() const {
+    RelayServerStatistics statistics;
+    statistics.datagrams_received = counters_.datagrams_received.load(std::memory_order_relaxed);
+    statistics.bytes_received = counters_.bytes_received.load(std::memory_order_relaxed);
+    statistics.datagrams_sent = counters_.datagrams_sent.load(std::memory_order_relaxed);
+    statistics.bytes_sent = counters_.bytes_sent.load(std::memory_order_relaxed);
+    statistics.malformed_dropped = counters_.malformed_dropped.load(std::memory_order_relaxed);
+    statistics.rate_limited_dropped =
+        counters_.rate_limited_dropped.load(std::memory_order_relaxed);
+    statistics.unknown_session_dropped =
+        counters_.unknown_session_dropped.load(std::memory_order_relaxed);
+    statistics.multicast_frames = counters_.multicast_frames.load(std::memory_order_relaxed);
+    statistics.send_errors = counters_.send_errors.load(std::memory_order_relaxed);
+    statistics.sessions_created = counters_.sessions_created.load(std::memory_order_relaxed);
+    statistics.sessions_joined = counters_.sessions_joined.load(std::memory_order_relaxed);
+    statistics.sessions_resumed = counters_.sessions_resumed.load(std::memory_order_relaxed);
+    statistics.session_requests_refused =
+        counters_.session_requests_refused.load(std::memory_order_relaxed);
+    statistics.spectators_subscribed =
+        counters_.spectators_subscribed.load(std::memory_order_relaxed);
+    statistics.spectate_requests_refused =
+        counters_.spectate_requests_refused.load(std::memory_order_relaxed);
+    statistics.spectator_frames = counters_.spectator_frames.load(std::memory_order_relaxed);
+    return statistics;
+}
+
+void RelayReactor::SendUpstream(uint32_t session_token, uint8_t flags, uint8_t extended_flags) {
+    if (context_.upstream.port == 0) {
+        return;
+    }
+    std::array<uint8_t, sizeof(ModelA::RelayHeader)> message{};
+    protocol_.WriteHeader(message, session_token, 0, flags, 0, extended_flags);
+    SendNow(context_.upstream, message);
+}
+
+void RelayReactor::Run() {
+    std::array<epoll_event, 2> events{};
+    while (!stop_requested_.load(std::memory_order_acquire)) {
+        const int count = ::epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()), -1);
+        if (count < 0 && errno != EINTR) {
+            break;
+        }
+        for (int i = 0; i < count; ++i) {
+            if (events[i].data.fd == socket_) {
+                ReceiveBatch();
+            }
+        }
+    }
+}
+
+void RelayReactor::ReceiveBatch() {
+    // Drain what is queued, but come back to epoll so Stop is noticed under load
+    constexpr size_t MAX_BATCHES_PER_WAKEUP = 16;
+    for (size_t batch = 0; batch < MAX_BATCHES_PER_WAKEUP; ++batch) {
+        for (auto& message : receive_messages_) {
+            message.msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        }
+        const int count = ::recvmmsg(socket_, receive_messages_.data(), BATCH_SIZE,
+                                     MSG_DONTWAIT, nullptr);
+        if (count <= 0) {
+            return;
+        }
+
+        const uint64_t batch_start = MonotonicClock::Now();
+        const int64_t now_ms = NowMs();
+        counters_.datagrams_received.fetch_add(count, std::memory_order_relaxed);
+        size_t bytes_received = 0;
+        for (int i = 0; i < count; ++i) {
+            const auto& message = receive_messages_[i];
+            bytes_received += message.msg_len;
+            if ((message.msg_hdr.msg_flags & MSG_TRUNC) != 0 ||
+                message.msg_hdr.msg_namelen != sizeof(sockaddr_in)) {
+                counters_.malformed_dropped.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            HandleDatagram(static_cast<size_t>(i), message.msg_len, now_ms);
+        }
+        FlushSends();
+        counters_.bytes_received.fetch_add(bytes_received, std::memory_order_relaxed);
+        const uint64_t batch_end = MonotonicClock::Now();
+        context_.batch_latency.Record(batch_end > batch_start ? batch_end - batch_start : 0);
+
+        if (static_cast<size_t>(count) < BATCH_SIZE) {
+            return;
+        }
+    }
+}
+
+void RelayReactor::HandleDatagram(size_t index, size_t size, int64_t now_ms) {
+    const RelayEndpoint from = ToEndpoint(receive_addresses_[index]);
+    RelayHeaderView header;
+    if (!protocol_.ValidateMessage(receive_buffers_[index].data(), size, &header)) {
+        counters_.malformed_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (context_.upstream.port != 0 && from == context_.upstream) {
+        HandleUpstream(header, index, size);
+        return;
+    }
+
+    const std::string& client_id = GetClientId(from);
+    if (!context_.ddos_protection.CheckGlobalPacketRate() ||
+        !context_.rate_manager.CheckPacketRateLimit(client_id) ||
+        !context_.rate_manager.CheckByteRateLimit(client_id, size)) {
+        counters_.rate_limited_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Same precedence as RelayClient::HandleIncomingFrame
+    const bool spectate = (header.extended_flags & RelayProtocol::EXT_FLAG_SPECTATE) != 0;
+    if ((header.flags & RelayProtocol::FLAG_KEEPALIVE) != 0) {
+        HandleKeepalive(header, from, index, now_ms);
+    } else if ((header.flags & SESSION_FLAGS) == RelayProtocol::FLAG_SESSION_JOIN && spectate) {
+        HandleSpectateRequest(header, from, index, now_ms);
+    } else if ((header.flags & SESSION_FLAGS) != 0) {
+        HandleSessionRequest(header, from, index, now_ms);
+    } else if ((header.flags & RelayProtocol::FLAG_SESSION_LEAVE) != 0) {
+        if (spectate) {
+            HandleSpectateLeave(header, from);
+        } else {
+            HandleSessionLeave(header, from);
+        }
+    } else if (header.flags == RelayProtocol::FLAG_DATA) {
+        ForwardData(header, from, index, size, now_ms);
+    }
+}
+
+void RelayReactor::HandleSessionRequest(const RelayHeaderView& header, const RelayEndpoint& from,
+                                        size_t index, int64_t now_ms) {
+    const uint8_t request = header.flags & SESSION_FLAGS;
+    // A resume joins the session, or creates it for the first peer to fail over
+    const bool resume = request == RelayProtocol::FLAG_SESSION_RESUME;
+    const bool create = request == RelayProtocol::FLAG_SESSION_CREATE;
+    const bool offered_compression =
+        (header.extended_flags & RelayProtocol::EXT_FLAG_COMPRESSED) != 0;
+    const uint8_t node_id =
+        header.payload.empty() ? RelayProtocol::NO_NODE_ID : header.payload[0];
+
+    bool compressed = false;
+    const auto join = [&] {
+        bool session_compressed = false;
+        const SessionResult joined = context_.sessions.Join(header.session_token, from, now_ms,
+                                                            session_compressed, node_id);
+        // A joiner that did not offer still decodes compressed frames; it just sends plain ones
+        compressed = session_compressed && offered_compression;
+        return joined;
+    };
+    const auto create_session = [&] {
+        compressed = offered_compression && context_.config.allow_compression;
+        return context_.sessions.Create(header.session_token, from, compressed, now_ms, node_id);
+    };
+
+    SessionResult result;
+    if (create) {
+        result = create_session();
+    } else {
+        result = join();
+        if (resume && result == SessionResult::NotFound) {
+            result = create_session();
+            if (result == SessionResult::AlreadyExists) {
+                result = join(); // Another peer resumed it in between
+            }
+        }
+    }
+    if (result == SessionResult::Accepted && !AdmitPeer(header.session_token, from)) {
+        result = SessionResult::SessionFull;
+    }
+
+    const bool accepted = result == SessionResult::Accepted || result == SessionResult::AlreadyMember;
+    if (result == SessionResult::Accepted) {
+        auto& counter = resume   ? counters_.sessions_resumed
+                        : create ? counters_.sessions_created
+                                 : counters_.sessions_joined;
+        counter.fetch_add(1, std::memory_order_relaxed);
+    } else if (!accepted) {
+        counters_.session_requests_refused.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Answered with the request's flags; FLAG_CONTROL marks a refusal
+    uint8_t flags = request;
+    if (!accepted) {
+        flags |= RelayProtocol::FLAG_CONTROL;
+    }
+    const uint8_t extended_flags = accepted && compressed ? RelayProtocol::EXT_FLAG_COMPRESSED : 0;
+    const size_t written = protocol_.WriteHeader(reply_buffers_[index], header.session_token, 0,
+                                                 flags, header.sequence_num, extended_flags);
+    QueueReply(index, from, written);
+}
+
+void RelayReactor::HandleSessionLeave(const RelayHeaderView& header, const RelayEndpoint& from) {
+    if (context_.sessions.Leave(header.session_token, from)) {
+        context_.ddos_protection.RemoveConnection(IpAddressKey::FromIPv4(from.address));
+    }
+}
+
+void RelayReactor::HandleSpectateRequest(const RelayHeaderView& header, const RelayEndpoint& from,
+                                         size_t index, int64_t now_ms) {
+    // Sessions this relay does not carry are spectated through the upstream
+    const bool local = context_.sessions.Contains(header.session_token);
+    const bool upstream = !local && context_.upstream.port != 0;
+    bool first = false;
+    SpectateResult result = SpectateResult::NotFound;
+    if (local || upstream) {
+        result = context_.spectators.Subscribe(header.session_token, from, now_ms, upstream, first);
+    }
+    if (first && upstream) {
+        SendUpstream(header.session_token, RelayProtocol::FLAG_SESSION_JOIN,
+                     RelayProtocol::EXT_FLAG_SPECTATE);
+    }
+
+    const bool accepted =
+        result == SpectateResult::Accepted || result == SpectateResult::AlreadySubscribed;
+    if (result == SpectateResult::Accepted) {
+        counters_.spectators_subscribed.fetch_add(1, std::memory_order_relaxed);
+    } else if (!accepted) {
+        counters_.spectate_requests_refused.fetch_add(1, std::memory_order_relaxed);
+    }
+    uint8_t flags = RelayProtocol::FLAG_SESSION_JOIN;
+    if (!accepted) {
+        flags |= RelayProtocol::FLAG_CONTROL;
+    }
+    const size_t written =
+        protocol_.WriteHeader(reply_buffers_[index], header.session_token, 0, flags,
+                              header.sequence_num, RelayProtocol::EXT_FLAG_SPECTATE);
+    QueueReply(index, from, written);
+    if (!accepted || !context_.spectators.GetSnapshot(header.session_token, snapshot_scratch_)) {
+        return;
+    }
+    // A late joiner starts from the latest snapshot, sent after the answer
+    FlushSends();
+    for (const auto& datagram : snapshot_scratch_) {
+        SendNow(from, datagram);
+    }
+    counters_.spectator_frames.fetch_add(snapshot_scratch_.size(), std::memory_order_relaxed);
+}
+
+void RelayReactor::HandleSpectateLeave(const RelayHeaderView& header, const RelayEndpoint& from) {
+    bool upstream = false;
+    if (context_.spectators.Unsubscribe(header.session_token, from, upstream) && upstream) {
+        SendUpstream(header.session_token, RelayProtocol::FLAG_SESSION_LEAVE,
+                     RelayProtocol::EXT_FLAG_SPECTATE);
+    }
+}
+
+void RelayReactor::HandleUpstream(const RelayHeaderView& header, size_t index, size_t size) {
+    // Answers to this relay's own requests and keepalives need no handling
+    if (header.flags == RelayProtocol::FLAG_DATA &&
+        (header.extended_flags & RelayProtocol::EXT_FLAG_SPECTATE) != 0) {
+        FanOutToSpectators(header, index, size);
+    }
+}
+
+void RelayReactor::HandleKeepalive(const RelayHeaderView& header, const RelayEndpoint& from,
+                                   size_t index, int64_t now_ms) {
+    if (header.session_token != 0) {
+        RelaySessionTable::PeerList ignored;
+        const RouteResult result =
+            context_.sessions.Route(header.session_token, from, now_ms, ignored);
+        // Spectators keep their subscription, and this relay's upstream one, alive the same way
+        const int64_t upstream_refresh_ms = context_.config.peer_idle_timeout.count() / 3;
+        if (result != RouteResult::Routed &&
+            context_.spectators.Touch(header.session_token, from, now_ms, upstream_refresh_ms)) {
+            SendUpstream(header.session_token, RelayProtocol::FLAG_KEEPALIVE, 0);
+        }
+    }
+
+    uint64_t timestamp_us = 0;
+    uint64_t echo_timestamp_us = 0;
+    const bool timestamped =
+        RelayProtocol::ParseKeepalivePayload(header.payload, timestamp_us, echo_timestamp_us);
+    if (timestamped && timestamp_us == 0) {
+        return; // A reply; replies are never answered
+    }
+
+    // Echo the sequence, and the timestamp if there is one, so probes match
+    // their answer; our clock lets clients synchronize to the relay's
+    auto& reply = reply_buffers_[index];
+    size_t payload_size = 0;
+    if (timestamped) {
+        payload_size = RelayProtocol::WriteKeepalivePayload(
+            std::span<uint8_t>(reply).subspan(sizeof(ModelA::RelayHeader)), 0, timestamp_us,
+            NowUs());
+    }
+    const size_t written =
+        protocol_.WriteHeader(reply, header.session_token, static_cast<uint16_t>(payload_size),
+                              RelayProtocol::FLAG_KEEPALIVE, header.sequence_num);
+    QueueReply(index, from, written + payload_size);
+}
+
+void RelayReactor::ForwardData(const RelayHeaderView& header, const RelayEndpoint& from,
+                               size_t index, size_t size, int64_t now_ms) {
+    uint8_t destination_mask = RelayProtocol::MULTICAST_ALL_NODES;
+    if ((header.extended_flags & RelayProtocol::EXT_FLAG_MULTICAST) != 0) {
+        if (header.payload.size() < RelayProtocol::MULTICAST_HEADER_SIZE) {
+            counters_.malformed_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        destination_mask = header.payload[0];
+        counters_.multicast_frames.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    RelaySessionTable::PeerList peers;
+    RouteResult result =
+        context_.sessions.Route(header.session_token, from, now_ms, peers, destination_mask);
+    // A spectator that sends data is not taken for a migrated member
+    if (result == RouteResult::NotMember &&
+        !context_.spectators.IsSubscribed(header.session_token, from) &&
+        AdoptPeer(header.session_token, from, now_ms)) {
+        result =
+            context_.sessions.Route(header.session_token, from, now_ms, peers, destination_mask);
+    }
+    if (result != RouteResult::Routed) {
+        counters_.unknown_session_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    const uint8_t spectate = header.extended_flags & (RelayProtocol::EXT_FLAG_SPECTATE |
+                                                      RelayProtocol::EXT_FLAG_SNAPSHOT);
+    // Snapshots are for spectators only
+    if (spectate != (RelayProtocol::EXT_FLAG_SPECTATE | RelayProtocol::EXT_FLAG_SNAPSHOT)) {
+        const uint8_t* datagram = receive_buffers_[index].data();
+        for (size_t i = 0; i < peers.count; ++i) {
+            QueueSend(peers.peers[i], datagram, size);
+        }
+    }
+    if ((spectate & RelayProtocol::EXT_FLAG_SPECTATE) != 0) {
+        FanOutToSpectators(header, index, size);
+    }
+}
+
+void RelayReactor::FanOutToSpectators(const RelayHeaderView& header, size_t index, size_t size) {
+    const uint8_t* datagram = receive_buffers_[index].data();
+    if ((header.extended_flags & RelayProtocol::EXT_FLAG_SNAPSHOT) != 0 &&
+        !context_.spectators.StoreSnapshot(header.session_token, header.sequence_num,
+                                           std::span<const uint8_t>(datagram, size))) {
+        return; // Nobody is watching
+    }
+    const size_t count = context_.spectators.CopySpectators(header.session_token, spectator_scratch_);
+    for (const auto& spectator : spectator_scratch_) {
+        QueueSend(spectator, datagram, size);
+    }
+    counters_.spectator_frames.fetch_add(count, std::memory_order_relaxed);
+}
+
+bool RelayReactor::AdoptPeer(uint32_t session_token, const RelayEndpoint& from, int64_t now_ms) {
+    // The relay identifies sessions by token, so a client that changed
+    // address keeps its session; its old address idles out
+    bool compressed = false;
+    if (context_.sessions.Join(session_token, from, now_ms, compressed) !=
+        SessionResult::Accepted) {
+        return false;
+    }
+    if (!AdmitPeer(session_token, from)) {
+        return false;
+    }
+    counters_.sessions_joined.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool RelayReactor::AdmitPeer(uint32_t session_token, const RelayEndpoint& peer) {
+    const IpAddressKey address = IpAddressKey::FromIPv4(peer.address);
+    if (!context_.ddos_protection.AllowNewConnection(address)) {
+        context_.sessions.Leave(session_token, peer);
+        return false;
+    }
+    context_.ddos_protection.RegisterConnection(address);
+    return true;
+}
+
+void RelayReactor::QueueSend(const RelayEndpoint& to, const uint8_t* data, size_t size) {
+    if (send_count_ == MAX_SENDS) {
+        FlushSends();
+    }
+    send_addresses_[send_count_] = ToSockaddr(to);
+    send_iovecs_[send_count_] = {const_cast<uint8_t*>(data), size};
+    ++send_count_;
+}
+
+void RelayReactor::QueueReply(size_t index, const RelayEndpoint& to, size_t size) {
+    if (size != 0) {
+        QueueSend(to, reply_buffers_[index].data(), size);
+    }
+}
+
+void RelayReactor::FlushSends() {
+    size_t sent = 0;
+    while (sent < send_count_) {
+        const int count = ::sendmmsg(socket_, send_messages_.data() + sent,
+                                     static_cast<unsigned int>(send_count_ - sent), MSG_DONTWAIT);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // The head message failed (full buffer, unreachable peer); skip it
+            counters_.send_errors.fetch_add(1, std::memory_order_relaxed);
+            ++sent;
+            continue;
+        }
+        for (int i = 0; i < count; ++i) {
+            counters_.bytes_sent.fetch_add(send_iovecs_[sent + i].iov_len,
+                                                std::memory_order_relaxed);
+        }
+        counters_.datagrams_sent.fetch_add(count, std::memory_order_relaxed);
+        sent += static_cast<size_t>(count);
+    }
+    send_count_ = 0;
+}
+
+void RelayReactor::SendNow(const RelayEndpoint& to, std::span<const uint8_t> datagram) {
+    const sockaddr_in address = ToSockaddr(to);
+    const ssize_t sent =
+        ::sendto(socket_, datagram.data(), datagram.size(), MSG_DONTWAIT,
+                 reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+    if (sent < 0) {
+        counters_.send_errors.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    counters_.datagrams_sent.fetch_add(1, std::memory_order_relaxed);
+    counters_.bytes_sent.fetch_add(static_cast<size_t>(sent), std::memory_order_relaxed);
+}
+
+const std::string& RelayReactor::GetClientId(const RelayEndpoint& endpoint) {
+    if (client_ids_.size() >= CLIENT_ID_CACHE_LIMIT) {
+        client_ids_.clear();
+    }
+    const auto [it, inserted] = client_ids_.try_emplace(endpoint.Key());
+    if (inserted) {
+        it->second = endpoint.ToString();
+    }
+    return it->second;
+}
+
+} // namespace Core::Multiplayer::Relay
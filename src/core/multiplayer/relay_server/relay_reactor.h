@@ -0,0 +1,183 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include "core/multiplayer/common/error_codes.h"
+#include "core/multiplayer/common/latency_histogram.h"
+#include "core/multiplayer/common/network_security.h"
+#include "core/multiplayer/model_a/relay_protocol.h"
+#include "relay_server_types.h"
+#include "relay_session_table.h"
+#include "relay_spectator_table.h"
+
+namespace Core::Multiplayer::Relay {
+
+/**
+ * Shared state every reactor of a server works against
+ */
+struct RelayReactorContext {
+    const RelayServerConfig& config;
+    RelaySessionTable& sessions;
+    Security::ClientRateManager& rate_manager;
+    Security::DDoSProtection& ddos_protection;
+    RelaySpectatorTable& spectators;
+    // Time from a batch's recvmmsg returning to its sendmmsg completing
+    LatencyHistogram& batch_latency;
+    // Relay that spectated sessions not carried here come from; port 0 for none
+    RelayEndpoint upstream;
+};
+
+/**
+ * One event loop thread of the relay server.
+ *
+ * Each reactor owns a UDP socket bound to the server port with SO_REUSEPORT,
+ * so the kernel spreads clients over the reactors by their address and a
+ * client always reaches the same one. A reactor waits on epoll, takes up to
+ * BATCH_SIZE datagrams with one recvmmsg and sends everything they produce
+ * with one sendmmsg. Forwarded datagrams are sent straight from the receive
+ * buffers, header included: the relay only reads the session token, so a
+ * packet is never copied between the two sockets.
+ *
+ * The peers of a session may sit on different reactors; any reactor's
+ * socket can reach them, because all share the server port.
+ *
+ * Frames members flag for spectators are also copied to the session's
+ * spectators from the same receive buffer. Datagrams from the upstream
+ * relay skip the client rate limits: they carry a whole session's
+ * spectator stream, and the upstream only sends what this relay asked for.
+ */
+class RelayReactor {
+public:
+    static constexpr size_t BATCH_SIZE = 32;
+    static constexpr size_t MAX_DATAGRAM_SIZE = 65536;
+
+    RelayReactor(size_t index, const RelayReactorContext& context);
+    ~RelayReactor();
+
+    RelayReactor(const RelayReactor&) = delete;
+    RelayReactor& operator=(const RelayReactor&) = delete;
+
+    /**
+     * Binds the socket; port 0 binds an ephemeral one
+     */
+    ErrorCode Open(uint16_t port);
+    // Starts the event loop on its own thread
+    void Start();
+    // Stops the event loop and closes the socket
+    void Stop();
+
+    // Port the socket is bound to, or 0 when closed
+    uint16_t GetLocalPort() const;
+    RelayServerStatistics GetStatistics() const;
+
+    /**
+     * Sends a header-only message for a session to the upstream relay.
+     * Safe from any thread: it bypasses the batched send path.
+     */
+    void SendUpstream(uint32_t session_token, uint8_t flags, uint8_t extended_flags);
+
+private:
+    struct alignas(64) Counters {
+        std::atomic<uint64_t> datagrams_received{0};
+        std::atomic<uint64_t> bytes_received{0};
+        std::atomic<uint64_t> datagrams_sent{0};
+        std::atomic<uint64_t> bytes_sent{0};
+        std::atomic<uint64_t> malformed_dropped{0};
+        std::atomic<uint64_t> rate_limited_dropped{0};
+        std::atomic<uint64_t> unknown_session_dropped{0};
+        std::atomic<uint64_t> multicast_frames{0};
+        std::atomic<uint64_t> send_errors{0};
+        std::atomic<uint64_t> sessions_created{0};
+        std::atomic<uint64_t> sessions_joined{0};
+        std::atomic<uint64_t> sessions_resumed{0};
+        std::atomic<uint64_t> session_requests_refused{0};
+        std::atomic<uint64_t> spectators_subscribed{0};
+        std::atomic<uint64_t> spectate_requests_refused{0};
+        std::atomic<uint64_t> spectator_frames{0};
+    };
+
+    // Header plus a keepalive payload: the largest message a reactor writes
+    static constexpr size_t REPLY_SIZE =
+        sizeof(ModelA::RelayHeader) + ModelA::RelayProtocol::KEEPALIVE_CLOCK_PAYLOAD_SIZE;
+    static constexpr size_t MAX_SENDS = BATCH_SIZE * (RelaySessionTable::MAX_SESSION_PEERS - 1);
+    static constexpr size_t CLIENT_ID_CACHE_LIMIT = 65536;
+
+    void Run();
+    void ReceiveBatch();
+    void HandleDatagram(size_t index, size_t size, int64_t now_ms);
+    void HandleSessionRequest(const ModelA::RelayHeaderView& header, const RelayEndpoint& from,
+                              size_t index, int64_t now_ms);
+    void HandleSessionLeave(const ModelA::RelayHeaderView& header, const RelayEndpoint& from);
+    void HandleSpectateRequest(const ModelA::RelayHeaderView& header, const RelayEndpoint& from,
+                               size_t index, int64_t now_ms);
+    void HandleSpectateLeave(const ModelA::RelayHeaderView& header, const RelayEndpoint& from);
+    // Traffic from the upstream relay; only spectator frames are used
+    void HandleUpstream(const ModelA::RelayHeaderView& header, size_t index, size_t size);
+    void HandleKeepalive(const ModelA::RelayHeaderView& header, const RelayEndpoint& from,
+                         size_t index, int64_t now_ms);
+    void ForwardData(const ModelA::RelayHeaderView& header, const RelayEndpoint& from,
+                     size_t index, size_t size, int64_t now_ms);
+    // Copies a spectator frame to the session's spectators, keeping snapshots
+    void FanOutToSpectators(const ModelA::RelayHeaderView& header, size_t index, size_t size);
+    // Joins a peer that reached the session from a new address, e.g. after migrating
+    bool AdoptPeer(uint32_t session_token, const RelayEndpoint& from, int64_t now_ms);
+    // Registers a newly added peer with DDoSProtection, or takes it back out
+    bool AdmitPeer(uint32_t session_token, const RelayEndpoint& peer);
+
+    void QueueSend(const RelayEndpoint& to, const uint8_t* data, size_t size);
+    void QueueReply(size_t index, const RelayEndpoint& to, size_t size);
+    void FlushSends();
+    // Unbatched send, for datagrams that do not live in a receive or reply buffer
+    void SendNow(const RelayEndpoint& to, std::span<const uint8_t> datagram);
+    const std::string& GetClientId(const RelayEndpoint& endpoint);
+
+    const size_t index_;
+    RelayReactorContext context_;
+    ModelA::RelayProtocol protocol_;
+
+    int socket_ = -1;
+    int epoll_fd_ = -1;
+    int wake_fd_ = -1;
+    std::atomic<bool> stop_requested_{false};
+    std::thread thread_;
+
+    // recvmmsg state; receive buffer i holds datagram i of the batch
+    std::unique_ptr<std::array<uint8_t, MAX_DATAGRAM_SIZE>[]> receive_buffers_;
+    std::array<mmsghdr, BATCH_SIZE> receive_messages_{};
+    std::array<iovec, BATCH_SIZE> receive_iovecs_{};
+    std::array<sockaddr_in, BATCH_SIZE> receive_addresses_{};
+    std::array<std::array<uint8_t, REPLY_SIZE>, BATCH_SIZE> reply_buffers_{};
+
+    // sendmmsg state, pointing into the receive and reply buffers
+    std::array<mmsghdr, MAX_SENDS> send_messages_{};
+    std::array<iovec, MAX_SENDS> send_iovecs_{};
+    std::array<sockaddr_in, MAX_SENDS> send_addresses_{};
+    size_t send_count_ = 0;
+
+    // Spectators a frame is copied to, and a snapshot for a new spectator
+    std::vector<RelayEndpoint> spectator_scratch_;
+    std::vector<std::vector<uint8_t>> snapshot_scratch_;
+
+    // Rate limiter keys; only this reactor's clients, so no lock
+    std::unordered_map<uint64_t, std::string> client_ids_;
+
+    Counters counters_;
+};
+
+} // namespace Core::Multiplayer::Relay
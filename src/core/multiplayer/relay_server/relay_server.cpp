@@ -0,0 +1,256 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "relay_server.h"
+
+#include <algorithm>
+#include <charconv>
+#include <string_view>
+#include <thread>
+
+#include <arpa/inet.h>
+
+namespace Core::Multiplayer::Relay {
+
+RelayServer::RelayServer(const RelayServerConfig& config, std::shared_ptr<TimerWheel> timer_wheel)
+    : config_(config), sessions_(config.max_sessions),
+      spectators_(config.max_sessions, config.max_spectators_per_session),
+      rate_manager_(config.rate_limits, timer_wheel), ddos_protection_(config.ddos, timer_wheel),
+      timer_wheel_(timer_wheel ? std::move(timer_wheel) : TimerWheel::GetShared()) {}
+
+RelayServer::~RelayServer() {
+    Stop();
+}
+
+ErrorCode RelayServer::Start() {
+    if (running_) {
+        return ErrorCode::InvalidState;
+    }
+
+    size_t reactor_count = config_.reactor_count;
+    if (reactor_count == 0) {
+        reactor_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    RelayEndpoint upstream;
+    if (!config_.spectator_upstream.empty() &&
+        !ParseEndpoint(config_.spectator_upstream, upstream)) {
+        return ErrorCode::ConfigurationInvalid;
+    }
+    const RelayReactorContext context{config_,     sessions_,      rate_manager_, ddos_protection_,
+                                      spectators_, batch_latency_, upstream};
+    reactors_.clear();
+    port_ = config_.port;
+    for (size_t i = 0; i < reactor_count; ++i) {
+        auto reactor = std::make_unique<RelayReactor>(i, context);
+        // The first socket settles an ephemeral port for the others
+        const ErrorCode result = reactor->Open(port_);
+        if (result != ErrorCode::Success) {
+            reactors_.clear();
+            port_ = 0;
+            return result;
+        }
+        port_ = reactor->GetLocalPort();
+        reactors_.push_back(std::move(reactor));
+    }
+
+    for (auto& reactor : reactors_) {
+        reactor->Start();
+    }
+    sweep_timer_ = timer_wheel_->ScheduleRepeating(SWEEP_INTERVAL, [this] { SweepNextShard(); });
+    running_ = true;
+    return ErrorCode::Success;
+}
+
+void RelayServer::Stop() {
+    if (!running_) {
+        return;
+    }
+    // Waits for an in-flight sweep, so the table outlives it
+    timer_wheel_->Cancel(sweep_timer_);
+    sweep_timer_ = TimerWheel::INVALID_TIMER_ID;
+    // Stopped reactors stay for GetStatistics until the next Start
+    for (auto& reactor : reactors_) {
+        reactor->Stop();
+    }
+    running_ = false;
+}
+
+RelayServerStatistics RelayServer::GetStatistics() const {
+    RelayServerStatistics total;
+    for (const auto& reactor : reactors_) {
+        const RelayServerStatistics statistics = reactor->GetStatistics();
+        total.datagrams_received += statistics.datagrams_received;
+        total.bytes_received += statistics.bytes_received;
+        total.datagrams_sent += statistics.datagrams_sent;
+        total.bytes_sent += statistics.bytes_sent;
+        total.malformed_dropped += statistics.malformed_dropped;
+        total.rate_limited_dropped += statistics.rate_limited_dropped;
+        total.unknown_session_dropped += statistics.unknown_session_dropped;
+        total.multicast_frames += statistics.multicast_frames;
+        total.send_errors += statistics.send_errors;
+        total.sessions_created += statistics.sessions_created;
+        total.sessions_joined += statistics.sessions_joined;
+        total.sessions_resumed += statistics.sessions_resumed;
+        total.session_requests_refused += statistics.session_requests_refused;
+        total.spectators_subscribed += statistics.spectators_subscribed;
+        total.spectate_requests_refused += statistics.spectate_requests_refused;
+        total.spectator_frames += statistics.spectator_frames;
+    }
+    total.peers_evicted = peers_evicted_.load(std::memory_order_relaxed);
+    total.spectators_evicted = spectators_evicted_.load(std::memory_order_relaxed);
+    total.active_sessions = sessions_.GetSessionCount();
+    total.active_spectators = spectators_.GetSpectatorCount();
+    return total;
+}
+
+void RelayServer::WriteMetrics(MetricsWriter& writer) const {
+    const RelayServerStatistics statistics = GetStatistics();
+    writer.Gauge("sudachi_relay_sessions", "Sessions with at least one peer",
+                 static_cast<double>(statistics.active_sessions));
+    writer.Gauge("sudachi_relay_spectators", "Subscribed spectators",
+                 static_cast<double>(statistics.active_spectators));
+    writer.Counter("sudachi_relay_datagrams_received_total", "Datagrams received",
+                   statistics.datagrams_received);
+    writer.Counter("sudachi_relay_bytes_received_total", "Bytes received",
+                   statistics.bytes_received);
+    writer.Counter("sudachi_relay_datagrams_sent_total", "Datagrams forwarded and replies sent",
+                   statistics.datagrams_sent);
+    writer.Counter("sudachi_relay_bytes_sent_total", "Bytes sent", statistics.bytes_sent);
+    writer.Counter("sudachi_relay_multicast_frames_total",
+                   "Data frames forwarded by destination mask", statistics.multicast_frames);
+    writer.Counter("sudachi_relay_spectator_frames_total", "Frame copies sent to spectators",
+                   statistics.spectator_frames);
+
+    constexpr std::string_view DROPPED = "sudachi_relay_dropped_total";
+    constexpr std::string_view DROPPED_HELP = "Datagrams received and dropped";
+    writer.Counter(DROPPED, DROPPED_HELP, statistics.malformed_dropped, {{"reason", "malformed"}});
+    writer.Counter(DROPPED, DROPPED_HELP, statistics.rate_limited_dropped,
+                   {{"reason", "rate_limited"}});
+    writer.Counter(DROPPED, DROPPED_HELP, statistics.unknown_session_dropped,
+                   {{"reason", "unknown_session"}});
+    writer.Counter("sudachi_relay_send_errors_total", "Datagrams the socket refused to send",
+                   statistics.send_errors);
+
+    constexpr std::string_view REQUESTS = "sudachi_relay_session_requests_total";
+    constexpr std::string_view REQUESTS_HELP = "Session requests by outcome";
+    writer.Counter(REQUESTS, REQUESTS_HELP, statistics.sessions_created, {{"result", "created"}});
+    writer.Counter(REQUESTS, REQUESTS_HELP, statistics.sessions_joined, {{"result", "joined"}});
+    writer.Counter(REQUESTS, REQUESTS_HELP, statistics.sessions_resumed, {{"result", "resumed"}});
+    writer.Counter(REQUESTS, REQUESTS_HELP, statistics.session_requests_refused,
+                   {{"result", "refused"}});
+    constexpr std::string_view SPECTATE = "sudachi_relay_spectate_requests_total";
+    constexpr std::string_view SPECTATE_HELP = "Spectate requests by outcome";
+    writer.Counter(SPECTATE, SPECTATE_HELP, statistics.spectators_subscribed,
+                   {{"result", "subscribed"}});
+    writer.Counter(SPECTATE, SPECTATE_HELP, statistics.spectate_requests_refused,
+                   {{"result", "refused"}});
+    constexpr std::string_view EVICTED = "sudachi_relay_evicted_total";
+    constexpr std::string_view EVICTED_HELP = "Peers and spectators evicted as idle";
+    writer.Counter(EVICTED, EVICTED_HELP, statistics.peers_evicted, {{"role", "peer"}});
+    writer.Counter(EVICTED, EVICTED_HELP, statistics.spectators_evicted, {{"role", "spectator"}});
+
+    const Security::RateLimitStatistics rate = rate_manager_.GetStatistics();
+    writer.Gauge("sudachi_relay_rate_limit_clients", "Clients tracked by the rate limiter",
+                 static_cast<double>(rate.tracked_clients));
+    writer.Counter("sudachi_relay_rate_limit_checked_total", "Packets checked by the rate limiter",
+                   rate.packets_checked);
+    writer.Counter("sudachi_relay_rate_limit_hits_total", "Packets over a client rate limit",
+                   rate.packets_limited);
+    writer.Counter("sudachi_relay_rate_limit_hit_bytes_total",
+                   "Bytes in packets over the client byte rate", rate.bytes_limited);
+
+    const Security::ProtectionStatistics protection = ddos_protection_.GetProtectionStatistics();
+    writer.Gauge("sudachi_relay_connections", "Peers admitted by DDoS protection",
+                 static_cast<double>(protection.active_connections));
+    constexpr std::string_view REJECTED = "sudachi_relay_ddos_rejections_total";
+    constexpr std::string_view REJECTED_HELP = "Connections and packets DDoS protection refused";
+    writer.Counter(REJECTED, REJECTED_HELP, protection.blacklist_rejections,
+                   {{"reason", "blacklisted"}});
+    writer.Counter(REJECTED, REJECTED_HELP, protection.connection_limit_rejections,
+                   {{"reason", "connection_limit"}});
+    writer.Counter(REJECTED, REJECTED_HELP, protection.per_address_rejections,
+                   {{"reason", "address_limit"}});
+    writer.Counter(REJECTED, REJECTED_HELP, protection.global_rate_limited,
+                   {{"reason", "global_rate"}});
+
+    writer.Histogram("sudachi_relay_batch_seconds",
+                     "Time from receiving a batch of datagrams to sending what it produced",
+                     batch_latency_);
+}
+
+size_t RelayServer::EvictIdlePeers() {
+    const int64_t now_ms = NowMs();
+    size_t evicted = 0;
+    for (size_t i = 0; i < RelaySessionTable::SHARD_COUNT; ++i) {
+        evicted += EvictIdlePeersInShard(i, now_ms);
+    }
+    for (size_t i = 0; i < RelaySpectatorTable::SHARD_COUNT; ++i) {
+        evicted += EvictIdleSpectatorsInShard(i, now_ms);
+    }
+    return evicted;
+}
+
+size_t RelayServer::EvictIdlePeersInShard(size_t shard_index, int64_t now_ms) {
+    const int64_t cutoff_ms = now_ms - config_.peer_idle_timeout.count();
+    const size_t evicted = sessions_.EvictIdlePeers(
+        shard_index, cutoff_ms, [this](uint32_t session_token, const RelayEndpoint& peer) {
+            ddos_protection_.RemoveConnection(IpAddressKey::FromIPv4(peer.address));
+            rate_manager_.RemoveClient(peer.ToString());
+        });
+    peers_evicted_.fetch_add(evicted, std::memory_order_relaxed);
+    return evicted;
+}
+
+size_t RelayServer::EvictIdleSpectatorsInShard(size_t shard_index, int64_t now_ms) {
+    const int64_t cutoff_ms = now_ms - config_.peer_idle_timeout.count();
+    const size_t evicted = spectators_.EvictIdle(
+        shard_index, cutoff_ms,
+        [this](uint32_t session_token) { return sessions_.Contains(session_token); },
+        [this](uint32_t session_token) {
+            // Any reactor's socket reaches the upstream
+            if (!reactors_.empty()) {
+                reactors_.front()->SendUpstream(session_token,
+                                                ModelA::RelayProtocol::FLAG_SESSION_LEAVE,
+                                                ModelA::RelayProtocol::EXT_FLAG_SPECTATE);
+            }
+        });
+    spectators_evicted_.fetch_add(evicted, std::memory_order_relaxed);
+    return evicted;
+}
+
+void RelayServer::SweepNextShard() {
+    // One shard per tick keeps each timer callback short
+    const size_t index =
+        next_sweep_shard_.fetch_add(1, std::memory_order_relaxed) % RelaySessionTable::SHARD_COUNT;
+    const int64_t now_ms = NowMs();
+    EvictIdlePeersInShard(index, now_ms);
+    EvictIdleSpectatorsInShard(index % RelaySpectatorTable::SHARD_COUNT, now_ms);
+}
+
+bool RelayServer::ParseEndpoint(const std::string& text, RelayEndpoint& out) {
+    const size_t colon = text.rfind(':');
+    if (colon == std::string::npos) {
+        return false;
+    }
+    in_addr address{};
+    if (::inet_pton(AF_INET, text.substr(0, colon).c_str(), &address) != 1) {
+        return false;
+    }
+    const auto port_text = std::string_view(text).substr(colon + 1);
+    uint16_t port = 0;
+    const auto [end, error] =
+        std::from_chars(port_text.data(), port_text.data() + port_text.size(), port);
+    if (error != std::errc{} || end != port_text.data() + port_text.size() || port == 0) {
+        return false;
+    }
+    out = RelayEndpoint{address.s_addr, htons(port)};
+    return true;
+}
+
+int64_t RelayServer::NowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+} // namespace Core::Multiplayer::Relay
@@ -0,0 +1,119 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/multiplayer/common/error_codes.h"
+#include "core/multiplayer/common/latency_histogram.h"
+#include "core/multiplayer/common/metrics_writer.h"
+#include "core/multiplayer/common/network_security.h"
+#include "core/multiplayer/common/timer_wheel.h"
+#include "relay_reactor.h"
+#include "relay_server_types.h"
+#include "relay_session_table.h"
+#include "relay_spectator_table.h"
+
+namespace Core::Multiplayer::Relay {
+
+/**
+ * UDP relay server for RelayClient, speaking RelayProtocol.
+ *
+ * Runs one RelayReactor per core on a shared SO_REUSEPORT port. Reactors
+ * route each datagram by its session token through a RelaySessionTable and
+ * forward it unchanged to the session's other peers. Every datagram passes
+ * the per-client ClientRateManager limits and the DDoSProtection global
+ * rate; each session peer counts as a DDoSProtection connection.
+ *
+ * Peers idle past peer_idle_timeout are evicted from a TimerWheel sweep,
+ * one table shard per tick, and a session goes with its last peer.
+ *
+ * Clients may also spectate a session through a RelaySpectatorTable. With
+ * spectator_upstream set, spectators of sessions this relay does not carry
+ * are served from one subscription to the upstream relay, so relays stack
+ * into a fan-out tree below the one the session's members use.
+ *
+ * Usage:
+ *   RelayServerConfig config;
+ *   config.port = 8443;
+ *   RelayServer server(config);
+ *   if (server.Start() == ErrorCode::Success) {
+ *       ...
+ *       server.Stop();
+ *   }
+ */
+class RelayServer {
+public:
+    static constexpr std::chrono::milliseconds SWEEP_INTERVAL{100};
+
+    /**
+     * @param timer_wheel Wheel that drives idle-peer eviction; the shared
+     *                    wheel is used when null
+     */
+    explicit RelayServer(const RelayServerConfig& config,
+                         std::shared_ptr<TimerWheel> timer_wheel = nullptr);
+    ~RelayServer();
+
+    RelayServer(const RelayServer&) = delete;
+    RelayServer& operator=(const RelayServer&) = delete;
+
+    /**
+     * Binds every reactor's socket and starts the event loops
+     * @return Success, or the first reactor's error with nothing left running
+     */
+    ErrorCode Start();
+    void Stop();
+    bool IsRunning() const { return running_; }
+
+    // Bound port, which differs from the configured one when that is 0
+    uint16_t GetPort() const { return port_; }
+    size_t GetReactorCount() const { return reactors_.size(); }
+    RelayServerStatistics GetStatistics() const;
+
+    /**
+     * Writes the statistics, the rate limiter and DDoS counters and the
+     * batch latency histogram as sudachi_relay_* metrics; a collector for
+     * MetricsExporter. Reads only atomics, so the reactors never wait.
+     */
+    void WriteMetrics(MetricsWriter& writer) const;
+
+    /**
+     * Evicts idle peers and spectators from every shard now, instead of
+     * waiting for the sweep
+     * @return Number of peers and spectators evicted
+     */
+    size_t EvictIdlePeers();
+
+private:
+    size_t EvictIdlePeersInShard(size_t shard_index, int64_t now_ms);
+    size_t EvictIdleSpectatorsInShard(size_t shard_index, int64_t now_ms);
+    void SweepNextShard();
+    // "address:port" with an IPv4 address
+    static bool ParseEndpoint(const std::string& text, RelayEndpoint& out);
+    static int64_t NowMs();
+
+    RelayServerConfig config_;
+    RelaySessionTable sessions_;
+    RelaySpectatorTable spectators_;
+    Security::ClientRateManager rate_manager_;
+    Security::DDoSProtection ddos_protection_;
+    LatencyHistogram batch_latency_;
+    std::vector<std::unique_ptr<RelayReactor>> reactors_;
+    bool running_ = false;
+    uint16_t port_ = 0;
+
+    std::shared_ptr<TimerWheel> timer_wheel_;
+    TimerWheel::TimerId sweep_timer_ = TimerWheel::INVALID_TIMER_ID;
+    std::atomic<size_t> next_sweep_shard_{0};
+    std::atomic<uint64_t> peers_evicted_{0};
+    std::atomic<uint64_t> spectators_evicted_{0};
+};
+
+} // namespace Core::Multiplayer::Relay
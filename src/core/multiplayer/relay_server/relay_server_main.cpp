@@ -0,0 +1,143 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// sudachi-relay-server: runs a RelayServer until SIGINT or SIGTERM
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+
+#include <pthread.h>
+
+#include "core/multiplayer/common/metrics_exporter.h"
+#include "relay_server.h"
+
+using namespace Core::Multiplayer;
+using namespace Core::Multiplayer::Relay;
+
+namespace {
+
+constexpr int STATISTICS_INTERVAL_SECONDS = 10;
+
+void PrintUsage(const char* program) {
+    std::fprintf(stderr,
+                 "Usage: %s [--bind ADDRESS] [--port PORT] [--reactors N] [--max-sessions N]\n"
+                 "          [--max-connections-per-ip N] [--idle-timeout SECONDS] [--no-pin]\n"
+                 "          [--no-compression] [--max-spectators N]\n"
+                 "          [--spectator-upstream ADDRESS:PORT]\n"
+                 "          [--metrics-port PORT] [--metrics-bind ADDRESS]\n",
+                 program);
+}
+
+// Prometheus endpoint; off unless a port is given
+struct MetricsOptions {
+    bool enabled = false;
+    MetricsExporterConfig exporter;
+};
+
+bool ParseArguments(int argc, char** argv, RelayServerConfig& config, MetricsOptions& metrics) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string option = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (option == "--bind" && has_value) {
+            config.bind_address = argv[++i];
+        } else if (option == "--port" && has_value) {
+            config.port = static_cast<uint16_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (option == "--reactors" && has_value) {
+            config.reactor_count = std::strtoul(argv[++i], nullptr, 10);
+        } else if (option == "--max-sessions" && has_value) {
+            config.max_sessions = std::strtoul(argv[++i], nullptr, 10);
+        } else if (option == "--max-connections-per-ip" && has_value) {
+            config.ddos.max_connections_per_ip = std::strtoul(argv[++i], nullptr, 10);
+        } else if (option == "--idle-timeout" && has_value) {
+            config.peer_idle_timeout = std::chrono::seconds(std::strtoul(argv[++i], nullptr, 10));
+        } else if (option == "--max-spectators" && has_value) {
+            config.max_spectators_per_session = std::strtoul(argv[++i], nullptr, 10);
+        } else if (option == "--spectator-upstream" && has_value) {
+            config.spectator_upstream = argv[++i];
+        } else if (option == "--metrics-port" && has_value) {
+            metrics.enabled = true;
+            metrics.exporter.port = static_cast<uint16_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (option == "--metrics-bind" && has_value) {
+            metrics.exporter.bind_address = argv[++i];
+        } else if (option == "--no-pin") {
+            config.pin_reactors = false;
+        } else if (option == "--no-compression") {
+            config.allow_compression = false;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+void PrintStatistics(const RelayServerStatistics& statistics) {
+    std::printf("sessions %zu spectators %zu | received %llu sent %llu (%llu bytes) | dropped: malformed %llu "
+                "rate %llu unknown %llu | send errors %llu | evicted %llu\n",
+                statistics.active_sessions, statistics.active_spectators,
+                static_cast<unsigned long long>(statistics.datagrams_received),
+                static_cast<unsigned long long>(statistics.datagrams_sent),
+                static_cast<unsigned long long>(statistics.bytes_sent),
+                static_cast<unsigned long long>(statistics.malformed_dropped),
+                static_cast<unsigned long long>(statistics.rate_limited_dropped),
+                static_cast<unsigned long long>(statistics.unknown_session_dropped),
+                static_cast<unsigned long long>(statistics.send_errors),
+                static_cast<unsigned long long>(statistics.peers_evicted));
+    std::fflush(stdout);
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    RelayServerConfig config;
+    MetricsOptions metrics;
+    if (!ParseArguments(argc, argv, config, metrics)) {
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // Blocked before any thread starts, so only sigtimedwait below sees them
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    RelayServer server(config);
+    const ErrorCode result = server.Start();
+    if (result != ErrorCode::Success) {
+        std::fprintf(stderr, "Failed to start the relay server on %s:%u (error %d)\n",
+                     config.bind_address.c_str(), config.port, static_cast<int>(result));
+        return EXIT_FAILURE;
+    }
+    std::printf("Relay server listening on %s:%u with %zu reactors\n", config.bind_address.c_str(),
+                server.GetPort(), server.GetReactorCount());
+    std::fflush(stdout);
+
+    MetricsExporter exporter(metrics.exporter);
+    if (metrics.enabled) {
+        exporter.AddCollector([&server](MetricsWriter& writer) { server.WriteMetrics(writer); });
+        if (exporter.Start() != ErrorCode::Success) {
+            std::fprintf(stderr, "Failed to serve metrics on %s:%u\n",
+                         metrics.exporter.bind_address.c_str(), metrics.exporter.port);
+            server.Stop();
+            return EXIT_FAILURE;
+        }
+        std::printf("Metrics at http://%s:%u/metrics\n", metrics.exporter.bind_address.c_str(),
+                    exporter.GetPort());
+        std::fflush(stdout);
+    }
+
+    const timespec interval{STATISTICS_INTERVAL_SECONDS, 0};
+    while (sigtimedwait(&signals, nullptr, &interval) < 0) {
+        PrintStatistics(server.GetStatistics());
+    }
+
+    exporter.Stop();
+    server.Stop();
+    PrintStatistics(server.GetStatistics());
+    return EXIT_SUCCESS;
+}
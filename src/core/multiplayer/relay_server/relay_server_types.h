@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "core/multiplayer/common/network_security.h"
+
+namespace Core::Multiplayer::Relay {
+
+/**
+ * IPv4 UDP endpoint of a relay client, both fields in network byte order
+ */
+struct RelayEndpoint {
+    uint32_t address = 0;
+    uint16_t port = 0;
+
+    bool operator==(const RelayEndpoint& other) const {
+        return address == other.address && port == other.port;
+    }
+
+    uint64_t Key() const { return static_cast<uint64_t>(address) << 16 | port; }
+
+    // Dotted quad
+    std::string ToAddressString() const;
+    // "address:port", the client id used for rate limiting
+    std::string ToString() const;
+};
+
+/**
+ * Relay server configuration
+ */
+struct RelayServerConfig {
+    std::string bind_address = "0.0.0.0";
+    uint16_t port = 8443;          // 0 binds an ephemeral port shared by every reactor
+    size_t reactor_count = 0;      // 0 runs one reactor per hardware thread
+    bool pin_reactors = true;      // Pin reactor i to core i
+    size_t max_sessions = 10000;
+    std::chrono::milliseconds peer_idle_timeout{30000};
+    bool allow_compression = true; // Accept EXT_FLAG_COMPRESSED offers
+    size_t socket_buffer_size = 4 * 1024 * 1024;
+
+    // Spectators of one session; an edge relay counts as one
+    size_t max_spectators_per_session = 256;
+    // "address:port" of the relay spectators of sessions this one does not
+    // carry are subscribed through; empty to refuse them
+    std::string spectator_upstream;
+
+    // A relay client sends 60 game packets per second plus keepalives
+    Security::RateLimitConfig rate_limits{.packets_per_second = 240.0,
+                                          .burst_capacity = 480.0,
+                                          .idle_client_timeout = std::chrono::seconds{300}};
+    // Each peer of a session is one connection; a few may share a NAT address
+    Security::DDoSProtectionConfig ddos{.max_total_connections = 20000,
+                                        .max_connections_per_ip = 16,
+                                        .max_packets_per_second = 4000000};
+};
+
+/**
+ * Relay server statistics, summed over all reactors
+ */
+struct RelayServerStatistics {
+    uint64_t datagrams_received = 0;
+    uint64_t bytes_received = 0;
+    uint64_t datagrams_sent = 0; // Forwarded packets and replies
+    uint64_t bytes_sent = 0;
+    uint64_t malformed_dropped = 0;
+    uint64_t rate_limited_dropped = 0;
+    uint64_t unknown_session_dropped = 0; // Data for a session that does not exist
+    uint64_t multicast_frames = 0; // Data frames forwarded by destination mask
+    uint64_t send_errors = 0;
+    uint64_t sessions_created = 0;
+    uint64_t sessions_joined = 0;
+    uint64_t sessions_resumed = 0; // Rejoined after a client's relay failover
+    uint64_t session_requests_refused = 0;
+    uint64_t peers_evicted = 0; // Idle past peer_idle_timeout
+    uint64_t spectators_subscribed = 0;
+    uint64_t spectate_requests_refused = 0;
+    uint64_t spectator_frames = 0; // Copies of members' frames sent to spectators
+    uint64_t spectators_evicted = 0;
+    size_t active_sessions = 0;
+    size_t active_spectators = 0;
+};
+
+} // namespace Core::Multiplayer::Relay
@@ -0,0 +1,289 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "relay_session_table.h"
+
+#include <algorithm>
+#include <bit>
+#include <mutex>
+#include <random>
+#include <string>
+
+namespace Core::Multiplayer::Relay {
+
+namespace {
+constexpr size_t MIN_SHARD_CAPACITY = 16;
+
+// Clients pick their tokens, so they are mixed with a per-table seed
+uint64_t Mix(uint64_t value) {
+    value ^= value >> 33;
+    value *= 0xFF51AFD7ED558CCDULL;
+    value ^= value >> 33;
+    value *= 0xC4CEB9FE1A85EC53ULL;
+    value ^= value >> 33;
+    return value;
+}
+
+uint64_t RandomSeed() {
+    std::random_device device;
+    return static_cast<uint64_t>(device()) << 32 | device();
+}
+} // namespace
+
+std::string RelayEndpoint::ToAddressString() const {
+    // Network byte order: the first octet is the lowest addressed byte
+    const auto* octets = reinterpret_cast<const uint8_t*>(&address);
+    return std::to_string(octets[0]) + '.' + std::to_string(octets[1]) + '.' +
+           std::to_string(octets[2]) + '.' + std::to_string(octets[3]);
+}
+
+std::string RelayEndpoint::ToString() const {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&port);
+    return ToAddressString() + ':' + std::to_string(bytes[0] << 8 | bytes[1]);
+}
+
+RelaySessionTable::RelaySessionTable(size_t max_sessions)
+    : max_sessions_(max_sessions), seed_(RandomSeed()) {
+    // Twice the average shard load, so an unlucky shard still probes short
+    const size_t per_shard = (max_sessions + SHARD_COUNT - 1) / SHARD_COUNT;
+    const size_t capacity = std::bit_ceil(std::max(MIN_SHARD_CAPACITY, 2 * per_shard + 16));
+    for (auto& shard : shards_) {
+        shard.slots = std::make_unique<Slot[]>(capacity);
+        shard.mask = capacity - 1;
+    }
+}
+
+RelaySessionTable::~RelaySessionTable() = default;
+
+size_t RelaySessionTable::Hash(uint32_t session_token) const {
+    return static_cast<size_t>(Mix(session_token ^ seed_));
+}
+
+RelaySessionTable::Shard& RelaySessionTable::GetShard(uint32_t session_token) {
+    // High bits pick the shard, low bits the slot within it
+    return shards_[(Hash(session_token) >> 58) % SHARD_COUNT];
+}
+
+RelaySessionTable::Slot* RelaySessionTable::FindLocked(Shard& shard,
+                                                       uint32_t session_token) const {
+    for (size_t i = Hash(session_token) & shard.mask;; i = (i + 1) & shard.mask) {
+        Slot& slot = shard.slots[i];
+        if (slot.session_token == session_token) {
+            return &slot;
+        }
+        if (slot.session_token == 0) {
+            return nullptr;
+        }
+    }
+}
+
+SessionResult RelaySessionTable::Create(uint32_t session_token, const RelayEndpoint& creator,
+                                        bool compressed, int64_t now_ms, uint8_t node_id) {
+    if (session_token == 0) {
+        return SessionResult::InvalidToken;
+    }
+    Shard& shard = GetShard(session_token);
+    std::unique_lock lock(shard.mutex);
+
+    size_t i = Hash(session_token) & shard.mask;
+    for (; shard.slots[i].session_token != 0; i = (i + 1) & shard.mask) {
+        Slot& slot = shard.slots[i];
+        if (slot.session_token == session_token) {
+            const bool creator_retry = slot.peer_count == 1 && slot.peers[0].endpoint == creator;
+            return creator_retry ? SessionResult::AlreadyMember : SessionResult::AlreadyExists;
+        }
+    }
+    // Keep a quarter of each shard empty so probes always end quickly
+    if (shard.used + 1 > (shard.mask + 1) * 3 / 4) {
+        return SessionResult::TableFull;
+    }
+    if (session_count_.fetch_add(1, std::memory_order_relaxed) >= max_sessions_) {
+        session_count_.fetch_sub(1, std::memory_order_relaxed);
+        return SessionResult::TableFull;
+    }
+
+    Slot& slot = shard.slots[i];
+    slot.session_token = session_token;
+    slot.compressed = compressed;
+    slot.peer_count = 1;
+    slot.peers[0].endpoint = creator;
+    slot.peers[0].node_id = node_id;
+    slot.peers[0].last_active_ms.store(now_ms, std::memory_order_relaxed);
+    ++shard.used;
+    return SessionResult::Accepted;
+}
+
+SessionResult RelaySessionTable::Join(uint32_t session_token, const RelayEndpoint& peer,
+                                      int64_t now_ms, bool& out_compressed, uint8_t node_id) {
+    if (session_token == 0) {
+        return SessionResult::InvalidToken;
+    }
+    Shard& shard = GetShard(session_token);
+    std::unique_lock lock(shard.mutex);
+
+    Slot* slot = FindLocked(shard, session_token);
+    if (slot == nullptr) {
+        return SessionResult::NotFound;
+    }
+    out_compressed = slot->compressed;
+    for (size_t i = 0; i < slot->peer_count; ++i) {
+        if (slot->peers[i].endpoint == peer) {
+            slot->peers[i].last_active_ms.store(now_ms, std::memory_order_relaxed);
+            if (node_id != ModelA::RelayProtocol::NO_NODE_ID) {
+                slot->peers[i].node_id = node_id;
+            }
+            return SessionResult::AlreadyMember;
+        }
+    }
+    if (slot->peer_count == MAX_SESSION_PEERS) {
+        return SessionResult::SessionFull;
+    }
+
+    Peer& added = slot->peers[slot->peer_count++];
+    added.endpoint = peer;
+    added.node_id = node_id;
+    added.last_active_ms.store(now_ms, std::memory_order_relaxed);
+    return SessionResult::Accepted;
+}
+
+bool RelaySessionTable::Leave(uint32_t session_token, const RelayEndpoint& peer) {
+    if (session_token == 0) {
+        return false;
+    }
+    Shard& shard = GetShard(session_token);
+    std::unique_lock lock(shard.mutex);
+
+    Slot* slot = FindLocked(shard, session_token);
+    if (slot == nullptr) {
+        return false;
+    }
+    for (size_t i = 0; i < slot->peer_count; ++i) {
+        if (slot->peers[i].endpoint == peer) {
+            RemovePeerLocked(shard, *slot, i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool RelaySessionTable::Contains(uint32_t session_token) {
+    if (session_token == 0) {
+        return false;
+    }
+    Shard& shard = GetShard(session_token);
+    std::shared_lock lock(shard.mutex);
+    return FindLocked(shard, session_token) != nullptr;
+}
+
+RouteResult RelaySessionTable::Route(uint32_t session_token, const RelayEndpoint& from,
+                                     int64_t now_ms, PeerList& out, uint8_t destination_mask) {
+    out.count = 0;
+    if (session_token == 0) {
+        return RouteResult::NotFound;
+    }
+    Shard& shard = GetShard(session_token);
+    std::shared_lock lock(shard.mutex);
+
+    const Slot* slot = FindLocked(shard, session_token);
+    if (slot == nullptr) {
+        return RouteResult::NotFound;
+    }
+    const Peer* sender = nullptr;
+    for (size_t i = 0; i < slot->peer_count; ++i) {
+        const Peer& peer = slot->peers[i];
+        if (peer.endpoint == from) {
+            sender = &peer;
+        } else if (out.count < out.peers.size() &&
+                   ModelA::RelayProtocol::IsMulticastDestination(destination_mask,
+                                                                 peer.node_id)) {
+            out.peers[out.count++] = peer.endpoint;
+        }
+    }
+    if (sender == nullptr) {
+        out.count = 0;
+        return RouteResult::NotMember;
+    }
+    // Skips the store, and its cache line invalidation, within a millisecond
+    if (sender->last_active_ms.load(std::memory_order_relaxed) != now_ms) {
+        sender->last_active_ms.store(now_ms, std::memory_order_relaxed);
+    }
+    return RouteResult::Routed;
+}
+
+size_t RelaySessionTable::EvictIdlePeers(size_t shard_index, int64_t cutoff_ms,
+                                         const PeerCallback& on_removed) {
+    Shard& shard = shards_[shard_index % SHARD_COUNT];
+    std::unique_lock lock(shard.mutex);
+
+    size_t removed = 0;
+    size_t i = 0;
+    while (i <= shard.mask) {
+        Slot& slot = shard.slots[i];
+        if (slot.session_token == 0) {
+            ++i;
+            continue;
+        }
+        const uint32_t session_token = slot.session_token;
+        for (size_t peer = slot.peer_count; peer-- > 0 && slot.session_token == session_token;) {
+            if (slot.peers[peer].last_active_ms.load(std::memory_order_relaxed) < cutoff_ms) {
+                const RelayEndpoint endpoint = slot.peers[peer].endpoint;
+                RemovePeerLocked(shard, slot, peer);
+                on_removed(session_token, endpoint);
+                ++removed;
+            }
+        }
+        // Erasing may shift a later session into this slot; look at it again
+        if (slot.session_token == session_token) {
+            ++i;
+        }
+    }
+    return removed;
+}
+
+void RelaySessionTable::RemovePeerLocked(Shard& shard, Slot& slot, size_t index) {
+    const size_t last = slot.peer_count - 1;
+    if (index != last) {
+        slot.peers[index].endpoint = slot.peers[last].endpoint;
+        slot.peers[index].node_id = slot.peers[last].node_id;
+        slot.peers[index].last_active_ms.store(
+            slot.peers[last].last_active_ms.load(std::memory_order_relaxed),
+            std::memory_order_relaxed);
+    }
+    if (--slot.peer_count == 0) {
+        EraseLocked(shard, slot);
+    }
+}
+
+void RelaySessionTable::EraseLocked(Shard& shard, Slot& slot) {
+    size_t hole = static_cast<size_t>(&slot - shard.slots.get());
+    for (size_t i = (hole + 1) & shard.mask; shard.slots[i].session_token != 0;
+         i = (i + 1) & shard.mask) {
+        // An entry may fill the hole if the hole lies on its probe path
+        const size_t home = Hash(shard.slots[i].session_token) & shard.mask;
+        if (((i - home) & shard.mask) >= ((i - hole) & shard.mask)) {
+            MoveSlot(shard.slots[hole], shard.slots[i]);
+            hole = i;
+        }
+    }
+    shard.slots[hole].session_token = 0;
+    shard.slots[hole].peer_count = 0;
+    --shard.used;
+    session_count_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void RelaySessionTable::MoveSlot(Slot& to, Slot& from) {
+    to.session_token = from.session_token;
+    to.peer_count = from.peer_count;
+    to.compressed = from.compressed;
+    for (size_t i = 0; i < from.peer_count; ++i) {
+        to.peers[i].endpoint = from.peers[i].endpoint;
+        to.peers[i].node_id = from.peers[i].node_id;
+        to.peers[i].last_active_ms.store(
+            from.peers[i].last_active_ms.load(std::memory_order_relaxed),
+            std::memory_order_relaxed);
+    }
+    from.session_token = 0;
+    from.peer_count = 0;
+}
+
+} // namespace Core::Multiplayer::Relay
@@ -0,0 +1,150 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <shared_mutex>
+
+#include "core/multiplayer/model_a/relay_protocol.h"
+#include "relay_server_types.h"
+
+namespace Core::Multiplayer::Relay {
+
+enum class SessionResult : uint8_t {
+    Accepted,
+    AlreadyMember, // Retransmitted request; answered like the first
+    InvalidToken,
+    NotFound,
+    AlreadyExists,
+    SessionFull,
+    TableFull,
+};
+
+enum class RouteResult : uint8_t {
+    Routed,
+    NotMember, // The session exists but the sender has not joined it
+    NotFound,
+};
+
+/**
+ * Maps session tokens to the endpoints of their peers.
+ *
+ * Every datagram the relay forwards looks its session up here, from every
+ * reactor at once, so the table is built for lookups: sessions are spread
+ * over SHARD_COUNT lock-striped shards, and each shard is a preallocated
+ * open-addressing array probed linearly, so a lookup takes one shared lock
+ * and usually touches one cache line past the lock. Session changes take
+ * the shard's lock exclusively. The table never grows; it is sized for
+ * max_sessions up front.
+ *
+ * Token 0 means "no session" to the client and is never stored.
+ */
+class RelaySessionTable {
+public:
+    static constexpr size_t SHARD_COUNT = 64;
+    // An LDN network holds at most eight nodes
+    static constexpr size_t MAX_SESSION_PEERS = 8;
+
+    /**
+     * Peers a datagram is forwarded to
+     */
+    struct PeerList {
+        std::array<RelayEndpoint, MAX_SESSION_PEERS - 1> peers{};
+        size_t count = 0;
+    };
+
+    using PeerCallback = std::function<void(uint32_t session_token, const RelayEndpoint& peer)>;
+
+    explicit RelaySessionTable(size_t max_sessions);
+    ~RelaySessionTable();
+
+    RelaySessionTable(const RelaySessionTable&) = delete;
+    RelaySessionTable& operator=(const RelaySessionTable&) = delete;
+
+    /**
+     * Creates a session with its first peer
+     * @param compressed Whether payloads in the session may be LZ4 compressed
+     * @param node_id The peer's LDN node id, for multicast masks
+     */
+    SessionResult Create(uint32_t session_token, const RelayEndpoint& creator, bool compressed,
+                         int64_t now_ms, uint8_t node_id = ModelA::RelayProtocol::NO_NODE_ID);
+
+    /**
+     * Adds a peer to an existing session; a retransmitted request may
+     * announce the node id the first one did not
+     * @param out_compressed Receives whether the session uses compression
+     */
+    SessionResult Join(uint32_t session_token, const RelayEndpoint& peer, int64_t now_ms,
+                       bool& out_compressed, uint8_t node_id = ModelA::RelayProtocol::NO_NODE_ID);
+
+    /**
+     * Removes a peer; the session goes with its last peer
+     * @return False if the peer was not in the session
+     */
+    bool Leave(uint32_t session_token, const RelayEndpoint& peer);
+
+    /**
+     * Looks up the peers a datagram from a session member goes to and marks
+     * the sender active
+     * @param destination_mask Multicast mask; peers it leaves out are skipped
+     */
+    RouteResult Route(uint32_t session_token, const RelayEndpoint& from, int64_t now_ms,
+                      PeerList& out,
+                      uint8_t destination_mask = ModelA::RelayProtocol::MULTICAST_ALL_NODES);
+
+    /**
+     * Removes peers last active before cutoff_ms from one shard
+     * @param on_removed Called for each removed peer, under the shard's lock
+     * @return Number of peers removed
+     */
+    size_t EvictIdlePeers(size_t shard_index, int64_t cutoff_ms, const PeerCallback& on_removed);
+
+    // Whether the session exists on this relay
+    bool Contains(uint32_t session_token);
+
+    size_t GetSessionCount() const { return session_count_.load(std::memory_order_relaxed); }
+    size_t GetMaxSessions() const { return max_sessions_; }
+
+private:
+    struct Peer {
+        RelayEndpoint endpoint;
+        uint8_t node_id = ModelA::RelayProtocol::NO_NODE_ID;
+        // Written under the shared lock by the reactor receiving from the peer
+        mutable std::atomic<int64_t> last_active_ms{0};
+    };
+
+    struct Slot {
+        uint32_t session_token = 0; // 0 while empty
+        uint8_t peer_count = 0;
+        bool compressed = false;
+        std::array<Peer, MAX_SESSION_PEERS> peers;
+    };
+
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex;
+        std::unique_ptr<Slot[]> slots;
+        size_t mask = 0;
+        size_t used = 0;
+    };
+
+    Shard& GetShard(uint32_t session_token);
+    size_t Hash(uint32_t session_token) const;
+    Slot* FindLocked(Shard& shard, uint32_t session_token) const;
+    // Backward-shift deletion keeps probe sequences free of tombstones
+    void EraseLocked(Shard& shard, Slot& slot);
+    void RemovePeerLocked(Shard& shard, Slot& slot, size_t index);
+    static void MoveSlot(Slot& to, Slot& from);
+
+    const size_t max_sessions_;
+    const uint64_t seed_;
+    std::array<Shard, SHARD_COUNT> shards_;
+    std::atomic<size_t> session_count_{0};
+};
+
+} // namespace Core::Multiplayer::Relay
@@ -0,0 +1,198 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "relay_spectator_table.h"
+
+#include <algorithm>
+#include <mutex>
+
+namespace Core::Multiplayer::Relay {
+
+using ModelA::RelayProtocol;
+
+RelaySpectatorTable::RelaySpectatorTable(size_t max_sessions, size_t max_spectators_per_session)
+    : max_sessions_(max_sessions), max_spectators_per_session_(max_spectators_per_session) {}
+
+RelaySpectatorTable::Shard& RelaySpectatorTable::GetShard(uint32_t session_token) {
+    return shards_[(session_token * 0x9E3779B9u) >> 28];
+}
+
+const RelaySpectatorTable::Shard& RelaySpectatorTable::GetShard(uint32_t session_token) const {
+    return shards_[(session_token * 0x9E3779B9u) >> 28];
+}
+
+SpectateResult RelaySpectatorTable::Subscribe(uint32_t session_token,
+                                              const RelayEndpoint& spectator, int64_t now_ms,
+                                              bool upstream, bool& out_first) {
+    out_first = false;
+    if (session_token == 0) {
+        return SpectateResult::InvalidToken;
+    }
+    Shard& shard = GetShard(session_token);
+    std::unique_lock lock(shard.mutex);
+    auto it = shard.entries.find(session_token);
+    if (it == shard.entries.end()) {
+        if (session_count_.load(std::memory_order_relaxed) >= max_sessions_) {
+            return SpectateResult::TableFull;
+        }
+        it = shard.entries.try_emplace(session_token).first;
+        it->second.upstream = upstream;
+        // The caller subscribes upstream right away
+        it->second.upstream_refreshed_ms = now_ms;
+        session_count_.fetch_add(1, std::memory_order_relaxed);
+        out_first = true;
+    }
+
+    auto& spectators = it->second.spectators;
+    for (auto& existing : spectators) {
+        if (existing.endpoint == spectator) {
+            existing.last_active_ms = now_ms;
+            return SpectateResult::AlreadySubscribed;
+        }
+    }
+    if (spectators.size() >= max_spectators_per_session_) {
+        return SpectateResult::SessionFull;
+    }
+    spectators.push_back(Spectator{spectator, now_ms});
+    spectator_count_.fetch_add(1, std::memory_order_relaxed);
+    return SpectateResult::Accepted;
+}
+
+bool RelaySpectatorTable::Unsubscribe(uint32_t session_token, const RelayEndpoint& spectator,
+                                      bool& out_upstream) {
+    out_upstream = false;
+    Shard& shard = GetShard(session_token);
+    std::unique_lock lock(shard.mutex);
+    const auto it = shard.entries.find(session_token);
+    if (it == shard.entries.end()) {
+        return false;
+    }
+    auto& spectators = it->second.spectators;
+    const auto found = std::find_if(spectators.begin(), spectators.end(),
+                                    [&](const Spectator& s) { return s.endpoint == spectator; });
+    if (found == spectators.end()) {
+        return false;
+    }
+    // Order does not matter, so the last one fills the gap
+    *found = spectators.back();
+    spectators.pop_back();
+    spectator_count_.fetch_sub(1, std::memory_order_relaxed);
+    if (spectators.empty()) {
+        out_upstream = it->second.upstream;
+        shard.entries.erase(it);
+        session_count_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+bool RelaySpectatorTable::IsSubscribed(uint32_t session_token,
+                                       const RelayEndpoint& spectator) const {
+    const Shard& shard = GetShard(session_token);
+    std::shared_lock lock(shard.mutex);
+    const auto it = shard.entries.find(session_token);
+    if (it == shard.entries.end()) {
+        return false;
+    }
+    return std::any_of(it->second.spectators.begin(), it->second.spectators.end(),
+                       [&](const Spectator& s) { return s.endpoint == spectator; });
+}
+
+bool RelaySpectatorTable::Touch(uint32_t session_token, const RelayEndpoint& spectator,
+                                int64_t now_ms, int64_t upstream_refresh_ms) {
+    Shard& shard = GetShard(session_token);
+    std::unique_lock lock(shard.mutex);
+    const auto it = shard.entries.find(session_token);
+    if (it == shard.entries.end()) {
+        return false;
+    }
+    Entry& entry = it->second;
+    const auto found = std::find_if(entry.spectators.begin(), entry.spectators.end(),
+                                    [&](const Spectator& s) { return s.endpoint == spectator; });
+    if (found == entry.spectators.end()) {
+        return false;
+    }
+    found->last_active_ms = now_ms;
+    if (!entry.upstream || now_ms - entry.upstream_refreshed_ms < upstream_refresh_ms) {
+        return false;
+    }
+    entry.upstream_refreshed_ms = now_ms;
+    return true;
+}
+
+size_t RelaySpectatorTable::CopySpectators(uint32_t session_token,
+                                           std::vector<RelayEndpoint>& out) const {
+    out.clear();
+    const Shard& shard = GetShard(session_token);
+    std::shared_lock lock(shard.mutex);
+    const auto it = shard.entries.find(session_token);
+    if (it == shard.entries.end()) {
+        return 0;
+    }
+    for (const auto& spectator : it->second.spectators) {
+        out.push_back(spectator.endpoint);
+    }
+    return out.size();
+}
+
+bool RelaySpectatorTable::StoreSnapshot(uint32_t session_token, uint32_t sequence,
+                                        std::span<const uint8_t> datagram) {
+    Shard& shard = GetShard(session_token);
+    std::unique_lock lock(shard.mutex);
+    const auto it = shard.entries.find(session_token);
+    if (it == shard.entries.end()) {
+        return false;
+    }
+    Entry& entry = it->second;
+    if (entry.snapshot.empty() || entry.snapshot_sequence != sequence) {
+        entry.snapshot.clear();
+        entry.snapshot_sequence = sequence;
+    }
+    if (entry.snapshot.size() < RelayProtocol::MAX_FRAGMENT_COUNT) {
+        entry.snapshot.emplace_back(datagram.begin(), datagram.end());
+    }
+    return true;
+}
+
+bool RelaySpectatorTable::GetSnapshot(uint32_t session_token,
+                                      std::vector<std::vector<uint8_t>>& out) const {
+    const Shard& shard = GetShard(session_token);
+    std::shared_lock lock(shard.mutex);
+    const auto it = shard.entries.find(session_token);
+    if (it == shard.entries.end() || it->second.snapshot.empty()) {
+        return false;
+    }
+    out = it->second.snapshot;
+    return true;
+}
+
+size_t RelaySpectatorTable::EvictIdle(size_t shard_index, int64_t cutoff_ms,
+                                      const LivenessCheck& is_live,
+                                      const SessionCallback& on_upstream_emptied) {
+    Shard& shard = shards_[shard_index % SHARD_COUNT];
+    std::unique_lock lock(shard.mutex);
+    size_t evicted = 0;
+    for (auto it = shard.entries.begin(); it != shard.entries.end();) {
+        Entry& entry = it->second;
+        auto& spectators = entry.spectators;
+        const auto kept_end =
+            entry.upstream || !is_live || is_live(it->first)
+                ? std::remove_if(spectators.begin(), spectators.end(),
+                                 [&](const Spectator& s) { return s.last_active_ms < cutoff_ms; })
+                : spectators.begin();
+        evicted += static_cast<size_t>(spectators.end() - kept_end);
+        spectators.erase(kept_end, spectators.end());
+        if (!spectators.empty()) {
+            ++it;
+            continue;
+        }
+        if (entry.upstream && on_upstream_emptied) {
+            on_upstream_emptied(it->first);
+        }
+        it = shard.entries.erase(it);
+        session_count_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    spectator_count_.fetch_sub(evicted, std::memory_order_relaxed);
+    return evicted;
+}
+
+} // namespace Core::Multiplayer::Relay
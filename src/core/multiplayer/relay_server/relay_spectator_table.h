@@ -0,0 +1,154 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <shared_mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "core/multiplayer/model_a/relay_protocol.h"
+#include "relay_server_types.h"
+
+namespace Core::Multiplayer::Relay {
+
+enum class SpectateResult : uint8_t {
+    Accepted,
+    AlreadySubscribed, // Retransmitted request; answered like the first
+    InvalidToken,
+    NotFound,          // Neither carried here nor reachable through an upstream relay
+    SessionFull,       // max_spectators_per_session reached
+    TableFull,
+};
+
+/**
+ * Spectators of relayed sessions, by session token.
+ *
+ * A session's members send the frames meant for an audience with
+ * EXT_FLAG_SPECTATE once, and the relay copies them to every spectator, so
+ * the host's upload does not grow with the audience. A spectator is either
+ * a client or a downstream relay that subscribed the same way and fans the
+ * frames out to its own spectators, which makes the relays a distribution
+ * tree. The latest snapshot of each session is kept here for spectators
+ * that join late.
+ *
+ * Spectated sessions are spread over SHARD_COUNT lock-striped maps. Only
+ * frames flagged for spectators look a session up, so ordinary relay
+ * traffic never touches the table.
+ */
+class RelaySpectatorTable {
+public:
+    static constexpr size_t SHARD_COUNT = 16;
+
+    using SessionCallback = std::function<void(uint32_t session_token)>;
+    using LivenessCheck = std::function<bool(uint32_t session_token)>;
+
+    /**
+     * @param max_sessions Sessions that may have spectators at once
+     * @param max_spectators_per_session Spectators of one session
+     */
+    RelaySpectatorTable(size_t max_sessions, size_t max_spectators_per_session);
+
+    RelaySpectatorTable(const RelaySpectatorTable&) = delete;
+    RelaySpectatorTable& operator=(const RelaySpectatorTable&) = delete;
+
+    /**
+     * Subscribes a spectator to a session
+     * @param upstream Whether the session's frames come from an upstream relay
+     *                 rather than members on this one; only read when the
+     *                 session gets its first spectator
+     * @param out_first Set when this made the session spectated
+     */
+    SpectateResult Subscribe(uint32_t session_token, const RelayEndpoint& spectator,
+                             int64_t now_ms, bool upstream, bool& out_first);
+
+    /**
+     * Removes a spectator; the session's entry goes with its last one
+     * @param out_upstream Set when that entry was fed by an upstream relay,
+     *                     which should then be unsubscribed from
+     * @return False if the endpoint was not spectating the session
+     */
+    bool Unsubscribe(uint32_t session_token, const RelayEndpoint& spectator, bool& out_upstream);
+
+    bool IsSubscribed(uint32_t session_token, const RelayEndpoint& spectator) const;
+
+    /**
+     * Marks a spectator active, on its keepalive
+     * @param upstream_refresh_ms How often the upstream subscription is renewed
+     * @return True when the session is fed by an upstream relay whose
+     *         subscription is due for a keepalive; the refresh counts as sent
+     */
+    bool Touch(uint32_t session_token, const RelayEndpoint& spectator, int64_t now_ms,
+               int64_t upstream_refresh_ms);
+
+    /**
+     * Copies the session's spectators, for the reactor to send to outside the lock
+     * @return Number of spectators
+     */
+    size_t CopySpectators(uint32_t session_token, std::vector<RelayEndpoint>& out) const;
+
+    /**
+     * Keeps one datagram of a session's snapshot. A snapshot with a new
+     * sequence number replaces the stored one; fragments of the same one
+     * are added to it, up to RelayProtocol::MAX_FRAGMENT_COUNT.
+     * @return False if nobody spectates the session
+     */
+    bool StoreSnapshot(uint32_t session_token, uint32_t sequence,
+                       std::span<const uint8_t> datagram);
+
+    /**
+     * Copies the stored snapshot's datagrams
+     * @return False if there is none
+     */
+    bool GetSnapshot(uint32_t session_token, std::vector<std::vector<uint8_t>>& out) const;
+
+    /**
+     * Removes spectators last active before cutoff_ms from one shard, and
+     * the spectators of local sessions that no longer exist
+     * @param is_live Whether a session not fed from upstream still exists
+     * @param on_upstream_emptied Called, under the shard's lock, for each
+     *                            upstream-fed session that lost its last spectator
+     * @return Number of spectators removed
+     */
+    size_t EvictIdle(size_t shard_index, int64_t cutoff_ms, const LivenessCheck& is_live,
+                     const SessionCallback& on_upstream_emptied);
+
+    size_t GetSpectatorCount() const { return spectator_count_.load(std::memory_order_relaxed); }
+    size_t GetSessionCount() const { return session_count_.load(std::memory_order_relaxed); }
+
+private:
+    struct Spectator {
+        RelayEndpoint endpoint;
+        int64_t last_active_ms = 0;
+    };
+
+    struct Entry {
+        std::vector<Spectator> spectators;
+        bool upstream = false;
+        int64_t upstream_refreshed_ms = 0;
+        uint32_t snapshot_sequence = 0;
+        std::vector<std::vector<uint8_t>> snapshot;
+    };
+
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<uint32_t, Entry> entries;
+    };
+
+    Shard& GetShard(uint32_t session_token);
+    const Shard& GetShard(uint32_t session_token) const;
+
+    const size_t max_sessions_;
+    const size_t max_spectators_per_session_;
+    std::array<Shard, SHARD_COUNT> shards_;
+    std::atomic<size_t> session_count_{0};
+    std::atomic<size_t> spectator_count_{0};
+};
+
+} // namespace Core::Multiplayer::Relay
@@ -0,0 +1,498 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "core/multiplayer/model_a/relay_protocol.h"
+#include "core/multiplayer/relay_server/relay_server.h"
+
+using namespace Core::Multiplayer;
+using namespace Core::Multiplayer::Relay;
+using ModelA::RelayHeaderView;
+using ModelA::RelayProtocol;
+
+namespace {
+
+// A client socket connected to the relay
+class TestClient {
+public:
+    explicit TestClient(uint16_t port) {
+        socket_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ::connect(socket_, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+    }
+    ~TestClient() { ::close(socket_); }
+
+    void Send(uint32_t token, uint8_t flags, std::vector<uint8_t> payload = {},
+              uint8_t extended_flags = 0, uint32_t sequence = 1) {
+        std::vector<uint8_t> frame(sizeof(ModelA::RelayHeader) + payload.size());
+        protocol_.WriteHeader(frame, token, static_cast<uint16_t>(payload.size()), flags, sequence,
+                              extended_flags);
+        std::copy(payload.begin(), payload.end(), frame.begin() + sizeof(ModelA::RelayHeader));
+        ::send(socket_, frame.data(), frame.size(), 0);
+    }
+
+    void SendRaw(const std::vector<uint8_t>& datagram) {
+        ::send(socket_, datagram.data(), datagram.size(), 0);
+    }
+
+    // The next datagram as raw bytes, if one arrives in time
+    std::optional<std::vector<uint8_t>> Receive(int timeout_ms = 1000) {
+        pollfd descriptor{socket_, POLLIN, 0};
+        if (::poll(&descriptor, 1, timeout_ms) <= 0) {
+            return std::nullopt;
+        }
+        std::vector<uint8_t> datagram(65536);
+        const ssize_t size = ::recv(socket_, datagram.data(), datagram.size(), 0);
+        if (size < 0) {
+            return std::nullopt;
+        }
+        datagram.resize(static_cast<size_t>(size));
+        return datagram;
+    }
+
+    std::optional<RelayHeaderView> ReceiveHeader(int timeout_ms = 1000) {
+        last_ = Receive(timeout_ms);
+        RelayHeaderView header;
+        if (!last_ || !protocol_.ValidateMessage(*last_, &header)) {
+            return std::nullopt;
+        }
+        return header;
+    }
+
+private:
+    int socket_ = -1;
+    RelayProtocol protocol_;
+    std::optional<std::vector<uint8_t>> last_;
+};
+
+class RelayServerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        RelayServerConfig config;
+        config.bind_address = "127.0.0.1";
+        config.port = 0;
+        config.reactor_count = 2;
+        config.pin_reactors = false;
+        config.max_sessions = 16;
+        server_ = std::make_unique<RelayServer>(config, timer_wheel_);
+        ASSERT_EQ(server_->Start(), ErrorCode::Success);
+        ASSERT_NE(server_->GetPort(), 0);
+    }
+
+    void TearDown() override { server_->Stop(); }
+
+    // Creates a session from a and joins it from b
+    void Connect(TestClient& a, TestClient& b, uint32_t token) {
+        a.Send(token, RelayProtocol::FLAG_SESSION_CREATE);
+        auto created = a.ReceiveHeader();
+        ASSERT_TRUE(created);
+        ASSERT_EQ(created->flags, RelayProtocol::FLAG_SESSION_CREATE);
+        b.Send(token, RelayProtocol::FLAG_SESSION_JOIN);
+        auto joined = b.ReceiveHeader();
+        ASSERT_TRUE(joined);
+        ASSERT_EQ(joined->flags, RelayProtocol::FLAG_SESSION_JOIN);
+    }
+
+    std::shared_ptr<TimerWheel> timer_wheel_ = std::make_shared<TimerWheel>();
+    std::unique_ptr<RelayServer> server_;
+};
+
+} // anonymous namespace
+
+TEST_F(RelayServerTest, ForwardsDataUnchangedBetweenPeers) {
+    TestClient a(server_->GetPort());
+    TestClient b(server_->GetPort());
+    Connect(a, b, 1234);
+
+    const std::vector<uint8_t> payload{1, 2, 3, 4, 5};
+    a.Send(1234, RelayProtocol::FLAG_DATA, payload, RelayProtocol::EXT_FLAG_BUNDLE, 77);
+    auto datagram = b.Receive();
+    ASSERT_TRUE(datagram);
+
+    RelayProtocol protocol;
+    RelayHeaderView header;
+    ASSERT_TRUE(protocol.ValidateMessage(*datagram, &header));
+    EXPECT_EQ(header.session_token, 1234u);
+    EXPECT_EQ(header.sequence_num, 77u);
+    EXPECT_EQ(header.extended_flags, RelayProtocol::EXT_FLAG_BUNDLE);
+    EXPECT_EQ(std::vector<uint8_t>(header.payload.begin(), header.payload.end()), payload);
+
+    b.Send(1234, RelayProtocol::FLAG_DATA, {9});
+    EXPECT_TRUE(a.ReceiveHeader());
+    // The sender never gets its own packets back
+    EXPECT_FALSE(b.Receive(100));
+}
+
+TEST_F(RelayServerTest, MulticastReachesOnlyTheMaskedMembers) {
+    TestClient a(server_->GetPort());
+    TestClient b(server_->GetPort());
+    TestClient c(server_->GetPort());
+    TestClient anonymous(server_->GetPort());
+
+    // Members announce their LDN node id in the session request
+    a.Send(42, RelayProtocol::FLAG_SESSION_CREATE, {0});
+    ASSERT_TRUE(a.ReceiveHeader());
+    b.Send(42, RelayProtocol::FLAG_SESSION_JOIN, {1});
+    ASSERT_TRUE(b.ReceiveHeader());
+    c.Send(42, RelayProtocol::FLAG_SESSION_JOIN, {2});
+    ASSERT_TRUE(c.ReceiveHeader());
+    anonymous.Send(42, RelayProtocol::FLAG_SESSION_JOIN);
+    ASSERT_TRUE(anonymous.ReceiveHeader());
+
+    a.Send(42, RelayProtocol::FLAG_DATA, {0b100, 9}, RelayProtocol::EXT_FLAG_MULTICAST);
+    auto to_c = c.ReceiveHeader();
+    ASSERT_TRUE(to_c);
+    EXPECT_EQ(to_c->extended_flags, RelayProtocol::EXT_FLAG_MULTICAST);
+    EXPECT_EQ(std::vector<uint8_t>(to_c->payload.begin(), to_c->payload.end()),
+              (std::vector<uint8_t>{0b100, 9}));
+    // A member the mask cannot address gets every multicast
+    EXPECT_TRUE(anonymous.ReceiveHeader());
+    EXPECT_FALSE(b.Receive(100));
+
+    a.Send(42, RelayProtocol::FLAG_DATA, {RelayProtocol::MULTICAST_ALL_NODES, 10},
+           RelayProtocol::EXT_FLAG_MULTICAST);
+    EXPECT_TRUE(b.ReceiveHeader());
+    EXPECT_TRUE(c.ReceiveHeader());
+    EXPECT_TRUE(anonymous.ReceiveHeader());
+
+    // A multicast without its mask is malformed
+    a.Send(42, RelayProtocol::FLAG_DATA, {}, RelayProtocol::EXT_FLAG_MULTICAST);
+    EXPECT_FALSE(b.Receive(100));
+
+    const auto statistics = server_->GetStatistics();
+    EXPECT_EQ(statistics.multicast_frames, 2u);
+    EXPECT_EQ(statistics.malformed_dropped, 1u);
+}
+
+TEST_F(RelayServerTest, ResumeCreatesOrJoinsTheSession) {
+    TestClient a(server_->GetPort());
+    TestClient b(server_->GetPort());
+
+    // The first peer to fail over brings the session, the second joins it
+    a.Send(42, RelayProtocol::FLAG_SESSION_RESUME);
+    auto created = a.ReceiveHeader();
+    ASSERT_TRUE(created);
+    EXPECT_EQ(created->flags, RelayProtocol::FLAG_SESSION_RESUME);
+    b.Send(42, RelayProtocol::FLAG_SESSION_RESUME);
+    auto joined = b.ReceiveHeader();
+    ASSERT_TRUE(joined);
+    EXPECT_EQ(joined->flags, RelayProtocol::FLAG_SESSION_RESUME);
+
+    // Sequence numbers carry on from the old relay untouched
+    a.Send(42, RelayProtocol::FLAG_DATA, {7}, 0, 5000);
+    auto data = b.ReceiveHeader();
+    ASSERT_TRUE(data);
+    EXPECT_EQ(data->sequence_num, 5000u);
+
+    const auto statistics = server_->GetStatistics();
+    EXPECT_EQ(statistics.sessions_resumed, 2u);
+    EXPECT_EQ(statistics.sessions_created, 0u);
+    EXPECT_EQ(statistics.session_requests_refused, 0u);
+}
+
+TEST_F(RelayServerTest, RefusesUnknownAndDuplicateSessions) {
+    TestClient a(server_->GetPort());
+    TestClient b(server_->GetPort());
+
+    a.Send(55, RelayProtocol::FLAG_SESSION_JOIN);
+    auto refused = a.ReceiveHeader();
+    ASSERT_TRUE(refused);
+    EXPECT_EQ(refused->flags, RelayProtocol::FLAG_SESSION_JOIN | RelayProtocol::FLAG_CONTROL);
+
+    a.Send(55, RelayProtocol::FLAG_SESSION_CREATE);
+    ASSERT_TRUE(a.ReceiveHeader());
+    b.Send(55, RelayProtocol::FLAG_SESSION_CREATE);
+    auto duplicate = b.ReceiveHeader();
+    ASSERT_TRUE(duplicate);
+    EXPECT_EQ(duplicate->flags, RelayProtocol::FLAG_SESSION_CREATE | RelayProtocol::FLAG_CONTROL);
+
+    // Data for a session nobody created goes nowhere
+    b.Send(56, RelayProtocol::FLAG_DATA, {1});
+    EXPECT_FALSE(a.Receive(100));
+    EXPECT_EQ(server_->GetStatistics().session_requests_refused, 2u);
+}
+
+TEST_F(RelayServerTest, NegotiatesCompressionWithTheCreator) {
+    TestClient a(server_->GetPort());
+    TestClient b(server_->GetPort());
+    TestClient c(server_->GetPort());
+
+    a.Send(8, RelayProtocol::FLAG_SESSION_CREATE, {}, RelayProtocol::EXT_FLAG_COMPRESSED);
+    auto created = a.ReceiveHeader();
+    ASSERT_TRUE(created);
+    EXPECT_EQ(created->extended_flags, RelayProtocol::EXT_FLAG_COMPRESSED);
+
+    b.Send(8, RelayProtocol::FLAG_SESSION_JOIN, {}, RelayProtocol::EXT_FLAG_COMPRESSED);
+    auto joined = b.ReceiveHeader();
+    ASSERT_TRUE(joined);
+    EXPECT_EQ(joined->extended_flags, RelayProtocol::EXT_FLAG_COMPRESSED);
+
+    // A joiner that did not offer is answered without the flag
+    c.Send(8, RelayProtocol::FLAG_SESSION_JOIN);
+    auto plain = c.ReceiveHeader();
+    ASSERT_TRUE(plain);
+    EXPECT_EQ(plain->extended_flags, 0);
+}
+
+TEST_F(RelayServerTest, EchoesKeepalives) {
+    TestClient a(server_->GetPort());
+
+    // Header-only probes, as RelayServerSelector sends, match by sequence
+    a.Send(0, RelayProtocol::FLAG_KEEPALIVE, {}, 0, 99);
+    auto probe = a.ReceiveHeader();
+    ASSERT_TRUE(probe);
+    EXPECT_EQ(probe->flags, RelayProtocol::FLAG_KEEPALIVE);
+    EXPECT_EQ(probe->sequence_num, 99u);
+
+    std::vector<uint8_t> payload(RelayProtocol::KEEPALIVE_PAYLOAD_SIZE);
+    RelayProtocol::WriteKeepalivePayload(payload, 123456, 0);
+    a.Send(0, RelayProtocol::FLAG_KEEPALIVE, payload);
+    auto reply = a.ReceiveHeader();
+    ASSERT_TRUE(reply);
+    uint64_t timestamp_us = 0;
+    uint64_t echo_timestamp_us = 0;
+    uint64_t relay_time_us = 0;
+    ASSERT_TRUE(RelayProtocol::ParseKeepalivePayload(reply->payload, timestamp_us,
+                                                     echo_timestamp_us, relay_time_us));
+    EXPECT_EQ(timestamp_us, 0u);
+    EXPECT_EQ(echo_timestamp_us, 123456u);
+    // Stamped with the relay's clock, for clock synchronization
+    EXPECT_NE(relay_time_us, 0u);
+}
+
+TEST_F(RelayServerTest, MigratedPeerKeepsItsSession) {
+    TestClient a(server_->GetPort());
+    TestClient b(server_->GetPort());
+    Connect(a, b, 77);
+
+    // Same token from a new address, as after UdpRelayTransport::Migrate
+    TestClient migrated(server_->GetPort());
+    migrated.Send(77, RelayProtocol::FLAG_DATA, {4, 2});
+    EXPECT_TRUE(b.ReceiveHeader());
+    b.Send(77, RelayProtocol::FLAG_DATA, {1});
+    EXPECT_TRUE(migrated.ReceiveHeader());
+}
+
+TEST_F(RelayServerTest, LeavingEndsTheSession) {
+    TestClient a(server_->GetPort());
+    TestClient b(server_->GetPort());
+    Connect(a, b, 31);
+    ASSERT_EQ(server_->GetStatistics().active_sessions, 1u);
+
+    a.Send(31, RelayProtocol::FLAG_SESSION_LEAVE);
+    b.Send(31, RelayProtocol::FLAG_SESSION_LEAVE);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (server_->GetStatistics().active_sessions != 0 &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(server_->GetStatistics().active_sessions, 0u);
+}
+
+TEST_F(RelayServerTest, DropsMalformedDatagrams) {
+    TestClient a(server_->GetPort());
+    TestClient b(server_->GetPort());
+    Connect(a, b, 12);
+
+    a.SendRaw({1, 2, 3, 4});
+    // The header claims more payload than the datagram holds
+    std::vector<uint8_t> truncated(sizeof(ModelA::RelayHeader) + 2);
+    RelayProtocol().WriteHeader(truncated, 12, 10, RelayProtocol::FLAG_DATA, 1);
+    a.SendRaw(truncated);
+    EXPECT_FALSE(b.Receive(100));
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (server_->GetStatistics().malformed_dropped < 2 &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(server_->GetStatistics().malformed_dropped, 2u);
+}
+
+TEST_F(RelayServerTest, ExportsMetrics) {
+    TestClient a(server_->GetPort());
+    TestClient b(server_->GetPort());
+    Connect(a, b, 13);
+    a.SendRaw({1, 2, 3, 4});
+    a.Send(13, RelayProtocol::FLAG_DATA, {1, 2, 3});
+    ASSERT_TRUE(b.Receive());
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (server_->GetStatistics().malformed_dropped < 1 &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::string metrics;
+    MetricsWriter writer(metrics);
+    server_->WriteMetrics(writer);
+
+    EXPECT_NE(metrics.find("\nsudachi_relay_sessions 1\n"), std::string::npos) << metrics;
+    EXPECT_NE(metrics.find("\nsudachi_relay_dropped_total{reason=\"malformed\"} 1\n"),
+              std::string::npos);
+    EXPECT_NE(metrics.find("\nsudachi_relay_session_requests_total{result=\"created\"} 1\n"),
+              std::string::npos);
+    EXPECT_NE(metrics.find("# TYPE sudachi_relay_batch_seconds histogram\n"), std::string::npos);
+    // Create, join, the malformed datagram and the data frame, in up to four batches
+    EXPECT_EQ(metrics.find("\nsudachi_relay_batch_seconds_count 0\n"), std::string::npos);
+    EXPECT_EQ(server_->GetStatistics().bytes_received,
+              2 * sizeof(ModelA::RelayHeader) + 4 + sizeof(ModelA::RelayHeader) + 3);
+}
+
+TEST_F(RelayServerTest, CopiesFlaggedFramesToSpectators) {
+    TestClient a(server_->GetPort());
+    TestClient b(server_->GetPort());
+    TestClient spectator(server_->GetPort());
+    Connect(a, b, 64);
+
+    spectator.Send(64, RelayProtocol::FLAG_SESSION_JOIN, {}, RelayProtocol::EXT_FLAG_SPECTATE);
+    auto subscribed = spectator.ReceiveHeader();
+    ASSERT_TRUE(subscribed);
+    EXPECT_EQ(subscribed->flags, RelayProtocol::FLAG_SESSION_JOIN);
+    EXPECT_EQ(subscribed->extended_flags, RelayProtocol::EXT_FLAG_SPECTATE);
+
+    a.Send(64, RelayProtocol::FLAG_DATA, {1}, RelayProtocol::EXT_FLAG_SPECTATE, 10);
+    EXPECT_TRUE(b.ReceiveHeader());
+    auto broadcast = spectator.ReceiveHeader();
+    ASSERT_TRUE(broadcast);
+    EXPECT_EQ(broadcast->sequence_num, 10u);
+    EXPECT_EQ(std::vector<uint8_t>(broadcast->payload.begin(), broadcast->payload.end()),
+              std::vector<uint8_t>{1});
+
+    // Unflagged traffic stays between the members
+    a.Send(64, RelayProtocol::FLAG_DATA, {2}, 0, 11);
+    EXPECT_TRUE(b.ReceiveHeader());
+    EXPECT_FALSE(spectator.Receive(100));
+
+    // A spectator's data reaches nobody, rather than making it a member
+    spectator.Send(64, RelayProtocol::FLAG_DATA, {3});
+    EXPECT_FALSE(a.Receive(100));
+    EXPECT_FALSE(b.Receive(100));
+
+    const auto statistics = server_->GetStatistics();
+    EXPECT_EQ(statistics.spectators_subscribed, 1u);
+    EXPECT_EQ(statistics.spectator_frames, 1u);
+    EXPECT_EQ(statistics.active_spectators, 1u);
+}
+
+TEST_F(RelayServerTest, LateSpectatorsStartFromTheLatestSnapshot) {
+    TestClient a(server_->GetPort());
+    TestClient b(server_->GetPort());
+    TestClient early(server_->GetPort());
+    TestClient late(server_->GetPort());
+    Connect(a, b, 65);
+
+    early.Send(65, RelayProtocol::FLAG_SESSION_JOIN, {}, RelayProtocol::EXT_FLAG_SPECTATE);
+    ASSERT_TRUE(early.ReceiveHeader());
+
+    constexpr uint8_t SNAPSHOT =
+        RelayProtocol::EXT_FLAG_SPECTATE | RelayProtocol::EXT_FLAG_SNAPSHOT;
+    a.Send(65, RelayProtocol::FLAG_DATA, {9, 9}, SNAPSHOT, 20);
+    auto live = early.ReceiveHeader();
+    ASSERT_TRUE(live);
+    EXPECT_EQ(live->extended_flags, SNAPSHOT);
+    // Members never see snapshots
+    EXPECT_FALSE(b.Receive(100));
+
+    late.Send(65, RelayProtocol::FLAG_SESSION_JOIN, {}, RelayProtocol::EXT_FLAG_SPECTATE);
+    auto subscribed = late.ReceiveHeader();
+    ASSERT_TRUE(subscribed);
+    EXPECT_EQ(subscribed->flags, RelayProtocol::FLAG_SESSION_JOIN);
+    auto snapshot = late.ReceiveHeader();
+    ASSERT_TRUE(snapshot);
+    EXPECT_EQ(snapshot->extended_flags, SNAPSHOT);
+    EXPECT_EQ(snapshot->sequence_num, 20u);
+    EXPECT_EQ(std::vector<uint8_t>(snapshot->payload.begin(), snapshot->payload.end()),
+              (std::vector<uint8_t>{9, 9}));
+
+    // Unsubscribed spectators get nothing more
+    late.Send(65, RelayProtocol::FLAG_SESSION_LEAVE, {}, RelayProtocol::EXT_FLAG_SPECTATE);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (server_->GetStatistics().active_spectators != 1 &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    a.Send(65, RelayProtocol::FLAG_DATA, {1}, RelayProtocol::EXT_FLAG_SPECTATE, 21);
+    EXPECT_TRUE(early.ReceiveHeader());
+    EXPECT_FALSE(late.Receive(100));
+    // The members' session is untouched by the spectator leaving
+    EXPECT_TRUE(b.ReceiveHeader());
+}
+
+TEST_F(RelayServerTest, RefusesSpectatorsOfUnknownSessions) {
+    TestClient spectator(server_->GetPort());
+    spectator.Send(99, RelayProtocol::FLAG_SESSION_JOIN, {}, RelayProtocol::EXT_FLAG_SPECTATE);
+    auto refused = spectator.ReceiveHeader();
+    ASSERT_TRUE(refused);
+    EXPECT_EQ(refused->flags, RelayProtocol::FLAG_SESSION_JOIN | RelayProtocol::FLAG_CONTROL);
+    EXPECT_EQ(server_->GetStatistics().spectate_requests_refused, 1u);
+}
+
+TEST_F(RelayServerTest, EdgeRelaysFanOutFromOneUpstreamSubscription) {
+    RelayServerConfig config;
+    config.bind_address = "127.0.0.1";
+    config.port = 0;
+    config.reactor_count = 2;
+    config.pin_reactors = false;
+    config.spectator_upstream = "127.0.0.1:" + std::to_string(server_->GetPort());
+    RelayServer edge(config, timer_wheel_);
+    ASSERT_EQ(edge.Start(), ErrorCode::Success);
+
+    TestClient a(server_->GetPort());
+    TestClient b(server_->GetPort());
+    Connect(a, b, 66);
+
+    TestClient first(edge.GetPort());
+    TestClient second(edge.GetPort());
+    for (TestClient* spectator : {&first, &second}) {
+        spectator->Send(66, RelayProtocol::FLAG_SESSION_JOIN, {}, RelayProtocol::EXT_FLAG_SPECTATE);
+        auto subscribed = spectator->ReceiveHeader();
+        ASSERT_TRUE(subscribed);
+        EXPECT_EQ(subscribed->flags, RelayProtocol::FLAG_SESSION_JOIN);
+    }
+    // The edge subscribes once, however many spectators it serves
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (server_->GetStatistics().active_spectators != 1 &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(server_->GetStatistics().active_spectators, 1u);
+    EXPECT_EQ(edge.GetStatistics().active_spectators, 2u);
+
+    a.Send(66, RelayProtocol::FLAG_DATA, {5}, RelayProtocol::EXT_FLAG_SPECTATE, 30);
+    EXPECT_TRUE(b.ReceiveHeader());
+    for (TestClient* spectator : {&first, &second}) {
+        auto frame = spectator->ReceiveHeader();
+        ASSERT_TRUE(frame);
+        EXPECT_EQ(frame->sequence_num, 30u);
+    }
+    EXPECT_EQ(server_->GetStatistics().spectator_frames, 1u);
+    EXPECT_EQ(edge.GetStatistics().spectator_frames, 2u);
+    edge.Stop();
+}
+
+TEST(RelayServerConfigTest, RejectsAMalformedSpectatorUpstream) {
+    RelayServerConfig config;
+    config.bind_address = "127.0.0.1";
+    config.port = 0;
+    config.reactor_count = 1;
+    config.pin_reactors = false;
+    config.spectator_upstream = "relay.example";
+    RelayServer server(config);
+    EXPECT_EQ(server.Start(), ErrorCode::ConfigurationInvalid);
+}
@@ -0,0 +1,140 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <set>
+#include <vector>
+
+#include "core/multiplayer/relay_server/relay_session_table.h"
+
+using namespace Core::Multiplayer::Relay;
+
+namespace {
+
+RelayEndpoint Endpoint(uint16_t n) {
+    return RelayEndpoint{0x0100007F, n}; // 127.0.0.1, port n in either byte order
+}
+
+} // anonymous namespace
+
+TEST(RelaySessionTableTest, RoutesBetweenPeers) {
+    RelaySessionTable table(16);
+    ASSERT_EQ(table.Create(42, Endpoint(1), false, 0), SessionResult::Accepted);
+    bool compressed = true;
+    ASSERT_EQ(table.Join(42, Endpoint(2), 0, compressed), SessionResult::Accepted);
+    EXPECT_FALSE(compressed);
+
+    RelaySessionTable::PeerList peers;
+    ASSERT_EQ(table.Route(42, Endpoint(1), 0, peers), RouteResult::Routed);
+    ASSERT_EQ(peers.count, 1u);
+    EXPECT_EQ(peers.peers[0], Endpoint(2));
+
+    EXPECT_EQ(table.Route(42, Endpoint(3), 0, peers), RouteResult::NotMember);
+    EXPECT_EQ(peers.count, 0u);
+    EXPECT_EQ(table.Route(43, Endpoint(1), 0, peers), RouteResult::NotFound);
+}
+
+TEST(RelaySessionTableTest, AnswersRetriesLikeTheFirstRequest) {
+    RelaySessionTable table(16);
+    ASSERT_EQ(table.Create(7, Endpoint(1), true, 0), SessionResult::Accepted);
+    EXPECT_EQ(table.Create(7, Endpoint(1), true, 0), SessionResult::AlreadyMember);
+    EXPECT_EQ(table.Create(7, Endpoint(2), true, 0), SessionResult::AlreadyExists);
+
+    bool compressed = false;
+    ASSERT_EQ(table.Join(7, Endpoint(2), 0, compressed), SessionResult::Accepted);
+    EXPECT_TRUE(compressed);
+    EXPECT_EQ(table.Join(7, Endpoint(2), 0, compressed), SessionResult::AlreadyMember);
+    EXPECT_EQ(table.Join(8, Endpoint(2), 0, compressed), SessionResult::NotFound);
+    EXPECT_EQ(table.Create(0, Endpoint(1), false, 0), SessionResult::InvalidToken);
+    EXPECT_EQ(table.GetSessionCount(), 1u);
+}
+
+TEST(RelaySessionTableTest, LimitsPeersAndSessions) {
+    RelaySessionTable table(2);
+    ASSERT_EQ(table.Create(1, Endpoint(1), false, 0), SessionResult::Accepted);
+    bool compressed = false;
+    for (uint16_t i = 2; i <= RelaySessionTable::MAX_SESSION_PEERS; ++i) {
+        ASSERT_EQ(table.Join(1, Endpoint(i), 0, compressed), SessionResult::Accepted);
+    }
+    EXPECT_EQ(table.Join(1, Endpoint(100), 0, compressed), SessionResult::SessionFull);
+
+    RelaySessionTable::PeerList peers;
+    ASSERT_EQ(table.Route(1, Endpoint(1), 0, peers), RouteResult::Routed);
+    EXPECT_EQ(peers.count, RelaySessionTable::MAX_SESSION_PEERS - 1);
+
+    ASSERT_EQ(table.Create(2, Endpoint(1), false, 0), SessionResult::Accepted);
+    EXPECT_EQ(table.Create(3, Endpoint(1), false, 0), SessionResult::TableFull);
+}
+
+TEST(RelaySessionTableTest, SessionEndsWithItsLastPeer) {
+    RelaySessionTable table(16);
+    ASSERT_EQ(table.Create(5, Endpoint(1), false, 0), SessionResult::Accepted);
+    bool compressed = false;
+    ASSERT_EQ(table.Join(5, Endpoint(2), 0, compressed), SessionResult::Accepted);
+
+    EXPECT_TRUE(table.Leave(5, Endpoint(1)));
+    EXPECT_FALSE(table.Leave(5, Endpoint(1)));
+    EXPECT_EQ(table.GetSessionCount(), 1u);
+    EXPECT_TRUE(table.Leave(5, Endpoint(2)));
+    EXPECT_EQ(table.GetSessionCount(), 0u);
+
+    RelaySessionTable::PeerList peers;
+    EXPECT_EQ(table.Route(5, Endpoint(2), 0, peers), RouteResult::NotFound);
+    EXPECT_EQ(table.Create(5, Endpoint(3), false, 0), SessionResult::Accepted);
+}
+
+TEST(RelaySessionTableTest, EvictsIdlePeers) {
+    RelaySessionTable table(16);
+    ASSERT_EQ(table.Create(9, Endpoint(1), false, 0), SessionResult::Accepted);
+    bool compressed = false;
+    ASSERT_EQ(table.Join(9, Endpoint(2), 0, compressed), SessionResult::Accepted);
+
+    // Only the peer that keeps sending stays
+    RelaySessionTable::PeerList peers;
+    ASSERT_EQ(table.Route(9, Endpoint(2), 1000, peers), RouteResult::Routed);
+
+    std::vector<RelayEndpoint> removed;
+    const auto collect = [&](uint32_t token, const RelayEndpoint& peer) {
+        EXPECT_EQ(token, 9u);
+        removed.push_back(peer);
+    };
+    size_t evicted = 0;
+    for (size_t shard = 0; shard < RelaySessionTable::SHARD_COUNT; ++shard) {
+        evicted += table.EvictIdlePeers(shard, 500, collect);
+    }
+    ASSERT_EQ(evicted, 1u);
+    EXPECT_EQ(removed[0], Endpoint(1));
+    EXPECT_EQ(table.GetSessionCount(), 1u);
+
+    for (size_t shard = 0; shard < RelaySessionTable::SHARD_COUNT; ++shard) {
+        evicted += table.EvictIdlePeers(shard, 2000, collect);
+    }
+    EXPECT_EQ(evicted, 2u);
+    EXPECT_EQ(table.GetSessionCount(), 0u);
+}
+
+TEST(RelaySessionTableTest, ChurnKeepsEverySessionReachable) {
+    // Enough sessions that shards see collisions and backward-shift deletion
+    constexpr uint32_t SESSIONS = 4000;
+    RelaySessionTable table(SESSIONS);
+    for (uint32_t token = 1; token <= SESSIONS; ++token) {
+        ASSERT_EQ(table.Create(token, Endpoint(1), false, 0), SessionResult::Accepted) << token;
+    }
+    for (uint32_t token = 1; token <= SESSIONS; token += 2) {
+        ASSERT_TRUE(table.Leave(token, Endpoint(1)));
+    }
+
+    RelaySessionTable::PeerList peers;
+    for (uint32_t token = 1; token <= SESSIONS; ++token) {
+        const RouteResult expected = token % 2 == 0 ? RouteResult::Routed : RouteResult::NotFound;
+        ASSERT_EQ(table.Route(token, Endpoint(1), 0, peers), expected) << token;
+    }
+    EXPECT_EQ(table.GetSessionCount(), SESSIONS / 2);
+}
+
+TEST(RelaySessionTableTest, FormatsEndpoints) {
+    const RelayEndpoint endpoint{0x0100A8C0, 0x5020}; // 192.168.0.1:8272, network byte order
+    EXPECT_EQ(endpoint.ToAddressString(), "192.168.0.1");
+    EXPECT_EQ(endpoint.ToString(), "192.168.0.1:8272");
+}
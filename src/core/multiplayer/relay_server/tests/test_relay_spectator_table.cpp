@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "core/multiplayer/relay_server/relay_spectator_table.h"
+
+using namespace Core::Multiplayer::Relay;
+
+namespace {
+
+RelayEndpoint Endpoint(uint16_t n) {
+    return RelayEndpoint{0x0100007F, n}; // 127.0.0.1, port n in either byte order
+}
+
+} // anonymous namespace
+
+TEST(RelaySpectatorTableTest, SubscribesUpToTheSessionLimit) {
+    RelaySpectatorTable table(4, 2);
+    bool first = false;
+    EXPECT_EQ(table.Subscribe(42, Endpoint(1), 0, false, first), SpectateResult::Accepted);
+    EXPECT_TRUE(first);
+    EXPECT_EQ(table.Subscribe(42, Endpoint(2), 0, false, first), SpectateResult::Accepted);
+    EXPECT_FALSE(first);
+    EXPECT_EQ(table.Subscribe(42, Endpoint(1), 0, false, first),
+              SpectateResult::AlreadySubscribed);
+    EXPECT_EQ(table.Subscribe(42, Endpoint(3), 0, false, first), SpectateResult::SessionFull);
+    EXPECT_EQ(table.Subscribe(0, Endpoint(3), 0, false, first), SpectateResult::InvalidToken);
+
+    std::vector<RelayEndpoint> spectators;
+    EXPECT_EQ(table.CopySpectators(42, spectators), 2u);
+    EXPECT_TRUE(table.IsSubscribed(42, Endpoint(2)));
+    EXPECT_FALSE(table.IsSubscribed(42, Endpoint(3)));
+    EXPECT_EQ(table.GetSpectatorCount(), 2u);
+    EXPECT_EQ(table.GetSessionCount(), 1u);
+}
+
+TEST(RelaySpectatorTableTest, SessionGoesWithItsLastSpectator) {
+    RelaySpectatorTable table(1, 8);
+    bool first = false;
+    ASSERT_EQ(table.Subscribe(42, Endpoint(1), 0, true, first), SpectateResult::Accepted);
+    EXPECT_EQ(table.Subscribe(43, Endpoint(1), 0, false, first), SpectateResult::TableFull);
+
+    bool upstream = false;
+    EXPECT_FALSE(table.Unsubscribe(42, Endpoint(2), upstream));
+    ASSERT_TRUE(table.Unsubscribe(42, Endpoint(1), upstream));
+    // The last spectator of an upstream-fed session ends the upstream subscription
+    EXPECT_TRUE(upstream);
+    EXPECT_EQ(table.GetSessionCount(), 0u);
+    EXPECT_EQ(table.Subscribe(43, Endpoint(1), 0, false, first), SpectateResult::Accepted);
+}
+
+TEST(RelaySpectatorTableTest, KeepsTheLatestSnapshot) {
+    RelaySpectatorTable table(4, 4);
+    const std::vector<uint8_t> fragment_a{1, 2};
+    const std::vector<uint8_t> fragment_b{3};
+    EXPECT_FALSE(table.StoreSnapshot(42, 10, fragment_a));
+
+    bool first = false;
+    ASSERT_EQ(table.Subscribe(42, Endpoint(1), 0, false, first), SpectateResult::Accepted);
+    std::vector<std::vector<uint8_t>> snapshot;
+    EXPECT_FALSE(table.GetSnapshot(42, snapshot));
+
+    // Fragments of one snapshot share its sequence number
+    ASSERT_TRUE(table.StoreSnapshot(42, 10, fragment_a));
+    ASSERT_TRUE(table.StoreSnapshot(42, 10, fragment_b));
+    ASSERT_TRUE(table.GetSnapshot(42, snapshot));
+    EXPECT_EQ(snapshot, (std::vector<std::vector<uint8_t>>{fragment_a, fragment_b}));
+
+    ASSERT_TRUE(table.StoreSnapshot(42, 20, fragment_b));
+    ASSERT_TRUE(table.GetSnapshot(42, snapshot));
+    EXPECT_EQ(snapshot, (std::vector<std::vector<uint8_t>>{fragment_b}));
+}
+
+TEST(RelaySpectatorTableTest, RefreshesTheUpstreamSubscriptionOnKeepalives) {
+    RelaySpectatorTable table(4, 4);
+    bool first = false;
+    ASSERT_EQ(table.Subscribe(42, Endpoint(1), 0, true, first), SpectateResult::Accepted);
+    ASSERT_EQ(table.Subscribe(43, Endpoint(1), 0, false, first), SpectateResult::Accepted);
+
+    EXPECT_FALSE(table.Touch(42, Endpoint(1), 500, 1000));
+    EXPECT_TRUE(table.Touch(42, Endpoint(1), 1000, 1000));
+    // One refresh per interval, however many spectators send keepalives
+    EXPECT_FALSE(table.Touch(42, Endpoint(1), 1500, 1000));
+    EXPECT_FALSE(table.Touch(43, Endpoint(1), 5000, 1000));
+    EXPECT_FALSE(table.Touch(42, Endpoint(2), 5000, 1000));
+}
+
+TEST(RelaySpectatorTableTest, EvictsIdleSpectatorsAndEndedSessions) {
+    RelaySpectatorTable table(64, 4);
+    bool first = false;
+    ASSERT_EQ(table.Subscribe(1, Endpoint(1), 0, true, first), SpectateResult::Accepted);
+    ASSERT_EQ(table.Subscribe(2, Endpoint(1), 100, false, first), SpectateResult::Accepted);
+    ASSERT_EQ(table.Subscribe(3, Endpoint(1), 100, false, first), SpectateResult::Accepted);
+
+    std::vector<uint32_t> upstream_emptied;
+    size_t evicted = 0;
+    for (size_t shard = 0; shard < RelaySpectatorTable::SHARD_COUNT; ++shard) {
+        evicted += table.EvictIdle(
+            shard, 50, [](uint32_t session_token) { return session_token != 3; },
+            [&](uint32_t session_token) { upstream_emptied.push_back(session_token); });
+    }
+    // Session 1 idled out, session 3 ended while its spectator was still active
+    EXPECT_EQ(evicted, 2u);
+    EXPECT_EQ(upstream_emptied, std::vector<uint32_t>{1});
+    EXPECT_TRUE(table.IsSubscribed(2, Endpoint(1)));
+    EXPECT_FALSE(table.IsSubscribed(3, Endpoint(1)));
+    EXPECT_EQ(table.GetSpectatorCount(), 1u);
+    EXPECT_EQ(table.GetSessionCount(), 1u);
+}
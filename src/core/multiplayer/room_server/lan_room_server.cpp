@@ -0,0 +1,512 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "lan_room_server.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <string_view>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "core/multiplayer/common/monotonic_clock.h"
+
+namespace Core::Multiplayer::LanRoom {
+
+namespace {
+
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0; // SO_NOSIGPIPE is set per socket instead
+#endif
+
+// Close status codes, RFC 6455 section 7.4.1
+constexpr uint16_t CLOSE_PROTOCOL_ERROR = 1002;
+constexpr uint16_t CLOSE_TOO_LARGE = 1009;
+
+constexpr std::string_view BAD_REQUEST_RESPONSE =
+    "HTTP/1.1 400 Bad Request\r\nConnection: close\r\nContent-Length: 0\r\n\r\n";
+
+bool SetNonBlocking(int fd) {
+    const int flags = ::fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+std::string FormatUrl(std::string_view address, uint16_t port) {
+    std::string url = "ws://";
+    if (address.find(':') != std::string_view::npos) {
+        url += '[';
+        url += address;
+        url += ']';
+    } else {
+        url += address;
+    }
+    url += ':';
+    url += std::to_string(port);
+    url += '/';
+    return url;
+}
+
+} // namespace
+
+LanRoomServer::LanRoomServer(const LanRoomServerConfig& config)
+    : config_(config), service_(config, [this](ConnectionId id, std::string_view message) {
+          QueueMessage(id, message);
+      }) {}
+
+LanRoomServer::~LanRoomServer() {
+    Stop();
+}
+
+ErrorCode LanRoomServer::Start() {
+    if (running_) {
+        return ErrorCode::InvalidState;
+    }
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(config_.port);
+    if (::inet_pton(AF_INET, config_.bind_address.c_str(), &address.sin_addr) != 1) {
+        return ErrorCode::ConfigurationInvalid;
+    }
+
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) {
+        return ErrorCode::NetworkError;
+    }
+    const int enable = 1;
+    ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    if (::bind(listen_fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listen_fd_, SOMAXCONN) != 0 || !SetNonBlocking(listen_fd_)) {
+        Stop();
+        return ErrorCode::ConnectionRefused;
+    }
+
+    int wake[2];
+    if (::pipe(wake) != 0) {
+        Stop();
+        return ErrorCode::ResourceExhausted;
+    }
+    wake_read_fd_ = wake[0];
+    wake_write_fd_ = wake[1];
+    SetNonBlocking(wake_read_fd_);
+
+    sockaddr_in bound{};
+    socklen_t length = sizeof(bound);
+    ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&bound), &length);
+    port_ = ntohs(bound.sin_port);
+
+    stop_requested_.store(false, std::memory_order_release);
+    thread_ = std::thread([this] { Run(); });
+    running_ = true;
+    return ErrorCode::Success;
+}
+
+void LanRoomServer::Stop() {
+    stop_requested_.store(true, std::memory_order_release);
+    if (wake_write_fd_ >= 0) {
+        const uint8_t wake = 1;
+        [[maybe_unused]] const ssize_t written = ::write(wake_write_fd_, &wake, sizeof(wake));
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    for (int* fd : {&listen_fd_, &wake_read_fd_, &wake_write_fd_}) {
+        if (*fd >= 0) {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
+    running_ = false;
+    port_ = 0;
+}
+
+std::string LanRoomServer::GetUrl(std::string_view address) const {
+    return FormatUrl(address, port_);
+}
+
+ModelB::GameSessionInfo LanRoomServer::MakeAdvertisement(const std::string& host_name,
+                                                         const std::string& host_ip) const {
+    ModelB::GameSessionInfo info;
+    info.game_id = std::string(LAN_ROOM_SERVER_GAME_ID);
+    info.version = config_.server_version;
+    info.current_players = static_cast<int>(GetClientCount());
+    info.max_players = static_cast<int>(config_.max_clients);
+    info.has_password = false;
+    info.host_name = host_name;
+    info.host_ip = host_ip;
+    info.port = port_;
+    info.session_id = host_name + "-rooms";
+    return info;
+}
+
+LanRoomServerStatistics LanRoomServer::GetStatistics() const {
+    LanRoomServerStatistics statistics = service_.GetStatistics();
+    statistics.connections_accepted = connections_accepted_.load(std::memory_order_relaxed);
+    statistics.connections_refused = connections_refused_.load(std::memory_order_relaxed);
+    statistics.idle_disconnects = idle_disconnects_.load(std::memory_order_relaxed);
+    statistics.messages_received = messages_received_.load(std::memory_order_relaxed);
+    statistics.messages_sent = messages_sent_.load(std::memory_order_relaxed);
+    statistics.protocol_errors += protocol_errors_.load(std::memory_order_relaxed);
+    return statistics;
+}
+
+void LanRoomServer::WriteMetrics(MetricsWriter& writer) const {
+    const LanRoomServerStatistics statistics = GetStatistics();
+    writer.Gauge("sudachi_lan_room_clients", "Registered clients",
+                 static_cast<double>(GetClientCount()));
+    writer.Gauge("sudachi_lan_room_rooms", "Open rooms", static_cast<double>(GetRoomCount()));
+
+    constexpr std::string_view CONNECTIONS = "sudachi_lan_room_connections_total";
+    constexpr std::string_view CONNECTIONS_HELP = "Connections by outcome";
+    writer.Counter(CONNECTIONS, CONNECTIONS_HELP, statistics.connections_accepted,
+                   {{"result", "accepted"}});
+    writer.Counter(CONNECTIONS, CONNECTIONS_HELP, statistics.connections_refused,
+                   {{"result", "refused"}});
+    writer.Counter("sudachi_lan_room_idle_disconnects_total", "Clients dropped as idle",
+                   statistics.idle_disconnects);
+    writer.Counter("sudachi_lan_room_messages_received_total", "Messages received",
+                   statistics.messages_received);
+    writer.Counter("sudachi_lan_room_messages_sent_total", "Messages sent",
+                   statistics.messages_sent);
+    writer.Counter("sudachi_lan_room_protocol_errors_total", "Malformed frames or messages",
+                   statistics.protocol_errors);
+    writer.Counter("sudachi_lan_room_rooms_created_total", "Rooms created",
+                   statistics.rooms_created);
+
+    constexpr std::string_view JOINS = "sudachi_lan_room_joins_total";
+    constexpr std::string_view JOINS_HELP = "Room joins by outcome";
+    writer.Counter(JOINS, JOINS_HELP, statistics.joins, {{"result", "joined"}});
+    writer.Counter(JOINS, JOINS_HELP, statistics.joins_refused, {{"result", "refused"}});
+    writer.Counter("sudachi_lan_room_p2p_forwarded_total", "P2P signalling messages forwarded",
+                   statistics.p2p_forwarded);
+
+    writer.Histogram("sudachi_lan_room_message_seconds",
+                     "Time the service took to handle a message", message_latency_);
+}
+
+void LanRoomServer::Run() {
+    std::vector<pollfd> descriptors;
+    std::vector<ConnectionId> polled;
+    std::vector<ConnectionId> to_close;
+    Clock::time_point last_sweep = Clock::now();
+
+    while (!stop_requested_.load(std::memory_order_acquire)) {
+        descriptors.clear();
+        polled.clear();
+        descriptors.push_back({listen_fd_, POLLIN, 0});
+        descriptors.push_back({wake_read_fd_, POLLIN, 0});
+        for (const auto& [id, connection] : connections_) {
+            short events = connection.closing ? 0 : POLLIN;
+            if (connection.outbound_offset < connection.outbound.size()) {
+                events |= POLLOUT;
+            }
+            descriptors.push_back({connection.fd, events, 0});
+            polled.push_back(id);
+        }
+
+        const int ready = ::poll(descriptors.data(), descriptors.size(),
+                                 static_cast<int>(SWEEP_INTERVAL.count()));
+        if (ready < 0 && errno != EINTR) {
+            break;
+        }
+        const Clock::time_point now = Clock::now();
+        if (descriptors[1].revents != 0) {
+            uint8_t drain[64];
+            while (::read(wake_read_fd_, drain, sizeof(drain)) > 0) {
+            }
+        }
+        if ((descriptors[0].revents & POLLIN) != 0) {
+            AcceptPending(now);
+        }
+
+        to_close.clear();
+        for (size_t i = 0; i < polled.size(); ++i) {
+            const short revents = descriptors[i + 2].revents;
+            const auto it = connections_.find(polled[i]);
+            if (revents == 0 || it == connections_.end()) {
+                continue;
+            }
+            bool keep = (revents & (POLLERR | POLLNVAL)) == 0;
+            if (keep && (revents & (POLLIN | POLLHUP)) != 0) {
+                keep = ReadFrom(it->first, it->second, now);
+            }
+            if (!keep) {
+                to_close.push_back(it->first);
+            }
+        }
+        for (const ConnectionId id : to_close) {
+            Close(id);
+        }
+
+        // Answers may be for any client, not just those that sent something
+        to_close.clear();
+        for (auto& [id, connection] : connections_) {
+            if (connection.overflowed || !Flush(connection) ||
+                (connection.closing && connection.outbound.empty())) {
+                to_close.push_back(id);
+            }
+        }
+        if (now - last_sweep >= SWEEP_INTERVAL) {
+            last_sweep = now;
+            for (const auto& [id, connection] : connections_) {
+                if (now - connection.last_activity >= config_.idle_timeout &&
+                    std::find(to_close.begin(), to_close.end(), id) == to_close.end()) {
+                    idle_disconnects_.fetch_add(1, std::memory_order_relaxed);
+                    to_close.push_back(id);
+                }
+            }
+        }
+        for (const ConnectionId id : to_close) {
+            Close(id);
+        }
+    }
+    CloseAll();
+}
+
+void LanRoomServer::AcceptPending(Clock::time_point now) {
+    while (true) {
+        const int fd = ::accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0) {
+            return; // Drained, or a client that went away before being taken
+        }
+        if (connections_.size() >= config_.max_clients || !SetNonBlocking(fd)) {
+            connections_refused_.fetch_add(1, std::memory_order_relaxed);
+            ::close(fd);
+            continue;
+        }
+        const int enable = 1;
+        // Room messages are small and answered at once; do not hold them back
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+#ifdef SO_NOSIGPIPE
+        ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &enable, sizeof(enable));
+#endif
+        Connection& connection = connections_[next_connection_id_++];
+        connection.fd = fd;
+        connection.last_activity = now;
+        connections_accepted_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool LanRoomServer::ReadFrom(ConnectionId id, Connection& connection, Clock::time_point now) {
+    while (true) {
+        const ssize_t received = ::recv(connection.fd, read_buffer_.data(), read_buffer_.size(), 0);
+        if (received == 0) {
+            return false;
+        }
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            return false;
+        }
+        connection.last_activity = now;
+        if (connection.closing) {
+            continue; // Whatever follows a close is dropped
+        }
+        connection.inbound.insert(connection.inbound.end(), read_buffer_.begin(),
+                                  read_buffer_.begin() + received);
+        if (static_cast<size_t>(received) < read_buffer_.size()) {
+            break;
+        }
+    }
+    if (connection.closing) {
+        return true;
+    }
+    if (!connection.upgraded && !HandleHandshake(id, connection)) {
+        return true;
+    }
+    HandleFrames(id, connection);
+    return true;
+}
+
+bool LanRoomServer::HandleHandshake(ConnectionId id, Connection& connection) {
+    const std::string_view received(reinterpret_cast<const char*>(connection.inbound.data()),
+                                    connection.inbound.size());
+    const size_t end = received.find("\r\n\r\n");
+    if (end == std::string_view::npos) {
+        if (received.size() > MAX_HANDSHAKE_SIZE) {
+            connections_refused_.fetch_add(1, std::memory_order_relaxed);
+            connection.outbound = BAD_REQUEST_RESPONSE;
+            connection.closing = true;
+        }
+        return false;
+    }
+    const auto key = ParseUpgradeRequest(received.substr(0, end + 4));
+    if (!key) {
+        connections_refused_.fetch_add(1, std::memory_order_relaxed);
+        connection.outbound = BAD_REQUEST_RESPONSE;
+        connection.closing = true;
+        return false;
+    }
+    connection.outbound = MakeUpgradeResponse(*key);
+    connection.inbound.erase(connection.inbound.begin(), connection.inbound.begin() + end + 4);
+    connection.upgraded = true;
+    service_.OnConnected(id);
+    return true;
+}
+
+void LanRoomServer::HandleFrames(ConnectionId id, Connection& connection) {
+    size_t consumed = 0;
+    while (!connection.closing) {
+        WebSocketFrame frame;
+        const auto result =
+            ParseClientFrame(std::span(connection.inbound).subspan(consumed),
+                             config_.max_message_size, frame);
+        if (result == FrameParseResult::Incomplete) {
+            break;
+        }
+        if (result != FrameParseResult::Complete) {
+            FailConnection(connection, result == FrameParseResult::TooLarge ? CLOSE_TOO_LARGE
+                                                                            : CLOSE_PROTOCOL_ERROR);
+            return;
+        }
+        consumed += frame.frame_size;
+        const std::string_view payload(reinterpret_cast<const char*>(frame.payload.data()),
+                                       frame.payload.size());
+
+        switch (frame.opcode) {
+        case WebSocketOpcode::Ping:
+            AppendServerFrame(WebSocketOpcode::Pong, frame.payload, connection.outbound);
+            break;
+        case WebSocketOpcode::Pong:
+            break;
+        case WebSocketOpcode::Close:
+            // Echo the status and hang up once it is written
+            AppendServerFrame(WebSocketOpcode::Close, frame.payload.first(std::min<size_t>(
+                                                          frame.payload.size(), 2)),
+                              connection.outbound);
+            connection.closing = true;
+            break;
+        case WebSocketOpcode::Text:
+        case WebSocketOpcode::Binary:
+            if (connection.in_message) {
+                FailConnection(connection, CLOSE_PROTOCOL_ERROR);
+                return;
+            }
+            if (frame.opcode == WebSocketOpcode::Binary) {
+                // The binary wire format is never agreed to here
+                protocol_errors_.fetch_add(1, std::memory_order_relaxed);
+                connection.in_message = !frame.fin;
+                connection.message.clear();
+                break;
+            }
+            if (frame.fin) {
+                Deliver(id, payload);
+            } else {
+                connection.in_message = true;
+                connection.message.assign(payload);
+            }
+            break;
+        case WebSocketOpcode::Continuation:
+            if (!connection.in_message ||
+                connection.message.size() + payload.size() > config_.max_message_size) {
+                FailConnection(connection, connection.in_message ? CLOSE_TOO_LARGE
+                                                                 : CLOSE_PROTOCOL_ERROR);
+                return;
+            }
+            connection.message.append(payload);
+            if (frame.fin) {
+                connection.in_message = false;
+                Deliver(id, connection.message);
+                connection.message.clear();
+            }
+            break;
+        }
+    }
+    connection.inbound.erase(connection.inbound.begin(),
+                             connection.inbound.begin() + std::min(consumed,
+                                                                   connection.inbound.size()));
+}
+
+void LanRoomServer::FailConnection(Connection& connection, uint16_t status) {
+    protocol_errors_.fetch_add(1, std::memory_order_relaxed);
+    const uint8_t payload[2] = {static_cast<uint8_t>(status >> 8), static_cast<uint8_t>(status)};
+    AppendServerFrame(WebSocketOpcode::Close, payload, connection.outbound);
+    connection.closing = true;
+    connection.inbound.clear();
+}
+
+void LanRoomServer::Deliver(ConnectionId id, std::string_view message) {
+    messages_received_.fetch_add(1, std::memory_order_relaxed);
+    const uint64_t start = MonotonicClock::Now();
+    service_.OnMessage(id, message);
+    const uint64_t end = MonotonicClock::Now();
+    message_latency_.Record(end > start ? end - start : 0);
+}
+
+void LanRoomServer::QueueMessage(ConnectionId id, std::string_view message) {
+    const auto it = connections_.find(id);
+    if (it == connections_.end() || it->second.closing) {
+        return;
+    }
+    Connection& connection = it->second;
+    AppendServerFrame(WebSocketOpcode::Text,
+                      {reinterpret_cast<const uint8_t*>(message.data()), message.size()},
+                      connection.outbound);
+    messages_sent_.fetch_add(1, std::memory_order_relaxed);
+    if (connection.outbound.size() - connection.outbound_offset > config_.max_pending_send) {
+        connection.overflowed = true;
+    }
+}
+
+bool LanRoomServer::Flush(Connection& connection) {
+    while (connection.outbound_offset < connection.outbound.size()) {
+        const ssize_t sent = ::send(connection.fd, connection.outbound.data() + connection.outbound_offset,
+                                    connection.outbound.size() - connection.outbound_offset,
+                                    SEND_FLAGS);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        connection.outbound_offset += static_cast<size_t>(sent);
+    }
+    connection.outbound.clear();
+    connection.outbound_offset = 0;
+    return true;
+}
+
+void LanRoomServer::Close(ConnectionId id) {
+    const auto it = connections_.find(id);
+    if (it == connections_.end()) {
+        return;
+    }
+    const int fd = it->second.fd;
+    const bool upgraded = it->second.upgraded;
+    connections_.erase(it);
+    ::close(fd);
+    if (upgraded) {
+        // Tells the rest of the room, whose frames go out on the next flush
+        service_.OnDisconnected(id);
+    }
+}
+
+void LanRoomServer::CloseAll() {
+    while (!connections_.empty()) {
+        Close(connections_.begin()->first);
+    }
+}
+
+std::optional<std::string> LanRoomServerUrl(const ModelB::GameSessionInfo& service) {
+    if (service.game_id != LAN_ROOM_SERVER_GAME_ID || service.port == 0) {
+        return std::nullopt;
+    }
+    const std::string& address = !service.host_ipv4.empty() ? service.host_ipv4 : service.host_ip;
+    if (address.empty()) {
+        return std::nullopt;
+    }
+    return FormatUrl(address, service.port);
+}
+
+} // namespace Core::Multiplayer::LanRoom
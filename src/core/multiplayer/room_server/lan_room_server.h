@@ -0,0 +1,207 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "core/multiplayer/common/error_codes.h"
+#include "core/multiplayer/common/latency_histogram.h"
+#include "core/multiplayer/common/metrics_writer.h"
+#include "core/multiplayer/model_a/room_client.h"
+#include "core/multiplayer/model_b/mdns_discovery.h"
+#include "lan_room_service.h"
+#include "lan_room_types.h"
+#include "websocket_framing.h"
+
+namespace Core::Multiplayer::LanRoom {
+
+/**
+ * In-process room server for LAN events without internet, speaking the
+ * room_messages.h protocol over WebSocket so RoomClient connects to it as
+ * to the internet room server, only without the WAN round trips.
+ *
+ * One thread runs a poll() loop over the listening socket and every client:
+ * upgrade handshakes, frames, pings and closes are handled there, and each
+ * text message goes to a LanRoomService whose answers are queued on the
+ * clients they are for and written once the loop has handled what arrived.
+ * Between messages the loop sleeps in poll, waking once a second to drop
+ * clients silent past idle_timeout, so hundreds of clients cost next to no
+ * CPU. Writes never block the loop; a client whose backlog exceeds
+ * max_pending_send is disconnected.
+ *
+ * The host advertises it with MdnsDiscovery::AdvertiseService and
+ * MakeAdvertisement; other hosts turn the discovered service into a URL with
+ * LanRoomServerUrl and hand it to RoomClient through LanRoomConfigProvider.
+ *
+ * Usage:
+ *   LanRoomServer server(LanRoomServerConfig{});
+ *   if (server.Start() == ErrorCode::Success) {
+ *       mdns.AdvertiseService(server.MakeAdvertisement(host_name, host_ip));
+ *       ...
+ *       server.Stop();
+ *   }
+ */
+class LanRoomServer {
+public:
+    static constexpr std::chrono::milliseconds SWEEP_INTERVAL{1000};
+
+    explicit LanRoomServer(const LanRoomServerConfig& config);
+    ~LanRoomServer();
+
+    LanRoomServer(const LanRoomServer&) = delete;
+    LanRoomServer& operator=(const LanRoomServer&) = delete;
+
+    // Binds and listens, then starts the event loop
+    ErrorCode Start();
+    // Disconnects every client and stops the event loop
+    void Stop();
+    bool IsRunning() const { return running_; }
+
+    // Bound port, which differs from the configured one when that is 0
+    uint16_t GetPort() const { return port_; }
+    // ws:// URL of this server at address, as RoomClient takes it
+    std::string GetUrl(std::string_view address) const;
+
+    // The mDNS service announcing this server, under LAN_ROOM_SERVER_GAME_ID
+    ModelB::GameSessionInfo MakeAdvertisement(const std::string& host_name,
+                                              const std::string& host_ip) const;
+
+    size_t GetClientCount() const { return service_.GetClientCount(); }
+    size_t GetRoomCount() const { return service_.GetRoomCount(); }
+    LanRoomServerStatistics GetStatistics() const;
+
+    // The statistics, counts and message handling time as sudachi_lan_room_*
+    // metrics; a collector for MetricsExporter
+    void WriteMetrics(MetricsWriter& writer) const;
+
+private:
+    using ConnectionId = LanRoomService::ConnectionId;
+    using Clock = std::chrono::steady_clock;
+
+    struct Connection {
+        int fd = -1;
+        bool upgraded = false;
+        bool closing = false;    // Closed once the outbound bytes are written
+        bool overflowed = false; // Closed at once; the client stopped reading
+        std::vector<uint8_t> inbound;
+        std::string outbound;
+        size_t outbound_offset = 0;
+        // A fragmented message being put together
+        bool in_message = false;
+        std::string message;
+        Clock::time_point last_activity;
+    };
+
+    void Run();
+    void AcceptPending(Clock::time_point now);
+    // @return False to close the connection at once
+    bool ReadFrom(ConnectionId id, Connection& connection, Clock::time_point now);
+    bool HandleHandshake(ConnectionId id, Connection& connection);
+    void HandleFrames(ConnectionId id, Connection& connection);
+    void FailConnection(Connection& connection, uint16_t status);
+    void Deliver(ConnectionId id, std::string_view message);
+    void QueueMessage(ConnectionId id, std::string_view message);
+    bool Flush(Connection& connection);
+    void Close(ConnectionId id);
+    void CloseAll();
+
+    const LanRoomServerConfig config_;
+    LanRoomService service_;
+    bool running_ = false;
+    uint16_t port_ = 0;
+
+    int listen_fd_ = -1;
+    int wake_read_fd_ = -1;
+    int wake_write_fd_ = -1;
+    std::atomic<bool> stop_requested_{false};
+    std::thread thread_;
+
+    // Event loop state; only the loop thread touches it
+    std::unordered_map<ConnectionId, Connection> connections_;
+    ConnectionId next_connection_id_ = 1;
+    std::array<uint8_t, 16 * 1024> read_buffer_{};
+
+    std::atomic<uint64_t> connections_accepted_{0};
+    std::atomic<uint64_t> connections_refused_{0};
+    std::atomic<uint64_t> idle_disconnects_{0};
+    std::atomic<uint64_t> messages_received_{0};
+    std::atomic<uint64_t> messages_sent_{0};
+    std::atomic<uint64_t> protocol_errors_{0};
+    // From a complete message to the service having answered it
+    LatencyHistogram message_latency_;
+};
+
+/**
+ * Room server URL of a service MdnsDiscovery found
+ * @return Nothing unless it was advertised by a LanRoomServer
+ */
+std::optional<std::string> LanRoomServerUrl(const ModelB::GameSessionInfo& service);
+
+/**
+ * Points RoomClient at a LAN room server through the usual
+ * GetRoomServerUrl path; everything else comes from base. The binary wire
+ * format is not offered, as the LAN server only speaks JSON.
+ */
+class LanRoomConfigProvider : public ModelA::IConfigProvider {
+public:
+    LanRoomConfigProvider(std::shared_ptr<const ModelA::IConfigProvider> base, std::string url)
+        : base_(std::move(base)), url_(std::move(url)) {}
+
+    std::string GetRoomServerUrl() const override { return url_; }
+    std::string GetAuthToken() const override { return base_->GetAuthToken(); }
+    std::chrono::milliseconds GetConnectionTimeout() const override {
+        return base_->GetConnectionTimeout();
+    }
+    std::chrono::milliseconds GetHeartbeatInterval() const override {
+        return base_->GetHeartbeatInterval();
+    }
+    std::chrono::milliseconds GetMessageTimeout() const override {
+        return base_->GetMessageTimeout();
+    }
+    bool IsAutoReconnectEnabled() const override { return base_->IsAutoReconnectEnabled(); }
+    int GetMaxReconnectAttempts() const override { return base_->GetMaxReconnectAttempts(); }
+    std::chrono::milliseconds GetReconnectBaseDelay() const override {
+        return base_->GetReconnectBaseDelay();
+    }
+    double GetReconnectBackoffMultiplier() const override {
+        return base_->GetReconnectBackoffMultiplier();
+    }
+    std::chrono::milliseconds GetMaxReconnectDelay() const override {
+        return base_->GetMaxReconnectDelay();
+    }
+    bool ShouldReconnectOnError(const std::string& error_type) const override {
+        return base_->ShouldReconnectOnError(error_type);
+    }
+    int GetMaxConcurrentMessages() const override { return base_->GetMaxConcurrentMessages(); }
+    size_t GetMessageQueueSize() const override { return base_->GetMessageQueueSize(); }
+    std::chrono::milliseconds GetMaxHeartbeatInterval() const override {
+        return base_->GetMaxHeartbeatInterval();
+    }
+    bool IsBinaryWireFormatEnabled() const override { return false; }
+    bool IsMessageCompressionEnabled() const override {
+        return base_->IsMessageCompressionEnabled();
+    }
+    std::chrono::milliseconds GetMembershipBatchWindow() const override {
+        return base_->GetMembershipBatchWindow();
+    }
+    uint64_t GetReconnectJitterSeed() const override { return base_->GetReconnectJitterSeed(); }
+
+private:
+    std::shared_ptr<const ModelA::IConfigProvider> base_;
+    std::string url_;
+};
+
+} // namespace Core::Multiplayer::LanRoom
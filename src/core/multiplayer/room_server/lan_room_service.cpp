@@ -0,0 +1,554 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "lan_room_service.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+
+#include "core/multiplayer/model_a/room_message_router.h"
+
+namespace Core::Multiplayer::LanRoom {
+
+using ModelA::MessageType;
+using ModelA::MessageTypeName;
+
+namespace {
+
+constexpr int MAX_ROOM_PLAYERS = 16;
+constexpr int MAX_PAGE_SIZE = 100;
+
+uint32_t RequestId(const nlohmann::json& j) {
+    const auto it = j.find("request_id");
+    return it != j.end() && it->is_number_unsigned() ? it->get<uint32_t>() : 0;
+}
+
+std::string String(const nlohmann::json& j, const char* key) {
+    const auto it = j.find(key);
+    return it != j.end() && it->is_string() ? it->get<std::string>() : std::string{};
+}
+
+int Int(const nlohmann::json& j, const char* key, int fallback) {
+    const auto it = j.find(key);
+    return it != j.end() && it->is_number_integer() ? it->get<int>() : fallback;
+}
+
+bool Bool(const nlohmann::json& j, const char* key) {
+    const auto it = j.find(key);
+    return it != j.end() && it->is_boolean() && it->get<bool>();
+}
+
+// Game ids travel as 16 upper-case hex digits; anything else reads as 0
+uint64_t GameId(const nlohmann::json& j) {
+    const std::string text = String(j, "game_id");
+    uint64_t value = 0;
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value, 16);
+    return error == std::errc{} && end == text.data() + text.size() ? value : 0;
+}
+
+std::string GameIdString(uint64_t game_id) {
+    char text[17];
+    std::snprintf(text, sizeof(text), "%016llX", static_cast<unsigned long long>(game_id));
+    return text;
+}
+
+// Ids sort in the order they were handed out
+std::string SerialId(std::string_view prefix, uint64_t serial) {
+    char text[24];
+    std::snprintf(text, sizeof(text), "%08llu", static_cast<unsigned long long>(serial));
+    return std::string(prefix) + text;
+}
+
+uint64_t UnsignedInt(const nlohmann::json& j, const char* key) {
+    const auto it = j.find(key);
+    return it != j.end() && it->is_number_unsigned() ? it->get<uint64_t>() : 0;
+}
+
+uint64_t NowMs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                     std::chrono::system_clock::now().time_since_epoch())
+                                     .count());
+}
+
+} // namespace
+
+LanRoomService::LanRoomService(const LanRoomServerConfig& config, SendCallback send)
+    : config_(config), send_(std::move(send)) {}
+
+void LanRoomService::OnConnected(ConnectionId connection) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    clients_.try_emplace(connection);
+}
+
+void LanRoomService::OnMessage(ConnectionId connection, std::string_view message) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto client_it = clients_.find(connection);
+    if (client_it == clients_.end()) {
+        return;
+    }
+    Client& client = client_it->second;
+
+    Json j = Json::parse(message, nullptr, false);
+    const auto type_it = j.is_object() ? j.find("type") : j.end();
+    if (j.is_discarded() || type_it == j.end() || !type_it->is_string()) {
+        protocol_errors_.fetch_add(1, std::memory_order_relaxed);
+        SendErrorLocked(connection, "PROTOCOL_ERROR", "Malformed message", 0);
+        return;
+    }
+    const MessageType type = ModelA::ResolveMessageType(type_it->get_ref<const std::string&>());
+
+    switch (type) {
+    case MessageType::Register:
+        HandleRegisterLocked(connection, client, j);
+        return;
+    case MessageType::Heartbeat:
+        // Echoed as is; the client times its round trips by it
+        send_(connection, message);
+        return;
+    case MessageType::Resume:
+        // Nothing survives a reconnect here; the client registers and joins again
+        SendLocked(connection, {{"type", MessageTypeName(MessageType::ResumeResponse)},
+                                {"success", false},
+                                {"request_id", RequestId(j)}});
+        return;
+    default:
+        break;
+    }
+
+    if (client.client_id.empty()) {
+        SendErrorLocked(connection, "NOT_REGISTERED", "Register first", RequestId(j));
+        return;
+    }
+    switch (type) {
+    case MessageType::CreateRoom:
+        HandleCreateRoomLocked(connection, client, j);
+        break;
+    case MessageType::RoomList:
+        HandleRoomListLocked(connection, j);
+        break;
+    case MessageType::RoomListSubscribe:
+        HandleSubscribeLocked(connection, client, j);
+        break;
+    case MessageType::RoomListUnsubscribe:
+        client.subscribed = false;
+        break;
+    case MessageType::RoomDetails:
+        HandleRoomDetailsLocked(connection, j);
+        break;
+    case MessageType::JoinRoom:
+        HandleJoinRoomLocked(connection, client, j);
+        break;
+    case MessageType::LeaveRoom:
+        LeaveRoomLocked(connection, client, "left");
+        break;
+    case MessageType::P2PInfo:
+        HandleP2PInfoLocked(client, j);
+        break;
+    case MessageType::AdvertiseDataUpdate:
+        HandleAdvertiseDataLocked(connection, client, message);
+        break;
+    default:
+        // Includes wire_format offers, which leaves the client on JSON
+        break;
+    }
+}
+
+void LanRoomService::OnDisconnected(ConnectionId connection) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = clients_.find(connection);
+    if (it == clients_.end()) {
+        return;
+    }
+    LeaveRoomLocked(connection, it->second, "disconnected");
+    client_ids_.erase(it->second.client_id);
+    clients_.erase(it);
+}
+
+void LanRoomService::HandleRegisterLocked(ConnectionId connection, Client& client,
+                                          const Json& j) {
+    std::string client_id = String(j, "client_id");
+    const auto taken = client_ids_.find(client_id);
+    if (client_id.empty() || client_id.size() > 64 ||
+        (taken != client_ids_.end() && taken->second != connection)) {
+        client_id = SerialId("lan-client-", next_client_++);
+    }
+    if (client_id != client.client_id) {
+        client_ids_.erase(client.client_id);
+        client.client_id = client_id;
+        client_ids_[client_id] = connection;
+    }
+    client.username = String(j, "username");
+
+    SendLocked(connection, {{"type", MessageTypeName(MessageType::RegisterResponse)},
+                            {"success", true},
+                            {"client_id", client.client_id},
+                            {"server_time", NowMs()},
+                            {"server_version", config_.server_version},
+                            {"request_id", RequestId(j)}});
+}
+
+void LanRoomService::HandleCreateRoomLocked(ConnectionId connection, Client& client,
+                                            const Json& j) {
+    const uint32_t request_id = RequestId(j);
+    const int max_players = Int(j, "max_players", 2);
+    if (!client.room_id.empty()) {
+        SendErrorLocked(connection, "ALREADY_IN_ROOM", "Leave the current room first", request_id);
+        return;
+    }
+    if (max_players < 1 || max_players > MAX_ROOM_PLAYERS) {
+        SendErrorLocked(connection, "INVALID_REQUEST", "Unsupported player count", request_id);
+        return;
+    }
+    if (rooms_.size() >= config_.max_rooms) {
+        SendErrorLocked(connection, "SERVER_FULL", "No more rooms on this server", request_id);
+        return;
+    }
+
+    Room room;
+    room.id = SerialId("lan-room-", next_room_++);
+    room.game_id = GameId(j);
+    room.game_name = String(j, "game_name");
+    room.description = String(j, "description");
+    room.is_private = Bool(j, "is_private");
+    room.password = String(j, "password");
+    room.max_players = max_players;
+    room.created_at = NowMs();
+    room.host = connection;
+    room.members.push_back(connection);
+    client.room_id = room.id;
+    rooms_created_.fetch_add(1, std::memory_order_relaxed);
+
+    const Room& stored = rooms_.emplace(room.id, std::move(room)).first->second;
+    SendLocked(connection, {{"type", MessageTypeName(MessageType::RoomCreated)},
+                            {"success", true},
+                            {"room",
+                             {{"id", stored.id},
+                              {"game_id", GameIdString(stored.game_id)},
+                              {"game_name", stored.game_name},
+                              {"host_id", client.client_id},
+                              {"host_name", client.username},
+                              {"max_players", stored.max_players},
+                              {"current_players", 1},
+                              {"is_private", stored.is_private}}},
+                            {"request_id", request_id}});
+    PublishRoomLocked(stored, false);
+}
+
+void LanRoomService::HandleRoomListLocked(ConnectionId connection, const Json& j) {
+    const uint64_t game_id = GameId(j);
+    const bool include_private = Bool(j, "include_private");
+    const bool include_full = Bool(j, "include_full");
+    const size_t page_size =
+        static_cast<size_t>(std::clamp(Int(j, "max_results", 20), 1, MAX_PAGE_SIZE));
+    const std::string cursor = String(j, "cursor");
+    size_t skip = cursor.empty() ? static_cast<size_t>(std::max(Int(j, "offset", 0), 0)) : 0;
+
+    Json rooms = Json::array();
+    std::string next_cursor;
+    int total_count = 0;
+    for (const auto& [id, room] : rooms_) {
+        if ((game_id != 0 && room.game_id != game_id) || (room.is_private && !include_private) ||
+            (!include_full && static_cast<int>(room.members.size()) >= room.max_players)) {
+            continue;
+        }
+        ++total_count;
+        if (!cursor.empty() && id <= cursor) {
+            continue;
+        }
+        if (skip != 0) {
+            --skip;
+            continue;
+        }
+        if (rooms.size() < page_size) {
+            rooms.push_back(SummaryJson(room));
+        } else if (next_cursor.empty()) {
+            // Another page follows; it starts after the last room of this one
+            next_cursor = rooms.back()["id"];
+        }
+    }
+
+    Json response = {{"type", MessageTypeName(MessageType::RoomListResponse)},
+                     {"success", true},
+                     {"total_count", total_count},
+                     {"rooms", std::move(rooms)},
+                     {"request_id", RequestId(j)}};
+    if (!next_cursor.empty()) {
+        response["next_cursor"] = next_cursor;
+    }
+    SendLocked(connection, response);
+}
+
+void LanRoomService::HandleSubscribeLocked(ConnectionId connection, Client& client,
+                                           const Json& j) {
+    // Always a snapshot: a LAN list is short, so no history is kept for deltas
+    client.subscribed = true;
+    client.subscription = {GameId(j), String(j, "region"), 1};
+    Json rooms = Json::array();
+    for (const auto& [id, room] : rooms_) {
+        if (!room.is_private && Matches(client.subscription, room, config_.region)) {
+            rooms.push_back(SummaryJson(room));
+        }
+    }
+    SendLocked(connection, {{"type", MessageTypeName(MessageType::RoomListDelta)},
+                            {"snapshot", true},
+                            {"base_version", 0},
+                            {"version", client.subscription.version},
+                            {"rooms", std::move(rooms)},
+                            {"removed", Json::array()}});
+}
+
+void LanRoomService::HandleRoomDetailsLocked(ConnectionId connection, const Json& j) {
+    const uint32_t request_id = RequestId(j);
+    const auto it = rooms_.find(String(j, "room_id"));
+    if (it == rooms_.end()) {
+        SendErrorLocked(connection, "ROOM_NOT_FOUND", "No such room", request_id);
+        return;
+    }
+    const Room& room = it->second;
+    Json response = {{"type", MessageTypeName(MessageType::RoomDetailsResponse)},
+                     {"success", true},
+                     {"version", room.version},
+                     {"request_id", request_id}};
+    if (UnsignedInt(j, "known_version") == room.version) {
+        response["not_modified"] = true;
+        SendLocked(connection, response);
+        return;
+    }
+
+    const auto host = clients_.find(room.host);
+    Json players = Json::array();
+    for (const ConnectionId member : room.members) {
+        players.push_back(PlayerJson(member, member == room.host));
+    }
+    response["room"] = {
+        {"id", room.id},
+        {"game_id", GameIdString(room.game_id)},
+        {"game_name", room.game_name},
+        {"host_id", host != clients_.end() ? host->second.client_id : std::string{}},
+        {"host_name", host != clients_.end() ? host->second.username : std::string{}},
+        {"max_players", room.max_players},
+        {"current_players", static_cast<int>(room.members.size())},
+        {"is_private", room.is_private},
+        {"created_at", room.created_at},
+        {"description", room.description}};
+    response["players"] = std::move(players);
+    SendLocked(connection, response);
+}
+
+void LanRoomService::HandleJoinRoomLocked(ConnectionId connection, Client& client,
+                                          const Json& j) {
+    const uint32_t request_id = RequestId(j);
+    const std::string room_id = String(j, "room_id");
+    const auto refuse = [&](std::string_view code, std::string_view message) {
+        joins_refused_.fetch_add(1, std::memory_order_relaxed);
+        SendErrorLocked(connection, code, message, request_id);
+    };
+
+    if (Bool(j, "spectator")) {
+        refuse("SPECTATOR_UNAVAILABLE", "LAN rooms have no relay to spectate through");
+        return;
+    }
+    if (!client.room_id.empty()) {
+        refuse("ALREADY_IN_ROOM", "Leave the current room first");
+        return;
+    }
+    const auto it = rooms_.find(room_id);
+    if (it == rooms_.end()) {
+        refuse("ROOM_NOT_FOUND", "No such room");
+        return;
+    }
+    Room& room = it->second;
+    if (!room.password.empty() && String(j, "password") != room.password) {
+        refuse("INVALID_PASSWORD", "Wrong room password");
+        return;
+    }
+    if (static_cast<int>(room.members.size()) >= room.max_players) {
+        joins_refused_.fetch_add(1, std::memory_order_relaxed);
+        SendLocked(connection,
+                   {{"type", MessageTypeName(MessageType::Error)},
+                    {"error_code", "ROOM_FULL"},
+                    {"message", "Room is full"},
+                    {"details",
+                     {{"current_players", std::to_string(room.members.size())},
+                      {"max_players", std::to_string(room.max_players)}}},
+                    {"request_id", request_id}});
+        return;
+    }
+
+    if (j.contains("client_info") && j["client_info"].is_object()) {
+        const std::string username = String(j["client_info"], "username");
+        if (!username.empty()) {
+            client.username = username;
+        }
+    }
+    room.members.push_back(connection);
+    ++room.version;
+    client.room_id = room.id;
+    joins_.fetch_add(1, std::memory_order_relaxed);
+
+    Json players = Json::array();
+    for (const ConnectionId member : room.members) {
+        players.push_back(PlayerJson(member, member == room.host));
+    }
+    SendLocked(connection, {{"type", MessageTypeName(MessageType::JoinRoomResponse)},
+                            {"success", true},
+                            {"room_id", room.id},
+                            {"player_id", client.client_id},
+                            {"players", std::move(players)},
+                            {"request_id", request_id}});
+
+    const Json joined = {{"type", MessageTypeName(MessageType::PlayerJoined)},
+                         {"room_id", room.id},
+                         {"player", PlayerJson(connection, false)}};
+    for (const ConnectionId member : room.members) {
+        if (member != connection) {
+            SendLocked(member, joined);
+        }
+    }
+    PublishRoomLocked(room, false);
+}
+
+void LanRoomService::HandleP2PInfoLocked(const Client& client, Json& j) {
+    // Only between members of one room, and always from the sender's own id
+    const auto target = client_ids_.find(String(j, "to_player"));
+    if (client.room_id.empty() || target == client_ids_.end()) {
+        return;
+    }
+    const auto target_client = clients_.find(target->second);
+    if (target_client == clients_.end() || target_client->second.room_id != client.room_id) {
+        return;
+    }
+    j["from_player"] = client.client_id;
+    p2p_forwarded_.fetch_add(1, std::memory_order_relaxed);
+    SendLocked(target->second, j);
+}
+
+void LanRoomService::HandleAdvertiseDataLocked(ConnectionId connection, const Client& client,
+                                               std::string_view message) {
+    const auto it = rooms_.find(client.room_id);
+    if (it == rooms_.end() || it->second.host != connection) {
+        return;
+    }
+    for (const ConnectionId member : it->second.members) {
+        if (member != connection) {
+            send_(member, message);
+        }
+    }
+}
+
+void LanRoomService::LeaveRoomLocked(ConnectionId connection, Client& client,
+                                     std::string_view reason) {
+    const auto it = rooms_.find(client.room_id);
+    client.room_id.clear();
+    if (it == rooms_.end()) {
+        return;
+    }
+    Room& room = it->second;
+    std::erase(room.members, connection);
+    ++room.version;
+
+    const bool closing = connection == room.host;
+    const Json left = {{"type", MessageTypeName(MessageType::PlayerLeft)},
+                       {"room_id", room.id},
+                       {"player_id", client.client_id},
+                       {"reason", closing ? std::string_view{"host_left"} : reason}};
+    for (const ConnectionId member : room.members) {
+        SendLocked(member, left);
+        if (closing) {
+            clients_[member].room_id.clear();
+        }
+    }
+    PublishRoomLocked(room, closing);
+    if (closing) {
+        rooms_.erase(it);
+    }
+}
+
+void LanRoomService::PublishRoomLocked(const Room& room, bool removed) {
+    if (room.is_private) {
+        return;
+    }
+    for (auto& [connection, client] : clients_) {
+        if (!client.subscribed || !Matches(client.subscription, room, config_.region)) {
+            continue;
+        }
+        const uint64_t base_version = client.subscription.version++;
+        Json upserted = Json::array();
+        Json removed_ids = Json::array();
+        if (removed) {
+            removed_ids.push_back(room.id);
+        } else {
+            upserted.push_back(SummaryJson(room));
+        }
+        SendLocked(connection, {{"type", MessageTypeName(MessageType::RoomListDelta)},
+                                {"snapshot", false},
+                                {"base_version", base_version},
+                                {"version", client.subscription.version},
+                                {"rooms", std::move(upserted)},
+                                {"removed", std::move(removed_ids)}});
+    }
+}
+
+void LanRoomService::SendLocked(ConnectionId connection, const Json& j) {
+    send_(connection, j.dump());
+}
+
+void LanRoomService::SendErrorLocked(ConnectionId connection, std::string_view code,
+                                     std::string_view message, uint32_t request_id) {
+    SendLocked(connection, {{"type", MessageTypeName(MessageType::Error)},
+                            {"error_code", code},
+                            {"message", message},
+                            {"request_id", request_id}});
+}
+
+nlohmann::json LanRoomService::SummaryJson(const Room& room) const {
+    const auto host = clients_.find(room.host);
+    return {{"id", room.id},
+            {"game_id", GameIdString(room.game_id)},
+            {"game_name", room.game_name},
+            {"host_name", host != clients_.end() ? host->second.username : std::string{}},
+            {"current_players", static_cast<int>(room.members.size())},
+            {"max_players", room.max_players},
+            {"ping", 0},
+            {"region", config_.region}};
+}
+
+nlohmann::json LanRoomService::PlayerJson(ConnectionId connection, bool is_host) const {
+    const auto it = clients_.find(connection);
+    if (it == clients_.end()) {
+        return {{"id", ""}, {"username", ""}, {"is_host", is_host}};
+    }
+    return {{"id", it->second.client_id},
+            {"username", it->second.username},
+            {"is_host", is_host}};
+}
+
+bool LanRoomService::Matches(const Subscription& subscription, const Room& room,
+                             std::string_view region) {
+    return (subscription.game_id == 0 || subscription.game_id == room.game_id) &&
+           (subscription.region.empty() || subscription.region == region);
+}
+
+size_t LanRoomService::GetClientCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return clients_.size();
+}
+
+size_t LanRoomService::GetRoomCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return rooms_.size();
+}
+
+LanRoomServerStatistics LanRoomService::GetStatistics() const {
+    LanRoomServerStatistics statistics;
+    statistics.protocol_errors = protocol_errors_.load(std::memory_order_relaxed);
+    statistics.rooms_created = rooms_created_.load(std::memory_order_relaxed);
+    statistics.joins = joins_.load(std::memory_order_relaxed);
+    statistics.joins_refused = joins_refused_.load(std::memory_order_relaxed);
+    statistics.p2p_forwarded = p2p_forwarded_.load(std::memory_order_relaxed);
+    return statistics;
+}
+
+} // namespace Core::Multiplayer::LanRoom
@@ -0,0 +1,133 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "lan_room_types.h"
+
+namespace Core::Multiplayer::LanRoom {
+
+/**
+ * The room protocol of room_messages.h as a LAN room server speaks it,
+ * without a transport: the owner feeds in each client's text messages and
+ * the service answers through the send callback.
+ *
+ * Covers what a LAN needs: register, create_room (the creator joins as
+ * host), room_list with cursor paging, room list subscriptions with
+ * per-subscriber versions, room_details with per-room versions, join_room
+ * and leave_room with player_joined and
+ * player_left to the other members, p2p_info forwarded within a room,
+ * advertise_data from the host to its members, and heartbeat echoes.
+ * Resumption always fails, so a reconnecting client registers and joins
+ * again; spectating is refused, as there is no relay to spectate through.
+ * A room closes when its host leaves.
+ *
+ * Thread-safe, though a server drives it from its one event loop. The send
+ * callback runs under the service's lock and must not call back into it.
+ */
+class LanRoomService {
+public:
+    using ConnectionId = uint64_t;
+    using SendCallback = std::function<void(ConnectionId connection, std::string_view message)>;
+
+    LanRoomService(const LanRoomServerConfig& config, SendCallback send);
+
+    LanRoomService(const LanRoomService&) = delete;
+    LanRoomService& operator=(const LanRoomService&) = delete;
+
+    void OnConnected(ConnectionId connection);
+    // Handles one text message; malformed ones are answered with an error
+    void OnMessage(ConnectionId connection, std::string_view message);
+    // Leaves the client's room, as leave_room would
+    void OnDisconnected(ConnectionId connection);
+
+    size_t GetClientCount() const;
+    size_t GetRoomCount() const;
+    // Counts the service keeps; the transport fills in the rest
+    LanRoomServerStatistics GetStatistics() const;
+
+private:
+    struct Subscription {
+        uint64_t game_id = 0; // 0 for every game
+        std::string region;   // Empty for every region
+        uint64_t version = 0; // Of the list as this subscriber knows it
+    };
+
+    struct Client {
+        std::string client_id; // Empty until registered
+        std::string username;
+        std::string room_id;
+        bool subscribed = false;
+        Subscription subscription;
+    };
+
+    struct Room {
+        std::string id;
+        uint64_t game_id = 0;
+        std::string game_name;
+        std::string description;
+        std::string password;
+        bool is_private = false;
+        int max_players = 2;
+        uint64_t created_at = 0;
+        uint64_t version = 1; // Of the details; bumped when the members change
+        ConnectionId host = 0;
+        std::vector<ConnectionId> members; // Host first
+    };
+
+    using Json = nlohmann::json;
+
+    void HandleRegisterLocked(ConnectionId connection, Client& client, const Json& j);
+    void HandleCreateRoomLocked(ConnectionId connection, Client& client, const Json& j);
+    void HandleRoomListLocked(ConnectionId connection, const Json& j);
+    void HandleSubscribeLocked(ConnectionId connection, Client& client, const Json& j);
+    void HandleRoomDetailsLocked(ConnectionId connection, const Json& j);
+    void HandleJoinRoomLocked(ConnectionId connection, Client& client, const Json& j);
+    void HandleP2PInfoLocked(const Client& client, Json& j);
+    void HandleAdvertiseDataLocked(ConnectionId connection, const Client& client,
+                                   std::string_view message);
+    void LeaveRoomLocked(ConnectionId connection, Client& client, std::string_view reason);
+
+    // Sends the room's summary, or its removal, to every subscriber it matches
+    void PublishRoomLocked(const Room& room, bool removed);
+    void SendLocked(ConnectionId connection, const Json& j);
+    void SendErrorLocked(ConnectionId connection, std::string_view code, std::string_view message,
+                         uint32_t request_id);
+
+    Json SummaryJson(const Room& room) const;
+    Json PlayerJson(ConnectionId connection, bool is_host) const;
+    static bool Matches(const Subscription& subscription, const Room& room,
+                        std::string_view region);
+
+    const LanRoomServerConfig config_;
+    const SendCallback send_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<ConnectionId, Client> clients_;
+    std::unordered_map<std::string, ConnectionId> client_ids_;
+    // Ordered by id, which is in creation order; list cursors are room ids
+    std::map<std::string, Room> rooms_;
+    uint64_t next_room_ = 1;
+    uint64_t next_client_ = 1;
+
+    std::atomic<uint64_t> rooms_created_{0};
+    std::atomic<uint64_t> joins_{0};
+    std::atomic<uint64_t> joins_refused_{0};
+    std::atomic<uint64_t> p2p_forwarded_{0};
+    std::atomic<uint64_t> protocol_errors_{0};
+};
+
+} // namespace Core::Multiplayer::LanRoom
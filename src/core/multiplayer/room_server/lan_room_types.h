@@ -0,0 +1,55 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace Core::Multiplayer::LanRoom {
+
+/**
+ * Game id a LAN room server is advertised under over mDNS, so browsers tell
+ * it apart from game sessions
+ */
+inline constexpr std::string_view LAN_ROOM_SERVER_GAME_ID = "sudachi-room-server";
+
+/**
+ * LAN room server configuration
+ */
+struct LanRoomServerConfig {
+    std::string bind_address = "0.0.0.0";
+    uint16_t port = 8470; // 0 binds an ephemeral port
+    size_t max_clients = 512;
+    size_t max_rooms = 128;
+    // Larger messages close the connection; RoomClient's own limit
+    size_t max_message_size = 32 * 1024;
+    // Queued outbound bytes per client before it counts as stuck and is dropped
+    size_t max_pending_send = 1024 * 1024;
+    // Clients heartbeat well within this; silent ones are disconnected
+    std::chrono::milliseconds idle_timeout{90000};
+    // Region every room is listed under
+    std::string region = "lan";
+    std::string server_version = "sudachi-lan-1";
+};
+
+/**
+ * LAN room server statistics
+ */
+struct LanRoomServerStatistics {
+    uint64_t connections_accepted = 0;
+    uint64_t connections_refused = 0; // Over max_clients or a failed handshake
+    uint64_t idle_disconnects = 0;
+    uint64_t messages_received = 0;
+    uint64_t messages_sent = 0;
+    uint64_t protocol_errors = 0; // Malformed frames or messages
+    uint64_t rooms_created = 0;
+    uint64_t joins = 0;
+    uint64_t joins_refused = 0;
+    uint64_t p2p_forwarded = 0;
+};
+
+} // namespace Core::Multiplayer::LanRoom
@@ -0,0 +1,317 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <nlohmann/json.hpp>
+
+#include "core/multiplayer/room_server/lan_room_server.h"
+
+using namespace Core::Multiplayer;
+using namespace Core::Multiplayer::LanRoom;
+using namespace std::chrono_literals;
+using Json = nlohmann::json;
+
+namespace {
+
+std::vector<uint8_t> MaskedFrame(WebSocketOpcode opcode, std::string_view payload,
+                                 bool fin = true) {
+    const uint8_t mask[4] = {0x12, 0x34, 0x56, 0x78};
+    std::vector<uint8_t> frame;
+    frame.push_back(static_cast<uint8_t>((fin ? 0x80 : 0x00) | static_cast<uint8_t>(opcode)));
+    if (payload.size() < 126) {
+        frame.push_back(static_cast<uint8_t>(0x80 | payload.size()));
+    } else {
+        frame.push_back(0x80 | 126);
+        frame.push_back(static_cast<uint8_t>(payload.size() >> 8));
+        frame.push_back(static_cast<uint8_t>(payload.size()));
+    }
+    frame.insert(frame.end(), mask, mask + 4);
+    for (size_t i = 0; i < payload.size(); ++i) {
+        frame.push_back(static_cast<uint8_t>(payload[i]) ^ mask[i & 3]);
+    }
+    return frame;
+}
+
+// Blocking WebSocket client over loopback, just enough to drive the server
+class TestClient {
+public:
+    explicit TestClient(uint16_t port) {
+        fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        ::inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+        connected_ =
+            ::connect(fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+    }
+    ~TestClient() {
+        ::close(fd_);
+    }
+
+    bool IsConnected() const { return connected_; }
+
+    void Write(std::string_view bytes) {
+        ::send(fd_, bytes.data(), bytes.size(), 0);
+    }
+    void Write(const std::vector<uint8_t>& bytes) {
+        ::send(fd_, bytes.data(), bytes.size(), 0);
+    }
+
+    // Everything up to and including the blank line ending the headers
+    std::string ReadHeaders() {
+        while (buffer_.find("\r\n\r\n") == std::string::npos && Fill()) {
+        }
+        const size_t end = buffer_.find("\r\n\r\n");
+        if (end == std::string::npos) {
+            return {};
+        }
+        std::string headers = buffer_.substr(0, end + 4);
+        buffer_.erase(0, end + 4);
+        return headers;
+    }
+
+    // The next unmasked server frame; opcode 0xFF when the connection ended
+    std::pair<uint8_t, std::string> ReadFrame() {
+        while (true) {
+            if (buffer_.size() >= 2) {
+                const auto first = static_cast<uint8_t>(buffer_[0]);
+                size_t length = static_cast<uint8_t>(buffer_[1]) & 0x7F;
+                size_t header = 2;
+                if (length == 126 && buffer_.size() >= 4) {
+                    length = static_cast<uint8_t>(buffer_[2]) << 8 | static_cast<uint8_t>(buffer_[3]);
+                    header = 4;
+                }
+                if (length < 126 || header == 4) {
+                    if (buffer_.size() >= header + length) {
+                        std::string payload = buffer_.substr(header, length);
+                        buffer_.erase(0, header + length);
+                        return {static_cast<uint8_t>(first & 0x0F), payload};
+                    }
+                }
+            }
+            if (!Fill()) {
+                return {0xFF, {}};
+            }
+        }
+    }
+
+    Json ReadMessage() {
+        const auto [opcode, payload] = ReadFrame();
+        EXPECT_EQ(opcode, static_cast<uint8_t>(WebSocketOpcode::Text));
+        return Json::parse(payload, nullptr, false);
+    }
+
+    bool Upgrade() {
+        Write("GET / HTTP/1.1\r\n"
+              "Host: 127.0.0.1\r\n"
+              "Upgrade: websocket\r\n"
+              "Connection: keep-alive, Upgrade\r\n"
+              "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+              "Sec-WebSocket-Version: 13\r\n\r\n");
+        const std::string headers = ReadHeaders();
+        return headers.starts_with("HTTP/1.1 101") &&
+               headers.find("s3pPLMBiTxaQ9kYGzzhZRbK+xOo=") != std::string::npos;
+    }
+
+private:
+    bool Fill() {
+        pollfd descriptor{fd_, POLLIN, 0};
+        if (::poll(&descriptor, 1, 2000) <= 0) {
+            return false;
+        }
+        char chunk[4096];
+        const ssize_t received = ::recv(fd_, chunk, sizeof(chunk), 0);
+        if (received <= 0) {
+            return false;
+        }
+        buffer_.append(chunk, static_cast<size_t>(received));
+        return true;
+    }
+
+    int fd_ = -1;
+    bool connected_ = false;
+    std::string buffer_;
+};
+
+LanRoomServerConfig LoopbackConfig() {
+    LanRoomServerConfig config;
+    config.bind_address = "127.0.0.1";
+    config.port = 0;
+    return config;
+}
+
+class BaseConfigProvider : public ModelA::IConfigProvider {
+public:
+    std::string GetRoomServerUrl() const override { return "wss://rooms.example"; }
+    std::string GetAuthToken() const override { return "token"; }
+    std::chrono::milliseconds GetConnectionTimeout() const override { return 2000ms; }
+    std::chrono::milliseconds GetHeartbeatInterval() const override { return 5000ms; }
+    std::chrono::milliseconds GetMessageTimeout() const override { return 3000ms; }
+    bool IsAutoReconnectEnabled() const override { return true; }
+    int GetMaxReconnectAttempts() const override { return 4; }
+    std::chrono::milliseconds GetReconnectBaseDelay() const override { return 1000ms; }
+    double GetReconnectBackoffMultiplier() const override { return 2.0; }
+    std::chrono::milliseconds GetMaxReconnectDelay() const override { return 60000ms; }
+    bool ShouldReconnectOnError(const std::string&) const override { return true; }
+    int GetMaxConcurrentMessages() const override { return 8; }
+    size_t GetMessageQueueSize() const override { return 64; }
+    bool IsBinaryWireFormatEnabled() const override { return true; }
+};
+
+} // namespace
+
+TEST(WebSocketFramingTest, AcceptKeyMatchesTheRfcExample) {
+    EXPECT_EQ(WebSocketAcceptKey("dGhlIHNhbXBsZSBub25jZQ=="), "s3pPLMBiTxaQ9kYGzzhZRbK+xOo=");
+}
+
+TEST(WebSocketFramingTest, ParsesMaskedFramesAndRejectsUnmaskedOnes) {
+    const std::string text(300, 'x');
+    std::vector<uint8_t> buffer = MaskedFrame(WebSocketOpcode::Text, text);
+    WebSocketFrame frame;
+    EXPECT_EQ(ParseClientFrame(std::span(buffer).first(100), 1024, frame),
+              FrameParseResult::Incomplete);
+    ASSERT_EQ(ParseClientFrame(buffer, 1024, frame), FrameParseResult::Complete);
+    EXPECT_EQ(frame.opcode, WebSocketOpcode::Text);
+    EXPECT_TRUE(frame.fin);
+    EXPECT_EQ(frame.frame_size, buffer.size());
+    EXPECT_EQ(std::string(frame.payload.begin(), frame.payload.end()), text);
+
+    buffer = MaskedFrame(WebSocketOpcode::Text, text);
+    EXPECT_EQ(ParseClientFrame(buffer, 100, frame), FrameParseResult::TooLarge);
+
+    std::string unmasked;
+    AppendServerFrame(WebSocketOpcode::Text, {}, unmasked);
+    std::vector<uint8_t> server_frame(unmasked.begin(), unmasked.end());
+    EXPECT_EQ(ParseClientFrame(server_frame, 1024, frame), FrameParseResult::Invalid);
+
+    buffer = MaskedFrame(WebSocketOpcode::Ping, "", false);
+    EXPECT_EQ(ParseClientFrame(buffer, 1024, frame), FrameParseResult::Invalid);
+}
+
+TEST(WebSocketFramingTest, UpgradeNeedsWebSocketAndAKey) {
+    EXPECT_EQ(ParseUpgradeRequest("GET / HTTP/1.1\r\nUpgrade: WebSocket\r\n"
+                                  "Connection: Upgrade\r\nSec-WebSocket-Key: abc\r\n\r\n"),
+              "abc");
+    EXPECT_FALSE(ParseUpgradeRequest("GET / HTTP/1.1\r\nSec-WebSocket-Key: abc\r\n\r\n"));
+    EXPECT_FALSE(ParseUpgradeRequest("POST / HTTP/1.1\r\nUpgrade: websocket\r\n"
+                                     "Connection: Upgrade\r\nSec-WebSocket-Key: abc\r\n\r\n"));
+}
+
+TEST(LanRoomServerTest, ServesRoomMessagesOverWebSocket) {
+    LanRoomServer server(LoopbackConfig());
+    ASSERT_EQ(server.Start(), ErrorCode::Success);
+    ASSERT_NE(server.GetPort(), 0);
+
+    TestClient client(server.GetPort());
+    ASSERT_TRUE(client.IsConnected());
+    ASSERT_TRUE(client.Upgrade());
+
+    // A register split over two fragments, then a ping
+    const std::string message =
+        Json{{"type", "register"}, {"client_id", "c1"}, {"username", "Ann"}, {"request_id", 1}}
+            .dump();
+    client.Write(MaskedFrame(WebSocketOpcode::Text, std::string_view(message).substr(0, 10),
+                             false));
+    client.Write(MaskedFrame(WebSocketOpcode::Continuation, std::string_view(message).substr(10)));
+    const Json registered = client.ReadMessage();
+    EXPECT_EQ(registered.at("type"), "register_response");
+    EXPECT_EQ(registered.at("client_id"), "c1");
+    EXPECT_EQ(server.GetClientCount(), 1u);
+
+    client.Write(MaskedFrame(WebSocketOpcode::Ping, "hi"));
+    const auto [opcode, payload] = client.ReadFrame();
+    EXPECT_EQ(opcode, static_cast<uint8_t>(WebSocketOpcode::Pong));
+    EXPECT_EQ(payload, "hi");
+
+    client.Write(MaskedFrame(WebSocketOpcode::Close, "\x03\xE8"));
+    EXPECT_EQ(client.ReadFrame().first, static_cast<uint8_t>(WebSocketOpcode::Close));
+    EXPECT_EQ(client.ReadFrame().first, 0xFF);
+
+    server.Stop();
+    EXPECT_FALSE(server.IsRunning());
+    const auto statistics = server.GetStatistics();
+    EXPECT_EQ(statistics.connections_accepted, 1u);
+    EXPECT_EQ(statistics.messages_received, 1u);
+    EXPECT_EQ(statistics.messages_sent, 1u);
+
+    std::string metrics;
+    MetricsWriter writer(metrics);
+    server.WriteMetrics(writer);
+    EXPECT_NE(metrics.find("\nsudachi_lan_room_messages_received_total 1\n"), std::string::npos)
+        << metrics;
+    EXPECT_NE(metrics.find("\nsudachi_lan_room_connections_total{result=\"accepted\"} 1\n"),
+              std::string::npos);
+    EXPECT_NE(metrics.find("\nsudachi_lan_room_message_seconds_count 1\n"), std::string::npos);
+}
+
+TEST(LanRoomServerTest, RelaysBetweenClientsAndRefusesPlainHttp) {
+    LanRoomServer server(LoopbackConfig());
+    ASSERT_EQ(server.Start(), ErrorCode::Success);
+
+    TestClient host(server.GetPort());
+    TestClient guest(server.GetPort());
+    ASSERT_TRUE(host.Upgrade());
+    ASSERT_TRUE(guest.Upgrade());
+    host.Write(MaskedFrame(WebSocketOpcode::Text,
+                           Json{{"type", "register"}, {"client_id", "host"}}.dump()));
+    guest.Write(MaskedFrame(WebSocketOpcode::Text,
+                            Json{{"type", "register"}, {"client_id", "guest"}}.dump()));
+    host.ReadMessage();
+    guest.ReadMessage();
+
+    host.Write(MaskedFrame(WebSocketOpcode::Text,
+                           Json{{"type", "create_room"},
+                                {"game_id", "0100000000010000"},
+                                {"max_players", 4},
+                                {"request_id", 2}}
+                               .dump()));
+    const Json created = host.ReadMessage();
+    ASSERT_EQ(created.at("type"), "room_created");
+
+    guest.Write(MaskedFrame(
+        WebSocketOpcode::Text,
+        Json{{"type", "join_room"}, {"room_id", created.at("room").at("id")}, {"request_id", 3}}
+            .dump()));
+    EXPECT_TRUE(guest.ReadMessage().at("success"));
+    EXPECT_EQ(host.ReadMessage().at("type"), "player_joined");
+
+    TestClient browser(server.GetPort());
+    browser.Write("GET / HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n");
+    EXPECT_TRUE(browser.ReadHeaders().starts_with("HTTP/1.1 400"));
+    EXPECT_EQ(browser.ReadFrame().first, 0xFF);
+    EXPECT_EQ(server.GetStatistics().connections_refused, 1u);
+}
+
+TEST(LanRoomServerTest, DiscoveredServiceTurnsIntoARoomClientUrl) {
+    LanRoomServer server(LoopbackConfig());
+    ASSERT_EQ(server.Start(), ErrorCode::Success);
+
+    const auto advertisement = server.MakeAdvertisement("lobby-pc", "192.168.1.20");
+    EXPECT_EQ(advertisement.game_id, LAN_ROOM_SERVER_GAME_ID);
+    EXPECT_EQ(advertisement.port, server.GetPort());
+    EXPECT_EQ(LanRoomServerUrl(advertisement),
+              "ws://192.168.1.20:" + std::to_string(server.GetPort()) + "/");
+    EXPECT_EQ(server.GetUrl("fe80::1"), "ws://[fe80::1]:" + std::to_string(server.GetPort()) + "/");
+
+    auto game = advertisement;
+    game.game_id = "0100000000010000";
+    EXPECT_FALSE(LanRoomServerUrl(game));
+
+    const LanRoomConfigProvider provider(std::make_shared<BaseConfigProvider>(),
+                                         *LanRoomServerUrl(advertisement));
+    EXPECT_EQ(provider.GetRoomServerUrl(), *LanRoomServerUrl(advertisement));
+    EXPECT_EQ(provider.GetAuthToken(), "token");
+    EXPECT_FALSE(provider.IsBinaryWireFormatEnabled());
+}
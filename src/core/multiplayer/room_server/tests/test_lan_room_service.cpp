@@ -0,0 +1,257 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "core/multiplayer/room_server/lan_room_service.h"
+
+using namespace Core::Multiplayer::LanRoom;
+using Json = nlohmann::json;
+
+namespace {
+
+class LanRoomServiceTest : public ::testing::Test {
+protected:
+    LanRoomServiceTest()
+        : service_(config_, [this](LanRoomService::ConnectionId connection,
+                                   std::string_view message) {
+              sent_[connection].push_back(Json::parse(message));
+          }) {}
+
+    void Connect(LanRoomService::ConnectionId connection, const std::string& username) {
+        service_.OnConnected(connection);
+        Send(connection, {{"type", "register"}, {"client_id", username}, {"username", username},
+                          {"request_id", 1}});
+        ASSERT_EQ(Take(connection).at("type"), "register_response");
+    }
+
+    void Send(LanRoomService::ConnectionId connection, const Json& message) {
+        service_.OnMessage(connection, message.dump());
+    }
+
+    // The oldest message sent to a connection, removed
+    Json Take(LanRoomService::ConnectionId connection) {
+        auto& queue = sent_[connection];
+        if (queue.empty()) {
+            return Json::object();
+        }
+        Json message = queue.front();
+        queue.erase(queue.begin());
+        return message;
+    }
+
+    std::string CreateRoom(LanRoomService::ConnectionId connection, int max_players = 2,
+                           bool is_private = false) {
+        Send(connection, {{"type", "create_room"},
+                          {"game_id", "0100000000010000"},
+                          {"game_name", "Island"},
+                          {"max_players", max_players},
+                          {"is_private", is_private},
+                          {"password", ""},
+                          {"request_id", 2}});
+        const Json created = Take(connection);
+        EXPECT_EQ(created.at("type"), "room_created");
+        EXPECT_EQ(created.at("request_id"), 2);
+        return created.at("room").at("id");
+    }
+
+    LanRoomServerConfig config_;
+    std::map<LanRoomService::ConnectionId, std::vector<Json>> sent_;
+    LanRoomService service_;
+};
+
+} // namespace
+
+TEST_F(LanRoomServiceTest, JoinNotifiesTheRoomAndFullRoomsRefuse) {
+    Connect(1, "host");
+    Connect(2, "guest");
+    Connect(3, "late");
+    const std::string room_id = CreateRoom(1);
+
+    Send(2, {{"type", "join_room"},
+             {"room_id", room_id},
+             {"password", ""},
+             {"client_info", {{"username", "Guest"}}},
+             {"request_id", 7}});
+    const Json joined = Take(2);
+    EXPECT_EQ(joined.at("type"), "join_room_response");
+    EXPECT_TRUE(joined.at("success"));
+    EXPECT_EQ(joined.at("player_id"), "guest");
+    EXPECT_EQ(joined.at("request_id"), 7);
+    ASSERT_EQ(joined.at("players").size(), 2u);
+    EXPECT_EQ(joined.at("players")[0].at("id"), "host");
+    EXPECT_TRUE(joined.at("players")[0].at("is_host"));
+
+    const Json notice = Take(1);
+    EXPECT_EQ(notice.at("type"), "player_joined");
+    EXPECT_EQ(notice.at("player").at("username"), "Guest");
+
+    Send(3, {{"type", "join_room"}, {"room_id", room_id}, {"request_id", 8}});
+    const Json refused = Take(3);
+    EXPECT_EQ(refused.at("type"), "error");
+    EXPECT_EQ(refused.at("error_code"), "ROOM_FULL");
+    EXPECT_EQ(refused.at("details").at("max_players"), "2");
+    EXPECT_EQ(refused.at("request_id"), 8);
+    EXPECT_EQ(service_.GetStatistics().joins, 1u);
+    EXPECT_EQ(service_.GetStatistics().joins_refused, 1u);
+}
+
+TEST_F(LanRoomServiceTest, RoomListPagesByCursorAndHidesPrivateRooms) {
+    for (LanRoomService::ConnectionId host = 1; host <= 4; ++host) {
+        Connect(host, "host" + std::to_string(host));
+        CreateRoom(host, 4, host == 4);
+    }
+    Connect(9, "browser");
+
+    Send(9, {{"type", "room_list"}, {"game_id", "0000000000000000"}, {"max_results", 2},
+             {"request_id", 3}});
+    Json page = Take(9);
+    EXPECT_EQ(page.at("type"), "room_list_response");
+    EXPECT_EQ(page.at("total_count"), 3);
+    ASSERT_EQ(page.at("rooms").size(), 2u);
+    EXPECT_EQ(page.at("rooms")[0].at("host_name"), "host1");
+    EXPECT_EQ(page.at("rooms")[0].at("region"), "lan");
+    ASSERT_TRUE(page.contains("next_cursor"));
+
+    Send(9, {{"type", "room_list"}, {"max_results", 2}, {"cursor", page.at("next_cursor")},
+             {"request_id", 4}});
+    page = Take(9);
+    ASSERT_EQ(page.at("rooms").size(), 1u);
+    EXPECT_EQ(page.at("rooms")[0].at("host_name"), "host3");
+    EXPECT_FALSE(page.contains("next_cursor"));
+
+    Send(9, {{"type", "room_list"}, {"include_private", true}, {"request_id", 5}});
+    EXPECT_EQ(Take(9).at("total_count"), 4);
+}
+
+TEST_F(LanRoomServiceTest, RoomDetailsAreVersioned) {
+    Connect(1, "host");
+    const std::string room_id = CreateRoom(1, 4);
+    Connect(2, "browser");
+
+    Send(2, {{"type", "room_details"}, {"room_id", room_id}, {"request_id", 3}});
+    Json details = Take(2);
+    EXPECT_EQ(details.at("type"), "room_details_response");
+    EXPECT_EQ(details.at("request_id"), 3);
+    EXPECT_EQ(details.at("room").at("host_id"), "host");
+    ASSERT_EQ(details.at("players").size(), 1u);
+    EXPECT_TRUE(details.at("players")[0].at("is_host"));
+    const uint64_t version = details.at("version");
+
+    // Unchanged, so nothing is sent again
+    Send(2, {{"type", "room_details"}, {"room_id", room_id}, {"known_version", version},
+             {"request_id", 4}});
+    details = Take(2);
+    EXPECT_TRUE(details.at("not_modified"));
+    EXPECT_FALSE(details.contains("players"));
+
+    Connect(3, "guest");
+    Send(3, {{"type", "join_room"}, {"room_id", room_id}, {"request_id", 5}});
+    Send(2, {{"type", "room_details"}, {"room_id", room_id}, {"known_version", version},
+             {"request_id", 6}});
+    details = Take(2);
+    EXPECT_FALSE(details.contains("not_modified"));
+    EXPECT_GT(details.at("version"), version);
+    EXPECT_EQ(details.at("players").size(), 2u);
+
+    Send(2, {{"type", "room_details"}, {"room_id", "lan-room-missing"}, {"request_id", 7}});
+    EXPECT_EQ(Take(2).at("error_code"), "ROOM_NOT_FOUND");
+}
+
+TEST_F(LanRoomServiceTest, SubscribersGetASnapshotThenVersionedDeltas) {
+    Connect(1, "host");
+    Connect(2, "watcher");
+    Send(2, {{"type", "room_list_subscribe"}, {"game_id", "0000000000000000"},
+             {"region", ""}, {"known_version", 0}});
+    const Json snapshot = Take(2);
+    EXPECT_EQ(snapshot.at("type"), "room_list_delta");
+    EXPECT_TRUE(snapshot.at("snapshot"));
+    EXPECT_TRUE(snapshot.at("rooms").empty());
+    const uint64_t version = snapshot.at("version");
+
+    const std::string room_id = CreateRoom(1);
+    const Json added = Take(2);
+    EXPECT_FALSE(added.at("snapshot"));
+    EXPECT_EQ(added.at("base_version"), version);
+    EXPECT_EQ(added.at("version"), version + 1);
+    ASSERT_EQ(added.at("rooms").size(), 1u);
+    EXPECT_EQ(added.at("rooms")[0].at("id"), room_id);
+
+    // The host leaving closes the room
+    service_.OnDisconnected(1);
+    const Json removed = Take(2);
+    EXPECT_EQ(removed.at("base_version"), version + 1);
+    ASSERT_EQ(removed.at("removed").size(), 1u);
+    EXPECT_EQ(removed.at("removed")[0], room_id);
+    EXPECT_EQ(service_.GetRoomCount(), 0u);
+    EXPECT_EQ(service_.GetClientCount(), 1u);
+}
+
+TEST_F(LanRoomServiceTest, HostLeavingTellsTheRestOfTheRoom) {
+    Connect(1, "host");
+    Connect(2, "guest");
+    const std::string room_id = CreateRoom(1);
+    Send(2, {{"type", "join_room"}, {"room_id", room_id}, {"request_id", 3}});
+    Take(2);
+    Take(1);
+
+    Send(1, {{"type", "leave_room"}});
+    const Json left = Take(2);
+    EXPECT_EQ(left.at("type"), "player_left");
+    EXPECT_EQ(left.at("player_id"), "host");
+    EXPECT_EQ(left.at("reason"), "host_left");
+
+    // The guest is free to host a room of its own
+    CreateRoom(2);
+    EXPECT_EQ(service_.GetRoomCount(), 1u);
+}
+
+TEST_F(LanRoomServiceTest, P2PInfoIsForwardedWithinTheRoomOnly) {
+    Connect(1, "host");
+    Connect(2, "guest");
+    Connect(3, "outsider");
+    const std::string room_id = CreateRoom(1);
+    Send(2, {{"type", "join_room"}, {"room_id", room_id}, {"request_id", 3}});
+    Take(2);
+    Take(1);
+
+    Send(2, {{"type", "p2p_info"},
+             {"from_player", "someone-else"},
+             {"to_player", "host"},
+             {"connection_type", "direct"},
+             {"ice_candidates", Json::array()}});
+    const Json forwarded = Take(1);
+    EXPECT_EQ(forwarded.at("type"), "p2p_info");
+    EXPECT_EQ(forwarded.at("from_player"), "guest");
+
+    Send(3, {{"type", "p2p_info"}, {"to_player", "host"}});
+    EXPECT_TRUE(sent_[1].empty());
+    EXPECT_EQ(service_.GetStatistics().p2p_forwarded, 1u);
+}
+
+TEST_F(LanRoomServiceTest, UnregisteredAndMalformedRequestsAreRefused) {
+    service_.OnConnected(1);
+    Send(1, {{"type", "room_list"}, {"request_id", 9}});
+    Json error = Take(1);
+    EXPECT_EQ(error.at("error_code"), "NOT_REGISTERED");
+    EXPECT_EQ(error.at("request_id"), 9);
+
+    service_.OnMessage(1, "{not json");
+    EXPECT_EQ(Take(1).at("error_code"), "PROTOCOL_ERROR");
+    EXPECT_EQ(service_.GetStatistics().protocol_errors, 1u);
+
+    // Heartbeats are echoed and resumption always fails
+    Send(1, {{"type", "heartbeat"}, {"timestamp", 42}});
+    EXPECT_EQ(Take(1).at("timestamp"), 42);
+    Send(1, {{"type", "resume"}, {"resume_token", "t"}, {"request_id", 11}});
+    const Json resumed = Take(1);
+    EXPECT_EQ(resumed.at("type"), "resume_response");
+    EXPECT_FALSE(resumed.at("success"));
+    EXPECT_EQ(resumed.at("request_id"), 11);
+}
@@ -0,0 +1,205 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "websocket_framing.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+
+#include <openssl/evp.h>
+
+namespace Core::Multiplayer::LanRoom {
+
+namespace {
+
+constexpr std::string_view WEBSOCKET_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+bool EqualsIgnoreCase(std::string_view a, std::string_view b) {
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+               return std::tolower(static_cast<unsigned char>(x)) ==
+                      std::tolower(static_cast<unsigned char>(y));
+           });
+}
+
+bool ContainsToken(std::string_view value, std::string_view token) {
+    // Comma-separated, e.g. "keep-alive, Upgrade"
+    while (!value.empty()) {
+        const size_t comma = value.find(',');
+        std::string_view item = value.substr(0, comma);
+        while (!item.empty() && item.front() == ' ') {
+            item.remove_prefix(1);
+        }
+        while (!item.empty() && item.back() == ' ') {
+            item.remove_suffix(1);
+        }
+        if (EqualsIgnoreCase(item, token)) {
+            return true;
+        }
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        value.remove_prefix(comma + 1);
+    }
+    return false;
+}
+
+} // namespace
+
+FrameParseResult ParseClientFrame(std::span<uint8_t> buffer, size_t max_payload,
+                                  WebSocketFrame& out) {
+    if (buffer.size() < 2) {
+        return FrameParseResult::Incomplete;
+    }
+    const uint8_t first = buffer[0];
+    const uint8_t second = buffer[1];
+    if ((first & 0x70) != 0 || (second & 0x80) == 0) {
+        // Reserved bits without an extension, or a client frame without a mask
+        return FrameParseResult::Invalid;
+    }
+    const auto opcode = static_cast<WebSocketOpcode>(first & 0x0F);
+    const bool fin = (first & 0x80) != 0;
+    const bool control = (first & 0x08) != 0;
+    switch (opcode) {
+    case WebSocketOpcode::Continuation:
+    case WebSocketOpcode::Text:
+    case WebSocketOpcode::Binary:
+    case WebSocketOpcode::Close:
+    case WebSocketOpcode::Ping:
+    case WebSocketOpcode::Pong:
+        break;
+    default:
+        return FrameParseResult::Invalid;
+    }
+
+    uint64_t length = second & 0x7F;
+    size_t header = 2;
+    if (length == 126) {
+        header = 4;
+    } else if (length == 127) {
+        header = 10;
+    }
+    if (control && (length > 125 || !fin)) {
+        return FrameParseResult::Invalid;
+    }
+    if (buffer.size() < header + 4) {
+        return FrameParseResult::Incomplete;
+    }
+    if (header != 2) {
+        length = 0;
+        for (size_t i = 2; i < header; ++i) {
+            length = length << 8 | buffer[i];
+        }
+    }
+    if (length > max_payload) {
+        return FrameParseResult::TooLarge;
+    }
+    const size_t payload_offset = header + 4;
+    if (buffer.size() - payload_offset < length) {
+        return FrameParseResult::Incomplete;
+    }
+
+    const uint8_t* mask = buffer.data() + header;
+    uint8_t* payload = buffer.data() + payload_offset;
+    for (size_t i = 0; i < length; ++i) {
+        payload[i] ^= mask[i & 3];
+    }
+    out.opcode = opcode;
+    out.fin = fin;
+    out.payload = {payload, static_cast<size_t>(length)};
+    out.frame_size = payload_offset + static_cast<size_t>(length);
+    return FrameParseResult::Complete;
+}
+
+void AppendServerFrame(WebSocketOpcode opcode, std::span<const uint8_t> payload,
+                       std::string& out) {
+    out.push_back(static_cast<char>(0x80 | static_cast<uint8_t>(opcode)));
+    const uint64_t length = payload.size();
+    if (length < 126) {
+        out.push_back(static_cast<char>(length));
+    } else if (length <= 0xFFFF) {
+        out.push_back(static_cast<char>(126));
+        out.push_back(static_cast<char>(length >> 8));
+        out.push_back(static_cast<char>(length));
+    } else {
+        out.push_back(static_cast<char>(127));
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            out.push_back(static_cast<char>(length >> shift));
+        }
+    }
+    out.append(reinterpret_cast<const char*>(payload.data()), payload.size());
+}
+
+std::optional<std::string> ParseUpgradeRequest(std::string_view request) {
+    if (!request.starts_with("GET ")) {
+        return std::nullopt;
+    }
+    bool upgrade = false;
+    bool connection_upgrade = false;
+    std::optional<std::string> key;
+
+    size_t line_start = request.find("\r\n");
+    while (line_start != std::string_view::npos) {
+        line_start += 2;
+        const size_t line_end = request.find("\r\n", line_start);
+        if (line_end == std::string_view::npos || line_end == line_start) {
+            break;
+        }
+        const std::string_view line = request.substr(line_start, line_end - line_start);
+        line_start = line_end;
+
+        const size_t colon = line.find(':');
+        if (colon == std::string_view::npos) {
+            continue;
+        }
+        const std::string_view name = line.substr(0, colon);
+        std::string_view value = line.substr(colon + 1);
+        while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+            value.remove_prefix(1);
+        }
+        while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+            value.remove_suffix(1);
+        }
+        if (EqualsIgnoreCase(name, "Upgrade")) {
+            upgrade = EqualsIgnoreCase(value, "websocket");
+        } else if (EqualsIgnoreCase(name, "Connection")) {
+            connection_upgrade = ContainsToken(value, "Upgrade");
+        } else if (EqualsIgnoreCase(name, "Sec-WebSocket-Key") && !value.empty()) {
+            key = std::string(value);
+        }
+    }
+    if (!upgrade || !connection_upgrade) {
+        return std::nullopt;
+    }
+    return key;
+}
+
+std::string MakeUpgradeResponse(std::string_view client_key) {
+    std::string response = "HTTP/1.1 101 Switching Protocols\r\n"
+                           "Upgrade: websocket\r\n"
+                           "Connection: Upgrade\r\n"
+                           "Sec-WebSocket-Accept: ";
+    response += WebSocketAcceptKey(client_key);
+    response += "\r\n\r\n";
+    return response;
+}
+
+std::string WebSocketAcceptKey(std::string_view client_key) {
+    std::string input(client_key);
+    input += WEBSOCKET_GUID;
+    std::array<unsigned char, EVP_MAX_MD_SIZE> digest{};
+    unsigned int digest_size = 0;
+    if (EVP_Digest(input.data(), input.size(), digest.data(), &digest_size, EVP_sha1(),
+                   nullptr) != 1) {
+        return {};
+    }
+    // Base64 of 20 bytes is 28 characters, plus the terminator EVP writes
+    std::array<unsigned char, 4 * ((EVP_MAX_MD_SIZE + 2) / 3) + 1> encoded{};
+    const int encoded_size = EVP_EncodeBlock(encoded.data(), digest.data(),
+                                             static_cast<int>(digest_size));
+    return std::string(reinterpret_cast<const char*>(encoded.data()),
+                       static_cast<size_t>(encoded_size));
+}
+
+} // namespace Core::Multiplayer::LanRoom
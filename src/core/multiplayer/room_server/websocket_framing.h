@@ -0,0 +1,70 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace Core::Multiplayer::LanRoom {
+
+/**
+ * The server side of RFC 6455, as much as the LAN room server needs: the
+ * upgrade handshake and unextended frames. No extensions are negotiated, so
+ * clients fall back to uncompressed messages.
+ */
+enum class WebSocketOpcode : uint8_t {
+    Continuation = 0x0,
+    Text = 0x1,
+    Binary = 0x2,
+    Close = 0x8,
+    Ping = 0x9,
+    Pong = 0xA,
+};
+
+struct WebSocketFrame {
+    WebSocketOpcode opcode = WebSocketOpcode::Text;
+    bool fin = true;
+    std::span<const uint8_t> payload; // Unmasked, within the parsed buffer
+    size_t frame_size = 0;            // Bytes the frame took, header included
+};
+
+enum class FrameParseResult : uint8_t {
+    Complete,
+    Incomplete, // More bytes are needed
+    Invalid,    // Unmasked, reserved bits or opcodes, or a malformed control frame
+    TooLarge,   // Payload over the limit
+};
+
+// Longest upgrade request accepted; browsers and clients send well under 1 KiB
+constexpr size_t MAX_HANDSHAKE_SIZE = 8 * 1024;
+
+/**
+ * Parses the client frame at the start of buffer and unmasks its payload
+ * in place
+ */
+FrameParseResult ParseClientFrame(std::span<uint8_t> buffer, size_t max_payload,
+                                  WebSocketFrame& out);
+
+// Appends an unmasked server frame with fin set
+void AppendServerFrame(WebSocketOpcode opcode, std::span<const uint8_t> payload,
+                       std::string& out);
+
+/**
+ * Reads the Sec-WebSocket-Key of a complete upgrade request (headers up to
+ * and including the blank line)
+ * @return Nothing unless it is a GET asking to upgrade to websocket
+ */
+std::optional<std::string> ParseUpgradeRequest(std::string_view request);
+
+// The 101 response accepting a client key
+std::string MakeUpgradeResponse(std::string_view client_key);
+
+// Sec-WebSocket-Accept for a client key: base64 of SHA-1 over key and GUID
+std::string WebSocketAcceptKey(std::string_view client_key);
+
+} // namespace Core::Multiplayer::LanRoom
@@ -0,0 +1,184 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "common/error_codes.h"
+
+namespace Core::Multiplayer::HLE {
+
+struct ScanCacheConfig {
+    // Answers older than this start a background refresh
+    std::chrono::milliseconds refresh_after{1000};
+    // Answers older than this are not served; the scan runs in the call
+    std::chrono::milliseconds max_age{10000};
+    // Off scans in every call, as before
+    bool enabled = true;
+};
+
+struct ScanCacheStatistics {
+    uint64_t fresh_hits = 0;
+    uint64_t stale_hits = 0;   // Served while a refresh ran
+    uint64_t misses = 0;       // Scanned in the call
+    uint64_t refreshes = 0;    // Started in the background
+    uint64_t failed_refreshes = 0;
+};
+
+/**
+ * Stale-while-revalidate cache for Scan results.
+ *
+ * Games call Scan over and over and block on it, while a backend scan is a
+ * discovery or room server round-trip. The cache answers from the last
+ * snapshot taken with the same filter and, once it is older than
+ * refresh_after or the backend's discovery epoch moved, scans again on a
+ * worker; the next call picks the new snapshot up. Only a call with no
+ * usable snapshot scans in the caller.
+ *
+ * The filter is compared as raw bytes, so a game alternating filters keeps
+ * one snapshot and scans in the call on every change.
+ *
+ * Owned by one thread, the HLE thread; only the scanner runs elsewhere.
+ * WaitForRefresh() before whatever the scanner calls into goes away.
+ */
+template <typename Networks>
+class ScanResultCache {
+public:
+    using Clock = std::chrono::steady_clock;
+    // Scans with the caller's filter into the given result
+    using Scanner = std::function<ErrorCode(Networks& out_networks)>;
+
+    explicit ScanResultCache(ScanCacheConfig config = {}) : config_(config) {}
+
+    ~ScanResultCache() {
+        WaitForRefresh();
+    }
+
+    ScanResultCache(const ScanResultCache&) = delete;
+    ScanResultCache& operator=(const ScanResultCache&) = delete;
+
+    void SetConfig(const ScanCacheConfig& config) {
+        config_ = config;
+    }
+
+    /**
+     * @param filter_key Bytes of the scan filter
+     * @param epoch Change counter of what the scanner would find; a
+     *        snapshot taken at another epoch is refreshed. Pass 0 when the
+     *        source has none.
+     */
+    ErrorCode Get(std::span<const uint8_t> filter_key, uint64_t epoch, Scanner scanner,
+                  Networks& out_networks, Clock::time_point now = Clock::now()) {
+        if (!config_.enabled) {
+            return scanner(out_networks);
+        }
+
+        CollectRefresh(false);
+        if (!IsUsable(filter_key, now) && refresh_.valid()) {
+            // Finishing the scan in flight is no slower than starting another
+            CollectRefresh(true);
+        }
+
+        if (IsUsable(filter_key, now)) {
+            out_networks = snapshot_->networks;
+            if (now - snapshot_->taken_at < config_.refresh_after && snapshot_->epoch == epoch) {
+                ++statistics_.fresh_hits;
+            } else {
+                ++statistics_.stale_hits;
+                StartRefresh(filter_key, epoch, std::move(scanner), now);
+            }
+            return ErrorCode::Success;
+        }
+
+        ++statistics_.misses;
+        Networks networks;
+        const ErrorCode result = scanner(networks);
+        if (result != ErrorCode::Success) {
+            return result;
+        }
+        snapshot_ = Snapshot{{filter_key.begin(), filter_key.end()}, networks, now, epoch};
+        out_networks = std::move(networks);
+        return ErrorCode::Success;
+    }
+
+    // Drops the snapshot, e.g. when the backend is switched
+    void Invalidate() {
+        WaitForRefresh();
+        snapshot_.reset();
+    }
+
+    // Finishes the refresh in flight, keeping its result
+    void WaitForRefresh() {
+        CollectRefresh(true);
+    }
+
+    bool IsRefreshing() const {
+        return refresh_.valid();
+    }
+
+    const ScanCacheStatistics& GetStatistics() const {
+        return statistics_;
+    }
+
+private:
+    struct Snapshot {
+        std::vector<uint8_t> filter_key;
+        Networks networks;
+        Clock::time_point taken_at;
+        uint64_t epoch = 0;
+    };
+
+    bool IsUsable(std::span<const uint8_t> filter_key, Clock::time_point now) const {
+        return snapshot_ && now - snapshot_->taken_at < config_.max_age &&
+               std::equal(filter_key.begin(), filter_key.end(), snapshot_->filter_key.begin(),
+                          snapshot_->filter_key.end());
+    }
+
+    void StartRefresh(std::span<const uint8_t> filter_key, uint64_t epoch, Scanner scanner,
+                      Clock::time_point now) {
+        if (refresh_.valid()) {
+            return;
+        }
+        ++statistics_.refreshes;
+        refresh_ = std::async(
+            std::launch::async,
+            [scanner = std::move(scanner),
+             snapshot = Snapshot{{filter_key.begin(), filter_key.end()}, {}, now, epoch}]() mutable
+            -> std::optional<Snapshot> {
+                if (scanner(snapshot.networks) != ErrorCode::Success) {
+                    return std::nullopt;
+                }
+                return snapshot;
+            });
+    }
+
+    void CollectRefresh(bool wait) {
+        if (!refresh_.valid() ||
+            (!wait && refresh_.wait_for(std::chrono::seconds(0)) != std::future_status::ready)) {
+            return;
+        }
+        auto snapshot = refresh_.get();
+        if (!snapshot) {
+            // The old snapshot keeps being served until max_age
+            ++statistics_.failed_refreshes;
+            return;
+        }
+        snapshot_ = std::move(*snapshot);
+    }
+
+    ScanCacheConfig config_;
+    std::optional<Snapshot> snapshot_;
+    std::future<std::optional<Snapshot>> refresh_;
+    ScanCacheStatistics statistics_;
+};
+
+} // namespace Core::Multiplayer::HLE
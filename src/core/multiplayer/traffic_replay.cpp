@@ -0,0 +1,113 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "traffic_replay.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace Core::Multiplayer::HLE {
+
+namespace {
+constexpr size_t RECEIVE_BATCH = 64;
+} // namespace
+
+TrafficReplayer::TrafficReplayer(const TrafficCaptureReader& capture, TrafficReplayOptions options)
+    : capture_(capture), options_(options) {
+    options_.max_batch = std::max<size_t>(options_.max_batch, 1);
+    if (!capture_.HasPayloads()) {
+        uint16_t largest = 0;
+        for (const auto& record : capture_.GetRecords()) {
+            largest = std::max(largest, record.size);
+        }
+        zero_payload_.assign(largest, 0);
+    }
+    batch_.reserve(options_.max_batch);
+    received_.resize(RECEIVE_BATCH);
+}
+
+TrafficReplayResult TrafficReplayer::Run(MultiplayerBackend& local, MultiplayerBackend* peer) {
+    using Clock = std::chrono::steady_clock;
+
+    TrafficReplayResult result;
+    const auto& records = capture_.GetRecords();
+    const auto start = Clock::now();
+    const auto due_at = [&](const TrafficRecord& record) {
+        if (options_.speed <= 0.0) {
+            return start;
+        }
+        const auto offset = std::chrono::nanoseconds(
+            static_cast<int64_t>(static_cast<double>(record.timestamp_ns) / options_.speed));
+        return start + offset;
+    };
+
+    size_t next = 0;
+    while (next < records.size()) {
+        const TrafficRecord& first = records[next];
+        const bool received = first.direction == TrafficDirection::Received;
+        if (received && !peer) {
+            ++next;
+            continue;
+        }
+
+        const auto due = due_at(first);
+        if (Clock::now() < due) {
+            std::this_thread::sleep_until(due);
+        }
+        const auto now = Clock::now();
+        result.max_lag = std::max(result.max_lag,
+                                  std::chrono::duration_cast<std::chrono::nanoseconds>(now - due));
+
+        // Everything in the same direction that is already due goes together
+        batch_.clear();
+        while (next < records.size() && batch_.size() < options_.max_batch &&
+               records[next].direction == first.direction && due_at(records[next]) <= now) {
+            const TrafficRecord& record = records[next];
+            PacketRef packet;
+            packet.data = record.payload.empty() ? zero_payload_.data() : record.payload.data();
+            packet.size = record.size;
+            packet.node_id = received ? options_.local_node_id : record.node_id;
+            batch_.push_back(packet);
+            ++next;
+        }
+        SendBatch(received ? *peer : local, result);
+        DrainReceived(local, result);
+    }
+
+    result.elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+    return result;
+}
+
+void TrafficReplayer::SendBatch(MultiplayerBackend& backend, TrafficReplayResult& result) {
+    size_t sent = 0;
+    // A failed packet is counted and skipped, the way a game would carry on
+    for (size_t offset = 0; offset < batch_.size(); offset += sent + 1) {
+        sent = 0;
+        const auto error = backend.SendPackets(batch_.data() + offset, batch_.size() - offset, sent);
+        for (size_t i = offset; i < offset + sent; ++i) {
+            result.bytes_sent += batch_[i].size;
+        }
+        result.packets_sent += sent;
+        if (error == ErrorCode::Success) {
+            break;
+        }
+        ++result.packets_failed;
+    }
+}
+
+void TrafficReplayer::DrainReceived(MultiplayerBackend& backend, TrafficReplayResult& result) {
+    size_t received = 0;
+    do {
+        received = 0;
+        if (backend.ReceivePackets(received_.data(), received_.size(), received) !=
+            ErrorCode::Success) {
+            return;
+        }
+        result.packets_received += received;
+        for (size_t i = 0; i < received; ++i) {
+            received_[i] = {};
+        }
+    } while (received == received_.size());
+}
+
+} // namespace Core::Multiplayer::HLE
@@ -0,0 +1,66 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "common/traffic_capture.h"
+#include "multiplayer_backend.h"
+
+namespace Core::Multiplayer::HLE {
+
+struct TrafficReplayOptions {
+    // 1 keeps the captured pace, 2 replays twice as fast; 0 sends every
+    // packet as soon as the backend takes it
+    double speed = 1.0;
+    // Node the peer backend addresses received records to
+    uint8_t local_node_id = 0;
+    // Consecutive due packets handed to SendPackets at once
+    size_t max_batch = 64;
+};
+
+struct TrafficReplayResult {
+    uint64_t packets_sent = 0;
+    uint64_t packets_failed = 0;
+    uint64_t bytes_sent = 0;
+    // Drained from the local backend's receive queue while replaying
+    uint64_t packets_received = 0;
+    // How far the replay fell behind the captured schedule at worst
+    std::chrono::nanoseconds max_lag{0};
+    std::chrono::nanoseconds elapsed{0};
+};
+
+/**
+ * Feeds a capture written by LdnServiceBridge::StartTrafficCapture into a
+ * backend, so benchmarks run on the traffic shape of a real game session.
+ *
+ * Sent records go out through the local backend. Received records were
+ * sent by another console; they go out through the peer backend if one is
+ * given, addressed to local_node_id, and are skipped otherwise. Captures
+ * without payloads replay zero-filled packets of the captured sizes.
+ *
+ * Packets due at the same time are handed over in one SendPackets call.
+ * The local backend's receive queue is drained between batches.
+ */
+class TrafficReplayer {
+public:
+    explicit TrafficReplayer(const TrafficCaptureReader& capture, TrafficReplayOptions options = {});
+
+    TrafficReplayResult Run(MultiplayerBackend& local, MultiplayerBackend* peer = nullptr);
+
+private:
+    void SendBatch(MultiplayerBackend& backend, TrafficReplayResult& result);
+    void DrainReceived(MultiplayerBackend& backend, TrafficReplayResult& result);
+
+    const TrafficCaptureReader& capture_;
+    TrafficReplayOptions options_;
+    std::vector<uint8_t> zero_payload_;
+    std::vector<PacketRef> batch_;
+    std::vector<ReceivedPacket> received_;
+};
+
+} // namespace Core::Multiplayer::HLE
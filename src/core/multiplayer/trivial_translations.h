@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+
+#include "type_translator.h"
+#include "sudachi/src/core/hle/service/ldn/ldn_types.h"
+
+/**
+ * Trivial Translations - Non-virtual conversions for layout-identical types
+ *
+ * MAC addresses, IPv4 addresses and session IDs have the same byte layout in
+ * the internal and LDN representations, so they convert with std::bit_cast.
+ * Everything here is constexpr and header-only; callers on per-packet paths
+ * get the conversion inlined instead of going through TypeTranslator's
+ * virtual interface. The layouts are checked at compile time.
+ */
+namespace Core::Multiplayer::HLE::TrivialTranslation {
+
+using InternalMacAddress = std::array<uint8_t, 6>;
+using InternalIpv4Address = std::array<uint8_t, 4>;
+using InternalSessionIdBytes = std::array<uint8_t, InternalSessionIdSize>;
+
+template <typename To, typename From>
+inline constexpr bool IsLayoutCompatible =
+    sizeof(To) == sizeof(From) && std::is_trivially_copyable_v<To> &&
+    std::is_trivially_copyable_v<From>;
+
+static_assert(IsLayoutCompatible<Service::LDN::MacAddress, InternalMacAddress>,
+              "MacAddress must be six raw bytes");
+static_assert(IsLayoutCompatible<Service::LDN::Ipv4Address, InternalIpv4Address>,
+              "Ipv4Address must be four raw bytes");
+static_assert(IsLayoutCompatible<Service::LDN::SessionId, InternalSessionIdBytes>,
+              "SessionId must be sixteen raw bytes");
+
+constexpr Service::LDN::MacAddress ToLdnMacAddress(const InternalMacAddress& internal_mac) {
+    return std::bit_cast<Service::LDN::MacAddress>(internal_mac);
+}
+
+constexpr InternalMacAddress FromLdnMacAddress(const Service::LDN::MacAddress& ldn_mac) {
+    return std::bit_cast<InternalMacAddress>(ldn_mac);
+}
+
+constexpr Service::LDN::Ipv4Address ToLdnIpv4Address(const InternalIpv4Address& internal_ip) {
+    return std::bit_cast<Service::LDN::Ipv4Address>(internal_ip);
+}
+
+constexpr InternalIpv4Address FromLdnIpv4Address(const Service::LDN::Ipv4Address& ldn_ip) {
+    return std::bit_cast<InternalIpv4Address>(ldn_ip);
+}
+
+// Session IDs shorter than the LDN size translate to an all-zero ID
+constexpr Service::LDN::SessionId ToLdnSessionId(const InternalSessionId& internal_id) {
+    if (internal_id.size() < InternalSessionIdSize) {
+        return std::bit_cast<Service::LDN::SessionId>(InternalSessionIdBytes{});
+    }
+
+    InternalSessionIdBytes bytes{};
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        bytes[i] = internal_id[i];
+    }
+    return std::bit_cast<Service::LDN::SessionId>(bytes);
+}
+
+constexpr InternalSessionId FromLdnSessionId(const Service::LDN::SessionId& ldn_id) {
+    const auto bytes = std::bit_cast<InternalSessionIdBytes>(ldn_id);
+    InternalSessionId internal_id;
+    internal_id.assign(bytes.begin(), bytes.end());
+    return internal_id;
+}
+
+} // namespace Core::Multiplayer::HLE::TrivialTranslation
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "type_translator.h"
+#include "trivial_translations.h"
 
 #include <algorithm>
 #include <cstring>
@@ -11,6 +12,16 @@
 
 namespace Core::Multiplayer::HLE {
 
+static_assert(sizeof(Service::LDN::SessionId) == InternalSessionIdSize);
+static_assert(sizeof(Service::LDN::NetworkId) == InternalNetworkIdSize);
+static_assert(static_cast<size_t>(Service::LDN::NodeCountMax) == InternalNodeCountMax);
+
+// The trivial translations must stay usable at compile time
+static_assert(TrivialTranslation::FromLdnMacAddress(TrivialTranslation::ToLdnMacAddress(
+                  {1, 2, 3, 4, 5, 6})) == TrivialTranslation::InternalMacAddress{1, 2, 3, 4, 5, 6});
+static_assert(TrivialTranslation::FromLdnSessionId(TrivialTranslation::ToLdnSessionId(
+                  InternalSessionId{})).size() == InternalSessionIdSize);
+
 /**
  * Concrete Type Translator Implementation
  * Minimal implementation to make tests pass
@@ -19,7 +30,21 @@ class ConcreteTypeTranslator : public TypeTranslator {
 public:
   Service::LDN::NetworkInfo
   ToLdnNetworkInfo(const InternalNetworkInfo &internal) override {
-    Service::LDN::NetworkInfo ldn{};
+    Service::LDN::NetworkInfo ldn;
+    ToLdnNetworkInfo(internal, ldn);
+    return ldn;
+  }
+
+  InternalNetworkInfo
+  FromLdnNetworkInfo(const Service::LDN::NetworkInfo &ldn) override {
+    InternalNetworkInfo internal{};
+    FromLdnNetworkInfo(ldn, internal);
+    return internal;
+  }
+
+  void ToLdnNetworkInfo(const InternalNetworkInfo &internal,
+                        Service::LDN::NetworkInfo &ldn) override {
+    ldn = {};
 
     // Convert basic network properties
     ldn.network_id.intent_id.local_communication_id =
@@ -34,7 +59,8 @@ public:
     ldn.ldn.node_count_max = internal.node_count_max;
 
     if (!internal.session_id.empty()) {
-      ldn.network_id.session_id = ToLdnSessionId(internal.session_id);
+      ldn.network_id.session_id =
+          TrivialTranslation::ToLdnSessionId(internal.session_id);
     }
 
     ldn.ldn.security_mode =
@@ -71,13 +97,12 @@ public:
                   copy_size);
       ldn.ldn.advertise_data_size = static_cast<uint16_t>(copy_size);
     }
-
-    return ldn;
   }
 
-  InternalNetworkInfo
-  FromLdnNetworkInfo(const Service::LDN::NetworkInfo &ldn) override {
-    InternalNetworkInfo internal{};
+  void FromLdnNetworkInfo(const Service::LDN::NetworkInfo &ldn,
+                          InternalNetworkInfo &internal) override {
+    // Vectors and strings are assigned rather than rebuilt so a reused
+    // output keeps its capacity
 
     // Convert basic properties
     internal.network_name = ldn.common.ssid.GetStringValue();
@@ -90,36 +115,39 @@ public:
     internal.network_mode =
         static_cast<uint8_t>(ldn.common.network_type);
 
-    internal.session_id = FromLdnSessionId(ldn.network_id.session_id);
+    internal.session_id =
+        TrivialTranslation::FromLdnSessionId(ldn.network_id.session_id);
     internal.security_mode =
         static_cast<uint8_t>(ldn.ldn.security_mode);
     internal.security_parameter.assign(ldn.ldn.security_parameter.begin(),
                                       ldn.ldn.security_parameter.end());
 
-    for (size_t i = 0; i < ldn.ldn.node_count; ++i) {
+    internal.nodes.clear();
+    const size_t node_count =
+        std::min(static_cast<size_t>(ldn.ldn.node_count),
+                 internal.nodes.capacity());
+    for (size_t i = 0; i < node_count; ++i) {
       internal.nodes.push_back(FromLdnNodeInfo(ldn.ldn.nodes[i]));
     }
-    if (!internal.nodes.empty()) {
-      internal.local_communication_version =
-          internal.nodes.front().local_communication_version;
-    }
+    internal.local_communication_version =
+        internal.nodes.empty()
+            ? 0
+            : internal.nodes.front().local_communication_version;
 
-    internal.network_id.resize(sizeof(ldn.network_id));
-    std::memcpy(internal.network_id.data(), &ldn.network_id,
-                sizeof(ldn.network_id));
+    const auto *network_id =
+        reinterpret_cast<const uint8_t *>(&ldn.network_id);
+    internal.network_id.assign(network_id, network_id + sizeof(ldn.network_id));
 
     // Convert advertise data
-    if (ldn.ldn.advertise_data_size > 0) {
-      internal.advertise_data.resize(ldn.ldn.advertise_data_size);
-      std::memcpy(internal.advertise_data.data(), ldn.ldn.advertise_data.data(),
-                  ldn.ldn.advertise_data_size);
-    }
+    internal.advertise_data.assign(
+        ldn.ldn.advertise_data.begin(),
+        ldn.ldn.advertise_data.begin() +
+            std::min(static_cast<size_t>(ldn.ldn.advertise_data_size),
+                     ldn.ldn.advertise_data.size()));
 
     // Determine if password protected
     internal.has_password =
         (ldn.ldn.security_mode != Service::LDN::SecurityMode::All);
-
-    return internal;
   }
 
   Service::LDN::NodeInfo
@@ -137,11 +165,9 @@ public:
                  static_cast<size_t>(Service::LDN::UserNameBytesMax));
     std::memcpy(ldn.user_name.data(), internal.user_name.data(), name_size);
 
-    // Convert MAC address
-    std::memcpy(ldn.mac_address.raw.data(), internal.mac_address.data(), 6);
-
-    // Convert IPv4 address
-    std::memcpy(ldn.ipv4_address.data(), internal.ipv4_address.data(), 4);
+    ldn.mac_address = TrivialTranslation::ToLdnMacAddress(internal.mac_address);
+    ldn.ipv4_address =
+        TrivialTranslation::ToLdnIpv4Address(internal.ipv4_address);
 
     return ldn;
   }
@@ -161,41 +187,49 @@ public:
         std::find(name_data, name_data + Service::LDN::UserNameBytesMax, '\0');
     internal.user_name.assign(name_data, name_end);
 
-    // Convert MAC address
-    std::memcpy(internal.mac_address.data(), ldn.mac_address.raw.data(), 6);
-
-    // Convert IPv4 address
-    std::memcpy(internal.ipv4_address.data(), ldn.ipv4_address.data(), 4);
+    internal.mac_address =
+        TrivialTranslation::FromLdnMacAddress(ldn.mac_address);
+    internal.ipv4_address =
+        TrivialTranslation::FromLdnIpv4Address(ldn.ipv4_address);
 
     return internal;
   }
 
   Service::LDN::SessionId
-  ToLdnSessionId(const std::vector<uint8_t> &internal_id) override {
-    Service::LDN::SessionId ldn_id{};
-
-    if (internal_id.size() >= sizeof(ldn_id)) {
-      std::memcpy(&ldn_id, internal_id.data(), sizeof(ldn_id));
-    }
-
-    return ldn_id;
+  ToLdnSessionId(const InternalSessionId &internal_id) override {
+    return TrivialTranslation::ToLdnSessionId(internal_id);
   }
 
-  std::vector<uint8_t>
+  InternalSessionId
   FromLdnSessionId(const Service::LDN::SessionId &ldn_id) override {
-    std::vector<uint8_t> internal_id(sizeof(ldn_id));
-    std::memcpy(internal_id.data(), &ldn_id, sizeof(ldn_id));
-    return internal_id;
+    return TrivialTranslation::FromLdnSessionId(ldn_id);
   }
 
   std::vector<Service::LDN::NetworkInfo> ToLdnScanResults(
       const std::vector<InternalScanResult> &internal_results) override {
+    std::vector<Service::LDN::NetworkInfo> ldn_results(internal_results.size());
+    ToLdnScanResults(std::span<const InternalScanResult>(internal_results),
+                     std::span<Service::LDN::NetworkInfo>(ldn_results));
+    return ldn_results;
+  }
+
+  std::vector<InternalScanResult> FromLdnScanResults(
+      const std::vector<Service::LDN::NetworkInfo> &ldn_results) override {
+    std::vector<InternalScanResult> internal_results(ldn_results.size());
+    FromLdnScanResults(std::span<const Service::LDN::NetworkInfo>(ldn_results),
+                       std::span<InternalScanResult>(internal_results));
+    return internal_results;
+  }
 
-    std::vector<Service::LDN::NetworkInfo> ldn_results;
-    ldn_results.reserve(internal_results.size());
+  size_t
+  ToLdnScanResults(std::span<const InternalScanResult> internal_results,
+                   std::span<Service::LDN::NetworkInfo> out_results) override {
+    const size_t count = std::min(internal_results.size(), out_results.size());
 
-    for (const auto &internal_result : internal_results) {
-      auto ldn_info = ToLdnNetworkInfo(internal_result.network);
+    for (size_t i = 0; i < count; ++i) {
+      const auto &internal_result = internal_results[i];
+      auto &ldn_info = out_results[i];
+      ToLdnNetworkInfo(internal_result.network, ldn_info);
 
       // Store RSSI in link level (approximate conversion)
       if (internal_result.rssi >= -40) {
@@ -207,22 +241,20 @@ public:
       } else {
         ldn_info.common.link_level = Service::LDN::LinkLevel::Bad;
       }
-
-      ldn_results.push_back(ldn_info);
     }
 
-    return ldn_results;
+    return count;
   }
 
-  std::vector<InternalScanResult> FromLdnScanResults(
-      const std::vector<Service::LDN::NetworkInfo> &ldn_results) override {
-
-    std::vector<InternalScanResult> internal_results;
-    internal_results.reserve(ldn_results.size());
+  size_t
+  FromLdnScanResults(std::span<const Service::LDN::NetworkInfo> ldn_results,
+                     std::span<InternalScanResult> out_results) override {
+    const size_t count = std::min(ldn_results.size(), out_results.size());
 
-    for (const auto &ldn_info : ldn_results) {
-      InternalScanResult internal_result{};
-      internal_result.network = FromLdnNetworkInfo(ldn_info);
+    for (size_t i = 0; i < count; ++i) {
+      const auto &ldn_info = ldn_results[i];
+      auto &internal_result = out_results[i];
+      FromLdnNetworkInfo(ldn_info, internal_result.network);
 
       // Convert link level to approximate RSSI
       switch (ldn_info.common.link_level) {
@@ -243,39 +275,54 @@ public:
 
       internal_result.timestamp = 0;             // Will be set by backend
       internal_result.platform_info = "Unknown"; // Will be set by backend
-
-      internal_results.push_back(internal_result);
     }
 
-    return internal_results;
+    return count;
   }
 
+  DiscoveryFilter
+  ToDiscoveryFilter(const Service::LDN::ScanFilter &filter) override {
+    const auto flags = static_cast<uint32_t>(filter.flag);
+    const auto has = [flags](Service::LDN::ScanFilterFlag flag) {
+      return (flags & static_cast<uint32_t>(flag)) != 0;
+    };
+
+    DiscoveryFilter discovery;
+    if (has(Service::LDN::ScanFilterFlag::LocalCommunicationId)) {
+      discovery.local_communication_id =
+          filter.network_id.intent_id.local_communication_id;
+    }
+    if (has(Service::LDN::ScanFilterFlag::SceneId)) {
+      discovery.scene_id = filter.network_id.intent_id.scene_id;
+    }
+    if (has(Service::LDN::ScanFilterFlag::Ssid)) {
+      discovery.network_name = filter.ssid.GetStringValue();
+    }
+    if (has(Service::LDN::ScanFilterFlag::MacAddress)) {
+      discovery.host_mac = TrivialTranslation::FromLdnMacAddress(filter.mac_address);
+    }
+    return discovery;
+  }
+
+  // Layout-identical types forward to the inline translations
   Service::LDN::MacAddress
   ToLdnMacAddress(const std::array<uint8_t, 6> &internal_mac) override {
-    Service::LDN::MacAddress ldn_mac{};
-    std::memcpy(ldn_mac.raw.data(), internal_mac.data(), 6);
-    return ldn_mac;
+    return TrivialTranslation::ToLdnMacAddress(internal_mac);
   }
 
   std::array<uint8_t, 6>
   FromLdnMacAddress(const Service::LDN::MacAddress &ldn_mac) override {
-    std::array<uint8_t, 6> internal_mac{};
-    std::memcpy(internal_mac.data(), ldn_mac.raw.data(), 6);
-    return internal_mac;
+    return TrivialTranslation::FromLdnMacAddress(ldn_mac);
   }
 
   Service::LDN::Ipv4Address
   ToLdnIpv4Address(const std::array<uint8_t, 4> &internal_ip) override {
-    Service::LDN::Ipv4Address ldn_ip{};
-    std::memcpy(ldn_ip.data(), internal_ip.data(), 4);
-    return ldn_ip;
+    return TrivialTranslation::ToLdnIpv4Address(internal_ip);
   }
 
   std::array<uint8_t, 4>
   FromLdnIpv4Address(const Service::LDN::Ipv4Address &ldn_ip) override {
-    std::array<uint8_t, 4> internal_ip{};
-    std::memcpy(internal_ip.data(), ldn_ip.data(), 4);
-    return internal_ip;
+    return TrivialTranslation::FromLdnIpv4Address(ldn_ip);
   }
 
   Service::LDN::CreateNetworkConfig
@@ -321,7 +368,7 @@ public:
     }
 
     // Generate cryptographically secure random session ID
-    internal.session_id.resize(16);
+    internal.session_id.resize(InternalSessionIdSize);
     std::random_device rd;
     for (auto &byte : internal.session_id) {
       byte = static_cast<uint8_t>(rd());
@@ -434,4 +481,8 @@ public:
   }
 };
 
+std::unique_ptr<TypeTranslator> CreateTypeTranslator() {
+  return std::make_unique<ConcreteTypeTranslator>();
+}
+
 } // namespace Core::Multiplayer::HLE
@@ -5,8 +5,13 @@
 
 #include <vector>
 #include <string>
+#include <cstddef>
 #include <cstdint>
 #include <array>
+#include <memory>
+#include <span>
+
+#include "common/discovery_filter.h"
 
 // Forward declarations for LDN types
 namespace Service::LDN {
@@ -17,11 +22,102 @@ class MacAddress;
 class Ipv4Address;
 class CreateNetworkConfig;
 class SecurityParameter;
+class ScanFilter;
 enum class State : uint32_t;
 }
 
 namespace Core::Multiplayer::HLE {
 
+/**
+ * Fixed-capacity array with a runtime size
+ *
+ * Holds translated LDN data inline instead of on the heap, so converting a
+ * scan result does not allocate. Elements past the capacity are dropped.
+ */
+template <typename T, size_t Capacity>
+class InlineArray {
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    static constexpr size_t capacity() { return Capacity; }
+
+    constexpr size_t size() const { return size_; }
+    constexpr bool empty() const { return size_ == 0; }
+
+    constexpr T* data() { return items_.data(); }
+    constexpr const T* data() const { return items_.data(); }
+
+    constexpr T& operator[](size_t index) { return items_[index]; }
+    constexpr const T& operator[](size_t index) const { return items_[index]; }
+
+    constexpr T& front() { return items_[0]; }
+    constexpr const T& front() const { return items_[0]; }
+
+    constexpr iterator begin() { return items_.data(); }
+    constexpr iterator end() { return items_.data() + size_; }
+    constexpr const_iterator begin() const { return items_.data(); }
+    constexpr const_iterator end() const { return items_.data() + size_; }
+
+    constexpr void clear() { size_ = 0; }
+
+    constexpr void resize(size_t count) {
+        for (size_t i = size_; i < count && i < Capacity; ++i) {
+            items_[i] = T{};
+        }
+        size_ = count < Capacity ? count : Capacity;
+    }
+
+    constexpr void assign(size_t count, const T& value) {
+        size_ = count < Capacity ? count : Capacity;
+        for (size_t i = 0; i < size_; ++i) {
+            items_[i] = value;
+        }
+    }
+
+    template <typename It>
+    constexpr void assign(It first, It last) {
+        size_ = 0;
+        for (; first != last && size_ < Capacity; ++first) {
+            items_[size_++] = *first;
+        }
+    }
+
+    // Returns false (and drops the element) when full
+    constexpr bool push_back(const T& value) {
+        if (size_ == Capacity) {
+            return false;
+        }
+        items_[size_++] = value;
+        return true;
+    }
+
+    constexpr bool operator==(const InlineArray& other) const {
+        if (size_ != other.size_) {
+            return false;
+        }
+        for (size_t i = 0; i < size_; ++i) {
+            if (!(items_[i] == other.items_[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    std::array<T, Capacity> items_{};
+    size_t size_ = 0;
+};
+
+// Sizes of the LDN structures the inline arrays mirror; checked in type_translator.cpp
+constexpr size_t InternalSessionIdSize = 16; // Service::LDN::SessionId
+constexpr size_t InternalNetworkIdSize = 32; // Service::LDN::NetworkId
+constexpr size_t InternalNodeCountMax = 8;   // Service::LDN::NodeCountMax
+
+using InternalSessionId = InlineArray<uint8_t, InternalSessionIdSize>;
+using InternalNetworkId = InlineArray<uint8_t, InternalNetworkIdSize>;
+
 /**
  * Internal Multiplayer Types - Minimal definitions for type conversion
  */
@@ -36,15 +132,15 @@ struct InternalNodeInfo {
 
 struct InternalNetworkInfo {
     std::string network_name;
-    std::vector<uint8_t> network_id;
-    std::vector<uint8_t> session_id;
+    InternalNetworkId network_id;
+    InternalSessionId session_id;
     uint64_t local_communication_id;
     uint16_t channel;
     uint8_t node_count;
     uint8_t node_count_max;
     int8_t link_level;  // Signal strength
     uint8_t network_mode;  // 0=None, 1=General, 2=LDN, 3=All
-    std::vector<InternalNodeInfo> nodes;
+    InlineArray<InternalNodeInfo, InternalNodeCountMax> nodes;
     std::vector<uint8_t> advertise_data;
     bool has_password;
     std::vector<uint8_t> security_parameter;
@@ -53,7 +149,7 @@ struct InternalNetworkInfo {
 };
 
 struct InternalSessionInfo {
-    std::vector<uint8_t> session_id;
+    InternalSessionId session_id;
     uint64_t local_communication_id;
     uint16_t scene_id;
     std::string passphrase;
@@ -77,21 +173,38 @@ public:
     // Network info translations
     virtual Service::LDN::NetworkInfo ToLdnNetworkInfo(const InternalNetworkInfo& internal) = 0;
     virtual InternalNetworkInfo FromLdnNetworkInfo(const Service::LDN::NetworkInfo& ldn) = 0;
+
+    // In-place network info translations - overwrite every field of the output
+    // so callers can reuse it without copying or reallocating
+    virtual void ToLdnNetworkInfo(const InternalNetworkInfo& internal,
+                                  Service::LDN::NetworkInfo& out_ldn) = 0;
+    virtual void FromLdnNetworkInfo(const Service::LDN::NetworkInfo& ldn,
+                                    InternalNetworkInfo& out_internal) = 0;
     
     // Node info translations
     virtual Service::LDN::NodeInfo ToLdnNodeInfo(const InternalNodeInfo& internal) = 0;
     virtual InternalNodeInfo FromLdnNodeInfo(const Service::LDN::NodeInfo& ldn) = 0;
     
     // Session info translations
-    virtual Service::LDN::SessionId ToLdnSessionId(const std::vector<uint8_t>& internal_id) = 0;
-    virtual std::vector<uint8_t> FromLdnSessionId(const Service::LDN::SessionId& ldn_id) = 0;
+    virtual Service::LDN::SessionId ToLdnSessionId(const InternalSessionId& internal_id) = 0;
+    virtual InternalSessionId FromLdnSessionId(const Service::LDN::SessionId& ldn_id) = 0;
     
     // Scan result translations
     virtual std::vector<Service::LDN::NetworkInfo> ToLdnScanResults(
         const std::vector<InternalScanResult>& internal_results) = 0;
     virtual std::vector<InternalScanResult> FromLdnScanResults(
         const std::vector<Service::LDN::NetworkInfo>& ldn_results) = 0;
+
+    // Batch scan result translations - write into caller-owned storage and
+    // return the number of entries written (the shorter of the two spans)
+    virtual size_t ToLdnScanResults(std::span<const InternalScanResult> internal_results,
+                                    std::span<Service::LDN::NetworkInfo> out_results) = 0;
+    virtual size_t FromLdnScanResults(std::span<const Service::LDN::NetworkInfo> ldn_results,
+                                      std::span<InternalScanResult> out_results) = 0;
     
+    // Scan filter in backend-neutral terms, for SetDiscoveryFilter
+    virtual DiscoveryFilter ToDiscoveryFilter(const Service::LDN::ScanFilter& filter) = 0;
+
     // Address translations
     virtual Service::LDN::MacAddress ToLdnMacAddress(const std::array<uint8_t, 6>& internal_mac) = 0;
     virtual std::array<uint8_t, 6> FromLdnMacAddress(const Service::LDN::MacAddress& ldn_mac) = 0;
@@ -111,9 +224,13 @@ public:
     virtual Service::LDN::State ToLdnState(const std::string& internal_state) = 0;
     virtual std::string FromLdnState(Service::LDN::State ldn_state) = 0;
     
-    // Validation methods
+    // Validation methods. A few header field comparisons, no per-node scan:
+    // cheaper than hashing the structure, so results are not worth caching.
     virtual bool ValidateLdnNetworkInfo(const Service::LDN::NetworkInfo& info) = 0;
     virtual bool ValidateInternalNetworkInfo(const InternalNetworkInfo& info) = 0;
 };
 
+// Factory function to create a concrete translator instance
+std::unique_ptr<TypeTranslator> CreateTypeTranslator();
+
 } // namespace Core::Multiplayer::HLE
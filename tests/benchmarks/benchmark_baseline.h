@@ -0,0 +1,289 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "benchmark_utilities.h"
+
+namespace Benchmarks {
+
+// =============================================================================
+// Baseline Storage
+// =============================================================================
+
+/**
+ * Per-benchmark timing samples from one run of the suite, keyed by the
+ * commit and CPU model they were measured on. Each sample is the mean time
+ * per iteration of one repetition in nanoseconds, so a run needs
+ * --benchmark_repetitions for the comparison to have anything to work with.
+ */
+struct BenchmarkSnapshot {
+    std::string commit = "unknown";
+    std::string cpu_model = "unknown";
+    std::string timestamp;
+    std::map<std::string, StatisticalAnalyzer> benchmarks;
+};
+
+class BaselineStore {
+public:
+    static std::string DetectCpuModel() {
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(cpuinfo, line)) {
+            if (line.rfind("model name", 0) == 0) {
+                const auto colon = line.find(':');
+                if (colon != std::string::npos) {
+                    return Trim(line.substr(colon + 1));
+                }
+            }
+        }
+        return "unknown";
+    }
+
+    // File-name friendly form of a commit or CPU model
+    static std::string Slug(const std::string& text) {
+        std::string slug;
+        for (char c : text) {
+            if (std::isalnum(static_cast<unsigned char>(c))) {
+                slug += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            } else if (!slug.empty() && slug.back() != '-') {
+                slug += '-';
+            }
+        }
+        while (!slug.empty() && slug.back() == '-') {
+            slug.pop_back();
+        }
+        return slug.empty() ? "unknown" : slug;
+    }
+
+    // <commit>_<cpu>.json, so results from several machines can share a directory
+    static std::string FileNameFor(const BenchmarkSnapshot& snapshot) {
+        return Slug(snapshot.commit) + "_" + Slug(snapshot.cpu_model) + ".json";
+    }
+
+    static bool Save(const BenchmarkSnapshot& snapshot, const std::string& path) {
+        nlohmann::json benchmarks = nlohmann::json::object();
+        for (const auto& [name, samples] : snapshot.benchmarks) {
+            benchmarks[name] = samples.GetSamples();
+        }
+        const nlohmann::json document = {
+            {"commit", snapshot.commit},
+            {"cpu_model", snapshot.cpu_model},
+            {"timestamp", snapshot.timestamp},
+            {"unit", "ns"},
+            {"benchmarks", std::move(benchmarks)},
+        };
+
+        std::error_code ec;
+        const auto directory = std::filesystem::path(path).parent_path();
+        if (!directory.empty()) {
+            std::filesystem::create_directories(directory, ec);
+        }
+        std::ofstream file(path);
+        if (!file) {
+            return false;
+        }
+        file << document.dump(2) << "\n";
+        return static_cast<bool>(file);
+    }
+
+    static std::optional<BenchmarkSnapshot> Load(const std::string& path) {
+        std::ifstream file(path);
+        if (!file) {
+            return std::nullopt;
+        }
+        const auto document = nlohmann::json::parse(file, nullptr, false);
+        if (document.is_discarded() || !document.contains("benchmarks") ||
+            !document["benchmarks"].is_object()) {
+            return std::nullopt;
+        }
+
+        BenchmarkSnapshot snapshot;
+        snapshot.commit = document.value("commit", "unknown");
+        snapshot.cpu_model = document.value("cpu_model", "unknown");
+        snapshot.timestamp = document.value("timestamp", "");
+        for (const auto& [name, samples] : document["benchmarks"].items()) {
+            if (!samples.is_array()) {
+                continue;
+            }
+            auto& analyzer = snapshot.benchmarks[name];
+            for (const auto& sample : samples) {
+                if (sample.is_number()) {
+                    analyzer.AddSample(sample.get<double>());
+                }
+            }
+        }
+        return snapshot;
+    }
+
+private:
+    static std::string Trim(const std::string& text) {
+        const auto first = text.find_first_not_of(" \t");
+        const auto last = text.find_last_not_of(" \t\r\n");
+        return first == std::string::npos ? std::string{} : text.substr(first, last - first + 1);
+    }
+};
+
+// =============================================================================
+// Regression Comparison
+// =============================================================================
+
+enum class RegressionVerdict {
+    Pass,         // Within the threshold, or the change is not significant
+    Regressed,    // Significantly slower by more than the threshold
+    Improved,     // Significantly faster by more than the threshold
+    Inconclusive, // Beyond the threshold, but too few samples to tell
+    New,          // Not in the baseline
+};
+
+struct RegressionRow {
+    std::string name;
+    double baseline_median_ns = 0.0;
+    double current_median_ns = 0.0;
+    double change_percent = 0.0;
+    double p_value = 1.0;
+    StatisticalAnalyzer::ConfidenceInterval ratio_ci; // current / baseline
+    RegressionVerdict verdict = RegressionVerdict::New;
+};
+
+/**
+ * Compares a run against a baseline benchmark by benchmark. A benchmark
+ * regresses when its median slows down by more than the threshold and the
+ * Mann-Whitney test finds the two sample sets different at the given
+ * significance level; the bootstrap interval of the median ratio is
+ * reported alongside.
+ */
+class RegressionComparator {
+public:
+    static constexpr size_t MIN_SAMPLES = 3;
+
+    explicit RegressionComparator(double threshold = 0.10, double alpha = 0.05)
+        : threshold_(threshold), alpha_(alpha) {}
+
+    std::vector<RegressionRow> Compare(const BenchmarkSnapshot& baseline,
+                                       const BenchmarkSnapshot& current) const {
+        std::vector<RegressionRow> rows;
+        for (const auto& [name, samples] : current.benchmarks) {
+            RegressionRow row;
+            row.name = name;
+            row.current_median_ns = samples.GetMedian();
+
+            const auto base = baseline.benchmarks.find(name);
+            if (base == baseline.benchmarks.end() || base->second.GetSampleCount() == 0) {
+                rows.push_back(std::move(row));
+                continue;
+            }
+            row.baseline_median_ns = base->second.GetMedian();
+            const double ratio = row.baseline_median_ns > 0.0
+                                     ? row.current_median_ns / row.baseline_median_ns
+                                     : 1.0;
+            row.change_percent = (ratio - 1.0) * 100.0;
+
+            const bool beyond_threshold = std::abs(ratio - 1.0) > threshold_;
+            if (samples.GetSampleCount() < MIN_SAMPLES ||
+                base->second.GetSampleCount() < MIN_SAMPLES) {
+                row.verdict = beyond_threshold ? RegressionVerdict::Inconclusive
+                                               : RegressionVerdict::Pass;
+                rows.push_back(std::move(row));
+                continue;
+            }
+
+            row.p_value = StatisticalAnalyzer::MannWhitneyU(samples, base->second).p_value;
+            row.ratio_ci = StatisticalAnalyzer::BootstrapMedianRatio(samples, base->second);
+            if (beyond_threshold && row.p_value < alpha_) {
+                row.verdict = ratio > 1.0 ? RegressionVerdict::Regressed
+                                          : RegressionVerdict::Improved;
+            } else {
+                row.verdict = RegressionVerdict::Pass;
+            }
+            rows.push_back(std::move(row));
+        }
+        return rows;
+    }
+
+    /**
+     * Prints one line per benchmark. prd_status returns whether the
+     * benchmark met its PRD Section 7.1 target, or nothing if none applies.
+     */
+    static void PrintTable(const std::vector<RegressionRow>& rows,
+                           const std::function<std::optional<bool>(const std::string&)>& prd_status) {
+        std::cout << "\n" << std::string(80, '=') << std::endl;
+        std::cout << "REGRESSION CHECK AGAINST BASELINE" << std::endl;
+        std::cout << std::string(80, '=') << std::endl;
+        std::cout << std::left << std::setw(44) << "Benchmark" << std::right
+                  << std::setw(12) << "Base (ns)" << std::setw(12) << "Now (ns)"
+                  << std::setw(9) << "Change" << std::setw(8) << "p" << std::setw(14)
+                  << "Ratio 95% CI" << "  " << std::left << std::setw(13) << "Verdict"
+                  << "PRD" << std::endl;
+        std::cout << std::string(120, '-') << std::endl;
+
+        size_t regressions = 0;
+        for (const auto& row : rows) {
+            std::ostringstream ci;
+            if (row.ratio_ci.upper > 0.0) {
+                ci << std::fixed << std::setprecision(2) << row.ratio_ci.lower << "-"
+                   << row.ratio_ci.upper;
+            } else {
+                ci << "-";
+            }
+            const auto prd = prd_status(row.name);
+
+            std::cout << std::left << std::setw(44) << Truncate(row.name, 43) << std::right
+                      << std::fixed << std::setprecision(1) << std::setw(12)
+                      << row.baseline_median_ns << std::setw(12) << row.current_median_ns
+                      << std::showpos << std::setw(8) << row.change_percent << "%"
+                      << std::noshowpos << std::setprecision(3) << std::setw(8) << row.p_value
+                      << std::setw(14) << ci.str() << "  " << std::left << std::setw(13)
+                      << VerdictName(row.verdict) << (prd ? (*prd ? "PASS" : "FAIL") : "-")
+                      << std::endl;
+            regressions += row.verdict == RegressionVerdict::Regressed;
+        }
+
+        std::cout << std::string(120, '-') << std::endl;
+        std::cout << "Regressions: " << regressions << " of " << rows.size() << " benchmarks"
+                  << std::endl;
+    }
+
+    static const char* VerdictName(RegressionVerdict verdict) {
+        switch (verdict) {
+        case RegressionVerdict::Pass:
+            return "PASS";
+        case RegressionVerdict::Regressed:
+            return "REGRESS";
+        case RegressionVerdict::Improved:
+            return "IMPROVED";
+        case RegressionVerdict::Inconclusive:
+            return "INCONCLUSIVE";
+        case RegressionVerdict::New:
+            return "NEW";
+        }
+        return "UNKNOWN";
+    }
+
+private:
+    static std::string Truncate(const std::string& text, size_t max_length) {
+        return text.size() <= max_length ? text : text.substr(0, max_length - 3) + "...";
+    }
+
+    double threshold_;
+    double alpha_;
+};
+
+} // namespace Benchmarks
@@ -14,6 +14,10 @@
 
 #include "benchmark_mocks.h"
 #include "benchmark_utilities.h"
+#include "backend_dispatch.h"
+#include "model_a/model_a_backend.h"
+#include "type_translator.h"
+#include "sudachi/src/core/hle/service/ldn/ldn_types.h"
 
 namespace Benchmarks {
 
@@ -218,6 +222,174 @@ BENCHMARK_REGISTER_F(HLEInterfaceFixture, SendReceivePackets)
     ->Iterations(5000)
     ->Name("Component/HLE/SendReceivePackets");
 
+// =============================================================================
+// Type Translation Benchmarks
+// =============================================================================
+
+namespace {
+
+// A busy scan: dozens of networks, each with a full set of nodes
+std::vector<Core::Multiplayer::HLE::InternalScanResult> MakeScanResults(size_t count) {
+    using namespace Core::Multiplayer::HLE;
+
+    std::vector<InternalScanResult> results(count);
+    for (size_t i = 0; i < count; ++i) {
+        auto& network = results[i].network;
+        network.network_name = "Network_" + std::to_string(i);
+        network.local_communication_id = 0x0100000000010000ULL + i;
+        network.node_count = static_cast<uint8_t>(InternalNodeCountMax);
+        network.node_count_max = static_cast<uint8_t>(InternalNodeCountMax);
+        network.session_id.assign(InternalSessionIdSize, static_cast<uint8_t>(i));
+        network.advertise_data.assign(128, 0xAB);
+        network.security_parameter.assign(16, 0x5A);
+        for (size_t n = 0; n < InternalNodeCountMax; ++n) {
+            network.nodes.push_back({static_cast<uint8_t>(n), "Player_" + std::to_string(n),
+                                     {}, {}, true, 1});
+        }
+        results[i].rssi = static_cast<int8_t>(-30 - static_cast<int>(i % 60));
+    }
+    return results;
+}
+
+} // namespace
+
+/**
+ * Benchmark: Scan result translation returning a new vector per call
+ * Baseline for the batch translation below
+ */
+static void TypeTranslation_ScanResultsVector(benchmark::State& state) {
+    auto translator = Core::Multiplayer::HLE::CreateTypeTranslator();
+    const auto results = MakeScanResults(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        auto networks = translator->ToLdnScanResults(results);
+        benchmark::DoNotOptimize(networks.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(TypeTranslation_ScanResultsVector)
+    ->Arg(8)
+    ->Arg(32)
+    ->Arg(64)
+    ->Unit(benchmark::kMicrosecond)
+    ->Name("Component/HLE/TypeTranslation/ToLdnVector");
+
+/**
+ * Benchmark: Batch scan result translation into preallocated storage
+ */
+static void TypeTranslation_ScanResultsBatch(benchmark::State& state) {
+    auto translator = Core::Multiplayer::HLE::CreateTypeTranslator();
+    const auto results = MakeScanResults(static_cast<size_t>(state.range(0)));
+    std::vector<Service::LDN::NetworkInfo> networks(results.size());
+
+    for (auto _ : state) {
+        const size_t written = translator->ToLdnScanResults(
+            std::span<const Core::Multiplayer::HLE::InternalScanResult>(results),
+            std::span<Service::LDN::NetworkInfo>(networks));
+        benchmark::DoNotOptimize(written);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(TypeTranslation_ScanResultsBatch)
+    ->Arg(8)
+    ->Arg(32)
+    ->Arg(64)
+    ->Unit(benchmark::kMicrosecond)
+    ->Name("Component/HLE/TypeTranslation/ToLdnBatch");
+
+/**
+ * Benchmark: Batch translation back to internal results, reusing the outputs
+ * After the first pass nothing is reallocated
+ */
+static void TypeTranslation_FromLdnBatch(benchmark::State& state) {
+    using Core::Multiplayer::HLE::InternalScanResult;
+
+    auto translator = Core::Multiplayer::HLE::CreateTypeTranslator();
+    const auto networks = translator->ToLdnScanResults(
+        MakeScanResults(static_cast<size_t>(state.range(0))));
+    std::vector<InternalScanResult> results(networks.size());
+
+    for (auto _ : state) {
+        const size_t written = translator->FromLdnScanResults(
+            std::span<const Service::LDN::NetworkInfo>(networks),
+            std::span<InternalScanResult>(results));
+        benchmark::DoNotOptimize(written);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(TypeTranslation_FromLdnBatch)
+    ->Arg(8)
+    ->Arg(32)
+    ->Arg(64)
+    ->Unit(benchmark::kMicrosecond)
+    ->Name("Component/HLE/TypeTranslation/FromLdnBatch");
+
+// =============================================================================
+// Backend Dispatch Benchmarks
+// =============================================================================
+
+/**
+ * Benchmark: Per-packet receive through the MultiplayerBackend vtable
+ * Baseline for the devirtualized dispatch below
+ */
+static void BackendDispatch_VirtualReceive(benchmark::State& state) {
+    auto backend = std::make_unique<Core::Multiplayer::ModelA::ModelABackend>(nullptr, nullptr);
+    backend->Initialize();
+    Core::Multiplayer::HLE::MultiplayerBackend* base = backend.get();
+    benchmark::DoNotOptimize(base);
+
+    Core::Multiplayer::PacketBuffer packet;
+    uint8_t node_id = 0;
+    for (auto _ : state) {
+        auto error = base->ReceivePacket(packet, node_id);
+        benchmark::DoNotOptimize(error);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BackendDispatch_VirtualReceive)
+    ->Unit(benchmark::kNanosecond)
+    ->Name("Component/HLE/BackendDispatch/Virtual");
+
+/**
+ * Benchmark: Per-packet receive through BackendDispatch
+ */
+static void BackendDispatch_DirectReceive(benchmark::State& state) {
+    auto backend = std::make_unique<Core::Multiplayer::ModelA::ModelABackend>(nullptr, nullptr);
+    backend->Initialize();
+    Core::Multiplayer::HLE::MultiplayerBackend* base = backend.get();
+    benchmark::DoNotOptimize(base);
+
+    Core::Multiplayer::HLE::BackendDispatch dispatch;
+    dispatch.Bind(base);
+    if (!dispatch.IsDevirtualized()) {
+        state.SkipWithError("ModelABackend was not devirtualized");
+        return;
+    }
+
+    Core::Multiplayer::PacketBuffer packet;
+    uint8_t node_id = 0;
+    for (auto _ : state) {
+        auto error = dispatch.ReceivePacket(packet, node_id);
+        benchmark::DoNotOptimize(error);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BackendDispatch_DirectReceive)
+    ->Unit(benchmark::kNanosecond)
+    ->Name("Component/HLE/BackendDispatch/Direct");
+
 // =============================================================================
 // Configuration System Performance Benchmarks
 // =============================================================================
@@ -0,0 +1,305 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "common/lock_contention.h"
+#include "common/network_security.h"
+#include "model_a/libp2p_p2p_network.h"
+#include "model_a/room_client.h"
+
+#include "room_client_stubs.h"
+
+namespace Benchmarks {
+
+/**
+ * Lock contention sweeps of the shared hot paths
+ *
+ * Each benchmark shares one component between 1 to 64 threads. Beside the
+ * usual items_per_second, which shows how throughput scales with threads,
+ * it reports per operation how often a lock was found held (contended) and
+ * how long the caller waited for it (wait_ns), as counted by the component's
+ * ProfiledMutex sites. Compare two builds with
+ *
+ *   sudachi_multiplayer_contention_benchmarks --benchmark_out=before.json
+ *       --benchmark_out_format=json
+ *   compare.py benchmarks before.json after.json
+ *
+ * A lock-free path shows zero wait at every thread count; throughput that
+ * stops growing while wait_ns stays at zero points at cache line traffic
+ * instead.
+ */
+
+using namespace Core::Multiplayer;
+
+namespace {
+
+void ContentionThreadCounts(benchmark::internal::Benchmark* benchmark) {
+    for (int threads : {1, 2, 4, 8, 16, 32, 64}) {
+        benchmark->Threads(threads);
+    }
+    benchmark->UseRealTime();
+}
+
+/**
+ * Resets the lock counters before the timed loop and reports the waits on
+ * the given sites after it. Only thread 0 does either; Google Benchmark
+ * holds every thread at the start and end of the loop, so the counts cover
+ * exactly the timed operations of all threads.
+ */
+class LockWaitReport {
+public:
+    LockWaitReport(benchmark::State& state, std::vector<LockSite> sites)
+        : state_(state), sites_(std::move(sites)) {
+        if (state_.thread_index() == 0) {
+            ResetLockContentionStatistics();
+        }
+    }
+
+    ~LockWaitReport() {
+        if (state_.thread_index() != 0) {
+            return;
+        }
+        const auto statistics = GetLockContentionStatistics();
+        uint64_t contended = 0;
+        uint64_t wait_ns = 0;
+        for (const LockSite site : sites_) {
+            contended += statistics[site].contended;
+            wait_ns += statistics[site].wait_ns;
+        }
+        // Other threads report nothing, so the sum over threads divided by
+        // all their iterations is per operation
+        state_.counters["contended"] = benchmark::Counter(
+            static_cast<double>(contended), benchmark::Counter::kAvgIterations);
+        state_.counters["wait_ns"] = benchmark::Counter(static_cast<double>(wait_ns),
+                                                        benchmark::Counter::kAvgIterations);
+    }
+
+private:
+    benchmark::State& state_;
+    std::vector<LockSite> sites_;
+};
+
+} // namespace
+
+// =============================================================================
+// RoomClient
+// =============================================================================
+
+/**
+ * Benchmark: Every thread sends through one RoomClient. Each send takes the
+ * connection handle under the client's connection lock
+ */
+static void BM_Contention_RoomClient_SendMessage(benchmark::State& state) {
+    static std::unique_ptr<ModelA::RoomClient> client;
+    if (state.thread_index() == 0) {
+        client = std::make_unique<ModelA::RoomClient>(std::make_shared<IdleWebSocketConnection>(),
+                                                      std::make_shared<StaticConfig>());
+    }
+    const std::string message = R"({"type":"heartbeat","thread":)" +
+                                std::to_string(state.thread_index()) + "}";
+
+    {
+        LockWaitReport report(state, {LockSite::RoomClientConnection});
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(client->SendMessage(message));
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        client->Shutdown();
+        client.reset();
+    }
+}
+BENCHMARK(BM_Contention_RoomClient_SendMessage)
+    ->Name("Contention/RoomClient/SendMessage")
+    ->Apply(ContentionThreadCounts);
+
+/**
+ * Benchmark: Every thread queues a message on one RoomClient and pumps the
+ * queue once, so producers and the sender share the outbound ring
+ */
+static void BM_Contention_RoomClient_QueueMessage(benchmark::State& state) {
+    static std::unique_ptr<ModelA::RoomClient> client;
+    if (state.thread_index() == 0) {
+        client = std::make_unique<ModelA::RoomClient>(std::make_shared<IdleWebSocketConnection>(),
+                                                      std::make_shared<StaticConfig>());
+    }
+    const std::string message = R"({"type":"heartbeat","thread":)" +
+                                std::to_string(state.thread_index()) + "}";
+
+    {
+        LockWaitReport report(state, {LockSite::RoomClientConnection,
+                                      LockSite::RoomClientCallbacks});
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(client->QueueMessage(message));
+            benchmark::DoNotOptimize(client->ProcessPendingMessages());
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        client->Shutdown();
+        client.reset();
+    }
+}
+BENCHMARK(BM_Contention_RoomClient_QueueMessage)
+    ->Name("Contention/RoomClient/QueueMessage")
+    ->Apply(ContentionThreadCounts);
+
+// =============================================================================
+// ClientRateManager
+// =============================================================================
+
+/**
+ * Benchmark: Packet rate checks on one manager, with each thread its own
+ * client (spread over the shards) or all threads on one client (one shard,
+ * one token bucket)
+ */
+static void BM_Contention_ClientRateManager_CheckPacketRateLimit(benchmark::State& state) {
+    static std::unique_ptr<Security::ClientRateManager> manager;
+    if (state.thread_index() == 0) {
+        Security::RateLimitConfig config;
+        config.packets_per_second = 1e9;
+        config.burst_capacity = 1e9;
+        manager = std::make_unique<Security::ClientRateManager>(config);
+    }
+    const bool shared_client = state.range(0) != 0;
+    const std::string client_id =
+        shared_client ? "client" : "client" + std::to_string(state.thread_index());
+
+    {
+        LockWaitReport report(state, {LockSite::RateLimiterShard});
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(manager->CheckPacketRateLimit(client_id));
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        manager.reset();
+    }
+}
+BENCHMARK(BM_Contention_ClientRateManager_CheckPacketRateLimit)
+    ->Name("Contention/ClientRateManager/CheckPacketRateLimit")
+    ->ArgName("shared_client")
+    ->Arg(0)
+    ->Arg(1)
+    ->Apply(ContentionThreadCounts);
+
+// =============================================================================
+// Libp2pP2PNetwork
+// =============================================================================
+
+namespace {
+
+constexpr const char* BENCHMARK_PROTOCOL = "/sudachi/benchmark/1.0.0";
+
+/**
+ * Two networks on loopback TCP, the second connected to the first. Set up
+ * once and kept for the whole run, since connecting takes far longer than
+ * any one benchmark repetition.
+ */
+struct LoopbackPeers {
+    std::unique_ptr<ModelA::Libp2pP2PNetwork> listener;
+    std::unique_ptr<ModelA::Libp2pP2PNetwork> sender;
+    std::string listener_id;
+    bool connected = false;
+};
+
+ModelA::P2PNetworkConfig LoopbackConfig(uint16_t port) {
+    ModelA::P2PNetworkConfig config;
+    config.enable_quic = false;
+    config.enable_autonat = false;
+    config.enable_relay = false;
+    config.tcp_port = port;
+    return config;
+}
+
+LoopbackPeers& GetLoopbackPeers() {
+    static LoopbackPeers peers = [] {
+        LoopbackPeers result;
+        result.listener = std::make_unique<ModelA::Libp2pP2PNetwork>(LoopbackConfig(47301));
+        result.sender = std::make_unique<ModelA::Libp2pP2PNetwork>(LoopbackConfig(47302));
+        result.listener->RegisterProtocolHandler(BENCHMARK_PROTOCOL);
+        result.listener->Start();
+        result.sender->Start();
+        result.listener_id = result.listener->GetPeerId();
+        result.sender->ConnectToPeer(result.listener_id,
+                                     "/ip4/127.0.0.1/tcp/47301/p2p/" + result.listener_id);
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!result.sender->IsConnectedToPeer(result.listener_id) &&
+               std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        result.connected = result.sender->IsConnectedToPeer(result.listener_id);
+        return result;
+    }();
+    return peers;
+}
+
+} // namespace
+
+/**
+ * Benchmark: Every thread writes to the same connected peer. Writers that
+ * find the stream busy queue behind the one holding it
+ */
+static void BM_Contention_Libp2p_SendMessage(benchmark::State& state) {
+    auto& peers = GetLoopbackPeers();
+    if (!peers.connected) {
+        state.SkipWithError("Loopback libp2p peers did not connect");
+        return;
+    }
+    const std::vector<uint8_t> payload(static_cast<size_t>(state.range(0)), 0xA5);
+
+    {
+        LockWaitReport report(state, {LockSite::P2PState, LockSite::P2PPeerWrite,
+                                      LockSite::P2PPeerSendQueue});
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(
+                peers.sender->SendMessage(peers.listener_id, BENCHMARK_PROTOCOL, payload));
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_Contention_Libp2p_SendMessage)
+    ->Name("Contention/Libp2p/SendMessage")
+    ->ArgName("payload")
+    ->Arg(64)
+    ->Arg(1400)
+    ->Apply(ContentionThreadCounts);
+
+/**
+ * Benchmark: Connection checks on the send path, for a connected peer and
+ * an unknown one
+ */
+static void BM_Contention_Libp2p_IsConnectedToPeer(benchmark::State& state) {
+    auto& peers = GetLoopbackPeers();
+    if (!peers.connected) {
+        state.SkipWithError("Loopback libp2p peers did not connect");
+        return;
+    }
+    const std::string peer_id = state.range(0) != 0 ? peers.listener_id : "12D3KooWUnknownPeer";
+
+    {
+        LockWaitReport report(state, {LockSite::P2PState});
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(peers.sender->IsConnectedToPeer(peer_id));
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Contention_Libp2p_IsConnectedToPeer)
+    ->Name("Contention/Libp2p/IsConnectedToPeer")
+    ->ArgName("connected")
+    ->Arg(1)
+    ->Arg(0)
+    ->Apply(ContentionThreadCounts);
+
+} // namespace Benchmarks
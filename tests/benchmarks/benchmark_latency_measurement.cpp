@@ -274,6 +274,148 @@ BENCHMARK_REGISTER_F(RelayLatencyFixture, RelayServerRTT)
     ->UseManualTime()
     ->Name("Latency/Relay/ServerRouting");
 
+// =============================================================================
+// P2P Transport Comparison: QUIC vs TCP
+// =============================================================================
+
+/**
+ * Simulated P2P link for comparing the transports Libp2pP2PNetwork dials.
+ * Times are computed rather than slept, so every run sees the same
+ * seeded loss pattern.
+ *
+ * TCP: TCP handshake, then multistream-select, Noise and mplex negotiation
+ * before the first stream; one byte stream carries game and control
+ * traffic, so a lost segment holds up everything behind it until it is
+ * retransmitted.
+ * QUIC: one round trip to an encrypted, multiplexed connection plus
+ * protocol selection; keepalives use their own stream and only wait for
+ * their own losses.
+ */
+class TransportComparisonFixture : public benchmark::Fixture {
+public:
+    enum Transport : int64_t { Tcp = 0, Quic = 1 };
+
+    static constexpr double RTT_MS = 40.0;
+    static constexpr double LOSS_RATE = 0.02;
+    // Retransmission once the loss is noticed, about one RTT later
+    static constexpr double RETRANSMIT_DELAY_MS = RTT_MS * 1.5;
+    static constexpr double FRAME_INTERVAL_MS = 1000.0 / 60.0;
+
+    static double ConnectionSetupMs(Transport transport) {
+        // TCP: SYN, multistream security, Noise XX, multistream muxer, protocol
+        // QUIC: handshake with TLS, protocol
+        return (transport == Tcp ? 5.0 : 2.0) * RTT_MS;
+    }
+
+    void SetUp(const benchmark::State& state) override {
+        rng_.seed(0x51D4C41);
+    }
+
+    void TearDown(const benchmark::State& state) override {}
+
+protected:
+    bool Lost() {
+        return loss_(rng_) < LOSS_RATE;
+    }
+
+    // One-way delay of a packet, its own retransmission included
+    double OneWayMs() {
+        double delay = RTT_MS / 2.0 + jitter_(rng_);
+        while (Lost()) {
+            delay += RETRANSMIT_DELAY_MS;
+        }
+        return delay;
+    }
+
+    std::mt19937 rng_;
+    std::uniform_real_distribution<double> loss_{0.0, 1.0};
+    std::uniform_real_distribution<double> jitter_{0.0, 2.0};
+    std::vector<double> latency_samples_;
+};
+
+BENCHMARK_DEFINE_F(TransportComparisonFixture, ConnectionSetup)(benchmark::State& state) {
+    const auto transport = static_cast<Transport>(state.range(0));
+    latency_samples_.clear();
+    latency_samples_.reserve(1000);
+
+    for (auto _ : state) {
+        double setup_ms = ConnectionSetupMs(transport);
+        // A handshake packet lost costs a retransmission as well
+        for (int i = 0; i < (transport == Tcp ? 10 : 4); ++i) {
+            if (Lost()) {
+                setup_ms += RETRANSMIT_DELAY_MS;
+            }
+        }
+        latency_samples_.push_back(setup_ms);
+        state.SetIterationTime(setup_ms / 1000.0);
+    }
+
+    if (!latency_samples_.empty()) {
+        double avg_setup = std::accumulate(latency_samples_.begin(), latency_samples_.end(), 0.0) / latency_samples_.size();
+        std::sort(latency_samples_.begin(), latency_samples_.end());
+        state.counters["AvgSetup_ms"] = avg_setup;
+        state.counters["P95Setup_ms"] = latency_samples_[static_cast<size_t>(latency_samples_.size() * 0.95)];
+        state.counters["SetupRTTs"] = ConnectionSetupMs(transport) / RTT_MS;
+    }
+}
+
+BENCHMARK_REGISTER_F(TransportComparisonFixture, ConnectionSetup)
+    ->Arg(TransportComparisonFixture::Tcp)
+    ->Arg(TransportComparisonFixture::Quic)
+    ->ArgNames({"quic"})
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(1000)
+    ->UseManualTime()
+    ->Name("Latency/P2P/Transport/ConnectionSetup");
+
+BENCHMARK_DEFINE_F(TransportComparisonFixture, KeepaliveUnderGameLoad)(benchmark::State& state) {
+    const auto transport = static_cast<Transport>(state.range(0));
+    latency_samples_.clear();
+    latency_samples_.reserve(1000);
+
+    // Arrival time of the latest game frame; on one byte stream nothing sent
+    // after it can be delivered before it
+    double game_frame_sent_ms = 0.0;
+    double game_frame_arrival_ms = 0.0;
+
+    for (auto _ : state) {
+        // A game frame goes out every frame, a keepalive right after it
+        game_frame_sent_ms += FRAME_INTERVAL_MS;
+        game_frame_arrival_ms = std::max(game_frame_arrival_ms, game_frame_sent_ms + OneWayMs());
+
+        double request_arrival_ms = game_frame_sent_ms + OneWayMs();
+        if (transport == Tcp) {
+            request_arrival_ms = std::max(request_arrival_ms, game_frame_arrival_ms);
+        }
+        const double rtt_ms = request_arrival_ms - game_frame_sent_ms + OneWayMs();
+
+        latency_samples_.push_back(rtt_ms);
+        state.SetIterationTime(rtt_ms / 1000.0);
+    }
+
+    if (!latency_samples_.empty()) {
+        double avg_latency = std::accumulate(latency_samples_.begin(), latency_samples_.end(), 0.0) / latency_samples_.size();
+        std::sort(latency_samples_.begin(), latency_samples_.end());
+        double p99_latency = latency_samples_[static_cast<size_t>(latency_samples_.size() * 0.99)];
+
+        state.counters["AvgLatency_ms"] = avg_latency;
+        state.counters["P99Latency_ms"] = p99_latency;
+        state.counters["PRDTarget_ms"] = 20.0;
+        // Overhead over the link's own round trip
+        state.counters["ProcessingOverhead_ms"] = avg_latency - RTT_MS;
+        state.counters["LossRate"] = LOSS_RATE;
+    }
+}
+
+BENCHMARK_REGISTER_F(TransportComparisonFixture, KeepaliveUnderGameLoad)
+    ->Arg(TransportComparisonFixture::Tcp)
+    ->Arg(TransportComparisonFixture::Quic)
+    ->ArgNames({"quic"})
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(1000)
+    ->UseManualTime()
+    ->Name("Latency/P2P/Transport/KeepaliveUnderGameLoad");
+
 // =============================================================================
 // Packet Processing Latency Benchmarks
 // =============================================================================
@@ -0,0 +1,625 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "backend_factory.h"
+#include "benchmark_utilities.h"
+#include "loopback_harness.h"
+#include "model_a/model_a_backend.h"
+#include "model_a/relay_protocol.h"
+#include "model_a/relay_transport.h"
+#include "model_b/model_b_backend.h"
+#include "relay_server/relay_server.h"
+
+namespace Benchmarks {
+
+/**
+ * End-to-end latency over real sockets
+ *
+ * Two real backends exchange packets over the loopback through
+ * ImpairedLink proxies, and each packet's time from the sender's
+ * SendPacket to the moment the receiver's ReceivePacket returns it is
+ * recorded. Three transport paths are measured:
+ *
+ *   Direct - ModelABackend to ModelABackend over one link
+ *   Relay  - ModelABackend to ModelABackend through an in-process
+ *            RelayServer, each peer on its own link to it
+ *   AdHoc  - ModelBBackend to ModelBBackend over one link
+ *
+ * The argument indexes IMPAIRMENT_PROFILES. Each iteration sends one
+ * frame of PACKETS_PER_FRAME packets and waits for them; the manual time is
+ * when the frame's last packet arrived, and the latency distribution, loss
+ * and reordering are reported as counters. Because the traffic is real UDP,
+ * tc netem on lo can be layered on top of the in-process impairment.
+ *
+ * The Stack variants of the direct and ad-hoc paths turn on kernel
+ * timestamping (SO_TIMESTAMPING) and split each packet's latency into
+ * LatencyBreakdown stages, so time in the backends, in the kernel's socket
+ * layers and on the link can be told apart. The relay path has no Stack
+ * variant; its sockets belong to UdpRelayTransport.
+ */
+
+using namespace Core::Multiplayer;
+
+namespace {
+
+constexpr size_t PACKETS_PER_FRAME = 4;
+constexpr size_t PAYLOAD_SIZE = 256;
+constexpr int64_t FRAME_ITERATIONS = 200;
+// Added to the worst-case transit before a frame's missing packets count as lost
+constexpr microseconds FRAME_SLACK{20000};
+
+constexpr uint8_t SENDER_NODE = 0;
+constexpr uint8_t RECEIVER_NODE = 1;
+
+struct Probe {
+    uint32_t frame = 0;
+    uint32_t index = 0;
+    int64_t sent_ns = 0;
+};
+
+int64_t NowNs() {
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Kernel timestamps are taken on CLOCK_REALTIME, so stage boundaries are too
+int64_t RealtimeNs() {
+    return duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+ErrorCode SendDatagram(DatagramSocket& socket, const uint8_t* data, size_t size) {
+    OutgoingDatagram datagram;
+    datagram.data = data;
+    datagram.size = size;
+    return socket.SendBatch(&datagram, 1) == 1 ? ErrorCode::Success : ErrorCode::NetworkError;
+}
+
+/**
+ * A sender and a receiver backend joined by real sockets
+ */
+class LoopbackPath {
+public:
+    virtual ~LoopbackPath() = default;
+
+    virtual bool Open(const ImpairmentProfile& profile) = 0;
+    virtual HLE::MultiplayerBackend& Sender() = 0;
+    virtual HLE::MultiplayerBackend& Receiver() = 0;
+    // Number of impaired links a packet crosses
+    virtual size_t HopCount() const = 0;
+};
+
+/**
+ * Point-to-point UDP through one ImpairedLink, shared by the direct and
+ * ad-hoc paths
+ */
+class UdpLinkPath : public LoopbackPath {
+public:
+    ~UdpLinkPath() override {
+        pump_.Stop();
+        link_.reset();
+    }
+
+    size_t HopCount() const override {
+        return 1;
+    }
+
+    // Turns on kernel timestamping for both sockets, from the NIC where it
+    // can; set before Open, which then fails if the kernel has none
+    void SetTimestamping(bool enabled) {
+        timestamping_ = enabled;
+    }
+
+    // Drains the sender's transmit timestamps; called on the sending thread
+    void CollectTransmitTimestamps() {
+        std::array<TransmitTimestamp, 64> batch;
+        size_t count = 0;
+        while ((count = send_socket_.ReadTransmitTimestamps(batch.data(), batch.size())) > 0) {
+            for (size_t i = 0; i < count; ++i) {
+                if (batch[i].id < transmits_.size()) {
+                    transmits_[batch[i].id] = batch[i].timestamps;
+                }
+            }
+        }
+    }
+
+    size_t GetDatagramsSent() const {
+        return send_syscalls_.size();
+    }
+
+    /**
+     * Fills the kernel-side stage boundaries of the datagram-th datagram
+     * sent, which was the arrival-th to reach the receiving socket. Software
+     * timestamps are used throughout, as hardware ones are on the NIC's clock.
+     * @return The hardware transmit and receive timestamps, when both sides had one
+     */
+    std::optional<std::pair<int64_t, int64_t>> GetKernelBoundaries(
+        size_t datagram, size_t arrival, LatencyBreakdown::Boundaries& boundaries) {
+        std::lock_guard<std::mutex> lock(trace_mutex_);
+        if (datagram >= send_syscalls_.size() || arrival >= arrivals_.size()) {
+            return std::nullopt;
+        }
+        const DatagramTimestamps& transmit = transmits_[datagram];
+        const Arrival& received = arrivals_[arrival];
+        boundaries[LatencyBreakdown::KernelSend] = send_syscalls_[datagram];
+        boundaries[LatencyBreakdown::Wire] = transmit.software_ns;
+        boundaries[LatencyBreakdown::KernelReceive] = received.timestamps.software_ns;
+        boundaries[LatencyBreakdown::UserReceive] = received.returned_ns;
+        if (transmit.hardware_ns == 0 || received.timestamps.hardware_ns == 0) {
+            return std::nullopt;
+        }
+        return std::make_pair(transmit.hardware_ns, received.timestamps.hardware_ns);
+    }
+
+protected:
+    struct Arrival {
+        DatagramTimestamps timestamps;
+        int64_t returned_ns = 0; // When the receive syscall returned it
+    };
+
+    bool OpenSockets(const ImpairmentProfile& profile,
+                     std::function<void(const uint8_t*, size_t)> deliver) {
+        if (receive_socket_.Open("127.0.0.1", 0) != ErrorCode::Success) {
+            return false;
+        }
+        link_ = std::make_unique<ImpairedLink>(profile);
+        DatagramEndpoint link_endpoint;
+        if (!link_->Start(receive_socket_.GetLocalEndpoint()) ||
+            !DatagramEndpoint::FromString("127.0.0.1", link_->GetPort(), link_endpoint) ||
+            send_socket_.Open("127.0.0.1", 0) != ErrorCode::Success ||
+            send_socket_.Connect(link_endpoint) != ErrorCode::Success) {
+            return false;
+        }
+        if (!timestamping_) {
+            pump_.Start(receive_socket_, std::move(deliver));
+            return true;
+        }
+
+        if (!EnableTimestamping(send_socket_) || !EnableTimestamping(receive_socket_)) {
+            return false;
+        }
+        pump_.Start(receive_socket_, [this, deliver = std::move(deliver)](
+                                         const uint8_t* data, size_t size,
+                                         const DatagramTimestamps& timestamps) {
+            const int64_t returned_ns = RealtimeNs();
+            {
+                std::lock_guard<std::mutex> lock(trace_mutex_);
+                arrivals_.push_back({timestamps, returned_ns});
+            }
+            deliver(data, size);
+        });
+        return true;
+    }
+
+    // The send socket's transmit timestamps are numbered from its first send
+    ErrorCode Send(const uint8_t* data, size_t size) {
+        if (!timestamping_) {
+            return SendDatagram(send_socket_, data, size);
+        }
+        const int64_t syscall_ns = RealtimeNs();
+        const ErrorCode result = SendDatagram(send_socket_, data, size);
+        if (result == ErrorCode::Success) {
+            std::lock_guard<std::mutex> lock(trace_mutex_);
+            send_syscalls_.push_back(syscall_ns);
+            transmits_.emplace_back();
+        }
+        return result;
+    }
+
+    DatagramSocket send_socket_;
+    DatagramSocket receive_socket_;
+    std::unique_ptr<ImpairedLink> link_;
+    DatagramPump pump_;
+
+private:
+    static bool EnableTimestamping(DatagramSocket& socket) {
+        return socket.EnableTimestamping(TimestampingMode::Hardware) == ErrorCode::Success ||
+               socket.EnableTimestamping(TimestampingMode::Software) == ErrorCode::Success;
+    }
+
+    bool timestamping_ = false;
+    std::mutex trace_mutex_;
+    std::vector<Arrival> arrivals_;
+    // Indexed by transmit timestamp id
+    std::vector<int64_t> send_syscalls_;
+    std::vector<DatagramTimestamps> transmits_;
+};
+
+class DirectPath final : public UdpLinkPath {
+public:
+    bool Open(const ImpairmentProfile& profile) override {
+        sender_.SetPacketSender([this](uint8_t, const uint8_t* data, size_t size, SendPriority) {
+            return Send(data, size);
+        });
+        return sender_.Initialize() == ErrorCode::Success &&
+               receiver_.Initialize() == ErrorCode::Success &&
+               OpenSockets(profile, [this](const uint8_t* data, size_t size) {
+                   receiver_.DeliverPacket(SENDER_NODE, data, size);
+               });
+    }
+
+    HLE::MultiplayerBackend& Sender() override {
+        return sender_;
+    }
+    HLE::MultiplayerBackend& Receiver() override {
+        return receiver_;
+    }
+
+private:
+    ModelA::ModelABackend sender_{nullptr, nullptr};
+    ModelA::ModelABackend receiver_{nullptr, nullptr};
+};
+
+class AdHocPath final : public UdpLinkPath {
+public:
+    bool Open(const ImpairmentProfile& profile) override {
+        sender_.SetPacketSender([this](uint8_t, const uint8_t* data, size_t size) {
+            return Send(data, size);
+        });
+        return sender_.Initialize() == ErrorCode::Success &&
+               receiver_.Initialize() == ErrorCode::Success &&
+               OpenSockets(profile, [this](const uint8_t* data, size_t size) {
+                   receiver_.DeliverPacket(SENDER_NODE, data, size);
+               });
+    }
+
+    HLE::MultiplayerBackend& Sender() override {
+        return sender_;
+    }
+    HLE::MultiplayerBackend& Receiver() override {
+        return receiver_;
+    }
+
+private:
+    ModelB::ModelBBackend sender_{nullptr, nullptr};
+    ModelB::ModelBBackend receiver_{nullptr, nullptr};
+};
+
+/**
+ * Both peers in one RelayServer session over UdpRelayTransport, each
+ * reaching the server through its own ImpairedLink
+ */
+class RelayPath final : public LoopbackPath {
+public:
+    static constexpr uint32_t SESSION_TOKEN = 0x5eed0001;
+
+    ~RelayPath() override {
+        for (auto& peer : peers_) {
+            peer.transport.Close();
+        }
+        for (auto& peer : peers_) {
+            peer.link.reset();
+        }
+        if (server_) {
+            server_->Stop();
+        }
+    }
+
+    bool Open(const ImpairmentProfile& profile) override {
+        Relay::RelayServerConfig config;
+        config.bind_address = "127.0.0.1";
+        config.port = 0;
+        config.reactor_count = 1;
+        config.pin_reactors = false;
+        // Frames go out back to back, well above a game's 60 packets per second
+        config.rate_limits.packets_per_second = 1e6;
+        config.rate_limits.burst_capacity = 1e6;
+        server_ = std::make_unique<Relay::RelayServer>(config);
+        DatagramEndpoint server_endpoint;
+        if (server_->Start() != ErrorCode::Success ||
+            !DatagramEndpoint::FromString("127.0.0.1", server_->GetPort(), server_endpoint)) {
+            return false;
+        }
+
+        for (size_t i = 0; i < peers_.size(); ++i) {
+            auto& peer = peers_[i];
+            peer.link = std::make_unique<ImpairedLink>(profile, static_cast<uint32_t>(0x1eed + i));
+            if (!peer.link->Start(server_endpoint) ||
+                !peer.transport.Open("127.0.0.1", peer.link->GetPort())) {
+                return false;
+            }
+            peer.transport.SetOnDatagramReceived(
+                [this, &peer](std::span<const uint8_t> datagram) { OnDatagram(peer, datagram); });
+        }
+
+        sender_.SetPacketSender([this](uint8_t, const uint8_t* data, size_t size, SendPriority) {
+            const auto frame = protocol_.FrameDataMessage(
+                SESSION_TOKEN, std::span<const uint8_t>(data, size), sequence_++);
+            return peers_[0].transport.SendFrame(frame) ? ErrorCode::Success
+                                                        : ErrorCode::NetworkError;
+        });
+        return RequestSession(peers_[0], ModelA::RelayProtocol::FLAG_SESSION_CREATE) &&
+               RequestSession(peers_[1], ModelA::RelayProtocol::FLAG_SESSION_JOIN) &&
+               sender_.Initialize() == ErrorCode::Success &&
+               receiver_.Initialize() == ErrorCode::Success;
+    }
+
+    HLE::MultiplayerBackend& Sender() override {
+        return sender_;
+    }
+    HLE::MultiplayerBackend& Receiver() override {
+        return receiver_;
+    }
+    size_t HopCount() const override {
+        return 2;
+    }
+
+private:
+    struct Peer {
+        std::unique_ptr<ImpairedLink> link;
+        ModelA::UdpRelayTransport transport;
+        std::atomic<uint8_t> session_reply{0};
+    };
+
+    void OnDatagram(Peer& peer, std::span<const uint8_t> datagram) {
+        ModelA::RelayHeaderView header;
+        if (!protocol_.ValidateMessage(datagram, &header)) {
+            return;
+        }
+        if (header.flags == ModelA::RelayProtocol::FLAG_DATA) {
+            if (&peer == &peers_[1]) {
+                receiver_.DeliverPacket(SENDER_NODE, header.payload.data(), header.payload.size());
+            }
+        } else if (header.session_token == SESSION_TOKEN) {
+            peer.session_reply = header.flags;
+        }
+    }
+
+    // Control frames cross the impaired link too, so lost requests are retried
+    bool RequestSession(Peer& peer, uint8_t flag) {
+        constexpr int ATTEMPTS = 10;
+        constexpr milliseconds REPLY_TIMEOUT{200};
+        for (int attempt = 0; attempt < ATTEMPTS; ++attempt) {
+            ModelA::RelayFrame request;
+            protocol_.WriteHeader(request.header, SESSION_TOKEN, 0, flag, 0);
+            peer.session_reply = 0;
+            if (!peer.transport.SendFrame(request)) {
+                return false;
+            }
+            const auto deadline = steady_clock::now() + REPLY_TIMEOUT;
+            while (steady_clock::now() < deadline) {
+                const uint8_t reply = peer.session_reply;
+                if ((reply & flag) != 0) {
+                    return (reply & ModelA::RelayProtocol::FLAG_CONTROL) == 0;
+                }
+                std::this_thread::sleep_for(milliseconds(1));
+            }
+        }
+        return false;
+    }
+
+    ModelA::RelayProtocol protocol_;
+    std::unique_ptr<Relay::RelayServer> server_;
+    std::array<Peer, 2> peers_;
+    uint32_t sequence_ = 0;
+    ModelA::ModelABackend sender_{nullptr, nullptr};
+    ModelA::ModelABackend receiver_{nullptr, nullptr};
+};
+
+void ImpairmentProfiles(benchmark::internal::Benchmark* benchmark) {
+    benchmark->ArgName("profile");
+    for (size_t i = 0; i < IMPAIRMENT_PROFILES.size(); ++i) {
+        benchmark->Arg(static_cast<int64_t>(i));
+    }
+    benchmark->UseManualTime()->Iterations(FRAME_ITERATIONS)->Unit(benchmark::kMicrosecond);
+}
+
+void MeasureLatency(benchmark::State& state, LoopbackPath& path) {
+    const auto& profile = IMPAIRMENT_PROFILES[static_cast<size_t>(state.range(0))];
+    state.SetLabel(profile.name);
+    if (!path.Open(profile)) {
+        state.SkipWithError("Could not set up the loopback path");
+        return;
+    }
+
+    auto& sender = path.Sender();
+    auto& receiver = path.Receiver();
+    const auto frame_timeout = path.HopCount() * profile.MaxTransit() + FRAME_SLACK;
+
+    std::vector<uint8_t> payload(PAYLOAD_SIZE, 0x5a);
+    StatisticalAnalyzer latency_us;
+    uint64_t sent = 0;
+    uint64_t received = 0;
+    uint64_t reordered = 0;
+    uint64_t late = 0;
+    uint32_t frame = 0;
+
+    for (auto _ : state) {
+        ++frame;
+        const auto start = steady_clock::now();
+        for (uint32_t index = 0; index < PACKETS_PER_FRAME; ++index) {
+            const Probe probe{frame, index, NowNs()};
+            std::memcpy(payload.data(), &probe, sizeof(probe));
+            if (sender.SendPacket(payload, RECEIVER_NODE) == ErrorCode::Success) {
+                ++sent;
+            }
+        }
+
+        const auto deadline = start + frame_timeout;
+        auto last_arrival = start;
+        size_t arrived = 0;
+        uint32_t highest_index = 0;
+        while (arrived < PACKETS_PER_FRAME && steady_clock::now() < deadline) {
+            PacketBuffer packet;
+            uint8_t node_id = 0;
+            if (receiver.ReceivePacket(packet, node_id) != ErrorCode::Success || !packet) {
+                std::this_thread::yield();
+                continue;
+            }
+            const int64_t now_ns = NowNs();
+            Probe probe;
+            if (packet.size() < sizeof(probe)) {
+                continue;
+            }
+            std::memcpy(&probe, packet.data(), sizeof(probe));
+            if (probe.frame != frame) {
+                ++late; // Arrived after its frame was given up on
+                continue;
+            }
+            latency_us.AddSample(static_cast<double>(now_ns - probe.sent_ns) / 1000.0);
+            if (arrived > 0 && probe.index < highest_index) {
+                ++reordered;
+            }
+            highest_index = std::max(highest_index, probe.index);
+            ++arrived;
+            last_arrival = steady_clock::now();
+        }
+        received += arrived;
+        state.SetIterationTime(duration<double>(last_arrival - start).count());
+    }
+
+    if (latency_us.GetSampleCount() > 0) {
+        state.counters["p50_us"] = latency_us.GetPercentile(50.0);
+        state.counters["p99_us"] = latency_us.GetPercentile(99.0);
+        state.counters["max_us"] = latency_us.GetPercentile(100.0);
+    }
+    const double sent_count = static_cast<double>(std::max<uint64_t>(sent, 1));
+    state.counters["loss_pct"] = 100.0 * static_cast<double>(sent - received) / sent_count;
+    state.counters["reorder_pct"] = 100.0 * static_cast<double>(reordered) / sent_count;
+    state.counters["late"] = static_cast<double>(late);
+    state.SetItemsProcessed(static_cast<int64_t>(received));
+}
+
+/**
+ * Same traffic as MeasureLatency, with each packet's latency split into
+ * stages by kernel timestamps. Packets are matched to their datagrams by
+ * send order and by arrival order, which holds while each SendPacket
+ * makes one datagram and the receiver queues packets in arrival order.
+ */
+void MeasureStackLatency(benchmark::State& state, UdpLinkPath& path) {
+    const auto& profile = IMPAIRMENT_PROFILES[static_cast<size_t>(state.range(0))];
+    state.SetLabel(profile.name);
+    path.SetTimestamping(true);
+    if (!path.Open(profile)) {
+        state.SkipWithError("Could not set up a timestamped loopback path");
+        return;
+    }
+
+    auto& sender = path.Sender();
+    auto& receiver = path.Receiver();
+    const auto frame_timeout = profile.MaxTransit() + FRAME_SLACK;
+
+    std::vector<uint8_t> payload(PAYLOAD_SIZE, 0x5a);
+    std::vector<int64_t> send_calls;       // By packet number
+    std::vector<std::pair<uint32_t, int64_t>> receives; // Packet number and return, by arrival
+    uint32_t frame = 0;
+
+    for (auto _ : state) {
+        ++frame;
+        const auto start = steady_clock::now();
+        for (uint32_t index = 0; index < PACKETS_PER_FRAME; ++index) {
+            const Probe probe{frame, static_cast<uint32_t>(send_calls.size()), NowNs()};
+            std::memcpy(payload.data(), &probe, sizeof(probe));
+            const int64_t call_ns = RealtimeNs();
+            if (sender.SendPacket(payload, RECEIVER_NODE) == ErrorCode::Success) {
+                send_calls.push_back(call_ns);
+            }
+        }
+
+        const auto deadline = start + frame_timeout;
+        auto last_arrival = start;
+        size_t arrived = 0;
+        while (arrived < PACKETS_PER_FRAME && steady_clock::now() < deadline) {
+            PacketBuffer packet;
+            uint8_t node_id = 0;
+            if (receiver.ReceivePacket(packet, node_id) != ErrorCode::Success || !packet) {
+                std::this_thread::yield();
+                continue;
+            }
+            const int64_t returned_ns = RealtimeNs();
+            Probe probe;
+            if (packet.size() < sizeof(probe)) {
+                continue;
+            }
+            std::memcpy(&probe, packet.data(), sizeof(probe));
+            // Late packets still took an arrival slot, so they are kept
+            receives.emplace_back(probe.index, returned_ns);
+            if (probe.frame == frame) {
+                ++arrived;
+                last_arrival = steady_clock::now();
+            }
+        }
+        path.CollectTransmitTimestamps();
+        state.SetIterationTime(duration<double>(last_arrival - start).count());
+    }
+
+    if (path.GetDatagramsSent() != send_calls.size()) {
+        state.SkipWithError("Packets and datagrams do not match one to one");
+        return;
+    }
+    // Transmit timestamps of the last frame can trail its arrival
+    std::this_thread::sleep_for(milliseconds(10));
+    path.CollectTransmitTimestamps();
+
+    LatencyBreakdown breakdown;
+    StatisticalAnalyzer hardware_wire_us;
+    uint64_t unmatched = 0;
+    for (size_t arrival = 0; arrival < receives.size(); ++arrival) {
+        const auto [packet, returned_ns] = receives[arrival];
+        LatencyBreakdown::Boundaries boundaries{};
+        boundaries[LatencyBreakdown::UserSend] = send_calls[packet];
+        boundaries[LatencyBreakdown::STAGE_COUNT] = returned_ns;
+        const auto hardware = path.GetKernelBoundaries(packet, arrival, boundaries);
+        if (!breakdown.AddSample(boundaries)) {
+            ++unmatched;
+            continue;
+        }
+        if (hardware && hardware->second >= hardware->first) {
+            hardware_wire_us.AddSample(
+                static_cast<double>(hardware->second - hardware->first) / 1000.0);
+        }
+    }
+
+    breakdown.Report(state);
+    if (hardware_wire_us.GetSampleCount() > 0) {
+        state.counters["hw_wire_p50_us"] = hardware_wire_us.GetPercentile(50.0);
+    }
+    state.counters["unmatched"] = static_cast<double>(unmatched);
+    state.SetItemsProcessed(static_cast<int64_t>(breakdown.GetSampleCount()));
+}
+
+} // namespace
+
+static void BM_Loopback_Direct(benchmark::State& state) {
+    DirectPath path;
+    MeasureLatency(state, path);
+}
+BENCHMARK(BM_Loopback_Direct)->Name("Loopback/Direct")->Apply(ImpairmentProfiles);
+
+static void BM_Loopback_Relay(benchmark::State& state) {
+    RelayPath path;
+    MeasureLatency(state, path);
+}
+BENCHMARK(BM_Loopback_Relay)->Name("Loopback/Relay")->Apply(ImpairmentProfiles);
+
+static void BM_Loopback_AdHoc(benchmark::State& state) {
+    AdHocPath path;
+    MeasureLatency(state, path);
+}
+BENCHMARK(BM_Loopback_AdHoc)->Name("Loopback/AdHoc")->Apply(ImpairmentProfiles);
+
+static void BM_Loopback_DirectStack(benchmark::State& state) {
+    DirectPath path;
+    MeasureStackLatency(state, path);
+}
+BENCHMARK(BM_Loopback_DirectStack)->Name("Loopback/Direct/Stack")->Apply(ImpairmentProfiles);
+
+static void BM_Loopback_AdHocStack(benchmark::State& state) {
+    AdHocPath path;
+    MeasureStackLatency(state, path);
+}
+BENCHMARK(BM_Loopback_AdHocStack)->Name("Loopback/AdHoc/Stack")->Apply(ImpairmentProfiles);
+
+} // namespace Benchmarks
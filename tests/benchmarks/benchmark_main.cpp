@@ -11,6 +11,15 @@
 #include <sstream>
 #include <chrono>
 #include <algorithm>
+#include <cstdlib>
+#include <optional>
+
+#include "benchmark_baseline.h"
+
+// Commit the suite was built from; CMake fills it in from git
+#ifndef SUDACHI_BENCHMARK_COMMIT
+#define SUDACHI_BENCHMARK_COMMIT "unknown"
+#endif
 
 /**
  * Custom benchmark main with PRD target validation and performance reporting
@@ -82,6 +91,16 @@ public:
         
         results_.push_back(result);
     }
+
+    // Whether the named benchmark met its PRD target, if it has one
+    std::optional<bool> GetTargetResult(const std::string& name) const {
+        for (const auto& result : results_) {
+            if (result.name == name) {
+                return result.passed;
+            }
+        }
+        return std::nullopt;
+    }
     
     void PrintSummaryReport() const {
         std::cout << "\n" << std::string(80, '=') << std::endl;
@@ -261,23 +280,56 @@ private:
 // Global analyzer instance
 PerformanceAnalyzer g_analyzer;
 
+// Per-repetition timings of this run, for the baseline store
+BenchmarkSnapshot g_snapshot;
+
+// Memory benchmarks whose bytes_per_session counter exceeded budget_bytes
+std::vector<std::string> g_memory_budget_violations;
+
+using BenchmarkRun = benchmark::BenchmarkReporter::Run;
+
 /**
  * Custom benchmark reporter for PRD validation
  */
 class PRDValidationReporter : public benchmark::ConsoleReporter {
 public:
-    void ReportRuns(const std::vector<benchmark::Run>& reports) override {
+    void ReportRuns(const std::vector<BenchmarkRun>& reports) override {
         // Call base implementation
         benchmark::ConsoleReporter::ReportRuns(reports);
         
         // Analyze results against PRD targets
         for (const auto& run : reports) {
             AnalyzeBenchmarkRun(run);
+            RecordSample(run);
+            CheckMemoryBudget(run);
         }
     }
 
 private:
-    void AnalyzeBenchmarkRun(const benchmark::Run& run) {
+    void CheckMemoryBudget(const BenchmarkRun& run) {
+        const auto cost = run.counters.find("bytes_per_session");
+        const auto budget = run.counters.find("budget_bytes");
+        if (run.run_type != BenchmarkRun::RT_Iteration || cost == run.counters.end() ||
+            budget == run.counters.end() || cost->second.value <= budget->second.value) {
+            return;
+        }
+        std::ostringstream violation;
+        violation << run.benchmark_name() << ": " << cost->second.value << " bytes per session, "
+                  << budget->second.value << " budgeted";
+        g_memory_budget_violations.push_back(violation.str());
+    }
+
+    // One sample per repetition; aggregates are recomputed from these
+    void RecordSample(const BenchmarkRun& run) {
+        if (run.run_type != BenchmarkRun::RT_Iteration || run.error_occurred ||
+            run.iterations <= 0) {
+            return;
+        }
+        const double ns_per_iteration = run.real_accumulated_time * 1e9 / run.iterations;
+        g_snapshot.benchmarks[run.benchmark_name()].AddSample(ns_per_iteration);
+    }
+
+    void AnalyzeBenchmarkRun(const BenchmarkRun& run) {
         std::string name = run.benchmark_name();
         
         // Parse benchmark results and compare against PRD targets
@@ -294,7 +346,7 @@ private:
         }
     }
     
-    void AnalyzeConnectionBenchmark(const benchmark::Run& run) {
+    void AnalyzeConnectionBenchmark(const BenchmarkRun& run) {
         double measured_ms = run.real_accumulated_time / 1e6; // Convert nanoseconds to milliseconds
         std::string name = run.benchmark_name();
         
@@ -313,7 +365,7 @@ private:
         }
     }
     
-    void AnalyzeLatencyBenchmark(const benchmark::Run& run) {
+    void AnalyzeLatencyBenchmark(const BenchmarkRun& run) {
         double measured_ms = run.real_accumulated_time / 1e6;
         std::string name = run.benchmark_name();
         
@@ -336,7 +388,7 @@ private:
         }
     }
     
-    void AnalyzePacketProcessingBenchmark(const benchmark::Run& run) {
+    void AnalyzePacketProcessingBenchmark(const BenchmarkRun& run) {
         std::string name = run.benchmark_name();
         
         if (name.find("60Hz") != std::string::npos) {
@@ -353,7 +405,7 @@ private:
         }
     }
     
-    void AnalyzeScalabilityBenchmark(const benchmark::Run& run) {
+    void AnalyzeScalabilityBenchmark(const BenchmarkRun& run) {
         std::string name = run.benchmark_name();
         
         if (name.find("RoomServer") != std::string::npos) {
@@ -372,7 +424,7 @@ private:
         }
     }
     
-    void AnalyzeComponentBenchmark(const benchmark::Run& run) {
+    void AnalyzeComponentBenchmark(const BenchmarkRun& run) {
         double measured_value = run.real_accumulated_time / 1e6; // Convert to milliseconds
         std::string name = run.benchmark_name();
         
@@ -395,10 +447,62 @@ private:
 
 } // namespace Benchmarks
 
+/**
+ * Options for the baseline store, taken out of argv before Google Benchmark
+ * sees them:
+ *   --baseline=FILE              compare against a stored run
+ *   --results_dir=DIR            store this run as DIR/<commit>_<cpu>.json
+ *   --commit=SHA                 override the commit recorded with the run
+ *   --regression_threshold=PCT   slowdown that counts as a regression (10)
+ *   --memory_budgets             fail if a memory benchmark is over budget
+ */
+struct BaselineOptions {
+    std::string baseline_path;
+    std::string results_dir;
+    std::string commit = SUDACHI_BENCHMARK_COMMIT;
+    double regression_threshold_percent = 10.0;
+    bool memory_budgets = false;
+};
+
+static BaselineOptions ExtractBaselineOptions(int& argc, char** argv) {
+    BaselineOptions options;
+    auto take = [](const std::string& arg, const std::string& flag, std::string& value) {
+        const std::string prefix = "--" + flag + "=";
+        if (arg.rfind(prefix, 0) != 0) {
+            return false;
+        }
+        value = arg.substr(prefix.size());
+        return true;
+    };
+
+    int kept = 1;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        std::string threshold;
+        if (take(arg, "baseline", options.baseline_path) ||
+            take(arg, "results_dir", options.results_dir) || take(arg, "commit", options.commit)) {
+            continue;
+        }
+        if (take(arg, "regression_threshold", threshold)) {
+            options.regression_threshold_percent = std::atof(threshold.c_str());
+            continue;
+        }
+        if (arg == "--memory_budgets") {
+            options.memory_budgets = true;
+            continue;
+        }
+        argv[kept++] = argv[i];
+    }
+    argc = kept;
+    return options;
+}
+
 /**
  * Custom main function with enhanced reporting
  */
 int main(int argc, char** argv) {
+    const BaselineOptions baseline_options = ExtractBaselineOptions(argc, argv);
+
     // Initialize Google Benchmark
     benchmark::Initialize(&argc, argv);
     
@@ -421,8 +525,59 @@ int main(int argc, char** argv) {
     std::string timestamp = std::to_string(std::chrono::system_clock::now().time_since_epoch().count());
     std::string json_filename = "sudachi_multiplayer_benchmark_results_" + timestamp + ".json";
     Benchmarks::g_analyzer.ExportToJSON(json_filename);
+
+    auto& snapshot = Benchmarks::g_snapshot;
+    snapshot.commit = baseline_options.commit;
+    snapshot.cpu_model = Benchmarks::BaselineStore::DetectCpuModel();
+    snapshot.timestamp = timestamp;
+
+    if (!baseline_options.results_dir.empty()) {
+        const std::string path = baseline_options.results_dir + "/" +
+                                 Benchmarks::BaselineStore::FileNameFor(snapshot);
+        if (Benchmarks::BaselineStore::Save(snapshot, path)) {
+            std::cout << "Benchmark samples stored to: " << path << std::endl;
+        } else {
+            std::cerr << "Failed to store benchmark samples to: " << path << std::endl;
+        }
+    }
+
+    int exit_code = 0;
+    if (!baseline_options.baseline_path.empty()) {
+        const auto baseline = Benchmarks::BaselineStore::Load(baseline_options.baseline_path);
+        if (!baseline) {
+            std::cerr << "Could not read baseline: " << baseline_options.baseline_path << std::endl;
+            exit_code = 1;
+        } else {
+            if (baseline->cpu_model != snapshot.cpu_model) {
+                std::cout << "Note: baseline was recorded on \"" << baseline->cpu_model
+                          << "\"; timings from a different CPU are not comparable" << std::endl;
+            }
+            const Benchmarks::RegressionComparator comparator(
+                baseline_options.regression_threshold_percent / 100.0);
+            const auto rows = comparator.Compare(*baseline, snapshot);
+            Benchmarks::RegressionComparator::PrintTable(rows, [](const std::string& name) {
+                return Benchmarks::g_analyzer.GetTargetResult(name);
+            });
+            const bool regressed = std::any_of(rows.begin(), rows.end(), [](const auto& row) {
+                return row.verdict == Benchmarks::RegressionVerdict::Regressed;
+            });
+            exit_code = regressed ? 1 : 0;
+        }
+    }
+
+    if (baseline_options.memory_budgets) {
+        const auto& violations = Benchmarks::g_memory_budget_violations;
+        for (const auto& violation : violations) {
+            std::cerr << "Over memory budget: " << violation << std::endl;
+        }
+        if (!violations.empty()) {
+            exit_code = 1;
+        } else {
+            std::cout << "All memory benchmarks within budget" << std::endl;
+        }
+    }
     
     benchmark::Shutdown();
     
-    return 0;
+    return exit_code;
 }
@@ -15,6 +15,7 @@
 #include <queue>
 #include <random>
 #include <map>
+#include <cstring>
 
 /**
  * Mock implementations for performance benchmarking
@@ -593,6 +594,7 @@ class MockConfigurationManager;
 class MockConfiguration;
 class MockErrorHandler;
 class MockRecoveryManager;
+class MockWiFiDirectWrapper;
 
 // Factory function declarations
 std::unique_ptr<MockRoomClient> CreateMockRoomClient(MockWebSocketClient* websocket);
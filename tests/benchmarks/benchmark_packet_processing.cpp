@@ -12,9 +12,11 @@
 #include <condition_variable>
 #include <algorithm>
 #include <numeric>
+#include <string>
 
 #include "benchmark_mocks.h"
 #include "benchmark_utilities.h"
+#include "model_a/room_message_router.h"
 
 namespace Benchmarks {
 
@@ -564,4 +566,117 @@ BENCHMARK_REGISTER_F(ConcurrentProcessingFixture, MultiThreadProcessing)
     ->UseManualTime()
     ->Name("PacketProcessing/Concurrent/MultiThread");
 
+// =============================================================================
+// Room Message Routing Benchmarks
+// =============================================================================
+
+namespace {
+
+// Representative room server traffic, dominated by list updates and relayed
+// player events, with some types the client does not handle
+const std::vector<std::string> kRoomServerMessages = {
+    R"({"type":"room_list_response","success":true,"total_count":1,"rooms":[{"id":"r1"}]})",
+    R"({"type":"player_joined","room_id":"r1","player":{"id":"p2","username":"b"}})",
+    R"({"type":"p2p_info","from_player":"p1","to_player":"p2","connection_type":"direct"})",
+    R"({"type":"heartbeat","timestamp":1700000000123})",
+    R"({"type":"player_left","room_id":"r1","player_id":"p2","reason":"quit"})",
+    R"({"type":"server_notice","text":"maintenance at 02:00"})",
+    R"({"type":"error","error_code":"ROOM_FULL","message":"The requested room is full"})",
+    R"({"type":"use_proxy","relay_server":"relay.example.org","relay_port":7777})",
+};
+
+// The routing chain RoomClient used before the dispatch table
+Core::Multiplayer::ModelA::MessageType RouteByStringCompare(const std::string& message_type) {
+    using Core::Multiplayer::ModelA::MessageType;
+    if (message_type == "room_created") {
+        return MessageType::RoomCreated;
+    } else if (message_type == "error") {
+        return MessageType::Error;
+    } else if (message_type == "room_list_response") {
+        return MessageType::RoomListResponse;
+    } else if (message_type == "join_room_response") {
+        return MessageType::JoinRoomResponse;
+    } else if (message_type == "p2p_info") {
+        return MessageType::P2PInfo;
+    } else if (message_type == "use_proxy") {
+        return MessageType::UseProxy;
+    } else if (message_type == "player_joined") {
+        return MessageType::PlayerJoined;
+    } else if (message_type == "player_left") {
+        return MessageType::PlayerLeft;
+    }
+    return MessageType::Unknown;
+}
+
+} // namespace
+
+/**
+ * Benchmark: Message type resolution by string comparison chain
+ * Baseline for the perfect-hash dispatch below
+ */
+static void RoomMessageRouting_StringCompare(benchmark::State& state) {
+    std::vector<std::string> type_names;
+    for (const auto& message : kRoomServerMessages) {
+        type_names.emplace_back(Core::Multiplayer::ModelA::PeekMessageType(message));
+    }
+
+    for (auto _ : state) {
+        for (const auto& name : type_names) {
+            benchmark::DoNotOptimize(RouteByStringCompare(name));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * type_names.size());
+}
+
+BENCHMARK(RoomMessageRouting_StringCompare)
+    ->Unit(benchmark::kNanosecond)
+    ->Name("PacketProcessing/RoomRouting/StringCompare");
+
+/**
+ * Benchmark: Message type resolution through the compile-time perfect hash
+ */
+static void RoomMessageRouting_PerfectHash(benchmark::State& state) {
+    std::vector<std::string> type_names;
+    for (const auto& message : kRoomServerMessages) {
+        type_names.emplace_back(Core::Multiplayer::ModelA::PeekMessageType(message));
+    }
+
+    for (auto _ : state) {
+        for (const auto& name : type_names) {
+            benchmark::DoNotOptimize(Core::Multiplayer::ModelA::ResolveMessageType(name));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * type_names.size());
+}
+
+BENCHMARK(RoomMessageRouting_PerfectHash)
+    ->Unit(benchmark::kNanosecond)
+    ->Name("PacketProcessing/RoomRouting/PerfectHash");
+
+/**
+ * Benchmark: Full routing decision from the raw message text
+ * Peeks the type without parsing the body, as RoomClient::ProcessMessage does
+ */
+static void RoomMessageRouting_PeekAndResolve(benchmark::State& state) {
+    size_t routed = 0;
+    for (auto _ : state) {
+        for (const auto& message : kRoomServerMessages) {
+            const auto type = Core::Multiplayer::ModelA::ResolveMessageType(
+                Core::Multiplayer::ModelA::PeekMessageType(message));
+            benchmark::DoNotOptimize(type);
+            routed += type != Core::Multiplayer::ModelA::MessageType::Unknown ? 1 : 0;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * kRoomServerMessages.size());
+    state.counters["RoutedPerBatch"] =
+        benchmark::Counter(static_cast<double>(routed), benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(RoomMessageRouting_PeekAndResolve)
+    ->Unit(benchmark::kNanosecond)
+    ->Name("PacketProcessing/RoomRouting/PeekAndResolve");
+
 } // namespace Benchmarks
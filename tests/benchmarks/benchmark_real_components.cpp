@@ -0,0 +1,931 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <regex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "common/circuit_breaker.h"
+#include "common/error_handling.h"
+#include "common/memory_accounting.h"
+#include "common/network_security.h"
+#include "common/packet_buffer.h"
+#include "common/secure_packet_pipeline.h"
+#include "model_a/packet_cipher.h"
+#include "model_a/peer_address_book.h"
+#include "model_a/relay_client.h"
+#include "model_a/relay_protocol.h"
+#include "model_a/room_binary_codec.h"
+#include "model_a/room_client.h"
+#include "model_a/room_list_index.h"
+#include "model_b/discovered_service_cache.h"
+#include "model_b/mdns_txt_records.h"
+#include "type_translator.h"
+#include "sudachi/src/core/hle/service/ldn/ldn_types.h"
+
+#include "room_client_stubs.h"
+
+namespace Benchmarks {
+
+/**
+ * Microbenchmarks of the shipping multiplayer components
+ *
+ * Unlike the rest of the suite these exercise the real classes rather than
+ * the stand-ins from benchmark_mocks.h, and leave timing and reporting to
+ * Google Benchmark, so runs from two releases can be compared directly:
+ *
+ *   sudachi_multiplayer_component_benchmarks --benchmark_out=before.json
+ *       --benchmark_out_format=json
+ *   compare.py benchmarks before.json after.json
+ *
+ * Packet-path benchmarks take the payload size in bytes as their argument;
+ * the ones that touch shared state also run at several thread counts.
+ *
+ * Components/Memory/* report what one room, peer, discovered service or
+ * client costs its subsystem's tracked memory resource, next to a budget;
+ * run with --memory_budgets to fail when one goes over.
+ */
+
+using namespace Core::Multiplayer;
+
+namespace {
+
+void PayloadSizes(benchmark::internal::Benchmark* benchmark) {
+    benchmark->ArgName("payload");
+    for (int64_t size : {64, 512, 1400}) {
+        benchmark->Arg(size);
+    }
+}
+
+void ThreadCounts(benchmark::internal::Benchmark* benchmark) {
+    benchmark->Threads(1)->Threads(2)->Threads(4)->Threads(8)->UseRealTime();
+}
+
+std::vector<uint8_t> MakePayload(size_t size) {
+    std::vector<uint8_t> payload(size);
+    for (size_t i = 0; i < size; ++i) {
+        payload[i] = static_cast<uint8_t>(i * 31 + 7);
+    }
+    return payload;
+}
+
+// Same framing the secure packet path expects: "LD" magic and version 1
+std::vector<uint8_t> MakeLdnPacket(size_t size) {
+    std::vector<uint8_t> packet = MakePayload(size);
+    packet[0] = 0x44;
+    packet[1] = 0x4C;
+    packet[2] = 0x01;
+    packet[3] = 0x00;
+    return packet;
+}
+
+std::string MakeChatMessage(size_t sentences) {
+    std::string message = R"({"type":"chat","room":"Lobby 3","from":"player_42","text":")";
+    for (size_t i = 0; i < sentences; ++i) {
+        message += "anyone up for a match on the new map? ";
+    }
+    return message + R"("})";
+}
+
+// Batches of 64 LDN packets, 8 in a row from each of 16 clients
+std::vector<InboundPacketBatch> MakeInboundBatches(size_t count) {
+    constexpr size_t BATCH = 64;
+    constexpr size_t CLIENTS = 16;
+    std::vector<InboundPacketBatch> batches;
+    for (size_t b = 0; b < count; ++b) {
+        InboundPacketBatch batch;
+        for (size_t i = 0; i < BATCH; ++i) {
+            const size_t client = (b + i / 8) % CLIENTS;
+            InboundPacket packet;
+            packet.client_id = "client" + std::to_string(client);
+            packet.client_ip = "192.0.2." + std::to_string(client + 1);
+            packet.data = MakeLdnPacket(256);
+            packet.protocol = "/sudachi/ldn/1.0.0";
+            batch.push_back(std::move(packet));
+        }
+        batches.push_back(std::move(batch));
+    }
+    return batches;
+}
+
+// Limits no benchmark run reaches, so every packet is checked in full
+std::unique_ptr<Security::NetworkSecurityManager> MakeUnlimitedSecurityManager() {
+    Security::RateLimitConfig rates;
+    rates.packets_per_second = 1e12;
+    rates.burst_capacity = 1e12;
+    rates.bytes_per_second = 1e15;
+    rates.byte_burst_capacity = 1e15;
+    Security::DDoSProtectionConfig protection;
+    protection.max_packets_per_second = 1'000'000'000;
+    return std::make_unique<Security::NetworkSecurityManager>(rates, protection);
+}
+
+ModelB::GameSessionInfo MakeGameSession() {
+    ModelB::GameSessionInfo session;
+    session.game_id = "0100ABCD12345678";
+    session.version = "1.2.0";
+    session.current_players = 3;
+    session.max_players = 8;
+    session.has_password = false;
+    session.host_name = "HostPlayer";
+    session.session_id = "5f0c9a2e-1b7d-4c3e-9f8a-2d6b0e4a7c11";
+    return session;
+}
+
+ModelA::RoomListResponse MakeRoomList(size_t room_count) {
+    ModelA::RoomListResponse response;
+    response.success = true;
+    response.total_count = static_cast<int>(room_count);
+    for (size_t i = 0; i < room_count; ++i) {
+        ModelA::RoomSummary room;
+        room.id = "room_" + std::to_string(i);
+        room.game_id = 0x0100123456789ABC;
+        room.game_name = "Game";
+        room.host_name = "Host" + std::to_string(i);
+        room.current_players = static_cast<int>(i % 8) + 1;
+        room.max_players = 8;
+        room.ping = 40 + static_cast<int>(i % 60);
+        room.region = "US";
+        response.rooms.push_back(std::move(room));
+    }
+    return response;
+}
+
+std::string ToJson(const ModelA::RoomListResponse& response) {
+    nlohmann::json rooms = nlohmann::json::array();
+    for (const auto& room : response.rooms) {
+        rooms.push_back({{"id", room.id},
+                         {"game_id", "0100123456789ABC"},
+                         {"game_name", room.game_name},
+                         {"host_name", room.host_name},
+                         {"current_players", room.current_players},
+                         {"max_players", room.max_players},
+                         {"ping", room.ping},
+                         {"region", room.region}});
+    }
+    return nlohmann::json{{"type", "room_list_response"},
+                          {"success", response.success},
+                          {"total_count", response.total_count},
+                          {"rooms", std::move(rooms)}}
+        .dump();
+}
+
+class CountingMessageHandler : public ModelA::IMessageHandler {
+public:
+    void OnRoomCreated(const ModelA::RoomCreatedResponse&) override {}
+    void OnRoomListUpdate(const ModelA::RoomListResponse& response) override {
+        rooms_seen += response.rooms.size();
+    }
+    void OnJoinedRoom(const ModelA::JoinRoomResponse&) override {}
+    void OnP2PInfoReceived(const ModelA::P2PInfoMessage&) override {}
+    void OnUseProxyMessage(const ModelA::UseProxyMessage&) override {}
+    void OnErrorReceived(const ModelA::ErrorMessage&) override {}
+    void OnPlayerJoined(const ModelA::PlayerJoinedMessage&) override {}
+    void OnPlayerLeft(const ModelA::PlayerLeftMessage&) override {}
+
+    size_t rooms_seen = 0;
+};
+
+HLE::InternalScanResult MakeScanResult(uint8_t index) {
+    HLE::InternalScanResult result;
+    auto& network = result.network;
+    network.network_name = "Network" + std::to_string(index);
+    network.network_id.assign(HLE::InternalNetworkIdSize, index);
+    network.session_id.assign(HLE::InternalSessionIdSize, static_cast<uint8_t>(index + 1));
+    network.local_communication_id = 0x0100ABCD12345678;
+    network.channel = 6;
+    network.node_count = 4;
+    network.node_count_max = 8;
+    network.link_level = 3;
+    network.network_mode = 2;
+    for (uint8_t node = 0; node < network.node_count; ++node) {
+        HLE::InternalNodeInfo info{};
+        info.node_id = node;
+        info.user_name = "Player" + std::to_string(node);
+        info.mac_address = {0x02, 0x00, 0x00, 0x00, index, node};
+        info.ipv4_address = {192, 168, 0, static_cast<uint8_t>(node + 1)};
+        info.is_connected = true;
+        info.local_communication_version = 1;
+        network.nodes.push_back(info);
+    }
+    network.advertise_data = MakePayload(128);
+    network.has_password = false;
+    network.security_mode = 1;
+    network.local_communication_version = 1;
+    result.rssi = -40;
+    result.timestamp = 0;
+    return result;
+}
+
+} // namespace
+
+// =============================================================================
+// Relay protocol
+// =============================================================================
+
+/**
+ * Benchmark: Frame a relay data message into a reused buffer and validate it
+ * again, as the send and receive paths do
+ */
+static void BM_RelayProtocol_WriteAndValidate(benchmark::State& state) {
+    const auto payload = MakePayload(static_cast<size_t>(state.range(0)));
+    ModelA::RelayProtocol protocol;
+    std::vector<uint8_t> buffer(protocol.GetHeaderSize() + protocol.GetMaxPayloadSize());
+    uint32_t sequence = 0;
+
+    for (auto _ : state) {
+        const size_t written = protocol.WriteDataMessage(buffer, 0xC0FFEE, payload, sequence++);
+        ModelA::RelayHeaderView view;
+        const bool valid = protocol.ValidateMessage(buffer.data(), written, &view);
+        benchmark::DoNotOptimize(valid);
+        benchmark::DoNotOptimize(view.payload.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_RelayProtocol_WriteAndValidate)
+    ->Name("Components/RelayProtocol/WriteAndValidate")
+    ->Apply(PayloadSizes);
+
+/**
+ * Benchmark: Scatter-gather framing, which leaves the payload in place
+ */
+static void BM_RelayProtocol_Frame(benchmark::State& state) {
+    const auto payload = MakePayload(static_cast<size_t>(state.range(0)));
+    ModelA::RelayProtocol protocol;
+    uint32_t sequence = 0;
+
+    for (auto _ : state) {
+        auto frame = protocol.FrameDataMessage(0xC0FFEE, payload, sequence++);
+        benchmark::DoNotOptimize(frame);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_RelayProtocol_Frame)->Name("Components/RelayProtocol/Frame")->Apply(PayloadSizes);
+
+// =============================================================================
+// Packet encryption
+// =============================================================================
+
+/**
+ * Benchmark: Seal a 60Hz burst of 16 pooled packets in place and open it
+ * again, for each AEAD the cipher can pick
+ */
+static void BM_PacketCipher_SealOpenBurst(benchmark::State& state,
+                                          ModelA::AeadAlgorithm algorithm) {
+    constexpr size_t BURST = 16;
+    constexpr std::array<uint8_t, ModelA::PacketCipher::KEY_SIZE> key{0x80, 0x81, 0x82, 0x83};
+    ModelA::PacketCipher sender(algorithm, key);
+    ModelA::PacketCipher receiver(algorithm, key);
+    if (!sender.IsValid()) {
+        state.SkipWithError("Cipher unavailable");
+        return;
+    }
+    const auto payload = MakePayload(static_cast<size_t>(state.range(0)));
+    PacketPool pool(BURST);
+    std::vector<PacketBuffer> packets;
+    for (size_t i = 0; i < BURST; ++i) {
+        packets.push_back(pool.Acquire(payload.data(), payload.size()));
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sender.SealBatch(packets));
+        benchmark::DoNotOptimize(receiver.OpenBatch(packets));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * BURST));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * BURST) * state.range(0));
+}
+BENCHMARK_CAPTURE(BM_PacketCipher_SealOpenBurst, chacha20, ModelA::AeadAlgorithm::ChaCha20Poly1305)
+    ->Name("Components/PacketCipher/SealOpenBurst/ChaCha20Poly1305")
+    ->ArgName("payload")
+    ->Arg(64)
+    ->Arg(512)
+    ->Arg(1200);
+BENCHMARK_CAPTURE(BM_PacketCipher_SealOpenBurst, aes256gcm, ModelA::AeadAlgorithm::Aes256Gcm)
+    ->Name("Components/PacketCipher/SealOpenBurst/Aes256Gcm")
+    ->ArgName("payload")
+    ->Arg(64)
+    ->Arg(512)
+    ->Arg(1200);
+
+// =============================================================================
+// mDNS TXT records
+// =============================================================================
+
+/**
+ * Benchmark: Apply a session update that changes the player count and
+ * re-encode the records, as a host does on every advertisement refresh
+ */
+static void BM_TxtRecordBuilder_UpdateAndEncode(benchmark::State& state) {
+    auto session = MakeGameSession();
+    auto builder = ModelB::TxtRecordBuilder::CreateGameSessionTxtRecords(session);
+
+    for (auto _ : state) {
+        session.current_players = session.current_players % session.max_players + 1;
+        builder.ApplyGameSession(session);
+        auto binary = builder.ToBinary();
+        benchmark::DoNotOptimize(binary.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TxtRecordBuilder_UpdateAndEncode)->Name("Components/TxtRecordBuilder/UpdateAndEncode");
+
+/**
+ * Benchmark: Parse the wire form of a game session's TXT records
+ */
+static void BM_TxtRecordParser_Parse(benchmark::State& state) {
+    const auto binary =
+        ModelB::TxtRecordBuilder::CreateGameSessionTxtRecords(MakeGameSession()).ToBinary();
+
+    for (auto _ : state) {
+        auto parser = ModelB::TxtRecordParser::ParseTxtRecords(binary);
+        benchmark::DoNotOptimize(parser.GetRecordCount());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * binary.size());
+}
+BENCHMARK(BM_TxtRecordParser_Parse)->Name("Components/TxtRecordParser/Parse");
+
+// =============================================================================
+// LDN type translation
+// =============================================================================
+
+/**
+ * Benchmark: Translate a scan result page to LDN and back into reused
+ * storage, as Scan does for the guest
+ */
+static void BM_TypeTranslator_ScanResults(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    auto translator = HLE::CreateTypeTranslator();
+    std::vector<HLE::InternalScanResult> internal;
+    for (size_t i = 0; i < count; ++i) {
+        internal.push_back(MakeScanResult(static_cast<uint8_t>(i)));
+    }
+    std::vector<Service::LDN::NetworkInfo> ldn(count);
+    std::vector<HLE::InternalScanResult> round_trip(count);
+
+    for (auto _ : state) {
+        translator->ToLdnScanResults(internal, ldn);
+        translator->FromLdnScanResults(ldn, round_trip);
+        benchmark::DoNotOptimize(round_trip.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+}
+BENCHMARK(BM_TypeTranslator_ScanResults)
+    ->Name("Components/TypeTranslator/ScanResults")
+    ->ArgName("networks")
+    ->Arg(1)
+    ->Arg(8)
+    ->Arg(24);
+
+// =============================================================================
+// Input validation and rate limiting
+// =============================================================================
+
+/**
+ * Benchmark: Structural and content checks on an inbound LDN packet
+ */
+static void BM_NetworkInputValidator_Packet(benchmark::State& state) {
+    const auto packet = MakeLdnPacket(static_cast<size_t>(state.range(0)));
+    const std::string protocol = "/sudachi/ldn/1.0.0";
+
+    for (auto _ : state) {
+        auto structure = Security::NetworkInputValidator::ValidatePacket(packet);
+        auto content = Security::NetworkInputValidator::ValidatePacketContent(packet, protocol);
+        benchmark::DoNotOptimize(structure.is_valid && content.is_valid);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_NetworkInputValidator_Packet)
+    ->Name("Components/NetworkInputValidator/Packet")
+    ->Apply(PayloadSizes);
+
+/**
+ * Benchmark: Validate a room server message, sized by its room count
+ */
+static void BM_NetworkInputValidator_Json(benchmark::State& state) {
+    const std::string message = ToJson(MakeRoomList(static_cast<size_t>(state.range(0))));
+
+    for (auto _ : state) {
+        auto result = Security::NetworkInputValidator::ValidateJsonMessage(message);
+        benchmark::DoNotOptimize(result.is_valid);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * message.size());
+}
+BENCHMARK(BM_NetworkInputValidator_Json)
+    ->Name("Components/NetworkInputValidator/Json")
+    ->ArgName("rooms")
+    ->Arg(1)
+    ->Arg(16)
+    ->Arg(64);
+
+/**
+ * Benchmark: UTF-8 validation of a chat message that is ASCII up to a short
+ * multibyte tail, the common shape of room traffic
+ */
+static void BM_NetworkInputValidator_Utf8(benchmark::State& state) {
+    std::string message = MakeChatMessage(static_cast<size_t>(state.range(0)));
+    message.insert(message.size() - 2, "caf\xC3\xA9 \xF0\x9F\x98\x81");
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Security::NetworkInputValidator::IsValidUtf8(message));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * message.size());
+}
+BENCHMARK(BM_NetworkInputValidator_Utf8)
+    ->Name("Components/NetworkInputValidator/Utf8")
+    ->ArgName("sentences")
+    ->Arg(1)
+    ->Arg(16)
+    ->Arg(64);
+
+/**
+ * Benchmark: Scan a clean chat message for suspicious patterns with the
+ * literal matcher, and with the regex it replaced for comparison
+ */
+static void BM_NetworkInputValidator_SuspiciousPatterns(benchmark::State& state, bool regex) {
+    static const std::regex reference(
+        R"(<script|javascript:|eval\(|exec\(|\.\./|..\\|cmd\.exe|/bin/|drop table|select \* from|union select|'; --)",
+        std::regex::icase);
+    const std::string message = MakeChatMessage(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        const bool found =
+            regex ? std::regex_search(message, reference)
+                  : Security::NetworkInputValidator::ContainsSuspiciousPatterns(message);
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * message.size());
+}
+BENCHMARK_CAPTURE(BM_NetworkInputValidator_SuspiciousPatterns, matcher, false)
+    ->Name("Components/NetworkInputValidator/SuspiciousPatterns")
+    ->ArgName("sentences")
+    ->Arg(1)
+    ->Arg(16)
+    ->Arg(64);
+BENCHMARK_CAPTURE(BM_NetworkInputValidator_SuspiciousPatterns, regex, true)
+    ->Name("Components/NetworkInputValidator/SuspiciousPatternsRegex")
+    ->ArgName("sentences")
+    ->Arg(1)
+    ->Arg(16)
+    ->Arg(64);
+
+/**
+ * Benchmark: Poll the security statistics while worker threads validate
+ * packets through the same manager
+ */
+static void BM_NetworkSecurityManager_PollStatistics(benchmark::State& state) {
+    Security::NetworkSecurityManager manager(Security::RateLimitConfig{},
+                                             Security::DDoSProtectionConfig{});
+    const auto packet = MakeLdnPacket(64);
+    std::atomic<bool> running{true};
+    std::vector<std::thread> workers;
+    for (int64_t t = 0; t < state.range(0); ++t) {
+        workers.emplace_back([&, t] {
+            const std::string client = "client" + std::to_string(t);
+            while (running.load(std::memory_order_relaxed)) {
+                manager.ValidateIncomingPacket(client, "192.0.2.1", packet, "/sudachi/ldn/1.0.0");
+            }
+        });
+    }
+
+    for (auto _ : state) {
+        const auto statistics = manager.GetSecurityStatistics();
+        benchmark::DoNotOptimize(statistics.packets_accepted);
+    }
+    running = false;
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NetworkSecurityManager_PollStatistics)
+    ->Name("Components/NetworkSecurityManager/PollStatistics")
+    ->ArgName("workers")
+    ->Arg(0)
+    ->Arg(4)
+    ->UseRealTime();
+
+/**
+ * Benchmark: Check 50 batches of packets one at a time on the calling thread
+ */
+static void BM_SecurePacketPipeline_Inline(benchmark::State& state) {
+    const auto batches = MakeInboundBatches(50);
+    size_t packets = 0;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto manager = MakeUnlimitedSecurityManager();
+        state.ResumeTiming();
+        for (const auto& batch : batches) {
+            for (const auto& packet : batch) {
+                benchmark::DoNotOptimize(manager->ValidateIncomingPacket(
+                    packet.client_id, packet.client_ip, packet.data, packet.protocol));
+            }
+            packets += batch.size();
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(packets));
+}
+BENCHMARK(BM_SecurePacketPipeline_Inline)
+    ->Name("Components/SecurePacketPipeline/Inline")
+    ->Unit(benchmark::kMicrosecond);
+
+/**
+ * Benchmark: Run the same 50 batches through the staged pipeline, from
+ * Start to the Stop that drains it. submit_ns reports what the receiving
+ * thread itself spends per packet
+ */
+static void BM_SecurePacketPipeline_Staged(benchmark::State& state) {
+    const auto batches = MakeInboundBatches(50);
+    SecurePacketPipelineConfig config;
+    config.queue_capacity = batches.size();
+    size_t packets = 0;
+    std::chrono::nanoseconds submitting{0};
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto manager = MakeUnlimitedSecurityManager();
+        auto copies = batches;
+        state.ResumeTiming();
+        SecurePacketPipeline pipeline(
+            *manager, [&packets](const std::string&, const std::vector<uint8_t>&) { ++packets; },
+            nullptr, config);
+        pipeline.Start();
+        const auto start = std::chrono::steady_clock::now();
+        for (auto& batch : copies) {
+            pipeline.Submit(std::move(batch));
+        }
+        submitting += std::chrono::steady_clock::now() - start;
+        pipeline.Stop();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(packets));
+    state.counters["submit_ns"] =
+        packets == 0 ? 0.0 : static_cast<double>(submitting.count()) / static_cast<double>(packets);
+}
+BENCHMARK(BM_SecurePacketPipeline_Staged)
+    ->Name("Components/SecurePacketPipeline/Staged")
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+/**
+ * Benchmark: Per-packet rate checks, one client per thread, all sharing
+ * one manager
+ */
+static void BM_ClientRateManager_Check(benchmark::State& state) {
+    static std::unique_ptr<Security::ClientRateManager> manager;
+    if (state.thread_index() == 0) {
+        Security::RateLimitConfig config;
+        config.packets_per_second = 1e9;
+        config.burst_capacity = 1e9;
+        config.bytes_per_second = 1e12;
+        config.byte_burst_capacity = 1e12;
+        manager = std::make_unique<Security::ClientRateManager>(config);
+    }
+    const std::string client_id = "client" + std::to_string(state.thread_index());
+    const size_t bytes = static_cast<size_t>(state.range(0));
+
+    for (auto _ : state) {
+        const bool allowed =
+            manager->CheckPacketRateLimit(client_id) && manager->CheckByteRateLimit(client_id, bytes);
+        benchmark::DoNotOptimize(allowed);
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        manager.reset();
+    }
+}
+BENCHMARK(BM_ClientRateManager_Check)
+    ->Name("Components/ClientRateManager/Check")
+    ->Apply(PayloadSizes)
+    ->Apply(ThreadCounts);
+
+/**
+ * Benchmark: Token bucket admission on the relay send path, with every
+ * thread drawing from one limiter
+ */
+static void BM_BandwidthLimiter_TryConsume(benchmark::State& state) {
+    static std::unique_ptr<ModelA::BandwidthLimiter> limiter;
+    if (state.thread_index() == 0) {
+        // Fast enough that the bucket never runs dry
+        limiter = std::make_unique<ModelA::BandwidthLimiter>(uint64_t{1} << 40, size_t{1} << 30);
+    }
+    const size_t bytes = static_cast<size_t>(state.range(0));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(limiter->TryConsumeBytes(bytes));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+    if (state.thread_index() == 0) {
+        limiter.reset();
+    }
+}
+BENCHMARK(BM_BandwidthLimiter_TryConsume)
+    ->Name("Components/BandwidthLimiter/TryConsume")
+    ->Apply(PayloadSizes)
+    ->Apply(ThreadCounts);
+
+/**
+ * Benchmark: Admission checks for spoofed source addresses against a CIDR
+ * ban list, every thread sharing one DDoSProtection
+ */
+static void BM_DDoSProtection_SpoofedAdmission(benchmark::State& state) {
+    static std::unique_ptr<Security::DDoSProtection> protection;
+    if (state.thread_index() == 0) {
+        protection = std::make_unique<Security::DDoSProtection>(Security::DDoSProtectionConfig{});
+        protection->BlacklistIP("203.0.113.0/24", "abuse");
+    }
+    std::mt19937 rng(static_cast<uint32_t>(99 + state.thread_index()));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(protection->AllowNewConnection(IpAddressKey::FromIPv4(rng())));
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        protection.reset();
+    }
+}
+BENCHMARK(BM_DDoSProtection_SpoofedAdmission)
+    ->Name("Components/DDoSProtection/SpoofedAdmission")
+    ->Apply(ThreadCounts);
+
+// =============================================================================
+// Circuit breakers
+// =============================================================================
+
+/**
+ * Benchmark: A send wrapped in its endpoint's breaker on the Closed fast
+ * path, every thread going through the same breaker
+ */
+static void BM_CircuitBreaker_WrappedSend(benchmark::State& state) {
+    static std::unique_ptr<CircuitBreakerRegistry> registry;
+    static CircuitBreakerRegistry::Key key = 0;
+    if (state.thread_index() == 0) {
+        registry = std::make_unique<CircuitBreakerRegistry>();
+        key = *registry->Intern(CircuitBreakerScope::Relay, "relay.example:443");
+    }
+    uint64_t sent = 0;
+    const auto send = [&sent] {
+        benchmark::DoNotOptimize(++sent);
+        return ErrorCode::Success;
+    };
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(registry->Get(key).Execute(send));
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        registry.reset();
+    }
+}
+BENCHMARK(BM_CircuitBreaker_WrappedSend)
+    ->Name("Components/CircuitBreaker/WrappedSend")
+    ->Apply(ThreadCounts);
+
+// =============================================================================
+// Error reporting
+// =============================================================================
+
+/**
+ * Benchmark: Report an expected error as a compact record, with no
+ * listener attached
+ */
+static void BM_ErrorHandler_ReportRecord(benchmark::State& state) {
+    ErrorHandler handler;
+
+    for (auto _ : state) {
+        handler.ReportError(MakeErrorRecord(ErrorCode::ResourceExhausted,
+                                            ErrorFormat::RateLimited, "Security", 100));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ErrorHandler_ReportRecord)->Name("Components/ErrorHandler/ReportRecord");
+
+/**
+ * Benchmark: Build the same error as an ErrorInfo, as callers did before
+ * records, for comparison
+ */
+static void BM_ErrorHandler_BuildErrorInfo(benchmark::State& state) {
+    for (auto _ : state) {
+        auto info = CreateNetworkError(ErrorCode::ResourceExhausted, "Rate limited");
+        benchmark::DoNotOptimize(info.message.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ErrorHandler_BuildErrorInfo)->Name("Components/ErrorHandler/BuildErrorInfo");
+
+// =============================================================================
+// Room client message processing
+// =============================================================================
+
+/**
+ * Benchmark: Route and decode a room list response through
+ * RoomClient::ProcessMessage, in the JSON and the binary wire format
+ */
+static void BM_RoomClient_ProcessRoomList(benchmark::State& state, bool binary) {
+    const auto response = MakeRoomList(static_cast<size_t>(state.range(0)));
+    const std::string message = binary ? ModelA::RoomBinaryCodec::Encode(response) : ToJson(response);
+
+    ModelA::RoomClient client(std::make_shared<IdleWebSocketConnection>(),
+                              std::make_shared<StaticConfig>());
+    auto handler = std::make_shared<CountingMessageHandler>();
+    client.SetMessageHandler(handler);
+
+    for (auto _ : state) {
+        client.SimulateIncomingMessage(message);
+    }
+    benchmark::DoNotOptimize(handler->rooms_seen);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * message.size());
+    client.Shutdown();
+}
+BENCHMARK_CAPTURE(BM_RoomClient_ProcessRoomList, json, false)
+    ->Name("Components/RoomClient/ProcessMessage/RoomListJson")
+    ->ArgName("rooms")
+    ->Arg(1)
+    ->Arg(16)
+    ->Arg(64);
+BENCHMARK_CAPTURE(BM_RoomClient_ProcessRoomList, binary, true)
+    ->Name("Components/RoomClient/ProcessMessage/RoomListBinary")
+    ->ArgName("rooms")
+    ->Arg(1)
+    ->Arg(16)
+    ->Arg(64);
+
+// =============================================================================
+// Per-session memory
+// =============================================================================
+
+namespace {
+
+// Bytes one session may hold in its subsystem's tables. Sized for 4GB
+// Android devices; strings past the small-string buffer are not counted
+constexpr uint64_t ROOM_BYTES_BUDGET = 512;
+constexpr uint64_t PEER_BYTES_BUDGET = 256;
+constexpr uint64_t SERVICE_BYTES_BUDGET = 512;
+constexpr uint64_t RATE_LIMIT_CLIENT_BYTES_BUDGET = 384;
+constexpr uint64_t RELAY_SESSION_BYTES_BUDGET = 256;
+constexpr uint64_t PACKET_BUFFER_BYTES_BUDGET = 1536;
+
+uint64_t LiveBytes(MemorySubsystem subsystem) {
+    return GetMemoryStatistics()[subsystem].live_bytes;
+}
+
+// Counters the main reporter checks under --memory_budgets
+void ReportBytesPerSession(benchmark::State& state, uint64_t bytes, size_t sessions,
+                           uint64_t budget) {
+    state.counters["bytes_per_session"] =
+        static_cast<double>(bytes) / static_cast<double>(std::max<size_t>(sessions, 1));
+    state.counters["budget_bytes"] = static_cast<double>(budget);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * sessions));
+}
+
+void SessionCounts(benchmark::internal::Benchmark* benchmark) {
+    benchmark->ArgName("sessions")->Arg(64)->Arg(1024);
+}
+
+} // namespace
+
+/**
+ * Benchmark: Room list index holding a snapshot of rooms
+ */
+static void BM_Memory_RoomListIndex(benchmark::State& state) {
+    const size_t rooms = static_cast<size_t>(state.range(0));
+    ModelA::RoomListDelta delta;
+    delta.snapshot = true;
+    delta.version = 1;
+    delta.upserted = MakeRoomList(rooms).rooms;
+
+    uint64_t bytes = 0;
+    for (auto _ : state) {
+        const uint64_t before = LiveBytes(MemorySubsystem::RoomClient);
+        ModelA::RoomListIndex index;
+        index.Apply(delta);
+        bytes = LiveBytes(MemorySubsystem::RoomClient) - before;
+    }
+    ReportBytesPerSession(state, bytes, rooms, ROOM_BYTES_BUDGET);
+}
+BENCHMARK(BM_Memory_RoomListIndex)->Name("Components/Memory/RoomListIndex")->Apply(SessionCounts);
+
+/**
+ * Benchmark: Peer address book remembering direct paths
+ */
+static void BM_Memory_PeerAddressBook(benchmark::State& state) {
+    const size_t peers = static_cast<size_t>(state.range(0));
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "sudachi_benchmark_peer_book.json").string();
+    {
+        ModelA::PeerAddressBook book(path, peers);
+        for (size_t i = 0; i < peers; ++i) {
+            book.RecordSuccess("peer" + std::to_string(i), "/ip4/192.168.1.2/udp/4000", false);
+        }
+    }
+
+    uint64_t bytes = 0;
+    for (auto _ : state) {
+        const uint64_t before = LiveBytes(MemorySubsystem::P2P);
+        ModelA::PeerAddressBook book(path, peers);
+        book.Load();
+        bytes = LiveBytes(MemorySubsystem::P2P) - before;
+    }
+    ReportBytesPerSession(state, bytes, peers, PEER_BYTES_BUDGET);
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_Memory_PeerAddressBook)
+    ->Name("Components/Memory/PeerAddressBook")
+    ->Apply(SessionCounts);
+
+/**
+ * Benchmark: Discovered service cache holding mDNS announcements
+ */
+static void BM_Memory_DiscoveredServiceCache(benchmark::State& state) {
+    const size_t services = static_cast<size_t>(state.range(0));
+
+    uint64_t bytes = 0;
+    for (auto _ : state) {
+        const uint64_t before = LiveBytes(MemorySubsystem::Mdns);
+        ModelB::DiscoveredServiceCache cache;
+        for (size_t i = 0; i < services; ++i) {
+            ModelB::GameSessionInfo info;
+            info.game_id = "0100123456789ABC";
+            info.host_ip = "10.0." + std::to_string(i / 256) + "." + std::to_string(i % 256);
+            info.session_id = "session" + std::to_string(i);
+            cache.Upsert(info, i);
+        }
+        bytes = LiveBytes(MemorySubsystem::Mdns) - before;
+    }
+    ReportBytesPerSession(state, bytes, services, SERVICE_BYTES_BUDGET);
+}
+BENCHMARK(BM_Memory_DiscoveredServiceCache)
+    ->Name("Components/Memory/DiscoveredServiceCache")
+    ->Apply(SessionCounts);
+
+/**
+ * Benchmark: Rate limit tables tracking clients
+ */
+static void BM_Memory_ClientRateManager(benchmark::State& state) {
+    const size_t clients = static_cast<size_t>(state.range(0));
+
+    uint64_t bytes = 0;
+    for (auto _ : state) {
+        const uint64_t before = LiveBytes(MemorySubsystem::SecurityTables);
+        Security::ClientRateManager manager(Security::RateLimitConfig{});
+        for (size_t i = 0; i < clients; ++i) {
+            manager.CheckPacketRateLimit("client" + std::to_string(i));
+        }
+        bytes = LiveBytes(MemorySubsystem::SecurityTables) - before;
+    }
+    ReportBytesPerSession(state, bytes, clients, RATE_LIMIT_CLIENT_BYTES_BUDGET);
+}
+BENCHMARK(BM_Memory_ClientRateManager)
+    ->Name("Components/Memory/ClientRateManager")
+    ->Apply(SessionCounts);
+
+/**
+ * Benchmark: Relay client carrying multiplexed sessions
+ */
+static void BM_Memory_RelaySessions(benchmark::State& state) {
+    const size_t sessions = static_cast<size_t>(state.range(0));
+
+    uint64_t bytes = 0;
+    for (auto _ : state) {
+        ModelA::RelayClient client;
+        const uint64_t before = LiveBytes(MemorySubsystem::Relay);
+        for (size_t i = 0; i < sessions; ++i) {
+            client.AddSession(static_cast<uint32_t>(i + 1), [](const std::vector<uint8_t>&) {});
+        }
+        bytes = LiveBytes(MemorySubsystem::Relay) - before;
+    }
+    ReportBytesPerSession(state, bytes, sessions, RELAY_SESSION_BYTES_BUDGET);
+}
+BENCHMARK(BM_Memory_RelaySessions)->Name("Components/Memory/RelaySessions")->Apply(SessionCounts);
+
+/**
+ * Benchmark: Packet pool slab, per buffer
+ */
+static void BM_Memory_PacketPool(benchmark::State& state) {
+    const size_t buffers = static_cast<size_t>(state.range(0));
+
+    uint64_t bytes = 0;
+    for (auto _ : state) {
+        const uint64_t before = LiveBytes(MemorySubsystem::PacketPool);
+        PacketPool pool(buffers);
+        bytes = LiveBytes(MemorySubsystem::PacketPool) - before;
+    }
+    ReportBytesPerSession(state, bytes, buffers, PACKET_BUFFER_BYTES_BUDGET);
+}
+BENCHMARK(BM_Memory_PacketPool)
+    ->Name("Components/Memory/PacketPool")
+    ->ArgName("buffers")
+    ->Arg(DEFAULT_PACKET_POOL_CAPACITY);
+
+} // namespace Benchmarks
@@ -4,6 +4,10 @@
 #pragma once
 
 #include "benchmark_mocks.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <random>
@@ -220,10 +224,184 @@ public:
         return std::sqrt(variance);
     }
 
+    size_t GetSampleCount() const {
+        return samples_.size();
+    }
+
+    const std::vector<double>& GetSamples() const {
+        return samples_;
+    }
+
+    struct MannWhitneyResult {
+        double u = 0.0;       // U statistic of the first sample set
+        double z = 0.0;       // Normal approximation, tie corrected
+        double p_value = 1.0; // Two-sided
+    };
+
+    /**
+     * Mann-Whitney U test of whether two sample sets come from the same
+     * distribution. Uses the normal approximation, which is rough below
+     * about five samples per side; a p-value of 1 means too few samples.
+     */
+    static MannWhitneyResult MannWhitneyU(const StatisticalAnalyzer& a,
+                                          const StatisticalAnalyzer& b) {
+        MannWhitneyResult result;
+        const size_t n1 = a.samples_.size();
+        const size_t n2 = b.samples_.size();
+        if (n1 == 0 || n2 == 0) {
+            return result;
+        }
+
+        std::vector<std::pair<double, int>> pooled;
+        pooled.reserve(n1 + n2);
+        for (double sample : a.samples_) pooled.emplace_back(sample, 0);
+        for (double sample : b.samples_) pooled.emplace_back(sample, 1);
+        std::sort(pooled.begin(), pooled.end());
+
+        // Average ranks over ties, and collect the tie correction term
+        double rank_sum_a = 0.0;
+        double tie_term = 0.0;
+        for (size_t i = 0; i < pooled.size();) {
+            size_t j = i;
+            while (j < pooled.size() && pooled[j].first == pooled[i].first) {
+                ++j;
+            }
+            const double rank = (i + 1 + j) / 2.0;
+            for (size_t k = i; k < j; ++k) {
+                if (pooled[k].second == 0) rank_sum_a += rank;
+            }
+            const double ties = static_cast<double>(j - i);
+            tie_term += ties * ties * ties - ties;
+            i = j;
+        }
+
+        const double n = static_cast<double>(n1 + n2);
+        result.u = rank_sum_a - n1 * (n1 + 1) / 2.0;
+        const double mean_u = n1 * n2 / 2.0;
+        const double variance = n1 * n2 / 12.0 * ((n + 1) - tie_term / (n * (n - 1)));
+        if (variance <= 0.0) {
+            return result;
+        }
+        result.z = (result.u - mean_u) / std::sqrt(variance);
+        result.p_value = std::erfc(std::abs(result.z) / std::sqrt(2.0));
+        return result;
+    }
+
+    struct ConfidenceInterval {
+        double lower = 0.0;
+        double upper = 0.0;
+    };
+
+    /**
+     * Bootstrap confidence interval for median(a) / median(b). Resampling is
+     * seeded, so the same samples always give the same interval.
+     */
+    static ConfidenceInterval BootstrapMedianRatio(const StatisticalAnalyzer& a,
+                                                   const StatisticalAnalyzer& b,
+                                                   double confidence = 0.95,
+                                                   size_t resamples = 2000,
+                                                   uint32_t seed = 0x5eed) {
+        ConfidenceInterval interval;
+        if (a.samples_.empty() || b.samples_.empty()) {
+            return interval;
+        }
+
+        std::mt19937 gen(seed);
+        auto resampled_median = [&gen](const std::vector<double>& samples) {
+            std::uniform_int_distribution<size_t> pick(0, samples.size() - 1);
+            StatisticalAnalyzer resample;
+            for (size_t i = 0; i < samples.size(); ++i) {
+                resample.AddSample(samples[pick(gen)]);
+            }
+            return resample.GetMedian();
+        };
+
+        StatisticalAnalyzer ratios;
+        for (size_t i = 0; i < resamples; ++i) {
+            const double denominator = resampled_median(b.samples_);
+            if (denominator > 0.0) {
+                ratios.AddSample(resampled_median(a.samples_) / denominator);
+            }
+        }
+        if (ratios.GetSampleCount() == 0) {
+            return interval;
+        }
+        const double tail = (1.0 - confidence) / 2.0 * 100.0;
+        interval.lower = ratios.GetPercentile(tail);
+        interval.upper = ratios.GetPercentile(100.0 - tail);
+        return interval;
+    }
+
 private:
     std::vector<double> samples_;
 };
 
+/**
+ * Splits one-way latency into the stages a datagram passes through.
+ *
+ * PrecisionTimer only sees user space. Given kernel timestamps for when a
+ * datagram left the sending socket and reached the receiving one, the time
+ * spent in the application, the kernel's socket layers and on the wire
+ * (or NIC, with hardware stamps) can be told apart.
+ */
+class LatencyBreakdown {
+public:
+    enum Stage : size_t {
+        UserSend,      // Application send call until the send syscall
+        KernelSend,    // Send syscall until the transmit timestamp
+        Wire,          // Transmit timestamp until the receive timestamp
+        KernelReceive, // Receive timestamp until the receive syscall returned
+        UserReceive,   // Receive syscall until the application has the packet
+        STAGE_COUNT,
+    };
+
+    static constexpr std::array<const char*, STAGE_COUNT> STAGE_NAMES = {
+        "user_send", "kernel_send", "wire", "kernel_receive", "user_receive"};
+
+    using Boundaries = std::array<int64_t, STAGE_COUNT + 1>;
+
+    /**
+     * Adds one datagram's stage boundaries, in nanoseconds on one clock
+     * @return false, adding nothing, if a boundary is missing or out of order
+     */
+    bool AddSample(const Boundaries& boundaries) {
+        for (size_t i = 0; i < boundaries.size(); ++i) {
+            if (boundaries[i] == 0 || (i > 0 && boundaries[i] < boundaries[i - 1])) {
+                return false;
+            }
+        }
+        for (size_t stage = 0; stage < STAGE_COUNT; ++stage) {
+            stages_[stage].AddSample(
+                static_cast<double>(boundaries[stage + 1] - boundaries[stage]) / 1000.0);
+        }
+        return true;
+    }
+
+    const StatisticalAnalyzer& GetStage(Stage stage) const {
+        return stages_[stage];
+    }
+
+    size_t GetSampleCount() const {
+        return stages_[0].GetSampleCount();
+    }
+
+    // Writes each stage's median and p99 in microseconds as state counters
+    template <typename State>
+    void Report(State& state) const {
+        if (GetSampleCount() == 0) {
+            return;
+        }
+        for (size_t stage = 0; stage < STAGE_COUNT; ++stage) {
+            const std::string name = STAGE_NAMES[stage];
+            state.counters[name + "_p50_us"] = stages_[stage].GetPercentile(50.0);
+            state.counters[name + "_p99_us"] = stages_[stage].GetPercentile(99.0);
+        }
+    }
+
+private:
+    std::array<StatisticalAnalyzer, STAGE_COUNT> stages_;
+};
+
 // =============================================================================
 // Network Simulation Utilities
 // =============================================================================
@@ -0,0 +1,148 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "event_loop.h"
+
+#include <algorithm>
+#include <array>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace Benchmarks::Load {
+
+EventLoop::EventLoop() {
+    epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+    wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epoll_fd_ >= 0 && wake_fd_ >= 0) {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.ptr = nullptr; // The wakeup descriptor has no handler
+        ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &event);
+    }
+}
+
+EventLoop::~EventLoop() {
+    Stop();
+    if (wake_fd_ >= 0) {
+        ::close(wake_fd_);
+    }
+    if (epoll_fd_ >= 0) {
+        ::close(epoll_fd_);
+    }
+}
+
+bool EventLoop::Start() {
+    if (epoll_fd_ < 0 || wake_fd_ < 0 || thread_.joinable()) {
+        return false;
+    }
+    stop_requested_ = false;
+    thread_ = std::thread([this] { Run(); });
+    return true;
+}
+
+void EventLoop::Stop() {
+    stop_requested_ = true;
+    if (wake_fd_ >= 0) {
+        const uint64_t one = 1;
+        [[maybe_unused]] const auto written = ::write(wake_fd_, &one, sizeof(one));
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+bool EventLoop::Add(int fd, uint32_t events, IEventHandler* handler) {
+    epoll_event event{};
+    event.events = events;
+    event.data.ptr = handler;
+    return ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) == 0;
+}
+
+bool EventLoop::Modify(int fd, uint32_t events, IEventHandler* handler) {
+    epoll_event event{};
+    event.events = events;
+    event.data.ptr = handler;
+    return ::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &event) == 0;
+}
+
+void EventLoop::Remove(int fd) {
+    ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+void EventLoop::Post(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(tasks_mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    const uint64_t one = 1;
+    [[maybe_unused]] const auto written = ::write(wake_fd_, &one, sizeof(one));
+}
+
+bool EventLoop::IsInLoopThread() const {
+    return loop_thread_id_.load(std::memory_order_relaxed) == std::this_thread::get_id();
+}
+
+void EventLoop::Run() {
+    loop_thread_id_ = std::this_thread::get_id();
+    std::array<epoll_event, MAX_EVENTS> events{};
+    while (!stop_requested_.load(std::memory_order_relaxed)) {
+        const int count = ::epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()), 100);
+        for (int i = 0; i < count; ++i) {
+            auto* handler = static_cast<IEventHandler*>(events[i].data.ptr);
+            if (handler == nullptr) {
+                uint64_t drained = 0;
+                [[maybe_unused]] const auto read = ::read(wake_fd_, &drained, sizeof(drained));
+                continue;
+            }
+            handler->OnEvents(events[i].events);
+        }
+        RunPostedTasks();
+    }
+    RunPostedTasks();
+    loop_thread_id_ = std::thread::id{};
+}
+
+void EventLoop::RunPostedTasks() {
+    std::vector<std::function<void()>> tasks;
+    {
+        std::lock_guard<std::mutex> lock(tasks_mutex_);
+        tasks.swap(tasks_);
+    }
+    for (auto& task : tasks) {
+        task();
+    }
+}
+
+EventLoopGroup::EventLoopGroup(size_t loop_count) {
+    for (size_t i = 0; i < std::max<size_t>(loop_count, 1); ++i) {
+        loops_.push_back(std::make_unique<EventLoop>());
+    }
+}
+
+EventLoopGroup::~EventLoopGroup() {
+    Stop();
+}
+
+bool EventLoopGroup::Start() {
+    for (auto& loop : loops_) {
+        if (!loop->Start()) {
+            Stop();
+            return false;
+        }
+    }
+    return true;
+}
+
+void EventLoopGroup::Stop() {
+    for (auto& loop : loops_) {
+        loop->Stop();
+    }
+}
+
+EventLoop& EventLoopGroup::Next() {
+    return *loops_[next_.fetch_add(1, std::memory_order_relaxed) % loops_.size()];
+}
+
+} // namespace Benchmarks::Load
@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Benchmarks::Load {
+
+/**
+ * Receives readiness for one descriptor registered with an EventLoop.
+ * Called on the loop thread; must outlive its registration.
+ */
+class IEventHandler {
+public:
+    virtual ~IEventHandler() = default;
+    virtual void OnEvents(uint32_t events) = 0; // EPOLLIN, EPOLLOUT, EPOLLERR, ...
+};
+
+/**
+ * One epoll thread that many virtual clients share.
+ *
+ * Descriptors may be added, changed and removed from any thread. Posted
+ * tasks run on the loop thread after the events of the current wakeup.
+ */
+class EventLoop {
+public:
+    EventLoop();
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    bool Start();
+    // Joins the thread; registered descriptors are left to their owners
+    void Stop();
+
+    bool Add(int fd, uint32_t events, IEventHandler* handler);
+    bool Modify(int fd, uint32_t events, IEventHandler* handler);
+    void Remove(int fd);
+
+    void Post(std::function<void()> task);
+    bool IsInLoopThread() const;
+
+private:
+    static constexpr size_t MAX_EVENTS = 256;
+
+    void Run();
+    void RunPostedTasks();
+
+    int epoll_fd_ = -1;
+    int wake_fd_ = -1;
+
+    std::mutex tasks_mutex_;
+    std::vector<std::function<void()>> tasks_;
+
+    std::atomic<bool> stop_requested_{false};
+    std::thread thread_;
+    std::atomic<std::thread::id> loop_thread_id_{};
+};
+
+/**
+ * A fixed set of event loops; clients are spread over them round-robin
+ */
+class EventLoopGroup {
+public:
+    explicit EventLoopGroup(size_t loop_count);
+    ~EventLoopGroup();
+
+    bool Start();
+    void Stop();
+
+    EventLoop& Next();
+    EventLoop& At(size_t index) { return *loops_[index % loops_.size()]; }
+    size_t Size() const { return loops_.size(); }
+
+private:
+    std::vector<std::unique_ptr<EventLoop>> loops_;
+    std::atomic<size_t> next_{0};
+};
+
+} // namespace Benchmarks::Load
@@ -0,0 +1,48 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "load_generator.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace Benchmarks::Load {
+
+void RampAndHold(const LoadOptions& options, LoadReporter& reporter,
+                 const std::function<void(size_t)>& start_client) {
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    const auto end = start + options.duration;
+    const auto interval = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1.0 / std::max(options.connect_rate, 0.001)));
+    const auto due = [&](size_t client) { return start + interval * static_cast<int64_t>(client); };
+    auto next_report = start + options.report_interval;
+
+    reporter.PrintHeader();
+    size_t started = 0;
+    while (true) {
+        const auto now = Clock::now();
+        if (now >= end) {
+            break;
+        }
+        if (now >= next_report) {
+            reporter.PrintInterval();
+            next_report += options.report_interval;
+        }
+
+        // Catch up on every client that is due, so the rate holds even when
+        // the sleep below overshoots
+        while (started < options.clients && due(started) <= now) {
+            start_client(started++);
+        }
+
+        auto wake = std::min(end, next_report);
+        if (started < options.clients) {
+            wake = std::min(wake, due(started));
+        }
+        std::this_thread::sleep_until(wake);
+    }
+    reporter.PrintInterval();
+}
+
+} // namespace Benchmarks::Load
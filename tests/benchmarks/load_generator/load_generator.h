@@ -0,0 +1,75 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "event_loop.h"
+#include "load_metrics.h"
+
+namespace Benchmarks::Load {
+
+enum class Scenario {
+    Connect,   // Room server: connect, register and stay online
+    JoinLeave, // Room server: join a room, dwell, leave, repeat
+    Broadcast, // Room server: players of a room exchange p2p_info messages
+    Relay      // Relay server: session members exchange game-rate data
+};
+
+struct LoadOptions {
+    Scenario scenario = Scenario::Connect;
+    size_t clients = 100;
+    double connect_rate = 50.0; // New clients per second during ramp-up
+    size_t loops = 4;           // Event loop threads shared by all clients
+    std::chrono::seconds duration{30};
+    std::chrono::seconds report_interval{1};
+
+    std::string room_server_url = "ws://127.0.0.1:8080/ws";
+    std::string auth_token = "load-generator";
+    size_t room_size = 4; // Players per room, or per relay session (at most 8)
+    std::chrono::milliseconds dwell{2000};      // Time in a room per join-leave cycle
+    std::chrono::milliseconds send_interval{100}; // Broadcast period per player
+
+    // An empty host runs an in-process relay server on an ephemeral port
+    std::string relay_host;
+    uint16_t relay_port = 8443;
+    double packet_rate = 60.0; // Relay data packets per second per client
+    size_t payload_size = 64;
+
+    // Relay runs split over several generators, e.g. one per simulated
+    // region: this one runs the clients numbered first_client, first_client
+    // + client_stride and so on, and all of them pass the same
+    // session_token_base so members of a session find each other. With the
+    // generator count as the stride, every session spans generators. 0
+    // picks a random base.
+    size_t first_client = 0;
+    size_t client_stride = 1;
+    uint32_t session_token_base = 0;
+
+    // Prefix of the .hgrm files the latency histograms are written to at
+    // the end of the run; empty writes none
+    std::string histogram_prefix;
+};
+
+/**
+ * Calls start_client(i) for every client at options.connect_rate, then holds
+ * until options.duration has passed since the first one, printing a report
+ * line every options.report_interval.
+ */
+void RampAndHold(const LoadOptions& options, LoadReporter& reporter,
+                 const std::function<void(size_t)>& start_client);
+
+/**
+ * Ramps options.clients virtual clients up at options.connect_rate, drives
+ * the scenario until options.duration elapses, then disconnects them.
+ * Progress goes to stdout through a LoadReporter.
+ * @return False when the run could not start
+ */
+bool RunRoomLoad(const LoadOptions& options, EventLoopGroup& loops, LoadMetrics& metrics);
+bool RunRelayLoad(const LoadOptions& options, EventLoopGroup& loops, LoadMetrics& metrics);
+
+} // namespace Benchmarks::Load
@@ -0,0 +1,141 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// sudachi_multiplayer_load_generator: runs thousands of virtual players,
+// built on the real RoomClient and RelayClient, against a room or relay
+// server from a handful of event loop threads. Without --relay the relay
+// scenario runs an in-process RelayServer on the loopback.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include <sys/resource.h>
+
+#include "load_generator.h"
+
+using namespace Benchmarks::Load;
+
+namespace {
+
+void PrintUsage(const char* program) {
+    std::fprintf(stderr,
+                 "Usage: %s [--scenario connect|join-leave|broadcast|relay] [--clients N]\n"
+                 "          [--rate CLIENTS_PER_SECOND] [--loops N] [--duration SECONDS]\n"
+                 "          [--server ws://HOST:PORT/PATH] [--token TOKEN] [--room-size N]\n"
+                 "          [--dwell MS] [--send-interval MS] [--relay HOST:PORT]\n"
+                 "          [--packet-rate HZ] [--payload BYTES] [--first-client N]\n"
+                 "          [--client-stride N] [--token-base N] [--histogram-out PREFIX]\n",
+                 program);
+}
+
+bool ParseScenario(const std::string& name, Scenario& scenario) {
+    if (name == "connect") {
+        scenario = Scenario::Connect;
+    } else if (name == "join-leave") {
+        scenario = Scenario::JoinLeave;
+    } else if (name == "broadcast") {
+        scenario = Scenario::Broadcast;
+    } else if (name == "relay") {
+        scenario = Scenario::Relay;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool ParseArguments(int argc, char** argv, LoadOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string option = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (option == "--scenario" && has_value) {
+            if (!ParseScenario(argv[++i], options.scenario)) {
+                return false;
+            }
+        } else if (option == "--clients" && has_value) {
+            options.clients = std::strtoul(argv[++i], nullptr, 10);
+        } else if (option == "--rate" && has_value) {
+            options.connect_rate = std::max(std::strtod(argv[++i], nullptr), 0.1);
+        } else if (option == "--loops" && has_value) {
+            options.loops = std::max<size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+        } else if (option == "--duration" && has_value) {
+            options.duration = std::chrono::seconds(std::strtoul(argv[++i], nullptr, 10));
+        } else if (option == "--server" && has_value) {
+            options.room_server_url = argv[++i];
+        } else if (option == "--token" && has_value) {
+            options.auth_token = argv[++i];
+        } else if (option == "--room-size" && has_value) {
+            options.room_size = std::max<size_t>(2, std::strtoul(argv[++i], nullptr, 10));
+        } else if (option == "--dwell" && has_value) {
+            options.dwell = std::chrono::milliseconds(std::strtoul(argv[++i], nullptr, 10));
+        } else if (option == "--send-interval" && has_value) {
+            options.send_interval =
+                std::chrono::milliseconds(std::max(1ul, std::strtoul(argv[++i], nullptr, 10)));
+        } else if (option == "--relay" && has_value) {
+            const std::string endpoint = argv[++i];
+            const size_t colon = endpoint.rfind(':');
+            if (colon == std::string::npos) {
+                return false;
+            }
+            options.relay_host = endpoint.substr(0, colon);
+            options.relay_port =
+                static_cast<uint16_t>(std::strtoul(endpoint.c_str() + colon + 1, nullptr, 10));
+        } else if (option == "--packet-rate" && has_value) {
+            options.packet_rate = std::max(std::strtod(argv[++i], nullptr), 1.0);
+        } else if (option == "--payload" && has_value) {
+            options.payload_size = std::min<size_t>(std::strtoul(argv[++i], nullptr, 10), 1400);
+        } else if (option == "--first-client" && has_value) {
+            options.first_client = std::strtoul(argv[++i], nullptr, 10);
+        } else if (option == "--client-stride" && has_value) {
+            options.client_stride = std::max(1ul, std::strtoul(argv[++i], nullptr, 10));
+        } else if (option == "--token-base" && has_value) {
+            options.session_token_base = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+        } else if (option == "--histogram-out" && has_value) {
+            options.histogram_prefix = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    return options.clients > 0;
+}
+
+void RaiseDescriptorLimit(size_t needed) {
+    rlimit limit{};
+    if (::getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < needed) {
+        limit.rlim_cur = std::min<rlim_t>(limit.rlim_max, needed);
+        ::setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    LoadOptions options;
+    if (!ParseArguments(argc, argv, options)) {
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    // One socket per client, plus the in-process relay server's
+    RaiseDescriptorLimit(options.clients * 2 + 64);
+
+    EventLoopGroup loops(options.loops);
+    if (!loops.Start()) {
+        std::fprintf(stderr, "Could not start the event loops\n");
+        return EXIT_FAILURE;
+    }
+
+    LoadMetrics metrics;
+    const bool ran = options.scenario == Scenario::Relay
+                         ? RunRelayLoad(options, loops, metrics)
+                         : RunRoomLoad(options, loops, metrics);
+    if (!ran) {
+        return EXIT_FAILURE;
+    }
+    if (!options.histogram_prefix.empty() &&
+        !LoadReporter(metrics).WriteHistograms(options.histogram_prefix)) {
+        std::fprintf(stderr, "Could not write histograms to %s.*\n",
+                     options.histogram_prefix.c_str());
+    }
+    return LoadReporter(metrics).HasErrors() ? EXIT_FAILURE : EXIT_SUCCESS;
+}
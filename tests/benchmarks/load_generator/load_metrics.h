@@ -0,0 +1,268 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <utility>
+
+namespace Benchmarks::Load {
+
+/**
+ * Lock-free latency histogram in microseconds. Values below 64 have a bucket
+ * each; above that every power of two is split into 32 buckets, so a
+ * percentile is within about 3% of the true value. Thousands of clients
+ * record into one histogram without contending on a lock.
+ */
+class LatencyHistogram {
+public:
+    void Record(std::chrono::nanoseconds latency) {
+        const auto us = static_cast<uint64_t>(std::max<int64_t>(latency.count() / 1000, 0));
+        buckets_[BucketFor(us)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        uint64_t max = max_.load(std::memory_order_relaxed);
+        while (us > max && !max_.compare_exchange_weak(max, us, std::memory_order_relaxed)) {
+        }
+    }
+
+    uint64_t Count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t MaxMicros() const { return max_.load(std::memory_order_relaxed); }
+
+    // Lower bound of the bucket holding the given quantile (0..1)
+    uint64_t PercentileMicros(double quantile) const {
+        const uint64_t total = Count();
+        if (total == 0) {
+            return 0;
+        }
+        const auto rank = static_cast<uint64_t>(quantile * static_cast<double>(total - 1)) + 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            seen += buckets_[i].load(std::memory_order_relaxed);
+            if (seen >= rank) {
+                return LowerBound(i);
+            }
+        }
+        return MaxMicros();
+    }
+
+    /**
+     * Writes the percentile distribution in HdrHistogram's .hgrm text
+     * format, values in milliseconds, one row per non-empty bucket, so runs
+     * can be plotted and compared with the usual HdrHistogram tools
+     */
+    void WritePercentileDistribution(std::FILE* out) const {
+        std::fprintf(out, "%12s %14s %10s %14s\n\n", "Value", "Percentile", "TotalCount",
+                     "1/(1-Percentile)");
+        const uint64_t total = Count();
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKET_COUNT && seen < total; ++i) {
+            const uint64_t count = buckets_[i].load(std::memory_order_relaxed);
+            if (count == 0) {
+                continue;
+            }
+            seen += count;
+            const double percentile = static_cast<double>(seen) / static_cast<double>(total);
+            const double value = static_cast<double>(LowerBound(i)) / 1000.0;
+            if (seen < total) {
+                std::fprintf(out, "%12.3f %2.12f %10llu %14.2f\n", value, percentile,
+                             static_cast<unsigned long long>(seen), 1.0 / (1.0 - percentile));
+            } else {
+                std::fprintf(out, "%12.3f %2.12f %10llu\n", value, percentile,
+                             static_cast<unsigned long long>(seen));
+            }
+        }
+        std::fprintf(out, "#[Max     = %12.3f, Total count    = %12llu]\n",
+                     static_cast<double>(MaxMicros()) / 1000.0,
+                     static_cast<unsigned long long>(total));
+    }
+
+private:
+    static constexpr size_t LINEAR_BUCKETS = 64;
+    static constexpr size_t SUB_BUCKETS = 32;
+    static constexpr int MAX_EXPONENT = 40; // About 12 days; anything longer is clamped
+    static constexpr size_t BUCKET_COUNT = LINEAR_BUCKETS + (MAX_EXPONENT - 5) * SUB_BUCKETS;
+
+    static size_t BucketFor(uint64_t us) {
+        if (us < LINEAR_BUCKETS) {
+            return static_cast<size_t>(us);
+        }
+        const int exponent = std::min(63 - std::countl_zero(us), MAX_EXPONENT - 1);
+        const int shift = exponent - 5;
+        const size_t sub = static_cast<size_t>(us >> shift) & (SUB_BUCKETS - 1);
+        return LINEAR_BUCKETS + static_cast<size_t>(exponent - 6) * SUB_BUCKETS + sub;
+    }
+
+    static uint64_t LowerBound(size_t bucket) {
+        if (bucket < LINEAR_BUCKETS) {
+            return bucket;
+        }
+        const size_t group = (bucket - LINEAR_BUCKETS) / SUB_BUCKETS;
+        const size_t sub = (bucket - LINEAR_BUCKETS) % SUB_BUCKETS;
+        return static_cast<uint64_t>(SUB_BUCKETS + sub) << (group + 1);
+    }
+
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+/**
+ * Counters shared by every virtual client of a run
+ */
+struct LoadMetrics {
+    std::atomic<uint64_t> clients_started{0};
+    std::atomic<uint64_t> connects_succeeded{0};
+    std::atomic<uint64_t> connect_failures{0};
+    std::atomic<uint64_t> disconnects{0};
+    std::atomic<uint64_t> requests_sent{0};
+    std::atomic<uint64_t> requests_succeeded{0};
+    std::atomic<uint64_t> request_failures{0};
+    std::atomic<uint64_t> request_timeouts{0};
+    std::atomic<uint64_t> messages_sent{0};
+    std::atomic<uint64_t> messages_received{0};
+    std::atomic<uint64_t> send_failures{0};
+    // Relay: (member, peer) pairs of a session where the peer sent data the member never got
+    std::atomic<uint64_t> unheard_peers{0};
+
+    LatencyHistogram connect_latency;
+    LatencyHistogram request_latency;
+    LatencyHistogram message_latency;
+};
+
+/**
+ * Prints one line per interval with the rates since the previous line, and
+ * a summary with latency percentiles at the end of the run.
+ */
+class LoadReporter {
+public:
+    explicit LoadReporter(const LoadMetrics& metrics)
+        : metrics_(metrics), start_(std::chrono::steady_clock::now()), last_(start_) {}
+
+    void PrintHeader() const {
+        std::printf("%8s %8s %9s %8s %8s %9s %8s %10s %10s %9s\n", "time_s", "online",
+                    "conn/s", "c_fail", "drops", "req/s", "r_fail", "msg_tx/s", "msg_rx/s",
+                    "p99_ms");
+    }
+
+    void PrintInterval() {
+        const auto now = std::chrono::steady_clock::now();
+        const double seconds = std::chrono::duration<double>(now - last_).count();
+        const Snapshot current = Take();
+        const auto rate = [&](uint64_t Snapshot::*field) {
+            return seconds > 0 ? static_cast<double>(current.*field - previous_.*field) / seconds
+                               : 0.0;
+        };
+        std::printf("%8.1f %8llu %9.1f %8llu %8llu %9.1f %8llu %10.1f %10.1f %9.2f\n",
+                    std::chrono::duration<double>(now - start_).count(),
+                    static_cast<unsigned long long>(current.connects - current.disconnects),
+                    rate(&Snapshot::connects),
+                    static_cast<unsigned long long>(current.connect_failures),
+                    static_cast<unsigned long long>(current.disconnects), rate(&Snapshot::requests),
+                    static_cast<unsigned long long>(current.request_failures),
+                    rate(&Snapshot::messages_sent), rate(&Snapshot::messages_received),
+                    static_cast<double>(metrics_.request_latency.PercentileMicros(0.99)) / 1000.0);
+        std::fflush(stdout);
+        previous_ = current;
+        last_ = now;
+    }
+
+    void PrintSummary() const {
+        const double seconds =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+        const auto count = [](const std::atomic<uint64_t>& value) {
+            return static_cast<unsigned long long>(value.load(std::memory_order_relaxed));
+        };
+        std::printf("\nSummary after %.1f s\n", seconds);
+        std::printf("  clients started      %llu\n", count(metrics_.clients_started));
+        std::printf("  connected            %llu (%.1f/s)\n", count(metrics_.connects_succeeded),
+                    seconds > 0 ? static_cast<double>(count(metrics_.connects_succeeded)) / seconds
+                                : 0.0);
+        std::printf("  connect failures     %llu\n", count(metrics_.connect_failures));
+        std::printf("  unexpected drops     %llu\n", count(metrics_.disconnects));
+        std::printf("  requests             %llu ok, %llu failed, %llu timed out\n",
+                    count(metrics_.requests_succeeded), count(metrics_.request_failures),
+                    count(metrics_.request_timeouts));
+        std::printf("  messages             %llu sent, %llu received, %llu send failures\n",
+                    count(metrics_.messages_sent), count(metrics_.messages_received),
+                    count(metrics_.send_failures));
+        if (count(metrics_.unheard_peers) != 0) {
+            std::printf("  unheard peers        %llu\n", count(metrics_.unheard_peers));
+        }
+        PrintLatency("connect latency", metrics_.connect_latency);
+        PrintLatency("request latency", metrics_.request_latency);
+        PrintLatency("message latency", metrics_.message_latency);
+    }
+
+    // One <prefix>.<name>.hgrm file per histogram that has samples
+    bool WriteHistograms(const std::string& prefix) const {
+        const std::array<std::pair<const char*, const LatencyHistogram*>, 3> histograms{{
+            {"connect", &metrics_.connect_latency},
+            {"request", &metrics_.request_latency},
+            {"message", &metrics_.message_latency},
+        }};
+        for (const auto& [name, histogram] : histograms) {
+            if (histogram->Count() == 0) {
+                continue;
+            }
+            const std::string path = prefix + '.' + name + ".hgrm";
+            std::FILE* out = std::fopen(path.c_str(), "w");
+            if (out == nullptr) {
+                return false;
+            }
+            histogram->WritePercentileDistribution(out);
+            if (std::fclose(out) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool HasErrors() const {
+        return metrics_.connect_failures.load() != 0 || metrics_.request_failures.load() != 0 ||
+               metrics_.request_timeouts.load() != 0 || metrics_.unheard_peers.load() != 0;
+    }
+
+private:
+    struct Snapshot {
+        uint64_t connects = 0;
+        uint64_t connect_failures = 0;
+        uint64_t disconnects = 0;
+        uint64_t requests = 0;
+        uint64_t request_failures = 0;
+        uint64_t messages_sent = 0;
+        uint64_t messages_received = 0;
+    };
+
+    Snapshot Take() const {
+        return {metrics_.connects_succeeded.load(), metrics_.connect_failures.load(),
+                metrics_.disconnects.load(),        metrics_.requests_succeeded.load(),
+                metrics_.request_failures.load(),   metrics_.messages_sent.load(),
+                metrics_.messages_received.load()};
+    }
+
+    static void PrintLatency(const char* name, const LatencyHistogram& histogram) {
+        if (histogram.Count() == 0) {
+            return;
+        }
+        std::printf("  %-20s p50 %.2f ms, p90 %.2f ms, p99 %.2f ms, max %.2f ms (%llu samples)\n",
+                    name, static_cast<double>(histogram.PercentileMicros(0.50)) / 1000.0,
+                    static_cast<double>(histogram.PercentileMicros(0.90)) / 1000.0,
+                    static_cast<double>(histogram.PercentileMicros(0.99)) / 1000.0,
+                    static_cast<double>(histogram.MaxMicros()) / 1000.0,
+                    static_cast<unsigned long long>(histogram.Count()));
+    }
+
+    const LoadMetrics& metrics_;
+    const std::chrono::steady_clock::time_point start_;
+    std::chrono::steady_clock::time_point last_;
+    Snapshot previous_;
+};
+
+} // namespace Benchmarks::Load
@@ -0,0 +1,137 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "loop_relay_transport.h"
+
+#include <array>
+#include <cerrno>
+
+#include <netdb.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace Benchmarks::Load {
+
+using Core::Multiplayer::ModelA::RelayFrame;
+using Core::Multiplayer::ModelA::RelayHeader;
+
+namespace {
+constexpr size_t MAX_DATAGRAM_SIZE = 65535 + sizeof(RelayHeader);
+} // namespace
+
+LoopRelayTransport::~LoopRelayTransport() {
+    Close();
+}
+
+bool LoopRelayTransport::Open(const std::string& host, uint16_t port) {
+    Close();
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* addresses = nullptr;
+    const std::string service = std::to_string(port);
+    if (::getaddrinfo(host.c_str(), service.c_str(), &hints, &addresses) != 0 ||
+        addresses == nullptr) {
+        return false;
+    }
+
+    const int socket =
+        ::socket(addresses->ai_family, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    const bool connected =
+        socket >= 0 && ::connect(socket, addresses->ai_addr, addresses->ai_addrlen) == 0;
+    ::freeaddrinfo(addresses);
+    if (!connected) {
+        if (socket >= 0) {
+            ::close(socket);
+        }
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(socket_mutex_);
+    socket_ = socket;
+    return loop_.Add(socket_, EPOLLIN, this);
+}
+
+void LoopRelayTransport::Close() {
+    std::lock_guard<std::mutex> lock(socket_mutex_);
+    if (socket_ >= 0) {
+        loop_.Remove(socket_);
+        ::close(socket_);
+        socket_ = -1;
+    }
+}
+
+bool LoopRelayTransport::IsOpen() const {
+    std::lock_guard<std::mutex> lock(socket_mutex_);
+    return socket_ >= 0;
+}
+
+bool LoopRelayTransport::SendFrame(const RelayFrame& frame) {
+    iovec segments[3];
+    size_t segment_count = 0;
+    segments[segment_count++] = {const_cast<uint8_t*>(frame.header.data()), frame.header.size()};
+    if (!frame.payload.empty()) {
+        segments[segment_count++] = {const_cast<uint8_t*>(frame.payload.data()),
+                                     frame.payload.size()};
+    }
+    if (frame.trailer_size != 0) {
+        segments[segment_count++] = {const_cast<uint8_t*>(frame.trailer.data()),
+                                     frame.trailer_size};
+    }
+
+    msghdr message{};
+    message.msg_iov = segments;
+    message.msg_iovlen = segment_count;
+
+    std::lock_guard<std::mutex> lock(socket_mutex_);
+    if (socket_ < 0 || ::sendmsg(socket_, &message, MSG_DONTWAIT) < 0) {
+        send_errors_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+void LoopRelayTransport::SetOnDatagramReceived(DatagramCallback callback) {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    on_datagram_ = std::move(callback);
+}
+
+void LoopRelayTransport::OnEvents(uint32_t events) {
+    if ((events & EPOLLIN) == 0) {
+        return;
+    }
+
+    // Shared by every transport on this loop; one per transport would cost
+    // 64 KiB per virtual client
+    thread_local std::array<uint8_t, MAX_DATAGRAM_SIZE> buffer;
+
+    DatagramCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(callback_mutex_);
+        callback = on_datagram_;
+    }
+    while (true) {
+        ssize_t received;
+        {
+            std::lock_guard<std::mutex> lock(socket_mutex_);
+            if (socket_ < 0) {
+                return;
+            }
+            received = ::recv(socket_, buffer.data(), buffer.size(), MSG_DONTWAIT);
+        }
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return; // EAGAIN, or an ICMP error surfaced on the connected socket
+        }
+        if (callback) {
+            callback(std::span<const uint8_t>(buffer.data(), static_cast<size_t>(received)));
+        }
+    }
+}
+
+} // namespace Benchmarks::Load
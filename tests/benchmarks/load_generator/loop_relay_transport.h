@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "core/multiplayer/model_a/relay_transport.h"
+#include "event_loop.h"
+
+namespace Benchmarks::Load {
+
+/**
+ * UDP relay transport whose receive side runs on a shared EventLoop instead
+ * of a thread per transport. Sends use the same header-plus-payload
+ * scatter-gather write as UdpRelayTransport. Migration is not supported.
+ */
+class LoopRelayTransport final : public Core::Multiplayer::ModelA::IRelayTransport,
+                                 private IEventHandler {
+public:
+    explicit LoopRelayTransport(EventLoop& loop) : loop_(loop) {}
+    ~LoopRelayTransport() override;
+
+    LoopRelayTransport(const LoopRelayTransport&) = delete;
+    LoopRelayTransport& operator=(const LoopRelayTransport&) = delete;
+
+    bool Open(const std::string& host, uint16_t port) override;
+    void Close() override;
+    bool IsOpen() const override;
+    bool SendFrame(const Core::Multiplayer::ModelA::RelayFrame& frame) override;
+    void SetOnDatagramReceived(DatagramCallback callback) override;
+    bool Migrate() override { return false; }
+
+    uint64_t GetSendErrors() const { return send_errors_.load(std::memory_order_relaxed); }
+
+private:
+    void OnEvents(uint32_t events) override;
+
+    EventLoop& loop_;
+
+    mutable std::mutex socket_mutex_;
+    int socket_ = -1;
+
+    std::mutex callback_mutex_;
+    DatagramCallback on_datagram_;
+
+    std::atomic<uint64_t> send_errors_{0};
+};
+
+} // namespace Benchmarks::Load
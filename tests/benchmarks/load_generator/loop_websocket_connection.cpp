@@ -0,0 +1,565 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "loop_websocket_connection.h"
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace Benchmarks::Load {
+
+namespace {
+
+constexpr char BASE64_ALPHABET[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+std::string Base64(const uint8_t* data, size_t size) {
+    std::string out;
+    out.reserve((size + 2) / 3 * 4);
+    for (size_t i = 0; i < size; i += 3) {
+        const uint32_t chunk = (static_cast<uint32_t>(data[i]) << 16) |
+                               (i + 1 < size ? static_cast<uint32_t>(data[i + 1]) << 8 : 0) |
+                               (i + 2 < size ? static_cast<uint32_t>(data[i + 2]) : 0);
+        out += BASE64_ALPHABET[(chunk >> 18) & 0x3F];
+        out += BASE64_ALPHABET[(chunk >> 12) & 0x3F];
+        out += i + 1 < size ? BASE64_ALPHABET[(chunk >> 6) & 0x3F] : '=';
+        out += i + 2 < size ? BASE64_ALPHABET[chunk & 0x3F] : '=';
+    }
+    return out;
+}
+
+// ws://host[:port][/path]
+bool ParseUri(const std::string& uri, std::string& host, std::string& port, std::string& path) {
+    constexpr std::string_view SCHEME = "ws://";
+    if (uri.compare(0, SCHEME.size(), SCHEME) != 0) {
+        return false;
+    }
+    const size_t authority_start = SCHEME.size();
+    const size_t path_start = uri.find('/', authority_start);
+    const std::string authority = uri.substr(authority_start, path_start - authority_start);
+    if (authority.empty()) {
+        return false;
+    }
+    path = path_start == std::string::npos ? "/" : uri.substr(path_start);
+
+    // A bracketed IPv6 literal may contain colons of its own
+    const size_t host_end = authority.front() == '[' ? authority.find(']') : 0;
+    if (host_end == std::string::npos) {
+        return false;
+    }
+    const size_t colon = authority.find(':', host_end);
+    host = authority.substr(0, colon);
+    port = colon == std::string::npos ? "80" : authority.substr(colon + 1);
+    if (host.size() >= 2 && host.front() == '[') {
+        host = host.substr(1, host.size() - 2);
+    }
+    return !host.empty() && !port.empty();
+}
+
+} // namespace
+
+LoopWebSocketConnection::LoopWebSocketConnection(EventLoop& loop, uint64_t seed)
+    : loop_(loop), mask_state_(seed != 0 ? seed : reinterpret_cast<uintptr_t>(this) | 1) {}
+
+LoopWebSocketConnection::~LoopWebSocketConnection() {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if (socket_ >= 0) {
+        loop_.Remove(socket_);
+        ::close(socket_);
+        socket_ = -1;
+    }
+}
+
+void LoopWebSocketConnection::Connect(const std::string& uri) {
+    std::string host, port, path;
+    if (!ParseUri(uri, host, port, path)) {
+        loop_.Post([this, uri] { Fail("Unsupported WebSocket URI: " + uri); });
+        return;
+    }
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    if (::getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses) != 0 || addresses == nullptr) {
+        loop_.Post([this, host] { Fail("Could not resolve " + host); });
+        return;
+    }
+
+    std::string error;
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        if (state_ != State::Closed) {
+            ::freeaddrinfo(addresses);
+            return;
+        }
+        socket_ = ::socket(addresses->ai_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (socket_ < 0) {
+            error = std::string("socket: ") + std::strerror(errno);
+        } else {
+            const int one = 1;
+            ::setsockopt(socket_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            if (::connect(socket_, addresses->ai_addr, addresses->ai_addrlen) != 0 &&
+                errno != EINPROGRESS) {
+                error = std::string("connect: ") + std::strerror(errno);
+                ::close(socket_);
+                socket_ = -1;
+            }
+        }
+        if (error.empty()) {
+            uri_ = uri;
+            host_ = host + (port == "80" ? "" : ":" + port);
+            path_ = path;
+            state_ = State::Connecting;
+            write_buffer_.clear();
+            write_offset_ = 0;
+            want_write_ = false;
+            loop_.Add(socket_, EPOLLIN | EPOLLOUT, this);
+        }
+    }
+    ::freeaddrinfo(addresses);
+    if (!error.empty()) {
+        loop_.Post([this, error] { Fail(error); });
+    }
+}
+
+void LoopWebSocketConnection::Disconnect(const std::string& reason) {
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        if (state_ == State::Open) {
+            // Status 1000, best effort
+            const char status[] = {'\x03', '\xE8'};
+            QueueFrameLocked(OPCODE_CLOSE, status, sizeof(status));
+            FlushLocked();
+        }
+    }
+    CloseSocket(reason.empty() ? "Client disconnected" : reason, true);
+}
+
+bool LoopWebSocketConnection::IsConnected() const {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    return state_ == State::Open;
+}
+
+std::string LoopWebSocketConnection::GetUri() const {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    return uri_;
+}
+
+void LoopWebSocketConnection::SetAuthToken(const std::string& token) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    auth_token_ = token;
+}
+
+void LoopWebSocketConnection::SendMessage(const std::string& message) {
+    bool failed = false;
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        if (state_ != State::Open) {
+            return;
+        }
+        const bool json = !message.empty() && (message.front() == '{' || message.front() == '[');
+        QueueFrameLocked(json ? OPCODE_TEXT : OPCODE_BINARY, message.data(), message.size());
+        failed = !FlushLocked();
+    }
+    if (failed) {
+        loop_.Post([this] { Fail("Send failed"); });
+    }
+}
+
+void LoopWebSocketConnection::SetOnMessageCallback(
+    std::function<void(const std::string&)> callback) {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    on_message_ = std::move(callback);
+}
+
+void LoopWebSocketConnection::SetOnConnectCallback(std::function<void()> callback) {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    on_connect_ = std::move(callback);
+}
+
+void LoopWebSocketConnection::SetOnDisconnectCallback(
+    std::function<void(const std::string&)> callback) {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    on_disconnect_ = std::move(callback);
+}
+
+void LoopWebSocketConnection::SetOnErrorCallback(std::function<void(const std::string&)> callback) {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    on_error_ = std::move(callback);
+}
+
+void LoopWebSocketConnection::OnEvents(uint32_t events) {
+    State state;
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        state = state_;
+    }
+    if (state == State::Closed) {
+        return;
+    }
+
+    if (state == State::Connecting) {
+        if ((events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) == 0) {
+            return;
+        }
+        int error = 0;
+        socklen_t length = sizeof(error);
+        int fd;
+        {
+            std::lock_guard<std::mutex> lock(write_mutex_);
+            fd = socket_;
+        }
+        if (::getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length) != 0 || error != 0) {
+            Fail(std::string("connect: ") + std::strerror(error != 0 ? error : errno));
+            return;
+        }
+        OnConnected();
+        return;
+    }
+
+    if ((events & EPOLLOUT) != 0) {
+        bool failed;
+        {
+            std::lock_guard<std::mutex> lock(write_mutex_);
+            failed = !FlushLocked();
+        }
+        if (failed) {
+            Fail("Send failed");
+            return;
+        }
+    }
+    if ((events & (EPOLLIN | EPOLLHUP | EPOLLERR)) != 0) {
+        OnReadable();
+    }
+}
+
+void LoopWebSocketConnection::OnConnected() {
+    std::array<uint8_t, 16> nonce{};
+    bool failed;
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        for (auto& byte : nonce) {
+            mask_state_ ^= mask_state_ << 13;
+            mask_state_ ^= mask_state_ >> 7;
+            mask_state_ ^= mask_state_ << 17;
+            byte = static_cast<uint8_t>(mask_state_);
+        }
+        std::string request = "GET " + path_ + " HTTP/1.1\r\n"
+                              "Host: " + host_ + "\r\n"
+                              "Upgrade: websocket\r\n"
+                              "Connection: Upgrade\r\n"
+                              "Sec-WebSocket-Key: " + Base64(nonce.data(), nonce.size()) + "\r\n"
+                              "Sec-WebSocket-Version: 13\r\n";
+        if (!auth_token_.empty()) {
+            request += "Authorization: Bearer " + auth_token_ + "\r\n";
+        }
+        request += "\r\n";
+        write_buffer_.insert(write_buffer_.end(), request.begin(), request.end());
+        state_ = State::Handshaking;
+        failed = !FlushLocked();
+        if (!failed) {
+            UpdateInterestLocked();
+        }
+    }
+    if (failed) {
+        Fail("Handshake send failed");
+    }
+}
+
+void LoopWebSocketConnection::OnReadable() {
+    std::array<char, 65536> buffer;
+    int fd;
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        fd = socket_;
+    }
+    while (fd >= 0) {
+        const ssize_t size = ::recv(fd, buffer.data(), buffer.size(), MSG_DONTWAIT);
+        if (size > 0) {
+            read_buffer_.append(buffer.data(), static_cast<size_t>(size));
+            bytes_received_.fetch_add(static_cast<uint64_t>(size), std::memory_order_relaxed);
+            continue;
+        }
+        if (size == 0) {
+            CloseSocket("Connection closed by server", true);
+            return;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        }
+        if (errno != EINTR) {
+            Fail(std::string("recv: ") + std::strerror(errno));
+            return;
+        }
+    }
+
+    State state;
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        state = state_;
+    }
+    if (state == State::Handshaking && !ProcessHandshake()) {
+        return;
+    }
+    ProcessFrames();
+}
+
+bool LoopWebSocketConnection::ProcessHandshake() {
+    const size_t end = read_buffer_.find("\r\n\r\n");
+    if (end == std::string::npos) {
+        if (read_buffer_.size() > 16384) {
+            Fail("Oversized handshake response");
+        }
+        return false;
+    }
+    const size_t status_end = read_buffer_.find("\r\n");
+    const std::string status_line = read_buffer_.substr(0, status_end);
+    if (status_line.compare(0, 5, "HTTP/") != 0 || status_line.find(" 101") == std::string::npos) {
+        Fail("Upgrade refused: " + status_line);
+        return false;
+    }
+    read_buffer_.erase(0, end + 4);
+
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        state_ = State::Open;
+    }
+    std::function<void()> callback;
+    {
+        std::lock_guard<std::mutex> lock(callback_mutex_);
+        callback = on_connect_;
+    }
+    if (callback) {
+        callback();
+    }
+    return true;
+}
+
+bool LoopWebSocketConnection::ProcessFrames() {
+    size_t offset = 0;
+    while (read_buffer_.size() - offset >= 2) {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(read_buffer_.data() + offset);
+        const size_t available = read_buffer_.size() - offset;
+        const bool final = (bytes[0] & 0x80) != 0;
+        const uint8_t opcode = bytes[0] & 0x0F;
+        const bool masked = (bytes[1] & 0x80) != 0;
+        uint64_t length = bytes[1] & 0x7F;
+        size_t header = 2;
+        if (length == 126) {
+            if (available < 4) {
+                break;
+            }
+            length = (static_cast<uint64_t>(bytes[2]) << 8) | bytes[3];
+            header = 4;
+        } else if (length == 127) {
+            if (available < 10) {
+                break;
+            }
+            length = 0;
+            for (size_t i = 0; i < 8; ++i) {
+                length = (length << 8) | bytes[2 + i];
+            }
+            header = 10;
+        }
+        if (length > MAX_MESSAGE_SIZE) {
+            Fail("Frame too large");
+            return false;
+        }
+        const size_t mask_offset = header;
+        if (masked) {
+            header += 4;
+        }
+        if (available < header + length) {
+            break;
+        }
+
+        std::string payload(read_buffer_, offset + header, static_cast<size_t>(length));
+        if (masked) {
+            for (size_t i = 0; i < payload.size(); ++i) {
+                payload[i] = static_cast<char>(payload[i] ^ bytes[mask_offset + (i & 3)]);
+            }
+        }
+        offset += header + static_cast<size_t>(length);
+        HandleFrame(opcode, final, std::move(payload));
+
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        if (state_ != State::Open) {
+            read_buffer_.clear();
+            return false;
+        }
+    }
+    read_buffer_.erase(0, offset);
+    return true;
+}
+
+void LoopWebSocketConnection::HandleFrame(uint8_t opcode, bool final, std::string&& payload) {
+    if (opcode == OPCODE_CLOSE) {
+        {
+            std::lock_guard<std::mutex> lock(write_mutex_);
+            QueueFrameLocked(OPCODE_CLOSE, payload.data(), std::min<size_t>(payload.size(), 2));
+            FlushLocked();
+        }
+        CloseSocket("Closed by server", true);
+        return;
+    }
+    if (opcode == OPCODE_PING) {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        QueueFrameLocked(OPCODE_PONG, payload.data(), payload.size());
+        FlushLocked();
+        return;
+    }
+    if (opcode == OPCODE_PONG) {
+        return;
+    }
+
+    std::string message;
+    if (opcode == OPCODE_CONTINUATION) {
+        fragments_ += payload;
+        if (!final) {
+            return;
+        }
+        message = std::move(fragments_);
+        fragments_.clear();
+    } else if (!final) {
+        fragment_opcode_ = opcode;
+        fragments_ = std::move(payload);
+        return;
+    } else {
+        message = std::move(payload);
+    }
+
+    std::function<void(const std::string&)> callback;
+    {
+        std::lock_guard<std::mutex> lock(callback_mutex_);
+        callback = on_message_;
+    }
+    if (callback) {
+        callback(message);
+    }
+}
+
+void LoopWebSocketConnection::QueueFrameLocked(uint8_t opcode, const char* data, size_t size) {
+    write_buffer_.push_back(static_cast<uint8_t>(0x80 | opcode));
+    if (size < 126) {
+        write_buffer_.push_back(static_cast<uint8_t>(0x80 | size));
+    } else if (size <= 0xFFFF) {
+        write_buffer_.push_back(0x80 | 126);
+        write_buffer_.push_back(static_cast<uint8_t>(size >> 8));
+        write_buffer_.push_back(static_cast<uint8_t>(size));
+    } else {
+        write_buffer_.push_back(0x80 | 127);
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            write_buffer_.push_back(static_cast<uint8_t>(static_cast<uint64_t>(size) >> shift));
+        }
+    }
+
+    mask_state_ ^= mask_state_ << 13;
+    mask_state_ ^= mask_state_ >> 7;
+    mask_state_ ^= mask_state_ << 17;
+    std::array<uint8_t, 4> mask;
+    std::memcpy(mask.data(), &mask_state_, mask.size());
+    write_buffer_.insert(write_buffer_.end(), mask.begin(), mask.end());
+
+    const size_t start = write_buffer_.size();
+    write_buffer_.resize(start + size);
+    for (size_t i = 0; i < size; ++i) {
+        write_buffer_[start + i] = static_cast<uint8_t>(data[i] ^ mask[i & 3]);
+    }
+}
+
+bool LoopWebSocketConnection::FlushLocked() {
+    if (socket_ < 0) {
+        return false;
+    }
+    while (write_offset_ < write_buffer_.size()) {
+        const ssize_t sent = ::send(socket_, write_buffer_.data() + write_offset_,
+                                    write_buffer_.size() - write_offset_,
+                                    MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (sent > 0) {
+            write_offset_ += static_cast<size_t>(sent);
+            bytes_sent_.fetch_add(static_cast<uint64_t>(sent), std::memory_order_relaxed);
+            continue;
+        }
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            if (!want_write_) {
+                want_write_ = true;
+                UpdateInterestLocked();
+            }
+            return true;
+        }
+        return false;
+    }
+    write_buffer_.clear();
+    write_offset_ = 0;
+    if (want_write_) {
+        want_write_ = false;
+        UpdateInterestLocked();
+    }
+    return true;
+}
+
+void LoopWebSocketConnection::UpdateInterestLocked() {
+    if (socket_ >= 0) {
+        loop_.Modify(socket_, EPOLLIN | (want_write_ ? EPOLLOUT : 0u), this);
+    }
+}
+
+void LoopWebSocketConnection::Fail(const std::string& error) {
+    std::function<void(const std::string&)> callback;
+    {
+        std::lock_guard<std::mutex> lock(callback_mutex_);
+        callback = on_error_;
+    }
+    if (callback) {
+        callback(error);
+    }
+    CloseSocket(error, true);
+}
+
+void LoopWebSocketConnection::CloseSocket(const std::string& reason, bool notify) {
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        if (socket_ < 0) {
+            return;
+        }
+        loop_.Remove(socket_);
+        ::close(socket_);
+        socket_ = -1;
+        state_ = State::Closed;
+        write_buffer_.clear();
+        write_offset_ = 0;
+        want_write_ = false;
+    }
+    if (!notify) {
+        return;
+    }
+
+    // On the loop thread, so a disconnect from inside a callback does not reenter it
+    loop_.Post([this, reason] {
+        read_buffer_.clear();
+        fragments_.clear();
+        std::function<void(const std::string&)> callback;
+        {
+            std::lock_guard<std::mutex> lock(callback_mutex_);
+            callback = on_disconnect_;
+        }
+        if (callback) {
+            callback(reason);
+        }
+    });
+}
+
+} // namespace Benchmarks::Load
@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "core/multiplayer/model_a/i_websocket_connection.h"
+#include "event_loop.h"
+
+namespace Benchmarks::Load {
+
+/**
+ * Plain-TCP WebSocket client (ws:// only) driven by a shared EventLoop, so
+ * thousands of RoomClients can connect without a thread each.
+ *
+ * Implements the client side of RFC 6455 as far as a load generator needs:
+ * the upgrade handshake with a bearer token, masked outgoing frames,
+ * fragmented incoming messages, ping/pong and close. The server's
+ * Sec-WebSocket-Accept is not verified.
+ *
+ * Messages go out as text frames unless they start with a byte that JSON
+ * cannot, in which case they are binary (RoomClient's binary wire format).
+ * Callbacks run on the loop thread.
+ */
+class LoopWebSocketConnection final : public Core::Multiplayer::ModelA::IWebSocketConnection,
+                                      private IEventHandler {
+public:
+    explicit LoopWebSocketConnection(EventLoop& loop, uint64_t seed = 0);
+    ~LoopWebSocketConnection() override;
+
+    LoopWebSocketConnection(const LoopWebSocketConnection&) = delete;
+    LoopWebSocketConnection& operator=(const LoopWebSocketConnection&) = delete;
+
+    void Connect(const std::string& uri) override;
+    void Disconnect(const std::string& reason = "") override;
+    bool IsConnected() const override;
+    std::string GetUri() const override;
+
+    void SetAuthToken(const std::string& token) override;
+
+    void SendMessage(const std::string& message) override;
+    void SetOnMessageCallback(std::function<void(const std::string&)> callback) override;
+
+    void SetOnConnectCallback(std::function<void()> callback) override;
+    void SetOnDisconnectCallback(std::function<void(const std::string&)> callback) override;
+    void SetOnErrorCallback(std::function<void(const std::string&)> callback) override;
+
+    uint64_t GetBytesSent() const { return bytes_sent_.load(std::memory_order_relaxed); }
+    uint64_t GetBytesReceived() const { return bytes_received_.load(std::memory_order_relaxed); }
+
+private:
+    enum class State { Closed, Connecting, Handshaking, Open };
+
+    static constexpr uint8_t OPCODE_CONTINUATION = 0x0;
+    static constexpr uint8_t OPCODE_TEXT = 0x1;
+    static constexpr uint8_t OPCODE_BINARY = 0x2;
+    static constexpr uint8_t OPCODE_CLOSE = 0x8;
+    static constexpr uint8_t OPCODE_PING = 0x9;
+    static constexpr uint8_t OPCODE_PONG = 0xA;
+    static constexpr size_t MAX_MESSAGE_SIZE = 16 * 1024 * 1024;
+
+    void OnEvents(uint32_t events) override;
+    void OnConnected();
+    void OnReadable();
+    bool ProcessHandshake();
+    bool ProcessFrames();
+    void HandleFrame(uint8_t opcode, bool final, std::string&& payload);
+
+    // Callers hold write_mutex_
+    void QueueFrameLocked(uint8_t opcode, const char* data, size_t size);
+    bool FlushLocked();
+    void UpdateInterestLocked();
+
+    void Fail(const std::string& error);
+    void CloseSocket(const std::string& reason, bool notify);
+
+    EventLoop& loop_;
+    uint64_t mask_state_;
+
+    // Guards everything but the read side, which only the loop thread touches
+    mutable std::mutex write_mutex_;
+    int socket_ = -1;
+    State state_ = State::Closed;
+    std::string uri_;
+    std::string host_;
+    std::string path_;
+    std::string auth_token_;
+    std::vector<uint8_t> write_buffer_;
+    size_t write_offset_ = 0;
+    bool want_write_ = false;
+
+    std::string read_buffer_;
+    std::string fragments_;
+    uint8_t fragment_opcode_ = OPCODE_TEXT;
+
+    std::mutex callback_mutex_;
+    std::function<void(const std::string&)> on_message_;
+    std::function<void()> on_connect_;
+    std::function<void(const std::string&)> on_disconnect_;
+    std::function<void(const std::string&)> on_error_;
+
+    std::atomic<uint64_t> bytes_sent_{0};
+    std::atomic<uint64_t> bytes_received_{0};
+};
+
+} // namespace Benchmarks::Load
@@ -0,0 +1,349 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "common/timer_wheel.h"
+#include "load_generator.h"
+#include "loop_relay_transport.h"
+#include "model_a/relay_client.h"
+#include "relay_server/relay_server.h"
+
+namespace Benchmarks::Load {
+
+namespace {
+
+using Core::Multiplayer::ErrorCode;
+using Core::Multiplayer::TimerWheel;
+using Core::Multiplayer::ModelA::RelayClient;
+using Clock = std::chrono::steady_clock;
+
+// How long a member whose creator runs in another generator keeps retrying
+constexpr std::chrono::seconds REMOTE_JOIN_TIMEOUT{10};
+constexpr std::chrono::milliseconds JOIN_RETRY_INTERVAL{100};
+
+// The creator's session, which the other members join once the relay
+// accepted it
+struct RelaySession {
+    uint32_t session_token = 0;
+    std::atomic<bool> created{false};
+    // The creator runs in another generator, so created is never set here
+    bool remote_creator = false;
+};
+
+// Data payloads start with the send time, then the sender's node id
+constexpr size_t PAYLOAD_NODE_ID_OFFSET = sizeof(int64_t);
+
+/**
+ * One simulated relay peer: a real RelayClient whose datagram transport is
+ * serviced by a shared event loop. The first member of each session creates
+ * it and the others join; all of them then send timestamped data at the
+ * game rate. Each member announces its place in the session as its node id
+ * and records which peers it heard from.
+ */
+class VirtualRelayClient {
+public:
+    VirtualRelayClient(uint8_t node_id, const LoadOptions& options, EventLoop& loop,
+                       const std::string& host, uint16_t port, RelaySession& session,
+                       TimerWheel& scenario_timers, LoadMetrics& metrics,
+                       const std::atomic<bool>& stopping)
+        : node_id_(node_id), creator_(node_id == 0), options_(options), loop_(loop),
+          host_(host), port_(port), session_(session),
+          scenario_timers_(scenario_timers), metrics_(metrics), stopping_(stopping),
+          payload_(std::max(options.payload_size, PAYLOAD_NODE_ID_OFFSET + 1)),
+          relay_(std::make_unique<RelayClient>()) {
+        payload_[PAYLOAD_NODE_ID_OFFSET] = node_id_;
+    }
+
+    uint8_t GetNodeId() const { return node_id_; }
+    const RelaySession& GetSession() const { return session_; }
+    bool Joined() const { return joined_.load(std::memory_order_relaxed); }
+    bool SentData() const { return sent_data_.load(std::memory_order_relaxed); }
+    // Bit n is set once data from node n arrived
+    uint32_t GetHeardPeers() const { return heard_peers_.load(std::memory_order_relaxed); }
+
+    // On the loop thread
+    void Start() {
+        metrics_.clients_started.fetch_add(1, std::memory_order_relaxed);
+        auto transport = std::make_unique<LoopRelayTransport>(loop_);
+        if (!transport->Open(host_, port_)) {
+            metrics_.connect_failures.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        relay_->SetDatagramTransport(std::move(transport));
+        relay_->SetNodeId(node_id_);
+        relay_->SetOnDataReceived([this](const std::vector<uint8_t>& data) { OnData(data); });
+
+        relay_->ConnectAsync(options_.auth_token, [this](bool connected) {
+            if (!connected) {
+                metrics_.connect_failures.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            metrics_.connects_succeeded.fetch_add(1, std::memory_order_relaxed);
+            if (creator_) {
+                RequestSession(true);
+            } else if (session_.remote_creator) {
+                join_deadline_ = Clock::now() + REMOTE_JOIN_TIMEOUT;
+                RequestSession(false);
+            } else {
+                JoinWhenCreated();
+            }
+        });
+    }
+
+    void Stop() {
+        in_session_ = false;
+        relay_->Disconnect();
+    }
+
+    void OnSendTick() {
+        if (!in_session_.load(std::memory_order_relaxed)) {
+            return;
+        }
+        const int64_t now = Clock::now().time_since_epoch().count();
+        std::memcpy(payload_.data(), &now, sizeof(now));
+        if (relay_->SendData(payload_)) {
+            sent_data_.store(true, std::memory_order_relaxed);
+            metrics_.messages_sent.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            metrics_.send_failures.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    void JoinWhenCreated() {
+        if (session_.created.load(std::memory_order_acquire)) {
+            RequestSession(false);
+            return;
+        }
+        if (stopping_.load(std::memory_order_relaxed)) {
+            return;
+        }
+        scenario_timers_.Schedule(std::chrono::milliseconds{20}, [this] {
+            loop_.Post([this] { JoinWhenCreated(); });
+        });
+    }
+
+    // The remote creator may not have created the session yet
+    bool RetryJoin() {
+        if (creator_ || !session_.remote_creator || Clock::now() >= join_deadline_) {
+            return false;
+        }
+        scenario_timers_.Schedule(JOIN_RETRY_INTERVAL, [this] {
+            loop_.Post([this] {
+                if (!stopping_.load(std::memory_order_relaxed)) {
+                    RequestSession(false);
+                }
+            });
+        });
+        return true;
+    }
+
+    void RequestSession(bool create) {
+        metrics_.requests_sent.fetch_add(1, std::memory_order_relaxed);
+        const auto start = Clock::now();
+        // Answered on the loop thread, or on the wheel thread on timeout
+        auto on_done = [this, start, create](bool accepted, uint32_t) {
+            if (!accepted) {
+                // Disconnecting at the end of the run fails what is still pending
+                if (stopping_.load(std::memory_order_relaxed) || RetryJoin()) {
+                    return;
+                }
+                metrics_.request_failures.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            metrics_.requests_succeeded.fetch_add(1, std::memory_order_relaxed);
+            metrics_.request_latency.Record(Clock::now() - start);
+            if (create) {
+                session_.created.store(true, std::memory_order_release);
+            }
+            joined_ = true;
+            in_session_ = true;
+        };
+        if (create) {
+            relay_->CreateSessionAsync(session_.session_token, std::move(on_done));
+        } else {
+            relay_->JoinSessionAsync(session_.session_token, std::move(on_done));
+        }
+    }
+
+    void OnData(const std::vector<uint8_t>& data) {
+        metrics_.messages_received.fetch_add(1, std::memory_order_relaxed);
+        if (data.size() > PAYLOAD_NODE_ID_OFFSET && data[PAYLOAD_NODE_ID_OFFSET] < 32) {
+            heard_peers_.fetch_or(uint32_t{1} << data[PAYLOAD_NODE_ID_OFFSET],
+                                  std::memory_order_relaxed);
+        }
+        if (data.size() >= sizeof(int64_t)) {
+            int64_t sent;
+            std::memcpy(&sent, data.data(), sizeof(sent));
+            metrics_.message_latency.Record(Clock::now().time_since_epoch() -
+                                            Clock::duration{sent});
+        }
+    }
+
+    const uint8_t node_id_;
+    const bool creator_;
+    const LoadOptions& options_;
+    EventLoop& loop_;
+    const std::string& host_;
+    const uint16_t port_;
+    RelaySession& session_;
+    TimerWheel& scenario_timers_;
+    LoadMetrics& metrics_;
+    const std::atomic<bool>& stopping_;
+
+    std::vector<uint8_t> payload_; // Loop thread only
+    Clock::time_point join_deadline_{};
+    std::atomic<bool> in_session_{false};
+    std::atomic<bool> joined_{false};
+    std::atomic<bool> sent_data_{false};
+    std::atomic<uint32_t> heard_peers_{0};
+    std::unique_ptr<RelayClient> relay_;
+};
+
+/**
+ * Counts the (member, peer) pairs of a session where the peer sent data but
+ * the member never received any. Only this generator's clients are known,
+ * so across generators a session's remote members go unchecked.
+ */
+uint64_t CountUnheardPeers(const std::vector<std::unique_ptr<VirtualRelayClient>>& clients) {
+    std::unordered_map<const RelaySession*, uint32_t> senders;
+    for (const auto& client : clients) {
+        if (client && client->SentData()) {
+            senders[&client->GetSession()] |= uint32_t{1} << client->GetNodeId();
+        }
+    }
+    uint64_t unheard = 0;
+    for (const auto& client : clients) {
+        if (!client || !client->Joined()) {
+            continue;
+        }
+        const uint32_t expected =
+            senders[&client->GetSession()] & ~(uint32_t{1} << client->GetNodeId());
+        unheard += std::popcount(expected & ~client->GetHeardPeers());
+    }
+    return unheard;
+}
+
+struct LoopShard {
+    EventLoop* loop = nullptr;
+    std::vector<VirtualRelayClient*> clients;
+};
+
+} // namespace
+
+bool RunRelayLoad(const LoadOptions& options, EventLoopGroup& loops, LoadMetrics& metrics) {
+    std::string host = options.relay_host;
+    uint16_t port = options.relay_port;
+
+    std::unique_ptr<Core::Multiplayer::Relay::RelayServer> server;
+    if (host.empty()) {
+        Core::Multiplayer::Relay::RelayServerConfig config;
+        config.bind_address = "127.0.0.1";
+        config.port = 0;
+        config.pin_reactors = false;
+        config.max_sessions = options.clients;
+        // Every virtual client shares the loopback address
+        config.ddos.max_connections_per_ip = options.clients + 16;
+        config.ddos.max_total_connections = options.clients + 16;
+        config.rate_limits.packets_per_second =
+            std::max(config.rate_limits.packets_per_second, options.packet_rate * 4);
+        config.rate_limits.burst_capacity = config.rate_limits.packets_per_second * 2;
+        server = std::make_unique<Core::Multiplayer::Relay::RelayServer>(config);
+        if (server->Start() != ErrorCode::Success) {
+            std::fprintf(stderr, "Could not start the in-process relay server\n");
+            return false;
+        }
+        host = "127.0.0.1";
+        port = server->GetPort();
+        std::printf("In-process relay server on %s:%u\n", host.c_str(), port);
+    }
+
+    // Clients are numbered across every generator of the run; sessions are
+    // consecutive runs of session_size of them, the first one creating it
+    const size_t session_size = std::clamp<size_t>(
+        options.room_size, 1, Core::Multiplayer::Relay::RelaySessionTable::MAX_SESSION_PEERS);
+    const size_t stride = std::max<size_t>(options.client_stride, 1);
+    const auto number_of = [&](size_t index) { return options.first_client + index * stride; };
+    const auto is_local = [&](size_t number) {
+        return number >= options.first_client && (number - options.first_client) % stride == 0;
+    };
+    const size_t first_session = number_of(0) / session_size;
+    const size_t last_session = number_of(options.clients - 1) / session_size;
+    // Tokens differ between runs so a restarted generator does not collide
+    // with sessions the relay still remembers
+    const uint32_t token_base = options.session_token_base != 0
+                                    ? options.session_token_base
+                                    : std::random_device{}() & 0x7FFF0000u;
+    std::vector<std::unique_ptr<RelaySession>> sessions(last_session - first_session + 1);
+    for (size_t i = 0; i < sessions.size(); ++i) {
+        sessions[i] = std::make_unique<RelaySession>();
+        sessions[i]->session_token = token_base + static_cast<uint32_t>(first_session + i) + 1;
+        sessions[i]->remote_creator = !is_local((first_session + i) * session_size);
+    }
+    std::vector<LoopShard> shards(loops.Size());
+    for (size_t i = 0; i < shards.size(); ++i) {
+        shards[i].loop = &loops.At(i);
+    }
+
+    std::atomic<bool> stopping{false};
+    // Finer than the default tick so 60 Hz sends are not rounded to 50 Hz
+    TimerWheel scenario_timers(std::chrono::milliseconds{1});
+    std::vector<std::unique_ptr<VirtualRelayClient>> clients(options.clients);
+
+    const auto send_interval = std::chrono::milliseconds{
+        std::max<int64_t>(static_cast<int64_t>(1000.0 / std::max(options.packet_rate, 1.0)), 1)};
+    scenario_timers.ScheduleRepeating(send_interval, [&shards] {
+        for (auto& shard : shards) {
+            shard.loop->Post([&shard] {
+                for (auto* client : shard.clients) {
+                    client->OnSendTick();
+                }
+            });
+        }
+    });
+
+    LoadReporter reporter(metrics);
+    RampAndHold(options, reporter, [&](size_t index) {
+        auto& shard = shards[index % shards.size()];
+        const size_t number = number_of(index);
+        clients[index] = std::make_unique<VirtualRelayClient>(
+            static_cast<uint8_t>(number % session_size), options, *shard.loop, host, port,
+            *sessions[number / session_size - first_session], scenario_timers, metrics, stopping);
+        auto* client = clients[index].get();
+        shard.loop->Post([&shard, client] {
+            shard.clients.push_back(client);
+            client->Start();
+        });
+    });
+
+    stopping = true;
+    scenario_timers.Shutdown();
+    for (auto& shard : shards) {
+        shard.loop->Post([&shard] {
+            for (auto* client : shard.clients) {
+                client->Stop();
+            }
+        });
+    }
+    loops.Stop();
+    metrics.unheard_peers.store(CountUnheardPeers(clients), std::memory_order_relaxed);
+    reporter.PrintSummary();
+
+    clients.clear();
+    if (server) {
+        server->Stop();
+    }
+    return true;
+}
+
+} // namespace Benchmarks::Load
@@ -0,0 +1,442 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common/timer_wheel.h"
+#include "load_generator.h"
+#include "loop_websocket_connection.h"
+#include "model_a/room_client.h"
+
+namespace Benchmarks::Load {
+
+namespace {
+
+using namespace Core::Multiplayer::ModelA;
+using Core::Multiplayer::ErrorCode;
+using Core::Multiplayer::TimerWheel;
+using Clock = std::chrono::steady_clock;
+
+// The send time rides in the offer so the receiver can measure fan-out latency
+constexpr std::string_view TIMESTAMP_PREFIX = "t=";
+
+/**
+ * Settings for a virtual client. Reconnection is off so a dropped client
+ * shows up as a drop instead of quietly reconnecting.
+ */
+class LoadConfigProvider final : public IConfigProvider {
+public:
+    explicit LoadConfigProvider(const LoadOptions& options) : options_(options) {}
+
+    std::string GetRoomServerUrl() const override { return options_.room_server_url; }
+    std::string GetAuthToken() const override { return options_.auth_token; }
+    std::chrono::milliseconds GetConnectionTimeout() const override {
+        return std::chrono::seconds{10};
+    }
+    std::chrono::milliseconds GetHeartbeatInterval() const override {
+        return std::chrono::seconds{30};
+    }
+    std::chrono::milliseconds GetMessageTimeout() const override {
+        return std::chrono::seconds{10};
+    }
+    bool IsAutoReconnectEnabled() const override { return false; }
+    int GetMaxReconnectAttempts() const override { return 0; }
+    std::chrono::milliseconds GetReconnectBaseDelay() const override {
+        return std::chrono::seconds{1};
+    }
+    double GetReconnectBackoffMultiplier() const override { return 2.0; }
+    std::chrono::milliseconds GetMaxReconnectDelay() const override {
+        return std::chrono::seconds{30};
+    }
+    bool ShouldReconnectOnError(const std::string&) const override { return false; }
+    int GetMaxConcurrentMessages() const override { return 64; }
+    size_t GetMessageQueueSize() const override { return 1024; }
+
+private:
+    const LoadOptions& options_;
+};
+
+// The room created by a group's host, which the other members then join
+struct RoomGroup {
+    std::mutex mutex;
+    std::string room_id;
+};
+
+class VirtualRoomClient;
+
+// Forwards to the client without the RoomClient owning it
+class RoomLoadHandler final : public IMessageHandler {
+public:
+    explicit RoomLoadHandler(VirtualRoomClient& client) : client_(client) {}
+
+    void OnRoomCreated(const RoomCreatedResponse& response) override;
+    void OnRoomListUpdate(const RoomListResponse&) override {}
+    void OnJoinedRoom(const JoinRoomResponse& response) override;
+    void OnP2PInfoReceived(const P2PInfoMessage& message) override;
+    void OnUseProxyMessage(const UseProxyMessage&) override {}
+    void OnErrorReceived(const ErrorMessage& error) override;
+    void OnPlayerJoined(const PlayerJoinedMessage& message) override;
+    void OnPlayerLeft(const PlayerLeftMessage& message) override;
+    void OnRegistered(const RegisterResponse& response) override;
+    void OnRequestTimedOut(uint32_t request_id, MessageType request_type) override;
+
+private:
+    VirtualRoomClient& client_;
+};
+
+/**
+ * One simulated player. Everything but the request-timeout callback runs on
+ * the client's event loop thread; timers post back onto it.
+ */
+class VirtualRoomClient {
+public:
+    VirtualRoomClient(size_t index, const LoadOptions& options, EventLoop& loop,
+                      std::shared_ptr<IConfigProvider> config, RoomGroup& group,
+                      TimerWheel& scenario_timers, LoadMetrics& metrics,
+                      const std::atomic<bool>& stopping)
+        : index_(index), options_(options), loop_(loop), group_(group),
+          scenario_timers_(scenario_timers), metrics_(metrics), stopping_(stopping),
+          is_host_(index % std::max<size_t>(options.room_size, 1) == 0) {
+        connection_ = std::make_shared<LoopWebSocketConnection>(loop, index + 1);
+        client_ = std::make_unique<RoomClient>(connection_, std::move(config));
+        client_->SetMessageHandler(std::make_shared<RoomLoadHandler>(*this));
+        client_->SetOnConnectedCallback([this] { OnConnected(); });
+        client_->SetOnDisconnectedCallback(
+            [this](const std::string& reason) { OnDisconnected(reason); });
+    }
+
+    void Start() {
+        metrics_.clients_started.fetch_add(1, std::memory_order_relaxed);
+        connect_start_ = Clock::now();
+        if (client_->BeginConnect() != ErrorCode::Success) {
+            metrics_.connect_failures.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void Stop() {
+        if (connected_) {
+            client_->Disconnect();
+        }
+    }
+
+    // Broadcast scenario: one p2p_info to every other player of the room
+    void OnSendTick() {
+        if (!in_room_ || members_.empty()) {
+            return;
+        }
+        P2PInfoMessage message;
+        message.from_player = player_id_;
+        message.connection_type = "direct";
+        message.session_description.type = "offer";
+        message.session_description.sdp =
+            std::string(TIMESTAMP_PREFIX) +
+            std::to_string(Clock::now().time_since_epoch().count());
+        for (const auto& member : members_) {
+            message.to_player = member;
+            if (client_->SendP2PInfo(message) == ErrorCode::Success) {
+                metrics_.messages_sent.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                metrics_.send_failures.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void OnRegistered(const RegisterResponse& response) {
+        CompleteRequest(response.success);
+        if (!response.success || options_.scenario == Scenario::Connect) {
+            return;
+        }
+        player_id_ = response.client_id;
+        if (is_host_) {
+            CreateRoomRequest request;
+            request.game_name = "load-generator";
+            request.max_players = static_cast<int>(options_.room_size);
+            request.description = "load-" + std::to_string(index_);
+            BeginRequest();
+            if (client_->CreateRoom(request) != ErrorCode::Success) {
+                FailRequest();
+            }
+        } else {
+            JoinWhenRoomExists();
+        }
+    }
+
+    void OnRoomCreated(const RoomCreatedResponse& response) {
+        CompleteRequest(response.success);
+        if (!response.success) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(group_.mutex);
+            group_.room_id = response.room.id;
+        }
+        // The host stays put so the room outlives the members' churn
+        in_room_ = true;
+    }
+
+    void OnJoinedRoom(const JoinRoomResponse& response) {
+        CompleteRequest(response.success);
+        if (!response.success) {
+            After(options_.dwell, [this] { JoinWhenRoomExists(); });
+            return;
+        }
+        in_room_ = true;
+        if (!response.player_id.empty()) {
+            player_id_ = response.player_id;
+        }
+        members_.clear();
+        for (const auto& player : response.players) {
+            if (player.id != player_id_) {
+                members_.push_back(player.id);
+            }
+        }
+        if (options_.scenario == Scenario::JoinLeave) {
+            After(options_.dwell, [this] { LeaveRoom(); });
+        }
+    }
+
+    void OnPlayerJoined(const PlayerJoinedMessage& message) {
+        if (message.player.id != player_id_ &&
+            std::find(members_.begin(), members_.end(), message.player.id) == members_.end()) {
+            members_.push_back(message.player.id);
+        }
+    }
+
+    void OnPlayerLeft(const PlayerLeftMessage& message) {
+        std::erase(members_, message.player_id);
+    }
+
+    void OnP2PInfoReceived(const P2PInfoMessage& message) {
+        metrics_.messages_received.fetch_add(1, std::memory_order_relaxed);
+        const auto& sdp = message.session_description.sdp;
+        if (sdp.starts_with(TIMESTAMP_PREFIX)) {
+            const Clock::duration sent{std::stoll(sdp.substr(TIMESTAMP_PREFIX.size()))};
+            metrics_.message_latency.Record(Clock::now().time_since_epoch() - sent);
+        }
+    }
+
+    void OnErrorReceived(const ErrorMessage& error) {
+        if (error.request_id != 0) {
+            FailRequest();
+        }
+    }
+
+    void OnRequestTimedOut() {
+        metrics_.request_timeouts.fetch_add(1, std::memory_order_relaxed);
+    }
+
+private:
+    void OnConnected() {
+        connected_ = true;
+        metrics_.connects_succeeded.fetch_add(1, std::memory_order_relaxed);
+        metrics_.connect_latency.Record(Clock::now() - connect_start_);
+
+        RegisterRequest request;
+        request.username = "load-" + std::to_string(index_);
+        request.platform = "load-generator";
+        request.sudachi_version = "load";
+        BeginRequest();
+        if (client_->Register(request) != ErrorCode::Success) {
+            FailRequest();
+        }
+    }
+
+    void OnDisconnected(const std::string&) {
+        in_room_ = false;
+        if (stopping_.load(std::memory_order_relaxed)) {
+            return;
+        }
+        if (connected_) {
+            metrics_.disconnects.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            metrics_.connect_failures.fetch_add(1, std::memory_order_relaxed);
+        }
+        connected_ = false;
+    }
+
+    void JoinWhenRoomExists() {
+        std::string room_id;
+        {
+            std::lock_guard<std::mutex> lock(group_.mutex);
+            room_id = group_.room_id;
+        }
+        if (room_id.empty()) {
+            After(std::chrono::milliseconds{100}, [this] { JoinWhenRoomExists(); });
+            return;
+        }
+
+        JoinRoomRequest request;
+        request.room_id = room_id;
+        request.client_info.username = "load-" + std::to_string(index_);
+        request.client_info.platform = "load-generator";
+        BeginRequest();
+        if (client_->RequestJoinRoom(request) != ErrorCode::Success) {
+            FailRequest();
+        }
+    }
+
+    void LeaveRoom() {
+        // RoomClient::LeaveRoom only forgets the room locally
+        const std::string room_id = client_->GetCurrentRoomId();
+        client_->SendMessage("{\"type\":\"leave_room\",\"room_id\":\"" + room_id + "\"}");
+        client_->LeaveRoom();
+        in_room_ = false;
+        members_.clear();
+        After(options_.dwell, [this] { JoinWhenRoomExists(); });
+    }
+
+    void BeginRequest() {
+        request_start_ = Clock::now();
+        metrics_.requests_sent.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void CompleteRequest(bool success) {
+        if (!success) {
+            FailRequest();
+            return;
+        }
+        metrics_.requests_succeeded.fetch_add(1, std::memory_order_relaxed);
+        metrics_.request_latency.Record(Clock::now() - request_start_);
+    }
+
+    void FailRequest() {
+        metrics_.request_failures.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Runs the step on this client's loop thread after the delay
+    template <typename Step>
+    void After(std::chrono::milliseconds delay, Step step) {
+        if (stopping_.load(std::memory_order_relaxed)) {
+            return;
+        }
+        scenario_timers_.Schedule(delay, [this, step] {
+            loop_.Post([this, step] {
+                if (!stopping_.load(std::memory_order_relaxed) && connected_) {
+                    step();
+                }
+            });
+        });
+    }
+
+    const size_t index_;
+    const LoadOptions& options_;
+    EventLoop& loop_;
+    RoomGroup& group_;
+    TimerWheel& scenario_timers_;
+    LoadMetrics& metrics_;
+    const std::atomic<bool>& stopping_;
+    const bool is_host_;
+
+    std::shared_ptr<LoopWebSocketConnection> connection_;
+    std::unique_ptr<RoomClient> client_;
+
+    // Loop thread only
+    Clock::time_point connect_start_;
+    Clock::time_point request_start_;
+    bool connected_ = false;
+    bool in_room_ = false;
+    std::string player_id_;
+    std::vector<std::string> members_;
+};
+
+void RoomLoadHandler::OnRoomCreated(const RoomCreatedResponse& response) {
+    client_.OnRoomCreated(response);
+}
+void RoomLoadHandler::OnJoinedRoom(const JoinRoomResponse& response) {
+    client_.OnJoinedRoom(response);
+}
+void RoomLoadHandler::OnP2PInfoReceived(const P2PInfoMessage& message) {
+    client_.OnP2PInfoReceived(message);
+}
+void RoomLoadHandler::OnErrorReceived(const ErrorMessage& error) {
+    client_.OnErrorReceived(error);
+}
+void RoomLoadHandler::OnPlayerJoined(const PlayerJoinedMessage& message) {
+    client_.OnPlayerJoined(message);
+}
+void RoomLoadHandler::OnPlayerLeft(const PlayerLeftMessage& message) {
+    client_.OnPlayerLeft(message);
+}
+void RoomLoadHandler::OnRegistered(const RegisterResponse& response) {
+    client_.OnRegistered(response);
+}
+void RoomLoadHandler::OnRequestTimedOut(uint32_t, MessageType) {
+    client_.OnRequestTimedOut();
+}
+
+// The clients of one event loop, touched only on that loop's thread
+struct LoopShard {
+    EventLoop* loop = nullptr;
+    std::vector<VirtualRoomClient*> clients;
+};
+
+} // namespace
+
+bool RunRoomLoad(const LoadOptions& options, EventLoopGroup& loops, LoadMetrics& metrics) {
+    if (options.room_server_url.rfind("ws://", 0) != 0) {
+        std::fprintf(stderr, "Only ws:// room server URLs are supported\n");
+        return false;
+    }
+
+    const auto config = std::make_shared<LoadConfigProvider>(options);
+    const size_t room_size = std::max<size_t>(options.room_size, 1);
+    std::vector<std::unique_ptr<RoomGroup>> groups((options.clients + room_size - 1) / room_size);
+    for (auto& group : groups) {
+        group = std::make_unique<RoomGroup>();
+    }
+    std::vector<LoopShard> shards(loops.Size());
+    for (size_t i = 0; i < shards.size(); ++i) {
+        shards[i].loop = &loops.At(i);
+    }
+
+    std::atomic<bool> stopping{false};
+    TimerWheel scenario_timers;
+    std::vector<std::unique_ptr<VirtualRoomClient>> clients(options.clients);
+
+    if (options.scenario == Scenario::Broadcast) {
+        scenario_timers.ScheduleRepeating(options.send_interval, [&shards] {
+            for (auto& shard : shards) {
+                shard.loop->Post([&shard] {
+                    for (auto* client : shard.clients) {
+                        client->OnSendTick();
+                    }
+                });
+            }
+        });
+    }
+
+    LoadReporter reporter(metrics);
+    RampAndHold(options, reporter, [&](size_t index) {
+        auto& shard = shards[index % shards.size()];
+        clients[index] = std::make_unique<VirtualRoomClient>(
+            index, options, *shard.loop, config, *groups[index / room_size], scenario_timers,
+            metrics, stopping);
+        auto* client = clients[index].get();
+        shard.loop->Post([&shard, client] {
+            shard.clients.push_back(client);
+            client->Start();
+        });
+    });
+
+    stopping = true;
+    scenario_timers.Shutdown();
+    for (auto& shard : shards) {
+        shard.loop->Post([&shard] {
+            for (auto* client : shard.clients) {
+                client->Stop();
+            }
+        });
+    }
+    loops.Stop();
+    reporter.PrintSummary();
+    return true;
+}
+
+} // namespace Benchmarks::Load
@@ -0,0 +1,313 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <time.h>
+
+#include "core/multiplayer/common/datagram_socket.h"
+
+/**
+ * Loopback harness for end-to-end latency benchmarks.
+ *
+ * Unlike NetworkConditionSimulator, which sleeps inside mocks, traffic here
+ * goes through real UDP sockets. An ImpairedLink is a UDP proxy on the
+ * loopback that applies netem-style delay, jitter, loss, reordering and a
+ * bandwidth cap to everything passing through it, so it can be placed
+ * between any two real endpoints. Linux only; it waits with ppoll.
+ */
+
+namespace Benchmarks {
+
+using namespace std::chrono;
+
+// =============================================================================
+// Impairment Profiles
+// =============================================================================
+
+struct ImpairmentProfile {
+    const char* name = "ideal";
+    microseconds delay{0};
+    microseconds jitter{0};         // Uniform in [-jitter, +jitter], added to delay
+    double loss_rate = 0.0;
+    double reorder_rate = 0.0;      // Packets held back by reorder_delay so later ones overtake
+    microseconds reorder_delay{0};
+    uint64_t bandwidth_bps = 0;     // 0 for an uncapped link
+
+    // Longest a packet can spend on the link, excluding bandwidth queueing
+    microseconds MaxTransit() const { return delay + jitter + reorder_delay; }
+};
+
+// Applied to each direction of each link; the relay path crosses two links
+inline const std::array<ImpairmentProfile, 4> IMPAIRMENT_PROFILES = {{
+    {"ideal", 0us, 0us, 0.0, 0.0, 0us, 0},
+    {"lan", 500us, 100us, 0.0, 0.0, 0us, 100'000'000},
+    {"wifi", 3ms, 1500us, 0.01, 0.01, 2ms, 20'000'000},
+    {"wan", 20ms, 5ms, 0.02, 0.02, 5ms, 2'000'000},
+}};
+
+// =============================================================================
+// Impaired Link
+// =============================================================================
+
+struct ImpairedLinkStatistics {
+    uint64_t received = 0;
+    uint64_t forwarded = 0;
+    uint64_t dropped = 0;
+    uint64_t reordered = 0;
+};
+
+/**
+ * UDP proxy that impairs both directions independently.
+ *
+ * Endpoints send to GetPort() on the loopback; datagrams are forwarded from
+ * a socket connected to the upstream endpoint, and the upstream's replies
+ * go back to whichever endpoint sent last. One thread does all the work,
+ * releasing each datagram when it is due.
+ */
+class ImpairedLink {
+public:
+    ImpairedLink(const ImpairmentProfile& profile, uint32_t seed = 0x1eed)
+        : profile_(profile), random_(seed) {}
+
+    ~ImpairedLink() {
+        Stop();
+    }
+
+    ImpairedLink(const ImpairedLink&) = delete;
+    ImpairedLink& operator=(const ImpairedLink&) = delete;
+
+    bool Start(const Core::Multiplayer::DatagramEndpoint& upstream) {
+        using Core::Multiplayer::ErrorCode;
+        if (client_side_.Open("127.0.0.1", 0) != ErrorCode::Success ||
+            upstream_side_.Open("127.0.0.1", 0) != ErrorCode::Success ||
+            upstream_side_.Connect(upstream) != ErrorCode::Success) {
+            client_side_.Close();
+            upstream_side_.Close();
+            return false;
+        }
+        stop_ = false;
+        thread_ = std::thread([this] { Run(); });
+        return true;
+    }
+
+    void Stop() {
+        stop_ = true;
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+        client_side_.Close();
+        upstream_side_.Close();
+    }
+
+    uint16_t GetPort() const {
+        return client_side_.GetLocalEndpoint().Port();
+    }
+
+    ImpairedLinkStatistics GetStatistics() const {
+        std::lock_guard<std::mutex> lock(statistics_mutex_);
+        return statistics_;
+    }
+
+private:
+    struct Direction {
+        steady_clock::time_point next_free{}; // When the bandwidth cap frees the link
+    };
+
+    struct Pending {
+        steady_clock::time_point due;
+        uint64_t order = 0;
+        bool to_upstream = true;
+        std::vector<uint8_t> data;
+
+        bool operator>(const Pending& other) const {
+            return due != other.due ? due > other.due : order > other.order;
+        }
+    };
+
+    static constexpr size_t MAX_DATAGRAM_SIZE = 65536;
+    static constexpr microseconds IDLE_WAIT{2000};
+
+    void Run() {
+        std::vector<uint8_t> buffer(MAX_DATAGRAM_SIZE);
+        while (!stop_.load(std::memory_order_relaxed)) {
+            Wait();
+            Receive(client_side_, true, buffer);
+            Receive(upstream_side_, false, buffer);
+            Release();
+        }
+    }
+
+    // Sleeps until a socket is readable or the next datagram is due
+    void Wait() {
+        auto timeout = IDLE_WAIT;
+        if (!pending_.empty()) {
+            const auto until_due = duration_cast<microseconds>(pending_.top().due - steady_clock::now());
+            timeout = std::clamp(until_due, 0us, IDLE_WAIT);
+        }
+        std::array<pollfd, 2> descriptors{{
+            {static_cast<int>(client_side_.GetNativeHandle()), POLLIN, 0},
+            {static_cast<int>(upstream_side_.GetNativeHandle()), POLLIN, 0},
+        }};
+        const timespec wait{0, static_cast<long>(timeout.count()) * 1000};
+        ::ppoll(descriptors.data(), descriptors.size(), &wait, nullptr);
+    }
+
+    void Receive(Core::Multiplayer::DatagramSocket& socket, bool to_upstream,
+                 std::vector<uint8_t>& buffer) {
+        Core::Multiplayer::DatagramReceiveSlot slot;
+        slot.buffer = buffer.data();
+        slot.capacity = buffer.size();
+        while (socket.ReceiveBatch(&slot, 1) == 1) {
+            if (to_upstream) {
+                last_client_ = slot.from;
+            }
+            Schedule(to_upstream, slot.buffer, slot.size);
+            slot.size = 0;
+        }
+    }
+
+    void Schedule(bool to_upstream, const uint8_t* data, size_t size) {
+        std::lock_guard<std::mutex> lock(statistics_mutex_);
+        ++statistics_.received;
+        if (profile_.loss_rate > 0.0 && unit_(random_) < profile_.loss_rate) {
+            ++statistics_.dropped;
+            return;
+        }
+
+        auto& direction = to_upstream ? upstream_direction_ : client_direction_;
+        auto departure = steady_clock::now();
+        if (profile_.bandwidth_bps != 0) {
+            const auto serialization = nanoseconds(size * 8 * 1'000'000'000ULL / profile_.bandwidth_bps);
+            departure = std::max(departure, direction.next_free) + serialization;
+            direction.next_free = departure;
+        }
+
+        auto transit = profile_.delay;
+        if (profile_.jitter.count() > 0) {
+            std::uniform_int_distribution<int64_t> jitter(-profile_.jitter.count(),
+                                                          profile_.jitter.count());
+            transit = std::max(0us, transit + microseconds(jitter(random_)));
+        }
+        if (profile_.reorder_rate > 0.0 && unit_(random_) < profile_.reorder_rate) {
+            transit += profile_.reorder_delay;
+            ++statistics_.reordered;
+        }
+
+        pending_.push(Pending{departure + transit, next_order_++, to_upstream,
+                              std::vector<uint8_t>(data, data + size)});
+    }
+
+    void Release() {
+        const auto now = steady_clock::now();
+        while (!pending_.empty() && pending_.top().due <= now) {
+            const Pending& next = pending_.top();
+            Core::Multiplayer::OutgoingDatagram datagram;
+            datagram.data = next.data.data();
+            datagram.size = next.data.size();
+            size_t sent = 0;
+            if (next.to_upstream) {
+                sent = upstream_side_.SendBatch(&datagram, 1);
+            } else if (last_client_.IsValid()) {
+                datagram.to = &last_client_;
+                sent = client_side_.SendBatch(&datagram, 1);
+            }
+            {
+                std::lock_guard<std::mutex> lock(statistics_mutex_);
+                statistics_.forwarded += sent;
+            }
+            pending_.pop();
+        }
+    }
+
+    const ImpairmentProfile profile_;
+    std::mt19937 random_;
+    std::uniform_real_distribution<double> unit_{0.0, 1.0};
+
+    Core::Multiplayer::DatagramSocket client_side_;
+    Core::Multiplayer::DatagramSocket upstream_side_;
+    Core::Multiplayer::DatagramEndpoint last_client_;
+
+    // Only touched by the link thread
+    std::priority_queue<Pending, std::vector<Pending>, std::greater<Pending>> pending_;
+    uint64_t next_order_ = 0;
+    Direction upstream_direction_;
+    Direction client_direction_;
+
+    mutable std::mutex statistics_mutex_;
+    ImpairedLinkStatistics statistics_;
+
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
+
+// =============================================================================
+// Datagram Pump
+// =============================================================================
+
+/**
+ * Network thread for a backend: receives datagrams on a socket and hands
+ * them to a callback, which is where a backend's DeliverPacket is called.
+ * With timestamping enabled on the socket, the timestamped handler also
+ * gets the kernel's receive timestamps.
+ */
+class DatagramPump {
+public:
+    using Handler = std::function<void(const uint8_t* data, size_t size)>;
+    using TimestampedHandler = std::function<void(
+        const uint8_t* data, size_t size, const Core::Multiplayer::DatagramTimestamps& timestamps)>;
+
+    ~DatagramPump() {
+        Stop();
+    }
+
+    void Start(Core::Multiplayer::DatagramSocket& socket, Handler handler) {
+        Start(socket, [handler = std::move(handler)](
+                          const uint8_t* data, size_t size,
+                          const Core::Multiplayer::DatagramTimestamps&) { handler(data, size); });
+    }
+
+    void Start(Core::Multiplayer::DatagramSocket& socket, TimestampedHandler handler) {
+        stop_ = false;
+        thread_ = std::thread([this, &socket, handler = std::move(handler)] {
+            std::vector<uint8_t> buffer(65536);
+            Core::Multiplayer::DatagramReceiveSlot slot;
+            slot.buffer = buffer.data();
+            slot.capacity = buffer.size();
+            while (!stop_.load(std::memory_order_relaxed)) {
+                if (!socket.WaitReadable(milliseconds(5))) {
+                    continue;
+                }
+                while (socket.ReceiveBatch(&slot, 1) == 1) {
+                    handler(slot.buffer, slot.size, slot.timestamps);
+                }
+            }
+        });
+    }
+
+    void Stop() {
+        stop_ = true;
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+private:
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
+
+} // namespace Benchmarks
@@ -0,0 +1,60 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <string>
+
+#include "model_a/room_client.h"
+
+namespace Benchmarks {
+
+// Connection that never leaves the process; RoomClient only needs it to
+// register its callbacks
+class IdleWebSocketConnection : public Core::Multiplayer::ModelA::IWebSocketConnection {
+public:
+    void Connect(const std::string& uri) override { uri_ = uri; }
+    void Disconnect(const std::string&) override {}
+    bool IsConnected() const override { return true; }
+    std::string GetUri() const override { return uri_; }
+    void SetAuthToken(const std::string&) override {}
+    void SendMessage(const std::string&) override {}
+    void SetOnMessageCallback(std::function<void(const std::string&)>) override {}
+    void SetOnConnectCallback(std::function<void()>) override {}
+    void SetOnDisconnectCallback(std::function<void(const std::string&)>) override {}
+    void SetOnErrorCallback(std::function<void(const std::string&)>) override {}
+
+private:
+    std::string uri_ = "wss://rooms.example.invalid";
+};
+
+class StaticConfig : public Core::Multiplayer::ModelA::IConfigProvider {
+public:
+    std::string GetRoomServerUrl() const override { return "wss://rooms.example.invalid"; }
+    std::string GetAuthToken() const override { return "token"; }
+    std::chrono::milliseconds GetConnectionTimeout() const override {
+        return std::chrono::milliseconds(5000);
+    }
+    std::chrono::milliseconds GetHeartbeatInterval() const override {
+        return std::chrono::milliseconds(30000);
+    }
+    std::chrono::milliseconds GetMessageTimeout() const override {
+        return std::chrono::milliseconds(10000);
+    }
+    bool IsAutoReconnectEnabled() const override { return false; }
+    int GetMaxReconnectAttempts() const override { return 0; }
+    std::chrono::milliseconds GetReconnectBaseDelay() const override {
+        return std::chrono::milliseconds(1000);
+    }
+    double GetReconnectBackoffMultiplier() const override { return 2.0; }
+    std::chrono::milliseconds GetMaxReconnectDelay() const override {
+        return std::chrono::milliseconds(30000);
+    }
+    bool ShouldReconnectOnError(const std::string&) const override { return false; }
+    int GetMaxConcurrentMessages() const override { return 64; }
+    size_t GetMessageQueueSize() const override { return 1024; }
+};
+
+} // namespace Benchmarks
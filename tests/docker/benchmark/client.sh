@@ -0,0 +1,12 @@
+#!/bin/sh
+# SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+# SPDX-License-Identifier: GPL-3.0-or-later
+
+# Sends the generator's traffic through its region gateway, then runs it
+# as client FIRST_CLIENT of a numbering shared with the other regions
+set -eu
+
+ip route replace default via "$GATEWAY"
+mkdir -p "$(dirname "$HISTOGRAM_PREFIX")"
+exec sudachi_multiplayer_load_generator --first-client "${FIRST_CLIENT:-0}" \
+    --histogram-out "$HISTOGRAM_PREFIX" "$@"
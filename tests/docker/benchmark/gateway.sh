@@ -0,0 +1,61 @@
+#!/bin/sh
+# SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+# SPDX-License-Identifier: GPL-3.0-or-later
+
+# Region gateway: routes its region's generators onto the core network
+# behind a NAT and shapes both directions of the link with netem.
+#
+#   REGION_SUBNET  region network, e.g. 10.30.1.0/24
+#   CORE_SUBNET    network the relay server is on
+#   NAT_TYPE       cone (port-preserving masquerade) or symmetric
+#                  (a random port for every flow)
+#   DELAY_MS       one-way delay added in each direction
+#   JITTER_MS      normally distributed jitter around DELAY_MS
+#   LOSS_PERCENT   random loss in each direction
+#   RATE           link rate, e.g. 100mbit; empty for unlimited
+set -eu
+
+interface_for() {
+    # First interface with an address inside the given /24
+    prefix=$(echo "$1" | cut -d. -f1-3)
+    ip -o -4 addr show | awk -v prefix="$prefix." 'index($4, prefix) == 1 { print $2; exit }'
+}
+
+REGION_IF=$(interface_for "$REGION_SUBNET")
+CORE_IF=$(interface_for "$CORE_SUBNET")
+if [ -z "$REGION_IF" ] || [ -z "$CORE_IF" ]; then
+    echo "gateway: cannot find region or core interface" >&2
+    exit 1
+fi
+
+case "${NAT_TYPE:-cone}" in
+cone)
+    # Linux keeps the source port when it is free and reuses one mapping per
+    # source, which clients see as a port-restricted cone
+    iptables -t nat -A POSTROUTING -s "$REGION_SUBNET" -o "$CORE_IF" -j MASQUERADE
+    ;;
+symmetric)
+    iptables -t nat -A POSTROUTING -s "$REGION_SUBNET" -o "$CORE_IF" -j MASQUERADE --random-fully
+    ;;
+*)
+    echo "gateway: unknown NAT_TYPE $NAT_TYPE" >&2
+    exit 1
+    ;;
+esac
+
+shape() {
+    netem="delay ${DELAY_MS:-0}ms ${JITTER_MS:-0}ms distribution normal loss ${LOSS_PERCENT:-0}%"
+    if [ -n "${RATE:-}" ]; then
+        netem="$netem rate $RATE"
+    fi
+    # shellcheck disable=SC2086
+    tc qdisc replace dev "$1" root netem $netem limit 100000
+}
+shape "$CORE_IF"
+shape "$REGION_IF"
+
+echo "gateway: $REGION_SUBNET via $CORE_IF, nat ${NAT_TYPE:-cone}," \
+     "${DELAY_MS:-0}±${JITTER_MS:-0}ms one way, ${LOSS_PERCENT:-0}% loss"
+trap 'exit 0' TERM INT
+sleep infinity &
+wait
@@ -0,0 +1,83 @@
+#!/usr/bin/env bash
+# SPDX-FileCopyrightText: 2025 Sudachi Emulator Project
+# SPDX-License-Identifier: GPL-3.0-or-later
+
+# Sweeps the multi-region topology over session sizes and session counts.
+# Each run gets its own directory under RESULTS_DIR with the generators'
+# .hgrm latency histograms and logs, the relay server log, and relay
+# server CPU and memory sampled once a second.
+#
+#   SESSION_SIZES   players per session to sweep (default "2 4 8")
+#   SESSION_COUNTS  sessions to sweep (default "10 100 1000 10000")
+#   DURATION        seconds each run sends traffic (default 30)
+#
+# Everything else docker-compose.bench.yml reads (region delays, NAT
+# types, PACKET_RATE, RELAY_REACTORS, ...) is passed through.
+set -euo pipefail
+
+cd "$(dirname "$0")"
+
+SESSION_SIZES=${SESSION_SIZES:-"2 4 8"}
+SESSION_COUNTS=${SESSION_COUNTS:-"10 100 1000 10000"}
+REGIONS=3
+export RESULTS_DIR=${RESULTS_DIR:-$PWD/results/$(date +%Y%m%d-%H%M%S)}
+export DURATION=${DURATION:-30}
+
+COMPOSE=(docker compose -f docker-compose.bench.yml -p sudachi-bench)
+GENERATORS=(generator-na generator-eu generator-ap)
+
+mkdir -p "$RESULTS_DIR"
+"${COMPOSE[@]}" build relay-server
+
+sample_relay() {
+    local out=$1
+    echo "time,cpu,memory" >"$out"
+    while true; do
+        docker stats --no-stream --format '{{.CPUPerc}},{{.MemUsage}}' \
+            "$("${COMPOSE[@]}" ps -q relay-server)" 2>/dev/null |
+            sed "s/^/$(date +%s),/" >>"$out" || true
+        sleep 1
+    done
+}
+
+run() {
+    local size=$1 sessions=$2
+    export SESSION_SIZE=$size
+    export CLIENTS_PER_REGION=$(((sessions * size + REGIONS - 1) / REGIONS))
+    export RUN_ID="size${size}-sessions${sessions}"
+    # Fresh session tokens per run so a slow teardown cannot collide
+    export TOKEN_BASE=$((0x10000 + RANDOM * 0x10000))
+    local dir=$RESULTS_DIR/$RUN_ID
+    mkdir -p "$dir"
+    echo "== $RUN_ID: $((CLIENTS_PER_REGION * REGIONS)) clients"
+
+    "${COMPOSE[@]}" up -d relay-server gateway-na gateway-eu gateway-ap
+    sample_relay "$dir/relay_stats.csv" &
+    local sampler=$!
+
+    # Non-zero when any generator saw a failed connect or request
+    local status=0
+    "${COMPOSE[@]}" up -d --no-deps "${GENERATORS[@]}"
+    for service in "${GENERATORS[@]}"; do
+        local code
+        code=$(docker wait "$("${COMPOSE[@]}" ps -aq "$service")")
+        [ "$code" = 0 ] || status=$code
+    done
+
+    kill "$sampler" 2>/dev/null || true
+    wait "$sampler" 2>/dev/null || true
+    for service in "${GENERATORS[@]}"; do
+        "${COMPOSE[@]}" logs --no-color "$service" >"$dir/$service.log"
+    done
+    "${COMPOSE[@]}" logs --no-color relay-server >"$dir/relay-server.log"
+    "${COMPOSE[@]}" down --remove-orphans >/dev/null
+    echo "$status" >"$dir/exit_status"
+}
+
+for size in $SESSION_SIZES; do
+    for sessions in $SESSION_COUNTS; do
+        run "$size" "$sessions"
+    done
+done
+
+echo "Results in $RESULTS_DIR"
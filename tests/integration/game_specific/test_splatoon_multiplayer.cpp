@@ -18,7 +18,7 @@ TEST(SplatoonMultiplayerTest, MapsSecurityAndVersionFields) {
     internal.node_count_max = 8;
     internal.link_level = 0;
     internal.network_mode = static_cast<uint8_t>(Service::LDN::PackedNetworkType::Ldn);
-    internal.session_id = std::vector<uint8_t>(sizeof(Service::LDN::SessionId), 0x42);
+    internal.session_id.assign(sizeof(Service::LDN::SessionId), 0x42);
     internal.security_mode = static_cast<uint8_t>(Service::LDN::SecurityMode::Retail);
     internal.local_communication_version = 0x0102;
     internal.nodes.push_back({0, "Host", {0,0,0,0,0,0}, {0,0,0,0}, true, internal.local_communication_version});
@@ -0,0 +1,209 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "allocation_counter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+
+#if __has_include(<execinfo.h>)
+#include <execinfo.h>
+#define SUDACHI_ALLOCATION_COUNTER_BACKTRACE 1
+#endif
+
+namespace Core::Multiplayer::Test {
+
+namespace {
+
+std::atomic<uint64_t> allocation_count{0};
+std::atomic<size_t> next_site{0};
+std::array<AllocationSite, AllocationCounter::MAX_RECORDED_SITES> sites;
+
+thread_local int scope_depth = 0;
+// Set while recording, so allocations made by the recorder are not counted
+thread_local bool recording = false;
+
+#ifdef SUDACHI_ALLOCATION_COUNTER_BACKTRACE
+// The first backtrace() loads the unwinder, which allocates; do it up front
+const int backtrace_warmup = [] {
+    void* frame = nullptr;
+    return backtrace(&frame, 1);
+}();
+#endif
+
+void RecordAllocation(size_t size) {
+    if (scope_depth == 0 || recording) {
+        return;
+    }
+    recording = true;
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    const size_t index = next_site.fetch_add(1, std::memory_order_relaxed);
+    if (index < sites.size()) {
+        AllocationSite& site = sites[index];
+        site.size = size;
+#ifdef SUDACHI_ALLOCATION_COUNTER_BACKTRACE
+        site.stack_depth = static_cast<size_t>(
+            backtrace(site.stack.data(), static_cast<int>(site.stack.size())));
+#endif
+    }
+    recording = false;
+}
+
+void* Allocate(size_t size) {
+    RecordAllocation(size);
+    void* const pointer = std::malloc(size != 0 ? size : 1);
+    if (pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* AllocateAligned(size_t size, std::align_val_t alignment) {
+    RecordAllocation(size);
+    void* pointer = nullptr;
+#ifdef _WIN32
+    pointer = _aligned_malloc(size != 0 ? size : 1, static_cast<size_t>(alignment));
+#else
+    if (posix_memalign(&pointer, std::max(static_cast<size_t>(alignment), sizeof(void*)),
+                       size != 0 ? size : 1) != 0) {
+        pointer = nullptr;
+    }
+#endif
+    if (pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void FreeAligned(void* pointer) {
+#ifdef _WIN32
+    _aligned_free(pointer);
+#else
+    std::free(pointer);
+#endif
+}
+
+} // namespace
+
+AllocationCounter::Scope::Scope() {
+    ++scope_depth;
+}
+
+AllocationCounter::Scope::~Scope() {
+    --scope_depth;
+}
+
+uint64_t AllocationCounter::GetCount() {
+    return allocation_count.load(std::memory_order_relaxed);
+}
+
+size_t AllocationCounter::GetRecordedSiteCount() {
+    return std::min(next_site.load(std::memory_order_relaxed), sites.size());
+}
+
+const AllocationSite& AllocationCounter::GetRecordedSite(size_t index) {
+    return sites[index];
+}
+
+std::string AllocationCounter::Describe() {
+    std::ostringstream out;
+    out << GetCount() << " allocation(s) in scope";
+    for (size_t i = 0; i < GetRecordedSiteCount(); ++i) {
+        const AllocationSite& site = sites[i];
+        out << "\n#" << i << ": " << site.size << " bytes";
+#ifdef SUDACHI_ALLOCATION_COUNTER_BACKTRACE
+        // Skip the recorder itself; how many of the frames above it are
+        // operator new depends on inlining
+        constexpr size_t SKIPPED_FRAMES = 1;
+        if (site.stack_depth > SKIPPED_FRAMES) {
+            char** const symbols =
+                backtrace_symbols(site.stack.data() + SKIPPED_FRAMES,
+                                  static_cast<int>(site.stack_depth - SKIPPED_FRAMES));
+            for (size_t frame = 0; symbols && frame < site.stack_depth - SKIPPED_FRAMES;
+                 ++frame) {
+                out << "\n    " << symbols[frame];
+            }
+            std::free(symbols);
+        }
+#endif
+    }
+    return out.str();
+}
+
+void AllocationCounter::Reset() {
+    allocation_count.store(0, std::memory_order_relaxed);
+    next_site.store(0, std::memory_order_relaxed);
+}
+
+} // namespace Core::Multiplayer::Test
+
+using Core::Multiplayer::Test::Allocate;
+using Core::Multiplayer::Test::AllocateAligned;
+using Core::Multiplayer::Test::FreeAligned;
+
+void* operator new(size_t size) {
+    return Allocate(size);
+}
+
+void* operator new[](size_t size) {
+    return Allocate(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return Allocate(size);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return Allocate(size);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    return AllocateAligned(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return AllocateAligned(size, alignment);
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept {
+    FreeAligned(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept {
+    FreeAligned(pointer);
+}
+
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept {
+    FreeAligned(pointer);
+}
+
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept {
+    FreeAligned(pointer);
+}
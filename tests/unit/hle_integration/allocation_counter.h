@@ -0,0 +1,60 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Core::Multiplayer::Test {
+
+/**
+ * A heap allocation made while an AllocationCounter::Scope was open
+ */
+struct AllocationSite {
+    static constexpr size_t MAX_STACK_DEPTH = 16;
+
+    size_t size = 0;
+    // Return addresses where the platform can walk the stack, else empty
+    std::array<void*, MAX_STACK_DEPTH> stack{};
+    size_t stack_depth = 0;
+};
+
+/**
+ * Counts heap allocations on the paths a test wants to keep allocation
+ * free.
+ *
+ * Linking allocation_counter.cpp into a test or benchmark binary replaces
+ * the global operator new and delete with versions that count every
+ * allocation made by a thread inside a Scope, and keep the size and stack
+ * of the first few. Allocations outside a Scope, or on other threads, pass
+ * through untouched, so setup and background work stay free to allocate.
+ */
+class AllocationCounter {
+public:
+    static constexpr size_t MAX_RECORDED_SITES = 8;
+
+    // Counts allocations made by this thread while alive
+    class Scope {
+    public:
+        Scope();
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    // Allocations counted since the last Reset()
+    static uint64_t GetCount();
+    static size_t GetRecordedSiteCount();
+    static const AllocationSite& GetRecordedSite(size_t index);
+
+    // The recorded sites with symbolized stacks, for a failure message
+    static std::string Describe();
+
+    static void Reset();
+};
+
+} // namespace Core::Multiplayer::Test
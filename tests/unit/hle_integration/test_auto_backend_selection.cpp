@@ -0,0 +1,68 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "core/multiplayer/backend_factory.h"
+
+namespace Core::Multiplayer::HLE {
+
+namespace {
+
+using namespace std::chrono_literals;
+using BackendType = BackendFactory::BackendType;
+
+// Availability checks answered after a delay, as the real ones touch the
+// network and the permission system; called from pool threads
+class SlowConfiguration : public ConfigurationManager {
+public:
+    SlowConfiguration(bool model_a_available, bool model_b_available)
+        : model_a_available_(model_a_available), model_b_available_(model_b_available) {}
+
+    MultiplayerMode GetPreferredMode() override {
+        return MultiplayerMode::Auto;
+    }
+    void SetPreferredMode(MultiplayerMode) override {}
+    bool IsModelAAvailable() override {
+        std::this_thread::sleep_for(50ms);
+        return model_a_available_;
+    }
+    bool IsModelBAvailable() override {
+        std::this_thread::sleep_for(50ms);
+        return model_b_available_;
+    }
+    std::string GetConfigFilePath() override {
+        return {};
+    }
+
+private:
+    const bool model_a_available_;
+    const bool model_b_available_;
+};
+
+} // namespace
+
+TEST(AutoBackendSelectionTest, AdHocIsPickedOnceItsCheckPasses) {
+    auto factory = CreateBackendFactory(std::make_shared<SlowConfiguration>(true, true));
+
+    // Answered before the checks finish
+    EXPECT_EQ(factory->GetPreferredBackend(), BackendType::ModelA_Internet);
+    EXPECT_FALSE(factory->IsPreferredBackendSettled());
+
+    EXPECT_EQ(factory->WaitForPreferredBackend(), BackendType::ModelB_AdHoc);
+    EXPECT_TRUE(factory->IsPreferredBackendSettled());
+    EXPECT_EQ(factory->GetPreferredBackend(), BackendType::ModelB_AdHoc);
+}
+
+TEST(AutoBackendSelectionTest, InternetIsPickedWithoutAdHoc) {
+    auto factory = CreateBackendFactory(std::make_shared<SlowConfiguration>(true, false));
+    EXPECT_EQ(factory->WaitForPreferredBackend(), BackendType::ModelA_Internet);
+    EXPECT_TRUE(factory->IsPreferredBackendSettled());
+}
+
+} // namespace Core::Multiplayer::HLE
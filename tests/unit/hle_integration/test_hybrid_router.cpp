@@ -0,0 +1,220 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "core/multiplayer/hybrid_router.h"
+
+namespace Core::Multiplayer::HLE {
+
+namespace {
+
+using namespace std::chrono_literals;
+
+// Stands in for the relay: records what reached the internet path
+struct InternetPath {
+    ErrorCode Send(uint8_t node_id, const uint8_t* data, size_t size, SendPriority) {
+        std::lock_guard<std::mutex> lock(mutex);
+        sent.push_back({node_id, std::vector<uint8_t>(data, data + size)});
+        return ErrorCode::Success;
+    }
+
+    size_t Count() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return sent.size();
+    }
+
+    std::mutex mutex;
+    std::vector<std::pair<uint8_t, std::vector<uint8_t>>> sent;
+};
+
+bool WaitFor(const std::function<bool()>& condition) {
+    const auto deadline = std::chrono::steady_clock::now() + 3s;
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(5ms);
+    }
+    return true;
+}
+
+HybridRouterConfig LoopbackConfig() {
+    HybridRouterConfig config;
+    config.lan.bind_address = "127.0.0.1";
+    config.lan.port = 0;
+    config.local_subnets = {*Ipv4Subnet::Parse("127.0.0.1/8")};
+    config.probe_interval = 20ms;
+    config.lan_timeout = 200ms;
+    return config;
+}
+
+class HybridRouterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_EQ(backend_a_.Initialize(), ErrorCode::Success);
+        ASSERT_EQ(backend_b_.Initialize(), ErrorCode::Success);
+    }
+
+    ErrorCode Start(HybridRouter& router, InternetPath& path, uint8_t node_id, uint64_t tag) {
+        return router.Start(node_id, tag,
+                            [&path](uint8_t node, const uint8_t* data, size_t size,
+                                    SendPriority priority) {
+                                return path.Send(node, data, size, priority);
+                            });
+    }
+
+    void Introduce() {
+        router_a_.ReportLanEndpoint(1, router_b_.GetLanEndpoint());
+        router_b_.ReportLanEndpoint(0, router_a_.GetLanEndpoint());
+    }
+
+    std::shared_ptr<TimerWheel> wheel_ = std::make_shared<TimerWheel>(5ms);
+    InternetPath internet_a_;
+    InternetPath internet_b_;
+    ModelA::ModelABackend backend_a_{nullptr, nullptr};
+    ModelA::ModelABackend backend_b_{nullptr, nullptr};
+    HybridRouter router_a_{backend_a_, LoopbackConfig(), wheel_};
+    HybridRouter router_b_{backend_b_, LoopbackConfig(), wheel_};
+};
+
+} // namespace
+
+TEST(Ipv4SubnetTest, ParsesAndMatches) {
+    EXPECT_EQ(ParseIpv4("192.168.0.1"), 0xC0A80001u);
+    EXPECT_FALSE(ParseIpv4("192.168.0").has_value());
+    EXPECT_FALSE(ParseIpv4("192.168.0.256").has_value());
+    EXPECT_FALSE(ParseIpv4("192.168..1").has_value());
+
+    const auto subnet = Ipv4Subnet::Parse("10.1.2.3/16");
+    ASSERT_TRUE(subnet.has_value());
+    EXPECT_TRUE(subnet->Contains(*ParseIpv4("10.1.200.7")));
+    EXPECT_FALSE(subnet->Contains(*ParseIpv4("10.2.0.1")));
+    EXPECT_FALSE(Ipv4Subnet::Parse("10.1.2.3/33").has_value());
+    EXPECT_TRUE(Ipv4Subnet::Parse("0.0.0.0/0")->Contains(*ParseIpv4("8.8.8.8")));
+}
+
+TEST_F(HybridRouterTest, OnlySameSubnetCandidatesAreProbed) {
+    HybridRouterConfig config;
+    config.local_subnets = {*Ipv4Subnet::Parse("192.168.1.20/24")};
+    HybridRouter router(backend_a_, config, wheel_);
+
+    EXPECT_FALSE(router.ReportNodeCandidates(1, {"203.0.113.5", "192.168.2.9"}));
+    // Our own address is another process on this host, not a LAN peer
+    EXPECT_FALSE(router.ReportNodeCandidates(1, {"192.168.1.20"}));
+    EXPECT_TRUE(router.ReportNodeCandidates(1, {"not an address", "192.168.1.31"}));
+    // A candidate is not sent to over the LAN until probes went both ways
+    EXPECT_FALSE(router.IsLocal(1));
+}
+
+TEST_F(HybridRouterTest, LanPeersAreReachedOverTheLan) {
+    ASSERT_EQ(Start(router_a_, internet_a_, 0, 42), ErrorCode::Success);
+    ASSERT_EQ(Start(router_b_, internet_b_, 1, 42), ErrorCode::Success);
+
+    // Before the LAN path is confirmed, packets take the internet path
+    const std::vector<uint8_t> packet{1, 2, 3, 4};
+    ASSERT_EQ(backend_a_.SendPacket(packet, 1), ErrorCode::Success);
+    EXPECT_EQ(internet_a_.Count(), 1u);
+
+    Introduce();
+    ASSERT_TRUE(WaitFor([&] { return router_a_.IsLocal(1) && router_b_.IsLocal(0); }));
+
+    // A node the room reports without a LAN path still goes over the internet
+    ASSERT_EQ(backend_a_.SendPacket(packet, 2), ErrorCode::Success);
+    EXPECT_EQ(internet_a_.Count(), 2u);
+
+    ASSERT_EQ(backend_a_.SendPacket(packet, 1), ErrorCode::Success);
+    EXPECT_EQ(internet_a_.Count(), 2u);
+    std::vector<uint8_t> received;
+    uint8_t from = 0xFF;
+    ASSERT_TRUE(WaitFor([&] {
+        return backend_b_.ReceivePacket(received, from) == ErrorCode::Success && !received.empty();
+    }));
+    EXPECT_EQ(received, packet);
+    EXPECT_EQ(from, 0);
+
+    const HybridRouterStatistics statistics = router_a_.GetStatistics();
+    EXPECT_EQ(statistics.lan_packets_sent, 1u);
+    EXPECT_EQ(statistics.internet_packets_sent, 2u);
+    EXPECT_EQ(statistics.lan_nodes, 1u);
+    EXPECT_EQ(router_b_.GetStatistics().lan_packets_received, 1u);
+}
+
+TEST_F(HybridRouterTest, LanAndInternetDeliveriesRaceIntoOneQueue) {
+    ASSERT_EQ(Start(router_a_, internet_a_, 0, 42), ErrorCode::Success);
+    ASSERT_EQ(Start(router_b_, internet_b_, 1, 42), ErrorCode::Success);
+    Introduce();
+    ASSERT_TRUE(WaitFor([&] { return router_a_.IsLocal(1) && router_b_.IsLocal(0); }));
+
+    // The LAN receive thread and the internet transport deliver to backend B
+    // at the same time; each packet names its path and index. Both together
+    // fit the receive queue, so nothing is dropped for want of room
+    constexpr uint8_t PACKETS = 100;
+    std::thread lan([&] {
+        for (uint8_t i = 0; i < PACKETS; ++i) {
+            const std::vector<uint8_t> packet{'L', i};
+            ASSERT_EQ(backend_a_.SendPacket(packet, 1), ErrorCode::Success);
+        }
+    });
+    std::thread internet([&] {
+        for (uint8_t i = 0; i < PACKETS; ++i) {
+            const uint8_t packet[] = {'I', i};
+            EXPECT_TRUE(backend_b_.DeliverPacket(0, packet, sizeof(packet)));
+        }
+    });
+
+    std::vector<uint8_t> next_index(2, 0);
+    std::vector<uint8_t> received;
+    uint8_t from = 0xFF;
+    const bool drained = WaitFor([&] {
+        while (backend_b_.ReceivePacket(received, from) == ErrorCode::Success &&
+               !received.empty()) {
+            EXPECT_EQ(from, 0);
+            EXPECT_EQ(received.size(), 2u);
+            const size_t path = received[0] == 'L' ? 0 : 1;
+            // Each path's packets come out whole and in the order they went in
+            EXPECT_EQ(received[1], next_index[path]);
+            ++next_index[path];
+        }
+        return next_index[0] == PACKETS && next_index[1] == PACKETS;
+    });
+    lan.join();
+    internet.join();
+    EXPECT_TRUE(drained);
+    EXPECT_EQ(router_b_.GetStatistics().lan_packets_received, PACKETS);
+}
+
+TEST_F(HybridRouterTest, OtherSessionsOnTheLanAreIgnored) {
+    ASSERT_EQ(Start(router_a_, internet_a_, 0, 42), ErrorCode::Success);
+    ASSERT_EQ(Start(router_b_, internet_b_, 1, 43), ErrorCode::Success);
+    Introduce();
+
+    std::this_thread::sleep_for(150ms);
+    EXPECT_FALSE(router_a_.IsLocal(1));
+    EXPECT_FALSE(router_b_.IsLocal(0));
+    ASSERT_EQ(backend_a_.SendPacket(std::vector<uint8_t>{9}, 1), ErrorCode::Success);
+    EXPECT_EQ(internet_a_.Count(), 1u);
+}
+
+TEST_F(HybridRouterTest, QuietLanPeersFallBackToTheInternet) {
+    ASSERT_EQ(Start(router_a_, internet_a_, 0, 42), ErrorCode::Success);
+    ASSERT_EQ(Start(router_b_, internet_b_, 1, 42), ErrorCode::Success);
+    Introduce();
+    ASSERT_TRUE(WaitFor([&] { return router_a_.IsLocal(1); }));
+
+    router_b_.Stop();
+    ASSERT_TRUE(WaitFor([&] { return !router_a_.IsLocal(1); }));
+    EXPECT_EQ(router_a_.GetStatistics().lan_fallbacks, 1u);
+
+    ASSERT_EQ(backend_a_.SendPacket(std::vector<uint8_t>{7}, 1), ErrorCode::Success);
+    EXPECT_EQ(internet_a_.Count(), 1u);
+}
+
+} // namespace Core::Multiplayer::HLE
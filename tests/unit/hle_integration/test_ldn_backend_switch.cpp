@@ -0,0 +1,305 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "core/multiplayer/ldn_service_bridge.h"
+
+#include "sudachi/src/core/hle/result.h"
+#include "sudachi/src/core/hle/service/ldn/ldn_results.h"
+#include "sudachi/src/core/hle/service/ldn/ldn_types.h"
+
+/**
+ * Make-before-break backend switches through the real bridge: the standby
+ * is prepared off the HLE thread, and the data path either swaps to it or
+ * drops it. A switch must never be left pending.
+ */
+
+namespace Service::LDN {
+
+namespace {
+
+using namespace std::chrono_literals;
+using Core::Multiplayer::ErrorCode;
+using BackendType = Core::Multiplayer::HLE::BackendFactory::BackendType;
+
+// What happened to the backends of one type, kept past their destruction
+struct BackendLog {
+    ErrorCode initialize_error = ErrorCode::Success;
+    // Initialize waits for it when set, holding the standby in preparation
+    std::shared_future<void> initialize_gate;
+    std::atomic<int> created{0};
+    std::atomic<int> initialized{0};
+    std::atomic<int> finalized{0};
+    std::atomic<int> networks_created{0};
+    std::atomic<int> packets_sent{0};
+};
+
+class FakeBackend : public Core::Multiplayer::HLE::MultiplayerBackend {
+public:
+    explicit FakeBackend(std::shared_ptr<BackendLog> log) : log_(std::move(log)) {}
+
+    ErrorCode Initialize() override {
+        if (log_->initialize_gate.valid()) {
+            log_->initialize_gate.wait();
+        }
+        ++log_->initialized;
+        return log_->initialize_error;
+    }
+    ErrorCode Finalize() override {
+        ++log_->finalized;
+        return ErrorCode::Success;
+    }
+    bool IsInitialized() const override {
+        return true;
+    }
+
+    ErrorCode CreateNetwork(const CreateNetworkConfig&) override {
+        ++log_->networks_created;
+        return ErrorCode::Success;
+    }
+    ErrorCode DestroyNetwork() override {
+        return ErrorCode::Success;
+    }
+    ErrorCode Connect(const ConnectNetworkData&, const NetworkInfo&) override {
+        return ErrorCode::Success;
+    }
+    ErrorCode Disconnect() override {
+        return ErrorCode::Success;
+    }
+    ErrorCode Scan(std::vector<NetworkInfo>& out_networks, const ScanFilter&) override {
+        out_networks.clear();
+        return ErrorCode::Success;
+    }
+    ErrorCode GetNetworkInfo(NetworkInfo&) override {
+        return ErrorCode::Success;
+    }
+    ErrorCode GetCurrentState(State&) override {
+        return ErrorCode::Success;
+    }
+
+    ErrorCode OpenAccessPoint() override {
+        return ErrorCode::Success;
+    }
+    ErrorCode CloseAccessPoint() override {
+        return ErrorCode::Success;
+    }
+    ErrorCode OpenStation() override {
+        return ErrorCode::Success;
+    }
+    ErrorCode CloseStation() override {
+        return ErrorCode::Success;
+    }
+
+    ErrorCode SendPacket(const std::vector<uint8_t>&, uint8_t) override {
+        ++log_->packets_sent;
+        return ErrorCode::Success;
+    }
+    ErrorCode ReceivePacket(std::vector<uint8_t>& out_data, uint8_t&) override {
+        out_data.clear();
+        return ErrorCode::Success;
+    }
+
+    ErrorCode SetAdvertiseData(const std::vector<uint8_t>&) override {
+        return ErrorCode::Success;
+    }
+    ErrorCode SetStationAcceptPolicy(AcceptPolicy) override {
+        return ErrorCode::Success;
+    }
+    ErrorCode AddAcceptFilterEntry(const MacAddress&) override {
+        return ErrorCode::Success;
+    }
+    ErrorCode GetSecurityParameter(SecurityParameter&) override {
+        return ErrorCode::Success;
+    }
+    ErrorCode GetDisconnectReason(DisconnectReason&) override {
+        return ErrorCode::Success;
+    }
+    ErrorCode GetIpv4Address(Ipv4Address&, Ipv4Address&) override {
+        return ErrorCode::Success;
+    }
+    ErrorCode GetNetworkConfig(NetworkConfig&) override {
+        return ErrorCode::Success;
+    }
+    void RegisterNodeEventCallbacks(std::function<void(uint8_t)>,
+                                    std::function<void(uint8_t)>) override {}
+
+private:
+    std::shared_ptr<BackendLog> log_;
+};
+
+class FakeBackendFactory : public Core::Multiplayer::HLE::BackendFactory {
+public:
+    std::unique_ptr<Core::Multiplayer::HLE::MultiplayerBackend> CreateBackend(
+        BackendType type) override {
+        auto& log = Log(type);
+        ++log->created;
+        return std::make_unique<FakeBackend>(log);
+    }
+    // Answers as Auto does before its checks finish
+    BackendType GetPreferredBackend() override {
+        return BackendType::ModelA_Internet;
+    }
+    BackendType WaitForPreferredBackend() override {
+        return settled_preference;
+    }
+
+    BackendType settled_preference = BackendType::ModelA_Internet;
+
+    std::shared_ptr<BackendLog>& Log(BackendType type) {
+        return type == BackendType::ModelA_Internet ? internet_ : adhoc_;
+    }
+
+private:
+    std::shared_ptr<BackendLog> internet_ = std::make_shared<BackendLog>();
+    std::shared_ptr<BackendLog> adhoc_ = std::make_shared<BackendLog>();
+};
+
+class LdnBackendSwitchTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto factory = std::make_unique<FakeBackendFactory>();
+        factory_ = factory.get();
+        bridge_ = CreateLdnServiceBridge(std::move(factory));
+        ASSERT_EQ(bridge_->Initialize(), ResultSuccess);
+    }
+
+    void TearDown() override {
+        bridge_->Finalize();
+    }
+
+    void HostNetwork() {
+        ASSERT_EQ(bridge_->OpenAccessPoint(), ResultSuccess);
+        ASSERT_EQ(bridge_->CreateNetwork(CreateNetworkConfig{}), ResultSuccess);
+    }
+
+    Result SendOne() {
+        const uint8_t payload[] = {1, 2, 3};
+        const Core::Multiplayer::HLE::PacketRef packet{payload, sizeof(payload), 1};
+        size_t sent = 0;
+        return bridge_->SendPackets(&packet, 1, sent);
+    }
+
+    // Keeps the data path moving until it has taken or dropped the standby
+    bool SendUntilSwitchSettles() {
+        const auto deadline = std::chrono::steady_clock::now() + 3s;
+        while (bridge_->IsBackendSwitchPending()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            SendOne();
+            std::this_thread::sleep_for(1ms);
+        }
+        return true;
+    }
+
+    BackendLog& Internet() {
+        return *factory_->Log(BackendType::ModelA_Internet);
+    }
+    BackendLog& AdHoc() {
+        return *factory_->Log(BackendType::ModelB_AdHoc);
+    }
+
+    FakeBackendFactory* factory_ = nullptr;
+    std::unique_ptr<LdnServiceBridge> bridge_;
+};
+
+} // namespace
+
+TEST(LdnBackendSelectionTest, InitializeCreatesTheSettledPreference) {
+    auto factory = std::make_unique<FakeBackendFactory>();
+    factory->settled_preference = BackendType::ModelB_AdHoc;
+    auto* logs = factory.get();
+    auto bridge = CreateLdnServiceBridge(std::move(factory));
+
+    ASSERT_EQ(bridge->Initialize(), ResultSuccess);
+    EXPECT_EQ(bridge->GetCurrentBackendType(), BackendType::ModelB_AdHoc);
+    EXPECT_EQ(logs->Log(BackendType::ModelA_Internet)->created, 0);
+    bridge->Finalize();
+}
+
+TEST_F(LdnBackendSwitchTest, SwitchNeedsANetwork) {
+    // Nothing would ever commit it outside the data path states
+    EXPECT_EQ(bridge_->BeginBackendSwitch(BackendType::ModelB_AdHoc), ResultBadState);
+    ASSERT_EQ(bridge_->OpenAccessPoint(), ResultSuccess);
+    EXPECT_EQ(bridge_->BeginBackendSwitch(BackendType::ModelB_AdHoc), ResultBadState);
+    EXPECT_FALSE(bridge_->IsBackendSwitchPending());
+    EXPECT_EQ(AdHoc().created, 0);
+}
+
+TEST_F(LdnBackendSwitchTest, DataPathHandsOverToTheStandby) {
+    HostNetwork();
+    ASSERT_EQ(bridge_->BeginBackendSwitch(BackendType::ModelB_AdHoc), ResultSuccess);
+    EXPECT_EQ(bridge_->BeginBackendSwitch(BackendType::ModelB_AdHoc), ResultBadState);
+
+    ASSERT_TRUE(SendUntilSwitchSettles());
+    EXPECT_EQ(bridge_->GetCurrentBackendType(), BackendType::ModelB_AdHoc);
+    // The standby rejoined the session before taking over
+    EXPECT_EQ(AdHoc().networks_created, 1);
+    EXPECT_EQ(Internet().finalized, 1);
+
+    const int sent_before = AdHoc().packets_sent;
+    EXPECT_EQ(SendOne(), ResultSuccess);
+    EXPECT_EQ(AdHoc().packets_sent, sent_before + 1);
+}
+
+TEST_F(LdnBackendSwitchTest, FailedStandbyKeepsTheCurrentBackend) {
+    HostNetwork();
+    AdHoc().initialize_error = ErrorCode::NetworkError;
+    ASSERT_EQ(bridge_->BeginBackendSwitch(BackendType::ModelB_AdHoc), ResultSuccess);
+
+    ASSERT_TRUE(SendUntilSwitchSettles());
+    EXPECT_EQ(bridge_->GetCurrentBackendType(), BackendType::ModelA_Internet);
+    EXPECT_EQ(AdHoc().finalized, 1);
+    EXPECT_EQ(Internet().finalized, 0);
+
+    // The failure does not block the next attempt
+    AdHoc().initialize_error = ErrorCode::Success;
+    ASSERT_EQ(bridge_->BeginBackendSwitch(BackendType::ModelB_AdHoc), ResultSuccess);
+    ASSERT_TRUE(SendUntilSwitchSettles());
+    EXPECT_EQ(bridge_->GetCurrentBackendType(), BackendType::ModelB_AdHoc);
+}
+
+TEST_F(LdnBackendSwitchTest, StateChangeDuringPreparationAbandonsTheSwitch) {
+    HostNetwork();
+    std::promise<void> release;
+    AdHoc().initialize_gate = release.get_future().share();
+    ASSERT_EQ(bridge_->BeginBackendSwitch(BackendType::ModelB_AdHoc), ResultSuccess);
+
+    // Preparation holds neither lock: packets and getters go on meanwhile
+    const int sent_before = Internet().packets_sent;
+    EXPECT_EQ(SendOne(), ResultSuccess);
+    EXPECT_EQ(Internet().packets_sent, sent_before + 1);
+    State state{};
+    EXPECT_EQ(bridge_->GetState(state), ResultSuccess);
+    EXPECT_EQ(state, State::AccessPointCreated);
+    EXPECT_TRUE(bridge_->IsBackendSwitchPending());
+
+    // The standby finishes while DestroyNetwork waits for it
+    std::thread releaser([&release] {
+        std::this_thread::sleep_for(50ms);
+        release.set_value();
+    });
+    EXPECT_EQ(bridge_->DestroyNetwork(), ResultSuccess);
+    releaser.join();
+
+    EXPECT_FALSE(bridge_->IsBackendSwitchPending());
+    EXPECT_EQ(bridge_->GetCurrentBackendType(), BackendType::ModelA_Internet);
+    EXPECT_EQ(AdHoc().finalized, 1);
+
+    // Nothing is left over to refuse the next switch
+    AdHoc().initialize_gate = {};
+    ASSERT_EQ(bridge_->CreateNetwork(CreateNetworkConfig{}), ResultSuccess);
+    ASSERT_EQ(bridge_->BeginBackendSwitch(BackendType::ModelB_AdHoc), ResultSuccess);
+    ASSERT_TRUE(SendUntilSwitchSettles());
+    EXPECT_EQ(bridge_->GetCurrentBackendType(), BackendType::ModelB_AdHoc);
+}
+
+} // namespace Service::LDN
@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "core/multiplayer/model_a/model_a_backend.h"
+
+namespace Core::Multiplayer::Test {
+
+namespace {
+
+using Frames = std::vector<std::vector<uint8_t>>;
+
+ModelA::ModelABackend::PacketSender RecordInto(Frames& frames) {
+    return [&frames](uint8_t, const uint8_t* data, size_t size, SendPriority) {
+        frames.emplace_back(data, data + size);
+        return ErrorCode::Success;
+    };
+}
+
+} // namespace
+
+// With redundant sending, each path's transport delivers from its own
+// thread; the copies race, and each packet must still come out once
+TEST(RedundantDeliveryTest, PathsDeliveredFromTwoThreadsKeepOneCopy) {
+    constexpr uint8_t PACKETS = 100;
+
+    Frames primary;
+    Frames secondary;
+    ModelA::ModelABackend sender{nullptr, nullptr};
+    sender.SetPacketSender(RecordInto(primary));
+    sender.EnableRedundantSend(RecordInto(secondary));
+    ASSERT_EQ(sender.Initialize(), ErrorCode::Success);
+    for (uint8_t i = 0; i < PACKETS; ++i) {
+        ASSERT_EQ(sender.SendPacket(std::vector<uint8_t>{i}, 1), ErrorCode::Success);
+    }
+    ASSERT_EQ(primary.size(), PACKETS);
+    ASSERT_EQ(secondary.size(), PACKETS);
+
+    ModelA::ModelABackend receiver{nullptr, nullptr};
+    receiver.EnableRedundantSend(
+        [](uint8_t, const uint8_t*, size_t, SendPriority) { return ErrorCode::Success; });
+    ASSERT_EQ(receiver.Initialize(), ErrorCode::Success);
+    const auto deliver = [&receiver](const Frames& frames, size_t path) {
+        for (const auto& frame : frames) {
+            EXPECT_TRUE(receiver.DeliverPacket(0, path, frame.data(), frame.size()));
+        }
+    };
+    std::thread first(deliver, std::cref(primary), 0);
+    std::thread second(deliver, std::cref(secondary), 1);
+    first.join();
+    second.join();
+
+    std::vector<uint8_t> seen(PACKETS, 0);
+    std::vector<uint8_t> received;
+    uint8_t from = 0xFF;
+    while (receiver.ReceivePacket(received, from) == ErrorCode::Success && !received.empty()) {
+        ASSERT_EQ(received.size(), 1u);
+        ASSERT_LT(received[0], PACKETS);
+        ++seen[received[0]];
+    }
+    EXPECT_EQ(seen, std::vector<uint8_t>(PACKETS, 1));
+
+    // A copy that lost the race is a duplicate, or stale if the other path
+    // ran a whole receive window ahead
+    const auto statistics = receiver.GetMultipathStatistics();
+    ASSERT_TRUE(statistics.has_value());
+    EXPECT_EQ(statistics->paths[0].first + statistics->paths[1].first, PACKETS);
+    EXPECT_EQ(statistics->paths[0].second + statistics->paths[1].second + statistics->stale,
+              PACKETS);
+}
+
+} // namespace Core::Multiplayer::Test
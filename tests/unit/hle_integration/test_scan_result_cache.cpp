@@ -0,0 +1,156 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "core/multiplayer/scan_result_cache.h"
+
+using namespace Core::Multiplayer;
+using namespace Core::Multiplayer::HLE;
+using namespace std::chrono_literals;
+
+namespace {
+
+using Networks = std::vector<int>;
+using Cache = ScanResultCache<Networks>;
+
+constexpr std::array<uint8_t, 4> FILTER_A{1, 0, 0, 0};
+constexpr std::array<uint8_t, 4> FILTER_B{2, 0, 0, 0};
+
+class ScanResultCacheTest : public ::testing::Test {
+protected:
+    // Reports one network per scan so far
+    Cache::Scanner CountingScanner() {
+        return [this](Networks& out) {
+            const int scan = ++scans_;
+            out.assign(static_cast<size_t>(scan), scan);
+            return ErrorCode::Success;
+        };
+    }
+
+    Cache::Clock::time_point start_ = Cache::Clock::now();
+    std::atomic<int> scans_{0};
+};
+
+} // namespace
+
+TEST_F(ScanResultCacheTest, FirstScanRunsInTheCallAndIsThenServedFresh) {
+    Cache cache;
+    Networks out;
+    ASSERT_EQ(cache.Get(FILTER_A, 0, CountingScanner(), out, start_), ErrorCode::Success);
+    EXPECT_EQ(out, Networks{1});
+
+    out.clear();
+    ASSERT_EQ(cache.Get(FILTER_A, 0, CountingScanner(), out, start_ + 100ms), ErrorCode::Success);
+    EXPECT_EQ(out, Networks{1});
+    EXPECT_EQ(scans_, 1);
+    EXPECT_EQ(cache.GetStatistics().misses, 1u);
+    EXPECT_EQ(cache.GetStatistics().fresh_hits, 1u);
+}
+
+TEST_F(ScanResultCacheTest, StaleSnapshotIsServedWhileRefreshing) {
+    Cache cache(ScanCacheConfig{.refresh_after = 1s, .max_age = 10s});
+    Networks out;
+    ASSERT_EQ(cache.Get(FILTER_A, 0, CountingScanner(), out, start_), ErrorCode::Success);
+
+    ASSERT_EQ(cache.Get(FILTER_A, 0, CountingScanner(), out, start_ + 2s), ErrorCode::Success);
+    EXPECT_EQ(out, Networks{1});
+    EXPECT_EQ(cache.GetStatistics().stale_hits, 1u);
+    EXPECT_EQ(cache.GetStatistics().refreshes, 1u);
+
+    cache.WaitForRefresh();
+    EXPECT_EQ(scans_, 2);
+}
+
+TEST_F(ScanResultCacheTest, RefreshedSnapshotIsPickedUpByTheNextCall) {
+    Cache cache;
+    Networks out;
+    ASSERT_EQ(cache.Get(FILTER_A, 0, CountingScanner(), out, start_), ErrorCode::Success);
+    ASSERT_EQ(cache.Get(FILTER_A, 0, CountingScanner(), out, start_ + 2s), ErrorCode::Success);
+
+    // Let the refresh finish without collecting it
+    while (scans_ < 2) {
+        std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(50ms);
+
+    ASSERT_EQ(cache.Get(FILTER_A, 0, CountingScanner(), out, start_ + 2100ms),
+              ErrorCode::Success);
+    EXPECT_EQ(out, (Networks{2, 2}));
+    EXPECT_EQ(cache.GetStatistics().fresh_hits, 1u);
+}
+
+TEST_F(ScanResultCacheTest, EpochChangeTriggersRefresh) {
+    Cache cache;
+    Networks out;
+    ASSERT_EQ(cache.Get(FILTER_A, 5, CountingScanner(), out, start_), ErrorCode::Success);
+    ASSERT_EQ(cache.Get(FILTER_A, 6, CountingScanner(), out, start_ + 10ms), ErrorCode::Success);
+    EXPECT_EQ(out, Networks{1});
+    EXPECT_EQ(cache.GetStatistics().refreshes, 1u);
+    cache.WaitForRefresh();
+}
+
+TEST_F(ScanResultCacheTest, SnapshotPastMaxAgeScansInTheCall) {
+    Cache cache(ScanCacheConfig{.refresh_after = 1s, .max_age = 5s});
+    Networks out;
+    ASSERT_EQ(cache.Get(FILTER_A, 0, CountingScanner(), out, start_), ErrorCode::Success);
+    ASSERT_EQ(cache.Get(FILTER_A, 0, CountingScanner(), out, start_ + 6s), ErrorCode::Success);
+    EXPECT_EQ(out, (Networks{2, 2}));
+    EXPECT_EQ(cache.GetStatistics().misses, 2u);
+}
+
+TEST_F(ScanResultCacheTest, DifferentFilterMisses) {
+    Cache cache;
+    Networks out;
+    ASSERT_EQ(cache.Get(FILTER_A, 0, CountingScanner(), out, start_), ErrorCode::Success);
+    ASSERT_EQ(cache.Get(FILTER_B, 0, CountingScanner(), out, start_ + 10ms), ErrorCode::Success);
+    EXPECT_EQ(scans_, 2);
+    EXPECT_EQ(cache.GetStatistics().misses, 2u);
+}
+
+TEST_F(ScanResultCacheTest, FailedScanIsReportedAndNotCached) {
+    Cache cache;
+    Networks out;
+    const auto failing = [](Networks&) { return ErrorCode::ConnectionTimeout; };
+    EXPECT_EQ(cache.Get(FILTER_A, 0, failing, out, start_), ErrorCode::ConnectionTimeout);
+    ASSERT_EQ(cache.Get(FILTER_A, 0, CountingScanner(), out, start_), ErrorCode::Success);
+    EXPECT_EQ(cache.GetStatistics().misses, 2u);
+}
+
+TEST_F(ScanResultCacheTest, FailedRefreshKeepsOldSnapshot) {
+    Cache cache;
+    Networks out;
+    ASSERT_EQ(cache.Get(FILTER_A, 0, CountingScanner(), out, start_), ErrorCode::Success);
+    const auto failing = [](Networks&) { return ErrorCode::ConnectionTimeout; };
+    ASSERT_EQ(cache.Get(FILTER_A, 0, failing, out, start_ + 2s), ErrorCode::Success);
+    cache.WaitForRefresh();
+
+    ASSERT_EQ(cache.Get(FILTER_A, 0, failing, out, start_ + 3s), ErrorCode::Success);
+    EXPECT_EQ(out, Networks{1});
+    EXPECT_EQ(cache.GetStatistics().failed_refreshes, 1u);
+    cache.WaitForRefresh();
+}
+
+TEST_F(ScanResultCacheTest, DisabledScansEveryCall) {
+    Cache cache(ScanCacheConfig{.enabled = false});
+    Networks out;
+    ASSERT_EQ(cache.Get(FILTER_A, 0, CountingScanner(), out, start_), ErrorCode::Success);
+    ASSERT_EQ(cache.Get(FILTER_A, 0, CountingScanner(), out, start_), ErrorCode::Success);
+    EXPECT_EQ(scans_, 2);
+}
+
+TEST_F(ScanResultCacheTest, InvalidateDropsSnapshot) {
+    Cache cache;
+    Networks out;
+    ASSERT_EQ(cache.Get(FILTER_A, 0, CountingScanner(), out, start_), ErrorCode::Success);
+    cache.Invalidate();
+    ASSERT_EQ(cache.Get(FILTER_A, 0, CountingScanner(), out, start_), ErrorCode::Success);
+    EXPECT_EQ(scans_, 2);
+}
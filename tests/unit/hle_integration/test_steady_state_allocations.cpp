@@ -0,0 +1,260 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+#include "allocation_counter.h"
+#include "core/multiplayer/common/packet_buffer.h"
+#include "core/multiplayer/model_a/model_a_backend.h"
+#include "core/multiplayer/model_b/model_b_backend.h"
+
+/**
+ * Once a session is up, the packet path must not touch the heap: every
+ * buffer comes from a PacketPool and every queue is preallocated. These
+ * tests run a full session's traffic through real backends with the
+ * allocation counter armed and fail, naming the call stack, on the first
+ * allocation.
+ */
+
+namespace Core::Multiplayer::Test {
+
+namespace {
+
+constexpr size_t NODE_COUNT = 8;
+constexpr size_t FRAME_RATE = 60;
+// One minute of frames, run back to back
+constexpr size_t STEADY_STATE_FRAMES = FRAME_RATE * 60;
+// Frames sent before counting, so per-node codec state and the like exist
+constexpr size_t WARMUP_FRAMES = FRAME_RATE;
+constexpr size_t PAYLOAD_SIZE = 512;
+
+enum class DataPathOptions {
+    Plain,
+    DeltaCoding,
+    ForwardErrorCorrection,
+    // Every node sent to through the routing table's broadcast
+    Broadcast,
+    // Broadcast sent once and replicated, as the relay does with multicast
+    RelayFanOut,
+};
+
+/**
+ * NODE_COUNT backends of one kind in a full mesh: each sender hands its
+ * packets straight to the addressed node's DeliverPacket, and every frame
+ * each node sends one packet to every other node and drains its queue.
+ */
+template <typename Backend>
+class Mesh {
+public:
+    explicit Mesh(DataPathOptions options)
+        : broadcast_(options == DataPathOptions::Broadcast ||
+                     options == DataPathOptions::RelayFanOut) {
+        for (size_t node = 0; node < NODE_COUNT; ++node) {
+            backends_[node] = std::make_unique<Backend>(nullptr, nullptr);
+            SetSender(node);
+            if constexpr (std::is_same_v<Backend, ModelA::ModelABackend>) {
+                if (options == DataPathOptions::RelayFanOut) {
+                    SetBroadcastSender(node);
+                }
+            }
+            if (options == DataPathOptions::DeltaCoding) {
+                backends_[node]->EnableDeltaCoding(DeltaCodecConfig{});
+            } else if (options == DataPathOptions::ForwardErrorCorrection) {
+                backends_[node]->EnableForwardErrorCorrection(FecConfig{});
+            }
+            initialized_ = backends_[node]->Initialize() == ErrorCode::Success && initialized_;
+            for (size_t other = 0; other < NODE_COUNT && broadcast_; ++other) {
+                if (other != node) {
+                    backends_[node]->ReportNodeJoined(static_cast<uint8_t>(other));
+                }
+            }
+        }
+    }
+
+    bool IsInitialized() const {
+        return initialized_;
+    }
+
+    size_t GetBroadcastSendCount() const {
+        return broadcast_sends_;
+    }
+
+    // Sends and drains one frame; false if any packet was not sent or received
+    bool RunFrame(uint32_t frame) {
+        bool ok = true;
+        for (size_t from = 0; from < NODE_COUNT; ++from) {
+            PacketBuffer packet = pool_.Acquire();
+            if (!packet) {
+                return false;
+            }
+            packet.Resize(PAYLOAD_SIZE);
+            for (size_t i = 0; i < PAYLOAD_SIZE; ++i) {
+                // Mostly unchanged between frames, like game state
+                packet.data()[i] = static_cast<uint8_t>(i % 7 == 0 ? frame + i : i);
+            }
+            if (broadcast_) {
+                ok = backends_[from]->SendPacket(packet, NodeRoutingTable::BROADCAST_NODE_ID) ==
+                         ErrorCode::Success &&
+                     ok;
+                continue;
+            }
+            for (size_t to = 0; to < NODE_COUNT; ++to) {
+                if (to != from) {
+                    ok = backends_[from]->SendPacket(packet, static_cast<uint8_t>(to)) ==
+                             ErrorCode::Success &&
+                         ok;
+                }
+            }
+        }
+
+        for (auto& backend : backends_) {
+            size_t received = 0;
+            if (backend->ReceivePackets(received_.data(), received_.size(), received) !=
+                    ErrorCode::Success ||
+                received != NODE_COUNT - 1) {
+                ok = false;
+            }
+            for (size_t i = 0; i < received; ++i) {
+                received_[i].packet.Reset();
+            }
+        }
+        return ok;
+    }
+
+private:
+    void SetSender(size_t node) {
+        const uint8_t from = static_cast<uint8_t>(node);
+        if constexpr (std::is_same_v<Backend, ModelA::ModelABackend>) {
+            backends_[node]->SetPacketSender(
+                [this, from](uint8_t to, const uint8_t* data, size_t size, SendPriority) {
+                    return Deliver(from, to, data, size);
+                });
+        } else {
+            backends_[node]->SetPacketSender(
+                [this, from](uint8_t to, const uint8_t* data, size_t size) {
+                    return Deliver(from, to, data, size);
+                });
+        }
+    }
+
+    void SetBroadcastSender(size_t node) {
+        const uint8_t from = static_cast<uint8_t>(node);
+        backends_[node]->SetBroadcastSender(
+            [this, from](uint8_t mask, const uint8_t* data, size_t size, SendPriority) {
+                ++broadcast_sends_;
+                for (uint8_t to = 0; to < NODE_COUNT; ++to) {
+                    if ((mask >> to) & 1) {
+                        Deliver(from, to, data, size);
+                    }
+                }
+                return ErrorCode::Success;
+            });
+    }
+
+    ErrorCode Deliver(uint8_t from, uint8_t to, const uint8_t* data, size_t size) {
+        if (to >= NODE_COUNT) {
+            return ErrorCode::InvalidParameter;
+        }
+        // A parity packet that completes nothing is not queued, so only
+        // missing data packets show up as receive failures
+        backends_[to]->DeliverPacket(from, data, size);
+        return ErrorCode::Success;
+    }
+
+    std::array<std::unique_ptr<Backend>, NODE_COUNT> backends_;
+    PacketPool pool_{NODE_COUNT};
+    std::array<ReceivedPacket, NODE_COUNT * 2> received_{};
+    bool broadcast_ = false;
+    size_t broadcast_sends_ = 0;
+    bool initialized_ = true;
+};
+
+template <typename Backend>
+void ExpectAllocationFreeSteadyState(DataPathOptions options) {
+    Mesh<Backend> mesh(options);
+    ASSERT_TRUE(mesh.IsInitialized());
+
+    uint32_t frame = 0;
+    for (; frame < WARMUP_FRAMES; ++frame) {
+        ASSERT_TRUE(mesh.RunFrame(frame));
+    }
+
+    AllocationCounter::Reset();
+    bool ok = true;
+    {
+        const AllocationCounter::Scope scope;
+        for (; frame < WARMUP_FRAMES + STEADY_STATE_FRAMES && ok; ++frame) {
+            ok = mesh.RunFrame(frame);
+        }
+    }
+    EXPECT_TRUE(ok) << "Packets were lost on frame " << frame - 1;
+    EXPECT_EQ(AllocationCounter::GetCount(), 0u) << AllocationCounter::Describe();
+}
+
+} // namespace
+
+TEST(AllocationCounterTest, CountsOnlyInsideScope) {
+    AllocationCounter::Reset();
+    // Called directly, since new-expressions may be optimized out
+    ::operator delete(::operator new(16));
+    {
+        const AllocationCounter::Scope scope;
+        ::operator delete(::operator new(64));
+    }
+    EXPECT_EQ(AllocationCounter::GetCount(), 1u);
+    ASSERT_EQ(AllocationCounter::GetRecordedSiteCount(), 1u);
+    EXPECT_EQ(AllocationCounter::GetRecordedSite(0).size, 64u);
+    AllocationCounter::Reset();
+}
+
+TEST(SteadyStateAllocationTest, ModelAPlain) {
+    ExpectAllocationFreeSteadyState<ModelA::ModelABackend>(DataPathOptions::Plain);
+}
+
+TEST(SteadyStateAllocationTest, ModelADeltaCoding) {
+    ExpectAllocationFreeSteadyState<ModelA::ModelABackend>(DataPathOptions::DeltaCoding);
+}
+
+TEST(SteadyStateAllocationTest, ModelAForwardErrorCorrection) {
+    ExpectAllocationFreeSteadyState<ModelA::ModelABackend>(
+        DataPathOptions::ForwardErrorCorrection);
+}
+
+TEST(SteadyStateAllocationTest, ModelABroadcast) {
+    ExpectAllocationFreeSteadyState<ModelA::ModelABackend>(DataPathOptions::Broadcast);
+}
+
+TEST(SteadyStateAllocationTest, ModelARelayFanOut) {
+    ExpectAllocationFreeSteadyState<ModelA::ModelABackend>(DataPathOptions::RelayFanOut);
+}
+
+TEST(SteadyStateAllocationTest, ModelARelayFanOutSendsOncePerBroadcast) {
+    Mesh<ModelA::ModelABackend> mesh(DataPathOptions::RelayFanOut);
+    ASSERT_TRUE(mesh.IsInitialized());
+    ASSERT_TRUE(mesh.RunFrame(0));
+    EXPECT_EQ(mesh.GetBroadcastSendCount(), NODE_COUNT);
+}
+
+TEST(SteadyStateAllocationTest, ModelBPlain) {
+    ExpectAllocationFreeSteadyState<ModelB::ModelBBackend>(DataPathOptions::Plain);
+}
+
+TEST(SteadyStateAllocationTest, ModelBDeltaCoding) {
+    ExpectAllocationFreeSteadyState<ModelB::ModelBBackend>(DataPathOptions::DeltaCoding);
+}
+
+TEST(SteadyStateAllocationTest, ModelBForwardErrorCorrection) {
+    ExpectAllocationFreeSteadyState<ModelB::ModelBBackend>(
+        DataPathOptions::ForwardErrorCorrection);
+}
+
+TEST(SteadyStateAllocationTest, ModelBBroadcast) {
+    ExpectAllocationFreeSteadyState<ModelB::ModelBBackend>(DataPathOptions::Broadcast);
+}
+
+} // namespace Core::Multiplayer::Test
@@ -0,0 +1,209 @@
+// SPDX-FileCopyrightText: 2025 sudachi Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "core/multiplayer/traffic_replay.h"
+
+namespace Core::Multiplayer::HLE {
+
+namespace {
+
+struct SentPacket {
+    uint8_t node_id;
+    std::vector<uint8_t> data;
+};
+
+// Records what it is asked to send; nothing else is exercised
+class RecordingBackend : public MultiplayerBackend {
+public:
+    ErrorCode Initialize() override { return ErrorCode::Success; }
+    ErrorCode Finalize() override { return ErrorCode::Success; }
+    bool IsInitialized() const override { return true; }
+    ErrorCode CreateNetwork(const Service::LDN::CreateNetworkConfig&) override { return ErrorCode::Success; }
+    ErrorCode DestroyNetwork() override { return ErrorCode::Success; }
+    ErrorCode Connect(const Service::LDN::ConnectNetworkData&, const Service::LDN::NetworkInfo&) override {
+        return ErrorCode::Success;
+    }
+    ErrorCode Disconnect() override { return ErrorCode::Success; }
+    ErrorCode Scan(std::vector<Service::LDN::NetworkInfo>&, const Service::LDN::ScanFilter&) override {
+        return ErrorCode::Success;
+    }
+    ErrorCode GetNetworkInfo(Service::LDN::NetworkInfo&) override { return ErrorCode::Success; }
+    ErrorCode GetCurrentState(Service::LDN::State&) override { return ErrorCode::Success; }
+    ErrorCode OpenAccessPoint() override { return ErrorCode::Success; }
+    ErrorCode CloseAccessPoint() override { return ErrorCode::Success; }
+    ErrorCode OpenStation() override { return ErrorCode::Success; }
+    ErrorCode CloseStation() override { return ErrorCode::Success; }
+    ErrorCode SetAdvertiseData(const std::vector<uint8_t>&) override { return ErrorCode::Success; }
+    ErrorCode SetStationAcceptPolicy(Service::LDN::AcceptPolicy) override { return ErrorCode::Success; }
+    ErrorCode AddAcceptFilterEntry(const Service::LDN::MacAddress&) override { return ErrorCode::Success; }
+    ErrorCode GetSecurityParameter(Service::LDN::SecurityParameter&) override { return ErrorCode::Success; }
+    ErrorCode GetDisconnectReason(Service::LDN::DisconnectReason&) override { return ErrorCode::Success; }
+    ErrorCode GetIpv4Address(Service::LDN::Ipv4Address&, Service::LDN::Ipv4Address&) override {
+        return ErrorCode::Success;
+    }
+    ErrorCode GetNetworkConfig(Service::LDN::NetworkConfig&) override { return ErrorCode::Success; }
+    void RegisterNodeEventCallbacks(std::function<void(uint8_t)>, std::function<void(uint8_t)>) override {}
+
+    ErrorCode SendPacket(const std::vector<uint8_t>& data, uint8_t node_id) override {
+        if (fail_node && *fail_node == node_id) {
+            return ErrorCode::NotConnected;
+        }
+        sent.push_back({node_id, data});
+        return ErrorCode::Success;
+    }
+    ErrorCode ReceivePacket(std::vector<uint8_t>&, uint8_t&) override {
+        return ErrorCode::NotConnected;
+    }
+    ErrorCode SendPackets(const PacketRef* packets, size_t count, size_t& out_sent) override {
+        ++send_calls;
+        return MultiplayerBackend::SendPackets(packets, count, out_sent);
+    }
+
+    std::vector<SentPacket> sent;
+    size_t send_calls = 0;
+    std::optional<uint8_t> fail_node;
+};
+
+class TrafficReplayTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = (std::filesystem::temp_directory_path() /
+                 ("traffic_replay_test_" +
+                  std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()) +
+                  ".ldncap"))
+                    .string();
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(path_);
+    }
+
+    struct Entry {
+        TrafficDirection direction;
+        uint8_t node_id;
+        std::vector<uint8_t> data;
+        uint64_t time_ns;
+    };
+
+    void WriteCapture(const std::vector<Entry>& entries, bool payloads = true) {
+        TrafficCaptureWriter writer;
+        ASSERT_EQ(writer.Open(path_, 1 << 16, payloads), ErrorCode::Success);
+        for (const auto& entry : entries) {
+            ASSERT_TRUE(writer.Record(entry.direction, entry.node_id, entry.data.data(),
+                                      entry.data.size(), entry.time_ns));
+        }
+        ASSERT_EQ(writer.Close(), ErrorCode::Success);
+        ASSERT_EQ(reader_.Open(path_), ErrorCode::Success);
+    }
+
+    std::string path_;
+    TrafficCaptureReader reader_;
+    RecordingBackend local_;
+    RecordingBackend peer_;
+};
+
+} // namespace
+
+TEST_F(TrafficReplayTest, SendsCapturedPacketsThroughTheirSide) {
+    WriteCapture({{TrafficDirection::Sent, 0xFF, {1, 2, 3}, 0},
+                  {TrafficDirection::Received, 3, {4, 5}, 1000},
+                  {TrafficDirection::Sent, 2, {6}, 2000}});
+
+    TrafficReplayOptions options;
+    options.speed = 0;
+    options.local_node_id = 1;
+    TrafficReplayer replayer(reader_, options);
+    const auto result = replayer.Run(local_, &peer_);
+
+    EXPECT_EQ(result.packets_sent, 3u);
+    EXPECT_EQ(result.bytes_sent, 6u);
+    EXPECT_EQ(result.packets_failed, 0u);
+    ASSERT_EQ(local_.sent.size(), 2u);
+    EXPECT_EQ(local_.sent[0].node_id, 0xFF);
+    EXPECT_EQ(local_.sent[0].data, (std::vector<uint8_t>{1, 2, 3}));
+    EXPECT_EQ(local_.sent[1].node_id, 2);
+    // The peer sends what this console received, to this console
+    ASSERT_EQ(peer_.sent.size(), 1u);
+    EXPECT_EQ(peer_.sent[0].node_id, 1);
+    EXPECT_EQ(peer_.sent[0].data, (std::vector<uint8_t>{4, 5}));
+}
+
+TEST_F(TrafficReplayTest, ReceivedRecordsAreSkippedWithoutAPeer) {
+    WriteCapture({{TrafficDirection::Received, 3, {4, 5}, 0},
+                  {TrafficDirection::Sent, 2, {6}, 10}});
+
+    TrafficReplayOptions options;
+    options.speed = 0;
+    TrafficReplayer replayer(reader_, options);
+    EXPECT_EQ(replayer.Run(local_).packets_sent, 1u);
+    EXPECT_EQ(local_.sent.size(), 1u);
+}
+
+TEST_F(TrafficReplayTest, PacketsDueTogetherGoInOneBatch) {
+    WriteCapture({{TrafficDirection::Sent, 1, {1}, 0},
+                  {TrafficDirection::Sent, 2, {2}, 0},
+                  {TrafficDirection::Sent, 3, {3}, 0},
+                  {TrafficDirection::Sent, 1, {4}, 20'000'000}});
+
+    TrafficReplayer replayer(reader_);
+    const auto result = replayer.Run(local_);
+
+    EXPECT_EQ(result.packets_sent, 4u);
+    EXPECT_EQ(local_.send_calls, 2u);
+    // The captured pace is kept
+    EXPECT_GE(result.elapsed, std::chrono::milliseconds(20));
+}
+
+TEST_F(TrafficReplayTest, AcceleratedReplayCompressesTheSchedule) {
+    WriteCapture({{TrafficDirection::Sent, 1, {1}, 0},
+                  {TrafficDirection::Sent, 1, {2}, 200'000'000}});
+
+    TrafficReplayOptions options;
+    options.speed = 10;
+    TrafficReplayer replayer(reader_, options);
+    const auto result = replayer.Run(local_);
+
+    EXPECT_EQ(result.packets_sent, 2u);
+    EXPECT_GE(result.elapsed, std::chrono::milliseconds(20));
+    EXPECT_LT(result.elapsed, std::chrono::milliseconds(150));
+}
+
+TEST_F(TrafficReplayTest, ShapeOnlyCapturesReplayZeroFilledPackets) {
+    WriteCapture({{TrafficDirection::Sent, 1, {7, 7, 7, 7}, 0}}, false);
+
+    TrafficReplayOptions options;
+    options.speed = 0;
+    TrafficReplayer replayer(reader_, options);
+    replayer.Run(local_);
+
+    ASSERT_EQ(local_.sent.size(), 1u);
+    EXPECT_EQ(local_.sent[0].data, std::vector<uint8_t>(4, 0));
+}
+
+TEST_F(TrafficReplayTest, FailedPacketsAreCountedAndSkipped) {
+    WriteCapture({{TrafficDirection::Sent, 1, {1}, 0},
+                  {TrafficDirection::Sent, 5, {2}, 0},
+                  {TrafficDirection::Sent, 2, {3}, 0}});
+    local_.fail_node = 5;
+
+    TrafficReplayOptions options;
+    options.speed = 0;
+    TrafficReplayer replayer(reader_, options);
+    const auto result = replayer.Run(local_);
+
+    EXPECT_EQ(result.packets_sent, 2u);
+    EXPECT_EQ(result.packets_failed, 1u);
+    ASSERT_EQ(local_.sent.size(), 2u);
+    EXPECT_EQ(local_.sent[1].node_id, 2);
+}
+
+} // namespace Core::Multiplayer::HLE
@@ -11,7 +11,7 @@
 // Note: Path assumes test is built from project root
 #include "core/multiplayer/common/packet_protocol.h"
 
-using namespace Sudachi::Multiplayer;
+using namespace Core::Multiplayer;
 using namespace testing;
 
 /**
@@ -148,7 +148,7 @@ TEST_F(PacketProtocolTest, PacketFragmentation) {
     auto large_data = CreateTestData(large_size);
 
     // Fragment the data
-    std::vector<LdnPacket> fragments;
+    std::vector<LdnPacketView> fragments;
     ASSERT_TRUE(FragmentData(large_data, 0x12345678, 1, 2, fragments));
 
     // Verify fragment count
@@ -247,7 +247,7 @@ TEST_F(PacketProtocolTest, ErrorPacketCreation) {
         0x12345678,  // session_id
         1,           // source_node
         2,           // dest_node
-        ErrorCode::InvalidPacket,
+        ErrorCode::InvalidMessage,
         "Test error message"
     );
 
@@ -257,7 +257,7 @@ TEST_F(PacketProtocolTest, ErrorPacketCreation) {
     // Verify error payload
     ASSERT_GE(error_packet.payload.size(), sizeof(uint32_t));
     uint32_t error_code = *reinterpret_cast<const uint32_t*>(error_packet.payload.data());
-    EXPECT_EQ(static_cast<uint32_t>(ErrorCode::InvalidPacket), error_code);
+    EXPECT_EQ(static_cast<uint32_t>(ErrorCode::InvalidMessage), error_code);
     
     // Verify error message
     std::string error_msg(